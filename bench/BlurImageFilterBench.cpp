@@ -17,6 +17,9 @@
 #define FILTER_HEIGHT_SMALL 32
 #define FILTER_WIDTH_LARGE  256
 #define FILTER_HEIGHT_LARGE 256
+// Big enough that the blur passes are split up across SkTaskGroup threads.
+#define FILTER_WIDTH_SCREEN  2048
+#define FILTER_HEIGHT_SCREEN 1536
 #define BLUR_SIGMA_MINI     0.5f
 #define BLUR_SIGMA_SMALL    1.0f
 #define BLUR_SIGMA_LARGE    10.0f
@@ -24,10 +27,21 @@
 
 class BlurImageFilterBench : public Benchmark {
 public:
+    enum Size {
+        kSmall_Size,
+        kLarge_Size,
+        kScreen_Size,
+    };
+
     BlurImageFilterBench(SkScalar sigmaX, SkScalar sigmaY,  bool small) :
-        fIsSmall(small), fInitialized(false), fSigmaX(sigmaX), fSigmaY(sigmaY) {
-        fName.printf("blur_image_filter_%s_%.2f_%.2f", fIsSmall ? "small" : "large",
-            SkScalarToFloat(sigmaX), SkScalarToFloat(sigmaY));
+        fSize(small ? kSmall_Size : kLarge_Size), fInitialized(false),
+        fSigmaX(sigmaX), fSigmaY(sigmaY) {
+        this->init();
+    }
+
+    BlurImageFilterBench(SkScalar sigmaX, SkScalar sigmaY, Size size) :
+        fSize(size), fInitialized(false), fSigmaX(sigmaX), fSigmaY(sigmaY) {
+        this->init();
     }
 
 protected:
@@ -52,9 +66,28 @@ protected:
     }
 
 private:
+    void init() {
+        static const char* gSizeNames[] = { "small", "large", "screen" };
+        fName.printf("blur_image_filter_%s_%.2f_%.2f", gSizeNames[fSize],
+            SkScalarToFloat(fSigmaX), SkScalarToFloat(fSigmaY));
+    }
+
     void make_checkerboard() {
-        const int w = fIsSmall ? FILTER_WIDTH_SMALL : FILTER_WIDTH_LARGE;
-        const int h = fIsSmall ? FILTER_HEIGHT_LARGE : FILTER_HEIGHT_LARGE;
+        int w, h;
+        switch (fSize) {
+            case kSmall_Size:
+                w = FILTER_WIDTH_SMALL;
+                h = FILTER_HEIGHT_LARGE;
+                break;
+            case kLarge_Size:
+                w = FILTER_WIDTH_LARGE;
+                h = FILTER_HEIGHT_LARGE;
+                break;
+            default:
+                w = FILTER_WIDTH_SCREEN;
+                h = FILTER_HEIGHT_SCREEN;
+                break;
+        }
         fCheckerboard.allocN32Pixels(w, h);
         SkCanvas canvas(fCheckerboard);
         canvas.clear(0x00000000);
@@ -76,7 +109,7 @@ private:
     }
 
     SkString fName;
-    bool fIsSmall;
+    Size fSize;
     bool fInitialized;
     SkBitmap fCheckerboard;
     SkScalar fSigmaX, fSigmaY;
@@ -95,3 +128,7 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_SMALL, BLUR_SIGMA_SMALL,
+                                          BlurImageFilterBench::kScreen_Size);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE,
+                                          BlurImageFilterBench::kScreen_Size);)
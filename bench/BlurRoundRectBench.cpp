@@ -91,3 +91,64 @@ DEF_BENCH(return new BlurRoundRectBench(100, 100, 6);)
 // Other radii options
 DEF_BENCH(return new BlurRoundRectBench(100, 100, 30);)
 DEF_BENCH(return new BlurRoundRectBench(100, 100, 90);)
+
+// Blurred shadows behind labels of many sizes, so a mask made for one can't be reused for the
+// next.
+class BlurShadowBench : public Benchmark {
+public:
+    enum Shape {
+        kRect_Shape,
+        kRRect_Shape,
+        kCircle_Shape,
+    };
+
+    BlurShadowBench(Shape shape, SkScalar sigma) : fShape(shape), fSigma(sigma) {
+        static const char* gShapeNames[] = { "rect", "rrect", "circle" };
+        fName.printf("blurshadow_%s_%g", gShapeNames[shape], sigma);
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0x80000000);
+        paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, fSigma))->unref();
+
+        for (int i = 0; i < loops; i++) {
+            const SkScalar w = SkIntToScalar(40 + (i * 7) % 120);
+            const SkScalar h = SkIntToScalar(20 + (i * 3) % 40);
+            const SkRect r = SkRect::MakeXYWH(SkIntToScalar(20 + i % 200),
+                                              SkIntToScalar(20 + i % 150), w, h);
+            switch (fShape) {
+                case kRect_Shape:
+                    canvas->drawRect(r, paint);
+                    break;
+                case kRRect_Shape: {
+                    SkRRect rrect;
+                    rrect.setRectXY(r, SkIntToScalar(6), SkIntToScalar(6));
+                    canvas->drawRRect(rrect, paint);
+                    break;
+                }
+                case kCircle_Shape:
+                    canvas->drawCircle(r.centerX(), r.centerY(), h / 2, paint);
+                    break;
+            }
+        }
+    }
+
+private:
+    Shape       fShape;
+    SkScalar    fSigma;
+    SkString    fName;
+
+    typedef     Benchmark INHERITED;
+};
+
+DEF_BENCH(return new BlurShadowBench(BlurShadowBench::kRect_Shape, 4);)
+DEF_BENCH(return new BlurShadowBench(BlurShadowBench::kRRect_Shape, 4);)
+DEF_BENCH(return new BlurShadowBench(BlurShadowBench::kCircle_Shape, 4);)
+DEF_BENCH(return new BlurShadowBench(BlurShadowBench::kRRect_Shape, 12);)
+DEF_BENCH(return new BlurShadowBench(BlurShadowBench::kCircle_Shape, 12);)
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+
+// Replicates recordings that save, translate and restore around every small "icon" they draw,
+// most of which fall outside the clip.  This mostly measures save/restore and quickReject.
+class CanvasSaveRestoreBench : public Benchmark {
+public:
+    CanvasSaveRestoreBench(bool scale) : fScale(scale) {
+        fName.printf("canvas_save_restore_%s", scale ? "scale" : "translate");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        // Spread the icons over an area four times the size of the canvas in each direction.
+        SkRandom rand;
+        for (int i = 0; i < kIconCount; i++) {
+            fOffsets[i].set(rand.nextRangeScalar(-1.5f * W, 2.5f * W),
+                            rand.nextRangeScalar(-1.5f * H, 2.5f * H));
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColor(0xFF336699);
+        const SkRect icon = SkRect::MakeWH(16, 16);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            if (fScale) {
+                canvas->scale(0.75f, 0.75f);
+            }
+            for (int j = 0; j < kIconCount; j++) {
+                canvas->save();
+                canvas->translate(fOffsets[j].fX, fOffsets[j].fY);
+                canvas->drawRect(icon, paint);
+                canvas->restore();
+            }
+            canvas->restore();
+        }
+    }
+
+private:
+    enum {
+        W = 640,
+        H = 480,
+        kIconCount = 100,
+    };
+
+    bool     fScale;
+    SkString fName;
+    SkPoint  fOffsets[kIconCount];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(CanvasSaveRestoreBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(CanvasSaveRestoreBench, (true)); )
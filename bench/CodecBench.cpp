@@ -8,11 +8,14 @@
 #include "CodecBench.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkColorPriv.h"
 #include "SkImageGenerator.h"
 #include "SkOSFile.h"
+#include "SkSwizzler.h"
 
-CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType)
+CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType, Mode mode)
     : fColorType(colorType)
+    , fMode(mode)
     , fData(SkRef(encoded))
 {
     // Parse filename and the color type to give the benchmark a useful name
@@ -31,6 +34,10 @@ CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType
             colorName = "Unknown";
     }
     fName.printf("Codec_%s_%s", baseName.c_str(), colorName);
+    if (kSwizzle_Mode == fMode) {
+        SkASSERT(kN32_SkColorType == fColorType);
+        fName.append("_swizzle");
+    }
 #ifdef SK_DEBUG
     // Ensure that we can create an SkCodec from this data.
     SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
@@ -48,10 +55,45 @@ bool CodecBench::isSuitableFor(Backend backend) {
 
 void CodecBench::onPreDraw() {
     SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
-    fBitmap.allocPixels(codec->getInfo().makeColorType(fColorType));
+    if (kDecode_Mode == fMode) {
+        fBitmap.allocPixels(codec->getInfo().makeColorType(fColorType));
+        return;
+    }
+
+    // Decode once without premultiplying, and keep the pixels in the byte order libpng hands
+    // to the swizzler.
+    SkBitmap decoded;
+    decoded.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    codec->getPixels(decoded.info(), decoded.getPixels(), decoded.rowBytes());
+    uint8_t* src = (uint8_t*)fSrc.reset(decoded.width() * decoded.height() * 4);
+    for (int y = 0; y < decoded.height(); ++y) {
+        const SkPMColor* row = decoded.getAddr32(0, y);
+        for (int x = 0; x < decoded.width(); ++x) {
+            *src++ = SkGetPackedR32(row[x]);
+            *src++ = SkGetPackedG32(row[x]);
+            *src++ = SkGetPackedB32(row[x]);
+            *src++ = SkGetPackedA32(row[x]);
+        }
+    }
+    fBitmap.allocPixels(decoded.info().makeAlphaType(kPremul_SkAlphaType));
 }
 
 void CodecBench::onDraw(const int n, SkCanvas* canvas) {
+    if (kSwizzle_Mode == fMode) {
+        const size_t srcRowBytes = fBitmap.width() * 4;
+        for (int i = 0; i < n; i++) {
+            SkAutoTDelete<SkSwizzler> swizzler(SkSwizzler::CreateSwizzler(SkSwizzler::kRGBA,
+                    NULL, fBitmap.info(), fBitmap.getPixels(), fBitmap.rowBytes(),
+                    SkImageGenerator::kNo_ZeroInitialized));
+            const uint8_t* src = (const uint8_t*)fSrc.get();
+            for (int y = 0; y < fBitmap.height(); y++) {
+                swizzler->next(src);
+                src += srcRowBytes;
+            }
+        }
+        return;
+    }
+
     SkAutoTDelete<SkCodec> codec;
     for (int i = 0; i < n; i++) {
         codec.reset(SkCodec::NewFromData(fData));
@@ -14,14 +14,24 @@
 #include "SkImageInfo.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
+#include "SkTypes.h"
 
 /**
  *  Time SkCodec.
  */
 class CodecBench : public Benchmark {
 public:
+    enum Mode {
+        // Time decoding the whole image with SkCodec::getPixels().
+        kDecode_Mode,
+        // Time only converting the image's RGBA rows to premultiplied kN32 with SkSwizzler,
+        // which is most of a PNG decode after zlib.
+        kSwizzle_Mode,
+    };
+
     // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType);
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType,
+               Mode mode = kDecode_Mode);
 
 protected:
     const char* onGetName() override;
@@ -32,8 +42,11 @@ protected:
 private:
     SkString                fName;
     const SkColorType       fColorType;
+    const Mode              fMode;
     SkAutoTUnref<SkData>    fData;
     SkBitmap                fBitmap;
+    // In kSwizzle_Mode, the decoded image as unpremultiplied RGBA rows.
+    SkAutoMalloc            fSrc;
     typedef Benchmark INHERITED;
 };
 #endif // CodecBench_DEFINED
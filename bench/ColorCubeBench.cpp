@@ -14,11 +14,14 @@ class ColorCubeBench : public Benchmark {
     int fCubeDimension;
     SkData* fCubeData;
     SkBitmap fBitmap;
+    bool fFlat;
 
 public:
-    ColorCubeBench()
+    // If flat, the source is a few large solid bands instead of a gradient.
+    ColorCubeBench(bool flat)
      : fCubeDimension(0)
-     , fCubeData(NULL) {
+     , fCubeData(NULL)
+     , fFlat(flat) {
         fSize = SkISize::Make(2880, 1800); // 2014 Macbook Pro resolution
     }
 
@@ -28,7 +31,7 @@ public:
 
 protected:
     const char* onGetName() override {
-        return "colorcube";
+        return fFlat ? "colorcube_flat" : "colorcube";
     }
 
     void onPreDraw() override {
@@ -61,6 +64,18 @@ private:
         fBitmap.allocN32Pixels(fSize.width(), fSize.height());
         SkCanvas canvas(fBitmap);
         canvas.clear(0x00000000);
+        if (fFlat) {
+            static const SkColor colors[] = { SK_ColorYELLOW, 0x800000FF, SK_ColorGREEN };
+            const int bandWidth = fSize.width() / SK_ARRAY_COUNT(colors);
+            for (size_t i = 0; i < SK_ARRAY_COUNT(colors); ++i) {
+                SkPaint paint;
+                paint.setColor(colors[i]);
+                canvas.drawRect(SkRect::MakeXYWH(SkIntToScalar(bandWidth * (int)i), 0,
+                                                 SkIntToScalar(bandWidth),
+                                                 SkIntToScalar(fSize.height())), paint);
+            }
+            return;
+        }
         SkPaint paint;
         paint.setAntiAlias(true);
         SkShader* shader = MakeLinear(fSize);
@@ -108,4 +123,5 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return new ColorCubeBench(); )
+DEF_BENCH( return new ColorCubeBench(false); )
+DEF_BENCH( return new ColorCubeBench(true); )
@@ -439,6 +439,60 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Dashed polylines with diagonal segments, like the borders and tram lines on a map tile. The
+// gpu dashes these in the fragment shader rather than expanding the dashes into a path.
+class DashPolylineBench : public Benchmark {
+    SkString     fName;
+    SkPath       fPath;
+    SkPaint::Cap fCap;
+    bool         fDoAA;
+
+    SkAutoTUnref<SkPathEffect> fPathEffect;
+
+public:
+    DashPolylineBench(SkPaint::Cap cap, bool doAA) {
+        static const char* gCapNames[] = { "butt", "round", "square" };
+        fName.printf("dashpolyline_%s%s", gCapNames[cap], doAA ? "_aa" : "_bw");
+        fCap = cap;
+        fDoAA = doAA;
+
+        SkRandom rand;
+        for (int contour = 0; contour < 10; ++contour) {
+            SkScalar y = SkIntToScalar(20 + contour * 45);
+            fPath.moveTo(SkIntToScalar(10), y);
+            for (int x = 10; x < 630; x += 6) {
+                fPath.lineTo(SkIntToScalar(x), y + rand.nextRangeScalar(-12, 12));
+            }
+        }
+
+        SkScalar vals[] = { SkIntToScalar(6), SkIntToScalar(4) };
+        fPathEffect.reset(SkDashPathEffect::Create(vals, 2, 0));
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setColor(SK_ColorBLACK);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(SkIntToScalar(2));
+        p.setStrokeCap(fCap);
+        p.setPathEffect(fPathEffect);
+        p.setAntiAlias(fDoAA);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, p);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -486,3 +540,8 @@ DEF_BENCH( return new DashGridBench(1, 1, false); )
 DEF_BENCH( return new DashGridBench(3, 1, true); )
 DEF_BENCH( return new DashGridBench(3, 1, false); )
 #endif
+
+DEF_BENCH( return new DashPolylineBench(SkPaint::kButt_Cap, true); )
+DEF_BENCH( return new DashPolylineBench(SkPaint::kButt_Cap, false); )
+DEF_BENCH( return new DashPolylineBench(SkPaint::kRound_Cap, true); )
+DEF_BENCH( return new DashPolylineBench(SkPaint::kSquare_Cap, true); )
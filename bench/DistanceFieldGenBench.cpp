@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkDistanceFieldGen.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+
+// Generates distance fields for a run of glyph-sized A8 discs, one at a time or all at once
+// through SkGenerateDistanceFields().
+class DistanceFieldGenBench : public Benchmark {
+public:
+    DistanceFieldGenBench(int size, bool batch) : fSize(size), fBatch(batch) {
+        fName.printf("distance_field_gen_%d%s", size, batch ? "_batch" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        const int dfSize = fSize + 2 * SK_DistanceFieldPad;
+        fImages.reset(kGlyphCount * fSize * fSize);
+        fFields.reset(kGlyphCount * dfSize * dfSize);
+        for (int i = 0; i < kGlyphCount; i++) {
+            uint8_t* image = fImages.get() + i * fSize * fSize;
+            const float radius = 0.25f * fSize + 0.2f * i;
+            const float center = 0.5f * fSize;
+            for (int y = 0; y < fSize; y++) {
+                for (int x = 0; x < fSize; x++) {
+                    const float dx = x + 0.5f - center;
+                    const float dy = y + 0.5f - center;
+                    const float coverage = SkScalarPin(radius + 0.5f - sqrtf(dx * dx + dy * dy),
+                                                       0, 1);
+                    image[y * fSize + x] = SkToU8((int)(coverage * 255));
+                }
+            }
+
+            SkDistanceFieldRequest& request = fRequests[i];
+            request.fDistanceField = fFields.get() + i * dfSize * dfSize;
+            request.fImage = image;
+            request.fWidth = fSize;
+            request.fHeight = fSize;
+            request.fRowBytes = fSize;
+            request.fIsBW = false;
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fBatch) {
+                SkGenerateDistanceFields(fRequests, kGlyphCount);
+            } else {
+                for (int j = 0; j < kGlyphCount; j++) {
+                    const SkDistanceFieldRequest& request = fRequests[j];
+                    SkGenerateDistanceFieldFromA8Image(request.fDistanceField, request.fImage,
+                                                       request.fWidth, request.fHeight,
+                                                       request.fRowBytes);
+                }
+            }
+        }
+    }
+
+private:
+    static const int kGlyphCount = 32;
+
+    SkString               fName;
+    int                    fSize;
+    bool                   fBatch;
+    SkAutoTMalloc<uint8_t> fImages;
+    SkAutoTMalloc<uint8_t> fFields;
+    SkDistanceFieldRequest fRequests[kGlyphCount];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (32, false)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (32, true)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (64, false)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (64, true)); )
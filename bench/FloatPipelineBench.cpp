@@ -0,0 +1,74 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkXfermode.h"
+
+// Draws anti-aliased circles through a gradient and an xfermode, either with the 8888
+// blitters or with SkPaint::kFloatPipeline_Flag set.
+class FloatPipelineBench : public Benchmark {
+public:
+    FloatPipelineBench(SkXfermode::Mode mode, bool floatPipeline)
+        : fMode(mode)
+        , fFloatPipeline(floatPipeline) {
+        fName.printf("float_pipeline_%s_%s", SkXfermode::ModeName(mode),
+                     floatPipeline ? "float" : "8888");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kRaster_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw() override {
+        const SkPoint pts[] = { { 0, 0 }, { 256, 256 } };
+        const SkColor colors[] = { 0xFF2080F0, 0x80F04010 };
+        fShader.reset(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                     SkShader::kMirror_TileMode));
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkISize size = canvas->getDeviceSize();
+        SkRandom random;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setShader(fShader);
+        paint.setXfermodeMode(fMode);
+        paint.setFloatPipeline(fFloatPipeline);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawCircle(random.nextUScalar1() * size.fWidth,
+                               random.nextUScalar1() * size.fHeight,
+                               random.nextRangeScalar(20, 60), paint);
+        }
+    }
+
+private:
+    SkXfermode::Mode        fMode;
+    bool                    fFloatPipeline;
+    SkAutoTUnref<SkShader>  fShader;
+    SkString                fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kSrcOver_Mode, false); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kSrcOver_Mode, true); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kSrcATop_Mode, false); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kSrcATop_Mode, true); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kMultiply_Mode, false); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kMultiply_Mode, true); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kDarken_Mode, false); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kDarken_Mode, true); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kDifference_Mode, false); )
+DEF_BENCH( return new FloatPipelineBench(SkXfermode::kDifference_Mode, true); )
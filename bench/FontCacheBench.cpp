@@ -6,11 +6,15 @@
  */
 
 #include "Benchmark.h"
+#include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkChecksum.h"
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkString.h"
 #include "SkTemplates.h"
+#include "SkThreadUtils.h"
 
 #include "gUniqueGlyphIDs.h"
 #define gUniqueGlyphIDs_Sentinel    0xFFFF
@@ -51,6 +55,116 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// The same measuring as FontCacheBench, shared out over several threads that all look up glyphs
+// in the same strikes at once.
+class ThreadedFontCacheBench : public Benchmark {
+public:
+    explicit ThreadedFontCacheBench(int threads) : fThreads(threads) {
+        fName.printf("fontcache_threads_%d", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+        SkAutoTArray<Worker> workers(fThreads);
+        SkTDArray<SkThread*> threads;
+        for (int i = 0; i < fThreads; i++) {
+            workers[i].fPaint  = &paint;
+            workers[i].fFirst  = i;
+            workers[i].fStride = fThreads;
+            workers[i].fLoops  = loops;
+            *threads.append() = SkNEW_ARGS(SkThread, (Worker::Run, &workers[i]));
+        }
+        for (int i = 0; i < fThreads; i++) {
+            threads[i]->start();
+        }
+        for (int i = 0; i < fThreads; i++) {
+            threads[i]->join();
+        }
+        threads.deleteAll();
+    }
+
+private:
+    // Runs loops fFirst, fFirst + fStride, ... until fLoops have been run overall.
+    struct Worker {
+        const SkPaint* fPaint;
+        int fFirst, fStride, fLoops;
+
+        static void Run(void* arg) {
+            const Worker* worker = (const Worker*)arg;
+            for (int i = worker->fFirst; i < worker->fLoops; i += worker->fStride) {
+                const uint16_t* array = gUniqueGlyphIDs;
+                while (*array != gUniqueGlyphIDs_Sentinel) {
+                    int count = count_glyphs(array);
+                    worker->fPaint->measureText(array, count * sizeof(uint16_t));
+                    array += count + 1;    // skip the sentinel
+                }
+            }
+        }
+    };
+
+    int      fThreads;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+// Fills a new strike with the images of every glyph in gUniqueGlyphIDs, either one at a time,
+// or all at once with SkGlyphCache::prefetchGlyphs().
+class FontCacheFillBench : public Benchmark {
+public:
+    FontCacheFillBench(bool blur, bool prefetch) : fBlur(blur), fPrefetch(prefetch) {
+        fName.printf("fontcache_fill%s%s", blur ? "_blur" : "", prefetch ? "_prefetch" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(true);
+        paint.setTextSize(SkIntToScalar(36));
+        if (fBlur) {
+            paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 2))->unref();
+        }
+
+        const int count = count_glyphs(gUniqueGlyphIDs);
+        for (int i = 0; i < loops; ++i) {
+            SkGraphics::PurgeFontCache();
+            SkAutoGlyphCache autoCache(paint, NULL, NULL);
+            SkGlyphCache* cache = autoCache.getCache();
+            if (fPrefetch) {
+                cache->prefetchGlyphs(gUniqueGlyphIDs, count);
+            } else {
+                for (int j = 0; j < count; ++j) {
+                    cache->findImage(cache->getGlyphIDMetrics(gUniqueGlyphIDs[j]));
+                }
+            }
+        }
+    }
+
+private:
+    bool     fBlur;
+    bool     fPrefetch;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static uint32_t rotr(uint32_t value, unsigned bits) {
@@ -142,6 +256,15 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new FontCacheBench(); )
+DEF_BENCH( return new ThreadedFontCacheBench(1); )
+DEF_BENCH( return new ThreadedFontCacheBench(2); )
+DEF_BENCH( return new ThreadedFontCacheBench(4); )
+DEF_BENCH( return new ThreadedFontCacheBench(8); )
+DEF_BENCH( return new ThreadedFontCacheBench(16); )
+DEF_BENCH( return new FontCacheFillBench(false, false); )
+DEF_BENCH( return new FontCacheFillBench(false, true); )
+DEF_BENCH( return new FontCacheFillBench(true, false); )
+DEF_BENCH( return new FontCacheFillBench(true, true); )
 
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
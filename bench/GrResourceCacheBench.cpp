@@ -139,7 +139,116 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Stands in for a scratch render target: same key for the same size, and large.
+class ScratchBenchResource : public GrGpuResource {
+public:
+    SK_DECLARE_INST_COUNT(ScratchBenchResource);
+    ScratchBenchResource(GrGpu* gpu, int kind)
+        : INHERITED(gpu, kCached_LifeCycle) {
+        GrScratchKey key;
+        ComputeScratchKey(kind, &key);
+        this->setScratchKey(key);
+        this->registerWithCache();
+    }
+
+    static void ComputeScratchKey(int kind, GrScratchKey* key) {
+        static GrScratchKey::ResourceType kType = GrScratchKey::GenerateResourceType();
+        GrScratchKey::Builder builder(key, kType, 1);
+        builder[0] = kind;
+    }
+
+    static const size_t kSize = 4096;
+
+private:
+    size_t onGpuMemorySize() const override { return kSize; }
+
+    typedef GrGpuResource INHERITED;
+};
+
+/**
+ * Each frame renders through a few scratch targets of new sizes, like offscreen layers, and every
+ * other frame also draws a set of cached textures, like map tiles.  The budget fits the textures
+ * and one frame's targets.  In plain LRU order the targets evict the textures on the frames that
+ * don't draw them, and the next frame recreates them; giving scratch resources low priority, as
+ * GrContext does, keeps the textures cached.
+ */
+class GrResourceCacheBenchScratchThrash : public Benchmark {
+    enum {
+        kHotCount = 256,
+        kScratchPerFrame = 4,
+        kScratchKinds = 16,
+    };
+
+public:
+    explicit GrResourceCacheBenchScratchThrash(bool prioritize) : fPrioritize(prioritize) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fPrioritize ? "grresourcecache_scratch_thrash_priority"
+                           : "grresourcecache_scratch_thrash_lru";
+    }
+
+    void onPreDraw() override {
+        fContext.reset(GrContext::CreateMockContext());
+        if (!fContext) {
+            return;
+        }
+        fContext->setResourceCacheLimits(CACHE_SIZE_COUNT,
+                                         100 * kHotCount +
+                                         ScratchBenchResource::kSize * kScratchPerFrame);
+        fContext->getResourceCache()->purgeAllUnlocked();
+        fFrame = 0;
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        if (!fContext) {
+            return;
+        }
+        GrResourceCache* cache = fContext->getResourceCache();
+        GrGpu* gpu = fContext->getGpu();
+        for (int i = 0; i < loops; ++i, ++fFrame) {
+            if (0 == fFrame % 2) {
+                for (int k = 0; k < kHotCount; ++k) {
+                    GrUniqueKey key;
+                    BenchResource::ComputeKey(k, &key);
+                    GrGpuResource* resource = cache->findAndRefUniqueResource(key);
+                    if (!resource) {
+                        resource = SkNEW_ARGS(BenchResource, (gpu));
+                        resource->resourcePriv().setUniqueKey(key);
+                    }
+                    resource->unref();
+                }
+            }
+            for (int k = 0; k < kScratchPerFrame; ++k) {
+                int kind = (fFrame * kScratchPerFrame + k) % kScratchKinds;
+                GrScratchKey key;
+                ScratchBenchResource::ComputeScratchKey(kind, &key);
+                GrGpuResource* resource = cache->findAndRefScratchResource(key);
+                if (!resource) {
+                    resource = SkNEW_ARGS(ScratchBenchResource, (gpu, kind));
+                }
+                if (fPrioritize) {
+                    resource->resourcePriv().setPurgePriority(GrGpuResource::kLow_PurgePriority);
+                }
+                resource->unref();
+            }
+        }
+    }
+
+private:
+    SkAutoTUnref<GrContext> fContext;
+    bool fPrioritize;
+    int fFrame;
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH( return new GrResourceCacheBenchAdd(); )
 DEF_BENCH( return new GrResourceCacheBenchFind(); )
+DEF_BENCH( return new GrResourceCacheBenchScratchThrash(false); )
+DEF_BENCH( return new GrResourceCacheBenchScratchThrash(true); )
 
 #endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTGroupHash.h"
+#include "SkTHash.h"
+
+/**
+ * Lookup-heavy hash map benches: fill a map once, then look up a fixed mix of keys that are in
+ * it (hits) and keys that are not (misses).  Each bench runs on SkTHashMap and on
+ * SkTGroupHashMap with the same keys, so the two can be compared directly.
+ */
+
+static const int kLookups = 1024;
+
+template <typename Map, typename K>
+class HashLookupBench : public Benchmark {
+public:
+    HashLookupBench(const char* mapName, const char* keyName, int count, int hitPercent)
+        : fCount(count)
+        , fHitPercent(hitPercent) {
+        fName.printf("hash_%s_%s_%d_hit%d", mapName, keyName, count, hitPercent);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onPreDraw() override {
+        SkRandom random;
+        for (int i = 0; i < fCount; i++) {
+            fMap.set(MakeKey(i), i);
+        }
+        for (int i = 0; i < kLookups; i++) {
+            int index = random.nextULessThan(fCount);
+            // Misses use keys past the ones in the map
+            bool hit = random.nextULessThan(100) < (uint32_t)fHitPercent;
+            fKeys[i] = MakeKey(hit ? index : fCount + index);
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        int found = 0;
+        for (int i = 0; i < loops; i++) {
+            for (int j = 0; j < kLookups; j++) {
+                if (const int* val = fMap.find(fKeys[j])) {
+                    found += *val;
+                }
+            }
+        }
+        fFound = found;
+    }
+
+private:
+    static int MakeKey(int i, int*) { return i * 0x9E3779B1; }
+    static SkString MakeKey(int i, SkString*) {
+        SkString key;
+        key.printf("typeface-%d-style-%d", i, i % 7);
+        return key;
+    }
+    static K MakeKey(int i) { return MakeKey(i, (K*)NULL); }
+
+    SkString fName;
+    int      fCount;
+    int      fHitPercent;
+    Map      fMap;
+    K        fKeys[kLookups];
+    int      fFound;
+
+    typedef Benchmark INHERITED;
+};
+
+typedef HashLookupBench<SkTHashMap<int, int>, int> IntHashBench;
+typedef HashLookupBench<SkTGroupHashMap<int, int>, int> IntGroupHashBench;
+typedef HashLookupBench<SkTHashMap<SkString, int>, SkString> StringHashBench;
+typedef HashLookupBench<SkTGroupHashMap<SkString, int>, SkString> StringGroupHashBench;
+
+DEF_BENCH( return new IntHashBench("thash", "int", 100, 90); )
+DEF_BENCH( return new IntGroupHashBench("tgrouphash", "int", 100, 90); )
+DEF_BENCH( return new IntHashBench("thash", "int", 10000, 90); )
+DEF_BENCH( return new IntGroupHashBench("tgrouphash", "int", 10000, 90); )
+DEF_BENCH( return new IntHashBench("thash", "int", 10000, 10); )
+DEF_BENCH( return new IntGroupHashBench("tgrouphash", "int", 10000, 10); )
+DEF_BENCH( return new StringHashBench("thash", "string", 1000, 90); )
+DEF_BENCH( return new StringGroupHashBench("tgrouphash", "string", 1000, 90); )
+DEF_BENCH( return new StringHashBench("thash", "string", 1000, 10); )
+DEF_BENCH( return new StringGroupHashBench("tgrouphash", "string", 1000, 10); )
@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -25,6 +26,7 @@ struct TestRec : public SkResourceCache::Rec {
     TestRec(const TestKey& key, intptr_t value) : fKey(key), fValue(value) {}
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "test"; }
     size_t bytesUsed() const override { return sizeof(fKey) + sizeof(fValue); }
 
     static bool Visitor(const SkResourceCache::Rec&, void*) {
@@ -73,3 +75,48 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Many threads finding through the global cache at once, to measure lock contention.
+class ImageCacheContentionBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        TASK_COUNT = 64,
+    };
+
+    struct Work {
+        int fLoops;
+    };
+
+    static void FindAll(int, Work* work) {
+        for (int i = 0; i < work->fLoops; ++i) {
+            TestKey key(i % CACHE_COUNT);
+            SkResourceCache::Find(key, TestRec::Visitor, NULL);
+        }
+    }
+
+public:
+    ImageCacheContentionBench() {}
+
+protected:
+    const char* onGetName() override {
+        return "imagecache_contended";
+    }
+
+    void onPreDraw() override {
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            SkResourceCache::Add(SkNEW_ARGS(TestRec, (TestKey(i), i)));
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        Work work = { SkTMax(1, loops / TASK_COUNT) };
+        sk_parallel_for(0, TASK_COUNT, 1, FindAll, &work);
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ImageCacheContentionBench(); )
@@ -22,9 +22,10 @@
 
 class BaseImageFilterCollapseBench : public Benchmark {
 public:
-    BaseImageFilterCollapseBench(): fImageFilter(NULL) {}
+    BaseImageFilterCollapseBench(): fImageFilter(NULL), fColorFilter(NULL) {}
     ~BaseImageFilterCollapseBench() {
         SkSafeUnref(fImageFilter);
+        SkSafeUnref(fColorFilter);
     }
 
 protected:
@@ -39,18 +40,25 @@ protected:
         }
     }
 
+    // Also draws with colorFilter on the paint, underneath the image filters.
+    void setPaintColorFilter(SkColorFilter* colorFilter) {
+        SkRefCnt_SafeAssign(fColorFilter, colorFilter);
+    }
+
     void onDraw(const int loops, SkCanvas* canvas) override {
         makeBitmap();
 
         for(int i = 0; i < loops; i++) {
             SkPaint paint;
             paint.setImageFilter(fImageFilter);
+            paint.setColorFilter(fColorFilter);
             canvas->drawBitmap(fBitmap, 0, 0, &paint);
         }
     }
 
 private:
     SkImageFilter* fImageFilter;
+    SkColorFilter* fColorFilter;
     SkBitmap fBitmap;
 
     void makeBitmap() {
@@ -154,5 +162,49 @@ protected:
     }
 };
 
+// Tables with a brightness matrix between them, which only scales and translates each
+// component, so it folds into the tables. The paint's color filter folds in too.
+class MixedCollapseBench: public BaseImageFilterCollapseBench {
+public:
+    explicit MixedCollapseBench(bool paintColorFilter) : fPaintColorFilter(paintColorFilter) {}
+    virtual ~MixedCollapseBench() {}
+
+protected:
+    virtual const char* onGetName() override {
+        return fPaintColorFilter ? "image_filter_collapse_mixed_paint"
+                                 : "image_filter_collapse_mixed";
+    }
+
+    virtual void onPreDraw() override {
+        uint8_t table1[256], table2[256];
+        for (int i = 0; i < 256; ++i) {
+            table1[i] = i * i / 255;
+            table2[i] = static_cast<uint8_t>(sqrtf(i / 255.0f) * 255);
+        }
+
+        SkColorFilter* colorFilters[] = {
+            SkTableColorFilter::Create(table1),
+            make_brightness(0.1f),
+            SkTableColorFilter::Create(table2),
+        };
+
+        doPreDraw(colorFilters, SK_ARRAY_COUNT(colorFilters));
+
+        for(unsigned i = 0; i < SK_ARRAY_COUNT(colorFilters); i++) {
+            colorFilters[i]->unref();
+        }
+
+        if (fPaintColorFilter) {
+            SkAutoTUnref<SkColorFilter> brightness(make_brightness(-0.1f));
+            this->setPaintColorFilter(brightness);
+        }
+    }
+
+private:
+    const bool fPaintColorFilter;
+};
+
 DEF_BENCH(return new TableCollapseBench;)
 DEF_BENCH(return new MatrixCollapseBench;)
+DEF_BENCH(return new MixedCollapseBench(false);)
+DEF_BENCH(return new MixedCollapseBench(true);)
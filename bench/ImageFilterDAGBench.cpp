@@ -15,22 +15,29 @@ enum { kNumInputs = 5 };
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
 // This bench shows an improvement in performance once cacheing of re-used
 // nodes is implemented, since the DAG is no longer flattened to a tree.
+//
+// The branches variant connects 5 different blurs instead, which share nothing
+// but can each be filtered on their own thread.
 
 class ImageFilterDAGBench : public Benchmark {
 public:
-    ImageFilterDAGBench() {}
+    explicit ImageFilterDAGBench(bool shared) : fShared(shared) {}
 
 protected:
     const char* onGetName() override {
-        return "image_filter_dag";
+        return fShared ? "image_filter_dag" : "image_filter_dag_branches";
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
         for (int j = 0; j < loops; j++) {
-            SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(20.0f, 20.0f));
+            SkAutoTUnref<SkImageFilter> blurs[kNumInputs];
             SkImageFilter* inputs[kNumInputs];
             for (int i = 0; i < kNumInputs; ++i) {
-                inputs[i] = blur.get();
+                if (0 == i || !fShared) {
+                    const SkScalar sigma = 20.0f + i;
+                    blurs[i].reset(SkBlurImageFilter::Create(sigma, sigma));
+                }
+                inputs[i] = fShared ? blurs[0].get() : blurs[i].get();
             }
             SkAutoTUnref<SkImageFilter> merge(SkMergeImageFilter::Create(inputs, kNumInputs));
             SkPaint paint;
@@ -41,7 +48,10 @@ protected:
     }
 
 private:
+    const bool fShared;
+
     typedef Benchmark INHERITED;
 };
 
-DEF_BENCH(return new ImageFilterDAGBench;)
+DEF_BENCH(return new ImageFilterDAGBench(true);)
+DEF_BENCH(return new ImageFilterDAGBench(false);)
@@ -7,8 +7,10 @@
 #include "Benchmark.h"
 #include "SkBitmapSource.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkDevice.h"
 #include "SkLightingImageFilter.h"
+#include "SkString.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
@@ -232,6 +234,57 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Lights a varying height map the size of a large canvas, the way a hillshade relief does.
+class LightingHeightMapBench : public LightingBaseBench {
+public:
+    LightingHeightMapBench(int size, bool distant)
+        : INHERITED(false), fSize(size), fDistant(distant) {
+        fName.printf("lightingheightmap_%s_%d", distant ? "distant" : "point", size);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(fSize, fSize);
+    }
+
+    void onPreDraw() override {
+        fHeights.allocN32Pixels(fSize, fSize);
+        for (int y = 0; y < fSize; ++y) {
+            for (int x = 0; x < fSize; ++x) {
+                SkScalar h = SkScalarSin(x * 0.05f) * SkScalarCos(y * 0.03f) +
+                             SkScalarSin((x + y) * 0.011f);
+                unsigned a = SkScalarRoundToInt(SkScalarPin(64 * h + 128, 0, 255));
+                *fHeights.getAddr32(x, y) = SkPackARGB32(a, a, a, a);
+            }
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkImageFilter* filter = fDistant ?
+            SkLightingImageFilter::CreateDistantLitDiffuse(getDistantDirection(), getWhite(),
+                                                           getSurfaceScale(), getKd()) :
+            SkLightingImageFilter::CreatePointLitDiffuse(getPointLocation(), getWhite(),
+                                                         getSurfaceScale(), getKd());
+        SkPaint paint;
+        paint.setImageFilter(filter)->unref();
+        for (int i = 0; i < loops; i++) {
+            canvas->drawBitmap(fHeights, 0, 0, &paint);
+        }
+    }
+
+private:
+    int      fSize;
+    bool     fDistant;
+    SkString fName;
+    SkBitmap fHeights;
+
+    typedef LightingBaseBench INHERITED;
+};
+
 DEF_BENCH( return new LightingPointLitDiffuseBench(true); )
 DEF_BENCH( return new LightingPointLitDiffuseBench(false); )
 DEF_BENCH( return new LightingDistantLitDiffuseBench(true); )
@@ -244,3 +297,7 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+DEF_BENCH( return new LightingHeightMapBench(1024, true); )
+DEF_BENCH( return new LightingHeightMapBench(1024, false); )
+DEF_BENCH( return new LightingHeightMapBench(2048, true); )
+DEF_BENCH( return new LightingHeightMapBench(2048, false); )
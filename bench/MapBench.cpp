@@ -0,0 +1,314 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+/**
+ * Procedurally generated street map workloads, in the spirit of what a mobile map renderer draws
+ * for each tile: cased and dashed road polylines, filled areas with holes (parks, lakes,
+ * buildings), street names along the roads, and point-of-interest icons with halos.  The map is
+ * generated from a fixed seed, so every run draws the same thing.
+ *
+ * Zoom is a scale about the center of a world four times the size of the bench; at 0.25 the
+ * whole world is visible.  As in a real map, line widths, dashes, text and icons stay the same
+ * size on screen at every zoom, while the geometry scales.
+ */
+
+static const int kW = 640, kH = 480;   // The bench's size.
+static const int kWorldScale = 4;      // The world is this many times wider and taller.
+
+enum MapLayer {
+    kRoads_MapLayer  = 1 << 0,
+    kAreas_MapLayer  = 1 << 1,
+    kLabels_MapLayer = 1 << 2,
+    kIcons_MapLayer  = 1 << 3,
+
+    kAll_MapLayer = kRoads_MapLayer | kAreas_MapLayer | kLabels_MapLayer | kIcons_MapLayer,
+};
+
+static const char* layer_name(uint32_t layers) {
+    switch (layers) {
+        case kRoads_MapLayer:  return "roads";
+        case kAreas_MapLayer:  return "areas";
+        case kLabels_MapLayer: return "labels";
+        case kIcons_MapLayer:  return "icons";
+        case kAll_MapLayer:    return "all";
+    }
+    SkFAIL("Unknown map layers.");
+    return NULL;
+}
+
+// A wandering polyline, like a road.
+static void make_road(SkRandom* rand, SkPath* path) {
+    const SkScalar worldW = SkIntToScalar(kW * kWorldScale),
+                   worldH = SkIntToScalar(kH * kWorldScale);
+    SkScalar x = rand->nextRangeScalar(0, worldW),
+             y = rand->nextRangeScalar(0, worldH);
+    SkScalar heading = rand->nextRangeScalar(0, 2 * SK_ScalarPI);
+    path->moveTo(x, y);
+    const int points = rand->nextRangeU(8, 30);
+    for (int i = 0; i < points; i++) {
+        heading += rand->nextRangeScalar(-0.5f, 0.5f);
+        const SkScalar step = rand->nextRangeScalar(10, 40);
+        x += step * SkScalarCos(heading);
+        y += step * SkScalarSin(heading);
+        path->lineTo(x, y);
+    }
+}
+
+// A closed, star shaped ring around (cx, cy); counterclockwise rings become holes under
+// even-odd filling either way.
+static void add_ring(SkRandom* rand, SkScalar cx, SkScalar cy, SkScalar radius, SkPath* path) {
+    const int points = rand->nextRangeU(6, 16);
+    for (int i = 0; i < points; i++) {
+        const SkScalar angle = 2 * SK_ScalarPI * i / points;
+        const SkScalar r = radius * rand->nextRangeScalar(0.7f, 1.0f);
+        const SkScalar x = cx + r * SkScalarCos(angle),
+                       y = cy + r * SkScalarSin(angle);
+        if (0 == i) {
+            path->moveTo(x, y);
+        } else {
+            path->lineTo(x, y);
+        }
+    }
+    path->close();
+}
+
+// An area with up to two holes, like a park with ponds in it.
+static void make_area(SkRandom* rand, SkPath* path) {
+    const SkScalar cx = rand->nextRangeScalar(0, SkIntToScalar(kW * kWorldScale)),
+                   cy = rand->nextRangeScalar(0, SkIntToScalar(kH * kWorldScale));
+    const SkScalar radius = rand->nextRangeScalar(15, 120);
+    add_ring(rand, cx, cy, radius, path);
+    const int holes = rand->nextULessThan(3);
+    for (int i = 0; i < holes; i++) {
+        add_ring(rand,
+                 cx + rand->nextRangeScalar(-0.3f, 0.3f) * radius,
+                 cy + rand->nextRangeScalar(-0.3f, 0.3f) * radius,
+                 radius * 0.2f, path);
+    }
+    path->setFillType(SkPath::kEvenOdd_FillType);
+}
+
+class MapBench : public Benchmark {
+public:
+    MapBench(uint32_t layers, SkScalar zoom) : fLayers(layers), fZoom(zoom) {
+        fName.printf("map_%s_%g", layer_name(layers), zoom);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(kW, kH); }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        // Roads are major (cased), minor, or footpaths (dashed).
+        for (int i = 0; i < 3000; i++) {
+            SkPath* road = &fRoads[rand.nextULessThan(kRoadClasses)].push_back();
+            make_road(&rand, road);
+        }
+        static const SkColor kAreaColors[] = {
+            0xFFC8FACC,  // Park.
+            0xFFAAD3DF,  // Water.
+            0xFFD9D0C9,  // Building.
+        };
+        for (int i = 0; i < 600; i++) {
+            Area& area = fAreas.push_back();
+            make_area(&rand, &area.fPath);
+            area.fColor = kAreaColors[rand.nextULessThan(SK_ARRAY_COUNT(kAreaColors))];
+        }
+        for (int i = 0; i < 400; i++) {
+            fIcons.push_back().set(rand.nextRangeScalar(0, SkIntToScalar(kW * kWorldScale)),
+                                   rand.nextRangeScalar(0, SkIntToScalar(kH * kWorldScale)));
+        }
+        this->makeIcon();
+        this->makePaints();
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            canvas->translate(SkIntToScalar(kW) / 2, SkIntToScalar(kH) / 2);
+            canvas->scale(fZoom, fZoom);
+            canvas->translate(-SkIntToScalar(kW * kWorldScale) / 2,
+                              -SkIntToScalar(kH * kWorldScale) / 2);
+
+            if (fLayers & kAreas_MapLayer) {
+                this->drawAreas(canvas);
+            }
+            if (fLayers & kRoads_MapLayer) {
+                this->drawRoads(canvas);
+            }
+            if (fLayers & kLabels_MapLayer) {
+                this->drawLabels(canvas);
+            }
+            if (fLayers & kIcons_MapLayer) {
+                this->drawIcons(canvas);
+            }
+            canvas->restore();
+        }
+    }
+
+private:
+    enum { kMajor_RoadClass, kMinor_RoadClass, kPath_RoadClass, kRoadClasses };
+
+    struct Area {
+        SkPath  fPath;
+        SkColor fColor;
+    };
+
+    // Paints are sized in screen pixels, so undo the zoom.
+    SkScalar px(SkScalar pixels) const { return pixels / fZoom; }
+
+    void makeIcon() {
+        fIcon.allocN32Pixels(16, 16);
+        fIcon.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(fIcon);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xFFD0421B);
+        canvas.drawCircle(8, 8, 7, paint);
+        paint.setColor(SK_ColorWHITE);
+        canvas.drawRect(SkRect::MakeLTRB(6, 4, 10, 12), paint);
+        fIcon.setImmutable();
+    }
+
+    void makePaints() {
+        for (int i = 0; i < kRoadClasses; i++) {
+            fRoadPaints[i].setAntiAlias(true);
+            fRoadPaints[i].setStyle(SkPaint::kStroke_Style);
+            fRoadPaints[i].setStrokeCap(SkPaint::kRound_Cap);
+            fRoadPaints[i].setStrokeJoin(SkPaint::kRound_Join);
+        }
+        fRoadPaints[kMajor_RoadClass].setStrokeWidth(this->px(6));
+        fRoadPaints[kMajor_RoadClass].setColor(0xFFFCD6A4);
+        fRoadPaints[kMinor_RoadClass].setStrokeWidth(this->px(3));
+        fRoadPaints[kMinor_RoadClass].setColor(SK_ColorWHITE);
+        fRoadPaints[kPath_RoadClass].setStrokeWidth(this->px(1));
+        fRoadPaints[kPath_RoadClass].setColor(0xFFFA8072);
+        fRoadPaints[kPath_RoadClass].setStrokeCap(SkPaint::kButt_Cap);
+        const SkScalar intervals[] = { this->px(4), this->px(2) };
+        fRoadPaints[kPath_RoadClass].setPathEffect(
+                SkDashPathEffect::Create(intervals, SK_ARRAY_COUNT(intervals), 0))->unref();
+
+        fCasingPaint = fRoadPaints[kMajor_RoadClass];
+        fCasingPaint.setStrokeWidth(this->px(8));
+        fCasingPaint.setColor(0xFFC08A4A);
+
+        fAreaPaint.setAntiAlias(true);
+
+        fLabelPaint.setAntiAlias(true);
+        fLabelPaint.setLCDRenderText(false);
+        fLabelPaint.setTextSize(this->px(11));
+        fLabelPaint.setColor(0xFF333333);
+        fHaloPaint = fLabelPaint;
+        fHaloPaint.setStyle(SkPaint::kStroke_Style);
+        fHaloPaint.setStrokeWidth(this->px(2));
+        fHaloPaint.setColor(SK_ColorWHITE);
+
+        fIconHaloPaint.setAntiAlias(true);
+        fIconHaloPaint.setColor(SK_ColorWHITE);
+        fIconHaloPaint.setMaskFilter(
+                SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 2))->unref();
+        fIconPaint.setFilterQuality(kLow_SkFilterQuality);
+    }
+
+    void drawAreas(SkCanvas* canvas) {
+        for (int i = 0; i < fAreas.count(); i++) {
+            fAreaPaint.setColor(fAreas[i].fColor);
+            canvas->drawPath(fAreas[i].fPath, fAreaPaint);
+        }
+    }
+
+    void drawRoads(SkCanvas* canvas) {
+        // Casings first, so that crossing major roads join up.
+        const SkTArray<SkPath>& major = fRoads[kMajor_RoadClass];
+        for (int i = 0; i < major.count(); i++) {
+            canvas->drawPath(major[i], fCasingPaint);
+        }
+        for (int c = kRoadClasses - 1; c >= 0; c--) {
+            for (int i = 0; i < fRoads[c].count(); i++) {
+                canvas->drawPath(fRoads[c][i], fRoadPaints[c]);
+            }
+        }
+    }
+
+    void drawLabels(SkCanvas* canvas) {
+        static const char* kNames[] = {
+            "Main Street", "High Street", "Station Road", "Church Lane", "Mill Road",
+            "Park Avenue", "Victoria Road", "Green Lane", "Manor Road", "Kings Road",
+        };
+        // Like a map renderer after label collision, only some major roads get a name.
+        const SkTArray<SkPath>& major = fRoads[kMajor_RoadClass];
+        const SkScalar vOffset = this->px(4);
+        for (int i = 0; i < major.count(); i += 8) {
+            const char* name = kNames[(i / 8) % SK_ARRAY_COUNT(kNames)];
+            const size_t len = strlen(name);
+            canvas->drawTextOnPathHV(name, len, major[i], 0, vOffset, fHaloPaint);
+            canvas->drawTextOnPathHV(name, len, major[i], 0, vOffset, fLabelPaint);
+        }
+    }
+
+    void drawIcons(SkCanvas* canvas) {
+        const SkScalar half = SkIntToScalar(fIcon.width()) / 2;
+        for (int i = 0; i < fIcons.count(); i++) {
+            canvas->save();
+            canvas->translate(fIcons[i].fX, fIcons[i].fY);
+            canvas->scale(this->px(1), this->px(1));
+            canvas->drawCircle(0, 0, half + 2, fIconHaloPaint);
+            canvas->drawBitmap(fIcon, -half, -half, &fIconPaint);
+            canvas->restore();
+        }
+    }
+
+    const uint32_t fLayers;
+    const SkScalar fZoom;
+    SkString fName;
+
+    SkTArray<SkPath> fRoads[kRoadClasses];
+    SkTArray<Area> fAreas;
+    SkTArray<SkPoint> fIcons;
+    SkBitmap fIcon;
+
+    SkPaint fRoadPaints[kRoadClasses];
+    SkPaint fCasingPaint;
+    SkPaint fAreaPaint;
+    SkPaint fLabelPaint;
+    SkPaint fHaloPaint;
+    SkPaint fIconHaloPaint;
+    SkPaint fIconPaint;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kRoads_MapLayer,  0.25f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kRoads_MapLayer,  1.0f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kRoads_MapLayer,  4.0f)); )
+
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kAreas_MapLayer,  0.25f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kAreas_MapLayer,  1.0f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kAreas_MapLayer,  4.0f)); )
+
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kLabels_MapLayer, 0.25f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kLabels_MapLayer, 1.0f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kLabels_MapLayer, 4.0f)); )
+
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kIcons_MapLayer,  0.25f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kIcons_MapLayer,  1.0f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kIcons_MapLayer,  4.0f)); )
+
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kAll_MapLayer,    0.25f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kAll_MapLayer,    1.0f)); )
+DEF_BENCH( return SkNEW_ARGS(MapBench, (kAll_MapLayer,    4.0f)); )
@@ -10,6 +10,7 @@
 #include "SkMatrixUtils.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 class MatrixBench : public Benchmark {
     SkString    fName;
@@ -271,26 +272,27 @@ static SkMatrix make_trans() { return SkMatrix::MakeTrans(2, 3); }
 static SkMatrix make_scale() { SkMatrix m(make_trans()); m.postScale(1.5f, 0.5f); return m; }
 static SkMatrix make_afine() { SkMatrix m(make_trans()); m.postRotate(15); return m; }
 
+static SkMatrix make_persp() { SkMatrix m(make_afine()); m.setPerspX(0.001f); return m; }
+
 class MapPointsMatrixBench : public MatrixBench {
 protected:
     SkMatrix fM;
-    enum {
-        N = 32
-    };
-    SkPoint fSrc[N], fDst[N];
+    int fCount;
+    SkAutoTMalloc<SkPoint> fSrc, fDst;
 public:
-    MapPointsMatrixBench(const char name[], const SkMatrix& m)
-        : MatrixBench(name), fM(m)
+    MapPointsMatrixBench(const char name[], const SkMatrix& m, int count = 32)
+        : MatrixBench(name), fM(m), fCount(count), fSrc(count), fDst(count)
     {
         SkRandom rand;
-        for (int i = 0; i < N; ++i) {
+        for (int i = 0; i < fCount; ++i) {
             fSrc[i].set(rand.nextSScalar1(), rand.nextSScalar1());
         }
     }
 
     void performTest() override {
-        for (int i = 0; i < 1000000; ++i) {
-            fM.mapPoints(fDst, fSrc, N);
+        // map the same number of points whatever the array size
+        for (int i = 32000000 / fCount; i > 0; --i) {
+            fM.mapPoints(fDst, fSrc, fCount);
         }
     }
 };
@@ -298,4 +300,32 @@ DEF_BENCH( return new MapPointsMatrixBench("mappoints_identity", SkMatrix::I());
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_trans", make_trans()); )
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_scale", make_scale()); )
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_affine", make_afine()); )
+DEF_BENCH( return new MapPointsMatrixBench("mappoints_persp", make_persp()); )
+DEF_BENCH( return new MapPointsMatrixBench("mappoints_affine_4096", make_afine(), 4096); )
+DEF_BENCH( return new MapPointsMatrixBench("mappoints_persp_4096", make_persp(), 4096); )
+
+class MapRectsMatrixBench : public MatrixBench {
+    SkMatrix fM;
+    SkAutoTMalloc<SkRect> fSrc, fDst;
+    enum {
+        N = 4096
+    };
+public:
+    MapRectsMatrixBench(const char name[], const SkMatrix& m)
+        : MatrixBench(name), fM(m), fSrc(N), fDst(N)
+    {
+        SkRandom rand;
+        for (int i = 0; i < N; ++i) {
+            fSrc[i].setXYWH(rand.nextSScalar1(), rand.nextSScalar1(),
+                            rand.nextUScalar1(), rand.nextUScalar1());
+        }
+    }
 
+    void performTest() override {
+        for (int i = 0; i < 1000; ++i) {
+            fM.mapRects(fDst, fSrc, N);
+        }
+    }
+};
+DEF_BENCH( return new MapRectsMatrixBench("maprects_scale", make_scale()); )
+DEF_BENCH( return new MapRectsMatrixBench("maprects_affine", make_afine()); )
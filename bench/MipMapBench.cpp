@@ -7,29 +7,59 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
 #include "SkMipMap.h"
+#include "SkRandom.h"
+#include "SkString.h"
 
 class MipMapBench: public Benchmark {
-    SkBitmap fBitmap;
+    SkBitmap    fBitmap;
+    SkString    fName;
+    SkColorType fColorType;
+    int         fSize;
+    bool        fGammaCorrect;
 
 public:
-    MipMapBench() {}
+    MipMapBench(SkColorType colorType, int size, bool gammaCorrect = false)
+        : fColorType(colorType)
+        , fSize(size)
+        , fGammaCorrect(gammaCorrect)
+    {
+        const char* name = kRGB_565_SkColorType == colorType ? "565"
+                         : kAlpha_8_SkColorType == colorType ? "a8" : "8888";
+        fName.printf("mipmap_build_%s_%d%s", name, size, gammaCorrect ? "_gamma" : "");
+    }
 
 protected:
     bool isSuitableFor(Backend backend) override {
         return kNonRendering_Backend == backend;
     }
 
-    const char* onGetName() override { return "mipmap_build"; }
+    const char* onGetName() override { return fName.c_str(); }
 
     void onPreDraw() override {
-        fBitmap.allocN32Pixels(1000, 1000, true);
-        fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        const SkAlphaType at = kAlpha_8_SkColorType == fColorType ? kPremul_SkAlphaType
+                                                                 : kOpaque_SkAlphaType;
+        fBitmap.allocPixels(SkImageInfo::Make(fSize, fSize, fColorType, at));
+        // Noise, so we don't read uninitialized memory and every pixel takes some work.
+        SkRandom rand;
+        SkAutoLockPixels alp(fBitmap);
+        for (int y = 0; y < fSize; y++) {
+            uint8_t* row = (uint8_t*)fBitmap.getAddr(0, y);
+            for (size_t i = 0; i < fBitmap.info().minRowBytes(); i++) {
+                row[i] = rand.nextU() & 0xFF;
+            }
+            if (kN32_SkColorType == fColorType) {
+                for (int x = 0; x < fSize; x++) {
+                    *fBitmap.getAddr32(x, y) |= SkPackARGB32(0xFF, 0, 0, 0);
+                }
+            }
+        }
     }
 
     void onDraw(const int loops, SkCanvas*) override {
         for (int i = 0; i < loops; i++) {
-            SkMipMap::Build(fBitmap, NULL)->unref();
+            SkMipMap::Build(fBitmap, NULL, fGammaCorrect)->unref();
         }
     }
 
@@ -37,4 +67,12 @@ private:
     typedef Benchmark INHERITED;
 };
 
-DEF_BENCH( return new MipMapBench; )
+DEF_BENCH( return new MipMapBench(kN32_SkColorType, 1000); )
+DEF_BENCH( return new MipMapBench(kRGB_565_SkColorType, 1000); )
+DEF_BENCH( return new MipMapBench(kAlpha_8_SkColorType, 1000); )
+DEF_BENCH( return new MipMapBench(kN32_SkColorType, 1000, true); )
+
+// Big enough to be built in bands on an SkTaskGroup.
+DEF_BENCH( return new MipMapBench(kN32_SkColorType, 4096); )
+DEF_BENCH( return new MipMapBench(kRGB_565_SkColorType, 4096); )
+DEF_BENCH( return new MipMapBench(kAlpha_8_SkColorType, 4096); )
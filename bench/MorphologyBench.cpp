@@ -94,3 +94,13 @@ DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
 DEF_BENCH( return new MorphologyBench(0, kErode_MT); )
+
+// Radii on both sides of the switch to van Herk/Gil-Werman, whose time shouldn't grow with them.
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(1), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(4), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(8), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(16), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(32), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(64), kDilate_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(16), kErode_MT); )
+DEF_BENCH( return new MorphologyBench(SkIntToScalar(64), kErode_MT); )
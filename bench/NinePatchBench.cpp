@@ -0,0 +1,64 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkNinePatch.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Draws a few hundred nine-patch label backgrounds, one DrawNine call each or all of them with a
+// single DrawNineBatch call.
+class NinePatchBench : public Benchmark {
+public:
+    NinePatchBench(bool batch) : fBatch(batch) {
+        fName.printf("ninepatch_%s", batch ? "batch" : "rects");
+    }
+
+protected:
+    static const int kCount = 300;
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw() override {
+        fBitmap.allocN32Pixels(32, 32);
+        fBitmap.eraseColor(SK_ColorBLUE);
+        fBitmap.eraseArea(SkIRect::MakeLTRB(8, 8, 24, 24), SK_ColorWHITE);
+
+        SkRandom rand;
+        for (int i = 0; i < kCount; i++) {
+            SkScalar x = rand.nextRangeScalar(0, 540);
+            SkScalar y = rand.nextRangeScalar(0, 460);
+            fRects[i].setXYWH(x, y, rand.nextRangeScalar(12, 100), rand.nextRangeScalar(12, 40));
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        const SkIRect margins = SkIRect::MakeLTRB(8, 8, 8, 8);
+        for (int loop = 0; loop < loops; loop++) {
+            if (fBatch) {
+                SkNinePatch::DrawNineBatch(canvas, fRects, kCount, fBitmap, margins);
+            } else {
+                for (int i = 0; i < kCount; i++) {
+                    SkNinePatch::DrawNine(canvas, fRects[i], fBitmap, margins);
+                }
+            }
+        }
+    }
+
+private:
+    bool     fBatch;
+    SkString fName;
+    SkBitmap fBitmap;
+    SkRect   fRects[kCount];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new NinePatchBench(false); )
+DEF_BENCH( return new NinePatchBench(true); )
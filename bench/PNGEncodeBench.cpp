@@ -0,0 +1,137 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+/**
+ *  Time SkImageEncoder's PNG encoder with each of its settings. Every loop encodes one
+ *  kSize x kSize kN32 image, i.e. 256KB of pixels, so the encode rate in MB/s is
+ *  250 / (the reported ms per loop).
+ */
+class PNGEncodeBench : public Benchmark {
+public:
+    enum Image {
+        // A handful of flat colors, like a map tile.
+        kTile_Image,
+        // A noisy gradient, with far more than 256 colors.
+        kPhoto_Image,
+    };
+
+    PNGEncodeBench(Image image, int zlibLevel, SkImageEncoder::PNGFilter filter, bool palettize)
+        : fImage(image)
+        , fZLibLevel(zlibLevel)
+        , fFilter(filter)
+        , fPalettize(palettize)
+    {
+        static const char* gFilterNames[] = { "default", "none", "sub", "up", "adaptive" };
+        fName.printf("png_encode_%s_z%d_%s%s", kTile_Image == image ? "tile" : "photo",
+                     zlibLevel, gFilterNames[filter], palettize ? "_palette" : "");
+    }
+
+protected:
+    enum {
+        kSize = 256
+    };
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onPreDraw() override {
+        fBitmap.allocN32Pixels(kSize, kSize, true);
+        SkRandom rand;
+        static const SkPMColor gTileColors[] = {
+            SkPackARGB32(0xFF, 0xF2, 0xEF, 0xE9),
+            SkPackARGB32(0xFF, 0xAA, 0xD3, 0xDF),
+            SkPackARGB32(0xFF, 0xFF, 0xFF, 0xFF),
+            SkPackARGB32(0xFF, 0xF7, 0xFA, 0xBF),
+            SkPackARGB32(0xFF, 0xC8, 0xFA, 0xCC),
+        };
+        for (int y = 0; y < kSize; y++) {
+            SkPMColor* row = fBitmap.getAddr32(0, y);
+            for (int x = 0; x < kSize; x++) {
+                if (kTile_Image == fImage) {
+                    // Blocks of flat color, crossed by roads.
+                    const int block = ((x / 48) * 7 + (y / 40) * 3) % 4;
+                    const bool road = (x % 48) < 3 || (y % 40) < 3;
+                    row[x] = gTileColors[road ? 4 : block];
+                } else {
+                    const int noise = rand.nextRangeU(0, 15);
+                    row[x] = SkPackARGB32(0xFF, x ^ noise, y ^ noise, (x + y) / 2);
+                }
+            }
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkAutoTDelete<SkImageEncoder> encoder(SkImageEncoder::Create(SkImageEncoder::kPNG_Type));
+        if (!encoder) {
+            return;
+        }
+        encoder->setZLibLevel(fZLibLevel);
+        encoder->setPNGFilter(fFilter);
+        encoder->setPalettize(fPalettize);
+        for (int i = 0; i < loops; i++) {
+            SkDynamicMemoryWStream stream;
+            encoder->encodeStream(&stream, fBitmap, SkImageEncoder::kDefaultQuality);
+        }
+    }
+
+private:
+    const Image                     fImage;
+    const int                       fZLibLevel;
+    const SkImageEncoder::PNGFilter fFilter;
+    const bool                      fPalettize;
+    SkString                        fName;
+    SkBitmap                        fBitmap;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 6,
+                                             SkImageEncoder::kDefault_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 1,
+                                             SkImageEncoder::kNone_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 1,
+                                             SkImageEncoder::kSub_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 1,
+                                             SkImageEncoder::kUp_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 1,
+                                             SkImageEncoder::kAdaptive_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 9,
+                                             SkImageEncoder::kAdaptive_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 1,
+                                             SkImageEncoder::kNone_PNGFilter, true)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kTile_Image, 6,
+                                             SkImageEncoder::kNone_PNGFilter, true)); )
+
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 6,
+                                             SkImageEncoder::kDefault_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 1,
+                                             SkImageEncoder::kNone_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 1,
+                                             SkImageEncoder::kSub_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 1,
+                                             SkImageEncoder::kUp_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 1,
+                                             SkImageEncoder::kAdaptive_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 9,
+                                             SkImageEncoder::kAdaptive_PNGFilter, false)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 1,
+                                             SkImageEncoder::kNone_PNGFilter, true)); )
+DEF_BENCH( return SkNEW_ARGS(PNGEncodeBench, (PNGEncodeBench::kPhoto_Image, 6,
+                                             SkImageEncoder::kNone_PNGFilter, true)); )
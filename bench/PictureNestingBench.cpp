@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkBBHFactory.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkNullCanvas.h"
@@ -182,3 +183,67 @@ DEF_BENCH( return new PictureNestingPlayback(8, 5); )
 DEF_BENCH( return new PictureNestingPlayback(8, 6); )
 DEF_BENCH( return new PictureNestingPlayback(8, 7); )
 DEF_BENCH( return new PictureNestingPlayback(8, 8); )
+
+// Draws small windows of one huge picture, recorded flat, flat with a BBH, or split into tiles
+// with their own BBHs by SkPictureRecorder::endRecordingAsTiles().
+class PictureTilesPlayback : public Benchmark {
+public:
+    enum Mode {
+        kFlat_Mode,
+        kFlatBBH_Mode,
+        kTiles_Mode,
+    };
+
+    PictureTilesPlayback(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "flat", "flat_bbh", "tiles" };
+        fName.printf("picture_nesting_tiles_%s", kNames[mode]);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize,
+                                                   kFlat_Mode == fMode ? NULL : &factory);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int y = 0; y < kSize; y += 32) {
+            for (int x = 0; x < kSize; x += 32) {
+                paint.setColor(SkColorSetRGB(x & 0xFF, y & 0xFF, 0x80));
+                canvas->drawCircle(SkIntToScalar(x + 16), SkIntToScalar(y + 16), 12, paint);
+            }
+        }
+        fPicture.reset(kTiles_Mode == fMode ? recorder.endRecordingAsTiles(512, 512, &factory)
+                                            : recorder.endRecording());
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            // Walk a window diagonally across the picture.
+            const SkScalar offset = SkIntToScalar((i * 97) % (kSize - kWindow));
+            canvas->save();
+            canvas->clipRect(SkRect::MakeWH(kWindow, kWindow));
+            canvas->translate(-offset, -offset);
+            canvas->drawPicture(fPicture);
+            canvas->restore();
+        }
+    }
+
+private:
+    static const int kSize = 8192;
+    static const int kWindow = 256;
+
+    Mode fMode;
+    SkString fName;
+    SkAutoTUnref<SkPicture> fPicture;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PictureTilesPlayback(PictureTilesPlayback::kFlat_Mode); )
+DEF_BENCH( return new PictureTilesPlayback(PictureTilesPlayback::kFlatBBH_Mode); )
+DEF_BENCH( return new PictureTilesPlayback(PictureTilesPlayback::kTiles_Mode); )
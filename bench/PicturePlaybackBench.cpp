@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "SkBBHFactory.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkCompiledPicture.h"
+#include "SkImageGenerator.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
@@ -14,6 +17,7 @@
 #include "SkRandom.h"
 #include "SkRect.h"
 #include "SkString.h"
+#include "SkThreadUtils.h"
 
 // This is designed to emulate about 4 screens of textual content
 
@@ -144,7 +148,7 @@ DEF_BENCH( return new PosTextPlaybackBench(false); )
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
 // both when querying tiles perfectly and when not.
-enum BBH  { kNone, kRTree };
+enum BBH  { kNone, kRTree, kTileGrid };
 enum Mode { kTiled, kRandom };
 class TiledPlaybackBench : public Benchmark {
 public:
@@ -152,6 +156,7 @@ public:
         switch (fBBH) {
             case kNone:     fName.append("_none"    ); break;
             case kRTree:    fName.append("_rtree"   ); break;
+            case kTileGrid: fName.append("_tilegrid"); break;
         }
         switch (fMode) {
             case kTiled:  fName.append("_tiled" ); break;
@@ -167,6 +172,14 @@ public:
         switch (fBBH) {
             case kNone:                                                 break;
             case kRTree:    factory.reset(new SkRTreeFactory);          break;
+            case kTileGrid: {
+                SkTileGridFactory::TileGridInfo info;
+                info.fTileInterval.set(256, 256);
+                info.fMargin.setEmpty();
+                info.fOffset.setZero();
+                factory.reset(new SkTileGridFactory(info));
+                break;
+            }
         }
 
         SkPictureRecorder recorder;
@@ -217,3 +230,203 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+DEF_BENCH( return new TiledPlaybackBench(kTileGrid, kRandom); )
+DEF_BENCH( return new TiledPlaybackBench(kTileGrid, kTiled ); )
+
+// Several threads play back the same picture, each into its own tile, as a raster tile worker
+// pool does.  The total work per loop is fixed, so with no contention between the threads the
+// time per loop should fall as the thread count rises, until we run out of cores.
+class ThreadedPlaybackBench : public Benchmark {
+public:
+    explicit ThreadedPlaybackBench(int threads) : fThreads(threads) {
+        fName.printf("picture_playback_threads_%d", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    enum {
+        kPictureSize     = 1024,
+        kTileSize        = 256,
+        kTilesPerLoop    = 32,
+    };
+
+protected:
+    void onPreDraw() override {
+        // The bitmaps are lazily generated, so drawing them has to lock a discardable pixel ref.
+        SkBitmap bitmaps[4];
+        for (int i = 0; i < 4; i++) {
+            SkInstallDiscardablePixelRef(SkNEW_ARGS(CheckerGenerator, (i)), &bitmaps[i]);
+        }
+
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kPictureSize, kPictureSize, &factory);
+            SkRandom rand;
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            for (int i = 0; i < 2000; i++) {
+                SkScalar x = rand.nextRangeScalar(0, kPictureSize),
+                         y = rand.nextRangeScalar(0, kPictureSize);
+                paint.setColor(rand.nextU() | 0xFF000000);
+                switch (i % 3) {
+                    case 0:
+                        canvas->drawRect(SkRect::MakeXYWH(x, y, 40, 30), paint);
+                        break;
+                    case 1:
+                        canvas->drawCircle(x, y, 20, paint);
+                        break;
+                    case 2:
+                        canvas->drawBitmapRect(bitmaps[i % 4], SkRect::MakeXYWH(x, y, 48, 48),
+                                               &paint);
+                        break;
+                }
+            }
+        fPicture.reset(recorder.endRecording());
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkAutoTArray<Worker> workers(fThreads);
+        SkTDArray<SkThread*> threads;
+        for (int i = 0; i < fThreads; i++) {
+            workers[i].fPicture   = fPicture;
+            workers[i].fFirst     = i;
+            workers[i].fStride    = fThreads;
+            workers[i].fPlaybacks = loops * kTilesPerLoop;
+            *threads.append() = SkNEW_ARGS(SkThread, (Worker::Run, &workers[i]));
+        }
+        for (int i = 0; i < fThreads; i++) {
+            threads[i]->start();
+        }
+        for (int i = 0; i < fThreads; i++) {
+            threads[i]->join();
+        }
+        threads.deleteAll();
+    }
+
+private:
+    class CheckerGenerator : public SkImageGenerator {
+    public:
+        explicit CheckerGenerator(int seed)
+            : INHERITED(SkImageInfo::MakeN32Premul(64, 64))
+            , fSeed(seed) {}
+
+    protected:
+        Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                           const Options&, SkPMColor[], int*) override {
+            if (info.colorType() != kN32_SkColorType) {
+                return kInvalidConversion;
+            }
+            for (int y = 0; y < info.height(); y++) {
+                SkPMColor* row = (SkPMColor*)((char*)pixels + y * rowBytes);
+                for (int x = 0; x < info.width(); x++) {
+                    row[x] = ((x ^ y ^ fSeed) & 8) ? 0xFF808080 : 0xFFFFFFFF;
+                }
+            }
+            return kSuccess;
+        }
+
+    private:
+        int fSeed;
+
+        typedef SkImageGenerator INHERITED;
+    };
+
+    // Plays back tiles fFirst, fFirst + fStride, ... until fPlaybacks have been drawn overall.
+    struct Worker {
+        const SkPicture* fPicture;
+        int fFirst, fStride, fPlaybacks;
+
+        static void Run(void* arg) {
+            const Worker* worker = (const Worker*)arg;
+            const int tiles = kPictureSize / kTileSize;
+
+            SkBitmap bitmap;
+            bitmap.allocN32Pixels(kTileSize, kTileSize);
+            SkCanvas canvas(bitmap);
+            for (int i = worker->fFirst; i < worker->fPlaybacks; i += worker->fStride) {
+                const int tile = i % (tiles * tiles);
+                SkAutoCanvasRestore acr(&canvas, true/*save now*/);
+                canvas.translate(-SkIntToScalar(kTileSize * (tile % tiles)),
+                                 -SkIntToScalar(kTileSize * (tile / tiles)));
+                worker->fPicture->playback(&canvas);
+            }
+        }
+    };
+
+    int                     fThreads;
+    SkString                fName;
+    SkAutoTUnref<SkPicture> fPicture;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ThreadedPlaybackBench(1); )
+DEF_BENCH( return new ThreadedPlaybackBench(2); )
+DEF_BENCH( return new ThreadedPlaybackBench(4); )
+DEF_BENCH( return new ThreadedPlaybackBench(8); )
+DEF_BENCH( return new ThreadedPlaybackBench(16); )
+DEF_BENCH( return new ThreadedPlaybackBench(32); )
+
+// A static overlay of small anti-aliased shapes, drawn over and over at the same matrix, either
+// scan converted each time or blitted from an SkCompiledPicture's masks.
+class CompiledPlaybackBench : public Benchmark {
+public:
+    explicit CompiledPlaybackBench(bool compiled) : fCompiled(compiled) {
+        fName.printf("compiled_playback_%s", compiled ? "compiled" : "plain");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024, 1024); }
+
+    void onPreDraw() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+            SkRandom rand;
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            for (int i = 0; i < 1000; i++) {
+                SkScalar x = rand.nextRangeScalar(0, 1024),
+                         y = rand.nextRangeScalar(0, 1024);
+                paint.setColor(rand.nextU() | 0x80000000);
+                paint.setStyle(SkPaint::kFill_Style);
+                canvas->drawCircle(x, y, rand.nextRangeScalar(4, 12), paint);
+
+                SkPath path;
+                path.moveTo(x, y);
+                path.quadTo(x + rand.nextRangeScalar(-40, 40), y + rand.nextRangeScalar(-40, 40),
+                            x + rand.nextRangeScalar(-40, 40), y + rand.nextRangeScalar(-40, 40));
+                paint.setStyle(SkPaint::kStroke_Style);
+                paint.setStrokeWidth(2);
+                canvas->drawPath(path, paint);
+            }
+        fPic.reset(recorder.endRecording());
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        if (fCompiled && (!fCompiledPic || fCompiledPic->matrix() != canvas->getTotalMatrix())) {
+            fCompiledPic.reset(SkCompiledPicture::Create(fPic, canvas->getTotalMatrix()));
+        }
+        for (int i = 0; i < loops; i++) {
+            if (fCompiled) {
+                fCompiledPic->playback(canvas);
+            } else {
+                fPic->playback(canvas);
+            }
+        }
+    }
+
+private:
+    bool                              fCompiled;
+    SkString                          fName;
+    SkAutoTUnref<SkPicture>           fPic;
+    SkAutoTDelete<SkCompiledPicture>  fCompiledPic;
+};
+
+DEF_BENCH( return new CompiledPlaybackBench(false); )
+DEF_BENCH( return new CompiledPlaybackBench(true); )
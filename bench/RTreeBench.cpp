@@ -15,6 +15,7 @@
 static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
+static const int NUM_LARGE_RECTS = 100000;  // Roughly the op count of a large map picture.
 static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
@@ -22,7 +23,9 @@ typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
+    RTreeBuildBench(const char* name, MakeRectProc proc, int numRects = NUM_BUILD_RECTS)
+        : fProc(proc)
+        , fNumRects(numRects) {
         fName.printf("rtree_%s_build", name);
     }
 
@@ -36,19 +39,20 @@ protected:
     }
     void onDraw(const int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_BUILD_RECTS);
-        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
 
         for (int i = 0; i < loops; ++i) {
             SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            tree.insert(rects.get(), fNumRects);
             SkASSERT(rects != NULL);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    int fNumRects;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -56,7 +60,9 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
+    RTreeQueryBench(const char* name, MakeRectProc proc, int numRects = NUM_QUERY_RECTS)
+        : fProc(proc)
+        , fNumRects(numRects) {
         fName.printf("rtree_%s_query", name);
     }
 
@@ -69,11 +75,11 @@ protected:
     }
     void onPreDraw() override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.insert(rects.get(), fNumRects);
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -91,6 +97,7 @@ protected:
 private:
     SkRTree fTree;
     MakeRectProc fProc;
+    int fNumRects;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -136,3 +143,13 @@ DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY",         &make_XYordered_rect
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("YX",         &make_YXordered_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random",     &make_random_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("concentric", &make_concentric_rects)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("XY_100k",     &make_XYordered_rects,
+                                              NUM_LARGE_RECTS)));
+DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, ("random_100k", &make_random_rects,
+                                              NUM_LARGE_RECTS)));
+
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY_100k",     &make_XYordered_rects,
+                                              NUM_LARGE_RECTS)));
+DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random_100k", &make_random_rects,
+                                              NUM_LARGE_RECTS)));
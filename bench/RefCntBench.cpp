@@ -153,6 +153,37 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+class NVRefCntObj : public SkNVRefCnt<NVRefCntObj> {
+};
+
+class NVRefCntBench_New : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() {
+        return "ref_cnt_new_nv";
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) {
+        for (int i = 0; i < loops; ++i) {
+            NVRefCntObj* ref = new NVRefCntObj();
+            for (int j = 0; j < M; ++j) {
+                ref->ref();
+                ref->unref();
+            }
+            ref->unref();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class WeakRefCntBench_Stack : public Benchmark {
 public:
     bool isSuitableFor(Backend backend) override {
@@ -245,6 +276,7 @@ DEF_BENCH( return new AtomicInc64(); )
 DEF_BENCH( return new RefCntBench_Stack(); )
 DEF_BENCH( return new RefCntBench_Heap(); )
 DEF_BENCH( return new RefCntBench_New(); )
+DEF_BENCH( return new NVRefCntBench_New(); )
 
 DEF_BENCH( return new WeakRefCntBench_Stack(); )
 DEF_BENCH( return new WeakRefCntBench_Heap(); )
@@ -84,12 +84,14 @@ static void convert_to_index666(const SkBitmap& src, SkBitmap* dst) {
 class RepeatTileBench : public Benchmark {
     const SkColorType   fColorType;
     const SkAlphaType   fAlphaType;
+    const SkShader::TileMode fTileMode;
     SkPaint             fPaint;
     SkString            fName;
     SkBitmap            fBitmap;
 public:
-    RepeatTileBench(SkColorType ct, SkAlphaType at = kPremul_SkAlphaType)
-        : fColorType(ct), fAlphaType(at)
+    RepeatTileBench(SkColorType ct, SkAlphaType at = kPremul_SkAlphaType,
+                    SkShader::TileMode tm = SkShader::kRepeat_TileMode)
+        : fColorType(ct), fAlphaType(at), fTileMode(tm)
     {
         const int w = 50;
         const int h = 50;
@@ -99,7 +101,7 @@ public:
         } else {
             fBitmap.setInfo(SkImageInfo::Make(w, h, ct, at));
         }
-        fName.printf("repeatTile_%s_%c",
+        fName.printf("%sTile_%s_%c", SkShader::kMirror_TileMode == tm ? "mirror" : "repeat",
                      sk_tool_utils::colortype_name(ct), kOpaque_SkAlphaType == at ? 'X' : 'A');
     }
 
@@ -120,9 +122,7 @@ protected:
             fBitmap = tmp;
         }
 
-        SkShader* s = SkShader::CreateBitmapShader(fBitmap,
-                                                   SkShader::kRepeat_TileMode,
-                                                   SkShader::kRepeat_TileMode);
+        SkShader* s = SkShader::CreateBitmapShader(fBitmap, fTileMode, fTileMode);
         fPaint.setShader(s)->unref();
     }
 
@@ -144,3 +144,12 @@ DEF_BENCH(return new RepeatTileBench(kN32_SkColorType, kOpaque_SkAlphaType))
 DEF_BENCH(return new RepeatTileBench(kN32_SkColorType, kPremul_SkAlphaType))
 DEF_BENCH(return new RepeatTileBench(kRGB_565_SkColorType, kOpaque_SkAlphaType))
 DEF_BENCH(return new RepeatTileBench(kIndex_8_SkColorType, kPremul_SkAlphaType))
+
+DEF_BENCH(return new RepeatTileBench(kN32_SkColorType, kOpaque_SkAlphaType,
+                                     SkShader::kMirror_TileMode))
+DEF_BENCH(return new RepeatTileBench(kN32_SkColorType, kPremul_SkAlphaType,
+                                     SkShader::kMirror_TileMode))
+DEF_BENCH(return new RepeatTileBench(kRGB_565_SkColorType, kOpaque_SkAlphaType,
+                                     SkShader::kMirror_TileMode))
+DEF_BENCH(return new RepeatTileBench(kIndex_8_SkColorType, kPremul_SkAlphaType,
+                                     SkShader::kMirror_TileMode))
@@ -46,6 +46,9 @@ public:
     // Record a single test metric.
     virtual void metric(const char name[], double ms) {}
 
+    // Record every sample that went into a metric, in the order they were measured.
+    virtual void samples(const char name[], const double ms[], int count) {}
+
     // Flush to storage now please.
     virtual void flush() {}
 };
@@ -68,6 +71,7 @@ public:
            "8888" : {
                  "median_ms" : 143.188128906250,
                  "min_ms" : 143.835957031250,
+                 "samples_ms" : [ 143.835957031250, 145.324035644531, ... ],
                  ...
               },
           ...
@@ -113,6 +117,14 @@ public:
         SkASSERT(fConfig);
         (*fConfig)[name] = ms;
     }
+    virtual void samples(const char name[], const double ms[], int count) {
+        SkASSERT(fConfig);
+        Json::Value& array = (*fConfig)[name] = Json::Value(Json::arrayValue);
+        for (int i = 0; i < count; i++) {
+            // JSON has no nan, so keep the others in order with null in its place.
+            array.append(sk_double_isnan(ms[i]) ? Json::Value() : Json::Value(ms[i]));
+        }
+    }
 
     // Flush to storage now please.
     virtual void flush() {
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SKPAnimationBench.h"
+#include "SkCanvas.h"
+
+SKPAnimationBench::SKPAnimationBench(const char* name, const SkPicture* pic, const SkIRect& clip,
+                                     const SkTArray<SkScalar>& scales, int frames)
+    : fPic(SkRef(pic))
+    , fClip(clip)
+    , fScales(scales)
+    , fFrames(SkTMax(frames, 1))
+    , fFrame(0)
+    , fName(name) {
+    SkASSERT(fScales.count() > 0);
+    fUniqueName.printf("%s_animation", name);
+}
+
+const char* SKPAnimationBench::onGetName() {
+    return fName.c_str();
+}
+
+const char* SKPAnimationBench::onGetUniqueName() {
+    return fUniqueName.c_str();
+}
+
+void SKPAnimationBench::onPerCanvasPreDraw(SkCanvas*) {
+    // Every target sees the same animation from its start.
+    fFrame = 0;
+}
+
+bool SKPAnimationBench::isSuitableFor(Backend backend) {
+    return backend != kNonRendering_Backend;
+}
+
+SkIPoint SKPAnimationBench::onGetSize() {
+    return SkIPoint::Make(fClip.width(), fClip.height());
+}
+
+SkMatrix SKPAnimationBench::frameMatrix(int frame) const {
+    const SkScalar t = SkIntToScalar(frame % fFrames) / fFrames;
+
+    // Zoom linearly from each scale to the next, ending back at the first.
+    const SkScalar u = t * fScales.count();
+    const int i = SkScalarFloorToInt(u);
+    const SkScalar scale = fScales[i] +
+                           (fScales[(i + 1) % fScales.count()] - fScales[i]) * (u - i);
+
+    // Pan from the top left of the scaled picture to its bottom right and back.
+    const SkScalar pan = SK_Scalar1 - SkScalarAbs(2 * t - SK_Scalar1);
+    const SkRect& cull = fPic->cullRect();
+    const SkScalar dx = SkTMax<SkScalar>(0, cull.width()  * scale - fClip.width())  * pan;
+    const SkScalar dy = SkTMax<SkScalar>(0, cull.height() * scale - fClip.height()) * pan;
+
+    SkMatrix matrix;
+    matrix.setScale(scale, scale);
+    matrix.postTranslate(-dx, -dy);
+    return matrix;
+}
+
+void SKPAnimationBench::onDraw(const int loops, SkCanvas* canvas) {
+    for (int i = 0; i < loops; i++) {
+        const SkMatrix matrix = this->frameMatrix(fFrame++);
+        canvas->drawPicture(fPic, &matrix, NULL);
+    }
+}
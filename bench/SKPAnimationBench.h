@@ -0,0 +1,47 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKPAnimationBench_DEFINED
+#define SKPAnimationBench_DEFINED
+
+#include "Benchmark.h"
+#include "SkPicture.h"
+#include "SkTArray.h"
+
+/**
+ * Plays an SkPicture back as an animation: each loop draws the next frame, zooming smoothly
+ * through the given scales while panning across the picture and back.  Meant to be timed frame
+ * by frame, so that slow frames (cache misses, evictions, uploads) are visible, not averaged away.
+ */
+class SKPAnimationBench : public Benchmark {
+public:
+    SKPAnimationBench(const char* name, const SkPicture*, const SkIRect& devClip,
+                      const SkTArray<SkScalar>& scales, int frames);
+
+protected:
+    const char* onGetName() override;
+    const char* onGetUniqueName() override;
+    void onPerCanvasPreDraw(SkCanvas*) override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(const int loops, SkCanvas* canvas) override;
+    SkIPoint onGetSize() override;
+
+private:
+    SkMatrix frameMatrix(int frame) const;
+
+    SkAutoTUnref<const SkPicture> fPic;
+    const SkIRect fClip;
+    SkTArray<SkScalar> fScales;
+    const int fFrames;
+    int fFrame;
+    SkString fName;
+    SkString fUniqueName;
+
+    typedef Benchmark INHERITED;
+};
+
+#endif
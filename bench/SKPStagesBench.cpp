@@ -0,0 +1,139 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SKPStagesBench.h"
+#include "Timer.h"
+#include "SkCanvas.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecordOpts.h"
+#include "SkRecorder.h"
+#include "SkRTree.h"
+
+const char* SKPStagesBench::StageName(Stage stage) {
+    static const char* kNames[] = {
+        "record",
+        "optimize",
+        "bounds",
+        "bbh",
+        "cull",
+        "raster",
+        "flush",
+    };
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kNames) == kStageCount, missing_stage_name);
+    return kNames[stage];
+}
+
+SKPStagesBench::SKPStagesBench(const char* name, const SkPicture* pic, const SkIRect& clip,
+                               SkScalar scale, bool useBBH)
+    : fSrc(SkRef(pic))
+    , fClip(clip)
+    , fScale(scale)
+    , fUseBBH(useBBH)
+    , fName(name) {
+    fUniqueName.printf("%s_%.2g_stages", name, scale);
+}
+
+const char* SKPStagesBench::onGetName() {
+    return fName.c_str();
+}
+
+const char* SKPStagesBench::onGetUniqueName() {
+    return fUniqueName.c_str();
+}
+
+bool SKPStagesBench::isSuitableFor(Backend backend) {
+    return backend != kNonRendering_Backend;
+}
+
+SkIPoint SKPStagesBench::onGetSize() {
+    return SkIPoint::Make(fClip.width(), fClip.height());
+}
+
+void SKPStagesBench::onDraw(const int loops, SkCanvas* canvas) {
+    double ms[kStageCount] = { 0 };
+    for (int i = 0; i < loops; i++) {
+        this->drawStages(canvas, ms);
+    }
+}
+
+namespace {
+
+// Adds the time from its construction to the first lap() to one stage, the time from there
+// to the next lap() to another, and so on.
+class StageTimer {
+public:
+    explicit StageTimer(double ms[]) : fMs(ms) { fTimer.start(); }
+
+    void lap(SKPStagesBench::Stage stage) {
+        fTimer.end();
+        fMs[stage] += fTimer.fWall;
+        fTimer.start();
+    }
+
+private:
+    double* fMs;
+    WallTimer fTimer;
+};
+
+}  // namespace
+
+void SKPStagesBench::drawStages(SkCanvas* canvas, double ms[kStageCount]) {
+    const SkRect cull = fSrc->cullRect();
+    StageTimer timer(ms);
+
+    SkRecord record;
+    SkRecorder recorder(&record, cull);
+    fSrc->playback(&recorder);
+    timer.lap(kRecord_Stage);
+
+    SkRecordOptimize(&record);
+    timer.lap(kOptimize_Stage);
+
+    SkAutoTDelete<SkRTree> bbh;
+    if (fUseBBH) {
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkRecordFillBounds(cull, record, bounds.get());
+        timer.lap(kBounds_Stage);
+
+        bbh.reset(SkNEW(SkRTree));
+        bbh->insert(bounds.get(), record.count());
+        timer.lap(kBBH_Stage);
+    }
+
+    SkAutoCanvasRestore acr(canvas, true/*save now*/);
+    canvas->clipRect(SkRect::Make(fClip));
+    canvas->scale(fScale, fScale);
+
+    // This is the same search SkRecordDraw() makes: the clip back in the picture's space.
+    SkTDArray<unsigned> ops;
+    if (bbh) {
+        SkRect query;
+        if (!canvas->getClipBounds(&query)) {
+            query.setEmpty();
+        }
+        bbh->search(query, &ops);
+    } else {
+        ops.setCount(record.count());
+        for (unsigned i = 0; i < record.count(); i++) {
+            ops[i] = i;
+        }
+    }
+    timer.lap(kCull_Stage);
+
+    {
+        SkAutoCanvasRestore playback(canvas, true/*save now*/);
+        SkRecords::Draw draw(canvas, NULL, NULL, 0);
+        for (int i = 0; i < ops.count(); i++) {
+            record.visit<void>(ops[i], draw);
+        }
+    }
+    timer.lap(kRaster_Stage);
+
+    canvas->flush();
+    timer.lap(kFlush_Stage);
+}
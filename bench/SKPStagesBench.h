@@ -0,0 +1,61 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKPStagesBench_DEFINED
+#define SKPStagesBench_DEFINED
+
+#include "Benchmark.h"
+#include "SkPicture.h"
+
+/**
+ * Records an SkPicture anew and plays it back scaled inside a device clip, like RecordingBench
+ * and SKPBench together, but one step at a time so that each step can be timed on its own.
+ */
+class SKPStagesBench : public Benchmark {
+public:
+    enum Stage {
+        kRecord_Stage,    // Capturing the picture's ops with an SkRecorder.
+        kOptimize_Stage,  // SkRecordOptimize().
+        kBounds_Stage,    // Finding each op's bounds for the BBH.
+        kBBH_Stage,       // Inserting those bounds into an SkRTree.
+        kCull_Stage,      // Searching the BBH for the ops inside the clip.
+        kRaster_Stage,    // Drawing those ops.
+        kFlush_Stage,     // Flushing the canvas, e.g. submitting GPU work.
+
+        kLast_Stage = kFlush_Stage
+    };
+    static const int kStageCount = kLast_Stage + 1;
+
+    // The name of a stage, suitable as part of a key in JSON results.
+    static const char* StageName(Stage);
+
+    SKPStagesBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
+                   bool useBBH);
+
+    // Record and draw the picture once, adding to ms how many milliseconds each stage took.
+    // Without a BBH, the bounds, BBH, and cull stages take no time and every op is drawn.
+    void drawStages(SkCanvas*, double ms[kStageCount]);
+
+protected:
+    const char* onGetName() override;
+    const char* onGetUniqueName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(const int loops, SkCanvas* canvas) override;
+    SkIPoint onGetSize() override;
+
+private:
+    SkAutoTUnref<const SkPicture> fSrc;
+    const SkIRect fClip;
+    const SkScalar fScale;
+    const bool fUseBBH;
+    SkString fName;
+    SkString fUniqueName;
+
+    typedef Benchmark INHERITED;
+};
+
+#endif
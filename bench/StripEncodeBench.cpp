@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkImageEncoder.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+/**
+ *  Time encoding a large bitmap serially, and in strips on SkTaskGroup threads (see
+ *  SkImageEncoder::setParallel()). Every loop encodes kSize x kSize kN32 pixels, 16MB, so the
+ *  encode rate in MB/s is 16000 / (the reported ms per loop).
+ */
+class StripEncodeBench : public Benchmark {
+public:
+    StripEncodeBench(SkImageEncoder::Type type, bool parallel)
+        : fType(type)
+        , fParallel(parallel)
+    {
+        fName.printf("encode_%s_%d_%s", SkImageEncoder::kPNG_Type == type ? "png" : "jpeg",
+                     kSize, parallel ? "parallel" : "serial");
+    }
+
+protected:
+    enum {
+        kSize = 2048
+    };
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onPreDraw() override {
+        // Smooth gradients with some edges, more like a composited map or photo than noise.
+        fBitmap.allocN32Pixels(kSize, kSize, true);
+        for (int y = 0; y < kSize; y++) {
+            SkPMColor* row = fBitmap.getAddr32(0, y);
+            for (int x = 0; x < kSize; x++) {
+                const int edge = ((x / 128) + (y / 96)) & 1 ? 0x40 : 0;
+                row[x] = SkPackARGB32(0xFF, (x >> 3) & 0xFF, (y >> 3) & 0xFF,
+                                      (((x + y) >> 4) & 0xBF) | edge);
+            }
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        SkAutoTDelete<SkImageEncoder> encoder(SkImageEncoder::Create(fType));
+        if (!encoder) {
+            return;
+        }
+        encoder->setParallel(fParallel);
+        for (int i = 0; i < loops; i++) {
+            SkDynamicMemoryWStream stream;
+            encoder->encodeStream(&stream, fBitmap, SkImageEncoder::kDefaultQuality);
+        }
+    }
+
+private:
+    const SkImageEncoder::Type  fType;
+    const bool                  fParallel;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(StripEncodeBench, (SkImageEncoder::kPNG_Type, false)); )
+DEF_BENCH( return SkNEW_ARGS(StripEncodeBench, (SkImageEncoder::kPNG_Type, true)); )
+DEF_BENCH( return SkNEW_ARGS(StripEncodeBench, (SkImageEncoder::kJPEG_Type, false)); )
+DEF_BENCH( return SkNEW_ARGS(StripEncodeBench, (SkImageEncoder::kJPEG_Type, true)); )
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "Benchmark.h"
+#include "SkAtomics.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+
+// Measures the overhead of scheduling tiny tasks on the global thread pool, which nanobench
+// sizes to the machine's core count.
+class TaskGroupBench : public Benchmark {
+public:
+    enum Mode {
+        kAdd_Mode,      // one add() per task, from this thread
+        kBatch_Mode,    // one batch() for all the tasks
+        kNested_Mode,   // tasks that each add() more tasks from inside the pool
+    };
+
+    TaskGroupBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "add", "batch", "nested" };
+        fName.printf("taskgroup_%s", kNames[mode]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        static const int kTasks = 1000;
+        int32_t counters[kTasks];
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup tg;
+            switch (fMode) {
+                case kAdd_Mode:
+                    for (int j = 0; j < kTasks; j++) {
+                        tg.add(Increment, &counters[j]);
+                    }
+                    break;
+                case kBatch_Mode:
+                    tg.batch(Increment, counters, kTasks);
+                    break;
+                case kNested_Mode:
+                    // 40 spawners, each adding 25 tasks.
+                    tg.batch(Spawn, counters, 40);
+                    break;
+            }
+            tg.wait();
+        }
+    }
+
+private:
+    static void Increment(int32_t* counter) {
+        sk_atomic_inc(counter);
+    }
+
+    static void Spawn(int32_t* counters) {
+        SkTaskGroup tg;
+        for (int j = 0; j < 25; j++) {
+            tg.add(Increment, counters);
+        }
+    }
+
+    Mode     fMode;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kAdd_Mode); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kBatch_Mode); )
+DEF_BENCH( return new TaskGroupBench(TaskGroupBench::kNested_Mode); )
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBBHFactory.h"
+#include "SkBBoxHierarchy.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Compares SkTileGrid with SkRTree on a map-like workload: lots of small, evenly spread ops,
+// queried with tile-aligned rects.
+static const int kNumRects = 100000;
+static const int kExtent = 4096;
+static const int kTileSize = 256;
+
+static const SkRect kBounds = SkRect::MakeWH(SkIntToScalar(kExtent), SkIntToScalar(kExtent));
+
+static void make_rects(SkRect rects[]) {
+    SkRandom rand;
+    for (int i = 0; i < kNumRects; ++i) {
+        SkScalar x = rand.nextRangeScalar(0, SkIntToScalar(kExtent)),
+                 y = rand.nextRangeScalar(0, SkIntToScalar(kExtent));
+        rects[i].setXYWH(x, y, rand.nextRangeScalar(1, 40), rand.nextRangeScalar(1, 40));
+    }
+}
+
+static SkBBHFactory* make_factory(bool tileGrid) {
+    if (!tileGrid) {
+        return SkNEW(SkRTreeFactory);
+    }
+    SkTileGridFactory::TileGridInfo info;
+    info.fTileInterval.set(kTileSize, kTileSize);
+    info.fMargin.setEmpty();
+    info.fOffset.setZero();
+    return SkNEW_ARGS(SkTileGridFactory, (info));
+}
+
+class BBHBuildBench : public Benchmark {
+public:
+    explicit BBHBuildBench(bool tileGrid) : fTileGrid(tileGrid) {
+        fName.printf("bbh_%s_build_100k", tileGrid ? "tilegrid" : "rtree");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw() override {
+        fRects.reset(kNumRects);
+        make_rects(fRects.get());
+        fFactory.reset(make_factory(fTileGrid));
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkAutoTUnref<SkBBoxHierarchy> bbh((*fFactory)(kBounds));
+            bbh->insert(fRects.get(), kNumRects);
+        }
+    }
+
+private:
+    bool                        fTileGrid;
+    SkString                    fName;
+    SkAutoTMalloc<SkRect>       fRects;
+    SkAutoTDelete<SkBBHFactory> fFactory;
+
+    typedef Benchmark INHERITED;
+};
+
+class BBHQueryBench : public Benchmark {
+public:
+    explicit BBHQueryBench(bool tileGrid) : fTileGrid(tileGrid) {
+        fName.printf("bbh_%s_tiled_query_100k", tileGrid ? "tilegrid" : "rtree");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw() override {
+        SkAutoTMalloc<SkRect> rects(kNumRects);
+        make_rects(rects.get());
+        SkAutoTDelete<SkBBHFactory> factory(make_factory(fTileGrid));
+        fBBH.reset((*factory)(kBounds));
+        fBBH->insert(rects.get(), kNumRects);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        const int tiles = kExtent / kTileSize;
+        SkTDArray<unsigned> hits;
+        for (int i = 0; i < loops; ++i) {
+            int tile = i % (tiles * tiles);
+            SkRect query = SkRect::MakeXYWH(SkIntToScalar(kTileSize * (tile % tiles)),
+                                            SkIntToScalar(kTileSize * (tile / tiles)),
+                                            SkIntToScalar(kTileSize), SkIntToScalar(kTileSize));
+            hits.rewind();
+            fBBH->search(query, &hits);
+        }
+    }
+
+private:
+    bool                            fTileGrid;
+    SkString                        fName;
+    SkAutoTUnref<SkBBoxHierarchy>   fBBH;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(BBHBuildBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(BBHBuildBench, (true)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (true)); )
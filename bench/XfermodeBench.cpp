@@ -83,6 +83,58 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Benchmark that calls SkXfermode::xfer32 directly on spans of pixels, with or without coverage,
+// so each mode's SIMD span code (whichever the CPU supports) is timed without drawing overhead.
+class Xfer32Bench : public Benchmark {
+public:
+    Xfer32Bench(SkXfermode::Mode mode, bool coverage) : fCoverage(coverage) {
+        fXfermode.reset(SkXfermode::Create(mode));
+        SkASSERT(fXfermode.get());
+        fName.printf("Xfermode_xfer32%s_%s", coverage ? "_aa" : "", SkXfermode::ModeName(mode));
+
+        SkRandom random;
+        for (int i = 0; i < kCount; ++i) {
+            fSrc[i] = SkPreMultiplyColor(random.nextU());
+            fDst[i] = SkPreMultiplyColor(random.nextU());
+            // Mostly edges of shapes: runs that are fully covered or uncovered, with some
+            // partial coverage in between
+            switch (random.nextULessThan(4)) {
+                case 0:  fAA[i] = 0;                                           break;
+                case 1:  fAA[i] = SkToU8(random.nextULessThan(256));           break;
+                default: fAA[i] = 0xFF;                                        break;
+            }
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            // Start from the same pixels each time, so modes which converge don't get faster
+            memcpy(fResult, fDst, sizeof(fResult));
+            fXfermode->xfer32(fResult, fSrc, kCount, fCoverage ? fAA : NULL);
+        }
+    }
+
+private:
+    static const int kCount = 1024;
+
+    SkAutoTUnref<SkXfermode> fXfermode;
+    SkString                 fName;
+    bool                     fCoverage;
+    SkPMColor                fSrc[kCount];
+    SkPMColor                fDst[kCount];
+    SkPMColor                fResult[kCount];
+    SkAlpha                  fAA[kCount];
+
+    typedef Benchmark INHERITED;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 
 #define CONCAT_I(x, y) x ## y
@@ -124,4 +176,72 @@ BENCH(SkXfermode::kSaturation_Mode)
 BENCH(SkXfermode::kColor_Mode)
 BENCH(SkXfermode::kLuminosity_Mode)
 
+#define XFER32_BENCH(mode, coverage) \
+    DEF_BENCH( return new Xfer32Bench(mode, coverage); )
+
+// kSrcOver_Mode has no SkXfermode object; blits special case it
+XFER32_BENCH(SkXfermode::kClear_Mode, false)
+XFER32_BENCH(SkXfermode::kSrc_Mode, false)
+XFER32_BENCH(SkXfermode::kDst_Mode, false)
+XFER32_BENCH(SkXfermode::kDstOver_Mode, false)
+XFER32_BENCH(SkXfermode::kSrcIn_Mode, false)
+XFER32_BENCH(SkXfermode::kDstIn_Mode, false)
+XFER32_BENCH(SkXfermode::kSrcOut_Mode, false)
+XFER32_BENCH(SkXfermode::kDstOut_Mode, false)
+XFER32_BENCH(SkXfermode::kSrcATop_Mode, false)
+XFER32_BENCH(SkXfermode::kDstATop_Mode, false)
+XFER32_BENCH(SkXfermode::kXor_Mode, false)
+
+XFER32_BENCH(SkXfermode::kPlus_Mode, false)
+XFER32_BENCH(SkXfermode::kModulate_Mode, false)
+XFER32_BENCH(SkXfermode::kScreen_Mode, false)
+
+XFER32_BENCH(SkXfermode::kOverlay_Mode, false)
+XFER32_BENCH(SkXfermode::kDarken_Mode, false)
+XFER32_BENCH(SkXfermode::kLighten_Mode, false)
+XFER32_BENCH(SkXfermode::kColorDodge_Mode, false)
+XFER32_BENCH(SkXfermode::kColorBurn_Mode, false)
+XFER32_BENCH(SkXfermode::kHardLight_Mode, false)
+XFER32_BENCH(SkXfermode::kSoftLight_Mode, false)
+XFER32_BENCH(SkXfermode::kDifference_Mode, false)
+XFER32_BENCH(SkXfermode::kExclusion_Mode, false)
+XFER32_BENCH(SkXfermode::kMultiply_Mode, false)
+
+XFER32_BENCH(SkXfermode::kHue_Mode, false)
+XFER32_BENCH(SkXfermode::kSaturation_Mode, false)
+XFER32_BENCH(SkXfermode::kColor_Mode, false)
+XFER32_BENCH(SkXfermode::kLuminosity_Mode, false)
+
+XFER32_BENCH(SkXfermode::kClear_Mode, true)
+XFER32_BENCH(SkXfermode::kSrc_Mode, true)
+XFER32_BENCH(SkXfermode::kDst_Mode, true)
+XFER32_BENCH(SkXfermode::kDstOver_Mode, true)
+XFER32_BENCH(SkXfermode::kSrcIn_Mode, true)
+XFER32_BENCH(SkXfermode::kDstIn_Mode, true)
+XFER32_BENCH(SkXfermode::kSrcOut_Mode, true)
+XFER32_BENCH(SkXfermode::kDstOut_Mode, true)
+XFER32_BENCH(SkXfermode::kSrcATop_Mode, true)
+XFER32_BENCH(SkXfermode::kDstATop_Mode, true)
+XFER32_BENCH(SkXfermode::kXor_Mode, true)
+
+XFER32_BENCH(SkXfermode::kPlus_Mode, true)
+XFER32_BENCH(SkXfermode::kModulate_Mode, true)
+XFER32_BENCH(SkXfermode::kScreen_Mode, true)
+
+XFER32_BENCH(SkXfermode::kOverlay_Mode, true)
+XFER32_BENCH(SkXfermode::kDarken_Mode, true)
+XFER32_BENCH(SkXfermode::kLighten_Mode, true)
+XFER32_BENCH(SkXfermode::kColorDodge_Mode, true)
+XFER32_BENCH(SkXfermode::kColorBurn_Mode, true)
+XFER32_BENCH(SkXfermode::kHardLight_Mode, true)
+XFER32_BENCH(SkXfermode::kSoftLight_Mode, true)
+XFER32_BENCH(SkXfermode::kDifference_Mode, true)
+XFER32_BENCH(SkXfermode::kExclusion_Mode, true)
+XFER32_BENCH(SkXfermode::kMultiply_Mode, true)
+
+XFER32_BENCH(SkXfermode::kHue_Mode, true)
+XFER32_BENCH(SkXfermode::kSaturation_Mode, true)
+XFER32_BENCH(SkXfermode::kColor_Mode, true)
+XFER32_BENCH(SkXfermode::kLuminosity_Mode, true)
+
 DEF_BENCH(return new XferCreateBench;)
@@ -13,6 +13,7 @@ def usage():
 
     print '-o <file> the old bench output file.'
     print '-n <file> the new bench output file.'
+    print '   Either may be bench output or nanobench --outResultsFile JSON.'
     print '-h causes headers to be output.'
     print '-s <stat> the type of statistical analysis used'
     print '   Not specifying is the same as -s "avg".'
@@ -29,8 +30,16 @@ def usage():
     print '  n: new time'
     print '  d: diff'
     print '  p: percent diff'
+    print '  v: p-value of the Mann-Whitney U test on the raw samples'
+    print '  e: effect size, Cliff\'s delta, of new over old: from -1 (always'
+    print '     faster) to 1 (always slower)'
     print '-t use tab delimited format for output.'
     print '--match <bench> only matches benches which begin with <bench>.'
+    print '--alpha <p> only output differences significant at this level,'
+    print '   by the Mann-Whitney U test on the raw samples of each bench.'
+    print '   Benches without raw samples are left out.'
+    print '--min_effect <e> with --alpha, also leave out differences whose'
+    print '   effect size is smaller than this. [default 0.5]'
 
 class BenchDiff:
     """A compare between data points produced by bench.
@@ -44,6 +53,10 @@ class BenchDiff:
         if old.time != 0:
             diffp = self.diff / old.time
         self.diffp = diffp
+        # With only a handful of noisy samples each, a difference in time
+        # alone means little; these say how consistently new differs.
+        self.pvalue, self.effect = bench_util.mann_whitney(old.per_iter_time,
+                                                          new.per_iter_time)
 
     def __repr__(self):
         return "BenchDiff(%s, %s)" % (
@@ -51,11 +64,23 @@ class BenchDiff:
                    str(self.old),
                )
 
+def parse_file(filename, stat_type):
+    """Parses bench output or nanobench JSON, whichever filename holds.
+
+    (str, str) -> [BenchDataPoint]"""
+    with open(filename, 'r') as f:
+        if f.read(1024).lstrip().startswith('{'):
+            f.seek(0)
+            return bench_util.parse_json(f, stat_type)
+        f.seek(0)
+        return bench_util.parse({}, f, stat_type)
+
 def main():
     """Parses command line and writes output."""
 
     try:
-        opts, _ = getopt.getopt(sys.argv[1:], "f:o:n:s:ht", ['match='])
+        opts, _ = getopt.getopt(sys.argv[1:], "f:o:n:s:ht",
+                                   ['match=', 'alpha=', 'min_effect='])
     except getopt.GetoptError, err:
         print str(err) 
         usage()
@@ -70,6 +95,8 @@ def main():
     stat_type = "avg"
     use_tabs = False
     match_bench = None;
+    alpha = None
+    min_effect = 0.5
 
     for option, value in opts:
         if option == "-o":
@@ -86,6 +113,10 @@ def main():
             use_tabs = True
         elif option == "--match":
             match_bench = value
+        elif option == "--alpha":
+            alpha = float(value)
+        elif option == "--min_effect":
+            min_effect = float(value)
         else:
             usage()
             assert False, "unhandled option"
@@ -94,8 +125,8 @@ def main():
         usage()
         sys.exit(2)
 
-    old_benches = bench_util.parse({}, open(old, 'r'), stat_type)
-    new_benches = bench_util.parse({}, open(new, 'r'), stat_type)
+    old_benches = parse_file(old, stat_type)
+    new_benches = parse_file(new, stat_type)
 
     bench_diffs = []
     for old_bench in old_benches:
@@ -111,7 +142,11 @@ def main():
         ]
         if (len(new_bench_match) < 1):
             continue
-        bench_diffs.append(BenchDiff(old_bench, new_bench_match[0]))
+        bench_diff = BenchDiff(old_bench, new_bench_match[0])
+        if alpha is not None and not (bench_diff.pvalue < alpha and
+                                      abs(bench_diff.effect) >= min_effect):
+            continue
+        bench_diffs.append(bench_diff)
 
     if use_tabs:
         column_formats = {
@@ -122,6 +157,8 @@ def main():
             'n' : '{new_time: 0.2f}\t',
             'd' : '{diff: 0.2f}\t',
             'p' : '{diffp: 0.1%}\t',
+            'v' : '{pvalue: 0.4f}\t',
+            'e' : '{effect: 0.2f}\t',
         }
         header_formats = {
             'b' : '{bench}\t',
@@ -131,10 +168,13 @@ def main():
             'n' : '{new_time}\t',
             'd' : '{diff}\t',
             'p' : '{diffp}\t',
+            'v' : '{pvalue}\t',
+            'e' : '{effect}\t',
         }
     else:
-        bench_max_len = max(map(lambda b: len(b.old.bench), bench_diffs))
-        config_max_len = max(map(lambda b: len(b.old.config), bench_diffs))
+        # --alpha may leave no benches at all.
+        bench_max_len = max([0] + map(lambda b: len(b.old.bench), bench_diffs))
+        config_max_len = max([0] + map(lambda b: len(b.old.config), bench_diffs))
         column_formats = {
             'b' : '{bench: >%d} ' % (bench_max_len),
             'c' : '{config: <%d} ' % (config_max_len),
@@ -143,6 +183,8 @@ def main():
             'n' : '{new_time: >10.2f} ',
             'd' : '{diff: >+10.2f} ',
             'p' : '{diffp: >+8.1%} ',
+            'v' : '{pvalue: >8.4f} ',
+            'e' : '{effect: >+7.2f} ',
         }
         header_formats = {
             'b' : '{bench: >%d} ' % (bench_max_len),
@@ -152,6 +194,8 @@ def main():
             'n' : '{new_time: >10} ',
             'd' : '{diff: >10} ',
             'p' : '{diffp: >8} ',
+            'v' : '{pvalue: >8} ',
+            'e' : '{effect: >7} ',
         }
 
     for column_char in columns:
@@ -171,6 +215,8 @@ def main():
             , new_time='new'
             , diff='diff'
             , diffp='diffP'
+            , pvalue='p'
+            , effect='effect'
         )
 
     bench_diffs.sort(key=lambda d : [d.diffp,
@@ -187,6 +233,8 @@ def main():
             , new_time=bench_diff.new.time
             , diff=bench_diff.diff
             , diffp=bench_diff.diffp
+            , pvalue=bench_diff.pvalue
+            , effect=bench_diff.effect
         )
 
 if __name__ == "__main__":
@@ -4,6 +4,7 @@ Created on May 19, 2011
 @author: bungeman
 '''
 
+import json
 import os
 import re
 import math
@@ -259,6 +260,86 @@ def parse(settings, lines, representation=None):
 
     return benches
 
+def parse_json(json_file, representation=None):
+    """Parses nanobench --outResultsFile output into a useful data structure.
+
+    (file) -> [BenchDataPoint]
+    Each BenchDataPoint's per_iter_time holds the raw samples_ms, if written,
+    and its time is their representation, one of the ALGORITHM_XXX types.
+    Results without samples fall back to their median_ms or min_ms."""
+
+    benches = []
+    results = json.load(json_file).get('results', {})
+    for bench in results:
+        for config in results[bench]:
+            result = results[bench][config]
+            if not isinstance(result, dict):
+                continue
+            per_iter_time = [t for t in result.get('samples_ms', [])
+                             if t is not None]
+            if per_iter_time:
+                bench_summary = _ListAlgorithm(
+                    list(per_iter_time), representation).compute()
+            elif 'median_ms' in result:
+                bench_summary = result['median_ms']
+            elif 'min_ms' in result:
+                bench_summary = result['min_ms']
+            else:
+                continue
+            benches.append(BenchDataPoint(
+                bench,
+                config,
+                '',
+                bench_summary,
+                result.get('options', {}),
+                per_iter_time=per_iter_time))
+
+    return benches
+
+def mann_whitney(old, new):
+    """Two-sided Mann-Whitney U test of whether new tends to differ from old.
+
+    ([float], [float]) -> (float, float)
+    Returns (p, effect).  p is the chance of ranks at least this lopsided if
+    old and new came from the same distribution, from the normal
+    approximation with a tie correction, so it is rough below ~8 samples each.
+    effect is Cliff's delta, P(new > old) - P(new < old): from -1 when every
+    new value is smaller to 1 when every new value is larger.
+    Both are nan if either list is empty."""
+
+    n1 = len(old)
+    n2 = len(new)
+    if not n1 or not n2:
+        return (float('nan'), float('nan'))
+
+    # Rank old and new together, giving tied values the mean of their ranks.
+    combined = sorted([(v, 0) for v in old] + [(v, 1) for v in new])
+    n = n1 + n2
+    new_rank_sum = 0.0
+    tie_sum = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1
+        new_rank_sum += rank * sum(1 for k in range(i, j + 1)
+                                   if combined[k][1] == 1)
+        ties = j - i + 1
+        tie_sum += ties ** 3 - ties
+        i = j + 1
+
+    u = new_rank_sum - n2 * (n2 + 1) / 2.0
+    effect = 2.0 * u / (n1 * n2) - 1
+
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_sum / (n * (n - 1.0)))
+    if variance <= 0:
+        # Every value is the same.
+        return (1.0, effect)
+    z = max(abs(u - mean) - 0.5, 0) / math.sqrt(variance)
+    return (min(1.0, math.erfc(z / math.sqrt(2))), effect)
+
 class LinearRegression:
     """Linear regression data based on a set of data points.
 
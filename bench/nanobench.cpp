@@ -10,6 +10,7 @@
 #include "nanobench.h"
 
 #include "Benchmark.h"
+#include "ChromeTracingTracer.h"
 #include "CodecBench.h"
 #include "CrashHandler.h"
 #include "DecodingBench.h"
@@ -18,23 +19,31 @@
 #include "ProcStats.h"
 #include "ResultsWriter.h"
 #include "RecordingBench.h"
+#include "SKPAnimationBench.h"
 #include "SKPBench.h"
+#include "SKPStagesBench.h"
+#include "PerfCounters.h"
 #include "Stats.h"
 #include "Timer.h"
 
+#include "SkAtomics.h"
 #include "SkBBoxHierarchy.h"
 #include "SkCanvas.h"
 #include "SkCodec.h"
 #include "SkCommonFlags.h"
 #include "SkData.h"
+#include "SkDrawArena.h"
 #include "SkForceLinking.h"
 #include "SkGraphics.h"
+#include "SkMallocStats.h"
 #include "SkOSFile.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
+#include "SkScan.h"
 #include "SkString.h"
 #include "SkSurface.h"
 #include "SkTaskGroup.h"
+#include "SkThreadUtils.h"
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     #include "nanobenchAndroid.h"
@@ -75,6 +84,10 @@ DEFINE_double(gpuMs, 5, "Target bench time in millseconds for GPU.");
 DEFINE_int32(gpuFrameLag, 5, "Overestimate of maximum number of frames GPU allows to lag.");
 DEFINE_bool(gpuCompressAlphaMasks, false, "Compress masks generated from falling back to "
                                           "software path rendering.");
+DEFINE_bool(gpuCompressStaticBitmaps, false, "ETC1 compress large opaque immutable bitmaps "
+                                            "before uploading them.");
+DEFINE_bool(gpuMixedSampleAA, false, "On msaa configs, multisample only concave path fills and "
+                                     "use coverage AA for everything else.");
 
 DEFINE_string(outResultsFile, "", "If given, write results here as JSON.");
 DEFINE_int32(maxCalibrationAttempts, 3,
@@ -87,6 +100,20 @@ DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
+DEFINE_bool(scratchMallocs, false, "Print how many heap allocations each loop makes for draw "
+                                   "scratch memory, measured over one extra timed run.");
+DEFINE_bool(mallocStats, false, "Report how many heap allocations and bytes each loop makes, "
+                                "and how far the live heap grows, over one extra timed run.");
+DEFINE_int32(frames, 0, "If greater than 0, also play each SKP back as an animation of this many "
+                        "frames, zooming through --scales while panning, and report the spread "
+                        "of frame times.");
+DEFINE_double(frameBudgetMs, 16.7, "Count animation frames slower than this many milliseconds.");
+DEFINE_bool(stages, false, "Also record and play back each SKP once per sample at the first of "
+                          "--scales, timing SkRecorder capture, SkRecordOptimize, BBH build, "
+                          "culling, rasterization, and flush separately.");
+DEFINE_bool(perfCounters, false, "Count instructions, cycles, cache misses and branch misses "
+                                 "per loop of each CPU bench with hardware performance counters. "
+                                 "Linux only.");
 
 static SkString humanize(double ms) {
     if (FLAGS_verbose) return SkStringPrintf("%llu", (uint64_t)(ms*1e6));
@@ -167,7 +194,7 @@ struct GPUTarget : public Target {
         
 #endif
 
-static double time(int loops, Benchmark* bench, Target* target) {
+static double time(int loops, Benchmark* bench, Target* target, PerfCounters* counters = NULL) {
     SkCanvas* canvas = target->getCanvas();
     if (canvas) {
         canvas->clear(SK_ColorWHITE);
@@ -175,10 +202,16 @@ static double time(int loops, Benchmark* bench, Target* target) {
     WallTimer timer;
     timer.start();
     canvas = target->beginTiming(canvas);
+    if (counters) {
+        counters->start();
+    }
     bench->draw(loops, canvas);
     if (canvas) {
         canvas->flush();
     }
+    if (counters) {
+        counters->end();
+    }
     target->endTiming();
     timer.end();
     return timer.fWall;
@@ -250,7 +283,8 @@ static bool write_canvas_png(Target* target, const SkString& filename) {
 }
 
 static int kFailedLoops = -2;
-static int cpu_bench(const double overhead, Target* target, Benchmark* bench, double* samples) {
+static int cpu_bench(const double overhead, Target* target, Benchmark* bench, double* samples,
+                     PerfCounters* counters) {
     // First figure out approximately how many loops of bench it takes to make overhead negligible.
     double bench_plus_overhead = 0.0;
     int round = 0;
@@ -291,12 +325,34 @@ static int cpu_bench(const double overhead, Target* target, Benchmark* bench, do
         loops = detect_forever_loops(loops);
     }
 
+    if (counters) {
+        counters->reset();
+    }
     for (int i = 0; i < FLAGS_samples; i++) {
-        samples[i] = time(loops, bench, target) / loops;
+        samples[i] = time(loops, bench, target, counters) / loops;
     }
     return loops;
 }
 
+// One thread of a --threads run.
+struct ThreadedRun {
+    Benchmark* bench;
+    Target* target;
+    int loops;
+    int32_t* ready;     // Counts threads waiting on go, so their startup isn't timed.
+    const int32_t* go;  // Every thread waits for this to be set, so they all draw at once.
+    double ms;
+};
+
+static void threaded_run_proc(void* data) {
+    ThreadedRun* run = static_cast<ThreadedRun*>(data);
+    sk_atomic_inc(run->ready);
+    while (!sk_atomic_load(run->go, sk_memory_order_acquire)) {
+        // Spin; sleeping would add wakeup latency to the timings.
+    }
+    run->ms = time(run->loops, run->bench, run->target);
+}
+
 static int gpu_bench(Target* target,
                      Benchmark* bench,
                      double* samples) {
@@ -344,6 +400,61 @@ static int gpu_bench(Target* target,
     return loops;
 }
 
+// Draws FLAGS_frames frames of an animated bench one at a time, waiting for each to finish,
+// and fills frames with how long each took.  There is no warmup: the first frames' cache
+// misses and uploads are part of the result.
+static void animation_bench(Target* target, Benchmark* bench, double* frames) {
+    for (int i = 0; i < FLAGS_frames; i++) {
+        SkCanvas* canvas = target->getCanvas();
+        if (canvas) {
+            canvas->clear(SK_ColorWHITE);
+        }
+        WallTimer timer;
+        timer.start();
+        canvas = target->beginTiming(canvas);
+        bench->draw(1, canvas);
+        if (canvas) {
+            canvas->flush();
+        }
+        target->endTiming();
+        target->fence();
+        timer.end();
+        frames[i] = timer.fWall;
+    }
+}
+
+// Draws an SKPStagesBench FLAGS_samples times after one warmup, and fills samples with how long
+// each stage took each time: all of the first stage's samples, then the second's, and so on.
+// Waiting for the GPU to finish counts as part of the flush.
+static void stages_bench(Target* target, SKPStagesBench* bench, double* samples) {
+    for (int i = -1; i < FLAGS_samples; i++) {
+        SkCanvas* canvas = target->getCanvas();
+        if (canvas) {
+            canvas->clear(SK_ColorWHITE);
+        }
+        double ms[SKPStagesBench::kStageCount] = { 0 };
+        canvas = target->beginTiming(canvas);
+        bench->drawStages(canvas, ms);
+
+        WallTimer timer;
+        timer.start();
+        target->endTiming();
+        target->fence();
+        timer.end();
+        ms[SKPStagesBench::kFlush_Stage] += timer.fWall;
+
+        for (int stage = 0; i >= 0 && stage < SKPStagesBench::kStageCount; stage++) {
+            samples[stage * FLAGS_samples + i] = ms[stage];
+        }
+    }
+}
+
+// The pth percentile of n sorted values.
+static double percentile(const double sorted[], int n, double p) {
+    const int i = SkTMin(SkTMax((int)ceil(p / 100 * n) - 1, 0), n - 1);
+    return sorted[i];
+}
+
 static SkString to_lower(const char* str) {
     SkString lower(str);
     for (size_t i = 0; i < lower.size(); i++) {
@@ -483,11 +594,16 @@ class BenchmarkStream {
 public:
     BenchmarkStream() : fBenches(BenchRegistry::Head())
                       , fGMs(skiagm::GMRegistry::Head())
+                      , fCurrentBench(NULL)
+                      , fCurrentGM(NULL)
                       , fCurrentRecording(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentUseMPD(0)
+                      , fCurrentAnimation(0)
+                      , fCurrentStages(0)
                       , fCurrentCodec(0)
+                      , fCurrentCodecSwizzled(false)
                       , fCurrentImage(0)
                       , fCurrentSubsetImage(0)
                       , fCurrentColorType(0)
@@ -566,8 +682,11 @@ public:
     }
 
     Benchmark* next() {
+        fCurrentBench = NULL;
+        fCurrentGM = NULL;
         if (fBenches) {
             Benchmark* bench = fBenches->factory()(NULL);
+            fCurrentBench = fBenches;
             fBenches = fBenches->next();
             fSourceType = "bench";
             fBenchType  = "micro";
@@ -576,6 +695,7 @@ public:
 
         while (fGMs) {
             SkAutoTDelete<skiagm::GM> gm(fGMs->factory()(NULL));
+            fCurrentGM = fGMs;
             fGMs = fGMs->next();
             if (gm->runAsBench()) {
                 fSourceType = "gm";
@@ -635,6 +755,43 @@ public:
             fCurrentScale++;
         }
 
+        // Then each as an animation through all the scales, timed frame by frame.
+        while (FLAGS_frames > 0 && fCurrentAnimation < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentAnimation++];
+            SkAutoTUnref<SkPicture> pic;
+            if (!ReadPicture(path.c_str(), &pic)) {
+                continue;
+            }
+            if (FLAGS_bbh) {
+                // Each frame shows a different part of the picture, so a BBH matters here.
+                SkRTreeFactory factory;
+                SkPictureRecorder recorder;
+                pic->playback(recorder.beginRecording(pic->cullRect().width(),
+                                                      pic->cullRect().height(),
+                                                      &factory));
+                pic.reset(recorder.endRecording());
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "animation";
+            return SkNEW_ARGS(SKPAnimationBench,
+                              (name.c_str(), pic.get(), fClip, fScales, FLAGS_frames));
+        }
+
+        // Then each once more, recorded and played back one stage at a time.
+        while (FLAGS_stages && fCurrentStages < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentStages++];
+            SkAutoTUnref<SkPicture> pic;
+            if (!ReadPicture(path.c_str(), &pic)) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "stages";
+            return SkNEW_ARGS(SKPStagesBench,
+                              (name.c_str(), pic.get(), fClip, fScales[0], FLAGS_bbh));
+        }
+
         for (; fCurrentCodec < fImages.count(); fCurrentCodec++) {
             const SkString& path = fImages[fCurrentCodec];
             SkAutoTUnref<SkData> encoded(SkData::NewFromFileName(path.c_str()));
@@ -667,6 +824,13 @@ public:
                         break;
                 }
             }
+            // Then time the swizzle on its own, once per image.
+            if (!fCurrentCodecSwizzled) {
+                fCurrentCodecSwizzled = true;
+                return new CodecBench(SkOSPath::Basename(path.c_str()), encoded,
+                                      kN32_SkColorType, CodecBench::kSwizzle_Mode);
+            }
+            fCurrentCodecSwizzled = false;
             fCurrentColorType = 0;
         }
 
@@ -744,6 +908,23 @@ public:
         return NULL;
     }
 
+    // Returns another copy of the last bench next() returned, or NULL if it can't make one.
+    Benchmark* cloneCurrent() const {
+        if (fCurrentBench) {
+            return fCurrentBench->factory()(NULL);
+        }
+        if (fCurrentGM) {
+            return SkNEW_ARGS(GMBench, (fCurrentGM->factory()(NULL)));
+        }
+        return NULL;
+    }
+
+    // Is the last bench next() returned meant to be timed frame by frame?
+    bool currentIsAnimation() const { return 0 == strcmp(fBenchType, "animation"); }
+
+    // Is the last bench next() returned an SKPStagesBench?
+    bool currentIsStages() const { return 0 == strcmp(fBenchType, "stages"); }
+
     void fillCurrentOptions(ResultsWriter* log) const {
         log->configOption("source_type", fSourceType);
         log->configOption("bench_type",  fBenchType);
@@ -751,8 +932,19 @@ public:
             log->configOption("clip",
                     SkStringPrintf("%d %d %d %d", fClip.fLeft, fClip.fTop,
                                                   fClip.fRight, fClip.fBottom).c_str());
-            log->configOption("scale", SkStringPrintf("%.2g", fScales[fCurrentScale]).c_str());
-            if (fCurrentUseMPD > 0) {
+            if (this->currentIsAnimation()) {
+                SkString scales;
+                for (int i = 0; i < fScales.count(); i++) {
+                    scales.appendf("%s%.2g", i > 0 ? " " : "", fScales[i]);
+                }
+                log->configOption("scales", scales.c_str());
+                log->configOption("frames", SkStringPrintf("%d", FLAGS_frames).c_str());
+            } else {
+                const SkScalar scale = this->currentIsStages() ? fScales[0]
+                                                               : fScales[fCurrentScale];
+                log->configOption("scale", SkStringPrintf("%.2g", scale).c_str());
+            }
+            if (fCurrentUseMPD > 0 && !this->currentIsAnimation()) {
                 SkASSERT(1 == fCurrentUseMPD || 2 == fCurrentUseMPD);
                 log->configOption("multi_picture_draw", fUseMPDs[fCurrentUseMPD-1] ? "true" : "false");
             }
@@ -766,6 +958,8 @@ public:
 private:
     const BenchRegistry* fBenches;
     const skiagm::GMRegistry* fGMs;
+    const BenchRegistry* fCurrentBench;
+    const skiagm::GMRegistry* fCurrentGM;
     SkIRect            fClip;
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
@@ -781,22 +975,99 @@ private:
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentUseMPD;
+    int fCurrentAnimation;
+    int fCurrentStages;
     int fCurrentCodec;
+    bool fCurrentCodecSwizzled;
     int fCurrentImage;
     int fCurrentSubsetImage;
     int fCurrentColorType;
     const int fDivisor;
 };
 
+// Times FLAGS_threads fresh copies of the stream's current bench drawing to their own targets
+// for config, on their own threads at once, FLAGS_samples times. Fills threadSamples with each
+// thread's time per loop, sample after sample, and wallSamples with the time until the slowest
+// thread finished. Returns false if the bench can't be copied.
+static bool threaded_bench(const BenchmarkStream& stream, const Config& config, int loops,
+                           double* threadSamples, double* wallSamples) {
+    const int threads = FLAGS_threads;
+    SkAutoTArray<ThreadedRun> runs(threads);
+    SkTDArray<Benchmark*> benches;
+    SkTDArray<Target*> targets;
+    bool ok = true;
+    for (int t = 0; t < threads && ok; t++) {
+        Benchmark* bench = stream.cloneCurrent();
+        Target* target = bench ? is_enabled(bench, config) : NULL;
+        if (target) {
+            *benches.append() = bench;
+            *targets.append() = target;
+            bench->preDraw();
+            target->setup();
+            bench->perCanvasPreDraw(target->getCanvas());
+        } else {
+            SkDELETE(bench);
+            ok = false;
+        }
+    }
+
+    for (int i = 0; i < FLAGS_samples && ok; i++) {
+        int32_t ready = 0, go = 0;
+        SkTDArray<SkThread*> pool;
+        for (int t = 0; t < threads; t++) {
+            runs[t].bench = benches[t];
+            runs[t].target = targets[t];
+            runs[t].loops = loops;
+            runs[t].ready = &ready;
+            runs[t].go = &go;
+            runs[t].ms = 0;
+            *pool.append() = SkNEW_ARGS(SkThread, (threaded_run_proc, &runs[t]));
+            pool[t]->start();
+        }
+        while (sk_atomic_load(&ready, sk_memory_order_acquire) < threads) {}
+        WallTimer timer;
+        timer.start();
+        sk_atomic_store(&go, 1, sk_memory_order_release);
+        for (int t = 0; t < threads; t++) {
+            pool[t]->join();
+        }
+        timer.end();
+        pool.deleteAll();
+
+        for (int t = 0; t < threads; t++) {
+            threadSamples[i * threads + t] = runs[t].ms / loops;
+        }
+        wallSamples[i] = timer.fWall;
+    }
+
+    for (int t = 0; t < benches.count(); t++) {
+        benches[t]->perCanvasPostDraw(targets[t]->getCanvas());
+    }
+    benches.deleteAll();
+    targets.deleteAll();
+    return ok;
+}
+
 int nanobench_main();
 int nanobench_main() {
     SetupCrashHandler();
+    if (!FLAGS_trace.isEmpty()) {
+        SkEventTracer::SetInstance(SkNEW_ARGS(ChromeTracingTracer, (FLAGS_trace[0])));
+    }
     SkAutoGraphics ag;
     SkTaskGroup::Enabler enabled;
+    gSkUseAnalyticAA = FLAGS_analyticAA;
+    SkGraphics::SetStrokeCacheEnabled(FLAGS_strokeCache);
+    SkGraphics::SetTextRunCacheEnabled(FLAGS_textRunCache);
+    SkGraphics::SetPatchCacheEnabled(FLAGS_patchCache);
+    SkGraphics::SetFastTextOnPathEnabled(FLAGS_fastTextOnPath);
+    SkGraphics::SetFontCacheSharesSubpixelImages(FLAGS_shareSubpixelGlyphs);
 
 #if SK_SUPPORT_GPU
     GrContext::Options grContextOpts;
     grContextOpts.fDrawPathToCompressedTexture = FLAGS_gpuCompressAlphaMasks;
+    grContextOpts.fCompressStaticBitmapTextures = FLAGS_gpuCompressStaticBitmaps;
+    grContextOpts.fMixedSampleAA = FLAGS_gpuMixedSampleAA;
     gGrFactory.reset(SkNEW_ARGS(GrContextFactory, (grContextOpts)));
 #endif
 
@@ -843,6 +1114,16 @@ int nanobench_main() {
 
     SkAutoTMalloc<double> samples(FLAGS_samples);
 
+    SkAutoTDelete<PerfCounters> counters;
+    if (FLAGS_perfCounters) {
+        counters.reset(SkNEW(PerfCounters));
+        if (!counters->hasAny()) {
+            SkDebugf("WARNING: Hardware performance counters are not available; "
+                     "ignoring --perfCounters.\n");
+            counters.reset(NULL);
+        }
+    }
+
     if (kAutoTuneLoops != FLAGS_loops) {
         SkDebugf("Fixed number of loops; times would only be misleading so we won't print them.\n");
     } else if (FLAGS_verbose) {
@@ -880,10 +1161,101 @@ int nanobench_main() {
             targets[j]->setup();
             bench->perCanvasPreDraw(canvas);
 
+            if (benchStream.currentIsAnimation()) {
+                SkAutoTMalloc<double> frames(FLAGS_frames);
+                animation_bench(targets[j], bench.get(), frames.get());
+                bench->perCanvasPostDraw(canvas);
+
+                int slowFrames = 0;
+                for (int i = 0; i < FLAGS_frames; i++) {
+                    slowFrames += frames[i] > FLAGS_frameBudgetMs;
+                }
+                SkTQSort(frames.get(), frames.get() + FLAGS_frames - 1);
+                const double p50 = percentile(frames.get(), FLAGS_frames, 50),
+                             p90 = percentile(frames.get(), FLAGS_frames, 90),
+                             p99 = percentile(frames.get(), FLAGS_frames, 99),
+                             max = frames[FLAGS_frames - 1];
+
+                log->config(config);
+                log->configOption("name", bench->getName());
+                benchStream.fillCurrentOptions(log.get());
+                targets[j]->fillOptions(log.get());
+                log->metric("p50_ms", p50);
+                log->metric("p90_ms", p90);
+                log->metric("p99_ms", p99);
+                log->metric("max_ms", max);
+                log->metric("slow_frames", slowFrames);
+                if (runs++ % FLAGS_flushEvery == 0) {
+                    log->flush();
+                }
+
+                SkDebugf("%4dM\t%d frames\tp50 %s\tp90 %s\tp99 %s\tmax %s\t"
+                         "%d over %s\t%s\t%s\n"
+                         , sk_tools::getBestResidentSetSizeMB()
+                         , FLAGS_frames
+                         , HUMANIZE(p50)
+                         , HUMANIZE(p90)
+                         , HUMANIZE(p99)
+                         , HUMANIZE(max)
+                         , slowFrames
+                         , HUMANIZE(FLAGS_frameBudgetMs)
+                         , config
+                         , bench->getUniqueName());
+                continue;
+            }
+
+            if (benchStream.currentIsStages()) {
+                const int kStageCount = SKPStagesBench::kStageCount;
+                SkAutoTMalloc<double> stageSamples(kStageCount * FLAGS_samples);
+                stages_bench(targets[j], static_cast<SKPStagesBench*>(bench.get()),
+                             stageSamples.get());
+                bench->perCanvasPostDraw(canvas);
+
+                log->config(config);
+                log->configOption("name", bench->getName());
+                benchStream.fillCurrentOptions(log.get());
+                targets[j]->fillOptions(log.get());
+                SkString line;
+                for (int stage = 0; stage < kStageCount; stage++) {
+                    Stats stats(stageSamples.get() + stage * FLAGS_samples, FLAGS_samples);
+                    const char* name = SKPStagesBench::StageName((SKPStagesBench::Stage)stage);
+                    log->metric(SkStringPrintf("%s_ms", name).c_str(), stats.median);
+                    line.appendf("%s %s\t", name, HUMANIZE(stats.median));
+                }
+                if (runs++ % FLAGS_flushEvery == 0) {
+                    log->flush();
+                }
+
+                SkDebugf("%4dM\t%s%s\t%s\n"
+                         , sk_tools::getBestResidentSetSizeMB()
+                         , line.c_str()
+                         , config
+                         , bench->getUniqueName());
+                continue;
+            }
+
             const int loops =
                 targets[j]->needsFrameTiming()
                 ? gpu_bench(targets[j], bench.get(), samples.get())
-                : cpu_bench(overhead, targets[j], bench.get(), samples.get());
+                : cpu_bench(overhead, targets[j], bench.get(), samples.get(), counters.get());
+
+            double scratchMallocs = 0;
+            if (FLAGS_scratchMallocs && kFailedLoops != loops) {
+                const int before = SkDrawArena::HeapAllocCount();
+                time(loops, bench.get(), targets[j]);
+                scratchMallocs = (SkDrawArena::HeapAllocCount() - before) / (double)loops;
+            }
+
+            double mallocCount = 0, mallocBytes = 0, mallocPeakDelta = 0;
+            if (FLAGS_mallocStats && kFailedLoops != loops) {
+                SkMallocStats::SetEnabled(true);
+                SkMallocStats::Reset();
+                time(loops, bench.get(), targets[j]);
+                mallocCount     = (double)SkMallocStats::Count() / loops;
+                mallocBytes     = (double)SkMallocStats::Bytes() / loops;
+                mallocPeakDelta = (double)SkMallocStats::PeakDelta();
+                SkMallocStats::SetEnabled(false);
+            }
 
             bench->perCanvasPostDraw(canvas);
 
@@ -906,6 +1278,33 @@ int nanobench_main() {
             benchStream.fillCurrentOptions(log.get());
             targets[j]->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
+            log->samples("samples_ms", samples.get(), FLAGS_samples);
+
+            // Copies of the bench on other threads share the global caches, so lock contention
+            // and false sharing show up as a slowdown here.
+            bool threaded = false;
+            double threadedMedian = 0, threadedSpeedup = 0;
+            SkAutoTMalloc<double> threadSamples, wallSamples;
+            if (FLAGS_threads > 1 && kAutoTuneLoops == FLAGS_loops &&
+                !targets[j]->needsFrameTiming() &&
+                (Benchmark::kRaster_Backend == targets[j]->config.backend ||
+                 Benchmark::kNonRendering_Backend == targets[j]->config.backend)) {
+                threadSamples.reset(FLAGS_threads * FLAGS_samples);
+                wallSamples.reset(FLAGS_samples);
+                threaded = threaded_bench(benchStream, targets[j]->config, loops,
+                                          threadSamples.get(), wallSamples.get());
+            }
+            if (threaded) {
+                Stats threadStats(threadSamples.get(), FLAGS_threads * FLAGS_samples);
+                Stats wallStats(wallSamples.get(), FLAGS_samples);
+                threadedMedian = threadStats.median;
+                // How much more work gets done per unit of time than with one thread.
+                threadedSpeedup = FLAGS_threads * loops * stats.median / wallStats.median;
+                log->metric("threads", FLAGS_threads);
+                log->metric("threaded_median_ms", threadedMedian);
+                log->metric("threaded_slowdown", threadedMedian / stats.median);
+                log->metric("threaded_speedup", threadedSpeedup);
+            }
             if (runs++ % FLAGS_flushEvery == 0) {
                 log->flush();
             }
@@ -943,6 +1342,50 @@ int nanobench_main() {
                         , bench->getUniqueName()
                         );
             }
+            if (FLAGS_scratchMallocs) {
+                log->metric("scratch_mallocs", scratchMallocs);
+                SkDebugf("%g scratch mallocs per loop\t%s\t%s\n",
+                         scratchMallocs, config, bench->getUniqueName());
+            }
+            if (FLAGS_mallocStats) {
+                log->metric("malloc_count", mallocCount);
+                log->metric("malloc_bytes", mallocBytes);
+                log->metric("malloc_peak_delta_bytes", mallocPeakDelta);
+                SkDebugf("%g mallocs, %g bytes per loop, peak %g bytes over start\t%s\t%s\n",
+                         mallocCount, mallocBytes, mallocPeakDelta,
+                         config, bench->getUniqueName());
+            }
+            if (counters.get() && !targets[j]->needsFrameTiming()) {
+                // Counted over every sample.
+                const double perLoop = 1.0 / ((double)loops * FLAGS_samples);
+                SkString line;
+                for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                    const PerfCounters::Counter counter = (PerfCounters::Counter)c;
+                    if (counters->has(counter)) {
+                        const double count = counters->get(counter) * perLoop;
+                        log->metric(PerfCounters::Name(counter), count);
+                        line.appendf("%.1f %s\t", count, PerfCounters::Name(counter));
+                    }
+                }
+                if (counters->has(PerfCounters::kInstructions_Counter) &&
+                    counters->has(PerfCounters::kCycles_Counter) &&
+                    counters->get(PerfCounters::kCycles_Counter) > 0) {
+                    line.appendf("%.2f IPC\t",
+                                 counters->get(PerfCounters::kInstructions_Counter) /
+                                 counters->get(PerfCounters::kCycles_Counter));
+                }
+                SkDebugf("%sper loop\t%s\t%s\n", line.c_str(), config, bench->getUniqueName());
+            }
+            if (threaded) {
+                SkDebugf("%d threads: %s per loop per thread (%.2fx slower), %.2fx throughput"
+                         "\t%s\t%s\n"
+                         , FLAGS_threads
+                         , HUMANIZE(threadedMedian)
+                         , threadedMedian / stats.median
+                         , threadedSpeedup
+                         , config
+                         , bench->getUniqueName());
+            }
 #if SK_SUPPORT_GPU
             if (FLAGS_gpuStats &&
                 Benchmark::kGPU_Backend == targets[j]->config.backend) {
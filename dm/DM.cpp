@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "ChromeTracingTracer.h"
 #include "CrashHandler.h"
 #include "DMJsonWriter.h"
 #include "DMSrcSink.h"
@@ -19,6 +20,7 @@
 #include "SkInstCnt.h"
 #include "SkMD5.h"
 #include "SkOSFile.h"
+#include "SkScan.h"
 #include "SkTHash.h"
 #include "SkTaskGroup.h"
 #include "SkThreadUtils.h"
@@ -34,6 +36,8 @@ DEFINE_string(matrix, "1 0 0 1",
               "2x2 scale+skew matrix to apply or upright when using "
               "'matrix' or 'upright' in config.");
 DEFINE_bool(gpu_threading, false, "Allow GPU work to run on multiple threads?");
+DEFINE_int32(gpu_shards, 1, "Without --gpu_threading, split GPU work across this many threads, "
+                            "each keeping its own GrContextFactory and GL contexts.");
 
 DEFINE_string(blacklist, "",
         "Space-separated config/src/name triples to blacklist.  '_' matches anything.  E.g. \n"
@@ -556,14 +560,33 @@ static void run_test(skiatest::Test* test) {
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
-// If we're isolating all GPU-bound work to one thread (the default), this function runs all that.
-static void run_enclave_and_gpu_tests(SkTArray<Task>* tasks) {
-    run_enclave(tasks);
-    for (int i = 0; i < gGPUTests.count(); i++) {
+// If we're isolating GPU-bound work to threads (the default), each of --gpu_shards threads runs
+// every shard-th GPU task and GPU test, starting from its own index.  The tasks share that
+// thread's GL contexts; tests make their own.
+//
+// Shards get threads of their own rather than going into SkTaskGroup: a pool thread waiting in
+// SkTaskGroup::wait() runs whatever work is queued, and must never start a second shard while
+// it's in the middle of a task from the first.
+struct GPUShard {
+    SkTArray<Task>* tasks;
+    int index;
+};
+
+static void run_gpu_shard(GPUShard* shard) {
+    const int shards = SkTMax(FLAGS_gpu_shards, 1);
+    {
+        AutoThreadGrContextFactory factory;
+        for (int i = shard->index; i < shard->tasks->count(); i += shards) {
+            Task::Run(shard->tasks->begin() + i);
+        }
+    }
+    for (int i = shard->index; i < gGPUTests.count(); i += shards) {
         run_test(&gGPUTests[i]);
     }
 }
 
+static void run_gpu_shard_thread(void* shard) { run_gpu_shard((GPUShard*)shard); }
+
 // Some runs (mostly, Valgrind) are so slow that the bot framework thinks we've hung.
 // This prints something every once in a while so that it knows we're still working.
 static void start_keepalive() {
@@ -594,8 +617,17 @@ static void start_keepalive() {
 int dm_main();
 int dm_main() {
     SetupCrashHandler();
+    if (!FLAGS_trace.isEmpty()) {
+        SkEventTracer::SetInstance(SkNEW_ARGS(ChromeTracingTracer, (FLAGS_trace[0])));
+    }
     SkAutoGraphics ag;
     SkTaskGroup::Enabler enabled(FLAGS_threads);
+    gSkUseAnalyticAA = FLAGS_analyticAA;
+    SkGraphics::SetStrokeCacheEnabled(FLAGS_strokeCache);
+    SkGraphics::SetTextRunCacheEnabled(FLAGS_textRunCache);
+    SkGraphics::SetPatchCacheEnabled(FLAGS_patchCache);
+    SkGraphics::SetFastTextOnPathEnabled(FLAGS_fastTextOnPath);
+    SkGraphics::SetFontCacheSharesSubpixelImages(FLAGS_shareSubpixelGlyphs);
     if (FLAGS_leaks) {
         SkInstCountPrintLeaksOnExit();
     }
@@ -623,6 +655,12 @@ int dm_main() {
         }
     }
 
+    SkTArray<GPUShard> gpuShards;
+    for (int i = 0; i < SkTMax(FLAGS_gpu_shards, 1); i++) {
+        GPUShard shard = { &enclaves[kGPU_Enclave], i };
+        gpuShards.push_back(shard);
+    }
+
     SkTaskGroup tg;
     tg.batch(run_test, gThreadedTests.begin(), gThreadedTests.count());
     for (int i = 0; i < kNumEnclaves; i++) {
@@ -631,14 +669,26 @@ int dm_main() {
                 tg.batch(Task::Run, enclaves[i].begin(), enclaves[i].count());
                 break;
             case kGPU_Enclave:
-                tg.add(run_enclave_and_gpu_tests, &enclaves[i]);
-                break;
+                break;  // Started below.
             default:
                 tg.add(run_enclave, &enclaves[i]);
                 break;
         }
     }
+    SkTDArray<SkThread*> gpuThreads;
+    for (int i = 0; i < gpuShards.count(); i++) {
+        if (0 == FLAGS_threads) {
+            run_gpu_shard(&gpuShards[i]);
+        } else {
+            *gpuThreads.append() = SkNEW_ARGS(SkThread, (run_gpu_shard_thread, &gpuShards[i]));
+            gpuThreads.top()->start();
+        }
+    }
     tg.wait();
+    for (int i = 0; i < gpuThreads.count(); i++) {
+        gpuThreads[i]->join();
+    }
+    gpuThreads.deleteAll();
     // At this point we're back in single-threaded land.
 
     SkDebugf("\n");
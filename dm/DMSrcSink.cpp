@@ -22,6 +22,7 @@
 #include "SkScanlineDecoder.h"
 #include "SkSVGCanvas.h"
 #include "SkStream.h"
+#include "SkTLS.h"
 #include "SkXMLWriter.h"
 
 static bool lazy_decode_bitmap(const void* src, size_t size, SkBitmap* dst) {
@@ -301,6 +302,27 @@ GPUSink::GPUSink(GrContextFactory::GLContextType ct,
     , fUseDFText(dfText)
     , fThreaded(threaded) {}
 
+static void* create_thread_factory_slot() { return SkNEW_ARGS(GrContextFactory*, (NULL)); }
+static void delete_thread_factory_slot(void* slot) { SkDELETE((GrContextFactory**)slot); }
+
+static GrContextFactory** thread_factory_slot() {
+    return (GrContextFactory**)SkTLS::Get(create_thread_factory_slot, delete_thread_factory_slot);
+}
+
+AutoThreadGrContextFactory::AutoThreadGrContextFactory() {
+    SkASSERT(NULL == *thread_factory_slot());
+    *thread_factory_slot() = &fFactory;
+}
+
+AutoThreadGrContextFactory::~AutoThreadGrContextFactory() {
+    *thread_factory_slot() = NULL;
+}
+
+GrContextFactory* AutoThreadGrContextFactory::Get() {
+    GrContextFactory** slot = (GrContextFactory**)SkTLS::Find(create_thread_factory_slot);
+    return slot ? *slot : NULL;
+}
+
 int GPUSink::enclave() const {
     return fThreaded ? kAnyThread_Enclave : kGPU_Enclave;
 }
@@ -308,18 +330,33 @@ int GPUSink::enclave() const {
 void PreAbandonGpuContextErrorHandler(SkError, void*) {}
 
 Error GPUSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString* log) const {
-    GrContextFactory factory;
+    SkAutoTDelete<GrContextFactory> ownFactory;
+    GrContextFactory* factory = AutoThreadGrContextFactory::Get();
+    if (!factory) {
+        ownFactory.reset(SkNEW(GrContextFactory));
+        factory = ownFactory.get();
+    }
+    // A shared factory can't hand contexts we abandon on to the next task.
+    struct AutoDestroyAbandoned {
+        GrContextFactory* fFactory;
+        ~AutoDestroyAbandoned() {
+            if (FLAGS_preAbandonGpuContext || FLAGS_abandonGpuContext) {
+                fFactory->destroyContexts();
+            }
+        }
+    } destroyAbandoned = { factory };
+
     const SkISize size = src.size();
     const SkImageInfo info =
         SkImageInfo::Make(size.width(), size.height(), kN32_SkColorType, kPremul_SkAlphaType);
     SkAutoTUnref<SkSurface> surface(
-            NewGpuSurface(&factory, fContextType, fGpuAPI, info, fSampleCount, fUseDFText));
+            NewGpuSurface(factory, fContextType, fGpuAPI, info, fSampleCount, fUseDFText));
     if (!surface) {
         return "Could not create a surface.";
     }
     if (FLAGS_preAbandonGpuContext) {
         SkSetErrorCallback(&PreAbandonGpuContextErrorHandler, NULL);
-        factory.abandonContexts();
+        factory->abandonContexts();
     }
     SkCanvas* canvas = surface->getCanvas();
     Error err = src.draw(canvas);
@@ -334,7 +371,7 @@ Error GPUSink::draw(const Src& src, SkBitmap* dst, SkWStream*, SkString* log) co
     dst->allocPixels(info);
     canvas->readPixels(dst, 0, 0);
     if (FLAGS_abandonGpuContext) {
-        factory.abandonContexts();
+        factory->abandonContexts();
     }
     return "";
 }
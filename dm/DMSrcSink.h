@@ -142,6 +142,21 @@ public:
 };
 
 
+// GPUSinks draw with their thread's GrContextFactory while one of these is alive on it, so a
+// thread running many GPU tasks keeps its GL contexts and caches from one task to the next.
+// Otherwise each draw creates (and tears down) a factory of its own.
+class AutoThreadGrContextFactory : SkNoncopyable {
+public:
+    AutoThreadGrContextFactory();
+    ~AutoThreadGrContextFactory();
+
+    // This thread's factory, or NULL.
+    static GrContextFactory* Get();
+
+private:
+    GrContextFactory fFactory;
+};
+
 class GPUSink : public Sink {
 public:
     GPUSink(GrContextFactory::GLContextType, GrGLStandard, int samples, bool dfText, bool threaded);
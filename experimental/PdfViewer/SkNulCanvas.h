@@ -79,6 +79,7 @@ protected:
     void onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
                       const SkPaint& paint) override {}
     void onDrawRect(const SkRect& rect, const SkPaint& paint) override {}
+    void onDrawRects(const SkRect rects[], int count, const SkPaint& paint) override {}
     void onDrawOval(const SkRect& oval, const SkPaint&) override {}
     void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {}
     void onDrawPath(const SkPath& path, const SkPaint& paint) override {}
@@ -474,10 +474,70 @@ private:
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Dashed polylines made of diagonal segments, open and closed, with each cap. The gpu dashes these
+// in the fragment shader, so this compares that against the expanded dashes drawn by the cpu.
+class DashingPolylineGM : public skiagm::GM {
+public:
+    DashingPolylineGM() {}
+
+protected:
+
+    bool runAsBench() const override { return true; }
+
+    SkString onShortName() override {
+        return SkString("dashing_polyline");
+    }
+
+    SkISize onISize() override { return SkISize::Make(640, 480); }
+
+    void onDraw(SkCanvas* canvas) override {
+        static const SkPaint::Cap gCaps[] = {
+            SkPaint::kButt_Cap,
+            SkPaint::kRound_Cap,
+            SkPaint::kSquare_Cap,
+        };
+        static const SkScalar gIntervals[] = { SkIntToScalar(8), SkIntToScalar(5) };
+
+        SkPath zigzag;
+        zigzag.moveTo(0, 0);
+        for (int i = 1; i <= 8; ++i) {
+            zigzag.lineTo(SkIntToScalar(i * 20), SkIntToScalar((i & 1) * 24));
+        }
+        SkPath triangle;
+        triangle.moveTo(SkIntToScalar(200), SkIntToScalar(24));
+        triangle.lineTo(SkIntToScalar(230), 0);
+        triangle.lineTo(SkIntToScalar(260), SkIntToScalar(24));
+        triangle.close();
+
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setPathEffect(SkDashPathEffect::Create(gIntervals, 2, SkIntToScalar(3)))->unref();
+
+        canvas->translate(SkIntToScalar(20), SkIntToScalar(20));
+        for (size_t cap = 0; cap < SK_ARRAY_COUNT(gCaps); ++cap) {
+            paint.setStrokeCap(gCaps[cap]);
+            for (int aa = 0; aa < 2; ++aa) {
+                paint.setAntiAlias(SkToBool(aa));
+                for (int width = 0; width <= 3; width++) {
+                    paint.setStrokeWidth(SkIntToScalar(width));
+                    canvas->save();
+                    canvas->translate(SkIntToScalar(aa * 300), SkIntToScalar(width * 36));
+                    canvas->drawPath(zigzag, paint);
+                    canvas->drawPath(triangle, paint);
+                    canvas->restore();
+                }
+            }
+            canvas->translate(0, SkIntToScalar(150));
+        }
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 DEF_GM(return SkNEW(DashingGM);)
 DEF_GM(return SkNEW(Dashing2GM);)
 DEF_GM(return SkNEW(Dashing3GM);)
 DEF_GM(return SkNEW(Dashing4GM);)
 DEF_GM(return SkNEW_ARGS(Dashing5GM, (true));)
 DEF_GM(return SkNEW_ARGS(Dashing5GM, (false));)
-
+DEF_GM(return SkNEW(DashingPolylineGM);)
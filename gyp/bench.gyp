@@ -19,9 +19,15 @@
         '../bench/DecodingSubsetBench.cpp',
         '../bench/GMBench.cpp',
         '../bench/RecordingBench.cpp',
+        '../bench/SKPAnimationBench.cpp',
         '../bench/SKPBench.cpp',
+        '../bench/SKPStagesBench.cpp',
         '../bench/nanobench.cpp',
       ],
+      'include_dirs': [
+        '../src/codec',
+        '../src/opts',
+      ],
       'includes': [
         'bench.gypi',
         'gmslides.gypi',
@@ -30,6 +36,7 @@
         'flags.gyp:flags_common',
         'jsoncpp.gyp:jsoncpp',
         'skia_lib.gyp:skia_lib',
+        'tools.gyp:chrome_tracing_tracer',
         'tools.gyp:crash_handler',
         'tools.gyp:proc_stats',
         'tools.gyp:timer',
@@ -18,7 +18,9 @@
       'dependencies': [
         'core.gyp:*',
         'giflib.gyp:giflib',
+        'libjpeg.gyp:libjpeg',
         'libpng.gyp:libpng',
+        'libwebp.gyp:libwebp',
       ],
       'cflags':[
         # FIXME: This gets around a longjmp warning. See
@@ -29,13 +31,16 @@
         '../include/codec',
         '../src/codec',
         '../src/core',
+        '../src/opts',
       ],
       'sources': [
         '../src/codec/SkCodec.cpp',
         '../src/codec/SkCodec_libbmp.cpp',
         '../src/codec/SkCodec_libgif.cpp',
         '../src/codec/SkCodec_libico.cpp',
+        '../src/codec/SkCodec_libjpeg.cpp',
         '../src/codec/SkCodec_libpng.cpp',
+        '../src/codec/SkCodec_libwebp.cpp',
         '../src/codec/SkCodec_wbmp.cpp',
         '../src/codec/SkGifInterlaceIter.cpp',
         '../src/codec/SkMaskSwizzler.cpp',
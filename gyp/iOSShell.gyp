@@ -27,7 +27,9 @@
             '../bench/DecodingSubsetBench.cpp',
             '../bench/GMBench.cpp',
             '../bench/RecordingBench.cpp',
+            '../bench/SKPAnimationBench.cpp',
             '../bench/SKPBench.cpp',
+            '../bench/SKPStagesBench.cpp',
             '../bench/nanobench.cpp',
             '../tests/skia_test.cpp',
             '../tools/iOSShell.cpp',
@@ -32,6 +32,7 @@
 
         '../src/fonts/SkFontMgr_indirect.cpp',
         '../src/fonts/SkRemotableFontMgr.cpp',
+        '../src/fonts/SkRemoteGlyphCache.cpp',
         '../src/ports/SkFontHost_win.cpp',
         '../src/ports/SkFontMgr_default_gdi.cpp',
         '../src/ports/SkFontMgr_default_dw.cpp',
@@ -57,6 +58,7 @@
         '../include/ports/SkFontMgr.h',
         '../include/ports/SkFontMgr_indirect.h',
         '../include/ports/SkRemotableFontMgr.h',
+        '../include/ports/SkRemoteGlyphCache.h',
       ],
       'conditions': [
         [ 'skia_os in ["linux", "freebsd", "openbsd", "solaris", "chromeos", "nacl", "android"]', {
@@ -33,6 +33,7 @@
         'skpdiff',
         'skpinfo',
         'skpmaker',
+        'startup_time',
         'test_image_decoder',
         'test_public_includes',
       ],
@@ -103,6 +104,7 @@
       'target_name' : 'timer',
       'type': 'static_library',
       'sources': [
+        '../tools/timer/PerfCounters.cpp',
         '../tools/timer/Timer.cpp',
         '../tools/timer/TimerData.cpp',
       ],
@@ -135,6 +137,19 @@
         }],
       ],
     },
+    {
+      'target_name': 'chrome_tracing_tracer',
+      'type': 'static_library',
+      'sources': [ '../tools/ChromeTracingTracer.cpp' ],
+      'include_dirs': [ '../src/core' ],
+      'dependencies': [
+        'skia_lib.gyp:skia_lib',
+        'timer',
+      ],
+      'direct_dependent_settings': {
+        'include_dirs': [ '../tools', ],
+      },
+    },
     {
       'target_name': 'skdiff',
       'type': 'executable',
@@ -147,6 +162,9 @@
         '../tools/skdiff_utils.cpp',
         '../tools/skdiff_utils.h',
       ],
+      'include_dirs': [
+        '../src/core', # needed for SkTaskGroup.h and SkUtils.h
+      ],
       'dependencies': [
         'skia_lib.gyp:skia_lib',
       ],
@@ -260,16 +278,30 @@
         }],
       ],
     },
+    {
+      'target_name': 'startup_time',
+      'type': 'executable',
+      'sources': [
+        '../tools/startup_time.cpp',
+      ],
+      'dependencies': [
+        'timer',
+        'flags.gyp:flags',
+        'skia_lib.gyp:skia_lib',
+      ],
+    },
     {
       'target_name': 'skpinfo',
       'type': 'executable',
       'sources': [
         '../tools/skpinfo.cpp',
+        '../tools/DumpRecord.cpp',
       ],
       'include_dirs': [
         '../src/core/',
       ],
       'dependencies': [
+        'timer',
         'flags.gyp:flags',
         'skia_lib.gyp:skia_lib',
       ],
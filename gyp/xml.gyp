@@ -29,9 +29,6 @@
         '../src/xml/SkXMLPullParser.cpp',
         '../src/xml/SkXMLWriter.cpp',
       ],
-      'sources!': [
-          '../src/xml/SkXMLPullParser.cpp', #if 0 around class decl in header
-      ],
       'direct_dependent_settings': {
         'include_dirs': [
           '../include/xml',
@@ -11,6 +11,7 @@
 #ifndef sk_canvas_DEFINED
 #define sk_canvas_DEFINED
 
+#include "sk_path.h"
 #include "sk_types.h"
 
 SK_C_PLUS_PLUS_BEGIN_GUARD
@@ -38,6 +39,32 @@ void sk_canvas_draw_image_rect(sk_canvas_t*, const sk_image_t*, const sk_rect_t*
                                const sk_rect_t* dst, const sk_paint_t*);
 void sk_canvas_draw_picture(sk_canvas_t*, const sk_picture_t*, const sk_matrix_t*, const sk_paint_t*);
 
+/*
+ *  Batched draws: each of these draws many primitives with one paint in a single call, so that
+ *  callers going through a foreign function interface pay for one crossing rather than one per
+ *  primitive.
+ */
+
+/** Draw each of the count rects, in order. */
+void sk_canvas_draw_rects(sk_canvas_t*, const sk_rect_t rects[], int count, const sk_paint_t*);
+/** Draw the points as points, line segments or a polyline (see SkCanvas::drawPoints). */
+void sk_canvas_draw_points(sk_canvas_t*, sk_point_mode_t, size_t count, const sk_point_t points[],
+                           const sk_paint_t*);
+/**
+ *  Build a path from the verbs, points and conic weights (as sk_path_add_verbs) and draw it.
+ *  Nothing is drawn if they don't match.
+ */
+void sk_canvas_draw_path_verbs(sk_canvas_t*, const sk_path_verb_t verbs[], int verbCount,
+                               const sk_point_t points[], int pointCount,
+                               const float conicWeights[], int conicWeightCount,
+                               const sk_paint_t*);
+/**
+ *  Draw a run of count glyph IDs, each at its own position, in the paint's typeface and text
+ *  size. The paint's text encoding is ignored.
+ */
+void sk_canvas_draw_glyphs(sk_canvas_t*, const uint16_t glyphs[], const sk_point_t positions[],
+                           int count, const sk_paint_t*);
+
 SK_C_PLUS_PLUS_END_GUARD
 
 #endif
@@ -20,6 +20,19 @@ typedef enum {
     CCW_SK_PATH_DIRECTION,
 } sk_path_direction_t;
 
+/**
+ *  Each verb consumes points in order: MOVE and LINE take 1, QUAD and CONIC 2, CUBIC 3 and
+ *  CLOSE none. Each CONIC also consumes one weight.
+ */
+typedef enum {
+    MOVE_SK_PATH_VERB,
+    LINE_SK_PATH_VERB,
+    QUAD_SK_PATH_VERB,
+    CONIC_SK_PATH_VERB,
+    CUBIC_SK_PATH_VERB,
+    CLOSE_SK_PATH_VERB,
+} sk_path_verb_t;
+
 sk_path_t* sk_path_new();
 void sk_path_delete(sk_path_t*);
 
@@ -30,6 +43,15 @@ void sk_path_conic_to(sk_path_t*, float x0, float y0, float x1, float y1, float
 void sk_path_cubic_to(sk_path_t*, float x0, float y0, float x1, float y1, float x2, float y2);
 void sk_path_close(sk_path_t*);
 
+/**
+ *  Append all of the verbs, with their points and conic weights (which may be NULL if there are
+ *  no conics), in one call. If the counts don't match the verbs, or a verb is unknown, return
+ *  false and leave the path unchanged.
+ */
+bool sk_path_add_verbs(sk_path_t*, const sk_path_verb_t verbs[], int verbCount,
+                       const sk_point_t points[], int pointCount,
+                       const float conicWeights[], int conicWeightCount);
+
 void sk_path_add_rect(sk_path_t*, const sk_rect_t*, sk_path_direction_t);
 void sk_path_add_oval(sk_path_t*, const sk_rect_t*, sk_path_direction_t);
 
@@ -53,6 +53,12 @@ typedef enum {
     DIFFERENCE_SK_CLIPTYPE,
 } sk_cliptype_t;
 
+typedef enum {
+    POINTS_SK_POINT_MODE,
+    LINES_SK_POINT_MODE,
+    POLYGON_SK_POINT_MODE,
+} sk_point_mode_t;
+
 sk_colortype_t sk_colortype_get_default_8888();
 
 typedef struct {
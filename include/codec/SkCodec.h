@@ -80,6 +80,33 @@ public:
      */
     SkScanlineDecoder* getScanlineDecoder(const SkImageInfo& dstInfo);
 
+    /**
+     *  Starts decoding into dst piece by piece, for a stream that grows as the encoded data
+     *  arrives (e.g. over a slow network), so that the part available so far can be shown.
+     *  The pixels are written by the calls to incrementalDecode() that follow.
+     *
+     *  The arguments are checked like those of getPixels(). The stream is rewound, so it must
+     *  support that, and must already hold the header, since creating the codec read it.
+     *
+     *  @return kSuccess if incrementalDecode() can now be called, kUnimplemented if this
+     *      codec cannot decode incrementally, or one of the failures of getPixels().
+     */
+    Result startIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                  const Options* = NULL);
+
+    /**
+     *  Decodes as much as the stream holds, continuing where the last call stopped without
+     *  reading the input it consumed again. Requires a successful startIncrementalDecode(),
+     *  which is undone by any other decode.
+     *
+     *  @param rowsDecoded If not NULL, set to the number of rows from the top of dst that
+     *      hold decoded pixels. For interlaced images the rows below it may already hold
+     *      some from earlier passes too.
+     *  @return kSuccess once the whole image is decoded, kIncompleteInput if the stream ran
+     *      out first (call again once it holds more), or kInvalidInput if the data is bad.
+     */
+    Result incrementalDecode(int* rowsDecoded = NULL);
+
     /**
      *  Some images may initially report that they have alpha due to the format
      *  of the encoded data, but then never use any colors which have alpha
@@ -133,6 +160,23 @@ protected:
         return NULL;
     }
 
+    /**
+     *  Override if your codec supports incremental decoding. Like onGetPixels(), this must
+     *  call rewindIfNeeded() and handle it as appropriate. The arguments have been checked.
+     */
+    virtual Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                            size_t rowBytes, const Options&) {
+        return kUnimplemented;
+    }
+
+    /**
+     *  Only called after onStartIncrementalDecode() succeeded, and no other decode since.
+     *  Must set rowsDecoded.
+     */
+    virtual Result onIncrementalDecode(int* rowsDecoded) {
+        return kUnimplemented;
+    }
+
     virtual bool onReallyHasAlpha() const { return false; }
 
     enum RewindState {
@@ -171,6 +215,7 @@ private:
 #endif  //  SK_SUPPORT_LEGACY_BOOL_ONGETINFO
     SkAutoTDelete<SkStream>             fStream;
     bool                                fNeedsRewind;
+    bool                                fIncrementalDecodeStarted;
     SkAutoTDelete<SkScanlineDecoder>    fScanlineDecoder;
 
     typedef SkImageGenerator INHERITED;
@@ -28,4 +28,35 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Creates an SkTileGrid: a uniform grid of cells, each with the list of ops that may touch it.
+ *  This suits pictures whose ops are spread evenly and that are played back one tile at a time.
+ */
+class SK_API SkTileGridFactory : public SkBBHFactory {
+public:
+    struct TileGridInfo {
+        /** Tile placement interval */
+        SkISize  fTileInterval;
+
+        /** Pixel coverage overlap between adjacent tiles.  Queries of size
+          * fTileInterval + 2 * fMargin, aligned with the grid, visit a single tile.
+          */
+        SkISize  fMargin;
+
+        /** Offset added to bounding box positions to convert them to tile-grid space.  This
+          * lets the grid match the "phase" of the query rects that will be used to search it.
+          */
+        SkIPoint fOffset;
+    };
+
+    SkTileGridFactory(const TileGridInfo& info) : fInfo(info) { }
+
+    SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
+
+private:
+    TileGridInfo fInfo;
+
+    typedef SkBBHFactory INHERITED;
+};
+
 #endif
@@ -50,6 +50,8 @@ protected:
                             const SkPoint[], const SkPaint& paint) override;
     virtual void drawRect(const SkDraw&, const SkRect& r,
                           const SkPaint& paint) override;
+    void drawRects(const SkDraw&, const SkRect rects[], int count,
+                   const SkPaint& paint) override;
     virtual void drawOval(const SkDraw&, const SkRect& oval,
                           const SkPaint& paint) override;
     virtual void drawRRect(const SkDraw&, const SkRRect& rr,
@@ -93,6 +95,12 @@ protected:
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], int scalarsPerPos,
                              const SkPoint& offset, const SkPaint& paint) override;
+    void drawPosTextHalo(const SkDraw&, const void* text, size_t len,
+                         const SkScalar pos[], int scalarsPerPos,
+                         const SkPoint& offset, const SkPaint& haloPaint,
+                         const SkPaint& paint) override;
+    void drawTextOnPath(const SkDraw&, const void* text, size_t len, const SkPath&,
+                        const SkMatrix*, const SkPaint&) override;
     virtual void drawVertices(const SkDraw&, SkCanvas::VertexMode, int vertexCount,
                               const SkPoint verts[], const SkPoint texs[],
                               const SkColor colors[], SkXfermode* xmode,
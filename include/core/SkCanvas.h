@@ -681,6 +681,15 @@ public:
     */
     void drawRect(const SkRect& rect, const SkPaint& paint);
 
+    /** Draw each of the rectangles using the same paint. The result is the same as calling
+        drawRect() for each of them in order, but raster devices set up the blitter once and
+        stream all of the rectangles through it, which is much cheaper for many small rects.
+        @param rects    The rects to be drawn
+        @param count    The number of rects
+        @param paint    The paint used to draw the rects
+    */
+    void drawRects(const SkRect rects[], int count, const SkPaint& paint);
+
     /** Draw the specified rectangle using the specified paint. The rectangle
         will be filled or framed based on the Style in the paint.
         @param rect     The rect to be drawn
@@ -1200,6 +1209,7 @@ protected:
 
     virtual void onDrawPaint(const SkPaint&);
     virtual void onDrawRect(const SkRect&, const SkPaint&);
+    virtual void onDrawRects(const SkRect rects[], int count, const SkPaint&);
     virtual void onDrawOval(const SkRect&, const SkPaint&);
     virtual void onDrawRRect(const SkRRect&, const SkPaint&);
     virtual void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&);
@@ -1247,6 +1257,9 @@ protected:
     // notify our surface (if we have one) that we are about to draw, so it
     // can perform copy-on-write or invalidate any cached images
     void predrawNotify();
+    // as above, but the draw touches no more than bounds (in local coordinates, or the whole
+    // clip if NULL), so the surface need only track those pixels as changed
+    void predrawNotify(const SkRect* bounds);
 
 private:
     class MCRec;
@@ -1287,6 +1300,7 @@ private:
     friend class SkRecorder;        // InitFlags
     friend class SkNoSaveLayerCanvas;   // InitFlags
     friend class SkPictureImageFilter;  // SkCanvas(SkBaseDevice*, SkSurfaceProps*, InitFlags)
+    friend class SkPicture;             // playbackParallel() needs fProps
 
     enum InitFlags {
         kDefault_InitFlags                  = 0,
@@ -1323,6 +1337,11 @@ private:
     void internalDrawPaint(const SkPaint& paint);
     void internalSaveLayer(const SkRect* bounds, const SkPaint*, SaveFlags, SaveLayerStrategy);
     void internalDrawDevice(SkBaseDevice*, int x, int y, const SkPaint*);
+    // Draws text whose paint's looper just puts a halo of haloRadius and haloColor under it
+    // (see SkDrawLooper::asAHalo), handing each device the halo and the text in one call.
+    void internalDrawPosTextHalo(const void* text, size_t byteLength, const SkScalar pos[],
+                                 int scalarsPerPos, const SkPoint& offset, const SkPaint&,
+                                 SkScalar haloRadius, SkColor haloColor);
 
     // shared by save() and saveLayer()
     void internalSave();
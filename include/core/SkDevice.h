@@ -171,6 +171,9 @@ protected:
                             const SkPoint[], const SkPaint& paint) = 0;
     virtual void drawRect(const SkDraw&, const SkRect& r,
                           const SkPaint& paint) = 0;
+    // Default impl calls drawRect() for each rect
+    virtual void drawRects(const SkDraw&, const SkRect rects[], int count,
+                           const SkPaint& paint);
     virtual void drawOval(const SkDraw&, const SkRect& oval,
                           const SkPaint& paint) = 0;
     virtual void drawRRect(const SkDraw&, const SkRRect& rr,
@@ -218,6 +221,16 @@ protected:
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], int scalarsPerPos,
                              const SkPoint& offset, const SkPaint& paint) = 0;
+    /**
+     *  Draw the text as a halo looper would (see SkDrawLooper::asAHalo): first with haloPaint,
+     *  which strokes and fills it in the halo's color with a round join, then with paint.
+     *  The default impl. calls drawPosText() with each paint; devices may instead draw the halo
+     *  from the same glyphs as the text.
+     */
+    virtual void drawPosTextHalo(const SkDraw&, const void* text, size_t len,
+                                 const SkScalar pos[], int scalarsPerPos,
+                                 const SkPoint& offset, const SkPaint& haloPaint,
+                                 const SkPaint& paint);
     virtual void drawVertices(const SkDraw&, SkCanvas::VertexMode, int vertexCount,
                               const SkPoint verts[], const SkPoint texs[],
                               const SkColor colors[], SkXfermode* xmode,
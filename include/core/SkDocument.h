@@ -51,17 +51,34 @@ public:
      *         for larger PDF files too, which would use more memory
      *         while rendering, and it would be slower to be processed
      *         or sent online or to printer.
+     *  @param maxImageDpi If positive, bitmaps that would be embedded with
+     *         more pixels per inch than this, at the size they are drawn on
+     *         the page, are resampled down to it first.  A large image drawn
+     *         as a thumbnail then costs only the thumbnail's pixels.
      *  @returns NULL if there is an error, otherwise a newly created
      *           PDF-backed SkDocument.
      */
     static SkDocument* CreatePDF(SkWStream*,
-                                 SkScalar dpi = SK_ScalarDefaultRasterDPI);
+                                 SkScalar dpi = SK_ScalarDefaultRasterDPI,
+                                 SkScalar maxImageDpi = 0);
 
     /**
      *  Create a PDF-backed document, writing the results into a file.
      */
     static SkDocument* CreatePDF(const char outputFilePath[],
-                                 SkScalar dpi = SK_ScalarDefaultRasterDPI);
+                                 SkScalar dpi = SK_ScalarDefaultRasterDPI,
+                                 SkScalar maxImageDpi = 0);
+
+    /**
+     *  Like CreatePDF(SkWStream*, dpi, maxImageDpi), but endPage() only records the page;
+     *  pages are turned into PDF several at a time, concurrently on the
+     *  SkTaskGroup thread pool, and written in order.  Faster for long
+     *  documents, but the output lags behind endPage(), and canvas state that
+     *  a picture doesn't record (e.g. a draw filter) is ignored.
+     */
+    static SkDocument* CreateConcurrentPDF(SkWStream*,
+                                           SkScalar dpi = SK_ScalarDefaultRasterDPI,
+                                           SkScalar maxImageDpi = 0);
 
     /**
      *  Create a XPS-backed document, writing the results into the stream.
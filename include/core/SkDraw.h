@@ -23,6 +23,7 @@ class SkPath;
 class SkRegion;
 class SkRasterClip;
 struct SkDrawProcs;
+struct SkRSXform;
 struct SkRect;
 class SkRRect;
 
@@ -39,6 +40,11 @@ public:
     void    drawRect(const SkRect& rect, const SkPaint& paint) const {
         this->drawRect(rect, paint, NULL, NULL);
     }
+    /**
+     *  Same as calling drawRect() for each rect, but the blitter is chosen once and all of
+     *  the rects (culled against the clip) are scan converted into it.
+     */
+    void    drawRects(const SkRect rects[], int count, const SkPaint&) const;
     void    drawRRect(const SkRRect&, const SkPaint&) const;
     /**
      *  To save on mallocs, we allow a flag that tells us that srcPath is
@@ -68,6 +74,21 @@ public:
     void    drawPosText(const char text[], size_t byteLength,
                         const SkScalar pos[], int scalarsPerPosition,
                         const SkPoint& offset, const SkPaint& paint) const;
+    /**
+     *  Draw the text with haloPaint, a round-joined stroke and fill, and then with paint. When
+     *  it can, this draws the halo by dilating paint's glyph masks rather than rasterizing the
+     *  stroked glyphs, and looks each glyph up only once.
+     */
+    void    drawPosTextHalo(const char text[], size_t byteLength,
+                            const SkScalar pos[], int scalarsPerPosition,
+                            const SkPoint& offset, const SkPaint& haloPaint,
+                            const SkPaint& paint) const;
+    /**
+     *  Draw each glyph's mask (or if it has none, its outline) mapped through its xform, as
+     *  computed by SkTextAlongPath::ComputeXforms(). Requires CanDrawTextRSXform().
+     */
+    void    drawTextRSXform(const uint16_t glyphs[], const SkRSXform xforms[], int count,
+                            const SkPaint& paint) const;
     void    drawVertices(SkCanvas::VertexMode mode, int count,
                          const SkPoint vertices[], const SkPoint textures[],
                          const SkColor colors[], SkXfermode* xmode,
@@ -114,6 +135,7 @@ public:
                                     SkPoint* strokeSize);
 
     static bool ShouldDrawTextAsPaths(const SkPaint&, const SkMatrix&);
+    static bool CanDrawTextRSXform(const SkPaint&, const SkMatrix&);
     void        drawText_asPaths(const char text[], size_t byteLength,
                                  SkScalar x, SkScalar y, const SkPaint&) const;
     void        drawPosText_asPaths(const char text[], size_t byteLength,
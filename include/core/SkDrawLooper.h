@@ -108,6 +108,23 @@ public:
      */
     virtual bool asABlurShadow(BlurShadowRec*) const;
 
+    struct HaloRec {
+        SkScalar        fRadius;    // how far the halo reaches past the glyph outlines
+        SkColor         fColor;
+    };
+    /**
+     *  If this looper can be interpreted as having two layers, such that
+     *      1. The first layer (bottom most) just strokes and fills, with a round join, in its
+     *         own color
+     *      2. The second layer has no modifications to either paint or canvas
+     *      3. No other layers.
+     *  then return true, and if not null, fill out the HaloRec. Text drawn this way gets a halo
+     *  (or outline) of fColor under it, which devices can draw along with the text.
+     *
+     *  If any of the above are not met, return false and ignore the HaloRec parameter.
+     */
+    virtual bool asAHalo(HaloRec*) const;
+
     SK_TO_STRING_PUREVIRT()
     SK_DEFINE_FLATTENABLE_TYPE(SkDrawLooper)
 
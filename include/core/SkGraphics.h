@@ -10,6 +10,8 @@
 
 #include "SkTypes.h"
 
+class SkTraceMemoryDump;
+
 class SK_API SkGraphics {
 public:
     /**
@@ -111,6 +113,103 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  The pixels of lazily decoded images that are cached (see SkCachingPixelRef) don't count
+     *  against the resource cache limit, but against one of their own. PurgeResourceCache()
+     *  purges them too, apart from the ones that are pinned.
+     */
+    static size_t GetDecodedImageCacheTotalBytesUsed();
+    static size_t GetDecodedImageCacheTotalByteLimit();
+    static size_t SetDecodedImageCacheTotalByteLimit(size_t newLimit);
+
+    /**
+     *  How short of memory the system is, from least to most.  Android's onTrimMemory() levels
+     *  map onto these: TRIM_MEMORY_RUNNING_MODERATE and TRIM_MEMORY_RUNNING_LOW to kLow,
+     *  TRIM_MEMORY_RUNNING_CRITICAL and TRIM_MEMORY_UI_HIDDEN to kCritical, and
+     *  TRIM_MEMORY_BACKGROUND and above to kComplete.
+     */
+    enum MemoryPressure {
+        kLow_MemoryPressure,        //!< purge discardable pixels that were only used once
+        kCritical_MemoryPressure,   //!< purge all unlocked discardable pixels and cached resources
+        kComplete_MemoryPressure,   //!< purge the font cache as well
+    };
+
+    /**
+     *  Frees what Skia can spare for the given level of memory pressure.  None of the cache
+     *  limits change, so the caches fill up again as they are used.
+     */
+    static void PurgeForMemoryPressure(MemoryPressure);
+
+    /**
+     *  Reports the memory held by each of Skia's CPU-side caches to dump: the font and typeface
+     *  caches, the resource cache (broken down by kind of entry), the decoded image cache and
+     *  the global discardable memory pool. The pool's memory may back entries reported by the
+     *  other caches. See GrContext::dumpMemoryStatistics() for the GPU caches.
+     */
+    static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
+
+    /**
+     *  When enabled, the raster backend keeps the results of stroking paths in the resource
+     *  cache, keyed by the path's generation ID and the stroke parameters, so drawing the same
+     *  (non-volatile) path with the same stroke again skips re-stroking it. The entries count
+     *  against the resource cache budget. Off by default; returns the previous setting.
+     */
+    static bool GetStrokeCacheEnabled();
+    static bool SetStrokeCacheEnabled(bool enabled);
+
+    /**
+     *  When enabled, SkCanvas::drawText() lays out each string once, as a text blob of glyph IDs
+     *  and positions kept in the resource cache, keyed by the text and the paint's font settings.
+     *  Drawing the same string with the same font again draws the cached blob, which skips
+     *  converting the text to glyphs and measuring it, and lets backends that cache blobs reuse
+     *  their work. The entries count against the resource cache budget. Off by default; returns
+     *  the previous setting.
+     */
+    static bool GetTextRunCacheEnabled();
+    static bool SetTextRunCacheEnabled(bool enabled);
+
+    /**
+     *  When enabled, SkCanvas::drawPatch() keeps each patch's tessellation in the resource cache,
+     *  keyed by its control points, colors, texture coordinates and level of detail, so drawing
+     *  the same patch at about the same scale again skips tessellating it. The entries count
+     *  against the resource cache budget. Off by default; returns the previous setting.
+     */
+    static bool GetPatchCacheEnabled();
+    static bool SetPatchCacheEnabled(bool enabled);
+
+    /**
+     *  When enabled, the raster backend draws text on a path by rotating each glyph's mask to
+     *  the path's tangent at the glyph's middle, rather than bending the glyph's outline along
+     *  the path. That's much faster, and looks the same for gently curving paths, but glyphs no
+     *  longer deform around tight bends. Off by default; returns the previous setting.
+     *
+     *  Either way, the distance table measuring each (non-volatile) path is kept in the
+     *  resource cache, keyed by the path's generation ID.
+     */
+    static bool GetFastTextOnPathEnabled();
+    static bool SetFastTextOnPathEnabled(bool enabled);
+
+    /**
+     *  When enabled, a glyph drawn at a new subpixel offset whose mask comes out identical to one
+     *  already made for another offset of the same glyph shares that image, rather than keeping
+     *  its own copy in the font cache. Shared images aren't counted again by GetFontCacheUsed().
+     *  This costs a comparison per new image of a subpixel positioned strike. Off by default;
+     *  returns the previous setting.
+     */
+    static bool GetFontCacheSharesSubpixelImages();
+    static bool SetFontCacheSharesSubpixelImages(bool enabled);
+
+    /**
+     *  When enabled, drawing an immutable bitmap with kHigh_SkFilterQuality at a scale whose
+     *  high quality copy isn't in the resource cache yet no longer makes that copy on the drawing
+     *  thread. Instead the copy is made by an SkTaskGroup (see SkTaskGroup::Enabler) while this
+     *  draw uses kLow_SkFilterQuality, and draws after it is cached use it. This suits interactive
+     *  zooming, where one blurrier frame beats a slow one. Off by default; returns the previous
+     *  setting.
+     */
+    static bool GetAsyncHighQualityScalingEnabled();
+    static bool SetAsyncHighQualityScalingEnabled(bool enabled);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
@@ -31,6 +31,7 @@ public:
     };
     static SkImageEncoder* Create(Type);
 
+    SkImageEncoder();
     virtual ~SkImageEncoder();
 
     /*  Quality ranges from 0..100 */
@@ -38,6 +39,50 @@ public:
         kDefaultQuality = 80
     };
 
+    enum {
+        /** Let the encoder pick its zlib level. */
+        kDefault_ZLibLevel = -1
+    };
+
+    /**
+     *  The zlib compression level, from 0 (store only, fastest) to 9 (smallest), for encoders
+     *  that deflate their pixels (i.e. PNG). Other encoders ignore it.
+     */
+    int getZLibLevel() const { return fZLibLevel; }
+    void setZLibLevel(int level) { fZLibLevel = SkPin32(level, kDefault_ZLibLevel, 9); }
+
+    /**
+     *  The row filters the PNG encoder tries before deflating each row. Adaptive picks the best
+     *  of all of them per row, which compresses well but is the slowest; none is the fastest.
+     */
+    enum PNGFilter {
+        kDefault_PNGFilter,     //!< libpng's choice
+        kNone_PNGFilter,
+        kSub_PNGFilter,
+        kUp_PNGFilter,
+        kAdaptive_PNGFilter,
+    };
+
+    PNGFilter getPNGFilter() const { return fPNGFilter; }
+    void setPNGFilter(PNGFilter filter) { fPNGFilter = filter; }
+
+    /**
+     *  If true, and the bitmap is kN32 with no more than 256 distinct colors, the PNG encoder
+     *  writes it as a palette image, which is lossless and usually much smaller. Other
+     *  encoders ignore it. Defaults to false, since it costs an extra pass over the pixels.
+     */
+    bool getPalettize() const { return fPalettize; }
+    void setPalettize(bool palettize) { fPalettize = palettize; }
+
+    /**
+     *  If true, the PNG and JPEG encoders split tall bitmaps into strips of rows, compress them on
+     *  SkTaskGroup threads, and join them into one ordinary file. Each strip is compressed
+     *  without reference to the others (PNG ends each with a zlib sync flush, JPEG with a restart
+     *  marker), so the file is a little larger than a serial encode. Defaults to false.
+     */
+    bool getParallel() const { return fParallel; }
+    void setParallel(bool parallel) { fParallel = parallel; }
+
     /**
      *  Encode bitmap 'bm', returning the results in an SkData, at quality level
      *  'quality' (which can be in range 0-100). If the bitmap cannot be
@@ -78,6 +123,12 @@ protected:
      * This must be overridden by each SkImageEncoder implementation.
      */
     virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) = 0;
+
+private:
+    int         fZLibLevel;
+    PNGFilter   fPNGFilter;
+    bool        fPalettize;
+    bool        fParallel;
 };
 
 // This macro declares a global (i.e., non-class owned) creation entry point
@@ -90,6 +90,9 @@ public:
                                  const Context&,
                                  SkBitmap* result, SkIPoint* offset) = 0;
         virtual const SkSurfaceProps* surfaceProps() const = 0;
+        // returns true if createDevice() and filterImage() may be called from several threads
+        // at once, which lets the independent inputs of a filter be filtered in parallel.
+        virtual bool isThreadSafe() { return false; }
     };
 
     /**
@@ -323,6 +326,18 @@ protected:
     bool applyCropRect(const Context&, Proxy* proxy, const SkBitmap& src, SkIPoint* srcOffset,
                        SkIRect* bounds, SkBitmap* result) const;
 
+    /**
+     *  Filters all of this filter's inputs, returning each one's result and offset in the
+     *  matching entries of results and offsets, which must hold countInputs() entries. A NULL
+     *  input gives src at (0, 0), and an input that fails gives an empty bitmap.
+     *
+     *  The inputs are evaluated as a DAG: an input connected more than once is only filtered
+     *  once, and if the proxy isThreadSafe() the distinct inputs are filtered in parallel on an
+     *  SkTaskGroup. Returns true if every input succeeded.
+     */
+    bool filterInputs(Proxy*, const SkBitmap& src, const Context&,
+                      SkBitmap results[], SkIPoint offsets[]) const;
+
     /**
      *  Returns true if the filter can be expressed a single-pass
      *  GrProcessor, used to process this filter on the GPU, or false if
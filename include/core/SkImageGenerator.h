@@ -14,6 +14,7 @@
 class SkBitmap;
 class SkData;
 class SkImageGenerator;
+struct SkIRect;
 
 //#define SK_SUPPORT_LEGACY_OPTIONLESS_GET_PIXELS
 
@@ -145,9 +146,19 @@ public:
      */
     struct Options {
         Options()
-            : fZeroInitialized(kNo_ZeroInitialized) {}
+            : fZeroInitialized(kNo_ZeroInitialized)
+            , fSubset(NULL) {}
 
         ZeroInitialized fZeroInitialized;
+
+        /**
+         *  If not NULL, decode only this part of the image, which must be inside getInfo()'s
+         *  bounds. The info passed to getPixels must have the subset's dimensions, and the
+         *  subset's top left pixel is written to the first pixel of the destination.
+         *
+         *  Generators which cannot decode subsets return kUnimplemented.
+         */
+        const SkIRect*  fSubset;
     };
 
     /**
@@ -230,6 +241,12 @@ protected:
     virtual bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
                                  SkYUVColorSpace* colorSpace);
 
+    /**
+     *  Override and return true if onGetPixels() honors Options::fSubset. getPixels() checks
+     *  that the subset is inside the image and matches the requested info's dimensions.
+     */
+    virtual bool onCanDecodeSubset() const { return false; }
+
 private:
     const SkImageInfo fInfo;
 };
@@ -208,6 +208,16 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const;
 
+    /**
+     *  Override if your subclass can filter a round rect (in device space) by computing its
+     *  coverage a span at a time and handing it straight to the blitter, without a mask. On
+     *  success return kTrue_FilterReturn. On failure return kFalse_FilterReturn. To fall back
+     *  to filterRRectToNine() and filterMask() (the default) return kUnimplemented_FilterReturn.
+     *  Rects and ovals are passed in as round rects too.
+     */
+    virtual FilterReturn filterRRectToSpans(const SkRRect& devRRect, const SkMatrix&,
+                                            const SkRasterClip&, SkBlitter*) const;
+
 private:
     friend class SkDraw;
 
@@ -523,6 +523,17 @@ public:
     */
     bool mapRect(SkRect* dst, const SkRect& src) const;
 
+    /** Apply this matrix to count rectangles in src, and write their transformed
+        bounds into dst. This gives the same results as calling mapRect() on each
+        one, but maps all their corners together.
+        @param dst  Where the transformed rectangles are written.
+        @param src  The original rectangles to be transformed. src and dst may be
+                    the same array.
+        @param count The number of rectangles in src.
+        @return the result of calling rectStaysRect()
+    */
+    bool mapRects(SkRect dst[], const SkRect src[], int count) const;
+
     /** Apply this matrix to the rectangle, and write the transformed rectangle
         back into it. This is accomplished by transforming the 4 corners of
         rect, and then setting it to the bounds of those points
@@ -803,6 +814,7 @@ private:
     static void Persp_pts(const SkMatrix&, SkPoint dst[], const SkPoint[], int);
 
     static void Affine_vpts(const SkMatrix&, SkPoint dst[], const SkPoint[], int);
+    static void Persp_vpts(const SkMatrix&, SkPoint dst[], const SkPoint[], int);
 
     static const MapPtsProc gMapPtsProcs[];
 
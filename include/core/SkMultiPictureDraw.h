@@ -66,8 +66,15 @@ private:
         void draw();
 
         static void Reset(SkTDArray<DrawData>&);
+    };
+
+    // The raster draws into one canvas or set of pixels, in the order they were added. Each
+    // target is drawn by its own task, so no two tasks ever draw into the same pixels.
+    struct RasterTarget {
+        SkTDArray<DrawData*> fDraws;
+        bool                 fFlush;
 
-        static void Draw(DrawData* d) { d->draw(); }
+        static void Draw(RasterTarget*);
     };
 
     SkTDArray<DrawData> fThreadSafeDrawData;
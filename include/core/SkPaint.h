@@ -118,6 +118,7 @@ public:
         kGenA8FromLCD_Flag    = 0x2000, // hack for GDI -- do not use if you can help it
         kDistanceFieldTextTEMP_Flag = 0x4000, //!< TEMPORARY mask to enable distance fields
                                               // currently overrides LCD and subpixel rendering
+        kFloatPipeline_Flag   = 0x8000, //!< mask to blend in float when rasterizing to 8888
         // when adding extra flags, note that the fFlags member is specified
         // with a bit-width and you'll have to expand it.
 
@@ -297,6 +298,19 @@ public:
      */
     void setDistanceFieldTextTEMP(bool distanceFieldText);
 
+    /** Helper for getFlags(), returns true if kFloatPipeline_Flag bit is set
+     @return true if the floatPipeline bit is set in the paint's flags.
+     */
+    bool isFloatPipeline() const {
+        return SkToBool(this->getFlags() & kFloatPipeline_Flag);
+    }
+
+    /** Helper for setFlags(), setting or clearing the kFloatPipeline_Flag bit
+     @param floatPipeline true to set the kFloatPipeline_Flag bit in the paint's
+     flags, false to clear it.
+     */
+    void setFloatPipeline(bool floatPipeline);
+
 #ifdef SK_SUPPORT_LEGACY_FILTERLEVEL_ENUM
     enum FilterLevel {
         kNone_FilterLevel   = kNone_SkFilterQuality,
@@ -931,6 +945,17 @@ public:
     void getPosTextPath(const void* text, size_t length,
                         const SkPoint pos[], SkPath* path) const;
 
+    /** Replace outlines with the outlines of count glyphs (regardless of the text encoding),
+        one after another in the same path, each at its own origin at this paint's text size.
+        If they aren't null, pointOffsets and verbOffsets must have room for count + 1 entries:
+        entry i is where glyph i's outline starts in outlines' points or verbs, and entry count
+        is where the last one ends, so glyph i owns [offsets[i], offsets[i + 1]). Glyphs with no
+        outline (e.g. spaces) own an empty range. Unlike calling getTextPath() per glyph, this
+        makes one path rather than one per glyph.
+    */
+    void getGlyphPaths(const uint16_t glyphs[], int count, SkPath* outlines,
+                       int pointOffsets[] = NULL, int verbOffsets[] = NULL) const;
+
     /**
      *  Return a rectangle that represents the union of the bounds of all
      *  of the glyphs, but each one positioned at (0,0). This may be conservatively large, and
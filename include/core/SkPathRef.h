@@ -34,7 +34,7 @@ class SkWBuffer;
  * logical verb or the last verb in memory).
  */
 
-class SK_API SkPathRef : public ::SkRefCnt {
+class SK_API SkPathRef : public SkNVRefCnt<SkPathRef> {
 public:
     SK_DECLARE_INST_COUNT(SkPathRef);
 
@@ -455,7 +455,6 @@ private:
     SkDEBUGCODE(int32_t fEditorsAttached;) // assert that only one editor in use at any time.
 
     friend class PathRefTest_Private;
-    typedef SkRefCnt INHERITED;
 };
 
 #endif
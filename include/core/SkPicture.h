@@ -18,12 +18,15 @@ class GrContext;
 #endif
 
 class SkBitmap;
+class SkBBHFactory;
 class SkBBoxHierarchy;
 class SkCanvas;
 class SkData;
 class SkPictureData;
+class SkPixelRef;
 class SkPixelSerializer;
 class SkStream;
+class SkTaskGroup;
 class SkWStream;
 
 struct SkPictInfo;
@@ -79,7 +82,9 @@ public:
     typedef bool (*InstallPixelRefProc)(const void* src, size_t length, SkBitmap* dst);
 
     /**
-     *  Recreate a picture that was serialized into a stream.
+     *  Recreate a picture that was serialized into a stream.  If the stream's data is already
+     *  in memory (e.g. a file mmap'd by SkStream::NewFromFile()), it is parsed in place rather
+     *  than copied; the returned picture does not refer back to it.
      *  @param SkStream Serialized picture data. Ownership is unchanged by this call.
      *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
      *              encoded bitmap data from the stream.
@@ -128,6 +133,55 @@ public:
     */
     void playback(SkCanvas* canvas, AbortCallback* = NULL) const;
 
+    /** Replays the drawing commands on the specified canvas, splitting the canvas' top layer
+        into horizontal bands that are played back concurrently on the SkTaskGroup thread pool.
+        Each band is culled against this picture's BBH (if any), so pictures recorded with an
+        SkRTreeFactory benefit the most.
+
+        This only applies to canvases whose top layer pixels are directly accessible (raster
+        backed) and whose clip is a rect; otherwise it behaves exactly like playback().
+        The canvas' matrix/clip state is left unchanged by this call. Since geometry is clipped
+        to each band, anti-aliased edges crossing a band seam may differ slightly from playback().
+
+        @param canvas    the canvas receiving the drawing commands.
+        @param taskGroup the group used to schedule the bands, or NULL to use a private one.
+                         This call blocks until taskGroup->wait() returns.
+        @param bandCount the number of bands to split the canvas into, or 0 to pick a default.
+    */
+    void playbackParallel(SkCanvas* canvas, SkTaskGroup* taskGroup = NULL,
+                          int bandCount = 0) const;
+
+    /** Decodes the lazily generated bitmaps and images this picture draws (see
+        SkPixelRef::isLazyGenerated()) concurrently on the SkTaskGroup thread pool. Otherwise
+        each one is decoded by the first playback that draws it, one after the other. Those
+        drawn by nested pictures are included.
+
+        The decoded pixels are only kept for as long as their pixel refs' caches hold on to
+        them, so call this shortly before playback.
+
+        @param area      if non-NULL, only the bitmaps drawn by commands that may touch this
+                         rect are decoded. This relies on the BBH (if any) and includes every
+                         bitmap of the nested pictures those commands draw.
+        @param taskGroup the group used to schedule the decodes, or NULL to use a private one.
+                         This call blocks until taskGroup->wait() returns.
+        @return the number of distinct pixel refs decoded.
+    */
+    int preDecodeBitmaps(const SkRect* area = NULL, SkTaskGroup* taskGroup = NULL) const;
+
+    /** Returns a new picture that draws like this one, except that everything inside the first
+        comment group described as group (see SkCanvas::beginCommentGroup()) is replaced by
+        drawing replacement, with the matrix and clip in effect at the start of the group.  The
+        group's begin and end markers are kept, so the result can be updated the same way.
+
+        The rest of this picture's commands are shared with the new picture, not copied, which
+        makes this much cheaper than re-recording when only a small part has changed.  If
+        factory is non-NULL, the new picture gets a bounding box hierarchy from it.
+
+        Returns NULL if there's no such group, or if this picture contains drawables.
+    */
+    SkPicture* newWithCommentGroupReplaced(const char group[], const SkPicture* replacement,
+                                           SkBBHFactory* factory = NULL) const;
+
     /** Return the cull rect used when creating this picture: { 0, 0, cullWidth, cullHeight }.
         It does not necessarily reflect the bounds of what has been recorded into the picture.
         @return the cull rect used to create this picture
@@ -146,6 +200,19 @@ public:
      */
     void serialize(SkWStream*, SkPixelSerializer* serializer = NULL) const;
 
+    /**
+     *  Serialize to a stream, like serialize(), but smaller: each op's size is a varint rather
+     *  than a full word, each distinct paint is written once however many draws use it, and
+     *  path points are written as varint deltas of fixed point coordinates.
+     *
+     *  Path points that are multiples of 1/64 are always kept exactly. If pathPrecision is
+     *  positive, other points are rounded to multiples of it; otherwise they are kept as floats.
+     *
+     *  CreateFromStream() reads the result; there is no compact form of flatten().
+     */
+    void serializeCompact(SkWStream*, SkScalar pathPrecision = 0,
+                          SkPixelSerializer* serializer = NULL) const;
+
     /**
      *  Serialize to a buffer.
      */
@@ -244,15 +311,18 @@ private:
     // V38: Added PictureResolution option to SkPictureImageFilter
     // V39: Added FilterLevel option to SkPictureImageFilter
     // V40: Remove UniqueID serialization from SkImageFilter.
+    // V41: Pad streamed chunks to 4 bytes, and size typefaces in bytes, so SKPs parse in place.
+    // V42: Optional compact op, paint and path chunks, written by serializeCompact().
 
     // Note: If the picture version needs to be increased then please follow the
     // steps to generate new SKPs in (only accessible to Googlers): http://goo.gl/qATVcw
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 40;
+    static const uint32_t CURRENT_PICTURE_VERSION = 42;
 
     void createHeader(SkPictInfo* info) const;
+    void serialize(SkWStream*, SkPixelSerializer*, bool compact, SkScalar pathPrecision) const;
     static bool IsValidPictInfo(const SkPictInfo& info);
 
     // Takes ownership of the SkRecord and (optional) SnapshotArray, refs the (optional) BBH.
@@ -275,7 +345,12 @@ private:
     // will return NULL if drawableCount() returns 0
     SkPicture const* const* drawablePicts() const;
 
+    // Appends the lazily generated pixel refs drawn by the commands that may touch area (or by
+    // all of them if area is NULL) to pixelRefs, skipping those it already holds.
+    void gatherLazyPixelRefs(const SkRect* area, SkTDArray<SkPixelRef*>* pixelRefs) const;
+
     struct PathCounter;
+    struct LazyPixelRefFinder;
 
     struct Analysis {
         Analysis() {}  // Only used by SkPictureData codepath.
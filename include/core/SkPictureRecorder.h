@@ -32,7 +32,11 @@ public:
     enum RecordFlags {
         // This flag indicates that, if some BHH is being computed, saveLayer
         // information should also be extracted at the same time.
-        kComputeSaveLayerInfo_RecordFlag = 0x01
+        kComputeSaveLayerInfo_RecordFlag = 0x01,
+        // This flag asks for the picture to note which of its ops are opaque, so that playback
+        // can skip ops hidden under later opaque rects, rrects, and images.  It is ignored
+        // along with kComputeSaveLayerInfo_RecordFlag.
+        kComputeOcclusion_RecordFlag = 0x02,
     };
 
     /** Returns the canvas that records the drawing commands.
@@ -84,6 +88,19 @@ public:
     // Legacy API -- use endRecordingAsPicture instead.
     SkPicture* endRecording() { return this->endRecordingAsPicture(); }
 
+    /**
+     *  Like endRecordingAsPicture(), but splits what was recorded into a grid of sub-pictures,
+     *  each at most tileWidth x tileHeight and holding just the ops that touch its tile, clipped
+     *  to it. The returned picture draws those sub-pictures, skipping empty tiles. Curves and
+     *  antialiased edges that cross a seam may come out slightly differently, as under any clip.
+     *
+     *  If bbhFactory is non-NULL, each sub-picture and the returned picture get their own BBH
+     *  from it, so a clipped playback only visits the tiles it touches, and only their ops
+     *  inside the clip.
+     */
+    SkPicture* endRecordingAsTiles(SkScalar tileWidth, SkScalar tileHeight,
+                                   SkBBHFactory* bbhFactory = NULL);
+
 private:
     void reset();
 
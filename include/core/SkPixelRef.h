@@ -197,6 +197,13 @@ public:
      */
     virtual GrTexture* getTexture() { return NULL; }
 
+    /**
+     *  Returns true if this pixelRef generates its pixels when they're first locked (e.g. by
+     *  decoding them), rather than holding them all along. Such pixels are worth generating
+     *  ahead of time, see SkPicture::preDecodeBitmaps().
+     */
+    bool isLazyGenerated() const { return this->onIsLazyGenerated(); }
+
     /**
      *  If any planes or rowBytes is NULL, this should output the sizes and return true
      *  if it can efficiently return YUV planar data. If it cannot, it should return false.
@@ -285,6 +292,9 @@ protected:
     // default impl returns NULL.
     virtual SkData* onRefEncodedData();
 
+    // default impl returns false.
+    virtual bool onIsLazyGenerated() const { return false; }
+
     // default impl returns false.
     virtual bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
                                  SkYUVColorSpace* colorSpace);
@@ -317,7 +327,7 @@ private:
 
     // LockRec is only valid if we're in a locked state (isLocked())
     LockRec         fRec;
-    int             fLockCount;
+    int             fLockCount;     // Changes atomically, so nested locks can skip fMutex.
 
     // Bottom bit indicates the Gen ID is unique.
     bool genIDIsUnique() const { return SkToBool(fTaggedGenID.load() & 1); }
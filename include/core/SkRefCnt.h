@@ -257,11 +257,16 @@ public:
     //   - unique() needs acquire when it returns true, and no barrier if it returns false;
     //   - ref() doesn't need any barrier;
     //   - unref() needs a release barrier, and an acquire if it's going to call delete.
+    //
+    // There are no weak refs to an SkNVRefCnt, so once the count reads 1 no other thread can
+    // take a new ref.  unref() uses that to skip the atomic decrement for the last owner, which
+    // is the common case for objects that never leave the thread that made them.
 
     bool unique() const { return 1 == sk_atomic_load(&fRefCnt, sk_memory_order_acquire); }
     void    ref() const { (void)sk_atomic_fetch_add(&fRefCnt, +1, sk_memory_order_relaxed); }
     void  unref() const {
-        if (1 == sk_atomic_fetch_add(&fRefCnt, -1, sk_memory_order_acq_rel)) {
+        if (this->unique() ||
+            1 == sk_atomic_fetch_add(&fRefCnt, -1, sk_memory_order_acq_rel)) {
             SkDEBUGCODE(fRefCnt = 1;)   // restore the 1 for our destructor's assert
             SkDELETE((const Derived*)this);
         }
@@ -125,6 +125,17 @@ public:
     /** Returns the starting address for the data. If this cannot be done, returns NULL. */
     //TODO: replace with virtual const SkData* getData()
     virtual const void* getMemoryBase() { return NULL; }
+
+    /** If the next bytes of the stream are already in memory, returns a pointer to them and sets
+     *  size to how many of them there are, without moving the stream. This lets a caller use
+     *  them in place rather than read() a copy; skip() past the bytes used afterwards. The
+     *  pointer stays valid until the stream is rewound, moved past the end of those bytes, or
+     *  destroyed. A stream at its end may return a pointer with a size of 0. If the next bytes
+     *  are not in memory, returns NULL.
+     *
+     *  The bytes are all the rest of the stream when size equals getLength() - getPosition().
+     */
+    virtual const void* peekMemory(size_t* /*size*/) { return NULL; }
 };
 
 /** SkStreamRewindable is a SkStream for which rewind and duplicate are required. */
@@ -330,6 +341,7 @@ public:
     size_t getLength() const override;
 
     const void* getMemoryBase() override;
+    const void* peekMemory(size_t* size) override;
 
 private:
     SkData* fData;
@@ -39,6 +39,8 @@ public:
     SkScalar getMiter() const { return fMiterLimit; }
     SkPaint::Cap getCap() const { return fCap; }
     SkPaint::Join getJoin() const { return fJoin; }
+    SkScalar getResScale() const { return fResScale; }
+    bool isStrokeAndFill() const { return fStrokeAndFill; }
 
     bool isHairlineStyle() const {
         return kHairline_Style == this->getStyle();
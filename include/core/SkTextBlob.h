@@ -94,6 +94,7 @@ private:
     friend class GrBitmapTextContextB;
     friend class GrTextContext;
     friend class SkBaseDevice;
+    friend class SkCanvas;
     friend class SkTextBlobBuilder;
     friend class TextBlobTester;
 
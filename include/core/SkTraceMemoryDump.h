@@ -0,0 +1,37 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTraceMemoryDump_DEFINED
+#define SkTraceMemoryDump_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  Receives the memory usage of Skia's caches, from SkGraphics::DumpMemoryStatistics() and
+ *  GrContext::dumpMemoryStatistics(), so the embedder can pass it on to its own tracing or
+ *  accounting.
+ *
+ *  Each cache reports under a dump name like "skia/sk_resource_cache/bitmap", one value at a
+ *  time. The value names used are:
+ *      "size"              bytes held, in "bytes"
+ *      "purgeable_size"    the part of size that would be freed by purging, in "bytes"
+ *      "limit"             the cache's budget, in "bytes" (or "objects" for count limits)
+ *      "count"             number of entries, in "objects"
+ *      "purgeable_count"   the part of count that would be freed by purging, in "objects"
+ *  A cache only reports the values it can measure.
+ */
+class SK_API SkTraceMemoryDump {
+public:
+    virtual ~SkTraceMemoryDump() { }
+
+    virtual void dumpNumericValue(const char* dumpName,
+                                  const char* valueName,
+                                  const char* units,
+                                  uint64_t value) = 0;
+};
+
+#endif
@@ -352,6 +352,7 @@ protected:
 
 private:
     friend class SkGTypeface;
+    friend class SkRemoteTypeface;
     friend class SkPDFFont;
     friend class SkPDFCIDFont;
     friend class GrPathRendering;
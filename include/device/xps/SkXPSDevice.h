@@ -18,6 +18,7 @@
 #include "SkBitSet.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkData.h"
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkPoint.h"
@@ -149,6 +150,18 @@ private:
     };
     friend static HRESULT subset_typeface(TypefaceUse* current);
 
+    class ImageUse : ::SkNoncopyable {
+    public:
+        uint32_t genID;
+        SkIPoint origin;
+        SkISize size;
+        SkData* pngData;
+        IXpsOMImageResource* xpsImage;
+
+        explicit ImageUse();
+        ~ImageUse();
+    };
+
     SkXPSDevice(IXpsOMObjectFactory* xpsFactory);
 
     SkAutoCoInitialize fAutoCo;
@@ -163,6 +176,7 @@ private:
     SkVector fCurrentPixelsPerMeter;
 
     SkTArray<TypefaceUse, true> fTypefaces;
+    SkTArray<ImageUse, true> fImages;
 
     /** Creates a GUID based id and places it into buffer.
         buffer should have space for at least GUID_ID_LEN wide characters.
@@ -201,6 +215,10 @@ private:
         const SkColor skColor, const SkAlpha alpha,
         IXpsOMBrush** xpsBrush);
 
+    HRESULT createXpsImageResource(
+        const SkBitmap& bitmap,
+        IXpsOMImageResource** xpsImage);
+
     HRESULT createXpsImageBrush(
         const SkBitmap& bitmap,
         const SkMatrix& localMatrix,
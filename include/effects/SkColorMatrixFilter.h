@@ -23,6 +23,9 @@ public:
     void filterSpan(const SkPMColor src[], int count, SkPMColor[]) const override;
     uint32_t getFlags() const override;
     bool asColorMatrix(SkScalar matrix[20]) const override;
+    // Succeeds when each component only depends on itself, i.e. the matrix only scales and
+    // translates, so the matrix can be folded together with SkTableColorFilters.
+    bool asComponentTable(SkBitmap* table) const override;
     SkColorFilter* newComposed(const SkColorFilter*) const override;
 
 #if SK_SUPPORT_GPU
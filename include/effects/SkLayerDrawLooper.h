@@ -78,6 +78,7 @@ public:
     size_t contextSize() const override { return sizeof(LayerDrawLooperContext); }
 
     bool asABlurShadow(BlurShadowRec* rec) const override;
+    bool asAHalo(HaloRec* rec) const override;
 
     SK_TO_STRING_OVERRIDE()
 
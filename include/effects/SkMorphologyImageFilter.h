@@ -31,7 +31,11 @@ public:
 protected:
     SkMorphologyImageFilter(int radiusX, int radiusY, SkImageFilter* input,
                             const CropRect* cropRect);
-    bool filterImageGeneric(Proc procX, Proc procY,
+    /**
+     * Runs procX and procY over the source, or vanHerkProcX and vanHerkProcY for radii large
+     * enough that their constant cost per pixel wins.
+     */
+    bool filterImageGeneric(Proc procX, Proc procY, Proc vanHerkProcX, Proc vanHerkProcY,
                             Proxy*, const SkBitmap& src, const Context&,
                             SkBitmap* result, SkIPoint* offset) const;
     void flatten(SkWriteBuffer&) const override;
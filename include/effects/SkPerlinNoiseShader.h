@@ -84,14 +84,13 @@ public:
 
     private:
         SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-            int channel,
-            StitchData& stitchData, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
+        // Computes the color at a point of the noise, without looking at fCachedTile.
+        SkPMColor shadeNoisePoint(const SkPoint& point, StitchData& stitchData) const;
 
         SkMatrix fMatrix;
         PaintingData* fPaintingData;
+        // When stitching, the colors at the integer points of the tile, if they were cached.
+        SkBitmap fCachedTile;
 
         typedef SkShader::Context INHERITED;
     };
@@ -20,6 +20,7 @@
 
 class GrAARectRenderer;
 class GrBatchFontCache;
+class GrBitmapAtlas;
 class GrDrawTarget;
 class GrFontCache;
 class GrFragmentProcessor;
@@ -32,6 +33,7 @@ class GrLayerCache;
 class GrOvalRenderer;
 class GrPath;
 class GrPathRenderer;
+class GrPersistentCache;
 class GrPipelineBuilder;
 class GrResourceEntry;
 class GrResourceCache;
@@ -42,6 +44,7 @@ class GrVertexBuffer;
 class GrVertexBufferAllocPool;
 class GrStrokeInfo;
 class GrSoftwarePathRenderer;
+class SkTraceMemoryDump;
 class SkGpuDevice;
 class SkStrokeRec;
 
@@ -50,12 +53,46 @@ public:
     SK_DECLARE_INST_COUNT(GrContext)
 
     struct Options {
-        Options() : fDrawPathToCompressedTexture(false) { }
+        Options()
+            : fDrawPathToCompressedTexture(false)
+            , fPersistentCache(NULL)
+            , fMultiChannelDistanceFieldText(false)
+            , fCompressStaticBitmapTextures(false)
+            , fSortBatches(false)
+            , fMixedSampleAA(false) { }
 
         // EXPERIMENTAL
         // May be removed in the future, or may become standard depending
         // on the outcomes of a variety of internal tests.
         bool fDrawPathToCompressedTexture;
+
+        // If set, the backend saves compiled shader programs here and looks for them here before
+        // compiling, so programs built by an earlier run of the process can be reused.  Not
+        // owned; it must outlive the context.
+        GrPersistentCache* fPersistentCache;
+
+        // If set, distance field text stores three distance channels per glyph (in the color
+        // atlas) and takes their median in the shader, which keeps glyph corners sharp when one
+        // base glyph is scaled up or rotated. LCD text and color glyphs are unaffected.
+        bool fMultiChannelDistanceFieldText;
+
+        // EXPERIMENTAL
+        // If set, large opaque immutable bitmaps are ETC1 compressed on the CPU before they are
+        // uploaded, when the GPU can texture from ETC1. That takes a sixth of the memory of
+        // 8888, at the cost of the encode and some image quality.
+        bool fCompressStaticBitmapTextures;
+
+        // If set, batches that don't overlap are reordered before they are drawn so that draws
+        // using the same kind of batch, texture and blend end up next to each other, saving GL
+        // state changes. Overlapping batches always draw in the order they were recorded.
+        bool fSortBatches;
+
+        // If set, antialiased draws to a multisampled render target use coverage AA, as they
+        // would on a single sampled target, except for concave path fills (and paths no coverage
+        // AA renderer takes), which are multisampled instead of falling back to software. Rects,
+        // ovals, convex paths and text keep their cheap analytic edges, and complex fills are
+        // stenciled.
+        bool fMixedSampleAA;
     };
 
     /**
@@ -138,6 +175,25 @@ public:
      */
     void getResourceCacheUsage(int* resourceCount, size_t* resourceBytes) const;
 
+    /**
+     *  Gets counts of GPU resource cache activity since the last call to resetResourceCacheStats().
+     *  Resetting once a frame gives per-frame counts.
+     *
+     *  @param hits   If non-null, returns the number of lookups that found a cached resource.
+     *  @param misses If non-null, returns the number of lookups that didn't.
+     *  @param purges If non-null, returns the number of resources purged to stay within budget.
+     */
+    void getResourceCacheStats(int* hits, int* misses, int* purges) const;
+    void resetResourceCacheStats();
+
+    /**
+     *  Reports the memory held by this context's caches to dump, under "skia/gr_resource_cache",
+     *  "skia/gr_layer_cache" and "skia/gr_batch_font_cache". The layer and font atlases live in
+     *  textures that are also counted by the resource cache. See
+     *  SkGraphics::DumpMemoryStatistics() for the CPU-side caches.
+     */
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const;
+
     /**
      *  Specify the GPU resource cache limits. If the current cache exceeds either
      *  of these, it will be purged (LRU) to keep the cache within these limits.
@@ -539,6 +595,21 @@ public:
      */
     void flush(int flagsBitfield = 0);
 
+    /**
+     * Flushes the context and returns a fence that signals once the 3D API has executed all the
+     * work issued so far, including uploads made with kAsync_PixelOpsFlag. Pass it to
+     * waitFence() before reusing anything that work depends on, then to deleteFence(). A zero
+     * fence means the backend can't fence; waitFence() still works, but waits for all work.
+     */
+    GrFence insertFence();
+
+    /**
+     * Waits up to timeoutNs nanoseconds for fence to signal. Returns true if it has.
+     */
+    bool waitFence(GrFence fence, uint64_t timeoutNs);
+
+    void deleteFence(GrFence fence);
+
    /**
     * These flags can be used with the read/write pixels functions below.
     */
@@ -552,6 +623,10 @@ public:
         /** The src for write or dst read is unpremultiplied. This is only respected if both the
             config src and dst configs are an RGBA/BGRA 8888 format. */
         kUnpremul_PixelOpsFlag  = 0x4,
+        /** A surface write may stage the pixels and return before the backend has updated the
+            surface, e.g. to queue uploads of textures that will be drawn next frame without
+            stalling on the 3D API. The src buffer may still be reused once the call returns. */
+        kAsync_PixelOpsFlag     = 0x8,
     };
 
     /**
@@ -658,6 +733,7 @@ public:
     GrBatchFontCache* getBatchFontCache() { return fBatchFontCache; }
     GrFontCache* getFontCache() { return fFontCache; }
     GrLayerCache* getLayerCache() { return fLayerCache.get(); }
+    GrBitmapAtlas* getBitmapAtlas() { return fBitmapAtlas.get(); }
     GrDrawTarget* getTextTarget();
     const GrIndexBuffer* getQuadIndexBuffer() const;
     GrAARectRenderer* getAARectRenderer() { return fAARectRenderer; }
@@ -700,6 +776,7 @@ private:
     GrBatchFontCache*               fBatchFontCache;
     GrFontCache*                    fFontCache;
     SkAutoTDelete<GrLayerCache>     fLayerCache;
+    SkAutoTDelete<GrBitmapAtlas>    fBitmapAtlas;
 
     GrPathRendererChain*            fPathRendererChain;
     GrSoftwarePathRenderer*         fSoftwarePathRenderer;
@@ -754,6 +831,15 @@ private:
                           const SkPath&,
                           const GrStrokeInfo&);
 
+    // Draws srcRect of a bitmap accepted by GrBitmapAtlas::CanAtlas() from the bitmap atlas. The
+    // paint's first color processor must sample the atlas texture with local coords.
+    void drawAtlasedBitmap(GrRenderTarget*,
+                           const GrClip&,
+                           const GrPaint&,
+                           const SkMatrix& viewMatrix,
+                           const SkBitmap&,
+                           const SkRect& srcRect);
+
     GrTexture* internalRefScratchTexture(const GrSurfaceDesc&, uint32_t flags);
 
     /**
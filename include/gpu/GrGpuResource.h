@@ -144,6 +144,18 @@ public:
         kWrapped_LifeCycle,
     };
 
+    /**
+     * When over budget, the cache purges resources of lower priority before those of higher
+     * priority, and resources of the same priority in LRU order. Resources start at the default.
+     */
+    enum PurgePriority {
+        /** e.g. scratch surfaces, whose contents don't outlive a use. */
+        kLow_PurgePriority,
+        kDefault_PurgePriority,
+        /** Content that is expensive to recreate. */
+        kHigh_PurgePriority,
+    };
+
     /**
      * Tests whether a object has been abandoned or released. All objects will
      * be in this state after their creating GrContext is destroyed or has
@@ -275,6 +287,7 @@ private:
     void removeScratchKey();
     void makeBudgeted();
     void makeUnbudgeted();
+    void setPurgePriority(PurgePriority);
 
 #ifdef SK_DEBUG
     friend class GrGpu; // for assert in GrGpu to access getGpu
@@ -299,6 +312,7 @@ private:
     mutable size_t              fGpuMemorySize;
 
     LifeCycle                   fLifeCycle;
+    PurgePriority               fPurgePriority;
     const uint32_t              fUniqueID;
 
     SkAutoTUnref<const SkData>  fData;
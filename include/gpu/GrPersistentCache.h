@@ -0,0 +1,39 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrPersistentCache_DEFINED
+#define GrPersistentCache_DEFINED
+
+#include "SkData.h"
+
+/**
+ * Storage the client supplies through GrContext::Options::fPersistentCache, typically backed by
+ * files on disk, so that expensive GPU objects outlive the process that built them.
+ *
+ * The GL backend stores each shader program it links with glGetProgramBinary and, the next time
+ * it needs the same program, reloads it with glProgramBinary instead of compiling.  Keys and data
+ * are opaque blobs, and keys can run to a few KB, so implementations may want to hash them.
+ * Stale or corrupt data is detected and simply rebuilt.  Both calls are made
+ * from whichever thread is using the GrContext.
+ */
+class SK_API GrPersistentCache : SkNoncopyable {
+public:
+    virtual ~GrPersistentCache() {}
+
+    /**
+     * Returns the data last stored for key, or NULL if there is none.  The caller takes the ref.
+     */
+    virtual SkData* load(const SkData& key) = 0;
+
+    /**
+     * Saves data for key, replacing anything stored there before.  The cache may copy data or
+     * ref it, and is free to drop entries whenever it likes.
+     */
+    virtual void store(const SkData& key, const SkData& data) = 0;
+};
+
+#endif
@@ -472,6 +472,10 @@ enum GrClipType {
 // opaque type for 3D API object handles
 typedef intptr_t GrBackendObject;
 
+// opaque handle to a point in the 3D API's command stream, see GrContext::insertFence(). Zero
+// is never a real fence.
+typedef uint64_t GrFence;
+
 /**
  * Gr can wrap an existing texture created by the client with a GrTexture
  * object. The client is responsible for ensuring that the texture lives at
@@ -150,6 +150,7 @@ public:
         GLPtr<GrGLBeginQueryProc> fBeginQuery;
         GLPtr<GrGLBindAttribLocationProc> fBindAttribLocation;
         GLPtr<GrGLBindBufferProc> fBindBuffer;
+        GLPtr<GrGLBindBufferBaseProc> fBindBufferBase;
         GLPtr<GrGLBindFragDataLocationProc> fBindFragDataLocation;
         GLPtr<GrGLBindFragDataLocationIndexedProc> fBindFragDataLocationIndexed;
         GLPtr<GrGLBindFramebufferProc> fBindFramebuffer;
@@ -161,10 +162,12 @@ public:
         GLPtr<GrGLBlitFramebufferProc> fBlitFramebuffer;
         GLPtr<GrGLBufferDataProc> fBufferData;
         GLPtr<GrGLBufferSubDataProc> fBufferSubData;
+        GLPtr<GrGLBufferStorageProc> fBufferStorage;
         GLPtr<GrGLCheckFramebufferStatusProc> fCheckFramebufferStatus;
         GLPtr<GrGLClearProc> fClear;
         GLPtr<GrGLClearColorProc> fClearColor;
         GLPtr<GrGLClearStencilProc> fClearStencil;
+        GLPtr<GrGLClientWaitSyncProc> fClientWaitSync;
         GLPtr<GrGLColorMaskProc> fColorMask;
         GLPtr<GrGLCompileShaderProc> fCompileShader;
         GLPtr<GrGLCompressedTexImage2DProc> fCompressedTexImage2D;
@@ -180,18 +183,21 @@ public:
         GLPtr<GrGLDeleteQueriesProc> fDeleteQueries;
         GLPtr<GrGLDeleteRenderbuffersProc> fDeleteRenderbuffers;
         GLPtr<GrGLDeleteShaderProc> fDeleteShader;
+        GLPtr<GrGLDeleteSyncProc> fDeleteSync;
         GLPtr<GrGLDeleteTexturesProc> fDeleteTextures;
         GLPtr<GrGLDeleteVertexArraysProc> fDeleteVertexArrays;
         GLPtr<GrGLDepthMaskProc> fDepthMask;
         GLPtr<GrGLDisableProc> fDisable;
         GLPtr<GrGLDisableVertexAttribArrayProc> fDisableVertexAttribArray;
         GLPtr<GrGLDrawArraysProc> fDrawArrays;
+        GLPtr<GrGLDrawArraysInstancedProc> fDrawArraysInstanced;
         GLPtr<GrGLDrawBufferProc> fDrawBuffer;
         GLPtr<GrGLDrawBuffersProc> fDrawBuffers;
         GLPtr<GrGLDrawElementsProc> fDrawElements;
         GLPtr<GrGLEnableProc> fEnable;
         GLPtr<GrGLEnableVertexAttribArrayProc> fEnableVertexAttribArray;
         GLPtr<GrGLEndQueryProc> fEndQuery;
+        GLPtr<GrGLFenceSyncProc> fFenceSync;
         GLPtr<GrGLFinishProc> fFinish;
         GLPtr<GrGLFlushProc> fFlush;
         GLPtr<GrGLFlushMappedBufferRangeProc> fFlushMappedBufferRange;
@@ -215,6 +221,7 @@ public:
         GLPtr<GrGLGetQueryObjectui64vProc> fGetQueryObjectui64v;
         GLPtr<GrGLGetQueryObjectuivProc> fGetQueryObjectuiv;
         GLPtr<GrGLGetQueryivProc> fGetQueryiv;
+        GLPtr<GrGLGetProgramBinaryProc> fGetProgramBinary;
         GLPtr<GrGLGetProgramInfoLogProc> fGetProgramInfoLog;
         GLPtr<GrGLGetProgramivProc> fGetProgramiv;
         GLPtr<GrGLGetRenderbufferParameterivProc> fGetRenderbufferParameteriv;
@@ -224,6 +231,7 @@ public:
         GLPtr<GrGLGetStringProc> fGetString;
         GLPtr<GrGLGetStringiProc> fGetStringi;
         GLPtr<GrGLGetTexLevelParameterivProc> fGetTexLevelParameteriv;
+        GLPtr<GrGLGetUniformBlockIndexProc> fGetUniformBlockIndex;
         GLPtr<GrGLGetUniformLocationProc> fGetUniformLocation;
         GLPtr<GrGLInsertEventMarkerProc> fInsertEventMarker;
         GLPtr<GrGLInvalidateBufferDataProc> fInvalidateBufferData;
@@ -242,6 +250,8 @@ public:
         GLPtr<GrGLMatrixLoadIdentityProc> fMatrixLoadIdentity;
         GLPtr<GrGLPixelStoreiProc> fPixelStorei;
         GLPtr<GrGLPopGroupMarkerProc> fPopGroupMarker;
+        GLPtr<GrGLProgramBinaryProc> fProgramBinary;
+        GLPtr<GrGLProgramParameteriProc> fProgramParameteri;
         GLPtr<GrGLPushGroupMarkerProc> fPushGroupMarker;
         GLPtr<GrGLQueryCounterProc> fQueryCounter;
         GLPtr<GrGLReadBufferProc> fReadBuffer;
@@ -308,6 +318,7 @@ public:
         GLPtr<GrGLUniformMatrix2fvProc> fUniformMatrix2fv;
         GLPtr<GrGLUniformMatrix3fvProc> fUniformMatrix3fv;
         GLPtr<GrGLUniformMatrix4fvProc> fUniformMatrix4fv;
+        GLPtr<GrGLUniformBlockBindingProc> fUniformBlockBinding;
         GLPtr<GrGLUnmapBufferProc> fUnmapBuffer;
         GLPtr<GrGLUnmapBufferSubDataProc> fUnmapBufferSubData;
         GLPtr<GrGLUnmapTexSubImage2DProc> fUnmapTexSubImage2D;
@@ -316,6 +327,7 @@ public:
         GLPtr<GrGLVertexAttrib2fvProc> fVertexAttrib2fv;
         GLPtr<GrGLVertexAttrib3fvProc> fVertexAttrib3fv;
         GLPtr<GrGLVertexAttrib4fvProc> fVertexAttrib4fv;
+        GLPtr<GrGLVertexAttribDivisorProc> fVertexAttribDivisor;
         GLPtr<GrGLVertexAttribPointerProc> fVertexAttribPointer;
         GLPtr<GrGLViewportProc> fViewport;
 
@@ -80,6 +80,23 @@ bool SK_API Simplify(const SkPath& path, SkPath* result);
   */
 bool SK_API TightBounds(const SkPath& path, SkRect* result);
 
+/** Set result to the part of path that lies inside rect, for the common case where
+    Op(path, rectPath, kIntersect_SkPathOp, ...) would be overkill.
+    Curves are only split where they cross the rect's edges, so this takes time
+    linear in the size of path. Unlike Op(), the result keeps path's fill type,
+    and its contours may overlap and may run along the rect's edges. Inverse
+    fills are resolved with Op().
+
+    Returns true if operation was able to produce a result;
+    otherwise, result is unmodified.
+
+    @param path The path to clip.
+    @param rect The rectangle to clip path to.
+    @param result The clipped path. The result may be the input.
+    @return True if the clip succeeded.
+  */
+bool SK_API ClipToRect(const SkPath& path, const SkRect& rect, SkPath* result);
+
 /** Perform a series of path operations, optimized for unioning many paths together.
   */
 class SK_API SkOpBuilder {
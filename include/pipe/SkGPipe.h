@@ -14,6 +14,7 @@
 #include "SkPicture.h"
 #include "SkWriter32.h"
 
+class SkBitmap;
 class SkCanvas;
 
 // XLib.h might have defined Status already (ugh)
@@ -46,6 +47,28 @@ public:
      */
     void setBitmapDecoder(SkPicture::InstallPixelRefProc proc) { fProc = proc; }
 
+    /**
+     *  Resolves the handles of bitmaps that the writer's controller exported
+     *  (see SkGPipeController::exportBitmap) back into bitmaps.
+     */
+    class BitmapImporter {
+    public:
+        virtual ~BitmapImporter() {}
+
+        /**
+         *  Set dst to the bitmap exported as handle, returning false if there
+         *  is no such bitmap. dst should ref its pixels, rather than copy them,
+         *  so that it stays valid for as long as the stream uses it.
+         */
+        virtual bool importBitmap(uint32_t handle, SkBitmap* dst) = 0;
+    };
+
+    /**
+     *  Set the importer for bitmaps passed by handle. It is not owned, and must
+     *  outlive any calls to playback.
+     */
+    void setBitmapImporter(BitmapImporter* importer) { fImporter = importer; }
+
     // data must be 4-byte aligned
     // length must be a multiple of 4
     Status playback(const void* data, size_t length, uint32_t playbackFlags = 0,
@@ -54,6 +77,7 @@ private:
     SkCanvas*                       fCanvas;
     class SkGPipeState*             fState;
     SkPicture::InstallPixelRefProc  fProc;
+    BitmapImporter*                 fImporter;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -87,6 +111,17 @@ public:
     virtual void notifyWritten(size_t bytes) = 0;
     virtual int numberOfReaders() const { return 1; }
 
+    /**
+     *  Called by a writer that is cross process, without a shared address
+     *  space, for each bitmap it would otherwise copy into the stream. If the
+     *  reader can get at the pixels some other way, e.g. because they already
+     *  live in memory shared with the reader's process, return true and set
+     *  handle to a value that the reader's SkGPipeReader::BitmapImporter
+     *  resolves to the same bitmap. Otherwise return false, and the bitmap is
+     *  flattened into the stream.
+     */
+    virtual bool exportBitmap(const SkBitmap&, uint32_t* handle) { return false; }
+
 private:
     friend class SkGPipeWriter;
     void setCanvas(SkGPipeCanvas*);
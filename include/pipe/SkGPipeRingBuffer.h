@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGPipeRingBuffer_DEFINED
+#define SkGPipeRingBuffer_DEFINED
+
+#include "SkGPipe.h"
+
+/**
+ *  A single producer, single consumer ring buffer that carries an SkGPipe
+ *  stream through a block of memory both sides can see, such as a shared
+ *  memory mapping in two processes. The sides only communicate through that
+ *  memory, with lock free loads and stores, so the reader can be in another
+ *  process (e.g. a GPU process). Mapping the memory is left to the caller.
+ *
+ *  The writer side, an SkGPipeRingBufferController, is given to
+ *  SkGPipeWriter::startRecording(). Use SkGPipeWriter::kCrossProcess_Flag
+ *  unless both sides are in the same process. The reader side, an
+ *  SkGPipeRingBufferReader, plays back whatever has been written whenever
+ *  it is asked to.
+ *
+ *  When the ring is full the writer spins until the reader frees space, so
+ *  the reader must keep playing back while the writer is busy.
+ */
+class SkGPipeRingBuffer {
+public:
+    /**
+     *  Return the bytes of memory needed for a ring of the given capacity.
+     */
+    static size_t ComputeMemorySize(size_t capacity);
+
+    /**
+     *  Lay out an empty ring in memory, which must be 4-byte aligned. Do this
+     *  once, before either side attaches. The capacity is whatever fits in
+     *  memorySize after the ring's own bookkeeping; returns false if that is
+     *  too small for the writer. Each block the writer asks for must fit in
+     *  half the capacity, or writing stops.
+     */
+    static bool Init(void* memory, size_t memorySize);
+
+private:
+    struct Header;
+    friend class SkGPipeRingBufferController;
+    friend class SkGPipeRingBufferReader;
+
+    // Each block handed to the writer is preceded by a 32 bit record word:
+    // the bytes notified so far, plus these flags once the writer moves on.
+    static const uint32_t kClosed_RecordFlag = 1u << 31;  // No more bytes will be added.
+    static const uint32_t kWraps_RecordFlag  = 1u << 30;  // The next record starts the ring.
+    static const uint32_t kBytes_RecordMask  = kWraps_RecordFlag - 1;
+
+    static uint32_t* RecordWord(uint8_t* data, uint32_t offset) {
+        return reinterpret_cast<uint32_t*>(data + offset);
+    }
+};
+
+class SkGPipeRingBufferController : public SkGPipeController {
+public:
+    /**
+     *  Write into a ring laid out in memory by SkGPipeRingBuffer::Init.
+     */
+    explicit SkGPipeRingBufferController(void* memory);
+
+    void* requestBlock(size_t minRequest, size_t* actual) override;
+    void notifyWritten(size_t bytes) override;
+
+private:
+    SkGPipeRingBuffer::Header* fHeader;
+    uint8_t* fData;
+    // Bytes of the ring in use, from the reader's position up to the end of
+    // the current record, counted over the ring's lifetime.
+    uint32_t fUsed;
+    uint32_t fRecordOffset;
+    uint32_t fRecordBytes;
+};
+
+class SkGPipeRingBufferReader {
+public:
+    /**
+     *  Read from a ring laid out in memory by SkGPipeRingBuffer::Init, and
+     *  draw to target.
+     */
+    SkGPipeRingBufferReader(void* memory, SkCanvas* target);
+
+    /**
+     *  The underlying reader, e.g. to set its bitmap decoder or importer.
+     */
+    SkGPipeReader* reader() { return &fReader; }
+
+    /**
+     *  Play back everything written so far, then return. Returns
+     *  SkGPipeReader::kEOF_Status if more may be written later.
+     */
+    SkGPipeReader::Status playback();
+
+private:
+    SkGPipeReader fReader;
+    SkGPipeRingBuffer::Header* fHeader;
+    uint8_t* fData;
+    uint32_t fRecordOffset;
+    uint32_t fRecordBytesRead;
+    SkGPipeReader::Status fStatus;
+};
+
+#endif
@@ -12,6 +12,7 @@
 #include "SkFontMgr.h"
 #include "SkFontStyle.h"
 #include "SkRemotableFontMgr.h"
+#include "SkRemoteGlyphCache.h"
 #include "SkTArray.h"
 #include "SkTypeface.h"
 
@@ -25,8 +26,12 @@ public:
     // TODO: The SkFontMgr is only used for createFromStream/File/Data.
     // In the future these calls should be broken out into their own interface
     // with a name like SkFontRenderer.
-    SkFontMgr_Indirect(SkFontMgr* impl, SkRemotableFontMgr* proxy)
-        : fImpl(SkRef(impl)), fProxy(SkRef(proxy)), fFamilyNamesInited(false)
+    // If glyphs is not NULL, the typefaces made from fonts the proxy names get their glyphs
+    // from glyphs' broker.
+    SkFontMgr_Indirect(SkFontMgr* impl, SkRemotableFontMgr* proxy,
+                       SkRemoteGlyphCacheClient* glyphs = NULL)
+        : fImpl(SkRef(impl)), fProxy(SkRef(proxy)), fGlyphs(SkSafeRef(glyphs))
+        , fFamilyNamesInited(false)
     { }
 
 protected:
@@ -57,9 +62,11 @@ protected:
 
 private:
     SkTypeface* createTypefaceFromFontId(const SkFontIdentity& fontId) const;
+    SkTypeface* createTypefaceFromStream(SkStreamAsset*, uint32_t dataId, int ttcIndex) const;
 
     SkAutoTUnref<SkFontMgr> fImpl;
     SkAutoTUnref<SkRemotableFontMgr> fProxy;
+    SkAutoTUnref<SkRemoteGlyphCacheClient> fGlyphs;
 
     struct DataEntry {
         uint32_t fDataId;  // key1
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRemoteGlyphCache_DEFINED
+#define SkRemoteGlyphCache_DEFINED
+
+#include "SkFontMgr.h"
+#include "SkRemotableFontMgr.h"
+#include "SkTArray.h"
+#include "SkThread.h"
+
+class SkTypeface;
+
+/**
+ *  Glyph metrics and images rasterized once, by a broker process, for any number of renderer
+ *  processes to read from a block of memory they all see, such as a shared memory mapping.
+ *  Mapping the memory is left to the caller.
+ *
+ *  The broker side, an SkRemoteGlyphCacheBroker, is the only writer. It owns the SkGlyphCache
+ *  strikes the glyphs come from, and finds fonts through an SkRemotableFontMgr, so renderers
+ *  name them by SkFontIdentity just as SkFontMgr_Indirect does.
+ *
+ *  The renderer side, an SkRemoteGlyphCacheClient, wraps each of the renderer's typefaces.
+ *  Their glyphs are looked up in the shared memory without locks or IPC. A glyph that is not
+ *  there yet is requested from the broker through the embedder's Transport, after which the
+ *  broker has published it. Outlines, font metrics, and glyphs drawn with path effects, mask
+ *  filters, or rasterizers still come from the renderer's own copy of the font.
+ *
+ *  Glyphs are never removed. Once the memory is full, renderers rasterize what is missing
+ *  themselves.
+ */
+class SK_API SkRemoteGlyphCache {
+public:
+    /**
+     *  Lay out an empty cache in memory, which must be 4-byte aligned. Do this once, before
+     *  either side attaches. Returns false if memorySize is too small to be useful.
+     */
+    static bool Init(void* memory, size_t memorySize);
+
+private:
+    struct Header;
+    struct StrikeKey;
+    struct GlyphKey;
+    struct Request;
+    struct Entry;
+    friend class SkRemoteGlyphCacheBroker;
+    friend class SkRemoteGlyphCacheClient;
+    friend class SkRemoteScalerContext;
+
+    static uint32_t* Slots(uint8_t* memory);
+    static const uint32_t* Slots(const uint8_t* memory);
+    static uint32_t StrikeHash(const StrikeKey&);
+    static uint32_t SlotHash(uint32_t strikeHash, const GlyphKey&);
+    // Return the published glyph request asks for, or NULL. *strikeOffset caches where the
+    // request's strike is published, or is 0 if that is not known yet.
+    static const Entry* Find(const uint8_t* memory, const Request&, uint32_t strikeHash,
+                             uint32_t* strikeOffset);
+};
+
+class SK_API SkRemoteGlyphCacheBroker : SkNoncopyable {
+public:
+    /**
+     *  Publish glyphs into memory laid out by SkRemoteGlyphCache::Init. Fonts named in requests
+     *  are read from fonts and made into typefaces by impl, or by SkFontMgr::RefDefault() if
+     *  impl is NULL.
+     */
+    SkRemoteGlyphCacheBroker(void* memory, SkRemotableFontMgr* fonts, SkFontMgr* impl = NULL);
+    ~SkRemoteGlyphCacheBroker();
+
+    /**
+     *  Handle a request a client sent through its Transport, publishing the glyph it asks
+     *  for. Requests come from renderers, so are not trusted: returns false for one that is
+     *  malformed or names an unknown font, or if the memory is full. Thread safe.
+     */
+    bool handleRequest(const void* request, size_t length);
+
+private:
+    struct Font {
+        uint32_t    fDataId;
+        uint32_t    fTtcIndex;
+        SkTypeface* fTypeface;
+    };
+    struct StrikeRef {
+        uint32_t fHash;
+        uint32_t fOffset;
+    };
+
+    SkTypeface* findTypeface(uint32_t dataId, uint32_t ttcIndex);
+    uint32_t findOrAddStrike(const SkRemoteGlyphCache::StrikeKey&, uint32_t hash);
+    void* alloc(size_t size, uint32_t* offset);
+    bool publish(const SkRemoteGlyphCache::Request&, uint32_t strikeHash);
+
+    uint8_t* fMemory;
+    SkAutoTUnref<SkRemotableFontMgr> fFonts;
+    SkAutoTUnref<SkFontMgr> fImpl;
+
+    SkMutex fMutex;
+    // Guarded by fMutex.
+    SkTArray<Font, true> fTypefaces;
+    SkTArray<StrikeRef, true> fStrikes;
+};
+
+class SK_API SkRemoteGlyphCacheClient : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkRemoteGlyphCacheClient)
+
+    /**
+     *  Carries requests from a client to its broker, e.g. over IPC.
+     */
+    class Transport {
+    public:
+        virtual ~Transport() {}
+
+        /**
+         *  Pass request to SkRemoteGlyphCacheBroker::handleRequest(), returning once the
+         *  broker has handled it. May be called from several threads at once.
+         */
+        virtual void sendRequest(const void* request, size_t length) = 0;
+    };
+
+    /**
+     *  Read glyphs from memory laid out by SkRemoteGlyphCache::Init, asking for missing
+     *  ones through transport, which must outlive this client and its typefaces.
+     */
+    SkRemoteGlyphCacheClient(const void* memory, Transport* transport);
+
+    /**
+     *  Return a typeface that draws like local, the renderer's copy of the font the broker
+     *  knows as id, but gets its glyphs from the broker. The caller must unref() it.
+     */
+    SkTypeface* createTypeface(SkTypeface* local, const SkFontIdentity& id);
+
+private:
+    const SkRemoteGlyphCache::Entry* find(const SkRemoteGlyphCache::Request& request,
+                                          uint32_t strikeHash, uint32_t* strikeOffset) const {
+        return SkRemoteGlyphCache::Find(fMemory, request, strikeHash, strikeOffset);
+    }
+    const SkRemoteGlyphCache::Entry* findOrRequest(const SkRemoteGlyphCache::Request&,
+                                                   uint32_t strikeHash, uint32_t* strikeOffset);
+
+    const uint8_t* fMemory;
+    Transport* fTransport;
+
+    friend class SkRemoteScalerContext;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
@@ -9,6 +9,7 @@
 #define SkSVGCanvas_DEFINED
 
 #include "SkCanvas.h"
+#include "SkParsePath.h"
 
 class SkXMLWriter;
 
@@ -26,6 +27,14 @@ public:
      *  SVG element).
      */
     static SkCanvas* Create(const SkRect& bounds, SkXMLWriter*);
+
+    /**
+     *  As above, but path data is written with at most 'pathPrecision' digits after the decimal
+     *  point (see SkParsePath::ToSVGString), and with relative commands for
+     *  kRelative_PathEncoding.  Both can shrink large documents such as maps considerably.
+     */
+    static SkCanvas* Create(const SkRect& bounds, SkXMLWriter*,
+                            SkParsePath::PathEncoding pathEncoding, int pathPrecision);
 };
 
 #endif
@@ -44,7 +44,7 @@ public:
     static void ConvertToArray(SkString& vals);
 protected:
     virtual bool onAddAttribute(const char name[], const char value[]);
-    bool onAddAttributeLen(const char name[], const char value[], size_t len);
+    virtual bool onAddAttributeLen(const char name[], const char value[], size_t len);
     virtual bool onEndElement(const char elem[]);
     virtual bool onStartElement(const char elem[]);
     bool onStartElementLen(const char elem[], size_t len);
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompactPath_DEFINED
+#define SkCompactPath_DEFINED
+
+#include "SkPath.h"
+#include "SkRefCnt.h"
+#include "SkTDArray.h"
+
+/** \class SkCompactPath
+
+    An immutable, compact copy of a path made only of lines, for keeping many long polylines
+    in memory. Each point is stored as a pair of 16-bit offsets from the top left of the
+    path's bounds, and the verbs are implied: each contour is a move followed by lines, and
+    may be closed. A point takes 4 bytes, where an SkPath takes 9 (an SkPoint and a verb).
+
+    Iter walks it the way SkPath::Iter walks the path it came from, and toPath() rebuilds
+    an SkPath to draw.
+*/
+class SK_API SkCompactPath : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkCompactPath)
+
+    /** Returns a compact copy of path with every coordinate within tolerance of the
+        original, or NULL if path has curves, isn't finite, or is too large for 16-bit
+        offsets to reach tolerance. Moves that begin no line, and lines that go nowhere
+        once quantized, are dropped.
+    */
+    static SkCompactPath* Create(const SkPath& path, SkScalar tolerance);
+
+    SkPath::FillType getFillType() const { return fFillType; }
+
+    /** The bounds of the quantized points. */
+    const SkRect& getBounds() const { return fBounds; }
+
+    int countPoints() const { return fCoords.count() >> 1; }
+    int countContours() const { return fContours.count(); }
+
+    /** Returns the size of the points and contours held, in bytes. */
+    size_t approximateBytesUsed() const;
+
+    /** Sets path to the lines this holds. */
+    void toPath(SkPath* path) const;
+
+    /** Iterates through the contours, returning the same verbs and points as SkPath::Iter
+        does for the path toPath() makes. Only moves, lines and closes are returned.
+    */
+    class SK_API Iter {
+    public:
+        Iter(const SkCompactPath& path, bool forceClose);
+
+        SkPath::Verb next(SkPoint pts[4]);
+
+    private:
+        const SkCompactPath&    fPath;
+        SkPoint                 fMoveTo;
+        SkPoint                 fLastPt;
+        int                     fContour;
+        int                     fIndex;
+        bool                    fForceClose;
+        bool                    fNeedClose;
+    };
+
+private:
+    SkCompactPath(const SkRect& bounds, SkPath::FillType fillType);
+
+    SkPoint point(int index) const {
+        return SkPoint::Make(fOrigin.fX + fStep.fX * fCoords[index * 2],
+                             fOrigin.fY + fStep.fY * fCoords[index * 2 + 1]);
+    }
+
+    // Each contour's end, one past its last point, shifted up by one, with the low bit set
+    // if it is closed.
+    SkTDArray<uint32_t> fContours;
+    SkTDArray<uint16_t> fCoords;
+    SkPoint             fOrigin;
+    SkVector            fStep;
+    SkRect              fBounds;
+    SkPath::FillType    fFillType;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
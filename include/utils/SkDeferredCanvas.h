@@ -27,11 +27,28 @@ class SK_API SkDeferredCanvas : public SkCanvas {
 public:
     class SK_API NotificationClient;
 
+    enum PlaybackThread {
+        /** Pending commands are played back by the thread that flushes them. */
+        kCaller_PlaybackThread,
+        /**
+         *  Pending commands flushed by reaching the storage limit, or by
+         *  flushInBackground(), are played back on another thread while
+         *  recording continues. Anything that needs the surface's pixels, like
+         *  flush(), readPixels() or newImageSnapshot(), waits for that
+         *  playback to finish. Up to twice the storage limit may be in use.
+         *  Without a thread pool, playback happens at once on the caller's
+         *  thread instead.
+         */
+        kBackground_PlaybackThread,
+    };
+
     /** Construct a canvas with the specified surface to draw into.
         This factory must be used for newImageSnapshot to work.
         @param surface Specifies a surface for the canvas to draw into.
+        @param playbackThread Where pending commands are played back.
      */
-    static SkDeferredCanvas* Create(SkSurface* surface);
+    static SkDeferredCanvas* Create(SkSurface* surface,
+                                    PlaybackThread playbackThread = kCaller_PlaybackThread);
 
 //    static SkDeferredCanvas* Create(SkBaseDevice* device);
 
@@ -143,6 +160,13 @@ public:
      */
     void silentFlush();
 
+    /**
+     *  Starts playing back pending commands without waiting for them, if the
+     *  canvas was created with kBackground_PlaybackThread. Otherwise this
+     *  plays them back.
+     */
+    void flushInBackground();
+
     SkDrawFilter* setDrawFilter(SkDrawFilter* filter) override;
 
 protected:
@@ -171,6 +195,7 @@ protected:
     void onDrawPaint(const SkPaint&) override;
     void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
     void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawOval(const SkRect&, const SkPaint&) override;
     void onDrawRRect(const SkRRect&, const SkPaint&) override;
     void onDrawPath(const SkPath&, const SkPaint&) override;
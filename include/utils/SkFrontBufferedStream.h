@@ -18,6 +18,10 @@ class SkStreamRewindable;
  *  where the caller knows that rewind will only be called from within
  *  X bytes (inclusive), and the wrapped stream is not necessarily
  *  able to rewind at all.
+ *
+ *  If the rest of the wrapped stream is already in memory (see
+ *  SkStream::peekMemory), nothing is copied: the returned stream reads
+ *  from that memory, and its peekMemory returns it for decoding in place.
  */
 class SkFrontBufferedStream {
 public:
@@ -28,6 +28,16 @@ public:
                          const int32_t xDivs[], int numXDivs,
                          const int32_t yDivs[], int numYDivs,
                          const SkPaint* paint = NULL);
+
+    /**
+     *  Draws the bitmap as a nine-patch into each of the count dst rects, like calling DrawNine
+     *  for each, but as one triangle mesh: every nine-patch adds 16 vertices whose texture
+     *  coordinates are the same margin lines in the bitmap, and all of them go to a single
+     *  drawVertices call (split only when 16 bit indices run out). Empty rects are skipped.
+     */
+    static void DrawNineBatch(SkCanvas* canvas, const SkRect dsts[], int count,
+                              const SkBitmap& bitmap, const SkIRect& margins,
+                              const SkPaint* paint = NULL);
 };
 
 #endif
@@ -13,11 +13,26 @@
 #include "SkPath.h"
 
 class SkString;
+class SkWStream;
 
 class SkParsePath {
 public:
     static bool FromSVGString(const char str[], SkPath*);
     static void ToSVGString(const SkPath&, SkString*);
+
+    enum PathEncoding {
+        kAbsolute_PathEncoding,     //!< "M10 10L20 10", as ToSVGString(path, str) writes
+        kRelative_PathEncoding,     //!< "m10 10l10 0", shorter for paths far from the origin
+    };
+
+    /**
+     *  Writes the path's SVG data straight to the stream. Coordinates are rounded to at most
+     *  'precision' digits after the decimal point, with trailing zeros dropped; a negative
+     *  precision prints them with "%g" like the SkString version. Relative coordinates are
+     *  taken from the rounded points already written, so rounding errors don't accumulate.
+     */
+    static void ToSVGString(const SkPath&, SkWStream*,
+                            PathEncoding = kAbsolute_PathEncoding, int precision = -1);
 };
 
 #endif
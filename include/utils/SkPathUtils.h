@@ -35,6 +35,14 @@ public:
     static void BitsToPath_Region(SkPath* path, const char* bitmap,
                                    int w, int h, int rowBytes);
 
+    /**
+       Sets dst to src with its runs of lines thinned out by Douglas-Peucker, so that every
+       point dropped is within tolerance of the lines that replace it. Move, close and
+       curve verbs are all kept, and so are the points where runs of lines begin and end.
+       dst may be src. A tolerance <= 0 copies src.
+    */
+    static void Simplify(const SkPath& src, SkScalar tolerance, SkPath* dst);
+
 };
 
 #endif
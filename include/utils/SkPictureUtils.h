@@ -10,6 +10,8 @@
 
 #include "SkPicture.h"
 
+class SkRegion;
+
 class SK_API SkPictureUtils {
 public:
     /**
@@ -19,6 +21,18 @@ public:
      *  SkRecord holds a reference to (e.g. paths, or pixels backing bitmaps).
      */
     static size_t ApproximateBytesUsed(const SkPicture* pict);
+
+    /**
+     *  Compute where drawing after may differ from drawing before, both drawn with matrix, by
+     *  comparing the pictures op by op.  damage is set to those device pixels, and is empty if
+     *  the pictures draw the same.  Clip to damage and draw after to repaint just what changed.
+     *
+     *  This errs on the side of damage: ops it can't compare (e.g. drawables, or paints with
+     *  equivalent but distinct effects) count as changed, and changed ops damage their whole
+     *  bounds, which are as loose as those the pictures' BBHs use.
+     */
+    static void ComputeDamage(const SkPicture* before, const SkPicture* after,
+                              const SkMatrix& matrix, SkRegion* damage);
 };
 
 #endif
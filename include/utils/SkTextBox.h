@@ -11,6 +11,24 @@
 #define SkTextBox_DEFINED
 
 #include "SkCanvas.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+
+class SkTextLineBreaker {
+public:
+    struct Line {
+        size_t  fOffset;    // from the start of the text, in bytes
+        size_t  fLength;    // in bytes, not counting trailing whitespace or the line break
+    };
+
+    static int CountLines(const char text[], size_t len, const SkPaint&, SkScalar width);
+
+    /** Break the text into lines that fit in width, appending them to lines if it is not NULL.
+        Returns the number of lines.
+    */
+    static int BreakLines(const char text[], size_t len, const SkPaint&, SkScalar width,
+                          SkTDArray<Line>* lines);
+};
 
 /** \class SkTextBox
 
@@ -76,12 +94,18 @@ private:
     size_t      fLen;
     const SkPaint* fPaint;
 
+    // The lines the text was last broken into, and what they depend on. Text that is drawn again
+    // and again is only broken into lines again when it, the box width or the paint changes.
+    mutable SkTDArray<SkTextLineBreaker::Line>  fLines;
+    mutable SkString                            fLinesText;
+    mutable SkScalar                            fLinesWidth;
+    mutable SkPaint                             fLinesPaint;
+    mutable SkPaint::FontMetrics                fLinesMetrics;
+    mutable SkScalar                            fLinesFontHeight;
+
+    const SkTDArray<SkTextLineBreaker::Line>& breakLines(const char text[], size_t len,
+                                                         const SkPaint&) const;
     SkScalar visit(Visitor&, const char text[], size_t len, const SkPaint&) const;
 };
 
-class SkTextLineBreaker {
-public:
-    static int CountLines(const char text[], size_t len, const SkPaint&, SkScalar width);
-};
-
 #endif
@@ -19,6 +19,7 @@
 
 class SkCanvas;
 class SkLayerView;
+class SkPicture;
 
 /** \class SkView
 
@@ -34,6 +35,7 @@ public:
         kFlexH_Shift,
         kFlexV_Shift,
         kNoClip_Shift,
+        kCachePicture_Shift,
 
         kFlagShiftCount
     };
@@ -44,6 +46,7 @@ public:
         kFlexH_Mask     = 1 << kFlexH_Shift,        //!< set if the view's width is stretchable
         kFlexV_Mask     = 1 << kFlexV_Shift,        //!< set if the view's height is stretchable
         kNoClip_Mask    = 1 << kNoClip_Shift,        //!< set if the view is not clipped to its bounds
+        kCachePicture_Mask = 1 << kCachePicture_Shift,  //!< set if the view's drawing is recorded and replayed
 
         kAllFlagMasks   = (uint32_t)(0 - 1) >> (32 - kFlagShiftCount)
     };
@@ -64,11 +67,19 @@ public:
     int         isEnabled() const { return fFlags & kEnabled_Mask; }
     int         isFocusable() const { return fFlags & kFocusable_Mask; }
     int         isClipToBounds() const { return !(fFlags & kNoClip_Mask); }
+    int         isCachePicture() const { return fFlags & kCachePicture_Mask; }
     /** Helper to set/clear the view's kVisible_Mask flag */
     void        setVisibleP(bool);
     void        setEnabledP(bool);
     void        setFocusableP(bool);
     void        setClipToBounds(bool);
+    /** When set, the view's onDraw() is recorded into a picture the first time the view is
+        drawn, and later draws replay that picture until the view is invalidated (see inval()).
+        Only the view's own drawing is recorded; children are drawn as usual, so invalidating a
+        child doesn't throw away its parent's picture. Set this on views whose onDraw() output
+        only changes when they call inval().
+    */
+    void        setCachePicture(bool);
 
     /** Return the view's width */
     SkScalar    width() const { return fWidth; }
@@ -118,6 +129,7 @@ public:
     /** Call this to invalidate part of all of a view, requesting that the view's
         draw method be called. The rectangle parameter specifies the part of the view
         that should be redrawn. If it is null, it specifies the entire view bounds.
+        This also discards the view's cached picture, if it has one.
     */
     void        inval(SkRect* rectOrNull);
 
@@ -389,6 +401,7 @@ private:
     SkView*     fPrevSibling;
     uint8_t     fFlags;
     uint8_t     fContainsFocus;
+    SkPicture*  fPicture;   // onDraw()'s output, when kCachePicture_Mask is set
 
     friend class B2FIter;
     friend class F2BIter;
@@ -398,6 +411,7 @@ private:
     bool    setFocusView(SkView* fvOrNull);
     SkView* acceptFocus(FocusDirection);
     void    detachFromParent_NoLayout();
+    void    drawContent(SkCanvas*);
     /** Compute the matrix to transform view-local coordinates into global ones */
     void    localToGlobal(SkMatrix* matrix) const;
 };
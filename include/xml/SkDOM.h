@@ -18,6 +18,7 @@ struct SkDOMNode;
 struct SkDOMAttr;
 
 class SkDOMParser;
+class SkStream;
 class SkXMLParser;
 
 class SkDOM {
@@ -31,6 +32,8 @@ public:
     /** Returns null on failure
     */
     const Node* build(const char doc[], size_t len);
+    // Parses the document straight from the stream, without reading it all into memory first.
+    const Node* build(SkStream&);
     const Node* copy(const SkDOM& dom, const Node* node);
 
     const Node* getRootNode() const;
@@ -11,6 +11,8 @@
 #define SkXMLParser_DEFINED
 
 #include "SkString.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
 
 class SkStream;
 
@@ -56,7 +58,9 @@ public:
             SkXMLParser(SkXMLParserError* parserError = NULL);
     virtual ~SkXMLParser();
 
-    /** Returns true for success
+    /** Returns true for success. The document is streamed through an SkXMLPullParser, so only
+        the current token is ever held in memory, and names and values are passed to the
+        callbacks straight from its buffer.
     */
     bool parse(const char doc[], size_t len);
     bool parse(SkStream& docStream);
@@ -68,6 +72,8 @@ protected:
     // override in subclasses; return true to stop parsing
     virtual bool onStartElement(const char elem[]);
     virtual bool onAddAttribute(const char name[], const char value[]);
+    // value is nul terminated too; the default calls onAddAttribute()
+    virtual bool onAddAttributeLen(const char name[], const char value[], size_t len);
     virtual bool onEndElement(const char elem[]);
     virtual bool onText(const char text[], int len);
 
@@ -75,6 +81,7 @@ public:
     // public for ported implementation, not meant for clients to call
     virtual bool startElement(const char elem[]);
     virtual bool addAttribute(const char name[], const char value[]);
+    virtual bool addAttributeLen(const char name[], const char value[], size_t len);
     virtual bool endElement(const char elem[]);
     virtual bool text(const char text[], int len);
     void* fParser;
@@ -84,14 +91,25 @@ private:
     void reportError(void* parser);
 };
 
-#if 0
-class SkXMLPullParser {
+/**
+ *  Pulls the tokens of an XML document out of a stream one at a time. The stream is read into a
+ *  window that only grows to hold the largest single token, so a document of any size parses
+ *  in about that much memory. Names, attribute values and text point straight into the window,
+ *  with entity references decoded in place, so nothing is copied or allocated per token; they
+ *  are valid until the next call to nextToken().
+ *
+ *  Names and attribute values are nul terminated. Text (TEXT, CDSECT, COMMENT, DOCDECL and
+ *  PROCESSING_INSTRUCTION) is not, so use getTextLength() with getText().
+ */
+class SkXMLPullParser : SkNoncopyable {
 public:
             SkXMLPullParser();
+    // The stream is not owned, and must outlive parsing.
     explicit SkXMLPullParser(SkStream*);
     virtual ~SkXMLPullParser();
 
     SkStream*   getStream() const { return fStream; }
+    // Starts over at START_DOCUMENT with the new stream (which may be NULL).
     SkStream*   setStream(SkStream* stream);
 
     enum EventType {
@@ -109,12 +127,14 @@ public:
         DOCDECL
     };
 
+    // An empty element tag (<a/>) is returned as a START_TAG followed by an END_TAG.
     EventType   nextToken();
     EventType   getEventType() const { return fCurr.fEventType; }
 
     struct AttrInfo {
         const char* fName;
         const char* fValue;
+        size_t      fValueLength;
     };
 
     int         getDepth() const { return fDepth; }
@@ -122,9 +142,25 @@ public:
     int         getAttributeCount();
     void        getAttributeInfo(int, AttrInfo*);
     const char* getText();
+    size_t      getTextLength();
     bool        isWhitespace();
 
+    enum Error {
+        kNone_Error,
+        kNoStream_Error,
+        kUnexpectedEnd_Error,   // the stream ended inside a token or an element
+        kMalformedTag_Error,
+        kMismatchedTag_Error,   // an end tag that doesn't close the open element
+        kOutsideRoot_Error,     // text, CDATA or a second element outside the root element
+    };
+    // Why nextToken() returned ERROR, and the line of the token it was parsing (from 1).
+    Error       getError() const { return fError; }
+    int         getLineNumber() const { return fTokenLine; }
+
 protected:
+    // Called for entity references other than the five predefined ones and character references.
+    // A replacement no longer than the reference itself is substituted; otherwise the reference
+    // is left as is.
     virtual bool onEntityReplacement(const char name[],
                                      SkString* replacement);
 
@@ -132,24 +168,52 @@ public:
     struct Curr {
         EventType   fEventType;
         const char* fName;
+        size_t      fNameLength;
         AttrInfo*   fAttrInfos;
         int         fAttrInfoCount;
         bool        fIsWhitespace;
     };
 
 private:
-    // implemented in the porting layer
+    // The tokenizer, in SkXMLPullParser.cpp.
     bool        onInit();   // return false on failure
     EventType   onNextToken();
     void        onExit();
 
+    bool        fill();
+    bool        ensure(size_t length);
+    size_t      find(size_t from, const char pattern[], size_t patternLength);
+    size_t      tagLength();
+    size_t      docDeclLength();
+    size_t      decode(char text[], size_t length);
+    char*       take(size_t length);
+    EventType   consume(EventType, size_t prefix, size_t length, size_t suffix);
+    EventType   error(Error);
+    EventType   parseStartTag(char tag[], size_t length);
+    EventType   parseEndTag(char tag[], size_t length);
+    EventType   parseText();
+
     SkStream*   fStream;
     Curr        fCurr;
     int         fDepth;
 
-    struct Impl;
-    Impl*   fImpl;
+    // fBuffer[fPos, fEnd) holds the unparsed part of the stream read so far.
+    SkAutoTMalloc<char>     fBuffer;
+    size_t                  fCapacity;
+    size_t                  fPos;
+    size_t                  fEnd;
+    bool                    fStreamEnded;
+
+    SkTDArray<AttrInfo>     fAttrs;
+    // The names of the open elements, nul terminated and end to end.
+    SkTDArray<char>         fOpenNames;
+    SkTDArray<int>          fOpenNameStarts;
+    bool                    fPendingEndTag;
+    bool                    fSeenRoot;
+
+    Error                   fError;
+    int                     fLine;
+    int                     fTokenLine;
 };
-#endif
 
 #endif
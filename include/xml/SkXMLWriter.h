@@ -11,7 +11,9 @@
 #include "SkTDArray.h"
 #include "SkString.h"
 #include "SkDOM.h"
+#include "SkTemplates.h"
 
+class SkDynamicMemoryWStream;
 class SkWStream;
 class SkXMLParser;
 
@@ -26,6 +28,10 @@ public:
     void    addHexAttribute(const char name[], uint32_t value, int minDigits = 0);
     void    addScalarAttribute(const char name[], SkScalar value);
     void    addText(const char text[], size_t length);
+    /** Starts an attribute whose value the caller writes, unescaped, to the returned stream,
+        which is only valid until the matching endAttribute(). */
+    SkWStream* beginAttribute(const char name[]);
+    void    endAttribute();
     void    endElement() { this->onEndElement(); }
     void    startElement(const char elem[]);
     void    startElementLen(const char elem[], size_t length);
@@ -38,6 +44,9 @@ protected:
     virtual void onAddAttributeLen(const char name[], const char value[], size_t length) = 0;
     virtual void onAddText(const char text[], size_t length) = 0;
     virtual void onEndElement() = 0;
+    // By default the value is buffered and handed to onAddAttributeLen().
+    virtual SkWStream* onBeginAttribute(const char name[]);
+    virtual void onEndAttribute();
 
     struct Elem {
         Elem(const char name[], size_t len)
@@ -57,6 +66,8 @@ protected:
 
 private:
     bool fDoEscapeMarkup;
+    SkString fAttributeName;
+    SkAutoTDelete<SkDynamicMemoryWStream> fAttributeValue;
     // illegal
     SkXMLWriter& operator=(const SkXMLWriter&);
 };
@@ -73,6 +84,8 @@ protected:
     void onEndElement() override;
     void onAddAttributeLen(const char name[], const char value[], size_t length) override;
     void onAddText(const char text[], size_t length) override;
+    SkWStream* onBeginAttribute(const char name[]) override;
+    void onEndAttribute() override;
 
 private:
     SkWStream&      fStream;
@@ -174,8 +174,7 @@ void SkActive::create(SkADrawable* drawable, SkMSec time) {
         if (animate->formula.size() > 0) {
             SkTDOperandArray values;
             values.setCount(count);
-            SkDEBUGCODE(bool success = ) animate->fFieldInfo->setValue(fMaker, &values, 0, 0, NULL,
-                animate->getValuesType(), animate->formula);
+            SkDEBUGCODE(bool success = ) animate->evaluateFormula(fMaker, &values);
             SkASSERT(success);
             fApply.applyValues(index, values.begin(), count, animate->getValuesType(), time);
         } else {
@@ -212,8 +211,7 @@ bool SkActive::immediate(bool enable) {
             if (animate->formula.size() > 0) {
                 SkTDOperandArray values;
                 values.setCount(count);
-                SkDEBUGCODE(bool success = ) animate->fFieldInfo->setValue(fMaker, &values, 0, 0, NULL,
-                    animate->getValuesType(), animate->formula);
+                SkDEBUGCODE(bool success = ) animate->evaluateFormula(fMaker, &values);
                 SkASSERT(success);
                 fApply.applyValues(index, values.begin(), count, animate->getValuesType(), time);
             } else {
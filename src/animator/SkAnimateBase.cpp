@@ -159,6 +159,27 @@ void SkAnimateBase::onEndElement(SkAnimateMaker& maker) {
     }
 }
 
+bool SkAnimateBase::evaluateFormula(SkAnimateMaker& maker, SkTDOperandArray* values) {
+    SkASSERT(formula.size() > 0);
+    if (fFormulaCached.size() > 0 && fFormulaCached.equals(formula)) {
+        SkASSERT(values->count() == fFormulaValues.count());
+        memcpy(values->begin(), fFormulaValues.begin(), values->count() * sizeof(SkOperand));
+        return true;
+    }
+    bool isConstant;
+    if (fFieldInfo->setValue(maker, values, 0, 0, NULL, getValuesType(), formula,
+            &isConstant) == false)
+        return false;
+    // strings and arrays belong to the storage they were written to, so only plain values are kept
+    SkDisplayTypes type = getValuesType();
+    if (isConstant && type != SkType_String && type != SkType_DynamicString &&
+            type != SkType_Array) {
+        fFormulaValues = *values;
+        fFormulaCached = formula;
+    }
+    return true;
+}
+
 void SkAnimateBase::packARGB(SkScalar array[], int count, SkTDOperandArray* converted)
 {
     SkASSERT(count == 4);
@@ -30,6 +30,9 @@ public:
     void dump(SkAnimateMaker* ) override;
 #endif
     int entries() { return fValues.count() / components(); }
+    // Evaluates formula into values, which holds components() operands. A formula that only
+    // combines literals is parsed once; later calls copy out the value it had then.
+    bool evaluateFormula(SkAnimateMaker& , SkTDOperandArray* values);
     virtual bool hasExecute() const;
     bool isDynamic() const { return SkToBool(fDynamic); }
     SkDisplayable* getParent() const override;
@@ -64,6 +67,8 @@ protected:
     SkMSec fStart;  // corrected time when this apply was enabled
     SkADrawable* fTarget;
     SkTypedArray fValues;
+    SkTDOperandArray fFormulaValues;    // the value of fFormulaCached, a constant formula
+    SkString fFormulaCached;
     unsigned fChanged : 1; // true when value referenced by script has changed
     unsigned fDelayed : 1;  // enabled, but undrawn pending delay
     unsigned fDynamic : 1;
@@ -629,8 +629,7 @@ bool SkApply::interpolate(SkAnimateMaker& maker, SkMSec rawTime) {
                 fLastTime = animate->dur;
             SkTypedArray formulaValues;
             formulaValues.setCount(count);
-            SkDEBUGCODE(bool success = ) animate->fFieldInfo->setValue(maker, &formulaValues, 0, 0, NULL,
-                animate->getValuesType(), animate->formula);
+            SkDEBUGCODE(bool success = ) animate->evaluateFormula(maker, &formulaValues);
             SkASSERT(success);
             if (restore)
                 save(inner); // save existing value
@@ -182,8 +182,10 @@ static inline bool is_hex(int c)
 
 bool SkMemberInfo::setValue(SkAnimateMaker& maker, SkTDOperandArray* arrayStorage,
     int storageOffset, int maxStorage, SkDisplayable* displayable, SkDisplayTypes outType,
-    const char rawValue[], size_t rawValueLen) const
+    const char rawValue[], size_t rawValueLen, bool* isConstant) const
 {
+    if (isConstant)
+        *isConstant = false;
     SkString valueStr(rawValue, rawValueLen);
     SkScriptValue scriptValue;
     scriptValue.fType = SkType_Unknown;
@@ -254,6 +256,8 @@ scriptCommon: {
                     maker.setScriptError(engine);
                     return false;
                 }
+                if (isConstant)
+                    *isConstant = engine.isConstant();
             }
             SkASSERT(success);
             if (scriptValue.fType == SkType_Displayable) {
@@ -348,9 +352,9 @@ dirty:
 
 bool SkMemberInfo::setValue(SkAnimateMaker& maker, SkTDOperandArray* arrayStorage,
         int storageOffset, int maxStorage, SkDisplayable* displayable, SkDisplayTypes outType,
-        SkString& raw) const {
+        SkString& raw, bool* isConstant) const {
     return setValue(maker, arrayStorage, storageOffset, maxStorage, displayable, outType, raw.c_str(),
-        raw.size());
+        raw.size(), isConstant);
 }
 
 bool SkMemberInfo::writeValue(SkDisplayable* displayable, SkTDOperandArray* arrayStorage,
@@ -83,12 +83,14 @@ struct SkMemberInfo {
     }
     void setString(SkDisplayable* , SkString* ) const;
     void setValue(SkDisplayable* , const SkOperand values[], int count) const;
+    // If isConstant is given, it's set to whether the value was a script that only combined
+    // literals (see SkScriptEngine::isConstant()), and would evaluate the same way again.
     bool setValue(SkAnimateMaker& , SkTDOperandArray* storage,
         int storageOffset, int maxStorage, SkDisplayable* ,
-        SkDisplayTypes outType, const char value[], size_t len) const;
+        SkDisplayTypes outType, const char value[], size_t len, bool* isConstant = NULL) const;
     bool setValue(SkAnimateMaker& , SkTDOperandArray* storage,
         int storageOffset, int maxStorage, SkDisplayable* ,
-        SkDisplayTypes outType, SkString& str) const;
+        SkDisplayTypes outType, SkString& str, bool* isConstant = NULL) const;
 //  void setValue(SkDisplayable* , const char value[], const char name[]) const;
     bool writeValue(SkDisplayable* displayable, SkTDOperandArray* arrayStorage,
         int storageOffset, int maxStorage, void* untypedStorage, SkDisplayTypes outType,
@@ -178,7 +178,7 @@ static int token_length(const char* start) {
 }
 
 SkScriptEngine::SkScriptEngine(SkOpType returnType) :
-    fTokenLength(0), fReturnType(returnType), fError(kNoError)
+    fTokenLength(0), fReturnType(returnType), fError(kNoError), fVariable(false)
 {
     SkSuppress noInitialSuppress;
     noInitialSuppress.fOperator = kUnassigned;
@@ -941,6 +941,7 @@ bool SkScriptEngine::handleFunction(const char** scriptPtr, bool suppressed) {
         goto done;
     if (suppressed == true)
         return true;
+    fVariable = true;
     {
         for (UserCallBack* callBack = fUserCallBacks.begin(); callBack < fUserCallBacks.end(); callBack++) {
             if (callBack->fCallBackType != kFunction)
@@ -963,6 +964,7 @@ done:
 bool SkScriptEngine::handleMember(const char* field, size_t len, void* object) {
     SkScriptValue callbackResult;
     bool success = true;
+    fVariable = true;
     for (UserCallBack* callBack = fUserCallBacks.begin(); callBack < fUserCallBacks.end(); callBack++) {
         if (callBack->fCallBackType != kMember)
             continue;
@@ -983,6 +985,7 @@ done:
 bool SkScriptEngine::handleMemberFunction(const char* field, size_t len, void* object, SkTDArray<SkScriptValue>& params) {
     SkScriptValue callbackResult;
     bool success = true;
+    fVariable = true;
     for (UserCallBack* callBack = fUserCallBacks.begin(); callBack < fUserCallBacks.end(); callBack++) {
         if (callBack->fCallBackType != kMemberFunction)
             continue;
@@ -1029,6 +1032,7 @@ bool SkScriptEngine::handleProperty(bool suppressed) {
     bool success = true;
     if (suppressed)
         goto done;
+    fVariable = true;
     success = false; // note that with standard animator-script plugins, callback never returns false
     {
         for (UserCallBack* callBack = fUserCallBacks.begin(); callBack < fUserCallBacks.end(); callBack++) {
@@ -1054,6 +1058,7 @@ done:
 
 bool SkScriptEngine::handleUnbox(SkScriptValue* scriptValue) {
     bool success = true;
+    fVariable = true;
     for (UserCallBack* callBack = fUserCallBacks.begin(); callBack < fUserCallBacks.end(); callBack++) {
         if (callBack->fCallBackType != kUnbox)
             continue;
@@ -78,6 +78,9 @@ public:
     void forget(SkTypedArray* array);
     void functionCallBack(_functionCallBack func, void* userStorage);
     Error getError() const { return fError; }
+    // True if the scripts evaluated so far only combined literals, without looking up any
+    // property, member, function or unboxed value, so evaluating them again gives the same result.
+    bool isConstant() const { return !fVariable; }
 #ifdef SK_DEBUG
     bool getErrorString(SkString* err) const;
 #endif
@@ -243,6 +246,7 @@ protected:
     SkOpType fReturnType;
     Error fError;
     int fErrorPosition;
+    bool fVariable;     // set once a callback supplies a value
 private:
     friend class SkTypedArray;
 #ifdef SK_SUPPORT_UNITTEST
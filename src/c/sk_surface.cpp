@@ -122,6 +122,27 @@ static bool from_c_path_direction(sk_path_direction_t cdir, SkPath::Direction* d
     return false;
 }
 
+const struct {
+    sk_point_mode_t     fC;
+    SkCanvas::PointMode fSk;
+} gPointModeMap[] = {
+    { POINTS_SK_POINT_MODE,  SkCanvas::kPoints_PointMode },
+    { LINES_SK_POINT_MODE,   SkCanvas::kLines_PointMode },
+    { POLYGON_SK_POINT_MODE, SkCanvas::kPolygon_PointMode },
+};
+
+static bool from_c_point_mode(sk_point_mode_t cmode, SkCanvas::PointMode* mode) {
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gPointModeMap); ++i) {
+        if (gPointModeMap[i].fC == cmode) {
+            if (mode) {
+                *mode = gPointModeMap[i].fSk;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 static SkData* AsData(const sk_data_t* cdata) {
     return reinterpret_cast<SkData*>(const_cast<sk_data_t*>(cdata));
 }
@@ -142,6 +163,10 @@ static const SkRect* AsRect(const sk_rect_t* crect) {
     return reinterpret_cast<const SkRect*>(crect);
 }
 
+static const SkPoint* AsPoints(const sk_point_t* cpoints) {
+    return reinterpret_cast<const SkPoint*>(cpoints);
+}
+
 static const SkPath& AsPath(const sk_path_t& cpath) {
     return reinterpret_cast<const SkPath&>(cpath);
 }
@@ -285,6 +310,60 @@ void sk_path_add_oval(sk_path_t* cpath, const sk_rect_t* crect, sk_path_directio
     as_path(cpath)->addOval(AsRect(*crect), dir);
 }
 
+// Checks the verbs against the point and weight counts before appending anything, so that a bad
+// call leaves the path as it was.
+static bool append_c_verbs(SkPath* path, const sk_path_verb_t verbs[], int verbCount,
+                           const SkPoint pts[], int ptCount,
+                           const float weights[], int weightCount) {
+    static const int gPtsPerVerb[] = { 1, 1, 2, 2, 3, 0 };
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(gPtsPerVerb) == CLOSE_SK_PATH_VERB + 1, verb_count_mismatch);
+
+    int ptsNeeded = 0, weightsNeeded = 0;
+    for (int i = 0; i < verbCount; ++i) {
+        if ((unsigned)verbs[i] > CLOSE_SK_PATH_VERB) {
+            return false;
+        }
+        ptsNeeded += gPtsPerVerb[verbs[i]];
+        weightsNeeded += CONIC_SK_PATH_VERB == verbs[i];
+    }
+    if (ptsNeeded != ptCount || weightsNeeded != weightCount) {
+        return false;
+    }
+
+    path->incReserve(ptCount);
+    for (int i = 0; i < verbCount; ++i) {
+        switch (verbs[i]) {
+            case MOVE_SK_PATH_VERB:
+                path->moveTo(pts[0]);
+                break;
+            case LINE_SK_PATH_VERB:
+                path->lineTo(pts[0]);
+                break;
+            case QUAD_SK_PATH_VERB:
+                path->quadTo(pts[0], pts[1]);
+                break;
+            case CONIC_SK_PATH_VERB:
+                path->conicTo(pts[0], pts[1], *weights++);
+                break;
+            case CUBIC_SK_PATH_VERB:
+                path->cubicTo(pts[0], pts[1], pts[2]);
+                break;
+            case CLOSE_SK_PATH_VERB:
+                path->close();
+                break;
+        }
+        pts += gPtsPerVerb[verbs[i]];
+    }
+    return true;
+}
+
+bool sk_path_add_verbs(sk_path_t* cpath, const sk_path_verb_t verbs[], int verbCount,
+                       const sk_point_t cpoints[], int pointCount,
+                       const float conicWeights[], int conicWeightCount) {
+    return append_c_verbs(as_path(cpath), verbs, verbCount, AsPoints(cpoints), pointCount,
+                          conicWeights, conicWeightCount);
+}
+
 bool sk_path_get_bounds(const sk_path_t* cpath, sk_rect_t* crect) {
     const SkPath& path = AsPath(*cpath);
 
@@ -388,6 +467,47 @@ void sk_canvas_draw_picture(sk_canvas_t* ccanvas, const sk_picture_t* cpicture,
     AsCanvas(ccanvas)->drawPicture(AsPicture(cpicture), matrixPtr, AsPaint(cpaint));
 }
 
+void sk_canvas_draw_rects(sk_canvas_t* ccanvas, const sk_rect_t crects[], int count,
+                          const sk_paint_t* cpaint) {
+    SkCanvas* canvas = AsCanvas(ccanvas);
+    const SkPaint& paint = AsPaint(*cpaint);
+    const SkRect* rects = AsRect(crects);
+    for (int i = 0; i < count; ++i) {
+        canvas->drawRect(rects[i], paint);
+    }
+}
+
+void sk_canvas_draw_points(sk_canvas_t* ccanvas, sk_point_mode_t cmode, size_t count,
+                           const sk_point_t cpoints[], const sk_paint_t* cpaint) {
+    SkCanvas::PointMode mode;
+    if (!from_c_point_mode(cmode, &mode)) {
+        return;
+    }
+    AsCanvas(ccanvas)->drawPoints(mode, count, AsPoints(cpoints), AsPaint(*cpaint));
+}
+
+void sk_canvas_draw_path_verbs(sk_canvas_t* ccanvas, const sk_path_verb_t verbs[], int verbCount,
+                               const sk_point_t cpoints[], int pointCount,
+                               const float conicWeights[], int conicWeightCount,
+                               const sk_paint_t* cpaint) {
+    SkPath path;
+    if (!append_c_verbs(&path, verbs, verbCount, AsPoints(cpoints), pointCount,
+                        conicWeights, conicWeightCount)) {
+        return;
+    }
+    AsCanvas(ccanvas)->drawPath(path, AsPaint(*cpaint));
+}
+
+void sk_canvas_draw_glyphs(sk_canvas_t* ccanvas, const uint16_t glyphs[],
+                           const sk_point_t cpositions[], int count, const sk_paint_t* cpaint) {
+    if (count <= 0) {
+        return;
+    }
+    SkPaint paint(AsPaint(*cpaint));
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    AsCanvas(ccanvas)->drawPosText(glyphs, count * sizeof(uint16_t), AsPoints(cpositions), paint);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 sk_surface_t* sk_surface_new_raster(const sk_imageinfo_t* cinfo) {
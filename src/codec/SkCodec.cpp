@@ -10,9 +10,12 @@
 #include "SkCodec_libbmp.h"
 #include "SkCodec_libgif.h"
 #include "SkCodec_libico.h"
+#include "SkCodec_libjpeg.h"
 #include "SkCodec_libpng.h"
+#include "SkCodec_libwebp.h"
 #include "SkCodec_wbmp.h"
 #include "SkCodecPriv.h"
+#include "SkRect.h"
 #include "SkStream.h"
 
 struct DecoderProc {
@@ -22,10 +25,12 @@ struct DecoderProc {
 
 static const DecoderProc gDecoderProcs[] = {
     { SkPngCodec::IsPng, SkPngCodec::NewFromStream },
+    { SkJpegCodec::IsJpeg, SkJpegCodec::NewFromStream },
     { SkGifCodec::IsGif, SkGifCodec::NewFromStream },
     { SkIcoCodec::IsIco, SkIcoCodec::NewFromStream },
     { SkBmpCodec::IsBmp, SkBmpCodec::NewFromStream },
-    { SkWbmpCodec::IsWbmp, SkWbmpCodec::NewFromStream }
+    { SkWbmpCodec::IsWbmp, SkWbmpCodec::NewFromStream },
+    { SkWebpCodec::IsWebp, SkWebpCodec::NewFromStream }
 };
 
 SkCodec* SkCodec::NewFromStream(SkStream* stream) {
@@ -73,6 +78,7 @@ SkCodec::SkCodec(const SkImageInfo& info, SkStream* stream)
 #endif
     , fStream(stream)
     , fNeedsRewind(false)
+    , fIncrementalDecodeStarted(false)
 {}
 
 SkCodec::RewindState SkCodec::rewindIfNeeded() {
@@ -80,6 +86,8 @@ SkCodec::RewindState SkCodec::rewindIfNeeded() {
     // require a rewind.
     const bool needsRewind = fNeedsRewind;
     fNeedsRewind = true;
+    // Every decode starts here, and each one abandons an incremental decode in progress.
+    fIncrementalDecodeStarted = false;
     if (!needsRewind) {
         return kNoRewindNecessary_RewindState;
     }
@@ -91,3 +99,46 @@ SkScanlineDecoder* SkCodec::getScanlineDecoder(const SkImageInfo& dstInfo) {
     fScanlineDecoder.reset(this->onGetScanlineDecoder(dstInfo));
     return fScanlineDecoder.get();
 }
+
+SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                size_t rowBytes, const Options* options) {
+    fIncrementalDecodeStarted = false;
+    if (kUnknown_SkColorType == dstInfo.colorType() ||
+            kIndex_8_SkColorType == dstInfo.colorType()) {
+        return kInvalidConversion;
+    }
+    if (NULL == dst || rowBytes < dstInfo.minRowBytes()) {
+        return kInvalidParameters;
+    }
+
+    Options optsStorage;
+    if (NULL == options) {
+        options = &optsStorage;
+    }
+    if (options->fSubset) {
+        if (!this->onCanDecodeSubset()) {
+            return kUnimplemented;
+        }
+        const SkIRect& subset = *options->fSubset;
+        if (!SkIRect::MakeSize(this->getInfo().dimensions()).contains(subset) ||
+                subset.size() != dstInfo.dimensions()) {
+            return kInvalidParameters;
+        }
+    }
+
+    const Result result = this->onStartIncrementalDecode(dstInfo, dst, rowBytes, *options);
+    fIncrementalDecodeStarted = kSuccess == result;
+    return result;
+}
+
+SkCodec::Result SkCodec::incrementalDecode(int* rowsDecoded) {
+    int rowsStorage;
+    if (NULL == rowsDecoded) {
+        rowsDecoded = &rowsStorage;
+    }
+    *rowsDecoded = 0;
+    if (!fIncrementalDecodeStarted) {
+        return kInvalidParameters;
+    }
+    return this->onIncrementalDecode(rowsDecoded);
+}
@@ -0,0 +1,548 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodec_libjpeg.h"
+#include "SkCodecPriv.h"
+#include "SkColorPriv.h"
+#include "SkMath.h"
+#include "SkRect.h"
+#include "SkScanlineDecoder.h"
+#include "SkStream.h"
+#include "SkSwizzler.h"
+
+#include <setjmp.h>
+#include <stdio.h>
+
+extern "C" {
+    #include "jpeglib.h"
+    #include "jerror.h"
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Callback functions
+///////////////////////////////////////////////////////////////////////////////
+
+struct JpegErrorMgr : jpeg_error_mgr {
+    jmp_buf fJmpBuf;
+};
+
+static void sk_error_exit(j_common_ptr cinfo) {
+    JpegErrorMgr* error = static_cast<JpegErrorMgr*>(cinfo->err);
+    (*error->output_message)(cinfo);
+    longjmp(error->fJmpBuf, 1);
+}
+
+static void sk_output_message(j_common_ptr cinfo) {
+    char buffer[JMSG_LENGTH_MAX];
+    (*cinfo->err->format_message)(cinfo, buffer);
+    SkCodecPrintf("------ jpeg error %s\n", buffer);
+}
+
+// Reads the stream from wherever it is. The codec rewinds it before reading the header again.
+struct JpegSourceMgr : jpeg_source_mgr {
+    enum {
+        kBufferSize = 4096
+    };
+
+    SkStream*   fStream;        // Unowned.
+    bool        fTruncated;     // Set once we've made up an end of image for a short stream.
+    JOCTET      fBuffer[kBufferSize];
+};
+
+static void sk_init_source(j_decompress_ptr dinfo) {
+    JpegSourceMgr* src = static_cast<JpegSourceMgr*>(dinfo->src);
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = 0;
+}
+
+static boolean sk_fill_input_buffer(j_decompress_ptr dinfo) {
+    JpegSourceMgr* src = static_cast<JpegSourceMgr*>(dinfo->src);
+    // If the stream's next bytes are in memory, hand them to libjpeg as they are.
+    size_t bytes = 0;
+    const void* memory = src->fStream->peekMemory(&bytes);
+    if (memory && bytes > 0) {
+        src->fStream->skip(bytes);
+        src->next_input_byte = static_cast<const JOCTET*>(memory);
+        src->bytes_in_buffer = bytes;
+        return TRUE;
+    }
+    bytes = src->fStream->read(src->fBuffer, JpegSourceMgr::kBufferSize);
+    if (0 == bytes) {
+        // Like libjpeg's own sources, finish a truncated stream with an end of image marker, so
+        // the rows it never got to come out gray rather than failing the whole decode.
+        WARNMS(dinfo, JWRN_JPEG_EOF);
+        src->fBuffer[0] = (JOCTET) 0xFF;
+        src->fBuffer[1] = (JOCTET) JPEG_EOI;
+        src->fTruncated = true;
+        bytes = 2;
+    }
+    src->next_input_byte = src->fBuffer;
+    src->bytes_in_buffer = bytes;
+    return TRUE;
+}
+
+static void sk_skip_input_data(j_decompress_ptr dinfo, long numBytes) {
+    JpegSourceMgr* src = static_cast<JpegSourceMgr*>(dinfo->src);
+    if (numBytes <= 0) {
+        return;
+    }
+    size_t bytes = (size_t) numBytes;
+    if (bytes > src->bytes_in_buffer) {
+        const size_t bytesToSkip = bytes - src->bytes_in_buffer;
+        if (src->fStream->skip(bytesToSkip) != bytesToSkip) {
+            SkCodecPrintf("Failure to skip.\n");
+            dinfo->err->error_exit((j_common_ptr) dinfo);
+            return;
+        }
+        src->next_input_byte = src->fBuffer;
+        src->bytes_in_buffer = 0;
+    } else {
+        src->next_input_byte += bytes;
+        src->bytes_in_buffer -= bytes;
+    }
+}
+
+static void sk_term_source(j_decompress_ptr) {}
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+
+// Everything libjpeg needs to decode from one pass over the stream.
+struct JpegDecoderMgr : SkNoncopyable {
+    JpegDecoderMgr(SkStream* stream) : fCreated(false) {
+        fDInfo.err = jpeg_std_error(&fErrorMgr);
+        fErrorMgr.error_exit = sk_error_exit;
+        fErrorMgr.output_message = sk_output_message;
+
+        fSrcMgr.init_source = sk_init_source;
+        fSrcMgr.fill_input_buffer = sk_fill_input_buffer;
+        fSrcMgr.skip_input_data = sk_skip_input_data;
+        fSrcMgr.resync_to_restart = jpeg_resync_to_restart;
+        fSrcMgr.term_source = sk_term_source;
+        fSrcMgr.next_input_byte = NULL;
+        fSrcMgr.bytes_in_buffer = 0;
+        fSrcMgr.fStream = stream;
+        fSrcMgr.fTruncated = false;
+    }
+
+    ~JpegDecoderMgr() {
+        if (fCreated) {
+            jpeg_destroy_decompress(&fDInfo);
+        }
+    }
+
+    jpeg_decompress_struct  fDInfo;
+    JpegErrorMgr            fErrorMgr;
+    JpegSourceMgr           fSrcMgr;
+    bool                    fCreated;
+};
+
+// Reads the header. Returns the decoder, ready to start decompressing, or NULL on failure.
+static JpegDecoderMgr* read_header(SkStream* stream, SkImageInfo* imageInfo) {
+    SkAutoTDelete<JpegDecoderMgr> mgr(SkNEW_ARGS(JpegDecoderMgr, (stream)));
+    if (setjmp(mgr->fErrorMgr.fJmpBuf)) {
+        return NULL;
+    }
+
+    jpeg_create_decompress(&mgr->fDInfo);
+    mgr->fCreated = true;
+    mgr->fDInfo.src = &mgr->fSrcMgr;
+    if (JPEG_HEADER_OK != jpeg_read_header(&mgr->fDInfo, TRUE)) {
+        return NULL;
+    }
+
+    if (imageInfo) {
+        // Every JPEG is opaque. Grayscale and CMYK images are expanded to kN32 as well.
+        *imageInfo = SkImageInfo::Make(mgr->fDInfo.image_width, mgr->fDInfo.image_height,
+                                       kN32_SkColorType, kOpaque_SkAlphaType);
+    }
+    return mgr.detach();
+}
+
+// libjpeg's own rounding for an output dimension scaled by 1/denom.
+static int scaled_dimension(int dimension, int denom) {
+    return (dimension + denom - 1) / denom;
+}
+
+static SkISize scaled_dimensions(const SkISize& size, int denom) {
+    return SkISize::Make(scaled_dimension(size.width(), denom),
+                         scaled_dimension(size.height(), denom));
+}
+
+// The scales the IDCT can decode at directly are 1/kScaleDenoms[i].
+static const int kScaleDenoms[] = { 1, 2, 4, 8 };
+
+// At the moment we only convert to opaque kN32, which any alpha type can describe.
+static bool conversion_possible(const SkImageInfo& dst, const SkImageInfo& src) {
+    if (kN32_SkColorType != dst.colorType()) {
+        return false;
+    }
+    if (dst.profileType() != src.profileType()) {
+        return false;
+    }
+    return kUnknown_SkAlphaType != dst.alphaType();
+}
+
+// We ask libjpeg for CMYK as it is, which in the JPEGs we see is inverted (as Adobe writes
+// them), and convert to RGBX in place: with C, M, Y and K all stored as 1 - x, each of
+// R, G and B is just the product of its inverted ink and the inverted black.
+static void convert_CMYK_to_RGBX(uint8_t* row, int width) {
+    for (int x = 0; x < width; ++x, row += 4) {
+        row[0] = SkMulDiv255Round(row[0], row[3]);
+        row[1] = SkMulDiv255Round(row[1], row[3]);
+        row[2] = SkMulDiv255Round(row[2], row[3]);
+        row[3] = 0xFF;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Creation
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkJpegCodec::IsJpeg(SkStream* stream) {
+    static const uint8_t kJpegSig[] = { 0xFF, 0xD8, 0xFF };
+    uint8_t buf[sizeof(kJpegSig)];
+    if (stream->read(buf, sizeof(kJpegSig)) != sizeof(kJpegSig)) {
+        return false;
+    }
+    return 0 == memcmp(buf, kJpegSig, sizeof(kJpegSig));
+}
+
+SkCodec* SkJpegCodec::NewFromStream(SkStream* stream) {
+    SkImageInfo imageInfo;
+    JpegDecoderMgr* decoderMgr = read_header(stream, &imageInfo);
+    if (NULL == decoderMgr) {
+        return NULL;
+    }
+    return SkNEW_ARGS(SkJpegCodec, (imageInfo, stream, decoderMgr));
+}
+
+SkJpegCodec::SkJpegCodec(const SkImageInfo& info, SkStream* stream, JpegDecoderMgr* decoderMgr)
+    : INHERITED(info, stream)
+    , fDecoderMgr(decoderMgr)
+    , fSrcConfig(SkSwizzler::kUnknown)
+{}
+
+SkJpegCodec::~SkJpegCodec() {}
+
+SkISize SkJpegCodec::onGetScaledDimensions(float desiredScale) const {
+    // Use the smallest scale that is still at least as large as the one asked for, so callers
+    // can downscale the rest of the way without losing detail.
+    int denom = 1;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kScaleDenoms); ++i) {
+        if (desiredScale * kScaleDenoms[i] <= 1) {
+            denom = kScaleDenoms[i];
+        }
+    }
+    return scaled_dimensions(this->getInfo().dimensions(), denom);
+}
+
+bool SkJpegCodec::handleRewind() {
+    switch (this->rewindIfNeeded()) {
+        case kNoRewindNecessary_RewindState:
+            return NULL != fDecoderMgr.get();
+        case kCouldNotRewind_RewindState:
+            return false;
+        case kRewound_RewindState:
+            // If this fails, fDecoderMgr stays NULL, and the next call rewinds and tries again.
+            fDecoderMgr.reset(read_header(this->stream(), NULL));
+            return NULL != fDecoderMgr.get();
+        default:
+            SkASSERT(false);
+            return false;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Getting the pixels
+///////////////////////////////////////////////////////////////////////////////
+
+SkCodec::Result SkJpegCodec::startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options) {
+    // A subset is in the coordinates of the full size image, so it can't be scaled as well.
+    const SkIRect* subset = options.fSubset;
+    int denom = 0;
+    if (subset) {
+        if (subset->size() == dstInfo.dimensions()) {
+            denom = 1;
+        }
+    } else {
+        for (size_t i = 0; i < SK_ARRAY_COUNT(kScaleDenoms); ++i) {
+            if (scaled_dimensions(this->getInfo().dimensions(), kScaleDenoms[i]) ==
+                    dstInfo.dimensions()) {
+                denom = kScaleDenoms[i];
+                break;
+            }
+        }
+    }
+    if (0 == denom) {
+        return kInvalidScale;
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+
+    jpeg_decompress_struct* dinfo = &fDecoderMgr->fDInfo;
+    switch (dinfo->jpeg_color_space) {
+        case JCS_GRAYSCALE:
+            dinfo->out_color_space = JCS_GRAYSCALE;
+            fSrcConfig = SkSwizzler::kGray;
+            break;
+        case JCS_CMYK:
+        case JCS_YCCK:
+            dinfo->out_color_space = JCS_CMYK;
+            fSrcConfig = SkSwizzler::kRGBX;
+            break;
+        default:
+            dinfo->out_color_space = JCS_RGB;
+            fSrcConfig = SkSwizzler::kRGB;
+            break;
+    }
+    dinfo->scale_num = 1;
+    dinfo->scale_denom = denom;
+
+    // libjpeg always decodes whole rows. The swizzler crops them to the subset's columns.
+    const SkISize outputSize = scaled_dimensions(this->getInfo().dimensions(), denom);
+    fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, NULL, dstInfo, dst, rowBytes,
+                                               options.fZeroInitialized,
+                                               subset ? subset->fLeft : 0));
+    if (!fSwizzler) {
+        return kUnimplemented;
+    }
+    fSrcRow.reset(outputSize.width() * SkSwizzler::BytesPerPixel(fSrcConfig));
+
+    if (setjmp(fDecoderMgr->fErrorMgr.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return kInvalidInput;
+    }
+    if (!jpeg_start_decompress(dinfo)) {
+        return kInvalidInput;
+    }
+    if (SkToInt(dinfo->output_width) != outputSize.width() ||
+            SkToInt(dinfo->output_height) != outputSize.height()) {
+        SkCodecPrintf("libjpeg scaled to %dx%d, not %dx%d.\n", dinfo->output_width,
+                      dinfo->output_height, outputSize.width(), outputSize.height());
+        return kInvalidScale;
+    }
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::decodeRows(void* dst, int count, size_t rowBytes) {
+    jpeg_decompress_struct* dinfo = &fDecoderMgr->fDInfo;
+    JSAMPLE* srcRow = static_cast<JSAMPLE*>(fSrcRow.get());
+    if (setjmp(fDecoderMgr->fErrorMgr.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return kInvalidInput;
+    }
+
+    for (int y = 0; y < count; ++y) {
+        if (1 != jpeg_read_scanlines(dinfo, &srcRow, 1)) {
+            return kIncompleteInput;
+        }
+        if (JCS_CMYK == dinfo->out_color_space) {
+            convert_CMYK_to_RGBX(srcRow, dinfo->output_width);
+        }
+        fSwizzler->setDstRow(dst);
+        fSwizzler->next(srcRow);
+        dst = SkTAddOffset<void>(dst, rowBytes);
+    }
+    return fDecoderMgr->fSrcMgr.fTruncated ? kIncompleteInput : kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::skipRows(int count) {
+    jpeg_decompress_struct* dinfo = &fDecoderMgr->fDInfo;
+    JSAMPLE* srcRow = static_cast<JSAMPLE*>(fSrcRow.get());
+    if (setjmp(fDecoderMgr->fErrorMgr.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return kInvalidInput;
+    }
+
+    for (int y = 0; y < count; ++y) {
+        if (1 != jpeg_read_scanlines(dinfo, &srcRow, 1)) {
+            return kIncompleteInput;
+        }
+    }
+    return kSuccess;
+}
+
+void SkJpegCodec::finish() {
+    if (setjmp(fDecoderMgr->fErrorMgr.fJmpBuf)) {
+        // We've already read all the scanlines. This is a success.
+        return;
+    }
+    jpeg_finish_decompress(&fDecoderMgr->fDInfo);
+}
+
+SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& requestedInfo, void* dst,
+                                         size_t rowBytes, const Options& options,
+                                         SkPMColor ctable[], int* ctableCount) {
+    if (!this->handleRewind()) {
+        return kCouldNotRewind;
+    }
+
+    Result result = this->startDecode(requestedInfo, dst, rowBytes, options);
+    if (kSuccess != result) {
+        return result;
+    }
+    const SkIRect* subset = options.fSubset;
+    if (subset && subset->fTop > 0) {
+        result = this->skipRows(subset->fTop);
+        if (kSuccess != result) {
+            return result;
+        }
+    }
+    result = this->decodeRows(dst, requestedInfo.height(), rowBytes);
+    if (kSuccess == result) {
+        if (subset && subset->fBottom < this->getInfo().height()) {
+            // Stop without decoding the rows below the subset. The next decode rewinds.
+            jpeg_abort_decompress(&fDecoderMgr->fDInfo);
+        } else {
+            this->finish();
+        }
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Getting the YUV planes
+///////////////////////////////////////////////////////////////////////////////
+
+// libjpeg's raw output is the planes as they are coded. In the supported layouts (4:4:4, 4:2:2,
+// 4:2:0 and 4:4:0) the chroma planes are at most half the size of the luma plane, and one call to
+// jpeg_read_raw_data() returns at most 2 * DCTSIZE rows of each plane.
+static bool has_yuv_planes(const jpeg_decompress_struct& dinfo) {
+    if (JCS_YCbCr != dinfo.jpeg_color_space || 3 != dinfo.num_components) {
+        return false;
+    }
+    const jpeg_component_info* comps = dinfo.comp_info;
+    return comps[0].h_samp_factor <= 2 && comps[0].v_samp_factor <= 2 &&
+           1 == comps[1].h_samp_factor && 1 == comps[1].v_samp_factor &&
+           1 == comps[2].h_samp_factor && 1 == comps[2].v_samp_factor;
+}
+
+// libjpeg writes every row and column of every block, so each plane needs this much room.
+static SkISize padded_plane_size(const jpeg_component_info& comp) {
+    return SkISize::Make(comp.width_in_blocks * DCTSIZE, comp.height_in_blocks * DCTSIZE);
+}
+
+bool SkJpegCodec::onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                                  SkYUVColorSpace* colorSpace) {
+    if (!this->handleRewind()) {
+        return false;
+    }
+    jpeg_decompress_struct* dinfo = &fDecoderMgr->fDInfo;
+    if (!has_yuv_planes(*dinfo)) {
+        return false;
+    }
+
+    const jpeg_component_info* comps = dinfo->comp_info;
+    if (NULL == planes || NULL == planes[0] || NULL == rowBytes || 0 == rowBytes[0]) {
+        // Only the sizes to allocate were asked for. The header is all that has been read.
+        for (int i = 0; i < 3; ++i) {
+            sizes[i] = padded_plane_size(comps[i]);
+        }
+        return true;
+    }
+    for (int i = 0; i < 3; ++i) {
+        const SkISize padded = padded_plane_size(comps[i]);
+        if (NULL == planes[i] || sizes[i] != padded ||
+                rowBytes[i] < SkToSizeT(padded.width())) {
+            return false;
+        }
+    }
+
+    dinfo->out_color_space = JCS_YCbCr;
+    dinfo->raw_data_out = TRUE;
+    dinfo->scale_num = 1;
+    dinfo->scale_denom = 1;
+    if (setjmp(fDecoderMgr->fErrorMgr.fJmpBuf)) {
+        SkCodecPrintf("setjmp long jump!\n");
+        return false;
+    }
+    if (!jpeg_start_decompress(dinfo)) {
+        return false;
+    }
+
+    // Each call decodes one row of MCUs: v_samp_factor rows of blocks of each plane. The last one
+    // only writes the rows of blocks that are left, but every row still needs a pointer.
+    JSAMPROW rows[3][2 * DCTSIZE];
+    JSAMPARRAY data[3] = { rows[0], rows[1], rows[2] };
+    const int mcuRows = dinfo->max_v_samp_factor * DCTSIZE;
+    for (int mcuY = 0; dinfo->output_scanline < dinfo->output_height; ++mcuY) {
+        for (int i = 0; i < 3; ++i) {
+            const int planeRows = comps[i].v_samp_factor * DCTSIZE;
+            const int lastRow = sizes[i].height() - 1;
+            for (int y = 0; y < planeRows; ++y) {
+                const int planeY = SkTMin(mcuY * planeRows + y, lastRow);
+                rows[i][y] = static_cast<JSAMPLE*>(planes[i]) + planeY * rowBytes[i];
+            }
+        }
+        if (0 == jpeg_read_raw_data(dinfo, data, mcuRows)) {
+            return false;
+        }
+    }
+    if (fDecoderMgr->fSrcMgr.fTruncated) {
+        // Leave partial images to getPixels(), which can report them as incomplete.
+        return false;
+    }
+    this->finish();
+
+    // The planes hold whole blocks, but only the pixels within the image are meaningful.
+    for (int i = 0; i < 3; ++i) {
+        sizes[i].set(comps[i].downsampled_width, comps[i].downsampled_height);
+    }
+    if (colorSpace) {
+        *colorSpace = kJPEG_SkYUVColorSpace;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scanline decoding
+///////////////////////////////////////////////////////////////////////////////
+
+class SkJpegScanlineDecoder : public SkScanlineDecoder {
+public:
+    SkJpegScanlineDecoder(const SkImageInfo& dstInfo, SkJpegCodec* codec)
+        : INHERITED(dstInfo)
+        , fCodec(codec)
+    {}
+
+    SkImageGenerator::Result onGetScanlines(void* dst, int count, size_t rowBytes) override {
+        return fCodec->decodeRows(dst, count, rowBytes);
+    }
+
+    SkImageGenerator::Result onSkipScanlines(int count) override {
+        return fCodec->skipRows(count);
+    }
+
+    void onFinish() override {
+        fCodec->finish();
+    }
+
+private:
+    SkJpegCodec*    fCodec;     // Unowned.
+
+    typedef SkScanlineDecoder INHERITED;
+};
+
+SkScanlineDecoder* SkJpegCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo) {
+    if (!this->handleRewind()) {
+        return NULL;
+    }
+
+    // Note: We set dst to NULL since we do not know it yet. Each row sets its own destination.
+    Options opts;
+    // FIXME: Pass this in to getScanlineDecoder?
+    opts.fZeroInitialized = kNo_ZeroInitialized;
+    if (this->startDecode(dstInfo, NULL, dstInfo.minRowBytes(), opts) != kSuccess) {
+        SkCodecPrintf("failed to start decoding.\n");
+        return NULL;
+    }
+    return SkNEW_ARGS(SkJpegScanlineDecoder, (dstInfo, this));
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodec_libjpeg_DEFINED
+#define SkCodec_libjpeg_DEFINED
+
+#include "SkCodec.h"
+#include "SkEncodedFormat.h"
+#include "SkImageInfo.h"
+#include "SkSwizzler.h"
+
+class SkScanlineDecoder;
+class SkStream;
+struct JpegDecoderMgr;
+
+/**
+ *  Decodes baseline and progressive JPEGs through libjpeg, to opaque kN32 pixels. Decoding can
+ *  be scaled by 1/2, 1/4 or 1/8 in the IDCT, which is much cheaper than a full decode followed
+ *  by a downscale: request one of the sizes getScaledDimensions() returns.
+ *
+ *  Subsets (see SkImageGenerator::Options::fSubset) decode at full size. The rows above the
+ *  subset are decoded and dropped, the ones below it aren't decoded at all.
+ *
+ *  Most JPEGs can also be decoded to their Y, U and V planes (see getYUV8Planes()), for the GPU
+ *  to convert to RGB as it draws them.
+ */
+class SkJpegCodec : public SkCodec {
+public:
+    // Assumes IsJpeg was called and returned true.
+    static SkCodec* NewFromStream(SkStream*);
+    static bool IsJpeg(SkStream*);
+protected:
+    Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*)
+            override;
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+    SkEncodedFormat onGetEncodedFormat() const override { return kJPEG_SkEncodedFormat; }
+    SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
+    bool onCanDecodeSubset() const override { return true; }
+    // YCbCr JPEGs whose chroma is subsampled by at most 2 in each direction hand out their
+    // planes straight from the IDCT, without upsampling or color conversion.
+    bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                         SkYUVColorSpace*) override;
+private:
+    // Takes ownership of decoderMgr, which has read the header.
+    SkJpegCodec(const SkImageInfo&, SkStream*, JpegDecoderMgr* decoderMgr);
+    ~SkJpegCodec();
+
+    // Calls rewindIfNeeded, and returns true if the decoder can continue.
+    bool handleRewind();
+    // Sets up libjpeg and the swizzler to decode to dstInfo, and starts decompressing. Returns
+    // kInvalidScale unless dstInfo's dimensions are one of the scaled dimensions, or those of
+    // the options' subset.
+    Result startDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&);
+    // Decodes the next count rows into dst, rowBytes apart.
+    Result decodeRows(void* dst, int count, size_t rowBytes);
+    Result skipRows(int count);
+    void finish();
+
+    SkAutoTDelete<JpegDecoderMgr>   fDecoderMgr;
+    SkAutoTDelete<SkSwizzler>       fSwizzler;
+    SkSwizzler::SrcConfig           fSrcConfig;
+    SkAutoMalloc                    fSrcRow;
+
+    friend class SkJpegScanlineDecoder;
+
+    typedef SkCodec INHERITED;
+};
+
+#endif  // SkCodec_libjpeg_DEFINED
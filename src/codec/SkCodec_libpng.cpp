@@ -11,6 +11,7 @@
 #include "SkColorTable.h"
 #include "SkBitmap.h"
 #include "SkMath.h"
+#include "SkRect.h"
 #include "SkScanlineDecoder.h"
 #include "SkSize.h"
 #include "SkStream.h"
@@ -201,6 +202,42 @@ bool SkPngCodec::IsPng(SkStream* stream) {
     return true;
 }
 
+// Tells libpng how to expand the rows of an image with this bit depth and png color type, for
+// decoding to skColorType.
+static void set_transforms(png_structp png_ptr, int bitDepth, int colorType,
+                           SkColorType skColorType) {
+    // Tell libpng to strip 16 bit/color files down to 8 bits/color
+    if (bitDepth == 16) {
+        png_set_strip_16(png_ptr);
+    }
+#ifdef PNG_READ_PACK_SUPPORTED
+    // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
+    // byte into separate bytes (useful for paletted and grayscale images).
+    if (bitDepth < 8) {
+        png_set_packing(png_ptr);
+    }
+#endif
+    // Expand grayscale images to the full 8 bits from 1, 2, or 4 bits/pixel.
+    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    }
+
+    // FIXME: Again, this block needs to go into onGetPixels.
+    bool convertGrayToRGB = PNG_COLOR_TYPE_GRAY == colorType && skColorType != kAlpha_8_SkColorType;
+
+    // Unless the user is requesting A8, convert a grayscale image into RGB.
+    // GRAY_ALPHA will always be converted to RGB
+    if (convertGrayToRGB || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_gray_to_rgb(png_ptr);
+    }
+
+    // Add filler (or alpha) byte (after each RGB triplet) if necessary.
+    // FIXME: It seems like we could just use RGB as the SrcConfig here.
+    if (colorType == PNG_COLOR_TYPE_RGB || convertGrayToRGB) {
+        png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+    }
+}
+
 // Reads the header, and initializes the passed in fields, if not NULL (except
 // stream, which is passed to the read function).
 // Returns true on success, in which case the caller is responsible for calling
@@ -254,23 +291,6 @@ static bool read_header(SkStream* stream, png_structp* png_ptrp,
         }
     }
 
-    // Tell libpng to strip 16 bit/color files down to 8 bits/color
-    if (bitDepth == 16) {
-        png_set_strip_16(png_ptr);
-    }
-#ifdef PNG_READ_PACK_SUPPORTED
-    // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
-    // byte into separate bytes (useful for paletted and grayscale images).
-    if (bitDepth < 8) {
-        png_set_packing(png_ptr);
-    }
-#endif
-    // Expand grayscale images to the full 8 bits from 1, 2, or 4 bits/pixel.
-    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
-        png_set_expand_gray_1_2_4_to_8(png_ptr);
-    }
-
-
     // Now determine the default SkColorType and SkAlphaType.
     SkColorType skColorType;
     SkAlphaType skAlphaType;
@@ -312,22 +332,7 @@ static bool read_header(SkStream* stream, png_structp* png_ptrp,
             break;
     }
 
-    {
-        // FIXME: Again, this block needs to go into onGetPixels.
-        bool convertGrayToRGB = PNG_COLOR_TYPE_GRAY == colorType && skColorType != kAlpha_8_SkColorType;
-
-        // Unless the user is requesting A8, convert a grayscale image into RGB.
-        // GRAY_ALPHA will always be converted to RGB
-        if (convertGrayToRGB || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
-            png_set_gray_to_rgb(png_ptr);
-        }
-
-        // Add filler (or alpha) byte (after each RGB triplet) if necessary.
-        // FIXME: It seems like we could just use RGB as the SrcConfig here.
-        if (colorType == PNG_COLOR_TYPE_RGB || convertGrayToRGB) {
-            png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
-        }
-    }
+    set_transforms(png_ptr, bitDepth, colorType, skColorType);
 
     // FIXME: Also need to check for sRGB (skbug.com/3471).
 
@@ -436,8 +441,9 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
         fSrcConfig = SkSwizzler::kRGBA;
     }
     const SkPMColor* colors = fColorTable ? fColorTable->readColors() : NULL;
+    const int srcX = options.fSubset ? options.fSubset->fLeft : 0;
     fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, colors, requestedInfo,
-            dst, rowBytes, options.fZeroInitialized));
+            dst, rowBytes, options.fZeroInitialized, srcX));
     if (!fSwizzler) {
         // FIXME: CreateSwizzler could fail for another reason.
         return kUnimplemented;
@@ -451,6 +457,8 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
 }
 
 bool SkPngCodec::handleRewind() {
+    // Whatever decode is starting, the incremental one (if any) is over.
+    fIncrementalDecoder.reset(NULL);
     switch (this->rewindIfNeeded()) {
         case kNoRewindNecessary_RewindState:
             return true;
@@ -484,7 +492,10 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
     if (!this->handleRewind()) {
         return kCouldNotRewind;
     }
-    if (requestedInfo.dimensions() != this->getInfo().dimensions()) {
+    // Rows outside the subset are read and dropped, and columns outside it are never swizzled.
+    const SkIRect subset = options.fSubset ? *options.fSubset
+                                           : SkIRect::MakeSize(this->getInfo().dimensions());
+    if (requestedInfo.dimensions() != subset.size()) {
         return kInvalidScale;
     }
     if (!conversion_possible(requestedInfo, this->getInfo())) {
@@ -505,38 +516,44 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
     }
 
     SkASSERT(fNumberPasses != INVALID_NUMBER_PASSES);
+    const int height = this->getInfo().height();
+    const size_t srcRowBytes = this->getInfo().width() * SkSwizzler::BytesPerPixel(fSrcConfig);
     SkAutoMalloc storage;
     if (fNumberPasses > 1) {
-        const int width = requestedInfo.width();
-        const int height = requestedInfo.height();
-        const int bpp = SkSwizzler::BytesPerPixel(fSrcConfig);
-        const size_t rowBytes = width * bpp;
-
-        storage.reset(width * height * bpp);
+        // Every pass fills in more of each row, so keep the subset's rows until the last one.
+        // The others only need somewhere to go: a single row they all share.
+        storage.reset((subset.height() + 1) * srcRowBytes);
         uint8_t* const base = static_cast<uint8_t*>(storage.get());
+        uint8_t* const discardRow = base + subset.height() * srcRowBytes;
 
         for (int i = 0; i < fNumberPasses; i++) {
-            uint8_t* row = base;
             for (int y = 0; y < height; y++) {
-                uint8_t* bmRow = row;
+                uint8_t* bmRow = (y >= subset.fTop && y < subset.fBottom)
+                        ? base + (y - subset.fTop) * srcRowBytes : discardRow;
                 png_read_rows(fPng_ptr, &bmRow, png_bytepp_NULL, 1);
-                row += rowBytes;
             }
         }
 
         // Now swizzle it.
         uint8_t* row = base;
-        for (int y = 0; y < height; y++) {
+        for (int y = 0; y < subset.height(); y++) {
             fReallyHasAlpha |= !SkSwizzler::IsOpaque(fSwizzler->next(row));
-            row += rowBytes;
+            row += srcRowBytes;
         }
     } else {
-        storage.reset(requestedInfo.width() * SkSwizzler::BytesPerPixel(fSrcConfig));
+        storage.reset(srcRowBytes);
         uint8_t* srcRow = static_cast<uint8_t*>(storage.get());
-        for (int y = 0; y < requestedInfo.height(); y++) {
+        for (int y = 0; y < subset.fTop; y++) {
+            png_read_rows(fPng_ptr, &srcRow, png_bytepp_NULL, 1);
+        }
+        for (int y = 0; y < subset.height(); y++) {
             png_read_rows(fPng_ptr, &srcRow, png_bytepp_NULL, 1);
             fReallyHasAlpha |= !SkSwizzler::IsOpaque(fSwizzler->next(srcRow));
         }
+        if (subset.fBottom < height) {
+            // Leave the rows below the subset unread. The next decode rewinds.
+            return kSuccess;
+        }
     }
 
     // FIXME: do we need substituteTranspColor? Note that we cannot do it for
@@ -590,7 +607,11 @@ public:
             return SkImageGenerator::kInvalidInput;
         }
 
-        png_read_rows(fCodec->fPng_ptr, png_bytepp_NULL, png_bytepp_NULL, count);
+        // png_read_rows() reads nothing when given no rows at all, so read into the row
+        // buffer without swizzling it.
+        for (int i = 0; i < count; i++) {
+            png_read_rows(fCodec->fPng_ptr, &fSrcRow, png_bytepp_NULL, 1);
+        }
         return SkImageGenerator::kSuccess;
     }
 
@@ -644,3 +665,195 @@ SkScanlineDecoder* SkPngCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo)
     return SkNEW_ARGS(SkPngScanlineDecoder, (dstInfo, this));
 }
 
+
+///////////////////////////////////////////////////////////////////////////////
+// Incremental decoding
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ *  Decodes with libpng's progressive reader, which is handed whatever the stream holds, keeps
+ *  its own place in the data, and calls back with each row as it finishes it.
+ */
+class SkPngIncrementalDecoder : SkNoncopyable {
+public:
+    // Takes ownership of png_ptr and info_ptr, which have not read anything yet.
+    SkPngIncrementalDecoder(SkPngCodec* codec, png_structp png_ptr, png_infop info_ptr,
+                            const SkIRect& subset, bool interlaced)
+        : fCodec(codec)
+        , fPng_ptr(png_ptr)
+        , fInfo_ptr(info_ptr)
+        , fSubset(subset)
+        , fInterlaced(interlaced)
+        , fRowWritten(subset.height())
+        , fRowsDecoded(0)
+        , fDone(false)
+        , fFailed(false)
+    {
+        if (fInterlaced) {
+            // Each pass adds to the rows, so keep the subset's to combine the next pass with.
+            fSrcRowBytes = codec->getInfo().width() * SkSwizzler::BytesPerPixel(codec->fSrcConfig);
+            fStorage.reset(subset.height() * fSrcRowBytes);
+            sk_bzero(fStorage.get(), subset.height() * fSrcRowBytes);
+        } else {
+            fSrcRowBytes = 0;
+        }
+        sk_bzero(fRowWritten.get(), subset.height() * sizeof(bool));
+        png_set_progressive_read_fn(fPng_ptr, this, InfoCallback, RowCallback, EndCallback);
+    }
+
+    ~SkPngIncrementalDecoder() {
+        png_destroy_read_struct(&fPng_ptr, &fInfo_ptr, png_infopp_NULL);
+    }
+
+    SkCodec::Result decode(SkStream* stream, int* rowsDecoded) {
+        if (!fFailed) {
+            // FIXME: Could we use the return value of setjmp to specify the type of
+            // error?
+            if (setjmp(png_jmpbuf(fPng_ptr))) {
+                SkCodecPrintf("setjmp long jump!\n");
+                fFailed = true;
+            } else {
+                // Once the stream runs dry, libpng holds on to any partial chunk or row, and
+                // the next call picks up right after the bytes handed over here.
+                while (!fDone) {
+                    const size_t bytes = stream->read(fBuffer, sizeof(fBuffer));
+                    if (0 == bytes) {
+                        break;
+                    }
+                    png_process_data(fPng_ptr, fInfo_ptr, fBuffer, bytes);
+                }
+            }
+        }
+        *rowsDecoded = fRowsDecoded;
+        if (fFailed) {
+            return SkCodec::kInvalidInput;
+        }
+        return fDone ? SkCodec::kSuccess : SkCodec::kIncompleteInput;
+    }
+
+private:
+    static SkPngIncrementalDecoder* Get(png_structp png_ptr) {
+        return static_cast<SkPngIncrementalDecoder*>(png_get_progressive_ptr(png_ptr));
+    }
+
+    // Called once the header is read, to set up the same transforms as read_header().
+    static void InfoCallback(png_structp png_ptr, png_infop info_ptr) {
+        png_uint_32 origWidth, origHeight;
+        int bitDepth, colorType, interlaceType;
+        png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bitDepth,
+                     &colorType, &interlaceType, int_p_NULL, int_p_NULL);
+        set_transforms(png_ptr, bitDepth, colorType, Get(png_ptr)->fCodec->getInfo().colorType());
+        if (interlaceType != PNG_INTERLACE_NONE) {
+            png_set_interlace_handling(png_ptr);
+        }
+        png_read_update_info(png_ptr, info_ptr);
+    }
+
+    // row is NULL for the rows an interlaced pass doesn't touch.
+    static void RowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int) {
+        if (row) {
+            Get(png_ptr)->onRow(row, rowNum);
+        }
+    }
+
+    static void EndCallback(png_structp png_ptr, png_infop) {
+        Get(png_ptr)->onEnd();
+    }
+
+    void onRow(png_bytep row, int y) {
+        if (y < fSubset.fTop || y >= fSubset.fBottom) {
+            return;
+        }
+        const int dstY = y - fSubset.fTop;
+        if (fInterlaced) {
+            uint8_t* combined = static_cast<uint8_t*>(fStorage.get()) + dstY * fSrcRowBytes;
+            png_progressive_combine_row(fPng_ptr, combined, row);
+            fCodec->fSwizzler->next(combined, dstY);
+        } else {
+            fCodec->fReallyHasAlpha |= !SkSwizzler::IsOpaque(fCodec->fSwizzler->next(row, dstY));
+            // The rows below the subset aren't needed.
+            fDone = dstY == fSubset.height() - 1;
+        }
+
+        fRowWritten[dstY] = true;
+        while (fRowsDecoded < fSubset.height() && fRowWritten[fRowsDecoded]) {
+            fRowsDecoded++;
+        }
+    }
+
+    void onEnd() {
+        fDone = true;
+        if (fInterlaced && kOpaque_SkAlphaType != fCodec->getInfo().alphaType()) {
+            // Only the last pass leaves the pixels whose alpha counts, so look at them again.
+            const uint8_t* row = static_cast<const uint8_t*>(fStorage.get());
+            for (int y = 0; y < fSubset.height(); y++) {
+                fCodec->fReallyHasAlpha |= !SkSwizzler::IsOpaque(fCodec->fSwizzler->next(row, y));
+                row += fSrcRowBytes;
+            }
+        }
+    }
+
+    static const size_t kBufferSize = 4096;
+
+    SkPngCodec*         fCodec;     // Unowned.
+    png_structp         fPng_ptr;
+    png_infop           fInfo_ptr;
+    const SkIRect       fSubset;
+    const bool          fInterlaced;
+    size_t              fSrcRowBytes;
+    SkAutoMalloc        fStorage;
+    SkAutoTMalloc<bool> fRowWritten;
+    int                 fRowsDecoded;
+    bool                fDone;
+    bool                fFailed;
+    png_byte            fBuffer[kBufferSize];
+};
+
+SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                     size_t rowBytes, const Options& options) {
+    if (!this->handleRewind()) {
+        return kCouldNotRewind;
+    }
+    const SkIRect subset = options.fSubset ? *options.fSubset
+                                           : SkIRect::MakeSize(this->getInfo().dimensions());
+    if (dstInfo.dimensions() != subset.size()) {
+        return kInvalidScale;
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+
+    // The swizzler and color table only depend on the header, which fPng_ptr has read.
+    const Result result = this->initializeSwizzler(dstInfo, dst, rowBytes, options);
+    if (result != kSuccess) {
+        return result;
+    }
+
+    // fPng_ptr can't switch to progressive reading, so another one starts over from the
+    // signature. This is the only time the stream is read twice.
+    if (!this->stream()->rewind()) {
+        return kCouldNotRewind;
+    }
+    png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
+                                                 sk_error_fn, sk_warning_fn);
+    if (!png_ptr) {
+        return kInvalidInput;
+    }
+    AutoCleanPng autoClean(png_ptr);
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr) {
+        return kInvalidInput;
+    }
+    autoClean.setInfoPtr(info_ptr);
+
+    SkASSERT(fNumberPasses != INVALID_NUMBER_PASSES);
+    fIncrementalDecoder.reset(SkNEW_ARGS(SkPngIncrementalDecoder,
+                                         (this, png_ptr, info_ptr, subset, fNumberPasses > 1)));
+    autoClean.detach();
+    return kSuccess;
+}
+
+SkCodec::Result SkPngCodec::onIncrementalDecode(int* rowsDecoded) {
+    SkASSERT(fIncrementalDecoder);
+    return fIncrementalDecoder->decode(this->stream(), rowsDecoded);
+}
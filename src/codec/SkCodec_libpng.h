@@ -16,6 +16,7 @@ extern "C" {
     #include "png.h"
 }
 
+class SkPngIncrementalDecoder;
 class SkScanlineDecoder;
 class SkStream;
 
@@ -30,6 +31,9 @@ protected:
     SkEncodedFormat onGetEncodedFormat() const override { return kPNG_SkEncodedFormat; }
     SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
     bool onReallyHasAlpha() const override { return fReallyHasAlpha; }
+    bool onCanDecodeSubset() const override { return true; }
+    Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t, const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
 private:
     png_structp                 fPng_ptr;
     png_infop                   fInfo_ptr;
@@ -37,6 +41,8 @@ private:
     // These are stored here so they can be used both by normal decoding and scanline decoding.
     SkAutoTUnref<SkColorTable>  fColorTable;    // May be unpremul.
     SkAutoTDelete<SkSwizzler>   fSwizzler;
+    // Has its own png_ptr, in progressive mode, while an incremental decode is under way.
+    SkAutoTDelete<SkPngIncrementalDecoder> fIncrementalDecoder;
 
     SkSwizzler::SrcConfig       fSrcConfig;
     int                         fNumberPasses;
@@ -54,6 +60,7 @@ private:
     void finish();
     void destroyReadStruct();
 
+    friend class SkPngIncrementalDecoder;
     friend class SkPngScanlineDecoder;
 
     typedef SkCodec INHERITED;
@@ -0,0 +1,342 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodec_libwebp.h"
+#include "SkCodecPriv.h"
+#include "SkRect.h"
+#include "SkScanlineDecoder.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+extern "C" {
+    #include "webp/decode.h"
+}
+
+// Enough for WebPGetFeatures() to find the size and alpha of simple and extended files alike.
+static const size_t WEBP_VP8_HEADER_SIZE = 64;
+
+// How much of the stream is handed to libwebp at a time.
+static const size_t WEBP_IDECODE_BUFFER_SZ = 4096;
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+
+static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
+    unsigned char buffer[WEBP_VP8_HEADER_SIZE];
+    const size_t bytesRead = stream->read(buffer, WEBP_VP8_HEADER_SIZE);
+
+    WebPBitstreamFeatures features;
+    if (VP8_STATUS_OK != WebPGetFeatures(buffer, bytesRead, &features)) {
+        return false;
+    }
+    // libwebp's decoder only draws the first frame of an animation, without its canvas.
+    if (features.has_animation) {
+        return false;
+    }
+
+    // Sanity check the size, so that the N32 pixels are addressable.
+    const int64_t size = sk_64_mul(features.width, features.height);
+    if (features.width <= 0 || features.height <= 0 || !sk_64_isS32(size) ||
+            sk_64_asS32(size) > (0x7FFFFFFF >> 2)) {
+        return false;
+    }
+
+    *info = SkImageInfo::MakeN32(features.width, features.height,
+                                 features.has_alpha ? kUnpremul_SkAlphaType
+                                                    : kOpaque_SkAlphaType);
+    return true;
+}
+
+static bool conversion_possible(const SkImageInfo& dst, const SkImageInfo& src) {
+    if (dst.profileType() != src.profileType()) {
+        return false;
+    }
+    switch (dst.colorType()) {
+        case kN32_SkColorType:
+            if (dst.alphaType() == src.alphaType()) {
+                return true;
+            }
+            return kPremul_SkAlphaType == dst.alphaType() &&
+                   kUnpremul_SkAlphaType == src.alphaType();
+        case kRGB_565_SkColorType:
+            return kOpaque_SkAlphaType == src.alphaType() &&
+                   kOpaque_SkAlphaType == dst.alphaType();
+        default:
+            return false;
+    }
+}
+
+static WEBP_CSP_MODE webp_decode_mode(const SkImageInfo& info) {
+    const bool premultiply = kPremul_SkAlphaType == info.alphaType();
+    switch (info.colorType()) {
+        case kBGRA_8888_SkColorType:
+            return premultiply ? MODE_bgrA : MODE_BGRA;
+        case kRGBA_8888_SkColorType:
+            return premultiply ? MODE_rgbA : MODE_RGBA;
+        case kRGB_565_SkColorType:
+            return MODE_RGB_565;
+        default:
+            return MODE_LAST;
+    }
+}
+
+// libwebp scales while it decodes, to any size no larger than the image.
+static bool valid_scale(const SkImageInfo& dstInfo, const SkImageInfo& srcInfo) {
+    return dstInfo.width() > 0 && dstInfo.height() > 0 &&
+           dstInfo.width() <= srcInfo.width() && dstInfo.height() <= srcInfo.height();
+}
+
+// Sets up config to decode the whole image to the dimensions of dstInfo.
+static bool init_config(WebPDecoderConfig* config, const SkImageInfo& dstInfo,
+                        const SkImageInfo& srcInfo) {
+    if (!WebPInitDecoderConfig(config)) {
+        return false;
+    }
+    config->output.colorspace = webp_decode_mode(dstInfo);
+    if (dstInfo.dimensions() != srcInfo.dimensions()) {
+        config->options.use_scaling = 1;
+        config->options.scaled_width = dstInfo.width();
+        config->options.scaled_height = dstInfo.height();
+    }
+    return true;
+}
+
+// Appends the stream to idec until libwebp has decoded rowsNeeded rows, or the stream runs out.
+// Sets rowsDecoded to the number of rows decoded so far.
+static SkImageGenerator::Result decode_rows(WebPIDecoder* idec, SkStream* stream, int rowsNeeded,
+                                            int* rowsDecoded) {
+    uint8_t buffer[WEBP_IDECODE_BUFFER_SZ];
+    for (;;) {
+        int lastY = 0;
+        if (NULL == WebPIDecGetRGB(idec, &lastY, NULL, NULL, NULL)) {
+            lastY = 0;  // Nothing has been output yet.
+        }
+        *rowsDecoded = lastY;
+        if (lastY >= rowsNeeded) {
+            return SkImageGenerator::kSuccess;
+        }
+
+        const size_t bytesRead = stream->read(buffer, WEBP_IDECODE_BUFFER_SZ);
+        if (0 == bytesRead) {
+            return SkImageGenerator::kIncompleteInput;
+        }
+        const VP8StatusCode status = WebPIAppend(idec, buffer, bytesRead);
+        if (VP8_STATUS_OK != status && VP8_STATUS_SUSPENDED != status) {
+            SkCodecPrintf("WebPIAppend failed with %d.\n", status);
+            return SkImageGenerator::kInvalidInput;
+        }
+    }
+}
+
+// Zeroes the rows of a partial image that libwebp didn't get to.
+static void fill_rows(void* dst, size_t rowBytes, size_t widthBytes, int startRow, int endRow) {
+    for (int y = startRow; y < endRow; ++y) {
+        memset(SkTAddOffset<void>(dst, y * rowBytes), 0, widthBytes);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Creation
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkWebpCodec::IsWebp(SkStream* stream) {
+    // RIFF, then the file size, then WEBP and the first chunk, which is VP8, VP8L or VP8X.
+    static const size_t kSigSize = 14;
+    char bytes[kSigSize];
+    if (stream->read(bytes, kSigSize) != kSigSize) {
+        return false;
+    }
+    return 0 == memcmp(bytes, "RIFF", 4) && 0 == memcmp(bytes + 8, "WEBPVP", 6);
+}
+
+SkCodec* SkWebpCodec::NewFromStream(SkStream* stream) {
+    SkAutoTDelete<SkStream> streamDeleter(stream);
+    SkImageInfo info;
+    if (!webp_parse_header(stream, &info)) {
+        return NULL;
+    }
+    // libwebp reads the header again with the rest of the image.
+    if (!stream->rewind()) {
+        return NULL;
+    }
+    return SkNEW_ARGS(SkWebpCodec, (info, streamDeleter.detach()));
+}
+
+SkWebpCodec::SkWebpCodec(const SkImageInfo& info, SkStream* stream)
+    : INHERITED(info, stream)
+{}
+
+SkISize SkWebpCodec::onGetScaledDimensions(float desiredScale) const {
+    SkISize dim = this->getInfo().dimensions();
+    // libwebp only scales down, and never to an empty image.
+    desiredScale = SkTMin(desiredScale, 1.0f);
+    dim.fWidth = SkTMax(1, SkScalarRoundToInt(desiredScale * dim.fWidth));
+    dim.fHeight = SkTMax(1, SkScalarRoundToInt(desiredScale * dim.fHeight));
+    return dim;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Getting the pixels
+///////////////////////////////////////////////////////////////////////////////
+
+SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options, SkPMColor*, int*) {
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded()) {
+        return kCouldNotRewind;
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+    const SkIRect* subset = options.fSubset;
+    if (!subset && !valid_scale(dstInfo, this->getInfo())) {
+        return kInvalidScale;
+    }
+
+    WebPDecoderConfig config;
+    if (!init_config(&config, dstInfo, subset ? dstInfo : this->getInfo())) {
+        return kInvalidInput;
+    }
+
+    // libwebp decodes straight into dst, unless the subset starts on an odd row or column:
+    // libwebp rounds the crop origin down to even coordinates (for the chroma of lossy images),
+    // so those subsets are decoded one larger, to the side, and copied.
+    SkImageInfo webpInfo = dstInfo;
+    void* webpDst = dst;
+    size_t webpRowBytes = rowBytes;
+    SkAutoMalloc cropStorage;
+    int dx = 0;
+    int dy = 0;
+    if (subset) {
+        dx = subset->fLeft & 1;
+        dy = subset->fTop & 1;
+        config.options.use_cropping = 1;
+        config.options.crop_left = subset->fLeft - dx;
+        config.options.crop_top = subset->fTop - dy;
+        config.options.crop_width = subset->width() + dx;
+        config.options.crop_height = subset->height() + dy;
+        if (dx || dy) {
+            webpInfo = dstInfo.makeWH(subset->width() + dx, subset->height() + dy);
+            webpRowBytes = webpInfo.minRowBytes();
+            webpDst = cropStorage.reset(webpInfo.getSafeSize(webpRowBytes));
+        }
+    }
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = static_cast<uint8_t*>(webpDst);
+    config.output.u.RGBA.stride = SkToInt(webpRowBytes);
+    config.output.u.RGBA.size = webpInfo.getSafeSize(webpRowBytes);
+
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(NULL, 0, &config));
+    if (!idec) {
+        return kInvalidInput;
+    }
+    int rowsDecoded;
+    const Result result = decode_rows(idec, this->stream(), webpInfo.height(), &rowsDecoded);
+    if (kInvalidInput == result) {
+        return result;
+    }
+    if (kIncompleteInput == result && kNo_ZeroInitialized == options.fZeroInitialized) {
+        fill_rows(webpDst, webpRowBytes, webpInfo.minRowBytes(), rowsDecoded,
+                  webpInfo.height());
+    }
+
+    if (webpDst != dst) {
+        const size_t bpp = dstInfo.bytesPerPixel();
+        for (int y = 0; y < dstInfo.height(); ++y) {
+            memcpy(SkTAddOffset<void>(dst, y * rowBytes),
+                   SkTAddOffset<const void>(webpDst, (y + dy) * webpRowBytes + dx * bpp),
+                   dstInfo.minRowBytes());
+        }
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scanline decoding
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  libwebp only decodes whole images, so the scanline decoder lets it decode into memory of its
+ *  own, appending the stream only until the rows asked for have been decoded, and copies them.
+ */
+class SkWebpScanlineDecoder : public SkScanlineDecoder {
+public:
+    SkWebpScanlineDecoder(const SkImageInfo& dstInfo, SkStream* stream)
+        : INHERITED(dstInfo)
+        , fStream(stream)
+        , fIDec(NULL)
+        , fWidthBytes(dstInfo.minRowBytes())
+        , fNextRow(0)
+    {}
+
+    ~SkWebpScanlineDecoder() {
+        if (fIDec) {
+            WebPIDelete(fIDec);
+            WebPFreeDecBuffer(&fConfig.output);
+        }
+    }
+
+    bool init(const SkImageInfo& dstInfo, const SkImageInfo& srcInfo) {
+        if (!init_config(&fConfig, dstInfo, srcInfo)) {
+            return false;
+        }
+        // fIDec keeps pointers to fConfig's options and output.
+        fIDec = WebPIDecode(NULL, 0, &fConfig);
+        return NULL != fIDec;
+    }
+
+    SkImageGenerator::Result onGetScanlines(void* dst, int count, size_t rowBytes) override {
+        const int endRow = fNextRow + count;
+        int rowsDecoded;
+        const SkImageGenerator::Result result = decode_rows(fIDec, fStream, endRow,
+                                                            &rowsDecoded);
+        int stride = 0;
+        const uint8_t* decoded = WebPIDecGetRGB(fIDec, NULL, NULL, NULL, &stride);
+        for (int y = fNextRow; y < endRow; ++y) {
+            if (decoded && y < rowsDecoded) {
+                memcpy(dst, decoded + y * stride, fWidthBytes);
+            } else {
+                memset(dst, 0, fWidthBytes);
+            }
+            dst = SkTAddOffset<void>(dst, rowBytes);
+        }
+        fNextRow = endRow;
+        return result;
+    }
+
+    SkImageGenerator::Result onSkipScanlines(int count) override {
+        fNextRow += count;
+        int rowsDecoded;
+        return decode_rows(fIDec, fStream, fNextRow, &rowsDecoded);
+    }
+
+private:
+    SkStream*           fStream;    // Unowned.
+    WebPDecoderConfig   fConfig;
+    WebPIDecoder*       fIDec;
+    const size_t        fWidthBytes;
+    int                 fNextRow;
+
+    typedef SkScanlineDecoder INHERITED;
+};
+
+SkScanlineDecoder* SkWebpCodec::onGetScanlineDecoder(const SkImageInfo& dstInfo) {
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded()) {
+        return NULL;
+    }
+    if (!conversion_possible(dstInfo, this->getInfo()) ||
+            !valid_scale(dstInfo, this->getInfo())) {
+        return NULL;
+    }
+
+    SkAutoTDelete<SkWebpScanlineDecoder> decoder(SkNEW_ARGS(SkWebpScanlineDecoder,
+                                                            (dstInfo, this->stream())));
+    if (!decoder->init(dstInfo, this->getInfo())) {
+        return NULL;
+    }
+    return decoder.detach();
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodec_libwebp_DEFINED
+#define SkCodec_libwebp_DEFINED
+
+#include "SkCodec.h"
+#include "SkEncodedFormat.h"
+#include "SkImageInfo.h"
+
+class SkScanlineDecoder;
+class SkStream;
+
+/**
+ *  Decodes lossy and lossless (still) WebPs through libwebp, to kN32, or to kRGB_565 when the
+ *  image is opaque. libwebp scales while it decodes, so any size can be requested (see
+ *  getScaledDimensions()).
+ *
+ *  Subsets (see SkImageGenerator::Options::fSubset) decode only the rows and columns they cover.
+ */
+class SkWebpCodec : public SkCodec {
+public:
+    // Assumes IsWebp was called and returned true.
+    static SkCodec* NewFromStream(SkStream*);
+    static bool IsWebp(SkStream*);
+protected:
+    Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*)
+            override;
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+    SkEncodedFormat onGetEncodedFormat() const override { return kWEBP_SkEncodedFormat; }
+    SkScanlineDecoder* onGetScanlineDecoder(const SkImageInfo& dstInfo) override;
+    bool onCanDecodeSubset() const override { return true; }
+    bool onReallyHasAlpha() const override {
+        // libwebp doesn't tell us whether the alpha it decoded was all opaque.
+        return kOpaque_SkAlphaType != this->getInfo().alphaType();
+    }
+private:
+    SkWebpCodec(const SkImageInfo&, SkStream*);
+
+    typedef SkCodec INHERITED;
+};
+
+#endif  // SkCodec_libwebp_DEFINED
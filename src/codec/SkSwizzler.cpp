@@ -8,6 +8,7 @@
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
 #include "SkSwizzler.h"
+#include "SkSwizzler_opts.h"
 #include "SkTemplates.h"
 
 SkSwizzler::ResultAlpha SkSwizzler::GetResult(uint8_t zeroAlpha,
@@ -171,6 +172,18 @@ static SkSwizzler::ResultAlpha swizzle_bgra_to_n32_premul(
     return COMPUTE_RESULT_ALPHA;
 }
 
+// kGray
+static SkSwizzler::ResultAlpha swizzle_gray_to_n32(
+        void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
+        int bytesPerPixel, int y, const SkPMColor ctable[]) {
+
+    SkPMColor* SK_RESTRICT dst = (SkPMColor*)dstRow;
+    for (int x = 0; x < width; x++) {
+        dst[x] = SkPackARGB32NoCheck(0xFF, src[x], src[x], src[x]);
+    }
+    return SkSwizzler::kOpaque_ResultAlpha;
+}
+
 // n32
 static SkSwizzler::ResultAlpha swizzle_rgbx_to_n32(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int width,
@@ -262,10 +275,14 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                                        const SkPMColor* ctable,
                                        const SkImageInfo& info, void* dst,
                                        size_t dstRowBytes,
-                                       SkImageGenerator::ZeroInitialized zeroInit) {
+                                       SkImageGenerator::ZeroInitialized zeroInit,
+                                       int srcX) {
     if (info.colorType() == kUnknown_SkColorType || kUnknown == sc) {
         return NULL;
     }
+    if (srcX < 0 || (srcX > 0 && !SkIsAlign8(BitsPerPixel(sc)))) {
+        return NULL;
+    }
     if (info.minRowBytes() > dstRowBytes) {
         return  NULL;
     }
@@ -274,7 +291,18 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
         return NULL;
     }
     RowProc proc = NULL;
+    // A platform version of proc, which the swizzler uses instead when it has one.
+    SkSwizzleRowProc optsProc = NULL;
     switch (sc) {
+        case kGray:
+            switch (info.colorType()) {
+                case kN32_SkColorType:
+                    proc = &swizzle_gray_to_n32;
+                    break;
+                default:
+                    break;
+            }
+            break;
         case kIndex1:
         case kIndex2:
         case kIndex4:
@@ -298,6 +326,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                         break;
                     } else {
                         proc = &swizzle_index_to_n32;
+                        optsProc = SkSwizzleGetPlatformProc(kIndex_To_N32_SkSwizzleProcType);
                         break;
                     }
                     break;
@@ -344,6 +373,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
             switch (info.colorType()) {
                 case kN32_SkColorType:
                     proc = &swizzle_rgbx_to_n32;
+                    optsProc = SkSwizzleGetPlatformProc(kRGBX_To_N32_SkSwizzleProcType);
                     break;
                 default:
                     break;
@@ -355,11 +385,15 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
                     if (info.alphaType() == kUnpremul_SkAlphaType) {
                         // Respect zeroInit?
                         proc = &swizzle_rgba_to_n32_unpremul;
+                        optsProc = SkSwizzleGetPlatformProc(
+                                kRGBA_To_N32_Unpremul_SkSwizzleProcType);
                     } else {
                         if (SkImageGenerator::kYes_ZeroInitialized == zeroInit) {
                             proc = &swizzle_rgba_to_n32_premul_skipZ;
                         } else {
                             proc = &swizzle_rgba_to_n32_premul;
+                            optsProc = SkSwizzleGetPlatformProc(
+                                    kRGBA_To_N32_Premul_SkSwizzleProcType);
                         }
                     }
                     break;
@@ -371,6 +405,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
             switch (info.colorType()) {
                 case kN32_SkColorType:
                     proc = &swizzle_rgbx_to_n32;
+                    optsProc = SkSwizzleGetPlatformProc(kRGB_To_N32_SkSwizzleProcType);
                     break;
                 default:
                     break;
@@ -386,16 +421,19 @@ SkSwizzler* SkSwizzler::CreateSwizzler(SkSwizzler::SrcConfig sc,
     // Store deltaSrc in bytes if it is an even multiple, otherwise use bits
     int deltaSrc = SkIsAlign8(BitsPerPixel(sc)) ? BytesPerPixel(sc) :
             BitsPerPixel(sc);
-    return SkNEW_ARGS(SkSwizzler, (proc, ctable, deltaSrc, info, dst,
+    const size_t srcOffset = srcX * (BitsPerPixel(sc) >> 3);
+    return SkNEW_ARGS(SkSwizzler, (proc, optsProc, ctable, deltaSrc, srcOffset, info, dst,
                                    dstRowBytes));
 }
 
-SkSwizzler::SkSwizzler(RowProc proc, const SkPMColor* ctable,
-                       int deltaSrc, const SkImageInfo& info, void* dst,
+SkSwizzler::SkSwizzler(RowProc proc, SkSwizzleRowProc optsProc, const SkPMColor* ctable,
+                       int deltaSrc, size_t srcOffset, const SkImageInfo& info, void* dst,
                        size_t rowBytes)
     : fRowProc(proc)
+    , fOptsProc(optsProc)
     , fColorTable(ctable)
     , fDeltaSrc(deltaSrc)
+    , fSrcOffset(srcOffset)
     , fDstInfo(info)
     , fDstRow(dst)
     , fDstRowBytes(rowBytes)
@@ -411,8 +449,7 @@ SkSwizzler::ResultAlpha SkSwizzler::next(const uint8_t* SK_RESTRICT src) {
     SkDEBUGCODE(fNextMode = kConsecutive_NextMode);
 
     // Decode a row
-    const ResultAlpha result = fRowProc(fDstRow, src, fDstInfo.width(),
-            fDeltaSrc, fCurrY, fColorTable);
+    const ResultAlpha result = this->swizzleRow(fDstRow, src, fCurrY);
 
     // Move to the next row and return the result
     fCurrY++;
@@ -430,6 +467,14 @@ SkSwizzler::ResultAlpha SkSwizzler::next(const uint8_t* SK_RESTRICT src,
     void* row = SkTAddOffset<void>(fDstRow, y*fDstRowBytes);
 
     // Decode the row
-    return fRowProc(row, src, fDstInfo.width(), fDeltaSrc, fCurrY,
-            fColorTable);
+    return this->swizzleRow(row, src, fCurrY);
+}
+
+SkSwizzler::ResultAlpha SkSwizzler::swizzleRow(void* dstRow, const uint8_t* SK_RESTRICT src,
+                                               int y) {
+    src += fSrcOffset;
+    if (fOptsProc) {
+        return fOptsProc((SkPMColor*)dstRow, src, fDstInfo.width(), fColorTable);
+    }
+    return fRowProc(dstRow, src, fDstInfo.width(), fDeltaSrc, y, fColorTable);
 }
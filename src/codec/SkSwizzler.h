@@ -11,6 +11,7 @@
 #include "SkCodec.h"
 #include "SkColor.h"
 #include "SkImageInfo.h"
+#include "SkSwizzler_opts.h"
 
 class SkSwizzler : public SkNoncopyable {
 public:
@@ -122,12 +123,16 @@ public:
      *  @param ZeroInitialized Whether dst is zero-initialized. The
                                implementation may choose to skip writing zeroes
      *                         if set to kYes_ZeroInitialized.
+     *  @param srcX First column of each src row to swizzle, for decoding a
+     *              subset. The src rows must be at least srcX + info.width()
+     *              pixels wide. Only supported for whole-byte src configs.
      *  @return A new SkSwizzler or NULL on failure.
      */
     static SkSwizzler* CreateSwizzler(SrcConfig, const SkPMColor* ctable,
                                       const SkImageInfo&, void* dst,
                                       size_t dstRowBytes,
-                                      SkImageGenerator::ZeroInitialized);
+                                      SkImageGenerator::ZeroInitialized,
+                                      int srcX = 0);
     /**
      *  Swizzle the next line. Call height times, once for each row of source.
      *  @param src The next row of the source data.
@@ -189,18 +194,22 @@ private:
                                    const SkPMColor ctable[]);
 
     const RowProc       fRowProc;
+    const SkSwizzleRowProc fOptsProc;     // SIMD version of fRowProc, or NULL
     const SkPMColor*    fColorTable;      // Unowned pointer
     const int           fDeltaSrc;        // if bitsPerPixel % 8 == 0
                                           //     deltaSrc is bytesPerPixel
                                           // else
                                           //     deltaSrc is bitsPerPixel
+    const size_t        fSrcOffset;       // in bytes, to the first column to swizzle
     const SkImageInfo   fDstInfo;
     void*               fDstRow;
     const size_t        fDstRowBytes;
     int                 fCurrY;
 
-    SkSwizzler(RowProc proc, const SkPMColor* ctable, int deltaSrc,
-               const SkImageInfo& info, void* dst, size_t rowBytes);
+    SkSwizzler(RowProc proc, SkSwizzleRowProc optsProc, const SkPMColor* ctable, int deltaSrc,
+               size_t srcOffset, const SkImageInfo& info, void* dst, size_t rowBytes);
+
+    ResultAlpha swizzleRow(void* dstRow, const uint8_t* SK_RESTRICT src, int y);
 
 };
 #endif // SkSwizzler_DEFINED
@@ -7,8 +7,19 @@
 
 #include "SkBBHFactory.h"
 #include "SkRTree.h"
+#include "SkTileGrid.h"
 
 SkBBoxHierarchy* SkRTreeFactory::operator()(const SkRect& bounds) const {
     SkScalar aspectRatio = bounds.width() / bounds.height();
     return SkNEW_ARGS(SkRTree, (aspectRatio));
 }
+
+SkBBoxHierarchy* SkTileGridFactory::operator()(const SkRect& bounds) const {
+    SkASSERT(fInfo.fTileInterval.width() > 0 && fInfo.fTileInterval.height() > 0);
+    // Cover the bounds, shifted into grid space, with whole tiles.
+    SkRect gridBounds = bounds.makeOffset(SkIntToScalar(fInfo.fOffset.fX),
+                                          SkIntToScalar(fInfo.fOffset.fY));
+    int xTiles = SkScalarCeilToInt(gridBounds.right() / fInfo.fTileInterval.width());
+    int yTiles = SkScalarCeilToInt(gridBounds.bottom() / fInfo.fTileInterval.height());
+    return SkNEW_ARGS(SkTileGrid, (SkTMax(xTiles, 1), SkTMax(yTiles, 1), fInfo));
+}
@@ -72,6 +72,7 @@ struct BitmapRec : public SkResourceCache::Rec {
     {}
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "bitmap"; }
     size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
 
     static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
@@ -172,6 +173,7 @@ struct MipMapRec : public SkResourceCache::Rec {
     }
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "mipmap"; }
     size_t bytesUsed() const override { return sizeof(fKey) + fMipMap->size(); }
 
     static bool Finder(const SkResourceCache::Rec& baseRec, void* contextMip) {
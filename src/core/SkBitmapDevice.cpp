@@ -12,6 +12,7 @@
 #include "SkRasterClip.h"
 #include "SkShader.h"
 #include "SkSurface.h"
+#include "SkTextAlongPath.h"
 
 #define CHECK_FOR_ANNOTATION(paint) \
     do { if (paint.getAnnotation()) { return; } } while (0)
@@ -184,6 +185,12 @@ void SkBitmapDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint
     draw.drawRect(r, paint);
 }
 
+void SkBitmapDevice::drawRects(const SkDraw& draw, const SkRect rects[], int count,
+                               const SkPaint& paint) {
+    CHECK_FOR_ANNOTATION(paint);
+    draw.drawRects(rects, count, paint);
+}
+
 void SkBitmapDevice::drawOval(const SkDraw& draw, const SkRect& oval, const SkPaint& paint) {
     CHECK_FOR_ANNOTATION(paint);
 
@@ -329,6 +336,28 @@ void SkBitmapDevice::drawPosText(const SkDraw& draw, const void* text, size_t le
     draw.drawPosText((const char*)text, len, xpos, scalarsPerPos, offset, paint);
 }
 
+void SkBitmapDevice::drawPosTextHalo(const SkDraw& draw, const void* text, size_t len,
+                                     const SkScalar xpos[], int scalarsPerPos,
+                                     const SkPoint& offset, const SkPaint& haloPaint,
+                                     const SkPaint& paint) {
+    draw.drawPosTextHalo((const char*)text, len, xpos, scalarsPerPos, offset, haloPaint, paint);
+}
+
+void SkBitmapDevice::drawTextOnPath(const SkDraw& draw, const void* text, size_t len,
+                                    const SkPath& follow, const SkMatrix* matrix,
+                                    const SkPaint& paint) {
+    if (SkTextAlongPath::IsEnabled() && SkDraw::CanDrawTextRSXform(paint, *draw.fMatrix)) {
+        SkAutoTUnref<SkSharedPathMeasure> measure(SkTextAlongPath::RefMeasure(follow));
+        SkTDArray<uint16_t> glyphs;
+        SkTDArray<SkRSXform> xforms;
+        if (SkTextAlongPath::ComputeXforms(text, len, paint, *measure, matrix, &glyphs, &xforms)) {
+            draw.drawTextRSXform(glyphs.begin(), xforms.begin(), xforms.count(), paint);
+            return;
+        }
+    }
+    this->INHERITED::drawTextOnPath(draw, text, len, follow, matrix, paint);
+}
+
 void SkBitmapDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode,
                                   int vertexCount,
                                   const SkPoint verts[], const SkPoint textures[],
@@ -9,6 +9,8 @@
 #include "SkBitmapProcState.h"
 #include "SkColorPriv.h"
 #include "SkFilterProc.h"
+#include "SkGraphics.h"
+#include "SkLazyPtr.h"
 #include "SkPaint.h"
 #include "SkShader.h"   // for tilemodes
 #include "SkUtilsArm.h"
@@ -17,6 +19,8 @@
 #include "SkPixelRef.h"
 #include "SkImageEncoder.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
+#include "SkThread.h"
 
 #if !SK_ARM_NEON_IS_NONE
 // These are defined in src/opts/SkBitmapProcState_arm_neon.cpp
@@ -112,6 +116,102 @@ static inline bool cache_size_okay(const SkBitmap& bm, const SkMatrix& invMat) {
         < (maximumAllocation * invMat.getScaleX() * invMat.getScaleY());
 }
 
+// Makes the high quality copy of src at the rounded dest size, and adds it to SkBitmapCache.
+static bool resize_and_cache(const SkBitmap& src, SkScalar destWidth, SkScalar destHeight,
+                             SkBitmap* result) {
+    if (!SkBitmapScaler::Resize(result, src, SkBitmapScaler::RESIZE_BEST,
+                                destWidth, destHeight, SkResourceCache::GetAllocator())) {
+        return false;
+    }
+    SkASSERT(result->getPixels());
+    result->setImmutable();
+    SkBitmapCache::Add(src, destWidth, destHeight, *result);
+    return true;
+}
+
+namespace {
+// A scale queued by queue_async_hq_scale(), until it has been cached.
+struct AsyncHQScale {
+    SkBitmap        fSrc;
+    SkScalar        fDestWidth;
+    SkScalar        fDestHeight;
+    AsyncHQScale*   fNext;
+
+    bool matches(const SkBitmap& src, SkScalar destWidth, SkScalar destHeight) const {
+        return fSrc.getGenerationID() == src.getGenerationID() &&
+               fSrc.pixelRefOrigin() == src.pixelRefOrigin() &&
+               fSrc.dimensions() == src.dimensions() &&
+               fDestWidth == destWidth && fDestHeight == destHeight;
+    }
+};
+} // namespace
+
+static bool gAsyncHQScalingEnabled = false;
+SK_DECLARE_STATIC_MUTEX(gAsyncHQScaleMutex);
+static AsyncHQScale* gPendingHQScales = NULL;   // Guarded by gAsyncHQScaleMutex.
+SK_DECLARE_STATIC_LAZY_PTR(SkTaskGroup, gAsyncHQScaleTasks);
+
+static void run_async_hq_scale(AsyncHQScale* scale) {
+    {
+        SkAutoLockPixels alp(scale->fSrc);
+        SkBitmap result;
+        if (scale->fSrc.getPixels()) {
+            resize_and_cache(scale->fSrc, scale->fDestWidth, scale->fDestHeight, &result);
+        }
+    }
+
+    SkAutoMutexAcquire am(gAsyncHQScaleMutex);
+    AsyncHQScale** link = &gPendingHQScales;
+    while (*link != scale) {
+        link = &(*link)->fNext;
+    }
+    *link = scale->fNext;
+    SkDELETE(scale);
+}
+
+// Queues the high quality scale of src on gAsyncHQScaleTasks, unless it is already queued.
+static void queue_async_hq_scale(const SkBitmap& src, SkScalar destWidth, SkScalar destHeight) {
+    AsyncHQScale* scale;
+    {
+        SkAutoMutexAcquire am(gAsyncHQScaleMutex);
+        for (const AsyncHQScale* s = gPendingHQScales; s; s = s->fNext) {
+            if (s->matches(src, destWidth, destHeight)) {
+                return;
+            }
+        }
+        scale = SkNEW(AsyncHQScale);
+        scale->fSrc = src;
+        scale->fDestWidth = destWidth;
+        scale->fDestHeight = destHeight;
+        scale->fNext = gPendingHQScales;
+        gPendingHQScales = scale;
+    }
+    // Without SkTaskGroup threads this runs the scale right away.
+    gAsyncHQScaleTasks.get()->add(run_async_hq_scale, scale);
+}
+
+bool SkBitmapProcState::IsAsyncHQScalingEnabled() {
+    return gAsyncHQScalingEnabled;
+}
+
+bool SkBitmapProcState::SetAsyncHQScalingEnabled(bool enabled) {
+    bool prev = gAsyncHQScalingEnabled;
+    gAsyncHQScalingEnabled = enabled;
+    return prev;
+}
+
+void SkBitmapProcState::WaitForAsyncHQScales() {
+    gAsyncHQScaleTasks.get()->wait();
+}
+
+bool SkGraphics::GetAsyncHighQualityScalingEnabled() {
+    return SkBitmapProcState::IsAsyncHQScalingEnabled();
+}
+
+bool SkGraphics::SetAsyncHighQualityScalingEnabled(bool enabled) {
+    return SkBitmapProcState::SetAsyncHQScalingEnabled(enabled);
+}
+
 /*
  *  High quality is implemented by performing up-right scale-only filtering and then
  *  using bilerp for any remaining transformations.
@@ -149,18 +249,18 @@ void SkBitmapProcState::processHQRequest() {
     SkScalar roundedDestHeight = SkScalarRoundToScalar(trueDestHeight);
 
     if (!SkBitmapCache::Find(fOrigBitmap, roundedDestWidth, roundedDestHeight, &fScaledBitmap)) {
-        if (!SkBitmapScaler::Resize(&fScaledBitmap,
-                                    fOrigBitmap,
-                                    SkBitmapScaler::RESIZE_BEST,
-                                    roundedDestWidth,
-                                    roundedDestHeight,
-                                    SkResourceCache::GetAllocator())) {
+        // Only immutable bitmaps are scaled later, since their pixels can't change meanwhile.
+        if (gAsyncHQScalingEnabled && fOrigBitmap.isImmutable()) {
+            queue_async_hq_scale(fOrigBitmap, roundedDestWidth, roundedDestHeight);
+            if (!SkBitmapCache::Find(fOrigBitmap, roundedDestWidth, roundedDestHeight,
+                                     &fScaledBitmap)) {
+                fFilterLevel = kLow_SkFilterQuality;
+                return; // draw the original bitmap until the scale is cached
+            }
+        } else if (!resize_and_cache(fOrigBitmap, roundedDestWidth, roundedDestHeight,
+                                     &fScaledBitmap)) {
             return; // we failed to create fScaledBitmap
         }
-
-        SkASSERT(fScaledBitmap.getPixels());
-        fScaledBitmap.setImmutable();
-        SkBitmapCache::Add(fOrigBitmap, roundedDestWidth, roundedDestHeight, fScaledBitmap);
     }
 
     SkASSERT(fScaledBitmap.getPixels());
@@ -605,43 +705,135 @@ static inline int sk_int_mirror(int x, int n) {
     return x;
 }
 
-static void Repeat_S32_D32_nofilter_trans_shaderproc(const SkBitmapProcState& s,
-                                                     int x, int y,
-                                                     SkPMColor* SK_RESTRICT colors,
-                                                     int count) {
+static inline int tile_y(int y, int height, unsigned tileMode) {
+    switch (tileMode) {
+        case SkShader::kRepeat_TileMode:
+            return sk_int_mod(y, height);
+        case SkShader::kMirror_TileMode:
+            return sk_int_mirror(y, height);
+        default:
+            return SkClampMax(y, height - 1);
+    }
+}
+
+// Writes the src pixels of a row to the shader's colors, forwards from row[ix] or backwards
+// from row[ix] (for the mirrored half of a mirror tile).
+struct S32_Row {
+    typedef SkPMColor Src;
+    static void Forward(const SkBitmapProcState&, const Src* row, int ix,
+                        SkPMColor* SK_RESTRICT colors, int n) {
+        memcpy(colors, row + ix, n * sizeof(SkPMColor));
+    }
+    static void Backward(const SkBitmapProcState&, const Src* row, int ix,
+                         SkPMColor* SK_RESTRICT colors, int n) {
+        for (int i = 0; i < n; ++i) {
+            colors[i] = row[ix - i];
+        }
+    }
+};
+
+struct S16_Row {
+    typedef uint16_t Src;
+    static void Forward(const SkBitmapProcState&, const Src* row, int ix,
+                        SkPMColor* SK_RESTRICT colors, int n) {
+        for (int i = 0; i < n; ++i) {
+            colors[i] = SkPixel16ToPixel32(row[ix + i]);
+        }
+    }
+    static void Backward(const SkBitmapProcState&, const Src* row, int ix,
+                         SkPMColor* SK_RESTRICT colors, int n) {
+        for (int i = 0; i < n; ++i) {
+            colors[i] = SkPixel16ToPixel32(row[ix - i]);
+        }
+    }
+};
+
+struct SI8_Row {
+    typedef uint8_t Src;
+    static void Forward(const SkBitmapProcState& s, const Src* row, int ix,
+                        SkPMColor* SK_RESTRICT colors, int n) {
+        const SkPMColor* SK_RESTRICT table = s.fBitmap->getColorTable()->readColors();
+        for (int i = 0; i < n; ++i) {
+            colors[i] = table[row[ix + i]];
+        }
+    }
+    static void Backward(const SkBitmapProcState& s, const Src* row, int ix,
+                         SkPMColor* SK_RESTRICT colors, int n) {
+        const SkPMColor* SK_RESTRICT table = s.fBitmap->getColorTable()->readColors();
+        for (int i = 0; i < n; ++i) {
+            colors[i] = table[row[ix - i]];
+        }
+    }
+};
+
+/**
+ *  Repeat or mirror tiling in x (and any tiling in y) of a src moved by whole pixels: each
+ *  span is one or more runs of a src row, copied in order, rather than a sampled pixel each.
+ */
+template <typename RowProcs>
+static void Tile_nofilter_trans_shaderproc(const SkBitmapProcState& s,
+                                           int x, int y,
+                                           SkPMColor* SK_RESTRICT colors,
+                                           int count) {
     SkASSERT(((s.fInvType & ~SkMatrix::kTranslate_Mask)) == 0);
     SkASSERT(s.fInvKy == 0);
     SkASSERT(count > 0 && colors != NULL);
     SkASSERT(kNone_SkFilterQuality == s.fFilterLevel);
+    SkASSERT(SkShader::kRepeat_TileMode == s.fTileModeX ||
+             SkShader::kMirror_TileMode == s.fTileModeX);
 
     const int stopX = s.fBitmap->width();
     const int stopY = s.fBitmap->height();
     int ix = s.fFilterOneX + x;
-    int iy = sk_int_mod(s.fFilterOneY + y, stopY);
+    int iy = tile_y(s.fFilterOneY + y, stopY, s.fTileModeY);
 #ifdef SK_DEBUG
     {
         SkPoint pt;
         s.fInvProc(s.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
                    SkIntToScalar(y) + SK_ScalarHalf, &pt);
-        int iy2 = sk_int_mod(SkScalarFloorToInt(pt.fY), stopY);
+        int iy2 = tile_y(SkScalarFloorToInt(pt.fY), stopY, s.fTileModeY);
         int ix2 = SkScalarFloorToInt(pt.fX);
 
         SkASSERT(iy == iy2);
         SkASSERT(ix == ix2);
     }
 #endif
-    const SkPMColor* row = s.fBitmap->getAddr32(0, iy);
+    const typename RowProcs::Src* row =
+            (const typename RowProcs::Src*)s.fBitmap->getAddr(0, iy);
+
+    if (SkShader::kRepeat_TileMode == s.fTileModeX) {
+        ix = sk_int_mod(ix, stopX);
+        for (;;) {
+            int n = SkMin32(stopX - ix, count);
+            RowProcs::Forward(s, row, ix, colors, n);
+            count -= n;
+            if (0 == count) {
+                return;
+            }
+            colors += n;
+            ix = 0;
+        }
+    }
 
-    ix = sk_int_mod(ix, stopX);
+    // Mirror: [0, stopX) runs forwards, and [stopX, 2 * stopX) backwards from stopX - 1.
+    ix = sk_int_mod(ix, 2 * stopX);
     for (;;) {
-        int n = SkMin32(stopX - ix, count);
-        memcpy(colors, row + ix, n * sizeof(SkPMColor));
+        int n;
+        if (ix < stopX) {
+            n = SkMin32(stopX - ix, count);
+            RowProcs::Forward(s, row, ix, colors, n);
+            ix = stopX;
+        } else {
+            const int mx = 2 * stopX - 1 - ix;
+            n = SkMin32(mx + 1, count);
+            RowProcs::Backward(s, row, mx, colors, n);
+            ix = 0;
+        }
         count -= n;
         if (0 == count) {
             return;
         }
         colors += n;
-        ix = 0;
     }
 }
 
@@ -788,13 +980,15 @@ bool SkBitmapProcState::setupForTranslate() {
 
 SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseShaderProc32() {
 
-    if (kN32_SkColorType != fBitmap->colorType()) {
+    const SkColorType colorType = fBitmap->colorType();
+    if (kN32_SkColorType != colorType && kRGB_565_SkColorType != colorType &&
+        kIndex_8_SkColorType != colorType) {
         return NULL;
     }
 
     static const unsigned kMask = SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask;
 
-    if (1 == fBitmap->width() && 0 == (fInvType & ~kMask)) {
+    if (kN32_SkColorType == colorType && 1 == fBitmap->width() && 0 == (fInvType & ~kMask)) {
         if (kNone_SkFilterQuality == fFilterLevel &&
             fInvType <= SkMatrix::kTranslate_Mask &&
             !this->setupForTranslate()) {
@@ -817,16 +1011,28 @@ SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseShaderProc32() {
     SkShader::TileMode ty = (SkShader::TileMode)fTileModeY;
 
     if (SkShader::kClamp_TileMode == tx && SkShader::kClamp_TileMode == ty) {
+        if (kN32_SkColorType != colorType) {
+            return NULL;
+        }
         if (this->setupForTranslate()) {
             return Clamp_S32_D32_nofilter_trans_shaderproc;
         }
         return DoNothing_shaderproc;
     }
-    if (SkShader::kRepeat_TileMode == tx && SkShader::kRepeat_TileMode == ty) {
-        if (this->setupForTranslate()) {
-            return Repeat_S32_D32_nofilter_trans_shaderproc;
+    if (SkShader::kRepeat_TileMode == tx || SkShader::kMirror_TileMode == tx) {
+        if (!this->setupForTranslate()) {
+            return DoNothing_shaderproc;
+        }
+        switch (colorType) {
+            case kN32_SkColorType:
+                return Tile_nofilter_trans_shaderproc<S32_Row>;
+            case kRGB_565_SkColorType:
+                return Tile_nofilter_trans_shaderproc<S16_Row>;
+            case kIndex_8_SkColorType:
+                return Tile_nofilter_trans_shaderproc<SI8_Row>;
+            default:
+                return NULL;
         }
-        return DoNothing_shaderproc;
     }
     return NULL;
 }
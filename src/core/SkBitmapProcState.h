@@ -111,6 +111,17 @@ struct SkBitmapProcState {
     SampleProc32 getSampleProc32() const { return fSampleProc32; }
     SampleProc16 getSampleProc16() const { return fSampleProc16; }
 
+    /**
+     *  When enabled (see SkGraphics::SetAsyncHighQualityScalingEnabled()), a high quality draw of
+     *  an immutable bitmap whose scaled copy is not in SkBitmapCache yet queues that scale on an
+     *  SkTaskGroup and draws with low quality instead. Later draws find the copy in the cache.
+     */
+    static bool IsAsyncHQScalingEnabled();
+    static bool SetAsyncHQScalingEnabled(bool enabled);   // returns the previous setting
+
+    // Blocks until every queued scale has been added to SkBitmapCache (or has failed).
+    static void WaitForAsyncHQScales();
+
 private:
     friend class SkBitmapProcShader;
 
@@ -1,6 +1,7 @@
 #include "SkBitmapScaler.h"
 #include "SkBitmapFilter.h"
 #include "SkRect.h"
+#include "SkResourceCache.h"
 #include "SkTArray.h"
 #include "SkErrorInternals.h"
 #include "SkConvolver.h"
@@ -8,8 +9,9 @@
 // SkResizeFilter ----------------------------------------------------------------
 
 // Encapsulates computation and storage of the filters required for one complete
-// resize operation.
-class SkResizeFilter {
+// resize operation. They only depend on the sizes and the method, so they are
+// shared through the SkResourceCache by every resize with the same ones.
+class SkResizeFilter : public SkRefCnt {
 public:
     SkResizeFilter(SkBitmapScaler::ResizeMethod method,
                    int srcFullWidth, int srcFullHeight,
@@ -21,8 +23,12 @@ public:
     }
 
     // Returns the filled filter values.
-    const SkConvolutionFilter1D& xFilter() { return fXFilter; }
-    const SkConvolutionFilter1D& yFilter() { return fYFilter; }
+    const SkConvolutionFilter1D& xFilter() const { return fXFilter; }
+    const SkConvolutionFilter1D& yFilter() const { return fYFilter; }
+
+    size_t bytesUsed() const {
+        return sizeof(*this) + fXFilter.bytesUsed() + fYFilter.bytesUsed();
+    }
 
 private:
 
@@ -207,6 +213,74 @@ void SkResizeFilter::computeFilters(int srcSize,
   }
 }
 
+// SkResizeFilter cache ----------------------------------------------------------
+
+namespace {
+static unsigned gResizeFilterKeyNamespaceLabel;
+
+struct ResizeFilterKey : public SkResourceCache::Key {
+public:
+    ResizeFilterKey(SkBitmapScaler::ResizeMethod method, int srcWidth, int srcHeight,
+                    float destWidth, float destHeight)
+        : fMethod(method)
+        , fSrcWidth(srcWidth)
+        , fSrcHeight(srcHeight)
+        , fDestWidth(destWidth)
+        , fDestHeight(destHeight)
+    {
+        this->init(&gResizeFilterKeyNamespaceLabel, 0,
+                   sizeof(fMethod) + sizeof(fSrcWidth) + sizeof(fSrcHeight) +
+                   sizeof(fDestWidth) + sizeof(fDestHeight));
+    }
+
+    int32_t fMethod;
+    int32_t fSrcWidth;
+    int32_t fSrcHeight;
+    float   fDestWidth;
+    float   fDestHeight;
+};
+
+struct ResizeFilterRec : public SkResourceCache::Rec {
+    ResizeFilterRec(const ResizeFilterKey& key, SkResizeFilter* filter)
+        : fKey(key)
+        , fFilter(SkRef(filter))
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "resize-filter"; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fFilter->bytesUsed(); }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextFilter) {
+        const ResizeFilterRec& rec = static_cast<const ResizeFilterRec&>(baseRec);
+        // The caller must unref() it when they are done.
+        *(SkResizeFilter**)contextFilter = SkRef(rec.fFilter.get());
+        return true;
+    }
+
+private:
+    ResizeFilterKey                 fKey;
+    SkAutoTUnref<SkResizeFilter>    fFilter;
+};
+}  // namespace
+
+// Returns the (ref'd) filters for the resize, from the cache if they're there.
+static SkResizeFilter* find_or_compute_filter(SkBitmapScaler::ResizeMethod method,
+                                              int srcWidth, int srcHeight,
+                                              float destWidth, float destHeight,
+                                              const SkConvolutionProcs& convolveProcs) {
+    const ResizeFilterKey key(method, srcWidth, srcHeight, destWidth, destHeight);
+    SkResizeFilter* filter;
+    if (SkResourceCache::Find(key, ResizeFilterRec::Finder, &filter)) {
+        return filter;
+    }
+
+    const SkRect destSubset = { 0, 0, destWidth, destHeight };
+    filter = SkNEW_ARGS(SkResizeFilter, (method, srcWidth, srcHeight, destWidth, destHeight,
+                                         destSubset, convolveProcs));
+    SkResourceCache::Add(SkNEW_ARGS(ResizeFilterRec, (key, filter)));
+    return filter;
+}
+
 static SkBitmapScaler::ResizeMethod ResizeMethodToAlgorithmMethod(
                                     SkBitmapScaler::ResizeMethod method) {
     // Convert any "Quality Method" into an "Algorithm Method"
@@ -280,8 +354,10 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
       return false;
   }
 
-  SkResizeFilter filter(method, source.width(), source.height(),
-                        destWidth, destHeight, destSubset, convolveProcs);
+  SkAutoTUnref<SkResizeFilter> filter(find_or_compute_filter(method,
+                                                             source.width(), source.height(),
+                                                             destWidth, destHeight,
+                                                             convolveProcs));
 
   // Get a source bitmap encompassing this touched area. We construct the
   // offsets and row strides such that it looks like a new bitmap, while
@@ -300,7 +376,7 @@ bool SkBitmapScaler::Resize(SkBitmap* resultPtr,
   }
 
   BGRAConvolve2D(sourceSubset, static_cast<int>(source.rowBytes()),
-      !source.isOpaque(), filter.xFilter(), filter.yFilter(),
+      !source.isOpaque(), filter->xFilter(), filter->yFilter(),
       static_cast<int>(result.rowBytes()),
       static_cast<unsigned char*>(result.getPixels()),
       convolveProcs, true);
@@ -8,6 +8,7 @@
 #include "SkBlitMask.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkUtils.h"
 
 static void D32_A8_Color(void* SK_RESTRICT dst, size_t dstRB,
                          const void* SK_RESTRICT maskPtr, size_t maskRB,
@@ -147,12 +148,84 @@ SkBlitMask::ColorProc SkBlitMask::ColorFactory(SkColorType ct,
     return NULL;
 }
 
+// Spans of partial coverage only end at a solid run at least this long, so the proc isn't called
+// for every few pixels of a mask that is mostly anti-aliased.
+static const int kMinSolidA8Run = 8;
+
+static inline uint64_t load_8_bytes(const uint8_t* p) {
+    uint64_t bytes;
+    memcpy(&bytes, p, sizeof(bytes));
+    return bytes;
+}
+
+// Returns how many of the count bytes at mask equal value, starting at mask[0].
+static int a8_run_length(const uint8_t* mask, int count, uint8_t value) {
+    const uint64_t value8 = value * 0x0101010101010101ULL;
+    int n = 0;
+    while (n + 8 <= count && load_8_bytes(mask + n) == value8) {
+        n += 8;
+    }
+    while (n < count && mask[n] == value) {
+        n += 1;
+    }
+    return n;
+}
+
+// Returns true if the kMinSolidA8Run bytes at mask are all transparent, or all opaque coverage
+// of an opaque color.
+static inline bool is_solid_a8_run(const uint8_t* mask, bool opaqueColor) {
+    uint64_t bytes = load_8_bytes(mask);
+    return 0 == bytes || (opaqueColor && ~0ULL == bytes);
+}
+
+/** Blits an A8 mask a span at a time: runs of 0 coverage are skipped, runs of 0xFF coverage of an
+    opaque color are filled, and only the spans in between go through proc. Every proc gives
+    exactly dst for 0 coverage, and exactly the color for full coverage of an opaque color, so
+    this draws the same pixels as calling proc on the whole mask.
+ */
+static void blit_a8_spans(SkBlitMask::ColorProc proc, SkPMColor* dst, size_t dstRB,
+                          const uint8_t* mask, size_t maskRB, SkColor color,
+                          int width, int height) {
+    const bool opaqueColor = 0xFF == SkColorGetA(color);
+    const SkPMColor pmc = SkPreMultiplyColor(color);
+    do {
+        int x = 0;
+        while (x < width) {
+            const uint8_t aa = mask[x];
+            if (0 == aa) {
+                x += a8_run_length(mask + x, width - x, 0);
+                continue;
+            }
+            if (0xFF == aa && opaqueColor) {
+                int n = a8_run_length(mask + x, width - x, 0xFF);
+                sk_memset32(dst + x, pmc, n);
+                x += n;
+                continue;
+            }
+            const int start = x;
+            x += 1;
+            while (x < width &&
+                   !(x + kMinSolidA8Run <= width && is_solid_a8_run(mask + x, opaqueColor))) {
+                x += 1;
+            }
+            proc(dst + start, dstRB, mask + start, maskRB, color, x - start, 1);
+        }
+        dst = (SkPMColor*)((char*)dst + dstRB);
+        mask += maskRB;
+    } while (--height != 0);
+}
+
 bool SkBlitMask::BlitColor(const SkBitmap& device, const SkMask& mask,
                            const SkIRect& clip, SkColor color) {
     ColorProc proc = ColorFactory(device.colorType(), mask.fFormat, color);
     if (proc) {
         int x = clip.fLeft;
         int y = clip.fTop;
+        if (SkMask::kA8_Format == mask.fFormat && kN32_SkColorType == device.colorType()) {
+            blit_a8_spans(proc, device.getAddr32(x, y), device.rowBytes(), mask.getAddr8(x, y),
+                          mask.fRowBytes, color, clip.width(), clip.height());
+            return true;
+        }
         proc(device.getAddr32(x, y), device.rowBytes(), mask.getAddr(x, y),
              mask.fRowBytes, color, clip.width(), clip.height());
         return true;
@@ -890,8 +890,13 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
         p->setColor(0);
     }
 
+    // The float pipeline blends everything it draws, so it wants a shader even for a plain color.
+    const bool floatPipeline = paint->isFloatPipeline() &&
+                               kN32_SkColorType == device.colorType() && !drawCoverage &&
+                               SkARGB32_Float_Blitter::Supports(*paint);
+
     if (NULL == shader) {
-        if (mode) {
+        if (mode || floatPipeline) {
             // xfermodes (and filters) require shaders for our current blitters
             shader = SkNEW_ARGS(SkColorShader, (paint->getColor()));
             paint.writable()->setShader(shader)->unref();
@@ -955,7 +960,11 @@ SkBlitter* SkBlitter::Choose(const SkBitmap& device,
             break;
 
         case kN32_SkColorType:
-            if (shader) {
+            if (floatPipeline) {
+                SkASSERT(shader);
+                blitter = allocator->createT<SkARGB32_Float_Blitter>(
+                        device, *paint, shaderContext);
+            } else if (shader) {
                 blitter = allocator->createT<SkARGB32_Shader_Blitter>(
                         device, *paint, shaderContext);
             } else if (paint->getColor() == SK_ColorBLACK) {
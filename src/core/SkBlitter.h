@@ -12,6 +12,7 @@
 
 #include "SkBitmap.h"
 #include "SkBitmapProcShader.h"
+#include "SkDrawArena.h"
 #include "SkMask.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
@@ -79,11 +80,12 @@ public:
     /**
      * This function allocates memory for the blitter that the blitter then owns.
      * The memory can be used by the calling function at will, but it will be
-     * released when the blitter's destructor is called. This function returns
+     * released when the blitter's destructor is called, or when the enclosing
+     * SkDrawArena::AutoScope ends, whichever is later. This function returns
      * NULL if no persistent memory is needed by the blitter.
      */
     virtual void* allocBlitMemory(size_t sz) {
-        return fBlitMemory.reset(sz, SkAutoMalloc::kReuse_OnShrink);
+        return SkDrawArena::Alloc(sz, &fBlitMemory);
     }
 
     ///@name non-virtual helpers
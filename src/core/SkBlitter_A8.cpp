@@ -237,13 +237,13 @@ SkA8_Shader_Blitter::SkA8_Shader_Blitter(const SkBitmap& device, const SkPaint&
     }
 
     int width = device.width();
-    fBuffer = (SkPMColor*)sk_malloc_throw(sizeof(SkPMColor) * (width + (SkAlign4(width) >> 2)));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(sizeof(SkPMColor) * (width + (SkAlign4(width) >> 2)),
+                                             &fBufferStorage);
     fAAExpand = (uint8_t*)(fBuffer + width);
 }
 
 SkA8_Shader_Blitter::~SkA8_Shader_Blitter() {
     if (fXfermode) SkSafeUnref(fXfermode);
-    sk_free(fBuffer);
 }
 
 void SkA8_Shader_Blitter::blitH(int x, int y, int width) {
@@ -273,7 +273,7 @@ SkARGB32_Shader_Blitter::SkARGB32_Shader_Blitter(const SkBitmap& device,
         const SkPaint& paint, SkShader::Context* shaderContext)
     : INHERITED(device, paint, shaderContext)
 {
-    fBuffer = (SkPMColor*)sk_malloc_throw(device.width() * (sizeof(SkPMColor)));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(device.width() * sizeof(SkPMColor), &fBufferStorage);
 
     fXfermode = paint.getXfermode();
     SkSafeRef(fXfermode);
@@ -307,7 +307,6 @@ SkARGB32_Shader_Blitter::SkARGB32_Shader_Blitter(const SkBitmap& device,
 
 SkARGB32_Shader_Blitter::~SkARGB32_Shader_Blitter() {
     SkSafeUnref(fXfermode);
-    sk_free(fBuffer);
 }
 
 void SkARGB32_Shader_Blitter::blitH(int x, int y, int width) {
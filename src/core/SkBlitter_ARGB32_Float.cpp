@@ -0,0 +1,230 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCoreBlitters.h"
+#include "SkPMFloat.h"
+#include "SkXfermode.h"
+
+// Each mode computes its result from premultiplied s and d, with components in [0, 255].
+// sa and da hold the source and destination alpha in every lane.
+
+static const float kInv255 = 1.0f / 255;
+
+static inline Sk4f inv(const Sk4f& alpha) { return Sk4f(1) - alpha * Sk4f(kInv255); }
+static inline Sk4f mul(const Sk4f& a, const Sk4f& b) { return a * b * Sk4f(kInv255); }
+
+// Has 1 in the alpha lane and 0 elsewhere.  The separable modes below compute their color
+// channels with a formula that is wrong for alpha; this lets them patch alpha back up.
+static inline Sk4f alpha_lane() { return SkPMFloat::FromARGB(1, 0, 0, 0); }
+
+#define FLOAT_MODE(Name, expr)                                                             \
+    struct Name {                                                                          \
+        static Sk4f Xfer(const Sk4f& s, const Sk4f& d, const Sk4f& sa, const Sk4f& da) { \
+            return expr;                                                                   \
+        }                                                                                  \
+    }
+
+FLOAT_MODE(Clear,    Sk4f(0));
+FLOAT_MODE(Src,      s);
+FLOAT_MODE(Dst,      d);
+FLOAT_MODE(SrcOver,  s + d * inv(sa));
+FLOAT_MODE(DstOver,  d + s * inv(da));
+FLOAT_MODE(SrcIn,    mul(s, da));
+FLOAT_MODE(DstIn,    mul(d, sa));
+FLOAT_MODE(SrcOut,   s * inv(da));
+FLOAT_MODE(DstOut,   d * inv(sa));
+FLOAT_MODE(SrcATop,  mul(s, da) + d * inv(sa));
+FLOAT_MODE(DstATop,  mul(d, sa) + s * inv(da));
+FLOAT_MODE(Xor,      s * inv(da) + d * inv(sa));
+FLOAT_MODE(Plus,     Sk4f::Min(s + d, Sk4f(255)));
+FLOAT_MODE(Modulate, mul(s, d));
+FLOAT_MODE(Screen,   s + d - mul(s, d));
+FLOAT_MODE(Multiply, s * inv(da) + d * inv(sa) + mul(s, d));
+FLOAT_MODE(Darken,   s + d - Sk4f::Max(mul(s, da), mul(d, sa)));
+FLOAT_MODE(Lighten,  s + d - Sk4f::Min(mul(s, da), mul(d, sa)));
+FLOAT_MODE(Difference,
+           s + d - Sk4f::Min(mul(s, da), mul(d, sa)) * (Sk4f(2) - alpha_lane()));
+FLOAT_MODE(Exclusion,
+           s + d - mul(s, d) * (Sk4f(2) - alpha_lane()));
+
+#undef FLOAT_MODE
+
+template <typename Mode>
+static inline Sk4f blend(const SkPMFloat& s, const SkPMFloat& d, const Sk4f& coverage) {
+    Sk4f r = Mode::Xfer(s, d, Sk4f(s.a()), Sk4f(d.a()));
+    return Sk4f(d) + (r - d) * coverage;
+}
+
+template <typename Mode>
+static void float_proc(SkPMColor dst[], const SkPMColor src[], int count,
+                       const SkAlpha aa[], float coverage) {
+    const Sk4f uniform(coverage);
+    const Sk4f k(kInv255);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        SkPMFloat s0, s1, s2, s3, d0, d1, d2, d3;
+        SkPMFloat::From4PMColors(src + i, &s0, &s1, &s2, &s3);
+        SkPMFloat::From4PMColors(dst + i, &d0, &d1, &d2, &d3);
+
+        Sk4f c0 = uniform, c1 = uniform, c2 = uniform, c3 = uniform;
+        if (aa) {
+            c0 = Sk4f(aa[i + 0]) * k;
+            c1 = Sk4f(aa[i + 1]) * k;
+            c2 = Sk4f(aa[i + 2]) * k;
+            c3 = Sk4f(aa[i + 3]) * k;
+        }
+        SkPMFloat::ClampTo4PMColors(blend<Mode>(s0, d0, c0), blend<Mode>(s1, d1, c1),
+                                    blend<Mode>(s2, d2, c2), blend<Mode>(s3, d3, c3), dst + i);
+    }
+    for (; i < count; ++i) {
+        Sk4f c = aa ? Sk4f(aa[i]) * k : uniform;
+        dst[i] = SkPMFloat(blend<Mode>(SkPMFloat(src[i]), SkPMFloat(dst[i]), c)).clamped();
+    }
+}
+
+static SkARGB32_Float_Blitter::Proc find_proc(const SkXfermode* xfer) {
+    SkXfermode::Mode mode;
+    if (!SkXfermode::AsMode(xfer, &mode)) {
+        return NULL;
+    }
+    switch (mode) {
+        case SkXfermode::kClear_Mode:      return float_proc<Clear>;
+        case SkXfermode::kSrc_Mode:        return float_proc<Src>;
+        case SkXfermode::kDst_Mode:        return float_proc<Dst>;
+        case SkXfermode::kSrcOver_Mode:    return float_proc<SrcOver>;
+        case SkXfermode::kDstOver_Mode:    return float_proc<DstOver>;
+        case SkXfermode::kSrcIn_Mode:      return float_proc<SrcIn>;
+        case SkXfermode::kDstIn_Mode:      return float_proc<DstIn>;
+        case SkXfermode::kSrcOut_Mode:     return float_proc<SrcOut>;
+        case SkXfermode::kDstOut_Mode:     return float_proc<DstOut>;
+        case SkXfermode::kSrcATop_Mode:    return float_proc<SrcATop>;
+        case SkXfermode::kDstATop_Mode:    return float_proc<DstATop>;
+        case SkXfermode::kXor_Mode:        return float_proc<Xor>;
+        case SkXfermode::kPlus_Mode:       return float_proc<Plus>;
+        case SkXfermode::kModulate_Mode:   return float_proc<Modulate>;
+        case SkXfermode::kScreen_Mode:     return float_proc<Screen>;
+        case SkXfermode::kMultiply_Mode:   return float_proc<Multiply>;
+        case SkXfermode::kDarken_Mode:     return float_proc<Darken>;
+        case SkXfermode::kLighten_Mode:    return float_proc<Lighten>;
+        case SkXfermode::kDifference_Mode: return float_proc<Difference>;
+        case SkXfermode::kExclusion_Mode:  return float_proc<Exclusion>;
+        default:                           return NULL;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SkARGB32_Float_Blitter::Supports(const SkPaint& paint) {
+    return find_proc(paint.getXfermode()) != NULL;
+}
+
+SkARGB32_Float_Blitter::SkARGB32_Float_Blitter(const SkBitmap& device, const SkPaint& paint,
+                                               SkShader::Context* shaderContext)
+    : INHERITED(device, paint, shaderContext) {
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(device.width() * sizeof(SkPMColor), &fBufferStorage);
+    fProc = find_proc(paint.getXfermode());
+    SkASSERT(fProc);
+    fConstInY = SkToBool(shaderContext->getFlags() & SkShader::kConstInY32_Flag);
+}
+
+SkARGB32_Float_Blitter::~SkARGB32_Float_Blitter() {}
+
+void SkARGB32_Float_Blitter::blitH(int x, int y, int width) {
+    SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
+
+    fShaderContext->shadeSpan(x, y, fBuffer, width);
+    fProc(fDevice.getAddr32(x, y), fBuffer, width, NULL, 1);
+}
+
+void SkARGB32_Float_Blitter::blitRect(int x, int y, int width, int height) {
+    SkASSERT(x >= 0 && y >= 0 &&
+             x + width <= fDevice.width() && y + height <= fDevice.height());
+
+    uint32_t*   device = fDevice.getAddr32(x, y);
+    size_t      deviceRB = fDevice.rowBytes();
+
+    if (fConstInY) {
+        fShaderContext->shadeSpan(x, y, fBuffer, width);
+    }
+    do {
+        if (!fConstInY) {
+            fShaderContext->shadeSpan(x, y, fBuffer, width);
+        }
+        fProc(device, fBuffer, width, NULL, 1);
+        y += 1;
+        device = (uint32_t*)((char*)device + deviceRB);
+    } while (--height > 0);
+}
+
+void SkARGB32_Float_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
+                                       const int16_t runs[]) {
+    uint32_t* device = fDevice.getAddr32(x, y);
+
+    for (;;) {
+        int count = *runs;
+        if (count <= 0) {
+            break;
+        }
+        int aa = *antialias;
+        if (aa) {
+            fShaderContext->shadeSpan(x, y, fBuffer, count);
+            fProc(device, fBuffer, count, NULL, aa * kInv255);
+        }
+        device += count;
+        runs += count;
+        antialias += count;
+        x += count;
+    }
+}
+
+void SkARGB32_Float_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
+    if (SkMask::kA8_Format != mask.fFormat) {
+        this->INHERITED::blitMask(mask, clip);
+        return;
+    }
+
+    SkASSERT(mask.fBounds.contains(clip));
+
+    const int x = clip.fLeft;
+    const int width = clip.width();
+    int y = clip.fTop;
+    int height = clip.height();
+
+    char* dstRow = (char*)fDevice.getAddr32(x, y);
+    const size_t dstRB = fDevice.rowBytes();
+    const uint8_t* maskRow = (const uint8_t*)mask.getAddr(x, y);
+    const size_t maskRB = mask.fRowBytes;
+
+    do {
+        fShaderContext->shadeSpan(x, y, fBuffer, width);
+        fProc((SkPMColor*)dstRow, fBuffer, width, maskRow, 1);
+        dstRow += dstRB;
+        maskRow += maskRB;
+        y += 1;
+    } while (--height > 0);
+}
+
+void SkARGB32_Float_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
+    SkASSERT(x >= 0 && y >= 0 && y + height <= fDevice.height());
+
+    uint32_t*   device = fDevice.getAddr32(x, y);
+    size_t      deviceRB = fDevice.rowBytes();
+    SkPMColor   c;
+
+    if (fConstInY) {
+        fShaderContext->shadeSpan(x, y, &c, 1);
+    }
+    do {
+        if (!fConstInY) {
+            fShaderContext->shadeSpan(x, y, &c, 1);
+        }
+        fProc(device, &c, 1, NULL, alpha * kInv255);
+        y += 1;
+        device = (uint32_t*)((char*)device + deviceRB);
+    } while (--height > 0);
+}
@@ -54,6 +54,67 @@ void sk_dither_memset16(uint16_t dst[], uint16_t value, uint16_t other,
     }
 }
 
+#if SK_ARM_NEON_IS_ALWAYS && defined(SK_CPU_LENDIAN)
+// Blends 8 pixels toward the expanded color, each as
+//     SkCompact_rgb_16((color32 * scale + SkExpand_rgb_16(dst) * (32 - scale)) >> 5)
+// with the 5-bit scales of the first and last 4 pixels in scale_lo and scale_hi.
+static inline void blend_8_pixels_neon(uint16_t* SK_RESTRICT device, uint32x4_t color32,
+                                       uint32x4_t scale_lo, uint32x4_t scale_hi) {
+    const uint32x4_t vmask_g16 = vdupq_n_u32(SK_G16_MASK_IN_PLACE);
+    const uint32x4_t vmask_ng16 = vdupq_n_u32(~SK_G16_MASK_IN_PLACE);
+    const uint32x4_t v32 = vdupq_n_u32(32);
+
+    // load pixels
+    uint16x8_t vdev = vld1q_u16(device);
+    uint32x4_t dev_lo = vmovl_u16(vget_low_u16(vdev));
+    uint32x4_t dev_hi = vmovl_u16(vget_high_u16(vdev));
+
+    // unpack them in 32 bits
+    dev_lo = vorrq_u32(vandq_u32(dev_lo, vmask_ng16),
+                       vshlq_n_u32(vandq_u32(dev_lo, vmask_g16), 16));
+    dev_hi = vorrq_u32(vandq_u32(dev_hi, vmask_ng16),
+                       vshlq_n_u32(vandq_u32(dev_hi, vmask_g16), 16));
+
+    // blend with color
+    dev_lo = vmlaq_u32(vmulq_u32(color32, scale_lo), dev_lo, vsubq_u32(v32, scale_lo));
+    dev_hi = vmlaq_u32(vmulq_u32(color32, scale_hi), dev_hi, vsubq_u32(v32, scale_hi));
+    dev_lo = vshrq_n_u32(dev_lo, 5);
+    dev_hi = vshrq_n_u32(dev_hi, 5);
+
+    // re-compact
+    uint16x4_t odev_lo = vmovn_u32(vorrq_u32(vandq_u32(dev_lo, vmask_ng16),
+                                             vandq_u32(vshrq_n_u32(dev_lo, 16), vmask_g16)));
+    uint16x4_t odev_hi = vmovn_u32(vorrq_u32(vandq_u32(dev_hi, vmask_ng16),
+                                             vandq_u32(vshrq_n_u32(dev_hi, 16), vmask_g16)));
+
+    // store
+    vst1q_u16(device, vcombine_u16(odev_lo, odev_hi));
+}
+#endif
+
+// Blends count pixels toward the expanded color by the same 5-bit scale.
+static void blend_row_rgb16(uint16_t* SK_RESTRICT device, uint32_t srcExpanded,
+                            unsigned scale5, int count) {
+#if SK_ARM_NEON_IS_ALWAYS && defined(SK_CPU_LENDIAN)
+    if (count >= 8) {
+        const uint32x4_t color = vdupq_n_u32(srcExpanded);
+        const uint32x4_t scale = vdupq_n_u32(scale5);
+        do {
+            blend_8_pixels_neon(device, color, scale, scale);
+            device += 8;
+            count -= 8;
+        } while (count >= 8);
+    }
+#endif
+    uint32_t src32 = srcExpanded * scale5;
+    scale5 = 32 - scale5;
+    while (count > 0) {
+        uint32_t dst32 = SkExpand_rgb_16(*device) * scale5;
+        *device++ = SkCompact_rgb_16((src32 + dst32) >> 5);
+        --count;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkRGB16_Blitter : public SkRasterBlitter {
@@ -124,6 +185,7 @@ public:
     void blitRect(int x, int y, int width, int height) override;
 
 protected:
+    SkAutoMalloc        fBufferStorage;  // Only used outside of an SkDrawArena::AutoScope.
     SkPMColor*          fBuffer;
     SkBlitRow::Proc16   fOpaqueProc;
     SkBlitRow::Proc16   fAlphaProc;
@@ -159,9 +221,10 @@ public:
                            const int16_t* runs) override;
 
 private:
-    SkXfermode* fXfermode;
-    SkPMColor*  fBuffer;
-    uint8_t*    fAAExpand;
+    SkXfermode*  fXfermode;
+    SkAutoMalloc fBufferStorage;  // Only used outside of an SkDrawArena::AutoScope.
+    SkPMColor*   fBuffer;
+    uint8_t*     fAAExpand;
 
     // illegal
     SkRGB16_Shader_Xfermode_Blitter& operator=(const SkRGB16_Shader_Xfermode_Blitter&);
@@ -336,20 +399,11 @@ void SkRGB16_Opaque_Blitter::blitAntiH(int x, int y,
                 }
             } else {
                 // TODO: respect fDoDither
-                unsigned scale5 = SkAlpha255To256(aa) >> 3;
-                uint32_t src32 = srcExpanded * scale5;
-                scale5 = 32 - scale5; // now we can use it on the device
-                int n = count;
-                do {
-                    uint32_t dst32 = SkExpand_rgb_16(*device) * scale5;
-                    *device++ = SkCompact_rgb_16((src32 + dst32) >> 5);
-                } while (--n != 0);
-                goto DONE;
+                blend_row_rgb16(device, srcExpanded, SkAlpha255To256(aa) >> 3, count);
             }
         }
         device += count;
 
-    DONE:
         // if we have no dithering, this will always fail
         if (count & ditherInt) {
             SkTSwap(ditherColor, srcColor);
@@ -596,14 +650,7 @@ void SkRGB16_Blitter::blitAntiH(int x, int y,
         unsigned aa = antialias[0];
         antialias += count;
         if (aa) {
-            unsigned scale5 = SkAlpha255To256(aa) * scale >> (8 + 3);
-            uint32_t src32 =  srcExpanded * scale5;
-            scale5 = 32 - scale5;
-            do {
-                uint32_t dst32 = SkExpand_rgb_16(*device) * scale5;
-                *device++ = SkCompact_rgb_16((src32 + dst32) >> 5);
-            } while (--count != 0);
-            continue;
+            blend_row_rgb16(device, srcExpanded, SkAlpha255To256(aa) * scale >> (8 + 3), count);
         }
         device += count;
     }
@@ -646,13 +693,30 @@ void SkRGB16_Blitter::blitMask(const SkMask& mask,
     unsigned scale256 = fScale;
     do {
         int w = width;
-        do {
+#if SK_ARM_NEON_IS_ALWAYS && defined(SK_CPU_LENDIAN)
+        if (w >= 8) {
+            // the color isn't opaque, so (aa + 1) * scale256 fits in 16 bits
+            SkASSERT(scale256 < 256);
+            const uint32x4_t color = vdupq_n_u32(color32);
+            do {
+                uint16x8_t vscale = vaddw_u8(vdupq_n_u16(1), vld1_u8(alpha));
+                vscale = vshrq_n_u16(vmulq_n_u16(vscale, scale256), 8 + 3);
+                blend_8_pixels_neon(device, color, vmovl_u16(vget_low_u16(vscale)),
+                                    vmovl_u16(vget_high_u16(vscale)));
+                device += 8;
+                alpha += 8;
+                w -= 8;
+            } while (w >= 8);
+        }
+#endif
+        while (w > 0) {
             unsigned aa = *alpha++;
             unsigned scale = SkAlpha255To256(aa) * scale256 >> (8 + 3);
             uint32_t src32 = color32 * scale;
             uint32_t dst32 = SkExpand_rgb_16(*device) * (32 - scale);
             *device++ = SkCompact_rgb_16((src32 + dst32) >> 5);
-        } while (--w != 0);
+            --w;
+        }
         device = (uint16_t*)((char*)device + deviceRB);
         alpha += maskRB;
     } while (--height != 0);
@@ -816,7 +880,8 @@ SkRGB16_Shader_Blitter::SkRGB16_Shader_Blitter(const SkBitmap& device,
 : INHERITED(device, paint, shaderContext) {
     SkASSERT(paint.getXfermode() == NULL);
 
-    fBuffer = (SkPMColor*)sk_malloc_throw(device.width() * sizeof(SkPMColor));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc(device.width() * sizeof(SkPMColor),
+                                             &fBufferStorage);
 
     // compute SkBlitRow::Procs
     unsigned flags = 0;
@@ -836,9 +901,7 @@ SkRGB16_Shader_Blitter::SkRGB16_Shader_Blitter(const SkBitmap& device,
     fAlphaProc  = SkBlitRow::Factory16(flags | SkBlitRow::kGlobalAlpha_Flag);
 }
 
-SkRGB16_Shader_Blitter::~SkRGB16_Shader_Blitter() {
-    sk_free(fBuffer);
-}
+SkRGB16_Shader_Blitter::~SkRGB16_Shader_Blitter() {}
 
 void SkRGB16_Shader_Blitter::blitH(int x, int y, int width) {
     SkASSERT(x + width <= fDevice.width());
@@ -945,13 +1008,13 @@ SkRGB16_Shader_Xfermode_Blitter::SkRGB16_Shader_Xfermode_Blitter(
     fXfermode->ref();
 
     int width = device.width();
-    fBuffer = (SkPMColor*)sk_malloc_throw((width + (SkAlign4(width) >> 2)) * sizeof(SkPMColor));
+    fBuffer = (SkPMColor*)SkDrawArena::Alloc((width + (SkAlign4(width) >> 2)) * sizeof(SkPMColor),
+                                             &fBufferStorage);
     fAAExpand = (uint8_t*)(fBuffer + width);
 }
 
 SkRGB16_Shader_Xfermode_Blitter::~SkRGB16_Shader_Xfermode_Blitter() {
     fXfermode->unref();
-    sk_free(fBuffer);
 }
 
 void SkRGB16_Shader_Xfermode_Blitter::blitH(int x, int y, int width) {
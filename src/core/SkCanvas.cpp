@@ -8,14 +8,17 @@
 #include "SkCanvas.h"
 #include "SkCanvasPriv.h"
 #include "SkBitmapDevice.h"
+#include "SkColorFilter.h"
 #include "SkDeviceImageFilterProxy.h"
 #include "SkDraw.h"
+#include "SkDrawArena.h"
 #include "SkDrawable.h"
 #include "SkDrawFilter.h"
 #include "SkDrawLooper.h"
 #include "SkErrorInternals.h"
 #include "SkImage.h"
 #include "SkMetaData.h"
+#include "SkNx.h"
 #include "SkPathOps.h"
 #include "SkPatchUtils.h"
 #include "SkPicture.h"
@@ -27,6 +30,7 @@
 #include "SkTemplates.h"
 #include "SkTextBlob.h"
 #include "SkTextFormatParams.h"
+#include "SkTextRunCache.h"
 #include "SkTLazy.h"
 #include "SkTraceEvent.h"
 #include "SkUtils.h"
@@ -283,21 +287,58 @@ private:
 
 /////////////////////////////////////////////////////////////////////////////
 
+/**
+ *  If the paint's image filter is just a color filter, and drawing with the two color filters
+ *  composed gives what drawing into a layer and filtering that does, returns the composition
+ *  (which the caller must unref()). Otherwise returns NULL.
+ */
+static SkColorFilter* image_to_color_filter(const SkPaint& paint) {
+    SkImageFilter* imgf = paint.getImageFilter();
+    SkColorFilter* imgCF;
+    // A looper could replace the color filter on some of its draws.
+    if (NULL == imgf || paint.getLooper() || !imgf->asAColorFilter(&imgCF)) {
+        return NULL;
+    }
+    SkAutoUnref autoUnref(imgCF);
+    // The layer is composited with srcover, and the filter runs over all of it, so it may not
+    // make the transparent pixels around the draw visible.
+    if (!SkXfermode::IsMode(paint.getXfermode(), SkXfermode::kSrcOver_Mode) ||
+        0 != SkColorGetA(imgCF->filterColor(SK_ColorTRANSPARENT))) {
+        return NULL;
+    }
+    SkColorFilter* paintCF = paint.getColorFilter();
+    if (NULL == paintCF) {
+        return SkRef(imgCF);
+    }
+    return SkColorFilter::CreateComposeFilter(imgCF, paintCF);
+}
+
 class AutoDrawLooper {
 public:
     AutoDrawLooper(SkCanvas* canvas, const SkSurfaceProps& props, const SkPaint& paint,
                    bool skipLayerForImageFilter = false,
-                   const SkRect* bounds = NULL) : fOrigPaint(paint) {
+                   const SkRect* bounds = NULL) : fOrigPaint(&paint) {
         fCanvas = canvas;
         fFilter = canvas->getDrawFilter();
-        fPaint = &fOrigPaint;
+        fPaint = fOrigPaint;
         fSaveCount = canvas->getSaveCount();
         fDoClearImageFilter = false;
         fDone = false;
 
-        if (!skipLayerForImageFilter && fOrigPaint.getImageFilter()) {
+        if (!skipLayerForImageFilter) {
+            // Apply a color filter node straight to the draw, rather than to a layer.
+            SkAutoTUnref<SkColorFilter> simplifiedCF(image_to_color_filter(paint));
+            if (simplifiedCF) {
+                SkPaint* simplified = fLazyPaintInit.set(paint);
+                simplified->setColorFilter(simplifiedCF);
+                simplified->setImageFilter(NULL);
+                fOrigPaint = fPaint = simplified;
+            }
+        }
+
+        if (!skipLayerForImageFilter && fOrigPaint->getImageFilter()) {
             SkPaint tmp;
-            tmp.setImageFilter(fOrigPaint.getImageFilter());
+            tmp.setImageFilter(fOrigPaint->getImageFilter());
             (void)canvas->internalSaveLayer(bounds, &tmp, SkCanvas::kARGB_ClipLayer_SaveFlag,
                                             SkCanvas::kFullLayer_SaveLayerStrategy);
             // we'll clear the imageFilter for the actual draws in next(), so
@@ -319,7 +360,7 @@ public:
         uint32_t oldFlags = paint.getFlags();
         fNewPaintFlags = filter_paint_flags(props, oldFlags);
         if (fIsSimple && (fNewPaintFlags != oldFlags)) {
-            SkPaint* paint = fLazyPaint.set(fOrigPaint);
+            SkPaint* paint = fLazyPaint.set(*fOrigPaint);
             paint->setFlags(fNewPaintFlags);
             fPaint = paint;
             // if we're not simple, doNext() will take care of calling setFlags()
@@ -350,9 +391,12 @@ public:
     }
 
 private:
+    // First, so the scratch memory of everything drawn through us outlives the rest of us.
+    SkDrawArena::AutoScope fArenaScope;
+    SkLazyPaint     fLazyPaintInit; // the paint, with its image filter folded into a color filter
     SkLazyPaint     fLazyPaint;
     SkCanvas*       fCanvas;
-    const SkPaint&  fOrigPaint;
+    const SkPaint*  fOrigPaint;
     SkDrawFilter*   fFilter;
     const SkPaint*  fPaint;
     int             fSaveCount;
@@ -371,7 +415,7 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
     SkASSERT(!fIsSimple);
     SkASSERT(fLooperContext || fFilter || fDoClearImageFilter);
 
-    SkPaint* paint = fLazyPaint.set(fOrigPaint);
+    SkPaint* paint = fLazyPaint.set(*fOrigPaint);
     paint->setFlags(fNewPaintFlags);
 
     if (fDoClearImageFilter) {
@@ -407,16 +451,35 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
     return true;
 }
 
+void SkCanvas::predrawNotify(const SkRect* bounds) {
+    if (fSurfaceBase) {
+        SkIRect devBounds = fMCRec->fRasterClip.getBounds();
+        // Perspective can map bounds that cross the eye plane too tightly, so don't trust them.
+        if (bounds && !fMCRec->fMatrix.hasPerspective()) {
+            SkRect devRect;
+            fMCRec->fMatrix.mapRect(&devRect, *bounds);
+            SkIRect devIRect;
+            devRect.roundOut(&devIRect);
+            // Leave room for antialiasing.
+            devIRect.outset(1, 1);
+            if (!devBounds.intersect(devIRect)) {
+                devBounds.setEmpty();
+            }
+        }
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode, &devBounds);
+    }
+}
+
 ////////// macros to place around the internal draw calls //////////////////
 
 #define LOOPER_BEGIN_DRAWDEVICE(paint, type)                        \
-    this->predrawNotify();                                          \
+    this->predrawNotify(NULL);                                      \
     AutoDrawLooper  looper(this, fProps, paint, true);              \
     while (looper.next(type)) {                                     \
         SkDrawIter          iter(this);
 
 #define LOOPER_BEGIN(paint, type, bounds)                           \
-    this->predrawNotify();                                          \
+    this->predrawNotify(bounds);                                    \
     AutoDrawLooper  looper(this, fProps, paint, false, bounds);     \
     while (looper.next(type)) {                                     \
         SkDrawIter          iter(this);
@@ -1485,7 +1548,26 @@ bool SkCanvas::quickReject(const SkRect& rect) const {
         return true;
     }
 
-    if (fMCRec->fMatrix.hasPerspective()) {
+    const SkMatrix& matrix = fMCRec->fMatrix;
+    if (matrix.isScaleTranslate() && 0 != matrix.getScaleX() && 0 != matrix.getScaleY()) {
+        // Map the rect into device space and test it against the device clip bounds, which the
+        // raster clip keeps up to date, rather than inverting the matrix after every translate
+        // or restore to get local clip bounds.
+        const Sk2s scale(matrix.getScaleX(), matrix.getScaleY()),
+                   trans(matrix.getTranslateX(), matrix.getTranslateY());
+        Sk2s lt = Sk2s::Load(&rect.fLeft)  * scale + trans,
+             rb = Sk2s::Load(&rect.fRight) * scale + trans;
+        Sk2s devMin = Sk2s::Min(lt, rb),
+             devMax = Sk2s::Max(lt, rb);
+
+        // adjust the clip outwards in case we are antialiasing, as getClipBounds() does
+        const SkIRect& clipR = fMCRec->fRasterClip.getBounds();
+        Sk2s clipMin(SkIntToScalar(clipR.fLeft - 1),  SkIntToScalar(clipR.fTop - 1)),
+             clipMax(SkIntToScalar(clipR.fRight + 1), SkIntToScalar(clipR.fBottom + 1));
+        return (devMin >= clipMax).anyTrue() || (devMax <= clipMin).anyTrue();
+    }
+
+    if (matrix.hasPerspective()) {
         SkRect dst;
         fMCRec->fMatrix.mapRect(&dst, rect);
         return !SkIRect::Intersects(dst.roundOut(), fMCRec->fRasterClip.getBounds());
@@ -1609,6 +1691,12 @@ void SkCanvas::drawRect(const SkRect& r, const SkPaint& paint) {
     this->onDrawRect(r, paint);
 }
 
+void SkCanvas::drawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    if (count > 0) {
+        this->onDrawRects(rects, count, paint);
+    }
+}
+
 void SkCanvas::drawOval(const SkRect& r, const SkPaint& paint) {
     this->onDrawOval(r, paint);
 }
@@ -1742,6 +1830,39 @@ void SkCanvas::onDrawRect(const SkRect& r, const SkPaint& paint) {
     LOOPER_END
 }
 
+void SkCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::drawRects()");
+    SkRect storage;
+    const SkRect* bounds = NULL;
+    if (paint.canComputeFastBounds()) {
+        // As in onDrawRect, sort before looking at the bounds. Empty rects can still draw
+        // (e.g. when stroked), so they must contribute too; SkRect::join() would skip them.
+        SkRect unionRect(rects[0]);
+        unionRect.sort();
+        for (int i = 1; i < count; ++i) {
+            SkRect tmp(rects[i]);
+            tmp.sort();
+            unionRect.set(SkTMin(unionRect.fLeft,   tmp.fLeft),
+                          SkTMin(unionRect.fTop,    tmp.fTop),
+                          SkTMax(unionRect.fRight,  tmp.fRight),
+                          SkTMax(unionRect.fBottom, tmp.fBottom));
+        }
+
+        bounds = &paint.computeFastBounds(unionRect, &storage);
+        if (this->quickReject(*bounds)) {
+            return;
+        }
+    }
+
+    LOOPER_BEGIN(paint, SkDrawFilter::kRect_Type, bounds)
+
+    while (iter.next()) {
+        iter.fDevice->drawRects(iter, rects, count, looper.paint());
+    }
+
+    LOOPER_END
+}
+
 void SkCanvas::onDrawOval(const SkRect& oval, const SkPaint& paint) {
     TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::drawOval()");
     SkRect storage;
@@ -2090,13 +2211,76 @@ void SkCanvas::DrawTextDecorations(const SkDraw& draw, const SkPaint& paint,
     }
 }
 
+// Returns true if paint's looper just draws a halo under the text, which devices can then draw
+// along with the text. Decorations would have to go between the two, so they rule it out.
+static bool get_text_halo(const SkPaint& paint, SkDrawLooper::HaloRec* halo) {
+    const uint32_t kDecorationFlags = SkPaint::kUnderlineText_Flag | SkPaint::kStrikeThruText_Flag;
+    return paint.getLooper() &&
+           SkPaint::kFill_Style == paint.getStyle() &&
+           !(paint.getFlags() & kDecorationFlags) &&
+           paint.getLooper()->asAHalo(halo);
+}
+
+void SkCanvas::internalDrawPosTextHalo(const void* text, size_t byteLength, const SkScalar pos[],
+                                       int scalarsPerPos, const SkPoint& offset,
+                                       const SkPaint& paint, SkScalar haloRadius,
+                                       SkColor haloColor) {
+    SkPaint textPaint(paint);
+    textPaint.setLooper(NULL);
+
+    LOOPER_BEGIN(textPaint, SkDrawFilter::kText_Type, NULL)
+
+    while (iter.next()) {
+        // This is the paint the looper's bottom layer would have drawn with.
+        SkPaint haloPaint(looper.paint());
+        haloPaint.setColor(haloColor);
+        haloPaint.setStyle(SkPaint::kStrokeAndFill_Style);
+        haloPaint.setStrokeWidth(2 * haloRadius);
+        haloPaint.setStrokeJoin(SkPaint::kRound_Join);
+
+        SkDeviceFilteredPaint haloDfp(iter.fDevice, haloPaint);
+        SkDeviceFilteredPaint dfp(iter.fDevice, looper.paint());
+        iter.fDevice->drawPosTextHalo(iter, text, byteLength, pos, scalarsPerPos, offset,
+                                      haloDfp.paint(), dfp.paint());
+    }
+
+    LOOPER_END
+}
+
 void SkCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
                           const SkPaint& paint) {
+    SkDrawLooper::HaloRec halo;
+    if (NULL == fMCRec->fFilter && get_text_halo(paint, &halo)) {
+        // Lay the text out once, for both the halo and the text.
+        SkAutoTUnref<const SkTextBlob> blob(SkTextRunCache::IsEnabled() ?
+                SkTextRunCache::FindOrCreate(text, byteLength, paint) :
+                SkTextRunCache::Create(text, byteLength, paint));
+        if (blob) {
+            SkTextBlob::RunIterator it(blob);
+            SkPaint glyphPaint(paint);
+            glyphPaint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+            glyphPaint.setTextAlign(SkPaint::kLeft_Align);
+            this->internalDrawPosTextHalo(it.glyphs(), it.glyphCount() * sizeof(uint16_t),
+                                          it.pos(), 1, SkPoint::Make(x, y + it.offset().y()),
+                                          glyphPaint, halo.fRadius, halo.fColor);
+            return;
+        }
+    }
+
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type, NULL)
 
     while (iter.next()) {
         SkDeviceFilteredPaint dfp(iter.fDevice, looper.paint());
-        iter.fDevice->drawText(iter, text, byteLength, x, y, dfp.paint());
+        SkAutoTUnref<const SkTextBlob> blob(SkTextRunCache::IsEnabled() ?
+                SkTextRunCache::FindOrCreate(text, byteLength, dfp.paint()) : NULL);
+        if (blob) {
+            // The blob already has the alignment applied to its positions.
+            SkPaint blobPaint(dfp.paint());
+            blobPaint.setTextAlign(SkPaint::kLeft_Align);
+            iter.fDevice->drawTextBlob(iter, blob, x, y, blobPaint, NULL);
+        } else {
+            iter.fDevice->drawText(iter, text, byteLength, x, y, dfp.paint());
+        }
         DrawTextDecorations(iter, dfp.paint(),
                             static_cast<const char*>(text), byteLength, x, y);
     }
@@ -2108,6 +2292,13 @@ void SkCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPoint
                              const SkPaint& paint) {
     SkPoint textOffset = SkPoint::Make(0, 0);
 
+    SkDrawLooper::HaloRec halo;
+    if (NULL == fMCRec->fFilter && get_text_halo(paint, &halo)) {
+        this->internalDrawPosTextHalo(text, byteLength, &pos->fX, 2, textOffset, paint,
+                                      halo.fRadius, halo.fColor);
+        return;
+    }
+
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type, NULL)
 
     while (iter.next()) {
@@ -2124,6 +2315,13 @@ void SkCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkScala
 
     SkPoint textOffset = SkPoint::Make(0, constY);
 
+    SkDrawLooper::HaloRec halo;
+    if (NULL == fMCRec->fFilter && get_text_halo(paint, &halo)) {
+        this->internalDrawPosTextHalo(text, byteLength, xpos, 1, textOffset, paint,
+                                      halo.fRadius, halo.fColor);
+        return;
+    }
+
     LOOPER_BEGIN(paint, SkDrawFilter::kText_Type, NULL)
 
     while (iter.next()) {
@@ -2409,6 +2607,20 @@ void SkCanvas::drawPicture(const SkPicture* picture, const SkMatrix* matrix, con
 
 void SkCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
                              const SkPaint* paint) {
+    // Reject a picture that's entirely clipped out once, rather than each of its ops.
+    if (!paint || paint->canComputeFastBounds()) {
+        SkRect bounds = picture->cullRect();
+        if (matrix) {
+            matrix->mapRect(&bounds);
+        }
+        if (paint) {
+            paint->computeFastBounds(bounds, &bounds);
+        }
+        if (this->quickReject(bounds)) {
+            return;
+        }
+    }
+
     SkBaseDevice* device = this->getTopDevice();
     if (device) {
         // Canvas has to first give the device the opportunity to render
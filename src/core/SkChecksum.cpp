@@ -0,0 +1,28 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkChecksum.h"
+#include "SkChecksum_opts.h"
+#include "SkLazyFnPtr.h"
+
+namespace {
+
+uint32_t murmur3(const void* data, size_t bytes, uint32_t seed) {
+    return SkChecksum::Murmur3(data, bytes, seed);
+}
+
+SkChecksumHashProc choose_fast_hash() {
+    SkChecksumHashProc proc = SkChecksumGetPlatformHashProc();
+    return proc ? proc : murmur3;
+}
+
+}  // namespace
+
+uint32_t SkChecksum::Fast(const void* data, size_t bytes, uint32_t seed) {
+    SK_DECLARE_STATIC_LAZY_FN_PTR(SkChecksumHashProc, proc, choose_fast_hash);
+    return proc.get()(data, bytes, seed);
+}
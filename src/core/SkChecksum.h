@@ -115,6 +115,22 @@ public:
         return Mix(hash);
     }
 
+    /**
+     * Calculate a 32-bit hash of any block of data, for keys that never leave the process: the
+     * glyph cache's descriptors, GPU resource keys, and the like.
+     *
+     * Where the CPU has CRC32C instructions (SSE4.2, or ARMv8 with the CRC extension) this is a
+     * hardware CRC32C followed by Mix, several times faster than Murmur3 on longer keys.
+     * Otherwise it is Murmur3.  Which one is chosen at run time, so the result may differ
+     * between machines and between builds; never store it or send it elsewhere.
+     *
+     *  @param data Memory address of the data block to be processed.
+     *  @param size Size of the data block in bytes.
+     *  @param seed Initial hash seed. (optional)
+     *  @return hash result
+     */
+    static uint32_t Fast(const void* data, size_t bytes, uint32_t seed=0);
+
     /**
      *  Compute a 32-bit checksum for a given data block
      *
@@ -48,8 +48,16 @@ public:
     }
     
     void filterSpan(const SkPMColor shader[], int count, SkPMColor result[]) const override {
-        fInner->filterSpan(shader, count, result);
-        fOuter->filterSpan(result, count, result);
+        // Run both filters a chunk at a time, so the inner filter's colors are still in cache
+        // when the outer filter reads them back.
+        while (count > 0) {
+            const int n = SkMin32(count, kChunk);
+            fInner->filterSpan(shader, n, result);
+            fOuter->filterSpan(result, n, result);
+            shader += n;
+            result += n;
+            count -= n;
+        }
     }
     
 #ifndef SK_IGNORE_TO_STRING
@@ -79,6 +87,10 @@ protected:
     }
     
 private:
+    enum {
+        kChunk = 256
+    };
+
     SkComposeColorFilter(SkColorFilter* outer, SkColorFilter* inner, int composedFilterCount)
         : fOuter(SkRef(outer))
         , fInner(SkRef(inner))
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkCompiledPicture.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+
+// Masks bigger than this are left to the scan converter: big shapes are mostly long spans,
+// which fill faster than a mask of the same area blits.
+static const int kMaxMaskArea = 256 * 256;
+
+namespace {
+
+// Visits each op of a record in order, tracking the record's CTM, and rasterizes the coverage
+// of each op it can into a Mask.
+class MaskCompiler : SkNoncopyable {
+public:
+    MaskCompiler(const SkMatrix& matrix, const SkIRect& clip,
+                 SkTArray<SkCompiledPicture::Mask>* masks)
+        : fMatrix(matrix)
+        , fCTM(matrix)
+        , fClip(clip)
+        , fMasks(masks)
+        , fOp(0) {}
+
+    void setCurrentOp(unsigned op) { fOp = op; }
+
+    template <typename T> void operator()(const T& op) {
+        this->updateCTM(op);
+        this->compile(op);
+    }
+
+private:
+    template <typename T> void updateCTM(const T&) {}
+    void updateCTM(const SkRecords::Restore& op)   { fCTM.setConcat(fMatrix, op.matrix); }
+    void updateCTM(const SkRecords::SetMatrix& op) { fCTM.setConcat(fMatrix, op.matrix); }
+
+    template <typename T> void compile(const T&) {}
+    void compile(const SkRecords::DrawPath& op) {
+        if (!op.path.isInverseFillType()) {
+            this->compile(op.paint, op.path.getBounds(), DrawPath(op.path));
+        }
+    }
+    void compile(const SkRecords::DrawOval& op) {
+        this->compile(op.paint, op.oval, DrawOval(op.oval));
+    }
+    void compile(const SkRecords::DrawRRect& op) {
+        this->compile(op.paint, op.rrect.rect(), DrawRRect(op.rrect));
+    }
+    void compile(const SkRecords::DrawDRRect& op) {
+        this->compile(op.paint, op.outer.rect(), DrawDRRect(op.outer, op.inner));
+    }
+
+    struct DrawPath {
+        explicit DrawPath(const SkPath& path) : fPath(path) {}
+        void operator()(SkCanvas* c, const SkPaint& p) const { c->drawPath(fPath, p); }
+        const SkPath& fPath;
+    };
+    struct DrawOval {
+        explicit DrawOval(const SkRect& oval) : fOval(oval) {}
+        void operator()(SkCanvas* c, const SkPaint& p) const { c->drawOval(fOval, p); }
+        const SkRect& fOval;
+    };
+    struct DrawRRect {
+        explicit DrawRRect(const SkRRect& rrect) : fRRect(rrect) {}
+        void operator()(SkCanvas* c, const SkPaint& p) const { c->drawRRect(fRRect, p); }
+        const SkRRect& fRRect;
+    };
+    struct DrawDRRect {
+        DrawDRRect(const SkRRect& outer, const SkRRect& inner) : fOuter(outer), fInner(inner) {}
+        void operator()(SkCanvas* c, const SkPaint& p) const { c->drawDRRect(fOuter, fInner, p); }
+        const SkRRect& fOuter;
+        const SkRRect& fInner;
+    };
+
+    // Coverage only depends on the geometry, the CTM, and the parts of the paint that shape it.
+    // Shaders, loopers and image filters all depend on more than that, so we leave them alone.
+    static bool CanCompile(const SkPaint& paint) {
+        return !paint.getShader()
+            && !paint.getLooper()
+            && !paint.getImageFilter()
+            && paint.canComputeFastBounds();
+    }
+
+    template <typename DrawFn>
+    void compile(const SkPaint& paint, const SkRect& geometryBounds, const DrawFn& draw) {
+        if (!CanCompile(paint) || fCTM.hasPerspective()) {
+            return;
+        }
+
+        SkRect storage, devBounds;
+        fCTM.mapRect(&devBounds, paint.computeFastBounds(geometryBounds, &storage));
+        SkIRect bounds;
+        devBounds.roundOut(&bounds);
+        bounds.outset(1, 1);    // Room for anti-aliasing.
+        if (!bounds.intersect(fClip) ||
+            (int64_t)bounds.width() * bounds.height() > kMaxMaskArea) {
+            return;
+        }
+
+        SkCompiledPicture::Mask& mask = fMasks->push_back();
+        mask.fOp = fOp;
+        mask.fOrigin.set(bounds.fLeft, bounds.fTop);
+        if (!mask.fAlpha.tryAllocPixels(SkImageInfo::MakeA8(bounds.width(), bounds.height()))) {
+            fMasks->pop_back();
+            return;
+        }
+        mask.fAlpha.eraseColor(SK_ColorTRANSPARENT);
+
+        // Everything that decides coverage stays on coverage; everything else moves to fPaint.
+        SkPaint coverage(paint);
+        coverage.setColor(SK_ColorBLACK);
+        coverage.setXfermode(NULL);
+        coverage.setColorFilter(NULL);
+
+        SkCanvas canvas(mask.fAlpha);
+        canvas.translate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+        canvas.concat(fCTM);
+        draw(&canvas, coverage);
+        mask.fAlpha.setImmutable();
+
+        mask.fPaint = paint;
+        mask.fPaint.setStyle(SkPaint::kFill_Style);
+        mask.fPaint.setPathEffect(NULL);
+        mask.fPaint.setMaskFilter(NULL);
+        mask.fPaint.setRasterizer(NULL);
+    }
+
+    const SkMatrix fMatrix;
+    SkMatrix fCTM;
+    const SkIRect fClip;
+    SkTArray<SkCompiledPicture::Mask>* fMasks;
+    unsigned fOp;
+};
+
+}  // namespace
+
+SkCompiledPicture* SkCompiledPicture::Create(const SkPicture* picture, const SkMatrix& matrix) {
+    return SkNEW_ARGS(SkCompiledPicture, (picture, matrix));
+}
+
+SkCompiledPicture::SkCompiledPicture(const SkPicture* picture, const SkMatrix& matrix)
+    : fPicture(SkRef(picture))
+    , fMatrix(matrix) {
+    // Recording the picture again gets us an SkRecord of our own to draw from.  Nested pictures
+    // stay as DrawPicture ops, and aren't compiled.
+    SkRecorder recorder(&fRecord, picture->cullRect());
+    picture->playback(&recorder);
+
+    if (matrix.hasPerspective()) {
+        return;
+    }
+
+    // Nothing drawn outside the picture's cull rect is ever seen, so no mask need extend past it.
+    SkRect cull;
+    matrix.mapRect(&cull, picture->cullRect());
+    SkIRect clip;
+    cull.roundOut(&clip);
+
+    MaskCompiler compiler(matrix, clip, &fMasks);
+    for (unsigned i = 0; i < fRecord.count(); i++) {
+        compiler.setCurrentOp(i);
+        fRecord.visit<void>(i, compiler);
+    }
+}
+
+SkCompiledPicture::~SkCompiledPicture() {}
+
+size_t SkCompiledPicture::bytesUsed() const {
+    size_t bytes = sizeof(*this) + fMasks.count() * sizeof(Mask);
+    for (int i = 0; i < fMasks.count(); i++) {
+        bytes += fMasks[i].fAlpha.getSize();
+    }
+    return bytes;
+}
+
+void SkCompiledPicture::playback(SkCanvas* canvas) const {
+    if (canvas->getTotalMatrix() != fMatrix) {
+        fPicture->playback(canvas);
+        return;
+    }
+
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    SkRecords::Draw draw(canvas, NULL, NULL, 0);
+    int next = 0;
+    for (unsigned i = 0; i < fRecord.count(); i++) {
+        if (next < fMasks.count() && fMasks[next].fOp == i) {
+            // The mask is already in device space, so blit it with an identity matrix.
+            const Mask& mask = fMasks[next++];
+            const SkMatrix ctm = canvas->getTotalMatrix();
+            canvas->setMatrix(SkMatrix::I());
+            canvas->drawBitmap(mask.fAlpha, SkIntToScalar(mask.fOrigin.fX),
+                                             SkIntToScalar(mask.fOrigin.fY), &mask.fPaint);
+            canvas->setMatrix(ctm);
+        } else {
+            fRecord.visit<void>(i, draw);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompiledPicture_DEFINED
+#define SkCompiledPicture_DEFINED
+
+#include "SkBitmap.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkRecord.h"
+#include "SkTArray.h"
+
+class SkCanvas;
+
+/**
+ * An SkPicture prepared ahead of time for raster playback at one fixed matrix.
+ *
+ * Create() records the picture's ops again and rasterizes the coverage of each path, oval and
+ * rrect it safely can into an A8 mask in device space.  playback() then blits those masks with
+ * the op's color instead of scan converting the geometry again, and draws the remaining ops as
+ * SkPicture would.  This pays off for static content drawn over and over at the same scale and
+ * offset, e.g. map overlays.
+ *
+ * The masks are only valid at the matrix they were made for: drawn into a canvas with any other
+ * total matrix, playback() just plays the picture back.  Call Create() again for the new matrix.
+ */
+class SkCompiledPicture : SkNoncopyable {
+public:
+    // Returns a new SkCompiledPicture to draw picture at matrix.  Never NULL.
+    static SkCompiledPicture* Create(const SkPicture* picture, const SkMatrix& matrix);
+
+    ~SkCompiledPicture();
+
+    const SkMatrix& matrix() const { return fMatrix; }
+
+    // Draws the picture into canvas, replaying the compiled masks if canvas' total matrix is
+    // the one we were compiled for.
+    void playback(SkCanvas* canvas) const;
+
+    // How many ops were compiled down to masks, and how many bytes those masks use.
+    int maskCount() const { return fMasks.count(); }
+    size_t bytesUsed() const;
+
+    struct Mask {
+        unsigned fOp;       // Index in fRecord of the op this mask replaces.
+        SkIPoint fOrigin;   // Device space position of fAlpha's top left corner.
+        SkBitmap fAlpha;    // The op's coverage, including any mask filter or path effect.
+        SkPaint  fPaint;    // The op's paint, less what fAlpha has already applied.
+    };
+
+private:
+    SkCompiledPicture(const SkPicture*, const SkMatrix&);
+
+    SkAutoTUnref<const SkPicture> fPicture;
+    const SkMatrix fMatrix;
+    SkRecord fRecord;
+    SkTArray<Mask> fMasks;     // Sorted by fOp.
+};
+
+#endif//SkCompiledPicture_DEFINED
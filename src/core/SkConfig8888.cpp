@@ -8,6 +8,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkConfig8888.h"
+#include "SkConfig8888_opts.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
 #include "SkMathPriv.h"
@@ -87,10 +88,12 @@ bool SkSrcPixelInfo::convertPixelsTo(SkDstPixelInfo* dst, int width, int height)
     AlphaVerb doAlpha = compute_AlphaVerb(fAlphaType, dst->fAlphaType);
     bool doSwapRB = fColorType != dst->fColorType;
 
+    SkConfig8888RowProc platformProc = NULL;
     switch (doAlpha) {
         case kNothing_AlphaVerb:
             if (doSwapRB) {
                 proc = convert32_row<true, kNothing_AlphaVerb>;
+                platformProc = SkConfig8888GetPlatformRowProc(kSwapRB_SkConfig8888RowProcType);
             } else {
                 if (fPixels == dst->fPixels) {
                     return true;
@@ -101,18 +104,27 @@ bool SkSrcPixelInfo::convertPixelsTo(SkDstPixelInfo* dst, int width, int height)
         case kPremul_AlphaVerb:
             if (doSwapRB) {
                 proc = convert32_row<true, kPremul_AlphaVerb>;
+                platformProc =
+                        SkConfig8888GetPlatformRowProc(kSwapRBPremul_SkConfig8888RowProcType);
             } else {
                 proc = convert32_row<false, kPremul_AlphaVerb>;
+                platformProc = SkConfig8888GetPlatformRowProc(kPremul_SkConfig8888RowProcType);
             }
             break;
         case kUnpremul_AlphaVerb:
             if (doSwapRB) {
                 proc = convert32_row<true, kUnpremul_AlphaVerb>;
+                platformProc =
+                        SkConfig8888GetPlatformRowProc(kSwapRBUnpremul_SkConfig8888RowProcType);
             } else {
                 proc = convert32_row<false, kUnpremul_AlphaVerb>;
+                platformProc = SkConfig8888GetPlatformRowProc(kUnpremul_SkConfig8888RowProcType);
             }
             break;
     }
+    if (platformProc) {
+        proc = platformProc;
+    }
 
     uint32_t* dstP = static_cast<uint32_t*>(dst->fPixels);
     const uint32_t* srcP = static_cast<const uint32_t*>(fPixels);
@@ -4,6 +4,8 @@
 
 #include "SkConvolver.h"
 #include "SkSize.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
 namespace {
@@ -292,7 +294,7 @@ void SkConvolutionFilter1D::AddFilter(int filterOffset,
     fixedValues.reset(filterLength);
 
     for (int i = 0; i < filterLength; ++i) {
-        fixedValues.push_back(FloatToFixed(filterValues[i]));
+        fixedValues[i] = FloatToFixed(filterValues[i]);
     }
 
     AddFilter(filterOffset, &fixedValues[0], filterLength);
@@ -358,26 +360,41 @@ const SkConvolutionFilter1D::ConvolutionFixed* SkConvolutionFilter1D::GetSingleF
     return &fFilterValues[filter.fDataLocation];
 }
 
-void BGRAConvolve2D(const unsigned char* sourceData,
-                    int sourceByteRowStride,
-                    bool sourceHasAlpha,
-                    const SkConvolutionFilter1D& filterX,
-                    const SkConvolutionFilter1D& filterY,
-                    int outputByteRowStride,
-                    unsigned char* output,
-                    const SkConvolutionProcs& convolveProcs,
-                    bool useSimdIfPossible) {
+namespace {
+// The output rows [fFirstOutputRow, fLastOutputRow) of a BGRAConvolve2D().
+struct ConvolveBand {
+    const unsigned char*            fSourceData;
+    int                             fSourceByteRowStride;
+    bool                            fSourceHasAlpha;
+    const SkConvolutionFilter1D*    fFilterX;
+    const SkConvolutionFilter1D*    fFilterY;
+    int                             fOutputByteRowStride;
+    unsigned char*                  fOutput;
+    const SkConvolutionProcs*       fConvolveProcs;
+    int                             fFirstOutputRow;
+    int                             fLastOutputRow;
+};
+}  // namespace
+
+static void convolve_band(ConvolveBand* band) {
+    const unsigned char* sourceData = band->fSourceData;
+    const int sourceByteRowStride = band->fSourceByteRowStride;
+    const bool sourceHasAlpha = band->fSourceHasAlpha;
+    const SkConvolutionFilter1D& filterX = *band->fFilterX;
+    const SkConvolutionFilter1D& filterY = *band->fFilterY;
+    const SkConvolutionProcs& convolveProcs = *band->fConvolveProcs;
 
     int maxYFilterSize = filterY.maxFilter();
 
     // The next row in the input that we will generate a horizontally
     // convolved row for. If the filter doesn't start at the beginning of the
-    // image (this is the case when we are only resizing a subset), then we
-    // don't want to generate any output rows before that. Compute the starting
-    // row for convolution as the first pixel for the first vertical filter.
+    // image (this is the case when we are only resizing a subset, or when this
+    // band starts part way down the output), then we don't want to generate
+    // any output rows before that. Compute the starting row for convolution as
+    // the first pixel for the first vertical filter of the band.
     int filterOffset, filterLength;
     const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
+        filterY.FilterForValue(band->fFirstOutputRow, &filterOffset, &filterLength);
     int nextXRow = filterOffset;
 
     // We loop over each row in the input doing a horizontal convolution. This
@@ -399,7 +416,6 @@ void BGRAConvolve2D(const unsigned char* sourceData,
 
     // Loop over every possible output row, processing just enough horizontal
     // convolutions to run each subsequent vertical convolution.
-    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
     int numOutputRows = filterY.numValues();
 
     // We need to check which is the last line to convolve before we advance 4
@@ -421,7 +437,7 @@ void BGRAConvolve2D(const unsigned char* sourceData,
     filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
                            &lastFilterLength);
 
-    for (int outY = 0; outY < numOutputRows; outY++) {
+    for (int outY = band->fFirstOutputRow; outY < band->fLastOutputRow; outY++) {
         filterValues = filterY.FilterForValue(outY,
                                               &filterOffset, &filterLength);
 
@@ -462,7 +478,8 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
 
         // Compute where in the output image this row of final data will go.
-        unsigned char* curOutputRow = &output[(uint64_t)outY * outputByteRowStride];
+        unsigned char* curOutputRow =
+            &band->fOutput[(uint64_t)outY * band->fOutputByteRowStride];
 
         // Get the list of rows that the circular buffer has, in order.
         int firstRowInCircularBuffer;
@@ -487,3 +504,54 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
     }
 }
+
+// Outputs with at least this many pixels are convolved in bands of kBandRows
+// rows on an SkTaskGroup. Each band convolves horizontally the few input rows
+// its first vertical filter shares with the band above it again, so the
+// bands are kept tall.
+static const int kMinParallelPixels = 256 * 1024;
+static const int kBandRows = 64;
+
+void BGRAConvolve2D(const unsigned char* sourceData,
+                    int sourceByteRowStride,
+                    bool sourceHasAlpha,
+                    const SkConvolutionFilter1D& filterX,
+                    const SkConvolutionFilter1D& filterY,
+                    int outputByteRowStride,
+                    unsigned char* output,
+                    const SkConvolutionProcs& convolveProcs,
+                    bool useSimdIfPossible) {
+    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
+    const int numOutputRows = filterY.numValues();
+    const int bandCount = (numOutputRows + kBandRows - 1) / kBandRows;
+
+    ConvolveBand band;
+    band.fSourceData = sourceData;
+    band.fSourceByteRowStride = sourceByteRowStride;
+    band.fSourceHasAlpha = sourceHasAlpha;
+    band.fFilterX = &filterX;
+    band.fFilterY = &filterY;
+    band.fOutputByteRowStride = outputByteRowStride;
+    band.fOutput = output;
+    band.fConvolveProcs = &convolveProcs;
+    band.fFirstOutputRow = 0;
+    band.fLastOutputRow = numOutputRows;
+
+    if (bandCount < 2 ||
+        sk_64_mul(filterX.numValues(), numOutputRows) < kMinParallelPixels) {
+        convolve_band(&band);
+        return;
+    }
+
+    // Every output row only depends on the input, so the bands may run in any order,
+    // and make exactly the pixels a single pass would.
+    SkAutoSTArray<16, ConvolveBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        bands[i] = band;
+        bands[i].fFirstOutputRow = i * kBandRows;
+        bands[i].fLastOutputRow = SkTMin((i + 1) * kBandRows, numOutputRows);
+    }
+    SkTaskGroup tg;
+    tg.batch(convolve_band, bands.get(), bandCount);
+    tg.wait();
+}
@@ -58,6 +58,12 @@ public:
     // output image.
     int numValues() const { return static_cast<int>(fFilters.count()); }
 
+    // Returns the number of bytes the filters and their values take up.
+    size_t bytesUsed() const {
+        return fFilters.count() * sizeof(FilterInstance) +
+               fFilterValues.count() * sizeof(ConvolutionFixed);
+    }
+
     // Appends the given list of scaling values for generating a given output
     // pixel. |filterOffset| is the distance from the edge of the image to where
     // the scaling factors start. The scaling factors apply to the source pixels
@@ -99,9 +99,10 @@ public:
     virtual void blitMask(const SkMask&, const SkIRect&);
 
 private:
-    SkXfermode* fXfermode;
-    SkPMColor*  fBuffer;
-    uint8_t*    fAAExpand;
+    SkXfermode*  fXfermode;
+    SkAutoMalloc fBufferStorage;  // Only used outside of an SkDrawArena::AutoScope.
+    SkPMColor*   fBuffer;
+    uint8_t*     fAAExpand;
 
     // illegal
     SkA8_Shader_Blitter& operator=(const SkA8_Shader_Blitter&);
@@ -168,6 +169,7 @@ public:
 
 private:
     SkXfermode*         fXfermode;
+    SkAutoMalloc        fBufferStorage;  // Only used outside of an SkDrawArena::AutoScope.
     SkPMColor*          fBuffer;
     SkBlitRow::Proc32   fProc32;
     SkBlitRow::Proc32   fProc32Blend;
@@ -180,6 +182,42 @@ private:
     typedef SkShaderBlitter INHERITED;
 };
 
+/**
+ *  Blits through float stages: the shaded span is converted to SkPMFloat four pixels at a time,
+ *  then the xfermode and the coverage are applied in float before storing back to 8888.
+ *  Chosen in place of SkARGB32_Shader_Blitter for paints with kFloatPipeline_Flag.
+ */
+class SkARGB32_Float_Blitter : public SkShaderBlitter {
+public:
+    // Returns true if the paint's xfermode has a float stage.
+    static bool Supports(const SkPaint&);
+
+    SkARGB32_Float_Blitter(const SkBitmap& device, const SkPaint& paint,
+                           SkShader::Context* shaderContext);
+    virtual ~SkARGB32_Float_Blitter();
+    void blitH(int x, int y, int width) override;
+    void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitRect(int x, int y, int width, int height) override;
+    void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
+    void blitMask(const SkMask&, const SkIRect&) override;
+
+    // Blends count src pixels into dst.  aa is per-pixel coverage, or NULL to use coverage
+    // (in [0, 1]) for every pixel.
+    typedef void (*Proc)(SkPMColor dst[], const SkPMColor src[], int count,
+                         const SkAlpha aa[], float coverage);
+
+private:
+    SkAutoMalloc fBufferStorage;  // Only used outside of an SkDrawArena::AutoScope.
+    SkPMColor*   fBuffer;
+    Proc         fProc;
+    bool         fConstInY;
+
+    // illegal
+    SkARGB32_Float_Blitter& operator=(const SkARGB32_Float_Blitter&);
+
+    typedef SkShaderBlitter INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*  These return the correct subclass of blitter for their device config.
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDecodedImageCache.h"
+#include "SkBitmapCache.h"
+#include "SkGraphics.h"
+#include "SkPixelRef.h"
+#include "SkRect.h"
+#include "SkTaskGroup.h"
+#include "SkThread.h"
+#include "SkTraceMemoryDump.h"
+
+// This can be defined by the caller's build system
+#ifndef SK_DEFAULT_DECODED_IMAGE_CACHE_LIMIT
+    #define SK_DEFAULT_DECODED_IMAGE_CACHE_LIMIT     (2 * 1024 * 1024)
+#endif
+
+namespace {
+static unsigned gDecodedImageKeyNamespaceLabel;
+
+struct DecodedImageKey : public SkResourceCache::Key {
+public:
+    DecodedImageKey(uint32_t genID, const SkIRect& bounds) : fGenID(genID), fBounds(bounds) {
+        // Shares the bitmap shared ID, so SkNotifyBitmapGenIDIsStale() purges these too.
+        this->init(&gDecodedImageKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(genID),
+                   sizeof(fGenID) + sizeof(fBounds));
+    }
+
+    uint32_t    fGenID;
+    SkIRect     fBounds;
+};
+
+struct DecodedImageRec : public SkResourceCache::Rec {
+    DecodedImageRec(uint32_t genID, const SkIRect& bounds, const SkBitmap& result)
+        : fKey(genID, bounds)
+        , fBitmap(result)
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "decoded-image"; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
+        const DecodedImageRec& rec = static_cast<const DecodedImageRec&>(baseRec);
+        SkBitmap* result = (SkBitmap*)contextBitmap;
+
+        *result = rec.fBitmap;
+        result->lockPixels();
+        return SkToBool(result->getPixels());
+    }
+
+    static bool Exists(const SkResourceCache::Rec&, void*) {
+        return true;
+    }
+
+private:
+    DecodedImageKey fKey;
+    SkBitmap        fBitmap;
+};
+} // namespace
+
+SK_DECLARE_STATIC_MUTEX(gMutex);
+static SkResourceCache* gDecodedImageCache = NULL;
+static void cleanup_gDecodedImageCache() {
+    // See cleanup_gResourceCache() in SkResourceCache.cpp.
+#if SK_DEVELOPER
+    SkDELETE(gDecodedImageCache);
+#endif
+}
+
+/** Must hold gMutex when calling. */
+static SkResourceCache* get_cache() {
+    gMutex.assertHeld();
+    if (NULL == gDecodedImageCache) {
+        gDecodedImageCache = SkNEW_ARGS(SkResourceCache, (SK_DEFAULT_DECODED_IMAGE_CACHE_LIMIT));
+        atexit(cleanup_gDecodedImageCache);
+    }
+    return gDecodedImageCache;
+}
+
+static DecodedImageKey make_key(const SkPixelRef* pr) {
+    // The key SkCachingPixelRef uses for its pixels.
+    return DecodedImageKey(pr->getGenerationID(), pr->info().bounds());
+}
+
+bool SkDecodedImageCache::Find(uint32_t genID, const SkIRect& bounds, SkBitmap* result) {
+    const DecodedImageKey key(genID, bounds);
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->find(key, DecodedImageRec::Finder, result);
+}
+
+void SkDecodedImageCache::Add(SkPixelRef* pr, const SkIRect& bounds, const SkBitmap& result) {
+    SkASSERT(result.isImmutable());
+    SkASSERT(result.dimensions() == bounds.size());
+
+    DecodedImageRec* rec = SkNEW_ARGS(DecodedImageRec, (pr->getGenerationID(), bounds, result));
+    {
+        SkAutoMutexAcquire am(gMutex);
+        get_cache()->add(rec);
+    }
+    pr->notifyAddedToCache();
+}
+
+static void prefetch_pixel_ref(SkPixelRef* pr) {
+    // Locking a lazy pixel ref decodes it, and SkCachingPixelRef adds the pixels to the cache.
+    pr->lockPixels();
+    pr->unlockPixels();
+    pr->unref();
+}
+
+int SkDecodedImageCache::Prefetch(const SkBitmap bitmaps[], int count, SkTaskGroup* taskGroup) {
+    SkASSERT(taskGroup);
+    int queued = 0;
+    for (int i = 0; i < count; ++i) {
+        SkPixelRef* pr = bitmaps[i].pixelRef();
+        if (NULL == pr || !pr->isLazyGenerated()) {
+            continue;
+        }
+        const DecodedImageKey key = make_key(pr);
+        {
+            SkAutoMutexAcquire am(gMutex);
+            if (get_cache()->find(key, DecodedImageRec::Exists, NULL)) {
+                continue;
+            }
+        }
+        taskGroup->add(prefetch_pixel_ref, SkRef(pr));
+        queued += 1;
+    }
+    return queued;
+}
+
+bool SkDecodedImageCache::Pin(const SkBitmap& bitmap) {
+    SkPixelRef* pr = bitmap.pixelRef();
+    if (NULL == pr) {
+        return false;
+    }
+    const DecodedImageKey key = make_key(pr);
+    {
+        SkAutoMutexAcquire am(gMutex);
+        if (get_cache()->pin(key)) {
+            return true;
+        }
+    }
+
+    // Not decoded yet, or purged since. Locking it puts the decoded pixels back in the cache.
+    pr->lockPixels();
+    bool pinned;
+    {
+        SkAutoMutexAcquire am(gMutex);
+        pinned = get_cache()->pin(key);
+    }
+    pr->unlockPixels();
+    return pinned;
+}
+
+bool SkDecodedImageCache::Unpin(const SkBitmap& bitmap) {
+    SkPixelRef* pr = bitmap.pixelRef();
+    if (NULL == pr) {
+        return false;
+    }
+    const DecodedImageKey key = make_key(pr);
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->unpin(key);
+}
+
+size_t SkDecodedImageCache::GetTotalBytesUsed() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getTotalBytesUsed();
+}
+
+size_t SkDecodedImageCache::GetTotalByteLimit() {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->getTotalByteLimit();
+}
+
+size_t SkDecodedImageCache::SetTotalByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->setTotalByteLimit(newLimit);
+}
+
+void SkDecodedImageCache::PurgeAll() {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->purgeAll();
+}
+
+void SkDecodedImageCache::GetStats(SkResourceCache::Stats* stats) {
+    SkAutoMutexAcquire am(gMutex);
+    get_cache()->getStats(stats);
+}
+
+void SkDecodedImageCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char kDumpName[] = "skia/sk_decoded_image_cache";
+    SkTDArray<SkResourceCache::CategoryStats> stats;
+    size_t limit;
+    {
+        SkAutoMutexAcquire am(gMutex);
+        get_cache()->addCategoryStats(&stats);
+        limit = get_cache()->getTotalByteLimit();
+    }
+    dump->dumpNumericValue(kDumpName, "limit", "bytes", limit);
+    SkResourceCache::DumpCategoryStats(kDumpName, stats, dump);
+}
+
+void SkDecodedImageCache::Dump() {
+    SkAutoMutexAcquire am(gMutex);
+    SkDebugf("SkDecodedImageCache: limit=%zu\n", get_cache()->getTotalByteLimit());
+    get_cache()->dump();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SkGraphics::GetDecodedImageCacheTotalBytesUsed() {
+    return SkDecodedImageCache::GetTotalBytesUsed();
+}
+
+size_t SkGraphics::GetDecodedImageCacheTotalByteLimit() {
+    return SkDecodedImageCache::GetTotalByteLimit();
+}
+
+size_t SkGraphics::SetDecodedImageCacheTotalByteLimit(size_t newLimit) {
+    return SkDecodedImageCache::SetTotalByteLimit(newLimit);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDecodedImageCache_DEFINED
+#define SkDecodedImageCache_DEFINED
+
+#include "SkBitmap.h"
+#include "SkResourceCache.h"
+
+class SkTaskGroup;
+class SkTraceMemoryDump;
+
+/**
+ *  The decoded pixels of lazily generated bitmaps (see SkCachingPixelRef), keyed by the pixel
+ *  ref's generation ID and bounds. They live in their own SkResourceCache, with its own budget,
+ *  so a few large decodes don't push the scaled bitmaps and mipmaps out of the shared cache (or
+ *  the other way around).
+ *
+ *  Images that are about to be drawn can be decoded ahead of time with Prefetch(), and the ones
+ *  that are on screen pinned, so that decoding others doesn't purge them.
+ *
+ *  All of the methods are thread-safe.
+ */
+class SkDecodedImageCache {
+public:
+    /**
+     *  Search for the pixels of the pixel ref with this genID. If found, returns true and result
+     *  is set to them, already locked.
+     */
+    static bool Find(uint32_t genID, const SkIRect& bounds, SkBitmap* result);
+
+    /**
+     *  The decoded pixels of pr, which must be immutable, and bounds' size.
+     */
+    static void Add(SkPixelRef* pr, const SkIRect& bounds, const SkBitmap& result);
+
+    /**
+     *  Queues a decode on taskGroup of each lazily generated bitmap that isn't cached yet, and
+     *  returns how many were queued. The tasks hold a ref on the pixel refs. Call
+     *  taskGroup->wait() before drawing the bitmaps to be sure they are all decoded.
+     */
+    static int Prefetch(const SkBitmap bitmaps[], int count, SkTaskGroup* taskGroup);
+
+    /**
+     *  Decodes the bitmap's pixels if needed, and keeps them in the cache until a matching call
+     *  to Unpin(), however far over budget it goes. Pins nest. Returns false if the pixels can't
+     *  be pinned, e.g. because the bitmap isn't backed by this cache.
+     */
+    static bool Pin(const SkBitmap&);
+    static bool Unpin(const SkBitmap&);
+
+    static size_t GetTotalBytesUsed();
+    static size_t GetTotalByteLimit();
+    static size_t SetTotalByteLimit(size_t newLimit);   // returns the previous limit
+
+    /** Purges everything that isn't pinned. */
+    static void PurgeAll();
+
+    static void GetStats(SkResourceCache::Stats*);
+
+    /** Reports the limit and the memory held under "skia/sk_decoded_image_cache". */
+    static void DumpMemoryStatistics(SkTraceMemoryDump*);
+
+    /**
+     *  Call SkDebugf() with diagnostic information about the state of the cache
+     */
+    static void Dump();
+};
+
+#endif
@@ -10,10 +10,12 @@
 #include "SkDraw.h"
 #include "SkDrawFilter.h"
 #include "SkMetaData.h"
+#include "SkPatchCache.h"
 #include "SkPatchUtils.h"
 #include "SkPathMeasure.h"
 #include "SkRasterClip.h"
 #include "SkShader.h"
+#include "SkTextAlongPath.h"
 #include "SkTextBlob.h"
 #include "SkTextToPathIter.h"
 
@@ -94,6 +96,13 @@ SkSurface* SkBaseDevice::newSurface(const SkImageInfo&, const SkSurfaceProps&) {
 
 const void* SkBaseDevice::peekPixels(SkImageInfo*, size_t*) { return NULL; }
 
+void SkBaseDevice::drawRects(const SkDraw& draw, const SkRect rects[], int count,
+                             const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->drawRect(draw, rects[i], paint);
+    }
+}
+
 void SkBaseDevice::drawDRRect(const SkDraw& draw, const SkRRect& outer,
                               const SkRRect& inner, const SkPaint& paint) {
     SkPath path;
@@ -108,10 +117,22 @@ void SkBaseDevice::drawDRRect(const SkDraw& draw, const SkRRect& outer,
 
 void SkBaseDevice::drawPatch(const SkDraw& draw, const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    SkPatchUtils::VertexData data;
-    
     SkISize lod = SkPatchUtils::GetLevelOfDetail(cubics, draw.fMatrix);
 
+    if (SkPatchCache::IsEnabled()) {
+        SkAutoTUnref<const SkPatchCache::Mesh> mesh(
+                SkPatchCache::FindOrCreate(cubics, colors, texCoords, lod.width(), lod.height()));
+        if (mesh) {
+            const SkPatchUtils::VertexData& data = mesh->data();
+            this->drawVertices(draw, SkCanvas::kTriangles_VertexMode, data.fVertexCount,
+                               data.fPoints, data.fTexCoords, data.fColors, xmode, data.fIndices,
+                               data.fIndexCount, paint);
+        }
+        return;
+    }
+
+    SkPatchUtils::VertexData data;
+
     // It automatically adjusts lodX and lodY in case it exceeds the number of indices.
     // If it fails to generate the vertices, then we do not draw. 
     if (SkPatchUtils::getVertexData(&data, cubics, colors, texCoords, lod.width(), lod.height())) {
@@ -121,6 +142,14 @@ void SkBaseDevice::drawPatch(const SkDraw& draw, const SkPoint cubics[12], const
     }
 }
 
+void SkBaseDevice::drawPosTextHalo(const SkDraw& draw, const void* text, size_t len,
+                                   const SkScalar pos[], int scalarsPerPos,
+                                   const SkPoint& offset, const SkPaint& haloPaint,
+                                   const SkPaint& paint) {
+    this->drawPosText(draw, text, len, pos, scalarsPerPos, offset, haloPaint);
+    this->drawPosText(draw, text, len, pos, scalarsPerPos, offset, paint);
+}
+
 void SkBaseDevice::drawTextBlob(const SkDraw& draw, const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint &paint, SkDrawFilter* drawFilter) {
 
@@ -312,12 +341,13 @@ void SkBaseDevice::drawTextOnPath(const SkDraw& draw, const void* text, size_t b
     }
     
     SkTextToPathIter    iter((const char*)text, byteLength, paint, true);
-    SkPathMeasure       meas(follow, false);
+    SkAutoTUnref<SkSharedPathMeasure> measure(SkTextAlongPath::RefMeasure(follow));
+    SkPathMeasure&      meas = *measure->measure();
     SkScalar            hOffset = 0;
     
     // need to measure first
     if (paint.getTextAlign() != SkPaint::kLeft_Align) {
-        SkScalar pathLen = meas.getLength();
+        SkScalar pathLen = measure->length();
         if (paint.getTextAlign() == SkPaint::kCenter_Align) {
             pathLen = SkScalarHalf(pathLen);
         }
@@ -38,6 +38,13 @@ public:
         return &fProps;
     }
 
+    bool isThreadSafe() override {
+        // Only raster devices create devices that can be drawn to on any thread.
+        SkImageInfo info;
+        size_t rowBytes;
+        return NULL != fDevice->peekPixels(&info, &rowBytes);
+    }
+
 private:
     SkBaseDevice*  fDevice;
     const SkSurfaceProps fProps;
@@ -6,100 +6,114 @@
  */
 
 #include "SkDistanceFieldGen.h"
+#include "SkColorPriv.h"
+#include "SkGeometry.h"
+#include "SkNx.h"
+#include "SkPath.h"
 #include "SkPoint.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
 
+// The temporary data is kept as planes, one per value, so that runs of texels can be loaded
+// four at a time.
 struct DFData {
-    float   fAlpha;      // alpha value of source texel
-    float   fDistSq;     // distance squared to nearest (so far) edge texel
-    SkPoint fDistVector; // distance vector to nearest (so far) edge texel
-};
-
-enum NeighborFlags {
-    kLeft_NeighborFlag        = 0x01,
-    kRight_NeighborFlag       = 0x02,
-    kTopLeft_NeighborFlag     = 0x04,
-    kTop_NeighborFlag         = 0x08,
-    kTopRight_NeighborFlag    = 0x10,
-    kBottomLeft_NeighborFlag  = 0x20,
-    kBottom_NeighborFlag      = 0x40,
-    kBottomRight_NeighborFlag = 0x80,
-    kAll_NeighborFlags        = 0xff,
-
-    kNeighborFlagCount        = 8
+    float* fAlpha;      // alpha value of source texel
+    float* fDistSq;     // distance squared to nearest (so far) edge texel
+    float* fDistX;      // distance vector to nearest (so far) edge texel
+    float* fDistY;
 };
 
 // We treat an "edge" as a place where we cross from >=128 to <128, or vice versa, or
 // where we have two non-zero pixels that are <128.
-// 'neighborFlags' is used to limit the directions in which we test to avoid indexing
-// outside of the image
-static bool found_edge(const unsigned char* imagePtr, int width, int neighborFlags) {
-    // the order of these should match the neighbor flags above
-    const int kNum8ConnectedNeighbors = 8;
-    const int offsets[8] = {-1, 1, -width-1, -width, -width+1, width-1, width, width+1 };
-    SkASSERT(kNum8ConnectedNeighbors == kNeighborFlagCount);
-
-    // search for an edge
-    unsigned char currVal = *imagePtr;
+static bool is_edge(unsigned char currVal, unsigned char neighborVal) {
     unsigned char currCheck = (currVal >> 7);
-    for (int i = 0; i < kNum8ConnectedNeighbors; ++i) {
-        unsigned char neighborVal;
-        if ((1 << i) & neighborFlags) {
-            const unsigned char* checkPtr = imagePtr + offsets[i];
-            neighborVal = *checkPtr;
-        } else {
-            neighborVal = 0;
+    unsigned char neighborCheck = (neighborVal >> 7);
+    // if sharp transition
+    return currCheck != neighborCheck ||
+           // or both <128 and >0
+           (!currCheck && !neighborCheck && currVal && neighborVal);
+}
+
+// Sets edges[i] to 255 (which makes for convenient debug rendering) where image[i] makes an edge
+// with any of its 8-connected neighbors, and to 0 elsewhere. The neighbors are read without any
+// bounds checks, so the image must be padded by a texel all around the run.
+static void find_edges(unsigned char* edges, const unsigned char* image, int count,
+                       int rowBytes) {
+    const int kNum8ConnectedNeighbors = 8;
+    const int offsets[kNum8ConnectedNeighbors] = {
+        -1, 1, -rowBytes-1, -rowBytes, -rowBytes+1, rowBytes-1, rowBytes, rowBytes+1
+    };
+
+    int i = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // Values >= 128 are the negative ones, as signed bytes.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_cmpeq_epi8(zero, zero);
+    for (; i + 16 <= count; i += 16) {
+        __m128i curr = _mm_loadu_si128((const __m128i*)(image + i));
+        __m128i currHigh = _mm_cmplt_epi8(curr, zero);
+        __m128i currLow = _mm_andnot_si128(_mm_or_si128(currHigh, _mm_cmpeq_epi8(curr, zero)),
+                                           ones);
+        __m128i edge = zero;
+        for (int n = 0; n < kNum8ConnectedNeighbors; ++n) {
+            __m128i neighbor = _mm_loadu_si128((const __m128i*)(image + i + offsets[n]));
+            __m128i neighborHigh = _mm_cmplt_epi8(neighbor, zero);
+            __m128i neighborLow = _mm_andnot_si128(
+                    _mm_or_si128(neighborHigh, _mm_cmpeq_epi8(neighbor, zero)), ones);
+            edge = _mm_or_si128(edge, _mm_or_si128(_mm_xor_si128(currHigh, neighborHigh),
+                                                   _mm_and_si128(currLow, neighborLow)));
         }
-        unsigned char neighborCheck = (neighborVal >> 7);
-        SkASSERT(currCheck == 0 || currCheck == 1);
-        SkASSERT(neighborCheck == 0 || neighborCheck == 1);
-        // if sharp transition
-        if (currCheck != neighborCheck ||
-            // or both <128 and >0
-            (!currCheck && !neighborCheck && currVal && neighborVal)) {
-            return true;
+        _mm_storeu_si128((__m128i*)(edges + i), edge);
+    }
+#elif defined(SK_ARM_HAS_NEON)
+    const uint8x16_t half = vdupq_n_u8(0x80);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t curr = vld1q_u8(image + i);
+        uint8x16_t currHigh = vcgeq_u8(curr, half);
+        uint8x16_t currLow = vbicq_u8(vtstq_u8(curr, curr), currHigh);
+        uint8x16_t edge = vdupq_n_u8(0);
+        for (int n = 0; n < kNum8ConnectedNeighbors; ++n) {
+            uint8x16_t neighbor = vld1q_u8(image + i + offsets[n]);
+            uint8x16_t neighborHigh = vcgeq_u8(neighbor, half);
+            uint8x16_t neighborLow = vbicq_u8(vtstq_u8(neighbor, neighbor), neighborHigh);
+            edge = vorrq_u8(edge, vorrq_u8(veorq_u8(currHigh, neighborHigh),
+                                           vandq_u8(currLow, neighborLow)));
         }
+        vst1q_u8(edges + i, edge);
+    }
+#endif
+    for (; i < count; ++i) {
+        bool edge = false;
+        for (int n = 0; n < kNum8ConnectedNeighbors && !edge; ++n) {
+            edge = is_edge(image[i], image[i + offsets[n]]);
+        }
+        edges[i] = edge ? 255 : 0;
     }
-
-    return false;
 }
 
-static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned char* image,
-                            int dataWidth, int dataHeight,
-                            int imageWidth, int imageHeight,
+static void init_glyph_data(const DFData& data, unsigned char* edges, const unsigned char* image,
+                            int dataWidth, int imageWidth, int imageHeight, int imageRowBytes,
                             int pad) {
-    data += pad*dataWidth;
-    data += pad;
-    edges += (pad*dataWidth + pad);
-
+    int offset = pad*dataWidth + pad;
     for (int j = 0; j < imageHeight; ++j) {
+        float* alpha = data.fAlpha + offset;
         for (int i = 0; i < imageWidth; ++i) {
-            if (255 == *image) {
-                data->fAlpha = 1.0f;
+            if (255 == image[i]) {
+                alpha[i] = 1.0f;
             } else {
-                data->fAlpha = (*image)*0.00392156862f;  // 1/255
-            }
-            int checkMask = kAll_NeighborFlags;
-            if (i == 0) {
-                checkMask &= ~(kLeft_NeighborFlag|kTopLeft_NeighborFlag|kBottomLeft_NeighborFlag);
-            }
-            if (i == imageWidth-1) {
-                checkMask &= ~(kRight_NeighborFlag|kTopRight_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (j == 0) {
-                checkMask &= ~(kTopLeft_NeighborFlag|kTop_NeighborFlag|kTopRight_NeighborFlag);
-            }
-            if (j == imageHeight-1) {
-                checkMask &= ~(kBottomLeft_NeighborFlag|kBottom_NeighborFlag|kBottomRight_NeighborFlag);
+                alpha[i] = image[i]*0.00392156862f;  // 1/255
             }
-            if (found_edge(image, imageWidth, checkMask)) {
-                *edges = 255;  // using 255 makes for convenient debug rendering
-            }
-            ++data;
-            ++image;
-            ++edges;
         }
-        data += 2*pad;
-        edges += 2*pad;
+        find_edges(edges + offset, image, imageWidth, imageRowBytes);
+        image += imageRowBytes;
+        offset += dataWidth;
     }
 }
 
@@ -145,170 +159,176 @@ static float edge_distance(const SkPoint& direction, float alpha) {
     return distance;
 }
 
-static void init_distances(DFData* data, unsigned char* edges, int width, int height) {
-    // skip one pixel border
-    DFData* currData = data;
-    DFData* prevData = data - width;
-    DFData* nextData = data + width;
-
+static void init_distances(const DFData& data, const unsigned char* edges, int width, int height) {
+    const float* alpha = data.fAlpha;
+    int index = 0;
     for (int j = 0; j < height; ++j) {
-        for (int i = 0; i < width; ++i) {
-            if (*edges) {
+        for (int i = 0; i < width; ++i, ++index) {
+            if (edges[index]) {
                 // we should not be in the one-pixel outside band
                 SkASSERT(i > 0 && i < width-1 && j > 0 && j < height-1);
+                const float* prevAlpha = alpha + index - width;
+                const float* currAlpha = alpha + index;
+                const float* nextAlpha = alpha + index + width;
                 // gradient will point from low to high
                 // +y is down in this case
                 // i.e., if you're outside, gradient points towards edge
                 // if you're inside, gradient points away from edge
                 SkPoint currGrad;
-                currGrad.fX = (prevData+1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*(currData+1)->fAlpha
-                             - SK_ScalarSqrt2*(currData-1)->fAlpha
-                             + (nextData+1)->fAlpha - (nextData-1)->fAlpha;
-                currGrad.fY = (nextData-1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*nextData->fAlpha
-                             - SK_ScalarSqrt2*prevData->fAlpha
-                             + (nextData+1)->fAlpha - (prevData+1)->fAlpha;
+                currGrad.fX = prevAlpha[1] - prevAlpha[-1]
+                             + SK_ScalarSqrt2*currAlpha[1]
+                             - SK_ScalarSqrt2*currAlpha[-1]
+                             + nextAlpha[1] - nextAlpha[-1];
+                currGrad.fY = nextAlpha[-1] - prevAlpha[-1]
+                             + SK_ScalarSqrt2*nextAlpha[0]
+                             - SK_ScalarSqrt2*prevAlpha[0]
+                             + nextAlpha[1] - prevAlpha[1];
                 currGrad.setLengthFast(1.0f);
 
                 // init squared distance to edge and distance vector
-                float dist = edge_distance(currGrad, currData->fAlpha);
-                currGrad.scale(dist, &currData->fDistVector);
-                currData->fDistSq = dist*dist;
+                float dist = edge_distance(currGrad, *currAlpha);
+                data.fDistX[index] = currGrad.fX*dist;
+                data.fDistY[index] = currGrad.fY*dist;
+                data.fDistSq[index] = dist*dist;
             } else {
                 // init distance to "far away"
-                currData->fDistSq = 2000000.f;
-                currData->fDistVector.fX = 1000.f;
-                currData->fDistVector.fY = 1000.f;
+                data.fDistSq[index] = 2000000.f;
+                data.fDistX[index] = 1000.f;
+                data.fDistY[index] = 1000.f;
             }
-            ++currData;
-            ++prevData;
-            ++nextData;
-            ++edges;
         }
     }
 }
 
 // Danielsson's 8SSEDT
-
-// first stage forward pass
-// (forward in Y, forward in X)
-static void F1(DFData* curr, int width) {
-    // upper left
-    DFData* check = curr - width-1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*(distVec.fX + distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // up
-    check = curr - width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // upper right
-    check = curr - width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX - distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // left
-    check = curr - 1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+//
+// Each pass gives every texel that isn't an edge the nearest of its own distance and those
+// through some of its neighbors, in order. The neighbors in the row before the one being swept
+// (going forward in y) or after it (going backward in y) are already settled, so those are taken
+// a whole row at a time, four texels to a vector. Only the left and right neighbors have to be
+// taken texel by texel.
+
+// The distance through a neighbor at (dx, dy), from that neighbor's distance vector.
+template <typename T>
+static inline void step_from(const T& distSq, const T& distX, const T& distY, float dx, float dy,
+                             T* stepSq, T* stepX, T* stepY) {
+    const T dot = T(dx)*distX + T(dy)*distY;
+    if (dx && dy) {
+        *stepSq = distSq + T(2.0f)*(dot + T(1.0f));
+    } else {
+        *stepSq = distSq + T(2.0f)*dot + T(1.0f);
     }
+    *stepX = distX + T(dx);
+    *stepY = distY + T(dy);
 }
 
-// second stage forward pass
-// (forward in Y, backward in X)
-static void F2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    float distSq = check->fDistSq;
-    SkPoint distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+static inline void take_nearer(const DFData& data, int index,
+                               float distSq, float distX, float distY) {
+    if (distSq < data.fDistSq[index]) {
+        data.fDistSq[index] = distSq;
+        data.fDistX[index] = distX;
+        data.fDistY[index] = distY;
     }
 }
 
-// first stage backward pass
-// (backward in Y, forward in X)
-static void B1(DFData* curr, int width) {
-    // left
-    DFData* check = curr - 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+// left (dx = -1) or right (dx = 1)
+static inline void take_from_side(const DFData& data, int index, int dx) {
+    float distSq, distX, distY;
+    step_from(data.fDistSq[index + dx], data.fDistX[index + dx], data.fDistY[index + dx],
+              (float)dx, 0.0f, &distSq, &distX, &distY);
+    take_nearer(data, index, distSq, distX, distY);
 }
 
-// second stage backward pass
-// (backward in Y, backwards in X)
-static void B2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // bottom left
-    check = curr + width-1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*(distVec.fX - distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // bottom
-    check = curr + width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // bottom right
-    check = curr + width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX + distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #define DF_SIMD 1
+    typedef __m128 DFMask;
+
+    // Lanes for the four texels that aren't edges.
+    static inline DFMask non_edge_mask(const unsigned char* edges) {
+        int32_t bytes;
+        memcpy(&bytes, edges, sizeof(bytes));
+        const __m128i zero = _mm_setzero_si128();
+        __m128i lanes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero),
+                                           zero);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(lanes, zero));
+    }
+
+    // Lanes of mask where a < b.
+    static inline DFMask less_mask(DFMask mask, const Sk4f& a, const Sk4f& b) {
+        return _mm_and_ps(mask, _mm_cmplt_ps(a.vec(), b.vec()));
+    }
+
+    static inline Sk4f select(DFMask mask, const Sk4f& t, const Sk4f& e) {
+        return _mm_or_ps(_mm_and_ps(mask, t.vec()), _mm_andnot_ps(mask, e.vec()));
+    }
+#elif !defined(SKNX_NO_SIMD) && defined(SK_ARM_HAS_NEON)
+    #define DF_SIMD 1
+    typedef uint32x4_t DFMask;
+
+    // Lanes for the four texels that aren't edges.
+    static inline DFMask non_edge_mask(const unsigned char* edges) {
+        uint32_t bytes;
+        memcpy(&bytes, edges, sizeof(bytes));
+        uint16x8_t lanes = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes)));
+        return vceqq_u32(vmovl_u16(vget_low_u16(lanes)), vdupq_n_u32(0));
+    }
+
+    // Lanes of mask where a < b.
+    static inline DFMask less_mask(DFMask mask, const Sk4f& a, const Sk4f& b) {
+        return vandq_u32(mask, vcltq_f32(a.vec(), b.vec()));
+    }
+
+    static inline Sk4f select(DFMask mask, const Sk4f& t, const Sk4f& e) {
+        return vbslq_f32(mask, t.vec(), e.vec());
+    }
+#else
+    #define DF_SIMD 0
+#endif
+
+// For the count texels from dst, takes the nearest of their distances and those through their
+// three neighbors, left to right, in the row above (dy = -1) or below (dy = 1). The neighbor
+// directly above or below the first texel is at index in data.
+static void take_from_row(float* dstSq, float* dstX, float* dstY, const DFData& data, int index,
+                          float dy, const unsigned char* edges, int count) {
+    const float* srcSq = data.fDistSq + index;
+    const float* srcX = data.fDistX + index;
+    const float* srcY = data.fDistY + index;
+
+    int i = 0;
+#if DF_SIMD
+    for (; i + 4 <= count; i += 4) {
+        const DFMask nonEdge = non_edge_mask(edges + i);
+        Sk4f distSq = Sk4f::Load(dstSq + i);
+        Sk4f distX = Sk4f::Load(dstX + i);
+        Sk4f distY = Sk4f::Load(dstY + i);
+        for (int dx = -1; dx <= 1; ++dx) {
+            Sk4f stepSq, stepX, stepY;
+            step_from(Sk4f::Load(srcSq + i + dx), Sk4f::Load(srcX + i + dx),
+                      Sk4f::Load(srcY + i + dx), (float)dx, dy, &stepSq, &stepX, &stepY);
+            const DFMask nearer = less_mask(nonEdge, stepSq, distSq);
+            distSq = select(nearer, stepSq, distSq);
+            distX = select(nearer, stepX, distX);
+            distY = select(nearer, stepY, distY);
+        }
+        distSq.store(dstSq + i);
+        distX.store(dstX + i);
+        distY.store(dstY + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (edges[i]) {
+            continue;
+        }
+        for (int dx = -1; dx <= 1; ++dx) {
+            float stepSq, stepX, stepY;
+            step_from(srcSq[i + dx], srcX[i + dx], srcY[i + dx], (float)dx, dy,
+                      &stepSq, &stepX, &stepY);
+            if (stepSq < dstSq[i]) {
+                dstSq[i] = stepSq;
+                dstX[i] = stepX;
+                dstY[i] = stepY;
+            }
+        }
     }
 }
 
@@ -327,7 +347,11 @@ static unsigned char pack_distance_field_val(float dist, float distanceMagnitude
 }
 #endif
 
-// assumes a padded 8-bit image and distance field
+// The source images are copied with this much zero padding all around. Edges are found out to
+// a texel beyond the image, and those texels need all their neighbors in bounds too.
+static const int kCopyPad = 2;
+
+// assumes an 8-bit image padded by kCopyPad, and a padded distance field
 // width and height are the original width and height of the image
 static bool generate_distance_field_from_image(unsigned char* distanceField,
                                                const unsigned char* copyPtr,
@@ -342,97 +366,113 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
     // set params for distance field data
     int dataWidth = width + 2*pad;
     int dataHeight = height + 2*pad;
+    int dataCount = dataWidth*dataHeight;
 
     // create temp data
-    size_t dataSize = dataWidth*dataHeight*sizeof(DFData);
-    SkAutoSMalloc<1024> dfStorage(dataSize);
-    DFData* dataPtr = (DFData*) dfStorage.get();
-    sk_bzero(dataPtr, dataSize);
-
-    SkAutoSMalloc<1024> edgeStorage(dataWidth*dataHeight*sizeof(char));
+    SkAutoSTMalloc<1024, float> dfStorage(4*dataCount);
+    DFData data;
+    data.fAlpha = dfStorage.get();
+    data.fDistSq = data.fAlpha + dataCount;
+    data.fDistX = data.fDistSq + dataCount;
+    data.fDistY = data.fDistX + dataCount;
+    sk_bzero(data.fAlpha, dataCount*sizeof(float));
+
+    SkAutoSMalloc<1024> edgeStorage(dataCount*sizeof(char));
     unsigned char* edgePtr = (unsigned char*) edgeStorage.get();
-    sk_bzero(edgePtr, dataWidth*dataHeight*sizeof(char));
+    sk_bzero(edgePtr, dataCount*sizeof(char));
 
-    // copy glyph into distance field storage
-    init_glyph_data(dataPtr, edgePtr, copyPtr,
-                    dataWidth, dataHeight,
-                    width+2, height+2, SK_DistanceFieldPad);
+    // copy glyph (and the texel around it) into distance field storage
+    const int copyWidth = width + 2*kCopyPad;
+    init_glyph_data(data, edgePtr, copyPtr + (kCopyPad-1)*copyWidth + (kCopyPad-1),
+                    dataWidth, width+2, height+2, copyWidth, SK_DistanceFieldPad);
 
     // create initial distance data, particularly at edges
-    init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
+    init_distances(data, edgePtr, dataWidth, dataHeight);
 
     // now perform Euclidean distance transform to propagate distances
+    // (skipping the outer buffer)
+    const int rowCount = dataWidth-2;
 
     // forwards in y
-    DFData* currData = dataPtr+dataWidth+1; // skip outer buffer
-    unsigned char* currEdge = edgePtr+dataWidth+1;
     for (int j = 1; j < dataHeight-1; ++j) {
+        const int row = j*dataWidth + 1;
+        // upper left, up and upper right
+        take_from_row(data.fDistSq + row, data.fDistX + row, data.fDistY + row,
+                      data, row - dataWidth, -1.0f, edgePtr + row, rowCount);
+
         // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
+        for (int i = row; i < row + rowCount; ++i) {
             // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F1(currData, dataWidth);
+            if (!edgePtr[i]) {
+                take_from_side(data, i, -1);
             }
-            ++currData;
-            ++currEdge;
         }
 
         // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F2(currData, dataWidth);
+        for (int i = row + rowCount - 1; i >= row; --i) {
+            if (!edgePtr[i]) {
+                take_from_side(data, i, 1);
             }
-            --currData;
-            --currEdge;
         }
-
-        currData += dataWidth+1;
-        currEdge += dataWidth+1;
     }
 
+    // The nearest through the row below, for each texel of the row being swept. They can only
+    // be taken after the right neighbor, so they are found up front and taken during the sweep.
+    SkAutoSTMalloc<256, float> belowStorage(3*rowCount);
+    float* belowSq = belowStorage.get();
+    float* belowX = belowSq + rowCount;
+    float* belowY = belowX + rowCount;
+
     // backwards in y
-    currData = dataPtr+dataWidth*(dataHeight-2) - 1; // skip outer buffer
-    currEdge = edgePtr+dataWidth*(dataHeight-2) - 1;
-    for (int j = 1; j < dataHeight-1; ++j) {
+    for (int j = dataHeight-2; j > 0; --j) {
+        const int row = j*dataWidth + 1;
+
         // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B1(currData, dataWidth);
+        for (int i = row; i < row + rowCount; ++i) {
+            if (!edgePtr[i]) {
+                take_from_side(data, i, -1);
             }
-            ++currData;
-            ++currEdge;
         }
 
+        // bottom left, bottom and bottom right
+        // (nothing is nearer than a texel's own "far away", so that is where they start)
+        for (int i = 0; i < rowCount; ++i) {
+            belowSq[i] = 2000000.f;
+            belowX[i] = 1000.f;
+            belowY[i] = 1000.f;
+        }
+        take_from_row(belowSq, belowX, belowY, data, row + dataWidth, 1.0f, edgePtr + row,
+                      rowCount);
+
         // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B2(currData, dataWidth);
+        for (int i = rowCount - 1; i >= 0; --i) {
+            if (!edgePtr[row + i]) {
+                take_from_side(data, row + i, 1);
+                take_nearer(data, row + i, belowSq[i], belowX[i], belowY[i]);
             }
-            --currData;
-            --currEdge;
         }
+    }
 
-        currData -= dataWidth-1;
-        currEdge -= dataWidth-1;
+#if !DUMP_EDGE
+    // the distances themselves, in place of their squares
+    int index = 0;
+    for (; index + 4 <= dataCount; index += 4) {
+        Sk4f::Load(data.fDistSq + index).sqrt().store(data.fDistSq + index);
+    }
+    for (; index < dataCount; ++index) {
+        data.fDistSq[index] = SkScalarSqrt(data.fDistSq[index]);
     }
+#endif
 
     // copy results to final distance field data
-    currData = dataPtr + dataWidth+1;
-    currEdge = edgePtr + dataWidth+1;
     unsigned char *dfPtr = distanceField;
     for (int j = 1; j < dataHeight-1; ++j) {
-        for (int i = 1; i < dataWidth-1; ++i) {
+        const int row = j*dataWidth + 1;
+        for (int i = row; i < row + rowCount; ++i) {
 #if DUMP_EDGE
-            float alpha = currData->fAlpha;
+            float alpha = data.fAlpha[i];
             float edge = 0.0f;
-            if (*currEdge) {
+            if (edgePtr[i]) {
                 edge = 0.25f;
             }
             // blend with original image
@@ -441,18 +481,14 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
             *dfPtr++ = val;
 #else
             float dist;
-            if (currData->fAlpha > 0.5f) {
-                dist = -SkScalarSqrt(currData->fDistSq);
+            if (data.fAlpha[i] > 0.5f) {
+                dist = -data.fDistSq[i];
             } else {
-                dist = SkScalarSqrt(currData->fDistSq);
+                dist = data.fDistSq[i];
             }
             *dfPtr++ = pack_distance_field_val(dist, (float)SK_DistanceFieldMagnitude);
 #endif
-            ++currData;
-            ++currEdge;
         }
-        currData += 2;
-        currEdge += 2;
     }
 
     return true;
@@ -466,22 +502,21 @@ bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
     SkASSERT(image);
 
     // create temp data
-    SkAutoSMalloc<1024> copyStorage((width+2)*(height+2)*sizeof(char));
+    const int copyWidth = width + 2*kCopyPad;
+    const size_t copySize = copyWidth*(height + 2*kCopyPad)*sizeof(char);
+    SkAutoSMalloc<1024> copyStorage(copySize);
     unsigned char* copyPtr = (unsigned char*) copyStorage.get();
+    sk_bzero(copyPtr, copySize);
 
     // we copy our source image into a padded copy to ensure we catch edge transitions
     // around the outside
     const unsigned char* currSrcScanLine = image;
-    sk_bzero(copyPtr, (width+2)*sizeof(char));
-    unsigned char* currDestPtr = copyPtr + width + 2;
+    unsigned char* currDestPtr = copyPtr + kCopyPad*copyWidth + kCopyPad;
     for (int i = 0; i < height; ++i) {
-        *currDestPtr++ = 0;
-        memcpy(currDestPtr, currSrcScanLine, rowBytes);
+        memcpy(currDestPtr, currSrcScanLine, width);
         currSrcScanLine += rowBytes;
-        currDestPtr += width;
-        *currDestPtr++ = 0;
+        currDestPtr += copyWidth;
     }
-    sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
@@ -494,16 +529,18 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
     SkASSERT(image);
 
     // create temp data
-    SkAutoSMalloc<1024> copyStorage((width+2)*(height+2)*sizeof(char));
+    const int copyWidth = width + 2*kCopyPad;
+    const size_t copySize = copyWidth*(height + 2*kCopyPad)*sizeof(char);
+    SkAutoSMalloc<1024> copyStorage(copySize);
     unsigned char* copyPtr = (unsigned char*) copyStorage.get();
+    sk_bzero(copyPtr, copySize);
 
     // we copy our source image into a padded copy to ensure we catch edge transitions
     // around the outside
     const unsigned char* currSrcScanLine = image;
-    sk_bzero(copyPtr, (width+2)*sizeof(char));
-    unsigned char* currDestPtr = copyPtr + width + 2;
+    unsigned char* currDestRow = copyPtr + kCopyPad*copyWidth + kCopyPad;
     for (int i = 0; i < height; ++i) {
-        *currDestPtr++ = 0;
+        unsigned char* currDestPtr = currDestRow;
         int rowWritesLeft = width;
         const unsigned char *maskPtr = currSrcScanLine;
         while (rowWritesLeft > 0) {
@@ -513,9 +550,427 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
             }
         }
         currSrcScanLine += rowBytes;
-        *currDestPtr++ = 0;
+        currDestRow += copyWidth;
     }
-    sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
+
+struct DistanceFieldTask {
+    const SkDistanceFieldRequest* fRequest;
+    bool                          fSucceeded;
+};
+
+static void generate_distance_field_task(DistanceFieldTask* task) {
+    const SkDistanceFieldRequest& request = *task->fRequest;
+    if (request.fIsBW) {
+        task->fSucceeded = SkGenerateDistanceFieldFromBWImage(request.fDistanceField,
+                                                              request.fImage,
+                                                              request.fWidth, request.fHeight,
+                                                              request.fRowBytes);
+    } else {
+        task->fSucceeded = SkGenerateDistanceFieldFromA8Image(request.fDistanceField,
+                                                              request.fImage,
+                                                              request.fWidth, request.fHeight,
+                                                              request.fRowBytes);
+    }
+}
+
+bool SkGenerateDistanceFields(const SkDistanceFieldRequest requests[], int count) {
+    SkAutoSTMalloc<32, DistanceFieldTask> tasks(count);
+    for (int i = 0; i < count; ++i) {
+        tasks[i].fRequest = &requests[i];
+        tasks[i].fSucceeded = false;
+    }
+
+    SkTaskGroup tg;
+    tg.batch(generate_distance_field_task, tasks.get(), count);
+    tg.wait();
+
+    bool succeeded = true;
+    for (int i = 0; i < count; ++i) {
+        succeeded &= tasks[i].fSucceeded;
+    }
+    return succeeded;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Multi-channel distance fields
+//
+// Each edge of the outline (the run of segments between two of its verbs) is given a color, a
+// set of one to three of the r, g and b channels. Each channel then holds the signed distance to
+// the nearest edge of a color including that channel, extended past the edge's ends along its
+// tangents. Inside any corner the two edges meeting there have different colors, so the median
+// of the three channels, which is what the shader draws, keeps the corner sharp where a single
+// distance would round it off.
+
+namespace {
+
+enum {
+    kRed_EdgeColor     = 0x1,
+    kGreen_EdgeColor   = 0x2,
+    kBlue_EdgeColor    = 0x4,
+    kYellow_EdgeColor  = kRed_EdgeColor | kGreen_EdgeColor,
+    kMagenta_EdgeColor = kRed_EdgeColor | kBlue_EdgeColor,
+    kCyan_EdgeColor    = kGreen_EdgeColor | kBlue_EdgeColor,
+    kWhite_EdgeColor   = kRed_EdgeColor | kGreen_EdgeColor | kBlue_EdgeColor,
+};
+
+// Steps through cyan, magenta and yellow, so consecutive colors share exactly one channel.
+inline int next_edge_color(int color) {
+    int shifted = color << 1;
+    return (shifted | (shifted >> 3)) & kWhite_EdgeColor;
+}
+
+// Edges whose tangents turn by more than roughly 3 radians' worth of sine (or back on themselves)
+// meet at a corner.
+const SkScalar kCornerCrossThreshold = 0.1411f;
+
+struct MSDFEdge {
+    int      fFirstSegment;
+    int      fSegmentCount;
+    SkVector fStartTangent;
+    SkVector fEndTangent;
+    int      fColor;
+};
+
+struct MSDFSegment {
+    SkPoint fStart;
+    SkPoint fEnd;
+    int     fEdge;
+    bool    fStartsEdge;
+    bool    fEndsEdge;
+};
+
+struct MSDFContour {
+    int fFirstEdge;
+    int fEdgeCount;
+};
+
+class MSDFOutline {
+public:
+    explicit MSDFOutline(const SkPath& path) {
+        SkPath::Iter iter(path, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kMove_Verb:
+                    this->startContour();
+                    break;
+                case SkPath::kLine_Verb:
+                    this->addEdge(pts, 2, pts[1] - pts[0], pts[1] - pts[0]);
+                    break;
+                case SkPath::kQuad_Verb:
+                    this->addEdge(pts, 3, tangent(pts[0], pts[1], pts[2]),
+                                  tangent(pts[2], pts[1], pts[0], true));
+                    break;
+                case SkPath::kConic_Verb: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(), 0.25f);
+                    // One edge, made of all the quads.
+                    const int edge = this->beginEdge();
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->flatten(&quadPts[2 * i], 3);
+                    }
+                    this->endEdge(edge, tangent(pts[0], pts[1], pts[2]),
+                                  tangent(pts[2], pts[1], pts[0], true));
+                    break;
+                }
+                case SkPath::kCubic_Verb:
+                    this->addEdge(pts, 4, tangent(pts[0], pts[1], pts[2], false, &pts[3]),
+                                  tangent(pts[3], pts[2], pts[1], true, &pts[0]));
+                    break;
+                case SkPath::kClose_Verb:
+                default:
+                    break;
+            }
+        }
+        this->colorEdges();
+    }
+
+    const SkTDArray<MSDFEdge>& edges() const { return fEdges; }
+    const SkTDArray<MSDFSegment>& segments() const { return fSegments; }
+
+    // Twice the outline's signed area. Positive when the filled side is on the left of each
+    // segment's direction, in y-down coordinates.
+    SkScalar signedArea() const {
+        SkScalar area = 0;
+        for (int i = 0; i < fSegments.count(); ++i) {
+            area += fSegments[i].fStart.cross(fSegments[i].fEnd);
+        }
+        return area;
+    }
+
+private:
+    // The direction leaving p0, skipping control points that coincide with it. If reverse, the
+    // result is negated, so it points along the curve's direction into its end point.
+    static SkVector tangent(const SkPoint& p0, const SkPoint& p1, const SkPoint& p2,
+                            bool reverse = false, const SkPoint* p3 = NULL) {
+        SkVector v = p1 - p0;
+        if (SkScalarNearlyZero(v.lengthSqd())) {
+            v = p2 - p0;
+            if (p3 && SkScalarNearlyZero(v.lengthSqd())) {
+                v = *p3 - p0;
+            }
+        }
+        return reverse ? -v : v;
+    }
+
+    void startContour() {
+        MSDFContour* contour = fContours.append();
+        contour->fFirstEdge = fEdges.count();
+        contour->fEdgeCount = 0;
+    }
+
+    int beginEdge() {
+        if (fContours.isEmpty()) {
+            this->startContour();
+        }
+        MSDFEdge* edge = fEdges.append();
+        edge->fFirstSegment = fSegments.count();
+        edge->fSegmentCount = 0;
+        edge->fColor = kWhite_EdgeColor;
+        return fEdges.count() - 1;
+    }
+
+    void endEdge(int index, SkVector startTangent, SkVector endTangent) {
+        MSDFEdge& edge = fEdges[index];
+        edge.fSegmentCount = fSegments.count() - edge.fFirstSegment;
+        if (0 == edge.fSegmentCount || !startTangent.normalize() || !endTangent.normalize()) {
+            // Degenerate, so don't let it take part in the coloring.
+            fSegments.setCount(edge.fFirstSegment);
+            fEdges.setCount(index);
+            return;
+        }
+        edge.fStartTangent = startTangent;
+        edge.fEndTangent = endTangent;
+        fSegments[edge.fFirstSegment].fStartsEdge = true;
+        fSegments[edge.fFirstSegment + edge.fSegmentCount - 1].fEndsEdge = true;
+        fContours.top().fEdgeCount += 1;
+    }
+
+    void addEdge(const SkPoint pts[], int count, const SkVector& start, const SkVector& end) {
+        const int edge = this->beginEdge();
+        this->flatten(pts, count);
+        this->endEdge(edge, start, end);
+    }
+
+    // Appends line segments approximating the line, quad or cubic to the last edge, at about a
+    // texel per segment.
+    void flatten(const SkPoint pts[], int count) {
+        SkScalar hull = 0;
+        for (int i = 1; i < count; ++i) {
+            hull += SkPoint::Distance(pts[i - 1], pts[i]);
+        }
+        const int pieces = 2 == count ? 1 : SkPin32(SkScalarCeilToInt(hull), 1, 64);
+        SkPoint prev = pts[0];
+        for (int i = 1; i <= pieces; ++i) {
+            const SkScalar t = SkIntToScalar(i) / pieces;
+            SkPoint next;
+            if (2 == count) {
+                next = pts[1];
+            } else if (3 == count) {
+                next = SkEvalQuadAt(pts, t);
+            } else {
+                SkEvalCubicAt(pts, t, &next, NULL, NULL);
+            }
+            if (next != prev) {
+                MSDFSegment* segment = fSegments.append();
+                segment->fStart = prev;
+                segment->fEnd = next;
+                segment->fEdge = fEdges.count() - 1;
+                segment->fStartsEdge = false;
+                segment->fEndsEdge = false;
+                prev = next;
+            }
+        }
+    }
+
+    static bool is_corner(const SkVector& in, const SkVector& out) {
+        return in.dot(out) <= 0 || SkScalarAbs(in.cross(out)) > kCornerCrossThreshold;
+    }
+
+    void colorEdges() {
+        for (int c = 0; c < fContours.count(); ++c) {
+            MSDFEdge* edges = fEdges.begin() + fContours[c].fFirstEdge;
+            const int count = fContours[c].fEdgeCount;
+
+            SkTDArray<int> corners;
+            for (int i = 0; i < count; ++i) {
+                const SkVector& in = edges[(i + count - 1) % count].fEndTangent;
+                if (is_corner(in, edges[i].fStartTangent)) {
+                    *corners.append() = i;
+                }
+            }
+
+            if (corners.isEmpty()) {
+                // Smooth all the way round; every channel sees every edge.
+                continue;
+            }
+            if (1 == corners.count()) {
+                // A teardrop: split the edges in three either side of the corner, so its two
+                // sides differ in two channels.
+                if (count < 3) {
+                    continue;
+                }
+                static const int kColors[] = {
+                    kMagenta_EdgeColor, kWhite_EdgeColor, kYellow_EdgeColor
+                };
+                for (int i = 0; i < count; ++i) {
+                    const int index = (corners[0] + i) % count;
+                    edges[index].fColor = kColors[SkTMin(2, 3 * i / count)];
+                }
+                continue;
+            }
+
+            const int initialColor = kCyan_EdgeColor;
+            int color = initialColor;
+            int corner = 0;
+            for (int i = 0; i < count; ++i) {
+                const int index = (corners[0] + i) % count;
+                if (corner + 1 < corners.count() && corners[corner + 1] == index) {
+                    ++corner;
+                    color = next_edge_color(color);
+                    if (corner == corners.count() - 1 && color == initialColor) {
+                        // Don't let the last run match the first, across the first corner.
+                        color = next_edge_color(color);
+                    }
+                }
+                edges[index].fColor = color;
+            }
+        }
+    }
+
+    SkTDArray<MSDFContour> fContours;
+    SkTDArray<MSDFEdge>    fEdges;
+    SkTDArray<MSDFSegment> fSegments;
+};
+
+// The nearest edge found so far for one channel of one texel.
+struct MSDFTexel {
+    float fDistance;    // unsigned distance to the nearest segment
+    float fOrthogonal;  // how squarely that segment faces the texel, to break ties at joins
+    float fSigned;      // signed pseudo-distance, positive inside
+};
+
+}  // namespace
+
+bool SkGenerateMultiChannelDistanceFieldFromPath(SkPMColor* distanceField, const SkPath& path,
+                                                 int width, int height) {
+    SkASSERT(distanceField);
+
+    const int pad = SK_DistanceFieldPad;
+    const int dfWidth = width + 2 * pad;
+    const int dfHeight = height + 2 * pad;
+    const float magnitude = (float)SK_DistanceFieldMagnitude;
+
+    MSDFOutline outline(path);
+    const SkTDArray<MSDFSegment>& segments = outline.segments();
+    const SkTDArray<MSDFEdge>& edges = outline.edges();
+    const float orientation = outline.signedArea() < 0 ? -1.0f : 1.0f;
+
+    // Three channels, plus the nearest edge of any color for texels whose median comes out on
+    // the wrong side.
+    static const int kTracks = 4;
+    SkAutoTMalloc<MSDFTexel> texels(dfWidth * dfHeight * kTracks);
+    for (int i = 0; i < dfWidth * dfHeight * kTracks; ++i) {
+        texels[i].fDistance = SK_FloatInfinity;
+        texels[i].fOrthogonal = 0;
+        texels[i].fSigned = 0;
+    }
+
+    // Only texels within the magnitude of a segment can see it as anything but saturated.
+    const float reach = magnitude + 1;
+    for (int s = 0; s < segments.count(); ++s) {
+        const MSDFSegment& segment = segments[s];
+        const int color = edges[segment.fEdge].fColor | 0x8;   // the last track sees every edge
+        const SkVector dir = segment.fEnd - segment.fStart;
+        const float len2 = dir.lengthSqd();
+        const float len = sqrtf(len2);
+
+        SkRect bounds;
+        bounds.set(segment.fStart, segment.fEnd);
+        bounds.outset(reach, reach);
+        bounds.offset(SkIntToScalar(pad) - 0.5f, SkIntToScalar(pad) - 0.5f);
+        const int left = SkTMax(0, SkScalarCeilToInt(bounds.fLeft));
+        const int top = SkTMax(0, SkScalarCeilToInt(bounds.fTop));
+        const int right = SkTMin(dfWidth - 1, SkScalarFloorToInt(bounds.fRight));
+        const int bottom = SkTMin(dfHeight - 1, SkScalarFloorToInt(bounds.fBottom));
+
+        for (int y = top; y <= bottom; ++y) {
+            for (int x = left; x <= right; ++x) {
+                const SkPoint p = SkPoint::Make(x - pad + 0.5f, y - pad + 0.5f);
+                const SkVector fromStart = p - segment.fStart;
+                const float t = fromStart.dot(dir) / len2;
+                const float clampedT = SkScalarPin(t, 0, 1);
+                const SkPoint nearest = SkPoint::Make(segment.fStart.fX + clampedT * dir.fX,
+                                                      segment.fStart.fY + clampedT * dir.fY);
+                const SkVector toP = p - nearest;
+                const float distance = toP.length();
+                const float cross = dir.cross(toP);
+                const float orthogonal = distance > 0 ? SkScalarAbs(cross) / (len * distance)
+                                                      : 1.0f;
+
+                // Past either end of the edge, measure from the edge's tangent line instead, so
+                // the field stays straight beyond a corner.
+                float side = cross;
+                float pseudo = distance;
+                if (t < 0 && segment.fStartsEdge) {
+                    const SkVector& tan = edges[segment.fEdge].fStartTangent;
+                    side = tan.cross(fromStart);
+                    pseudo = SkTMin(distance, SkScalarAbs(side));
+                } else if (t > 1 && segment.fEndsEdge) {
+                    const SkVector& tan = edges[segment.fEdge].fEndTangent;
+                    side = tan.cross(p - segment.fEnd);
+                    pseudo = SkTMin(distance, SkScalarAbs(side));
+                }
+                const float sign = (side < 0 ? -1.0f : 1.0f) * orientation;
+
+                MSDFTexel* texel = &texels[(y * dfWidth + x) * kTracks];
+                for (int track = 0; track < kTracks; ++track, ++texel) {
+                    if (!(color & (1 << track))) {
+                        continue;
+                    }
+                    const float delta = distance - texel->fDistance;
+                    if (delta < -1e-4f || (delta <= 1e-4f && orthogonal > texel->fOrthogonal)) {
+                        texel->fDistance = distance;
+                        texel->fOrthogonal = orthogonal;
+                        texel->fSigned = sign * (track < 3 ? pseudo : distance);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int y = 0; y < dfHeight; ++y) {
+        for (int x = 0; x < dfWidth; ++x) {
+            const bool inside = path.contains(x - pad + 0.5f, y - pad + 0.5f);
+            const float saturated = inside ? magnitude : -magnitude;
+            const MSDFTexel* texel = &texels[(y * dfWidth + x) * kTracks];
+
+            float channels[3];
+            for (int i = 0; i < 3; ++i) {
+                channels[i] = texel[i].fDistance < SK_FloatInfinity ? texel[i].fSigned
+                                                                    : saturated;
+            }
+            const float median = SkTMax(SkTMin(channels[0], channels[1]),
+                                        SkTMin(SkTMax(channels[0], channels[1]), channels[2]));
+            if ((median > 0) != inside) {
+                // The channels disagree about this texel, so fall back to one plain distance.
+                const float single = texel[3].fDistance < SK_FloatInfinity
+                                   ? (inside ? texel[3].fDistance : -texel[3].fDistance)
+                                   : saturated;
+                channels[0] = channels[1] = channels[2] = single;
+            }
+
+            // pack_distance_field_val() takes distances that are negative inside.
+            *distanceField++ = SkPackARGB32(0xFF,
+                                            pack_distance_field_val(-channels[0], magnitude),
+                                            pack_distance_field_val(-channels[1], magnitude),
+                                            pack_distance_field_val(-channels[2], magnitude));
+        }
+    }
+
+    return true;
+}
@@ -7,7 +7,9 @@
 #ifndef SkDistanceFieldGen_DEFINED
 #define SkDistanceFieldGen_DEFINED
 
-#include "SkTypes.h"
+#include "SkColor.h"
+
+class SkPath;
 
 // the max magnitude for the distance field
 // distance values are limited to the range [-SK_DistanceFieldMagnitude, SK_DistanceFieldMagnitude)
@@ -50,6 +52,39 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
                                         const unsigned char* image,
                                         int w, int h, size_t rowBytes);
 
+/** One distance field for SkGenerateDistanceFields() to generate. */
+struct SkDistanceFieldRequest {
+    unsigned char*       fDistanceField;  // allocated by the client with the padding above
+    const unsigned char* fImage;
+    int                  fWidth;
+    int                  fHeight;
+    size_t               fRowBytes;
+    bool                 fIsBW;           // fImage is a 1-bit mask, rather than an 8-bit one
+};
+
+/** Generate many distance fields at once, as SkGenerateDistanceFieldFromA8Image() and
+ *  SkGenerateDistanceFieldFromBWImage() would one at a time. When SkTaskGroups are enabled,
+ *  they are generated in parallel on its threads.
+
+ *  @param requests          The distance fields to generate.
+ *  @param count             Number of requests.
+ *  @return                  true if every distance field was generated.
+ */
+bool SkGenerateDistanceFields(const SkDistanceFieldRequest requests[], int count);
+
+/** Given a glyph's outline, generate a multi-channel distance field for it. Each texel's r, g
+ *  and b bytes hold distances like those above, but to different subsets of the outline's edges,
+ *  so that the median of the three reproduces sharp corners that a single distance would round.
+
+ *  @param distanceField     The distance field to be generated, one SkPMColor per texel. Should
+ *                           already be allocated by the client with the padding above.
+ *  @param path              The outline, in the coordinates of the (unpadded) image it covers.
+ *  @param w                 Width of the original image.
+ *  @param h                 Height of the original image.
+ */
+bool SkGenerateMultiChannelDistanceFieldFromPath(SkPMColor* distanceField, const SkPath& path,
+                                                 int w, int h);
+
 /** Given width and height of original image, return size (in bytes) of distance field
  *  @param w                 Width of the original image.
  *  @param h                 Height of the original image.
@@ -10,8 +10,10 @@
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkDashPathPriv.h"
 #include "SkDevice.h"
 #include "SkDeviceLooper.h"
+#include "SkDrawArena.h"
 #include "SkFixed.h"
 #include "SkMaskFilter.h"
 #include "SkPaint.h"
@@ -24,6 +26,9 @@
 #include "SkSmallAllocator.h"
 #include "SkString.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
+#include "SkTArray.h"
+#include "SkTextAlongPath.h"
 #include "SkTextMapStateProc.h"
 #include "SkTLazy.h"
 #include "SkUtils.h"
@@ -537,6 +542,32 @@ PtProcRec::Proc PtProcRec::chooseProc(SkBlitter** blitterPtr) {
 // must be even for lines/polygon to work
 #define MAX_DEV_PTS     32
 
+// Strokes up to this wide (in device pixels) may skip SkStroke, see SkScan_ThinStroke.cpp
+static const SkScalar kMaxThinStrokeWidth = 3;
+
+/** Returns true if the (stroked) lines drawn with this paint and matrix can go straight to
+    SkScan::AntiThinStrokePath/Segments, and if so, returns their device width. The caller
+    checks the style, joins and geometry.
+ */
+static bool treat_as_thin_stroke(const SkPaint& paint, const SkMatrix& matrix,
+                                 SkScalar* devWidth) {
+#ifdef SK_IGNORE_THIN_STROKE_FASTPATH
+    return false;
+#else
+    if (!paint.isAntiAlias() || paint.getPathEffect() || paint.getMaskFilter() ||
+            paint.getRasterizer() || SkPaint::kSquare_Cap == paint.getStrokeCap() ||
+            !matrix.isSimilarity()) {
+        return false;
+    }
+    const SkScalar width = SkScalarMul(paint.getStrokeWidth(), matrix.getMaxScale());
+    if (!(width > 0 && width <= kMaxThinStrokeWidth)) {
+        return false;
+    }
+    *devWidth = width;
+    return true;
+#endif
+}
+
 void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
                         const SkPoint pts[], const SkPaint& paint,
                         bool forceUseDevice) const {
@@ -713,6 +744,19 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
                 }
                 // couldn't take fast path so fall through!
             case SkCanvas::kPolygon_PointMode: {
+                SkScalar thinWidth;
+                if (!forceUseDevice && treat_as_thin_stroke(paint, *fMatrix, &thinWidth)) {
+                    const int n = SkToInt(count);
+                    SkAutoSTMalloc<MAX_DEV_PTS, SkPoint> devPts(n);
+                    fMatrix->mapPoints(devPts.get(), pts, n);
+                    SkAutoBlitterChoose blitter(*fBitmap, *fMatrix, paint);
+                    SkScan::AntiThinStrokeSegments(devPts.get(), n,
+                                                   SkCanvas::kPolygon_PointMode == mode,
+                                                   thinWidth,
+                                                   SkPaint::kRound_Cap == paint.getStrokeCap(),
+                                                   *fRC, blitter.get());
+                    break;
+                }
                 count -= 1;
                 SkPath path;
                 SkPaint p(paint);
@@ -792,6 +836,38 @@ static SkPoint* rect_points(SkRect& r) {
     return SkTCast<SkPoint*>(&r);
 }
 
+static void blit_rect(SkDraw::RectType rtype, const SkRect& devRect, const SkPoint& strokeSize,
+                      bool antiAlias, const SkRasterClip& clip, SkBlitter* blitter) {
+    // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
+    // case we are also hairline (if we've gotten to here), which devolves to
+    // effectively just kFill
+    switch (rtype) {
+        case SkDraw::kFill_RectType:
+            if (antiAlias) {
+                SkScan::AntiFillRect(devRect, clip, blitter);
+            } else {
+                SkScan::FillRect(devRect, clip, blitter);
+            }
+            break;
+        case SkDraw::kStroke_RectType:
+            if (antiAlias) {
+                SkScan::AntiFrameRect(devRect, strokeSize, clip, blitter);
+            } else {
+                SkScan::FrameRect(devRect, strokeSize, clip, blitter);
+            }
+            break;
+        case SkDraw::kHair_RectType:
+            if (antiAlias) {
+                SkScan::AntiHairRect(devRect, clip, blitter);
+            } else {
+                SkScan::HairRect(devRect, clip, blitter);
+            }
+            break;
+        default:
+            SkDEBUGFAIL("bad rtype");
+    }
+}
+
 void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
                       const SkMatrix* paintMatrix, const SkRect* postPaintRect) const {
     SkDEBUGCODE(this->validate();)
@@ -864,33 +940,82 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         const SkRasterClip& clip = looper.getRC();
         SkBlitter*          blitter = blitterStorage.get();
 
-        // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
-        // case we are also hairline (if we've gotten to here), which devolves to
-        // effectively just kFill
-        switch (rtype) {
-            case kFill_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiFillRect(localDevRect, clip, blitter);
-                } else {
-                    SkScan::FillRect(localDevRect, clip, blitter);
-                }
-                break;
-            case kStroke_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiFrameRect(localDevRect, strokeSize, clip, blitter);
-                } else {
-                    SkScan::FrameRect(localDevRect, strokeSize, clip, blitter);
-                }
-                break;
-            case kHair_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiHairRect(localDevRect, clip, blitter);
-                } else {
-                    SkScan::HairRect(localDevRect, clip, blitter);
-                }
-                break;
-            default:
-                SkDEBUGFAIL("bad rtype");
+        blit_rect(rtype, localDevRect, strokeSize, paint.isAntiAlias(), clip, blitter);
+    }
+}
+
+void SkDraw::drawRects(const SkRect rects[], int count, const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (fRC->isEmpty() || count <= 0) {
+        return;
+    }
+
+    SkPoint strokeSize;
+    RectType rtype = ComputeRectType(paint, *fMatrix, &strokeSize);
+
+    if (kPath_RectType == rtype) {
+        for (int i = 0; i < count; ++i) {
+            this->drawRect(rects[i], paint);
+        }
+        return;
+    }
+
+    // Map every rect up front, remembering the (outset) device bounds of each one so we can
+    // cull them individually and find the area the looper has to cover.
+    SkAutoSTMalloc<32, SkRect> devRects(count);
+    SkAutoSTMalloc<32, SkIRect> devBounds(count);
+    SkScalar outsetX = 0, outsetY = 0;
+    if (paint.getStyle() != SkPaint::kFill_Style) {
+        // extra space for hairlines
+        if (paint.getStrokeWidth() == 0) {
+            outsetX = outsetY = 1;
+        } else {
+            const SkPoint& ssize = (kStroke_RectType == rtype)
+                ? strokeSize
+                : compute_stroke_size(paint, *fMatrix);
+            outsetX = SkScalarHalf(ssize.x());
+            outsetY = SkScalarHalf(ssize.y());
+        }
+    }
+
+    SkIRect unionBounds;
+    unionBounds.setEmpty();
+    for (int i = 0; i < count; ++i) {
+        SkRect& devRect = devRects[i];
+        fMatrix->mapPoints(rect_points(devRect), rect_points(rects[i]), 2);
+        devRect.sort();
+
+        SkRect bbox = devRect;
+        bbox.outset(outsetX, outsetY);
+        devBounds[i] = bbox.roundOut();
+        if (fRC->quickReject(devBounds[i])) {
+            devBounds[i].setEmpty();
+        } else {
+            unionBounds.join(devBounds[i]);
+        }
+    }
+    if (unionBounds.isEmpty()) {
+        return;
+    }
+
+    SkDeviceLooper looper(*fBitmap, *fRC, unionBounds, paint.isAntiAlias());
+    while (looper.next()) {
+        SkMatrix localMatrix;
+        looper.mapMatrix(&localMatrix, *fMatrix);
+
+        SkAutoBlitterChoose blitterStorage(looper.getBitmap(), localMatrix, paint);
+        const SkRasterClip& clip = looper.getRC();
+        SkBlitter*          blitter = blitterStorage.get();
+
+        for (int i = 0; i < count; ++i) {
+            if (devBounds[i].isEmpty()) {
+                continue;
+            }
+            SkRect localDevRect;
+            looper.mapRect(&localDevRect, devRects[i]);
+            blit_rect(rtype, localDevRect, strokeSize, paint.isAntiAlias(), clip, blitter);
         }
     }
 }
@@ -1015,6 +1140,112 @@ static SkScalar compute_res_scale_for_stroking(const SkMatrix& matrix) {
     return 1;
 }
 
+// Dashed paths with more than this many dashes are dashed and stroked a batch at a time, with
+// each batch's coverage unioned into an SkAAClip, so there is never a path of every dash.
+static const int kStreamDashCount = 4096;
+
+namespace {
+struct DashStreamRec {
+    DashStreamRec(const SkMatrix& matrix, const SkRasterClip& rc, bool doAA, SkAAClip* coverage)
+        : fMatrix(matrix)
+        , fClip(rc.getBounds())
+        , fDoAA(doAA)
+        , fBatchCount(0)
+        , fCoverage(coverage) {
+        if (rc.isBW()) {
+            fClip = rc.bwRgn();
+        }
+    }
+
+    const SkMatrix& fMatrix;
+    SkRegion        fClip;
+    bool            fDoAA;
+    int             fBatchCount;
+    SkPath          fFirstBatch;
+    SkAAClip*       fCoverage;
+};
+}
+
+static void accumulate_dash_coverage(const SkPath& dashes, const SkStrokeRec& rec,
+                                     DashStreamRec* stream) {
+    SkPath stroked;
+    const SkPath* fillPath = &dashes;
+    if (rec.applyToPath(&stroked, dashes)) {
+        fillPath = &stroked;
+    }
+    SkPath devPath;
+    fillPath->transform(stream->fMatrix, &devPath);
+
+    SkAAClip batch;
+    if (batch.setPath(devPath, &stream->fClip, stream->fDoAA)) {
+        stream->fCoverage->op(batch, SkRegion::kUnion_Op);
+    }
+}
+
+static void stream_dash_proc(const SkPath& dashes, const SkStrokeRec& rec, void* ctx) {
+    DashStreamRec* stream = static_cast<DashStreamRec*>(ctx);
+    // Hold on to the first batch: if it turns out to be the only one, it's drawn as a path.
+    if (0 == stream->fBatchCount++) {
+        stream->fFirstBatch = dashes;
+        return;
+    }
+    if (2 == stream->fBatchCount) {
+        accumulate_dash_coverage(stream->fFirstBatch, rec, stream);
+        stream->fFirstBatch.reset();
+    }
+    accumulate_dash_coverage(dashes, rec, stream);
+}
+
+// Applies a dash path effect, streaming the dashes if there are many of them. Returns false if
+// the paint's path effect should be applied as usual. Otherwise either dst and doFill are set as
+// SkPaint::getFillPath() would have, or streamed is set and coverage holds the device space
+// coverage of the stroked dashes, already clipped.
+static bool stream_dashes(const SkPath& src, const SkPaint& paint, const SkMatrix& matrix,
+                          const SkRasterClip& rc, const SkRect* cullRect, SkScalar resScale,
+                          SkPath* dst, bool* doFill, SkAAClip* coverage, bool* streamed) {
+    SkPathEffect* pathEffect = paint.getPathEffect();
+    if (NULL == pathEffect || SkPaint::kFill_Style == paint.getStyle() ||
+        paint.getRasterizer() || paint.getMaskFilter()) {
+        return false;
+    }
+
+    SkPathEffect::DashInfo info;
+    if (SkPathEffect::kDash_DashType != pathEffect->asADash(&info)) {
+        return false;
+    }
+
+    // Dashed hairlines are drawn without building their outlines, so are cheap to hold.
+    SkStrokeRec rec(paint, resScale);
+    if (rec.isHairlineStyle()) {
+        return false;
+    }
+
+    SkAutoSTMalloc<8, SkScalar> intervals(info.fCount);
+    info.fIntervals = intervals.get();
+    pathEffect->asADash(&info);
+
+    DashStreamRec stream(matrix, rc, paint.isAntiAlias(), coverage);
+    if (!SkDashPath::StreamDashPath(src, &rec, cullRect, info, kStreamDashCount,
+                                    stream_dash_proc, &stream)) {
+        coverage->setEmpty();
+        return false;
+    }
+
+    if (stream.fBatchCount <= 1) {
+        if (!rec.applyToPath(dst, stream.fFirstBatch)) {
+            dst->swap(stream.fFirstBatch);
+        }
+        *doFill = true;
+        return true;
+    }
+
+    if (rc.isAA()) {
+        coverage->op(rc.aaRgn(), SkRegion::kIntersect_Op);
+    }
+    *streamed = true;
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -1077,17 +1308,51 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
-    if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
+    SkAAClip dashCoverage;
+    bool dashesStreamed = false;
+
+    // Thin round-joined polylines are blitted directly, without building their outline.
+    SkScalar thinWidth = 0;
+    const bool thinStroke = SkPaint::kStroke_Style == paint->getStyle() &&
+                            SkPaint::kRound_Join == paint->getStrokeJoin() &&
+                            SkPath::kLine_SegmentMask == pathPtr->getSegmentMasks() &&
+                            !pathPtr->isInverseFillType() &&
+                            treat_as_thin_stroke(*paint, *matrix, &thinWidth);
+
+    if (thinStroke) {
+        doFill = false;
+    } else if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = NULL;
         if (this->computeConservativeLocalClipBounds(&cullRect)) {
             cullRectPtr = &cullRect;
         }
-        doFill = paint->getFillPath(*pathPtr, &tmpPath, cullRectPtr,
-                                    compute_res_scale_for_stroking(*fMatrix));
+        const SkScalar resScale = compute_res_scale_for_stroking(*fMatrix);
+        if (NULL == paint->getPathEffect() && SkStrokeCache::IsEnabled()) {
+            doFill = SkStrokeCache::GetFillPath(*paint, *pathPtr, &tmpPath, resScale);
+        } else if (!stream_dashes(*pathPtr, *paint, *matrix, *fRC, cullRectPtr, resScale,
+                                  &tmpPath, &doFill, &dashCoverage, &dashesStreamed)) {
+            doFill = paint->getFillPath(*pathPtr, &tmpPath, cullRectPtr, resScale);
+        }
         pathPtr = &tmpPath;
     }
 
+    if (dashesStreamed) {
+        SkAutoBlitterChoose blitterStorage;
+        SkBlitter* blitter = customBlitter;
+        if (NULL == blitter) {
+            blitterStorage.choose(*fBitmap, *fMatrix, *paint, drawCoverage);
+            blitter = blitterStorage.get();
+        }
+        if (!dashCoverage.isEmpty()) {
+            SkAAClipBlitter clipBlitter;
+            clipBlitter.init(blitter, &dashCoverage);
+            const SkIRect& bounds = dashCoverage.getBounds();
+            clipBlitter.blitRect(bounds.fLeft, bounds.fTop, bounds.width(), bounds.height());
+        }
+        return;
+    }
+
     if (paint->getRasterizer()) {
         SkMask  mask;
         if (paint->getRasterizer()->rasterize(*pathPtr, *matrix,
@@ -1114,6 +1379,12 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         blitter = customBlitter;
     }
 
+    if (thinStroke) {
+        SkScan::AntiThinStrokePath(*devPathPtr, thinWidth,
+                                   SkPaint::kRound_Cap == paint->getStrokeCap(), *fRC, blitter);
+        return;
+    }
+
     if (paint->getMaskFilter()) {
         SkPaint::Style style = doFill ? SkPaint::kFill_Style :
             SkPaint::kStroke_Style;
@@ -1197,8 +1468,8 @@ void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap,
         }
 
         // allocate (and clear) our temp buffer to hold the transformed bitmap
-        SkAutoMalloc    storage(size);
-        mask.fImage = (uint8_t*)storage.get();
+        SkAutoMalloc    storage;
+        mask.fImage = (uint8_t*)SkDrawArena::Alloc(size, &storage);
         memset(mask.fImage, 0, size);
 
         // now draw our bitmap(src) into mask(dst), transformed by the matrix
@@ -1870,6 +2141,292 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
     }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+bool SkDraw::CanDrawTextRSXform(const SkPaint& paint, const SkMatrix& ctm) {
+    // Each glyph's mask is drawn as an alpha bitmap, so nothing may need its outline, and the
+    // paint's color must be all there is to shade it with.
+    return SkPaint::kFill_Style == paint.getStyle() &&
+           !paint.isVerticalText() &&
+           NULL == paint.getPathEffect() &&
+           NULL == paint.getMaskFilter() &&
+           NULL == paint.getRasterizer() &&
+           NULL == paint.getShader() &&
+           !ShouldDrawTextAsPaths(paint, ctm);
+}
+
+void SkDraw::drawTextRSXform(const uint16_t glyphs[], const SkRSXform xforms[], int count,
+                             const SkPaint& paint) const {
+    SkASSERT(count == 0 || (glyphs != NULL && xforms != NULL));
+    SkASSERT(CanDrawTextRSXform(paint, *fMatrix));
+
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (0 == count || fRC->isEmpty()) {
+        return;
+    }
+
+    // The masks are rotated after they're rasterized, so rasterize them unrotated, at the size
+    // they'll end up. LCD masks can't be rotated, so draw those as plain A8.
+    const SkScalar scale = fMatrix->getMaxScale();
+    if (!(scale > 0)) {
+        return;
+    }
+    const SkScalar invScale = SkScalarInvert(scale);
+    SkMatrix scaleMatrix;
+    scaleMatrix.setScale(scale, scale);
+
+    SkPaint font(paint);
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    font.setTextAlign(SkPaint::kLeft_Align);
+    font.setLCDRenderText(false);
+
+    SkAutoGlyphCache    autoCache(font, &fDevice->getLeakyProperties(), &scaleMatrix);
+    SkGlyphCache*       cache = autoCache.getCache();
+
+    SkPaint bitmapPaint(paint);
+    bitmapPaint.setFilterQuality(kLow_SkFilterQuality);
+
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphs[i]);
+        if (0 == glyph.fWidth) {
+            continue;
+        }
+
+        SkMatrix m;
+        xforms[i].toMatrix(&m);
+        m.preScale(invScale, invScale);
+
+        const void* image = SkMask::kA8_Format == glyph.fMaskFormat ? cache->findImage(glyph)
+                                                                    : NULL;
+        if (image) {
+            SkBitmap mask;
+            if (mask.installPixels(SkImageInfo::MakeA8(glyph.fWidth, glyph.fHeight),
+                                   const_cast<void*>(image), glyph.rowBytes())) {
+                m.preTranslate(SkIntToScalar(glyph.fLeft), SkIntToScalar(glyph.fTop));
+                this->drawBitmap(mask, m, NULL, bitmapPaint);
+            }
+        } else if (const SkPath* path = cache->findPath(glyph)) {
+            // BW and color glyphs keep their own look by drawing the outline instead.
+            this->drawPath(*path, paint, &m, false);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Halos wider than this (in device pixels) are drawn by stroking the glyphs.
+static const int kMaxHaloRadius = 4;
+
+// Dilates the A8 mask src by radius into dst, whose bounds are src's outset by ceil(radius).
+// Each source pixel spreads its coverage over a disc, whose edge is antialiased.
+static void dilate_mask(const SkMask& src, SkScalar radius, const SkMask& dst) {
+    SkASSERT(SkMask::kA8_Format == src.fFormat && SkMask::kA8_Format == dst.fFormat);
+    const int r = SkScalarCeilToInt(radius);
+    SkASSERT(r > 0 && r <= kMaxHaloRadius);
+    SkASSERT(dst.fBounds.width() == src.fBounds.width() + 2*r);
+    SkASSERT(dst.fBounds.height() == src.fBounds.height() + 2*r);
+
+    const int size = 2*r + 1;
+    uint8_t weights[(2*kMaxHaloRadius + 1) * (2*kMaxHaloRadius + 1)];
+    for (int dy = -r; dy <= r; ++dy) {
+        for (int dx = -r; dx <= r; ++dx) {
+            SkScalar distance = SkScalarSqrt(SkIntToScalar(dx*dx + dy*dy));
+            SkScalar weight = SkScalarPin(radius + SK_ScalarHalf - distance, 0, SK_Scalar1);
+            weights[(dy + r)*size + dx + r] = SkToU8(SkScalarRoundToInt(weight * 255));
+        }
+    }
+    weights[r*size + r] = 0xFF;
+
+    sk_bzero(dst.fImage, dst.computeImageSize());
+    const int width = src.fBounds.width();
+    const int height = src.fBounds.height();
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* srcRow = src.fImage + y * src.fRowBytes;
+        for (int x = 0; x < width; ++x) {
+            const unsigned alpha = srcRow[x];
+            if (0 == alpha) {
+                continue;
+            }
+            for (int ky = 0; ky < size; ++ky) {
+                uint8_t* dstRow = dst.fImage + (y + ky) * dst.fRowBytes + x;
+                const uint8_t* w = &weights[ky*size];
+                for (int kx = 0; kx < size; ++kx) {
+                    const unsigned coverage = SkMulDiv255Round(alpha, w[kx]);
+                    if (coverage > dstRow[kx]) {
+                        dstRow[kx] = SkToU8(coverage);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void blit_halo_mask(const SkDraw1Glyph& state, const SkMask& mask) {
+    if (state.fClip && !state.fClip->isRect()) {
+        for (SkRegion::Cliperator clipper(*state.fClip, mask.fBounds); !clipper.done();
+             clipper.next()) {
+            state.blitMask(mask, clipper.rect());
+        }
+    } else {
+        SkIRect bounds;
+        if (bounds.intersect(mask.fBounds, state.fClipBounds)) {
+            state.blitMask(mask, bounds);
+        }
+    }
+}
+
+void SkDraw::drawPosTextHalo(const char text[], size_t byteLength,
+                             const SkScalar pos[], int scalarsPerPosition,
+                             const SkPoint& offset, const SkPaint& haloPaint,
+                             const SkPaint& paint) const {
+    SkASSERT(byteLength == 0 || text != NULL);
+    SkASSERT(1 == scalarsPerPosition || 2 == scalarsPerPosition);
+
+    SkDEBUGCODE(this->validate();)
+
+    // nothing to draw
+    if (text == NULL || byteLength == 0 || fRC->isEmpty()) {
+        return;
+    }
+
+    // The halo is paint's A8 glyph masks dilated by the halo radius, which matches stroking
+    // them with a round join as long as the matrix scales uniformly and nothing but the
+    // outline shapes the masks.
+    const SkScalar radius = SkScalarHalf(haloPaint.getStrokeWidth()) * fMatrix->getMaxScale();
+    bool canDilate = needsRasterTextBlit(*this) &&
+                     fMatrix->isSimilarity() &&
+                     radius > 0 && radius <= kMaxHaloRadius &&
+                     paint.isAntiAlias() &&
+                     !paint.isLCDRenderText() &&
+                     SkPaint::kFill_Style == paint.getStyle() &&
+                     SkPaint::kLeft_Align == paint.getTextAlign() &&
+                     NULL == paint.getPathEffect() &&
+                     NULL == paint.getMaskFilter() &&
+                     NULL == paint.getRasterizer() &&
+                     !ShouldDrawTextAsPaths(paint, *fMatrix);
+    if (!canDilate) {
+        this->drawPosText(text, byteLength, pos, scalarsPerPosition, offset, haloPaint);
+        this->drawPosText(text, byteLength, pos, scalarsPerPosition, offset, paint);
+        return;
+    }
+
+    SkDrawCacheProc     glyphCacheProc = paint.getDrawCacheProc();
+    SkAutoGlyphCache    autoCache(paint, &fDevice->getLeakyProperties(), fMatrix);
+    SkGlyphCache*       cache = autoCache.getCache();
+
+    // Look each glyph up once, remembering where it goes, as drawPosText() would draw it.
+    struct Glyph {
+        Sk48Dot16       fX, fY;
+        const SkGlyph*  fGlyph;
+    };
+    SkSTArray<64, Glyph, true> glyphs;
+
+    const char*        stop = text + byteLength;
+    SkTextMapStateProc tmsProc(*fMatrix, offset, scalarsPerPosition);
+    SkScalar halfSampleX = SK_ScalarHalf;
+    SkScalar halfSampleY = SK_ScalarHalf;
+    SkFixed fxMask = 0;
+    SkFixed fyMask = 0;
+    if (cache->isSubpixel()) {
+        fxMask = fyMask = ~0;
+        SkAxisAlignment baseline = SkComputeAxisAlignmentForHText(*fMatrix);
+        halfSampleX = halfSampleY = SkFixedToScalar(SkGlyph::kSubpixelRound);
+        if (kX_SkAxisAlignment == baseline) {
+            fyMask = 0;
+            halfSampleY = SK_ScalarHalf;
+        } else if (kY_SkAxisAlignment == baseline) {
+            fxMask = 0;
+            halfSampleX = SK_ScalarHalf;
+        }
+    }
+    const char* cursor = text;
+    const SkScalar* cursorPos = pos;
+    while (cursor < stop) {
+        SkPoint tmsLoc;
+        tmsProc(cursorPos, &tmsLoc);
+
+        Sk48Dot16 fx = SkScalarTo48Dot16(tmsLoc.fX + halfSampleX);
+        Sk48Dot16 fy = SkScalarTo48Dot16(tmsLoc.fY + halfSampleY);
+
+        const SkGlyph& glyph = glyphCacheProc(cache, &cursor, fx & fxMask, fy & fyMask);
+        if (glyph.fWidth) {
+            if (SkMask::kA8_Format != glyph.fMaskFormat) {
+                // color glyphs have no coverage to dilate
+                this->drawPosText(text, byteLength, pos, scalarsPerPosition, offset, haloPaint);
+                this->drawPosText(text, byteLength, pos, scalarsPerPosition, offset, paint);
+                return;
+            }
+            Glyph* g = &glyphs.push_back();
+            g->fX = fx;
+            g->fY = fy;
+            g->fGlyph = &glyph;
+        }
+        cursorPos += scalarsPerPosition;
+    }
+
+    SkAAClipBlitterWrapper haloWrapper, wrapper;
+    SkAutoBlitterChoose haloBlitter(*fBitmap, *fMatrix, haloPaint);
+    SkAutoBlitterChoose blitter(*fBitmap, *fMatrix, paint);
+    SkBlitter* haloBlit = haloBlitter.get();
+    SkBlitter* blit = blitter.get();
+    if (fRC->isAA()) {
+        haloWrapper.init(*fRC, haloBlit);
+        haloBlit = haloWrapper.getBlitter();
+        wrapper.init(*fRC, blit);
+        blit = wrapper.getBlitter();
+    }
+
+    // First all the halos, so that none of them covers a neighbouring glyph...
+    SkDraw1Glyph haloD1G;
+    haloD1G.init(this, haloBlit, cache, haloPaint);
+    const int r = SkScalarCeilToInt(radius);
+    SkAutoSMalloc<1024> storage;
+    for (int i = 0; i < glyphs.count(); ++i) {
+        const Sk48Dot16 fx = glyphs[i].fX;
+        const Sk48Dot16 fy = glyphs[i].fY;
+        // as in D1G_RectClip, skip glyphs outside of or straddling the edge of device space
+        if ((fx >> 16) > INT_MAX - (INT16_MAX + UINT16_MAX) ||
+            (fx >> 16) < INT_MIN - (INT16_MIN + 0 /*UINT16_MIN*/) ||
+            (fy >> 16) > INT_MAX - (INT16_MAX + UINT16_MAX) ||
+            (fy >> 16) < INT_MIN - (INT16_MIN + 0 /*UINT16_MIN*/)) {
+            continue;
+        }
+        const SkGlyph& glyph = *glyphs[i].fGlyph;
+        const uint8_t* image = (const uint8_t*)cache->findImage(glyph);
+        if (NULL == image) {
+            continue;
+        }
+        SkMask src;
+        src.fImage = const_cast<uint8_t*>(image);
+        src.fBounds.setXYWH(Sk48Dot16FloorToInt(fx) + glyph.fLeft,
+                            Sk48Dot16FloorToInt(fy) + glyph.fTop,
+                            glyph.fWidth, glyph.fHeight);
+        src.fRowBytes = glyph.rowBytes();
+        src.fFormat = SkMask::kA8_Format;
+
+        SkMask halo;
+        halo.fBounds = src.fBounds;
+        halo.fBounds.outset(r, r);
+        if (!SkIRect::Intersects(halo.fBounds, haloD1G.fClipBounds)) {
+            continue;
+        }
+        halo.fRowBytes = halo.fBounds.width();
+        halo.fFormat = SkMask::kA8_Format;
+        halo.fImage = (uint8_t*)storage.reset(halo.computeImageSize());
+        dilate_mask(src, radius, halo);
+        blit_halo_mask(haloD1G, halo);
+    }
+
+    // ...then the text over them, from the same glyphs.
+    SkDraw1Glyph d1g;
+    SkDraw1Glyph::Proc proc = d1g.init(this, blit, cache, paint);
+    for (int i = 0; i < glyphs.count(); ++i) {
+        proc(d1g, glyphs[i].fX, glyphs[i].fY, *glyphs[i].fGlyph);
+    }
+}
+
 #if defined _WIN32 && _MSC_VER >= 1300
 #pragma warning ( pop )
 #endif
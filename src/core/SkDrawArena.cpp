@@ -0,0 +1,113 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDrawArena.h"
+
+// Blocks start this big, and the arena hangs on to at most this much between draws.
+static const size_t kMinBlockSize = 4 * 1024;
+static const size_t kMaxRetainedSize = 1024 * 1024;
+
+SkDrawArena::SkDrawArena() : fBlock(-1), fUsed(0), fPeak(0), fDepth(0), fHeapAllocCount(0) {}
+
+SkDrawArena::~SkDrawArena() {
+    SkASSERT(0 == fDepth);
+    for (int i = 0; i < fBlocks.count(); ++i) {
+        sk_free(fBlocks[i].fMemory);
+    }
+}
+
+void* SkDrawArena::Create() { return SkNEW(SkDrawArena); }
+void SkDrawArena::Delete(void* arena) { SkDELETE((SkDrawArena*)arena); }
+
+char* SkDrawArena::newBlock(size_t size) {
+    fHeapAllocCount += 1;
+    return (char*)sk_malloc_throw(size);
+}
+
+void* SkDrawArena::alloc(size_t bytes) {
+    SkASSERT(fDepth > 0);
+    bytes = SkAlign8(bytes);
+    if (fBlock < 0 || fUsed + bytes > fBlocks[fBlock].fSize) {
+        // Move on to the next block, dropping any too small for this allocation.
+        size_t before = 0;
+        for (int i = 0; i <= fBlock; ++i) {
+            before += fBlocks[i].fSize;
+        }
+        while (fBlock + 1 < fBlocks.count() && fBlocks[fBlock + 1].fSize < bytes) {
+            sk_free(fBlocks[fBlock + 1].fMemory);
+            fBlocks.remove(fBlock + 1);
+        }
+        if (fBlock + 1 == fBlocks.count()) {
+            Block* block = fBlocks.append();
+            block->fSize = SkTMax(bytes, SkTMax(kMinBlockSize, before));
+            block->fMemory = this->newBlock(block->fSize);
+        }
+        fBlock += 1;
+        fUsed = 0;
+    }
+    void* ptr = fBlocks[fBlock].fMemory + fUsed;
+    fUsed += bytes;
+
+    size_t inUse = fUsed;
+    for (int i = 0; i < fBlock; ++i) {
+        inUse += fBlocks[i].fSize;
+    }
+    fPeak = SkTMax(fPeak, inUse);
+    return ptr;
+}
+
+void SkDrawArena::release(int block, size_t used) {
+    fBlock = block;
+    fUsed = used;
+    if (fDepth > 0 || fBlocks.count() < 2) {
+        return;
+    }
+    // The last draw spilled into more than one block. Merge them so the next one fits.
+    for (int i = 0; i < fBlocks.count(); ++i) {
+        sk_free(fBlocks[i].fMemory);
+    }
+    fBlocks.rewind();
+    fBlock = -1;
+    if (fPeak <= kMaxRetainedSize) {
+        Block* merged = fBlocks.append();
+        merged->fSize = fPeak;
+        merged->fMemory = this->newBlock(fPeak);
+        fBlock = 0;
+    }
+    fPeak = 0;
+}
+
+SkDrawArena::AutoScope::AutoScope() {
+    fArena = SkDrawArena::Get();
+    fBlock = fArena->fBlock;
+    fUsed = fArena->fUsed;
+    fArena->fDepth += 1;
+}
+
+SkDrawArena::AutoScope::~AutoScope() {
+    SkASSERT(fArena->fDepth > 0);
+    fArena->fDepth -= 1;
+    fArena->release(fBlock, fUsed);
+}
+
+SkDrawArena* SkDrawArena::Current() {
+    SkDrawArena* arena = (SkDrawArena*)SkTLS::Find(SkDrawArena::Create);
+    return arena && arena->fDepth > 0 ? arena : NULL;
+}
+
+void* SkDrawArena::Alloc(size_t bytes, SkAutoMalloc* storage) {
+    if (SkDrawArena* arena = Current()) {
+        return arena->alloc(bytes);
+    }
+    Get()->fHeapAllocCount += 1;
+    return storage->reset(bytes);
+}
+
+int SkDrawArena::HeapAllocCount() {
+    SkDrawArena* arena = (SkDrawArena*)SkTLS::Find(SkDrawArena::Create);
+    return arena ? arena->fHeapAllocCount : 0;
+}
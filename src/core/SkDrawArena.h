@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDrawArena_DEFINED
+#define SkDrawArena_DEFINED
+
+#include "SkTDArray.h"
+#include "SkTLS.h"
+#include "SkTypes.h"
+
+/**
+ *  Scratch memory for the temporaries of a single draw: blitter span buffers, supersampling
+ *  runs, edge lists and the like. Each thread has its own arena. An AutoScope marks the arena
+ *  when it begins and releases everything allocated since when it ends, so scopes must nest.
+ *  SkCanvas opens one around each draw call. When the outermost scope ends, the arena merges
+ *  its blocks into one, so the next draw of the same size finds all the room it needs without
+ *  going to the heap.
+ */
+class SkDrawArena : SkNoncopyable {
+public:
+    class AutoScope : SkNoncopyable {
+    public:
+        AutoScope();
+        ~AutoScope();
+
+    private:
+        SkDrawArena* fArena;
+        int          fBlock;
+        size_t       fUsed;
+    };
+
+    /**
+     *  Returns bytes of scratch memory, 8-byte aligned, that stays valid until the innermost
+     *  open AutoScope on this thread ends. If no scope is open, the memory comes from storage
+     *  instead, and lives as long as it does.
+     */
+    static void* Alloc(size_t bytes, SkAutoMalloc* storage);
+
+    /**
+     *  Returns this thread's arena if an AutoScope is open on it, or NULL. Callers making many
+     *  small allocations can look this up once and then call alloc() directly.
+     */
+    static SkDrawArena* Current();
+
+    /**
+     *  Returns bytes of memory, 8-byte aligned, that stays valid until the innermost open
+     *  AutoScope ends.
+     */
+    void* alloc(size_t bytes);
+
+    /**
+     *  The number of heap allocations made for scratch memory on this thread so far: the
+     *  arena's own blocks, plus what Alloc() got from storage when no scope was open.
+     */
+    static int HeapAllocCount();
+
+    ~SkDrawArena();
+
+private:
+    SkDrawArena();
+
+    void release(int block, size_t used);
+
+    static void* Create();
+    static void Delete(void*);
+    static SkDrawArena* Get() { return (SkDrawArena*)SkTLS::Get(Create, Delete); }
+
+    char* newBlock(size_t size);
+
+    struct Block {
+        char*  fMemory;
+        size_t fSize;
+    };
+    SkTDArray<Block> fBlocks;
+    int              fBlock;     // The block we're allocating from, or -1 if there are none.
+    size_t           fUsed;      // How much of fBlocks[fBlock] is in use.
+    size_t           fPeak;      // The most memory in use at once since the last merge.
+    int              fDepth;     // How many AutoScopes are open.
+    int              fHeapAllocCount;
+};
+
+#endif
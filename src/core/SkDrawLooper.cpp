@@ -66,3 +66,7 @@ void SkDrawLooper::computeFastBounds(const SkPaint& paint, const SkRect& s,
 bool SkDrawLooper::asABlurShadow(BlurShadowRec*) const {
     return false;
 }
+
+bool SkDrawLooper::asAHalo(HaloRec*) const {
+    return false;
+}
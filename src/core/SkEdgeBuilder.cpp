@@ -12,18 +12,13 @@
 #include "SkLineClipper.h"
 #include "SkGeometry.h"
 
-template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
-    return static_cast<T*>(alloc.allocThrow(sizeof(T)));
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
 SkEdgeBuilder::SkEdgeBuilder() : fAlloc(16*1024) {
+    fArena = NULL;
     fEdgeList = NULL;
 }
 
 void SkEdgeBuilder::addLine(const SkPoint pts[]) {
-    SkEdge* edge = typedAllocThrow<SkEdge>(fAlloc);
+    SkEdge* edge = this->allocEdge<SkEdge>();
     if (edge->setLine(pts[0], pts[1], fShiftUp)) {
         fList.push(edge);
     } else {
@@ -32,7 +27,7 @@ void SkEdgeBuilder::addLine(const SkPoint pts[]) {
 }
 
 void SkEdgeBuilder::addQuad(const SkPoint pts[]) {
-    SkQuadraticEdge* edge = typedAllocThrow<SkQuadraticEdge>(fAlloc);
+    SkQuadraticEdge* edge = this->allocEdge<SkQuadraticEdge>();
     if (edge->setQuadratic(pts, fShiftUp)) {
         fList.push(edge);
     } else {
@@ -41,7 +36,7 @@ void SkEdgeBuilder::addQuad(const SkPoint pts[]) {
 }
 
 void SkEdgeBuilder::addCubic(const SkPoint pts[]) {
-    SkCubicEdge* edge = typedAllocThrow<SkCubicEdge>(fAlloc);
+    SkCubicEdge* edge = this->allocEdge<SkCubicEdge>();
     if (edge->setCubic(pts, fShiftUp)) {
         fList.push(edge);
     } else {
@@ -96,7 +91,7 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
     size_t maxEdgePtrSize = maxEdgeCount * sizeof(SkEdge*);
 
     // lets store the edges and their pointers in the same block
-    char* storage = (char*)fAlloc.allocThrow(maxEdgeSize + maxEdgePtrSize);
+    char* storage = (char*)this->allocEdgeMemory(maxEdgeSize + maxEdgePtrSize);
     SkEdge* edge = reinterpret_cast<SkEdge*>(storage);
     SkEdge** edgePtr = reinterpret_cast<SkEdge**>(storage + maxEdgeSize);
     // Record the beginning of our pointers, so we can return them to the caller
@@ -164,6 +159,7 @@ static void handle_quad(SkEdgeBuilder* builder, const SkPoint pts[3]) {
 int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, int shiftUp,
                          bool canCullToTheRight) {
     fAlloc.reset();
+    fArena = SkDrawArena::Current();
     fList.reset();
     fShiftUp = shiftUp;
 
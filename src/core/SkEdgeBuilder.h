@@ -9,6 +9,7 @@
 #define SkEdgeBuilder_DEFINED
 
 #include "SkChunkAlloc.h"
+#include "SkDrawArena.h"
 #include "SkRect.h"
 #include "SkTDArray.h"
 
@@ -27,7 +28,8 @@ public:
     SkEdge** edgeList() { return fEdgeList; }
 
 private:
-    SkChunkAlloc        fAlloc;
+    SkChunkAlloc        fAlloc;     // Only used when there's no SkDrawArena to use instead.
+    SkDrawArena*        fArena;
     SkTDArray<SkEdge*>  fList;
 
     /*
@@ -40,6 +42,14 @@ private:
 
     int         fShiftUp;
 
+    void* allocEdgeMemory(size_t bytes) {
+        return fArena ? fArena->alloc(bytes) : fAlloc.allocThrow(bytes);
+    }
+
+    template <typename T> T* allocEdge() {
+        return static_cast<T*>(this->allocEdgeMemory(sizeof(T)));
+    }
+
 public:
     void addLine(const SkPoint pts[]);
     void addQuad(const SkPoint pts[]);
@@ -45,8 +45,7 @@ static bool sort_increasing_Y(SkPoint dst[], const SkPoint src[], int count) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool chopMonoQuadAt(SkScalar c0, SkScalar c1, SkScalar c2,
-                           SkScalar target, SkScalar* t) {
+bool SkChopMonoQuadAt(SkScalar c0, SkScalar c1, SkScalar c2, SkScalar target, SkScalar* t) {
     /* Solve F(t) = y where F(t) := [0](1-t)^2 + 2[1]t(1-t) + [2]t^2
      *  We solve for t, using quadratic equation, hence we have to rearrange
      * our cooefficents to look like At^2 + Bt + C
@@ -65,11 +64,11 @@ static bool chopMonoQuadAt(SkScalar c0, SkScalar c1, SkScalar c2,
 }
 
 static bool chopMonoQuadAtY(SkPoint pts[3], SkScalar y, SkScalar* t) {
-    return chopMonoQuadAt(pts[0].fY, pts[1].fY, pts[2].fY, y, t);
+    return SkChopMonoQuadAt(pts[0].fY, pts[1].fY, pts[2].fY, y, t);
 }
 
 static bool chopMonoQuadAtX(SkPoint pts[3], SkScalar x, SkScalar* t) {
-    return chopMonoQuadAt(pts[0].fX, pts[1].fX, pts[2].fX, x, t);
+    return SkChopMonoQuadAt(pts[0].fX, pts[1].fX, pts[2].fX, x, t);
 }
 
 // Modify pts[] in place so that it is clipped in Y to the clip rect
@@ -233,8 +232,8 @@ static SkScalar eval_cubic_coeff(SkScalar A, SkScalar B, SkScalar C,
 /*  Given 4 cubic points (either Xs or Ys), and a target X or Y, compute the
     t value such that cubic(t) = target
  */
-static bool chopMonoCubicAt(SkScalar c0, SkScalar c1, SkScalar c2, SkScalar c3,
-                           SkScalar target, SkScalar* t) {
+bool SkChopMonoCubicAt(SkScalar c0, SkScalar c1, SkScalar c2, SkScalar c3,
+                       SkScalar target, SkScalar* t) {
  //   SkASSERT(c0 <= c1 && c1 <= c2 && c2 <= c3);
     SkASSERT(c0 < target && target < c3);
 
@@ -268,11 +267,11 @@ static bool chopMonoCubicAt(SkScalar c0, SkScalar c1, SkScalar c2, SkScalar c3,
 }
 
 static bool chopMonoCubicAtY(SkPoint pts[4], SkScalar y, SkScalar* t) {
-    return chopMonoCubicAt(pts[0].fY, pts[1].fY, pts[2].fY, pts[3].fY, y, t);
+    return SkChopMonoCubicAt(pts[0].fY, pts[1].fY, pts[2].fY, pts[3].fY, y, t);
 }
 
 static bool chopMonoCubicAtX(SkPoint pts[4], SkScalar x, SkScalar* t) {
-    return chopMonoCubicAt(pts[0].fX, pts[1].fX, pts[2].fX, pts[3].fX, x, t);
+    return SkChopMonoCubicAt(pts[0].fX, pts[1].fX, pts[2].fX, pts[3].fX, x, t);
 }
 
 // Modify pts[] in place so that it is clipped in Y to the clip rect
@@ -45,6 +45,14 @@ private:
     void appendCubic(const SkPoint pts[4], bool reverse);
 };
 
+/** Given one coordinate (all Xs or all Ys) of a quad or cubic that is monotonic in it, compute
+    the t at which the curve reaches target. The cubic's coordinates must be increasing, with
+    c0 < target < c3.
+ */
+bool SkChopMonoQuadAt(SkScalar c0, SkScalar c1, SkScalar c2, SkScalar target, SkScalar* t);
+bool SkChopMonoCubicAt(SkScalar c0, SkScalar c1, SkScalar c2, SkScalar c3,
+                       SkScalar target, SkScalar* t);
+
 #ifdef SK_DEBUG
     void sk_assert_monotonic_x(const SkPoint pts[], int count);
     void sk_assert_monotonic_y(const SkPoint pts[], int count);
@@ -30,7 +30,7 @@ template <typename T> void* skia_alloc_func(void*, T items, T size) {
 
 static void skia_free_func(void*, void* address) { sk_free(address); }
 
-bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
+bool doInflate(SkStream* src, SkWStream* dst) {
     uint8_t inputBuffer[kBufferSize];
     uint8_t outputBuffer[kBufferSize];
     z_stream flateData;
@@ -41,11 +41,7 @@ bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
     flateData.avail_in = 0;
     flateData.next_out = outputBuffer;
     flateData.avail_out = kBufferSize;
-    int rc;
-    if (compress)
-        rc = deflateInit(&flateData, Z_DEFAULT_COMPRESSION);
-    else
-        rc = inflateInit(&flateData);
+    int rc = inflateInit(&flateData);
     if (rc != Z_OK)
         return false;
 
@@ -81,16 +77,10 @@ bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
             flateData.next_in = inputBuffer;
             flateData.avail_in = SkToUInt(read);
         }
-        if (compress)
-            rc = deflate(&flateData, Z_NO_FLUSH);
-        else
-            rc = inflate(&flateData, Z_NO_FLUSH);
+        rc = inflate(&flateData, Z_NO_FLUSH);
     }
     while (rc == Z_OK) {
-        if (compress)
-            rc = deflate(&flateData, Z_FINISH);
-        else
-            rc = inflate(&flateData, Z_FINISH);
+        rc = inflate(&flateData, Z_FINISH);
         if (flateData.avail_out < kBufferSize) {
             if (!dst->write(outputBuffer, kBufferSize - flateData.avail_out))
                 return false;
@@ -99,10 +89,7 @@ bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
         }
     }
 
-    if (compress)
-        deflateEnd(&flateData);
-    else
-        inflateEnd(&flateData);
+    inflateEnd(&flateData);
     if (rc == Z_STREAM_END)
         return true;
     return false;
@@ -112,25 +99,45 @@ bool doFlate(bool compress, SkStream* src, SkWStream* dst) {
 
 // static
 bool SkFlate::Deflate(SkStream* src, SkWStream* dst) {
-    return doFlate(true, src, dst);
+    SkDeflateWStream deflateWStream(dst);
+    uint8_t inputBuffer[kBufferSize];
+    bool success = true;
+    while (success) {
+        // Compress memory streams in place, and read anything else through a buffer.
+        size_t size;
+        if (const void* memory = src->peekMemory(&size)) {
+            if (0 == size) {
+                break;
+            }
+            success = deflateWStream.write(memory, size);
+            src->skip(size);
+        } else {
+            size = src->read(inputBuffer, kBufferSize);
+            if (0 == size) {
+                break;
+            }
+            success = deflateWStream.write(inputBuffer, size);
+        }
+    }
+    return deflateWStream.finalize() && success;
 }
 
 bool SkFlate::Deflate(const void* ptr, size_t len, SkWStream* dst) {
-    SkMemoryStream stream(ptr, len);
-    return doFlate(true, &stream, dst);
+    SkDeflateWStream deflateWStream(dst);
+    bool success = deflateWStream.write(ptr, len);
+    return deflateWStream.finalize() && success;
 }
 
 bool SkFlate::Deflate(const SkData* data, SkWStream* dst) {
     if (data) {
-        SkMemoryStream stream(data->data(), data->size());
-        return doFlate(true, &stream, dst);
+        return Deflate(data->data(), data->size(), dst);
     }
     return false;
 }
 
 // static
 bool SkFlate::Inflate(SkStream* src, SkWStream* dst) {
-    return doFlate(false, src, dst);
+    return doInflate(src, dst);
 }
 
 
@@ -139,15 +146,19 @@ bool SkFlate::Inflate(SkStream* src, SkWStream* dst) {
                                                   // enough to always do a
                                                   // single loop.
 
-// called by both write() and finalize()
-static void do_deflate(int flush,
+// called by both write() and finalize().  Returns false if writing to out
+// failed.
+static bool do_deflate(int flush,
                        z_stream* zStream,
                        SkWStream* out,
-                       unsigned char* inBuffer,
+                       const unsigned char* inBuffer,
                        size_t inBufferSize) {
-    zStream->next_in = inBuffer;
-    zStream->avail_in = SkToInt(inBufferSize);
+    // zlib doesn't write through next_in, but only declares it const when
+    // built with ZLIB_CONST.
+    zStream->next_in = const_cast<unsigned char*>(inBuffer);
+    zStream->avail_in = SkToUInt(inBufferSize);
     unsigned char outBuffer[SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE];
+    bool success = true;
     SkDEBUGCODE(int returnValue;)
     do {
         zStream->next_out = outBuffer;
@@ -155,11 +166,15 @@ static void do_deflate(int flush,
         SkDEBUGCODE(returnValue =) deflate(zStream, flush);
         SkASSERT(!zStream->msg);
 
-        out->write(outBuffer, sizeof(outBuffer) - zStream->avail_out);
+        size_t compressed = sizeof(outBuffer) - zStream->avail_out;
+        if (compressed > 0 && !out->write(outBuffer, compressed)) {
+            success = false;
+        }
     } while (zStream->avail_in || !zStream->avail_out);
     SkASSERT(flush == Z_FINISH
                  ? returnValue == Z_STREAM_END
-                 : returnValue == Z_OK);
+                 : returnValue == Z_OK || returnValue == Z_BUF_ERROR);
+    return success;
 }
 
 // Hide all zlib impl details.
@@ -167,41 +182,76 @@ struct SkDeflateWStream::Impl {
     SkWStream* fOut;
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
+    bool fFailed;  // A write to fOut failed.
     z_stream fZStream;
 };
 
-SkDeflateWStream::SkDeflateWStream(SkWStream* out)
+static int zlib_strategy(SkDeflateWStream::Strategy strategy) {
+    switch (strategy) {
+        case SkDeflateWStream::kDefault_Strategy:     return Z_DEFAULT_STRATEGY;
+        case SkDeflateWStream::kFiltered_Strategy:    return Z_FILTERED;
+        case SkDeflateWStream::kHuffmanOnly_Strategy: return Z_HUFFMAN_ONLY;
+        case SkDeflateWStream::kRLE_Strategy:         return Z_RLE;
+    }
+    SkFAIL("Unknown strategy");
+    return Z_DEFAULT_STRATEGY;
+}
+
+SkDeflateWStream::SkDeflateWStream(SkWStream* out,
+                                   int compressionLevel,
+                                   Strategy strategy)
     : fImpl(SkNEW(SkDeflateWStream::Impl)) {
+    SkASSERT(kDefaultCompressionLevel == Z_DEFAULT_COMPRESSION);
+    SkASSERT(compressionLevel == kDefaultCompressionLevel ||
+             (compressionLevel >= 0 && compressionLevel <= 9));
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fFailed = false;
     if (!fImpl->fOut) {
         return;
     }
     fImpl->fZStream.zalloc = &skia_alloc_func;
     fImpl->fZStream.zfree = &skia_free_func;
     fImpl->fZStream.opaque = NULL;
-    SkDEBUGCODE(int r =) deflateInit(&fImpl->fZStream, Z_DEFAULT_COMPRESSION);
+    // 15 and 8 are zlib's defaults for the window size and memory level.
+    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
+                                      Z_DEFLATED, 15, 8,
+                                      zlib_strategy(strategy));
     SkASSERT(Z_OK == r);
 }
 
 SkDeflateWStream::~SkDeflateWStream() { this->finalize(); }
 
-void SkDeflateWStream::finalize() {
+bool SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
-        return;
+        return !fImpl->fFailed;
+    }
+    if (!do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
+                    fImpl->fInBufferIndex)) {
+        fImpl->fFailed = true;
     }
-    do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
-               fImpl->fInBufferIndex);
+    fImpl->fInBufferIndex = 0;
     (void)deflateEnd(&fImpl->fZStream);
     fImpl->fOut = NULL;
+    return !fImpl->fFailed;
 }
 
 bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
     if (!fImpl->fOut) {
         return false;
     }
-    const char* buffer = (const char*)void_buffer;
+    const unsigned char* buffer = (const unsigned char*)void_buffer;
     while (len > 0) {
+        // With nothing buffered, compress a write of a whole buffer or more
+        // straight from the caller's memory.
+        if (0 == fImpl->fInBufferIndex && len >= sizeof(fImpl->fInBuffer)) {
+            if (!do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
+                            buffer, len)) {
+                fImpl->fFailed = true;
+            }
+            break;
+        }
+
         size_t tocopy =
                 SkTMin(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
         memcpy(fImpl->fInBuffer + fImpl->fInBufferIndex, buffer, tocopy);
@@ -212,12 +262,14 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 
         // if the buffer isn't filled, don't call into zlib yet.
         if (sizeof(fImpl->fInBuffer) == fImpl->fInBufferIndex) {
-            do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
-                       fImpl->fInBuffer, fImpl->fInBufferIndex);
+            if (!do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
+                            fImpl->fInBuffer, fImpl->fInBufferIndex)) {
+                fImpl->fFailed = true;
+            }
             fImpl->fInBufferIndex = 0;
         }
     }
-    return true;
+    return !fImpl->fFailed;
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
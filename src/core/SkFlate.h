@@ -22,7 +22,8 @@ class SkFlate {
 public:
     /**
      *  Use the flate compression algorithm to compress the data in src,
-     *  putting the result into dst.  Returns false if an error occurs.
+     *  from its current position to its end, putting the result into dst.
+     *  Returns false if an error occurs.
      */
     static bool Deflate(SkStream* src, SkWStream* dst);
 
@@ -46,22 +47,45 @@ public:
 
 /**
   * Wrap a stream in this class to compress the information written to
-  * this stream using the Deflate algorithm.  Uses Zlib's
-  * Z_DEFAULT_COMPRESSION level.
+  * this stream using the Deflate algorithm.  Compressed data is written
+  * through to the wrapped stream as it is produced, so the whole input is
+  * never held in memory.  Large writes are compressed straight from the
+  * caller's memory; small ones are gathered into a 4K buffer first.
   *
   * See http://en.wikipedia.org/wiki/DEFLATE
   */
 class SkDeflateWStream : public SkWStream {
 public:
-    /** Does not take ownership of the stream. */
-    SkDeflateWStream(SkWStream*);
+    /** How zlib looks for repeated strings.  See zlib's deflateInit2. */
+    enum Strategy {
+        kDefault_Strategy,
+        // Favors Huffman coding over string matching, for data that is
+        // mostly small, somewhat random values, like filtered image rows.
+        kFiltered_Strategy,
+        // No string matching at all: the fastest, and the least compression.
+        kHuffmanOnly_Strategy,
+        // Only matches runs of one byte, nearly as fast as kHuffmanOnly, but
+        // much better on images with flat areas.
+        kRLE_Strategy,
+    };
+
+    /** zlib's Z_DEFAULT_COMPRESSION, currently the same as level 6. */
+    static const int kDefaultCompressionLevel = -1;
+
+    /** Does not take ownership of the stream.  compressionLevel goes from
+        0 (store only, fastest) to 9 (smallest output, slowest), or is
+        kDefaultCompressionLevel. */
+    SkDeflateWStream(SkWStream*,
+                     int compressionLevel = kDefaultCompressionLevel,
+                     Strategy = kDefault_Strategy);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream();
 
     /** Write the end of the compressed stream.  All subsequent calls to
-        write() will fail. Subsequent calls to finalize() do nothing. */
-    void finalize();
+        write() will fail. Subsequent calls to finalize() do nothing.
+        Returns false if any write to the wrapped stream failed. */
+    bool finalize();
 
     // The SkWStream interface:
     bool write(const void*, size_t) override;
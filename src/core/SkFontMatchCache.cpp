@@ -0,0 +1,171 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFontMatchCache.h"
+#include "SkTypeface.h"
+
+// Like SkTypefaceCache, start over rather than track use once there are this many entries.
+#define FONT_MATCH_CACHE_LIMIT  1024
+
+// Keys are the request's fields, with a separator that can't appear in family names or
+// language tags.
+static const char kSeparator = '\x1f';
+
+static void append_family_style(SkString* key, char kind, const char familyName[],
+                                const SkFontStyle& style) {
+    key->append(&kind, 1);
+    if (familyName) {
+        key->append(familyName);
+    } else {
+        // Distinguishes no family from the empty one.
+        key->append(&kSeparator, 1);
+    }
+    key->append(&kSeparator, 1);
+    key->appendS32(style.weight());
+    key->append(&kSeparator, 1);
+    key->appendS32(style.width());
+    key->append(&kSeparator, 1);
+    key->appendS32(style.slant());
+}
+
+static SkString make_style_key(const char familyName[], const SkFontStyle& style) {
+    SkString key;
+    append_family_style(&key, 's', familyName, style);
+    return key;
+}
+
+static SkString make_range_key(const char familyName[], const SkFontStyle& style,
+                               const char* bcp47[], int bcp47Count, SkUnichar character) {
+    SkString key;
+    append_family_style(&key, 'c', familyName, style);
+    for (int i = 0; i < bcp47Count; ++i) {
+        key.append(&kSeparator, 1);
+        key.append(bcp47[i]);
+    }
+    key.append(&kSeparator, 1);
+    key.appendU32(SkToU32(character) >> SkFontMatchCache::kRangeShift);
+    return key;
+}
+
+static bool has_glyph(SkTypeface* face, SkUnichar character) {
+    uint16_t glyph = 0;
+    face->charsToGlyphs(&character, SkTypeface::kUTF32_Encoding, &glyph, 1);
+    return 0 != glyph;
+}
+
+SkFontMatchCache::SkFontMatchCache() {
+    fStats.fHits = 0;
+    fStats.fMisses = 0;
+}
+
+SkFontMatchCache::~SkFontMatchCache() {
+    this->purgeAllLocked();
+}
+
+bool SkFontMatchCache::findStyle(const char familyName[], const SkFontStyle& style,
+                                 SkTypeface** result) const {
+    SkString key = make_style_key(familyName, style);
+    SkAutoMutexAcquire ama(fMutex);
+    SkTypeface** face = fStyles.find(key);
+    if (NULL == face) {
+        fStats.fMisses++;
+        return false;
+    }
+    fStats.fHits++;
+    *result = SkSafeRef(*face);
+    return true;
+}
+
+void SkFontMatchCache::addStyle(const char familyName[], const SkFontStyle& style,
+                                SkTypeface* result) {
+    SkString key = make_style_key(familyName, style);
+    SkAutoMutexAcquire ama(fMutex);
+    if (fStyles.find(key)) {
+        // Another thread looked it up at the same time.
+        return;
+    }
+    this->purgeIfFull();
+    fStyles.set(key, SkSafeRef(result));
+}
+
+bool SkFontMatchCache::findCharacter(const char familyName[], const SkFontStyle& style,
+                                     const char* bcp47[], int bcp47Count, SkUnichar character,
+                                     SkTypeface** result) const {
+    SkString key = make_range_key(familyName, style, bcp47, bcp47Count, character);
+    const int bit = character & (kRangeSize - 1);
+
+    SkAutoMutexAcquire ama(fMutex);
+    Range** range = fRanges.find(key);
+    if (range) {
+        if ((*range)->fMissing[bit >> 5] & (1 << (bit & 31))) {
+            fStats.fHits++;
+            *result = NULL;
+            return true;
+        }
+        const SkTDArray<SkTypeface*>& faces = (*range)->fFaces;
+        for (int i = 0; i < faces.count(); ++i) {
+            if (has_glyph(faces[i], character)) {
+                fStats.fHits++;
+                *result = SkRef(faces[i]);
+                return true;
+            }
+        }
+    }
+    fStats.fMisses++;
+    return false;
+}
+
+void SkFontMatchCache::addCharacter(const char familyName[], const SkFontStyle& style,
+                                    const char* bcp47[], int bcp47Count, SkUnichar character,
+                                    SkTypeface* result) {
+    SkString key = make_range_key(familyName, style, bcp47, bcp47Count, character);
+    const int bit = character & (kRangeSize - 1);
+
+    SkAutoMutexAcquire ama(fMutex);
+    Range** found = fRanges.find(key);
+    Range* range;
+    if (found) {
+        range = *found;
+    } else {
+        this->purgeIfFull();
+        range = SkNEW(Range);
+        sk_bzero(range->fMissing, sizeof(range->fMissing));
+        fRanges.set(key, range);
+    }
+
+    if (NULL == result) {
+        range->fMissing[bit >> 5] |= 1 << (bit & 31);
+    } else if (range->fFaces.find(result) < 0) {
+        *range->fFaces.append() = SkRef(result);
+    }
+}
+
+void SkFontMatchCache::purgeAll() {
+    SkAutoMutexAcquire ama(fMutex);
+    this->purgeAllLocked();
+}
+
+void SkFontMatchCache::getStats(Stats* stats) const {
+    SkAutoMutexAcquire ama(fMutex);
+    *stats = fStats;
+}
+
+void SkFontMatchCache::purgeIfFull() {
+    if (fStyles.count() + fRanges.count() >= FONT_MATCH_CACHE_LIMIT) {
+        this->purgeAllLocked();
+    }
+}
+
+void SkFontMatchCache::purgeAllLocked() {
+    fStyles.foreach([](const SkString&, SkTypeface** face) { SkSafeUnref(*face); });
+    fStyles.reset();
+    fRanges.foreach([](const SkString&, Range** range) {
+        (*range)->fFaces.unrefAll();
+        SkDELETE(*range);
+    });
+    fRanges.reset();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFontMatchCache_DEFINED
+#define SkFontMatchCache_DEFINED
+
+#include "SkFontStyle.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+#include "SkTHash.h"
+#include "SkThread.h"
+
+class SkTypeface;
+
+/**
+ *  Remembers what a font manager's matchFamilyStyle() and matchFamilyStyleCharacter() returned,
+ *  so that a font manager whose lookups are slow (querying fontconfig, walking fallback family
+ *  lists) only does each once. Failed lookups are remembered too.
+ *
+ *  Character lookups are keyed by family, style, languages and the range of kRangeSize code
+ *  points the character is in. A typeface found for one character of a range is reused for
+ *  any other character of the range that it has a glyph for, so text in one script resolves
+ *  with a single lookup.
+ *
+ *  The cache holds refs on the typefaces it returns, which are the same objects the font
+ *  manager hands out (and keeps in its SkTypefaceCache). It is safe to use from any thread.
+ */
+class SkFontMatchCache : SkNoncopyable {
+public:
+    SkFontMatchCache();
+    ~SkFontMatchCache();
+
+    enum {
+        kRangeShift = 7,
+        kRangeSize = 1 << kRangeShift,
+    };
+
+    /**
+     *  If (familyName, style) was added, set *result to a ref on what was added (which may be
+     *  NULL) and return true. Otherwise return false.
+     */
+    bool findStyle(const char familyName[], const SkFontStyle&, SkTypeface** result) const;
+    void addStyle(const char familyName[], const SkFontStyle&, SkTypeface* result);
+
+    /**
+     *  As findStyle(), for a character. A hit is a typeface added for this character or another
+     *  in its range that has a glyph for this character, or NULL if this character was added
+     *  with no typeface.
+     */
+    bool findCharacter(const char familyName[], const SkFontStyle&, const char* bcp47[],
+                       int bcp47Count, SkUnichar, SkTypeface** result) const;
+    void addCharacter(const char familyName[], const SkFontStyle&, const char* bcp47[],
+                      int bcp47Count, SkUnichar, SkTypeface* result);
+
+    /** Forget everything, dropping the cache's refs. */
+    void purgeAll();
+
+    struct Stats {
+        int32_t fHits;
+        int32_t fMisses;
+    };
+    void getStats(Stats*) const;
+
+private:
+    struct Range {
+        SkTDArray<SkTypeface*> fFaces;                  // refs
+        uint32_t fMissing[kRangeSize / 32];             // characters with no typeface
+    };
+
+    void purgeIfFull();
+    void purgeAllLocked();
+
+    mutable SkMutex fMutex;
+    SkTHashMap<SkString, SkTypeface*> fStyles;          // refs, or NULL
+    SkTHashMap<SkString, Range*> fRanges;
+    mutable Stats fStats;
+};
+
+#endif
@@ -11,8 +11,10 @@
 #include "SkLazyPtr.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTLS.h"
+#include "SkTSort.h"
 #include "SkTypeface.h"
 
 //#define SPEW_PURGE_STATUS
@@ -38,6 +40,9 @@ static SkGlyphCache_Globals& getGlobals() {
     return tls ? *tls : getSharedGlobals();
 }
 
+// See SkGraphics::SetFontCacheSharesSubpixelImages().
+static bool gShareSubpixelImages = false;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
@@ -63,16 +68,18 @@ SkGlyphCache::SkGlyphCache(SkTypeface* typeface, const SkDescriptor* desc, SkSca
     SkASSERT(ctx);
 
     fPrev = fNext = NULL;
+    fUseCount = 0;
+    fGlobals = NULL;
 
     fDesc = desc->copy();
     fScalerContext->getFontMetrics(&fFontMetrics);
 
-    // Create the sentinel SkGlyph.
-    SkGlyph* sentinel = fGlyphArray.insert(0);
-    sentinel->initGlyphFromCombinedID(SkGlyph::kImpossibleID);
-
-    // Initialize all index to zero which points to the sentinel SkGlyph.
-    memset(fGlyphHash, 0x00, sizeof(fGlyphHash));
+    // Point every hash entry at the sentinel SkGlyph.
+    fSentinel.initGlyphFromCombinedID(SkGlyph::kImpossibleID);
+    for (int i = 0; i < kHashCount; ++i) {
+        fGlyphHash[i] = &fSentinel;
+    }
+    fCharToGlyphHash = NULL;
 
     fMemoryUsed = sizeof(*this);
 
@@ -110,47 +117,55 @@ SkGlyphCache::~SkGlyphCache() {
 
     }
 #endif
-    SkGlyph*   gptr = fGlyphArray.begin();
-    SkGlyph*   stop = fGlyphArray.end();
+    SkGlyph**  gptr = fGlyphArray.begin();
+    SkGlyph**  stop = fGlyphArray.end();
     while (gptr < stop) {
-        SkPath* path = gptr->fPath;
+        SkPath* path = (*gptr)->fPath;
         if (path) {
             SkDELETE(path);
         }
         gptr += 1;
     }
+    sk_free(fCharToGlyphHash);
     SkDescriptor::Free(fDesc);
     SkDELETE(fScalerContext);
     this->invokeAndRemoveAuxProcs();
 }
 
-SkGlyphCache::CharGlyphRec* SkGlyphCache::getCharGlyphRec(uint32_t id) {
-    if (NULL == fCharToGlyphHash.get()) {
-        // Allocate the array.
-        fCharToGlyphHash.reset(kHashCount);
-        // Initialize entries of fCharToGlyphHash to index the sentinel glyph and
-        // an fID value that will not match any id.
-        for (int i = 0; i <kHashCount; ++i) {
-            fCharToGlyphHash[i].fID = SkGlyph::kImpossibleID;
-            fCharToGlyphHash[i].fGlyphIndex = 0;
+// An empty fCharToGlyphHash entry, which matches no id.
+static const uint64_t kEmptyCharToGlyph = (uint64_t)SkGlyph::kImpossibleID << 32;
+
+bool SkGlyphCache::findCharToGlyph(uint32_t id, uint16_t* glyphID) const {
+    const uint64_t* hash = sk_atomic_load(&fCharToGlyphHash, sk_memory_order_acquire);
+    if (hash) {
+        uint64_t rec = sk_atomic_load(&hash[ID2HashIndex(id)], sk_memory_order_relaxed);
+        if ((uint32_t)(rec >> 32) == id) {
+            *glyphID = (uint16_t)rec;
+            return true;
         }
     }
-
-    return &fCharToGlyphHash[ID2HashIndex(id)];
+    return false;
 }
 
-void SkGlyphCache::adjustCaches(int insertion_index) {
-    for (int i = 0; i < kHashCount; ++i) {
-        if (fGlyphHash[i] >= SkToU16(insertion_index)) {
-            fGlyphHash[i] += 1;
-        }
-    }
-    if (fCharToGlyphHash.get() != NULL) {
+void SkGlyphCache::setCharToGlyph(uint32_t id, uint16_t glyphID) {
+    fMutex.assertHeld();
+    uint64_t* hash = fCharToGlyphHash;
+    if (NULL == hash) {
+        // Allocate the array, and only publish it once every entry is empty.
+        hash = (uint64_t*)sk_malloc_throw(kHashCount * sizeof(uint64_t));
         for (int i = 0; i < kHashCount; ++i) {
-            if (fCharToGlyphHash[i].fGlyphIndex >= SkToU16(insertion_index)) {
-                fCharToGlyphHash[i].fGlyphIndex += 1;
-            }
+            hash[i] = kEmptyCharToGlyph;
         }
+        sk_release_store(&fCharToGlyphHash, hash);
+    }
+    sk_atomic_store(&hash[ID2HashIndex(id)], ((uint64_t)id << 32) | glyphID,
+                    sk_memory_order_relaxed);
+}
+
+void SkGlyphCache::addMemoryUsed(size_t bytes) {
+    fMemoryUsed += bytes;
+    if (fGlobals) {
+        fGlobals->addMemoryUsed(bytes);
     }
 }
 
@@ -165,20 +180,23 @@ void SkGlyphCache::adjustCaches(int insertion_index) {
 uint16_t SkGlyphCache::unicharToGlyph(SkUnichar charCode) {
     VALIDATE();
     uint32_t id = SkGlyph::MakeID(charCode);
-    const CharGlyphRec& rec = *this->getCharGlyphRec(id);
+    uint16_t glyphID;
 
-    if (rec.fID == id) {
-        return fGlyphArray[rec.fGlyphIndex].getGlyphID();
+    if (this->findCharToGlyph(id, &glyphID)) {
+        return glyphID;
     } else {
+        SkAutoMutexAcquire ac(fMutex);
         return fScalerContext->charToGlyphID(charCode);
     }
 }
 
 SkUnichar SkGlyphCache::glyphToUnichar(uint16_t glyphID) {
+    SkAutoMutexAcquire ac(fMutex);
     return fScalerContext->glyphIDToChar(glyphID);
 }
 
 unsigned SkGlyphCache::getGlyphCount() {
+    SkAutoMutexAcquire ac(fMutex);
     return fScalerContext->getGlyphCount();
 }
 
@@ -221,111 +239,157 @@ const SkGlyph& SkGlyphCache::getGlyphIDMetrics(uint16_t glyphID, SkFixed x, SkFi
 }
 
 SkGlyph* SkGlyphCache::lookupByChar(SkUnichar charCode, MetricsType type, SkFixed x, SkFixed y) {
+    // this ID is based on the UniChar
     uint32_t id = SkGlyph::MakeID(charCode, x, y);
-    CharGlyphRec* rec = this->getCharGlyphRec(id);
-    SkGlyph* glyph;
-    if (rec->fID != id) {
-        RecordHashCollisionIf(glyph_index != SkGlyph::kImpossibleID);
-        // this ID is based on the UniChar
-        rec->fID = id;
-        // this ID is based on the glyph index
-        id = SkGlyph::MakeID(fScalerContext->charToGlyphID(charCode), x, y);
-        rec->fGlyphIndex = this->lookupMetrics(id, type);
-        glyph = &fGlyphArray[rec->fGlyphIndex];
-    } else {
+    uint16_t glyphID;
+    if (this->findCharToGlyph(id, &glyphID)) {
         RecordHashSuccess();
-        glyph = &fGlyphArray[rec->fGlyphIndex];
-        if (type == kFull_MetricsType && glyph->isJustAdvance()) {
-            fScalerContext->getMetrics(glyph);
-        }
+    } else {
+        RecordHashCollision();
+        SkAutoMutexAcquire ac(fMutex);
+        glyphID = fScalerContext->charToGlyphID(charCode);
+        this->setCharToGlyph(id, glyphID);
     }
-    return glyph;
+    // this ID is based on the glyph index
+    return this->lookupByCombinedID(SkGlyph::MakeID(glyphID, x, y), type);
 }
 
 SkGlyph* SkGlyphCache::lookupByCombinedID(uint32_t id, MetricsType type) {
-    uint32_t hash_index = ID2HashIndex(id);
-    uint16_t glyph_index = fGlyphHash[hash_index];
-    SkGlyph* glyph = &fGlyphArray[glyph_index];
-
-    if (glyph->fID != id) {
-        RecordHashCollisionIf(glyph_index != SkGlyph::kImpossibleID);
-        glyph_index = this->lookupMetrics(id, type);
-        fGlyphHash[hash_index] = glyph_index;
-        glyph = &fGlyphArray[glyph_index];
-    } else {
+    SkGlyph** slot = &fGlyphHash[ID2HashIndex(id)];
+    SkGlyph* glyph = sk_acquire_load(slot);
+
+    if (glyph->fID == id && (kJustAdvance_MetricsType == type || !glyph->isJustAdvance())) {
         RecordHashSuccess();
-        if (type == kFull_MetricsType && glyph->isJustAdvance()) {
-           fScalerContext->getMetrics(glyph);
-        }
+        return glyph;
     }
+
+    RecordHashCollisionIf(glyph != &fSentinel);
+    SkAutoMutexAcquire ac(fMutex);
+    glyph = this->lookupMetrics(id, type);
+    sk_release_store(slot, glyph);
     return glyph;
 }
 
-uint16_t SkGlyphCache::lookupMetrics(uint32_t id, MetricsType mtype) {
+SkGlyph* SkGlyphCache::lookupMetrics(uint32_t id, MetricsType mtype) {
     SkASSERT(id != SkGlyph::kImpossibleID);
-    // Count is always greater than 0 because of the sentinel.
-    // The fGlyphArray cache is in descending order, so that the sentinel with a value of ~0 is
-    // always at index 0.
-    SkGlyph* gptr = fGlyphArray.begin();
-    int lo = 0;
-    int hi = fGlyphArray.count() - 1;
-    while (lo < hi) {
-        int mid = (hi + lo) >> 1;
-        if (gptr[mid].fID > id) {
-            lo = mid + 1;
-        } else {
-            hi = mid;
-        }
-    }
+    fMutex.assertHeld();
+
+    SkGlyph** gptr = fGlyphArray.begin();
+    int hi = this->findGlyphIndex(id);
 
-    uint16_t glyph_index = hi;
-    SkGlyph* glyph = &gptr[glyph_index];
-    if (glyph->fID == id) {
+    SkGlyph* glyph;
+    if (hi < fGlyphArray.count() && gptr[hi]->fID == id) {
+        glyph = gptr[hi];
         if (kFull_MetricsType == mtype && glyph->isJustAdvance()) {
+            // Other threads may be reading the advance-only glyph without the lock, so rather
+            // than filling it in, replace it with a complete one.
+            glyph = this->allocGlyph(id);
             fScalerContext->getMetrics(glyph);
+            gptr[hi] = glyph;
         }
-        SkASSERT(glyph->fID != SkGlyph::kImpossibleID);
-        return glyph_index;
-    }
-
-    // check if we need to bump hi before falling though to the allocator
-    if (glyph->fID > id) {
-        glyph_index += 1;
+        return glyph;
     }
 
-    // Not found, but hi contains the index of the insertion point of the new glyph.
-    fMemoryUsed += sizeof(SkGlyph);
-
-    this->adjustCaches(glyph_index);
-
-    glyph = fGlyphArray.insert(glyph_index);
-    glyph->initGlyphFromCombinedID(id);
-
+    // Not found, but hi is the insertion point of the new glyph.
+    glyph = this->allocGlyph(id);
     if (kJustAdvance_MetricsType == mtype) {
         fScalerContext->getAdvance(glyph);
     } else {
         SkASSERT(kFull_MetricsType == mtype);
         fScalerContext->getMetrics(glyph);
     }
+    *fGlyphArray.insert(hi) = glyph;
+    return glyph;
+}
+
+int SkGlyphCache::findGlyphIndex(uint32_t id) const {
+    fMutex.assertHeld();
 
-    SkASSERT(glyph->fID != SkGlyph::kImpossibleID);
-    return glyph_index;
+    // The fGlyphArray cache is in descending order, so find the first glyph whose fID is not
+    // greater than id.
+    SkGlyph* const* gptr = fGlyphArray.begin();
+    int lo = 0;
+    int hi = fGlyphArray.count();
+    while (lo < hi) {
+        int mid = (hi + lo) >> 1;
+        if (gptr[mid]->fID > id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return hi;
+}
+
+void* SkGlyphCache::findSharedImage(const SkGlyph& glyph, const void* image, size_t size) const {
+    fMutex.assertHeld();
+
+    const unsigned code = glyph.getGlyphID();
+    for (unsigned sub = 0; sub < (1 << (2 * SkGlyph::kSubBits)); ++sub) {
+        const SkFixed x = SkGlyph::SubToFixed(sub >> SkGlyph::kSubBits);
+        const SkFixed y = SkGlyph::SubToFixed(sub & SkGlyph::kSubMask);
+        const uint32_t id = SkGlyph::MakeID(code, x, y);
+        if (id == glyph.fID) {
+            continue;
+        }
+        int index = this->findGlyphIndex(id);
+        if (index >= fGlyphArray.count() || fGlyphArray[index]->fID != id) {
+            continue;
+        }
+        const SkGlyph* other = fGlyphArray[index];
+        if (other->fImage && other->fWidth == glyph.fWidth && other->fHeight == glyph.fHeight &&
+            other->fLeft == glyph.fLeft && other->fTop == glyph.fTop &&
+            other->fMaskFormat == glyph.fMaskFormat && 0 == memcmp(other->fImage, image, size)) {
+            return other->fImage;
+        }
+    }
+    return NULL;
+}
+
+SkGlyph* SkGlyphCache::allocGlyph(uint32_t id) {
+    SkGlyph* glyph = (SkGlyph*)fGlyphAlloc.allocThrow(sizeof(SkGlyph));
+    glyph->initGlyphFromCombinedID(id);
+    this->addMemoryUsed(sizeof(SkGlyph) + sizeof(SkGlyph*));
+    return glyph;
 }
 
 const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth) {
+        void* image = sk_acquire_load(&glyph.fImage);
+        if (image) {
+            return image;
+        }
+
+        SkAutoMutexAcquire ac(fMutex);
         if (NULL == glyph.fImage) {
             size_t  size = glyph.computeImageSize();
-            const_cast<SkGlyph&>(glyph).fImage = fGlyphAlloc.alloc(size,
-                                        SkChunkAlloc::kReturnNil_AllocFailType);
+            image = fGlyphAlloc.alloc(size, SkChunkAlloc::kReturnNil_AllocFailType);
             // check that alloc() actually succeeded
-            if (glyph.fImage) {
-                fScalerContext->getImage(glyph);
+            if (image) {
+                // Other threads may be reading glyph, so draw into a copy and publish the image
+                // once it is complete.
+                SkGlyph tmp = glyph;
+                tmp.fImage = image;
+                fScalerContext->getImage(tmp);
                 // TODO: the scaler may have changed the maskformat during
                 // getImage (e.g. from AA or LCD to BW) which means we may have
                 // overallocated the buffer. Check if the new computedImageSize
                 // is smaller, and if so, strink the alloc size in fImageAlloc.
-                fMemoryUsed += size;
+                const_cast<SkGlyph&>(glyph).fMaskFormat = tmp.fMaskFormat;
+                void* shared = NULL;
+                if (gShareSubpixelImages && this->isSubpixel()) {
+                    shared = this->findSharedImage(tmp, image, tmp.computeImageSize());
+                }
+                if (shared) {
+                    // Nothing else was allocated since, so this gives the space back.
+                    if (0 == fGlyphAlloc.unalloc(image)) {
+                        this->addMemoryUsed(size);
+                    }
+                    image = shared;
+                } else {
+                    this->addMemoryUsed(size);
+                }
+                sk_release_store(&const_cast<SkGlyph&>(glyph).fImage, image);
             }
         }
     }
@@ -334,17 +398,148 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
 
 const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     if (glyph.fWidth) {
+        SkPath* path = sk_acquire_load(&glyph.fPath);
+        if (path) {
+            return path;
+        }
+
+        SkAutoMutexAcquire ac(fMutex);
         if (glyph.fPath == NULL) {
-            const_cast<SkGlyph&>(glyph).fPath = SkNEW(SkPath);
-            fScalerContext->getPath(glyph, glyph.fPath);
-            fMemoryUsed += sizeof(SkPath) +
-                    glyph.fPath->countPoints() * sizeof(SkPoint);
+            path = SkNEW(SkPath);
+            fScalerContext->getPath(glyph, path);
+            this->addMemoryUsed(sizeof(SkPath) + path->countPoints() * sizeof(SkPoint));
+            sk_release_store(&const_cast<SkGlyph&>(glyph).fPath, path);
         }
     }
     return glyph.fPath;
 }
 
+void SkGlyphCache::appendGlyphPaths(const uint16_t glyphIDs[], int count, SkPath* dst,
+                                    int pointOffsets[], int verbOffsets[]) {
+    SkPath scratch;
+    for (int i = 0; i < count; ++i) {
+        if (pointOffsets) {
+            pointOffsets[i] = dst->countPoints();
+        }
+        if (verbOffsets) {
+            verbOffsets[i] = dst->countVerbs();
+        }
+
+        const SkGlyph& glyph = this->getGlyphIDMetrics(glyphIDs[i]);
+        if (0 == glyph.fWidth) {
+            continue;
+        }
+        const SkPath* path = sk_acquire_load(&glyph.fPath);
+        if (NULL == path) {
+            SkAutoMutexAcquire ac(fMutex);
+            scratch.rewind();
+            fScalerContext->getPath(glyph, &scratch);
+            path = &scratch;
+        }
+        dst->addPath(*path);
+    }
+    if (pointOffsets) {
+        pointOffsets[count] = dst->countPoints();
+    }
+    if (verbOffsets) {
+        verbOffsets[count] = dst->countVerbs();
+    }
+}
+
+namespace {
+
+// The glyphs one task rasterizes, with a scaler context of its own.
+struct PrefetchTask {
+    SkTypeface*         fTypeface;
+    const SkDescriptor* fDesc;
+    SkGlyph*            fGlyphs;    // copies, drawing into storage nobody else can see yet
+    int                 fCount;
+    bool                fDone;
+};
+
+void prefetch_glyphs(PrefetchTask* task) {
+    SkAutoTDelete<SkScalerContext> ctx(task->fTypeface->createScalerContext(task->fDesc, true));
+    task->fDone = SkToBool(ctx.get());
+    if (task->fDone) {
+        for (int i = 0; i < task->fCount; ++i) {
+            ctx->getImage(task->fGlyphs[i]);
+        }
+    }
+}
+
+}  // namespace
+
+void SkGlyphCache::prefetchGlyphs(const uint16_t glyphIDs[], int count) {
+    // Don't bother other threads for fewer glyphs than it takes to create a scaler context.
+    static const int kGlyphsPerTask = 16;
+
+    SkTDArray<SkGlyph*> missing;
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph& glyph = this->getGlyphIDMetrics(glyphIDs[i]);
+        if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth &&
+                NULL == sk_acquire_load(&glyph.fImage)) {
+            *missing.append() = const_cast<SkGlyph*>(&glyph);
+        }
+    }
+    if (missing.count() > 1) {
+        SkTQSort(missing.begin(), missing.end() - 1, SkTCompareLT<SkGlyph*>());
+        SkGlyph** last = missing.begin();
+        for (SkGlyph** iter = missing.begin() + 1; iter < missing.end(); ++iter) {
+            if (*iter != *last) {
+                *++last = *iter;
+            }
+        }
+        missing.setCount(SkToInt(last - missing.begin()) + 1);
+    }
+    if (missing.count() < 2 * kGlyphsPerTask) {
+        for (int i = 0; i < missing.count(); ++i) {
+            this->findImage(*missing[i]);
+        }
+        return;
+    }
+
+    // fGlyphAlloc isn't thread safe, so allocate all the images here.
+    SkAutoTArray<SkGlyph> copies(missing.count());
+    {
+        SkAutoMutexAcquire ac(fMutex);
+        for (int i = 0; i < missing.count(); ++i) {
+            copies[i] = *missing[i];
+            copies[i].fImage = fGlyphAlloc.alloc(missing[i]->computeImageSize(),
+                                                 SkChunkAlloc::kReturnNil_AllocFailType);
+        }
+    }
+
+    const int taskCount = (missing.count() + kGlyphsPerTask - 1) / kGlyphsPerTask;
+    SkAutoTArray<PrefetchTask> tasks(taskCount);
+    for (int i = 0; i < taskCount; ++i) {
+        tasks[i].fTypeface = fScalerContext->getTypeface();
+        tasks[i].fDesc = fDesc;
+        tasks[i].fGlyphs = &copies[i * kGlyphsPerTask];
+        tasks[i].fCount = SkTMin(kGlyphsPerTask, missing.count() - i * kGlyphsPerTask);
+        tasks[i].fDone = false;
+    }
+    SkTaskGroup tg;
+    tg.batch(prefetch_glyphs, tasks.get(), taskCount);
+    tg.wait();
+
+    // Publish the images, unless another thread has beaten us to one.
+    SkAutoMutexAcquire ac(fMutex);
+    for (int i = 0; i < missing.count(); ++i) {
+        SkGlyph* glyph = missing[i];
+        const SkGlyph& copy = copies[i];
+        if (NULL == copy.fImage) {
+            continue;
+        }
+        this->addMemoryUsed(glyph->computeImageSize());
+        if (tasks[i / kGlyphsPerTask].fDone && NULL == glyph->fImage) {
+            glyph->fMaskFormat = copy.fMaskFormat;
+            sk_release_store(&glyph->fImage, copy.fImage);
+        }
+    }
+}
+
 void SkGlyphCache::dump() const {
+    SkAutoMutexAcquire ac(fMutex);
     const SkTypeface* face = fScalerContext->getTypeface();
     const SkScalerContextRec& rec = fScalerContext->getRec();
     SkMatrix matrix;
@@ -370,6 +565,7 @@ void SkGlyphCache::dump() const {
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkGlyphCache::getAuxProcData(void (*proc)(void*), void** dataPtr) const {
+    SkAutoMutexAcquire ac(fMutex);
     const AuxProcRec* rec = fAuxProcList;
     while (rec) {
         if (rec->fProc == proc) {
@@ -388,6 +584,7 @@ void SkGlyphCache::setAuxProc(void (*proc)(void*), void* data) {
         return;
     }
 
+    SkAutoMutexAcquire ac(fMutex);
     AuxProcRec* rec = fAuxProcList;
     while (rec) {
         if (rec->fProc == proc) {
@@ -425,10 +622,8 @@ size_t SkGlyphCache_Globals::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoMutexAcquire    ac(fMutex);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
+    size_t prevLimit = this->getCacheSizeLimit();
+    sk_atomic_store(&fCacheSizeLimit, newLimit, sk_memory_order_relaxed);
     this->internalPurge();
     return prevLimit;
 }
@@ -438,24 +633,18 @@ int SkGlyphCache_Globals::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexAcquire    ac(fMutex);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
+    int prevCount = this->getCacheCountLimit();
+    sk_atomic_store(&fCacheCountLimit, (int32_t)newCount, sk_memory_order_relaxed);
     this->internalPurge();
     return prevCount;
 }
 
 void SkGlyphCache_Globals::purgeAll() {
-    SkAutoMutexAcquire    ac(fMutex);
-    this->internalPurge(fTotalMemoryUsed);
+    this->internalPurge(this->getTotalMemoryUsed());
 }
 
-/*  This guy calls the visitor from within the mutext lock, so the visitor
-    cannot:
-    - take too much time
-    - try to acquire the mutext again
-    - call a fontscaler (which might call into the cache)
+/*  The visitor is called outside of any lock, with the strike marked as in
+    use, so it may take its time, and even call into the strike.
 */
 SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
                               const SkDescriptor* desc,
@@ -467,29 +656,16 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     SkASSERT(desc);
 
     SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
-    SkGlyphCache*         cache;
-    bool                  insideMutex = true;
-
-    globals.validate();
+    SkGlyphCache* cache = globals.findAndUseCache(*desc);
 
-    for (cache = globals.internalGetHead(); cache != NULL; cache = cache->fNext) {
-        if (cache->fDesc->equals(*desc)) {
-            globals.internalDetachCache(cache);
-            goto FOUND_IT;
-        }
-    }
+    if (NULL == cache) {
+        /* Create the new entry outside of the shard's mutex, as that might
+            have side-effects like trying to access the cache/mutex (yikes!)
+        */
 
-    /* Release the mutex now, before we create a new entry (which might have
-        side-effects like trying to access the cache/mutex (yikes!)
-    */
-    ac.release();           // release the mutex now
-    insideMutex = false;    // can't use globals anymore
-
-    // Check if we can create a scaler-context before creating the glyphcache.
-    // If not, we may have exhausted OS/font resources, so try purging the
-    // cache once and try again.
-    {
+        // Check if we can create a scaler-context before creating the glyphcache.
+        // If not, we may have exhausted OS/font resources, so try purging the
+        // cache once and try again.
         // pass true the first time, to notice if the scalercontext failed,
         // so we can try the purge.
         SkScalerContext* ctx = typeface->createScalerContext(desc, true);
@@ -498,19 +674,19 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
             ctx = typeface->createScalerContext(desc, false);
             SkASSERT(ctx);
         }
-        cache = SkNEW_ARGS(SkGlyphCache, (typeface, desc, ctx));
-    }
+        SkGlyphCache* newCache = SkNEW_ARGS(SkGlyphCache, (typeface, desc, ctx));
 
-FOUND_IT:
+        // Another thread may have beaten us to it, in which case we use its strike.
+        cache = globals.addAndUseCache(newCache);
+        if (cache != newCache) {
+            SkDELETE(newCache);
+        }
+    }
 
     AutoValidate av(cache);
 
-    if (!proc(cache, context)) {   // need to reattach
-        if (insideMutex) {
-            globals.internalAttachCacheToHead(cache);
-        } else {
-            globals.attachCacheToHead(cache);
-        }
+    if (!proc(cache, context)) {   // done with it already
+        globals.releaseCache(cache);
         cache = NULL;
     }
     return cache;
@@ -518,15 +694,17 @@ FOUND_IT:
 
 void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
-    SkASSERT(cache->fNext == NULL);
 
-    getGlobals().attachCacheToHead(cache);
+    if (NULL == cache->fGlobals) {
+        // The thread-local cache that held it is gone.
+        SkDELETE(cache);
+        return;
+    }
+    cache->fGlobals->releaseCache(cache);
 }
 
 void SkGlyphCache::Dump() {
     SkGlyphCache_Globals& globals = getGlobals();
-    SkAutoMutexAcquire    ac(globals.fMutex);
-    SkGlyphCache*         cache;
 
     globals.validate();
 
@@ -538,12 +716,15 @@ void SkGlyphCache::Dump() {
     int missCount = 0;
 #endif
 
-    for (cache = globals.internalGetHead(); cache != NULL; cache = cache->fNext) {
+    for (int i = 0; i < SkGlyphCache_Globals::kShardCount; ++i) {
+        SkAutoMutexAcquire ac(globals.shardMutex(i));
+        for (SkGlyphCache* cache = globals.internalGetHead(i); cache; cache = cache->fNext) {
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
-        hitCount += cache->fHashHitCount;
-        missCount += cache->fHashMissCount;
+            hitCount += cache->fHashHitCount;
+            missCount += cache->fHashMissCount;
 #endif
-        cache->dump();
+            cache->dump();
+        }
     }
 #ifdef SK_GLYPHCACHE_TRACK_HASH_STATS
     SkDebugf("Hash hit percent:%2d\n", 100 * hitCount / (hitCount + missCount));
@@ -552,44 +733,76 @@ void SkGlyphCache::Dump() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
-    SkAutoMutexAcquire    ac(fMutex);
-
-    this->validate();
-    cache->validate();
+SkGlyphCache* SkGlyphCache_Globals::findAndUseCache(const SkDescriptor& desc) {
+    const int shard = ShardIndex(desc);
+    SkAutoMutexAcquire ac(this->shardMutex(shard));
 
-    this->internalAttachCacheToHead(cache);
-    this->internalPurge();
+    for (SkGlyphCache* cache = fHeads[shard]; cache != NULL; cache = cache->fNext) {
+        if (cache->fDesc->equals(desc)) {
+            this->internalMoveToHead(cache);
+            cache->fUseCount += 1;
+            return cache;
+        }
+    }
+    return NULL;
 }
 
-SkGlyphCache* SkGlyphCache_Globals::internalGetTail() const {
-    SkGlyphCache* cache = fHead;
-    if (cache) {
-        while (cache->fNext) {
-            cache = cache->fNext;
+SkGlyphCache* SkGlyphCache_Globals::addAndUseCache(SkGlyphCache* newCache) {
+    SkASSERT(0 == newCache->fUseCount && NULL == newCache->fGlobals);
+    const int shard = ShardIndex(*newCache->fDesc);
+    SkGlyphCache* cache;
+    {
+        SkAutoMutexAcquire ac(this->shardMutex(shard));
+
+        for (cache = fHeads[shard]; cache != NULL; cache = cache->fNext) {
+            if (cache->fDesc->equals(*newCache->fDesc)) {
+                break;
+            }
+        }
+        if (NULL == cache) {
+            cache = newCache;
+            this->internalAttachCacheToHead(cache);
+        } else {
+            this->internalMoveToHead(cache);
         }
+        cache->fUseCount += 1;
+    }
+    if (cache == newCache) {
+        this->internalPurge();
     }
     return cache;
 }
 
-size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+void SkGlyphCache_Globals::releaseCache(SkGlyphCache* cache) {
+    {
+        SkAutoMutexAcquire ac(this->shardMutex(ShardIndex(*cache->fDesc)));
+        SkASSERT(cache->fUseCount > 0);
+        cache->validate();
+        cache->fUseCount -= 1;
+    }
+    this->internalPurge();
+}
 
+size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
+    const size_t totalMemoryUsed = this->getTotalMemoryUsed();
+    const size_t cacheSizeLimit = this->getCacheSizeLimit();
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
+    const int cacheCount = this->getCacheCountUsed();
+    const int cacheCountLimit = this->getCacheCountLimit();
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > cacheCountLimit) {
+        countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -597,21 +810,38 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
         return 0;
     }
 
+    this->validate();
+
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // we start at the tail and proceed backwards, as the linklist is in LRU
-    // order, with unimportant entries at the tail.
-    SkGlyphCache* cache = this->internalGetTail();
-    while (cache != NULL &&
-           (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        SkGlyphCache* prev = cache->fPrev;
-        bytesFreed += cache->fMemoryUsed;
-        countFreed += 1;
-
-        this->internalDetachCache(cache);
-        SkDELETE(cache);
-        cache = prev;
+    // Each shard's list is in LRU order, with unimportant entries at the tail, so taking a
+    // strike from the tail of each shard in turn approximates purging in LRU order overall.
+    // Strikes in use are skipped.
+    bool purgedAny = true;
+    while (purgedAny && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
+        purgedAny = false;
+        for (int i = 0; i < kShardCount; ++i) {
+            if (bytesFreed >= bytesNeeded && countFreed >= countNeeded) {
+                break;
+            }
+            SkGlyphCache* cache;
+            {
+                SkAutoMutexAcquire ac(this->shardMutex(i));
+                cache = fTails[i];
+                while (cache && cache->fUseCount > 0) {
+                    cache = cache->fPrev;
+                }
+                if (NULL == cache) {
+                    continue;
+                }
+                this->internalDetachCache(cache);
+            }
+            bytesFreed += cache->fMemoryUsed;
+            countFreed += 1;
+            SkDELETE(cache);
+            purgedAny = true;
+        }
     }
 
     this->validate();
@@ -628,30 +858,57 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
 
 void SkGlyphCache_Globals::internalAttachCacheToHead(SkGlyphCache* cache) {
     SkASSERT(NULL == cache->fPrev && NULL == cache->fNext);
-    if (fHead) {
-        fHead->fPrev = cache;
-        cache->fNext = fHead;
+    const int shard = ShardIndex(*cache->fDesc);
+    if (fHeads[shard]) {
+        fHeads[shard]->fPrev = cache;
+        cache->fNext = fHeads[shard];
+    } else {
+        fTails[shard] = cache;
     }
-    fHead = cache;
+    fHeads[shard] = cache;
+    cache->fGlobals = this;
+
+    sk_atomic_fetch_add(&fCacheCount, 1, sk_memory_order_relaxed);
+    this->addMemoryUsed(cache->fMemoryUsed);
+}
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += cache->fMemoryUsed;
+// Keeps the list in LRU order. Unlike detaching and reattaching the strike, this leaves the
+// totals alone, so it is safe while other threads are using the strike.
+void SkGlyphCache_Globals::internalMoveToHead(SkGlyphCache* cache) {
+    const int shard = ShardIndex(*cache->fDesc);
+    if (NULL == cache->fPrev) {
+        return;
+    }
+    cache->fPrev->fNext = cache->fNext;
+    if (cache->fNext) {
+        cache->fNext->fPrev = cache->fPrev;
+    } else {
+        fTails[shard] = cache->fPrev;
+    }
+    cache->fPrev = NULL;
+    cache->fNext = fHeads[shard];
+    fHeads[shard]->fPrev = cache;
+    fHeads[shard] = cache;
 }
 
 void SkGlyphCache_Globals::internalDetachCache(SkGlyphCache* cache) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= cache->fMemoryUsed;
+    SkASSERT(this->getCacheCountUsed() > 0);
+    sk_atomic_fetch_add(&fCacheCount, -1, sk_memory_order_relaxed);
+    sk_atomic_fetch_add(&fTotalMemoryUsed, -cache->fMemoryUsed, sk_memory_order_relaxed);
 
+    const int shard = ShardIndex(*cache->fDesc);
     if (cache->fPrev) {
         cache->fPrev->fNext = cache->fNext;
     } else {
-        fHead = cache->fNext;
+        fHeads[shard] = cache->fNext;
     }
     if (cache->fNext) {
         cache->fNext->fPrev = cache->fPrev;
+    } else {
+        fTails[shard] = cache->fPrev;
     }
     cache->fPrev = cache->fNext = NULL;
+    cache->fGlobals = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -660,10 +917,14 @@ void SkGlyphCache_Globals::internalDetachCache(SkGlyphCache* cache) {
 
 void SkGlyphCache::validate() const {
 #ifdef SK_DEBUG_GLYPH_CACHE
+    SkAutoMutexAcquire ac(fMutex);
     int count = fGlyphArray.count();
     for (int i = 0; i < count; i++) {
-        const SkGlyph* glyph = &fGlyphArray[i];
+        const SkGlyph* glyph = fGlyphArray[i];
         SkASSERT(glyph);
+        if (i > 0) {
+            SkASSERT(fGlyphArray[i - 1]->fID > glyph->fID);
+        }
         if (glyph->fImage) {
             SkASSERT(fGlyphAlloc.contains(glyph->fImage));
         }
@@ -675,15 +936,28 @@ void SkGlyphCache_Globals::validate() const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const SkGlyphCache* head = fHead;
-    while (head != NULL) {
-        computedBytes += head->fMemoryUsed;
-        computedCount += 1;
-        head = head->fNext;
+    for (int i = 0; i < kShardCount; ++i) {
+        SkAutoMutexAcquire ac(this->shardMutex(i));
+        const SkGlyphCache* prev = NULL;
+        const SkGlyphCache* head = fHeads[i];
+        while (head != NULL) {
+            SkASSERT(head->fPrev == prev);
+            SkASSERT(head->fGlobals == this);
+            SkASSERT(ShardIndex(*head->fDesc) == i);
+            computedBytes += head->fMemoryUsed;
+            computedCount += 1;
+            prev = head;
+            head = head->fNext;
+        }
+        SkASSERT(fTails[i] == prev);
     }
 
-    SkASSERT(fTotalMemoryUsed == computedBytes);
-    SkASSERT(fCacheCount == computedCount);
+    // Strikes in use may grow while we look, and other shards may change once we've let
+    // go of them, so the totals can only be checked when there's just the one thread.
+    if (NULL == fMutexes) {
+        SkASSERT(this->getTotalMemoryUsed() == computedBytes);
+        SkASSERT(this->getCacheCountUsed() == computedCount);
+    }
 }
 
 #endif
@@ -722,6 +996,16 @@ void SkGraphics::PurgeFontCache() {
     SkTypefaceCache::PurgeAll();
 }
 
+bool SkGraphics::GetFontCacheSharesSubpixelImages() {
+    return gShareSubpixelImages;
+}
+
+bool SkGraphics::SetFontCacheSharesSubpixelImages(bool enabled) {
+    bool prev = gShareSubpixelImages;
+    gShareSubpixelImages = enabled;
+    return prev;
+}
+
 size_t SkGraphics::GetTLSFontCacheLimit() {
     const SkGlyphCache_Globals* tls = SkGlyphCache_Globals::FindTLS();
     return tls ? tls->getCacheSizeLimit() : 0;
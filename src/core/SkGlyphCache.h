@@ -13,6 +13,7 @@
 #include "SkChunkAlloc.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
+#include "SkMutex.h"
 #include "SkScalerContext.h"
 #include "SkTemplates.h"
 #include "SkTDArray.h"
@@ -35,7 +36,9 @@ class SkGlyphCache_Globals;
     adding it to the strike.
 
     The strikes are held in a global list, available to all threads. To interact
-    with one, call either VisitCache() or DetachCache().
+    with one, call either VisitCache() or DetachCache(). A strike may be in use
+    by several threads at once: looking up a glyph that is already cached does
+    not lock, and generating a missing one locks only that strike.
 */
 class SkGlyphCache {
 public:
@@ -88,6 +91,21 @@ public:
     */
     const SkPath* findPath(const SkGlyph&);
 
+    /** Append the outlines of these glyphs to dst, each at its own origin. If they aren't
+        NULL, pointOffsets[i] and verbOffsets[i] are set to where glyph i's outline starts in
+        dst, and pointOffsets[count] and verbOffsets[count] to where the last one ends. Outlines
+        findPath() already made are copied; the rest are generated straight into dst through one
+        reused scratch path, without making an SkPath per glyph.
+    */
+    void appendGlyphPaths(const uint16_t glyphIDs[], int count, SkPath* dst,
+                          int pointOffsets[], int verbOffsets[]);
+
+    /** Generate the images of any of these glyphs that don't have one yet, spreading the work
+        over SkTaskGroup threads, each with its own scaler context. Worth calling before drawing
+        many glyphs from a new strike, e.g. at a new zoom level. Duplicate IDs are fine.
+    */
+    void prefetchGlyphs(const uint16_t glyphIDs[], int count);
+
     /** Return the vertical metrics for this strike.
     */
     const SkPaint::FontMetrics& getFontMetrics() const {
@@ -123,27 +141,23 @@ public:
     SkScalerContext* getScalerContext() const { return fScalerContext; }
 
     /** Find a matching cache entry, and call proc() with it. If none is found
-        create a new one. If the proc() returns true, detach the cache and
-        return it, otherwise leave it and return NULL.
+        create a new one. If the proc() returns true, return the cache, which
+        stays in use until it is passed to AttachCache(), otherwise return NULL.
     */
     static SkGlyphCache* VisitCache(SkTypeface*, const SkDescriptor* desc,
                                     bool (*proc)(const SkGlyphCache*, void*),
                                     void* context);
 
     /** Given a strike that was returned by either VisitCache() or DetachCache()
-        add it back into the global cache list (after which the caller should
-        not reference it anymore.
+        mark it as no longer in use by the caller, who should not reference it
+        anymore. Strikes are only ever purged while nobody is using them.
     */
     static void AttachCache(SkGlyphCache*);
 
-    /** Detach a strike from the global cache matching the specified descriptor.
-        Once detached, it can be queried/modified by the current thread, and
-        when finished, be reattached to the global cache with AttachCache().
-        While detached, if another request is made with the same descriptor,
-        a different strike will be generated. This is fine. It does mean we
-        can have more than 1 strike for the same descriptor, but that will
-        eventually get purged, and the win is that different thread will never
-        block each other while a strike is being used.
+    /** Return the strike from the global cache matching the specified
+        descriptor, creating it if needed. It can then be used by the current
+        thread, and when finished, be handed back with AttachCache(). Threads
+        asking for the same descriptor at the same time share one strike.
     */
     static SkGlyphCache* DetachCache(SkTypeface* typeface,
                                      const SkDescriptor* desc) {
@@ -194,12 +208,26 @@ private:
     // Return a SkGlyph* associated with unicode id and position x and y.
     SkGlyph* lookupByChar(SkUnichar id, MetricsType type, SkFixed x = 0, SkFixed y = 0);
 
-    // Return the index of id in the fGlyphArray. If it does
-    // not exist, create a new one using MetricsType.
-    uint16_t lookupMetrics(uint32_t id, MetricsType type);
+    // Return the glyph for id in the fGlyphArray. If it does not exist, create a new one
+    // using MetricsType. fMutex must be held.
+    SkGlyph* lookupMetrics(uint32_t id, MetricsType type);
+    // Return the index in fGlyphArray of the first glyph whose fID is not greater than id, which
+    // is where a glyph with that id is, or would go. fMutex must be held.
+    int findGlyphIndex(uint32_t id) const;
+    // Return an image of another subpixel variant of glyph that is identical to image, or NULL.
+    // fMutex must be held.
+    void* findSharedImage(const SkGlyph& glyph, const void* image, size_t size) const;
+    SkGlyph* allocGlyph(uint32_t id);
     static bool DetachProc(const SkGlyphCache*, void*) { return true; }
 
+    // Adds to fMemoryUsed, and to the total of the globals holding this strike.
+    void addMemoryUsed(size_t bytes);
+
+    // These are guarded by the mutex of the strike's shard in fGlobals.
     SkGlyphCache*        fNext, *fPrev;
+    int                  fUseCount;
+    SkGlyphCache_Globals* fGlobals;
+
     SkDescriptor*        fDesc;
     SkScalerContext*     fScalerContext;
     SkPaint::FontMetrics fFontMetrics;
@@ -210,27 +238,31 @@ private:
         kHashMask           = kHashCount - 1
     };
 
-    // A quick lookup to avoid the binary search looking for glyphs in fGlyphArray.
-    uint16_t             fGlyphHash[kHashCount];
-    // Contains the SkGlyphs that are used by fGlyphHash and fCharToGlyphHash. The zero element
-    // is reserved for a sentinel SkGlyph that reduces the logic to check for collisions in the
-    // hash arrays. The zero element has an fID of SkGlyph::kImpossibleID which never matches
-    // any combined id generated for a char or a glyph.
-    SkTDArray<SkGlyph>   fGlyphArray;
+    // Guards the scaler context, and everything below that changes once the strike is made.
+    // Lookups that hit in the hashes don't take it.
+    mutable SkMutex      fMutex;
+
+    // A quick lookup to avoid the binary search looking for glyphs in fGlyphArray. Entries are
+    // replaced with a release store and read with an acquire load, without fMutex. Once a glyph
+    // is in here it never changes, except to gain an image or path, which are published the
+    // same way. Empty entries point at fSentinel, whose fID of SkGlyph::kImpossibleID never
+    // matches any combined id generated for a char or a glyph.
+    SkGlyph*             fGlyphHash[kHashCount];
+    SkGlyph              fSentinel;
+    // All the glyphs, in descending order of fID. Each is allocated from fGlyphAlloc, so it
+    // stays put while other threads hold on to it.
+    SkTDArray<SkGlyph*>  fGlyphArray;
     SkChunkAlloc         fGlyphAlloc;
 
-    struct CharGlyphRec {
-        uint32_t    fID;    // unichar + subpixel
-        uint16_t    fGlyphIndex;
-    };
-
+    // Maps a unichar + subpixel id (the high 32 bits of each entry) to its glyph id (the low
+    // 16 bits), so each entry can be read and written atomically.
     // no reason to use the same kHashCount as fGlyphHash, but we do for now
     // Dynamically allocated when chars are encountered.
-    SkAutoTArray<CharGlyphRec> fCharToGlyphHash;
+    uint64_t*            fCharToGlyphHash;
 
     // The id arg is a combined id generated by MakeID.
-    CharGlyphRec* getCharGlyphRec(uint32_t id);
-    void adjustCaches(int insertion_index);
+    bool findCharToGlyph(uint32_t id, uint16_t* glyphID) const;
+    void setCharToGlyph(uint32_t id, uint16_t glyphID);
 
     static inline unsigned ID2HashIndex(uint32_t h) {
         return SkChecksum::CheapMix(h) & kHashMask;
@@ -252,8 +284,6 @@ private:
     AuxProcRec* fAuxProcList;
     void invokeAndRemoveAuxProcs();
 
-    inline static SkGlyphCache* FindTail(SkGlyphCache* head);
-
     friend class SkGlyphCache_Globals;
 };
 
@@ -8,7 +8,9 @@
 #ifndef SkGlyphCache_Globals_DEFINED
 #define SkGlyphCache_Globals_DEFINED
 
+#include "SkAtomics.h"
 #include "SkGlyphCache.h"
+#include "SkMutex.h"
 #include "SkTLS.h"
 
 #ifndef SK_DEFAULT_FONT_CACHE_COUNT_LIMIT
@@ -21,8 +23,6 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class SkMutex;
-
 class SkGlyphCache_Globals {
 public:
     enum UseMutex {
@@ -31,33 +31,65 @@ public:
     };
 
     SkGlyphCache_Globals(UseMutex um) {
-        fHead = NULL;
+        for (int i = 0; i < kShardCount; ++i) {
+            fHeads[i] = fTails[i] = NULL;
+        }
         fTotalMemoryUsed = 0;
         fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
         fCacheCount = 0;
         fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
 
-        fMutex = (kYes_UseMutex == um) ? SkNEW(SkMutex) : NULL;
+        fMutexes = (kYes_UseMutex == um) ? SkNEW_ARRAY(SkMutex, kShardCount) : NULL;
     }
 
     ~SkGlyphCache_Globals() {
-        SkGlyphCache* cache = fHead;
-        while (cache) {
-            SkGlyphCache* next = cache->fNext;
-            SkDELETE(cache);
-            cache = next;
+        for (int i = 0; i < kShardCount; ++i) {
+            SkGlyphCache* cache = fHeads[i];
+            while (cache) {
+                SkGlyphCache* next = cache->fNext;
+                if (cache->fUseCount > 0) {
+                    // Still in use, so leave it to be deleted by AttachCache().
+                    cache->fPrev = cache->fNext = NULL;
+                    cache->fGlobals = NULL;
+                } else {
+                    SkDELETE(cache);
+                }
+                cache = next;
+            }
         }
 
-        SkDELETE(fMutex);
+        SkDELETE_ARRAY(fMutexes);
     }
 
-    SkMutex*        fMutex;
+    // The strikes are spread over a few shards by their descriptor, each with its own LRU list
+    // and mutex, so threads looking up different strikes rarely wait on each other.
+    enum {
+        kShardBits  = 3,
+        kShardCount = 1 << kShardBits,
+        kShardMask  = kShardCount - 1
+    };
+
+    static int ShardIndex(const SkDescriptor& desc) {
+        return SkChecksum::CheapMix(desc.getChecksum()) & kShardMask;
+    }
+
+    // NULL for the thread-local cache.
+    SkMutex* shardMutex(int shard) const { return fMutexes ? &fMutexes[shard] : NULL; }
+
+    SkGlyphCache* internalGetHead(int shard) const { return fHeads[shard]; }
+    SkGlyphCache* internalGetTail(int shard) const { return fTails[shard]; }
 
-    SkGlyphCache* internalGetHead() const { return fHead; }
-    SkGlyphCache* internalGetTail() const;
+    size_t getTotalMemoryUsed() const {
+        return sk_atomic_load(&fTotalMemoryUsed, sk_memory_order_relaxed);
+    }
+    int getCacheCountUsed() const {
+        return sk_atomic_load(&fCacheCount, sk_memory_order_relaxed);
+    }
 
-    size_t getTotalMemoryUsed() const { return fTotalMemoryUsed; }
-    int getCacheCountUsed() const { return fCacheCount; }
+    // Called as a strike in the cache grows.
+    void addMemoryUsed(size_t bytes) {
+        sk_atomic_fetch_add(&fTotalMemoryUsed, bytes, sk_memory_order_relaxed);
+    }
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -65,27 +97,40 @@ public:
     void validate() const {}
 #endif
 
-    int getCacheCountLimit() const { return fCacheCountLimit; }
+    int getCacheCountLimit() const {
+        return sk_atomic_load(&fCacheCountLimit, sk_memory_order_relaxed);
+    }
     int setCacheCountLimit(int limit);
 
-    size_t  getCacheSizeLimit() const { return fCacheSizeLimit; }
+    size_t  getCacheSizeLimit() const {
+        return sk_atomic_load(&fCacheSizeLimit, sk_memory_order_relaxed);
+    }
     size_t  setCacheSizeLimit(size_t limit);
 
     // returns true if this cache is over-budget either due to size limit
     // or count limit.
     bool isOverBudget() const {
-        return fCacheCount > fCacheCountLimit ||
-               fTotalMemoryUsed > fCacheSizeLimit;
+        return this->getCacheCountUsed() > this->getCacheCountLimit() ||
+               this->getTotalMemoryUsed() > this->getCacheSizeLimit();
     }
 
     void purgeAll(); // does not change budget
 
-    // call when a glyphcache is available for caching (i.e. not in use)
-    void attachCacheToHead(SkGlyphCache*);
+    // Returns the strike matching desc, marked as in use, or NULL if there is none.
+    SkGlyphCache* findAndUseCache(const SkDescriptor& desc);
+
+    // Adds a new strike to the cache, marked as in use, and returns it. If another thread added
+    // one for the same descriptor first, that one is marked and returned instead, and the caller
+    // should delete the strike it made.
+    SkGlyphCache* addAndUseCache(SkGlyphCache*);
+
+    // call when done with a strike returned by findAndUseCache() or addAndUseCache()
+    void releaseCache(SkGlyphCache*);
 
-    // can only be called when the mutex is already held
+    // can only be called when the strike's shard mutex is already held
     void internalDetachCache(SkGlyphCache*);
     void internalAttachCacheToHead(SkGlyphCache*);
+    void internalMoveToHead(SkGlyphCache*);
 
     // can return NULL
     static SkGlyphCache_Globals* FindTLS() {
@@ -99,14 +144,17 @@ public:
     static void DeleteTLS() { SkTLS::Delete(CreateTLS); }
 
 private:
-    SkGlyphCache* fHead;
+    SkGlyphCache* fHeads[kShardCount];
+    SkGlyphCache* fTails[kShardCount];
+    SkMutex*      fMutexes;
     size_t  fTotalMemoryUsed;
     size_t  fCacheSizeLimit;
     int32_t fCacheCountLimit;
     int32_t fCacheCount;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
+    // and attempt to purge caches to match. Takes each shard's mutex in turn,
+    // so none must be held by the caller.
     // Returns number of bytes freed.
     size_t internalPurge(size_t minBytesNeeded = 0);
 
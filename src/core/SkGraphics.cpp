@@ -11,6 +11,7 @@
 
 #include "SkBlitter.h"
 #include "SkCanvas.h"
+#include "SkDecodedImageCache.h"
 #include "SkGeometry.h"
 #include "SkMath.h"
 #include "SkMatrix.h"
@@ -18,14 +19,18 @@
 #include "SkPathEffect.h"
 #include "SkPixelRef.h"
 #include "SkRefCnt.h"
+#include "SkResourceCache.h"
 #include "SkRTConf.h"
 #include "SkScalerContext.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
+#include "SkTraceMemoryDump.h"
+#include "SkTypefaceCache.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
+#include "../lazy/SkDiscardableMemoryPool.h"
 
 void SkGraphics::GetVersion(int32_t* major, int32_t* minor, int32_t* patch) {
     if (major) {
@@ -131,6 +136,26 @@ void SkGraphics::Term() {
     SkPaint::Term();
 }
 
+void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    // Every glyph cache without a user can be purged, and the global cache doesn't track
+    // which are in use, so all of it is reported as purgeable.
+    static const char kGlyphCacheName[] = "skia/sk_glyph_cache";
+    const size_t glyphBytes = GetFontCacheUsed();
+    dump->dumpNumericValue(kGlyphCacheName, "size", "bytes", glyphBytes);
+    dump->dumpNumericValue(kGlyphCacheName, "purgeable_size", "bytes", glyphBytes);
+    dump->dumpNumericValue(kGlyphCacheName, "limit", "bytes", GetFontCacheLimit());
+    dump->dumpNumericValue(kGlyphCacheName, "count", "objects", GetFontCacheCountUsed());
+
+    SkTypefaceCache::DumpMemoryStatistics(dump);
+    SkResourceCache::DumpMemoryStatistics(dump);
+    SkDecodedImageCache::DumpMemoryStatistics(dump);
+
+    static const char kPoolName[] = "skia/sk_discardable_memory_pool";
+    SkDiscardableMemoryPool* pool = SkGetGlobalDiscardableMemoryPool();
+    dump->dumpNumericValue(kPoolName, "size", "bytes", pool->getRAMUsed());
+    dump->dumpNumericValue(kPoolName, "limit", "bytes", pool->getRAMBudget());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
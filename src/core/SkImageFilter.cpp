@@ -17,6 +17,7 @@
 #include "SkRect.h"
 #include "SkTDynamicHash.h"
 #include "SkTInternalLList.h"
+#include "SkTaskGroup.h"
 #include "SkValidationUtils.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -191,6 +192,81 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
     return false;
 }
 
+namespace {
+// One distinct input of a filter, filtered by filter_input().
+struct InputTask {
+    const SkImageFilter*            fFilter;
+    SkImageFilter::Proxy*           fProxy;
+    const SkBitmap*                 fSrc;
+    const SkImageFilter::Context*   fContext;
+    SkBitmap                        fResult;
+    SkIPoint                        fOffset;
+    bool                            fSucceeded;
+};
+} // namespace
+
+static void filter_input(InputTask* task) {
+    task->fOffset = SkIPoint::Make(0, 0);
+    task->fSucceeded = task->fFilter->filterImage(task->fProxy, *task->fSrc, *task->fContext,
+                                                  &task->fResult, &task->fOffset);
+    if (!task->fSucceeded) {
+        task->fResult.reset();
+    }
+}
+
+bool SkImageFilter::filterInputs(Proxy* proxy, const SkBitmap& src, const Context& context,
+                                 SkBitmap results[], SkIPoint offsets[]) const {
+    // taskIndex[i] is the task that filters input i, or -1 if input i is NULL.
+    SkAutoSTArray<4, int> taskIndex(fInputCount);
+    SkAutoSTArray<4, InputTask> tasks(fInputCount);
+    int taskCount = 0;
+    for (int i = 0; i < fInputCount; ++i) {
+        taskIndex[i] = -1;
+        SkImageFilter* input = this->getInput(i);
+        if (NULL == input) {
+            continue;
+        }
+        for (int j = 0; j < i; ++j) {
+            if (this->getInput(j) == input) {
+                taskIndex[i] = taskIndex[j];
+                break;
+            }
+        }
+        if (taskIndex[i] < 0) {
+            InputTask& task = tasks[taskCount];
+            task.fFilter = input;
+            task.fProxy = proxy;
+            task.fSrc = &src;
+            task.fContext = &context;
+            taskIndex[i] = taskCount++;
+        }
+    }
+
+    if (taskCount > 1 && proxy && proxy->isThreadSafe()) {
+        SkTaskGroup tg;
+        tg.batch(filter_input, tasks.get(), taskCount);
+        tg.wait();
+    } else {
+        for (int i = 0; i < taskCount; ++i) {
+            filter_input(&tasks[i]);
+        }
+    }
+
+    bool succeeded = true;
+    for (int i = 0; i < fInputCount; ++i) {
+        if (taskIndex[i] < 0) {
+            results[i] = src;
+            offsets[i] = SkIPoint::Make(0, 0);
+        } else {
+            const InputTask& task = tasks[taskIndex[i]];
+            results[i] = task.fResult;
+            offsets[i] = task.fOffset;
+            succeeded = succeeded && task.fSucceeded;
+        }
+    }
+    return succeeded;
+}
+
 bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
                                  SkIRect* dst) const {
     SkASSERT(&src);
@@ -6,6 +6,7 @@
  */
 
 #include "SkImageGenerator.h"
+#include "SkRect.h"
 
 #ifdef SK_SUPPORT_LEGACY_BOOL_ONGETINFO
 SkImageInfo SkImageGenerator::getInfo() {
@@ -47,6 +48,16 @@ SkImageGenerator::Result SkImageGenerator::getPixels(const SkImageInfo& info, vo
     if (NULL == options) {
         options = &optsStorage;
     }
+    if (options->fSubset) {
+        if (!this->onCanDecodeSubset()) {
+            return kUnimplemented;
+        }
+        const SkIRect& subset = *options->fSubset;
+        if (!SkIRect::MakeSize(this->getInfo().dimensions()).contains(subset) ||
+                subset.width() != info.width() || subset.height() != info.height()) {
+            return kInvalidParameters;
+        }
+    }
     const Result result = this->onGetPixels(info, pixels, rowBytes, *options, ctable, ctableCount);
 
     if ((kIncompleteInput == result || kSuccess == result) && ctableCount) {
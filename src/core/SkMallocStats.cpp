@@ -0,0 +1,62 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMallocStats.h"
+
+bool SkMallocStats::gEnabled = false;
+
+static int64_t gCount = 0;
+static int64_t gBytes = 0;
+static int64_t gLiveBytes = 0;
+static int64_t gResetLiveBytes = 0;
+static int64_t gPeakLiveBytes = 0;
+
+void SkMallocStats::SetEnabled(bool enabled) {
+    sk_atomic_store(&gEnabled, enabled, sk_memory_order_relaxed);
+}
+
+void SkMallocStats::Reset() {
+    const int64_t live = sk_atomic_load(&gLiveBytes, sk_memory_order_relaxed);
+    sk_atomic_store(&gCount, (int64_t)0, sk_memory_order_relaxed);
+    sk_atomic_store(&gBytes, (int64_t)0, sk_memory_order_relaxed);
+    sk_atomic_store(&gResetLiveBytes, live, sk_memory_order_relaxed);
+    sk_atomic_store(&gPeakLiveBytes, live, sk_memory_order_relaxed);
+}
+
+int64_t SkMallocStats::Count() { return sk_atomic_load(&gCount, sk_memory_order_relaxed); }
+int64_t SkMallocStats::Bytes() { return sk_atomic_load(&gBytes, sk_memory_order_relaxed); }
+
+int64_t SkMallocStats::LiveBytes() {
+    return sk_atomic_load(&gLiveBytes, sk_memory_order_relaxed);
+}
+
+int64_t SkMallocStats::PeakDelta() {
+    return sk_atomic_load(&gPeakLiveBytes,  sk_memory_order_relaxed) -
+           sk_atomic_load(&gResetLiveBytes, sk_memory_order_relaxed);
+}
+
+void SkMallocStats::Alloc(size_t bytes) {
+    if (!IsEnabled()) {
+        return;
+    }
+    sk_atomic_fetch_add(&gCount, (int64_t)1, sk_memory_order_relaxed);
+    sk_atomic_fetch_add(&gBytes, (int64_t)bytes, sk_memory_order_relaxed);
+    const int64_t live =
+            sk_atomic_fetch_add(&gLiveBytes, (int64_t)bytes, sk_memory_order_relaxed) + bytes;
+
+    int64_t peak = sk_atomic_load(&gPeakLiveBytes, sk_memory_order_relaxed);
+    while (live > peak &&
+           !sk_atomic_compare_exchange(&gPeakLiveBytes, &peak, live,
+                                       sk_memory_order_relaxed, sk_memory_order_relaxed)) {}
+}
+
+void SkMallocStats::Free(size_t bytes) {
+    if (!IsEnabled()) {
+        return;
+    }
+    sk_atomic_fetch_add(&gLiveBytes, -(int64_t)bytes, sk_memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMallocStats_DEFINED
+#define SkMallocStats_DEFINED
+
+#include "SkAtomics.h"
+
+/**
+ *  Optional process wide counts of what goes through sk_malloc_throw(), sk_realloc_throw(),
+ *  sk_calloc() and sk_free(), for tools that want to measure allocation reduction directly.
+ *
+ *  Counting is off until SetEnabled(true), and costs one relaxed load per call while off.
+ *  Only memory ports that call Alloc() and Free() are counted (SkMemory_malloc.cpp does);
+ *  with any other, every count stays 0.  Allocations made before counting was enabled are
+ *  not known, so freeing them can drive LiveBytes() negative.
+ */
+class SkMallocStats {
+public:
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return sk_atomic_load(&gEnabled, sk_memory_order_relaxed); }
+
+    /** Zero the counts, and start tracking the peak again from the bytes live now. */
+    static void Reset();
+
+    /** Allocations made since Reset(), counting each realloc as one. */
+    static int64_t Count();
+    /** Bytes those allocations asked the system allocator for. */
+    static int64_t Bytes();
+    /** Bytes allocated but not yet freed, since counting was enabled. */
+    static int64_t LiveBytes();
+    /** The most LiveBytes() exceeded its value at Reset() by, since then. */
+    static int64_t PeakDelta();
+
+    /** For memory ports: record an allocation or free of the given size, if enabled. */
+    static void Alloc(size_t bytes);
+    static void Free(size_t bytes);
+
+private:
+    static bool gEnabled;
+};
+
+#endif
@@ -52,6 +52,7 @@ struct RRectBlurRec : public SkResourceCache::Rec {
     MaskValue      fValue;
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "rrect-blur"; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
@@ -143,6 +144,7 @@ struct RectsBlurRec : public SkResourceCache::Rec {
     MaskValue      fValue;
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "rects-blur"; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
@@ -217,6 +217,15 @@ static int countNestedRects(const SkPath& path, SkRect rects[2]) {
 bool SkMaskFilter::filterRRect(const SkRRect& devRRect, const SkMatrix& matrix,
                                const SkRasterClip& clip, SkBlitter* blitter,
                                SkPaint::Style style) const {
+    switch (this->filterRRectToSpans(devRRect, matrix, clip, blitter)) {
+        case kFalse_FilterReturn:
+            return false;
+        case kTrue_FilterReturn:
+            return true;
+        case kUnimplemented_FilterReturn:
+            break;
+    }
+
     // Attempt to speed up drawing by creating a nine patch. If a nine patch
     // cannot be used, return false to allow our caller to recover and perform
     // the drawing another way.
@@ -240,6 +249,24 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     if (SkPaint::kFill_Style == style) {
         rectCount = countNestedRects(devPath, rects);
     }
+    SkRect oval;
+    if (!devPath.isInverseFillType() &&
+        (1 == rectCount || (SkPaint::kFill_Style == style && devPath.isOval(&oval)))) {
+        SkRRect devRRect;
+        if (1 == rectCount) {
+            devRRect.setRect(rects[0]);
+        } else {
+            devRRect.setOval(oval);
+        }
+        switch (this->filterRRectToSpans(devRRect, matrix, clip, blitter)) {
+            case kFalse_FilterReturn:
+                return false;
+            case kTrue_FilterReturn:
+                return true;
+            case kUnimplemented_FilterReturn:
+                break;
+        }
+    }
     if (rectCount > 0) {
         NinePatch patch;
 
@@ -297,6 +324,12 @@ SkMaskFilter::filterRRectToNine(const SkRRect&, const SkMatrix&,
     return kUnimplemented_FilterReturn;
 }
 
+SkMaskFilter::FilterReturn
+SkMaskFilter::filterRRectToSpans(const SkRRect&, const SkMatrix&, const SkRasterClip&,
+                                 SkBlitter*) const {
+    return kUnimplemented_FilterReturn;
+}
+
 SkMaskFilter::FilterReturn
 SkMaskFilter::filterRectsToNine(const SkRect[], int count, const SkMatrix&,
                                 const SkIRect& clipBounds, NinePatch*) const {
@@ -1042,6 +1042,41 @@ void SkMatrix::Affine_vpts(const SkMatrix& m, SkPoint dst[], const SkPoint src[]
     }
 }
 
+void SkMatrix::Persp_vpts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
+    SkASSERT(m.hasPerspective());
+
+    if (count > 0) {
+        if (count & 1) {
+            Persp_pts(m, dst, src, 1);
+            src += 1;
+            dst += 1;
+        }
+        Sk4s trans4(m.fMat[kMTransX], m.fMat[kMTransY], m.fMat[kMTransX], m.fMat[kMTransY]);
+        Sk4s scale4(m.fMat[kMScaleX], m.fMat[kMScaleY], m.fMat[kMScaleX], m.fMat[kMScaleY]);
+        Sk4s  skew4(m.fMat[kMSkewX], m.fMat[kMSkewY], m.fMat[kMSkewX], m.fMat[kMSkewY]);
+        // z is summed in both lanes of each point, once from src4 and once from its swizzle.
+        Sk4s  persp4(m.fMat[kMPersp0], m.fMat[kMPersp1], m.fMat[kMPersp0], m.fMat[kMPersp1]);
+        Sk4s swzPersp4(m.fMat[kMPersp1], m.fMat[kMPersp0], m.fMat[kMPersp1], m.fMat[kMPersp0]);
+        Sk4s  persp2(m.fMat[kMPersp2]);
+        const Sk4s zero4(0);
+        const Sk4s one4(SK_Scalar1);
+        count >>= 1;
+        for (int i = 0; i < count; ++i) {
+            Sk4s src4 = Sk4s::Load(&src->fX);
+            Sk4s swz4(src[0].fY, src[0].fX, src[1].fY, src[1].fX);  // need ABCD -> BADC
+            Sk4s z4 = src4 * persp4 + swz4 * swzPersp4 + persp2;
+            if ((z4 == zero4).anyTrue()) {
+                // Persp_pts leaves these at zero rather than dividing by it.
+                Persp_pts(m, dst, src, 2);
+            } else {
+                ((src4 * scale4 + swz4 * skew4 + trans4) * (one4 / z4)).store(&dst->fX);
+            }
+            src += 2;
+            dst += 2;
+        }
+    }
+}
+
 const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
     SkMatrix::Identity_pts, SkMatrix::Trans_pts,
     SkMatrix::Scale_pts,   SkMatrix::Scale_pts,
@@ -1053,10 +1088,17 @@ const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
     SkMatrix::Affine_vpts,  SkMatrix::Affine_vpts,
 #endif
     // repeat the persp proc 8 times
+#ifdef SK_SUPPORT_LEGACY_SCALAR_MAPPOINTS
     SkMatrix::Persp_pts,    SkMatrix::Persp_pts,
     SkMatrix::Persp_pts,    SkMatrix::Persp_pts,
     SkMatrix::Persp_pts,    SkMatrix::Persp_pts,
     SkMatrix::Persp_pts,    SkMatrix::Persp_pts
+#else
+    SkMatrix::Persp_vpts,   SkMatrix::Persp_vpts,
+    SkMatrix::Persp_vpts,   SkMatrix::Persp_vpts,
+    SkMatrix::Persp_vpts,   SkMatrix::Persp_vpts,
+    SkMatrix::Persp_vpts,   SkMatrix::Persp_vpts
+#endif
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1130,6 +1172,26 @@ bool SkMatrix::mapRect(SkRect* dst, const SkRect& src) const {
     }
 }
 
+bool SkMatrix::mapRects(SkRect dst[], const SkRect src[], int count) const {
+    SkASSERT((dst && src && count > 0) || 0 == count);
+
+    if (this->rectStaysRect()) {
+        // Each rect is its two corners, so map them all in one pass.
+        this->mapPoints((SkPoint*)dst, (const SkPoint*)src, count * 2);
+        for (int i = 0; i < count; ++i) {
+            dst[i].sort();
+        }
+        return true;
+    }
+    for (int i = 0; i < count; ++i) {
+        SkPoint quad[4];
+        src[i].toQuad(quad);
+        this->mapPoints(quad, quad, 4);
+        dst[i].set(quad, 4);
+    }
+    return false;
+}
+
 SkScalar SkMatrix::mapRadius(SkScalar radius) const {
     SkVector    vec[2];
 
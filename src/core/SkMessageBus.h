@@ -8,6 +8,7 @@
 #ifndef SkMessageBus_DEFINED
 #define SkMessageBus_DEFINED
 
+#include "SkAtomics.h"
 #include "SkLazyPtr.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
@@ -20,6 +21,9 @@ public:
     // Post a message to be received by all Inboxes for this Message type.  Threadsafe.
     static void Post(const Message& m);
 
+    // Post count messages, in order, taking the bus's lock once for all of them.  Threadsafe.
+    static void PostMany(const Message* m, int count);
+
     class Inbox {
     public:
         Inbox();
@@ -29,11 +33,19 @@ public:
         void poll(SkTArray<Message>* out);
 
     private:
-        SkTArray<Message>  fMessages;
-        SkMutex            fMessagesMutex;
+        // Received messages are pushed onto a lock-free stack, newest first.  Any number of
+        // threads may push; poll() takes the whole stack with one exchange.
+        struct Node {
+            Node(const Message& m, Node* next) : fMessage(m), fNext(next) {}
+            Message fMessage;
+            Node*   fNext;
+        };
+        Node* fHead;
 
         friend class SkMessageBus;
-        void receive(const Message& m);  // SkMessageBus is a friend only to call this.
+        // SkMessageBus is a friend only to call these.
+        void receive(const Message* m, int count);
+        static void DeleteList(Node*);
     };
 
 private:
@@ -59,7 +71,7 @@ private:
 //   ----------------------- Implementation of SkMessageBus::Inbox -----------------------
 
 template<typename Message>
-SkMessageBus<Message>::Inbox::Inbox() {
+SkMessageBus<Message>::Inbox::Inbox() : fHead(NULL) {
     // Register ourselves with the corresponding message bus.
     SkMessageBus<Message>* bus = SkMessageBus<Message>::Get();
     SkAutoMutexAcquire lock(bus->fInboxesMutex);
@@ -78,20 +90,53 @@ SkMessageBus<Message>::Inbox::~Inbox() {
             break;
         }
     }
+    DeleteList(fHead);
+}
+
+template<typename Message>
+void SkMessageBus<Message>::Inbox::DeleteList(Node* node) {
+    while (node) {
+        Node* next = node->fNext;
+        SkDELETE(node);
+        node = next;
+    }
 }
 
 template<typename Message>
-void SkMessageBus<Message>::Inbox::receive(const Message& m) {
-    SkAutoMutexAcquire lock(fMessagesMutex);
-    fMessages.push_back(m);
+void SkMessageBus<Message>::Inbox::receive(const Message* m, int count) {
+    if (count <= 0) {
+        return;
+    }
+    // Chain the messages up privately, newest first, then push the whole chain at once.
+    Node* last = SkNEW_ARGS(Node, (m[0], NULL));
+    Node* first = last;
+    for (int i = 1; i < count; i++) {
+        first = SkNEW_ARGS(Node, (m[i], first));
+    }
+    Node* head = sk_atomic_load(&fHead, sk_memory_order_relaxed);
+    do {
+        last->fNext = head;
+    } while (!sk_atomic_compare_exchange(&fHead, &head, first,
+                                         sk_memory_order_release, sk_memory_order_relaxed));
 }
 
 template<typename Message>
 void SkMessageBus<Message>::Inbox::poll(SkTArray<Message>* messages) {
     SkASSERT(messages);
     messages->reset();
-    SkAutoMutexAcquire lock(fMessagesMutex);
-    fMessages.swap(messages);
+    Node* node = sk_atomic_exchange(&fHead, (Node*)NULL, sk_memory_order_acquire);
+    // The stack is newest first; reverse it to hand the messages out oldest first.
+    Node* oldest = NULL;
+    while (node) {
+        Node* next = node->fNext;
+        node->fNext = oldest;
+        oldest = node;
+        node = next;
+    }
+    for (node = oldest; node; node = node->fNext) {
+        messages->push_back(node->fMessage);
+    }
+    DeleteList(oldest);
 }
 
 //   ----------------------- Implementation of SkMessageBus -----------------------
@@ -101,10 +146,17 @@ SkMessageBus<Message>::SkMessageBus() {}
 
 template <typename Message>
 /*static*/ void SkMessageBus<Message>::Post(const Message& m) {
+    PostMany(&m, 1);
+}
+
+template <typename Message>
+/*static*/ void SkMessageBus<Message>::PostMany(const Message* m, int count) {
     SkMessageBus<Message>* bus = SkMessageBus<Message>::Get();
+    // This lock only keeps inboxes from going away while we deliver to them.  Delivery itself
+    // never blocks: the inboxes' stacks are lock-free.
     SkAutoMutexAcquire lock(bus->fInboxesMutex);
     for (int i = 0; i < bus->fInboxes.count(); i++) {
-        bus->fInboxes[i]->receive(m);
+        bus->fInboxes[i]->receive(m, count);
     }
 }
 
@@ -8,26 +8,28 @@
 #include "SkMipMap.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
-
-static void downsample32_nocheck(void* dst, int, int, const void* srcPtr, const SkBitmap& srcBM) {
-    const uint32_t* p = static_cast<const uint32_t*>(srcPtr);
-    const uint32_t* baseP = p;
-    uint32_t c, ag, rb;
-
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    p += 1;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    p = baseP;
-    p += srcBM.rowBytes() >> 2;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    p += 1;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    *(uint32_t*)dst = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+#include "SkMipMap_opts.h"
+#include "SkOnce.h"
+#include "SkTaskGroup.h"
+#include "SkUnPreMultiply.h"
+
+#include <math.h>
+
+// Averages 2x2 blocks of 8888 pixels, one channel at a time, whatever their order in memory.
+static void downsample32_row(void* dst, const void* srcPtr, size_t srcRowBytes, int count) {
+    const uint32_t* p0 = static_cast<const uint32_t*>(srcPtr);
+    const uint32_t* p1 = (const uint32_t*)((const char*)srcPtr + srcRowBytes);
+    uint32_t* d = static_cast<uint32_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t ag = ((p0[0] >> 8) & 0xFF00FF) + ((p0[1] >> 8) & 0xFF00FF) +
+                      ((p1[0] >> 8) & 0xFF00FF) + ((p1[1] >> 8) & 0xFF00FF);
+        uint32_t rb = (p0[0] & 0xFF00FF) + (p0[1] & 0xFF00FF) +
+                      (p1[0] & 0xFF00FF) + (p1[1] & 0xFF00FF);
+        d[i] = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
+    }
 }
 
 static void downsample32_check(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
@@ -69,6 +71,19 @@ static inline U16CPU pack16(uint32_t c) {
     return (c & ~SK_G16_MASK_IN_PLACE) | ((c >> 16) & SK_G16_MASK_IN_PLACE);
 }
 
+static void downsample16_row(void* dst, const void* srcPtr, size_t srcRowBytes, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(srcPtr);
+    const uint16_t* p1 = (const uint16_t*)((const char*)srcPtr + srcRowBytes);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t c = expand16(p0[0]) + expand16(p0[1]) + expand16(p1[0]) + expand16(p1[1]);
+        d[i] = (uint16_t)pack16(c >> 2);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
 static void downsample16(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
     const uint16_t* p = static_cast<const uint16_t*>(srcPtr);
     const uint16_t* baseP = p;
@@ -106,6 +121,19 @@ static U16CPU collaps4444(uint32_t c) {
     return (c & 0xF0F) | ((c >> 12) & ~0xF0F);
 }
 
+static void downsample4444_row(void* dst, const void* srcPtr, size_t srcRowBytes, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(srcPtr);
+    const uint16_t* p1 = (const uint16_t*)((const char*)srcPtr + srcRowBytes);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t c = expand4444(p0[0]) + expand4444(p0[1]) + expand4444(p1[0]) + expand4444(p1[1]);
+        d[i] = (uint16_t)collaps4444(c >> 2);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
 static void downsample4444(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
     const uint16_t* p = static_cast<const uint16_t*>(srcPtr);
     const uint16_t* baseP = p;
@@ -135,10 +163,16 @@ static void downsample4444(void* dst, int x, int y, const void* srcPtr, const Sk
    *((uint16_t*)dst) = (uint16_t)collaps4444(c >> 2);
 }
 
-static void downsample8_nocheck(void* dst, int, int, const void* srcPtr, const SkBitmap& srcBM) {
-    const size_t rb = srcBM.rowBytes();
-    const uint8_t* p = static_cast<const uint8_t*>(srcPtr);
-    *(uint8_t*)dst = (p[0] + p[1] + p[rb] + p[rb + 1]) >> 2;
+static void downsample8_row(void* dst, const void* srcPtr, size_t srcRowBytes, int count) {
+    const uint8_t* p0 = static_cast<const uint8_t*>(srcPtr);
+    const uint8_t* p1 = p0 + srcRowBytes;
+    uint8_t* d = static_cast<uint8_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        d[i] = (p0[0] + p0[1] + p1[0] + p1[1]) >> 2;
+        p0 += 2;
+        p1 += 2;
+    }
 }
 
 static void downsample8_check(void* dst, int x, int y, const void* srcPtr, const SkBitmap& srcBM) {
@@ -168,6 +202,90 @@ static void downsample8_check(void* dst, int x, int y, const void* srcPtr, const
     *(uint8_t*)dst = c >> 2;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// For gamma correct downsampling: sRGB bytes to 16 bit linear values, and the top 12 bits of
+// linear values back to sRGB bytes.
+static uint16_t gSRGBToLinear[256];
+static uint8_t  gLinearToSRGB[4096];
+
+static void init_srgb_tables() {
+    for (int i = 0; i < 256; ++i) {
+        const float s = i / 255.0f;
+        const float l = s <= 0.04045f ? s / 12.92f : powf((s + 0.055f) / 1.055f, 2.4f);
+        gSRGBToLinear[i] = (uint16_t)(l * 65535 + 0.5f);
+    }
+    for (int i = 0; i < 4096; ++i) {
+        // The middle of the range of linear values that map to entry i.
+        const float l = (i + 0.5f) / 4096;
+        const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1 / 2.4f) - 0.055f;
+        gLinearToSRGB[i] = SkToU8(SkClampMax((int)(s * 255 + 0.5f), 255));
+    }
+}
+
+SK_DECLARE_STATIC_ONCE(gSRGBTablesOnce);
+
+/**
+ *  Averages four premultiplied (or opaque) 8888 pixels in linear space: each color channel is
+ *  unpremultiplied, linearized and weighted by its alpha, and the average is converted back to
+ *  sRGB and premultiplied by the average alpha.
+ */
+static uint32_t average32_gamma(const uint8_t* p00, const uint8_t* p01,
+                                const uint8_t* p10, const uint8_t* p11) {
+    const uint8_t* pixels[] = { p00, p01, p10, p11 };
+    uint32_t sums[3] = { 0, 0, 0 };
+    unsigned alphaSum = 0;
+    for (int i = 0; i < 4; ++i) {
+        // Alpha is the last byte of both kRGBA_8888 and kBGRA_8888.
+        const unsigned a = pixels[i][3];
+        const SkUnPreMultiply::Scale scale = SkUnPreMultiply::GetScale(a);
+        for (int c = 0; c < 3; ++c) {
+            sums[c] += gSRGBToLinear[SkUnPreMultiply::ApplyScale(scale, pixels[i][c])] * a;
+        }
+        alphaSum += a;
+    }
+    if (0 == alphaSum) {
+        return 0;
+    }
+
+    const unsigned a = alphaSum >> 2;
+    uint8_t result[4];
+    for (int c = 0; c < 3; ++c) {
+        result[c] = SkToU8(SkMulDiv255Round(gLinearToSRGB[(sums[c] / alphaSum) >> 4], a));
+    }
+    result[3] = SkToU8(a);
+    uint32_t pixel;
+    memcpy(&pixel, result, sizeof(pixel));
+    return pixel;
+}
+
+static void downsample32_gamma_row(void* dst, const void* srcPtr, size_t srcRowBytes, int count) {
+    const uint8_t* p0 = static_cast<const uint8_t*>(srcPtr);
+    const uint8_t* p1 = p0 + srcRowBytes;
+    uint32_t* d = static_cast<uint32_t*>(dst);
+
+    for (int i = 0; i < count; ++i) {
+        d[i] = average32_gamma(p0, p0 + 4, p1, p1 + 4);
+        p0 += 8;
+        p1 += 8;
+    }
+}
+
+static void downsample32_gamma_check(void* dst, int x, int y, const void* srcPtr,
+                                     const SkBitmap& srcBM) {
+    const uint8_t* p = static_cast<const uint8_t*>(srcPtr);
+
+    x <<= 1;
+    y <<= 1;
+    SkASSERT((const void*)srcBM.getAddr32(x, y) == srcPtr);
+
+    const size_t dx = x < srcBM.width() - 1 ? 4 : 0;
+    const size_t dy = y < srcBM.height() - 1 ? srcBM.rowBytes() : 0;
+    *((uint32_t*)dst) = average32_gamma(p, p + dx, p + dy, p + dy + dx);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     if (levelCount < 0) {
         return 0;
@@ -181,33 +299,111 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 
 typedef void SkDownSampleProc(void*, int x, int y, const void* srcPtr, const SkBitmap& srcBM);
 
-SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
-    SkDownSampleProc* proc_nocheck, *proc_check;
+namespace {
+// Rows [fTop, fBottom) of one level, built from the level above it.
+struct DownsampleBand {
+    const SkBitmap*             fSrc;
+    const SkBitmap*             fDst;
+    int                         fTop;
+    int                         fBottom;
+    SkMipMapDownsampleRowProc   fRowProc;
+    SkDownSampleProc*           fCheckProc;
+};
+}
+
+static void downsample_band(DownsampleBand* band) {
+    const SkBitmap& srcBM = *band->fSrc;
+    const SkBitmap& dstBM = *band->fDst;
+    const int width = dstBM.width();
+    const int widthEven = width & ~1;
+    const int heightEven = dstBM.height() & ~1;
+    const size_t pixelSize = srcBM.info().bytesPerPixel();
+
+    for (int y = band->fTop; y < band->fBottom; y++) {
+        const char* srcPtr = (const char*)srcBM.getPixels() + srcBM.rowBytes() * 2 * y;
+        char* dstPtr = (char*)dstBM.getPixels() + dstBM.rowBytes() * y;
+        int x = 0;
+        if (y < heightEven) {
+            band->fRowProc(dstPtr, srcPtr, srcBM.rowBytes(), widthEven);
+            srcPtr += pixelSize * 2 * widthEven;
+            dstPtr += pixelSize * widthEven;
+            x = widthEven;
+        }
+        for (; x < width; x++) {
+            band->fCheckProc(dstPtr, x, y, srcPtr, srcBM);
+            srcPtr += pixelSize * 2;
+            dstPtr += pixelSize;
+        }
+    }
+}
+
+// Levels with at least this many pixels are built in bands of kBandRows rows on an SkTaskGroup.
+static const int kMinParallelPixels = 256 * 1024;
+static const int kBandRows = 64;
+
+static void downsample_level(const SkBitmap& srcBM, const SkBitmap& dstBM,
+                             SkMipMapDownsampleRowProc rowProc, SkDownSampleProc* checkProc) {
+    const int height = dstBM.height();
+    const int bandCount = (height + kBandRows - 1) / kBandRows;
+    if (bandCount < 2 || sk_64_mul(dstBM.width(), height) < kMinParallelPixels) {
+        DownsampleBand band = { &srcBM, &dstBM, 0, height, rowProc, checkProc };
+        downsample_band(&band);
+        return;
+    }
+
+    SkAutoSTArray<32, DownsampleBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        DownsampleBand band = { &srcBM, &dstBM, i * kBandRows,
+                                SkTMin((i + 1) * kBandRows, height), rowProc, checkProc };
+        bands[i] = band;
+    }
+    SkTaskGroup tg;
+    tg.batch(downsample_band, bands.get(), bandCount);
+    tg.wait();
+}
+
+SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact, bool gammaCorrect) {
+    SkMipMapDownsampleRowProc proc_row, platform_row;
+    SkDownSampleProc* proc_check;
 
     const SkColorType ct = src.colorType();
     const SkAlphaType at = src.alphaType();
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc_check = downsample32_check;
-            proc_nocheck = downsample32_nocheck;
+            if (gammaCorrect && kUnpremul_SkAlphaType != at) {
+                SkOnce(&gSRGBTablesOnce, init_srgb_tables);
+                proc_check = downsample32_gamma_check;
+                proc_row = downsample32_gamma_row;
+                platform_row = NULL;
+            } else {
+                proc_check = downsample32_check;
+                proc_row = downsample32_row;
+                platform_row = SkMipMapGetPlatformDownsampleProc(k8888_SkMipMapDownsampleProcType);
+            }
             break;
         case kRGB_565_SkColorType:
             proc_check = downsample16;
-            proc_nocheck = proc_check;
+            proc_row = downsample16_row;
+            platform_row = SkMipMapGetPlatformDownsampleProc(k565_SkMipMapDownsampleProcType);
             break;
         case kARGB_4444_SkColorType:
             proc_check = downsample4444;
-            proc_nocheck = proc_check;
+            proc_row = downsample4444_row;
+            platform_row = NULL;
             break;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
             proc_check = downsample8_check;
-            proc_nocheck = downsample8_nocheck;
+            proc_row = downsample8_row;
+            platform_row = SkMipMapGetPlatformDownsampleProc(kA8_SkMipMapDownsampleProcType);
             break;
         default:
             return NULL; // don't build mipmaps for any other colortypes (yet)
     }
+    if (platform_row) {
+        proc_row = platform_row;
+    }
 
     SkAutoLockPixels alp(src);
     if (!src.readyToDraw()) {
@@ -277,37 +473,7 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
         dstBM.installPixels(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
 
         srcBM.lockPixels();
-        const int widthEven = width & ~1;
-        const int heightEven = height & ~1;
-        const size_t pixelSize = srcBM.info().bytesPerPixel();
-
-        const void* srcBasePtr = srcBM.getPixels();
-        void* dstBasePtr = dstBM.getPixels();
-        for (int y = 0; y < heightEven; y++) {
-            const void* srcPtr = srcBasePtr;
-            void* dstPtr = dstBasePtr;
-            for (int x = 0; x < widthEven; x++) {
-                proc_nocheck(dstPtr, x, y, srcPtr, srcBM);
-                srcPtr = (char*)srcPtr + pixelSize * 2;
-                dstPtr = (char*)dstPtr + pixelSize;
-            }
-            if (width & 1) {
-                proc_check(dstPtr, widthEven, y, srcPtr, srcBM);
-            }
-
-            srcBasePtr = (char*)srcBasePtr + srcBM.rowBytes() * 2;
-            dstBasePtr = (char*)dstBasePtr + dstBM.rowBytes();
-        }
-        if (height & 1) {
-            const void* srcPtr = srcBasePtr;
-            void* dstPtr = dstBasePtr;
-            for (int x = 0; x < width; x++) {
-                proc_check(dstPtr, x, heightEven, srcPtr, srcBM);
-                srcPtr = (char*)srcPtr + pixelSize * 2;
-                dstPtr = (char*)dstPtr + pixelSize;
-            }
-        }
-
+        downsample_level(srcBM, dstBM, proc_row, proc_check);
         srcBM.unlockPixels();
 
         srcBM = dstBM;
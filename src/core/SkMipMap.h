@@ -18,7 +18,16 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
 
 class SkMipMap : public SkCachedData {
 public:
-    static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
+    /**
+     *  Builds every level of src, each half the size of the one above it. Large levels are
+     *  built in bands on an SkTaskGroup.
+     *
+     *  If gammaCorrect is true, premultiplied and opaque 8888 pixels are treated as sRGB and
+     *  averaged in linear space, so that bright and dark details don't darken as they shrink.
+     *  This is slower, and other color types ignore it.
+     */
+    static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc,
+                           bool gammaCorrect = false);
 
     struct Level {
         void*       fPixels;
@@ -12,7 +12,9 @@
 #include "SkCanvasPriv.h"
 #include "SkMultiPictureDraw.h"
 #include "SkPicture.h"
+#include "SkTArray.h"
 #include "SkTaskGroup.h"
+#include "SkTHash.h"
 
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -41,6 +43,15 @@ void SkMultiPictureDraw::DrawData::init(SkCanvas* canvas, const SkPicture* pictu
     }
 }
 
+void SkMultiPictureDraw::RasterTarget::Draw(RasterTarget* target) {
+    for (int i = 0; i < target->fDraws.count(); ++i) {
+        target->fDraws[i]->draw();
+    }
+    if (target->fFlush && target->fDraws.count() > 0) {
+        target->fDraws[0]->fCanvas->flush();
+    }
+}
+
 void SkMultiPictureDraw::DrawData::Reset(SkTDArray<DrawData>& data) {
     for (int i = 0; i < data.count(); ++i) {
         data[i].fPicture->unref();
@@ -84,21 +95,50 @@ public:
     ~AutoMPDReset() { fMPD->reset(); }
 };
 
+// The render target a GPU canvas draws into, or the canvas itself if it can't tell.
+static const void* render_target(SkCanvas* canvas) {
+#if SK_SUPPORT_GPU
+    if (GrRenderTarget* rt = canvas->internal_private_accessTopLayerRenderTarget()) {
+        return rt;
+    }
+#endif
+    return canvas;
+}
+
 //#define FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
 
 void SkMultiPictureDraw::draw(bool flush) {
     AutoMPDReset mpdreset(this);
 
+    // Draws into the same canvas, or into different canvases on the same pixels, must not race,
+    // so gather the raster draws by target; only distinct targets are drawn concurrently.
+    SkTArray<RasterTarget> rasterTargets;
+    {
+        SkTHashMap<const void*, int> targetIndex;
+        for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
+            DrawData* dd = &fThreadSafeDrawData[i];
+            const void* key = dd->fCanvas->accessTopLayerPixels(NULL, NULL);
+            if (NULL == key) {
+                key = dd->fCanvas;
+            }
+            int* index = targetIndex.find(key);
+            if (NULL == index) {
+                index = targetIndex.set(key, rasterTargets.count());
+                rasterTargets.push_back().fFlush = flush;
+            }
+            *rasterTargets[*index].fDraws.append() = dd;
+        }
+    }
+
 #ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
-    for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
-        DrawData* dd = &fThreadSafeDrawData.begin()[i];
-        dd->fCanvas->drawPicture(dd->fPicture, &dd->fMatrix, dd->fPaint);
+    for (int i = 0; i < rasterTargets.count(); ++i) {
+        RasterTarget::Draw(&rasterTargets[i]);
     }
 #else
-    // we place the taskgroup after the MPDReset, to ensure that we don't delete the DrawData
-    // objects until after we're finished the tasks (which have pointers to the data).
+    // we place the taskgroup after the MPDReset and the targets, to ensure that we don't delete
+    // the DrawData objects until after we're finished the tasks (which have pointers to them).
     SkTaskGroup group;
-    group.batch(DrawData::Draw, fThreadSafeDrawData.begin(), fThreadSafeDrawData.count());
+    group.batch(RasterTarget::Draw, rasterTargets.begin(), rasterTargets.count());
 #endif
     // we deliberately don't call wait() here, since the destructor will do that, this allows us
     // to continue processing gpu-data without having to wait on the cpu tasks.
@@ -150,8 +190,30 @@ void SkMultiPictureDraw::draw(bool flush) {
     SkTDArray<GrHoistedLayer> needRendering, recycled;
 #endif
 
+    // Draw everything into one render target before moving on to the next, so the GPU switches
+    // targets as little as possible.  Each target's draws stay in the order they were added.
+    SkTDArray<int> order;
+    order.setReserve(count);
+    {
+        SkTDArray<bool> ordered;
+        ordered.setCount(count);
+        memset(ordered.begin(), 0, count * sizeof(bool));
+        for (int i = 0; i < count; ++i) {
+            if (ordered[i]) {
+                continue;
+            }
+            const void* target = render_target(fGPUDrawData[i].fCanvas);
+            for (int j = i; j < count; ++j) {
+                if (!ordered[j] && render_target(fGPUDrawData[j].fCanvas) == target) {
+                    *order.append() = j;
+                    ordered[j] = true;
+                }
+            }
+        }
+    }
+
     for (int i = 0; i < count; ++i) {
-        const DrawData& data = fGPUDrawData[i];
+        const DrawData& data = fGPUDrawData[order[i]];
         SkCanvas* canvas = data.fCanvas;
         const SkPicture* picture = data.fPicture;
 
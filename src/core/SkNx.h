@@ -21,12 +21,39 @@
 template <int N, typename T>
 class SkNi {
 public:
-    // For now SkNi is a _very_ minimal sketch just to support comparison operators on SkNf.
+    // For now SkNi is a _very_ minimal sketch: comparison results for SkNf, plus integer math.
     SkNi() {}
     SkNi(const SkNi<N/2, T>& lo, const SkNi<N/2, T>& hi) : fLo(lo), fHi(hi) {}
+    explicit SkNi(T val) : fLo(val), fHi(val) {}
+    static SkNi Load(const T vals[N]) {
+        return SkNi(SkNi<N/2,T>::Load(vals), SkNi<N/2,T>::Load(vals+N/2));
+    }
+
+    SkNi(T a, T b)           : fLo(a),   fHi(b)   { REQUIRE(N==2); }
+    SkNi(T a, T b, T c, T d) : fLo(a,b), fHi(c,d) { REQUIRE(N==4); }
+
+    void store(T vals[N]) const {
+        fLo.store(vals);
+        fHi.store(vals+N/2);
+    }
+
+    SkNi operator + (const SkNi& o) const { return SkNi(fLo + o.fLo, fHi + o.fHi); }
+    SkNi operator - (const SkNi& o) const { return SkNi(fLo - o.fLo, fHi - o.fHi); }
+    SkNi operator & (const SkNi& o) const { return SkNi(fLo & o.fLo, fHi & o.fHi); }
+    SkNi operator | (const SkNi& o) const { return SkNi(fLo | o.fLo, fHi | o.fHi); }
+    SkNi operator ^ (const SkNi& o) const { return SkNi(fLo ^ o.fLo, fHi ^ o.fHi); }
+
+    SkNi operator << (int bits) const { return SkNi(fLo << bits, fHi << bits); }
+    SkNi operator >> (int bits) const { return SkNi(fLo >> bits, fHi >> bits); }
+
     bool allTrue() const { return fLo.allTrue() && fHi.allTrue(); }
     bool anyTrue() const { return fLo.anyTrue() || fHi.anyTrue(); }
 
+    T operator[] (int k) const {
+        SkASSERT(0 <= k && k < N);
+        return k < N/2 ? fLo[k] : fHi[k-N/2];
+    }
+
 private:
     REQUIRE(0 == (N & (N-1)));
     SkNi<N/2, T> fLo, fHi;
@@ -78,6 +105,9 @@ public:
     SkNf       invert() const { return SkNf(fLo.      invert(), fHi.      invert()); }
     SkNf approxInvert() const { return SkNf(fLo.approxInvert(), fHi.approxInvert()); }
 
+    // Converts to integers, rounding toward zero like a C cast.
+    Ni castTrunc() const { return Ni(fLo.castTrunc(), fHi.castTrunc()); }
+
     T operator[] (int k) const {
         SkASSERT(0 <= k && k < N);
         return k < N/2 ? fLo[k] : fHi[k-N/2];
@@ -97,9 +127,27 @@ class SkNi<1,T> {
 public:
     SkNi() {}
     explicit SkNi(T val) : fVal(val) {}
+    static SkNi Load(const T vals[1]) { return SkNi(vals[0]); }
+
+    void store(T vals[1]) const { vals[0] = fVal; }
+
+    SkNi operator + (const SkNi& o) const { return SkNi(fVal + o.fVal); }
+    SkNi operator - (const SkNi& o) const { return SkNi(fVal - o.fVal); }
+    SkNi operator & (const SkNi& o) const { return SkNi(fVal & o.fVal); }
+    SkNi operator | (const SkNi& o) const { return SkNi(fVal | o.fVal); }
+    SkNi operator ^ (const SkNi& o) const { return SkNi(fVal ^ o.fVal); }
+
+    SkNi operator << (int bits) const { return SkNi(fVal << bits); }
+    SkNi operator >> (int bits) const { return SkNi(fVal >> bits); }
+
     bool allTrue() const { return (bool)fVal; }
     bool anyTrue() const { return (bool)fVal; }
 
+    T operator[] (int SkDEBUGCODE(k)) const {
+        SkASSERT(k == 0);
+        return fVal;
+    }
+
 private:
     T fVal;
 };
@@ -137,6 +185,8 @@ public:
     SkNf       invert() const { return SkNf((T)1 / fVal); }
     SkNf approxInvert() const { return this->invert();    }
 
+    Ni castTrunc() const { return Ni(fVal); }
+
     T operator[] (int SkDEBUGCODE(k)) const {
         SkASSERT(k == 0);
         return fVal;
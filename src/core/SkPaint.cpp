@@ -16,6 +16,7 @@
 #include "SkFontDescriptor.h"
 #include "SkGlyphCache.h"
 #include "SkImageFilter.h"
+#include "SkLazyPtr.h"
 #include "SkMaskFilter.h"
 #include "SkMaskGamma.h"
 #include "SkReadBuffer.h"
@@ -235,6 +236,10 @@ void SkPaint::setDistanceFieldTextTEMP(bool doDistanceFieldText) {
     this->setFlags(SkSetClearMask(fBitfields.fFlags, doDistanceFieldText, kDistanceFieldTextTEMP_Flag));
 }
 
+void SkPaint::setFloatPipeline(bool floatPipeline) {
+    this->setFlags(SkSetClearMask(fBitfields.fFlags, floatPipeline, kFloatPipeline_Flag));
+}
+
 void SkPaint::setStyle(Style style) {
     if ((unsigned)style < kStyleCount) {
         fBitfields.fStyle = style;
@@ -1228,6 +1233,35 @@ void SkPaint::getPosTextPath(const void* textData, size_t length,
     }
 }
 
+void SkPaint::getGlyphPaths(const uint16_t glyphs[], int count, SkPath* outlines,
+                            int pointOffsets[], int verbOffsets[]) const {
+    SkASSERT(count == 0 || glyphs != NULL);
+
+    if (NULL == outlines) {
+        return;
+    }
+    outlines->reset();
+    count = SkMax32(count, 0);
+
+    // Set up like SkTextToPathIter, so these are the same outlines getTextPath() would use.
+    SkPaint paint(*this);
+    paint.setTextEncoding(kGlyphID_TextEncoding);
+    paint.setLinearText(true);
+    paint.setMaskFilter(NULL);
+    paint.setPathEffect(NULL);
+    paint.setStyle(kFill_Style);
+    paint.setTextSize(SkIntToScalar(kCanonicalTextSizeForPaths));
+
+    SkGlyphCache* cache = paint.detachCache(NULL, NULL, false);
+    cache->appendGlyphPaths(glyphs, count, outlines, pointOffsets, verbOffsets);
+    SkGlyphCache::AttachCache(cache);
+
+    const SkScalar scale = this->getTextSize() / kCanonicalTextSizeForPaths;
+    if (scale != SK_Scalar1) {
+        outlines->transform(SkMatrix::MakeScale(scale, scale));
+    }
+}
+
 SkRect SkPaint::getFontBounds() const {
     SkMatrix m;
     m.setScale(fTextSize * fTextScaleX, fTextSize);
@@ -1502,14 +1536,57 @@ void SkScalerContext::MakeRec(const SkPaint& paint,
     // be sure to call PostMakeRec(rec) before you actually use it!
 }
 
+#ifdef SK_GAMMA_CONTRAST
+static const SkScalar kDefaultContrast = SK_GAMMA_CONTRAST;
+#else
+static const SkScalar kDefaultContrast = 0.5f;  // as MakeRec() uses
+#endif
+
 /**
- * In order to call cachedDeviceLuminance, cachedPaintLuminance, or
- * cachedMaskGamma the caller must hold the gMaskGammaCacheMutex and continue
- * to hold it until the returned pointer is refed or forgotten.
+ * The (contrast, paint gamma, device gamma) triples nearly every glyph cache asks for. Their
+ * SkMaskGammas are built on first use and then shared by all threads without taking a lock.
  */
+struct MaskGammaParams {
+    SkScalar fContrast;
+    SkScalar fPaintGamma;
+    SkScalar fDeviceGamma;
+};
+static const MaskGammaParams gCommonMaskGammaParams[] = {
+    { 0,                SK_Scalar1,        SK_Scalar1 },         // linear, when gamma is ignored
+    { kDefaultContrast, SK_GAMMA_EXPONENT, SK_GAMMA_EXPONENT },  // the default from MakeRec()
+    { 0,                SK_GAMMA_EXPONENT, SK_GAMMA_EXPONENT },  // fonthosts that clear contrast
+    { kDefaultContrast, SK_Scalar1,        SK_Scalar1 },         // linear devices
+};
+
+// The common triple i, rounded the way SkScalerContext::Rec stores it, since that is how glyph
+// caches ask for it.
+static MaskGammaParams common_mask_gamma_params(int i) {
+    SkScalerContext::Rec rec;
+    rec.setContrast(gCommonMaskGammaParams[i].fContrast);
+    rec.setPaintGamma(gCommonMaskGammaParams[i].fPaintGamma);
+    rec.setDeviceGamma(gCommonMaskGammaParams[i].fDeviceGamma);
+    MaskGammaParams params = { rec.getContrast(), rec.getPaintGamma(), rec.getDeviceGamma() };
+    return params;
+}
+
+// As a template argument these must have external linkage.
+SkMaskGamma* sk_create_common_mask_gamma(int i) {
+    if (0 == i) {
+        return SkNEW(SkMaskGamma);
+    }
+    MaskGammaParams params = common_mask_gamma_params(i);
+    return SkNEW_ARGS(SkMaskGamma, (params.fContrast, params.fPaintGamma, params.fDeviceGamma));
+}
+
+namespace { void sk_unref_mask_gamma(SkMaskGamma* maskGamma) { maskGamma->unref(); } }
+
+SK_DECLARE_STATIC_LAZY_PTR_ARRAY(SkMaskGamma, gCommonMaskGammas,
+                                 SK_ARRAY_COUNT(gCommonMaskGammaParams),
+                                 sk_create_common_mask_gamma, sk_unref_mask_gamma);
+
+// Any other triple gets the single SkMaskGamma cached below, under gMaskGammaCacheMutex.
 SK_DECLARE_STATIC_MUTEX(gMaskGammaCacheMutex);
 
-static SkMaskGamma* gLinearMaskGamma = NULL;
 static SkMaskGamma* gMaskGamma = NULL;
 static SkScalar gContrast = SK_ScalarMin;
 static SkScalar gPaintGamma = SK_ScalarMin;
@@ -1520,12 +1597,6 @@ static SkScalar gDeviceGamma = SK_ScalarMin;
  */
 static const SkMaskGamma& cachedMaskGamma(SkScalar contrast, SkScalar paintGamma, SkScalar deviceGamma) {
     gMaskGammaCacheMutex.assertHeld();
-    if (0 == contrast && SK_Scalar1 == paintGamma && SK_Scalar1 == deviceGamma) {
-        if (NULL == gLinearMaskGamma) {
-            gLinearMaskGamma = SkNEW(SkMaskGamma);
-        }
-        return *gLinearMaskGamma;
-    }
     if (gContrast != contrast || gPaintGamma != paintGamma || gDeviceGamma != deviceGamma) {
         SkSafeUnref(gMaskGamma);
         gMaskGamma = SkNEW_ARGS(SkMaskGamma, (contrast, paintGamma, deviceGamma));
@@ -1536,11 +1607,26 @@ static const SkMaskGamma& cachedMaskGamma(SkScalar contrast, SkScalar paintGamma
     return *gMaskGamma;
 }
 
+/**
+ * Returns a ref to the SkMaskGamma for these parameters. Only uncommon parameters take the lock.
+ */
+static const SkMaskGamma* refMaskGamma(SkScalar contrast, SkScalar paintGamma,
+                                       SkScalar deviceGamma) {
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(gCommonMaskGammaParams); ++i) {
+        MaskGammaParams params = common_mask_gamma_params(i);
+        if (params.fContrast == contrast &&
+            params.fPaintGamma == paintGamma &&
+            params.fDeviceGamma == deviceGamma) {
+            return SkRef(gCommonMaskGammas[i]);
+        }
+    }
+    SkAutoMutexAcquire ama(gMaskGammaCacheMutex);
+    return SkRef(&cachedMaskGamma(contrast, paintGamma, deviceGamma));
+}
+
 /*static*/ void SkPaint::Term() {
     SkAutoMutexAcquire ama(gMaskGammaCacheMutex);
 
-    SkSafeUnref(gLinearMaskGamma);
-    gLinearMaskGamma = NULL;
     SkSafeUnref(gMaskGamma);
     gMaskGamma = NULL;
     SkDEBUGCODE(gContrast = SK_ScalarMin;)
@@ -1776,21 +1862,19 @@ SkGlyphCache* SkPaint::detachCache(const SkDeviceProperties* deviceProperties,
  */
 //static
 SkMaskGamma::PreBlend SkScalerContext::GetMaskPreBlend(const SkScalerContext::Rec& rec) {
-    SkAutoMutexAcquire ama(gMaskGammaCacheMutex);
-    const SkMaskGamma& maskGamma = cachedMaskGamma(rec.getContrast(),
-                                                   rec.getPaintGamma(),
-                                                   rec.getDeviceGamma());
-    return maskGamma.preBlend(rec.getLuminanceColor());
+    SkAutoTUnref<const SkMaskGamma> maskGamma(refMaskGamma(rec.getContrast(),
+                                                           rec.getPaintGamma(),
+                                                           rec.getDeviceGamma()));
+    return maskGamma->preBlend(rec.getLuminanceColor());
 }
 
 size_t SkScalerContext::GetGammaLUTSize(SkScalar contrast, SkScalar paintGamma,
                                         SkScalar deviceGamma, int* width, int* height) {
-    SkAutoMutexAcquire ama(gMaskGammaCacheMutex);
-    const SkMaskGamma& maskGamma = cachedMaskGamma(contrast,
-                                                   paintGamma,
-                                                   deviceGamma);
+    SkAutoTUnref<const SkMaskGamma> maskGamma(refMaskGamma(contrast,
+                                                           paintGamma,
+                                                           deviceGamma));
 
-    maskGamma.getGammaTableDimensions(width, height);
+    maskGamma->getGammaTableDimensions(width, height);
     size_t size = (*width)*(*height)*sizeof(uint8_t);
 
     return size;
@@ -1798,14 +1882,13 @@ size_t SkScalerContext::GetGammaLUTSize(SkScalar contrast, SkScalar paintGamma,
 
 void SkScalerContext::GetGammaLUTData(SkScalar contrast, SkScalar paintGamma, SkScalar deviceGamma,
                                       void* data) {
-    SkAutoMutexAcquire ama(gMaskGammaCacheMutex);
-    const SkMaskGamma& maskGamma = cachedMaskGamma(contrast,
-                                                   paintGamma,
-                                                   deviceGamma);
+    SkAutoTUnref<const SkMaskGamma> maskGamma(refMaskGamma(contrast,
+                                                           paintGamma,
+                                                           deviceGamma));
     int width, height;
-    maskGamma.getGammaTableDimensions(&width, &height);
+    maskGamma->getGammaTableDimensions(&width, &height);
     size_t size = width*height*sizeof(uint8_t);
-    const uint8_t* gammaTables = maskGamma.getGammaTables();
+    const uint8_t* gammaTables = maskGamma->getGammaTables();
     memcpy(data, gammaTables, size);
 }
 
@@ -2248,6 +2331,7 @@ void SkPaint::toString(SkString* str) const {
         SkAddFlagToString(str, this->isVerticalText(), "VerticalText", &needSeparator);
         SkAddFlagToString(str, SkToBool(this->getFlags() & SkPaint::kGenA8FromLCD_Flag),
                           "GenA8FromLCD", &needSeparator);
+        SkAddFlagToString(str, this->isFloatPipeline(), "FloatPipeline", &needSeparator);
     } else {
         str->append("None");
     }
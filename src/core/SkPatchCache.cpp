@@ -0,0 +1,160 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPatchCache.h"
+#include "SkAtomics.h"
+#include "SkGraphics.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+static bool gPatchCacheEnabled = false;
+static int32_t gPatchCacheHits = 0;
+static int32_t gPatchCacheMisses = 0;
+
+namespace {
+static unsigned gPatchKeyNamespaceLabel;
+
+struct PatchKey : public SkResourceCache::Key {
+public:
+    PatchKey(const SkPoint cubics[12], const SkColor colors[4], const SkPoint texCoords[4],
+             int lodX, int lodY)
+        : fLodX(lodX)
+        , fLodY(lodY)
+        , fFlags((colors ? 1 : 0) | (texCoords ? 2 : 0))
+    {
+        memcpy(fCubics, cubics, sizeof(fCubics));
+        if (colors) {
+            memcpy(fColors, colors, sizeof(fColors));
+        } else {
+            memset(fColors, 0, sizeof(fColors));
+        }
+        if (texCoords) {
+            memcpy(fTexCoords, texCoords, sizeof(fTexCoords));
+        } else {
+            memset(fTexCoords, 0, sizeof(fTexCoords));
+        }
+        // Patches have no ID to purge them by, so they don't share one.
+        this->init(&gPatchKeyNamespaceLabel, 0,
+                   sizeof(fCubics) + sizeof(fTexCoords) + sizeof(fColors) +
+                   sizeof(fLodX) + sizeof(fLodY) + sizeof(fFlags));
+    }
+
+    SkPoint  fCubics[SkPatchUtils::kNumCtrlPts];
+    SkPoint  fTexCoords[SkPatchUtils::kNumCorners];
+    SkColor  fColors[SkPatchUtils::kNumCorners];
+    int32_t  fLodX;
+    int32_t  fLodY;
+    uint32_t fFlags;
+};
+
+struct PatchCacheRec : public SkResourceCache::Rec {
+    PatchCacheRec(const PatchKey& key, const SkPatchCache::Mesh* mesh)
+        : fKey(key)
+        , fMesh(SkRef(mesh))
+    {}
+
+    PatchKey                               fKey;
+    SkAutoTUnref<const SkPatchCache::Mesh> fMesh;
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "patch"; }
+    size_t bytesUsed() const override {
+        const SkPatchUtils::VertexData& data = fMesh->data();
+        size_t bytesPerVertex = sizeof(SkPoint);
+        if (data.fTexCoords) {
+            bytesPerVertex += sizeof(SkPoint);
+        }
+        if (data.fColors) {
+            bytesPerVertex += sizeof(uint32_t);
+        }
+        return sizeof(*this) + sizeof(SkPatchCache::Mesh) +
+               data.fVertexCount * bytesPerVertex + data.fIndexCount * sizeof(uint16_t);
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextMesh) {
+        const PatchCacheRec& rec = static_cast<const PatchCacheRec&>(baseRec);
+        const SkPatchCache::Mesh** result = (const SkPatchCache::Mesh**)contextMesh;
+
+        *result = SkRef(rec.fMesh.get());
+        return true;
+    }
+};
+} // namespace
+
+bool SkPatchCache::IsEnabled() {
+    return gPatchCacheEnabled;
+}
+
+bool SkPatchCache::SetEnabled(bool enabled) {
+    bool prev = gPatchCacheEnabled;
+    gPatchCacheEnabled = enabled;
+    return prev;
+}
+
+const SkPatchCache::Mesh* SkPatchCache::Find(const SkPoint cubics[12], const SkColor colors[4],
+                                             const SkPoint texCoords[4], int lodX, int lodY,
+                                             SkResourceCache* localCache) {
+    PatchKey key(cubics, colors, texCoords, lodX, lodY);
+    const Mesh* mesh = NULL;
+    if (!CHECK_LOCAL(localCache, find, Find, key, PatchCacheRec::Visitor, &mesh)) {
+        sk_atomic_inc(&gPatchCacheMisses);
+        return NULL;
+    }
+    sk_atomic_inc(&gPatchCacheHits);
+    return mesh;
+}
+
+void SkPatchCache::Add(const SkPoint cubics[12], const SkColor colors[4],
+                       const SkPoint texCoords[4], int lodX, int lodY, const Mesh* mesh,
+                       SkResourceCache* localCache) {
+    PatchKey key(cubics, colors, texCoords, lodX, lodY);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(PatchCacheRec, (key, mesh)));
+}
+
+const SkPatchCache::Mesh* SkPatchCache::Create(const SkPoint cubics[12], const SkColor colors[4],
+                                               const SkPoint texCoords[4], int lodX, int lodY) {
+    SkAutoTUnref<Mesh> mesh(SkNEW(Mesh));
+    if (!SkPatchUtils::getVertexData(&mesh->fData, cubics, colors, texCoords, lodX, lodY)) {
+        return NULL;
+    }
+    return mesh.detach();
+}
+
+const SkPatchCache::Mesh* SkPatchCache::FindOrCreate(const SkPoint cubics[12],
+                                                     const SkColor colors[4],
+                                                     const SkPoint texCoords[4],
+                                                     int lodX, int lodY) {
+    const Mesh* mesh = Find(cubics, colors, texCoords, lodX, lodY);
+    if (NULL == mesh) {
+        mesh = Create(cubics, colors, texCoords, lodX, lodY);
+        if (mesh) {
+            Add(cubics, colors, texCoords, lodX, lodY, mesh);
+        }
+    }
+    return mesh;
+}
+
+void SkPatchCache::GetStats(Stats* stats) {
+    stats->fHits = sk_atomic_load(&gPatchCacheHits);
+    stats->fMisses = sk_atomic_load(&gPatchCacheMisses);
+}
+
+void SkPatchCache::ResetStats() {
+    sk_atomic_store(&gPatchCacheHits, 0);
+    sk_atomic_store(&gPatchCacheMisses, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkGraphics::GetPatchCacheEnabled() {
+    return SkPatchCache::IsEnabled();
+}
+
+bool SkGraphics::SetPatchCacheEnabled(bool enabled) {
+    return SkPatchCache::SetEnabled(enabled);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPatchCache_DEFINED
+#define SkPatchCache_DEFINED
+
+#include "SkPatchUtils.h"
+#include "SkRefCnt.h"
+#include "SkResourceCache.h"
+
+/**
+ *  Remembers the tessellation of Coons patches, keyed by the patch's control points, corner
+ *  colors, texture coordinates and level of detail. Entries live in the SkResourceCache, so they
+ *  share its budget and are purged with it.
+ *
+ *  The global cache is consulted by SkBaseDevice::drawPatch() only while enabled (it is off by
+ *  default, see SkGraphics::SetPatchCacheEnabled()).
+ */
+class SkPatchCache {
+public:
+    static bool IsEnabled();
+    static bool SetEnabled(bool enabled);   // returns the previous setting
+
+    /**
+     *  A patch's vertex data, shared by the cache and whoever is drawing it.
+     */
+    class Mesh : public SkRefCnt {
+    public:
+        const SkPatchUtils::VertexData& data() const { return fData; }
+
+    private:
+        Mesh() {}
+
+        SkPatchUtils::VertexData fData;
+
+        friend class SkPatchCache;
+        typedef SkRefCnt INHERITED;
+    };
+
+    /**
+     *  If the patch is cached at this level of detail, return its mesh, which the caller must
+     *  unref. Otherwise return NULL. colors and texCoords may be NULL, as for drawPatch().
+     */
+    static const Mesh* Find(const SkPoint cubics[12], const SkColor colors[4],
+                            const SkPoint texCoords[4], int lodX, int lodY,
+                            SkResourceCache* localCache = NULL);
+
+    /**
+     *  Add the mesh of the patch at this level of detail to the cache.
+     */
+    static void Add(const SkPoint cubics[12], const SkColor colors[4],
+                    const SkPoint texCoords[4], int lodX, int lodY, const Mesh* mesh,
+                    SkResourceCache* localCache = NULL);
+
+    /**
+     *  Tessellate the patch with SkPatchUtils::getVertexData(), returning a mesh the caller must
+     *  unref, or NULL if that fails.
+     */
+    static const Mesh* Create(const SkPoint cubics[12], const SkColor colors[4],
+                              const SkPoint texCoords[4], int lodX, int lodY);
+
+    /**
+     *  Find() in the global cache, or Create() and Add() on a miss.
+     */
+    static const Mesh* FindOrCreate(const SkPoint cubics[12], const SkColor colors[4],
+                                    const SkPoint texCoords[4], int lodX, int lodY);
+
+    struct Stats {
+        int32_t fHits;
+        int32_t fMisses;
+    };
+
+    /** Find() hits and misses, counted across all caches since the last ResetStats(). */
+    static void GetStats(Stats*);
+    static void ResetStats();
+};
+
+#endif
@@ -438,7 +438,6 @@ uint32_t SkPathRef::genID() const {
 
 #ifdef SK_DEBUG
 void SkPathRef::validate() const {
-    this->INHERITED::validate();
     SkASSERT(static_cast<ptrdiff_t>(fFreeSpace) >= 0);
     SkASSERT(reinterpret_cast<intptr_t>(fVerbs) - reinterpret_cast<intptr_t>(fPoints) >= 0);
     SkASSERT((NULL == fPoints) == (NULL == fVerbs));
@@ -12,18 +12,22 @@
 #include "SkPictureRecord.h"
 #include "SkPictureRecorder.h"
 
+#include "SkBBHFactory.h"
 #include "SkBitmapDevice.h"
 #include "SkCanvas.h"
 #include "SkChunkAlloc.h"
+#include "SkImage_Base.h"
 #include "SkMessageBus.h"
 #include "SkPaintPriv.h"
 #include "SkPathEffect.h"
 #include "SkPicture.h"
+#include "SkPixelRef.h"
 #include "SkRegion.h"
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkTDArray.h"
 #include "SkTLogic.h"
+#include "SkTaskGroup.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
 
@@ -169,27 +173,34 @@ struct SkPicture::PathCounter {
     }
 
     void operator()(const SkRecords::DrawPoints& op) {
-        this->checkPaint(&op.paint);
-        const SkPathEffect* effect = op.paint.getPathEffect();
+        this->checkPaint(op.paint.get());
+        const SkPathEffect* effect = op.paint->getPathEffect();
         if (effect) {
             SkPathEffect::DashInfo info;
             SkPathEffect::DashType dashType = effect->asADash(&info);
-            if (2 == op.count && SkPaint::kRound_Cap != op.paint.getStrokeCap() &&
+            if (2 == op.count && SkPaint::kRound_Cap != op.paint->getStrokeCap() &&
                 SkPathEffect::kDash_DashType == dashType && 2 == info.fCount) {
                 numFastPathDashEffects++;
             }
         }
     }
 
+    // Merged DrawRects still draw each rect with the paint, so count them all.
+    void operator()(const SkRecords::DrawRects& op) {
+        for (int i = 0; i < op.count; i++) {
+            this->checkPaint(op.paint.get());
+        }
+    }
+
     void operator()(const SkRecords::DrawPath& op) {
-        this->checkPaint(&op.paint);
-        if (op.paint.isAntiAlias() && !op.path.isConvex()) {
+        this->checkPaint(op.paint.get());
+        if (op.paint->isAntiAlias() && !op.path.isConvex()) {
             numAAConcavePaths++;
 
-            SkPaint::Style paintStyle = op.paint.getStyle();
+            SkPaint::Style paintStyle = op.paint->getStyle();
             const SkRect& pathBounds = op.path.getBounds();
             if (SkPaint::kStroke_Style == paintStyle &&
-                0 == op.paint.getStrokeWidth()) {
+                0 == op.paint->getStrokeWidth()) {
                 numAAHairlineConcavePaths++;
             } else if (SkPaint::kFill_Style == paintStyle && pathBounds.width() < 64.f &&
                        pathBounds.height() < 64.f && !op.path.isVolatile()) {
@@ -308,8 +319,214 @@ void SkPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
     (void)canvas->getClipBounds(&clipBounds);
     const bool useBBH = !clipBounds.contains(this->cullRect());
 
+    // SkPictureRecorder may have noted which ops later opaque ops hide.
+    const SkRecordOcclusion* occlusion = static_cast<const SkRecordOcclusion*>(
+            this->EXPERIMENTAL_getAccelData(SkRecordOcclusion::ComputeKey()));
+
     SkRecordDraw(*fRecord, canvas, this->drawablePicts(), NULL, this->drawableCount(),
-                 useBBH ? fBBH.get() : NULL, callback);
+                 useBBH ? fBBH.get() : NULL, callback, occlusion);
+}
+
+namespace {
+
+// One horizontal slice of the destination, with its own canvas wrapping those rows of pixels.
+struct PlaybackBand {
+    const SkPicture*       fPicture;
+    SkAutoTDelete<SkCanvas> fCanvas;
+
+    static void Draw(PlaybackBand* band) {
+        // Goes through playback() so the BBH is only consulted when the band doesn't cover
+        // the whole picture.
+        band->fPicture->playback(band->fCanvas.get());
+    }
+};
+
+}  // namespace
+
+// Bands shorter than this aren't worth the per-band BBH query and canvas setup.
+static const int kMinPlaybackBandHeight = 64;
+static const int kMaxDefaultPlaybackBands = 16;
+
+void SkPicture::playbackParallel(SkCanvas* canvas, SkTaskGroup* taskGroup, int bandCount) const {
+    SkASSERT(canvas);
+
+    SkImageInfo info;
+    size_t rowBytes;
+    SkIPoint origin;
+    void* pixels = canvas->accessTopLayerPixels(&info, &rowBytes, &origin);
+
+    SkIRect devClip;
+    if (!pixels || !canvas->isClipRect() || canvas->getDrawFilter()) {
+        // Non-raster devices, complex clips and draw filters can't be split into bands.
+        this->playback(canvas);
+        return;
+    }
+    if (!canvas->getClipDeviceBounds(&devClip)) {
+        return;  // Nothing to draw.
+    }
+
+    // Work in the top layer's pixel space from here on.
+    devClip.offset(-origin.fX, -origin.fY);
+    if (!devClip.intersect(SkIRect::MakeWH(info.width(), info.height()))) {
+        return;
+    }
+
+    if (bandCount <= 0) {
+        bandCount = SkTMin(kMaxDefaultPlaybackBands,
+                           devClip.height() / kMinPlaybackBandHeight);
+    }
+    bandCount = SkTMin(bandCount, devClip.height());
+    if (bandCount <= 1) {
+        this->playback(canvas);
+        return;
+    }
+
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    const size_t bpp = info.bytesPerPixel();
+
+    SkAutoTArray<PlaybackBand> bands(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        const int top    = devClip.fTop + devClip.height() *  i      / bandCount;
+        const int bottom = devClip.fTop + devClip.height() * (i + 1) / bandCount;
+
+        // Each band canvas covers only the clipped columns of its rows.
+        SkBitmap bm;
+        bm.installPixels(info.makeWH(devClip.width(), bottom - top),
+                         (char*)pixels + top * rowBytes + devClip.fLeft * bpp, rowBytes);
+
+        SkCanvas* bandCanvas = SkNEW_ARGS(SkCanvas, (bm, canvas->fProps));
+        SkMatrix bandMatrix;
+        bandMatrix.setTranslate(SkIntToScalar(-origin.fX - devClip.fLeft),
+                                SkIntToScalar(-origin.fY - top));
+        bandMatrix.preConcat(ctm);
+        bandCanvas->setMatrix(bandMatrix);
+
+        bands[i].fPicture = this;
+        bands[i].fCanvas.reset(bandCanvas);
+    }
+
+    if (taskGroup) {
+        taskGroup->batch(PlaybackBand::Draw, bands.get(), bandCount);
+        taskGroup->wait();
+    } else {
+        SkTaskGroup tg;
+        tg.batch(PlaybackBand::Draw, bands.get(), bandCount);
+        tg.wait();
+    }
+}
+
+/** SkRecords visitor collecting the lazily generated pixel refs of the bitmaps and images
+    drawn by the visited ops, directly or through their paint's shader, each one once.
+ */
+struct SkPicture::LazyPixelRefFinder {
+    // These create HasMember_bitmap, HasMember_image and HasMember_paint.
+    SK_CREATE_MEMBER_DETECTOR(bitmap);
+    SK_CREATE_MEMBER_DETECTOR(image);
+    SK_CREATE_MEMBER_DETECTOR(paint);
+
+    LazyPixelRefFinder(SkPicture const* const drawablePicts[], int drawableCount,
+                       SkTDArray<SkPixelRef*>* pixelRefs)
+        : fDrawablePicts(drawablePicts), fDrawableCount(drawableCount), fPixelRefs(pixelRefs) {}
+
+    // Nested pictures are gathered whole: the BBH only knows about this picture's ops.
+    void operator()(const SkRecords::DrawPicture& op) {
+        op.picture->gatherLazyPixelRefs(NULL, fPixelRefs);
+    }
+    void operator()(const SkRecords::DrawDrawable& op) {
+        if (op.index < fDrawableCount) {
+            fDrawablePicts[op.index]->gatherLazyPixelRefs(NULL, fPixelRefs);
+        }
+    }
+
+    template <typename T>
+    void operator()(const T& op) {
+        this->checkBitmap(op);
+        this->checkImage(op);
+        this->checkPaint(op);
+    }
+
+    template <typename T>
+    SK_WHEN(HasMember_bitmap<T>, void) checkBitmap(const T& op) {
+        this->add(op.bitmap.shallowCopy());
+    }
+    template <typename T>
+    SK_WHEN(!HasMember_bitmap<T>, void) checkBitmap(const T&) {}
+
+    template <typename T>
+    SK_WHEN(HasMember_image<T>, void) checkImage(const T& op) {
+        // Reading back a texture would defeat the purpose, everything else is a cheap copy.
+        SkBitmap bitmap;
+        if (!op.image->getTexture() && as_IB(op.image)->getROPixels(&bitmap)) {
+            this->add(bitmap);
+        }
+    }
+    template <typename T>
+    SK_WHEN(!HasMember_image<T>, void) checkImage(const T&) {}
+
+    template <typename T>
+    SK_WHEN(HasMember_paint<T>, void) checkPaint(const T& op) {
+        const SkPaint* paint = AsPtr(op.paint);
+        const SkShader* shader = paint ? paint->getShader() : NULL;
+        SkBitmap bitmap;
+        if (shader && shader->asABitmap(&bitmap, NULL, NULL) == SkShader::kDefault_BitmapType) {
+            this->add(bitmap);
+        }
+    }
+    template <typename T>
+    SK_WHEN(!HasMember_paint<T>, void) checkPaint(const T&) {}
+
+    void add(const SkBitmap& bitmap) {
+        SkPixelRef* pixelRef = bitmap.pixelRef();
+        if (pixelRef && pixelRef->isLazyGenerated() && fPixelRefs->find(pixelRef) < 0) {
+            *fPixelRefs->append() = pixelRef;
+        }
+    }
+
+    SkPicture const* const* fDrawablePicts;
+    const int               fDrawableCount;
+    SkTDArray<SkPixelRef*>* fPixelRefs;
+};
+
+namespace {
+
+// Locking a lazily generated pixel ref generates its pixels, and they stay cached after the
+// matching unlock.
+static void decode_pixel_ref(SkPixelRef** pixelRef) {
+    (*pixelRef)->lockPixels();
+    (*pixelRef)->unlockPixels();
+}
+
+}  // namespace
+
+void SkPicture::gatherLazyPixelRefs(const SkRect* area, SkTDArray<SkPixelRef*>* pixelRefs) const {
+    LazyPixelRefFinder finder(this->drawablePicts(), this->drawableCount(), pixelRefs);
+    if (area && fBBH.get() && !area->contains(this->cullRect())) {
+        SkTDArray<unsigned> ops;
+        fBBH->search(*area, &ops);
+        for (int i = 0; i < ops.count(); i++) {
+            fRecord->visit<void>(ops[i], finder);
+        }
+    } else {
+        for (unsigned i = 0; i < fRecord->count(); i++) {
+            fRecord->visit<void>(i, finder);
+        }
+    }
+}
+
+int SkPicture::preDecodeBitmaps(const SkRect* area, SkTaskGroup* taskGroup) const {
+    SkTDArray<SkPixelRef*> pixelRefs;
+    this->gatherLazyPixelRefs(area, &pixelRefs);
+
+    // The picture holds a ref on every one of them, so they outlive the decodes.
+    if (taskGroup) {
+        taskGroup->batch(decode_pixel_ref, pixelRefs.begin(), pixelRefs.count());
+        taskGroup->wait();
+    } else {
+        SkTaskGroup tg;
+        tg.batch(decode_pixel_ref, pixelRefs.begin(), pixelRefs.count());
+        tg.wait();
+    }
+    return pixelRefs.count();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -402,6 +619,9 @@ SkPicture* SkPicture::CreateFromStream(SkStream* stream, InstallPixelRefProc pro
     if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
         return NULL;
     }
+    if (info.fVersion >= SkReadBuffer::kAlignedStream_Version && stream->skip(3) != 3) {
+        return NULL;
+    }
     SkAutoTDelete<SkPictureData> data(SkPictureData::CreateFromStream(stream, info, proc));
     return Forwardport(info, data);
 }
@@ -443,18 +663,110 @@ SkPictureData* SkPicture::Backport(const SkRecord& src, const SkPictInfo& info,
     return SkNEW_ARGS(SkPictureData, (rec, info, false/*deep copy ops?*/));
 }
 
+namespace {
+
+// Measures how a command changes the comment group nesting depth.
+struct CommentGroupDelta {
+    int operator()(const SkRecords::BeginCommentGroup&) { return +1; }
+    int operator()(const SkRecords::EndCommentGroup&)   { return -1; }
+    template <typename T>
+    int operator()(const T&) { return 0; }
+};
+
+// Matches a BeginCommentGroup with the given description.
+struct IsNamedCommentGroup {
+    const char* fName;
+
+    bool operator()(const SkRecords::BeginCommentGroup& op) {
+        return 0 == strcmp(op.description, fName);
+    }
+    template <typename T>
+    bool operator()(const T&) { return false; }
+};
+
+// Finds the first comment group named name, and its matching EndCommentGroup.
+bool find_comment_group(const SkRecord& record, const char name[],
+                        unsigned* begin, unsigned* end) {
+    IsNamedCommentGroup named = { name };
+    for (unsigned i = 0; i < record.count(); i++) {
+        if (!record.visit<bool>(i, named)) {
+            continue;
+        }
+        CommentGroupDelta delta;
+        int depth = 0;
+        for (unsigned j = i; j < record.count(); j++) {
+            depth += record.visit<int>(j, delta);
+            if (0 == depth) {
+                *begin = i;
+                *end = j;
+                return true;
+            }
+        }
+        return false;  // The group never ended.
+    }
+    return false;
+}
+
+}  // namespace
+
+SkPicture* SkPicture::newWithCommentGroupReplaced(const char group[],
+                                                  const SkPicture* replacement,
+                                                  SkBBHFactory* factory) const {
+    SkASSERT(group && replacement);
+    unsigned begin, end;
+    // Shared DrawDrawables would index into our drawable list, so we don't try to carry it over.
+    if (this->drawableCount() > 0 || !find_comment_group(*fRecord, group, &begin, &end)) {
+        return NULL;
+    }
+
+    // Keep everything up to and including the BeginCommentGroup, draw the replacement in place
+    // of the group's contents, and keep the EndCommentGroup and everything after it.
+    // Drawing it as a nested picture keeps its SetMatrix commands relative to the group's matrix.
+    SkAutoTUnref<SkRecord> record(SkNEW(SkRecord));
+    for (unsigned i = 0; i <= begin; i++) {
+        record->appendShared(*fRecord, i);
+    }
+    SkNEW_PLACEMENT_ARGS(record->append<SkRecords::DrawPicture>(), SkRecords::DrawPicture,
+                         ((SkPaint*)NULL, replacement, SkMatrix::I()));
+    for (unsigned i = end; i < fRecord->count(); i++) {
+        record->appendShared(*fRecord, i);
+    }
+
+    // Our BBHs are bulk loaded, so there's no updating just the entries that changed.  Filling
+    // bounds only visits the commands, though, which is cheap next to recording them.
+    SkAutoTUnref<SkBBoxHierarchy> bbh(factory ? (*factory)(fCullRect) : NULL);
+    if (bbh.get()) {
+        SkRecordFillBounds(fCullRect, *record, bbh.get());
+    }
+    return SkNEW_ARGS(SkPicture, (fCullRect, record.get(), NULL, bbh.get()));
+}
+
 void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer) const {
+    this->serialize(stream, pixelSerializer, false, 0);
+}
+
+void SkPicture::serializeCompact(SkWStream* stream, SkScalar pathPrecision,
+                                 SkPixelSerializer* pixelSerializer) const {
+    this->serialize(stream, pixelSerializer, true, pathPrecision);
+}
+
+void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer,
+                          bool compact, SkScalar pathPrecision) const {
     SkPictInfo info;
     this->createHeader(&info);
     SkAutoTDelete<SkPictureData> data(Backport(*fRecord, info, this->drawablePicts(),
                                                this->drawableCount()));
 
+    // The bool is padded out so that everything after it stays 4-byte aligned.
+    static const uint8_t kPad[3] = { 0, 0, 0 };
     stream->write(&info, sizeof(info));
     if (data) {
         stream->writeBool(true);
-        data->serialize(stream, pixelSerializer);
+        stream->write(kPad, sizeof(kPad));
+        data->serialize(stream, pixelSerializer, compact, pathPrecision);
     } else {
         stream->writeBool(false);
+        stream->write(kPad, sizeof(kPad));
     }
 }
 
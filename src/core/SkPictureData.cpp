@@ -9,6 +9,7 @@
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
 #include "SkTextBlob.h"
+#include "SkTHash.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
 
@@ -139,6 +140,277 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Pads a chunk of size bytes out to a multiple of 4, so the next chunk starts aligned.
+static void write_padding(SkWStream* stream, size_t size) {
+    static const uint8_t kPad[3] = { 0, 0, 0 };
+    stream->write(kPad, SkAlign4(size) - size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// The compact sections use LEB128 varints: 7 bits a byte, low bits first.
+
+static void write_varint(SkWStream* stream, uint32_t value) {
+    while (value >= 0x80) {
+        stream->write8(0x80 | (value & 0x7F));
+        value >>= 7;
+    }
+    stream->write8(value);
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+namespace {
+
+// Reads what write_varint() wrote, failing (rather than reading past the end) on bad data.
+class VarintReader {
+public:
+    VarintReader(const void* data, size_t size)
+        : fCurr((const uint8_t*)data), fStop(fCurr + size), fValid(true) {}
+
+    bool eof() const { return fCurr == fStop; }
+    bool isValid() const { return fValid; }
+
+    uint32_t readVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35 && fCurr < fStop; shift += 7) {
+            const uint8_t byte = *fCurr++;
+            value |= (uint32_t)(byte & 0x7F) << shift;
+            if (0 == (byte & 0x80)) {
+                return value;
+            }
+        }
+        fValid = false;
+        return 0;
+    }
+
+    const void* skip(size_t size) {
+        if (size > (size_t)(fStop - fCurr)) {
+            fValid = false;
+            return NULL;
+        }
+        const void* data = fCurr;
+        fCurr += size;
+        return data;
+    }
+
+    bool read(void* dst, size_t size) {
+        const void* src = this->skip(size);
+        if (src) {
+            memcpy(dst, src, size);
+        }
+        return src != NULL;
+    }
+
+private:
+    const uint8_t* fCurr;
+    const uint8_t* fStop;
+    bool fValid;
+};
+
+}  // namespace
+
+// Each op is written as varint(op), varint(data words << 1 | extended size), then its data.
+// Ops point at each other by offset, so they must expand back to exactly the same bytes.
+// Returns false if the ops don't parse, in which case the caller writes them as they are.
+static bool compact_ops(const SkData* opData, SkWStream* stream) {
+    const uint8_t* ops = opData->bytes();
+    const size_t total = opData->size();
+    size_t offset = 0;
+    while (offset < total) {
+        uint32_t header[2];
+        if (total - offset < sizeof(uint32_t)) {
+            return false;
+        }
+        memcpy(&header[0], ops + offset, sizeof(uint32_t));
+        const uint32_t op = header[0] >> 24;
+        uint32_t size = header[0] & MASK_24;
+        size_t headerSize = sizeof(uint32_t);
+        if (MASK_24 == size) {
+            if (total - offset < sizeof(header)) {
+                return false;
+            }
+            memcpy(&header[1], ops + offset + sizeof(uint32_t), sizeof(uint32_t));
+            size = header[1];
+            headerSize = sizeof(header);
+        }
+        if (size < headerSize || size > total - offset || !SkIsAlign4(size)) {
+            return false;
+        }
+        write_varint(stream, op);
+        const uint32_t words = SkToU32(size - headerSize) >> 2;
+        write_varint(stream, (words << 1) | (headerSize > sizeof(uint32_t)));
+        stream->write(ops + offset + headerSize, size - headerSize);
+        offset += size;
+    }
+    return true;
+}
+
+static SkData* expand_ops(const void* compact, size_t size) {
+    VarintReader reader(compact, size);
+    SkDynamicMemoryWStream ops;
+    while (!reader.eof()) {
+        const uint32_t op = reader.readVarint();
+        const uint32_t words = reader.readVarint();
+        if (!reader.isValid() || op > 0xFF || (words >> 1) >= (1u << 28)) {
+            return NULL;
+        }
+        const size_t dataSize = (size_t)(words >> 1) * sizeof(uint32_t);
+        const void* data = reader.skip(dataSize);
+        if (NULL == data) {
+            return NULL;
+        }
+        if (words & 1) {
+            ops.write32(PACK_8_24(op, MASK_24));
+            ops.write32(SkToU32(dataSize + 2 * sizeof(uint32_t)));
+        } else {
+            const size_t opSize = dataSize + sizeof(uint32_t);
+            if (opSize >= MASK_24) {
+                return NULL;
+            }
+            ops.write32(PACK_8_24(op, SkToU32(opSize)));
+        }
+        ops.write(data, dataSize);
+    }
+    return ops.copyToData();
+}
+
+// Compact paths store their points in one of these ways.
+enum PathPoints {
+    kRaw_PathPoints,        // Floats, as they are.
+    kGrid_PathPoints,       // Exact multiples of 1/kPathGrid: delta-encoded, zigzagged varints.
+    kPrecision_PathPoints,  // Rounded to multiples of the section's precision, as for kGrid.
+};
+static const SkScalar kPathGrid = 64;
+
+// Keeps the deltas between quantized coordinates inside an int32_t.
+static const SkScalar kMaxQuantized = (SkScalar)(1 << 29);
+
+static bool quantize_points(const SkPoint* pts, int count, SkScalar scale, bool exact,
+                            SkTDArray<int32_t>* quantized) {
+    quantized->setCount(2 * count);
+    for (int i = 0; i < 2 * count; ++i) {
+        const SkScalar value = (&pts[0].fX)[i] * scale;
+        if (!(SkScalarAbs(value) < kMaxQuantized)) {  // Also rejects NaN.
+            return false;
+        }
+        const int32_t q = exact ? (int32_t)value : SkScalarRoundToInt(value);
+        if (exact && (SkScalar)q != value) {
+            return false;
+        }
+        (*quantized)[i] = q;
+    }
+    return true;
+}
+
+static void write_compact_path(SkWStream* stream, const SkPath& path, SkScalar precision) {
+    const int pointCount = path.countPoints();
+    SkAutoSTArray<32, SkPoint> pts(pointCount);
+    path.getPoints(pts.get(), pointCount);
+
+    SkTDArray<int32_t> quantized;
+    PathPoints mode = kRaw_PathPoints;
+    if (quantize_points(pts.get(), pointCount, kPathGrid, true, &quantized)) {
+        mode = kGrid_PathPoints;
+    } else if (precision > 0 &&
+               quantize_points(pts.get(), pointCount, SkScalarInvert(precision), false,
+                               &quantized)) {
+        mode = kPrecision_PathPoints;
+    }
+    // Rounding can change a path's convexity, so that is only kept when the points are.
+    const SkPath::Convexity convexity = kPrecision_PathPoints == mode
+                                      ? SkPath::kUnknown_Convexity
+                                      : path.getConvexityOrUnknown();
+    write_varint(stream, path.getFillType() | (convexity << 2) | (mode << 4));
+
+    SkTDArray<uint8_t> verbs;
+    SkTDArray<SkScalar> weights;
+    SkPath::RawIter iter(path);
+    SkPoint unused[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(unused)) != SkPath::kDone_Verb) {
+        *verbs.append() = verb;
+        if (SkPath::kConic_Verb == verb) {
+            *weights.append() = iter.conicWeight();
+        }
+    }
+    write_varint(stream, verbs.count());
+    stream->write(verbs.begin(), verbs.count());
+    write_varint(stream, pointCount);
+    if (kRaw_PathPoints == mode) {
+        stream->write(pts.get(), pointCount * sizeof(SkPoint));
+    } else {
+        int32_t prev[2] = { 0, 0 };
+        for (int i = 0; i < quantized.count(); ++i) {
+            write_varint(stream, zigzag(quantized[i] - prev[i & 1]));
+            prev[i & 1] = quantized[i];
+        }
+    }
+    stream->write(weights.begin(), weights.count() * sizeof(SkScalar));
+}
+
+static bool read_compact_path(VarintReader* reader, SkScalar precision, SkPath* path) {
+    const uint32_t bits = reader->readVarint();
+    const PathPoints mode = (PathPoints)(bits >> 4);
+    const SkPath::Convexity convexity = (SkPath::Convexity)((bits >> 2) & 3);
+    if (mode > kPrecision_PathPoints || convexity > SkPath::kConcave_Convexity) {
+        return false;
+    }
+
+    const size_t verbCount = reader->readVarint();
+    const uint8_t* verbs = (const uint8_t*)reader->skip(verbCount);
+    const size_t pointCount = reader->readVarint();
+    if (!reader->isValid() || pointCount > verbCount * 3) {
+        return false;
+    }
+    SkAutoSTArray<32, SkPoint> pts(SkToInt(pointCount));
+    if (kRaw_PathPoints == mode) {
+        if (!reader->read(pts.get(), pointCount * sizeof(SkPoint))) {
+            return false;
+        }
+    } else {
+        const SkScalar scale = kGrid_PathPoints == mode ? SkScalarInvert(kPathGrid) : precision;
+        int32_t prev[2] = { 0, 0 };
+        for (size_t i = 0; i < 2 * pointCount; ++i) {
+            prev[i & 1] += unzigzag(reader->readVarint());
+            (&pts[0].fX)[i] = prev[i & 1] * scale;
+        }
+    }
+
+    path->reset();
+    path->setFillType((SkPath::FillType)(bits & 3));
+    const SkPoint* p = pts.get();
+    const SkPoint* stop = p + pointCount;
+    for (size_t i = 0; i < verbCount; ++i) {
+        static const int kPointsForVerb[] = { 1, 1, 2, 2, 3, 0 };  // move ... close
+        if (verbs[i] >= SK_ARRAY_COUNT(kPointsForVerb) || stop - p < kPointsForVerb[verbs[i]]) {
+            return false;
+        }
+        switch (verbs[i]) {
+            case SkPath::kMove_Verb:  path->moveTo(p[0]); break;
+            case SkPath::kLine_Verb:  path->lineTo(p[0]); break;
+            case SkPath::kQuad_Verb:  path->quadTo(p[0], p[1]); break;
+            case SkPath::kConic_Verb: {
+                SkScalar weight;
+                if (!reader->read(&weight, sizeof(weight))) {
+                    return false;
+                }
+                path->conicTo(p[0], p[1], weight);
+            } break;
+            case SkPath::kCubic_Verb: path->cubicTo(p[0], p[1], p[2]); break;
+            case SkPath::kClose_Verb: path->close(); break;
+        }
+        p += kPointsForVerb[verbs[i]];
+    }
+    path->setConvexity(convexity);
+    return reader->isValid() && p == stop;
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -165,6 +437,7 @@ void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     }
 
     SkASSERT(size == (stream->bytesWritten() - start));
+    write_padding(stream, size);
 }
 
 void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
@@ -176,17 +449,37 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     SkTypeface** array = (SkTypeface**)storage.get();
     rec.copyToArray((SkRefCnt**)array);
 
+    // Typefaces don't know their serialized size up front, so write them aside first.
+    SkDynamicMemoryWStream typefaces;
     for (int i = 0; i < count; i++) {
 #ifdef SK_PICTURE_FORCE_FONT_EMBEDDING
-        array[i]->serializeForcingEmbedding(stream);
+        array[i]->serializeForcingEmbedding(&typefaces);
 #else
         // TODO: if (embedFonts) { array[i]->serializeForcingEmbedding(stream) } else
-        array[i]->serialize(stream);
+        array[i]->serialize(&typefaces);
 #endif
     }
+
+    const size_t size = typefaces.bytesWritten();
+    stream->write32(SkToU32(size));
+    typefaces.writeToStream(stream);
+    write_padding(stream, size);
+}
+
+static void read_typefaces(SkStream* stream, SkTypefacePlayback* playback) {
+    for (int i = 0; i < playback->count(); i++) {
+        SkAutoTUnref<SkTypeface> tf(SkTypeface::Deserialize(stream));
+        if (!tf.get()) {    // failed to deserialize
+            // fTFPlayback asserts it never has a null, so we plop in
+            // the default here.
+            tf.reset(SkTypeface::RefDefault());
+        }
+        playback->set(i, tf);
+    }
 }
 
-void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
+void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool compact,
+                                    SkScalar pathPrecision) const {
     int i, n;
 
     if ((n = fBitmaps.count()) > 0) {
@@ -196,14 +489,45 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
         }
     }
 
-    if ((n = fPaints.count()) > 0) {
+    if ((n = fPaints.count()) > 0 && compact) {
+        // Recording keeps a copy of the paint for each draw, so many are the same.  Write each
+        // distinct paint once, then which of those each of ours is.
+        SkTHashMap<uint32_t, int> hashToUnique;
+        SkTDArray<int> uniques;
+        SkDynamicMemoryWStream indices;
+        for (i = 0; i < n; i++) {
+            const uint32_t hash = fPaints[i].getHash();
+            const int* unique = hashToUnique.find(hash);
+            if (NULL == unique || !(fPaints[uniques[*unique]] == fPaints[i])) {
+                unique = hashToUnique.set(hash, uniques.count());
+                *uniques.append() = i;
+            }
+            write_varint(&indices, *unique);
+        }
+        write_tag_size(buffer, SK_PICT_COMPACT_PAINT_BUFFER_TAG, n);
+        buffer.writeInt(uniques.count());
+        for (i = 0; i < uniques.count(); i++) {
+            buffer.writePaint(fPaints[uniques[i]]);
+        }
+        SkAutoDataUnref data(indices.copyToData());
+        buffer.writeByteArray(data->data(), data->size());
+    } else if (n > 0) {
         write_tag_size(buffer, SK_PICT_PAINT_BUFFER_TAG, n);
         for (i = 0; i < n; i++) {
             buffer.writePaint(fPaints[i]);
         }
     }
 
-    if ((n = fPaths.count()) > 0) {
+    if ((n = fPaths.count()) > 0 && compact) {
+        SkDynamicMemoryWStream paths;
+        for (i = 0; i < n; i++) {
+            write_compact_path(&paths, fPaths[i], pathPrecision);
+        }
+        write_tag_size(buffer, SK_PICT_COMPACT_PATH_BUFFER_TAG, n);
+        buffer.writeScalar(pathPrecision);
+        SkAutoDataUnref data(paths.copyToData());
+        buffer.writeByteArray(data->data(), data->size());
+    } else if (n > 0) {
         write_tag_size(buffer, SK_PICT_PATH_BUFFER_TAG, n);
         buffer.writeInt(n);
         for (int i = 0; i < n; i++) {
@@ -220,14 +544,28 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
 }
 
 void SkPictureData::serialize(SkWStream* stream,
-                              SkPixelSerializer* pixelSerializer) const {
-    write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
-    stream->write(fOpData->bytes(), fOpData->size());
+                              SkPixelSerializer* pixelSerializer,
+                              bool compact,
+                              SkScalar pathPrecision) const {
+    SkDynamicMemoryWStream compactOps;
+    if (compact && compact_ops(fOpData, &compactOps)) {
+        const size_t size = compactOps.bytesWritten();
+        write_tag_size(stream, SK_PICT_COMPACT_READER_TAG, size);
+        compactOps.writeToStream(stream);
+        write_padding(stream, size);
+    } else {
+        write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
+        stream->write(fOpData->bytes(), fOpData->size());
+    }
 
     if (fPictureCount > 0) {
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictureCount);
         for (int i = 0; i < fPictureCount; i++) {
-            fPictureRefs[i]->serialize(stream, pixelSerializer);
+            if (compact) {
+                fPictureRefs[i]->serializeCompact(stream, pathPrecision, pixelSerializer);
+            } else {
+                fPictureRefs[i]->serialize(stream, pixelSerializer);
+            }
         }
     }
 
@@ -242,7 +580,7 @@ void SkPictureData::serialize(SkWStream* stream,
         buffer.setFactoryRecorder(&factSet);
         buffer.setPixelSerializer(pixelSerializer);
 
-        this->flattenToBuffer(buffer);
+        this->flattenToBuffer(buffer, compact, pathPrecision);
 
         // We have to write these two sets into the stream *before* we write
         // the buffer, since parsing that buffer will require that we already
@@ -298,6 +636,23 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// If the stream's bytes are already in memory, e.g. a file mmap'd by SkStream::NewFromFile(),
+// returns the next size bytes in place and skips past them.  Returns NULL if they'd have to be
+// read (or aren't aligned for SkReader32), leaving the stream untouched.
+static const void* skip_in_memory(SkStream* stream, size_t size) {
+    const char* base = (const char*)stream->getMemoryBase();
+    if (NULL == base || !stream->hasPosition() || !stream->hasLength()) {
+        return NULL;
+    }
+    const size_t position = stream->getPosition();
+    if (position > stream->getLength() || size > stream->getLength() - position ||
+        !SkIsAlign4((intptr_t)(base + position))) {
+        return NULL;
+    }
+    SkAssertResult(stream->skip(size) == size);
+    return base + position;
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
@@ -316,13 +671,36 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromStream(stream, size);
+            if (const void* ops = skip_in_memory(stream, size)) {
+                // No need to copy: we're only kept around while CreateFromStream()'s caller
+                // replays us, and that finishes while the stream is still alive.
+                fOpData = SkData::NewWithoutCopy(ops, size);
+            } else {
+                fOpData = SkData::NewFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_COMPACT_READER_TAG: {
+            SkASSERT(NULL == fOpData);
+            SkAutoMalloc storage;
+            const void* bytes = skip_in_memory(stream, size);
+            if (NULL == bytes) {
+                bytes = storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+            }
+            fOpData = expand_ops(bytes, size);
+            const size_t padding = SkAlign4(size) - size;
+            if (!fOpData || stream->skip(padding) != padding) {
+                return false;
+            }
+        } break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
+            const size_t chunkSize = size;
             size = stream->readU32();
             fFactoryPlayback = SkNEW_ARGS(SkFactoryPlayback, (size));
             for (size_t i = 0; i < size; i++) {
@@ -334,19 +712,38 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                 }
                 fFactoryPlayback->base()[i] = SkFlattenable::NameToFactory(str.c_str());
             }
+            if (fInfo.fVersion >= SkReadBuffer::kAlignedStream_Version) {
+                const size_t padding = SkAlign4(chunkSize) - chunkSize;
+                if (stream->skip(padding) != padding) {
+                    return false;
+                }
+            }
         } break;
         case SK_PICT_TYPEFACE_TAG: {
             SkASSERT(!haveBuffer);
-            const int count = SkToInt(size);
-            fTFPlayback.setCount(count);
-            for (int i = 0; i < count; i++) {
-                SkAutoTUnref<SkTypeface> tf(SkTypeface::Deserialize(stream));
-                if (!tf.get()) {    // failed to deserialize
-                    // fTFPlayback asserts it never has a null, so we plop in
-                    // the default here.
-                    tf.reset(SkTypeface::RefDefault());
+            fTFPlayback.setCount(SkToInt(size));
+            if (fInfo.fVersion < SkReadBuffer::kAlignedStream_Version) {
+                read_typefaces(stream, &fTFPlayback);
+                break;
+            }
+
+            // Read the typefaces out of their own chunk, so we land on the next one no matter
+            // how much of it each typeface uses.
+            const size_t chunkSize = stream->readU32();
+            SkAutoMalloc storage;
+            const void* bytes = skip_in_memory(stream, chunkSize);
+            if (NULL == bytes) {
+                bytes = storage.reset(chunkSize);
+                if (stream->read(storage.get(), chunkSize) != chunkSize) {
+                    return false;
                 }
-                fTFPlayback.set(i, tf);
+            }
+            SkMemoryStream typefaces(bytes, chunkSize, false/*copyData*/);
+            read_typefaces(&typefaces, &fTFPlayback);
+
+            const size_t padding = SkAlign4(chunkSize) - chunkSize;
+            if (stream->skip(padding) != padding) {
+                return false;
             }
         } break;
         case SK_PICT_PICTURE_TAG: {
@@ -373,13 +770,18 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            // Everything read out of the buffer is copied, so it can be parsed in place.
+            SkAutoMalloc storage;
+            const void* bytes = skip_in_memory(stream, size);
+            if (NULL == bytes) {
+                bytes = storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
 
@@ -425,6 +827,39 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer,
                 buffer.readPaint(&fPaints[i]);
             }
         } break;
+        case SK_PICT_COMPACT_PAINT_BUFFER_TAG: {
+            const int count = SkToInt(size);
+            const int uniqueCount = buffer.readInt();
+            if (!buffer.validate(uniqueCount >= 0 && uniqueCount <= count)) {
+                return false;
+            }
+            SkTArray<SkPaint> uniques(uniqueCount);
+            for (int i = 0; i < uniqueCount; ++i) {
+                buffer.readPaint(&uniques.push_back());
+            }
+            SkAutoDataUnref indices(buffer.readByteArrayAsData());
+            VarintReader reader(indices->data(), indices->size());
+            fPaints.reset(count);
+            for (int i = 0; i < count; ++i) {
+                const uint32_t index = reader.readVarint();
+                if (!buffer.validate(reader.isValid() && index < (uint32_t)uniqueCount)) {
+                    return false;
+                }
+                fPaints[i] = uniques[index];
+            }
+        } break;
+        case SK_PICT_COMPACT_PATH_BUFFER_TAG: {
+            const int count = SkToInt(size);
+            const SkScalar precision = buffer.readScalar();
+            SkAutoDataUnref paths(buffer.readByteArrayAsData());
+            VarintReader reader(paths->data(), paths->size());
+            fPaths.reset(count);
+            for (int i = 0; i < count; ++i) {
+                if (!buffer.validate(read_compact_path(&reader, precision, &fPaths[i]))) {
+                    return false;
+                }
+            }
+        } break;
         case SK_PICT_PATH_BUFFER_TAG:
             if (size > 0) {
                 const int count = buffer.readInt();
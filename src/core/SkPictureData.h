@@ -43,6 +43,8 @@ struct SkPictInfo {
 #define SK_PICT_FACTORY_TAG    SkSetFourByteTag('f', 'a', 'c', 't')
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
 #define SK_PICT_PICTURE_TAG    SkSetFourByteTag('p', 'c', 't', 'r')
+// Written by serializeCompact() in place of READER_TAG: varint op and size, then each op's data.
+#define SK_PICT_COMPACT_READER_TAG  SkSetFourByteTag('c', 'o', 'p', 's')
 
 // This tag specifies the size of the ReadBuffer, needed for the following tags
 #define SK_PICT_BUFFER_SIZE_TAG     SkSetFourByteTag('a', 'r', 'a', 'y')
@@ -51,6 +53,9 @@ struct SkPictInfo {
 #define SK_PICT_PAINT_BUFFER_TAG    SkSetFourByteTag('p', 'n', 't', ' ')
 #define SK_PICT_PATH_BUFFER_TAG     SkSetFourByteTag('p', 't', 'h', ' ')
 #define SK_PICT_TEXTBLOB_BUFFER_TAG SkSetFourByteTag('b', 'l', 'o', 'b')
+// serializeCompact() writes these in place of PAINT_BUFFER_TAG and PATH_BUFFER_TAG.
+#define SK_PICT_COMPACT_PAINT_BUFFER_TAG SkSetFourByteTag('c', 'p', 'n', 't')
+#define SK_PICT_COMPACT_PATH_BUFFER_TAG  SkSetFourByteTag('c', 'p', 't', 'h')
 
 // Always write this guy last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
@@ -58,7 +63,8 @@ struct SkPictInfo {
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&, bool deepCopyOps);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream.  If the stream is in memory, the op data points
+    // into it, so the result must not outlive the stream.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            SkPicture::InstallPixelRefProc);
@@ -66,7 +72,9 @@ public:
 
     virtual ~SkPictureData();
 
-    void serialize(SkWStream*, SkPixelSerializer*) const;
+    // If compact, writes the compact sections SkPicture::serializeCompact() describes.
+    void serialize(SkWStream*, SkPixelSerializer*, bool compact = false,
+                   SkScalar pathPrecision = 0) const;
     void flatten(SkWriteBuffer&) const;
 
     bool containsBitmaps() const;
@@ -140,7 +148,7 @@ private:
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size, SkPicture::InstallPixelRefProc);
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
-    void flattenToBuffer(SkWriteBuffer&) const;
+    void flattenToBuffer(SkWriteBuffer&, bool compact = false, SkScalar pathPrecision = 0) const;
 
     // Only used by getBitmap() if the passed in index is SkBitmapHeap::INVALID_SLOT. This empty
     // bitmap allows playback to draw nothing and move on.
@@ -6,6 +6,7 @@
  */
 
 #include "SkPictureRecord.h"
+#include "SkChecksum.h"
 #include "SkDevice.h"
 #include "SkPatchUtils.h"
 #include "SkPixelRef.h"
@@ -496,6 +497,12 @@ void SkPictureRecord::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     this->validate(initialOffset, size);
 }
 
+void SkPictureRecord::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkPictureRecord::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     // op + paint index + rrect
     size_t size = 2 * kUInt32Size + SkRRect::kSizeInMemory;
@@ -878,16 +885,56 @@ static bool equivalent(const SkBitmap& a, const SkBitmap& b) {
     return false;  // Couldn't get pixels for both bitmaps.
 }
 
+// Hashes what equivalent() compares: the encoded data if there is any, otherwise the pixels.
+// Bitmaps that are equivalent() always hash the same.
+static uint32_t content_hash(const SkBitmap& bitmap) {
+    const SkImageInfo& info = bitmap.info();
+    const uint32_t shape[] = {
+        SkToU32(info.width()), SkToU32(info.height()),
+        SkToU32(info.colorType()), SkToU32(info.alphaType()),
+    };
+    uint32_t hash = SkChecksum::Murmur3(shape, sizeof(shape));
+    if (!bitmap.pixelRef()) {
+        return hash;
+    }
+    SkAutoTUnref<SkData> encoded(bitmap.pixelRef()->refEncodedData());
+    if (encoded) {
+        return SkChecksum::Murmur3(encoded->data(), encoded->size(), hash);
+    }
+    SkAutoLockPixels alp(bitmap);
+    const char* pixels = (const char*)bitmap.getPixels();
+    if (!pixels) {
+        return hash;
+    }
+    const size_t rowBytes = info.width() * info.bytesPerPixel();
+    for (int row = 0; row < info.height(); row++) {
+        hash = SkChecksum::Murmur3(pixels, rowBytes, hash);
+        pixels += bitmap.rowBytes();
+    }
+    return hash;
+}
+
 void SkPictureRecord::addBitmap(const SkBitmap& bitmap) {
-    // First see if we already have this bitmap.  This deduplication should really
-    // only be important for our tests, where bitmaps tend not to be tagged immutable.
-    // In Chrome (and hopefully Android?) they're typically immutable.
+    // First see if we already have this bitmap.  The same pixels drawn again are the common
+    // case and cheap to spot.
     for (int i = 0; i < fBitmaps.count(); i++) {
-        if (equivalent(fBitmaps[i], bitmap)) {
+        if (fBitmaps[i].pixelRef() == bitmap.pixelRef() &&
+            fBitmaps[i].pixelRefOrigin() == bitmap.pixelRefOrigin() &&
+            fBitmaps[i].info() == bitmap.info()) {
             this->addInt(i);  // Unlike the rest, bitmap indices are 0-based.
             return;
         }
     }
+    // Otherwise look for the same content, e.g. an icon decoded separately for each use.  Only
+    // bitmaps with matching hashes are compared in full.
+    const uint32_t hash = content_hash(bitmap);
+    for (int i = 0; i < fBitmapHashes.count(); i++) {
+        if (fBitmapHashes[i] == hash && equivalent(fBitmaps[i], bitmap)) {
+            this->addInt(i);
+            return;
+        }
+    }
+    *fBitmapHashes.append() = hash;
     // Don't have it.  We'll add it to our list, making sure it's tagged as immutable.
     if (bitmap.isImmutable()) {
         // Shallow copies of bitmaps are cheap, so immutable == fast.
@@ -178,6 +178,7 @@ protected:
     void onDrawPaint(const SkPaint&) override;
     void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
     void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawOval(const SkRect&, const SkPaint&) override;
     void onDrawRRect(const SkRRect&, const SkPaint&) override;
     void onDrawPath(const SkPath&, const SkPaint&) override;
@@ -226,6 +227,7 @@ private:
     SkPictureContentInfo fContentInfo;
 
     SkTArray<SkBitmap> fBitmaps;
+    SkTDArray<uint32_t> fBitmapHashes;  // content_hash() of each of fBitmaps
     SkTArray<SkPaint>  fPaints;
     SkTArray<SkPath>   fPaths;
 
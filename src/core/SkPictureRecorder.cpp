@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "SkBBHFactory.h"
+#include "SkBBoxHierarchy.h"
 #include "SkData.h"
 #include "SkDrawable.h"
 #include "SkLayerInfo.h"
@@ -54,6 +56,12 @@ SkPicture* SkPictureRecorder::endRecordingAsPicture() {
     SkDrawableList* drawableList = fRecorder->getDrawableList();
     SkPicture::SnapshotArray* pictList = drawableList ? drawableList->newDrawableSnapshot() : NULL;
 
+    // A picture holds only one AccelData, and saveLayer information wins.
+    SkAutoTUnref<SkRecordOcclusion> occlusion;
+    if (!saveLayerData && (fFlags & kComputeOcclusion_RecordFlag)) {
+        occlusion.reset(SkNEW_ARGS(SkRecordOcclusion, (fCullRect, *fRecord)));
+    }
+
     if (fBBH.get()) {
         if (saveLayerData) {
             SkRecordComputeLayers(fCullRect, *fRecord, pictList, fBBH.get(), saveLayerData);
@@ -70,6 +78,8 @@ SkPicture* SkPictureRecorder::endRecordingAsPicture() {
 
     if (saveLayerData) {
         pict->EXPERIMENTAL_addAccelData(saveLayerData);
+    } else if (occlusion) {
+        pict->EXPERIMENTAL_addAccelData(occlusion);
     }
 
     // release our refs now, so only the picture will be the owner.
@@ -80,6 +90,44 @@ SkPicture* SkPictureRecorder::endRecordingAsPicture() {
     return pict;
 }
 
+SkPicture* SkPictureRecorder::endRecordingAsTiles(SkScalar tileWidth, SkScalar tileHeight,
+                                                  SkBBHFactory* bbhFactory) {
+    SkASSERT(tileWidth > 0 && tileHeight > 0);
+
+    // Each tile plays back only the ops its BBH search finds.
+    if (!fBBH) {
+        SkRTreeFactory factory;
+        fBBH.reset(factory(fCullRect));
+    }
+    SkAutoTUnref<SkBBoxHierarchy> bbh(SkRef(fBBH.get()));
+    SkAutoTUnref<SkPicture> whole(this->endRecordingAsPicture());
+    const SkRect bounds = whole->cullRect();
+
+    SkPictureRecorder tiled;
+    SkCanvas* canvas = tiled.beginRecording(bounds, bbhFactory, fFlags);
+    SkTDArray<unsigned> ops;
+    for (SkScalar y = bounds.fTop; y < bounds.fBottom; y += tileHeight) {
+        for (SkScalar x = bounds.fLeft; x < bounds.fRight; x += tileWidth) {
+            SkRect tile = SkRect::MakeXYWH(x, y, tileWidth, tileHeight);
+            SkAssertResult(tile.intersect(bounds));
+
+            ops.rewind();
+            bbh->search(tile, &ops);
+            if (ops.isEmpty()) {
+                continue;
+            }
+
+            SkPictureRecorder recorder;
+            SkCanvas* tileCanvas = recorder.beginRecording(tile, bbhFactory, fFlags);
+            tileCanvas->clipRect(tile);
+            whole->playback(tileCanvas);
+            SkAutoTUnref<SkPicture> picture(recorder.endRecordingAsPicture());
+            canvas->drawPicture(picture);
+        }
+    }
+    return tiled.endRecordingAsPicture();
+}
+
 void SkPictureRecorder::partialReplay(SkCanvas* canvas) const {
     if (NULL == canvas) {
         return;
@@ -7,9 +7,11 @@
 
 #include "SkPictureShader.h"
 
+#include "SkAtomics.h"
 #include "SkBitmap.h"
 #include "SkBitmapProcShader.h"
 #include "SkCanvas.h"
+#include "SkFloatBits.h"
 #include "SkMatrixUtils.h"
 #include "SkPicture.h"
 #include "SkReadBuffer.h"
@@ -17,6 +19,10 @@
 
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
+#include "GrResourceKey.h"
+#include "GrTexture.h"
+#include "SkGrPixelRef.h"
+#include "SkSurface.h"
 #endif
 
 namespace {
@@ -71,6 +77,7 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
     size_t                 fBitmapBytes;
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "picture-shader"; }
     size_t bytesUsed() const override {
         return sizeof(fKey) + sizeof(SkShader) + fBitmapBytes;
     }
@@ -101,6 +108,15 @@ static bool cache_try_alloc_pixels(SkBitmap* bitmap) {
 
 } // namespace
 
+static int32_t gRasterHits, gRasterMisses, gGpuHits, gGpuMisses;
+
+void SkPictureShader::GetTileCacheStats(TileCacheStats* stats) {
+    stats->fRasterHits   = sk_atomic_load(&gRasterHits, sk_memory_order_relaxed);
+    stats->fRasterMisses = sk_atomic_load(&gRasterMisses, sk_memory_order_relaxed);
+    stats->fGpuHits      = sk_atomic_load(&gGpuHits, sk_memory_order_relaxed);
+    stats->fGpuMisses    = sk_atomic_load(&gGpuMisses, sk_memory_order_relaxed);
+}
+
 SkPictureShader::SkPictureShader(const SkPicture* picture, TileMode tmx, TileMode tmy,
                                  const SkMatrix* localMatrix, const SkRect* tile)
     : INHERITED(localMatrix)
@@ -141,7 +157,20 @@ void SkPictureShader::flatten(SkWriteBuffer& buffer) const {
     fPicture->flatten(buffer);
 }
 
-SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatrix* localM) const {
+// Rounds the scale up to a power of two, so every scale in (2^(n-1), 2^n] shares one tile.
+static SkScalar bucket_scale(SkScalar scale) {
+#ifdef SK_SUPPORT_LEGACY_PICTURESHADER_EXACT_SCALE
+    return scale;
+#else
+    if (!SkScalarIsFinite(scale) || scale <= 0) {
+        return scale;
+    }
+    return SkScalarPow(2, SkScalarCeilToScalar(SkScalarLog2(scale)));
+#endif
+}
+
+bool SkPictureShader::computeTile(const SkMatrix& matrix, const SkMatrix* localM,
+                                  SkISize* tileSize, SkSize* tileScale, bool* resampled) const {
     SkASSERT(fPicture && !fPicture->cullRect().isEmpty());
 
     SkMatrix m;
@@ -160,8 +189,12 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
         scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
                   SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
     }
-    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * fTile.width()),
-                                     SkScalarAbs(scale.y() * fTile.height()));
+    const SkScalar scaleX = SkScalarAbs(scale.x()),
+                   scaleY = SkScalarAbs(scale.y());
+    const SkScalar bucketX = bucket_scale(scaleX),
+                   bucketY = bucket_scale(scaleY);
+    *resampled = bucketX != scaleX || bucketY != scaleY;
+    SkSize scaledSize = SkSize::Make(bucketX * fTile.width(), bucketY * fTile.height());
 
     // Clamp the tile size to about 4M pixels
     static const SkScalar kMaxTileArea = 2048 * 2048;
@@ -170,16 +203,33 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
         SkScalar clampScale = SkScalarSqrt(SkScalarDiv(kMaxTileArea, tileArea));
         scaledSize.set(SkScalarMul(scaledSize.width(), clampScale),
                        SkScalarMul(scaledSize.height(), clampScale));
+        *resampled = true;
     }
 
-    SkISize tileSize = scaledSize.toRound();
-    if (tileSize.isEmpty()) {
-        return NULL;
+    *tileSize = scaledSize.toRound();
+    if (tileSize->isEmpty()) {
+        return false;
     }
 
     // The actual scale, compensating for rounding & clamping.
-    SkSize tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
-                                    SkIntToScalar(tileSize.height()) / fTile.height());
+    tileScale->set(SkIntToScalar(tileSize->width()) / fTile.width(),
+                   SkIntToScalar(tileSize->height()) / fTile.height());
+    return true;
+}
+
+void SkPictureShader::drawTile(SkCanvas* canvas, const SkSize& tileScale) const {
+    canvas->scale(tileScale.width(), tileScale.height());
+    canvas->translate(-fTile.x(), -fTile.y());
+    canvas->drawPicture(fPicture);
+}
+
+SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatrix* localM,
+                                           bool* resampled) const {
+    SkISize tileSize;
+    SkSize tileScale;
+    if (!this->computeTile(matrix, localM, &tileSize, &tileScale, resampled)) {
+        return NULL;
+    }
 
     SkAutoTUnref<SkShader> tileShader;
     BitmapShaderKey key(fPicture->uniqueID(),
@@ -189,7 +239,10 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
                         tileScale,
                         this->getLocalMatrix());
 
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+    if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+        sk_atomic_inc(&gRasterHits);
+    } else {
+        sk_atomic_inc(&gRasterMisses);
         SkBitmap bm;
         bm.setInfo(SkImageInfo::MakeN32Premul(tileSize));
         if (!cache_try_alloc_pixels(&bm)) {
@@ -199,10 +252,7 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
 
         // Always disable LCD text, since we can't assume our image will be opaque.
         SkCanvas canvas(bm, SkSurfaceProps(0, kUnknown_SkPixelGeometry));
-
-        canvas.scale(tileScale.width(), tileScale.height());
-        canvas.translate(-fTile.x(), -fTile.y());
-        canvas.drawPicture(fPicture);
+        this->drawTile(&canvas, tileScale);
 
         SkMatrix shaderMatrix = this->getLocalMatrix();
         shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
@@ -219,19 +269,22 @@ size_t SkPictureShader::contextSize() const {
 }
 
 SkShader::Context* SkPictureShader::onCreateContext(const ContextRec& rec, void* storage) const {
-    SkAutoTUnref<SkShader> bitmapShader(this->refBitmapShader(*rec.fMatrix, rec.fLocalMatrix));
+    bool resampled;
+    SkAutoTUnref<SkShader> bitmapShader(this->refBitmapShader(*rec.fMatrix, rec.fLocalMatrix,
+                                                              &resampled));
     if (NULL == bitmapShader.get()) {
         return NULL;
     }
-    return PictureShaderContext::Create(storage, *this, rec, bitmapShader);
+    return PictureShaderContext::Create(storage, *this, rec, bitmapShader, resampled);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////
 
 SkShader::Context* SkPictureShader::PictureShaderContext::Create(void* storage,
-                   const SkPictureShader& shader, const ContextRec& rec, SkShader* bitmapShader) {
+                   const SkPictureShader& shader, const ContextRec& rec, SkShader* bitmapShader,
+                   bool resampled) {
     PictureShaderContext* ctx = SkNEW_PLACEMENT_ARGS(storage, PictureShaderContext,
-                                                     (shader, rec, bitmapShader));
+                                                     (shader, rec, bitmapShader, resampled));
     if (NULL == ctx->fBitmapShaderContext) {
         ctx->~PictureShaderContext();
         ctx = NULL;
@@ -240,12 +293,20 @@ SkShader::Context* SkPictureShader::PictureShaderContext::Create(void* storage,
 }
 
 SkPictureShader::PictureShaderContext::PictureShaderContext(
-        const SkPictureShader& shader, const ContextRec& rec, SkShader* bitmapShader)
+        const SkPictureShader& shader, const ContextRec& rec, SkShader* bitmapShader,
+        bool resampled)
     : INHERITED(shader, rec)
     , fBitmapShader(SkRef(bitmapShader))
 {
+    ContextRec bitmapRec(rec);
+    if (resampled && kNone_SkFilterQuality == rec.fPaint->getFilterQuality()) {
+        // The tile was drawn at a different scale, so smooth it back to size.
+        fFilteredPaint = *rec.fPaint;
+        fFilteredPaint.setFilterQuality(kLow_SkFilterQuality);
+        bitmapRec.fPaint = &fFilteredPaint;
+    }
     fBitmapShaderContextStorage = sk_malloc_throw(bitmapShader->contextSize());
-    fBitmapShaderContext = bitmapShader->createContext(rec, fBitmapShaderContextStorage);
+    fBitmapShaderContext = bitmapShader->createContext(bitmapRec, fBitmapShaderContextStorage);
     //if fBitmapShaderContext is null, we are invalid
 }
 
@@ -295,14 +356,83 @@ void SkPictureShader::toString(SkString* str) const {
 #endif
 
 #if SK_SUPPORT_GPU
+// Unlike the raster tiles, the GPU tiles are just the picture's pixels, in GrResourceCache, so
+// the key leaves out the tile modes and local matrix.
+static void make_gpu_tile_key(uint32_t pictureID, const SkRect& tile, const SkSize& tileScale,
+                              GrUniqueKey* key) {
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey::Builder builder(key, kDomain, 7);
+    builder[0] = pictureID;
+    builder[1] = SkFloat2Bits(tile.fLeft);
+    builder[2] = SkFloat2Bits(tile.fTop);
+    builder[3] = SkFloat2Bits(tile.fRight);
+    builder[4] = SkFloat2Bits(tile.fBottom);
+    builder[5] = SkFloat2Bits(tileScale.width());
+    builder[6] = SkFloat2Bits(tileScale.height());
+}
+
 bool SkPictureShader::asFragmentProcessor(GrContext* context, const SkPaint& paint,
                                           const SkMatrix& viewM, const SkMatrix* localMatrix,
                                           GrColor* paintColor,
                                           GrFragmentProcessor** fp) const {
-    SkAutoTUnref<SkShader> bitmapShader(this->refBitmapShader(viewM, localMatrix));
+    SkISize tileSize;
+    SkSize tileScale;
+    bool resampled;
+    if (!this->computeTile(viewM, localMatrix, &tileSize, &tileScale, &resampled)) {
+        return false;
+    }
+
+    // Draw the tile straight into a texture, rather than rasterizing and uploading it.
+    GrUniqueKey key;
+    make_gpu_tile_key(fPicture->uniqueID(), fTile, tileScale, &key);
+    SkAutoTUnref<GrTexture> texture(context->findAndRefCachedTexture(key));
+    if (texture) {
+        sk_atomic_inc(&gGpuHits);
+    } else {
+        sk_atomic_inc(&gGpuMisses);
+        GrSurfaceDesc desc;
+        desc.fFlags = kRenderTarget_GrSurfaceFlag;
+        desc.fWidth = tileSize.width();
+        desc.fHeight = tileSize.height();
+        desc.fConfig = kSkia8888_GrPixelConfig;
+        texture.reset(context->createTexture(desc, true));
+        if (!texture) {
+            return false;
+        }
+        // Always disable LCD text, since we can't assume our image will be opaque.
+        const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTargetDirect(texture->asRenderTarget(),
+                                                                         &props));
+        if (!surface) {
+            return false;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clear(SK_ColorTRANSPARENT);
+        this->drawTile(canvas, tileScale);
+        canvas->flush();
+        context->addResourceToCache(key, texture);
+    }
+
+    // Shade with the texture the same way the raster tile would be, through an SkBitmapProcShader
+    // whose bitmap wraps it.
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(tileSize);
+    SkBitmap bm;
+    bm.setInfo(info);
+    bm.setPixelRef(SkNEW_ARGS(SkGrPixelRef, (info, texture)))->unref();
+
+    SkMatrix shaderMatrix = this->getLocalMatrix();
+    shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
+    SkAutoTUnref<SkShader> bitmapShader(CreateBitmapShader(bm, fTmx, fTmy, &shaderMatrix));
     if (!bitmapShader) {
         return false;
     }
+
+    if (resampled && kNone_SkFilterQuality == paint.getFilterQuality()) {
+        SkPaint filteredPaint(paint);
+        filteredPaint.setFilterQuality(kLow_SkFilterQuality);
+        return bitmapShader->asFragmentProcessor(context, filteredPaint, viewM, NULL, paintColor,
+                                                 fp);
+    }
     return bitmapShader->asFragmentProcessor(context, paint, viewM, NULL, paintColor, fp);
 }
 #else
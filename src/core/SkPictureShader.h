@@ -8,9 +8,11 @@
 #ifndef SkPictureShader_DEFINED
 #define SkPictureShader_DEFINED
 
+#include "SkPaint.h"
 #include "SkShader.h"
 
 class SkBitmap;
+class SkCanvas;
 class SkPicture;
 
 /*
@@ -27,6 +29,20 @@ public:
 
     size_t contextSize() const override;
 
+    /**
+     *  Counts how often a tile was found already rasterized, and how often it had to be drawn,
+     *  for the raster tiles in SkResourceCache and the GPU tiles in GrResourceCache.
+     */
+    struct TileCacheStats {
+        int32_t fRasterHits;
+        int32_t fRasterMisses;
+        int32_t fGpuHits;
+        int32_t fGpuMisses;
+    };
+
+    /** Returns the counts since startup. */
+    static void GetTileCacheStats(TileCacheStats*);
+
     SK_TO_STRING_OVERRIDE()
     SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkPictureShader)
 
@@ -41,7 +57,18 @@ protected:
 private:
     SkPictureShader(const SkPicture*, TileMode, TileMode, const SkMatrix*, const SkRect*);
 
-    SkShader* refBitmapShader(const SkMatrix&, const SkMatrix* localMatrix) const;
+    /**
+     *  Picks the size to rasterize fTile at for the given matrices, and the scale to draw it
+     *  with. The scale is rounded up to a power of two, so that gradual zooms reuse the same
+     *  tile. Returns false if the tile would be empty. Sets resampled if the tile doesn't match
+     *  the matrices' scale, so needs filtering when drawn.
+     */
+    bool computeTile(const SkMatrix&, const SkMatrix* localMatrix, SkISize* tileSize,
+                     SkSize* tileScale, bool* resampled) const;
+    void drawTile(SkCanvas*, const SkSize& tileScale) const;
+
+    SkShader* refBitmapShader(const SkMatrix&, const SkMatrix* localMatrix,
+                              bool* resampled) const;
 
     const SkPicture* fPicture;
     SkRect           fTile;
@@ -50,7 +77,7 @@ private:
     class PictureShaderContext : public SkShader::Context {
     public:
         static Context* Create(void* storage, const SkPictureShader&, const ContextRec&,
-                               SkShader* bitmapShader);
+                               SkShader* bitmapShader, bool resampled);
 
         virtual ~PictureShaderContext();
 
@@ -61,9 +88,11 @@ private:
         void shadeSpan16(int x, int y, uint16_t dstC[], int count) override;
 
     private:
-        PictureShaderContext(const SkPictureShader&, const ContextRec&, SkShader* bitmapShader);
+        PictureShaderContext(const SkPictureShader&, const ContextRec&, SkShader* bitmapShader,
+                             bool resampled);
 
         SkAutoTUnref<SkShader>  fBitmapShader;
+        SkPaint                 fFilteredPaint;
         SkShader::Context*      fBitmapShaderContext;
         void*                   fBitmapShaderContextStorage;
 
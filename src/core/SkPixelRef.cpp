@@ -151,21 +151,42 @@ void SkPixelRef::setPreLocked(void* pixels, size_t rowBytes, SkColorTable* ctabl
 #endif
 }
 
+// Once some thread has the pixels locked, fRec can't change until the last unlock.  So while
+// fLockCount stays above zero, nesting lockPixels()/unlockPixels() calls just bump it with a
+// compare-and-swap, and only the first lock and last unlock take fMutex.  This keeps threads
+// drawing the same bitmap (e.g. playing back one picture into different tiles) off the mutex.
 bool SkPixelRef::lockPixels(LockRec* rec) {
     SkASSERT(!fPreLocked || SKPIXELREF_PRELOCKED_LOCKCOUNT == fLockCount);
 
     if (!fPreLocked) {
+        int count = sk_atomic_load(&fLockCount, sk_memory_order_relaxed);
+        while (count > 0) {
+            // Acquire pairs with the release below, making the locking thread's fRec visible.
+            if (sk_atomic_compare_exchange(&fLockCount, &count, count + 1,
+                                           sk_memory_order_acquire, sk_memory_order_relaxed)) {
+                *rec = fRec;
+                return true;
+            }
+        }
+
         SkAutoMutexAcquire  ac(*fMutex);
 
-        if (1 == ++fLockCount) {
+        if (0 == sk_atomic_load(&fLockCount, sk_memory_order_relaxed)) {
             SkASSERT(fRec.isZero());
 
             LockRec rec;
-            if (!this->onNewLockPixels(&rec)) {
+            bool success = this->onNewLockPixels(&rec);
+            if (success) {
+                SkASSERT(!rec.isZero());    // else why did onNewLock return true?
+                fRec = rec;
+            }
+            // Only now can other threads take the fast path above.
+            sk_atomic_store(&fLockCount, 1, sk_memory_order_release);
+            if (!success) {
                 return false;
             }
-            SkASSERT(!rec.isZero());    // else why did onNewLock return true?
-            fRec = rec;
+        } else {
+            sk_atomic_fetch_add(&fLockCount, 1, sk_memory_order_relaxed);
         }
     }
     *rec = fRec;
@@ -181,10 +202,19 @@ void SkPixelRef::unlockPixels() {
     SkASSERT(!fPreLocked || SKPIXELREF_PRELOCKED_LOCKCOUNT == fLockCount);
 
     if (!fPreLocked) {
+        int count = sk_atomic_load(&fLockCount, sk_memory_order_relaxed);
+        while (count > 1) {
+            if (sk_atomic_compare_exchange(&fLockCount, &count, count - 1,
+                                           sk_memory_order_release, sk_memory_order_relaxed)) {
+                return;
+            }
+        }
+
         SkAutoMutexAcquire  ac(*fMutex);
 
+        // Other threads may have locked again since we looked, so this may not be the last.
         SkASSERT(fLockCount > 0);
-        if (0 == --fLockCount) {
+        if (1 == sk_atomic_fetch_add(&fLockCount, -1, sk_memory_order_acq_rel)) {
             // don't call onUnlockPixels unless onLockPixels succeeded
             if (fRec.fPixels) {
                 this->onUnlockPixels();
@@ -6,6 +6,7 @@
  */
 
 #include "SkRTree.h"
+#include "SkNx.h"
 
 SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
 
@@ -47,6 +48,7 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
             fNodes.setReserve(CountNodes(fCount, fAspectRatio));
             fRoot = this->bulkLoad(&branches);
         }
+        this->flatten();
     }
 }
 
@@ -161,19 +163,94 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
     return this->bulkLoad(branches, level + 1);
 }
 
-void SkRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+void SkRTree::flatten() {
+    SkASSERT(fNodes.count() > 0);
+
+    // The nodes in breadth-first order.  A node's index here is its index in fFlatNodes.
+    SkTDArray<const Node*> queue;
+    queue.setReserve(fNodes.count());
+    *queue.append() = fRoot.fSubtree;
+
+    fFlatNodes.setCount(fNodes.count());
+    for (int i = 0; i < queue.count(); ++i) {
+        const Node* node = queue[i];
+        FlatNode* flat = &fFlatNodes[i];
+        flat->fNumChildren = node->fNumChildren;
+        flat->fLevel = node->fLevel;
+        for (int j = 0; j < kChildLanes; ++j) {
+            if (j < node->fNumChildren) {
+                const Branch& child = node->fChildren[j];
+                flat->fLeft[j]   = child.fBounds.fLeft;
+                flat->fTop[j]    = child.fBounds.fTop;
+                flat->fRight[j]  = child.fBounds.fRight;
+                flat->fBottom[j] = child.fBounds.fBottom;
+                if (0 == node->fLevel) {
+                    flat->fChildren[j] = child.fOpIndex;
+                } else {
+                    flat->fChildren[j] = queue.count();
+                    *queue.append() = child.fSubtree;
+                }
+            } else {
+                flat->fLeft[j] = flat->fTop[j] = flat->fRight[j] = flat->fBottom[j] = SK_ScalarNaN;
+                flat->fChildren[j] = 0;
+            }
+        }
     }
+    SkASSERT(queue.count() == fNodes.count());
+
+    fRoot.fSubtree = NULL;
+    fNodes.reset();
 }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<unsigned>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+unsigned SkRTree::Intersections(const FlatNode& node, const SkRect& query) {
+    const Sk4f queryLeft(query.fLeft), queryTop(query.fTop),
+               queryRight(query.fRight), queryBottom(query.fBottom);
+
+    unsigned hits = 0;
+    for (int i = 0; i < node.fNumChildren; i += 4) {
+        // Same test as SkRect::Intersects() for a non-empty query; NaN lanes are always false.
+        Sk4i hit = (Sk4f::Load(node.fLeft + i) < queryRight) &
+                   (queryLeft < Sk4f::Load(node.fRight + i)) &
+                   (Sk4f::Load(node.fTop + i) < queryBottom) &
+                   (queryTop < Sk4f::Load(node.fBottom + i));
+        if (hit.anyTrue()) {
+            for (int k = 0; k < 4; ++k) {
+                if (hit[k]) {
+                    hits |= 1 << (i + k);
+                }
+            }
+        }
+    }
+    return hits;
+}
+
+void SkRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
+    // This also rejects empty queries, which Intersections() would not.
+    if (0 == fCount || !SkRect::Intersects(fRoot.fBounds, query)) {
+        return;
+    }
+
+    // Nodes still to visit.  Each visit pops one node and pushes at most kMaxChildren, so the
+    // stack never holds more than this many.
+    SkAutoSTMalloc<64, unsigned> stack(this->getDepth() * (kMaxChildren - 1) + 1);
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const FlatNode& node = fFlatNodes[stack[--top]];
+        unsigned hits = Intersections(node, query);
+        if (0 == node.fLevel) {
+            for (int i = 0; hits; ++i, hits >>= 1) {
+                if (hits & 1) {
+                    results->push(node.fChildren[i]);
+                }
+            }
+        } else {
+            // Push in reverse so children are visited, and ops found, in order.
+            for (int i = node.fNumChildren - 1; i >= 0; --i) {
+                if (hits & (1 << i)) {
+                    stack[top++] = node.fChildren[i];
+                }
             }
         }
     }
@@ -182,7 +259,7 @@ void SkRTree::search(Node* node, const SkRect& query, SkTDArray<unsigned>* resul
 size_t SkRTree::bytesUsed() const {
     size_t byteCount = sizeof(SkRTree);
 
-    byteCount += fNodes.reserved() * sizeof(Node);
+    byteCount += fFlatNodes.reserved() * sizeof(FlatNode);
 
     return byteCount;
 }
@@ -48,7 +48,7 @@ public:
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fFlatNodes[0].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -76,7 +76,27 @@ private:
         Branch fChildren[kMaxChildren];
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<unsigned>* results) const;
+    // kMaxChildren rounded up, so children can be tested against a query four at a time.
+    static const int kChildLanes = (kMaxChildren + 3) & ~3;
+
+    // The searchable form of a Node.  Child bounds are stored as parallel arrays, and child
+    // nodes are referred to by their index in fFlatNodes, which holds the tree breadth-first
+    // with the root at index 0.  Unused lanes have NaN bounds, which never intersect anything.
+    struct FlatNode {
+        float fLeft[kChildLanes];
+        float fTop[kChildLanes];
+        float fRight[kChildLanes];
+        float fBottom[kChildLanes];
+        unsigned fChildren[kChildLanes];  // FlatNode indices, or op indices when fLevel == 0.
+        uint16_t fNumChildren;
+        uint16_t fLevel;
+    };
+
+    // Returns a bit mask of the children of node intersecting query.
+    static unsigned Intersections(const FlatNode& node, const SkRect& query);
+
+    // Copies the Node tree into fFlatNodes and frees fNodes.
+    void flatten();
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
@@ -90,7 +110,8 @@ private:
     int fCount;
     SkScalar fAspectRatio;
     Branch fRoot;
-    SkTDArray<Node> fNodes;
+    SkTDArray<Node> fNodes;          // Only used while bulk loading.
+    SkTDArray<FlatNode> fFlatNodes;
 
     typedef SkBBoxHierarchy INHERITED;
 };
@@ -56,6 +56,8 @@ public:
         kPictureImageFilterResolution_Version = 38,
         kPictureImageFilterLevel_Version   = 39,
         kImageFilterNoUniqueID_Version     = 40,
+        kAlignedStream_Version             = 41,
+        kCompactStream_Version             = 42,
     };
 
     /**
@@ -3,15 +3,60 @@
 SkRecord::~SkRecord() {
     Destroyer destroyer;
     for (unsigned i = 0; i < this->count(); i++) {
-        this->mutate<void>(i, destroyer);
+        if (!fRecords[i].isShared()) {
+            this->mutate<void>(i, destroyer);
+        }
+    }
+    if (fSharedFrom) {
+        for (int i = 0; i < fSharedFrom->count(); i++) {
+            (*fSharedFrom)[i]->unref();
+        }
+        SkDELETE(fSharedFrom);
     }
 }
 
 void SkRecord::grow() {
     SkASSERT(fCount == fReserved);
+    const unsigned oldReserved = fReserved;
     fReserved = SkTMax<unsigned>(kFirstReserveCount, fReserved*2);
-    fRecords.realloc(fReserved);
-    fTypes.realloc(fReserved);
+    const size_t typesAsRecords = (fReserved * sizeof(Type8) + sizeof(Record) - 1) / sizeof(Record);
+    fRecords.realloc(fReserved + typesAsRecords);
+
+    // The types were right after the old Records; slide them up past the new ones.
+    if (fCount > 0) {
+        memmove(this->types(), fRecords.get() + oldReserved, fCount * sizeof(Type8));
+    }
+}
+
+// Empty commands all point at one static singleton, which may not be pointer-aligned.
+// Destroying those is a no-op, so they don't need marking as shared.
+struct IsEmptyCommand {
+    template <typename T>
+    bool operator()(const T&) { return SkTIsEmpty<T>::value; }
+};
+
+void SkRecord::appendShared(const SkRecord& src, unsigned i) {
+    SkASSERT(i < src.count());
+    SkASSERT(&src != this);
+    if (fCount == fReserved) {
+        this->grow();
+    }
+
+    IsEmptyCommand isEmpty;
+    this->types()[fCount] = src.types()[i];
+    fRecords[fCount] = src.fRecords[i];
+    if (!src.visit<bool>(i, isEmpty)) {
+        fRecords[fCount].markShared();
+    }
+    fCount++;
+
+    if (NULL == fSharedFrom) {
+        fSharedFrom = SkNEW(SkTDArray<const SkRecord*>);
+    }
+    // Shared commands usually come in long runs from the same SkRecord.
+    if (fSharedFrom->isEmpty() || (fSharedFrom->top() != &src && fSharedFrom->find(&src) < 0)) {
+        *fSharedFrom->append() = SkRef(&src);
+    }
 }
 
 size_t SkRecord::bytesUsed() const {
@@ -9,6 +9,7 @@
 #define SkRecord_DEFINED
 
 #include "SkRecords.h"
+#include "SkTDArray.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 #include "SkVarAlloc.h"
@@ -30,7 +31,11 @@ class SkRecord : public SkNVRefCnt<SkRecord> {
         kFirstReserveCount = 64 / sizeof(void*),
     };
 public:
-    SkRecord() : fCount(0), fReserved(0), fAlloc(8/*start block sizes at 256 bytes*/) {}
+    SkRecord()
+        : fCount(0)
+        , fReserved(0)
+        , fAlloc(8/*start block sizes at 256 bytes*/)
+        , fSharedFrom(NULL) {}
     ~SkRecord();
 
     // Returns the number of canvas commands in this SkRecord.
@@ -43,7 +48,7 @@ public:
     template <typename R, typename F>
     R visit(unsigned i, F& f) const {
         SkASSERT(i < this->count());
-        return fRecords[i].visit<R>(fTypes[i], f);
+        return fRecords[i].visit<R>(this->types()[i], f);
     }
 
     // Mutate the i-th canvas command with a functor matching this interface:
@@ -53,7 +58,7 @@ public:
     template <typename R, typename F>
     R mutate(unsigned i, F& f) {
         SkASSERT(i < this->count());
-        return fRecords[i].mutate<R>(fTypes[i], f);
+        return fRecords[i].mutate<R>(this->types()[i], f);
     }
     // TODO: It'd be nice to infer R from F for visit and mutate if we ever get std::result_of.
 
@@ -72,10 +77,21 @@ public:
         if (fCount == fReserved) {
             this->grow();
         }
-        fTypes[fCount] = T::kType;
+        this->types()[fCount] = T::kType;
         return fRecords[fCount++].set(this->allocCommand<T>());
     }
 
+    // Append the i-th command of src to this SkRecord without copying it.  src is kept alive as
+    // long as this SkRecord is.  The command still belongs to src, so it must not be mutated
+    // here; replace() just lets go of it.
+    void appendShared(const SkRecord& src, unsigned i);
+
+    // Returns true if the i-th command was added by appendShared().
+    bool isShared(unsigned i) const {
+        SkASSERT(i < this->count());
+        return fRecords[i].isShared();
+    }
+
     // Replace the i-th command with a new command of type T.
     // You are expected to placement new an object of type T onto this pointer.
     // References to the original command are invalidated.
@@ -83,10 +99,12 @@ public:
     T* replace(unsigned i) {
         SkASSERT(i < this->count());
 
-        Destroyer destroyer;
-        this->mutate<void>(i, destroyer);
+        if (!fRecords[i].isShared()) {
+            Destroyer destroyer;
+            this->mutate<void>(i, destroyer);
+        }
 
-        fTypes[i] = T::kType;
+        this->types()[i] = T::kType;
         return fRecords[i].set(this->allocCommand<T>());
     }
 
@@ -97,10 +115,11 @@ public:
     T* replace(unsigned i, const SkRecords::Adopted<Existing>& proofOfAdoption) {
         SkASSERT(i < this->count());
 
-        SkASSERT(Existing::kType == fTypes[i]);
+        SkASSERT(Existing::kType == this->types()[i]);
         SkASSERT(proofOfAdoption == fRecords[i].ptr<Existing>());
+        SkASSERT(!fRecords[i].isShared());
 
-        fTypes[i] = T::kType;
+        this->types()[i] = T::kType;
         return fRecords[i].set(this->allocCommand<T>());
     }
 
@@ -138,7 +157,7 @@ private:
     // visit() or mutate().  The recorded canvas calls don't have to have any idea about the
     // operations performed on them.
     //
-    // We store the types in a parallel fTypes array, mainly so that they can be tightly packed as
+    // We store the types in a parallel array, mainly so that they can be tightly packed as
     // single bytes.  This has the side effect of allowing very fast analysis passes over an
     // SkRecord looking for just patterns of draw commands (or using this as a quick reject
     // mechanism) though there's admittedly not a very good API exposed publically for this.
@@ -177,7 +196,10 @@ private:
     void grow();
 
     // An untyped pointer to some bytes in fAlloc.  This is the interface for polymorphic dispatch:
-    // visit() and mutate() work with the parallel fTypes array to do the work of a vtable.
+    // visit() and mutate() work with the parallel types array to do the work of a vtable.
+    //
+    // Commands appended by appendShared() point into another SkRecord's fAlloc.  They're marked
+    // by setting the low bit of fPtr, which is free since everything in fAlloc is pointer-aligned.
     struct Record {
     public:
         // Point this record to its data in fAlloc.  Returns ptr for convenience.
@@ -189,7 +211,10 @@ private:
 
         // Get the data in fAlloc, assuming it's of type T.
         template <typename T>
-        T* ptr() const { return (T*)fPtr; }
+        T* ptr() const { return (T*)((uintptr_t)fPtr & ~kShared_Bit); }
+
+        void markShared() { fPtr = (void*)((uintptr_t)fPtr | kShared_Bit); }
+        bool isShared() const { return SkToBool((uintptr_t)fPtr & kShared_Bit); }
 
         // Visit this record with functor F (see public API above) assuming the record we're
         // pointing to has this type.
@@ -214,21 +239,29 @@ private:
         }
 
     private:
+        static const uintptr_t kShared_Bit = 1;
+
         void* fPtr;
     };
 
     // fAlloc needs to be a data structure which can append variable length data in contiguous
     // chunks, returning a stable handle to that data for later retrieval.
     //
-    // fRecords and fTypes need to be data structures that can append fixed length data, and need to
-    // support efficient random access and forward iteration.  (They don't need to be contiguous.)
+    // fRecords and the types need to be data structures that can append fixed length data, and
+    // need to support efficient random access and forward iteration.  (They don't need to be
+    // contiguous.)
+
+    // fCount and fReserved measure both fRecords and the types, which always grow in lock step.
+    // To save a pointer and an allocation, the types live in fRecords' block, right after its
+    // fReserved Records.
+    Type8* types() const { return (Type8*)(fRecords.get() + fReserved); }
 
-    // fCount and fReserved measure both fRecords and fTypes, which always grow in lock step.
     unsigned fCount;
     unsigned fReserved;
     SkAutoTMalloc<Record> fRecords;
-    SkAutoTMalloc<Type8> fTypes;
     SkVarAlloc fAlloc;
+    // The SkRecords our shared commands came from, each ref'd once.  NULL until appendShared().
+    SkTDArray<const SkRecord*>* fSharedFrom;
     // Strangely the order of these fields matters.  If the unsigneds don't go first we're 56 bytes.
     // tomhudson and mtklein have no idea why.
 };
@@ -15,22 +15,32 @@ void SkRecordDraw(const SkRecord& record,
                   SkDrawable* const drawables[],
                   int drawableCount,
                   const SkBBoxHierarchy* bbh,
-                  SkPicture::AbortCallback* callback) {
+                  SkPicture::AbortCallback* callback,
+                  const SkRecordOcclusion* occlusion) {
     SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
 
-    if (bbh) {
-        // Draw only ops that affect pixels in the canvas's current clip.
-        // The SkRecord and BBH were recorded in identity space.  This canvas
-        // is not necessarily in that same space.  getClipBounds() returns us
-        // this canvas' clip bounds transformed back into identity space, which
-        // lets us query the BBH.
-        SkRect query;
-        if (!canvas->getClipBounds(&query)) {
-            query.setEmpty();
-        }
-
+    if (bbh || occlusion) {
         SkTDArray<unsigned> ops;
-        bbh->search(query, &ops);
+        if (bbh) {
+            // Draw only ops that affect pixels in the canvas's current clip.
+            // The SkRecord and BBH were recorded in identity space.  This canvas
+            // is not necessarily in that same space.  getClipBounds() returns us
+            // this canvas' clip bounds transformed back into identity space, which
+            // lets us query the BBH.
+            SkRect query;
+            if (!canvas->getClipBounds(&query)) {
+                query.setEmpty();
+            }
+            bbh->search(query, &ops);
+        } else {
+            ops.setCount(record.count());
+            for (unsigned i = 0; i < record.count(); i++) {
+                ops[i] = i;
+            }
+        }
+        if (occlusion) {
+            occlusion->cull(canvas, &ops);
+        }
 
         SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
         for (int i = 0; i < ops.count(); i++) {
@@ -111,6 +121,7 @@ DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, r.paint));
 DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, r.paint));
 DRAW(DrawRRect, drawRRect(r.rrect, r.paint));
 DRAW(DrawRect, drawRect(r.rect, r.paint));
+DRAW(DrawRects, drawRects(r.rects, r.count, r.paint));
 DRAW(DrawSprite, drawSprite(r.bitmap.shallowCopy(), r.left, r.top, r.paint));
 DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, r.paint));
 DRAW(DrawTextBlob, drawTextBlob(r.blob, r.x, r.y, r.paint));
@@ -402,13 +413,25 @@ private:
         return rect;
     }
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint.get()); }
+    Bounds bounds(const DrawRects& op) const {
+        // Like SkCanvas::onDrawRects(), sort each rect first so empty ones still count.
+        SkRect dst = op.rects[0];
+        dst.sort();
+        for (int i = 1; i < op.count; i++) {
+            SkRect rect = op.rects[i];
+            rect.sort();
+            dst.set(SkTMin(dst.fLeft,   rect.fLeft),  SkTMin(dst.fTop,    rect.fTop),
+                    SkTMax(dst.fRight,  rect.fRight), SkTMax(dst.fBottom, rect.fBottom));
+        }
+        return this->adjustAndMap(dst, op.paint.get());
+    }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint.get()); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint.get());
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint.get());
     }
     Bounds bounds(const DrawImage& op) const {
         const SkImage* image = op.image;
@@ -436,27 +459,27 @@ private:
 
     Bounds bounds(const DrawPath& op) const {
         return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+                                           : this->adjustAndMap(op.path.getBounds(), op.paint.get());
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawPicture& op) const {
@@ -466,7 +489,7 @@ private:
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -474,10 +497,10 @@ private:
         SkRect dst;
         dst.set(op.pos, N);
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -489,7 +512,7 @@ private:
         }
         SkRect dst = { left, op.y, right, op.y };
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
@@ -504,13 +527,13 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawTextBlob& op) const {
         SkRect dst = op.blob->bounds();
         dst.offset(op.x, op.y);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawDrawable& op) const {
@@ -779,8 +802,323 @@ private:
     SkRecords::FillBounds fFillBounds;
 };
 
+// This is an SkRecord visitor that decides whether an op draws any pixels for
+// SkRecordProfileDraw, and reports its type.
+class TouchesPixels : SkNoncopyable {
+public:
+    TouchesPixels() : fType(NoOp_Type) {}
+
+    Type type() const { return fType; }
+
+    template <typename T> bool operator()(const T& op) {
+        fType = T::kType;
+        return this->touches(op);
+    }
+
+private:
+    // Most ops draw.
+    template <typename T> bool touches(const T&) { return true; }
+
+    bool touches(const NoOp&)              { return false; }
+    bool touches(const SetMatrix&)         { return false; }
+    bool touches(const ClipPath&)          { return false; }
+    bool touches(const ClipRRect&)         { return false; }
+    bool touches(const ClipRect&)          { return false; }
+    bool touches(const ClipRegion&)        { return false; }
+    bool touches(const BeginCommentGroup&) { return false; }
+    bool touches(const AddComment&)        { return false; }
+    bool touches(const EndCommentGroup&)   { return false; }
+
+    // Only layers draw when they're restored.
+    bool touches(const Save&)              { fIsLayer.push(false); return false; }
+    bool touches(const SaveLayer&)         { fIsLayer.push(true);  return false; }
+    bool touches(const Restore&) {
+        bool isLayer = false;
+        if (!fIsLayer.isEmpty()) {
+            fIsLayer.pop(&isLayer);
+        }
+        return isLayer;
+    }
+
+    Type fType;
+    SkTDArray<bool> fIsLayer;
+};
+
+// This is an SkRecord visitor that fills in an SkRecordOcclusion: the bounds of each op from
+// FillBounds, and the area each op is sure to cover with opaque pixels.
+//
+// We only look for opaque coverage in simple cases: rects, rrects, paints, and images drawn
+// with a paint that can't let anything underneath show through, under a matrix that keeps
+// rects rects, outside any saveLayer, and inside clips we can bound from the inside by a rect.
+class FindOpaque : SkNoncopyable {
+public:
+    FindOpaque(const SkRect& cullRect, const SkRecord& record, SkRecordOcclusion::Op* ops)
+        : fCullRect(cullRect)
+        , fFillBounds(cullRect, record)
+        , fOps(ops)
+        , fNumRecords(record.count())
+        , fCurrentOp(0)
+        , fClip(cullRect)
+        , fLayers(0) {}
+
+    void setCurrentOp(unsigned currentOp) {
+        fCurrentOp = currentOp;
+        fFillBounds.setCurrentOp(currentOp);
+    }
+
+    void cleanUp() {
+        fFillBounds.cleanUp(NULL);
+        for (unsigned i = 0; i < fNumRecords; i++) {
+            fOps[i].fBounds = fFillBounds.getBounds(i);
+        }
+    }
+
+    template <typename T> void operator()(const T& op) {
+        fFillBounds(op);
+        fOps[fCurrentOp].fCanSkip = CanSkip(op);
+        fOps[fCurrentOp].fOpaque = this->opaque(op);
+        this->updateClip(op);
+    }
+
+private:
+    struct SaveState {
+        SkRect fClip;
+        bool   fIsLayer;
+    };
+
+    // Only ops that draw may be skipped.
+    template <typename T> static bool CanSkip(const T&) { return true; }
+    static bool CanSkip(const Save&)              { return false; }
+    static bool CanSkip(const SaveLayer&)         { return false; }
+    static bool CanSkip(const Restore&)           { return false; }
+    static bool CanSkip(const SetMatrix&)         { return false; }
+    static bool CanSkip(const ClipPath&)          { return false; }
+    static bool CanSkip(const ClipRRect&)         { return false; }
+    static bool CanSkip(const ClipRect&)          { return false; }
+    static bool CanSkip(const ClipRegion&)        { return false; }
+    static bool CanSkip(const BeginCommentGroup&) { return false; }
+    static bool CanSkip(const AddComment&)        { return false; }
+    static bool CanSkip(const EndCommentGroup&)   { return false; }
+
+    // fClip is an identity-space rect inside the current clip, maybe empty.
+    template <typename T> void updateClip(const T&) {}
+    void updateClip(const Save&)      { this->push(false); }
+    void updateClip(const SaveLayer&) { this->push(true); fLayers++; }
+    void updateClip(const Restore&) {
+        if (fSaveStack.isEmpty()) {
+            return;
+        }
+        SaveState state;
+        fSaveStack.pop(&state);
+        fClip = state.fClip;
+        fLayers -= state.fIsLayer ? 1 : 0;
+    }
+    void updateClip(const ClipRect& op)  { this->clip(op.rect, op.opAA.op); }
+    void updateClip(const ClipRRect& op) { this->clip(InnerRect(op.rrect), op.opAA.op); }
+    void updateClip(const ClipPath& op) {
+        SkRect rect;
+        this->clip(op.path.isRect(&rect) && !op.path.isInverseFillType() ? rect
+                                                                         : SkRect::MakeEmpty(),
+                   op.opAA.op);
+    }
+    void updateClip(const ClipRegion& op) {
+        this->clip(op.region.isRect() ? SkRect::Make(op.region.getBounds()) : SkRect::MakeEmpty(),
+                   op.op);
+    }
+
+    void push(bool isLayer) {
+        SaveState* state = fSaveStack.append();
+        state->fClip = fClip;
+        state->fIsLayer = isLayer;
+    }
+
+    void clip(SkRect rect, SkRegion::Op op) {
+        const SkMatrix& ctm = fFillBounds.ctm();
+        if (!ctm.rectStaysRect()) {
+            rect.setEmpty();
+        }
+        rect.sort();
+        ctm.mapRect(&rect);
+        switch (op) {
+            case SkRegion::kIntersect_Op:
+                break;
+            case SkRegion::kReplace_Op:
+                fClip = fCullRect;
+                break;
+            default:
+                // The clip may grow or get holes.  Nothing below it can be an occluder.
+                rect.setEmpty();
+                break;
+        }
+        if (!fClip.intersect(rect)) {
+            fClip.setEmpty();
+        }
+    }
+
+    // A rect inside rrect: the wider or taller of the two bands that miss its corners.
+    static SkRect InnerRect(const SkRRect& rrect) {
+        SkRect rect = rrect.rect();
+        if (rrect.isRect()) {
+            return rect;
+        }
+        SkScalar dx = 0, dy = 0;
+        for (int i = 0; i < 4; i++) {
+            const SkVector& radii = rrect.radii((SkRRect::Corner)i);
+            dx = SkMaxScalar(dx, radii.fX);
+            dy = SkMaxScalar(dy, radii.fY);
+        }
+        SkRect wide = rect, tall = rect;
+        wide.inset(0, dy);
+        tall.inset(dx, 0);
+        if (wide.isEmpty()) {
+            return tall.isEmpty() ? SkRect::MakeEmpty() : tall;
+        }
+        if (tall.isEmpty()) {
+            return wide;
+        }
+        return wide.width() * wide.height() >= tall.width() * tall.height() ? wide : tall;
+    }
+
+    // Would drawing with paint hide everything under it?  Images ignore the paint's style.
+    static bool PaintIsOpaque(const SkPaint* paint, bool isImage) {
+        if (!paint) {
+            return isImage;
+        }
+        if (paint->getAlpha() != 0xFF ||
+            (!isImage && paint->getStyle() != SkPaint::kFill_Style) ||
+            (paint->getShader() && !paint->getShader()->isOpaque()) ||
+            paint->getPathEffect() ||
+            paint->getMaskFilter() ||
+            paint->getColorFilter() ||
+            paint->getImageFilter() ||
+            paint->getLooper() ||
+            paint->getRasterizer()) {
+            return false;
+        }
+        SkXfermode::Mode mode;
+        if (paint->getXfermode() && (!paint->getXfermode()->asMode(&mode) ||
+                                     (mode != SkXfermode::kSrcOver_Mode &&
+                                      mode != SkXfermode::kSrc_Mode))) {
+            return false;
+        }
+        return true;
+    }
+
+    // Map rect, covered opaquely in local coordinates, to identity space inside the clip.
+    SkRect mapOpaque(SkRect rect) const {
+        const SkMatrix& ctm = fFillBounds.ctm();
+        if (fLayers > 0 || !ctm.rectStaysRect()) {
+            return SkRect::MakeEmpty();
+        }
+        rect.sort();
+        ctm.mapRect(&rect);
+        if (!rect.intersect(fClip)) {
+            return SkRect::MakeEmpty();
+        }
+        return rect;
+    }
+
+    SkRect image(bool isOpaque, int width, int height, const SkRect* src, const SkRect& dst,
+                 const SkPaint* paint) const {
+        // Parts of src outside the image draw nothing, so they'd shrink what dst covers.
+        if (!isOpaque || !PaintIsOpaque(paint, true) ||
+            (src && !SkRect::MakeIWH(width, height).contains(*src))) {
+            return SkRect::MakeEmpty();
+        }
+        return this->mapOpaque(dst);
+    }
+
+    template <typename T> SkRect opaque(const T&) const { return SkRect::MakeEmpty(); }
+
+    SkRect opaque(const DrawRect& op) const {
+        return PaintIsOpaque(op.paint.get(), false) ? this->mapOpaque(op.rect)
+                                                    : SkRect::MakeEmpty();
+    }
+    SkRect opaque(const DrawRRect& op) const {
+        return PaintIsOpaque(op.paint.get(), false) ? this->mapOpaque(InnerRect(op.rrect))
+                                                    : SkRect::MakeEmpty();
+    }
+    SkRect opaque(const DrawPaint& op) const {
+        // No matrix can stop a paint from filling the clip.
+        return PaintIsOpaque(op.paint.get(), false) && fLayers == 0 ? fClip
+                                                                   : SkRect::MakeEmpty();
+    }
+    SkRect opaque(const DrawImage& op) const {
+        const SkImage* image = op.image;
+        return this->image(image->isOpaque(), image->width(), image->height(), NULL,
+                           SkRect::MakeXYWH(op.left, op.top, image->width(), image->height()),
+                           op.paint);
+    }
+    SkRect opaque(const DrawImageRect& op) const {
+        const SkImage* image = op.image;
+        return this->image(image->isOpaque(), image->width(), image->height(), op.src, op.dst,
+                           op.paint);
+    }
+    SkRect opaque(const DrawBitmap& op) const {
+        return this->image(op.bitmap.isOpaque(), op.bitmap.width(), op.bitmap.height(), NULL,
+                           SkRect::MakeXYWH(op.left, op.top,
+                                            op.bitmap.width(), op.bitmap.height()),
+                           op.paint);
+    }
+    SkRect opaque(const DrawBitmapRectToRect& op) const {
+        return this->image(op.bitmap.isOpaque(), op.bitmap.width(), op.bitmap.height(), op.src,
+                           op.dst, op.paint);
+    }
+    SkRect opaque(const DrawBitmapRectToRectBleed& op) const {
+        return this->image(op.bitmap.isOpaque(), op.bitmap.width(), op.bitmap.height(), op.src,
+                           op.dst, op.paint);
+    }
+
+    const SkRect fCullRect;
+    FillBounds fFillBounds;
+    SkRecordOcclusion::Op* fOps;
+    const unsigned fNumRecords;
+    unsigned fCurrentOp;
+
+    SkRect fClip;
+    int fLayers;  // Number of SaveLayers we're inside.
+    SkTDArray<SaveState> fSaveStack;
+};
+
 }  // namespace SkRecords
 
+void SkRecordProfileDraw(const SkRecord& record, const SkRect& cullRect, SkCanvas* canvas,
+                         SkPicture const* const drawablePicts[], int drawableCount,
+                         SkRecordDrawProfiler* profiler) {
+    // The bounds come back in the record's identity space, which is the canvas' current space.
+    SkRecords::FillBounds bounds(cullRect, record);
+    for (unsigned i = 0; i < record.count(); i++) {
+        bounds.setCurrentOp(i);
+        record.visit<void>(i, bounds);
+    }
+    bounds.cleanUp(NULL);
+
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+    const SkMatrix ctm = canvas->getTotalMatrix();
+    SkIRect clip;
+    if (!canvas->getClipDeviceBounds(&clip)) {
+        clip.setEmpty();
+    }
+    const SkRect devClip = SkRect::Make(clip);
+
+    SkRecords::TouchesPixels touches;
+    SkRecords::Draw draw(canvas, drawablePicts, NULL, drawableCount);
+    for (unsigned i = 0; i < record.count(); i++) {
+        int64_t pixels = 0;
+        SkRect devBounds;
+        ctm.mapRect(&devBounds, bounds.getBounds(i));
+        if (record.visit<bool>(i, touches) && devBounds.intersect(devClip)) {
+            SkIRect devPixels;
+            devBounds.roundOut(&devPixels);
+            pixels = (int64_t)devPixels.width() * devPixels.height();
+        }
+
+        profiler->willDraw(i, touches.type());
+        record.visit<void>(i, draw);
+        profiler->didDraw(i, touches.type(), pixels);
+    }
+}
+
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkBBoxHierarchy* bbh) {
     SkRecords::FillBounds visitor(cullRect, record);
 
@@ -792,6 +1130,20 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkBBoxHi
     visitor.cleanUp(bbh);
 }
 
+void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[]) {
+    SkRecords::FillBounds visitor(cullRect, record);
+
+    for (unsigned curOp = 0; curOp < record.count(); curOp++) {
+        visitor.setCurrentOp(curOp);
+        record.visit<void>(curOp, visitor);
+    }
+
+    visitor.cleanUp(NULL);
+    for (unsigned curOp = 0; curOp < record.count(); curOp++) {
+        bounds[curOp] = visitor.getBounds(curOp);
+    }
+}
+
 void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord& record,
                            const SkPicture::SnapshotArray* pictList, SkBBoxHierarchy* bbh,
                            SkLayerInfo* data) {
@@ -805,3 +1157,99 @@ void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord& record,
     visitor.cleanUp(bbh);
 }
 
+SkPicture::AccelData::Key SkRecordOcclusion::ComputeKey() {
+    static const SkPicture::AccelData::Key gOcclusionID = SkPicture::AccelData::GenerateDomain();
+
+    return gOcclusionID;
+}
+
+SkRecordOcclusion::SkRecordOcclusion(const SkRect& cullRect, const SkRecord& record)
+    : INHERITED(ComputeKey())
+    , fCount(record.count())
+    , fOps(record.count()) {
+    SkRecords::FindOpaque visitor(cullRect, record, fOps.get());
+
+    for (unsigned curOp = 0; curOp < record.count(); curOp++) {
+        visitor.setCurrentOp(curOp);
+        record.visit<void>(curOp, visitor);
+    }
+
+    visitor.cleanUp();
+}
+
+void SkRecordOcclusion::cull(SkCanvas* canvas, SkTDArray<unsigned>* ops) const {
+    // A draw filter could change any paint, and other matrices don't keep our rects rects.
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    SkIRect clip;
+    if (canvas->getDrawFilter() || !ctm.rectStaysRect() || !canvas->getClipDeviceBounds(&clip)) {
+        return;
+    }
+
+    // Walk back to front, gathering the device pixels the biggest few later occluders cover.
+    // Ops are compared by the pixels they may touch, so antialiased edges are never mistaken
+    // for covered: an op is skipped only if all its pixels lie wholly inside one occluder.
+    static const int kMaxOccluders = 8;
+    SkIRect occluders[kMaxOccluders];
+    int occluderCount = 0;
+
+    static const unsigned kSkipped = ~0u;
+    bool skippedAny = false;
+    for (int j = ops->count() - 1; j >= 0; j--) {
+        SkASSERT((*ops)[j] < fCount);
+        const Op& op = fOps[(*ops)[j]];
+
+        if (op.fCanSkip) {
+            SkRect bounds;
+            ctm.mapRect(&bounds, op.fBounds);
+            // Hairlines and antialiasing can reach a little past the bounds.
+            bounds.outset(SK_Scalar1, SK_Scalar1);
+            SkIRect pixels;
+            bounds.roundOut(&pixels);
+
+            bool skip = !pixels.intersect(clip);
+            for (int k = 0; !skip && k < occluderCount; k++) {
+                skip = occluders[k].contains(pixels);
+            }
+            if (skip) {
+                (*ops)[j] = kSkipped;
+                skippedAny = true;
+                continue;
+            }
+        }
+
+        if (!op.fOpaque.isEmpty()) {
+            SkRect opaque;
+            ctm.mapRect(&opaque, op.fOpaque);
+            SkIRect covered;
+            opaque.roundIn(&covered);
+            if (!covered.intersect(clip)) {
+                continue;
+            }
+            int64_t area = (int64_t)covered.width() * covered.height();
+            if (occluderCount < kMaxOccluders) {
+                occluders[occluderCount++] = covered;
+                continue;
+            }
+            int smallest = 0;
+            for (int k = 1; k < kMaxOccluders; k++) {
+                if ((int64_t)occluders[k].width() * occluders[k].height() <
+                    (int64_t)occluders[smallest].width() * occluders[smallest].height()) {
+                    smallest = k;
+                }
+            }
+            if ((int64_t)occluders[smallest].width() * occluders[smallest].height() < area) {
+                occluders[smallest] = covered;
+            }
+        }
+    }
+
+    if (skippedAny) {
+        int count = 0;
+        for (int j = 0; j < ops->count(); j++) {
+            if ((*ops)[j] != kSkipped) {
+                (*ops)[count++] = (*ops)[j];
+            }
+        }
+        ops->setCount(count);
+    }
+}
@@ -15,18 +15,55 @@
 
 class SkDrawable;
 class SkLayerInfo;
+class SkRecordOcclusion;
+namespace SkRecords { class FindOpaque; }
 
 // Fill a BBH to be used by SkRecordDraw to accelerate playback.
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&, SkBBoxHierarchy*);
 
+// Or just fill bounds, record.count() of them, with the bounds that would go into that BBH.
+void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&, SkRect bounds[]);
+
 void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord& record,
                            const SkPicture::SnapshotArray*,
                            SkBBoxHierarchy* bbh, SkLayerInfo* data);
 
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
+// If occlusion is set, ops hidden by later opaque draws are skipped.
 void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
                   SkDrawable* const drawables[], int drawableCount,
-                  const SkBBoxHierarchy*, SkPicture::AbortCallback*);
+                  const SkBBoxHierarchy*, SkPicture::AbortCallback*,
+                  const SkRecordOcclusion* occlusion = NULL);
+
+// Where each op of an SkRecord draws, and where it draws opaquely, so that playback can skip
+// ops that later opaque rect, rrect, and image draws completely cover.  SkPictureRecorder
+// attaches this to a picture as its AccelData when asked to.
+class SkRecordOcclusion : public SkPicture::AccelData {
+public:
+    SkRecordOcclusion(const SkRect& cullRect, const SkRecord&);
+
+    static SkPicture::AccelData::Key ComputeKey();
+
+    // Remove from ops, a list of op indices in drawing order, those hidden when drawn to canvas.
+    // This only culls when the canvas' matrix keeps rects rects and there is no draw filter.
+    void cull(SkCanvas*, SkTDArray<unsigned>* ops) const;
+
+    size_t bytesUsed() const { return sizeof(*this) + fCount * sizeof(Op); }
+
+private:
+    struct Op {
+        SkRect fBounds;  // Conservative identity-space bounds, as for the BBH.
+        SkRect fOpaque;  // Identity-space area this op covers with opaque pixels, maybe empty.
+        bool   fCanSkip; // False for saves, restores, clips, matrix changes, and comments.
+    };
+
+    const unsigned fCount;
+    SkAutoTMalloc<Op> fOps;
+
+    friend class SkRecords::FindOpaque;  // Fills in fOps.
+
+    typedef SkPicture::AccelData INHERITED;
+};
 
 // Draw a portion of an SkRecord into an SkCanvas.
 // When drawing a portion of an SkRecord the CTM on the passed in canvas must be
@@ -37,6 +74,27 @@ void SkRecordPartialDraw(const SkRecord&, SkCanvas*,
                          SkPicture const* const drawablePicts[], int drawableCount,
                          unsigned start, unsigned stop, const SkMatrix& initialCTM);
 
+// Receives a report on each op drawn by SkRecordProfileDraw().
+class SkRecordDrawProfiler {
+public:
+    virtual ~SkRecordDrawProfiler() {}
+
+    // Called just before op i is drawn.  Time it from here...
+    virtual void willDraw(unsigned i, SkRecords::Type) {}
+
+    // ... to here.  pixels estimates how many device pixels op i touched: the area of its bounds
+    // in device space, clipped to the canvas' clip at the start of playback.  Ops that don't draw
+    // (saves, clips, matrix changes, comments) touch none, but the Restore of a SaveLayer touches
+    // the pixels the layer is drawn back onto.
+    virtual void didDraw(unsigned i, SkRecords::Type, int64_t pixels) = 0;
+};
+
+// Draw all of an SkRecord into an SkCanvas like SkRecordDraw, reporting on each op to profiler.
+// This is for tools hunting for slow ops, and is itself a good deal slower than SkRecordDraw.
+void SkRecordProfileDraw(const SkRecord&, const SkRect& cullRect, SkCanvas*,
+                         SkPicture const* const drawablePicts[], int drawableCount,
+                         SkRecordDrawProfiler*);
+
 namespace SkRecords {
 
 // This is an SkRecord visitor that will draw that SkRecord to an SkCanvas.
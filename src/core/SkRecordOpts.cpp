@@ -9,41 +9,37 @@
 
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkTaskGroup.h"
+#include "SkTArray.h"
 #include "SkTDArray.h"
 
 using namespace SkRecords;
 
-void SkRecordOptimize(SkRecord* record) {
-    // This might be useful  as a first pass in the future if we want to weed
-    // out junk for other optimization passes.  Right now, nothing needs it,
-    // and the bounding box hierarchy will do the work of skipping no-op
-    // Save-NoDraw-Restore sequences better than we can here.
-    //SkRecordNoopSaveRestores(record);
-
-    SkRecordNoopSaveLayerDrawRestores(record);
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
-}
-
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
 //   - a Pattern typedef
 //   - a bool onMatch(SkRceord*, Pattern*, unsigned begin, unsigned end) method,
 //     which returns true if it made changes and false if not.
 
-// Run a pattern-based optimization once across the SkRecord, returning true if it made any changes.
-// It looks for spans which match Pass::Pattern, and when found calls onMatch() with the pattern,
-// record, and [begin,end) span of the commands that matched.
+// Run a pattern-based optimization once across the [start, stop) span of the SkRecord, returning
+// true if it made any changes.  It looks for spans which match Pass::Pattern, and when found calls
+// onMatch() with the pattern, record, and [begin,end) span of the commands that matched.
 template <typename Pass>
-static bool apply(Pass* pass, SkRecord* record) {
+static bool apply(Pass* pass, SkRecord* record, unsigned start, unsigned stop) {
     typename Pass::Pattern pattern;
     bool changed = false;
-    unsigned begin, end = 0;
+    unsigned begin, end = start;
 
-    while (pattern.search(record, &begin, &end)) {
+    while (pattern.search(record, &begin, &end, stop)) {
         changed |= pass->onMatch(record, &pattern, begin, end);
     }
     return changed;
 }
 
+template <typename Pass>
+static bool apply(Pass* pass, SkRecord* record) {
+    return apply(pass, record, 0, record->count());
+}
+
 // Turns the logical NoOp Save and Restore in Save-Draw*-Restore patterns into actual NoOps.
 struct SaveOnlyDrawsRestoreNooper {
     typedef Pattern3<Is<Save>,
@@ -176,9 +172,12 @@ struct SaveLayerDrawRestoreNooper {
         return true;
     }
 };
-void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
+static void noop_save_layer_draw_restores(SkRecord* record, unsigned start, unsigned stop) {
     SaveLayerDrawRestoreNooper pass;
-    apply(&pass, record);
+    apply(&pass, record, start, stop);
+}
+void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
+    noop_save_layer_draw_restores(record, 0, record->count());
 }
 
 
@@ -226,7 +225,146 @@ struct SvgOpacityAndFilterLayerMergePass {
     }
 };
 
-void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
+static void merge_svg_opacity_and_filter_layers(SkRecord* record, unsigned start, unsigned stop) {
     SvgOpacityAndFilterLayerMergePass pass;
+    apply(&pass, record, start, stop);
+}
+void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
+    merge_svg_opacity_and_filter_layers(record, 0, record->count());
+}
+
+// Merges runs of DrawRects sharing a paint into a single DrawRects, so playback sets up the
+// paint, clip and blitter once per run instead of once per rect.  NoOps inside a run are skipped.
+struct DrawRectMerger {
+    typedef Pattern2<Is<DrawRect>, Star<Or<Is<NoOp>, Is<DrawRect> > > > Pattern;
+
+    // Every DrawRect in a run is culled together, so keep runs short enough that a tiled
+    // playback doesn't end up drawing far more than it asked for.
+    static const int kMaxRectsPerRun = 64;
+
+    bool onMatch(SkRecord* record, Pattern* pattern, unsigned begin, unsigned end) {
+        bool changed = false;
+        SkSTArray<kMaxRectsPerRun, unsigned, true> run;
+        for (unsigned i = begin; i < end; i++) {
+            DrawRect* draw = AsDrawRect(record, i);
+            if (NULL == draw) {
+                continue;  // A NoOp.
+            }
+            if (!run.empty() && (run.count() == kMaxRectsPerRun ||
+                                 !SamePaint(draw->paint, AsDrawRect(record, run[0])->paint))) {
+                changed |= Merge(record, run);
+                run.reset();
+            }
+            if (CanMerge(draw->paint)) {
+                run.push_back(i);
+            }
+        }
+        return Merge(record, run) || changed;
+    }
+
+    // A looper or image filter applies to each draw call as a whole, so it would treat a merged
+    // run differently than the rects drawn one at a time.
+    static bool SamePaint(const SharedPaint& a, const SharedPaint& b) {
+        // Interned paints make this usually a pointer comparison.
+        return a.box() == b.box() || *a.get() == *b.get();
+    }
+
+    static bool CanMerge(const SkPaint& paint) {
+        return NULL == paint.getLooper() && NULL == paint.getImageFilter();
+    }
+
+    static DrawRect* AsDrawRect(SkRecord* record, unsigned i) {
+        Is<DrawRect> isDrawRect;
+        record->mutate<bool>(i, isDrawRect);
+        return isDrawRect.get();
+    }
+
+    static bool Merge(SkRecord* record, const SkTArray<unsigned, true>& run) {
+        if (run.count() < 2) {
+            return false;
+        }
+        SkRect* rects = record->alloc<SkRect>(run.count());
+        for (int i = 0; i < run.count(); i++) {
+            rects[i] = AsDrawRect(record, run[i])->rect;
+        }
+        SkAutoTUnref<PaintBox> paint(SkRef(AsDrawRect(record, run[0])->paint.box()));
+        for (int i = 1; i < run.count(); i++) {
+            record->replace<NoOp>(run[i]);
+        }
+        SkNEW_PLACEMENT_ARGS(record->replace<DrawRects>(run[0]), DrawRects,
+                             (paint.get(), rects, run.count()));
+        return true;
+    }
+};
+void SkRecordMergeDrawRects(SkRecord* record) {
+    DrawRectMerger pass;
     apply(&pass, record);
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Every pass above rewrites only the ops from a Save or SaveLayer through its matching Restore.
+// So wherever the save depth returns to zero, the record can be cut into spans that are
+// optimized independently, and at the same time.  Matches can't straddle a cut, so the result
+// is the same as running each pass over the whole record.  The passes only ever replace ops
+// with NoOp, which needs no allocation from the SkRecord.  SkRecordMergeDrawRects() does
+// allocate, so it runs afterwards on this thread.
+
+// Spans smaller than this aren't worth handing to another thread.
+static const unsigned kMinOpsPerSpan = 4096;
+
+struct SaveDepthDelta {
+    int operator()(const Save&)      { return +1; }
+    int operator()(const SaveLayer&) { return +1; }
+    int operator()(const Restore&)   { return -1; }
+    template <typename T>
+    int operator()(const T&)         { return 0; }
+};
+
+struct OptimizeSpan {
+    SkRecord* fRecord;
+    unsigned  fStart, fStop;
+};
+
+static void optimize_span(OptimizeSpan* span) {
+    noop_save_layer_draw_restores(span->fRecord, span->fStart, span->fStop);
+    merge_svg_opacity_and_filter_layers(span->fRecord, span->fStart, span->fStop);
+}
+
+void SkRecordOptimize(SkRecord* record) {
+    // This might be useful  as a first pass in the future if we want to weed
+    // out junk for other optimization passes.  Right now, nothing needs it,
+    // and the bounding box hierarchy will do the work of skipping no-op
+    // Save-NoDraw-Restore sequences better than we can here.
+    //SkRecordNoopSaveRestores(record);
+
+    SkTDArray<OptimizeSpan> spans;
+    if (record->count() >= 2 * kMinOpsPerSpan) {
+        SaveDepthDelta delta;
+        int depth = 0;
+        unsigned start = 0;
+        for (unsigned i = 0; i < record->count(); i++) {
+            depth += record->visit<int>(i, delta);
+            if (0 == depth && i + 1 - start >= kMinOpsPerSpan) {
+                OptimizeSpan span = { record, start, i + 1 };
+                *spans.append() = span;
+                start = i + 1;
+            }
+        }
+        if (start < record->count()) {
+            OptimizeSpan span = { record, start, record->count() };
+            *spans.append() = span;
+        }
+    }
+
+    if (spans.count() <= 1) {
+        OptimizeSpan span = { record, 0, record->count() };
+        optimize_span(&span);
+    } else {
+        SkTaskGroup tg;
+        tg.batch(optimize_span, spans.begin(), spans.count());
+        tg.wait();
+    }
+
+    SkRecordMergeDrawRects(record);
+}
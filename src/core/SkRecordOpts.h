@@ -10,7 +10,8 @@
 
 #include "SkRecord.h"
 
-// Run all optimizations in recommended order.
+// Run all optimizations in recommended order.  Large records are split at points where no
+// Save or SaveLayer is open, and the pieces are optimized in parallel on SkTaskGroup.
 void SkRecordOptimize(SkRecord*);
 
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
@@ -24,4 +25,7 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Merge runs of DrawRect with identical paints into single DrawRects.
+void SkRecordMergeDrawRects(SkRecord*);
+
 #endif//SkRecordOpts_DEFINED
@@ -32,39 +32,42 @@ private:
     type* fPtr;
 };
 
-// Matches any command that draws, and stores its paint.
+// Matches any command that draws, and stores its paint.  get() assumes the caller will modify
+// the paint, so it unshares a SharedPaint; matching alone doesn't.
 class IsDraw {
     SK_CREATE_MEMBER_DETECTOR(paint);
 public:
-    IsDraw() : fPaint(NULL) {}
+    IsDraw() : fPaint(NULL), fShared(NULL) {}
 
     typedef SkPaint type;
-    type* get() { return fPaint; }
+    type* get() { return fShared ? fShared->writable() : fPaint; }
 
     template <typename T>
     SK_WHEN(HasMember_paint<T>, bool) operator()(T* draw) {
-        fPaint = AsPtr(draw->paint);
+        this->set(draw->paint);
         return true;
     }
 
     template <typename T>
     SK_WHEN(!HasMember_paint<T>, bool) operator()(T*) {
-        fPaint = NULL;
+        this->set((SkPaint*)NULL);
         return false;
     }
 
     // SaveLayer has an SkPaint named paint, but it's not a draw.
     bool operator()(SaveLayer*) {
-        fPaint = NULL;
+        this->set((SkPaint*)NULL);
         return false;
     }
 
 private:
-    // Abstracts away whether the paint is always part of the command or optional.
-    template <typename T> static T* AsPtr(SkRecords::Optional<T>& x) { return x; }
-    template <typename T> static T* AsPtr(T& x) { return &x; }
+    // Abstracts away whether the paint is always part of the command, shared, or optional.
+    void set(SkPaint* paint)                    { fPaint = paint; fShared = NULL; }
+    void set(SkRecords::Optional<SkPaint>& x)   { this->set((SkPaint*)x); }
+    void set(SkRecords::SharedPaint& x)         { fPaint = NULL; fShared = &x; }
 
     type* fPaint;
+    SkRecords::SharedPaint* fShared;
 };
 
 // Matches if Matcher doesn't.  Stores nothing.
@@ -117,9 +120,14 @@ public:
     // Starting from *end, walk through the SkRecord to find the first span matching this pattern.
     // If there is no such span, return false.  If there is, return true and set [*begin, *end).
     SK_ALWAYS_INLINE bool search(SkRecord* record, unsigned* begin, unsigned* end) {
-        for (*begin = *end; *begin < record->count(); ++(*begin)) {
+        return this->search(record, begin, end, record->count());
+    }
+
+    // As above, but only finds spans ending at or before stop.
+    SK_ALWAYS_INLINE bool search(SkRecord* record, unsigned* begin, unsigned* end, unsigned stop) {
+        for (*begin = *end; *begin < stop; ++(*begin)) {
             *end = this->match(record, *begin);
-            if (*end != 0) {
+            if (*end != 0 && *end <= stop) {
                 return true;
             }
         }
@@ -146,7 +154,7 @@ private:
         return 0;
     }
 
-    // If head is a Star, walk i until it doesn't match.
+    // If head is a Star, walk i until it doesn't match.  A Star may run to the end of the record.
     template <typename T>
     unsigned matchHead(Star<T>*, SkRecord* record, unsigned i) {
         while (i < record->count()) {
@@ -155,7 +163,7 @@ private:
             }
             i++;
         }
-        return 0;
+        return i;
     }
 
     Matcher fHead;
@@ -39,6 +39,10 @@ SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds)
     : SkCanvas(bounds.roundOut(), SkCanvas::kConservativeRasterClip_InitFlag)
     , fRecord(record) {}
 
+SkRecorder::~SkRecorder() {
+    fPaints.foreach([](SkRecords::PaintBox** box) { (*box)->unref(); });
+}
+
 void SkRecorder::forgetRecord() {
     fDrawableList.reset(NULL);
     fRecord = NULL;
@@ -57,7 +61,7 @@ void SkRecorder::forgetRecord() {
 // non-trivial copy constructors, we skip the first copy (and its destruction) by wrapping the value
 // with delay_copy(), forcing the argument to be passed by const&.
 //
-// This is used below for SkBitmap, SkPaint, SkPath, and SkRegion, which all have non-trivial copy
+// This is used below for SkBitmap, SkPath, and SkRegion, which all have non-trivial copy
 // constructors and destructors.  You'll know you've got a good candidate T if you see ~T() show up
 // unexpectedly on a profile of record time.  Otherwise don't bother.
 template <typename T>
@@ -72,6 +76,16 @@ private:
 template <typename T>
 static Reference<T> delay_copy(const T& x) { return Reference<T>(x); }
 
+// Returns a box holding a paint equal to paint, shared by every op recorded with that paint.
+// The table keeps a ref on each box, and the SkRecords::SharedPaint in each op takes another.
+SkRecords::PaintBox* SkRecorder::intern(const SkPaint& paint) {
+    SkRecords::PaintBox** box = fPaints.find(paint);
+    if (NULL == box) {
+        box = fPaints.set(SkNEW_ARGS(SkRecords::PaintBox, (paint)));
+    }
+    return *box;
+}
+
 // Use copy() only for optional arguments, to be copied if present or skipped if not.
 // (For most types we just pass by value and let copy constructors do their thing.)
 template <typename T>
@@ -117,30 +131,38 @@ char* SkRecorder::copy(const char* src) {
 
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, delay_copy(paint));
+    APPEND(DrawPaint, this->intern(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    APPEND(DrawPoints, delay_copy(paint), mode, SkToUInt(count), this->copy(pts, count));
+    APPEND(DrawPoints, this->intern(paint), mode, SkToUInt(count), this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
-    APPEND(DrawRect, delay_copy(paint), rect);
+    APPEND(DrawRect, this->intern(paint), rect);
+}
+
+void SkRecorder::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    // Recorded as individual DrawRect ops so the BBH sees each rect; SkRecordMergeDrawRects()
+    // batches them back up in bounded runs.
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, delay_copy(paint), oval);
+    APPEND(DrawOval, this->intern(paint), oval);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, delay_copy(paint), rrect);
+    APPEND(DrawRRect, this->intern(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, delay_copy(paint), outer, inner);
+    APPEND(DrawDRRect, this->intern(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable) {
@@ -152,7 +174,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable) {
 }
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
-    APPEND(DrawPath, delay_copy(paint), delay_copy(path));
+    APPEND(DrawPath, this->intern(paint), delay_copy(path));
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -202,14 +224,14 @@ void SkRecorder::onDrawSprite(const SkBitmap& bitmap, int left, int top, const S
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           delay_copy(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
+           this->intern(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           delay_copy(paint),
+           this->intern(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -219,7 +241,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           delay_copy(paint),
+           this->intern(paint),
            this->copy((const char*)text, byteLength),
            SkToUInt(byteLength),
            constY,
@@ -229,7 +251,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           delay_copy(paint),
+           this->intern(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            delay_copy(path),
@@ -238,7 +260,7 @@ void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkP
 
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
-    APPEND(DrawTextBlob, delay_copy(paint), blob, x, y);
+    APPEND(DrawTextBlob, this->intern(paint), blob, x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
@@ -250,7 +272,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
                                 const SkPoint texs[], const SkColor colors[],
                                 SkXfermode* xmode,
                                 const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, delay_copy(paint),
+    APPEND(DrawVertices, this->intern(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -263,7 +285,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    APPEND(DrawPatch, delay_copy(paint),
+    APPEND(DrawPatch, this->intern(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : NULL,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : NULL,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : NULL,
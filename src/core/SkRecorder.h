@@ -12,6 +12,7 @@
 #include "SkRecord.h"
 #include "SkRecords.h"
 #include "SkTDArray.h"
+#include "SkTHash.h"
 
 class SkBBHFactory;
 
@@ -38,6 +39,7 @@ public:
     // Does not take ownership of the SkRecord.
     SkRecorder(SkRecord*, int width, int height);   // legacy version
     SkRecorder(SkRecord*, const SkRect& bounds);
+    ~SkRecorder() override;
 
     SkDrawableList* getDrawableList() const { return fDrawableList.get(); }
     SkDrawableList* detachDrawableList() { return fDrawableList.detach(); }
@@ -85,6 +87,7 @@ public:
     void onDrawPaint(const SkPaint&) override;
     void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
     void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawOval(const SkRect&, const SkPaint&) override;
     void onDrawRRect(const SkRRect&, const SkPaint&) override;
     void onDrawPath(const SkPath&, const SkPaint&) override;
@@ -123,6 +126,8 @@ private:
     template <typename T>
     T* copy(const T[], size_t count);
 
+    SkRecords::PaintBox* intern(const SkPaint&);
+
     SkIRect devBounds() const {
         SkIRect devBounds;
         this->getClipDeviceBounds(&devBounds);
@@ -132,6 +137,13 @@ private:
     SkRecord* fRecord;
 
     SkAutoTDelete<SkDrawableList> fDrawableList;
+
+    // Every distinct paint recorded so far, for intern().
+    struct PaintBoxTraits {
+        static const SkPaint& GetKey(SkRecords::PaintBox* box) { return box->fPaint; }
+        static uint32_t Hash(const SkPaint& paint) { return paint.getHash(); }
+    };
+    SkTHashTable<SkRecords::PaintBox*, const SkPaint&, PaintBoxTraits> fPaints;
 };
 
 #endif//SkRecorder_DEFINED
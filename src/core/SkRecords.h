@@ -58,6 +58,7 @@ namespace SkRecords {
     M(DrawTextOnPath)                                               \
     M(DrawRRect)                                                    \
     M(DrawRect)                                                     \
+    M(DrawRects)                                                    \
     M(DrawSprite)                                                   \
     M(DrawTextBlob)                                                 \
     M(DrawVertices)
@@ -192,6 +193,7 @@ public:
 
     int width()  const { return fBitmap.width();  }
     int height() const { return fBitmap.height(); }
+    bool isOpaque() const { return fBitmap.isOpaque(); }
 
     // While the pixels are immutable, SkBitmap itself is not thread-safe, so return a copy.
     SkBitmap shallowCopy() const { return fBitmap; }
@@ -218,6 +220,42 @@ struct TypedMatrix : public SkMatrix {
     }
 };
 
+// SkRecorder interns the paints it records, so ops drawn with equal paints share one copy of the
+// paint and one ref on each of its effects.  A PaintBox is that shared copy...
+class PaintBox : public SkNVRefCnt<PaintBox> {
+public:
+    explicit PaintBox(const SkPaint& paint) : fPaint(paint) {}
+
+    SkPaint fPaint;
+};
+
+// ... and a SharedPaint is an op's ref on it, which acts like a const SkPaint.  A paint must not
+// change while it's shared, so writable() copies it first if need be.
+class SharedPaint : SkNoncopyable {
+public:
+    SharedPaint(const SkPaint& paint) : fBox(SkNEW_ARGS(PaintBox, (paint))) {}
+    SharedPaint(PaintBox* box) : fBox(SkRef(box)) {}
+    ~SharedPaint() { fBox->unref(); }
+
+    operator const SkPaint&() const { return fBox->fPaint; }
+    const SkPaint* operator->() const { return &fBox->fPaint; }
+    const SkPaint* get() const { return &fBox->fPaint; }
+
+    PaintBox* box() const { return fBox; }
+
+    SkPaint* writable() {
+        if (!fBox->unique()) {
+            PaintBox* copy = SkNEW_ARGS(PaintBox, (fBox->fPaint));
+            fBox->unref();
+            fBox = copy;
+        }
+        return &fBox->fPaint;
+    }
+
+private:
+    PaintBox* fBox;
+};
+
 RECORD0(NoOp);
 
 RECORD2(Restore, SkIRect, devBounds, TypedMatrix, matrix);
@@ -259,7 +297,7 @@ RECORD4(DrawBitmapRectToRectBleed, Optional<SkPaint>, paint,
                                    ImmutableBitmap, bitmap,
                                    Optional<SkRect>, src,
                                    SkRect, dst);
-RECORD3(DrawDRRect, SkPaint, paint, SkRRect, outer, SkRRect, inner);
+RECORD3(DrawDRRect, SharedPaint, paint, SkRRect, outer, SkRRect, inner);
 RECORD2(DrawDrawable, SkRect, worstCaseBounds, int32_t, index);
 RECORD4(DrawImage, Optional<SkPaint>, paint,
                    RefBox<const SkImage>, image,
@@ -269,41 +307,42 @@ RECORD4(DrawImageRect, Optional<SkPaint>, paint,
                        RefBox<const SkImage>, image,
                        Optional<SkRect>, src,
                        SkRect, dst);
-RECORD2(DrawOval, SkPaint, paint, SkRect, oval);
-RECORD1(DrawPaint, SkPaint, paint);
-RECORD2(DrawPath, SkPaint, paint, PreCachedPath, path);
+RECORD2(DrawOval, SharedPaint, paint, SkRect, oval);
+RECORD1(DrawPaint, SharedPaint, paint);
+RECORD2(DrawPath, SharedPaint, paint, PreCachedPath, path);
 RECORD3(DrawPicture, Optional<SkPaint>, paint,
                      RefBox<const SkPicture>, picture,
                      TypedMatrix, matrix);
-RECORD4(DrawPoints, SkPaint, paint, SkCanvas::PointMode, mode, unsigned, count, SkPoint*, pts);
-RECORD4(DrawPosText, SkPaint, paint,
+RECORD4(DrawPoints, SharedPaint, paint, SkCanvas::PointMode, mode, unsigned, count, SkPoint*, pts);
+RECORD4(DrawPosText, SharedPaint, paint,
                      PODArray<char>, text,
                      size_t, byteLength,
                      PODArray<SkPoint>, pos);
-RECORD5(DrawPosTextH, SkPaint, paint,
+RECORD5(DrawPosTextH, SharedPaint, paint,
                       PODArray<char>, text,
                       unsigned, byteLength,
                       SkScalar, y,
                       PODArray<SkScalar>, xpos);
-RECORD2(DrawRRect, SkPaint, paint, SkRRect, rrect);
-RECORD2(DrawRect, SkPaint, paint, SkRect, rect);
+RECORD2(DrawRRect, SharedPaint, paint, SkRRect, rrect);
+RECORD2(DrawRect, SharedPaint, paint, SkRect, rect);
+RECORD3(DrawRects, SharedPaint, paint, PODArray<SkRect>, rects, int, count);
 RECORD4(DrawSprite, Optional<SkPaint>, paint, ImmutableBitmap, bitmap, int, left, int, top);
-RECORD5(DrawText, SkPaint, paint,
+RECORD5(DrawText, SharedPaint, paint,
                   PODArray<char>, text,
                   size_t, byteLength,
                   SkScalar, x,
                   SkScalar, y);
-RECORD4(DrawTextBlob, SkPaint, paint,
+RECORD4(DrawTextBlob, SharedPaint, paint,
                       RefBox<const SkTextBlob>, blob,
                       SkScalar, x,
                       SkScalar, y);
-RECORD5(DrawTextOnPath, SkPaint, paint,
+RECORD5(DrawTextOnPath, SharedPaint, paint,
                         PODArray<char>, text,
                         size_t, byteLength,
                         PreCachedPath, path,
                         TypedMatrix, matrix);
 
-RECORD5(DrawPatch, SkPaint, paint,
+RECORD5(DrawPatch, SharedPaint, paint,
                    PODArray<SkPoint>, cubics,
                    PODArray<SkColor>, colors,
                    PODArray<SkPoint>, texCoords,
@@ -313,7 +352,7 @@ RECORD5(DrawPatch, SkPaint, paint,
 struct DrawVertices {
     static const Type kType = DrawVertices_Type;
 
-    DrawVertices(const SkPaint& paint,
+    DrawVertices(PaintBox* paint,
                  SkCanvas::VertexMode vmode,
                  int vertexCount,
                  SkPoint* vertices,
@@ -332,7 +371,7 @@ struct DrawVertices {
         , indices(indices)
         , indexCount(indexCount) {}
 
-    SkPaint paint;
+    SharedPaint paint;
     SkCanvas::VertexMode vmode;
     int vertexCount;
     PODArray<SkPoint> vertices;
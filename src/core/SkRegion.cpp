@@ -8,6 +8,9 @@
 
 
 #include "SkRegionPriv.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkThread.h"
 #include "SkUtils.h"
@@ -585,16 +588,89 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+struct RectTopLess {
+    bool operator()(const SkIRect* a, const SkIRect* b) const { return a->fTop < b->fTop; }
+};
+
+struct IntervalLess {
+    bool operator()(const SkIRect* a, const SkIRect* b) const { return a->fLeft < b->fLeft; }
+};
+} // namespace
+
+/*  Builds the runs directly with one sweep down the rects, rather than a union per rect,
+    which copies the whole region each time. Each span between consecutive tops and bottoms
+    gets the merged intervals of the rects crossing it, and a span with the same intervals as
+    the one above it just extends that one's bottom.
+ */
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    SkSTArray<16, const SkIRect*, true> sorted;
+    SkTDArray<RunType> ys;
+    for (int i = 0; i < count; i++) {
+        if (!rects[i].isEmpty()) {
+            sorted.push_back(&rects[i]);
+            *ys.append() = rects[i].fTop;
+            *ys.append() = rects[i].fBottom;
+        }
+    }
+    if (sorted.count() <= 1) {
+        return sorted.empty() ? this->setEmpty() : this->setRect(*sorted[0]);
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, RectTopLess());
+    SkTQSort(ys.begin(), ys.end() - 1);
+
+    SkTDArray<RunType> runs;
+    *runs.append() = ys[0];   // top
+    int prevStart = 0;          // index in runs of the previous span's first interval
+    int prevIntervals = -1;     // never matches a real span
+    SkTDArray<const SkIRect*> active;
+    int nextRect = 0;
+    for (int i = 0; i < ys.count() - 1; i++) {
+        int top = ys[i];
+        int bottom = ys[i + 1];
+        if (top == bottom) {
+            continue;
+        }
+        // drop the rects that ended above this span, and add the ones that start here
+        for (int j = active.count() - 1; j >= 0; j--) {
+            if (active[j]->fBottom <= top) {
+                active.removeShuffle(j);
+            }
+        }
+        for (; nextRect < sorted.count() && sorted[nextRect]->fTop <= top; nextRect++) {
+            *active.append() = sorted[nextRect];
+        }
+        if (active.count() > 1) {
+            SkTQSort(active.begin(), active.end() - 1, IntervalLess());
+        }
+
+        // write the bottom and a slot for the interval count, then the merged intervals
+        int start = runs.count() + 2;
+        runs.append(2);
+        for (int j = 0; j < active.count(); j++) {
+            const SkIRect* r = active[j];
+            if (runs.count() > start && r->fLeft <= runs.top()) {
+                runs.top() = SkMax32(runs.top(), r->fRight);
+            } else {
+                *runs.append() = r->fLeft;
+                *runs.append() = r->fRight;
+            }
+        }
+        int intervals = (runs.count() - start) >> 1;
+        if (intervals == prevIntervals && !memcmp(&runs[prevStart], &runs[start],
+                                                  intervals * 2 * sizeof(RunType))) {
+            runs.setCount(start - 2);
+            runs[prevStart - 2] = bottom;
+        } else {
+            runs[start - 2] = bottom;
+            runs[start - 1] = intervals;
+            *runs.append() = kRunTypeSentinel;
+            prevStart = start;
+            prevIntervals = intervals;
         }
     }
-    return !this->isEmpty();
+    *runs.append() = kRunTypeSentinel;
+    return this->setRuns(runs.begin(), runs.count());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,9 @@
 #include "SkMipMap.h"
 #include "SkPixelRef.h"
 #include "SkResourceCache.h"
+#include "SkString.h"
+#include "SkTraceEvent.h"
+#include "SkTraceMemoryDump.h"
 
 #include <stddef.h>
 
@@ -62,6 +65,11 @@ void SkResourceCache::init() {
     fHash = new Hash;
     fTotalBytesUsed = 0;
     fCount = 0;
+    fPinnedCount = 0;
+    fPinnedBytes = 0;
+    fHitCount = 0;
+    fMissCount = 0;
+    fPurgeCount = 0;
     fSingleAllocationByteLimit = 0;
     fAllocator = NULL;
 
@@ -213,15 +221,48 @@ bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     if (rec) {
         if (visitor(*rec, context)) {
             this->moveToHead(rec);  // for our LRU
+            fHitCount += 1;
             return true;
         } else {
             this->remove(rec);  // stale
+            fMissCount += 1;
             return false;
         }
     }
+    fMissCount += 1;
     return false;
 }
 
+bool SkResourceCache::pin(const Key& key) {
+    this->checkMessages();
+
+    Rec* rec = fHash->find(key);
+    if (NULL == rec) {
+        return false;
+    }
+    if (0 == rec->fPinCount++) {
+        fPinnedCount += 1;
+        fPinnedBytes += rec->bytesUsed();
+    }
+    return true;
+}
+
+bool SkResourceCache::unpin(const Key& key) {
+    this->checkMessages();
+
+    Rec* rec = fHash->find(key);
+    if (NULL == rec || 0 == rec->fPinCount) {
+        return false;
+    }
+    if (0 == --rec->fPinCount) {
+        fPinnedCount -= 1;
+        fPinnedBytes -= rec->bytesUsed();
+        // It may have been keeping us over budget.
+        this->purgeAsNeeded();
+    }
+    return true;
+}
+
 static void make_size_str(size_t size, SkString* str) {
     const char suffix[] = { 'b', 'k', 'm', 'g', 't', 0 };
     int i = 0;
@@ -269,6 +310,10 @@ void SkResourceCache::remove(Rec* rec) {
 
     fTotalBytesUsed -= used;
     fCount -= 1;
+    if (rec->fPinCount) {
+        fPinnedCount -= 1;
+        fPinnedBytes -= used;
+    }
 
     if (gDumpCacheTransactions) {
         SkString bytesStr, totalStr;
@@ -292,6 +337,10 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         countLimit = SK_MaxS32; // no limit based on count
         byteLimit = fTotalByteLimit;
     }
+    if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        return;
+    }
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia"), "SkResourceCache::purgeAsNeeded");
 
     Rec* rec = fTail;
     while (rec) {
@@ -300,7 +349,10 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         }
 
         Rec* prev = rec->fPrev;
-        this->remove(rec);
+        if (0 == rec->fPinCount) {
+            this->remove(rec);
+            fPurgeCount += 1;
+        }
         rec = prev;
     }
 }
@@ -458,6 +510,17 @@ void SkResourceCache::validate() const {
     }
     SkASSERT(fCount == count);
 
+    int pinnedCount = 0;
+    size_t pinnedBytes = 0;
+    for (rec = fHead; rec; rec = rec->fNext) {
+        if (rec->fPinCount) {
+            pinnedCount += 1;
+            pinnedBytes += rec->bytesUsed();
+        }
+    }
+    SkASSERT(fPinnedCount == pinnedCount);
+    SkASSERT(fPinnedBytes == pinnedBytes);
+
     rec = fTail;
     while (rec) {
         SkASSERT(count > 0);
@@ -472,11 +535,49 @@ void SkResourceCache::validate() const {
 }
 #endif
 
+void SkResourceCache::getStats(Stats* stats) const {
+    stats->fCount = fCount;
+    stats->fBytesUsed = fTotalBytesUsed;
+    stats->fPinnedCount = fPinnedCount;
+    stats->fPinnedBytes = fPinnedBytes;
+    stats->fHits = fHitCount;
+    stats->fMisses = fMissCount;
+    stats->fPurges = fPurgeCount;
+}
+
+void SkResourceCache::addCategoryStats(SkTDArray<CategoryStats>* stats) const {
+    for (const Rec* rec = fHead; rec; rec = rec->fNext) {
+        const char* category = rec->getCategory();
+        CategoryStats* entry = NULL;
+        for (int i = 0; i < stats->count(); ++i) {
+            if (0 == strcmp((*stats)[i].fCategory, category)) {
+                entry = &(*stats)[i];
+                break;
+            }
+        }
+        if (NULL == entry) {
+            entry = stats->append();
+            entry->fCategory = category;
+            entry->fCount = 0;
+            entry->fBytes = 0;
+            entry->fPurgeableBytes = 0;
+        }
+        const size_t bytes = rec->bytesUsed();
+        entry->fCount += 1;
+        entry->fBytes += bytes;
+        if (0 == rec->fPinCount) {
+            entry->fPurgeableBytes += bytes;
+        }
+    }
+}
+
 void SkResourceCache::dump() const {
     this->validate();
 
     SkDebugf("SkResourceCache: count=%d bytes=%d %s\n",
              fCount, fTotalBytesUsed, fDiscardableFactory ? "discardable" : "malloc");
+    SkDebugf("    pinned=%d pinnedBytes=%zu hits=%d misses=%d purges=%d\n",
+             fPinnedCount, fPinnedBytes, fHitCount, fMissCount, fPurgeCount);
 }
 
 size_t SkResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
@@ -517,96 +618,199 @@ void SkResourceCache::checkMessages() {
 
 #include "SkThread.h"
 
+// The global cache is split into this many shards, each with its own lock and an even share of
+// the budget, so threads looking up different keys usually don't wait on each other. Each key
+// always lands in the same shard. A rec too big for one shard's share can't be cached, so
+// clients with small budgets should stick with one shard; GetEffectiveSingleAllocationByteLimit()
+// reports the per-shard limit.
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT   1
+#endif
+
+namespace {
+
+struct Shard {
+    Shard() : fCache(NULL) {}
+    ~Shard() { SkDELETE(fCache); }
+
+    SkMutex          fMutex;
+    SkResourceCache* fCache;
+};
+
+struct ShardSet {
+    static const int kCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+    SK_COMPILE_ASSERT(kCount > 0, need_at_least_one_shard);
+
+    ShardSet() {
+        for (int i = 0; i < kCount; ++i) {
+#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
+            fShards[i].fCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
+#else
+            fShards[i].fCache = SkNEW_ARGS(SkResourceCache,
+                                           (ShareOf(SK_DEFAULT_IMAGE_CACHE_LIMIT, i)));
+#endif
+        }
+    }
+
+    // Splits bytes between the shards, with any remainder going to the first.
+    static size_t ShareOf(size_t bytes, int index) {
+        return bytes / kCount + (0 == index ? bytes % kCount : 0);
+    }
+
+    Shard& shardFor(const SkResourceCache::Key& key) {
+        // SkTDynamicHash picks buckets with the low bits of the hash, so pick shards with the rest.
+        return fShards[kCount > 1 ? SkChecksum::Mix(key.hash()) % kCount : 0];
+    }
+
+    Shard fShards[kCount];
+};
+
+}  // namespace
+
 SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = NULL;
-static void cleanup_gResourceCache() {
+static ShardSet* gShards = NULL;
+static void cleanup_gShards() {
     // We'll clean this up in our own tests, but disable for clients.
     // Chrome seems to have funky multi-process things going on in unit tests that
     // makes this unsafe to delete when the main process atexit()s.
     // SkLazyPtr does the same sort of thing.
 #if SK_DEVELOPER
-    SkDELETE(gResourceCache);
+    SkDELETE(gShards);
 #endif
 }
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (NULL == gResourceCache) {
-#ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
-#else
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SK_DEFAULT_IMAGE_CACHE_LIMIT));
-#endif
-        atexit(cleanup_gResourceCache);
+static ShardSet* get_shards() {
+    ShardSet* shards = sk_acquire_load(&gShards);
+    if (NULL == shards) {
+        SkAutoMutexAcquire am(gMutex);
+        shards = gShards;
+        if (NULL == shards) {
+            shards = SkNEW(ShardSet);
+            atexit(cleanup_gShards);
+            sk_release_store(&gShards, shards);
+        }
     }
-    return gResourceCache;
+    return shards;
 }
 
+// Holds one shard's lock, and gives access to its cache.
+class AutoShard : SkNoncopyable {
+public:
+    explicit AutoShard(Shard& shard) : fShard(shard) { fShard.fMutex.acquire(); }
+    ~AutoShard() { fShard.fMutex.release(); }
+
+    SkResourceCache* operator->() const { return fShard.fCache; }
+
+private:
+    Shard& fShard;
+};
+
+// For settings that every shard shares; answers come from the first shard.
+static Shard& first_shard() { return get_shards()->fShards[0]; }
+
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    ShardSet* shards = get_shards();
+    size_t used = 0;
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        used += AutoShard(shards->fShards[i])->getTotalBytesUsed();
+    }
+    return used;
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    ShardSet* shards = get_shards();
+    size_t limit = 0;
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        limit += AutoShard(shards->fShards[i])->getTotalByteLimit();
+    }
+    return limit;
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    ShardSet* shards = get_shards();
+    size_t prevLimit = 0;
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        prevLimit += AutoShard(shards->fShards[i])->setTotalByteLimit(
+                ShardSet::ShareOf(newLimit, i));
+    }
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    return AutoShard(first_shard())->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->allocator();
+    return AutoShard(first_shard())->allocator();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return AutoShard(first_shard())->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    ShardSet* shards = get_shards();
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        AutoShard(shards->fShards[i])->dump();
+    }
+}
+
+void SkResourceCache::DumpCategoryStats(const char* dumpPrefix,
+                                        const SkTDArray<CategoryStats>& stats,
+                                        SkTraceMemoryDump* dump) {
+    for (int i = 0; i < stats.count(); ++i) {
+        SkString dumpName;
+        dumpName.printf("%s/%s", dumpPrefix, stats[i].fCategory);
+        dump->dumpNumericValue(dumpName.c_str(), "size", "bytes", stats[i].fBytes);
+        dump->dumpNumericValue(dumpName.c_str(), "purgeable_size", "bytes",
+                               stats[i].fPurgeableBytes);
+        dump->dumpNumericValue(dumpName.c_str(), "count", "objects", stats[i].fCount);
+    }
+}
+
+void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char kDumpName[] = "skia/sk_resource_cache";
+    SkTDArray<CategoryStats> stats;
+    ShardSet* shards = get_shards();
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        AutoShard(shards->fShards[i])->addCategoryStats(&stats);
+    }
+    dump->dumpNumericValue(kDumpName, "limit", "bytes", GetTotalByteLimit());
+    DumpCategoryStats(kDumpName, stats, dump);
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    ShardSet* shards = get_shards();
+    size_t prevLimit = 0;
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        prevLimit = AutoShard(shards->fShards[i])->setSingleAllocationByteLimit(size);
+    }
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return AutoShard(first_shard())->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    // The first shard has the largest share of the budget, so this is a little generous for
+    // the others when the budget doesn't divide evenly.
+    return AutoShard(first_shard())->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    ShardSet* shards = get_shards();
+    for (int i = 0; i < ShardSet::kCount; ++i) {
+        AutoShard(shards->fShards[i])->purgeAll();
+    }
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    return AutoShard(get_shards()->shardFor(key))->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec);
+    AutoShard(get_shards()->shardFor(rec->getKey()))->add(rec);
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -617,6 +821,7 @@ void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "SkDecodedImageCache.h"
 #include "SkGraphics.h"
 
 size_t SkGraphics::GetResourceCacheTotalBytesUsed() {
@@ -640,6 +845,7 @@ size_t SkGraphics::SetResourceCacheSingleAllocationByteLimit(size_t newLimit) {
 }
 
 void SkGraphics::PurgeResourceCache() {
+    SkDecodedImageCache::PurgeAll();
     return SkResourceCache::PurgeAll();
 }
 
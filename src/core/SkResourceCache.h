@@ -15,6 +15,7 @@
 class SkCachedData;
 class SkDiscardableMemory;
 class SkMipMap;
+class SkTraceMemoryDump;
 
 /**
  *  Cache object for bitmaps (with possible scale in X Y as part of the key).
@@ -25,6 +26,9 @@ class SkMipMap;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  If SK_RESOURCE_CACHE_SHARD_COUNT is defined, the global instance is split into
+ *  that many independently locked shards by key hash, each with an even share of
+ *  the byte limit.
  */
 class SkResourceCache {
 public:
@@ -70,7 +74,7 @@ public:
     struct Rec {
         typedef SkResourceCache::Key Key;
 
-        Rec() {}
+        Rec() : fPinCount(0) {}
         virtual ~Rec() {}
 
         uint32_t getHash() const { return this->getKey().hash(); }
@@ -78,6 +82,9 @@ public:
         virtual const Key& getKey() const = 0;
         virtual size_t bytesUsed() const = 0;
 
+        // Names the kind of Rec in memory dumps, e.g. "bitmap". Must be a string literal.
+        virtual const char* getCategory() const = 0;
+
         // for SkTDynamicHash::Traits
         static uint32_t Hash(const Key& key) { return key.hash(); }
         static const Key& GetKey(const Rec& rec) { return rec.getKey(); }
@@ -85,6 +92,7 @@ public:
     private:
         Rec*    fNext;
         Rec*    fPrev;
+        int32_t fPinCount;  // Pinned recs are never purged to fit the budget.
 
         friend class SkResourceCache;
     };
@@ -98,6 +106,24 @@ public:
 
     typedef const Rec* ID;
 
+    struct Stats {
+        int     fCount;
+        size_t  fBytesUsed;
+        int     fPinnedCount;
+        size_t  fPinnedBytes;
+        int     fHits;      // find() calls that returned true
+        int     fMisses;    // find() calls that returned false
+        int     fPurges;    // recs removed to stay within the budget
+    };
+
+    // Memory held by the Recs of one category, for memory dumps.
+    struct CategoryStats {
+        const char* fCategory;
+        int         fCount;
+        size_t      fBytes;
+        size_t      fPurgeableBytes;    // in unpinned Recs
+    };
+
     /**
      *  Callback function for find(). If called, the cache will have found a match for the
      *  specified Key, and will pass in the corresponding Rec, along with a caller-specified
@@ -163,6 +189,18 @@ public:
      */
     static void Dump();
 
+    /**
+     *  Reports the global cache's limit, and the memory held by each category of Rec, under
+     *  "skia/sk_resource_cache".
+     */
+    static void DumpMemoryStatistics(SkTraceMemoryDump*);
+
+    /**
+     *  Reports stats under dumpPrefix, one dump per category: "<dumpPrefix>/<category>".
+     */
+    static void DumpCategoryStats(const char* dumpPrefix, const SkTDArray<CategoryStats>& stats,
+                                  SkTraceMemoryDump*);
+
     ///////////////////////////////////////////////////////////////////////////
 
     /**
@@ -195,6 +233,15 @@ public:
     bool find(const Key&, FindVisitor, void* context);
     void add(Rec*);
 
+    /**
+     *  Pins the Rec matching the Key, so it is kept however far over budget the cache goes (and
+     *  through purgeAll()), until a matching call to unpin(). Pins nest. Pinned Recs still count
+     *  against the budget, so the unpinned ones are purged first. purgeSharedID() still removes
+     *  them, since their contents are stale. Returns false if there is no matching Rec.
+     */
+    bool pin(const Key&);
+    bool unpin(const Key&);
+
     size_t getTotalBytesUsed() const { return fTotalBytesUsed; }
     size_t getTotalByteLimit() const { return fTotalByteLimit; }
 
@@ -227,6 +274,14 @@ public:
 
     SkCachedData* newCachedData(size_t bytes);
 
+    void getStats(Stats*) const;
+
+    /**
+     *  Adds this cache's Recs to stats, merging them into the entries already there for
+     *  their category.
+     */
+    void addCategoryStats(SkTDArray<CategoryStats>* stats) const;
+
     /**
      *  Call SkDebugf() with diagnostic information about the state of the cache
      */
@@ -247,6 +302,11 @@ private:
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
+    int     fPinnedCount;
+    size_t  fPinnedBytes;
+    int     fHitCount;
+    int     fMissCount;
+    int     fPurgeCount;
 
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
@@ -22,6 +22,7 @@
 #include "SkRasterClip.h"
 #include "SkStroke.h"
 #include "SkThread.h"
+#include "SkTraceEvent.h"
 
 #define ComputeBWRowBytes(width)        (((unsigned)(width) + 7) >> 3)
 
@@ -468,6 +469,7 @@ static void extract_alpha(const SkMask& dst,
 }
 
 void SkScalerContext::getImage(const SkGlyph& origGlyph) {
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia"), "SkScalerContext::getImage");
     const SkGlyph*  glyph = &origGlyph;
     SkGlyph         tmpGlyph;
 
@@ -22,6 +22,11 @@ class SkPath;
 */
 typedef SkIRect SkXRect;
 
+/** When true, AntiFillPath() computes exact per-pixel area coverage instead of supersampling
+    (for non-inverse fills). This may be toggled at runtime, between draws.
+*/
+extern bool gSkUseAnalyticAA;
+
 class SkScan {
 public:
     static void FillPath(const SkPath&, const SkIRect&, SkBlitter*);
@@ -50,6 +55,19 @@ public:
     static void HairPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiHairPath(const SkPath&, const SkRasterClip&, SkBlitter*);
 
+    /** Anti-aliased strokes of a few pixels wide, blitted without building the stroked outline.
+        The path (in device space) must contain only lines; joins are round, and caps are round
+        or butt. See SkScan_ThinStroke.cpp.
+     */
+    static void AntiThinStrokePath(const SkPath&, SkScalar width, bool roundCaps,
+                                   const SkRasterClip&, SkBlitter*);
+    /** As above, stroking each segment of pts independently, with caps at both of its ends.
+        If connected, the segments are pts[i]..pts[i+1] for every i, otherwise they are pairs.
+     */
+    static void AntiThinStrokeSegments(const SkPoint pts[], int count, bool connected,
+                                       SkScalar width, bool roundCaps,
+                                       const SkRasterClip&, SkBlitter*);
+
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -33,6 +33,10 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   const SkRegion& clipRgn);
 
+// Anti-aliased fill using exact per-pixel area coverage rather than supersampling. Only blits
+// within bounds, and doesn't handle inverse fills. See SkScan_AnalyticPath.cpp.
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter);
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
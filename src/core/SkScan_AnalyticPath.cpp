@@ -0,0 +1,428 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkBlitter.h"
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/** @file
+    An anti-aliased path filler that computes the exact area covered in each pixel, instead of
+    supersampling.
+
+    The path is flattened into lines (in destination coordinates). Each line deposits, into a
+    per-row accumulation buffer, the signed area it sweeps to its right within every pixel it
+    crosses (the "signed-area accumulation" technique used by font rasterizers). A prefix sum
+    along the row then yields the winding-weighted coverage of every pixel.
+
+    Coverage is exact wherever the path does not overlap itself inside a pixel; where it does,
+    coverage is clamped (winding) or folded (even-odd), as in most accumulation rasterizers.
+ */
+
+bool gSkUseAnalyticAA = false;
+
+// Curves are flattened until they are within this distance (in pixels) of their chords.
+static const SkScalar kFlattenTolerance = SK_Scalar1 / 8;
+static const int kMaxCurveLines = 256;
+
+namespace {
+
+struct AnalyticLine {
+    SkScalar fX0, fY0;  // x is relative to the left of the bounds; fY0 < fY1
+    SkScalar fY1;
+    SkScalar fDXDY;
+    SkScalar fDir;      // +1 if the original line went down, -1 if it went up
+
+    bool operator<(const AnalyticLine& other) const { return fY0 < other.fY0; }
+};
+
+class LineBuilder {
+public:
+    LineBuilder(const SkIRect& bounds)
+        : fLeft(SkIntToScalar(bounds.fLeft))
+        , fRight(SkIntToScalar(bounds.width()))
+        , fTop(SkIntToScalar(bounds.fTop))
+        , fBottom(SkIntToScalar(bounds.fBottom)) {}
+
+    void build(const SkPath& path) {
+        SkPath::Iter iter(path, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kLine_Verb:
+                    this->addLine(pts[0], pts[1]);
+                    break;
+                case SkPath::kQuad_Verb:
+                    this->addQuad(pts);
+                    break;
+                case SkPath::kConic_Verb: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                                  kFlattenTolerance);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->addQuad(&quadPts[2 * i]);
+                    }
+                    break;
+                }
+                case SkPath::kCubic_Verb:
+                    this->addCubic(pts);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    SkTDArray<AnalyticLine>& lines() { return fLines; }
+
+private:
+    static int CurveLineCount(SkScalar deviation) {
+        // deviation is an upper bound on |B''| / 8 for the curve; with n equal steps in t,
+        // the chords stray at most deviation / n^2 from the curve.
+        SkScalar n = SkScalarSqrt(deviation / kFlattenTolerance);
+        return SkPin32(SkScalarCeilToInt(n), 1, kMaxCurveLines);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+        int n = CurveLineCount(dd.length() / 4);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next;
+            SkEvalQuadAt(pts, SkIntToScalar(i) / n, &next);
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2];
+        SkVector dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+        int n = CurveLineCount(SkMaxScalar(dd0.length(), dd1.length()) * 3 / 4);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next;
+            SkEvalCubicAt(pts, SkIntToScalar(i) / n, &next, NULL, NULL);
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        if (SkTMax(p0.fY, p1.fY) <= fTop || SkTMin(p0.fY, p1.fY) >= fBottom) {
+            return;     // can't contribute to any row we'll scan
+        }
+        this->addClampedLine(p0.fX - fLeft, p0.fY, p1.fX - fLeft, p1.fY);
+    }
+
+    // Anything left of the bounds still contributes its winding to every pixel to its right,
+    // so rather than clipping lines horizontally we split them at the bounds, and pin the
+    // parts outside onto the bounds' edges.
+    void addClampedLine(SkScalar x0, SkScalar y0, SkScalar x1, SkScalar y1) {
+        if (y0 == y1) {
+            return;     // horizontal lines don't cover anything
+        }
+        const SkScalar edges[] = { 0, fRight };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(edges); ++i) {
+            const SkScalar e = edges[i];
+            if ((x0 < e && x1 > e) || (x0 > e && x1 < e)) {
+                SkScalar y = y0 + (e - x0) * (y1 - y0) / (x1 - x0);
+                this->addClampedLine(x0, y0, e, y);
+                this->addClampedLine(e, y, x1, y1);
+                return;
+            }
+        }
+
+        AnalyticLine* line = fLines.append();
+        line->fDir = SK_Scalar1;
+        if (y0 > y1) {
+            SkTSwap(x0, x1);
+            SkTSwap(y0, y1);
+            line->fDir = -SK_Scalar1;
+        }
+        x0 = SkScalarPin(x0, 0, fRight);
+        x1 = SkScalarPin(x1, 0, fRight);
+        line->fX0 = x0;
+        line->fY0 = y0;
+        line->fY1 = y1;
+        line->fDXDY = (x1 - x0) / (y1 - y0);
+    }
+
+    const SkScalar fLeft, fRight, fTop, fBottom;
+    SkTDArray<AnalyticLine> fLines;
+};
+
+/// Accumulates the signed area swept by lines across one row of pixels, then resolves it into
+/// coverage and blits the row.
+///
+/// The row is divided into cells of kCellWidth pixels, and only the cells that lines touched are
+/// visited when resolving. Between dirty cells the running sum is constant, so those stretches
+/// become a single run (usually of zero or full coverage) without reading the buffer. Long, thin
+/// geometry on a wide row therefore costs in proportion to the pixels its edges cross.
+class RowAccumulator {
+public:
+    RowAccumulator(SkBlitter* blitter, int left, int width, bool evenOdd)
+        : fBlitter(blitter)
+        , fLeft(left)
+        , fWidth(width)
+        , fEvenOdd(evenOdd)
+        , fAccum(width + 2)
+        , fAlpha(width + 1)
+        , fRuns(width + 1)
+        , fCellIsDirty(CellCount(width)) {
+        sk_bzero(fAccum.get(), (width + 2) * sizeof(SkScalar));
+        sk_bzero(fCellIsDirty.get(), CellCount(width) * sizeof(bool));
+    }
+
+    /// Add the part of line that lies within [rowTop, rowTop + 1).
+    void accumulate(const AnalyticLine& line, SkScalar rowTop) {
+        const SkScalar ya = SkTMax(line.fY0, rowTop);
+        const SkScalar yb = SkTMin(line.fY1, rowTop + SK_Scalar1);
+        if (yb <= ya) {
+            return;
+        }
+        const SkScalar right = SkIntToScalar(fWidth);
+        SkScalar xa = SkScalarPin(line.fX0 + (ya - line.fY0) * line.fDXDY, 0, right);
+        SkScalar xb = SkScalarPin(line.fX0 + (yb - line.fY0) * line.fDXDY, 0, right);
+        const SkScalar d = (yb - ya) * line.fDir;
+        SkScalar* acc = fAccum.get();
+
+        if (xa > xb) {
+            SkTSwap(xa, xb);
+        }
+        const SkScalar xaFloor = SkScalarFloorToScalar(xa);
+        const int xai = (int)xaFloor;
+        const int xbi = SkScalarCeilToInt(xb);
+
+        if (xbi <= xai + 1) {
+            // The line stays within one column: split d by how far across the column it sits.
+            const SkScalar xmf = SkScalarHalf(xa + xb) - xaFloor;
+            acc[xai]     += d - d * xmf;
+            acc[xai + 1] += d * xmf;
+        } else {
+            // Spread d over the columns the line crosses, in proportion to the area it sweeps.
+            const SkScalar s = SkScalarInvert(xb - xa);
+            const SkScalar xaf = xa - xaFloor;
+            const SkScalar a0 = SkScalarHalf(s * (1 - xaf) * (1 - xaf));
+            const SkScalar xbf = xb - SkIntToScalar(xbi) + 1;
+            const SkScalar am = SkScalarHalf(s * xbf * xbf);
+            acc[xai] += d * a0;
+            if (xbi == xai + 2) {
+                acc[xai + 1] += d * (1 - a0 - am);
+            } else {
+                const SkScalar a1 = s * (1.5f - xaf);
+                acc[xai + 1] += d * (a1 - a0);
+                for (int x = xai + 2; x < xbi - 1; ++x) {
+                    acc[x] += d * s;
+                }
+                const SkScalar a2 = a1 + (xbi - xai - 3) * s;
+                acc[xbi - 1] += d * (1 - a2 - am);
+            }
+            acc[xbi] += d * am;
+        }
+        this->markDirty(xai, SkTMax(xai + 1, xbi));
+    }
+
+    /// Resolve the accumulated row into coverage, blit it as row y, and reset for the next row.
+    void flush(int y) {
+        if (fDirtyCells.isEmpty()) {
+            return;
+        }
+        SkTQSort(fDirtyCells.begin(), fDirtyCells.end() - 1);
+
+        SkScalar* acc = fAccum.get();
+        SkAlpha* alpha = fAlpha.get();
+        fFirst = -1;
+        fLast = 0;
+        fRunX = fPendingEnd = 0;
+        fRunAlpha = 0;
+
+        SkScalar sum = 0;
+        int x = 0;
+        for (int i = 0; i < fDirtyCells.count(); ++i) {
+            const int cell = fDirtyCells[i];
+            fCellIsDirty[cell] = false;
+
+            const int cellLeft = cell << kCellShift;
+            const int cellRight = SkTMin(cellLeft + kCellWidth, fWidth);
+            if (cellLeft >= fWidth) {
+                continue;   // only the accumulator's guard slots, right of the bounds
+            }
+            // Nothing changes the sum between dirty cells.
+            if (x < cellLeft) {
+                this->appendRun(x, cellLeft - x, this->coverageToAlpha(sum));
+            }
+            for (x = cellLeft; x < cellRight; ++x) {
+                sum += acc[x];
+                acc[x] = 0;
+                alpha[x] = this->coverageToAlpha(sum);
+                this->appendRun(x, 1, alpha[x]);
+            }
+        }
+        // Lines may deposit just past the last pixel; that never affects the row.
+        acc[fWidth] = acc[fWidth + 1] = 0;
+        fDirtyCells.rewind();
+
+        // Closed paths return to zero coverage by the end of the row, so trailing runs are
+        // transparent; end the row at the last covered pixel.
+        this->closeRun();
+        if (fFirst < 0) {
+            return;
+        }
+        fRuns[fLast] = 0;
+        fBlitter->blitAntiH(fLeft + fFirst, y, &alpha[fFirst], &fRuns[fFirst]);
+    }
+
+private:
+    static const int kCellShift = 5;
+    static const int kCellWidth = 1 << kCellShift;
+
+    // Enough cells to cover every slot of the accumulator, including its two guard slots.
+    static int CellCount(int width) { return ((width + 1) >> kCellShift) + 1; }
+
+    // Note that the accumulator was written at [left, right] (inclusive).
+    void markDirty(int left, int right) {
+        for (int cell = left >> kCellShift; cell <= (right >> kCellShift); ++cell) {
+            if (!fCellIsDirty[cell]) {
+                fCellIsDirty[cell] = true;
+                *fDirtyCells.append() = cell;
+            }
+        }
+    }
+
+    // Runs are built as SkAlphaRuns expects them: fRuns[x] is the length of the run starting at
+    // x, and fAlpha[x] its alpha. Neighbouring pixels with the same alpha share a run.
+    void appendRun(int x, int n, SkAlpha a) {
+        SkASSERT(x == fPendingEnd);
+        if (a == fRunAlpha) {
+            fPendingEnd += n;
+            return;
+        }
+        this->closeRun();
+        fRunX = x;
+        fPendingEnd = x + n;
+        fRunAlpha = a;
+    }
+
+    void closeRun() {
+        if (fPendingEnd == fRunX || 0 == fRunAlpha) {
+            return;     // transparent runs are only written once something follows them
+        }
+        if (fFirst < 0) {
+            fFirst = fRunX;
+        } else if (fLast < fRunX) {
+            this->writeRuns(fLast, fRunX - fLast, 0);
+        }
+        this->writeRuns(fRunX, fPendingEnd - fRunX, fRunAlpha);
+        fLast = fPendingEnd;
+    }
+
+    // Runs are int16_t, so very wide stretches are split.
+    void writeRuns(int x, int n, SkAlpha a) {
+        while (n > 0) {
+            int count = SkTMin(n, (int)SK_MaxS16);
+            fRuns[x] = SkToS16(count);
+            fAlpha[x] = a;
+            x += count;
+            n -= count;
+        }
+    }
+
+    SkAlpha coverageToAlpha(SkScalar sum) const {
+        SkScalar coverage = SkScalarAbs(sum);
+        if (fEvenOdd) {
+            coverage -= 2 * SkScalarFloorToScalar(coverage * SK_ScalarHalf);
+            if (coverage > SK_Scalar1) {
+                coverage = 2 - coverage;
+            }
+        }
+        if (coverage >= SK_Scalar1) {
+            return 0xFF;
+        }
+        return SkToU8((int)(coverage * 255 + SK_ScalarHalf));
+    }
+
+    SkBlitter*  fBlitter;
+    const int   fLeft;
+    const int   fWidth;
+    const bool  fEvenOdd;
+
+    // The run being built by appendRun(), covering [fRunX, fPendingEnd), and the extent of
+    // the covered runs written so far, [fFirst, fLast). fFirst is -1 until a run is written.
+    int         fRunX, fPendingEnd;
+    SkAlpha     fRunAlpha;
+    int         fFirst, fLast;
+
+    SkAutoSTMalloc<256, SkScalar> fAccum;
+    SkAutoSTMalloc<256, SkAlpha>  fAlpha;
+    SkAutoSTMalloc<256, int16_t>  fRuns;
+    SkAutoSTMalloc<16, bool>      fCellIsDirty;
+    SkTDArray<int>                fDirtyCells;
+};
+
+}  // namespace
+
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter) {
+    SkASSERT(!path.isInverseFillType());
+    if (bounds.isEmpty()) {
+        return;
+    }
+
+    LineBuilder builder(bounds);
+    builder.build(path);
+    SkTDArray<AnalyticLine>& lines = builder.lines();
+    if (lines.isEmpty()) {
+        return;
+    }
+    SkTQSort(lines.begin(), lines.end() - 1);
+
+    const bool evenOdd = SkPath::kEvenOdd_FillType == path.getFillType();
+    RowAccumulator row(blitter, bounds.fLeft, bounds.width(), evenOdd);
+    SkTDArray<const AnalyticLine*> active;
+
+    int next = 0;
+    int y = bounds.fTop;
+    while (y < bounds.fBottom) {
+        if (active.isEmpty()) {
+            if (next == lines.count()) {
+                break;
+            }
+            // Skip straight to the first row touched by the next line.
+            y = SkTMax(y, SkScalarFloorToInt(lines[next].fY0));
+            if (y >= bounds.fBottom) {
+                break;
+            }
+        }
+
+        const SkScalar rowTop = SkIntToScalar(y);
+        const SkScalar rowBottom = rowTop + SK_Scalar1;
+        while (next < lines.count() && lines[next].fY0 < rowBottom) {
+            if (lines[next].fY1 > rowTop) {
+                *active.append() = &lines[next];
+            }
+            ++next;
+        }
+
+        for (int i = 0; i < active.count(); ) {
+            const AnalyticLine* line = active[i];
+            row.accumulate(*line, rowTop);
+            if (line->fY1 <= rowBottom) {
+                active.removeShuffle(i);    // done after this row
+            } else {
+                ++i;
+            }
+        }
+        row.flush(y);
+        ++y;
+    }
+}
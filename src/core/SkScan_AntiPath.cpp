@@ -13,6 +13,7 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 #include "SkAntiRun.h"
+#include "SkTraceEvent.h"
 
 #define SHIFT   2
 #define SCALE   (1 << SHIFT)
@@ -628,6 +629,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     if (origClip.isEmpty()) {
         return;
     }
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia"), "SkScan::AntiFillPath");
 
     const bool isInverse = path.isInverseFillType();
     SkIRect ir;
@@ -700,6 +702,14 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
+    if (gSkUseAnalyticAA && !isInverse && !forceRLE) {
+        SkIRect bounds = ir;
+        if (bounds.intersect(clipRgn->getBounds())) {
+            sk_analytic_fill_path(path, bounds, blitter);
+        }
+        return;
+    }
+
     SkIRect superRect, *superClipRect = NULL;
 
     if (clipRect) {
@@ -10,12 +10,14 @@
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
 #include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkTemplates.h"
 #include "SkTSort.h"
+#include "SkTraceEvent.h"
 
 #define kEDGE_HEAD_Y    SK_MinS32
 #define kEDGE_TAIL_Y    SK_MaxS32
@@ -299,6 +301,152 @@ static void walk_convex_edges(SkEdge* prevHead, SkPath::FillType,
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Paths with at least this many edges, all of them lines, are walked by walk_line_edges().
+static const int kMinLineEdgeTableCount = 16;
+
+/**
+ *  Structure-of-arrays copy of the active edges, kept sorted by x. Line edges only need their
+ *  x, slope, last scanline and winding, so each scanline can step four edges at once and the
+ *  re-sort moves a few ints instead of relinking SkEdges.
+ */
+class LineEdgeTable {
+public:
+    LineEdgeTable(int count) : fCount(0) {
+        // Round up so the stepping loop can always work on whole groups of four.
+        int capacity = SkAlign4(count);
+        fStorage.reset(4 * capacity);
+        fX       = fStorage.get();
+        fDX      = fX  + capacity;
+        fLastY   = fDX + capacity;
+        fWinding = fLastY + capacity;
+    }
+
+    int count() const { return fCount; }
+
+    void append(const SkEdge& edge) {
+        SkASSERT(0 == edge.fCurveCount);
+        fX[fCount]       = edge.fX;
+        fDX[fCount]      = edge.fDX;
+        fLastY[fCount]   = edge.fLastY;
+        fWinding[fCount] = edge.fWinding;
+        fCount += 1;
+    }
+
+    // The table is nearly sorted after each step, so insertion sort is the right tool.
+    // It is stable, which keeps edges with equal x in the order walk_edges() would see them.
+    void sort() {
+        for (int i = 1; i < fCount; i++) {
+            SkFixed x = fX[i];
+            if (fX[i - 1] <= x) {
+                continue;
+            }
+            SkFixed dx      = fDX[i];
+            int     lastY   = fLastY[i];
+            int     winding = fWinding[i];
+            int j = i;
+            do {
+                fX[j]       = fX[j - 1];
+                fDX[j]      = fDX[j - 1];
+                fLastY[j]   = fLastY[j - 1];
+                fWinding[j] = fWinding[j - 1];
+            } while (--j > 0 && fX[j - 1] > x);
+            fX[j]       = x;
+            fDX[j]      = dx;
+            fLastY[j]   = lastY;
+            fWinding[j] = winding;
+        }
+    }
+
+    /**
+     *  Blit the spans of scanline y (same rules as walk_edges), drop the edges that end on y,
+     *  and advance the survivors to y + 1.
+     */
+    void blitAndStep(SkBlitter* blitter, int y, int windingMask, int rightClip) {
+        int  w = 0;
+        int  left SK_INIT_TO_AVOID_WARNING;
+        bool in_interval = false;
+        int  kept = 0;
+
+        for (int i = 0; i < fCount; i++) {
+            int x = SkFixedRoundToInt(fX[i]);
+            w += fWinding[i];
+            if ((w & windingMask) == 0) { // we finished an interval
+                SkASSERT(in_interval);
+                int width = x - left;
+                SkASSERT(width >= 0);
+                if (width) {
+                    blitter->blitH(left, y, width);
+                }
+                in_interval = false;
+            } else if (!in_interval) {
+                left = x;
+                in_interval = true;
+            }
+
+            if (fLastY[i] > y) {
+                fX[kept]       = fX[i];
+                fDX[kept]      = fDX[i];
+                fLastY[kept]   = fLastY[i];
+                fWinding[kept] = fWinding[i];
+                kept += 1;
+            }
+        }
+
+        // was our right-edge culled away?
+        if (in_interval) {
+            int width = rightClip - left;
+            if (width > 0) {
+                blitter->blitH(left, y, width);
+            }
+        }
+
+        fCount = kept;
+        // The tail of the last group may hold stale values; stepping them is harmless.
+        for (int i = 0; i < fCount; i += 4) {
+            (Sk4i::Load(fX + i) + Sk4i::Load(fDX + i)).store(fX + i);
+        }
+    }
+
+private:
+    SkAutoSTMalloc<4 * kMinLineEdgeTableCount, int32_t> fStorage;
+    SkFixed* fX;
+    SkFixed* fDX;
+    int*     fLastY;
+    int*     fWinding;
+    int      fCount;
+};
+
+// Equivalent to walk_edges() for paths made only of lines, using a LineEdgeTable for the
+// active edges. newEdge is the first of the edges sorted by (fFirstY, fX).
+static void walk_line_edges(const SkEdge* newEdge, int count, SkPath::FillType fillType,
+                            SkBlitter* blitter, int start_y, int stop_y,
+                            PrePostProc proc, int rightClip) {
+    validate_sort(newEdge);
+
+    // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
+    int windingMask = (fillType & 1) ? 1 : -1;
+    LineEdgeTable table(count);
+
+    for (int curr_y = start_y; curr_y < stop_y; curr_y++) {
+        // Like walk_edges, edges starting above start_y are taken as they are.
+        while (newEdge->fFirstY <= curr_y) {
+            table.append(*newEdge);
+            newEdge = newEdge->fNext;
+        }
+        table.sort();
+
+        if (proc) {
+            proc(blitter, curr_y, PREPOST_START);    // pre-proc
+        }
+        table.blitAndStep(blitter, curr_y, windingMask, rightClip);
+        if (proc) {
+            proc(blitter, curr_y, PREPOST_END);    // post-proc
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 // this guy overrides blitH, and will call its proxy blitter with the inverse
 // of the spans it is given (clipped to the left/right of the cliprect)
 //
@@ -478,8 +626,18 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         } else {
             rightEdge = SkScalarRoundToInt(path.getBounds().right()) << shiftEdgesUp;
         }
-        
-        walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc, rightEdge);
+
+
+        bool allLines = count >= kMinLineEdgeTableCount;
+        for (int i = 0; allLines && i < count; i++) {
+            allLines = 0 == list[i]->fCurveCount;
+        }
+        if (allLines) {
+            walk_line_edges(edge, count, path.getFillType(), blitter, start_y, stop_y, proc,
+                            rightEdge);
+        } else {
+            walk_edges(&headEdge, path.getFillType(), blitter, start_y, stop_y, proc, rightEdge);
+        }
     }
 }
 
@@ -564,6 +722,7 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
     if (origClip.isEmpty()) {
         return;
     }
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia"), "SkScan::FillPath");
 
     // Our edges are fixed-point, and don't like the bounds of the clip to
     // exceed that. Here we trim the clip just so we don't overflow later on
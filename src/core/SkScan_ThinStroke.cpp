@@ -0,0 +1,446 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkBlitter.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/** @file
+    An anti-aliased renderer for thin strokes made only of lines, which blits coverage directly
+    instead of building the stroked outline with SkStroke and filling it.
+
+    Every segment is stroked as a rectangle along the segment, plus a disc at each end that is
+    round (round caps, and every join). Each pixel row is sampled by a few horizontal lines; each
+    line crosses every nearby segment's stroke in a single span, which is computed directly. The
+    spans are merged, so joins and self-intersections are not blended twice, and their exact
+    horizontal coverage is accumulated into the row before it is blitted.
+ */
+
+namespace {
+
+struct ThinSegment {
+    SkPoint  fA, fB;
+    SkVector fU;        // unit vector from fA to fB (0,0 if the segment is a dot)
+    SkScalar fLength;
+    SkScalar fTop, fBottom;
+    bool     fRoundA, fRoundB;
+
+    bool operator<(const ThinSegment& other) const { return fTop < other.fTop; }
+};
+
+class SegmentBuilder {
+public:
+    SegmentBuilder(SkScalar width, bool roundCaps)
+        : fRadius(SkScalarHalf(width))
+        , fRoundCaps(roundCaps) {}
+
+    // Adds a single segment, with caps at both ends.
+    void addSegment(const SkPoint& a, const SkPoint& b) {
+        if (a == b) {
+            if (fRoundCaps) {
+                this->add(a, a, true, true);
+            }
+        } else {
+            this->add(a, b, fRoundCaps, fRoundCaps);
+        }
+    }
+
+    // Adds a polyline with caps at its ends (unless closed) and round joins between segments.
+    void addPolyline(const SkPoint pts[], int count, bool closed) {
+        // Skip repeated points, so every segment has a direction.
+        fScratch.rewind();
+        for (int i = 0; i < count; ++i) {
+            if (fScratch.isEmpty() || fScratch.top() != pts[i]) {
+                *fScratch.append() = pts[i];
+            }
+        }
+        while (closed && fScratch.count() > 1 && fScratch.top() == fScratch[0]) {
+            fScratch.pop();
+        }
+
+        const int n = fScratch.count();
+        if (n == 0) {
+            return;
+        }
+        if (n == 1) {
+            this->addSegment(fScratch[0], fScratch[0]);
+            return;
+        }
+        for (int i = 0; i < n - 1; ++i) {
+            this->add(fScratch[i], fScratch[i + 1],
+                      closed || i > 0 || fRoundCaps,
+                      closed || i < n - 2 || fRoundCaps);
+        }
+        if (closed) {
+            this->add(fScratch[n - 1], fScratch[0], true, true);
+        }
+    }
+
+    SkTDArray<ThinSegment>& segments() { return fSegments; }
+    SkScalar radius() const { return fRadius; }
+
+    // Device bounds of everything added so far.
+    SkRect bounds() const {
+        SkRect r;
+        r.setEmpty();
+        if (fSegments.isEmpty()) {
+            return r;
+        }
+        r.set(fSegments[0].fA, fSegments[0].fA);
+        for (int i = 0; i < fSegments.count(); ++i) {
+            r.growToInclude(fSegments[i].fA.fX, fSegments[i].fA.fY);
+            r.growToInclude(fSegments[i].fB.fX, fSegments[i].fB.fY);
+        }
+        r.outset(fRadius, fRadius);
+        return r;
+    }
+
+private:
+    void add(const SkPoint& a, const SkPoint& b, bool roundA, bool roundB) {
+        ThinSegment* seg = fSegments.append();
+        seg->fA = a;
+        seg->fB = b;
+        seg->fU = b - a;
+        seg->fLength = seg->fU.length();
+        if (seg->fLength > 0) {
+            seg->fU.scale(SkScalarInvert(seg->fLength));
+        } else {
+            seg->fU.set(0, 0);
+        }
+        seg->fTop = SkTMin(a.fY, b.fY) - fRadius;
+        seg->fBottom = SkTMax(a.fY, b.fY) + fRadius;
+        seg->fRoundA = roundA;
+        seg->fRoundB = roundB;
+    }
+
+    SkTDArray<ThinSegment> fSegments;
+    SkTDArray<SkPoint>     fScratch;
+    const SkScalar         fRadius;
+    const bool             fRoundCaps;
+};
+
+// Each pixel row is sampled by this many horizontal lines, like SkScan_AntiPath's supersampler.
+static const int kSubRows = 4;
+
+struct ThinSpan {
+    SkScalar fL, fR;
+
+    bool operator<(const ThinSpan& other) const { return fL < other.fL; }
+};
+
+// Narrows [*lo, *hi] to the x for which min <= x * k + base <= max. Returns false if empty.
+static inline bool intersect_slab(SkScalar k, SkScalar base, SkScalar min, SkScalar max,
+                                  SkScalar* lo, SkScalar* hi) {
+    if (0 == k) {
+        return base >= min && base <= max;
+    }
+    SkScalar x0 = (min - base) / k;
+    SkScalar x1 = (max - base) / k;
+    if (x0 > x1) {
+        SkTSwap(x0, x1);
+    }
+    *lo = SkTMax(*lo, x0);
+    *hi = SkTMin(*hi, x1);
+    return *lo < *hi;
+}
+
+static inline void intersect_disc(const SkPoint& center, SkScalar r, SkScalar y,
+                                  SkScalar* lo, SkScalar* hi) {
+    const SkScalar dy = y - center.fY;
+    const SkScalar h2 = r * r - dy * dy;
+    if (h2 > 0) {
+        const SkScalar h = SkScalarSqrt(h2);
+        *lo = SkTMin(*lo, center.fX - h);
+        *hi = SkTMax(*hi, center.fX + h);
+    }
+}
+
+/** Finds where the horizontal line at y crosses the stroke of seg. The stroke is convex, so this
+    is a single span: its rectangle's span, extended by the spans of its round ends.
+ */
+static bool segment_span(const ThinSegment& seg, SkScalar r, SkScalar y, ThinSpan* span) {
+    SkScalar lo = SK_ScalarMax, hi = -SK_ScalarMax;
+    if (seg.fLength > 0) {
+        // Along the segment: 0 <= (p - A).u <= length. Across it: -r <= (p - A).n <= r.
+        const SkScalar dy = y - seg.fA.fY;
+        SkScalar rectL = -SK_ScalarMax, rectR = SK_ScalarMax;
+        if (intersect_slab(seg.fU.fX, dy * seg.fU.fY - seg.fA.fX * seg.fU.fX, 0, seg.fLength,
+                           &rectL, &rectR) &&
+            intersect_slab(-seg.fU.fY, dy * seg.fU.fX + seg.fA.fX * seg.fU.fY, -r, r,
+                           &rectL, &rectR)) {
+            lo = rectL;
+            hi = rectR;
+        }
+    }
+    if (seg.fRoundA) {
+        intersect_disc(seg.fA, r, y, &lo, &hi);
+    }
+    if (seg.fRoundB) {
+        intersect_disc(seg.fB, r, y, &lo, &hi);
+    }
+    span->fL = lo;
+    span->fR = hi;
+    return lo < hi;
+}
+
+/** Accumulates the coverage of one pixel row, sub-row by sub-row, then blits it as runs of equal
+    alpha. Within a sub-row, the spans of all segments are merged first, so overlapping segments
+    (at joins, or where the line crosses itself) only cover once.
+ */
+class ThinRow {
+public:
+    ThinRow(SkBlitter* blitter, int left, int width)
+        : fBlitter(blitter)
+        , fLeft(left)
+        , fWidth(width)
+        , fCoverage(width + 1)
+        , fRunAlpha(width + 1)
+        , fRuns(width + 1) {
+        sk_bzero(fCoverage.get(), (width + 1) * sizeof(SkScalar));
+        fDirtyL = width;
+        fDirtyR = 0;
+    }
+
+    void addSegment(const ThinSegment& seg, SkScalar r, SkScalar y) {
+        ThinSpan span;
+        if (segment_span(seg, r, y, &span)) {
+            span.fL -= SkIntToScalar(fLeft);
+            span.fR -= SkIntToScalar(fLeft);
+            if (span.fR > 0 && span.fL < SkIntToScalar(fWidth)) {
+                *fSpans.append() = span;
+            }
+        }
+    }
+
+    // Merges the spans added since the last call, and accumulates them.
+    void resolveSubRow() {
+        const int count = fSpans.count();
+        if (0 == count) {
+            return;
+        }
+        if (count > 1) {
+            SkTQSort(fSpans.begin(), fSpans.end() - 1);
+        }
+        ThinSpan merged = fSpans[0];
+        for (int i = 1; i < count; ++i) {
+            if (fSpans[i].fL <= merged.fR) {
+                merged.fR = SkTMax(merged.fR, fSpans[i].fR);
+            } else {
+                this->accumulate(merged.fL, merged.fR);
+                merged = fSpans[i];
+            }
+        }
+        this->accumulate(merged.fL, merged.fR);
+        fSpans.rewind();
+    }
+
+    void flush(int y) {
+        if (fDirtyL >= fDirtyR) {
+            return;
+        }
+        const SkScalar scale = SkIntToScalar(255) / kSubRows;
+        SkScalar* coverage = fCoverage.get();
+        uint8_t* aa = fRunAlpha.get();
+        int16_t* runs = fRuns.get();
+        // Convert in place, reusing fRunAlpha for the per-pixel alpha before building runs.
+        for (int x = fDirtyL; x < fDirtyR; ++x) {
+            aa[x] = SkToU8(SkTMin(255, SkScalarRoundToInt(coverage[x] * scale)));
+        }
+        int x = fDirtyL;
+        while (x < fDirtyR) {
+            const U8CPU a = aa[x];
+            int n = 1;
+            while (x + n < fDirtyR && aa[x + n] == a && n < SK_MaxS16) {
+                ++n;
+            }
+            runs[x] = SkToS16(n);
+            x += n;
+        }
+        runs[fDirtyR] = 0;
+        fBlitter->blitAntiH(fLeft + fDirtyL, y, aa + fDirtyL, runs + fDirtyL);
+
+        sk_bzero(coverage + fDirtyL, (fDirtyR - fDirtyL) * sizeof(SkScalar));
+        fDirtyL = fWidth;
+        fDirtyR = 0;
+    }
+
+private:
+    // Adds the exact horizontal coverage of [l, r) (relative to fLeft) to the row.
+    void accumulate(SkScalar l, SkScalar r) {
+        l = SkTMax<SkScalar>(l, 0);
+        r = SkTMin(r, SkIntToScalar(fWidth));
+        if (l >= r) {
+            return;
+        }
+        SkScalar* coverage = fCoverage.get();
+        const int il = SkScalarFloorToInt(l);
+        const int ir = SkTMin(SkScalarFloorToInt(r), fWidth - 1);
+        if (il == ir) {
+            coverage[il] += r - l;
+        } else {
+            coverage[il] += SkIntToScalar(il + 1) - l;
+            for (int x = il + 1; x < ir; ++x) {
+                coverage[x] += SK_Scalar1;
+            }
+            coverage[ir] += r - SkIntToScalar(ir);
+        }
+        fDirtyL = SkTMin(fDirtyL, il);
+        fDirtyR = SkTMax(fDirtyR, ir + 1);
+    }
+
+    SkBlitter*                    fBlitter;
+    const int                     fLeft;
+    const int                     fWidth;
+    SkTDArray<ThinSpan>           fSpans;
+    SkAutoSTMalloc<512, SkScalar> fCoverage;
+    SkAutoSTMalloc<512, uint8_t>  fRunAlpha;
+    SkAutoSTMalloc<512, int16_t>  fRuns;
+    int                           fDirtyL, fDirtyR;
+};
+
+}  // namespace
+
+static void thin_stroke(SegmentBuilder& builder, const SkRegion& clip, SkBlitter* blitter) {
+    SkTDArray<ThinSegment>& segs = builder.segments();
+    if (segs.isEmpty()) {
+        return;
+    }
+
+    SkRect devBounds = builder.bounds();
+    if (!devBounds.isFinite() || !devBounds.intersect(SkRect::Make(clip.getBounds()))) {
+        return;
+    }
+    SkIRect ir;
+    devBounds.roundOut(&ir);
+    if (ir.isEmpty()) {
+        return;
+    }
+
+    SkScanClipper clipper(blitter, &clip, ir);
+    blitter = clipper.getBlitter();
+    if (NULL == blitter) {
+        return;
+    }
+    if (const SkIRect* clipRect = clipper.getClipRect()) {
+        if (!ir.intersect(*clipRect)) {
+            return;
+        }
+    }
+
+    SkTQSort(segs.begin(), segs.end() - 1);
+
+    const SkScalar r = builder.radius();
+    ThinRow row(blitter, ir.fLeft, ir.width());
+    SkTDArray<const ThinSegment*> active;
+
+    int next = 0;
+    int y = ir.fTop;
+    while (y < ir.fBottom) {
+        if (active.isEmpty()) {
+            if (next == segs.count()) {
+                break;
+            }
+            // Skip straight to the first row touched by the next segment.
+            y = SkTMax(y, SkScalarFloorToInt(segs[next].fTop));
+            if (y >= ir.fBottom) {
+                break;
+            }
+        }
+
+        const SkScalar rowTop = SkIntToScalar(y);
+        const SkScalar rowBottom = rowTop + SK_Scalar1;
+        while (next < segs.count() && segs[next].fTop < rowBottom) {
+            if (segs[next].fBottom > rowTop) {
+                *active.append() = &segs[next];
+            }
+            ++next;
+        }
+
+        int i = 0;
+        while (i < active.count()) {
+            if (active[i]->fBottom <= rowTop) {
+                active.removeShuffle(i);
+            } else {
+                ++i;
+            }
+        }
+        for (int sub = 0; sub < kSubRows; ++sub) {
+            const SkScalar subY = rowTop + (sub + SK_ScalarHalf) / kSubRows;
+            for (i = 0; i < active.count(); ++i) {
+                row.addSegment(*active[i], r, subY);
+            }
+            row.resolveSubRow();
+        }
+        row.flush(y);
+        ++y;
+    }
+}
+
+static void thin_stroke(SegmentBuilder& builder, const SkRasterClip& clip, SkBlitter* blitter) {
+    if (clip.isEmpty()) {
+        return;
+    }
+    if (clip.isBW()) {
+        thin_stroke(builder, clip.bwRgn(), blitter);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        thin_stroke(builder, tmp, &aaBlitter);
+    }
+}
+
+void SkScan::AntiThinStrokePath(const SkPath& path, SkScalar width, bool roundCaps,
+                                const SkRasterClip& clip, SkBlitter* blitter) {
+    SkASSERT(SkPath::kLine_SegmentMask == path.getSegmentMasks());
+
+    SegmentBuilder builder(width, roundCaps);
+    SkTDArray<SkPoint> contour;
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                builder.addPolyline(contour.begin(), contour.count(), false);
+                contour.rewind();
+                *contour.append() = pts[0];
+                break;
+            case SkPath::kLine_Verb:
+                *contour.append() = pts[1];
+                break;
+            case SkPath::kClose_Verb:
+                builder.addPolyline(contour.begin(), contour.count(), true);
+                contour.rewind();
+                break;
+            default:
+                SkDEBUGFAIL("thin strokes only handle lines");
+                return;
+        }
+    }
+    builder.addPolyline(contour.begin(), contour.count(), false);
+
+    thin_stroke(builder, clip, blitter);
+}
+
+void SkScan::AntiThinStrokeSegments(const SkPoint pts[], int count, bool connected,
+                                    SkScalar width, bool roundCaps,
+                                    const SkRasterClip& clip, SkBlitter* blitter) {
+    SegmentBuilder builder(width, roundCaps);
+    const int inc = connected ? 1 : 2;
+    for (int i = 0; i + 1 < count; i += inc) {
+        builder.addSegment(pts[i], pts[i + 1]);
+    }
+
+    thin_stroke(builder, clip, blitter);
+}
@@ -11,6 +11,8 @@
 #include "SkBlitRow.h"
 #include "SkColorFilter.h"
 #include "SkColorPriv.h"
+#include "SkColorTable.h"
+#include "SkSwizzler_opts.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
@@ -203,6 +205,83 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static uint16_t index8_to_n32(SkPMColor* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src,
+                              int count, const SkPMColor ctable[]) {
+    for (int i = 0; i < count; ++i) {
+        dst[i] = ctable[src[i]];
+    }
+    return 0;
+}
+
+static uint16_t rgb565_to_n32(SkPMColor* SK_RESTRICT dst, const uint8_t* SK_RESTRICT src,
+                              int count, const SkPMColor[]) {
+    const uint16_t* SK_RESTRICT src16 = (const uint16_t*)src;
+    for (int i = 0; i < count; ++i) {
+        dst[i] = SkPixel16ToPixel32(src16[i]);
+    }
+    return 0;
+}
+
+/**
+ *  Draws kIndex_8 or kRGB_565 sources by converting each row to N32 in fBuffer (with the
+ *  platform swizzler when there is one), and then filtering and blending that like an N32
+ *  source, with the paint's alpha unless there is an xfermode.
+ */
+class Sprite_D32_SConvert_XferFilter : public Sprite_D32_XferFilter {
+public:
+    Sprite_D32_SConvert_XferFilter(const SkBitmap& source, const SkPaint& paint)
+        : Sprite_D32_XferFilter(source, paint) {
+        if (kIndex_8_SkColorType == source.colorType()) {
+            fConvertProc = SkSwizzleGetPlatformProc(kIndex_To_N32_SkSwizzleProcType);
+            if (NULL == fConvertProc) {
+                fConvertProc = index8_to_n32;
+            }
+        } else {
+            SkASSERT(kRGB_565_SkColorType == source.colorType());
+            fConvertProc = SkSwizzleGetPlatformProc(kRGB565_To_N32_SkSwizzleProcType);
+            if (NULL == fConvertProc) {
+                fConvertProc = rgb565_to_n32;
+            }
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        SkASSERT(width > 0 && height > 0);
+        SkPMColor* SK_RESTRICT dst = fDevice->getAddr32(x, y);
+        const uint8_t* SK_RESTRICT src = (const uint8_t*)fSource->getAddr(x - fLeft, y - fTop);
+        size_t dstRB = fDevice->rowBytes();
+        size_t srcRB = fSource->rowBytes();
+        const SkPMColor* colors = fSource->getColorTable() ?
+                                  fSource->getColorTable()->readColors() : NULL;
+        SkPMColor* SK_RESTRICT buffer = fBuffer;
+        SkColorFilter* colorFilter = fColorFilter;
+        SkXfermode* xfermode = fXfermode;
+
+        do {
+            fConvertProc(buffer, src, width, colors);
+
+            if (colorFilter) {
+                colorFilter->filterSpan(buffer, width, buffer);
+            }
+            if (xfermode) {
+                xfermode->xfer32(dst, buffer, width, NULL);
+            } else {
+                fProc32(dst, buffer, width, fAlpha);
+            }
+
+            dst = (SkPMColor* SK_RESTRICT)((char*)dst + dstRB);
+            src += srcRB;
+        } while (--height != 0);
+    }
+
+private:
+    SkSwizzleRowProc fConvertProc;
+
+    typedef Sprite_D32_XferFilter INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 static void src_row(SkPMColor* SK_RESTRICT dst,
                     const SkPMColor16* SK_RESTRICT src, int count) {
     do {
@@ -289,6 +368,18 @@ SkSpriteBlitter* SkSpriteBlitter::ChooseD32(const SkBitmap& source, const SkPain
                 blitter = allocator->createT<Sprite_D32_S4444>(source);
             }
             break;
+        case kIndex_8_SkColorType: {
+            SkAutoLockPixels alp(source);
+            if (NULL == source.getColorTable()) {
+                return NULL;
+            }
+        }   // fall through
+        case kRGB_565_SkColorType:
+            if (xfermode && alpha != 0xFF) {
+                return NULL;    // xfer32() can't apply the paint's alpha
+            }
+            blitter = allocator->createT<Sprite_D32_SConvert_XferFilter>(source, paint);
+            break;
         case kN32_SkColorType:
             if (xfermode || filter) {
                 if (255 == alpha) {
@@ -409,6 +409,11 @@ const void* SkMemoryStream::getMemoryBase() {
     return fData->data();
 }
 
+const void* SkMemoryStream::peekMemory(size_t* size) {
+    *size = fData->size() - fOffset;
+    return fData->bytes() + fOffset;
+}
+
 const void* SkMemoryStream::getAtPos() {
     return fData->bytes() + fOffset;
 }
@@ -765,6 +770,21 @@ public:
         return NULL;
     }
 
+    const void* peekMemory(size_t* size) override {
+        // The bytes up to the end of the current block are contiguous.
+        const SkDynamicMemoryWStream::Block* block = fCurrent;
+        size_t offset = fCurrentOffset;
+        if (block && offset == block->written() && block->fNext) {
+            block = block->fNext;
+            offset = 0;
+        }
+        if (NULL == block) {
+            return NULL;
+        }
+        *size = SkTMin(block->written() - offset, fSize - fOffset);
+        return block->start() + offset;
+    }
+
 private:
     SkAutoTUnref<SkBlockMemoryRefCnt> const fBlockMemory;
     SkDynamicMemoryWStream::Block const * fCurrent;
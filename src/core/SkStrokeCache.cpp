@@ -0,0 +1,146 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+#include "SkAtomics.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+static bool gStrokeCacheEnabled = false;
+static int32_t gStrokeCacheHits = 0;
+static int32_t gStrokeCacheMisses = 0;
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+// Shared by every stroke of one path, so all of them can be purged together.
+static uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('s', 't', 'r', 'k');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& src, const SkStrokeRec& rec)
+        : fGenID(src.getGenerationID())
+        , fFillType(src.getFillType())
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(rec.getResScale())
+        , fCap(rec.getCap())
+        , fJoin(rec.getJoin())
+        , fStrokeAndFill(rec.isStrokeAndFill())
+    {
+        this->init(&gStrokeKeyNamespaceLabel, make_shared_id(fGenID),
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fWidth) + sizeof(fMiter) +
+                   sizeof(fResScale) + sizeof(fCap) + sizeof(fJoin) + sizeof(fStrokeAndFill));
+    }
+
+    uint32_t fGenID;
+    int32_t  fFillType;
+    SkScalar fWidth;
+    SkScalar fMiter;
+    SkScalar fResScale;
+    int32_t  fCap;
+    int32_t  fJoin;
+    int32_t  fStrokeAndFill;
+};
+
+struct StrokeCacheRec : public SkResourceCache::Rec {
+    StrokeCacheRec(const StrokeKey& key, const SkPath& stroked)
+        : fKey(key)
+        , fStroked(stroked)
+    {}
+
+    StrokeKey fKey;
+    SkPath    fStroked;
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "stroke"; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fStroked.countPoints() * sizeof(SkPoint) +
+               fStroked.countVerbs() * sizeof(uint8_t);
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextPath) {
+        const StrokeCacheRec& rec = static_cast<const StrokeCacheRec&>(baseRec);
+        SkPath* result = (SkPath*)contextPath;
+
+        *result = rec.fStroked;     // shares the SkPathRef; no points are copied
+        return true;
+    }
+};
+} // namespace
+
+bool SkStrokeCache::IsEnabled() {
+    return gStrokeCacheEnabled;
+}
+
+bool SkStrokeCache::SetEnabled(bool enabled) {
+    bool prev = gStrokeCacheEnabled;
+    gStrokeCacheEnabled = enabled;
+    return prev;
+}
+
+bool SkStrokeCache::Find(const SkPath& src, const SkStrokeRec& rec, SkPath* dst,
+                         SkResourceCache* localCache) {
+    StrokeKey key(src, rec);
+    if (!CHECK_LOCAL(localCache, find, Find, key, StrokeCacheRec::Visitor, dst)) {
+        sk_atomic_inc(&gStrokeCacheMisses);
+        return false;
+    }
+    sk_atomic_inc(&gStrokeCacheHits);
+    return true;
+}
+
+void SkStrokeCache::Add(const SkPath& src, const SkStrokeRec& rec, const SkPath& stroked,
+                        SkResourceCache* localCache) {
+    StrokeKey key(src, rec);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(StrokeCacheRec, (key, stroked)));
+}
+
+bool SkStrokeCache::GetFillPath(const SkPaint& paint, const SkPath& src, SkPath* dst,
+                                SkScalar resScale) {
+    SkASSERT(NULL == paint.getPathEffect());
+    SkStrokeRec rec(paint, resScale);
+
+    // Volatile paths won't be drawn again, and fills and hairlines aren't stroked at all.
+    if (src.isVolatile() || !rec.needToApply()) {
+        return paint.getFillPath(src, dst, NULL, resScale);
+    }
+
+    if (!Find(src, rec, dst)) {
+        // Take the key before dst is written, since it may be the same path as src.
+        const StrokeKey key(src, rec);
+        SkAssertResult(rec.applyToPath(dst, src));
+        SkResourceCache::Add(SkNEW_ARGS(StrokeCacheRec, (key, *dst)));
+    }
+    return !rec.isHairlineStyle();
+}
+
+void SkStrokeCache::GetStats(Stats* stats) {
+    stats->fHits = sk_atomic_load(&gStrokeCacheHits);
+    stats->fMisses = sk_atomic_load(&gStrokeCacheMisses);
+}
+
+void SkStrokeCache::ResetStats() {
+    sk_atomic_store(&gStrokeCacheHits, 0);
+    sk_atomic_store(&gStrokeCacheMisses, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkGraphics::GetStrokeCacheEnabled() {
+    return SkStrokeCache::IsEnabled();
+}
+
+bool SkGraphics::SetStrokeCacheEnabled(bool enabled) {
+    return SkStrokeCache::SetEnabled(enabled);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "SkStrokeRec.h"
+
+class SkPaint;
+
+/**
+ *  Remembers the result of stroking a path, keyed by the path's generation ID and the stroke
+ *  parameters (width, miter, cap, join, stroke-and-fill, and the resolution scale taken from
+ *  the matrix). Entries live in the SkResourceCache, so they share its budget and are purged
+ *  with it.
+ *
+ *  The global cache is consulted by SkDraw only while enabled (it is off by default, see
+ *  SkGraphics::SetStrokeCacheEnabled()).
+ */
+class SkStrokeCache {
+public:
+    static bool IsEnabled();
+    static bool SetEnabled(bool enabled);   // returns the previous setting
+
+    /**
+     *  If src stroked with rec is cached, copy the result into dst and return true.
+     *  dst and src may be the same path.
+     */
+    static bool Find(const SkPath& src, const SkStrokeRec& rec, SkPath* dst,
+                     SkResourceCache* localCache = NULL);
+
+    /**
+     *  Add the result of stroking src with rec to the cache.
+     */
+    static void Add(const SkPath& src, const SkStrokeRec& rec, const SkPath& stroked,
+                    SkResourceCache* localCache = NULL);
+
+    /**
+     *  Equivalent to paint.getFillPath(src, dst, NULL, resScale) for paints without a path
+     *  effect, but reuses (and fills) the global cache when the stroke is cacheable.
+     */
+    static bool GetFillPath(const SkPaint& paint, const SkPath& src, SkPath* dst,
+                            SkScalar resScale);
+
+    struct Stats {
+        int32_t fHits;
+        int32_t fMisses;
+    };
+
+    /** Find() hits and misses, counted across all caches since the last ResetStats(). */
+    static void GetStats(Stats*);
+    static void ResetStats();
+};
+
+#endif
@@ -0,0 +1,331 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTGroupHash_DEFINED
+#define SkTGroupHash_DEFINED
+
+#include "SkChecksum.h"
+#include "SkMath.h"
+#include "SkTypes.h"
+#include "SkTemplates.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// SkTGroupHashTable, SkTGroupHashMap and SkTGroupHashSet have the same interface as their SkTHash
+// counterparts (plus remove()), and can be swapped in for them where lookups dominate.
+//
+// Next to the entries, the table keeps one control byte per slot: empty, removed, or the low 7
+// bits of the entry's hash.  Slots are probed in aligned groups of 16.  One probe compares all 16
+// control bytes of a group against the hash bits at once (with SSE2 when available), so only
+// entries whose 7 hash bits match ever have their keys compared, and a lookup stops at the first
+// group with an empty slot.  Tables are kept at most 7/8 full.
+//
+// As with SkTHashTable, T and K are ordinary copyable C++ types, and Traits must have:
+//   - static K GetKey(T)
+//   - static uint32_t Hash(K)
+template <typename T, typename K, typename Traits = T>
+class SkTGroupHashTable : SkNoncopyable {
+public:
+    SkTGroupHashTable() : fCount(0), fRemoved(0), fCapacity(0), fControl(NULL) {}
+
+    // Clear the table.
+    void reset() {
+        this->~SkTGroupHashTable();
+        SkNEW_PLACEMENT(this, SkTGroupHashTable);
+    }
+
+    // How many entries are in the table?
+    int count() const { return fCount; }
+
+    // The same cautions as for SkTHashTable apply: don't change an entry's key through the
+    // pointers from set(), find() or foreach(), and those from set() and find() are valid only
+    // until the next call to set() or remove().
+
+    // Copy val into the hash table, returning a pointer to the copy now in the table.
+    // If there already is an entry in the table with the same key, we overwrite it.
+    T* set(const T& val) {
+        if (8 * (fCount + fRemoved + 1) > 7 * fCapacity) {
+            // Rehash in place if removals, rather than entries, are what filled the table.
+            this->resize(fCount >= fRemoved ? SkTMax(fCapacity * 2, kGroupSize) : fCapacity);
+        }
+        return this->uncheckedSet(val);
+    }
+
+    // If there is an entry in the table with this key, return a pointer to it.  If not, NULL.
+    T* find(const K& key) const {
+        if (0 == fCapacity) {
+            return NULL;
+        }
+        uint32_t hash = Traits::Hash(key);
+        uint8_t tag = Tag(hash);
+        int group = this->firstGroup(hash);
+        for (int n = 0; n < this->groupCount(); n++) {
+            const uint8_t* control = &fControl[group * kGroupSize];
+            for (uint32_t matches = Match(control, tag); matches; matches &= matches - 1) {
+                T& val = fSlots[group * kGroupSize + LowestBit(matches)];
+                if (key == Traits::GetKey(val)) {
+                    return &val;
+                }
+            }
+            if (Match(control, kEmpty)) {
+                return NULL;
+            }
+            group = this->nextGroup(group, n);
+        }
+        return NULL;
+    }
+
+    // Remove the entry with this key, if there is one.
+    void remove(const K& key) {
+        T* val = this->find(key);
+        if (!val) {
+            return;
+        }
+        int index = SkToInt(val - fSlots.get());
+        // A lookup stops at the first group with an empty slot, so if this slot's group has one
+        // no lookup can have probed past it, and the slot can go back to empty.
+        uint8_t* control = &fControl[index & ~(kGroupSize - 1)];
+        if (Match(control, kEmpty)) {
+            fControl[index] = kEmpty;
+        } else {
+            fControl[index] = kRemoved;
+            fRemoved++;
+        }
+        *val = T();
+        fCount--;
+    }
+
+    // Call fn on every entry in the table.  You may mutate the entries, but be very careful.
+    template <typename Fn>  // f(T*)
+    void foreach(Fn&& fn) {
+        for (int i = 0; i < fCapacity; i++) {
+            if (IsFull(fControl[i])) {
+                fn(&fSlots[i]);
+            }
+        }
+    }
+
+    // Call fn on every entry in the table.  You may not mutate anything.
+    template <typename Fn>  // f(T) or f(const T&)
+    void foreach(Fn&& fn) const {
+        for (int i = 0; i < fCapacity; i++) {
+            if (IsFull(fControl[i])) {
+                fn(fSlots[i]);
+            }
+        }
+    }
+
+private:
+    static const int kGroupSize = 16;
+
+    // Control bytes with the high bit clear hold the low 7 bits of a full slot's hash.
+    static const uint8_t kEmpty   = 0x80;
+    static const uint8_t kRemoved = 0xFE;
+
+    static bool IsFull(uint8_t control) { return control < 0x80; }
+    static uint8_t Tag(uint32_t hash) { return hash & 0x7F; }
+
+    // Returns a bit mask of the control bytes in the group that equal c.
+    static uint32_t Match(const uint8_t* control, uint8_t c) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(control));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < kGroupSize; i++) {
+            mask |= (uint32_t)(control[i] == c) << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Returns a bit mask of the slots in the group that are empty or removed.
+    static uint32_t MatchAvailable(const uint8_t* control) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(control));
+        return _mm_movemask_epi8(group);
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < kGroupSize; i++) {
+            mask |= (uint32_t)!IsFull(control[i]) << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Index of the lowest set bit of a non-zero mask.
+    static int LowestBit(uint32_t mask) {
+        SkASSERT(mask);
+        return 31 - SkCLZ(mask & (0 - mask));
+    }
+
+    int groupCount() const { return fCapacity / kGroupSize; }
+    int firstGroup(uint32_t hash) const { return (hash >> 7) & (this->groupCount() - 1); }
+    int nextGroup(int group, int n) const {
+        // Quadratic probing over groups, which visits them all since the count is a power of 2.
+        return (group + n + 1) & (this->groupCount() - 1);
+    }
+
+    T* uncheckedSet(const T& val) {
+        if (T* existing = this->find(Traits::GetKey(val))) {
+            // Note: this triggers extra copies when adding the same value repeatedly.
+            *existing = val;
+            return existing;
+        }
+        uint32_t hash = Traits::Hash(Traits::GetKey(val));
+        int group = this->firstGroup(hash);
+        for (int n = 0; n < this->groupCount(); n++) {
+            if (uint32_t available = MatchAvailable(&fControl[group * kGroupSize])) {
+                int index = group * kGroupSize + LowestBit(available);
+                if (kRemoved == fControl[index]) {
+                    fRemoved--;
+                }
+                fControl[index] = Tag(hash);
+                fSlots[index] = val;
+                fCount++;
+                return &fSlots[index];
+            }
+            group = this->nextGroup(group, n);
+        }
+        SkASSERT(false);
+        return NULL;
+    }
+
+    void resize(int capacity) {
+        SkASSERT(capacity >= kGroupSize && SkIsPow2(capacity));
+        int oldCapacity = fCapacity;
+        SkDEBUGCODE(int oldCount = fCount);
+
+        SkAutoTArray<T> oldSlots(capacity);
+        oldSlots.swap(fSlots);
+        SkAutoTMalloc<uint8_t> oldControlStorage(fControlStorage.detach());
+        const uint8_t* oldControl = fControl;
+
+        // Groups are loaded with aligned loads.
+        fControlStorage.reset(capacity + kGroupSize - 1);
+        fControl = reinterpret_cast<uint8_t*>(
+                (reinterpret_cast<uintptr_t>(fControlStorage.get()) + kGroupSize - 1) &
+                ~(uintptr_t)(kGroupSize - 1));
+        memset(fControl, kEmpty, capacity);
+        fCount = 0;
+        fRemoved = 0;
+        fCapacity = capacity;
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (IsFull(oldControl[i])) {
+                this->uncheckedSet(oldSlots[i]);
+            }
+        }
+        SkASSERT(fCount == oldCount);
+    }
+
+    int fCount, fRemoved, fCapacity;
+    SkAutoTArray<T> fSlots;
+    SkAutoTMalloc<uint8_t> fControlStorage;
+    uint8_t* fControl;  // fControlStorage, aligned to 16 bytes.
+};
+
+// Maps K->V, like SkTHashMap, on an SkTGroupHashTable.
+template <typename K, typename V, uint32_t(*HashK)(const K&) = &SkGoodHash>
+class SkTGroupHashMap : SkNoncopyable {
+public:
+    SkTGroupHashMap() {}
+
+    // Clear the map.
+    void reset() { fTable.reset(); }
+
+    // How many key/value pairs are in the table?
+    int count() const { return fTable.count(); }
+
+    // N.B. The pointers returned by set() and find() are valid only until the next call to set()
+    // or remove().
+
+    // Set key to val in the table, replacing any previous value with the same key.
+    // We copy both key and val, and return a pointer to the value copy now in the table.
+    V* set(const K& key, const V& val) {
+        Pair in = { key, val };
+        Pair* out = fTable.set(in);
+        return &out->val;
+    }
+
+    // If there is key/value entry in the table with this key, return a pointer to the value.
+    // If not, return NULL.
+    V* find(const K& key) const {
+        if (Pair* p = fTable.find(key)) {
+            return &p->val;
+        }
+        return NULL;
+    }
+
+    // Remove the key/value entry in the table with this key, if there is one.
+    void remove(const K& key) { fTable.remove(key); }
+
+    // Call fn on every key/value pair in the table.  You may mutate the value but not the key.
+    template <typename Fn>  // f(K, V*) or f(const K&, V*)
+    void foreach(Fn&& fn) {
+        fTable.foreach([&fn](Pair* p){ fn(p->key, &p->val); });
+    }
+
+    // Call fn on every key/value pair in the table.  You may not mutate anything.
+    template <typename Fn>  // f(K, V), f(const K&, V), f(K, const V&) or f(const K&, const V&).
+    void foreach(Fn&& fn) const {
+        fTable.foreach([&fn](const Pair& p){ fn(p.key, p.val); });
+    }
+
+private:
+    struct Pair {
+        K key;
+        V val;
+        static const K& GetKey(const Pair& p) { return p.key; }
+        static uint32_t Hash(const K& key) { return HashK(key); }
+    };
+
+    SkTGroupHashTable<Pair, K> fTable;
+};
+
+// A set of T, like SkTHashSet, on an SkTGroupHashTable.
+template <typename T, uint32_t(*HashT)(const T&) = &SkGoodHash>
+class SkTGroupHashSet : SkNoncopyable {
+public:
+    SkTGroupHashSet() {}
+
+    // Clear the set.
+    void reset() { fTable.reset(); }
+
+    // How many items are in the set?
+    int count() const { return fTable.count(); }
+
+    // Copy an item into the set.
+    void add(const T& item) { fTable.set(item); }
+
+    // Remove the item equal to this from the set, if there is one.
+    void remove(const T& item) { fTable.remove(item); }
+
+    // Is this item in the set?
+    bool contains(const T& item) const { return SkToBool(this->find(item)); }
+
+    // If an item equal to this is in the set, return a pointer to it, otherwise null.
+    // This pointer remains valid until the next call to add() or remove().
+    const T* find(const T& item) const { return fTable.find(item); }
+
+    // Call fn on every item in the set.  You may not mutate anything.
+    template <typename Fn>  // f(T), f(const T&)
+    void foreach (Fn&& fn) const {
+        fTable.foreach (fn);
+    }
+
+private:
+    struct Traits {
+        static const T& GetKey(const T& item) { return item; }
+        static uint32_t Hash(const T& item) { return HashT(item); }
+    };
+    SkTGroupHashTable<T, T, Traits> fTable;
+};
+
+#endif//SkTGroupHash_DEFINED
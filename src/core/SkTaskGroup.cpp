@@ -3,6 +3,8 @@
 #include "SkCondVar.h"
 #include "SkRunnable.h"
 #include "SkTDArray.h"
+#include "SkTLS.h"
+#include "SkTemplates.h"
 #include "SkThread.h"
 #include "SkThreadUtils.h"
 
@@ -21,6 +23,15 @@
 
 namespace {
 
+/*  Each thread has its own queue of work, under its own lock. A thread adds work to the back
+    of its own queue and takes it from there too, so nested tasks run soon after they are
+    spawned, while their data is still warm. A thread whose queue is empty steals from the
+    front of the others'. Threads outside the pool spread their work across the queues.
+
+    fQueued counts the work in every queue. Threads only sleep on fReady once it's zero, and
+    adders only take fReady's lock to wake them when someone is asleep, so in the busy case
+    threads touch no lock but the queues they work on.
+ */
 class ThreadPool : SkNoncopyable {
 public:
     static void Add(SkRunnable* task, int32_t* pending) {
@@ -50,17 +61,14 @@ public:
             SkASSERT(*pending == 0);
             return;
         }
+        const int self = CurrentQueue();
         while (sk_acquire_load(pending) > 0) {  // Pairs with sk_atomic_dec here or in Loop.
             // Lend a hand until our SkTaskGroup of interest is done.
             Work work;
-            {
-                AutoLock lock(&gGlobal->fReady);
-                if (gGlobal->fWork.isEmpty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                gGlobal->fWork.pop(&work);
+            if (!gGlobal->take(self, &work)) {
+                // Someone has picked up all the work (including ours).  How nice of them!
+                // (They may still be working on it, so we can't assert *pending == 0 here.)
+                continue;
             }
             // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
@@ -85,18 +93,51 @@ private:
         int32_t* pending;   // then sk_atomic_dec(pending) afterwards.
     };
 
-    explicit ThreadPool(int threads) : fDraining(false) {
+    // A thread's work. Its owner pushes and pops at the back; thieves take from fHead.
+    struct Queue {
+        Queue() : fHead(0) {}
+
+        SkMutex         fLock;
+        SkTDArray<Work> fWork;
+        int             fHead;
+    };
+
+    struct Worker {
+        ThreadPool* fPool;
+        int         fIndex;
+    };
+
+    // The index of the calling thread's queue, or -1 if it isn't one of the pool's threads.
+    static void* CreateQueueIndex() { return SkNEW_ARGS(int, (-1)); }
+    static void DeleteQueueIndex(void* index) { SkDELETE((int*)index); }
+    static int CurrentQueue() {
+        const int* index = (const int*)SkTLS::Find(CreateQueueIndex);
+        return index ? *index : -1;
+    }
+
+    ThreadPool(int threads, bool pinThreads)
+        : fQueued(0)
+        , fSleeping(0)
+        , fNext(0)
+        , fDraining(false) {
         if (threads == -1) {
             threads = num_cores();
         }
+        fQueues.reset(threads);
+        fWorkers.reset(threads);
         for (int i = 0; i < threads; i++) {
-            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, this)));
+            fWorkers[i].fPool = this;
+            fWorkers[i].fIndex = i;
+            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, &fWorkers[i])));
+            if (pinThreads) {
+                fThreads.top()->setProcessorAffinity(i % num_cores());
+            }
             fThreads.top()->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.isEmpty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(0 == fQueued);  // All SkTaskGroups should be destroyed by now.
         {
             AutoLock lock(&fReady);
             fDraining = true;
@@ -105,55 +146,134 @@ private:
         for (int i = 0; i < fThreads.count(); i++) {
             fThreads[i]->join();
         }
-        SkASSERT(fWork.isEmpty());  // Can't hurt to double check.
+        SkASSERT(0 == fQueued);  // Can't hurt to double check.
         fThreads.deleteAll();
     }
 
+    int queueCount() const { return fThreads.count(); }
+
+    // How many threads are in the global pool, 0 if there is none.
+    static int ThreadCount() { return gGlobal ? gGlobal->queueCount() : 0; }
+
+    // Pool threads keep their work; everyone else deals it out round robin.
+    int queueForAdd() {
+        int self = CurrentQueue();
+        if (self >= 0) {
+            return self;
+        }
+        return (sk_atomic_inc(&fNext) & SK_MaxS32) % this->queueCount();
+    }
+
+    void push(int index, const Work* work, int count) {
+        Queue& queue = fQueues[index];
+        SkAutoMutexAcquire lock(queue.fLock);
+        queue.fWork.append(count, work);
+    }
+
+    bool take(int self, Work* work) {
+        if (self >= 0) {
+            Queue& queue = fQueues[self];
+            SkAutoMutexAcquire lock(queue.fLock);
+            if (queue.fWork.count() > queue.fHead) {
+                queue.fWork.pop(work);
+                this->emptied(&queue);
+                sk_atomic_dec(&fQueued);
+                return true;
+            }
+        }
+        const int count = this->queueCount();
+        for (int i = 1; i <= count; i++) {
+            Queue& queue = fQueues[(self + i + count) % count];
+            SkAutoMutexAcquire lock(queue.fLock);
+            if (queue.fWork.count() > queue.fHead) {
+                *work = queue.fWork[queue.fHead++];
+                this->emptied(&queue);
+                sk_atomic_dec(&fQueued);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Once everything has been taken, reuse the queue's storage from the start.
+    void emptied(Queue* queue) {
+        if (queue->fWork.count() == queue->fHead) {
+            queue->fWork.rewind();
+            queue->fHead = 0;
+        }
+    }
+
+    // Called after work is counted in fQueued and queued. A sleeper raises fSleeping before
+    // its last check of fQueued, so either it sees the new work or we see it sleeping.
+    void wake(bool all) {
+        if (sk_atomic_load(&fSleeping) > 0) {
+            AutoLock lock(&fReady);
+            all ? fReady.broadcast() : fReady.signal();
+        }
+    }
+
     void add(void (*fn)(void*), void* arg, int32_t* pending) {
         Work work = { fn, arg, pending };
         sk_atomic_inc(pending);  // No barrier needed.
-        {
-            AutoLock lock(&fReady);
-            fWork.push(work);
-            fReady.signal();
-        }
+        // Count the work before it is queued, so fQueued never falls below zero.
+        sk_atomic_inc(&fQueued);
+        this->push(this->queueForAdd(), &work, 1);
+        this->wake(false);
     }
 
     void batch(void (*fn)(void*), void* arg, int N, size_t stride, int32_t* pending) {
+        if (N <= 0) {
+            return;
+        }
         sk_atomic_add(pending, N);  // No barrier needed.
-        {
-            AutoLock lock(&fReady);
-            Work* batch = fWork.append(N);
-            for (int i = 0; i < N; i++) {
-                Work work = { fn, (char*)arg + i*stride, pending };
-                batch[i] = work;
-            }
-            fReady.broadcast();
+        SkAutoSTMalloc<64, Work> batch(N);
+        for (int i = 0; i < N; i++) {
+            Work work = { fn, (char*)arg + i*stride, pending };
+            batch[i] = work;
+        }
+        sk_atomic_add(&fQueued, N);
+        // Deal the batch out in even slices, so every thread starts with some of it.
+        const int self = CurrentQueue();
+        const int slices = SkTMin(N, this->queueCount());
+        const int first = self >= 0 ? self : this->queueForAdd();
+        for (int i = 0; i < slices; i++) {
+            int start = (int)((int64_t)N * i / slices);
+            int end = (int)((int64_t)N * (i + 1) / slices);
+            this->push((first + i) % this->queueCount(), &batch[start], end - start);
         }
+        this->wake(true);
     }
 
     static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
+        Worker* worker = (Worker*)arg;
+        ThreadPool* pool = worker->fPool;
+        *(int*)SkTLS::Get(CreateQueueIndex, DeleteQueueIndex) = worker->fIndex;
         Work work;
         while (true) {
-            {
+            if (!pool->take(worker->fIndex, &work)) {
                 AutoLock lock(&pool->fReady);
-                while (pool->fWork.isEmpty()) {
-                    if (pool->fDraining) {
-                        return;
-                    }
+                sk_atomic_inc(&pool->fSleeping);
+                while (sk_atomic_load(&pool->fQueued) <= 0 && !pool->fDraining) {
                     pool->fReady.wait();
                 }
-                pool->fWork.pop(&work);
+                sk_atomic_dec(&pool->fSleeping);
+                if (sk_atomic_load(&pool->fQueued) <= 0 && pool->fDraining) {
+                    return;
+                }
+                continue;
             }
             work.fn(work.arg);
             sk_atomic_dec(work.pending);  // Release pairs with sk_acquire_load() in Wait().
         }
     }
 
-    SkTDArray<Work>      fWork;
+    SkAutoTArray<Queue>  fQueues;
+    SkAutoTArray<Worker> fWorkers;
     SkTDArray<SkThread*> fThreads;
     SkCondVar            fReady;
+    /*atomic*/ int32_t   fQueued;    // Work in all the queues.
+    /*atomic*/ int32_t   fSleeping;  // Threads waiting on fReady.
+    /*atomic*/ int32_t   fNext;      // Where outside threads add their next work.
     bool                 fDraining;
 
     static ThreadPool* gGlobal;
@@ -163,10 +283,10 @@ ThreadPool* ThreadPool::gGlobal = NULL;
 
 }  // namespace
 
-SkTaskGroup::Enabler::Enabler(int threads) {
+SkTaskGroup::Enabler::Enabler(int threads, bool pinThreads) {
     SkASSERT(ThreadPool::gGlobal == NULL);
     if (threads != 0 && SkCondVar::Supported()) {
-        ThreadPool::gGlobal = SkNEW_ARGS(ThreadPool, (threads));
+        ThreadPool::gGlobal = SkNEW_ARGS(ThreadPool, (threads, pinThreads));
     }
 }
 
@@ -183,3 +303,81 @@ void SkTaskGroup::batch (void (*fn)(void*), void* args, int N, size_t stride) {
     ThreadPool::Batch(fn, args, N, stride, &fPending);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void SkTask::init(SkTaskGroup* group, void_fn fn, void* arg) {
+    fGroup = group;
+    fFn = fn;
+    fArg = arg;
+    fBlockers = 1;  // Held until start().
+}
+
+void SkTask::runAfter(SkTask* other) {
+    *other->fSuccessors.append() = this;
+    sk_atomic_inc(&fBlockers);  // No barrier needed; nothing has started yet.
+}
+
+void SkTask::start() { this->finishedOne(); }
+
+void SkTask::finishedOne() {
+    // The last one through schedules us.  Acquire-release pairs with the other decrements,
+    // so we see everything the tasks before us wrote.
+    if (1 == sk_atomic_fetch_add(&fBlockers, -1, sk_memory_order_acq_rel)) {
+        fGroup->add(&SkTask::Run, this);
+    }
+}
+
+void SkTask::Run(SkTask* task) {
+    task->fFn(task->fArg);
+    // Our successors are added to their groups before ours counts us as done, so a wait() on
+    // our group can't return before they're pending too when they share it.
+    for (int i = 0; i < task->fSuccessors.count(); i++) {
+        task->fSuccessors[i]->finishedOne();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Chunk {
+    void (*fn)(int, void*);
+    void* arg;
+    int   begin, end;
+};
+
+void run_chunk(Chunk* chunk) {
+    for (int i = chunk->begin; i < chunk->end; i++) {
+        chunk->fn(i, chunk->arg);
+    }
+}
+
+}  // namespace
+
+void sk_parallel_for(int begin, int end, int grain, void (*fn)(int, void*), void* arg) {
+    if (end <= begin) {
+        return;
+    }
+    const int count = end - begin;
+    const int threads = ThreadPool::ThreadCount();
+    if (grain <= 0) {
+        // A few chunks per thread evens out uneven chunks without much scheduling overhead.
+        grain = SkTMax(1, count / SkTMax(1, 4 * threads));
+    }
+    const int chunkCount = (int)(((int64_t)count + grain - 1) / grain);
+    if (chunkCount <= 1 || 0 == threads) {
+        Chunk chunk = { fn, arg, begin, end };
+        return run_chunk(&chunk);
+    }
+
+    SkAutoSTMalloc<32, Chunk> chunks(chunkCount);
+    for (int i = 0; i < chunkCount; i++) {
+        chunks[i].fn = fn;
+        chunks[i].arg = arg;
+        chunks[i].begin = begin + i * grain;
+        chunks[i].end = SkTMin(end, chunks[i].begin + grain);
+    }
+    SkTaskGroup tg;
+    tg.batch(run_chunk, chunks.get(), chunkCount);
+    tg.wait();
+}
@@ -8,6 +8,7 @@
 #ifndef SkTaskGroup_DEFINED
 #define SkTaskGroup_DEFINED
 
+#include "SkTDArray.h"
 #include "SkTypes.h"
 
 struct SkRunnable;
@@ -16,7 +17,9 @@ class SkTaskGroup : SkNoncopyable {
 public:
     // Create one of these in main() to enable SkTaskGroups globally.
     struct Enabler : SkNoncopyable {
-        explicit Enabler(int threads = -1);  // Default is system-reported core count.
+        // Default is system-reported core count.  If pinThreads is true, each thread is
+        // bound to one core.
+        explicit Enabler(int threads = -1, bool pinThreads = false);
         ~Enabler();
     };
 
@@ -25,6 +28,7 @@ public:
 
     // Add a task to this SkTaskGroup.  It will likely run on another thread.
     // Neither add() method takes owership of any of its parameters.
+    // Tasks may add more tasks, to this or any other SkTaskGroup, and wait() on them.
     void add(SkRunnable*);
 
     template <typename T>
@@ -48,4 +52,45 @@ private:
     /*atomic*/ int32_t fPending;
 };
 
+// A task that runs in an SkTaskGroup once the tasks it depends on have all finished, without
+// anyone blocking to wait for them.  Link tasks together with runAfter(), then start() every
+// one of them; each runs once it has been started and everything before it has run.
+// The caller owns its SkTasks, and must keep them alive until their group's wait() returns.
+class SkTask : SkNoncopyable {
+public:
+    template <typename T>
+    SkTask(SkTaskGroup* group, void (*fn)(T*), T* arg) {
+        this->init(group, (void_fn)fn, (void*)arg);
+    }
+
+    // Don't run this until other has run.  Only call this before either task is started.
+    void runAfter(SkTask* other);
+
+    // This task may now run, as soon as everything it runs after has.  Call this once.
+    void start();
+
+private:
+    typedef void(*void_fn)(void*);
+
+    void init(SkTaskGroup*, void_fn, void* arg);
+    void finishedOne();
+    static void Run(SkTask*);
+
+    SkTaskGroup*       fGroup;
+    void_fn            fFn;
+    void*              fArg;
+    SkTDArray<SkTask*> fSuccessors;
+    /*atomic*/ int32_t fBlockers;    // Unfinished tasks before this one, plus one until start().
+};
+
+// Calls fn(i, arg) for every i in [begin, end), in chunks of grain indices spread over the
+// thread pool, and returns once they have all been called.  If grain is <= 0, the indices are
+// chunked to give a few chunks to each thread.
+void sk_parallel_for(int begin, int end, int grain, void (*fn)(int, void*), void* arg);
+
+template <typename T>
+void sk_parallel_for(int begin, int end, int grain, void (*fn)(int, T*), T* arg) {
+    sk_parallel_for(begin, end, grain, (void (*)(int, void*))fn, (void*)arg);
+}
+
 #endif//SkTaskGroup_DEFINED
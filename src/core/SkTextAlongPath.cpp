@@ -0,0 +1,185 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTextAlongPath.h"
+#include "SkAtomics.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkResourceCache.h"
+#include "SkTemplates.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+static bool gFastTextOnPathEnabled = false;
+static int32_t gPathMeasureCacheHits = 0;
+static int32_t gPathMeasureCacheMisses = 0;
+
+SkSharedPathMeasure::SkSharedPathMeasure(const SkPath& path) : fPath(path) {
+    fMeasure.setPath(&fPath, false);
+    // Build the distance table now, while nobody else can see us.
+    fLength = fMeasure.getLength();
+}
+
+size_t SkSharedPathMeasure::bytesUsed() const {
+    // Besides our copy of the points, the table holds a few segments for each of them.
+    static const int kSegmentsPerPoint = 4;
+    static const size_t kSegmentSize = sizeof(SkScalar) + sizeof(uint32_t);
+    return sizeof(*this) + fPath.countPoints() * (sizeof(SkPoint) +
+                                                  kSegmentsPerPoint * kSegmentSize);
+}
+
+namespace {
+static unsigned gPathMeasureKeyNamespaceLabel;
+
+// Tagged with the path's generation ID, so its entry can be purged by it.
+static uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'm', 's', 'r');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct PathMeasureKey : public SkResourceCache::Key {
+public:
+    explicit PathMeasureKey(const SkPath& path) : fGenID(path.getGenerationID()) {
+        this->init(&gPathMeasureKeyNamespaceLabel, make_shared_id(fGenID), sizeof(fGenID));
+    }
+
+    uint32_t fGenID;
+};
+
+struct PathMeasureRec : public SkResourceCache::Rec {
+    PathMeasureRec(const PathMeasureKey& key, SkSharedPathMeasure* measure)
+        : fKey(key)
+        , fMeasure(SkRef(measure))
+    {}
+
+    PathMeasureKey                    fKey;
+    SkAutoTUnref<SkSharedPathMeasure> fMeasure;
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "path-measure"; }
+    size_t bytesUsed() const override { return sizeof(*this) + fMeasure->bytesUsed(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextMeasure) {
+        const PathMeasureRec& rec = static_cast<const PathMeasureRec&>(baseRec);
+        SkSharedPathMeasure** result = (SkSharedPathMeasure**)contextMeasure;
+
+        *result = SkRef(rec.fMeasure.get());
+        return true;
+    }
+};
+} // namespace
+
+bool SkTextAlongPath::IsEnabled() {
+    return gFastTextOnPathEnabled;
+}
+
+bool SkTextAlongPath::SetEnabled(bool enabled) {
+    bool prev = gFastTextOnPathEnabled;
+    gFastTextOnPathEnabled = enabled;
+    return prev;
+}
+
+SkSharedPathMeasure* SkTextAlongPath::RefMeasure(const SkPath& path, SkResourceCache* localCache) {
+    // Volatile paths won't be drawn along again.
+    if (path.isVolatile()) {
+        return SkNEW_ARGS(SkSharedPathMeasure, (path));
+    }
+
+    PathMeasureKey key(path);
+    SkSharedPathMeasure* measure = NULL;
+    if (CHECK_LOCAL(localCache, find, Find, key, PathMeasureRec::Visitor, &measure)) {
+        sk_atomic_inc(&gPathMeasureCacheHits);
+        return measure;
+    }
+    sk_atomic_inc(&gPathMeasureCacheMisses);
+
+    measure = SkNEW_ARGS(SkSharedPathMeasure, (path));
+    CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(PathMeasureRec, (key, measure)));
+    return measure;
+}
+
+bool SkTextAlongPath::ComputeXforms(const void* text, size_t byteLength, const SkPaint& paint,
+                                 const SkSharedPathMeasure& measure, const SkMatrix* matrix,
+                                 SkTDArray<uint16_t>* glyphs, SkTDArray<SkRSXform>* xforms) {
+    glyphs->rewind();
+    xforms->rewind();
+
+    if (paint.isVerticalText() ||
+        (matrix && (matrix->getType() & ~SkMatrix::kTranslate_Mask))) {
+        return false;
+    }
+    const int count = paint.textToGlyphs(text, byteLength, NULL);
+    if (count <= 0) {
+        return true;
+    }
+
+    SkAutoSTMalloc<64, uint16_t> ids(count);
+    SkAutoSTMalloc<64, SkScalar> widths(count);
+    paint.textToGlyphs(text, byteLength, ids.get());
+    paint.getTextWidths(text, byteLength, widths.get());
+
+    // Line the text up along the path as SkBaseDevice::drawTextOnPath() does.
+    const SkScalar length = measure.length();
+    SkScalar x = 0;
+    if (SkPaint::kLeft_Align != paint.getTextAlign()) {
+        SkScalar width = 0;
+        for (int i = 0; i < count; ++i) {
+            width += widths[i];
+        }
+        x = length - width;
+        if (SkPaint::kCenter_Align == paint.getTextAlign()) {
+            x = SkScalarHalf(x);
+        }
+    }
+    SkScalar y = 0;
+    if (matrix) {
+        x += matrix->getTranslateX();
+        y = matrix->getTranslateY();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const SkScalar halfWidth = SkScalarHalf(widths[i]);
+        const SkScalar middle = x + halfWidth;
+        x += widths[i];
+
+        SkPoint pos;
+        SkVector tan;
+        if (middle < 0 || middle > length || !measure.getPosTan(middle, &pos, &tan)) {
+            continue;
+        }
+        // Rotate the glyph about its middle, then push it out along the normal, matching the
+        // way morphpoints() maps (x, y) to pos + y * (-tan.fY, tan.fX).
+        SkRSXform* xform = xforms->append();
+        xform->fSCos = tan.fX;
+        xform->fSSin = tan.fY;
+        xform->fTx   = pos.fX - SkScalarMul(tan.fX, halfWidth) - SkScalarMul(tan.fY, y);
+        xform->fTy   = pos.fY - SkScalarMul(tan.fY, halfWidth) + SkScalarMul(tan.fX, y);
+        *glyphs->append() = ids[i];
+    }
+    return true;
+}
+
+void SkTextAlongPath::GetStats(Stats* stats) {
+    stats->fHits = sk_atomic_load(&gPathMeasureCacheHits);
+    stats->fMisses = sk_atomic_load(&gPathMeasureCacheMisses);
+}
+
+void SkTextAlongPath::ResetStats() {
+    sk_atomic_store(&gPathMeasureCacheHits, 0);
+    sk_atomic_store(&gPathMeasureCacheMisses, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkGraphics::GetFastTextOnPathEnabled() {
+    return SkTextAlongPath::IsEnabled();
+}
+
+bool SkGraphics::SetFastTextOnPathEnabled(bool enabled) {
+    return SkTextAlongPath::SetEnabled(enabled);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextAlongPath_DEFINED
+#define SkTextAlongPath_DEFINED
+
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "SkPathMeasure.h"
+#include "SkRefCnt.h"
+#include "SkTDArray.h"
+
+class SkPaint;
+class SkResourceCache;
+
+/**
+ *  A rotation and uniform scale followed by a translation, packed as
+ *      [ fSCos -fSSin fTx ]
+ *      [ fSSin  fSCos fTy ]
+ */
+struct SkRSXform {
+    SkScalar fSCos;
+    SkScalar fSSin;
+    SkScalar fTx;
+    SkScalar fTy;
+
+    void toMatrix(SkMatrix* matrix) const {
+        matrix->setAll(fSCos, -fSSin, fTx,
+                       fSSin,  fSCos, fTy,
+                       0,      0,     1);
+    }
+};
+
+/**
+ *  An SkPathMeasure over its own copy of a path, with the distance table built up front. After
+ *  that, getLength() and getPosTan() only read the table, so one of these can be shared by any
+ *  number of draws and threads.
+ */
+class SkSharedPathMeasure : public SkRefCnt {
+public:
+    explicit SkSharedPathMeasure(const SkPath& path);
+
+    SkScalar length() const { return fLength; }
+    bool getPosTan(SkScalar distance, SkPoint* pos, SkVector* tangent) const {
+        return fMeasure.getPosTan(distance, pos, tangent);
+    }
+
+    /** For code written against SkPathMeasure. Only call getLength() and getPosTan(). */
+    SkPathMeasure* measure() const { return &fMeasure; }
+
+    size_t bytesUsed() const;
+
+private:
+    SkPath                fPath;
+    mutable SkPathMeasure fMeasure;
+    SkScalar              fLength;
+
+    typedef SkRefCnt INHERITED;
+};
+
+/**
+ *  Shared path measures, and placing whole glyphs along a path.
+ *
+ *  SkBitmapDevice draws text on a path with ComputeXforms() and SkDraw::drawTextRSXform() only
+ *  while enabled (it is off by default, see SkGraphics::SetFastTextOnPathEnabled()). Otherwise
+ *  it bends each glyph's outline, though still along a measure from RefMeasure().
+ */
+class SkTextAlongPath {
+public:
+    static bool IsEnabled();
+    static bool SetEnabled(bool enabled);   // returns the previous setting
+
+    /**
+     *  Returns the measure of path (not force-closed), which the caller must unref. Measures of
+     *  non-volatile paths are kept in the resource cache, keyed by the path's generation ID, so
+     *  drawing along the same path again reuses its distance table.
+     */
+    static SkSharedPathMeasure* RefMeasure(const SkPath& path,
+                                           SkResourceCache* localCache = NULL);
+
+    /**
+     *  Places each glyph of text along the path as SkCanvas::drawTextOnPath() would, but as a
+     *  whole: rather than bending its outline, each glyph is rotated to the path's tangent at
+     *  the glyph's middle, and offset along the normal by the matrix's y translation. Glyphs
+     *  whose middles fall off either end of the path are left out.
+     *
+     *  Each xform maps the glyph's own space (origin on the baseline, at the paint's text size)
+     *  to the path's space. Only translating matrices are supported, and NULL means identity.
+     *  Returns false if the text or the matrix can't be placed this way.
+     */
+    static bool ComputeXforms(const void* text, size_t byteLength, const SkPaint& paint,
+                              const SkSharedPathMeasure& measure, const SkMatrix* matrix,
+                              SkTDArray<uint16_t>* glyphs, SkTDArray<SkRSXform>* xforms);
+
+    struct Stats {
+        int32_t fHits;
+        int32_t fMisses;
+    };
+
+    /** RefMeasure() hits and misses, counted across all caches since the last ResetStats(). */
+    static void GetStats(Stats*);
+    static void ResetStats();
+};
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTextRunCache.h"
+#include "SkAtomics.h"
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkTextBlob.h"
+#include "SkTypeface.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+static bool gTextRunCacheEnabled = false;
+static int32_t gTextRunCacheHits = 0;
+static int32_t gTextRunCacheMisses = 0;
+
+namespace {
+static unsigned gTextRunKeyNamespaceLabel;
+
+// Shared by every string drawn in one typeface, so all of them can be purged together.
+static uint64_t make_shared_id(uint32_t fontID) {
+    uint64_t sharedID = SkSetFourByteTag('t', 'r', 'u', 'n');
+    return (sharedID << 32) | fontID;
+}
+
+struct TextRunKey : public SkResourceCache::Key {
+public:
+    TextRunKey(const void* text, size_t length, const SkPaint& paint)
+        : fFontID(SkTypeface::UniqueID(paint.getTypeface()))
+        , fSize(paint.getTextSize())
+        , fScaleX(paint.getTextScaleX())
+        , fSkewX(paint.getTextSkewX())
+        , fFlags(paint.getFlags())
+        , fHinting(paint.getHinting())
+        , fEncoding(paint.getTextEncoding())
+        , fAlign(paint.getTextAlign())
+        , fLength(SkToU32(length))
+    {
+        SkASSERT(length <= SkTextRunCache::kMaxTextLength);
+        // Only the words the text covers are part of the key, so zero the last one's padding.
+        const size_t textWords = SkAlign4(length) >> 2;
+        if (textWords > 0) {
+            fText[textWords - 1] = 0;
+        }
+        memcpy(fText, text, length);
+        this->init(&gTextRunKeyNamespaceLabel, make_shared_id(fFontID),
+                   sizeof(fFontID) + sizeof(fSize) + sizeof(fScaleX) + sizeof(fSkewX) +
+                   sizeof(fFlags) + sizeof(fHinting) + sizeof(fEncoding) + sizeof(fAlign) +
+                   sizeof(fLength) + (textWords << 2));
+    }
+
+    uint32_t fFontID;
+    SkScalar fSize;
+    SkScalar fScaleX;
+    SkScalar fSkewX;
+    uint32_t fFlags;
+    int32_t  fHinting;
+    int32_t  fEncoding;
+    int32_t  fAlign;
+    uint32_t fLength;
+    uint32_t fText[SkTextRunCache::kMaxTextLength >> 2];
+};
+
+struct TextRunCacheRec : public SkResourceCache::Rec {
+    TextRunCacheRec(const TextRunKey& key, const SkTextBlob* blob)
+        : fKey(key)
+        , fBlob(SkRef(blob))
+    {}
+
+    TextRunKey                     fKey;
+    SkAutoTUnref<const SkTextBlob> fBlob;
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "text-run"; }
+    size_t bytesUsed() const override {
+        // Each glyph has an ID and an x position, and no encoding takes less than a byte a glyph.
+        return sizeof(*this) + sizeof(SkTextBlob) +
+               fKey.fLength * (sizeof(uint16_t) + sizeof(SkScalar));
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextBlob) {
+        const TextRunCacheRec& rec = static_cast<const TextRunCacheRec&>(baseRec);
+        const SkTextBlob** result = (const SkTextBlob**)contextBlob;
+
+        *result = SkRef(rec.fBlob.get());
+        return true;
+    }
+};
+} // namespace
+
+bool SkTextRunCache::IsEnabled() {
+    return gTextRunCacheEnabled;
+}
+
+bool SkTextRunCache::SetEnabled(bool enabled) {
+    bool prev = gTextRunCacheEnabled;
+    gTextRunCacheEnabled = enabled;
+    return prev;
+}
+
+bool SkTextRunCache::CanCache(const void* text, size_t length, const SkPaint& paint) {
+    return text && length > 0 && length <= kMaxTextLength &&
+           !paint.isVerticalText() && !paint.isDevKernText();
+}
+
+const SkTextBlob* SkTextRunCache::Find(const void* text, size_t length, const SkPaint& paint,
+                                       SkResourceCache* localCache) {
+    if (!CanCache(text, length, paint)) {
+        return NULL;
+    }
+    TextRunKey key(text, length, paint);
+    const SkTextBlob* blob = NULL;
+    if (!CHECK_LOCAL(localCache, find, Find, key, TextRunCacheRec::Visitor, &blob)) {
+        sk_atomic_inc(&gTextRunCacheMisses);
+        return NULL;
+    }
+    sk_atomic_inc(&gTextRunCacheHits);
+    return blob;
+}
+
+void SkTextRunCache::Add(const void* text, size_t length, const SkPaint& paint,
+                         const SkTextBlob* blob, SkResourceCache* localCache) {
+    if (!CanCache(text, length, paint)) {
+        return;
+    }
+    TextRunKey key(text, length, paint);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(TextRunCacheRec, (key, blob)));
+}
+
+const SkTextBlob* SkTextRunCache::Create(const void* text, size_t length, const SkPaint& paint) {
+    if (!CanCache(text, length, paint)) {
+        return NULL;
+    }
+    const int count = paint.textToGlyphs(text, length, NULL);
+    if (count <= 0) {
+        return NULL;
+    }
+
+    SkPaint font(paint);
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    font.setTextAlign(SkPaint::kLeft_Align);
+
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer& run = builder.allocRunPosH(font, count, 0);
+    paint.textToGlyphs(text, length, run.glyphs);
+
+    // Sum the advances in fixed point, as SkDraw::drawText() does.
+    SkFixed x = 0;
+    {
+        SkAutoGlyphCache autoCache(font, NULL, NULL);
+        SkGlyphCache* cache = autoCache.getCache();
+        for (int i = 0; i < count; ++i) {
+            run.pos[i] = SkFixedToScalar(x);
+            x += cache->getGlyphIDAdvance(run.glyphs[i]).fAdvanceX;
+        }
+    }
+
+    if (SkPaint::kLeft_Align != paint.getTextAlign()) {
+        SkScalar offset = SkFixedToScalar(x);
+        if (SkPaint::kCenter_Align == paint.getTextAlign()) {
+            offset = SkScalarHalf(offset);
+        }
+        for (int i = 0; i < count; ++i) {
+            run.pos[i] -= offset;
+        }
+    }
+    return builder.build();
+}
+
+const SkTextBlob* SkTextRunCache::FindOrCreate(const void* text, size_t length,
+                                               const SkPaint& paint) {
+    const SkTextBlob* blob = Find(text, length, paint);
+    if (NULL == blob) {
+        blob = Create(text, length, paint);
+        if (blob) {
+            Add(text, length, paint, blob);
+        }
+    }
+    return blob;
+}
+
+void SkTextRunCache::GetStats(Stats* stats) {
+    stats->fHits = sk_atomic_load(&gTextRunCacheHits);
+    stats->fMisses = sk_atomic_load(&gTextRunCacheMisses);
+}
+
+void SkTextRunCache::ResetStats() {
+    sk_atomic_store(&gTextRunCacheHits, 0);
+    sk_atomic_store(&gTextRunCacheMisses, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkGraphics::GetTextRunCacheEnabled() {
+    return SkTextRunCache::IsEnabled();
+}
+
+bool SkGraphics::SetTextRunCacheEnabled(bool enabled) {
+    return SkTextRunCache::SetEnabled(enabled);
+}
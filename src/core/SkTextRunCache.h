@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextRunCache_DEFINED
+#define SkTextRunCache_DEFINED
+
+#include "SkResourceCache.h"
+
+class SkPaint;
+class SkTextBlob;
+
+/**
+ *  Remembers how a string lays out: a text blob with one run of glyph IDs, positioned along the
+ *  baseline by their advances (as SkPaint::measureText() would). The key is the text itself
+ *  plus the paint's typeface, size, scale, skew, flags, hinting, encoding and alignment. Entries
+ *  live in the SkResourceCache, so they share its budget and are purged with it.
+ *
+ *  The alignment is already applied to the positions, so the blob draws like
+ *  SkCanvas::drawText() at the same origin with a left-aligned copy of the paint.
+ *
+ *  The global cache is consulted by SkCanvas only while enabled (it is off by default, see
+ *  SkGraphics::SetTextRunCacheEnabled()).
+ */
+class SkTextRunCache {
+public:
+    static bool IsEnabled();
+    static bool SetEnabled(bool enabled);   // returns the previous setting
+
+    /**
+     *  Vertical text, device kerning and strings longer than kMaxTextLength bytes aren't cached.
+     */
+    enum { kMaxTextLength = 128 };
+    static bool CanCache(const void* text, size_t length, const SkPaint& paint);
+
+    /**
+     *  If text drawn with paint is cached, return its blob, which the caller must unref.
+     *  Otherwise return NULL.
+     */
+    static const SkTextBlob* Find(const void* text, size_t length, const SkPaint& paint,
+                                  SkResourceCache* localCache = NULL);
+
+    /**
+     *  Add the blob for text drawn with paint to the cache.
+     */
+    static void Add(const void* text, size_t length, const SkPaint& paint, const SkTextBlob* blob,
+                    SkResourceCache* localCache = NULL);
+
+    /**
+     *  Lay out text drawn with paint as described above, returning a blob the caller must unref,
+     *  or NULL if the text isn't cacheable or has no glyphs.
+     */
+    static const SkTextBlob* Create(const void* text, size_t length, const SkPaint& paint);
+
+    /**
+     *  Find() in the global cache, or Create() and Add() on a miss.
+     */
+    static const SkTextBlob* FindOrCreate(const void* text, size_t length, const SkPaint& paint);
+
+    struct Stats {
+        int32_t fHits;
+        int32_t fMisses;
+    };
+
+    /** Find() hits and misses, counted across all caches since the last ResetStats(). */
+    static void GetStats(Stats*);
+    static void ResetStats();
+};
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTileGrid.h"
+#include "SkTSort.h"
+
+SkTileGrid::SkTileGrid(int xTiles, int yTiles, const SkTileGridFactory::TileGridInfo& info)
+    : fXTiles(xTiles)
+    , fYTiles(yTiles)
+    , fTileWidth(SkIntToScalar(info.fTileInterval.width()))
+    , fTileHeight(SkIntToScalar(info.fTileInterval.height()))
+    , fMarginWidth(SkIntToScalar(info.fMargin.width()))
+    , fMarginHeight(SkIntToScalar(info.fMargin.height()))
+    , fOffset(SkPoint::Make(SkIntToScalar(info.fOffset.fX), SkIntToScalar(info.fOffset.fY)))
+    , fRootBound(SkRect::MakeEmpty()) {
+    SkASSERT(fXTiles > 0 && fYTiles > 0);
+    SkASSERT(fTileWidth > 0 && fTileHeight > 0);
+}
+
+void SkTileGrid::TileRange(SkScalar lo, SkScalar hi, SkScalar interval, int count,
+                           int* first, int* last) {
+    // Pin before converting, so huge bounds can't overflow an int.  A single point (lo == hi)
+    // gets the one tile it falls in.
+    const SkScalar max = SkIntToScalar(count);
+    *first = SkScalarFloorToInt(SkScalarPin(lo / interval, 0, max));
+    *last  = SkScalarCeilToInt(SkScalarPin(hi / interval, 0, max)) - 1;
+    *first = SkTMin(*first, count - 1);
+    *last  = SkTMax(*first, SkTMin(*last, count - 1));
+}
+
+void SkTileGrid::boundsToTiles(const SkRect& bounds, SkIRect* tiles) const {
+    // Ops are outset by the margin...
+    TileRange(bounds.fLeft + fOffset.fX - fMarginWidth,
+              bounds.fRight + fOffset.fX + fMarginWidth,
+              fTileWidth, fXTiles, &tiles->fLeft, &tiles->fRight);
+    TileRange(bounds.fTop + fOffset.fY - fMarginHeight,
+              bounds.fBottom + fOffset.fY + fMarginHeight,
+              fTileHeight, fYTiles, &tiles->fTop, &tiles->fBottom);
+}
+
+void SkTileGrid::queryToTiles(const SkRect& query, SkIRect* tiles) const {
+    // ... and queries are inset by it, so that a grid-aligned query of
+    // fTileInterval + 2 * fMargin lands in a single tile.  A query too small to inset still
+    // finds everything it intersects in the tile holding its center: any op reaching into the
+    // query comes within fMargin of that center.
+    SkScalar left  = query.fLeft  + fOffset.fX + fMarginWidth,
+             right = query.fRight + fOffset.fX - fMarginWidth;
+    if (left < right) {
+        TileRange(left, right, fTileWidth, fXTiles, &tiles->fLeft, &tiles->fRight);
+    } else {
+        SkScalar center = SkScalarHalf(query.fLeft + query.fRight) + fOffset.fX;
+        TileRange(center, center, fTileWidth, fXTiles, &tiles->fLeft, &tiles->fRight);
+    }
+
+    SkScalar top    = query.fTop    + fOffset.fY + fMarginHeight,
+             bottom = query.fBottom + fOffset.fY - fMarginHeight;
+    if (top < bottom) {
+        TileRange(top, bottom, fTileHeight, fYTiles, &tiles->fTop, &tiles->fBottom);
+    } else {
+        SkScalar center = SkScalarHalf(query.fTop + query.fBottom) + fOffset.fY;
+        TileRange(center, center, fTileHeight, fYTiles, &tiles->fTop, &tiles->fBottom);
+    }
+}
+
+void SkTileGrid::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(fOps.isEmpty());
+
+    // First count how many ops land in each tile, then lay the tiles out back to back.
+    // Tile ranges are inclusive.  Empty ops are skipped.
+    SkAutoTMalloc<SkIRect> ranges(N);
+    fTileStarts.setCount(fXTiles * fYTiles + 1);
+    sk_bzero(fTileStarts.begin(), fTileStarts.count() * sizeof(int));
+
+    for (int i = 0; i < N; ++i) {
+        const SkRect& bounds = boundsArray[i];
+        if (bounds.isEmpty()) {
+            continue;
+        }
+        fRootBound.join(bounds);
+        this->boundsToTiles(bounds, &ranges[i]);
+        for (int y = ranges[i].fTop; y <= ranges[i].fBottom; ++y) {
+            for (int x = ranges[i].fLeft; x <= ranges[i].fRight; ++x) {
+                fTileStarts[y * fXTiles + x + 1]++;
+            }
+        }
+    }
+
+    for (int i = 1; i < fTileStarts.count(); ++i) {
+        fTileStarts[i] += fTileStarts[i - 1];
+    }
+    fOps.setCount(fTileStarts.top());
+
+    // Filling in op order leaves each tile's list sorted.
+    SkAutoTMalloc<int> cursors(fXTiles * fYTiles);
+    memcpy(cursors.get(), fTileStarts.begin(), fXTiles * fYTiles * sizeof(int));
+    for (int i = 0; i < N; ++i) {
+        if (boundsArray[i].isEmpty()) {
+            continue;
+        }
+        const SkIRect& range = ranges[i];
+        for (int y = range.fTop; y <= range.fBottom; ++y) {
+            for (int x = range.fLeft; x <= range.fRight; ++x) {
+                fOps[cursors[y * fXTiles + x]++] = i;
+            }
+        }
+    }
+}
+
+void SkTileGrid::search(const SkRect& query, SkTDArray<unsigned>* results) const {
+    if (fOps.isEmpty() || query.isEmpty()) {
+        return;
+    }
+
+    SkIRect tiles;
+    this->queryToTiles(query, &tiles);
+
+    if (tiles.fLeft == tiles.fRight && tiles.fTop == tiles.fBottom) {
+        // The common case for tiled playback: the answer is already sitting in one tile.
+        int tile = tiles.fTop * fXTiles + tiles.fLeft;
+        results->append(fTileStarts[tile + 1] - fTileStarts[tile],
+                        fOps.begin() + fTileStarts[tile]);
+        return;
+    }
+
+    // Gather every tile's ops, then sort and drop the duplicates of ops spanning several tiles.
+    const int start = results->count();
+    for (int y = tiles.fTop; y <= tiles.fBottom; ++y) {
+        for (int x = tiles.fLeft; x <= tiles.fRight; ++x) {
+            int tile = y * fXTiles + x;
+            results->append(fTileStarts[tile + 1] - fTileStarts[tile],
+                            fOps.begin() + fTileStarts[tile]);
+        }
+    }
+    if (results->count() - start < 2) {
+        return;
+    }
+
+    unsigned* ops = results->begin() + start;
+    SkTQSort(ops, results->end() - 1);
+    int unique = 1;
+    for (int i = 1; i < results->count() - start; ++i) {
+        if (ops[i] != ops[unique - 1]) {
+            ops[unique++] = ops[i];
+        }
+    }
+    results->setCount(start + unique);
+}
+
+size_t SkTileGrid::bytesUsed() const {
+    return sizeof(SkTileGrid) + fTileStarts.reserved() * sizeof(int)
+                              + fOps.reserved() * sizeof(unsigned);
+}
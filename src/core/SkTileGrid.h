@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTileGrid_DEFINED
+#define SkTileGrid_DEFINED
+
+#include "SkBBHFactory.h"
+#include "SkBBoxHierarchy.h"
+
+/**
+ * Subclass of SkBBoxHierarchy that stores elements in buckets that correspond
+ * to tile regions, disposed in a regular grid.  This is useful when the tile
+ * structure that will be used in search() calls is known prior to insertion.
+ *
+ * Each tile's list is precomputed and packed into one array at insert() time, so a query that
+ * covers a single tile just copies that tile's ops.  Results may include ops whose bounds
+ * share a tile with the query without actually intersecting it.
+ */
+class SkTileGrid : public SkBBoxHierarchy {
+public:
+    SkTileGrid(int xTiles, int yTiles, const SkTileGridFactory::TileGridInfo& info);
+    virtual ~SkTileGrid() {}
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, SkTDArray<unsigned>* results) const override;
+    size_t bytesUsed() const override;
+    SkRect getRootBound() const override { return fRootBound; }
+
+    // For testing.
+    int tileCount(int x, int y) const {
+        SkASSERT(x >= 0 && x < fXTiles && y >= 0 && y < fYTiles);
+        int tile = y * fXTiles + x;
+        return fTileStarts.isEmpty() ? 0 : fTileStarts[tile + 1] - fTileStarts[tile];
+    }
+
+private:
+    // Returns the inclusive range of tiles covered by the open interval (lo, hi), clamped to
+    // [0, count).  interval is the tile size.
+    static void TileRange(SkScalar lo, SkScalar hi, SkScalar interval, int count,
+                          int* first, int* last);
+
+    // Sets tiles to the tiles an op with these bounds is stored in.
+    void boundsToTiles(const SkRect& bounds, SkIRect* tiles) const;
+
+    // Sets tiles to the tiles that may hold ops intersecting query.
+    void queryToTiles(const SkRect& query, SkIRect* tiles) const;
+
+    const int fXTiles, fYTiles;
+    const SkScalar fTileWidth, fTileHeight;
+    const SkScalar fMarginWidth, fMarginHeight;
+    const SkPoint fOffset;
+    SkRect fRootBound;
+
+    // The ops in tile i are fOps[fTileStarts[i]] through fOps[fTileStarts[i+1] - 1], ascending.
+    SkTDArray<int> fTileStarts;
+    SkTDArray<unsigned> fOps;
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
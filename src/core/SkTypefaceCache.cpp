@@ -10,6 +10,7 @@
 
 #include "SkTypefaceCache.h"
 #include "SkThread.h"
+#include "SkTraceMemoryDump.h"
 
 #define TYPEFACE_CACHE_LIMIT    1024
 
@@ -116,6 +117,23 @@ void SkTypefaceCache::PurgeAll() {
     Get().purgeAll();
 }
 
+void SkTypefaceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    static const char kDumpName[] = "skia/sk_typeface_cache";
+    int count, purgeable = 0;
+    {
+        SkAutoMutexAcquire ama(gMutex);
+        const SkTDArray<Rec>& array = Get().fArray;
+        count = array.count();
+        for (int i = 0; i < count; ++i) {
+            if (array[i].fFace->unique()) {
+                purgeable += 1;
+            }
+        }
+    }
+    dump->dumpNumericValue(kDumpName, "count", "objects", count);
+    dump->dumpNumericValue(kDumpName, "purgeable_count", "objects", purgeable);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -21,6 +21,8 @@
  *  they map to the same internal obj (e.g. CTFontRef on the mac)
  */
 
+class SkTraceMemoryDump;
+
 class SkTypefaceCache {
 public:
     SkTypefaceCache();
@@ -82,6 +84,12 @@ public:
      */
     static void Dump();
 
+    /**
+     *  Reports how many typefaces the cache holds, and how many of those only the cache owns,
+     *  under "skia/sk_typeface_cache".
+     */
+    static void DumpMemoryStatistics(SkTraceMemoryDump*);
+
 private:
     static SkTypefaceCache& Get();
 
@@ -33,6 +33,9 @@ bool SkValidatingReadBuffer::isValid() const {
     return !fError;
 }
 
+// The whole buffer is checked up front: it must start 4-byte aligned and be a multiple of 4 bytes
+// long. Every read moves the cursor by a multiple of 4, so it stays aligned, and each read then
+// only has to check that enough bytes are left.
 void SkValidatingReadBuffer::setMemory(const void* data, size_t size) {
     this->validate(IsPtrAlign4(data) && (SkAlign4(size) == size));
     if (!fError) {
@@ -40,20 +43,28 @@ void SkValidatingReadBuffer::setMemory(const void* data, size_t size) {
     }
 }
 
+bool SkValidatingReadBuffer::canRead(size_t size) {
+    SkASSERT(fError || IsPtrAlign4(fReader.peek()));
+    if (!fError && fReader.isAvailable(size)) {
+        return true;
+    }
+    this->validate(false);
+    return false;
+}
+
 const void* SkValidatingReadBuffer::skip(size_t size) {
-    size_t inc = SkAlign4(size);
     const void* addr = fReader.peek();
-    this->validate(IsPtrAlign4(addr) && fReader.isAvailable(inc));
-    if (!fError) {
+    // What's left is a multiple of 4 bytes, so if size fits, so does SkAlign4(size).
+    if (this->canRead(size)) {
         fReader.skip(size);
     }
     return addr;
 }
 
-// All the methods in this file funnel down into either readInt(), readScalar() or skip(),
-// followed by a memcpy. So we've got all our validation in readInt(), readScalar() and skip();
-// if they fail they'll return a zero value or skip nothing, respectively, and set fError to
-// true, which the caller should check to see if an error occurred during the read operation.
+// All the methods in this file funnel down into canRead(), either directly or through readInt(),
+// readScalar() or skip(), so each primitive, structure or array is bounds checked once. If that
+// fails they return a zero value or skip nothing and set fError to true, which the caller should
+// check to see if an error occurred during the read operation.
 
 bool SkValidatingReadBuffer::readBool() {
     uint32_t value = this->readInt();
@@ -71,15 +82,11 @@ SkFixed SkValidatingReadBuffer::readFixed() {
 }
 
 int32_t SkValidatingReadBuffer::readInt() {
-    const size_t inc = sizeof(int32_t);
-    this->validate(IsPtrAlign4(fReader.peek()) && fReader.isAvailable(inc));
-    return fError ? 0 : fReader.readInt();
+    return this->canRead(sizeof(int32_t)) ? fReader.readInt() : 0;
 }
 
 SkScalar SkValidatingReadBuffer::readScalar() {
-    const size_t inc = sizeof(SkScalar);
-    this->validate(IsPtrAlign4(fReader.peek()) && fReader.isAvailable(inc));
-    return fError ? 0 : fReader.readScalar();
+    return this->canRead(sizeof(SkScalar)) ? fReader.readScalar() : 0;
 }
 
 uint32_t SkValidatingReadBuffer::readUInt() {
@@ -120,8 +127,12 @@ void* SkValidatingReadBuffer::readEncodedString(size_t* length, SkPaint::TextEnc
 }
 
 void SkValidatingReadBuffer::readPoint(SkPoint* point) {
-    point->fX = this->readScalar();
-    point->fY = this->readScalar();
+    if (this->canRead(sizeof(SkPoint))) {
+        point->fX = fReader.readScalar();
+        point->fY = fReader.readScalar();
+    } else {
+        point->set(0, 0);
+    }
 }
 
 void SkValidatingReadBuffer::readMatrix(SkMatrix* matrix) {
@@ -173,17 +184,14 @@ void SkValidatingReadBuffer::readPath(SkPath* path) {
 
 bool SkValidatingReadBuffer::readArray(void* value, size_t size, size_t elementSize) {
     const uint32_t count = this->getArrayCount();
-    this->validate(size == count);
-    (void)this->skip(sizeof(uint32_t)); // Skip array count
+    // One check covers the count and all of the elements.
     const uint64_t byteLength64 = sk_64_mul(count, elementSize);
-    const size_t byteLength = count * elementSize;
-    this->validate(byteLength == byteLength64);
-    const void* ptr = this->skip(SkAlign4(byteLength));
-    if (!fError) {
-        memcpy(value, ptr, byteLength);
-        return true;
+    if (!this->validate(size == count && sizeof(uint32_t) + byteLength64 <= fReader.available())) {
+        return false;
     }
-    return false;
+    fReader.skip(sizeof(uint32_t));  // Skip array count
+    memcpy(value, fReader.skip((size_t)byteLength64), (size_t)byteLength64);
+    return true;
 }
 
 bool SkValidatingReadBuffer::readByteArray(void* value, size_t size) {
@@ -207,9 +215,7 @@ bool SkValidatingReadBuffer::readScalarArray(SkScalar* values, size_t size) {
 }
 
 uint32_t SkValidatingReadBuffer::getArrayCount() {
-    const size_t inc = sizeof(uint32_t);
-    fError = fError || !IsPtrAlign4(fReader.peek()) || !fReader.isAvailable(inc);
-    return fError ? 0 : *(uint32_t*)fReader.peek();
+    return this->canRead(sizeof(uint32_t)) ? *(const uint32_t*)fReader.peek() : 0;
 }
 
 SkTypeface* SkValidatingReadBuffer::readTypeface() {
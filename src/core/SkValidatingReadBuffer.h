@@ -67,6 +67,9 @@ public:
     bool validateAvailable(size_t size) override;
 
 private:
+    // Returns true if size more bytes are left to read; otherwise marks the buffer invalid.
+    bool canRead(size_t size);
+
     bool readArray(void* value, size_t size, size_t elementSize);
 
     void setMemory(const void* data, size_t size);
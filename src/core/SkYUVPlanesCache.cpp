@@ -47,6 +47,7 @@ struct YUVPlanesRec : public SkResourceCache::Rec {
     YUVValue      fValue;
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "yuv-planes"; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
@@ -132,6 +132,20 @@ SkXPSDevice::TypefaceUse::~TypefaceUse() {
     delete this->glyphsUsed;
 }
 
+SkXPSDevice::ImageUse::ImageUse()
+    : genID(0)
+    , pngData(NULL)
+    , xpsImage(NULL) {
+}
+
+SkXPSDevice::ImageUse::~ImageUse() {
+    //xpsImage reads from pngData through its own ref
+    if (this->xpsImage) {
+        this->xpsImage->Release();
+    }
+    SkSafeUnref(this->pngData);
+}
+
 bool SkXPSDevice::beginPortfolio(SkWStream* outputStream) {
     if (!this->fAutoCo.succeeded()) return false;
 
@@ -438,6 +452,7 @@ bool SkXPSDevice::endPortfolio() {
     }
 
     HRBM(this->fPackageWriter->Close(), "Could not close writer.");
+    this->fImages.reset();
 
     return true;
 }
@@ -626,29 +641,52 @@ static XPS_TILE_MODE SkToXpsTileMode[SkShader::kTileModeCount+1]
 /*None  */ XTM_N,  XTM_N,   XTM_Y,   XTM_N,
 };
 
-HRESULT SkXPSDevice::createXpsImageBrush(
+HRESULT SkXPSDevice::createXpsImageResource(
         const SkBitmap& bitmap,
-        const SkMatrix& localMatrix,
-        const SkShader::TileMode (&xy)[2],
-        const SkAlpha alpha,
-        IXpsOMTileBrush** xpsBrush) {
+        IXpsOMImageResource** xpsImage) {
+    const uint32_t genID = bitmap.getGenerationID();
+    const SkIPoint origin = bitmap.pixelRefOrigin();
+    const SkISize size = bitmap.dimensions();
+
+    //An image already written for these pixels is reused by later pages.
+    for (int i = 0; i < this->fImages.count(); ++i) {
+        const ImageUse& use = this->fImages[i];
+        if (use.genID == genID && use.origin == origin && use.size == size) {
+            use.xpsImage->AddRef();
+            *xpsImage = use.xpsImage;
+            return S_OK;
+        }
+    }
+
     SkDynamicMemoryWStream write;
     if (!SkImageEncoder::EncodeStream(&write, bitmap,
                                       SkImageEncoder::kPNG_Type, 100)) {
         HRM(E_FAIL, "Unable to encode bitmap as png.");
     }
+    SkAutoTUnref<SkData> pngData(write.copyToData());
+
+    //Different bitmaps with the same pixels share one image part too.
+    for (int i = 0; i < this->fImages.count(); ++i) {
+        const ImageUse& use = this->fImages[i];
+        if (use.pngData->equals(pngData.get())) {
+            use.xpsImage->AddRef();
+            *xpsImage = use.xpsImage;
+            return S_OK;
+        }
+    }
+
     SkMemoryStream* read = new SkMemoryStream;
-    read->setData(write.copyToData())->unref();
+    read->setData(pngData.get());
     SkTScopedComPtr<IStream> readWrapper;
     HRM(SkIStream::CreateFromSkStream(read, true, &readWrapper),
         "Could not create stream from png data.");
 
-    const size_t size =
+    const size_t bufferSize =
         SK_ARRAY_COUNT(L"/Documents/1/Resources/Images/" L_GUID_ID L".png");
-    wchar_t buffer[size];
+    wchar_t buffer[bufferSize];
     wchar_t id[GUID_ID_LEN];
     HR(this->createId(id, GUID_ID_LEN));
-    swprintf_s(buffer, size, L"/Documents/1/Resources/Images/%s.png", id);
+    swprintf_s(buffer, bufferSize, L"/Documents/1/Resources/Images/%s.png", id);
 
     SkTScopedComPtr<IOpcPartUri> imagePartUri;
     HRM(this->fXpsFactory->CreatePartUri(buffer, &imagePartUri),
@@ -662,6 +700,27 @@ HRESULT SkXPSDevice::createXpsImageBrush(
             &imageResource),
         "Could not create image resource.");
 
+    ImageUse& newImageUse = this->fImages.push_back();
+    newImageUse.genID = genID;
+    newImageUse.origin = origin;
+    newImageUse.size = size;
+    newImageUse.pngData = pngData.detach();
+    newImageUse.xpsImage = imageResource.get();
+    newImageUse.xpsImage->AddRef();
+
+    *xpsImage = imageResource.release();
+    return S_OK;
+}
+
+HRESULT SkXPSDevice::createXpsImageBrush(
+        const SkBitmap& bitmap,
+        const SkMatrix& localMatrix,
+        const SkShader::TileMode (&xy)[2],
+        const SkAlpha alpha,
+        IXpsOMTileBrush** xpsBrush) {
+    SkTScopedComPtr<IXpsOMImageResource> imageResource;
+    HR(this->createXpsImageResource(bitmap, &imageResource));
+
     XPS_RECT bitmapRect = {
         0.0, 0.0,
         static_cast<FLOAT>(bitmap.width()), static_cast<FLOAT>(bitmap.height())
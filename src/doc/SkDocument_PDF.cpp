@@ -12,7 +12,9 @@
 #include "SkPDFResourceDict.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
+#include "SkPictureRecorder.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
 static void emit_pdf_header(SkWStream* stream) {
     stream->writeText("%PDF-1.4\n%");
@@ -41,25 +43,13 @@ static void emit_pdf_footer(SkWStream* stream,
     stream->writeText("\n%%EOF");
 }
 
-static void perform_font_subsetting(
-        const SkTDArray<const SkPDFDevice*>& pageDevices,
-        SkPDFSubstituteMap* substituteMap) {
-    SkASSERT(substituteMap);
+static void compress_object(int i, const SkTDArray<SkPDFObject*>* objects) {
+    (*objects)[i]->compress();
+}
 
-    SkPDFGlyphSetMap usage;
-    for (int i = 0; i < pageDevices.count(); ++i) {
-        usage.merge(pageDevices[i]->getFontGlyphUsage());
-    }
-    SkPDFGlyphSetMap::F2BIter iterator(usage);
-    const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
-    while (entry) {
-        SkAutoTUnref<SkPDFFont> subsetFont(
-                entry->fFont->getFontSubset(entry->fGlyphSet));
-        if (subsetFont) {
-            substituteMap->setSubstitute(entry->fFont, subsetFont.get());
-        }
-        entry = iterator.next();
-    }
+// Deflates objects [begin, end) across the thread pool.
+static void compress_objects(const SkTDArray<SkPDFObject*>& objects, int begin, int end) {
+    sk_parallel_for(begin, end, 1, compress_object, &objects);
 }
 
 static SkPDFDict* create_pdf_page(const SkPDFDevice* pageDevice) {
@@ -83,177 +73,6 @@ static SkPDFDict* create_pdf_page(const SkPDFDevice* pageDevice) {
     return page.detach();
 }
 
-static void generate_page_tree(const SkTDArray<SkPDFDict*>& pages,
-                               SkTDArray<SkPDFDict*>* pageTree,
-                               SkPDFDict** rootNode) {
-    // PDF wants a tree describing all the pages in the document.  We arbitrary
-    // choose 8 (kNodeSize) as the number of allowed children.  The internal
-    // nodes have type "Pages" with an array of children, a parent pointer, and
-    // the number of leaves below the node as "Count."  The leaves are passed
-    // into the method, have type "Page" and need a parent pointer. This method
-    // builds the tree bottom up, skipping internal nodes that would have only
-    // one child.
-    static const int kNodeSize = 8;
-
-    SkAutoTUnref<SkPDFName> kidsName(new SkPDFName("Kids"));
-    SkAutoTUnref<SkPDFName> countName(new SkPDFName("Count"));
-    SkAutoTUnref<SkPDFName> parentName(new SkPDFName("Parent"));
-
-    // curNodes takes a reference to its items, which it passes to pageTree.
-    SkTDArray<SkPDFDict*> curNodes;
-    curNodes.setReserve(pages.count());
-    for (int i = 0; i < pages.count(); i++) {
-        SkSafeRef(pages[i]);
-        curNodes.push(pages[i]);
-    }
-
-    // nextRoundNodes passes its references to nodes on to curNodes.
-    SkTDArray<SkPDFDict*> nextRoundNodes;
-    nextRoundNodes.setReserve((pages.count() + kNodeSize - 1)/kNodeSize);
-
-    int treeCapacity = kNodeSize;
-    do {
-        for (int i = 0; i < curNodes.count(); ) {
-            if (i > 0 && i + 1 == curNodes.count()) {
-                nextRoundNodes.push(curNodes[i]);
-                break;
-            }
-
-            SkPDFDict* newNode = new SkPDFDict("Pages");
-            SkAutoTUnref<SkPDFObjRef> newNodeRef(new SkPDFObjRef(newNode));
-
-            SkAutoTUnref<SkPDFArray> kids(new SkPDFArray);
-            kids->reserve(kNodeSize);
-
-            int count = 0;
-            for (; i < curNodes.count() && count < kNodeSize; i++, count++) {
-                curNodes[i]->insert(parentName.get(), newNodeRef.get());
-                kids->append(new SkPDFObjRef(curNodes[i]))->unref();
-
-                // TODO(vandebo): put the objects in strict access order.
-                // Probably doesn't matter because they are so small.
-                if (curNodes[i] != pages[0]) {
-                    pageTree->push(curNodes[i]);  // Transfer reference.
-                } else {
-                    SkSafeUnref(curNodes[i]);
-                }
-            }
-
-            // treeCapacity is the number of leaf nodes possible for the
-            // current set of subtrees being generated. (i.e. 8, 64, 512, ...).
-            // It is hard to count the number of leaf nodes in the current
-            // subtree. However, by construction, we know that unless it's the
-            // last subtree for the current depth, the leaf count will be
-            // treeCapacity, otherwise it's what ever is left over after
-            // consuming treeCapacity chunks.
-            int pageCount = treeCapacity;
-            if (i == curNodes.count()) {
-                pageCount = ((pages.count() - 1) % treeCapacity) + 1;
-            }
-            newNode->insert(countName.get(), new SkPDFInt(pageCount))->unref();
-            newNode->insert(kidsName.get(), kids.get());
-            nextRoundNodes.push(newNode);  // Transfer reference.
-        }
-
-        curNodes = nextRoundNodes;
-        nextRoundNodes.rewind();
-        treeCapacity *= kNodeSize;
-    } while (curNodes.count() > 1);
-
-    pageTree->push(curNodes[0]);  // Transfer reference.
-    if (rootNode) {
-        *rootNode = curNodes[0];
-    }
-}
-
-static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
-                              SkWStream* stream) {
-    if (pageDevices.isEmpty()) {
-        return false;
-    }
-
-    SkTDArray<SkPDFDict*> pages;
-    SkAutoTUnref<SkPDFDict> dests(SkNEW(SkPDFDict));
-
-    for (int i = 0; i < pageDevices.count(); i++) {
-        SkASSERT(pageDevices[i]);
-        SkASSERT(i == 0 ||
-                 pageDevices[i - 1]->getCanon() == pageDevices[i]->getCanon());
-        SkAutoTUnref<SkPDFDict> page(create_pdf_page(pageDevices[i]));
-        pageDevices[i]->appendDestinations(dests, page.get());
-        pages.push(page.detach());
-    }
-
-    SkTDArray<SkPDFDict*> pageTree;
-    SkAutoTUnref<SkPDFDict> docCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog")));
-
-    SkPDFDict* pageTreeRoot;
-    generate_page_tree(pages, &pageTree, &pageTreeRoot);
-
-    docCatalog->insert("Pages", new SkPDFObjRef(pageTreeRoot))->unref();
-
-    /* TODO(vandebo): output intent
-    SkAutoTUnref<SkPDFDict> outputIntent = new SkPDFDict("OutputIntent");
-    outputIntent->insert("S", new SkPDFName("GTS_PDFA1"))->unref();
-    outputIntent->insert("OutputConditionIdentifier",
-                         new SkPDFString("sRGB"))->unref();
-    SkAutoTUnref<SkPDFArray> intentArray = new SkPDFArray;
-    intentArray->append(outputIntent.get());
-    docCatalog->insert("OutputIntent", intentArray.get());
-    */
-
-    if (dests->size() > 0) {
-        docCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (dests.get())))
-                ->unref();
-    }
-
-    // Build font subsetting info before proceeding.
-    SkPDFSubstituteMap substitutes;
-    perform_font_subsetting(pageDevices, &substitutes);
-
-    SkPDFObjNumMap objNumMap;
-    if (objNumMap.addObject(docCatalog.get())) {
-        docCatalog->addResources(&objNumMap, substitutes);
-    }
-    size_t baseOffset = SkToOffT(stream->bytesWritten());
-    emit_pdf_header(stream);
-    SkTDArray<int32_t> offsets;
-    for (int i = 0; i < objNumMap.objects().count(); ++i) {
-        SkPDFObject* object = objNumMap.objects()[i];
-        offsets.push(SkToS32(stream->bytesWritten() - baseOffset));
-        SkASSERT(object == substitutes.getSubstitute(object));
-        SkASSERT(objNumMap.getObjectNumber(object) == i + 1);
-        stream->writeDecAsText(i + 1);
-        stream->writeText(" 0 obj\n");  // Generation number is always 0.
-        object->emitObject(stream, objNumMap, substitutes);
-        stream->writeText("\nendobj\n");
-    }
-    int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - baseOffset);
-
-    // Include the zeroth object in the count.
-    int32_t objCount = SkToS32(offsets.count() + 1);
-
-    stream->writeText("xref\n0 ");
-    stream->writeDecAsText(objCount);
-    stream->writeText("\n0000000000 65535 f \n");
-    for (int i = 0; i < offsets.count(); i++) {
-        SkASSERT(offsets[i] > 0);
-        stream->writeBigDecAsText(offsets[i], 10);
-        stream->writeText(" 00000 n \n");
-    }
-    emit_pdf_footer(stream, objNumMap, substitutes, docCatalog.get(), objCount,
-                    xRefFileOffset);
-
-    // The page tree has both child and parent pointers, so it creates a
-    // reference cycle.  We must clear that cycle to properly reclaim memory.
-    for (int i = 0; i < pageTree.count(); i++) {
-        pageTree[i]->clear();
-    }
-    pageTree.safeUnrefAll();
-    pages.unrefAll();
-    return true;
-}
-
 #if 0
 // TODO(halcanary): expose notEmbeddableCount in SkDocument
 void GetCountOfFontTypes(
@@ -296,13 +115,33 @@ void GetCountOfFontTypes(
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace {
+/**
+ *  Writes each page, and every object only that page uses, to the stream as
+ *  soon as the page ends, then lets go of them.  Only what has to wait for
+ *  the whole document stays in memory until close(): the fonts, which are
+ *  subset to the glyphs all the pages used, objects the SkPDFCanon shares
+ *  between pages, the page tree, and an empty shell for each written object
+ *  so its address isn't reused while the object number map knows it.
+ *
+ *  A concurrent document records each page instead, and turns a batch of
+ *  recorded pages into SkPDFDevices at once on the thread pool, sharing the
+ *  SkPDFCanon; the batch is then written in page order.
+ */
 class SkDocument_PDF : public SkDocument {
 public:
     SkDocument_PDF(SkWStream* stream,
                    void (*doneProc)(SkWStream*, bool),
-                   SkScalar rasterDpi)
+                   SkScalar rasterDpi,
+                   SkScalar maxImageDpi,
+                   bool concurrent)
         : SkDocument(stream, doneProc)
-        , fRasterDpi(rasterDpi) {}
+        , fRasterDpi(rasterDpi)
+        , fConcurrent(concurrent)
+        , fBaseOffset(0)
+        , fPageCount(0)
+        , fFontCount(0) {
+        fCanon.setMaxImageDpi(maxImageDpi);
+    }
 
     virtual ~SkDocument_PDF() {
         // subclasses must call close() in their destructors
@@ -316,54 +155,337 @@ protected:
 
         SkISize pageSize = SkISize::Make(
                 SkScalarRoundToInt(width), SkScalarRoundToInt(height));
-        SkAutoTUnref<SkPDFDevice> device(
-                SkPDFDevice::Create(pageSize, fRasterDpi, &fCanon));
-        fCanvas.reset(SkNEW_ARGS(SkCanvas, (device.get())));
-        fPageDevices.push(device.detach());
+        if (fConcurrent) {
+            fRecordingSize = pageSize;
+            SkCanvas* canvas = fRecorder.beginRecording(SkIntToScalar(pageSize.width()),
+                                                        SkIntToScalar(pageSize.height()));
+            canvas->clipRect(trimBox);
+            canvas->translate(trimBox.x(), trimBox.y());
+            return canvas;
+        }
+        fDevice.reset(SkPDFDevice::Create(pageSize, fRasterDpi, &fCanon));
+        fCanvas.reset(SkNEW_ARGS(SkCanvas, (fDevice.get())));
         fCanvas->clipRect(trimBox);
         fCanvas->translate(trimBox.x(), trimBox.y());
         return fCanvas.get();
     }
 
     void onEndPage() override {
+        if (fConcurrent) {
+            PendingPage* page = fPendingPages.append();
+            page->fContent = fRecorder.endRecording();
+            page->fSize = fRecordingSize;
+            page->fDevice = NULL;
+            if (fPendingPages.count() >= kPagesPerBatch) {
+                this->emitPendingPages();
+            }
+            return;
+        }
         SkASSERT(fCanvas.get());
         fCanvas->flush();
         fCanvas.reset(NULL);
+
+        int firstPageObject = this->emitPage(fDevice.get());
+        // The device holds refs to the page's resources too.
+        fDevice.reset(NULL);
+        this->dropUnshared(firstPageObject);
     }
 
     bool onClose(SkWStream* stream) override {
         SkASSERT(!fCanvas.get());
+        this->emitPendingPages();
+        if (0 == fPageCount) {
+            this->reset();
+            return false;
+        }
 
-        bool success = emit_pdf_document(fPageDevices, stream);
-        fPageDevices.unrefAll();
-        fCanon.reset();
-        return success;
+        // Subset each font to the glyphs used on all the pages.  A subset is
+        // written in place of the font it replaces, under the same number.
+        SkPDFSubstituteMap fontSubsets;
+        SkPDFGlyphSetMap::F2BIter iterator(fGlyphUsage);
+        const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
+        while (entry) {
+            SkAutoTUnref<SkPDFFont> subsetFont(
+                    entry->fFont->getFontSubset(entry->fGlyphSet));
+            if (subsetFont) {
+                fontSubsets.setSubstitute(entry->fFont, subsetFont.get());
+            }
+            entry = iterator.next();
+        }
+        for (int i = 0; i < fFontCount; i++) {
+            fontSubsets.getSubstitute(fCanon.fontAt(i))->addResources(
+                    &fObjNumMap, fNoSubstitutes);
+        }
+
+        SkPDFDict* pageTreeRoot = this->finishPageTree();
+        SkAutoTUnref<SkPDFDict> docCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog")));
+        docCatalog->insert("Pages", new SkPDFObjRef(pageTreeRoot))->unref();
+        if (fDests->size() > 0) {
+            docCatalog->insert("Dests", SkNEW_ARGS(SkPDFObjRef, (fDests.get())))
+                    ->unref();
+        }
+        if (fObjNumMap.addObject(docCatalog.get())) {
+            docCatalog->addResources(&fObjNumMap, fNoSubstitutes);
+        }
+
+        // Everything not yet written: fonts, the page tree, the catalog, and
+        // whatever they refer to.
+        SkTDArray<int> unwritten;
+        SkTDArray<SkPDFObject*> objects;
+        for (int i = 0; i < fObjNumMap.objects().count(); i++) {
+            if (i >= fOffsets.count() || 0 == fOffsets[i]) {
+                unwritten.push(i);
+                objects.push(fontSubsets.getSubstitute(fObjNumMap.objects()[i]));
+            }
+        }
+        compress_objects(objects, 0, objects.count());
+        for (int i = 0; i < objects.count(); i++) {
+            this->emitObject(unwritten[i], objects[i]);
+        }
+        int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - fBaseOffset);
+
+        // Include the zeroth object in the count.
+        int32_t objCount = SkToS32(fOffsets.count() + 1);
+
+        stream->writeText("xref\n0 ");
+        stream->writeDecAsText(objCount);
+        stream->writeText("\n0000000000 65535 f \n");
+        for (int i = 0; i < fOffsets.count(); i++) {
+            SkASSERT(fOffsets[i] > 0);
+            stream->writeBigDecAsText(fOffsets[i], 10);
+            stream->writeText(" 00000 n \n");
+        }
+        emit_pdf_footer(stream, fObjNumMap, fNoSubstitutes, docCatalog.get(),
+                        objCount, xRefFileOffset);
+        this->reset();
+        return true;
     }
 
     void onAbort() override {
-        fPageDevices.unrefAll();
-        fCanon.reset();
+        fCanvas.reset(NULL);
+        this->reset();
     }
 
 private:
+    // Each node of the page tree has at most this many children.
+    static const int kNodeSize = 8;
+    // A concurrent document draws this many recorded pages at a time.
+    static const int kPagesPerBatch = 16;
+
+    struct PendingPage {
+        SkPicture* fContent;    // Reffed.
+        SkISize fSize;
+        SkPDFDevice* fDevice;   // Reffed; NULL until drawn.
+    };
+
+    static void DrawPendingPage(int i, SkDocument_PDF* doc) {
+        PendingPage& page = doc->fPendingPages[i];
+        page.fDevice = SkPDFDevice::Create(page.fSize, doc->fRasterDpi, &doc->fCanon);
+        SkCanvas canvas(page.fDevice);
+        page.fContent->playback(&canvas);
+        canvas.flush();
+    }
+
+    // Draws the recorded pages across the thread pool, then writes them in order.
+    void emitPendingPages() {
+        sk_parallel_for(0, fPendingPages.count(), 1, DrawPendingPage, this);
+        for (int i = 0; i < fPendingPages.count(); i++) {
+            PendingPage& page = fPendingPages[i];
+            page.fContent->unref();
+            page.fContent = NULL;
+            int firstPageObject = this->emitPage(page.fDevice);
+            page.fDevice->unref();
+            page.fDevice = NULL;
+            this->dropUnshared(firstPageObject);
+        }
+        fPendingPages.rewind();
+    }
+
+    // Adds obj to the object number map, holding a ref on it for as long as it is there.
+    void track(SkPDFObject* obj) {
+        if (fObjNumMap.addObject(obj)) {
+            fHeld.push(SkRef(obj));
+        }
+    }
+
+    void emitObject(int index, SkPDFObject* object) {
+        SkWStream* stream = this->getStream();
+        while (fOffsets.count() <= index) {
+            fOffsets.push(0);
+        }
+        fOffsets[index] = SkToS32(stream->bytesWritten() - fBaseOffset);
+        stream->writeDecAsText(index + 1);
+        stream->writeText(" 0 obj\n");  // Generation number is always 0.
+        object->emitObject(stream, fObjNumMap, fNoSubstitutes);
+        stream->writeText("\nendobj\n");
+    }
+
+    // Writes the page and everything new it refers to, except fonts.  Returns
+    // the index of the first object written.
+    int emitPage(const SkPDFDevice* device) {
+        if (0 == fPageCount) {
+            fBaseOffset = this->getStream()->bytesWritten();
+            emit_pdf_header(this->getStream());
+            fDests.reset(SkNEW(SkPDFDict));
+        }
+        fGlyphUsage.merge(device->getFontGlyphUsage());
+
+        // Pages hang off leaf nodes of the page tree, which is finished in
+        // onClose().  Their numbers are needed now, for the pages' Parents.
+        if (0 == fPageCount % kNodeSize) {
+            SkAutoTUnref<SkPDFDict> leaf(SkNEW_ARGS(SkPDFDict, ("Pages")));
+            fLeafKids.reset(SkNEW(SkPDFArray));
+            fLeafKids->reserve(kNodeSize);
+            leaf->insert("Kids", fLeafKids.get());
+            this->track(leaf.get());
+            fPageTree.push(leaf.detach());
+        }
+        SkAutoTUnref<SkPDFDict> page(create_pdf_page(device));
+        page->insert("Parent", new SkPDFObjRef(fPageTree.top()))->unref();
+        fLeafKids->append(new SkPDFObjRef(page.get()))->unref();
+        device->appendDestinations(fDests, page.get());
+        fPageCount++;
+
+        // Numbering the fonts now keeps them out of this page's objects; they
+        // are written in onClose().
+        for (; fFontCount < fCanon.fontCount(); fFontCount++) {
+            this->track(fCanon.fontAt(fFontCount));
+        }
+
+        const int first = fObjNumMap.objects().count();
+        if (fObjNumMap.addObject(page.get())) {
+            page->addResources(&fObjNumMap, fNoSubstitutes);
+        }
+        compress_objects(fObjNumMap.objects(), first, fObjNumMap.objects().count());
+        for (int i = first; i < fObjNumMap.objects().count(); i++) {
+            SkPDFObject* object = fObjNumMap.objects()[i];
+            fHeld.push(SkRef(object));
+            this->emitObject(i, object);
+        }
+        // The page is referred to by number from here on.
+        page->clear();
+        return first;
+    }
+
+    // Frees the written objects from first on that nothing but fHeld refers to.
+    void dropUnshared(int first) {
+        SkTDArray<SkPDFObject*> written;
+        written.append(fObjNumMap.objects().count() - first, &fObjNumMap.objects()[first]);
+        bool dropped;
+        do {
+            // Dropping one object can leave the ones it referred to unshared.
+            dropped = false;
+            for (int i = written.count() - 1; i >= 0; i--) {
+                if (written[i]->unique()) {
+                    written[i]->drop();
+                    written.removeShuffle(i);
+                    dropped = true;
+                }
+            }
+        } while (dropped);
+    }
+
+    // Builds the page tree above the leaf nodes and returns its root.
+    SkPDFDict* finishPageTree() {
+        SkAutoTUnref<SkPDFName> kidsName(new SkPDFName("Kids"));
+        SkAutoTUnref<SkPDFName> countName(new SkPDFName("Count"));
+        SkAutoTUnref<SkPDFName> parentName(new SkPDFName("Parent"));
+
+        SkTDArray<SkPDFDict*> curNodes;
+        SkTDArray<int> curCounts;
+        for (int i = 0; i < fPageTree.count(); i++) {
+            int count = SkTMin(kNodeSize, fPageCount - i * kNodeSize);
+            fPageTree[i]->insert(countName.get(), new SkPDFInt(count))->unref();
+            curNodes.push(fPageTree[i]);
+            curCounts.push(count);
+        }
+        while (curNodes.count() > 1) {
+            SkTDArray<SkPDFDict*> nextNodes;
+            SkTDArray<int> nextCounts;
+            for (int i = 0; i < curNodes.count(); ) {
+                SkPDFDict* node = SkNEW_ARGS(SkPDFDict, ("Pages"));
+                fPageTree.push(node);  // Transfer reference.
+                SkAutoTUnref<SkPDFObjRef> nodeRef(new SkPDFObjRef(node));
+                SkAutoTUnref<SkPDFArray> kids(new SkPDFArray);
+                kids->reserve(kNodeSize);
+                int count = 0;
+                for (int n = 0; i < curNodes.count() && n < kNodeSize; i++, n++) {
+                    curNodes[i]->insert(parentName.get(), nodeRef.get());
+                    kids->append(new SkPDFObjRef(curNodes[i]))->unref();
+                    count += curCounts[i];
+                }
+                node->insert(countName.get(), new SkPDFInt(count))->unref();
+                node->insert(kidsName.get(), kids.get());
+                nextNodes.push(node);
+                nextCounts.push(count);
+            }
+            curNodes.swap(nextNodes);
+            curCounts.swap(nextCounts);
+        }
+        return curNodes[0];
+    }
+
+    void reset() {
+        // The page tree has both child and parent pointers, so it creates a
+        // reference cycle.  We must clear that cycle to properly reclaim memory.
+        for (int i = 0; i < fPageTree.count(); i++) {
+            fPageTree[i]->clear();
+        }
+        fPageTree.unrefAll();
+        fLeafKids.reset(NULL);
+        fDests.reset(NULL);
+        fHeld.unrefAll();
+        fGlyphUsage.reset();
+        fDevice.reset(NULL);
+        for (int i = 0; i < fPendingPages.count(); i++) {
+            SkSafeUnref(fPendingPages[i].fContent);
+            SkSafeUnref(fPendingPages[i].fDevice);
+        }
+        fPendingPages.rewind();
+        fCanon.reset();
+    }
+
     SkPDFCanon fCanon;
-    SkTDArray<const SkPDFDevice*> fPageDevices;
+    SkAutoTUnref<SkPDFDevice> fDevice;
     SkAutoTUnref<SkCanvas> fCanvas;
     SkScalar fRasterDpi;
+
+    const bool fConcurrent;
+    SkPictureRecorder fRecorder;
+    SkISize fRecordingSize;
+    SkTDArray<PendingPage> fPendingPages;
+
+    SkPDFObjNumMap fObjNumMap;
+    SkPDFSubstituteMap fNoSubstitutes;
+    SkTDArray<SkPDFObject*> fHeld;    // Everything in fObjNumMap, reffed.
+    SkTDArray<int32_t> fOffsets;      // Of each written object; 0 if not yet.
+    size_t fBaseOffset;
+
+    int fPageCount;
+    SkTDArray<SkPDFDict*> fPageTree;  // Leaf nodes first, reffed.
+    SkAutoTUnref<SkPDFArray> fLeafKids;
+    SkAutoTUnref<SkPDFDict> fDests;
+    SkPDFGlyphSetMap fGlyphUsage;
+    int fFontCount;                   // Fonts in fCanon given numbers so far.
 };
 }  // namespace
 ///////////////////////////////////////////////////////////////////////////////
 
-SkDocument* SkDocument::CreatePDF(SkWStream* stream, SkScalar dpi) {
-    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi)) : NULL;
+SkDocument* SkDocument::CreatePDF(SkWStream* stream, SkScalar dpi, SkScalar maxImageDpi) {
+    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi, maxImageDpi, false)) : NULL;
+}
+
+SkDocument* SkDocument::CreateConcurrentPDF(SkWStream* stream, SkScalar dpi,
+                                            SkScalar maxImageDpi) {
+    return stream ? SkNEW_ARGS(SkDocument_PDF, (stream, NULL, dpi, maxImageDpi, true)) : NULL;
 }
 
-SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
+SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi, SkScalar maxImageDpi) {
     SkFILEWStream* stream = SkNEW_ARGS(SkFILEWStream, (path));
     if (!stream->isValid()) {
         SkDELETE(stream);
         return NULL;
     }
     auto delete_wstream = [](SkWStream* stream, bool) { SkDELETE(stream); };
-    return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi));
+    return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi, maxImageDpi, false));
 }
@@ -69,13 +69,48 @@ SkPath1DPathEffect::SkPath1DPathEffect(const SkPath& path, SkScalar advance,
     }
 }
 
+// Returns how far pt is outside of rect in x or y, or 0 if it's inside.
+static SkScalar distance_outside(const SkRect& rect, const SkPoint& pt) {
+    SkScalar dx = SkMaxScalar(rect.fLeft - pt.fX, pt.fX - rect.fRight);
+    SkScalar dy = SkMaxScalar(rect.fTop - pt.fY, pt.fY - rect.fBottom);
+    return SkMaxScalar(SkMaxScalar(dx, dy), 0);
+}
+
 bool SkPath1DPathEffect::filterPath(SkPath* dst, const SkPath& src,
                             SkStrokeRec* rec, const SkRect* cullRect) const {
-    if (fAdvance > 0) {
-        rec->setFillStyle();
+    if (fAdvance <= 0) {
+        return false;
+    }
+    rec->setFillStyle();
+    if (NULL == cullRect || cullRect->contains(src.getBounds())) {
         return this->INHERITED::filterPath(dst, src, rec, cullRect);
     }
-    return false;
+
+    // Every style places each point (x, y) of fPath within |x| + |y| of the position it is
+    // stamped at, and the stamp a distance d further along the path is within d of this one, so
+    // the stamps that can't reach the cull rect can be skipped a run at a time.
+    const SkRect& bounds = fPath.getBounds();
+    const SkScalar radius = SkMaxScalar(SkScalarAbs(bounds.fLeft), SkScalarAbs(bounds.fRight)) +
+                            SkMaxScalar(SkScalarAbs(bounds.fTop), SkScalarAbs(bounds.fBottom));
+
+    SkPathMeasure   meas(src, false);
+    do {
+        SkScalar    length = meas.getLength();
+        SkScalar    distance = this->begin(length);
+        while (distance < length) {
+            SkPoint pos;
+            SkScalar gap = 0;
+            if (meas.getPosTan(distance, &pos, NULL)) {
+                gap = distance_outside(*cullRect, pos) - radius;
+            }
+            if (gap > 0) {
+                distance += SkScalarCeilToScalar(gap / fAdvance) * fAdvance;
+            } else {
+                distance += this->next(dst, distance, meas);
+            }
+        }
+    } while (meas.nextContour());
+    return true;
 }
 
 static bool morphpoints(SkPoint dst[], const SkPoint src[], int count,
@@ -9,6 +9,7 @@
 #include "SkBlurImageFilter.h"
 #include "SkColorPriv.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkWriteBuffer.h"
 #include "SkGpuBlurUtils.h"
 #include "SkBlurImage_opts.h"
@@ -75,14 +76,14 @@ enum BlurDirection {
  */
 
 template<BlurDirection srcDirection, BlurDirection dstDirection>
-static void boxBlur(const SkPMColor* src, int srcStride, SkPMColor* dst, int kernelSize,
-                    int leftOffset, int rightOffset, int width, int height)
+static void boxBlur(const SkPMColor* src, int srcStride, SkPMColor* dst, int dstStride,
+                    int kernelSize, int leftOffset, int rightOffset, int width, int height)
 {
     int rightBorder = SkMin32(rightOffset + 1, width);
     int srcStrideX = srcDirection == kX ? 1 : srcStride;
-    int dstStrideX = dstDirection == kX ? 1 : height;
+    int dstStrideX = dstDirection == kX ? 1 : dstStride;
     int srcStrideY = srcDirection == kX ? srcStride : 1;
-    int dstStrideY = dstDirection == kX ? width : 1;
+    int dstStrideY = dstDirection == kX ? dstStride : 1;
     uint32_t scale = (1 << 24) / kernelSize;
     uint32_t half = 1 << 23;
     for (int y = 0; y < height; ++y) {
@@ -128,6 +129,72 @@ static void boxBlur(const SkPMColor* src, int srcStride, SkPMColor* dst, int ker
     }
 }
 
+namespace {
+// The rows of one box blur pass given to one SkTaskGroup task.
+struct BlurStripe {
+    SkBoxBlurProc       fProc;
+    const SkPMColor*    fSrc;
+    int                 fSrcStride;
+    SkPMColor*          fDst;
+    int                 fDstStride;
+    int                 fKernelSize;
+    int                 fLeftOffset;
+    int                 fRightOffset;
+    int                 fWidth;
+    int                 fHeight;
+};
+} // namespace
+
+static void blur_stripe(BlurStripe* stripe) {
+    stripe->fProc(stripe->fSrc, stripe->fSrcStride, stripe->fDst, stripe->fDstStride,
+                  stripe->fKernelSize, stripe->fLeftOffset, stripe->fRightOffset,
+                  stripe->fWidth, stripe->fHeight);
+}
+
+// Passes over fewer pixels than this per stripe aren't worth splitting up.
+static const int kMinBlurStripePixels = 64 * 1024;
+static const int kMaxBlurStripes = 32;
+
+/**
+ *  Runs one pass of proc over height rows of width pixels. Every row is blurred on its own, so
+ *  big passes are split into stripes of rows that run on SkTaskGroup threads.
+ */
+template<BlurDirection srcDirection, BlurDirection dstDirection>
+static void blurPass(SkBoxBlurProc proc, const SkPMColor* src, int srcStride, SkPMColor* dst,
+                     int kernelSize, int leftOffset, int rightOffset, int width, int height) {
+    const int dstStride = dstDirection == kX ? width : height;
+    const int rowsPerStripe = SkMax32(kMinBlurStripePixels / SkMax32(width, 1), 1);
+    const int stripeCount = SkMin32((height + rowsPerStripe - 1) / rowsPerStripe,
+                                    kMaxBlurStripes);
+    if (stripeCount <= 1) {
+        proc(src, srcStride, dst, dstStride, kernelSize, leftOffset, rightOffset, width, height);
+        return;
+    }
+
+    // Where each row starts, relative to the one before it.
+    const int srcRowStep = srcDirection == kX ? srcStride : 1;
+    const int dstRowStep = dstDirection == kX ? dstStride : 1;
+    BlurStripe stripes[kMaxBlurStripes];
+    for (int i = 0; i < stripeCount; ++i) {
+        const int top = height * i / stripeCount;
+        const int bottom = height * (i + 1) / stripeCount;
+        BlurStripe& stripe = stripes[i];
+        stripe.fProc = proc;
+        stripe.fSrc = src + top * srcRowStep;
+        stripe.fSrcStride = srcStride;
+        stripe.fDst = dst + top * dstRowStep;
+        stripe.fDstStride = dstStride;
+        stripe.fKernelSize = kernelSize;
+        stripe.fLeftOffset = leftOffset;
+        stripe.fRightOffset = rightOffset;
+        stripe.fWidth = width;
+        stripe.fHeight = bottom - top;
+    }
+    SkTaskGroup tg;
+    tg.batch(blur_stripe, stripes, stripeCount);
+    tg.wait();
+}
+
 static void getBox3Params(SkScalar s, int *kernelSize, int* kernelSize3, int *lowOffset,
                           int *highOffset)
 {
@@ -212,20 +279,20 @@ bool SkBlurImageFilter::onFilterImage(Proxy* proxy,
     }
 
     if (kernelSizeX > 0 && kernelSizeY > 0) {
-        boxBlurX(s,  sw, t, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
-        boxBlurX(t,  w,  d, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
-        boxBlurXY(d, w,  t, kernelSizeX3, highOffsetX, highOffsetX, w, h);
-        boxBlurX(t,  h,  d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
-        boxBlurX(d,  h,  t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
-        boxBlurXY(t, h,  d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
+        blurPass<kX, kX>(boxBlurX,  s, sw, t, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
+        blurPass<kX, kX>(boxBlurX,  t, w,  d, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
+        blurPass<kX, kY>(boxBlurXY, d, w,  t, kernelSizeX3, highOffsetX, highOffsetX, w, h);
+        blurPass<kX, kX>(boxBlurX,  t, h,  d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
+        blurPass<kX, kX>(boxBlurX,  d, h,  t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
+        blurPass<kX, kY>(boxBlurXY, t, h,  d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
     } else if (kernelSizeX > 0) {
-        boxBlurX(s,  sw, d, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
-        boxBlurX(d,  w,  t, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
-        boxBlurX(t,  w,  d, kernelSizeX3, highOffsetX, highOffsetX, w, h);
+        blurPass<kX, kX>(boxBlurX,  s, sw, d, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
+        blurPass<kX, kX>(boxBlurX,  d, w,  t, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
+        blurPass<kX, kX>(boxBlurX,  t, w,  d, kernelSizeX3, highOffsetX, highOffsetX, w, h);
     } else if (kernelSizeY > 0) {
-        boxBlurYX(s, sw, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
-        boxBlurX(d,  h,  t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
-        boxBlurXY(t, h,  d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
+        blurPass<kY, kX>(boxBlurYX, s, sw, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
+        blurPass<kX, kX>(boxBlurX,  d, h,  t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
+        blurPass<kX, kY>(boxBlurXY, t, h,  d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
     }
     return true;
 }
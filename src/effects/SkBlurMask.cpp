@@ -11,6 +11,7 @@
 #include "SkMath.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
+#include "SkTaskGroup.h"
 
 
 // This constant approximates the scaling done in the software path's
@@ -76,9 +77,9 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
  *          }
  *      }
  */
-static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
-                   int leftRadius, int rightRadius, int width, int height,
-                   bool transpose)
+static int boxBlurRows(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                       int leftRadius, int rightRadius, int width, int height,
+                       bool transpose, int startY, int endY)
 {
     int diameter = leftRadius + rightRadius;
     int kernelSize = diameter + 1;
@@ -88,7 +89,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
     int dst_x_stride = transpose ? height : 1;
     int dst_y_stride = transpose ? 1 : new_width;
     uint32_t half = 1 << 23;
-    for (int y = 0; y < height; ++y) {
+    for (int y = startY; y < endY; ++y) {
         uint32_t sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
         const uint8_t* right = src + y * src_y_stride;
@@ -278,9 +279,9 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
  *  return new_width;
  */
 
-static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
-                         int radius, int width, int height,
-                         bool transpose, uint8_t outer_weight)
+static int boxBlurInterpRows(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                             int radius, int width, int height,
+                             bool transpose, uint8_t outer_weight, int startY, int endY)
 {
     int diameter = radius * 2;
     int kernelSize = diameter + 1;
@@ -294,7 +295,7 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     int new_width = width + diameter;
     int dst_x_stride = transpose ? height : 1;
     int dst_y_stride = transpose ? 1 : new_width;
-    for (int y = 0; y < height; ++y) {
+    for (int y = startY; y < endY; ++y) {
         uint32_t outer_sum = 0, inner_sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
         const uint8_t* right = src + y * src_y_stride;
@@ -406,6 +407,82 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     return new_width;
 }
 
+namespace {
+// The rows [fStartY, fEndY) of one box blur pass, given to one SkTaskGroup task.
+struct BoxBlurBand {
+    const uint8_t*  fSrc;
+    int             fSrcYStride;
+    uint8_t*        fDst;
+    int             fLeftRadius;
+    int             fRightRadius;
+    int             fWidth;
+    int             fHeight;
+    bool            fTranspose;
+    bool            fInterp;
+    uint8_t         fOuterWeight;
+    int             fStartY;
+    int             fEndY;
+};
+} // namespace
+
+static void box_blur_band(BoxBlurBand* band) {
+    if (band->fInterp) {
+        boxBlurInterpRows(band->fSrc, band->fSrcYStride, band->fDst, band->fLeftRadius,
+                          band->fWidth, band->fHeight, band->fTranspose, band->fOuterWeight,
+                          band->fStartY, band->fEndY);
+    } else {
+        boxBlurRows(band->fSrc, band->fSrcYStride, band->fDst, band->fLeftRadius,
+                    band->fRightRadius, band->fWidth, band->fHeight, band->fTranspose,
+                    band->fStartY, band->fEndY);
+    }
+}
+
+// Masks with fewer pixels than this per band aren't worth splitting up.
+static const int kMinBoxBlurBandPixels = 64 * 1024;
+static const int kMaxBoxBlurBands = 32;
+
+// Blurs the rows of proto in bands on SkTaskGroup threads. Every row is blurred on its own and
+// written to its own column (or row) of dst, so the bands never touch each other's pixels.
+static void box_blur_bands(const BoxBlurBand& proto) {
+    const int rowsPerBand = SkMax32(kMinBoxBlurBandPixels / SkMax32(proto.fWidth, 1), 1);
+    const int bandCount = SkMin32((proto.fHeight + rowsPerBand - 1) / rowsPerBand,
+                                  kMaxBoxBlurBands);
+    if (bandCount <= 1) {
+        BoxBlurBand band = proto;
+        box_blur_band(&band);
+        return;
+    }
+    BoxBlurBand bands[kMaxBoxBlurBands];
+    for (int i = 0; i < bandCount; ++i) {
+        bands[i] = proto;
+        bands[i].fStartY = proto.fHeight * i / bandCount;
+        bands[i].fEndY = proto.fHeight * (i + 1) / bandCount;
+    }
+    SkTaskGroup tg;
+    tg.batch(box_blur_band, bands, bandCount);
+    tg.wait();
+}
+
+static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                   int leftRadius, int rightRadius, int width, int height,
+                   bool transpose)
+{
+    BoxBlurBand proto = { src, src_y_stride, dst, leftRadius, rightRadius, width, height,
+                          transpose, false, 0, 0, height };
+    box_blur_bands(proto);
+    return width + SkMax32(leftRadius, rightRadius) * 2;
+}
+
+static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                         int radius, int width, int height,
+                         bool transpose, uint8_t outer_weight)
+{
+    BoxBlurBand proto = { src, src_y_stride, dst, radius, radius, width, height,
+                          transpose, true, outer_weight, 0, height };
+    box_blur_bands(proto);
+    return width + radius * 2;
+}
+
 static void get_adjusted_radii(SkScalar passRadius, int *loRadius, int *hiRadius)
 {
     *loRadius = *hiRadius = SkScalarCeilToInt(passRadius);
@@ -8,10 +8,12 @@
 
 #include "SkBlurMaskFilter.h"
 #include "SkBlurMask.h"
+#include "SkBlitter.h"
 #include "SkGpuBlurUtils.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkMaskFilter.h"
+#include "SkRasterClip.h"
 #include "SkRRect.h"
 #include "SkRTConf.h"
 #include "SkStringUtils.h"
@@ -84,6 +86,9 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const override;
 
+    virtual FilterReturn filterRRectToSpans(const SkRRect&, const SkMatrix&,
+                                            const SkRasterClip&, SkBlitter*) const override;
+
     bool filterRectMask(SkMask* dstM, const SkRect& r, const SkMatrix& matrix,
                         SkIPoint* margin, SkMask::CreateMode createMode) const;
     bool filterRRectMask(SkMask* dstM, const SkRRect& r, const SkMatrix& matrix,
@@ -445,6 +450,212 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     return kTrue_FilterReturn;
 }
 
+SK_CONF_DECLARE( bool, c_analyticBlurSpans, "mask.filter.blur.analyticspans", true, "Blit blurred rects, round rects and ovals straight from their analytic coverage" );
+
+// Below this sigma the blur doesn't hide the pixel coverage of the sharp edge, which the
+// analytic spans sample only at pixel centers.
+static const SkScalar kMinAnalyticSpansSigma = 2;
+
+// Approximates erf(x) to within 5e-4 (Abramowitz and Stegun 7.1.27).
+static inline float approx_erf(float x) {
+    const float ax = SkScalarAbs(x);
+    float d = 1 + ax * (0.278393f + ax * (0.230389f + ax * (0.000972f + ax * 0.078108f)));
+    d *= d;
+    d *= d;
+    const float e = 1 - 1 / d;
+    return x < 0 ? -e : e;
+}
+
+/**
+ *  Computes the coverage of a round rect with equal corners blurred by a gaussian, a row at a
+ *  time. The gaussian is separable, so each row of coverage is an integral over y of the
+ *  horizontal span the round rect covers at that y blurred in x, which integrates exactly to
+ *  differences of erf. Where the rows the blur reaches all have the same span that integral is
+ *  exact too; across the corners it is a sum over a few strips, each weighted by the gaussian
+ *  mass it holds.
+ */
+class AnalyticRRectBlur {
+public:
+    AnalyticRRectBlur(const SkRRect& rrect, SkScalar sigma)
+        : fRect(rrect.rect())
+        , fRadii(rrect.getSimpleRadii())
+        , fExtent(3 * sigma)
+        , fScale(1 / (sigma * SK_ScalarSqrt2))
+        , fStrip(sigma / 8) {
+        fBounds = fRect;
+        fBounds.outset(fExtent, fExtent);
+    }
+
+    const SkRect& bounds() const { return fBounds; }
+
+    // Fills alphas with the coverage of pixels [left, right) of row y.
+    void computeRow(int y, int left, int right, SkAlpha alphas[]) {
+        this->computeTerms(SkIntToScalar(y) + SK_ScalarHalf);
+        if (0 == fTermCount) {
+            memset(alphas, 0, right - left);
+            return;
+        }
+        float total = 0;
+        SkScalar maxLeft = fTerms[0].fLeft, minRight = fTerms[0].fRight;
+        for (int i = 0; i < fTermCount; ++i) {
+            total += fTerms[i].fWeight;
+            maxLeft = SkTMax(maxLeft, fTerms[i].fLeft);
+            minRight = SkTMin(minRight, fTerms[i].fRight);
+        }
+        // Past the blur of every left edge and short of every right edge, the row is flat.
+        const SkScalar flatLeft = maxLeft + fExtent, flatRight = minRight - fExtent;
+        const SkAlpha flat = to_alpha(total);
+        for (int x = left; x < right; ++x) {
+            const SkScalar cx = SkIntToScalar(x) + SK_ScalarHalf;
+            if (cx >= flatLeft && cx <= flatRight) {
+                alphas[x - left] = flat;
+                continue;
+            }
+            float coverage = 0;
+            for (int i = 0; i < fTermCount; ++i) {
+                coverage += fTerms[i].fWeight * (approx_erf((cx - fTerms[i].fLeft) * fScale) -
+                                                 approx_erf((cx - fTerms[i].fRight) * fScale));
+            }
+            alphas[x - left] = to_alpha(coverage * 0.5f);
+        }
+    }
+
+private:
+    enum {
+        // Strips per corner, at most.
+        kMaxStrips = 32
+    };
+
+    struct Term {
+        float    fWeight;
+        SkScalar fLeft;
+        SkScalar fRight;
+    };
+
+    static SkAlpha to_alpha(float coverage) {
+        return SkToU8(SkClampMax(SkScalarRoundToInt(coverage * 255), 255));
+    }
+
+    // The gaussian mass between a and b, which are relative to the row's center.
+    float mass(SkScalar a, SkScalar b) const {
+        return 0.5f * (approx_erf(b * fScale) - approx_erf(a * fScale));
+    }
+
+    // Adds the span of the rows dy below the top of a corner (or above the bottom of one),
+    // weighted by the given mass.
+    void addCornerTerm(float weight, SkScalar dy) {
+        const SkScalar t = SkScalarDiv(fRadii.fY - dy, fRadii.fY);
+        const SkScalar inset = fRadii.fX - fRadii.fX * SkScalarSqrt(SkTMax(1 - t * t, 0.0f));
+        this->addTerm(weight, fRect.fLeft + inset, fRect.fRight - inset);
+    }
+
+    void addTerm(float weight, SkScalar left, SkScalar right) {
+        if (weight > 0 && left < right) {
+            fTerms[fTermCount].fWeight = weight;
+            fTerms[fTermCount].fLeft = left;
+            fTerms[fTermCount].fRight = right;
+            fTermCount++;
+        }
+    }
+
+    // Adds the corner strips between top and bottom, which are relative to cy.
+    void addCorner(SkScalar cy, SkScalar top, SkScalar bottom, SkScalar edge, bool isTop) {
+        if (top >= bottom) {
+            return;
+        }
+        const int strips = SkTMin(SkScalarCeilToInt((bottom - top) / fStrip), (int)kMaxStrips);
+        const SkScalar step = (bottom - top) / strips;
+        for (int i = 0; i < strips; ++i) {
+            const SkScalar a = top + step * i, b = a + step;
+            const SkScalar mid = cy + (a + b) / 2;
+            this->addCornerTerm(this->mass(a, b), isTop ? mid - edge : edge - mid);
+        }
+    }
+
+    void computeTerms(SkScalar cy) {
+        fTermCount = 0;
+        const SkScalar top = SkTMax(fRect.fTop, cy - fExtent) - cy;
+        const SkScalar bottom = SkTMin(fRect.fBottom, cy + fExtent) - cy;
+        if (top >= bottom) {
+            return;
+        }
+        const SkScalar straightTop = fRect.fTop + fRadii.fY - cy;
+        const SkScalar straightBottom = fRect.fBottom - fRadii.fY - cy;
+        this->addCorner(cy, top, SkTMin(bottom, straightTop), fRect.fTop, true);
+        const SkScalar a = SkTMax(top, straightTop), b = SkTMin(bottom, straightBottom);
+        if (a < b) {
+            this->addTerm(this->mass(a, b), fRect.fLeft, fRect.fRight);
+        }
+        this->addCorner(cy, SkTMax(top, straightBottom), bottom, fRect.fBottom, false);
+    }
+
+    const SkRect   fRect;
+    const SkVector fRadii;
+    const SkScalar fExtent;
+    const SkScalar fScale;
+    const SkScalar fStrip;
+    SkRect         fBounds;
+    Term           fTerms[2 * kMaxStrips + 1];
+    int            fTermCount;
+};
+
+// Blits a row of alphas as runs of equal alpha.
+static void blit_alpha_row(SkBlitter* blitter, int x, int y, SkAlpha alphas[], int16_t runs[],
+                           int width) {
+    int start = 0;
+    while (start < width) {
+        int end = start + 1;
+        while (end < width && alphas[end] == alphas[start]) {
+            end++;
+        }
+        runs[start] = SkToS16(end - start);
+        start = end;
+    }
+    runs[width] = 0;
+    blitter->blitAntiH(x, y, alphas, runs);
+}
+
+SkMaskFilter::FilterReturn
+SkBlurMaskFilterImpl::filterRRectToSpans(const SkRRect& rrect, const SkMatrix& matrix,
+                                         const SkRasterClip& clip, SkBlitter* blitter) const {
+    if (!c_analyticBlurSpans || kNormal_SkBlurStyle != fBlurStyle) {
+        return kUnimplemented_FilterReturn;
+    }
+    if (!rrect.isRect() && !rrect.isOval() && !rrect.isSimple()) {
+        return kUnimplemented_FilterReturn;
+    }
+    const SkScalar sigma = this->computeXformedSigma(matrix);
+    if (sigma < kMinAnalyticSpansSigma || rect_exceeds(rrect.rect(), SkIntToScalar(32767))) {
+        return kUnimplemented_FilterReturn;
+    }
+
+    AnalyticRRectBlur blur(rrect, sigma);
+    SkIRect bounds;
+    blur.bounds().roundOut(&bounds);
+
+    SkAAClipBlitterWrapper wrapper(clip, blitter);
+    blitter = wrapper.getBlitter();
+    SkRegion::Cliperator clipper(wrapper.getRgn(), bounds);
+    if (clipper.done()) {
+        return kTrue_FilterReturn;
+    }
+
+    enum {
+        kStackWidth = 256
+    };
+    SkAutoSTMalloc<kStackWidth, SkAlpha> alphas(bounds.width());
+    SkAutoSTMalloc<kStackWidth + 1, int16_t> runs(bounds.width() + 1);
+    do {
+        const SkIRect& cr = clipper.rect();
+        for (int y = cr.fTop; y < cr.fBottom; ++y) {
+            blur.computeRow(y, cr.fLeft, cr.fRight, alphas.get());
+            blit_alpha_row(blitter, cr.fLeft, y, alphas.get(), runs.get(), cr.width());
+        }
+        clipper.next();
+    } while (!clipper.done());
+    return kTrue_FilterReturn;
+}
+
 SK_CONF_DECLARE( bool, c_analyticBlurNinepatch, "mask.filter.analyticNinePatch", true, "Use the faster analytic blur approach for ninepatch rects" );
 
 SkMaskFilter::FilterReturn
@@ -1116,6 +1327,201 @@ GrGLFragmentProcessor* GrRRectBlurEffect::createGLInstance() const {
     return SkNEW_ARGS(GrGLRRectBlurEffect, (*this));
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  The GPU twin of AnalyticRRectBlur: each fragment sums the blurred spans of a few strips of the
+ *  round rect's rows, with no nine patch texture. It takes the round rects (and circles) that
+ *  GrRRectBlurEffect can't nine patch.
+ */
+class GrAnalyticRRectBlurEffect : public GrFragmentProcessor {
+public:
+    static GrFragmentProcessor* Create(float sigma, const SkRRect&);
+
+    virtual ~GrAnalyticRRectBlurEffect() {};
+    const char* name() const override { return "GrAnalyticRRectBlur"; }
+
+    const SkRRect& getRRect() const { return fRRect; }
+    float getSigma() const { return fSigma; }
+
+    virtual void getGLProcessorKey(const GrGLCaps& caps,
+                                   GrProcessorKeyBuilder* b) const override;
+
+    GrGLFragmentProcessor* createGLInstance() const override;
+
+private:
+    GrAnalyticRRectBlurEffect(float sigma, const SkRRect&);
+
+    bool onIsEqual(const GrFragmentProcessor& other) const override;
+
+    void onComputeInvariantOutput(GrInvariantOutput* inout) const override;
+
+    SkRRect             fRRect;
+    float               fSigma;
+
+    GR_DECLARE_FRAGMENT_PROCESSOR_TEST;
+
+    typedef GrFragmentProcessor INHERITED;
+};
+
+GrFragmentProcessor* GrAnalyticRRectBlurEffect::Create(float sigma, const SkRRect& rrect) {
+    if (!rrect.isRect() && !rrect.isOval() && !rrect.isSimple()) {
+        return NULL;
+    }
+    if (sigma < kMinAnalyticSpansSigma) {
+        return NULL;
+    }
+    return SkNEW_ARGS(GrAnalyticRRectBlurEffect, (sigma, rrect));
+}
+
+void GrAnalyticRRectBlurEffect::onComputeInvariantOutput(GrInvariantOutput* inout) const {
+    inout->mulByUnknownSingleComponent();
+}
+
+GrAnalyticRRectBlurEffect::GrAnalyticRRectBlurEffect(float sigma, const SkRRect& rrect)
+    : fRRect(rrect),
+      fSigma(sigma) {
+    this->initClassID<GrAnalyticRRectBlurEffect>();
+    this->setWillReadFragmentPosition();
+}
+
+bool GrAnalyticRRectBlurEffect::onIsEqual(const GrFragmentProcessor& other) const {
+    const GrAnalyticRRectBlurEffect& arrbe = other.cast<GrAnalyticRRectBlurEffect>();
+    return fRRect == arrbe.fRRect && fSigma == arrbe.fSigma;
+}
+
+GR_DEFINE_FRAGMENT_PROCESSOR_TEST(GrAnalyticRRectBlurEffect);
+
+GrFragmentProcessor* GrAnalyticRRectBlurEffect::TestCreate(SkRandom* random,
+                                                           GrContext* context,
+                                                           const GrDrawTargetCaps& caps,
+                                                           GrTexture*[]) {
+    SkScalar w = random->nextRangeScalar(20.f, 1000.f);
+    SkScalar h = random->nextRangeScalar(20.f, 1000.f);
+    SkScalar r = random->nextRangeF(0.f, 10.f);
+    SkScalar sigma = random->nextRangeF(2.f, 10.f);
+    SkRRect rrect;
+    rrect.setRectXY(SkRect::MakeWH(w, h), r, r);
+    return GrAnalyticRRectBlurEffect::Create(sigma, rrect);
+}
+
+class GrGLAnalyticRRectBlurEffect : public GrGLFragmentProcessor {
+public:
+    GrGLAnalyticRRectBlurEffect(const GrProcessor&) {}
+
+    virtual void emitCode(GrGLFPBuilder*,
+                          const GrFragmentProcessor&,
+                          const char* outputColor,
+                          const char* inputColor,
+                          const TransformedCoordsArray&,
+                          const TextureSamplerArray&) override;
+
+    void setData(const GrGLProgramDataManager&, const GrProcessor&) override;
+
+private:
+    enum {
+        // Strips summed per fragment.
+        kStrips = 16
+    };
+
+    GrGLProgramDataManager::UniformHandle fRectUniform;
+    GrGLProgramDataManager::UniformHandle fBlurUniform;
+    typedef GrGLFragmentProcessor INHERITED;
+};
+
+void GrGLAnalyticRRectBlurEffect::emitCode(GrGLFPBuilder* builder,
+                                           const GrFragmentProcessor&,
+                                           const char* outputColor,
+                                           const char* inputColor,
+                                           const TransformedCoordsArray&,
+                                           const TextureSamplerArray&) {
+    const char* rectName;
+    const char* blurName;
+
+    // The rect's left, top, right, and bottom edges are components x, y, z, and w. The blur
+    // uniform holds the corner radii, 3 sigma and 1 / (sigma * sqrt(2)).
+    fRectUniform = builder->addUniform(GrGLProgramBuilder::kFragment_Visibility,
+                                       kVec4f_GrSLType,
+                                       kDefault_GrSLPrecision,
+                                       "rect",
+                                       &rectName);
+    fBlurUniform = builder->addUniform(GrGLProgramBuilder::kFragment_Visibility,
+                                       kVec4f_GrSLType,
+                                       kDefault_GrSLPrecision,
+                                       "blur",
+                                       &blurName);
+
+    GrGLFPFragmentBuilder* fsBuilder = builder->getFragmentShaderBuilder();
+    const char* fragmentPos = fsBuilder->fragmentPosition();
+
+    // Matches approx_erf() (Abramowitz and Stegun 7.1.27).
+    static const GrGLShaderVar gErfArgs[] = {
+        GrGLShaderVar("x", kFloat_GrSLType),
+    };
+    SkString erfName;
+    fsBuilder->emitFunction(kFloat_GrSLType,
+                            "erf",
+                            SK_ARRAY_COUNT(gErfArgs),
+                            gErfArgs,
+                            "\tfloat ax = abs(x);\n"
+                            "\tfloat d = 1.0 + ax * (0.278393 + ax * (0.230389 + "
+                            "ax * (0.000972 + ax * 0.078108)));\n"
+                            "\td *= d;\n"
+                            "\td *= d;\n"
+                            "\treturn sign(x) * (1.0 - 1.0 / d);\n",
+                            &erfName);
+
+    fsBuilder->codeAppendf("\t\tvec2 pos = %s.xy;\n", fragmentPos);
+    fsBuilder->codeAppendf("\t\tfloat top = max(%s.y, pos.y - %s.z);\n", rectName, blurName);
+    fsBuilder->codeAppendf("\t\tfloat bottom = min(%s.w, pos.y + %s.z);\n", rectName, blurName);
+    fsBuilder->codeAppendf("\t\tfloat step = max(bottom - top, 0.0) / %d.0;\n", kStrips);
+    fsBuilder->codeAppend("\t\tfloat coverage = 0.0;\n");
+    fsBuilder->codeAppendf("\t\tfor (int i = 0; i < %d; i++) {\n", kStrips);
+    fsBuilder->codeAppend("\t\t\tfloat a = top + step * float(i);\n");
+    fsBuilder->codeAppendf("\t\t\tfloat weight = %s((a + step - pos.y) * %s.w) - "
+                           "%s((a - pos.y) * %s.w);\n",
+                           erfName.c_str(), blurName, erfName.c_str(), blurName);
+    // How far the middle of the strip reaches into a corner, as a fraction of its height.
+    fsBuilder->codeAppend("\t\t\tfloat mid = a + 0.5 * step;\n");
+    fsBuilder->codeAppendf("\t\t\tfloat t = max(max(%s.y + %s.y - mid, mid - %s.w + %s.y), 0.0) / "
+                           "max(%s.y, 0.0001);\n",
+                           rectName, blurName, rectName, blurName, blurName);
+    fsBuilder->codeAppendf("\t\t\tfloat inset = %s.x - %s.x * sqrt(max(1.0 - t * t, 0.0));\n",
+                           blurName, blurName);
+    fsBuilder->codeAppendf("\t\t\tcoverage += weight * (%s((pos.x - %s.x - inset) * %s.w) - "
+                           "%s((pos.x - %s.z + inset) * %s.w));\n",
+                           erfName.c_str(), rectName, blurName,
+                           erfName.c_str(), rectName, blurName);
+    fsBuilder->codeAppend("\t\t}\n");
+    fsBuilder->codeAppend("\t\tcoverage = clamp(0.25 * coverage, 0.0, 1.0);\n");
+
+    if (inputColor) {
+        fsBuilder->codeAppendf("\t%s = %s * coverage;\n", outputColor, inputColor);
+    } else {
+        fsBuilder->codeAppendf("\t%s = vec4(coverage);\n", outputColor);
+    }
+}
+
+void GrGLAnalyticRRectBlurEffect::setData(const GrGLProgramDataManager& pdman,
+                                          const GrProcessor& proc) {
+    const GrAnalyticRRectBlurEffect& arrbe = proc.cast<GrAnalyticRRectBlurEffect>();
+    const SkRRect& rrect = arrbe.getRRect();
+    const SkRect& rect = rrect.rect();
+    const SkVector& radii = rrect.getSimpleRadii();
+    const float sigma = arrbe.getSigma();
+    pdman.set4f(fRectUniform, rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
+    pdman.set4f(fBlurUniform, radii.fX, radii.fY, 3 * sigma, 1 / (sigma * SK_ScalarSqrt2));
+}
+
+void GrAnalyticRRectBlurEffect::getGLProcessorKey(const GrGLCaps& caps,
+                                                  GrProcessorKeyBuilder* b) const {
+    GrGLAnalyticRRectBlurEffect::GenKey(*this, caps, b);
+}
+
+GrGLFragmentProcessor* GrAnalyticRRectBlurEffect::createGLInstance() const {
+    return SkNEW_ARGS(GrGLAnalyticRRectBlurEffect, (*this));
+}
+
 bool SkBlurMaskFilterImpl::directFilterRRectMaskGPU(GrContext* context,
                                                     GrRenderTarget* rt,
                                                     GrPaint* grp,
@@ -1135,12 +1541,17 @@ bool SkBlurMaskFilterImpl::directFilterRRectMaskGPU(GrContext* context,
     SkMatrix ctm = viewMatrix;
     SkScalar xformedSigma = this->computeXformedSigma(ctm);
     float extra=3.f*SkScalarCeilToScalar(xformedSigma-1/6.0f);
-    proxy_rect.outset(extra, extra);
 
     SkAutoTUnref<GrFragmentProcessor> fp(GrRRectBlurEffect::Create(context, xformedSigma, rrect));
+    if (!fp && c_analyticBlurSpans) {
+        // Too tight (or too round) to nine patch, so compute the coverage in the shader.
+        fp.reset(GrAnalyticRRectBlurEffect::Create(xformedSigma, rrect));
+        extra = SkScalarCeilToScalar(3 * xformedSigma);
+    }
     if (!fp) {
         return false;
     }
+    proxy_rect.outset(extra, extra);
 
     grp->addCoverageProcessor(fp);
 
@@ -7,6 +7,7 @@
 
 #include "SkColorCubeFilter.h"
 #include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkOnce.h"
 #include "SkReadBuffer.h"
 #include "SkUnPreMultiply.h"
@@ -129,34 +130,42 @@ void SkColorCubeFilter::filterSpan(const SkPMColor src[], int count, SkPMColor d
     fCache.getProcessingLuts(&colorToIndex, &colorToFactors, &colorToScalar);
 
     const int dim = fCache.cubeDimension();
-    SkColor* colorCube = (SkColor*)fCubeData->data();
+    const SkColor* colorCube = (const SkColor*)fCubeData->data();
     for (int i = 0; i < count; ++i) {
+        // Flat runs of one color are common in filtered content, and cost a full trilinear
+        // lookup each, so reuse the previous result when the input repeats.
+        if (i > 0 && src[i] == src[i - 1]) {
+            dst[i] = dst[i - 1];
+            continue;
+        }
         SkColor inputColor = SkUnPreMultiply::PMColorToColor(src[i]);
         uint8_t r = SkColorGetR(inputColor);
         uint8_t g = SkColorGetG(inputColor);
         uint8_t b = SkColorGetB(inputColor);
         uint8_t a = SkColorGetA(inputColor);
-        SkScalar rOut(0), gOut(0), bOut(0);
+        if (0 == a) {
+            dst[i] = 0;
+            continue;
+        }
+        // The r, g and b outputs are accumulated together in lanes 0-2 of one vector.
+        Sk4f out(0);
         for (int x = 0; x < 2; ++x) {
             for (int y = 0; y < 2; ++y) {
+                const SkColor* row = colorCube + colorToIndex[x][r] + colorToIndex[y][g] * dim;
+                const SkScalar factorXY = colorToFactors[x][r] * colorToFactors[y][g];
                 for (int z = 0; z < 2; ++z) {
-                    SkColor lutColor = colorCube[colorToIndex[x][r] +
-                                                (colorToIndex[y][g] +
-                                                 colorToIndex[z][b] * dim) * dim];
-                    SkScalar factor = colorToFactors[x][r] *
-                                      colorToFactors[y][g] *
-                                      colorToFactors[z][b];
-                    rOut += colorToScalar[SkColorGetR(lutColor)] * factor;
-                    gOut += colorToScalar[SkColorGetG(lutColor)] * factor;
-                    bOut += colorToScalar[SkColorGetB(lutColor)] * factor;
+                    SkColor lutColor = row[colorToIndex[z][b] * dim * dim];
+                    SkScalar factor = factorXY * colorToFactors[z][b];
+                    out = out + Sk4f(colorToScalar[SkColorGetR(lutColor)],
+                                     colorToScalar[SkColorGetG(lutColor)],
+                                     colorToScalar[SkColorGetB(lutColor)],
+                                     0) * Sk4f(factor);
                 }
             }
         }
-        const SkScalar aOut = SkIntToScalar(a);
-        dst[i] = SkPackARGB32(a,
-            SkScalarRoundToInt(rOut * aOut),
-            SkScalarRoundToInt(gOut * aOut),
-            SkScalarRoundToInt(bOut * aOut));
+        // Premultiply and round; every lane is non-negative, so truncating x + 0.5 rounds.
+        Sk4i rounded = (out * Sk4f(SkIntToScalar(a)) + Sk4f(SK_ScalarHalf)).castTrunc();
+        dst[i] = SkPackARGB32(a, rounded[0], rounded[1], rounded[2]);
     }
 }
 
@@ -10,6 +10,7 @@
 #include "SkColorPriv.h"
 #include "SkPMFloat.h"
 #include "SkReadBuffer.h"
+#include "SkTableColorFilter.h"
 #include "SkWriteBuffer.h"
 #include "SkUnPreMultiply.h"
 #include "SkString.h"
@@ -384,6 +385,47 @@ bool SkColorMatrixFilter::asColorMatrix(SkScalar matrix[20]) const {
     return true;
 }
 
+// Returns true if no row of the matrix reads any component but its own.
+static bool is_componentwise(const SkScalar matrix[20]) {
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            if (row != col && 0 != matrix[row * 5 + col]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool SkColorMatrixFilter::asComponentTable(SkBitmap* table) const {
+    const SkScalar* mat = fMatrix.fMat;
+    if (!is_componentwise(mat)) {
+        return false;
+    }
+    if (table) {
+        table->allocPixels(SkImageInfo::MakeA8(256, 4));
+        // The table's rows are A, R, G, B; the matrix's are R, G, B, A.
+        static const int kRows[] = { 3, 0, 1, 2 };
+        for (int y = 0; y < 4; ++y) {
+            const SkScalar scale = mat[kRows[y] * 6];
+            const SkScalar trans = mat[kRows[y] * 5 + 4];
+            uint8_t* row = table->getAddr8(0, y);
+            for (int i = 0; i < 256; ++i) {
+                row[i] = SkToU8(pin(SkScalarRoundToInt(scale * i + trans), 255));
+            }
+        }
+    }
+    return true;
+}
+
+// Combines the two lookup tables so that making a lookup using res[] has
+// the same effect as making a lookup through inner[] then outer[].
+static void combine_tables(uint8_t res[256], const uint8_t outer[256], const uint8_t inner[256]) {
+    for (int i = 0; i < 256; i++) {
+        res[i] = outer[inner[i]];
+    }
+}
+
 SkColorFilter* SkColorMatrixFilter::newComposed(const SkColorFilter* innerFilter) const {
     SkScalar innerMatrix[20];
     if (innerFilter->asColorMatrix(innerMatrix) && !SkColorMatrix::NeedsClamping(innerMatrix)) {
@@ -391,6 +433,21 @@ SkColorFilter* SkColorMatrixFilter::newComposed(const SkColorFilter* innerFilter
         SkColorMatrix::SetConcat(concat, fMatrix.fMat, innerMatrix);
         return SkColorMatrixFilter::Create(concat);
     }
+
+    // A scale and translate can still be folded into what the inner filter does to each
+    // component, clamping and all, as long as the inner filter is a table too.
+    SkBitmap outerBM, innerBM;
+    if (this->asComponentTable(&outerBM) && innerFilter->asComponentTable(&innerBM)) {
+        SkAutoLockPixels outerLock(outerBM), innerLock(innerBM);
+        if (NULL == innerBM.getPixels()) {
+            return NULL;
+        }
+        uint8_t concat[4][256];
+        for (int y = 0; y < 4; ++y) {
+            combine_tables(concat[y], outerBM.getAddr8(0, y), innerBM.getAddr8(0, y));
+        }
+        return SkTableColorFilter::CreateARGB(concat[0], concat[1], concat[2], concat[3]);
+    }
     return NULL;
 }
 
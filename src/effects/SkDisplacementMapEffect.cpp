@@ -210,14 +210,15 @@ bool SkDisplacementMapEffect::onFilterImage(Proxy* proxy,
                                             const Context& ctx,
                                             SkBitmap* dst,
                                             SkIPoint* offset) const {
-    SkBitmap displ = src, color = src;
-    const SkImageFilter* colorInput = getColorInput();
-    const SkImageFilter* displInput = getDisplacementInput();
-    SkIPoint colorOffset = SkIPoint::Make(0, 0), displOffset = SkIPoint::Make(0, 0);
-    if ((colorInput && !colorInput->filterImage(proxy, src, ctx, &color, &colorOffset)) ||
-        (displInput && !displInput->filterImage(proxy, src, ctx, &displ, &displOffset))) {
+    SkBitmap inputs[2];
+    SkIPoint inputOffsets[2];
+    if (!this->filterInputs(proxy, src, ctx, inputs, inputOffsets)) {
         return false;
     }
+    SkBitmap& displ = inputs[0];
+    SkBitmap& color = inputs[1];
+    SkIPoint& displOffset = inputOffsets[0];
+    const SkIPoint& colorOffset = inputOffsets[1];
     if ((displ.colorType() != kN32_SkColorType) ||
         (color.colorType() != kN32_SkColorType)) {
         return false;
@@ -197,6 +197,48 @@ bool SkLayerDrawLooper::asABlurShadow(BlurShadowRec* bsRec) const {
     return true;
 }
 
+bool SkLayerDrawLooper::asAHalo(HaloRec* haloRec) const {
+    if (fCount != 2) {
+        return false;
+    }
+    const Rec* rec = fRecs;
+
+    // bottom layer needs to be just a round-joined stroke and fill, in its own color
+    if (kStyle_Bit != rec->fInfo.fPaintBits) {
+        return false;
+    }
+    if (SkXfermode::kSrc_Mode != rec->fInfo.fColorMode) {
+        return false;
+    }
+    if (!rec->fInfo.fOffset.equals(0, 0)) {
+        return false;
+    }
+    const SkPaint& haloPaint = rec->fPaint;
+    if (SkPaint::kStrokeAndFill_Style != haloPaint.getStyle() ||
+        SkPaint::kRound_Join != haloPaint.getStrokeJoin() ||
+        !(haloPaint.getStrokeWidth() > 0)) {
+        return false;
+    }
+
+    rec = rec->fNext;
+    // top layer needs to be "plain"
+    if (rec->fInfo.fPaintBits) {
+        return false;
+    }
+    if (SkXfermode::kDst_Mode != rec->fInfo.fColorMode) {
+        return false;
+    }
+    if (!rec->fInfo.fOffset.equals(0, 0)) {
+        return false;
+    }
+
+    if (haloRec) {
+        haloRec->fRadius = SkScalarHalf(haloPaint.getStrokeWidth());
+        haloRec->fColor = haloPaint.getColor();
+    }
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkLayerDrawLooper::flatten(SkWriteBuffer& buffer) const {
@@ -8,6 +8,7 @@
 #include "SkLightingImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkReadBuffer.h"
@@ -28,6 +29,8 @@ class GrGLSpecularLightingEffect;
 typedef GrGLProgramDataManager::UniformHandle UniformHandle;
 #endif
 
+class SkDistantLight;
+
 namespace {
 
 const SkScalar gOneThird = SkScalarInvert(SkIntToScalar(3));
@@ -62,6 +65,7 @@ class DiffuseLightingType {
 public:
     DiffuseLightingType(SkScalar kd)
         : fKD(kd) {}
+    SkScalar kd() const { return fKD; }
     SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight,
                     const SkPoint3& lightColor) const {
         SkScalar colorScale = SkScalarMul(fKD, normal.dot(surfaceTolight));
@@ -166,6 +170,91 @@ inline SkPoint3 bottomRightNormal(int m[9], SkScalar surfaceScale) {
                          surfaceScale);
 }
 
+// The interior normals, which are nearly all of them, are found a chunk of a row at a time, four
+// pixels at a time, from the row's alpha and the alpha above and below it. They match the ones
+// interiorNormal() finds exactly.
+struct InteriorChunk {
+    static const int kMaxCount = 64;
+
+    void computeNormals(const SkPMColor* row0, const SkPMColor* row1, const SkPMColor* row2,
+                        int count, SkScalar surfaceScale);
+
+    // Interior pixel i is at column i + 1 of the alpha rows, and its normal is normal i.
+    SkScalar fAlpha[3][kMaxCount + 2 + 3];
+    SkScalar fNormalX[kMaxCount + 3];
+    SkScalar fNormalY[kMaxCount + 3];
+    SkScalar fNormalZ[kMaxCount + 3];
+    int      fZ[kMaxCount];
+};
+
+void InteriorChunk::computeNormals(const SkPMColor* row0, const SkPMColor* row1,
+                                   const SkPMColor* row2, int count, SkScalar surfaceScale) {
+    SkASSERT(count > 0 && count <= kMaxCount);
+    const SkPMColor* rows[3] = { row0, row1, row2 };
+    for (int r = 0; r < 3; ++r) {
+        for (int i = 0; i < count + 2; ++i) {
+            fAlpha[r][i] = SkIntToScalar(SkGetPackedA32(rows[r][i]));
+        }
+        // The lanes past the end are computed but not used.
+        for (int i = count + 2; i < count + 5; ++i) {
+            fAlpha[r][i] = 0;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        fZ[i] = SkGetPackedA32(row1[i + 1]);
+    }
+
+    const Sk4f two(2), quarter(gOneQuarter), negScale(-surfaceScale), one(SK_Scalar1);
+    const Sk4f nearlyZero(SK_ScalarNearlyZero);
+    for (int i = 0; i < count; i += 4) {
+        Sk4f m0 = Sk4f::Load(&fAlpha[0][i]), m1 = Sk4f::Load(&fAlpha[0][i + 1]),
+             m2 = Sk4f::Load(&fAlpha[0][i + 2]);
+        Sk4f m3 = Sk4f::Load(&fAlpha[1][i]), m5 = Sk4f::Load(&fAlpha[1][i + 2]);
+        Sk4f m6 = Sk4f::Load(&fAlpha[2][i]), m7 = Sk4f::Load(&fAlpha[2][i + 1]),
+             m8 = Sk4f::Load(&fAlpha[2][i + 2]);
+        // The sums are of small integers, so they're exact in any order.
+        Sk4f x = (m2 - m0 + two * (m5 - m3) + m8 - m6) * quarter * negScale;
+        Sk4f y = (m6 - m0 + two * (m7 - m1) + m8 - m2) * quarter * negScale;
+        Sk4f scale = ((x * x + y * y + one).sqrt() + nearlyZero).invert();
+        (x * scale).store(&fNormalX[i]);
+        (y * scale).store(&fNormalY[i]);
+        scale.store(&fNormalZ[i]);
+    }
+}
+
+template <class LightingType, class LightType> void lightInterior(
+        const LightingType& lightingType, const LightType* l, const InteriorChunk& chunk,
+        int x, int y, int count, SkScalar surfaceScale, SkPMColor* dst) {
+    for (int i = 0; i < count; ++i) {
+        SkPoint3 normal(chunk.fNormalX[i], chunk.fNormalY[i], chunk.fNormalZ[i]);
+        SkPoint3 surfaceToLight = l->surfaceToLight(x + i, y, chunk.fZ[i], surfaceScale);
+        dst[i] = lightingType.light(normal, surfaceToLight, l->lightColor(surfaceToLight));
+    }
+}
+
+// A distant light's diffuse term is the same for every pixel with the same normal, so it's
+// computed four pixels at a time too. Defined after SkDistantLight.
+void lightInterior(const DiffuseLightingType&, const SkDistantLight*, const InteriorChunk&,
+                   int x, int y, int count, SkScalar surfaceScale, SkPMColor* dst);
+
+template <class LightingType, class LightType> void lightInteriorRow(
+        const LightingType& lightingType, const LightType* l, const SkPMColor* row0,
+        const SkPMColor* row1, const SkPMColor* row2, int x, int y, int count,
+        SkScalar surfaceScale, SkPMColor* dst) {
+    InteriorChunk chunk;
+    while (count > 0) {
+        int n = SkTMin(count, static_cast<int>(InteriorChunk::kMaxCount));
+        chunk.computeNormals(row0, row1, row2, n, surfaceScale);
+        lightInterior(lightingType, l, chunk, x, y, n, surfaceScale, dst);
+        row0 += n;
+        row1 += n;
+        row2 += n;
+        x += n;
+        dst += n;
+        count -= n;
+    }
+}
+
 template <class LightingType, class LightType> void lightBitmap(
         const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst,
         SkScalar surfaceScale, const SkIRect& bounds) {
@@ -217,16 +306,20 @@ template <class LightingType, class LightType> void lightBitmap(
         SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
         *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
                                      l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
+        const int interiorCount = right - left - 2;
+        lightInteriorRow(lightingType, l, row0 - 2, row1 - 2, row2 - 2, x + 1, y, interiorCount,
+                         surfaceScale, dptr);
+        dptr += interiorCount;
+        x = right - 1;
+        row0 = src.getAddr32(x - 1, y - 1);
+        row1 = src.getAddr32(x - 1, y);
+        row2 = src.getAddr32(x - 1, y + 1);
+        m[0] = SkGetPackedA32(*row0++);
+        m[1] = SkGetPackedA32(*row0++);
+        m[3] = SkGetPackedA32(*row1++);
+        m[4] = SkGetPackedA32(*row1++);
+        m[6] = SkGetPackedA32(*row2++);
+        m[7] = SkGetPackedA32(*row2++);
         surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
         *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
                                      l->lightColor(surfaceToLight));
@@ -633,6 +726,41 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+void lightInterior(const DiffuseLightingType& lightingType, const SkDistantLight* l,
+                   const InteriorChunk& chunk, int, int, int count, SkScalar, SkPMColor* dst) {
+    const SkPoint3& surfaceToLight = l->direction();
+    const SkPoint3& color = l->color();
+    const Sk4f kd(lightingType.kd()), zero(0), one(SK_Scalar1), half(SK_ScalarHalf), max(255);
+    const Sk4f lightX(surfaceToLight.fX), lightY(surfaceToLight.fY), lightZ(surfaceToLight.fZ);
+    const Sk4f r(color.fX), g(color.fY), b(color.fZ);
+    const Sk4i alpha(SK_A32_MASK << SK_A32_SHIFT);
+    for (int i = 0; i < count; i += 4) {
+        Sk4f nx = Sk4f::Load(&chunk.fNormalX[i]);
+        Sk4f ny = Sk4f::Load(&chunk.fNormalY[i]);
+        Sk4f nz = Sk4f::Load(&chunk.fNormalZ[i]);
+        Sk4f scale = Sk4f::Max(Sk4f::Min(kd * (nx * lightX + ny * lightY + nz * lightZ), one),
+                               zero);
+        // The channels aren't negative, so truncating after adding a half rounds them.
+        Sk4i pixels = alpha |
+                      (Sk4f::Min(r * scale + half, max).castTrunc() << SK_R32_SHIFT) |
+                      (Sk4f::Min(g * scale + half, max).castTrunc() << SK_G32_SHIFT) |
+                      (Sk4f::Min(b * scale + half, max).castTrunc() << SK_B32_SHIFT);
+        if (i + 4 <= count) {
+            pixels.store(reinterpret_cast<int32_t*>(dst + i));
+        } else {
+            for (int j = 0; i + j < count; ++j) {
+                dst[i + j] = pixels[j];
+            }
+        }
+    }
+}
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
 class SkPointLight : public SkLight {
 public:
     SkPointLight(const SkPoint3& location, SkColor color)
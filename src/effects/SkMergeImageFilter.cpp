@@ -74,30 +74,23 @@ bool SkMergeImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     if (NULL == dst) {
         return false;
     }
+    int inputCount = countInputs();
+    SkAutoSTArray<4, SkBitmap> inputs(inputCount);
+    SkAutoSTArray<4, SkIPoint> positions(inputCount);
+    if (!this->filterInputs(proxy, src, ctx, inputs.get(), positions.get())) {
+        return false;
+    }
+
     SkCanvas canvas(dst);
     SkPaint paint;
 
-    int inputCount = countInputs();
     for (int i = 0; i < inputCount; ++i) {
-        SkBitmap tmp;
-        const SkBitmap* srcPtr;
-        SkIPoint pos = SkIPoint::Make(0, 0);
-        SkImageFilter* filter = getInput(i);
-        if (filter) {
-            if (!filter->filterImage(proxy, src, ctx, &tmp, &pos)) {
-                return false;
-            }
-            srcPtr = &tmp;
-        } else {
-            srcPtr = &src;
-        }
-
         if (fModes) {
             paint.setXfermodeMode((SkXfermode::Mode)fModes[i]);
         } else {
             paint.setXfermode(NULL);
         }
-        canvas.drawSprite(*srcPtr, pos.x() - x0, pos.y() - y0, &paint);
+        canvas.drawSprite(inputs[i], positions[i].x() - x0, positions[i].y() - y0, &paint);
     }
 
     offset->fX = bounds.left();
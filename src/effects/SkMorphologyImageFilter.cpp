@@ -12,6 +12,7 @@
 #include "SkWriteBuffer.h"
 #include "SkRect.h"
 #include "SkMorphology_opts.h"
+#include "SkTemplates.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #include "GrInvariantOutput.h"
@@ -114,15 +115,95 @@ static void dilate(const SkPMColor* src, SkPMColor* dst,
     }
 }
 
-static void callProcX(SkMorphologyImageFilter::Proc procX, const SkBitmap& src, SkBitmap* dst, int radiusX, const SkIRect& bounds)
+enum MorphType {
+    kDilate, kErode
+};
+
+// At and above this radius the van Herk/Gil-Werman procs, whose cost doesn't depend on the
+// radius, beat the procs that look at every pixel in the window.
+static const int kVanHerkMinRadius = 6;
+
+template<MorphType type>
+static inline SkPMColor morph_pixels(SkPMColor a, SkPMColor b) {
+    if (type == kDilate) {
+        return SkPackARGB32(SkTMax(SkGetPackedA32(a), SkGetPackedA32(b)),
+                            SkTMax(SkGetPackedR32(a), SkGetPackedR32(b)),
+                            SkTMax(SkGetPackedG32(a), SkGetPackedG32(b)),
+                            SkTMax(SkGetPackedB32(a), SkGetPackedB32(b)));
+    }
+    return SkPackARGB32(SkTMin(SkGetPackedA32(a), SkGetPackedA32(b)),
+                        SkTMin(SkGetPackedR32(a), SkGetPackedR32(b)),
+                        SkTMin(SkGetPackedG32(a), SkGetPackedG32(b)),
+                        SkTMin(SkGetPackedB32(a), SkGetPackedB32(b)));
+}
+
+/**
+ *  van Herk/Gil-Werman erode or dilate, which costs three min or max per pixel whatever the
+ *  radius. Each line is cut into blocks the size of the window; every window spans at most two
+ *  blocks, so its result is the suffix of the first block it touches combined with the prefix of
+ *  the second. Windows clamped at the ends of the line are prefixes or suffixes themselves.
+ */
+template<MorphType type, MorphDirection direction>
+static void morph_van_herk(const SkPMColor* src, SkPMColor* dst,
+                           int radius, int width, int height,
+                           int srcStride, int dstStride)
 {
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    radius = SkMin32(radius, width - 1);
+    const int window = 2 * radius + 1;
+    const int lastBlock = (width - 1) / window * window;
+    SkAutoTMalloc<SkPMColor> storage(2 * width);
+    SkPMColor* prefix = storage.get();
+    SkPMColor* suffix = prefix + width;
+    for (int y = 0; y < height; ++y) {
+        const SkPMColor* sptr = src + y * srcStrideY;
+        SkPMColor* dptr = dst + y * dstStrideY;
+        for (int start = 0; start < width; start += window) {
+            const int end = SkMin32(start + window, width);
+            prefix[start] = sptr[start * srcStrideX];
+            for (int x = start + 1; x < end; ++x) {
+                prefix[x] = morph_pixels<type>(prefix[x - 1], sptr[x * srcStrideX]);
+            }
+            suffix[end - 1] = sptr[(end - 1) * srcStrideX];
+            for (int x = end - 2; x >= start; --x) {
+                suffix[x] = morph_pixels<type>(suffix[x + 1], sptr[x * srcStrideX]);
+            }
+        }
+        // Windows clamped on the left are prefixes of the first block.
+        int x = 0;
+        for (; x <= radius; ++x) {
+            dptr[x * dstStrideX] = prefix[SkMin32(x + radius, width - 1)];
+        }
+        for (; x + radius < width; ++x) {
+            dptr[x * dstStrideX] = morph_pixels<type>(suffix[x - radius], prefix[x + radius]);
+        }
+        // Windows clamped on the right end with the line, as does the suffix of the last block.
+        for (; x < width; ++x) {
+            const int lo = x - radius;
+            dptr[x * dstStrideX] = lo >= lastBlock ? suffix[lo]
+                                 : morph_pixels<type>(suffix[lo], prefix[width - 1]);
+        }
+    }
+}
+
+static void callProcX(SkMorphologyImageFilter::Proc procX, SkMorphologyImageFilter::Proc vanHerkProcX, const SkBitmap& src, SkBitmap* dst, int radiusX, const SkIRect& bounds)
+{
+    if (radiusX >= kVanHerkMinRadius) {
+        procX = vanHerkProcX;
+    }
     procX(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
           radiusX, bounds.width(), bounds.height(),
           src.rowBytesAsPixels(), dst->rowBytesAsPixels());
 }
 
-static void callProcY(SkMorphologyImageFilter::Proc procY, const SkBitmap& src, SkBitmap* dst, int radiusY, const SkIRect& bounds)
+static void callProcY(SkMorphologyImageFilter::Proc procY, SkMorphologyImageFilter::Proc vanHerkProcY, const SkBitmap& src, SkBitmap* dst, int radiusY, const SkIRect& bounds)
 {
+    if (radiusY >= kVanHerkMinRadius) {
+        procY = vanHerkProcY;
+    }
     procY(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
           radiusY, bounds.height(), bounds.width(),
           src.rowBytesAsPixels(), dst->rowBytesAsPixels());
@@ -130,6 +211,8 @@ static void callProcY(SkMorphologyImageFilter::Proc procY, const SkBitmap& src,
 
 bool SkMorphologyImageFilter::filterImageGeneric(SkMorphologyImageFilter::Proc procX,
                                                  SkMorphologyImageFilter::Proc procY,
+                                                 SkMorphologyImageFilter::Proc vanHerkProcX,
+                                                 SkMorphologyImageFilter::Proc vanHerkProcY,
                                                  Proxy* proxy,
                                                  const SkBitmap& source,
                                                  const Context& ctx,
@@ -185,13 +268,13 @@ bool SkMorphologyImageFilter::filterImageGeneric(SkMorphologyImageFilter::Proc p
     }
 
     if (width > 0 && height > 0) {
-        callProcX(procX, src, &temp, width, srcBounds);
+        callProcX(procX, vanHerkProcX, src, &temp, width, srcBounds);
         SkIRect tmpBounds = SkIRect::MakeWH(srcBounds.width(), srcBounds.height());
-        callProcY(procY, temp, dst, height, tmpBounds);
+        callProcY(procY, vanHerkProcY, temp, dst, height, tmpBounds);
     } else if (width > 0) {
-        callProcX(procX, src, dst, width, srcBounds);
+        callProcX(procX, vanHerkProcX, src, dst, width, srcBounds);
     } else if (height > 0) {
-        callProcY(procY, src, dst, height, srcBounds);
+        callProcY(procY, vanHerkProcY, src, dst, height, srcBounds);
     }
     offset->fX = bounds.left();
     offset->fY = bounds.top();
@@ -209,7 +292,16 @@ bool SkErodeImageFilter::onFilterImage(Proxy* proxy,
     if (!erodeYProc) {
         erodeYProc = erode<kY>;
     }
-    return this->filterImageGeneric(erodeXProc, erodeYProc, proxy, source, ctx, dst, offset);
+    Proc erodeXVanHerkProc = SkMorphologyGetPlatformProc(kErodeXVanHerk_SkMorphologyProcType);
+    if (!erodeXVanHerkProc) {
+        erodeXVanHerkProc = morph_van_herk<kErode, kX>;
+    }
+    Proc erodeYVanHerkProc = SkMorphologyGetPlatformProc(kErodeYVanHerk_SkMorphologyProcType);
+    if (!erodeYVanHerkProc) {
+        erodeYVanHerkProc = morph_van_herk<kErode, kY>;
+    }
+    return this->filterImageGeneric(erodeXProc, erodeYProc, erodeXVanHerkProc, erodeYVanHerkProc,
+                                    proxy, source, ctx, dst, offset);
 }
 
 bool SkDilateImageFilter::onFilterImage(Proxy* proxy,
@@ -223,7 +315,16 @@ bool SkDilateImageFilter::onFilterImage(Proxy* proxy,
     if (!dilateYProc) {
         dilateYProc = dilate<kY>;
     }
-    return this->filterImageGeneric(dilateXProc, dilateYProc, proxy, source, ctx, dst, offset);
+    Proc dilateXVanHerkProc = SkMorphologyGetPlatformProc(kDilateXVanHerk_SkMorphologyProcType);
+    if (!dilateXVanHerkProc) {
+        dilateXVanHerkProc = morph_van_herk<kDilate, kX>;
+    }
+    Proc dilateYVanHerkProc = SkMorphologyGetPlatformProc(kDilateYVanHerk_SkMorphologyProcType);
+    if (!dilateYVanHerkProc) {
+        dilateYVanHerkProc = morph_van_herk<kDilate, kY>;
+    }
+    return this->filterImageGeneric(dilateXProc, dilateYProc, dilateXVanHerkProc, dilateYVanHerkProc,
+                                    proxy, source, ctx, dst, offset);
 }
 
 void SkMorphologyImageFilter::computeFastBounds(const SkRect& src, SkRect* dst) const {
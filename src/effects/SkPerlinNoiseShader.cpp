@@ -8,7 +8,9 @@
 #include "SkDither.h"
 #include "SkPerlinNoiseShader.h"
 #include "SkColorFilter.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkWriteBuffer.h"
 #include "SkShader.h"
 #include "SkUnPreMultiply.h"
@@ -104,6 +106,9 @@ struct SkPerlinNoiseShader::PaintingData {
     uint8_t     fLatticeSelector[kBlockSize];
     uint16_t    fNoise[4][kBlockSize][2];
     SkPoint     fGradient[4][kBlockSize];
+    // fGradient again, with the four channels of each lattice point side by side.
+    SkScalar    fGradientX[kBlockSize][4];
+    SkScalar    fGradientY[kBlockSize][4];
     SkISize     fTileSize;
     SkVector    fBaseFrequency;
     StitchData  fStitchDataInit;
@@ -195,6 +200,8 @@ private:
                     fGradient[channel][i].fX + SK_Scalar1, gHalfMax16bits));
                 fNoise[channel][i][1] = SkScalarRoundToInt(SkScalarMul(
                     fGradient[channel][i].fY + SK_Scalar1, gHalfMax16bits));
+                fGradientX[i][channel] = fGradient[channel][i].fX;
+                fGradientY[i][channel] = fGradient[channel][i].fY;
             }
         }
     }
@@ -313,8 +320,71 @@ void SkPerlinNoiseShader::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
+namespace {
+
+static unsigned gNoiseTileKeyNamespaceLabel;
+
+// Identifies the noise of a stitched tile: everything the noise of a point depends on.
+struct NoiseTileKey : public SkResourceCache::Key {
+public:
+    NoiseTileKey(SkPerlinNoiseShader::Type type, int numOctaves, SkScalar seed,
+                 const SkVector& baseFrequency, const SkISize& tileSize, U8CPU alpha)
+        : fType(type)
+        , fNumOctaves(numOctaves)
+        , fSeed(seed)
+        , fBaseFrequency(baseFrequency)
+        , fTileSize(tileSize)
+        , fAlpha(alpha) {
+        static const size_t keySize = sizeof(fType) + sizeof(fNumOctaves) + sizeof(fSeed) +
+                                      sizeof(fBaseFrequency) + sizeof(fTileSize) +
+                                      sizeof(fAlpha);
+        // This better be packed.
+        SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - (uint32_t*)&fType) == keySize);
+        this->init(&gNoiseTileKeyNamespaceLabel, 0, keySize);
+    }
+
+private:
+    int32_t  fType;
+    int32_t  fNumOctaves;
+    SkScalar fSeed;
+    SkVector fBaseFrequency;
+    SkISize  fTileSize;
+    uint32_t fAlpha;
+
+    SkDEBUGCODE(uint32_t fEndOfStruct;)
+};
+
+struct NoiseTileRec : public SkResourceCache::Rec {
+    NoiseTileRec(const NoiseTileKey& key, const SkBitmap& tile)
+        : fKey(key)
+        , fTile(tile) {}
+
+    NoiseTileKey fKey;
+    SkBitmap     fTile;
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "perlin-noise"; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fTile.getSize(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextTile) {
+        const NoiseTileRec& rec = static_cast<const NoiseTileRec&>(baseRec);
+        SkBitmap* result = static_cast<SkBitmap*>(contextTile);
+        *result = rec.fTile;
+        result->lockPixels();
+        return result->getPixels() != NULL;
+    }
+};
+
+// Tiles up to this many points are cached; bigger ones would cost too much to make up front.
+static const int kMaxCachedTilePoints = 256 * 256;
+
+} // end namespace
+
+// Returns the noise of all four channels at noiseVector. Everything but the gradients is the
+// same for each channel, so it is worked out once.
+static Sk4f noise2D(const SkPerlinNoiseShader::PaintingData& paintingData, bool stitchTiles,
+                    const SkPerlinNoiseShader::StitchData& stitchData,
+                    const SkPoint& noiseVector) {
     struct Noise {
         int noisePositionIntegerValue;
         int nextNoisePositionIntegerValue;
@@ -329,10 +399,8 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
     };
     Noise noiseX(noiseVector.x());
     Noise noiseY(noiseVector.y());
-    SkScalar u, v;
-    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
+    if (stitchTiles) {
         noiseX.noisePositionIntegerValue =
             checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
         noiseY.noisePositionIntegerValue =
@@ -347,45 +415,72 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
     noiseX.nextNoisePositionIntegerValue &= kBlockMask;
     noiseY.nextNoisePositionIntegerValue &= kBlockMask;
     int i =
-        fPaintingData->fLatticeSelector[noiseX.noisePositionIntegerValue];
+        paintingData.fLatticeSelector[noiseX.noisePositionIntegerValue];
     int j =
-        fPaintingData->fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
+        paintingData.fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
     int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
     int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
     int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
     int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
+    Sk4f sx(smoothCurve(noiseX.noisePositionFractionValue));
+    Sk4f sy(smoothCurve(noiseY.noisePositionFractionValue));
     // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData->fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData->fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData->fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData->fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
+    Sk4f fx(noiseX.noisePositionFractionValue);
+    Sk4f fy(noiseY.noisePositionFractionValue);
+    Sk4f fx1(noiseX.noisePositionFractionValue - SK_Scalar1);
+    Sk4f fy1(noiseY.noisePositionFractionValue - SK_Scalar1);
+    Sk4f u = Sk4f::Load(paintingData.fGradientX[b00]) * fx +
+             Sk4f::Load(paintingData.fGradientY[b00]) * fy;    // Offset (0,0)
+    Sk4f v = Sk4f::Load(paintingData.fGradientX[b10]) * fx1 +
+             Sk4f::Load(paintingData.fGradientY[b10]) * fy;    // Offset (-1,0)
+    Sk4f a = u + (v - u) * sx;
+    v = Sk4f::Load(paintingData.fGradientX[b11]) * fx1 +
+        Sk4f::Load(paintingData.fGradientY[b11]) * fy1;        // Offset (-1,-1)
+    u = Sk4f::Load(paintingData.fGradientX[b01]) * fx +
+        Sk4f::Load(paintingData.fGradientY[b01]) * fy1;        // Offset (0,-1)
+    Sk4f b = u + (v - u) * sx;
+    return a + (b - a) * sy;
+}
+
+SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
+        const SkPoint& point, StitchData& stitchData) const {
+    SkPoint newPoint;
+    fMatrix.mapPoints(&newPoint, &point, 1);
+    newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
+    newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
+
+    // The noise only depends on the rounded point, so the tile, when there is one, holds the
+    // noise of the integer points inside it.
+    if (fCachedTile.getPixels()) {
+        SkScalar width = SkIntToScalar(fCachedTile.width());
+        SkScalar height = SkIntToScalar(fCachedTile.height());
+        if (newPoint.fX >= 0 && newPoint.fX < width && newPoint.fY >= 0 && newPoint.fY < height) {
+            return *fCachedTile.getAddr32(SkScalarTruncToInt(newPoint.fX),
+                                          SkScalarTruncToInt(newPoint.fY));
+        }
+    }
+    return this->shadeNoisePoint(newPoint, stitchData);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
+SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeNoisePoint(
+        const SkPoint& point, StitchData& stitchData) const {
     const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     if (perlinNoiseShader.fStitchTiles) {
         // Set up TurbulenceInitial stitch values.
         stitchData = fPaintingData->fStitchDataInit;
     }
-    SkScalar turbulenceFunctionResult = 0;
+    // The channels are computed together, R, G, B and A in that order.
+    Sk4f turbulenceFunctionResult(0);
     SkPoint noiseVector(SkPoint::Make(SkScalarMul(point.x(), fPaintingData->fBaseFrequency.fX),
                                       SkScalarMul(point.y(), fPaintingData->fBaseFrequency.fY)));
     SkScalar ratio = SK_Scalar1;
     for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        turbulenceFunctionResult += SkScalarDiv(
-            (perlinNoiseShader.fType == kFractalNoise_Type) ? noise : SkScalarAbs(noise), ratio);
+        Sk4f noise = noise2D(*fPaintingData, perlinNoiseShader.fStitchTiles, stitchData,
+                             noiseVector);
+        if (perlinNoiseShader.fType != kFractalNoise_Type) {
+            noise = Sk4f::Max(noise, -noise);
+        }
+        turbulenceFunctionResult += noise / Sk4f(ratio);
         noiseVector.fX *= 2;
         noiseVector.fY *= 2;
         ratio *= 2;
@@ -402,30 +497,17 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValue
     // by fractalNoise and (turbulenceFunctionResult) by turbulence.
     if (perlinNoiseShader.fType == kFractalNoise_Type) {
         turbulenceFunctionResult =
-            SkScalarMul(turbulenceFunctionResult, SK_ScalarHalf) + SK_ScalarHalf;
-    }
-
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult = SkScalarMul(turbulenceFunctionResult,
-            SkScalarDiv(SkIntToScalar(getPaintAlpha()), SkIntToScalar(255)));
+            turbulenceFunctionResult * Sk4f(SK_ScalarHalf) + Sk4f(SK_ScalarHalf);
     }
 
-    // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
-}
+    // Scale alpha by paint value
+    SkScalar alphaScale = SkScalarDiv(SkIntToScalar(getPaintAlpha()), SkIntToScalar(255));
+    turbulenceFunctionResult =
+        turbulenceFunctionResult * Sk4f(SK_Scalar1, SK_Scalar1, SK_Scalar1, alphaScale);
 
-SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
-        const SkPoint& point, StitchData& stitchData) const {
-    SkPoint newPoint;
-    fMatrix.mapPoints(&newPoint, &point, 1);
-    newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
-    newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
-
-    U8CPU rgba[4];
-    for (int channel = 3; channel >= 0; --channel) {
-        rgba[channel] = SkScalarFloorToInt(255 *
-            calculateTurbulenceValueForPoint(channel, stitchData, newPoint));
-    }
+    // Clamp result, and since it isn't negative, truncating it is taking its floor.
+    Sk4i rgba = (Sk4f(255) * Sk4f::Max(Sk4f::Min(turbulenceFunctionResult, Sk4f(SK_Scalar1)),
+                                       Sk4f(0))).castTrunc();
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
 
@@ -451,6 +533,30 @@ SkPerlinNoiseShader::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
     fMatrix.setTranslate(-newMatrix.getTranslateX() + SK_Scalar1, -newMatrix.getTranslateY() + SK_Scalar1);
     fPaintingData = SkNEW_ARGS(PaintingData, (shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX, shader.fBaseFrequencyY, newMatrix));
+
+    // A stitched tile is usually drawn over and over, so the noise of the points in it (and of
+    // the row and column just past it, since the noise is 1 based) is made once and cached.
+    const SkISize& tileSize = fPaintingData->fTileSize;
+    if (shader.fStitchTiles && !tileSize.isEmpty() &&
+        (int64_t)(tileSize.width() + 1) * (tileSize.height() + 1) <= kMaxCachedTilePoints) {
+        NoiseTileKey key(shader.fType, shader.fNumOctaves, shader.fSeed,
+                         fPaintingData->fBaseFrequency, tileSize, this->getPaintAlpha());
+        if (!SkResourceCache::Find(key, NoiseTileRec::Visitor, &fCachedTile)) {
+            fCachedTile.reset();
+            SkBitmap tile;
+            if (tile.tryAllocN32Pixels(tileSize.width() + 1, tileSize.height() + 1)) {
+                StitchData stitchData;
+                for (int y = 0; y < tile.height(); ++y) {
+                    for (int x = 0; x < tile.width(); ++x) {
+                        *tile.getAddr32(x, y) = this->shadeNoisePoint(
+                                SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y)), stitchData);
+                    }
+                }
+                SkResourceCache::Add(SkNEW_ARGS(NoiseTileRec, (key, tile)));
+                fCachedTile = tile;
+            }
+        }
+    }
 }
 
 SkPerlinNoiseShader::PerlinNoiseShaderContext::~PerlinNoiseShaderContext() {
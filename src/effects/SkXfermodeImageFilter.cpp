@@ -47,19 +47,14 @@ bool SkXfermodeImageFilter::onFilterImage(Proxy* proxy,
                                             const Context& ctx,
                                             SkBitmap* dst,
                                             SkIPoint* offset) const {
-    SkBitmap background = src, foreground = src;
-    SkImageFilter* backgroundInput = getInput(0);
-    SkImageFilter* foregroundInput = getInput(1);
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    if (backgroundInput &&
-        !backgroundInput->filterImage(proxy, src, ctx, &background, &backgroundOffset)) {
-        background.reset();
-    }
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    if (foregroundInput &&
-        !foregroundInput->filterImage(proxy, src, ctx, &foreground, &foregroundOffset)) {
-        foreground.reset();
-    }
+    // A failed input is left empty, and blended as transparent black.
+    SkBitmap inputs[2];
+    SkIPoint inputOffsets[2];
+    (void)this->filterInputs(proxy, src, ctx, inputs, inputOffsets);
+    SkBitmap& background = inputs[0];
+    SkBitmap& foreground = inputs[1];
+    const SkIPoint& backgroundOffset = inputOffsets[0];
+    const SkIPoint& foregroundOffset = inputOffsets[1];
 
     SkIRect bounds, foregroundBounds;
     if (!applyCropRect(ctx, foreground, foregroundOffset, &foregroundBounds)) {
@@ -6,6 +6,7 @@
  */
 
 #include "SkLinearGradient.h"
+#include "SkNx.h"
 
 static inline int repeat_bits(int x, const int bits) {
     return x & ((1 << bits) - 1);
@@ -113,6 +114,63 @@ SkLinearGradient::LinearGradientContext::LinearGradientContext(
 
 namespace {
 
+// The Sk4i kernels below step four pixels at a time. Each lane holds the low 32 bits of its
+// pixel's fx, which stay exact as the lanes step by 4 * dx, and the cache index is their top
+// byte. The dither toggle alternates from lane to lane, so it is the same for every step.
+
+static inline Sk4i lane_dither(int toggle) {
+    const int other = next_dither_toggle(toggle);
+    return Sk4i(toggle, other, toggle, other);
+}
+
+static inline void store4(SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
+                          const Sk4i& index) {
+    int32_t i[4];
+    index.store(i);
+    dstC[0] = cache[i[0]];
+    dstC[1] = cache[i[1]];
+    dstC[2] = cache[i[2]];
+    dstC[3] = cache[i[3]];
+}
+
+// Shades the first count & ~3 pixels, for repeat or for a clamp range whose fx stays in
+// [0, 1). Returns the fx of the pixel after them.
+static SkGradFixed shade4_linear_repeat(SkGradFixed fx, SkGradFixed dx,
+                                        SkPMColor* SK_RESTRICT dstC,
+                                        const SkPMColor* SK_RESTRICT cache,
+                                        int toggle, int count) {
+    Sk4i lanes((int32_t)fx, (int32_t)(fx + dx), (int32_t)(fx + 2 * dx), (int32_t)(fx + 3 * dx));
+    const Sk4i step((int32_t)(4 * dx));
+    const Sk4i dither = lane_dither(toggle);
+    const Sk4i mask(0xFF);
+    for (int i = 0; i < count >> 2; i++) {
+        store4(dstC, cache, ((lanes >> 24) & mask) + dither);
+        lanes += step;
+        dstC += 4;
+    }
+    return fx + (count & ~3) * dx;
+}
+
+// For mirror the lanes hold fx >> 1 instead, so they also carry the bit which picks the
+// direction. fx + 4 * dx stays exact after the shift because 4 * dx is even.
+static SkGradFixed shade4_linear_mirror(SkGradFixed fx, SkGradFixed dx,
+                                        SkPMColor* SK_RESTRICT dstC,
+                                        const SkPMColor* SK_RESTRICT cache,
+                                        int toggle, int count) {
+    Sk4i lanes((int32_t)(fx >> 1), (int32_t)((fx + dx) >> 1),
+               (int32_t)((fx + 2 * dx) >> 1), (int32_t)((fx + 3 * dx) >> 1));
+    const Sk4i step((int32_t)(2 * dx));
+    const Sk4i dither = lane_dither(toggle);
+    const Sk4i mask(0xFF);
+    for (int i = 0; i < count >> 2; i++) {
+        // Same as mirror_8bits(): flip the index when the bit above it is set.
+        store4(dstC, cache, (((lanes >> 23) ^ (lanes >> 31)) & mask) + dither);
+        lanes += step;
+        dstC += 4;
+    }
+    return fx + (count & ~3) * dx;
+}
+
 typedef void (*LinearShadeProc)(TileProc proc, SkGradFixed dx, SkGradFixed fx,
                                 SkPMColor* dstC, const SkPMColor* cache,
                                 int toggle, int count);
@@ -159,15 +217,9 @@ void shadeSpan_linear_clamp(TileProc proc, SkGradFixed dx, SkGradFixed fx,
         dstC += count;
     }
     if ((count = range.fCount1) > 0) {
-        int unroll = count >> 3;
-        fx = range.fFx1;
-        for (int i = 0; i < unroll; i++) {
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-            NO_CHECK_ITER;  NO_CHECK_ITER;
-        }
-        if ((count &= 7) > 0) {
+        fx = shade4_linear_repeat(range.fFx1, dx, dstC, cache, toggle, count);
+        dstC += count & ~3;
+        if ((count &= 3) > 0) {
             do {
                 NO_CHECK_ITER;
             } while (--count != 0);
@@ -185,6 +237,11 @@ void shadeSpan_linear_mirror(TileProc proc, SkGradFixed dx, SkGradFixed fx,
                              SkPMColor* SK_RESTRICT dstC,
                              const SkPMColor* SK_RESTRICT cache,
                              int toggle, int count) {
+    fx = shade4_linear_mirror(fx, dx, dstC, cache, toggle, count);
+    dstC += count & ~3;
+    if ((count &= 3) == 0) {
+        return;
+    }
     do {
         unsigned fi = mirror_8bits(SkGradFixedToFixed(fx) >> 8);
         SkASSERT(fi <= 0xFF);
@@ -198,6 +255,11 @@ void shadeSpan_linear_repeat(TileProc proc, SkGradFixed dx, SkGradFixed fx,
         SkPMColor* SK_RESTRICT dstC,
         const SkPMColor* SK_RESTRICT cache,
         int toggle, int count) {
+    fx = shade4_linear_repeat(fx, dx, dstC, cache, toggle, count);
+    dstC += count & ~3;
+    if ((count &= 3) == 0) {
+        return;
+    }
     do {
         unsigned fi = repeat_8bits(SkGradFixedToFixed(fx) >> 8);
         SkASSERT(fi <= 0xFF);
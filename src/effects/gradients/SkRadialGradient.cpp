@@ -8,6 +8,7 @@
 
 #include "SkRadialGradient.h"
 #include "SkRadialGradient_Table.h"
+#include "SkNx.h"
 
 #define kSQRT_TABLE_BITS    11
 #define kSQRT_TABLE_SIZE    (1 << kSQRT_TABLE_BITS)
@@ -373,14 +374,48 @@ void shadeSpan_radial_clamp(SkScalar sfx, SkScalar sdx,
     }
 }
 
-// Unrolling this loop doesn't seem to help (when float); we're stalling to
-// get the results of the sqrt (?), and don't have enough extra registers to
-// have many in flight.
-template <SkFixed (*TileProc)(SkFixed)>
+static inline Sk4i repeat_tileproc4(const Sk4i& x) {
+    return x & Sk4i(0xFFFF);
+}
+
+static inline Sk4i mirror_tileproc4(const Sk4i& x) {
+    return (x ^ ((x << 15) >> 31)) & Sk4i(0xFFFF);
+}
+
+// Steps four pixels at a time with Sk4f, then finishes the span one pixel at a time. Each lane
+// adds dx four times per step, in the same order as the one pixel loop, so the lanes see exactly
+// the fx and fy that it would.
+template <SkFixed (*TileProc)(SkFixed), Sk4i (*TileProc4)(const Sk4i&)>
 void shadeSpan_radial(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                       SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
                       int count, int toggle) {
-    do {
+    if (count >= 4) {
+        const SkScalar fx1 = fx + dx, fx2 = fx1 + dx,
+                       fy1 = fy + dy, fy2 = fy1 + dy;
+        Sk4f fx4(fx, fx1, fx2, fx2 + dx),
+             fy4(fy, fy1, fy2, fy2 + dy);
+        const Sk4f dx4(dx), dy4(dy), fixed1(SK_Fixed1);
+        const int other = next_dither_toggle(toggle);
+        const Sk4i dither(toggle, other, toggle, other);
+        do {
+            const Sk4f dist = (fx4 * fx4 + fy4 * fy4).sqrt() * fixed1;
+            const Sk4i fi = (TileProc4(dist.castTrunc()) >> SkGradientShaderBase::kCache32Shift)
+                          + dither;
+            int32_t i[4];
+            fi.store(i);
+            dstC[0] = cache[i[0]];
+            dstC[1] = cache[i[1]];
+            dstC[2] = cache[i[2]];
+            dstC[3] = cache[i[3]];
+            dstC += 4;
+            fx4 = fx4 + dx4 + dx4 + dx4 + dx4;
+            fy4 = fy4 + dy4 + dy4 + dy4 + dy4;
+            count -= 4;
+        } while (count >= 4);
+        fx = fx4[0];
+        fy = fy4[0];
+    }
+    while (count > 0) {
         const SkFixed dist = SkFloatToFixed(sk_float_sqrt(fx*fx + fy*fy));
         const unsigned fi = TileProc(dist);
         SkASSERT(fi <= 0xFFFF);
@@ -388,19 +423,22 @@ void shadeSpan_radial(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
         toggle = next_dither_toggle(toggle);
         fx += dx;
         fy += dy;
-    } while (--count != 0);
+        count -= 1;
+    }
 }
 
 void shadeSpan_radial_mirror(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                              SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
                              int count, int toggle) {
-    shadeSpan_radial<mirror_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle);
+    shadeSpan_radial<mirror_tileproc_nonstatic, mirror_tileproc4>(fx, dx, fy, dy, dstC, cache,
+                                                                 count, toggle);
 }
 
 void shadeSpan_radial_repeat(SkScalar fx, SkScalar dx, SkScalar fy, SkScalar dy,
                              SkPMColor* SK_RESTRICT dstC, const SkPMColor* SK_RESTRICT cache,
                              int count, int toggle) {
-    shadeSpan_radial<repeat_tileproc_nonstatic>(fx, dx, fy, dy, dstC, cache, count, toggle);
+    shadeSpan_radial<repeat_tileproc_nonstatic, repeat_tileproc4>(fx, dx, fy, dy, dstC, cache,
+                                                                 count, toggle);
 }
 
 }  // namespace
@@ -180,6 +180,19 @@ SkFontStyleSet* SkFontMgr_Indirect::onMatchFamily(const char familyName[]) const
     return SkNEW_ARGS(SkStyleSet_Indirect, (this, -1, fProxy->matchName(familyName)));
 }
 
+SkTypeface* SkFontMgr_Indirect::createTypefaceFromStream(SkStreamAsset* stream, uint32_t dataId,
+                                                         int ttcIndex) const {
+    SkAutoTUnref<SkTypeface> typeface(fImpl->createFromStream(stream, ttcIndex));
+    if (typeface.get() == NULL || fGlyphs.get() == NULL) {
+        return typeface.detach();
+    }
+    SkFontIdentity id;
+    id.fDataId = dataId;
+    id.fTtcIndex = ttcIndex;
+    id.fFontStyle = typeface->fontStyle();
+    return fGlyphs->createTypeface(typeface, id);
+}
+
 SkTypeface* SkFontMgr_Indirect::createTypefaceFromFontId(const SkFontIdentity& id) const {
     if (id.fDataId == SkFontIdentity::kInvalidDataId) {
         return NULL;
@@ -215,7 +228,8 @@ SkTypeface* SkFontMgr_Indirect::createTypefaceFromFontId(const SkFontIdentity& i
     if (dataTypeface.get() != NULL) {
         SkAutoTDelete<SkStreamAsset> stream(dataTypeface->openStream(NULL));
         if (stream.get() != NULL) {
-            return fImpl->createFromStream(stream.detach(), dataTypefaceIndex);
+            return this->createTypefaceFromStream(stream.detach(), id.fDataId,
+                                                  dataTypefaceIndex);
         }
     }
 
@@ -225,7 +239,8 @@ SkTypeface* SkFontMgr_Indirect::createTypefaceFromFontId(const SkFontIdentity& i
         return NULL;
     }
 
-    SkAutoTUnref<SkTypeface> typeface(fImpl->createFromStream(stream.detach(), id.fTtcIndex));
+    SkAutoTUnref<SkTypeface> typeface(this->createTypefaceFromStream(stream.detach(), id.fDataId,
+                                                                     id.fTtcIndex));
     if (typeface.get() == NULL) {
         return NULL;
     }
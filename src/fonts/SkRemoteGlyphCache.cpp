@@ -0,0 +1,547 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRemoteGlyphCache.h"
+#include "SkAtomics.h"
+#include "SkChecksum.h"
+#include "SkDescriptor.h"
+#include "SkGlyph.h"
+#include "SkGlyphCache.h"
+#include "SkPath.h"
+#include "SkStream.h"
+#include "SkTypeface.h"
+#include "SkTypefaceCache.h"
+
+static const uint32_t kMagic = SkSetFourByteTag('s', 'r', 'g', 'c');
+
+// Lives at the start of the memory, followed by fSlotCount slots, then the strikes and glyphs.
+// Each slot is 0 or the offset of a glyph's Entry; only the broker writes any of it.
+struct SkRemoteGlyphCache::Header {
+    uint32_t fMagic;
+    uint32_t fSize;
+    uint32_t fSlotCount;   // A power of 2.
+    uint32_t fUsed;        // Bytes from the start of the memory, only read by the broker.
+    uint32_t fEntryCount;  // Only read by the broker.
+    uint32_t fFull;        // Set once the broker can publish no more glyphs.
+};
+
+// What a strike is published as, and what names it in a request. The rec's font ID is 0: the
+// font is named by its SkFontIdentity instead.
+struct SkRemoteGlyphCache::StrikeKey {
+    uint32_t           fDataId;
+    uint32_t           fTtcIndex;
+    SkScalerContextRec fRec;
+};
+
+struct SkRemoteGlyphCache::GlyphKey {
+    uint32_t fGlyphID;
+    SkFixed  fSubX;
+    SkFixed  fSubY;
+
+    bool operator==(const GlyphKey& that) const {
+        return fGlyphID == that.fGlyphID && fSubX == that.fSubX && fSubY == that.fSubY;
+    }
+};
+
+struct SkRemoteGlyphCache::Request {
+    StrikeKey fStrike;
+    GlyphKey  fGlyph;
+};
+
+// A published glyph. Its image, if any, follows it.
+struct SkRemoteGlyphCache::Entry {
+    uint32_t fStrike;  // Offset of its StrikeKey.
+    GlyphKey fGlyph;
+    SkFixed  fAdvanceX, fAdvanceY;
+    uint16_t fWidth, fHeight;
+    int16_t  fTop, fLeft;
+    uint8_t  fMaskFormat;
+    int8_t   fRsbDelta, fLsbDelta;
+    int8_t   fForceBW;
+    uint32_t fImageSize;
+
+    const void* image() const { return this + 1; }
+};
+
+uint32_t* SkRemoteGlyphCache::Slots(uint8_t* memory) {
+    return reinterpret_cast<uint32_t*>(memory + sizeof(Header));
+}
+
+const uint32_t* SkRemoteGlyphCache::Slots(const uint8_t* memory) {
+    return reinterpret_cast<const uint32_t*>(memory + sizeof(Header));
+}
+
+// Most glyphs take a few hundred bytes; keep the table sparse even when the memory is full.
+static const size_t kBytesPerSlot = 128;
+
+bool SkRemoteGlyphCache::Init(void* memory, size_t memorySize) {
+    SkASSERT(SkIsAlign4(reinterpret_cast<uintptr_t>(memory)));
+    memorySize = SkTMin<size_t>(memorySize, SK_MaxS32) & ~3;
+    if (memorySize < 16 * kBytesPerSlot) {
+        return false;
+    }
+    uint32_t slotCount = 16;
+    while (slotCount * 2 * kBytesPerSlot <= memorySize) {
+        slotCount *= 2;
+    }
+
+    Header* header = static_cast<Header*>(memory);
+    header->fMagic = kMagic;
+    header->fSize = SkToU32(memorySize);
+    header->fSlotCount = slotCount;
+    header->fUsed = SkToU32(sizeof(Header) + slotCount * sizeof(uint32_t));
+    header->fEntryCount = 0;
+    header->fFull = 0;
+    sk_bzero(Slots(static_cast<uint8_t*>(memory)), slotCount * sizeof(uint32_t));
+    return true;
+}
+
+uint32_t SkRemoteGlyphCache::StrikeHash(const StrikeKey& key) {
+    return SkChecksum::Murmur3(&key, sizeof(key));
+}
+
+uint32_t SkRemoteGlyphCache::SlotHash(uint32_t strikeHash, const GlyphKey& key) {
+    return SkChecksum::Murmur3(&key, sizeof(key), strikeHash);
+}
+
+const SkRemoteGlyphCache::Entry* SkRemoteGlyphCache::Find(const uint8_t* memory,
+                                                          const Request& request,
+                                                          uint32_t strikeHash,
+                                                          uint32_t* strikeOffset) {
+    const Header* header = reinterpret_cast<const Header*>(memory);
+    const uint32_t* slot = Slots(memory);
+    const uint32_t mask = header->fSlotCount - 1;
+    uint32_t index = SlotHash(strikeHash, request.fGlyph) & mask;
+    for (uint32_t probe = 0; probe <= mask; ++probe) {
+        // Pairs with the broker's release store, so the entry is all there.
+        const uint32_t offset = sk_atomic_load(&slot[index], sk_memory_order_acquire);
+        if (0 == offset || offset > header->fSize - sizeof(Entry)) {
+            return NULL;
+        }
+        const Entry* entry = reinterpret_cast<const Entry*>(memory + offset);
+        if (entry->fImageSize > header->fSize - sizeof(Entry) - offset) {
+            return NULL;
+        }
+        if (entry->fGlyph == request.fGlyph) {
+            if (entry->fStrike == *strikeOffset) {
+                return entry;
+            }
+            if (0 == *strikeOffset && entry->fStrike <= header->fSize - sizeof(StrikeKey) &&
+                0 == memcmp(memory + entry->fStrike, &request.fStrike, sizeof(StrikeKey))) {
+                // The broker publishes each strike once, so this is the request's strike.
+                *strikeOffset = entry->fStrike;
+                return entry;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkRemoteGlyphCacheBroker::SkRemoteGlyphCacheBroker(void* memory, SkRemotableFontMgr* fonts,
+                                                   SkFontMgr* impl)
+    : fMemory(static_cast<uint8_t*>(memory))
+    , fFonts(SkRef(fonts))
+    , fImpl(impl ? SkRef(impl) : SkFontMgr::RefDefault()) {
+    SkASSERT(kMagic == reinterpret_cast<SkRemoteGlyphCache::Header*>(memory)->fMagic);
+}
+
+SkRemoteGlyphCacheBroker::~SkRemoteGlyphCacheBroker() {
+    for (int i = 0; i < fTypefaces.count(); ++i) {
+        SkSafeUnref(fTypefaces[i].fTypeface);
+    }
+}
+
+SkTypeface* SkRemoteGlyphCacheBroker::findTypeface(uint32_t dataId, uint32_t ttcIndex) {
+    for (int i = 0; i < fTypefaces.count(); ++i) {
+        if (fTypefaces[i].fDataId == dataId && fTypefaces[i].fTtcIndex == ttcIndex) {
+            return fTypefaces[i].fTypeface;
+        }
+    }
+    // Remember fonts that fail to load too, so each is only read once.
+    Font& font = fTypefaces.push_back();
+    font.fDataId = dataId;
+    font.fTtcIndex = ttcIndex;
+    font.fTypeface = NULL;
+    if (SkFontIdentity::kInvalidDataId != dataId && dataId <= SK_MaxS32 &&
+        ttcIndex <= SK_MaxS32) {
+        SkStreamAsset* stream = fFonts->getData(dataId);
+        if (stream) {
+            font.fTypeface = fImpl->createFromStream(stream, ttcIndex);
+        }
+    }
+    return font.fTypeface;
+}
+
+void* SkRemoteGlyphCacheBroker::alloc(size_t size, uint32_t* offset) {
+    SkRemoteGlyphCache::Header* header = reinterpret_cast<SkRemoteGlyphCache::Header*>(fMemory);
+    size = SkAlign4(size);
+    if (size > header->fSize - header->fUsed) {
+        return NULL;
+    }
+    *offset = header->fUsed;
+    header->fUsed += SkToU32(size);
+    return fMemory + *offset;
+}
+
+uint32_t SkRemoteGlyphCacheBroker::findOrAddStrike(const SkRemoteGlyphCache::StrikeKey& key,
+                                                   uint32_t hash) {
+    for (int i = 0; i < fStrikes.count(); ++i) {
+        if (fStrikes[i].fHash == hash && 0 == memcmp(fMemory + fStrikes[i].fOffset, &key,
+                                                     sizeof(key))) {
+            return fStrikes[i].fOffset;
+        }
+    }
+    uint32_t offset;
+    void* strike = this->alloc(sizeof(key), &offset);
+    if (NULL == strike) {
+        return 0;
+    }
+    memcpy(strike, &key, sizeof(key));
+    StrikeRef& ref = fStrikes.push_back();
+    ref.fHash = hash;
+    ref.fOffset = offset;
+    return offset;
+}
+
+bool SkRemoteGlyphCacheBroker::publish(const SkRemoteGlyphCache::Request& request,
+                                       uint32_t strikeHash) {
+    SkRemoteGlyphCache::Header* header = reinterpret_cast<SkRemoteGlyphCache::Header*>(fMemory);
+    SkTypeface* typeface = this->findTypeface(request.fStrike.fDataId,
+                                              request.fStrike.fTtcIndex);
+    if (NULL == typeface) {
+        return false;
+    }
+
+    const size_t descSize = SkDescriptor::ComputeOverhead(1) + sizeof(SkScalerContextRec);
+    SkAutoDescriptor ad(descSize);
+    SkDescriptor* desc = ad.getDesc();
+    desc->init();
+    SkScalerContextRec* rec = static_cast<SkScalerContextRec*>(
+            desc->addEntry(kRec_SkDescriptorTag, sizeof(SkScalerContextRec),
+                           &request.fStrike.fRec));
+    rec->fFontID = typeface->uniqueID();
+    desc->computeChecksum();
+
+    // Leave a quarter of the slots empty, so probes stay short.
+    bool published = false;
+    if (header->fEntryCount < header->fSlotCount - header->fSlotCount / 4) {
+        SkGlyphCache* cache = SkGlyphCache::DetachCache(typeface, desc);
+        const SkGlyph& glyph = cache->getGlyphIDMetrics(SkToU16(request.fGlyph.fGlyphID),
+                                                        request.fGlyph.fSubX,
+                                                        request.fGlyph.fSubY);
+        const void* image = (glyph.fWidth && glyph.fHeight) ? cache->findImage(glyph) : NULL;
+        const size_t imageSize = image ? glyph.computeImageSize() : 0;
+
+        uint32_t entryOffset;
+        const uint32_t strikeOffset = this->findOrAddStrike(request.fStrike, strikeHash);
+        SkRemoteGlyphCache::Entry* entry = strikeOffset ? static_cast<SkRemoteGlyphCache::Entry*>(
+                this->alloc(sizeof(SkRemoteGlyphCache::Entry) + imageSize, &entryOffset)) : NULL;
+        if (entry) {
+            entry->fStrike = strikeOffset;
+            entry->fGlyph = request.fGlyph;
+            entry->fAdvanceX = glyph.fAdvanceX;
+            entry->fAdvanceY = glyph.fAdvanceY;
+            entry->fWidth = glyph.fWidth;
+            entry->fHeight = glyph.fHeight;
+            entry->fTop = glyph.fTop;
+            entry->fLeft = glyph.fLeft;
+            entry->fMaskFormat = glyph.fMaskFormat;
+            entry->fRsbDelta = glyph.fRsbDelta;
+            entry->fLsbDelta = glyph.fLsbDelta;
+            entry->fForceBW = glyph.fForceBW;
+            entry->fImageSize = SkToU32(imageSize);
+            if (imageSize) {
+                memcpy(entry + 1, image, imageSize);
+            }
+
+            uint32_t* slot = SkRemoteGlyphCache::Slots(fMemory);
+            const uint32_t mask = header->fSlotCount - 1;
+            uint32_t index = SkRemoteGlyphCache::SlotHash(strikeHash, request.fGlyph) & mask;
+            while (slot[index]) {
+                index = (index + 1) & mask;
+            }
+            // Clients may be reading the table: publish the entry only once it is written.
+            sk_atomic_store(&slot[index], entryOffset, sk_memory_order_release);
+            header->fEntryCount++;
+            published = true;
+        }
+        SkGlyphCache::AttachCache(cache);
+    }
+    if (!published) {
+        sk_atomic_store(&header->fFull, 1u, sk_memory_order_relaxed);
+    }
+    return published;
+}
+
+bool SkRemoteGlyphCacheBroker::handleRequest(const void* data, size_t length) {
+    if (length != sizeof(SkRemoteGlyphCache::Request)) {
+        return false;
+    }
+    SkRemoteGlyphCache::Request request;
+    memcpy(&request, data, sizeof(request));
+
+    // Only ask the scaler for what a renderer's own SkPaint could have asked for.
+    const SkScalerContextRec& rec = request.fStrike.fRec;
+    const SkScalar scalars[] = {
+        rec.fTextSize, rec.fPreScaleX, rec.fPreSkewX,
+        rec.fPost2x2[0][0], rec.fPost2x2[0][1], rec.fPost2x2[1][0], rec.fPost2x2[1][1],
+        rec.fFrameWidth, rec.fMiterLimit,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(scalars); ++i) {
+        if (!SkScalarIsFinite(scalars[i])) {
+            return false;
+        }
+    }
+    if (0 != rec.fFontID || rec.fTextSize <= 0 || rec.fMaskFormat >= SkMask::kCountMaskFormats ||
+        request.fGlyph.fGlyphID > 0xFFFF) {
+        return false;
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    // Another renderer may have asked for it first.
+    const uint32_t strikeHash = SkRemoteGlyphCache::StrikeHash(request.fStrike);
+    uint32_t strikeOffset = 0;
+    if (SkRemoteGlyphCache::Find(fMemory, request, strikeHash, &strikeOffset)) {
+        return true;
+    }
+    return this->publish(request, strikeHash);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SkRemoteTypeface : public SkTypeface {
+public:
+    SkRemoteTypeface(SkTypeface* proxy, SkRemoteGlyphCacheClient* client,
+                     const SkFontIdentity& id)
+        : SkTypeface(proxy->fontStyle(), SkTypefaceCache::NewFontID(), proxy->isFixedPitch())
+        , fProxy(SkRef(proxy))
+        , fClient(SkRef(client))
+        , fId(id) {}
+
+    SkTypeface* proxy() const { return fProxy; }
+    SkRemoteGlyphCacheClient* client() const { return fClient; }
+    const SkFontIdentity& id() const { return fId; }
+
+protected:
+    SkScalerContext* onCreateScalerContext(const SkDescriptor*) const override;
+
+    void onFilterRec(SkScalerContextRec* rec) const override {
+        fProxy->filterRec(rec);
+    }
+
+    SkAdvancedTypefaceMetrics* onGetAdvancedTypefaceMetrics(
+            SkAdvancedTypefaceMetrics::PerGlyphInfo info,
+            const uint32_t* glyphIDs,
+            uint32_t glyphIDsCount) const override {
+        return fProxy->getAdvancedTypefaceMetrics(info, glyphIDs, glyphIDsCount);
+    }
+
+    SkStreamAsset* onOpenStream(int* ttcIndex) const override {
+        return fProxy->openStream(ttcIndex);
+    }
+
+    void onGetFontDescriptor(SkFontDescriptor* desc, bool* isLocal) const override {
+        fProxy->getFontDescriptor(desc, isLocal);
+    }
+
+    int onCharsToGlyphs(const void* chars, Encoding encoding,
+                        uint16_t glyphs[], int glyphCount) const override {
+        return fProxy->charsToGlyphs(chars, encoding, glyphs, glyphCount);
+    }
+
+    int onCountGlyphs() const override { return fProxy->countGlyphs(); }
+
+    int onGetUPEM() const override { return fProxy->getUnitsPerEm(); }
+
+    bool onGetKerningPairAdjustments(const uint16_t glyphs[], int count,
+                                     int32_t adjustments[]) const override {
+        return fProxy->getKerningPairAdjustments(glyphs, count, adjustments);
+    }
+
+    void onGetFamilyName(SkString* familyName) const override {
+        fProxy->getFamilyName(familyName);
+    }
+
+    SkTypeface::LocalizedStrings* onCreateFamilyNameIterator() const override {
+        return fProxy->createFamilyNameIterator();
+    }
+
+    int onGetTableTags(SkFontTableTag tags[]) const override {
+        return fProxy->getTableTags(tags);
+    }
+
+    size_t onGetTableData(SkFontTableTag tag, size_t offset,
+                          size_t length, void* data) const override {
+        return fProxy->getTableData(tag, offset, length, data);
+    }
+
+private:
+    SkAutoTUnref<SkTypeface> fProxy;
+    SkAutoTUnref<SkRemoteGlyphCacheClient> fClient;
+    SkFontIdentity fId;
+
+    typedef SkTypeface INHERITED;
+};
+
+// Gets glyphs from the broker when it can, and from a scaler context for the local copy of the
+// font when it cannot. Strikes are only single threaded, so neither needs a lock.
+class SkRemoteScalerContext : public SkScalerContext {
+public:
+    // The broker only sees the rec, so glyphs with effects, or stroked, are left to the local
+    // font. The base class would apply those on top of whatever the proxy returns.
+    static bool CanUseBroker(const SkDescriptor* desc) {
+        const size_t recOnlySize = SkDescriptor::ComputeOverhead(1) + sizeof(SkScalerContextRec);
+        const SkScalerContextRec* rec = static_cast<const SkScalerContextRec*>(
+                desc->findEntry(kRec_SkDescriptorTag, NULL));
+        return desc->getLength() == recOnlySize && rec && rec->fFrameWidth <= 0;
+    }
+
+    SkRemoteScalerContext(SkRemoteTypeface* face, const SkDescriptor* desc,
+                          SkScalerContext* proxy)
+        : SkScalerContext(face, desc)
+        , fClient(face->client())
+        , fProxy(proxy)
+        , fStrikeOffset(0) {
+        SkASSERT(CanUseBroker(desc));
+        fRequest.fStrike.fDataId = face->id().fDataId;
+        fRequest.fStrike.fTtcIndex = face->id().fTtcIndex;
+        fRequest.fStrike.fRec = fRec;
+        fRequest.fStrike.fRec.fFontID = 0;
+        fStrikeHash = SkRemoteGlyphCache::StrikeHash(fRequest.fStrike);
+    }
+
+    virtual ~SkRemoteScalerContext() {
+        SkDELETE(fProxy);
+    }
+
+protected:
+    unsigned generateGlyphCount() override {
+        return fProxy->getGlyphCount();
+    }
+
+    uint16_t generateCharToGlyph(SkUnichar uni) override {
+        return fProxy->charToGlyphID(uni);
+    }
+
+    void generateAdvance(SkGlyph* glyph) override {
+        // Only use what is already there; advances alone are not worth a round trip.
+        const SkRemoteGlyphCache::Entry* entry = this->find(*glyph);
+        if (entry) {
+            glyph->fAdvanceX = entry->fAdvanceX;
+            glyph->fAdvanceY = entry->fAdvanceY;
+        } else {
+            fProxy->getAdvance(glyph);
+        }
+    }
+
+    void generateMetrics(SkGlyph* glyph) override {
+        this->setGlyphKey(*glyph);
+        const SkRemoteGlyphCache::Entry* entry =
+                fClient->findOrRequest(fRequest, fStrikeHash, &fStrikeOffset);
+        if (entry) {
+            glyph->fAdvanceX = entry->fAdvanceX;
+            glyph->fAdvanceY = entry->fAdvanceY;
+            glyph->fWidth = entry->fWidth;
+            glyph->fHeight = entry->fHeight;
+            glyph->fTop = entry->fTop;
+            glyph->fLeft = entry->fLeft;
+            glyph->fMaskFormat = entry->fMaskFormat;
+            glyph->fRsbDelta = entry->fRsbDelta;
+            glyph->fLsbDelta = entry->fLsbDelta;
+            glyph->fForceBW = entry->fForceBW;
+        } else {
+            fProxy->getMetrics(glyph);
+        }
+    }
+
+    void generateImage(const SkGlyph& glyph) override {
+        const SkRemoteGlyphCache::Entry* entry = this->find(glyph);
+        if (entry && entry->fWidth == glyph.fWidth && entry->fHeight == glyph.fHeight &&
+            entry->fMaskFormat == glyph.fMaskFormat &&
+            entry->fImageSize == glyph.computeImageSize()) {
+            memcpy(glyph.fImage, entry->image(), entry->fImageSize);
+        } else {
+            fProxy->getImage(glyph);
+        }
+    }
+
+    void generatePath(const SkGlyph& glyph, SkPath* path) override {
+        fProxy->getPath(glyph, path);
+        // Both the proxy and the base class offset the path to the glyph's subpixel position.
+        if (this->isSubpixel()) {
+            path->offset(-SkFixedToScalar(glyph.getSubXFixed()),
+                         -SkFixedToScalar(glyph.getSubYFixed()));
+        }
+    }
+
+    void generateFontMetrics(SkPaint::FontMetrics* metrics) override {
+        fProxy->getFontMetrics(metrics);
+    }
+
+private:
+    void setGlyphKey(const SkGlyph& glyph) {
+        fRequest.fGlyph.fGlyphID = glyph.getGlyphID();
+        fRequest.fGlyph.fSubX = glyph.getSubXFixed();
+        fRequest.fGlyph.fSubY = glyph.getSubYFixed();
+    }
+
+    const SkRemoteGlyphCache::Entry* find(const SkGlyph& glyph) {
+        this->setGlyphKey(glyph);
+        return fClient->find(fRequest, fStrikeHash, &fStrikeOffset);
+    }
+
+    SkRemoteGlyphCacheClient* fClient;
+    SkScalerContext* fProxy;
+    SkRemoteGlyphCache::Request fRequest;
+    uint32_t fStrikeHash;
+    uint32_t fStrikeOffset;
+
+    typedef SkScalerContext INHERITED;
+};
+
+SkScalerContext* SkRemoteTypeface::onCreateScalerContext(const SkDescriptor* desc) const {
+    SkScalerContext* proxy = fProxy->createScalerContext(desc, true);
+    if (NULL == proxy || !SkRemoteScalerContext::CanUseBroker(desc)) {
+        return proxy;
+    }
+    return SkNEW_ARGS(SkRemoteScalerContext, (const_cast<SkRemoteTypeface*>(this), desc, proxy));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkRemoteGlyphCacheClient::SkRemoteGlyphCacheClient(const void* memory, Transport* transport)
+    : fMemory(static_cast<const uint8_t*>(memory))
+    , fTransport(transport) {
+    SkASSERT(kMagic == reinterpret_cast<const SkRemoteGlyphCache::Header*>(memory)->fMagic);
+}
+
+const SkRemoteGlyphCache::Entry* SkRemoteGlyphCacheClient::findOrRequest(
+        const SkRemoteGlyphCache::Request& request, uint32_t strikeHash,
+        uint32_t* strikeOffset) {
+    const SkRemoteGlyphCache::Entry* entry = this->find(request, strikeHash, strikeOffset);
+    if (entry) {
+        return entry;
+    }
+    const SkRemoteGlyphCache::Header* header =
+            reinterpret_cast<const SkRemoteGlyphCache::Header*>(fMemory);
+    if (sk_atomic_load(&header->fFull, sk_memory_order_relaxed)) {
+        return NULL;
+    }
+    fTransport->sendRequest(&request, sizeof(request));
+    return this->find(request, strikeHash, strikeOffset);
+}
+
+SkTypeface* SkRemoteGlyphCacheClient::createTypeface(SkTypeface* local,
+                                                     const SkFontIdentity& id) {
+    if (NULL == local) {
+        return NULL;
+    }
+    return SkNEW_ARGS(SkRemoteTypeface, (local, this, id));
+}
@@ -21,23 +21,52 @@
 #include "SkDistanceFieldGen.h"
 #include "SkRTConf.h"
 
-#define ATLAS_TEXTURE_WIDTH 1024
-#define ATLAS_TEXTURE_HEIGHT 2048
+// The atlas sizes may be overridden by the build. Each page is one texture of the given size;
+// the atlas adds pages, up to the maximum, before it evicts fields still waiting to be drawn.
+#ifndef GR_DF_PATH_ATLAS_TEXTURE_WIDTH
+#define GR_DF_PATH_ATLAS_TEXTURE_WIDTH  1024
+#endif
+#ifndef GR_DF_PATH_ATLAS_TEXTURE_HEIGHT
+#define GR_DF_PATH_ATLAS_TEXTURE_HEIGHT 2048
+#endif
+#ifndef GR_DF_PATH_ATLAS_MAX_PAGES
+#define GR_DF_PATH_ATLAS_MAX_PAGES      4
+#endif
+
 #define PLOT_WIDTH  256
 #define PLOT_HEIGHT 256
 
-#define NUM_PLOTS_X   (ATLAS_TEXTURE_WIDTH / PLOT_WIDTH)
-#define NUM_PLOTS_Y   (ATLAS_TEXTURE_HEIGHT / PLOT_HEIGHT)
+#define NUM_PLOTS_X   (GR_DF_PATH_ATLAS_TEXTURE_WIDTH / PLOT_WIDTH)
+#define NUM_PLOTS_Y   (GR_DF_PATH_ATLAS_TEXTURE_HEIGHT / PLOT_HEIGHT)
 
 #ifdef DF_PATH_TRACKING
 static int g_NumCachedPaths = 0;
 static int g_NumFreedPaths = 0;
 #endif
 
-// mip levels
-static const int kSmallMIP = 32;
-static const int kMediumMIP = 78;
-static const int kLargeMIP = 192;
+// Sizes the distance fields are generated at ("mip levels"), each at most a third larger than
+// the one before, so a path is never drawn far from the size its field was made for. The largest
+// must fit in a plot with its padding.
+static const uint32_t kMIPDimensions[] = { 32, 40, 48, 64, 80, 96, 128, 160, 192 };
+static const int kMIPCount = SK_ARRAY_COUNT(kMIPDimensions);
+
+// Paths drawn larger than this on the device go to other renderers
+static const SkScalar kMaxDeviceSize = 256.f;
+
+// A cached field one level down is reused for paths up to this much larger than it was made for,
+// so a path zooming back and forth across a level boundary isn't regenerated each time it
+// crosses.
+static const SkScalar kMaxMIPMagnification = 1.2f;
+
+// The level a path of the given device size is generated at
+static int mip_level(SkScalar size) {
+    for (int i = 0; i < kMIPCount - 1; ++i) {
+        if (size <= kMIPDimensions[i]) {
+            return i;
+        }
+    }
+    return kMIPCount - 1;
+}
 
 // Callback to clear out internal path cache when eviction occurs
 void GrAADistanceFieldPathRenderer::HandleEviction(GrBatchAtlas::AtlasID id, void* pr) {
@@ -101,12 +130,12 @@ bool GrAADistanceFieldPathRenderer::canDrawPath(const GrDrawTarget* target,
         return false;
     }
     
-    // only support paths smaller than 64x64, scaled to less than 256x256
+    // only support paths drawn smaller than 256x256, whatever their size before the view matrix
     // the goal is to accelerate rendering of lots of small paths that may be scaling
     SkScalar maxScale = viewMatrix.getMaxScale();
     const SkRect& bounds = path.getBounds();
     SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
-    return maxDim < 64.f && maxDim * maxScale < 256.f;
+    return maxDim > 0 && maxDim * maxScale < kMaxDeviceSize;
 }
 
 
@@ -179,17 +208,11 @@ public:
         uint32_t flags = 0;
         flags |= this->viewMatrix().isSimilarity() ? kSimilarity_DistanceFieldEffectFlag : 0;
 
-        GrTextureParams params(SkShader::kRepeat_TileMode, GrTextureParams::kBilerp_FilterMode);
-
-        // Setup GrGeometryProcessor
+        // Setup GrGeometryProcessor. We start on the first page, and switch pages (and so
+        // geometry processors) whenever a path's field is on another one.
         GrBatchAtlas* atlas = fAtlas;
-        SkAutoTUnref<GrGeometryProcessor> dfProcessor(
-                GrDistanceFieldNoGammaTextureEffect::Create(this->color(),
-                                                            this->viewMatrix(),
-                                                            atlas->getTexture(),
-                                                            params,
-                                                            flags,
-                                                            false));
+        int currentPage = 0;
+        SkAutoTUnref<const GrGeometryProcessor> dfProcessor(this->createGP(currentPage, flags));
 
         this->initDraw(batchTarget, dfProcessor, pipeline);
 
@@ -235,26 +258,21 @@ public:
             const SkRect& bounds = args.fPath.getBounds();
             SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
             SkScalar size = maxScale * maxDim;
-            uint32_t desiredDimension;
-            if (size <= kSmallMIP) {
-                desiredDimension = kSmallMIP;
-            } else if (size <= kMediumMIP) {
-                desiredDimension = kMediumMIP;
-            } else {
-                desiredDimension = kLargeMIP;
-            }
+            int level = mip_level(size);
+            uint32_t desiredDimension = kMIPDimensions[level];
 
-            // check to see if path is cached
+            // check to see if path is cached, at its level or one next to it
             // TODO: handle stroked vs. filled version of same path
-            PathData::Key key = { args.fPath.getGenerationID(), desiredDimension };
-            args.fPathData = fPathCache->find(key);
-            if (NULL == args.fPathData || !atlas->hasID(args.fPathData->fID)) {
-                // Remove the stale cache entry
-                if (args.fPathData) {
-                    fPathCache->remove(args.fPathData->fKey);
-                    fPathList->remove(args.fPathData);
-                    SkDELETE(args.fPathData);
-                }
+            uint32_t genID = args.fPath.getGenerationID();
+            args.fPathData = this->findPathData(genID, level);
+            if (NULL == args.fPathData && level + 1 < kMIPCount) {
+                args.fPathData = this->findPathData(genID, level + 1);
+            }
+            if (NULL == args.fPathData && level > 0 &&
+                size <= kMIPDimensions[level - 1] * kMaxMIPMagnification) {
+                args.fPathData = this->findPathData(genID, level - 1);
+            }
+            if (NULL == args.fPathData) {
                 SkScalar scale = desiredDimension/maxDim;
                 args.fPathData = SkNEW(PathData);
                 if (!this->addPathToAtlas(batchTarget,
@@ -275,6 +293,16 @@ public:
                 }
             }
 
+            // a field on another page has to go in a draw with that page's texture
+            int page = atlas->pageForID(args.fPathData->fID);
+            if (page != currentPage) {
+                this->flush(batchTarget, &drawInfo, instancesToFlush, maxInstancesPerDraw);
+                instancesToFlush = 0;
+                dfProcessor.reset(this->createGP(page, flags));
+                this->initDraw(batchTarget, dfProcessor, pipeline);
+                currentPage = page;
+            }
+
             atlas->setLastRefToken(args.fPathData->fID, batchTarget->currentToken());
 
             // Now set vertices
@@ -282,7 +310,7 @@ public:
             offset += i * GrBatchTarget::kVertsPerRect * vertexStride;
             SkPoint* positions = reinterpret_cast<SkPoint*>(offset);
             this->drawPath(batchTarget,
-                           atlas,
+                           atlas->getTexture(page),
                            pipeline,
                            dfProcessor,
                            positions,
@@ -313,6 +341,30 @@ private:
         fPathList = pathList;
     }
 
+    const GrGeometryProcessor* createGP(int page, uint32_t flags) {
+        GrTextureParams params(SkShader::kRepeat_TileMode, GrTextureParams::kBilerp_FilterMode);
+        return GrDistanceFieldNoGammaTextureEffect::Create(this->color(),
+                                                           this->viewMatrix(),
+                                                           fAtlas->getTexture(page),
+                                                           params,
+                                                           flags,
+                                                           false);
+    }
+
+    // Returns the path's field at the given level if it is cached and still in the atlas.
+    // Entries whose plot has gone are removed.
+    PathData* findPathData(uint32_t genID, int level) {
+        PathData::Key key = { genID, kMIPDimensions[level] };
+        PathData* pathData = fPathCache->find(key);
+        if (pathData && !fAtlas->hasID(pathData->fID)) {
+            fPathCache->remove(pathData->fKey);
+            fPathList->remove(pathData);
+            SkDELETE(pathData);
+            pathData = NULL;
+        }
+        return pathData;
+    }
+
     bool addPathToAtlas(GrBatchTarget* batchTarget,
                         const GrGeometryProcessor* dfProcessor,
                         const GrPipeline* pipeline,
@@ -459,7 +511,7 @@ private:
     }
 
     void drawPath(GrBatchTarget* target,
-                  GrBatchAtlas* atlas,
+                  GrTexture* texture,
                   const GrPipeline* pipeline,
                   const GrGeometryProcessor* gp,
                   SkPoint* positions,
@@ -467,8 +519,6 @@ private:
                   const SkMatrix& viewMatrix,
                   const SkPath& path,
                   const PathData* pathData) {
-        GrTexture* texture = atlas->getTexture();
-
         SkScalar dx = pathData->fBounds.fLeft;
         SkScalar dy = pathData->fBounds.fTop;
         SkScalar width = pathData->fBounds.width();
@@ -583,8 +633,8 @@ bool GrAADistanceFieldPathRenderer::onDrawPath(GrDrawTarget* target,
         // Create a new atlas
         GrSurfaceDesc desc;
         desc.fFlags = kNone_GrSurfaceFlags;
-        desc.fWidth = ATLAS_TEXTURE_WIDTH;
-        desc.fHeight = ATLAS_TEXTURE_HEIGHT;
+        desc.fWidth = GR_DF_PATH_ATLAS_TEXTURE_WIDTH;
+        desc.fHeight = GR_DF_PATH_ATLAS_TEXTURE_HEIGHT;
         desc.fConfig = kAlpha_8_GrPixelConfig;
 
         // We don't want to flush the context so we claim we're in the middle of flushing so as to
@@ -593,6 +643,7 @@ bool GrAADistanceFieldPathRenderer::onDrawPath(GrDrawTarget* target,
                                                          true);
         if (texture) {
             fAtlas = SkNEW_ARGS(GrBatchAtlas, (texture, NUM_PLOTS_X, NUM_PLOTS_Y));
+            fAtlas->setMaxPages(fContext, GR_DF_PATH_ATLAS_MAX_PAGES);
         } else {
             return false;
         }
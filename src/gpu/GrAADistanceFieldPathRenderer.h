@@ -48,7 +48,7 @@ private:
     struct PathData {
         struct Key {
             uint32_t   fGenID;
-            // rendered size for stored path (32x32 max, 64x64 max, 128x128 max)
+            // rendered size for stored path, one of the mip level dimensions (32x32 to 192x192)
             uint32_t   fDimension;
             bool operator==(const Key& other) const {
                 return other.fGenID == fGenID && other.fDimension == fDimension;
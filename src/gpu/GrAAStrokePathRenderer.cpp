@@ -0,0 +1,658 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrAAStrokePathRenderer.h"
+
+#include "GrBatch.h"
+#include "GrBatchTarget.h"
+#include "GrBufferAllocPool.h"
+#include "GrContext.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrPathUtils.h"
+#include "GrPipelineBuilder.h"
+#include "SkGeometry.h"
+#include "SkStrokeRec.h"
+#include "effects/GrPorterDuffXferProcessor.h"
+
+// Curves, round joins and round caps are flattened so that their chords stray at most this many
+// pixels from the curve
+static const SkScalar kTolerance = 0.25f;
+
+namespace {
+
+SkVector scaled(const SkVector& v, SkScalar scale) {
+    return SkVector::Make(v.fX * scale, v.fY * scale);
+}
+
+struct StrokeVertex {
+    SkPoint fPos;
+    float   fCoverage;
+};
+
+/**
+ * Turns device space polylines into triangles covering their stroke.  Every piece of the stroke
+ * is built from an inner outline, at full coverage, and when antialiasing an outer outline one
+ * pixel further out, at zero coverage.  The two outlines sit half a pixel either side of the
+ * stroke's true edge.
+ */
+class StrokeTessellator {
+public:
+    StrokeTessellator(SkScalar halfWidth, SkPaint::Join join, SkPaint::Cap cap,
+                      SkScalar miterLimit, bool antiAlias, SkTDArray<StrokeVertex>* vertices)
+        : fJoin(join)
+        , fCap(cap)
+        , fMiterLimit(miterLimit)
+        , fAntiAlias(antiAlias)
+        , fVertices(vertices) {
+        if (antiAlias) {
+            fInner = SkTMax(halfWidth - SK_ScalarHalf, 0.f);
+            fOuter = halfWidth + SK_ScalarHalf;
+        } else {
+            fInner = fOuter = halfWidth;
+        }
+        fHalfWidth = halfWidth;
+        if (SkPaint::kMiter_Join == fJoin && fMiterLimit <= SK_Scalar1) {
+            fJoin = SkPaint::kBevel_Join;
+        }
+    }
+
+    // Strokes one contour.  A contour that has segments but no length still gets round or square
+    // caps, like SkStroke gives it.
+    void strokeContour(const SkPoint* pts, int count, bool closed) {
+        fPts.rewind();
+        for (int i = 0; i < count; ++i) {
+            if (fPts.isEmpty() || !fPts.top().equalsWithinTolerance(pts[i])) {
+                *fPts.append() = pts[i];
+            }
+        }
+        if (closed && fPts.count() > 1 &&
+            fPts.top().equalsWithinTolerance(fPts[0])) {
+            fPts.pop();
+        }
+
+        fDirs.rewind();
+        if (1 == fPts.count()) {
+            if (count < 2 || SkPaint::kButt_Cap == fCap) {
+                return;
+            }
+            *fPts.append() = fPts[0];
+            fDirs.append()->set(SK_Scalar1, 0);
+            closed = false;
+        } else {
+            int segmentCount = closed ? fPts.count() : fPts.count() - 1;
+            for (int i = 0; i < segmentCount; ++i) {
+                SkVector* dir = fDirs.append();
+                *dir = fPts[(i + 1) % fPts.count()] - fPts[i];
+                dir->normalize();
+            }
+        }
+
+        int last = fPts.count() - 1;
+        SkScalar startOutset = 0;
+        SkScalar endOutset = 0;
+        if (!closed) {
+            // Square caps are butt caps on a longer line
+            if (SkPaint::kSquare_Cap == fCap) {
+                fPts[0] -= scaled(fDirs[0], fHalfWidth);
+                fPts[last] += scaled(fDirs.top(), fHalfWidth);
+            }
+            // Pull the ends of the line in so the end's coverage ramp straddles the true end
+            if (fAntiAlias && SkPaint::kRound_Cap != fCap) {
+                SkScalar firstLength = SkPoint::Distance(fPts[0], fPts[1]);
+                SkScalar lastLength = SkPoint::Distance(fPts[last - 1], fPts[last]);
+                startOutset = SkTMin(SK_ScalarHalf, SkScalarHalf(firstLength));
+                endOutset = SkTMin(SK_ScalarHalf, SkScalarHalf(lastLength));
+                fPts[0] += scaled(fDirs[0], startOutset);
+                fPts[last] -= scaled(fDirs.top(), endOutset);
+            }
+        }
+
+        for (int i = 0; i < fDirs.count(); ++i) {
+            this->segment(fPts[i], fPts[(i + 1) % fPts.count()], fDirs[i]);
+        }
+
+        if (closed) {
+            for (int i = 0; i < fPts.count(); ++i) {
+                int prev = (i + fDirs.count() - 1) % fDirs.count();
+                this->join(fPts[i], fDirs[prev], fDirs[i]);
+            }
+        } else {
+            for (int i = 1; i < last; ++i) {
+                this->join(fPts[i], fDirs[i - 1], fDirs[i]);
+            }
+            this->cap(fPts[0], -fDirs[0], startOutset);
+            this->cap(fPts[last], fDirs.top(), endOutset);
+        }
+    }
+
+private:
+    void vertex(const SkPoint& pos, float coverage) {
+        StrokeVertex* v = fVertices->append();
+        v->fPos = pos;
+        v->fCoverage = coverage;
+    }
+
+    void triangle(const SkPoint& a, const SkPoint& b, const SkPoint& c) {
+        this->vertex(a, 1.f);
+        this->vertex(b, 1.f);
+        this->vertex(c, 1.f);
+    }
+
+    // The coverage ramp between the inner edge i0-i1 and the outer edge o0-o1
+    void fringe(const SkPoint& i0, const SkPoint& i1, const SkPoint& o0, const SkPoint& o1) {
+        if (!fAntiAlias) {
+            return;
+        }
+        this->vertex(i0, 1.f);
+        this->vertex(o0, 0.f);
+        this->vertex(i1, 1.f);
+        this->vertex(i1, 1.f);
+        this->vertex(o0, 0.f);
+        this->vertex(o1, 0.f);
+    }
+
+    void segment(const SkPoint& p0, const SkPoint& p1, const SkVector& dir) {
+        SkVector normal = SkVector::Make(-dir.fY, dir.fX);
+        SkVector inner = scaled(normal, fInner);
+        SkVector outer = scaled(normal, fOuter);
+        this->triangle(p0 + inner, p1 + inner, p0 - inner);
+        this->triangle(p0 - inner, p1 + inner, p1 - inner);
+        this->fringe(p0 + inner, p1 + inner, p0 + outer, p1 + outer);
+        this->fringe(p0 - inner, p1 - inner, p0 - outer, p1 - outer);
+    }
+
+    // Fills the wedge around center swept by offsets, whose points on the inner and outer
+    // outlines are center + offset * fInner and center + offset * fOuter
+    void fan(const SkPoint& center, const SkVector* offsets, int count) {
+        for (int i = 0; i < count - 1; ++i) {
+            SkPoint i0 = center + scaled(offsets[i], fInner);
+            SkPoint i1 = center + scaled(offsets[i + 1], fInner);
+            this->triangle(center, i0, i1);
+            this->fringe(i0, i1,
+                         center + scaled(offsets[i], fOuter),
+                         center + scaled(offsets[i + 1], fOuter));
+        }
+    }
+
+    // Appends unit vectors from start, rotating through sweep radians
+    void arc(const SkVector& start, SkScalar sweep) {
+        SkScalar maxStep = SK_ScalarPI / 2;
+        if (fOuter > kTolerance) {
+            maxStep = SkTMin(maxStep, 2 * SkScalarACos(SK_Scalar1 - kTolerance / fOuter));
+        }
+        int steps = SkTMax(1, SkScalarCeilToInt(SkScalarAbs(sweep) / maxStep));
+        SkScalar step = sweep / steps;
+        SkScalar c = SkScalarCos(step);
+        SkScalar s = SkScalarSin(step);
+        SkVector v = start;
+        *fOffsets.append() = v;
+        for (int i = 0; i < steps; ++i) {
+            v.set(v.fX * c - v.fY * s, v.fX * s + v.fY * c);
+            *fOffsets.append() = v;
+        }
+    }
+
+    void join(const SkPoint& pt, const SkVector& before, const SkVector& after) {
+        SkScalar cross = before.cross(after);
+        SkScalar dot = before.dot(after);
+        if (SkScalarNearlyZero(cross) && dot > 0) {
+            return;
+        }
+        // The join fills the outside of the turn
+        SkScalar side = cross > 0 ? -SK_Scalar1 : SK_Scalar1;
+        SkVector a = SkVector::Make(-before.fY * side, before.fX * side);
+        SkVector b = SkVector::Make(-after.fY * side, after.fX * side);
+
+        fOffsets.rewind();
+        switch (fJoin) {
+            case SkPaint::kRound_Join:
+                this->arc(a, SkScalarATan2(a.cross(b), a.dot(b)));
+                break;
+            case SkPaint::kMiter_Join: {
+                *fOffsets.append() = a;
+                // Scaled so that it reaches both outlines' miter points
+                SkScalar abDot = a.dot(b);
+                if (abDot > -SK_Scalar1 + SK_ScalarNearlyZero) {
+                    SkVector miter = scaled(a + b, SkScalarInvert(SK_Scalar1 + abDot));
+                    if (miter.length() <= fMiterLimit) {
+                        *fOffsets.append() = miter;
+                    }
+                }
+                *fOffsets.append() = b;
+                break;
+            }
+            default:
+                *fOffsets.append() = a;
+                *fOffsets.append() = b;
+                break;
+        }
+        this->fan(pt, fOffsets.begin(), fOffsets.count());
+    }
+
+    // Caps the end of the line at pt, facing dir.  outset is how far pt was pulled back from the
+    // line's true end.
+    void cap(const SkPoint& pt, const SkVector& dir, SkScalar outset) {
+        SkVector normal = SkVector::Make(-dir.fY, dir.fX);
+        if (SkPaint::kRound_Cap == fCap) {
+            fOffsets.rewind();
+            this->arc(normal, -SK_ScalarPI);
+            this->fan(pt, fOffsets.begin(), fOffsets.count());
+            return;
+        }
+        if (!fAntiAlias) {
+            return;
+        }
+        // The coverage ramp across the end, and the corners between it and the sides' ramps
+        SkVector reach = scaled(dir, outset + SK_ScalarHalf);
+        SkPoint inner0 = pt + scaled(normal, fInner);
+        SkPoint inner1 = pt - scaled(normal, fInner);
+        SkPoint outer0 = pt + scaled(normal, fOuter);
+        SkPoint outer1 = pt - scaled(normal, fOuter);
+        this->fringe(inner0, inner0, outer0, outer0 + reach);
+        this->fringe(inner0, inner1, outer0 + reach, outer1 + reach);
+        this->fringe(inner1, inner1, outer1 + reach, outer1);
+    }
+
+    SkScalar                fHalfWidth;
+    SkScalar                fInner;
+    SkScalar                fOuter;
+    SkPaint::Join           fJoin;
+    SkPaint::Cap            fCap;
+    SkScalar                fMiterLimit;
+    bool                    fAntiAlias;
+    SkTDArray<StrokeVertex>* fVertices;
+    SkTDArray<SkPoint>      fPts;
+    SkTDArray<SkVector>     fDirs;
+    SkTDArray<SkVector>     fOffsets;
+};
+
+// Flattens the device space path into polylines and strokes each of them
+void tessellate_stroke(const SkPath& devPath, SkScalar devHalfWidth, const SkStrokeRec& stroke,
+                       bool antiAlias, SkTDArray<StrokeVertex>* vertices) {
+    StrokeTessellator tessellator(devHalfWidth, stroke.getJoin(), stroke.getCap(),
+                                  stroke.getMiter(), antiAlias, vertices);
+    const SkScalar tol = kTolerance;
+    const SkScalar tolSqd = SkScalarMul(tol, tol);
+
+    SkTDArray<SkPoint> contour;
+    SkPath::Iter iter(devPath, false);
+    SkPath::Verb verb;
+    SkPoint pts[4];
+    bool closed = false;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                if (contour.count()) {
+                    tessellator.strokeContour(contour.begin(), contour.count(), closed);
+                }
+                contour.rewind();
+                closed = false;
+                *contour.append() = pts[0];
+                break;
+            case SkPath::kLine_Verb:
+                *contour.append() = pts[1];
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads converter;
+                const SkPoint* quadPts = converter.computeQuads(pts, iter.conicWeight(), tol);
+                for (int i = 0; i < converter.countQuads(); ++i) {
+                    const SkPoint* quad = quadPts + i * 2;
+                    uint32_t maxPts = GrPathUtils::quadraticPointCount(quad, tol);
+                    SkPoint* vert = contour.append(maxPts);
+                    uint32_t n = GrPathUtils::generateQuadraticPoints(quad[0], quad[1], quad[2],
+                                                                      tolSqd, &vert, maxPts);
+                    contour.setCount(contour.count() - maxPts + n);
+                }
+                break;
+            }
+            case SkPath::kQuad_Verb: {
+                uint32_t maxPts = GrPathUtils::quadraticPointCount(pts, tol);
+                SkPoint* vert = contour.append(maxPts);
+                uint32_t n = GrPathUtils::generateQuadraticPoints(pts[0], pts[1], pts[2], tolSqd,
+                                                                  &vert, maxPts);
+                contour.setCount(contour.count() - maxPts + n);
+                break;
+            }
+            case SkPath::kCubic_Verb: {
+                uint32_t maxPts = GrPathUtils::cubicPointCount(pts, tol);
+                SkPoint* vert = contour.append(maxPts);
+                uint32_t n = GrPathUtils::generateCubicPoints(pts[0], pts[1], pts[2], pts[3],
+                                                              tolSqd, &vert, maxPts);
+                contour.setCount(contour.count() - maxPts + n);
+                break;
+            }
+            case SkPath::kClose_Verb:
+                closed = true;
+                break;
+            default:
+                break;
+        }
+    }
+    if (contour.count()) {
+        tessellator.strokeContour(contour.begin(), contour.count(), closed);
+    }
+}
+
+} // namespace
+
+static const GrGeometryProcessor* create_stroke_gp(bool antiAlias,
+                                                   bool tweakAlphaForCoverage,
+                                                   const SkMatrix& localMatrix) {
+    uint32_t flags = GrDefaultGeoProcFactory::kColor_GPType;
+    if (antiAlias && !tweakAlphaForCoverage) {
+        flags |= GrDefaultGeoProcFactory::kCoverage_GPType;
+    }
+    return GrDefaultGeoProcFactory::Create(flags, GrColor_WHITE, SkMatrix::I(), localMatrix,
+                                           false, 0xff);
+}
+
+class AAStrokePathBatch : public GrBatch {
+public:
+    struct Geometry {
+        GrColor fColor;
+        SkMatrix fViewMatrix;
+        SkPath fPath;
+        SkStrokeRec fStroke;
+        // Where this path's triangles start and end in fVertices once tessellated
+        int fFirstVertex;
+        int fVertexCount;
+
+        Geometry(const SkStrokeRec& stroke) : fStroke(stroke) {}
+    };
+
+    static GrBatch* Create(const Geometry& geometry, bool antiAlias) {
+        return SkNEW_ARGS(AAStrokePathBatch, (geometry, antiAlias));
+    }
+
+    const char* name() const override { return "AAStrokePathBatch"; }
+
+    void getInvariantOutputColor(GrInitInvariantOutput* out) const override {
+        // When this is called on a batch, there is only one geometry bundle
+        out->setKnownFourComponents(fGeoData[0].fColor);
+    }
+
+    void getInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        if (fBatch.fAntiAlias) {
+            out->setUnknownSingleComponent();
+        } else {
+            out->setKnownSingleComponent(0xff);
+        }
+    }
+
+    void initBatchTracker(const GrPipelineInfo& init) override {
+        // Handle any color overrides
+        if (init.fColorIgnored) {
+            fGeoData[0].fColor = GrColor_ILLEGAL;
+        } else if (GrColor_ILLEGAL != init.fOverrideColor) {
+            fGeoData[0].fColor = init.fOverrideColor;
+        }
+
+        // setup batch properties
+        fBatch.fColorIgnored = init.fColorIgnored;
+        fBatch.fColor = fGeoData[0].fColor;
+        fBatch.fUsesLocalCoords = init.fUsesLocalCoords;
+        fBatch.fCoverageIgnored = init.fCoverageIgnored;
+        fBatch.fCanTweakAlphaForCoverage = init.fCanTweakAlphaForCoverage;
+    }
+
+    // Tessellates every path's stroke into fVertices.  This is all CPU work on data no other
+    // batch touches.
+    void prepareGeometry() override {
+        if (fPrepared) {
+            return;
+        }
+        fPrepared = true;
+
+        for (int i = 0; i < fGeoData.count(); i++) {
+            Geometry& args = fGeoData[i];
+            args.fFirstVertex = fVertices.count();
+
+            SkPath devPath;
+            args.fPath.transform(args.fViewMatrix, &devPath);
+            SkScalar devHalfWidth = SkScalarHalf(args.fStroke.getWidth()) *
+                                    args.fViewMatrix.getMaxScale();
+            tessellate_stroke(devPath, devHalfWidth, args.fStroke, fBatch.fAntiAlias, &fVertices);
+
+            args.fVertexCount = fVertices.count() - args.fFirstVertex;
+        }
+    }
+
+    void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
+        this->prepareGeometry();
+        if (fVertices.isEmpty()) {
+            return;
+        }
+
+        bool canTweakAlphaForCoverage = this->canTweakAlphaForCoverage();
+
+        SkMatrix localMatrix;
+        if (this->usesLocalCoords() && !this->viewMatrix().invert(&localMatrix)) {
+            SkDebugf("Cannot invert\n");
+            return;
+        }
+
+        SkAutoTUnref<const GrGeometryProcessor> gp(create_stroke_gp(fBatch.fAntiAlias,
+                                                                    canTweakAlphaForCoverage,
+                                                                    localMatrix));
+
+        batchTarget->initDraw(gp, pipeline);
+
+        // TODO this is hacky, but the only way we have to initialize the GP is to use the
+        // GrPipelineInfo struct so we can generate the correct shader.  Once we have GrBatch
+        // everywhere we can remove this nastiness
+        GrPipelineInfo init;
+        init.fColorIgnored = fBatch.fColorIgnored;
+        init.fOverrideColor = GrColor_ILLEGAL;
+        init.fCoverageIgnored = fBatch.fCoverageIgnored;
+        init.fUsesLocalCoords = this->usesLocalCoords();
+        gp->initBatchTracker(batchTarget->currentBatchTracker(), init);
+
+        size_t vertexStride = gp->getVertexStride();
+        bool hasCoverage = fBatch.fAntiAlias && !canTweakAlphaForCoverage;
+        SkASSERT(hasCoverage ?
+                 vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr) :
+                 vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorAttr));
+
+        const GrVertexBuffer* vertexBuffer;
+        int firstVertex;
+        int vertexCount = fVertices.count();
+
+        void* vertices = batchTarget->vertexPool()->makeSpace(vertexStride,
+                                                              vertexCount,
+                                                              &vertexBuffer,
+                                                              &firstVertex);
+
+        if (!vertices) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+
+        static const int kColorOffset = sizeof(SkPoint);
+        static const int kCoverageOffset = sizeof(SkPoint) + sizeof(GrColor);
+        intptr_t verts = reinterpret_cast<intptr_t>(vertices);
+        for (int i = 0; i < fGeoData.count(); i++) {
+            const Geometry& args = fGeoData[i];
+            const StrokeVertex* src = fVertices.begin() + args.fFirstVertex;
+            for (int j = 0; j < args.fVertexCount; ++j) {
+                *reinterpret_cast<SkPoint*>(verts) = src[j].fPos;
+                GrColor* color = reinterpret_cast<GrColor*>(verts + kColorOffset);
+                if (hasCoverage) {
+                    *color = args.fColor;
+                    *reinterpret_cast<float*>(verts + kCoverageOffset) = src[j].fCoverage;
+                } else {
+                    // Coverage is only ever 0 or 1
+                    *color = src[j].fCoverage > 0 ? args.fColor : 0;
+                }
+                verts += vertexStride;
+            }
+        }
+
+        GrDrawTarget::DrawInfo drawInfo;
+        drawInfo.setPrimitiveType(kTriangles_GrPrimitiveType);
+        drawInfo.setVertexBuffer(vertexBuffer);
+        drawInfo.setStartVertex(firstVertex);
+        drawInfo.setVertexCount(vertexCount);
+        drawInfo.setStartIndex(0);
+        drawInfo.setIndexCount(0);
+        batchTarget->draw(drawInfo);
+    }
+
+    SkSTArray<1, Geometry, false>* geoData() { return &fGeoData; }
+
+private:
+    AAStrokePathBatch(const Geometry& geometry, bool antiAlias) : fPrepared(false) {
+        this->initClassID<AAStrokePathBatch>();
+        fGeoData.push_back(geometry);
+        fBatch.fAntiAlias = antiAlias;
+    }
+
+    GrColor color() const { return fBatch.fColor; }
+    bool usesLocalCoords() const { return fBatch.fUsesLocalCoords; }
+    bool canTweakAlphaForCoverage() const { return fBatch.fCanTweakAlphaForCoverage; }
+    const SkMatrix& viewMatrix() const { return fGeoData[0].fViewMatrix; }
+
+    bool onCombineIfPossible(GrBatch* t) override {
+        AAStrokePathBatch* that = t->cast<AAStrokePathBatch>();
+        SkASSERT(!fPrepared && !that->fPrepared);
+
+        if (fBatch.fAntiAlias != that->fBatch.fAntiAlias) {
+            return false;
+        }
+
+        // We apply the viewmatrix to the strokes on the cpu, so local coords only work if the
+        // matrices match
+        SkASSERT(this->usesLocalCoords() == that->usesLocalCoords());
+        if (this->usesLocalCoords() && !this->viewMatrix().cheapEqualTo(that->viewMatrix())) {
+            return false;
+        }
+
+        if (this->color() != that->color()) {
+            fBatch.fColor = GrColor_ILLEGAL;
+        }
+
+        // In the event of two batches, one who can tweak, one who cannot, we just fall back to
+        // not tweaking
+        if (this->canTweakAlphaForCoverage() != that->canTweakAlphaForCoverage()) {
+            fBatch.fCanTweakAlphaForCoverage = false;
+        }
+
+        fGeoData.push_back_n(that->geoData()->count(), that->geoData()->begin());
+        return true;
+    }
+
+    struct BatchTracker {
+        GrColor fColor;
+        bool fUsesLocalCoords;
+        bool fColorIgnored;
+        bool fCoverageIgnored;
+        bool fCanTweakAlphaForCoverage;
+        bool fAntiAlias;
+    };
+
+    BatchTracker fBatch;
+    SkSTArray<1, Geometry, false> fGeoData;
+    bool fPrepared;
+    SkTDArray<StrokeVertex> fVertices;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+GrAAStrokePathRenderer::GrAAStrokePathRenderer() {
+}
+
+GrPathRenderer::StencilSupport GrAAStrokePathRenderer::onGetStencilSupport(
+                                                            const GrDrawTarget*,
+                                                            const GrPipelineBuilder*,
+                                                            const SkPath&,
+                                                            const SkStrokeRec&) const {
+    return GrPathRenderer::kNoSupport_StencilSupport;
+}
+
+bool GrAAStrokePathRenderer::canDrawPath(const GrDrawTarget* target,
+                                         const GrPipelineBuilder* pipelineBuilder,
+                                         const SkMatrix& viewMatrix,
+                                         const SkPath& path,
+                                         const SkStrokeRec& stroke,
+                                         bool antiAlias) const {
+    // Hairlines and thin strokes are left to the hairline renderer.  The stroke is built in
+    // device space, so it has to be equally wide in every direction there.
+    if (SkStrokeRec::kStroke_Style != stroke.getStyle() ||
+        IsStrokeHairlineOrEquivalent(stroke, viewMatrix, NULL) ||
+        path.isInverseFillType() ||
+        !viewMatrix.isSimilarity()) {
+        return false;
+    }
+    // The coverage ramps need at least a pixel of width to fit inside
+    SkScalar devWidth = stroke.getWidth() * viewMatrix.getMaxScale();
+    return !antiAlias || devWidth >= SK_Scalar1;
+}
+
+// The pieces of the stroke overlap, so some pixels are drawn twice.  That only looks right when
+// drawing an opaque color again over itself changes nothing.
+static bool overlap_is_invisible(const GrPipelineBuilder* pipelineBuilder, GrColor color) {
+    if (!GrColorIsOpaque(color) || pipelineBuilder->numFragmentStages() > 0) {
+        return false;
+    }
+    SkAutoTUnref<GrXPFactory> srcOver(GrPorterDuffXPFactory::Create(SkXfermode::kSrcOver_Mode));
+    SkAutoTUnref<GrXPFactory> src(GrPorterDuffXPFactory::Create(SkXfermode::kSrc_Mode));
+    const GrXPFactory* xpFactory = pipelineBuilder->getXPFactory();
+    return xpFactory->isEqual(*srcOver) || xpFactory->isEqual(*src);
+}
+
+bool GrAAStrokePathRenderer::onDrawPath(GrDrawTarget* target,
+                                        GrPipelineBuilder* pipelineBuilder,
+                                        GrColor color,
+                                        const SkMatrix& viewMatrix,
+                                        const SkPath& path,
+                                        const SkStrokeRec& stroke,
+                                        bool antiAlias) {
+    if (path.isEmpty()) {
+        return true;
+    }
+
+    if (!overlap_is_invisible(pipelineBuilder, color)) {
+        // Expand the stroke on the CPU and let another renderer fill it
+        SkPath strokedPath;
+        if (!stroke.applyToPath(&strokedPath, path)) {
+            return false;
+        }
+        SkStrokeRec fill(SkStrokeRec::kFill_InitStyle);
+        GrPathRendererChain::DrawType type = antiAlias ?
+                GrPathRendererChain::kColorAntiAlias_DrawType :
+                GrPathRendererChain::kColor_DrawType;
+        GrContext* context = pipelineBuilder->getRenderTarget()->getContext();
+        GrPathRenderer* pr = context->getPathRenderer(target, pipelineBuilder, viewMatrix,
+                                                      strokedPath, fill, true, type);
+        if (NULL == pr) {
+            return false;
+        }
+        return pr->drawPath(target, pipelineBuilder, color, viewMatrix, strokedPath, fill,
+                            antiAlias);
+    }
+
+    AAStrokePathBatch::Geometry geometry(stroke);
+    geometry.fColor = color;
+    geometry.fViewMatrix = viewMatrix;
+    geometry.fPath = path;
+
+    SkAutoTUnref<GrBatch> batch(AAStrokePathBatch::Create(geometry, antiAlias));
+
+    // Miters reach furthest from the centerline, then square caps' corners
+    SkScalar outset = SkScalarHalf(stroke.getWidth());
+    if (SkPaint::kMiter_Join == stroke.getJoin()) {
+        outset *= SkTMax(stroke.getMiter(), SK_ScalarSqrt2);
+    } else if (SkPaint::kSquare_Cap == stroke.getCap()) {
+        outset *= SK_ScalarSqrt2;
+    }
+    SkRect devBounds = path.getBounds();
+    devBounds.outset(outset, outset);
+    viewMatrix.mapRect(&devBounds);
+    devBounds.outset(SK_Scalar1, SK_Scalar1);
+    target->drawBatch(pipelineBuilder, batch, &devBounds);
+
+    return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrAAStrokePathRenderer_DEFINED
+#define GrAAStrokePathRenderer_DEFINED
+
+#include "GrPathRenderer.h"
+
+/**
+ *  Subclass that draws wide strokes by tessellating them straight from the path's centerline,
+ *  rather than expanding them into a fill path with SkStroke first.  Each segment becomes a quad,
+ *  and joins and caps become fans around their point, all in device space with a one pixel
+ *  coverage ramp along the outside edges when antialiasing.  The pieces overlap where segments
+ *  meet, so this is only used when drawing a pixel twice looks the same as drawing it once.
+ */
+class GrAAStrokePathRenderer : public GrPathRenderer {
+public:
+    GrAAStrokePathRenderer();
+
+    bool canDrawPath(const GrDrawTarget*,
+                     const GrPipelineBuilder*,
+                     const SkMatrix& viewMatrix,
+                     const SkPath&,
+                     const SkStrokeRec&,
+                     bool antiAlias) const override;
+
+protected:
+    StencilSupport onGetStencilSupport(const GrDrawTarget*,
+                                       const GrPipelineBuilder*,
+                                       const SkPath&,
+                                       const SkStrokeRec&) const override;
+
+    bool onDrawPath(GrDrawTarget*,
+                    GrPipelineBuilder*,
+                    GrColor,
+                    const SkMatrix& viewMatrix,
+                    const SkPath&,
+                    const SkStrokeRec&,
+                    bool antiAlias) override;
+
+private:
+    typedef GrPathRenderer INHERITED;
+};
+
+#endif
@@ -9,8 +9,10 @@
 
 #include "GrStencilAndCoverPathRenderer.h"
 #include "GrAAHairLinePathRenderer.h"
+#include "GrAAStrokePathRenderer.h"
 #include "GrAAConvexPathRenderer.h"
 #include "GrAADistanceFieldPathRenderer.h"
+#include "GrCoverageCountingPathRenderer.h"
 #include "GrTessellatingPathRenderer.h"
 #if GR_STROKE_PATH_RENDERING
 #include "../../experimental/StrokePathRenderer/GrStrokePathRenderer.h"
@@ -39,6 +41,8 @@ void GrPathRenderer::AddPathRenderers(GrContext* ctx, GrPathRendererChain* chain
     if (GrPathRenderer* pr = GrAAHairLinePathRenderer::Create(ctx)) {
         chain->addPathRenderer(pr)->unref();
     }
+    chain->addPathRenderer(SkNEW(GrAAStrokePathRenderer))->unref();
     chain->addPathRenderer(SkNEW(GrAAConvexPathRenderer))->unref();
     chain->addPathRenderer(SkNEW_ARGS(GrAADistanceFieldPathRenderer, (ctx)))->unref();
+    chain->addPathRenderer(SkNEW_ARGS(GrCoverageCountingPathRenderer, (ctx)))->unref();
 }
@@ -130,9 +130,11 @@ public:
                                                        : GrPlotList::Iter::kHead_IterStart);
     }
 
-private:
+    // Move plot to the front of the LRU list, e.g. when a client reuses what it already holds.
     void makeMRU(GrPlot* plot);
 
+private:
+
     GrGpu*         fGpu;
     GrPixelConfig  fPixelConfig;
     GrSurfaceFlags fFlags;
@@ -744,16 +744,12 @@ public:
             return;
         }
 
-        GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
-        // This will be ignored in the non A8 case
-        bool opaqueVertexColors = GrColorIsOpaque(this->color());
-        SkAutoTUnref<const GrGeometryProcessor> gp(
-                GrBitmapTextGeoProc::Create(this->color(),
-                                            fFontCache->getTexture(fMaskFormat),
-                                            params,
-                                            fMaskFormat,
-                                            opaqueVertexColors,
-                                            localMatrix));
+        // Start on the page the first SubRun was last drawn from. We switch pages (and so
+        // geometry processors) whenever the glyphs move to another one.
+        const Geometry& first = fGeoData[0];
+        int firstPage = first.fBlob->fRuns[first.fRun].fSubRunInfo[first.fSubRun].fAtlasPage;
+        int currentPage = SkTMax(0, firstPage);
+        SkAutoTUnref<const GrGeometryProcessor> gp(this->createGP(currentPage, localMatrix));
 
         size_t vertexStride = gp->getVertexStride();
         SkASSERT(vertexStride == get_vertex_stride(fMaskFormat));
@@ -810,6 +806,12 @@ public:
             // or coords as needed.  One final note, if we have to break a run for an atlas eviction
             // then we can't really trust the atlas has all of the correct data.  Atlas evictions
             // should be pretty rare, so we just always regenerate in those cases
+            if (!regenerateTextureCoords && info.fAtlasPage != currentPage) {
+                this->switchPage(batchTarget, pipeline, &drawInfo, &instancesToFlush,
+                                 maxInstancesPerDraw, info.fAtlasPage, localMatrix, &gp);
+                currentPage = info.fAtlasPage;
+            }
+
             if (regenerateTextureCoords || regenerateColors) {
                 // first regenerate texture coordinates / colors if need be
                 const SkDescriptor* desc = NULL;
@@ -817,6 +819,7 @@ public:
                 GrFontScaler* scaler = NULL;
                 GrBatchTextStrike* strike = NULL;
                 bool brokenRun = false;
+                int runPage = kMixedAtlasPages;
                 if (regenerateTextureCoords) {
                     desc = run.fDescriptor.getDesc();
                     cache = SkGlyphCache::DetachCache(run.fTypeface, desc);
@@ -844,6 +847,19 @@ public:
                             SkASSERT(success);
                         }
 
+                        // a glyph on another page has to go in a draw with that page's texture
+                        int page = fFontCache->pageForGlyph(glyph);
+                        if (page != currentPage) {
+                            this->switchPage(batchTarget, pipeline, &drawInfo, &instancesToFlush,
+                                             maxInstancesPerDraw, page, localMatrix, &gp);
+                            currentPage = page;
+                        }
+                        if (0 == glyphIdx) {
+                            runPage = page;
+                        } else if (page != runPage) {
+                            runPage = kMixedAtlasPages;
+                        }
+
                         fFontCache->setGlyphRefToken(glyph, batchTarget->currentToken());
 
                         // Texture coords are the last vertex attribute so we get a pointer to the
@@ -868,8 +884,11 @@ public:
 
                 if (regenerateTextureCoords) {
                     SkGlyphCache::AttachCache(cache);
-                    info.fAtlasGeneration = brokenRun ? GrBatchAtlas::kInvalidAtlasGeneration :
-                                                        fFontCache->atlasGeneration(fMaskFormat);
+                    bool mixedPages = kMixedAtlasPages == runPage;
+                    info.fAtlasGeneration = brokenRun || mixedPages ?
+                                            GrBatchAtlas::kInvalidAtlasGeneration :
+                                            fFontCache->atlasGeneration(fMaskFormat);
+                    info.fAtlasPage = runPage;
                 }
             } else {
                 instancesToFlush += glyphCount;
@@ -939,6 +958,32 @@ private:
         }
     }
 
+    // A SubRun's fAtlasPage while its glyphs are on more than one page
+    static const int kMixedAtlasPages = -1;
+
+    const GrGeometryProcessor* createGP(int page, const SkMatrix& localMatrix) {
+        GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
+        // This will be ignored in the non A8 case
+        bool opaqueVertexColors = GrColorIsOpaque(this->color());
+        return GrBitmapTextGeoProc::Create(this->color(),
+                                           fFontCache->getTexture(fMaskFormat, page),
+                                           params,
+                                           fMaskFormat,
+                                           opaqueVertexColors,
+                                           localMatrix);
+    }
+
+    // Ends the current draw, and starts another reading the texture of the given page
+    void switchPage(GrBatchTarget* batchTarget, const GrPipeline* pipeline,
+                    GrDrawTarget::DrawInfo* drawInfo, int* instancesToFlush,
+                    int maxInstancesPerDraw, int page, const SkMatrix& localMatrix,
+                    SkAutoTUnref<const GrGeometryProcessor>* gp) {
+        this->flush(batchTarget, drawInfo, *instancesToFlush, maxInstancesPerDraw);
+        *instancesToFlush = 0;
+        gp->reset(this->createGP(page, localMatrix));
+        this->initDraw(batchTarget, *gp, pipeline);
+    }
+
     void initDraw(GrBatchTarget* batchTarget,
                   const GrGeometryProcessor* gp,
                   const GrPipeline* pipeline) {
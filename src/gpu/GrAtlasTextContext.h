@@ -12,7 +12,7 @@
 
 #include "GrGeometryProcessor.h"
 #include "SkDescriptor.h"
-#include "SkTHash.h"
+#include "SkTGroupHash.h"
 
 class GrBatchTextStrike;
 class GrPipelineBuilder;
@@ -82,12 +82,17 @@ private:
             struct SubRunInfo {
                 SubRunInfo()
                     : fAtlasGeneration(GrBatchAtlas::kInvalidAtlasGeneration)
+                    , fAtlasPage(0)
                     , fGlyphStartIndex(0)
                     , fGlyphEndIndex(0)
                     , fVertexStartIndex(0)
                     , fVertexEndIndex(0) {}
                 GrMaskFormat fMaskFormat;
                 uint64_t fAtlasGeneration;
+                // The atlas page (texture) holding all of the SubRun's glyphs, valid while
+                // fAtlasGeneration is.  SubRuns spread over several pages never keep a valid
+                // generation, so they are drawn a glyph at a time, switching textures as needed.
+                int fAtlasPage;
                 uint32_t fGlyphStartIndex;
                 uint32_t fGlyphEndIndex;
                 size_t fVertexStartIndex;
@@ -172,7 +177,7 @@ private:
 
     // TODO use real cache
     static void ClearCacheEntry(uint32_t key, BitmapTextBlob**);
-    SkTHashMap<uint32_t, BitmapTextBlob*, BitmapTextBlob::Hash> fCache;
+    SkTGroupHashMap<uint32_t, BitmapTextBlob*, BitmapTextBlob::Hash> fCache;
 
     friend class BitmapTextBatch;
 
@@ -66,6 +66,15 @@ public:
 
     virtual bool onCombineIfPossible(GrBatch*) = 0;
 
+    /*
+     * Called some time before generateGeometry(), possibly on another thread, and possibly while
+     * other batches are preparing their geometry too.  Batches that spend a lot of CPU time
+     * building their geometry (e.g. tessellating paths) can do that work here, leaving
+     * generateGeometry() to copy the result into the GrBatchTarget.  This must not touch the GPU,
+     * or anything shared with other batches.  generateGeometry() may also be called without it.
+     */
+    virtual void prepareGeometry() {}
+
     virtual void generateGeometry(GrBatchTarget*, const GrPipeline*) = 0;
 
     // TODO this goes away when batches are everywhere
@@ -7,6 +7,7 @@
 
 #include "GrBatchAtlas.h"
 #include "GrBatchTarget.h"
+#include "GrContext.h"
 #include "GrGpu.h"
 #include "GrRectanizer.h"
 #include "GrTracing.h"
@@ -223,7 +224,8 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY)
-    : fTexture(texture)
+    : fContext(NULL)
+    , fMaxPages(1)
     , fNumPlotsX(numPlotsX)
     , fNumPlotsY(numPlotsY)
     , fPlotWidth(texture->width() / numPlotsX)
@@ -237,29 +239,67 @@ GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY)
 
     // set up allocated plots
     fBPP = GrBytesPerPixel(texture->desc().fConfig);
-    fPlotArray = SkNEW_ARRAY(SkAutoTUnref<BatchPlot>, (fNumPlotsX * fNumPlotsY));
+    *fPages.append() = texture;
+    this->addPlots(texture);
+}
+
+GrBatchAtlas::~GrBatchAtlas() {
+    for (int i = 0; i < fPages.count(); ++i) {
+        SkSafeUnref(fPages[i]);
+    }
+    for (int i = 0; i < fPlotArray.count(); ++i) {
+        fPlotArray[i]->unref();
+    }
+
+#if ATLAS_STATS
+      SkDebugf("Num uploads: %d\n", g_UploadCount);
+#endif
+}
+
+void GrBatchAtlas::setMaxPages(GrContext* context, int maxPages) {
+    fContext = context;
+    fMaxPages = SkTMax(maxPages, fPages.count());
+}
+
+// Makes the plots for the last page, and puts them at the head of the LRU list
+void GrBatchAtlas::addPlots(GrTexture* texture) {
+    int firstIndex = (fPages.count() - 1) * this->plotsPerPage();
+    // the page's plots have to be distinguishable in an AtlasID
+    SkASSERT(firstIndex + this->plotsPerPage() <= (1 << 16));
 
-    SkAutoTUnref<BatchPlot>* currPlot = fPlotArray;
     for (int y = fNumPlotsY - 1, r = 0; y >= 0; --y, ++r) {
         for (int x = fNumPlotsX - 1, c = 0; x >= 0; --x, ++c) {
-            int id = r * fNumPlotsX + c;
-            currPlot->reset(SkNEW(BatchPlot));
-            (*currPlot)->init(this, texture, id, 1, x, y, fPlotWidth, fPlotHeight, fBPP);
+            int id = firstIndex + r * fNumPlotsX + c;
+            BatchPlot* plot = SkNEW(BatchPlot);
+            plot->init(this, texture, id, 1, x, y, fPlotWidth, fPlotHeight, fBPP);
+            SkASSERT(fPlotArray.count() == id);
+            *fPlotArray.append() = plot;
 
             // build LRU list
-            fPlotList.addToHead(currPlot->get());
-            ++currPlot;
+            fPlotList.addToHead(plot);
         }
     }
 }
 
-GrBatchAtlas::~GrBatchAtlas() {
-    SkSafeUnref(fTexture);
-    SkDELETE_ARRAY(fPlotArray);
+bool GrBatchAtlas::addPage() {
+    if (NULL == fContext || fPages.count() >= fMaxPages) {
+        return false;
+    }
 
-#if ATLAS_STATS
-      SkDebugf("Num uploads: %d\n", g_UploadCount);
-#endif
+    // Every page is the same size as the first, so texture coordinates mean the same on all of
+    // them.  As when the atlas was made, we claim we're flushing so we do not get a texture
+    // with pending IO.
+    GrSurfaceDesc desc = fPages[0]->desc();
+    desc.fFlags = kNone_GrSurfaceFlags;
+    GrTexture* texture = fContext->refScratchTexture(desc, GrContext::kExact_ScratchTexMatch,
+                                                     true);
+    if (!texture) {
+        return false;
+    }
+    *fPages.append() = texture;
+    this->addPlots(texture);
+    fStats.fPagesAdded++;
+    return true;
 }
 
 void GrBatchAtlas::processEviction(AtlasID id) {
@@ -294,7 +334,7 @@ inline void GrBatchAtlas::updatePlot(GrBatchTarget* batchTarget, AtlasID* id, Ba
 bool GrBatchAtlas::addToAtlas(AtlasID* id, GrBatchTarget* batchTarget,
                               int width, int height, const void* image, SkIPoint16* loc) {
     // We should already have a texture, TODO clean this up
-    SkASSERT(fTexture && width < fPlotWidth && height < fPlotHeight);
+    SkASSERT(fPages[0] && width < fPlotWidth && height < fPlotHeight);
 
     // now look through all allocated plots for one we can share, in Most Recently Refed order
     GrBatchPlotList::Iter plotIter;
@@ -320,6 +360,17 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrBatchTarget* batchTarget,
         SkASSERT(verify);
         this->updatePlot(batchTarget, id, plot);
         fAtlasGeneration++;
+        fStats.fEvictions++;
+        return true;
+    }
+
+    // Every plot is still waiting to be drawn.  Rather than evict any of them, grow into a new
+    // page if we may.  Nothing is removed, so the atlas generation stays the same.
+    if (this->addPage()) {
+        plot = fPlotList.head();
+        SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc, fBPP * width);
+        SkASSERT(verify);
+        this->updatePlot(batchTarget, id, plot);
         return true;
     }
 
@@ -330,11 +381,11 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrBatchTarget* batchTarget,
     // array.  If it is equal to the currentToken, then the caller has to flush draws to the batch
     // target so we can spin off the plot
     if (plot->lastRefToken() == batchTarget->currentToken()) {
+        fStats.fFlushes++;
         return false;
     }
 
-    // We take an extra ref here so our plot isn't deleted when we reset its index in the array.
-    plot->ref();
+    // The array's ref keeps our plot alive until we're done with it below.
     int index = plot->index();
     int x = plot->x();
     int y = plot->y();
@@ -342,11 +393,12 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrBatchTarget* batchTarget,
 
     this->processEviction(plot->id());
     fPlotList.remove(plot);
-    SkAutoTUnref<BatchPlot>& newPlot = fPlotArray[plot->index()];
-    newPlot.reset(SkNEW(BatchPlot));
-    newPlot->init(this, fTexture, index, ++generation, x, y, fPlotWidth, fPlotHeight, fBPP);
+    BatchPlot* newPlot = SkNEW(BatchPlot);
+    newPlot->init(this, plot->texture(), index, ++generation, x, y, fPlotWidth, fPlotHeight,
+                  fBPP);
+    fPlotArray[index] = newPlot;
 
-    fPlotList.addToHead(newPlot.get());
+    fPlotList.addToHead(newPlot);
     SkDEBUGCODE(bool verify = )newPlot->addSubImage(width, height, image, loc, fBPP * width);
     SkASSERT(verify);
     newPlot->setLastUploadToken(batchTarget->currentToken());
@@ -355,12 +407,13 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrBatchTarget* batchTarget,
     *id = newPlot->id();
     plot->unref();
     fAtlasGeneration++;
+    fStats.fEvictions++;
     return true;
 }
 
 bool GrBatchAtlas::hasID(AtlasID id) {
     int index = this->getIndexFromID(id);
-    SkASSERT(index < fNumPlotsX * fNumPlotsY);
+    SkASSERT(index < fPlotArray.count());
     return fPlotArray[index]->genID() == this->getGenerationFromID(id);
 }
 
@@ -15,6 +15,7 @@
 
 class BatchPlot;
 class GrBatchTarget;
+class GrContext;
 class GrRectanizer;
 
 typedef SkTInternalLList<BatchPlot> GrBatchPlotList;
@@ -36,6 +37,11 @@ public:
     GrBatchAtlas(GrTexture*, int numPlotsX, int numPlotsY);
     ~GrBatchAtlas();
 
+    // By default the atlas is the one texture it was created with.  This lets it add up to
+    // maxPages - 1 more textures (pages) like it, made with the context, before it has to evict
+    // plots that are still waiting to be drawn.
+    void setMaxPages(GrContext*, int maxPages);
+
     // Adds a width x height subimage to the atlas. Upon success it returns
     // the containing GrPlot and absolute location in the backing texture.
     // NULL is returned if the subimage cannot fit in the atlas.
@@ -43,7 +49,10 @@ public:
     bool addToAtlas(AtlasID*, GrBatchTarget*, int width, int height, const void* image,
                     SkIPoint16* loc);
 
-    GrTexture* getTexture() const { return fTexture; }
+    int numPages() const { return fPages.count(); }
+    GrTexture* getTexture(int page = 0) const { return fPages[page]; }
+    // The page (and so the texture) holding the data for an id
+    int pageForID(AtlasID id) const { return this->getIndexFromID(id) / this->plotsPerPage(); }
 
     uint64_t atlasGeneration() const { return fAtlasGeneration; }
     bool hasID(AtlasID id);
@@ -54,22 +63,40 @@ public:
         data->fData = userData;
     }
 
+    struct Stats {
+        Stats() : fPagesAdded(0), fEvictions(0), fFlushes(0) {}
+
+        int fPagesAdded;    // textures added since the atlas was created
+        int fEvictions;     // plots whose data was thrown away to make room
+        int fFlushes;       // adds that failed because every plot is used by the current draw,
+                            // so the caller had to flush before trying again
+    };
+    const Stats& stats() const { return fStats; }
+
 private:
-    int getIndexFromID(AtlasID id) {
+    int getIndexFromID(AtlasID id) const {
         return id & 0xffff;
     }
 
-    int getGenerationFromID(AtlasID id) {
+    int getGenerationFromID(AtlasID id) const {
         return (id >> 16) & 0xffff;
     }
 
+    int plotsPerPage() const { return fNumPlotsX * fNumPlotsY; }
+
+    void addPlots(GrTexture*);
+    bool addPage();
+
     inline void updatePlot(GrBatchTarget*, AtlasID*, BatchPlot*);
 
     inline void makeMRU(BatchPlot* plot);
 
     inline void processEviction(AtlasID);
 
-    GrTexture* fTexture;
+    // The first page is the texture the atlas was created with
+    SkTDArray<GrTexture*> fPages;
+    GrContext* fContext;
+    int fMaxPages;
     int fNumPlotsX;
     int fNumPlotsY;
     int fPlotWidth;
@@ -83,10 +110,11 @@ private:
     };
 
     SkTDArray<EvictionData> fEvictionCallbacks;
-    // allocated array of GrBatchPlots
-    SkAutoTUnref<BatchPlot>* fPlotArray;
-    // LRU list of GrPlots (MRU at head - LRU at tail)
+    // the GrBatchPlots of every page, page by page, each holding a ref
+    SkTDArray<BatchPlot*> fPlotArray;
+    // LRU list of GrPlots across all pages (MRU at head - LRU at tail)
     GrBatchPlotList fPlotList;
+    Stats fStats;
 };
 
 #endif
@@ -82,6 +82,7 @@ void GrBatchFontCache::init(GrContext* context) {
         }
 
         if (fAtlases[i]) {
+            fAtlases[i]->setMaxPages(context, GR_FONT_ATLAS_MAX_PAGES);
             fAtlases[i]->registerEvictionCallback(&GrBatchFontCache::HandleEviction, (void*)this);
         }
     }
@@ -146,10 +147,23 @@ uint64_t GrBatchFontCache::atlasGeneration(GrMaskFormat format) const {
     return this->getAtlas(format)->atlasGeneration();
 }
 
-GrTexture* GrBatchFontCache::getTexture(GrMaskFormat format) {
+GrTexture* GrBatchFontCache::getTexture(GrMaskFormat format, int page) {
     int atlasIndex = MaskFormatToAtlasIndex(format);
     SkASSERT(fAtlases[atlasIndex]);
-    return fAtlases[atlasIndex]->getTexture();
+    return fAtlases[atlasIndex]->getTexture(page);
+}
+
+int GrBatchFontCache::numPages(GrMaskFormat format) const {
+    return this->getAtlas(format)->numPages();
+}
+
+int GrBatchFontCache::pageForGlyph(GrGlyph* glyph) const {
+    SkASSERT(glyph);
+    return this->getAtlas(glyph->fMaskFormat)->pageForID(glyph->fID);
+}
+
+const GrBatchAtlas::Stats& GrBatchFontCache::atlasStats(GrMaskFormat format) const {
+    return this->getAtlas(format)->stats();
 }
 
 GrPixelConfig GrBatchFontCache::getPixelConfig(GrMaskFormat format) const {
@@ -180,19 +194,33 @@ void GrBatchFontCache::HandleEviction(GrBatchAtlas::AtlasID id, void* ptr) {
     }
 }
 
+size_t GrBatchFontCache::atlasBytes() const {
+    size_t bytes = 0;
+    for (int i = 0; i < kMaskFormatCount; ++i) {
+        if (fAtlases[i]) {
+            for (int page = 0; page < fAtlases[i]->numPages(); ++page) {
+                bytes += fAtlases[i]->getTexture(page)->gpuMemorySize();
+            }
+        }
+    }
+    return bytes;
+}
+
 void GrBatchFontCache::dump() const {
     static int gDumpCount = 0;
     for (int i = 0; i < kMaskFormatCount; ++i) {
         if (fAtlases[i]) {
-            GrTexture* texture = fAtlases[i]->getTexture();
-            if (texture) {
-                SkString filename;
+            for (int page = 0; page < fAtlases[i]->numPages(); ++page) {
+                GrTexture* texture = fAtlases[i]->getTexture(page);
+                if (texture) {
+                    SkString filename;
 #ifdef SK_BUILD_FOR_ANDROID
-                filename.printf("/sdcard/fontcache_%d%d.png", gDumpCount, i);
+                    filename.printf("/sdcard/fontcache_%d%d_%d.png", gDumpCount, i, page);
 #else
-                filename.printf("fontcache_%d%d.png", gDumpCount, i);
+                    filename.printf("fontcache_%d%d_%d.png", gDumpCount, i, page);
 #endif
-                texture->surfacePriv().savePixels(filename.c_str());
+                    texture->surfacePriv().savePixels(filename.c_str());
+                }
             }
         }
     }
@@ -228,7 +256,7 @@ GrBatchTextStrike::~GrBatchTextStrike() {
 GrGlyph* GrBatchTextStrike::generateGlyph(GrGlyph::PackedID packed,
                                           GrFontScaler* scaler) {
     SkIRect bounds;
-    if (GrGlyph::kDistance_MaskStyle == GrGlyph::UnpackMaskStyle(packed)) {
+    if (GrGlyph::IsDistanceField(packed)) {
         if (!scaler->getPackedGlyphDFBounds(packed, &bounds)) {
             return NULL;
         }
@@ -260,8 +288,7 @@ void GrBatchTextStrike::removeID(GrBatchAtlas::AtlasID id) {
 bool GrBatchTextStrike::glyphTooLargeForAtlas(GrGlyph* glyph) {
     int width = glyph->fBounds.width();
     int height = glyph->fBounds.height();
-    bool useDistanceField =
-            (GrGlyph::kDistance_MaskStyle == GrGlyph::UnpackMaskStyle(glyph->fPackedID));
+    bool useDistanceField = GrGlyph::IsDistanceField(glyph->fPackedID);
     int pad = useDistanceField ? 2 * SK_DistanceFieldPad : 0;
     int plotWidth = (kA8_GrMaskFormat == glyph->fMaskFormat) ? GR_FONT_ATLAS_A8_PLOT_WIDTH
                                                              : GR_FONT_ATLAS_PLOT_WIDTH;
@@ -289,7 +316,7 @@ bool GrBatchTextStrike::addGlyphToAtlas(GrBatchTarget* batchTarget, GrGlyph* gly
     size_t size = glyph->fBounds.area() * bytesPerPixel;
     GrAutoMalloc<1024> storage(size);
 
-    if (GrGlyph::kDistance_MaskStyle == GrGlyph::UnpackMaskStyle(glyph->fPackedID)) {
+    if (GrGlyph::IsDistanceField(glyph->fPackedID)) {
         if (!scaler->getPackedGlyphDFImage(glyph->fPackedID, glyph->width(),
                                            glyph->height(),
                                            storage.get())) {
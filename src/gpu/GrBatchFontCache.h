@@ -112,11 +112,22 @@ public:
 
     void freeAll();
 
-    GrTexture* getTexture(GrMaskFormat);
+    // Each atlas may grow to several textures (pages).  A glyph's texture coordinates are in the
+    // texture of its page.
+    GrTexture* getTexture(GrMaskFormat, int page = 0);
+    int numPages(GrMaskFormat) const;
+    int pageForGlyph(GrGlyph*) const;
     GrPixelConfig getPixelConfig(GrMaskFormat) const;
 
+    // Page growth, evictions and flushes forced by a full atlas, for the atlas of this format.
+    const GrBatchAtlas::Stats& atlasStats(GrMaskFormat) const;
+
     void dump() const;
 
+    int numStrikes() const { return fCache.count(); }
+    // The GPU memory of the atlases' textures, which also count in the GrResourceCache.
+    size_t atlasBytes() const;
+
 private:
     // There is a 1:1 mapping between GrMaskFormats and atlas indices
     static int MaskFormatToAtlasIndex(GrMaskFormat);
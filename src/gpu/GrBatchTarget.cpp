@@ -8,6 +8,7 @@
 #include "GrBatchTarget.h"
 
 #include "GrBatchAtlas.h"
+#include "GrGpuCommandBuffer.h"
 #include "GrPipeline.h"
 
 GrBatchTarget::GrBatchTarget(GrGpu* gpu,
@@ -24,7 +25,16 @@ GrBatchTarget::GrBatchTarget(GrGpu* gpu,
     , fInlineUpdatesIndex(0) {
 }
 
-void GrBatchTarget::flushNext(int n)  {
+void GrBatchTarget::preFlush(GrGpuCommandBuffer* commands) {
+    int updateCount = fAsapUploads.count();
+    for (int i = 0; i < updateCount; i++) {
+        commands->upload(fAsapUploads[i]);
+    }
+    fInlineUpdatesIndex = 0;
+    fIter = FlushBuffer::Iter(fFlushBuffer);
+}
+
+void GrBatchTarget::flushNext(int n, GrGpuCommandBuffer* commands)  {
     for (; n > 0; n--) {
         fLastFlushedToken++;
         SkDEBUGCODE(bool verify =) fIter.next();
@@ -36,20 +46,19 @@ void GrBatchTarget::flushNext(int n)  {
         int uploadCount = fInlineUploads.count();
         while (fInlineUpdatesIndex < uploadCount &&
                fInlineUploads[fInlineUpdatesIndex]->lastUploadToken() <= fLastFlushedToken) {
-            fInlineUploads[fInlineUpdatesIndex++]->upload(TextureUploader(fGpu));
+            commands->upload(fInlineUploads[fInlineUpdatesIndex++]);
         }
 
-        GrProgramDesc desc;
         const GrPipeline* pipeline = bf->fPipeline;
         const GrPrimitiveProcessor* primProc = bf->fPrimitiveProcessor.get();
-        fGpu->buildProgramDesc(&desc, *primProc, *pipeline, bf->fBatchTracker);
+        fGpu->buildProgramDesc(&bf->fDesc, *primProc, *pipeline, bf->fBatchTracker);
 
-        GrGpu::DrawArgs args(primProc, pipeline, &desc, &bf->fBatchTracker);
+        commands->bindProgram(primProc, pipeline, &bf->fDesc, &bf->fBatchTracker);
 
         int drawCount = bf->fDraws.count();
         const SkSTArray<1, DrawInfo, true>& draws = bf->fDraws;
         for (int i = 0; i < drawCount; i++) {
-            fGpu->draw(args, draws[i]);
+            commands->draw(draws[i]);
         }
     }
 }
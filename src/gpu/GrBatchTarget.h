@@ -20,6 +20,7 @@
  * that render their batch.
  */
 
+class GrGpuCommandBuffer;
 class GrIndexBufferAllocPool;
 class GrVertexBufferAllocPool;
 
@@ -94,15 +95,10 @@ public:
     // TODO much of this complexity goes away when batch is everywhere
     void resetNumberOfDraws() { fNumberOfDraws = 0; }
     int numberOfDraws() const { return fNumberOfDraws; }
-    void preFlush() {
-        int updateCount = fAsapUploads.count();
-        for (int i = 0; i < updateCount; i++) {
-            fAsapUploads[i]->upload(TextureUploader(fGpu));
-        }
-        fInlineUpdatesIndex = 0;
-        fIter = FlushBuffer::Iter(fFlushBuffer);
-    }
-    void flushNext(int n);
+    // Flushing records the uploads and draws into the command buffer, which must be submitted
+    // before postFlush().
+    void preFlush(GrGpuCommandBuffer*);
+    void flushNext(int n, GrGpuCommandBuffer*);
     void postFlush() {
         SkASSERT(!fIter.next());
         fFlushBuffer.reset();
@@ -119,6 +115,13 @@ public:
     const GrDrawTargetCaps& caps() const { return *fGpu->caps(); }
 
     GrVertexBufferAllocPool* vertexPool() { return fVertexPool; }
+
+    // Makes a static vertex buffer of size bytes for geometry a batch wants to keep beyond this
+    // flush, e.g. in the resource cache.  Unlike vertexPool() space, filling it is up to the
+    // caller.
+    GrVertexBuffer* createStaticVertexBuffer(size_t size) {
+        return fGpu->createVertexBuffer(size, false);
+    }
     GrIndexBufferAllocPool* indexPool() { return fIndexPool; }
 
     const static int kVertsPerRect = 4;
@@ -147,6 +150,7 @@ private:
         ProgramPrimitiveProcessor fPrimitiveProcessor;
         const GrPipeline* fPipeline;
         GrBatchTracker fBatchTracker;
+        GrProgramDesc fDesc;     // Built when the draws are flushed
         SkSTArray<1, DrawInfo, true> fDraws;
     };
 
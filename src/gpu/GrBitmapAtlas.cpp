@@ -0,0 +1,392 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrBitmapAtlas.h"
+
+#include "GrBatch.h"
+#include "GrBatchTarget.h"
+#include "GrBufferAllocPool.h"
+#include "GrContext.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrTemplates.h"
+
+#include "SkBitmap.h"
+
+#define ATLAS_TEXTURE_WIDTH 512
+#define ATLAS_TEXTURE_HEIGHT 512
+#define PLOT_WIDTH  128
+#define PLOT_HEIGHT 128
+
+#define NUM_PLOTS_X   (ATLAS_TEXTURE_WIDTH / PLOT_WIDTH)
+#define NUM_PLOTS_Y   (ATLAS_TEXTURE_HEIGHT / PLOT_HEIGHT)
+
+// Each bitmap is surrounded by a copy of its edge pixels
+static const int kBorder = 1;
+
+SK_COMPILE_ASSERT(GrBitmapAtlas::kMaxBitmapSize + 2 * kBorder <= PLOT_WIDTH &&
+                  GrBitmapAtlas::kMaxBitmapSize + 2 * kBorder <= PLOT_HEIGHT,
+                  atlased_bitmaps_must_fit_in_a_plot);
+
+// Callback to clear out the bitmap cache when eviction occurs
+void GrBitmapAtlas::HandleEviction(GrBatchAtlas::AtlasID id, void* ptr) {
+    GrBitmapAtlas* bitmapAtlas = (GrBitmapAtlas*)ptr;
+    // remove any bitmaps that use this plot
+    BitmapDataList::Iter iter;
+    iter.init(bitmapAtlas->fBitmapList, BitmapDataList::Iter::kHead_IterStart);
+    BitmapData* bitmapData;
+    while ((bitmapData = iter.get())) {
+        iter.next();
+        if (id == bitmapData->fID) {
+            bitmapAtlas->fBitmapCache.remove(bitmapData->fKey);
+            bitmapAtlas->fBitmapList.remove(bitmapData);
+            SkDELETE(bitmapData);
+        }
+    }
+}
+
+GrBitmapAtlas::GrBitmapAtlas(GrContext* context)
+    : fContext(context)
+    , fAtlas(NULL) {
+}
+
+GrBitmapAtlas::~GrBitmapAtlas() {
+    this->freeAll();
+}
+
+void GrBitmapAtlas::freeAll() {
+    BitmapDataList::Iter iter;
+    iter.init(fBitmapList, BitmapDataList::Iter::kHead_IterStart);
+    BitmapData* bitmapData;
+    while ((bitmapData = iter.get())) {
+        iter.next();
+        fBitmapList.remove(bitmapData);
+        SkDELETE(bitmapData);
+    }
+    fBitmapCache.rewind();
+
+    SkDELETE(fAtlas);
+    fAtlas = NULL;
+}
+
+bool GrBitmapAtlas::CanAtlas(const SkBitmap& bitmap) {
+    return !bitmap.getTexture() &&
+           !bitmap.isVolatile() &&
+           kN32_SkColorType == bitmap.colorType() &&
+           kUnpremul_SkAlphaType != bitmap.alphaType() &&
+           bitmap.width() > 0 && bitmap.width() <= kMaxBitmapSize &&
+           bitmap.height() > 0 && bitmap.height() <= kMaxBitmapSize;
+}
+
+GrTexture* GrBitmapAtlas::getTexture() {
+    if (!fAtlas) {
+        GrSurfaceDesc desc;
+        desc.fFlags = kNone_GrSurfaceFlags;
+        desc.fWidth = ATLAS_TEXTURE_WIDTH;
+        desc.fHeight = ATLAS_TEXTURE_HEIGHT;
+        desc.fConfig = kSkia8888_GrPixelConfig;
+
+        // We don't want to flush the context so we claim we're in the middle of flushing so as to
+        // guarantee we do not recieve a texture with pending IO
+        GrTexture* texture = fContext->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch,
+                                                         true);
+        if (!texture) {
+            return NULL;
+        }
+        fAtlas = SkNEW_ARGS(GrBatchAtlas, (texture, NUM_PLOTS_X, NUM_PLOTS_Y));
+        fAtlas->registerEvictionCallback(&GrBitmapAtlas::HandleEviction, (void*)this);
+    }
+    return fAtlas->getTexture();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+class AtlasedBitmapBatch : public GrBatch {
+public:
+    typedef GrBitmapAtlas::BitmapData BitmapData;
+
+    struct Geometry {
+        SkBitmap fBitmap;
+        SkRect fSrcRect;
+        SkMatrix fViewMatrix;
+        GrColor fColor;
+    };
+
+    static GrBatch* Create(const Geometry& geometry, GrBitmapAtlas* bitmapAtlas) {
+        return SkNEW_ARGS(AtlasedBitmapBatch, (geometry, bitmapAtlas));
+    }
+
+    const char* name() const override { return "AtlasedBitmapBatch"; }
+
+    void getInvariantOutputColor(GrInitInvariantOutput* out) const override {
+        // When this is called on a batch, there is only one geometry bundle
+        out->setKnownFourComponents(fGeoData[0].fColor);
+    }
+
+    void getInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        out->setKnownSingleComponent(0xff);
+    }
+
+    void initBatchTracker(const GrPipelineInfo& init) override {
+        // Handle any color overrides
+        if (init.fColorIgnored) {
+            fGeoData[0].fColor = GrColor_ILLEGAL;
+        } else if (GrColor_ILLEGAL != init.fOverrideColor) {
+            fGeoData[0].fColor = init.fOverrideColor;
+        }
+
+        // setup batch properties
+        fBatch.fColorIgnored = init.fColorIgnored;
+        fBatch.fColor = fGeoData[0].fColor;
+        fBatch.fUsesLocalCoords = init.fUsesLocalCoords;
+        fBatch.fCoverageIgnored = init.fCoverageIgnored;
+    }
+
+    void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
+        // Positions are mapped to device space and the atlas coords are explicit local coords,
+        // so bitmaps drawn with different matrices share one draw
+        uint32_t flags = GrDefaultGeoProcFactory::kPosition_GPType |
+                         GrDefaultGeoProcFactory::kColor_GPType |
+                         GrDefaultGeoProcFactory::kLocalCoord_GPType;
+        SkAutoTUnref<const GrGeometryProcessor> gp(
+                GrDefaultGeoProcFactory::Create(flags, this->color(), SkMatrix::I(),
+                                                SkMatrix::I(), GrColorIsOpaque(this->color())));
+
+        this->initDraw(batchTarget, gp, pipeline);
+
+        size_t vertexStride = gp->getVertexStride();
+        SkASSERT(vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorLocalCoordAttr));
+
+        int instanceCount = fGeoData.count();
+        int vertexCount = kVertsPerRect * instanceCount;
+
+        const GrVertexBuffer* vertexBuffer;
+        int firstVertex;
+
+        void* vertices = batchTarget->vertexPool()->makeSpace(vertexStride,
+                                                              vertexCount,
+                                                              &vertexBuffer,
+                                                              &firstVertex);
+
+        if (!vertices || !batchTarget->quadIndexBuffer()) {
+            SkDebugf("Could not allocate buffers\n");
+            return;
+        }
+
+        // We may have to flush while uploading bitmaps to the atlas, so we set up the draw here
+        const GrIndexBuffer* quadIndexBuffer = batchTarget->quadIndexBuffer();
+        int maxInstancesPerDraw = quadIndexBuffer->maxQuads();
+
+        GrDrawTarget::DrawInfo drawInfo;
+        drawInfo.setPrimitiveType(kTriangles_GrPrimitiveType);
+        drawInfo.setStartVertex(0);
+        drawInfo.setStartIndex(0);
+        drawInfo.setVerticesPerInstance(kVertsPerRect);
+        drawInfo.setIndicesPerInstance(kIndicesPerRect);
+        drawInfo.adjustStartVertex(firstVertex);
+        drawInfo.setVertexBuffer(vertexBuffer);
+        drawInfo.setIndexBuffer(quadIndexBuffer);
+
+        GrBatchAtlas* atlas = fBitmapAtlas->fAtlas;
+        GrTexture* texture = atlas->getTexture();
+
+        int instancesToFlush = 0;
+        for (int i = 0; i < instanceCount; i++) {
+            const Geometry& args = fGeoData[i];
+
+            const BitmapData* bitmapData = this->findOrAddBitmap(batchTarget, gp, pipeline,
+                                                                 &drawInfo, &instancesToFlush,
+                                                                 maxInstancesPerDraw,
+                                                                 args.fBitmap);
+            if (!bitmapData) {
+                SkDebugf("Could not add bitmap to atlas\n");
+                break;
+            }
+            atlas->setLastRefToken(bitmapData->fID, batchTarget->currentToken());
+
+            intptr_t offset = GrTCast<intptr_t>(vertices) + kVertsPerRect * i * vertexStride;
+            SkPoint* positions = GrTCast<SkPoint*>(offset);
+
+            positions->setRectFan(0, 0, args.fSrcRect.width(), args.fSrcRect.height(),
+                                  vertexStride);
+            args.fViewMatrix.mapPointsWithStride(positions, vertexStride, kVertsPerRect);
+
+            static const int kColorOffset = sizeof(SkPoint);
+            GrColor* vertColor = GrTCast<GrColor*>(offset + kColorOffset);
+            for (int j = 0; j < kVertsPerRect; ++j) {
+                *vertColor = args.fColor;
+                vertColor = (GrColor*) ((intptr_t) vertColor + vertexStride);
+            }
+
+            static const int kLocalOffset = sizeof(SkPoint) + sizeof(GrColor);
+            SkPoint* coords = GrTCast<SkPoint*>(offset + kLocalOffset);
+            SkScalar left = SkIntToScalar(bitmapData->fAtlasLocation.fX) + args.fSrcRect.fLeft;
+            SkScalar top = SkIntToScalar(bitmapData->fAtlasLocation.fY) + args.fSrcRect.fTop;
+            SkScalar wInv = SkScalarInvert(SkIntToScalar(texture->width()));
+            SkScalar hInv = SkScalarInvert(SkIntToScalar(texture->height()));
+            coords->setRectFan(left * wInv, top * hInv,
+                               (left + args.fSrcRect.width()) * wInv,
+                               (top + args.fSrcRect.height()) * hInv,
+                               vertexStride);
+            instancesToFlush++;
+        }
+
+        this->flush(batchTarget, &drawInfo, instancesToFlush, maxInstancesPerDraw);
+    }
+
+    SkSTArray<1, Geometry, false>* geoData() { return &fGeoData; }
+
+private:
+    AtlasedBitmapBatch(const Geometry& geometry, GrBitmapAtlas* bitmapAtlas)
+        : fBitmapAtlas(bitmapAtlas) {
+        this->initClassID<AtlasedBitmapBatch>();
+        fGeoData.push_back(geometry);
+    }
+
+    const BitmapData* findOrAddBitmap(GrBatchTarget* batchTarget,
+                                      const GrGeometryProcessor* gp,
+                                      const GrPipeline* pipeline,
+                                      GrDrawTarget::DrawInfo* drawInfo,
+                                      int* instancesToFlush,
+                                      int maxInstancesPerDraw,
+                                      const SkBitmap& bitmap) {
+        GrBatchAtlas* atlas = fBitmapAtlas->fAtlas;
+
+        SkIPoint origin = bitmap.pixelRefOrigin();
+        BitmapData::Key key = { bitmap.getGenerationID(), origin.fX, origin.fY,
+                                bitmap.width(), bitmap.height() };
+        BitmapData* bitmapData = fBitmapAtlas->fBitmapCache.find(key);
+        if (bitmapData && atlas->hasID(bitmapData->fID)) {
+            return bitmapData;
+        }
+        // Remove the stale cache entry
+        if (bitmapData) {
+            fBitmapAtlas->fBitmapCache.remove(bitmapData->fKey);
+            fBitmapAtlas->fBitmapList.remove(bitmapData);
+            SkDELETE(bitmapData);
+        }
+
+        SkAutoLockPixels alp(bitmap);
+        if (!bitmap.readyToDraw()) {
+            return NULL;
+        }
+
+        // Copy the pixels with their edges repeated into the border
+        int width = bitmap.width() + 2 * kBorder;
+        int height = bitmap.height() + 2 * kBorder;
+        SkAutoSTMalloc<(GrBitmapAtlas::kMaxBitmapSize + 2 * kBorder) * 4, uint32_t>
+                storage(width * height);
+        uint32_t* dst = storage.get();
+        for (int y = 0; y < height; ++y) {
+            int srcY = SkPin32(y - kBorder, 0, bitmap.height() - 1);
+            const uint32_t* src = bitmap.getAddr32(0, srcY);
+            dst[0] = src[0];
+            memcpy(dst + kBorder, src, bitmap.width() * sizeof(uint32_t));
+            dst[width - 1] = src[bitmap.width() - 1];
+            dst += width;
+        }
+
+        SkIPoint16 atlasLocation;
+        GrBatchAtlas::AtlasID id;
+        bool success = atlas->addToAtlas(&id, batchTarget, width, height, storage.get(),
+                                         &atlasLocation);
+        if (!success) {
+            // Every plot is used by this draw, so draw what we have and try again
+            this->flush(batchTarget, drawInfo, *instancesToFlush, maxInstancesPerDraw);
+            this->initDraw(batchTarget, gp, pipeline);
+            *instancesToFlush = 0;
+
+            success = atlas->addToAtlas(&id, batchTarget, width, height, storage.get(),
+                                        &atlasLocation);
+            if (!success) {
+                return NULL;
+            }
+        }
+
+        bitmapData = SkNEW(BitmapData);
+        bitmapData->fKey = key;
+        bitmapData->fID = id;
+        atlasLocation.fX += kBorder;
+        atlasLocation.fY += kBorder;
+        bitmapData->fAtlasLocation = atlasLocation;
+
+        fBitmapAtlas->fBitmapCache.add(bitmapData);
+        fBitmapAtlas->fBitmapList.addToTail(bitmapData);
+        return bitmapData;
+    }
+
+    void initDraw(GrBatchTarget* batchTarget,
+                  const GrGeometryProcessor* gp,
+                  const GrPipeline* pipeline) {
+        batchTarget->initDraw(gp, pipeline);
+
+        // TODO remove this when batch is everywhere
+        GrPipelineInfo init;
+        init.fColorIgnored = fBatch.fColorIgnored;
+        init.fOverrideColor = GrColor_ILLEGAL;
+        init.fCoverageIgnored = fBatch.fCoverageIgnored;
+        init.fUsesLocalCoords = this->usesLocalCoords();
+        gp->initBatchTracker(batchTarget->currentBatchTracker(), init);
+    }
+
+    void flush(GrBatchTarget* batchTarget,
+               GrDrawTarget::DrawInfo* drawInfo,
+               int instanceCount,
+               int maxInstancesPerDraw) {
+        while (instanceCount) {
+            drawInfo->setInstanceCount(SkTMin(instanceCount, maxInstancesPerDraw));
+            drawInfo->setVertexCount(drawInfo->instanceCount() * drawInfo->verticesPerInstance());
+            drawInfo->setIndexCount(drawInfo->instanceCount() * drawInfo->indicesPerInstance());
+
+            batchTarget->draw(*drawInfo);
+
+            drawInfo->setStartVertex(drawInfo->startVertex() + drawInfo->vertexCount());
+            instanceCount -= drawInfo->instanceCount();
+       }
+    }
+
+    GrColor color() const { return fBatch.fColor; }
+    bool usesLocalCoords() const { return fBatch.fUsesLocalCoords; }
+
+    bool onCombineIfPossible(GrBatch* t) override {
+        AtlasedBitmapBatch* that = t->cast<AtlasedBitmapBatch>();
+
+        // Positions are in device space and every bitmap samples the same atlas, so any two
+        // batches drawn with the same pipeline can be drawn together
+        if (this->color() != that->color()) {
+            fBatch.fColor = GrColor_ILLEGAL;
+        }
+        fGeoData.push_back_n(that->geoData()->count(), that->geoData()->begin());
+        return true;
+    }
+
+    struct BatchTracker {
+        GrColor fColor;
+        bool fUsesLocalCoords;
+        bool fColorIgnored;
+        bool fCoverageIgnored;
+    };
+
+    const static int kVertsPerRect = 4;
+    const static int kIndicesPerRect = 6;
+
+    BatchTracker fBatch;
+    SkSTArray<1, Geometry, false> fGeoData;
+    GrBitmapAtlas* fBitmapAtlas;
+};
+
+GrBatch* GrBitmapAtlas::createBatch(const SkBitmap& bitmap, const SkRect& srcRect,
+                                    const SkMatrix& viewMatrix, GrColor color) {
+    SkASSERT(CanAtlas(bitmap));
+    SkASSERT(fAtlas);
+
+    AtlasedBitmapBatch::Geometry geometry;
+    geometry.fBitmap = bitmap;
+    geometry.fSrcRect = srcRect;
+    geometry.fViewMatrix = viewMatrix;
+    geometry.fColor = color;
+    return AtlasedBitmapBatch::Create(geometry, this);
+}
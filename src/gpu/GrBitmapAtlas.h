@@ -0,0 +1,95 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrBitmapAtlas_DEFINED
+#define GrBitmapAtlas_DEFINED
+
+#include "GrBatchAtlas.h"
+#include "GrColor.h"
+#include "SkChecksum.h"
+#include "SkTDynamicHash.h"
+#include "SkTInternalLList.h"
+
+class GrBatch;
+class GrContext;
+class GrTexture;
+class SkBitmap;
+class SkMatrix;
+struct SkRect;
+
+/**
+ * GrBitmapAtlas packs small raster bitmaps (icons and the like) into one shared texture so that
+ * draws of different bitmaps can be combined into a single draw call, instead of each bitmap
+ * getting its own texture through GrRefCachedBitmapTexture.  Bitmaps are uploaded lazily, when
+ * the batches that draw them generate their geometry, and are keyed by their pixel ref's
+ * generation ID and subset.  Each bitmap is stored with a one pixel border that repeats its edge
+ * pixels, so filtering at the bitmap's edges matches the clamp tiling of an unatlased draw.
+ */
+class GrBitmapAtlas {
+public:
+    GrBitmapAtlas(GrContext*);
+    ~GrBitmapAtlas();
+
+    // Bitmaps at most this size in both dimensions may be atlased
+    static const int kMaxBitmapSize = 64;
+
+    // Returns true if the bitmap is small enough and has a pixel format that can live in the atlas
+    static bool CanAtlas(const SkBitmap&);
+
+    // The texture atlased bitmaps are drawn from. It is created on first use and is NULL if it
+    // could not be created.
+    GrTexture* getTexture();
+
+    // Creates a batch which draws srcRect of the bitmap with the rect's top left corner at the
+    // origin, mapped by the viewMatrix.  The pipeline the batch is drawn with must sample
+    // getTexture() with its local coords.
+    GrBatch* createBatch(const SkBitmap&, const SkRect& srcRect, const SkMatrix& viewMatrix,
+                         GrColor);
+
+    // Drops every atlased bitmap and the texture they live in
+    void freeAll();
+
+private:
+    struct BitmapData {
+        struct Key {
+            uint32_t fGenID;
+            int32_t  fOriginX;
+            int32_t  fOriginY;
+            int32_t  fWidth;
+            int32_t  fHeight;
+            bool operator==(const Key& other) const {
+                return 0 == memcmp(this, &other, sizeof(Key));
+            }
+        };
+        Key                   fKey;
+        GrBatchAtlas::AtlasID fID;
+        // The top left of the bitmap in the atlas, inside its border
+        SkIPoint16            fAtlasLocation;
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(BitmapData);
+
+        static inline const Key& GetKey(const BitmapData& data) {
+            return data.fKey;
+        }
+
+        static inline uint32_t Hash(Key key) {
+            return SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(&key), sizeof(key));
+        }
+    };
+
+    static void HandleEviction(GrBatchAtlas::AtlasID, void*);
+
+    typedef SkTInternalLList<BitmapData> BitmapDataList;
+
+    GrContext*                                  fContext;
+    GrBatchAtlas*                               fAtlas;
+    SkTDynamicHash<BitmapData, BitmapData::Key> fBitmapCache;
+    BitmapDataList                              fBitmapList;
+
+    friend class AtlasedBitmapBatch;
+};
+
+#endif
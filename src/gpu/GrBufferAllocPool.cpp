@@ -49,6 +49,7 @@ GrBufferAllocPool::GrBufferAllocPool(GrGpu* gpu,
 
     fBufferType = bufferType;
     fFrequentResetHint = frequentResetHint;
+    fPersistent = SkToBool(GrDrawTargetCaps::kPersistent_MapFlag & gpu->caps()->mapBufferFlags());
     fBufferPtr = NULL;
     fMinBlockSize = SkTMax(GrBufferAllocPool_MIN_BLOCK_SIZE, blockSize);
 
@@ -62,6 +63,10 @@ GrBufferAllocPool::GrBufferAllocPool(GrGpu* gpu,
             *fPreallocBuffers.append() = buffer;
         }
     }
+    if (fPersistent) {
+        fPreallocFences.setCount(fPreallocBuffers.count());
+        sk_bzero(fPreallocFences.begin(), fPreallocFences.count() * sizeof(GrFence));
+    }
 }
 
 GrBufferAllocPool::~GrBufferAllocPool() {
@@ -75,6 +80,11 @@ GrBufferAllocPool::~GrBufferAllocPool() {
     while (!fBlocks.empty()) {
         destroyBlock();
     }
+    for (int i = 0; i < fPreallocFences.count(); ++i) {
+        if (fPreallocFences[i]) {
+            fGpu->deleteFence(fPreallocFences[i]);
+        }
+    }
     fPreallocBuffers.unrefAll();
     releaseGpuRef();
 }
@@ -97,6 +107,15 @@ void GrBufferAllocPool::reset() {
     }
     // fPreallocBuffersInUse will be decremented down to zero in the while loop
     int preallocBuffersInUse = fPreallocBuffersInUse;
+    if (fPersistent) {
+        // The draws reading these buffers have been issued; don't write them again until the
+        // GPU is past those draws.
+        for (int i = 0; i < preallocBuffersInUse; ++i) {
+            int index = (fPreallocBufferStartIdx + i) % fPreallocBuffers.count();
+            SkASSERT(0 == fPreallocFences[index]);
+            fPreallocFences[index] = fGpu->insertFence();
+        }
+    }
     while (!fBlocks.empty()) {
         this->destroyBlock();
     }
@@ -286,7 +305,9 @@ bool GrBufferAllocPool::createBlock(size_t requestSize) {
     BufferBlock& block = fBlocks.push_back();
 
     if (size == fMinBlockSize &&
-        fPreallocBuffersInUse < fPreallocBuffers.count()) {
+        fPreallocBuffersInUse < fPreallocBuffers.count() &&
+        this->reclaimPreallocBuffer((fPreallocBuffersInUse + fPreallocBufferStartIdx) %
+                                    fPreallocBuffers.count())) {
 
         uint32_t nextBuffer = (fPreallocBuffersInUse +
                                fPreallocBufferStartIdx) %
@@ -316,12 +337,12 @@ bool GrBufferAllocPool::createBlock(size_t requestSize) {
 
     SkASSERT(NULL == fBufferPtr);
 
-    // If the buffer is CPU-backed we map it because it is free to do so and saves a copy.
-    // Otherwise when buffer mapping is supported:
+    // If the buffer is CPU-backed or persistently mapped we map it because it is free to do so
+    // and saves a copy. Otherwise when buffer mapping is supported:
     //      a) If the frequently reset hint is set we only map when the requested size meets a
     //      threshold (since we don't expect it is likely that we will see more vertex data)
     //      b) If the hint is not set we map if the buffer size is greater than the threshold.
-    bool attemptMap = block.fBuffer->isCPUBacked();
+    bool attemptMap = block.fBuffer->isCPUBacked() || fPersistent;
     if (!attemptMap && GrDrawTargetCaps::kNone_MapFlags != fGpu->caps()->mapBufferFlags()) {
         if (fFrequentResetHint) {
             attemptMap = requestSize > GR_GEOM_BUFFER_MAP_THRESHOLD;
@@ -362,6 +383,22 @@ void GrBufferAllocPool::destroyBlock() {
     fBufferPtr = NULL;
 }
 
+bool GrBufferAllocPool::reclaimPreallocBuffer(int index) {
+    if (!fPersistent) {
+        return true;
+    }
+    GrFence& fence = fPreallocFences[index];
+    if (fence) {
+        // Don't stall on the GPU; the caller makes a new buffer if this one is still busy.
+        if (!fGpu->waitFence(fence, 0)) {
+            return false;
+        }
+        fGpu->deleteFence(fence);
+        fence = 0;
+    }
+    return true;
+}
+
 void GrBufferAllocPool::flushCpuData(const BufferBlock& block, size_t flushSize) {
     GrGeometryBuffer* buffer = block.fBuffer;
     SkASSERT(buffer);
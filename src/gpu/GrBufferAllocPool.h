@@ -8,6 +8,7 @@
 #ifndef GrBufferAllocPool_DEFINED
 #define GrBufferAllocPool_DEFINED
 
+#include "GrTypes.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTypes.h"
@@ -26,6 +27,12 @@ class GrGpu;
  * At creation time a minimum per-buffer size can be specified. Additionally,
  * a number of buffers to preallocate can be specified. These will
  * be allocated at the min size and kept around until the pool is destroyed.
+ *
+ * When the GrGpu supports persistently mapped buffers (kPersistent_MapFlag) the
+ * preallocated buffers form a ring: the client writes straight into them with no
+ * CPU staging copy, and reset() fences each buffer it hands back so that it is only
+ * written again once the GPU has finished reading it. If the next buffer in the ring
+ * is still busy, a new buffer is created instead of waiting.
  */
 class GrBufferAllocPool : SkNoncopyable {
 public:
@@ -37,6 +44,7 @@ public:
 
     /**
      *  Invalidates all the data in the pool, unrefs non-preallocated buffers.
+     *  Call after drawing from the pool has been issued to the GrGpu.
      */
     void reset();
 
@@ -155,6 +163,7 @@ private:
 
     bool createBlock(size_t requestSize);
     void destroyBlock();
+    bool reclaimPreallocBuffer(int index);
     void flushCpuData(const BufferBlock& block, size_t flushSize);
 #ifdef SK_DEBUG
     void validate(bool unusedBlockAllowed = false) const;
@@ -165,7 +174,13 @@ private:
     GrGpu*                          fGpu;
     bool                            fGpuIsReffed;
     bool                            fFrequentResetHint;
+    // Dynamic buffers are persistently mapped, so we write straight into them, but must not
+    // reuse a preallocated buffer until the GPU is done with the draws that last read it.
+    bool                            fPersistent;
     SkTDArray<GrGeometryBuffer*>    fPreallocBuffers;
+    // Parallel to fPreallocBuffers when fPersistent. A nonzero fence was inserted after the last
+    // flush to read the buffer.
+    SkTDArray<GrFence>              fPreallocFences;
     size_t                          fMinBlockSize;
     BufferType                      fBufferType;
 
@@ -10,6 +10,7 @@
 #include "GrAAHairLinePathRenderer.h"
 #include "GrAARectRenderer.h"
 #include "GrDrawTargetCaps.h"
+#include "GrGpuResourcePriv.h"
 #include "GrPaint.h"
 #include "GrPathRenderer.h"
 #include "GrRenderTarget.h"
@@ -204,6 +205,27 @@ invert ? kInverseFillBW_GrProcessorEdgeType : kFillBW_GrProcessorEdgeType;
     return !failed;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void GrClipMaskManager::reduceClipStack(const SkClipStack& stack, const SkIRect& queryBounds) {
+    int32_t stackGenID = stack.getTopmostGenID();
+    if (SkClipStack::kInvalidGenID != stackGenID && fReducedClip.fStackGenID == stackGenID &&
+        fReducedClip.fQueryBounds == queryBounds) {
+        return;
+    }
+    fReducedClip.fGenID = 0;
+    fReducedClip.fInitialState = GrReducedClip::kAllIn_InitialState;
+    fReducedClip.fRequiresAA = false;
+    GrReducedClip::ReduceClipStack(stack,
+                                   queryBounds,
+                                   &fReducedClip.fElements,
+                                   &fReducedClip.fGenID,
+                                   &fReducedClip.fInitialState,
+                                   &fReducedClip.fTighterBounds,
+                                   &fReducedClip.fRequiresAA);
+    fReducedClip.fStackGenID = stackGenID;
+    fReducedClip.fQueryBounds = queryBounds;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // sort out what kind of clip mask needs to be created: alpha, stencil,
 // scissor, or entirely software
@@ -217,7 +239,7 @@ bool GrClipMaskManager::setupClipping(GrPipelineBuilder* pipelineBuilder,
         fClipMode = kIgnoreClip_StencilClipMode;
     }
 
-    GrReducedClip::ElementList elements(16);
+    const GrReducedClip::ElementList& elements = fReducedClip.fElements;
     int32_t genID = 0;
     GrReducedClip::InitialState initialState = GrReducedClip::kAllIn_InitialState;
     SkIRect clipSpaceIBounds;
@@ -251,13 +273,11 @@ bool GrClipMaskManager::setupClipping(GrPipelineBuilder* pipelineBuilder,
         }
         case GrClip::kClipStack_ClipType: {
             clipSpaceRTIBounds.offset(clip.origin());
-            GrReducedClip::ReduceClipStack(*clip.clipStack(),
-                                            clipSpaceRTIBounds,
-                                            &elements,
-                                            &genID,
-                                            &initialState,
-                                            &clipSpaceIBounds,
-                                            &requiresAA);
+            this->reduceClipStack(*clip.clipStack(), clipSpaceRTIBounds);
+            genID = fReducedClip.fGenID;
+            initialState = fReducedClip.fInitialState;
+            clipSpaceIBounds = fReducedClip.fTighterBounds;
+            requiresAA = fReducedClip.fRequiresAA;
             if (elements.isEmpty()) {
                 if (GrReducedClip::kAllIn_InitialState == initialState) {
                     if (clipSpaceIBounds == clipSpaceRTIBounds) {
@@ -298,7 +318,7 @@ bool GrClipMaskManager::setupClipping(GrPipelineBuilder* pipelineBuilder,
 
     // If MSAA is enabled we can do everything in the stencil buffer.
     if (0 == rt->numSamples() && requiresAA) {
-        GrTexture* result = NULL;
+        SkAutoTUnref<GrTexture> result;
 
         // The top-left of the mask corresponds to the top-left corner of the bounds.
         SkVector clipToMaskOffset = {
@@ -309,17 +329,17 @@ bool GrClipMaskManager::setupClipping(GrPipelineBuilder* pipelineBuilder,
         if (this->useSWOnlyPath(pipelineBuilder, clipToMaskOffset, elements)) {
             // The clip geometry is complex enough that it will be more efficient to create it
             // entirely in software
-            result = this->createSoftwareClipMask(genID,
-                                                  initialState,
-                                                  elements,
-                                                  clipToMaskOffset,
-                                                  clipSpaceIBounds);
+            result.reset(this->createSoftwareClipMask(genID,
+                                                      initialState,
+                                                      elements,
+                                                      clipToMaskOffset,
+                                                      clipSpaceIBounds));
         } else {
-            result = this->createAlphaClipMask(genID,
-                                               initialState,
-                                               elements,
-                                               clipToMaskOffset,
-                                               clipSpaceIBounds);
+            result.reset(this->createAlphaClipMask(genID,
+                                                   initialState,
+                                                   elements,
+                                                   clipToMaskOffset,
+                                                   clipSpaceIBounds));
         }
 
         if (result) {
@@ -335,13 +355,6 @@ bool GrClipMaskManager::setupClipping(GrPipelineBuilder* pipelineBuilder,
         // if alpha clip mask creation fails fall through to the non-AA code paths
     }
 
-    // Either a hard (stencil buffer) clip was explicitly requested or an anti-aliased clip couldn't
-    // be created. In either case, free up the texture in the anti-aliased mask cache.
-    // TODO: this may require more investigation. Ganesh performs a lot of utility draws (e.g.,
-    // clears, InOrderDrawBuffer playbacks) that hit the stencil buffer path. These may be
-    // "incorrectly" clearing the AA cache.
-    fAACache.reset();
-
     // use the stencil clip if we can't represent the clip as a rectangle.
     SkIPoint clipSpaceToStencilSpaceOffset = -clip.origin();
     this->createStencilClipMask(rt,
@@ -504,27 +517,43 @@ GrTexture* GrClipMaskManager::createTempMask(int width, int height) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Return the texture currently in the cache if it exists. Otherwise, return NULL
+// A mask is a rasterization of one clip's elements through the given bounds, so those two are all
+// it takes to find it again.
+static void get_clip_mask_key(int32_t clipGenID, const SkIRect& bounds, GrUniqueKey* key) {
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey::Builder builder(key, kDomain, 5);
+    builder[0] = clipGenID;
+    builder[1] = bounds.fLeft;
+    builder[2] = bounds.fTop;
+    builder[3] = bounds.fRight;
+    builder[4] = bounds.fBottom;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Return a ref to the mask made earlier for this clip and bounds if the resource cache still has
+// it. Otherwise, return NULL
 GrTexture* GrClipMaskManager::getCachedMaskTexture(int32_t elementsGenID,
                                                    const SkIRect& clipSpaceIBounds) {
-    bool cached = fAACache.canReuse(elementsGenID, clipSpaceIBounds);
-    if (!cached) {
-        return NULL;
-    }
+    GrUniqueKey key;
+    get_clip_mask_key(elementsGenID, clipSpaceIBounds, &key);
+    return this->getContext()->findAndRefCachedTexture(key);
+}
 
-    return fAACache.getLastMask();
+// Gives a finished mask its key, so later draws with the same clip can find it.
+void GrClipMaskManager::cacheMaskTexture(int32_t elementsGenID,
+                                         const SkIRect& clipSpaceIBounds,
+                                         GrTexture* mask) {
+    GrUniqueKey key;
+    get_clip_mask_key(elementsGenID, clipSpaceIBounds, &key);
+    this->getContext()->addResourceToCache(key, mask);
+    // It came from the scratch pool at low priority, but is no longer quick to replace.
+    mask->resourcePriv().setPurgePriority(GrGpuResource::kDefault_PurgePriority);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Allocate a texture in the texture cache. This function returns the texture
+// Allocate a scratch texture for a clip mask. This function returns a ref to the texture
 // allocated (or NULL on error).
-GrTexture* GrClipMaskManager::allocMaskTexture(int32_t elementsGenID,
-                                               const SkIRect& clipSpaceIBounds,
-                                               bool willUpload) {
-    // Since we are setting up the cache we should free up the
-    // currently cached mask so it can be reused.
-    fAACache.reset();
-
+GrTexture* GrClipMaskManager::allocMaskTexture(const SkIRect& clipSpaceIBounds, bool willUpload) {
     GrSurfaceDesc desc;
     desc.fFlags = willUpload ? kNone_GrSurfaceFlags : kRenderTarget_GrSurfaceFlag;
     desc.fWidth = clipSpaceIBounds.width();
@@ -535,8 +564,10 @@ GrTexture* GrClipMaskManager::allocMaskTexture(int32_t elementsGenID,
         desc.fConfig = kAlpha_8_GrPixelConfig;
     }
 
-    fAACache.acquireMask(elementsGenID, desc, clipSpaceIBounds);
-    return fAACache.getLastMask();
+    // HACK: set the last param to true to indicate that this request is at flush time and
+    // therefore we require a scratch texture with no pending IO operations.
+    return this->getContext()->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch,
+                                                 /*flushing=*/true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -549,16 +580,15 @@ GrTexture* GrClipMaskManager::createAlphaClipMask(int32_t elementsGenID,
     SkASSERT(kNone_ClipMaskType == fCurrClipMaskType);
 
     // First, check for cached texture
-    GrTexture* result = this->getCachedMaskTexture(elementsGenID, clipSpaceIBounds);
+    SkAutoTUnref<GrTexture> result(this->getCachedMaskTexture(elementsGenID, clipSpaceIBounds));
     if (result) {
         fCurrClipMaskType = kAlpha_ClipMaskType;
-        return result;
+        return result.detach();
     }
 
     // There's no texture in the cache. Let's try to allocate it then.
-    result = this->allocMaskTexture(elementsGenID, clipSpaceIBounds, false);
+    result.reset(this->allocMaskTexture(clipSpaceIBounds, false));
     if (NULL == result) {
-        fAACache.reset();
         return NULL;
     }
 
@@ -616,7 +646,6 @@ GrTexture* GrClipMaskManager::createAlphaClipMask(int32_t elementsGenID,
                     temp.reset(this->createTempMask(maskSpaceIBounds.fRight,
                                                     maskSpaceIBounds.fBottom));
                     if (!temp) {
-                        fAACache.reset();
                         return NULL;
                     }
                 }
@@ -643,7 +672,6 @@ GrTexture* GrClipMaskManager::createAlphaClipMask(int32_t elementsGenID,
             }
 
             if (!this->drawElement(&pipelineBuilder, translate, dst, element, pr)) {
-                fAACache.reset();
                 return NULL;
             }
 
@@ -690,8 +718,9 @@ GrTexture* GrClipMaskManager::createAlphaClipMask(int32_t elementsGenID,
         }
     }
 
+    this->cacheMaskTexture(elementsGenID, clipSpaceIBounds, result);
     fCurrClipMaskType = kAlpha_ClipMaskType;
-    return result;
+    return result.detach();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1046,6 +1075,28 @@ void GrClipMaskManager::adjustStencilParams(GrStencilSettings* settings,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// If the mask is just the coverage of one element (the clip starts out empty and the element
+// is added to it, or starts out full and is intersected with it), return that element.
+static const Element* get_sole_mask_element(GrReducedClip::InitialState initialState,
+                                            const GrReducedClip::ElementList& elements) {
+    if (1 != elements.count()) {
+        return NULL;
+    }
+    const Element* element = elements.head();
+    switch (element->getOp()) {
+        case SkRegion::kReplace_Op:
+            return element;
+        case SkRegion::kUnion_Op:
+        case SkRegion::kXOR_Op:
+        case SkRegion::kReverseDifference_Op:
+            return GrReducedClip::kAllOut_InitialState == initialState ? element : NULL;
+        case SkRegion::kIntersect_Op:
+            return GrReducedClip::kAllIn_InitialState == initialState ? element : NULL;
+        default:
+            return NULL;
+    }
+}
+
 GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
                                                      GrReducedClip::InitialState initialState,
                                                      const GrReducedClip::ElementList& elements,
@@ -1055,6 +1106,7 @@ GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
 
     GrTexture* result = this->getCachedMaskTexture(elementsGenID, clipSpaceIBounds);
     if (result) {
+        fCurrClipMaskType = kAlpha_ClipMaskType;
         return result;
     }
 
@@ -1069,10 +1121,36 @@ GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
     SkMatrix translate;
     translate.setTranslate(clipToMaskOffset);
 
-    helper.init(maskSpaceIBounds, &translate, false);
-    helper.clear(GrReducedClip::kAllIn_InitialState == initialState ? 0xFF : 0x00);
     SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
 
+    // A mask of one element is drawn once, with nothing to combine it with, so it can be
+    // rasterized straight into a compressed texture when the GPU takes compressed masks.
+    if (const Element* element = get_sole_mask_element(initialState, elements)) {
+        if (!helper.init(maskSpaceIBounds, &translate)) {
+            return NULL;
+        }
+        SkPath path;
+        element->asPath(&path);
+        helper.draw(path, stroke, SkRegion::kReplace_Op, element->isAA(), 0xFF);
+
+        result = helper.createTexture(/*flushing=*/true);
+        if (NULL == result) {
+            return NULL;
+        }
+        helper.toTexture(result);
+
+        this->cacheMaskTexture(elementsGenID, clipSpaceIBounds, result);
+        fCurrClipMaskType = kAlpha_ClipMaskType;
+        return result;
+    }
+
+    // Otherwise the elements are combined in an A8 bitmap, which the compressing blitters can't
+    // read back from.
+    if (!helper.init(maskSpaceIBounds, &translate, false)) {
+        return NULL;
+    }
+    helper.clear(GrReducedClip::kAllIn_InitialState == initialState ? 0xFF : 0x00);
+
     for (GrReducedClip::ElementList::Iter iter(elements.headIter()) ; iter.get(); iter.next()) {
         const Element* element = iter.get();
         SkRegion::Op op = element->getOp();
@@ -1106,25 +1184,24 @@ GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
     }
 
     // Allocate clip mask texture
-    result = this->allocMaskTexture(elementsGenID, clipSpaceIBounds, true);
+    result = this->allocMaskTexture(clipSpaceIBounds, true);
     if (NULL == result) {
-        fAACache.reset();
         return NULL;
     }
     helper.toTexture(result);
 
+    this->cacheMaskTexture(elementsGenID, clipSpaceIBounds, result);
     fCurrClipMaskType = kAlpha_ClipMaskType;
     return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void GrClipMaskManager::purgeResources() {
-    fAACache.purgeResources();
+GrContext* GrClipMaskManager::getContext() {
+    return fClipTarget->getContext();
 }
 
 void GrClipMaskManager::setClipTarget(GrClipTarget* clipTarget) {
     fClipTarget = clipTarget;
-    fAACache.setContext(clipTarget->getContext());
 }
 
 void GrClipMaskManager::adjustPathStencilParams(const GrStencilBuffer* stencilBuffer,
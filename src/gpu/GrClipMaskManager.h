@@ -7,7 +7,6 @@
 #ifndef GrClipMaskManager_DEFINED
 #define GrClipMaskManager_DEFINED
 
-#include "GrClipMaskCache.h"
 #include "GrContext.h"
 #include "GrPipelineBuilder.h"
 #include "GrReducedClip.h"
@@ -54,12 +53,6 @@ public:
                        GrScissorState*,
                        const SkRect* devBounds);
 
-    /**
-     * Purge resources to free up memory. TODO: This class shouldn't hold any long lived refs
-     * which will allow Resourcecache to automatically purge anything this class has created.
-     */
-    void purgeResources();
-
     bool isClipInStencil() const {
         return kStencil_ClipMaskType == fCurrClipMaskType;
     }
@@ -68,9 +61,7 @@ public:
         return kAlpha_ClipMaskType == fCurrClipMaskType;
     }
 
-    GrContext* getContext() {
-        return fAACache.getContext();
-    }
+    GrContext* getContext();
 
     void setClipTarget(GrClipTarget*);
 
@@ -107,8 +98,10 @@ private:
                                const SkIRect& clipSpaceIBounds,
                                const SkIPoint& clipSpaceToStencilOffset);
 
-    // Creates an alpha mask of the clip. The mask is a rasterization of elements through the
-    // rect specified by clipSpaceIBounds.
+    // Creates an alpha mask of the clip and returns a ref to it. The mask is a rasterization of
+    // elements through the rect specified by clipSpaceIBounds. Masks are kept in the resource
+    // cache, keyed by elementsGenID and clipSpaceIBounds, so drawing with the same clip again
+    // reuses one for as long as the cache holds on to it.
     GrTexture* createAlphaClipMask(int32_t elementsGenID,
                                    GrReducedClip::InitialState initialState,
                                    const GrReducedClip::ElementList& elements,
@@ -122,15 +115,16 @@ private:
                                       const SkVector& clipToMaskOffset,
                                       const SkIRect& clipSpaceIBounds);
 
-    // Returns the cached mask texture if it matches the elementsGenID and the clipSpaceIBounds.
+    // Returns a ref to the cached mask texture for the elementsGenID and the clipSpaceIBounds.
     // Returns NULL if not found.
     GrTexture* getCachedMaskTexture(int32_t elementsGenID, const SkIRect& clipSpaceIBounds);
 
-    // Handles allocation (if needed) of a clip alpha-mask texture for both the sw-upload
-    // or gpu-rendered cases.
-    GrTexture* allocMaskTexture(int32_t elementsGenID,
-                                const SkIRect& clipSpaceIBounds,
-                                bool willUpload);
+    // Keys a completed mask so getCachedMaskTexture() can find it.
+    void cacheMaskTexture(int32_t elementsGenID, const SkIRect& clipSpaceIBounds, GrTexture*);
+
+    // Handles allocation of a clip alpha-mask texture for both the sw-upload or gpu-rendered
+    // cases.
+    GrTexture* allocMaskTexture(const SkIRect& clipSpaceIBounds, bool willUpload);
 
     bool useSWOnlyPath(const GrPipelineBuilder*,
                        const SkVector& clipToMaskOffset,
@@ -189,10 +183,28 @@ private:
         kAlpha_ClipMaskType,
     } fCurrClipMaskType;
 
-    GrClipMaskCache fAACache;       // cache for the AA path
     GrClipTarget*   fClipTarget;
     StencilClipMode fClipMode;
 
+    /**
+     * The last reduction of a clip stack. A stack's topmost gen ID names its contents, so
+     * consecutive draws under the same stack and query bounds reuse this instead of reducing
+     * the stack again.
+     */
+    struct ReducedClip {
+        ReducedClip() : fStackGenID(SkClipStack::kInvalidGenID), fElements(16) {}
+
+        int32_t                     fStackGenID;
+        SkIRect                     fQueryBounds;
+        GrReducedClip::ElementList  fElements;
+        int32_t                     fGenID;
+        GrReducedClip::InitialState fInitialState;
+        SkIRect                     fTighterBounds;
+        bool                        fRequiresAA;
+    } fReducedClip;
+
+    void reduceClipStack(const SkClipStack&, const SkIRect& queryBounds);
+
     typedef SkNoncopyable INHERITED;
 };
 #endif // GrClipMaskManager_DEFINED
@@ -13,6 +13,7 @@
 #include "GrBatch.h"
 #include "GrBatchFontCache.h"
 #include "GrBatchTarget.h"
+#include "GrBitmapAtlas.h"
 #include "GrBufferAllocPool.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrFontCache.h"
@@ -44,6 +45,7 @@
 #include "SkTLazy.h"
 #include "SkTLS.h"
 #include "SkTraceEvent.h"
+#include "SkTraceMemoryDump.h"
 
 #include "effects/GrConfigConversionEffect.h"
 #include "effects/GrDashingEffect.h"
@@ -125,6 +127,7 @@ void GrContext::initCommon() {
     fFontCache = SkNEW_ARGS(GrFontCache, (fGpu));
 
     fLayerCache.reset(SkNEW_ARGS(GrLayerCache, (this)));
+    fBitmapAtlas.reset(SkNEW_ARGS(GrBitmapAtlas, (this)));
 
     fAARectRenderer = SkNEW_ARGS(GrAARectRenderer, (fGpu));
     fOvalRenderer = SkNEW_ARGS(GrOvalRenderer, (fGpu));
@@ -149,6 +152,8 @@ GrContext::~GrContext() {
         (*fCleanUpData[i].fFunc)(this, fCleanUpData[i].fInfo);
     }
 
+    // The atlas texture must be released while the resource cache is alive
+    fBitmapAtlas.free();
     SkDELETE(fResourceCache);
     SkDELETE(fBatchFontCache);
     SkDELETE(fFontCache);
@@ -190,6 +195,7 @@ void GrContext::abandonContext() {
 
     fBatchFontCache->freeAll();
     fFontCache->freeAll();
+    fBitmapAtlas->freeAll();
     fLayerCache->freeAll();
 }
 
@@ -200,15 +206,12 @@ void GrContext::resetContext(uint32_t state) {
 void GrContext::freeGpuResources() {
     this->flush();
 
-    if (fDrawBuffer) {
-        fDrawBuffer->purgeResources();
-    }
-
     fAARectRenderer->reset();
     fOvalRenderer->reset();
 
     fBatchFontCache->freeAll();
     fFontCache->freeAll();
+    fBitmapAtlas->freeAll();
     fLayerCache->freeAll();
     // a path renderer may be holding onto resources
     SkSafeSetNull(fPathRendererChain);
@@ -224,12 +227,48 @@ void GrContext::getResourceCacheUsage(int* resourceCount, size_t* resourceBytes)
     }
 }
 
+void GrContext::getResourceCacheStats(int* hits, int* misses, int* purges) const {
+    if (hits) {
+        *hits = fResourceCache->getHitCount();
+    }
+    if (misses) {
+        *misses = fResourceCache->getMissCount();
+    }
+    if (purges) {
+        *purges = fResourceCache->getPurgeCount();
+    }
+}
+
+void GrContext::resetResourceCacheStats() {
+    fResourceCache->resetStats();
+}
+
+void GrContext::dumpMemoryStatistics(SkTraceMemoryDump* dump) const {
+    static const char kResourceCacheName[] = "skia/gr_resource_cache";
+    dump->dumpNumericValue(kResourceCacheName, "size", "bytes",
+                           fResourceCache->getResourceBytes());
+    dump->dumpNumericValue(kResourceCacheName, "purgeable_size", "bytes",
+                           fResourceCache->getPurgeableBytes());
+    dump->dumpNumericValue(kResourceCacheName, "limit", "bytes",
+                           fResourceCache->getMaxResourceBytes());
+    dump->dumpNumericValue(kResourceCacheName, "count", "objects",
+                           fResourceCache->getResourceCount());
+
+    dump->dumpNumericValue("skia/gr_layer_cache", "count", "objects", fLayerCache->numLayers());
+
+    static const char kBatchFontCacheName[] = "skia/gr_batch_font_cache";
+    dump->dumpNumericValue(kBatchFontCacheName, "size", "bytes", fBatchFontCache->atlasBytes());
+    dump->dumpNumericValue(kBatchFontCacheName, "count", "objects",
+                           fBatchFontCache->numStrikes());
+}
+
 GrTextContext* GrContext::createTextContext(GrRenderTarget* renderTarget,
                                             SkGpuDevice* gpuDevice,
                                             const SkDeviceProperties&
                                             leakyProperties,
                                             bool enableDistanceFieldFonts) {
-    if (fGpu->caps()->pathRenderingSupport() && renderTarget->isMultisampled()) {
+    if (fGpu->caps()->pathRenderingSupport() && renderTarget->isMultisampled() &&
+        !fOptions.fMixedSampleAA) {
         GrStencilBuffer* sb = renderTarget->renderTargetPriv().attachStencilBuffer();
         if (sb) {
             return GrStencilAndCoverTextContext::Create(this, gpuDevice, leakyProperties);
@@ -275,6 +314,8 @@ GrTexture* GrContext::createTexture(const GrSurfaceDesc& desc, bool budgeted, co
                 if (!budgeted) {
                     texture->resourcePriv().makeUnbudgeted();
                 }
+                // It holds content now, not scratch.
+                texture->resourcePriv().setPurgePriority(GrGpuResource::kDefault_PurgePriority);
                 return texture;
             }
             texture->unref();
@@ -301,6 +342,8 @@ GrTexture* GrContext::refScratchTexture(const GrSurfaceDesc& desc, ScratchTexMat
     }
 }
 
+// Scratch textures are made kLow_PurgePriority: their contents don't outlive a use, so they give
+// way to cached content when the cache is over budget.
 GrTexture* GrContext::internalRefScratchTexture(const GrSurfaceDesc& inDesc, uint32_t flags) {
     SkASSERT(!GrPixelConfigIsCompressed(inDesc.fConfig));
 
@@ -332,12 +375,17 @@ GrTexture* GrContext::internalRefScratchTexture(const GrSurfaceDesc& inDesc, uin
             if (rt && fGpu->caps()->discardRenderTargetSupport()) {
                 rt->discard();
             }
+            resource->resourcePriv().setPurgePriority(GrGpuResource::kLow_PurgePriority);
             return surface->asTexture();
         }
     }
 
     if (!(kNoCreate_ScratchTextureFlag & flags)) {
-        return fGpu->createTexture(*desc, true, NULL, 0);
+        GrTexture* texture = fGpu->createTexture(*desc, true, NULL, 0);
+        if (texture) {
+            texture->resourcePriv().setPurgePriority(GrGpuResource::kLow_PurgePriority);
+        }
+        return texture;
     }
 
     return NULL;
@@ -470,7 +518,7 @@ static bool apply_aa_to_rect(GrDrawTarget* target,
                              SkScalar strokeWidth,
                              const SkMatrix& combinedMatrix,
                              GrColor color) {
-    if (pipelineBuilder->getRenderTarget()->isMultisampled()) {
+    if (pipelineBuilder->isHWAntialias()) {
         return false;
     }
 
@@ -743,7 +791,7 @@ void GrContext::drawRect(GrRenderTarget* rt,
 
     GrColor color = paint.getColor();
     SkRect devBoundRect;
-    bool needAA = paint.isAntiAlias() && !pipelineBuilder.getRenderTarget()->isMultisampled();
+    bool needAA = paint.isAntiAlias() && !pipelineBuilder.isHWAntialias();
     bool doAA = needAA && apply_aa_to_rect(target, &pipelineBuilder, &devBoundRect, rect, width,
                                            viewMatrix, color);
 
@@ -814,6 +862,30 @@ void GrContext::drawNonAARectToRect(GrRenderTarget* rt,
                      localMatrix);
 }
 
+void GrContext::drawAtlasedBitmap(GrRenderTarget* rt,
+                                  const GrClip& clip,
+                                  const GrPaint& paint,
+                                  const SkMatrix& viewMatrix,
+                                  const SkBitmap& bitmap,
+                                  const SkRect& srcRect) {
+    RETURN_IF_ABANDONED
+    AutoCheckFlush acf(this);
+    GrPipelineBuilder pipelineBuilder;
+    GrDrawTarget* target = this->prepareToDraw(&pipelineBuilder, rt, clip, &paint, &acf);
+    if (NULL == target) {
+        return;
+    }
+
+    GR_CREATE_TRACE_MARKER("GrContext::drawAtlasedBitmap", target);
+
+    SkAutoTUnref<GrBatch> batch(fBitmapAtlas->createBatch(bitmap, srcRect, viewMatrix,
+                                                          paint.getColor()));
+
+    SkRect bounds = SkRect::MakeWH(srcRect.width(), srcRect.height());
+    viewMatrix.mapRect(&bounds);
+    target->drawBatch(&pipelineBuilder, batch, &bounds);
+}
+
 static const GrGeometryProcessor* set_vertex_attributes(bool hasLocalCoords,
                                                         bool hasColors,
                                                         int* colorOffset,
@@ -1328,8 +1400,7 @@ void GrContext::drawPath(GrRenderTarget* rt,
 
     GrColor color = paint.getColor();
     if (strokeInfo.isDashed()) {
-        SkPoint pts[2];
-        if (path.isLine(pts)) {
+        if (SkPath::kLine_SegmentMask == path.getSegmentMasks()) {
             AutoCheckFlush acf(this);
             GrPipelineBuilder pipelineBuilder;
             GrDrawTarget* target = this->prepareToDraw(&pipelineBuilder, rt, clip, &paint, &acf);
@@ -1337,10 +1408,17 @@ void GrContext::drawPath(GrRenderTarget* rt,
                 return;
             }
 
-            if (GrDashingEffect::DrawDashLine(fGpu, target, &pipelineBuilder, color, viewMatrix,
+            SkPoint pts[2];
+            if (path.isLine(pts) &&
+                GrDashingEffect::DrawDashLine(fGpu, target, &pipelineBuilder, color, viewMatrix,
                                               pts, paint, strokeInfo)) {
                 return;
             }
+
+            if (GrDashingEffect::DrawDashPolyline(fGpu, target, &pipelineBuilder, color,
+                                                  viewMatrix, path, paint, strokeInfo)) {
+                return;
+            }
         }
 
         // Filter dashed path into new path with the dashing applied
@@ -1373,8 +1451,7 @@ void GrContext::drawPath(GrRenderTarget* rt,
 
     const SkStrokeRec& strokeRec = strokeInfo.getStrokeRec();
 
-    bool useCoverageAA = paint.isAntiAlias() &&
-        !pipelineBuilder.getRenderTarget()->isMultisampled();
+    bool useCoverageAA = paint.isAntiAlias() && !pipelineBuilder.isHWAntialias();
 
     if (useCoverageAA && strokeRec.getWidth() < 0 && !path.isConvex()) {
         // Concave AA paths are expensive - try to avoid them for special cases
@@ -1419,21 +1496,38 @@ void GrContext::internalDrawPath(GrDrawTarget* target,
     // the src color (either the input alpha or in the frag shader) to implement
     // aa. If we have some future driver-mojo path AA that can do the right
     // thing WRT to the blend then we'll need some query on the PR.
-    bool useCoverageAA = useAA &&
-        !pipelineBuilder->getRenderTarget()->isMultisampled();
+    bool useCoverageAA = useAA && !pipelineBuilder->isHWAntialias();
 
+    const SkPath* pathPtr = &path;
+    SkTLazy<SkPath> tmpPath;
+    SkTCopyOnFirstWrite<SkStrokeRec> stroke(strokeInfo.getStrokeRec());
+
+    GrPathRenderer* pr = NULL;
+    if (useCoverageAA && fOptions.fMixedSampleAA &&
+        pipelineBuilder->getRenderTarget()->isMultisampled()) {
+        // Concave fills, and paths no coverage AA renderer can draw without software, are
+        // multisampled
+        if (stroke->isFillStyle() && !path.isConvex()) {
+            useCoverageAA = false;
+        } else {
+            pr = this->getPathRenderer(target, pipelineBuilder, viewMatrix, *pathPtr, *stroke,
+                                       false, GrPathRendererChain::kColorAntiAlias_DrawType);
+            useCoverageAA = SkToBool(pr);
+        }
+        if (!useCoverageAA) {
+            pipelineBuilder->enableState(GrPipelineBuilder::kHWAntialias_StateBit);
+        }
+    }
 
     GrPathRendererChain::DrawType type =
         useCoverageAA ? GrPathRendererChain::kColorAntiAlias_DrawType :
                         GrPathRendererChain::kColor_DrawType;
 
-    const SkPath* pathPtr = &path;
-    SkTLazy<SkPath> tmpPath;
-    SkTCopyOnFirstWrite<SkStrokeRec> stroke(strokeInfo.getStrokeRec());
-
     // Try a 1st time without stroking the path and without allowing the SW renderer
-    GrPathRenderer* pr = this->getPathRenderer(target, pipelineBuilder, viewMatrix, *pathPtr,
-                                               *stroke, false, type);
+    if (NULL == pr) {
+        pr = this->getPathRenderer(target, pipelineBuilder, viewMatrix, *pathPtr, *stroke, false,
+                                   type);
+    }
 
     if (NULL == pr) {
         if (!GrPathRenderer::IsStrokeHairlineOrEquivalent(*stroke, viewMatrix, NULL)) {
@@ -1477,6 +1571,24 @@ void GrContext::flush(int flagsBitfield) {
     fFlushToReduceCacheSize = false;
 }
 
+GrFence GrContext::insertFence() {
+    if (!fDrawBuffer) {
+        return 0;
+    }
+    this->flush();
+    return fGpu->insertFence();
+}
+
+bool GrContext::waitFence(GrFence fence, uint64_t timeoutNs) {
+    RETURN_FALSE_IF_ABANDONED
+    return fGpu->waitFence(fence, timeoutNs);
+}
+
+void GrContext::deleteFence(GrFence fence) {
+    RETURN_IF_ABANDONED
+    fGpu->deleteFence(fence);
+}
+
 bool sw_convert_to_premul(GrPixelConfig srcConfig, int width, int height, size_t inRowBytes,
                           const void* inPixels, size_t outRowBytes, void* outPixels) {
     SkSrcPixelInfo srcPI;
@@ -1511,7 +1623,8 @@ bool GrContext::writeSurfacePixels(GrSurface* surface,
                 this->flush();
             }
             return fGpu->writeTexturePixels(texture, left, top, width, height,
-                                            srcConfig, buffer, rowBytes);
+                                            srcConfig, buffer, rowBytes,
+                                            SkToBool(kAsync_PixelOpsFlag & pixelOpsFlags));
             // Don't need to check kFlushWrites_PixelOp here, we just did a direct write so the
             // upload is already flushed.
         }
@@ -1835,6 +1948,10 @@ GrDrawTarget* GrContext::prepareToDraw(GrPipelineBuilder* pipelineBuilder,
     ASSERT_OWNED_RESOURCE(rt);
     SkASSERT(rt && paint && acf);
     pipelineBuilder->setFromPaint(*paint, rt, clip);
+    if (fOptions.fMixedSampleAA) {
+        // Multisampling is turned back on by internalDrawPath for the paths that need it
+        pipelineBuilder->disableState(GrPipelineBuilder::kHWAntialias_StateBit);
+    }
     return fDrawBuffer;
 }
 
@@ -1921,6 +2038,7 @@ void GrContext::setupDrawBuffer() {
     fDrawBuffer = SkNEW_ARGS(GrInOrderDrawBuffer, (fGpu,
                                                    fDrawBufferVBAllocPool,
                                                    fDrawBufferIBAllocPool));
+    fDrawBuffer->setSortBatches(fOptions.fSortBatches);
 }
 
 GrDrawTarget* GrContext::getTextTarget() {
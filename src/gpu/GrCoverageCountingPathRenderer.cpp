@@ -0,0 +1,694 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrCoverageCountingPathRenderer.h"
+
+#include "GrBatch.h"
+#include "GrBatchTarget.h"
+#include "GrContext.h"
+#include "GrDrawTarget.h"
+#include "GrGeometryProcessor.h"
+#include "GrInvariantOutput.h"
+#include "GrPathUtils.h"
+#include "GrPipelineBuilder.h"
+#include "GrProcessorUnitTest.h"
+#include "GrTexture.h"
+#include "SkGeometry.h"
+#include "SkTDArray.h"
+#include "effects/GrPorterDuffXferProcessor.h"
+#include "effects/GrSingleTextureEffect.h"
+#include "gl/GrGLGeometryProcessor.h"
+#include "gl/GrGLProcessor.h"
+#include "gl/GrGLSL.h"
+#include "gl/builders/GrGLProgramBuilder.h"
+
+// Paths are flattened in device space, so this is how far a curve's line segments may stray from
+// it, in pixels.
+static const SkScalar kTolerance = SK_Scalar1 / 4;
+
+static const int kAtlasSize = 1024;
+// Bigger paths are left to the software renderer, so that an atlas holds at least four paths.
+static const int kMaxSlotSize = 512;
+
+static int atlas_size(const GrDrawTargetCaps* caps) {
+    return SkTMin(kAtlasSize, caps->maxRenderTargetSize());
+}
+
+// Finds the device space pixels the path may touch, including a pixel of antialiasing all around.
+// Returns false if none of them are inside the clip.
+static bool get_path_dev_bounds(const GrPipelineBuilder* pipelineBuilder,
+                                const SkMatrix& viewMatrix,
+                                const SkPath& path,
+                                SkIRect* devBounds) {
+    SkIRect devClipBounds;
+    pipelineBuilder->clip().getConservativeBounds(pipelineBuilder->getRenderTarget(),
+                                                  &devClipBounds);
+    SkRect bounds;
+    viewMatrix.mapRect(&bounds, path.getBounds());
+    bounds.roundOut(devBounds);
+    devBounds->outset(1, 1);
+    return devBounds->intersect(devClipBounds);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct EdgeVertex {
+    SkPoint fPos;
+    SkPoint fEdge[2];
+};
+
+}
+
+/**
+ * Draws one edge of a path into the atlas, as a quad covering the edge and everything to its right
+ * in the path's slot. Each pixel gets the fraction of its height the edge spans, times the fraction
+ * of its width that lies right of the edge, negated for edges that go up. Summed over all of the
+ * path's edges with additive blending, that is the path's fractional winding number at the pixel.
+ */
+class CoverageCountEdgeEffect : public GrGeometryProcessor {
+public:
+    static GrGeometryProcessor* Create(GrColor color) {
+        return SkNEW_ARGS(CoverageCountEdgeEffect, (color));
+    }
+
+    virtual ~CoverageCountEdgeEffect() {}
+
+    const char* name() const override { return "CoverageCountEdge"; }
+
+    const Attribute* inPosition() const { return fInPosition; }
+    const Attribute* inEdge() const { return fInEdge; }
+
+    class GLProcessor : public GrGLGeometryProcessor {
+    public:
+        GLProcessor(const GrGeometryProcessor&,
+                    const GrBatchTracker&)
+            : fColor(GrColor_ILLEGAL) {}
+
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const CoverageCountEdgeEffect& ce = args.fGP.cast<CoverageCountEdgeEffect>();
+            GrGLGPBuilder* pb = args.fPB;
+            GrGLVertexBuilder* vsBuilder = pb->getVertexShaderBuilder();
+
+            // emit attributes
+            vsBuilder->emitAttributes(ce);
+
+            // Atlas coordinates run to the atlas size, so these need all the precision we have.
+            GrGLVertToFrag pos(kVec2f_GrSLType);
+            pb->addVarying("Position", &pos, kHigh_GrSLPrecision);
+            vsBuilder->codeAppendf("%s = %s;", pos.vsOut(), ce.inPosition()->fName);
+
+            GrGLVertToFrag edge(kVec4f_GrSLType);
+            pb->addVarying("Edge", &edge, kHigh_GrSLPrecision);
+            vsBuilder->codeAppendf("%s = %s;", edge.vsOut(), ce.inEdge()->fName);
+
+            const BatchTracker& local = args.fBT.cast<BatchTracker>();
+
+            // Setup pass through color
+            this->setupColorPassThrough(pb, local.fInputColorType, args.fOutputColor, NULL,
+                                        &fColorUniform);
+
+            // Setup position
+            this->setupPosition(pb, gpArgs, ce.inPosition()->fName, ce.viewMatrix());
+
+            // emit transforms
+            this->emitTransforms(args.fPB, gpArgs->fPositionVar, ce.inPosition()->fName,
+                                 ce.localMatrix(), args.fTransformsIn, args.fTransformsOut);
+
+            GrGLGPFragmentBuilder* fsBuilder = pb->getFragmentShaderBuilder();
+            // The part of the edge inside this pixel's row, and where it crosses the row's middle.
+            fsBuilder->codeAppendf("float y0 = max(min(%s.y, %s.w), %s.y - 0.5);",
+                                   edge.fsIn(), edge.fsIn(), pos.fsIn());
+            fsBuilder->codeAppendf("float y1 = min(max(%s.y, %s.w), %s.y + 0.5);",
+                                   edge.fsIn(), edge.fsIn(), pos.fsIn());
+            fsBuilder->codeAppendf("float t = (0.5 * (y0 + y1) - %s.y) / (%s.w - %s.y);",
+                                   edge.fsIn(), edge.fsIn(), edge.fsIn());
+            fsBuilder->codeAppendf("float x = mix(%s.x, %s.z, t);", edge.fsIn(), edge.fsIn());
+            fsBuilder->codeAppendf("float winding = %s.w > %s.y ? 1.0 : -1.0;",
+                                   edge.fsIn(), edge.fsIn());
+            fsBuilder->codeAppendf("%s = vec4(winding * max(y1 - y0, 0.0) * "
+                                   "clamp(%s.x + 0.5 - x, 0.0, 1.0));",
+                                   args.fOutputCoverage, pos.fsIn());
+        }
+
+        static inline void GenKey(const GrGeometryProcessor& gp,
+                                  const GrBatchTracker& bt,
+                                  const GrGLCaps&,
+                                  GrProcessorKeyBuilder* b) {
+            const BatchTracker& local = bt.cast<BatchTracker>();
+            uint32_t key = local.fInputColorType << 16;
+            key |= local.fUsesLocalCoords && gp.localMatrix().hasPerspective() ? 0x1 : 0x0;
+            key |= ComputePosKey(gp.viewMatrix()) << 1;
+            b->add32(key);
+        }
+
+        virtual void setData(const GrGLProgramDataManager& pdman,
+                             const GrPrimitiveProcessor& gp,
+                             const GrBatchTracker& bt) override {
+            this->setUniformViewMatrix(pdman, gp.viewMatrix());
+
+            const BatchTracker& local = bt.cast<BatchTracker>();
+            if (kUniform_GrGPInput == local.fInputColorType && local.fColor != fColor) {
+                GrGLfloat c[4];
+                GrColorToRGBAFloat(local.fColor, c);
+                pdman.set4fv(fColorUniform, 1, c);
+                fColor = local.fColor;
+            }
+        }
+
+    private:
+        GrColor fColor;
+        UniformHandle fColorUniform;
+
+        typedef GrGLGeometryProcessor INHERITED;
+    };
+
+    virtual void getGLProcessorKey(const GrBatchTracker& bt,
+                                   const GrGLCaps& caps,
+                                   GrProcessorKeyBuilder* b) const override {
+        GLProcessor::GenKey(*this, bt, caps, b);
+    }
+
+    virtual GrGLPrimitiveProcessor* createGLInstance(const GrBatchTracker& bt,
+                                                     const GrGLCaps&) const override {
+        return SkNEW_ARGS(GLProcessor, (*this, bt));
+    }
+
+    void initBatchTracker(GrBatchTracker* bt, const GrPipelineInfo& init) const override {
+        BatchTracker* local = bt->cast<BatchTracker>();
+        local->fInputColorType = GetColorInputType(&local->fColor, this->color(), init, false);
+        local->fUsesLocalCoords = init.fUsesLocalCoords;
+    }
+
+    bool onCanMakeEqual(const GrBatchTracker& m,
+                        const GrGeometryProcessor& that,
+                        const GrBatchTracker& t) const override {
+        const BatchTracker& mine = m.cast<BatchTracker>();
+        const BatchTracker& theirs = t.cast<BatchTracker>();
+        return CanCombineLocalMatrices(*this, mine.fUsesLocalCoords,
+                                       that, theirs.fUsesLocalCoords) &&
+               CanCombineOutput(mine.fInputColorType, mine.fColor,
+                                theirs.fInputColorType, theirs.fColor);
+    }
+
+private:
+    CoverageCountEdgeEffect(GrColor color)
+        : INHERITED(color) {
+        this->initClassID<CoverageCountEdgeEffect>();
+        fInPosition = &this->addVertexAttrib(Attribute("inPosition", kVec2f_GrVertexAttribType));
+        fInEdge = &this->addVertexAttrib(Attribute("inEdge", kVec4f_GrVertexAttribType));
+    }
+
+    bool onIsEqual(const GrGeometryProcessor& other) const override {
+        return true;
+    }
+
+    void onGetInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        out->setUnknownSingleComponent();
+    }
+
+    struct BatchTracker {
+        GrGPInput fInputColorType;
+        GrColor fColor;
+        bool fUsesLocalCoords;
+    };
+
+    const Attribute* fInPosition;
+    const Attribute* fInEdge;
+
+    GR_DECLARE_GEOMETRY_PROCESSOR_TEST;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+
+GR_DEFINE_GEOMETRY_PROCESSOR_TEST(CoverageCountEdgeEffect);
+
+GrGeometryProcessor* CoverageCountEdgeEffect::TestCreate(SkRandom* random,
+                                                         GrContext*,
+                                                         const GrDrawTargetCaps&,
+                                                         GrTexture*[]) {
+    return CoverageCountEdgeEffect::Create(GrRandomColor(random));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Modulates its input by the coverage of a path, read from the winding counts the path left in
+ * the atlas. Device coords are mapped to the path's slot by the texture matrix.
+ */
+class CoverageCountResolveEffect : public GrSingleTextureEffect {
+public:
+    static GrFragmentProcessor* Create(GrTexture* atlas, const SkMatrix& matrix,
+                                       SkPath::FillType fillType) {
+        return SkNEW_ARGS(CoverageCountResolveEffect, (atlas, matrix, fillType));
+    }
+
+    virtual ~CoverageCountResolveEffect() {}
+
+    const char* name() const override { return "CoverageCountResolve"; }
+
+    SkPath::FillType fillType() const { return fFillType; }
+
+    void getGLProcessorKey(const GrGLCaps&, GrProcessorKeyBuilder*) const override;
+
+    GrGLFragmentProcessor* createGLInstance() const override;
+
+private:
+    CoverageCountResolveEffect(GrTexture* atlas, const SkMatrix& matrix,
+                               SkPath::FillType fillType)
+        : INHERITED(atlas, matrix, GrTextureParams::kNone_FilterMode, kDevice_GrCoordSet)
+        , fFillType(fillType) {
+        this->initClassID<CoverageCountResolveEffect>();
+    }
+
+    bool onIsEqual(const GrFragmentProcessor& other) const override {
+        return fFillType == other.cast<CoverageCountResolveEffect>().fFillType;
+    }
+
+    void onComputeInvariantOutput(GrInvariantOutput* inout) const override {
+        inout->mulByUnknownSingleComponent();
+    }
+
+    SkPath::FillType fFillType;
+
+    GR_DECLARE_FRAGMENT_PROCESSOR_TEST;
+
+    typedef GrSingleTextureEffect INHERITED;
+};
+
+class GLCoverageCountResolveEffect : public GrGLFragmentProcessor {
+public:
+    GLCoverageCountResolveEffect(const GrProcessor&) {}
+
+    virtual void emitCode(GrGLFPBuilder* builder,
+                          const GrFragmentProcessor& fp,
+                          const char* outputColor,
+                          const char* inputColor,
+                          const TransformedCoordsArray& coords,
+                          const TextureSamplerArray& samplers) override {
+        const CoverageCountResolveEffect& cre = fp.cast<CoverageCountResolveEffect>();
+        GrGLFPFragmentBuilder* fsBuilder = builder->getFragmentShaderBuilder();
+        fsBuilder->codeAppend("\t\tfloat count = ");
+        fsBuilder->appendTextureLookup(samplers[0], coords[0].c_str(), coords[0].getType());
+        fsBuilder->codeAppend(".a;\n");
+        if (SkPath::kEvenOdd_FillType == cre.fillType()) {
+            fsBuilder->codeAppend("\t\tfloat coverage = 1.0 - abs(mod(abs(count), 2.0) - 1.0);\n");
+        } else {
+            fsBuilder->codeAppend("\t\tfloat coverage = min(abs(count), 1.0);\n");
+        }
+        fsBuilder->codeAppendf("\t\t%s = %s;\n", outputColor,
+                               (GrGLSLExpr4(inputColor) * GrGLSLExpr1("coverage")).c_str());
+    }
+
+    static inline void GenKey(const GrProcessor& processor, const GrGLCaps&,
+                              GrProcessorKeyBuilder* b) {
+        const CoverageCountResolveEffect& cre = processor.cast<CoverageCountResolveEffect>();
+        b->add32(cre.fillType());
+    }
+
+private:
+    typedef GrGLFragmentProcessor INHERITED;
+};
+
+void CoverageCountResolveEffect::getGLProcessorKey(const GrGLCaps& caps,
+                                                   GrProcessorKeyBuilder* b) const {
+    GLCoverageCountResolveEffect::GenKey(*this, caps, b);
+}
+
+GrGLFragmentProcessor* CoverageCountResolveEffect::createGLInstance() const {
+    return SkNEW_ARGS(GLCoverageCountResolveEffect, (*this));
+}
+
+GR_DEFINE_FRAGMENT_PROCESSOR_TEST(CoverageCountResolveEffect);
+
+GrFragmentProcessor* CoverageCountResolveEffect::TestCreate(SkRandom* random,
+                                                            GrContext*,
+                                                            const GrDrawTargetCaps&,
+                                                            GrTexture* textures[]) {
+    SkPath::FillType fillType = random->nextBool() ? SkPath::kWinding_FillType :
+                                                     SkPath::kEvenOdd_FillType;
+    return CoverageCountResolveEffect::Create(textures[GrProcessorUnitTest::kAlphaTextureIdx],
+                                              GrProcessorUnitTest::TestMatrix(random), fillType);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Clips the edge from p0 to p1 to the rows of slot, and adds the quad that accumulates its winding
+// into the part of slot from the edge rightwards.
+static void add_edge(const SkPoint& p0, const SkPoint& p1, const SkIRect& slot,
+                     SkTDArray<EdgeVertex>* vertices) {
+    // Horizontal edges never change the winding.
+    if (p0.fY == p1.fY) {
+        return;
+    }
+    SkScalar top = SkTMax(SkScalarFloorToScalar(SkTMin(p0.fY, p1.fY)), SkIntToScalar(slot.fTop));
+    SkScalar bottom = SkTMin(SkScalarCeilToScalar(SkTMax(p0.fY, p1.fY)),
+                             SkIntToScalar(slot.fBottom));
+    SkScalar left = SkTMax(SkScalarFloorToScalar(SkTMin(p0.fX, p1.fX)) - SK_Scalar1,
+                           SkIntToScalar(slot.fLeft));
+    SkScalar right = SkIntToScalar(slot.fRight);
+    if (top >= bottom || left >= right) {
+        return;
+    }
+
+    EdgeVertex* verts = vertices->append(4);
+    verts[0].fPos.set(left, top);
+    verts[1].fPos.set(left, bottom);
+    verts[2].fPos.set(right, bottom);
+    verts[3].fPos.set(right, top);
+    for (int i = 0; i < 4; i++) {
+        verts[i].fEdge[0] = p0;
+        verts[i].fEdge[1] = p1;
+    }
+}
+
+// Adds the edges of the points GrPathUtils generated after start, which it leaves out.
+static void add_edges(const SkPoint& start, const SkPoint* points, const SkPoint* end,
+                      const SkIRect& slot, SkTDArray<EdgeVertex>* vertices) {
+    SkPoint prev = start;
+    for (; points < end; ++points) {
+        add_edge(prev, *points, slot, vertices);
+        prev = *points;
+    }
+}
+
+static void add_quad(const SkPoint pts[3], const SkIRect& slot, SkTDArray<EdgeVertex>* vertices) {
+    uint32_t count = GrPathUtils::quadraticPointCount(pts, kTolerance);
+    SkAutoSTMalloc<32, SkPoint> points(count);
+    SkPoint* end = points.get();
+    GrPathUtils::generateQuadraticPoints(pts[0], pts[1], pts[2], kTolerance * kTolerance, &end,
+                                         count);
+    add_edges(pts[0], points.get(), end, slot, vertices);
+}
+
+static void add_cubic(const SkPoint pts[4], const SkIRect& slot, SkTDArray<EdgeVertex>* vertices) {
+    uint32_t count = GrPathUtils::cubicPointCount(pts, kTolerance);
+    SkAutoSTMalloc<32, SkPoint> points(count);
+    SkPoint* end = points.get();
+    GrPathUtils::generateCubicPoints(pts[0], pts[1], pts[2], pts[3], kTolerance * kTolerance,
+                                     &end, count);
+    add_edges(pts[0], points.get(), end, slot, vertices);
+}
+
+// Flattens path, which is already in atlas space, into the edge quads for its slot.
+static void add_path(const SkPath& path, const SkIRect& slot, SkTDArray<EdgeVertex>* vertices) {
+    // Force closing the contours, so every contour's winding adds up to zero.
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    for (;;) {
+        switch (iter.next(pts)) {
+            case SkPath::kMove_Verb:
+            case SkPath::kClose_Verb:
+                break;
+            case SkPath::kLine_Verb:
+                add_edge(pts[0], pts[1], slot, vertices);
+                break;
+            case SkPath::kQuad_Verb:
+                add_quad(pts, slot, vertices);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads converter;
+                const SkPoint* quadPts = converter.computeQuads(pts, iter.conicWeight(),
+                                                                kTolerance);
+                for (int i = 0; i < converter.countQuads(); ++i) {
+                    add_quad(quadPts + 2 * i, slot, vertices);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                add_cubic(pts, slot, vertices);
+                break;
+            case SkPath::kDone_Verb:
+                return;
+        }
+    }
+}
+
+class CoverageCountAccumulateBatch : public GrBatch {
+public:
+    struct Geometry {
+        SkMatrix fViewMatrix;   // Maps the path to its slot in the atlas.
+        SkPath fPath;
+        SkIRect fSlot;
+    };
+
+    static GrBatch* Create(const Geometry& geometry) {
+        return SkNEW_ARGS(CoverageCountAccumulateBatch, (geometry));
+    }
+
+    const char* name() const override { return "CoverageCountAccumulateBatch"; }
+
+    void getInvariantOutputColor(GrInitInvariantOutput* out) const override {
+        out->setKnownFourComponents(GrColor_WHITE);
+    }
+    void getInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        out->setUnknownSingleComponent();
+    }
+
+    void initBatchTracker(const GrPipelineInfo& init) override {
+        fBatch.fColorIgnored = init.fColorIgnored;
+        fBatch.fCoverageIgnored = init.fCoverageIgnored;
+    }
+
+    void prepareGeometry() override {
+        if (fPrepared) {
+            return;
+        }
+        fPrepared = true;
+
+        SkPath atlasPath;
+        for (int i = 0; i < fGeoData.count(); i++) {
+            const Geometry& args = fGeoData[i];
+            args.fPath.transform(args.fViewMatrix, &atlasPath);
+            add_path(atlasPath, args.fSlot, &fVertices);
+        }
+    }
+
+    void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
+        this->prepareGeometry();
+
+        int instanceCount = fVertices.count() / kVertsPerEdge;
+        if (0 == instanceCount) {
+            return;
+        }
+
+        SkAutoTUnref<GrGeometryProcessor> gp(CoverageCountEdgeEffect::Create(GrColor_WHITE));
+
+        batchTarget->initDraw(gp, pipeline);
+
+        // TODO this is hacky, but the only way we have to initialize the GP is to use the
+        // GrPipelineInfo struct so we can generate the correct shader.  Once we have GrBatch
+        // everywhere we can remove this nastiness
+        GrPipelineInfo init;
+        init.fColorIgnored = fBatch.fColorIgnored;
+        init.fOverrideColor = GrColor_ILLEGAL;
+        init.fCoverageIgnored = fBatch.fCoverageIgnored;
+        init.fUsesLocalCoords = false;
+        gp->initBatchTracker(batchTarget->currentBatchTracker(), init);
+
+        size_t vertexStride = gp->getVertexStride();
+        SkASSERT(vertexStride == sizeof(EdgeVertex));
+
+        const GrVertexBuffer* vertexBuffer;
+        int firstVertex;
+
+        void *vertices = batchTarget->vertexPool()->makeSpace(vertexStride,
+                                                              fVertices.count(),
+                                                              &vertexBuffer,
+                                                              &firstVertex);
+
+        if (!vertices || !batchTarget->quadIndexBuffer()) {
+            SkDebugf("Could not allocate buffers\n");
+            return;
+        }
+
+        memcpy(vertices, fVertices.begin(), fVertices.count() * sizeof(EdgeVertex));
+
+        const GrIndexBuffer* quadIndexBuffer = batchTarget->quadIndexBuffer();
+
+        GrDrawTarget::DrawInfo drawInfo;
+        drawInfo.setPrimitiveType(kTriangles_GrPrimitiveType);
+        drawInfo.setStartVertex(0);
+        drawInfo.setStartIndex(0);
+        drawInfo.setVerticesPerInstance(kVertsPerEdge);
+        drawInfo.setIndicesPerInstance(kIndicesPerEdge);
+        drawInfo.adjustStartVertex(firstVertex);
+        drawInfo.setVertexBuffer(vertexBuffer);
+        drawInfo.setIndexBuffer(quadIndexBuffer);
+
+        int maxInstancesPerDraw = quadIndexBuffer->maxQuads();
+
+        while (instanceCount) {
+            drawInfo.setInstanceCount(SkTMin(instanceCount, maxInstancesPerDraw));
+            drawInfo.setVertexCount(drawInfo.instanceCount() * drawInfo.verticesPerInstance());
+            drawInfo.setIndexCount(drawInfo.instanceCount() * drawInfo.indicesPerInstance());
+
+            batchTarget->draw(drawInfo);
+
+            drawInfo.setStartVertex(drawInfo.startVertex() + drawInfo.vertexCount());
+            instanceCount -= drawInfo.instanceCount();
+        }
+    }
+
+    SkSTArray<1, Geometry, true>* geoData() { return &fGeoData; }
+
+private:
+    CoverageCountAccumulateBatch(const Geometry& geometry) : fPrepared(false) {
+        this->initClassID<CoverageCountAccumulateBatch>();
+        fGeoData.push_back(geometry);
+    }
+
+    bool onCombineIfPossible(GrBatch* t) override {
+        // Every accumulation into an atlas has the same pipeline, and the geometry doesn't care
+        // which path it came from: windings only ever add up.
+        CoverageCountAccumulateBatch* that = t->cast<CoverageCountAccumulateBatch>();
+        SkASSERT(!fPrepared && !that->fPrepared);
+        fGeoData.push_back_n(that->geoData()->count(), that->geoData()->begin());
+        return true;
+    }
+
+    struct BatchTracker {
+        bool fColorIgnored;
+        bool fCoverageIgnored;
+    };
+
+    static const int kVertsPerEdge = 4;
+    static const int kIndicesPerEdge = 6;
+
+    BatchTracker fBatch;
+    SkSTArray<1, Geometry, true> fGeoData;
+    SkTDArray<EdgeVertex> fVertices;
+    bool fPrepared;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(GrContext* context)
+    : fContext(context) {
+}
+
+GrCoverageCountingPathRenderer::~GrCoverageCountingPathRenderer() {}
+
+bool GrCoverageCountingPathRenderer::canDrawPath(const GrDrawTarget* target,
+                                                 const GrPipelineBuilder* pipelineBuilder,
+                                                 const SkMatrix& viewMatrix,
+                                                 const SkPath& path,
+                                                 const SkStrokeRec& stroke,
+                                                 bool antiAlias) const {
+    // TODO: Support inverse fill
+    if (!antiAlias || !stroke.isFillStyle() || path.isInverseFillType() ||
+        viewMatrix.hasPerspective()) {
+        return false;
+    }
+
+    const GrDrawTargetCaps* caps = target->caps();
+    if (!caps->isConfigRenderable(kAlpha_half_GrPixelConfig, false)) {
+        return false;
+    }
+
+    SkIRect devBounds;
+    if (!get_path_dev_bounds(pipelineBuilder, viewMatrix, path, &devBounds)) {
+        // Nothing to draw.
+        return true;
+    }
+    const int maxSlotSize = SkTMin(kMaxSlotSize, atlas_size(caps));
+    return devBounds.width() <= maxSlotSize && devBounds.height() <= maxSlotSize;
+}
+
+GrPathRenderer::StencilSupport
+GrCoverageCountingPathRenderer::onGetStencilSupport(const GrDrawTarget*,
+                                                    const GrPipelineBuilder*,
+                                                    const SkPath&,
+                                                    const SkStrokeRec&) const {
+    return GrPathRenderer::kNoSupport_StencilSupport;
+}
+
+bool GrCoverageCountingPathRenderer::allocSlot(GrDrawTarget* target, int width, int height,
+                                               SkIPoint16* loc) {
+    if (fAtlas && fRectanizer->addRect(width, height, loc)) {
+        return true;
+    }
+
+    // Slots are never reused, so a full atlas is done with. Draws already recorded keep it alive
+    // until they are flushed, and the next atlas can't be it: scratch textures with pending IO
+    // aren't handed out.
+    fAtlas.reset(NULL);
+
+    const int size = atlas_size(target->caps());
+    GrSurfaceDesc desc;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = size;
+    desc.fHeight = size;
+    desc.fConfig = kAlpha_half_GrPixelConfig;
+    fAtlas.reset(fContext->refScratchTexture(desc, GrContext::kExact_ScratchTexMatch, true));
+    if (!fAtlas) {
+        return false;
+    }
+    fRectanizer.reset(GrRectanizer::Factory(size, size));
+
+    target->clear(NULL, 0x0, true, fAtlas->asRenderTarget());
+    return fRectanizer->addRect(width, height, loc);
+}
+
+bool GrCoverageCountingPathRenderer::onDrawPath(GrDrawTarget* target,
+                                                GrPipelineBuilder* pipelineBuilder,
+                                                GrColor color,
+                                                const SkMatrix& viewMatrix,
+                                                const SkPath& path,
+                                                const SkStrokeRec& stroke,
+                                                bool antiAlias) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect devBounds;
+    if (!get_path_dev_bounds(pipelineBuilder, viewMatrix, path, &devBounds)) {
+        return true;
+    }
+
+    SkMatrix invert;
+    if (!viewMatrix.invert(&invert)) {
+        return false;
+    }
+
+    SkIPoint16 loc;
+    if (!this->allocSlot(target, devBounds.width(), devBounds.height(), &loc)) {
+        return false;
+    }
+    const SkIRect slot = SkIRect::MakeXYWH(loc.fX, loc.fY, devBounds.width(), devBounds.height());
+    const SkScalar dx = SkIntToScalar(loc.fX - devBounds.fLeft);
+    const SkScalar dy = SkIntToScalar(loc.fY - devBounds.fTop);
+
+    // Accumulate the path's windings into its slot.
+    CoverageCountAccumulateBatch::Geometry geometry;
+    geometry.fViewMatrix = viewMatrix;
+    geometry.fViewMatrix.postTranslate(dx, dy);
+    geometry.fPath = path;
+    geometry.fSlot = slot;
+
+    GrPipelineBuilder atlasPipelineBuilder;
+    atlasPipelineBuilder.setRenderTarget(fAtlas->asRenderTarget());
+    atlasPipelineBuilder.setXPFactory(
+            GrPorterDuffXPFactory::Create(SkXfermode::kPlus_Mode))->unref();
+
+    SkAutoTUnref<GrBatch> batch(CoverageCountAccumulateBatch::Create(geometry));
+    SkRect slotBounds = SkRect::MakeFromIRect(slot);
+    target->drawBatch(&atlasPipelineBuilder, batch, &slotBounds);
+
+    // Then resolve them into coverage over the path's bounds. Device coords are translated into
+    // the slot, then normalized.
+    GrPipelineBuilder::AutoRestoreFragmentProcessors arfp(pipelineBuilder);
+
+    SkMatrix atlasMatrix;
+    atlasMatrix.setIDiv(fAtlas->width(), fAtlas->height());
+    atlasMatrix.preTranslate(dx, dy);
+    pipelineBuilder->addCoverageProcessor(
+            CoverageCountResolveEffect::Create(fAtlas, atlasMatrix, path.getFillType()))->unref();
+
+    target->drawRect(pipelineBuilder, color, SkMatrix::I(), SkRect::MakeFromIRect(devBounds),
+                     NULL, &invert);
+    return true;
+}
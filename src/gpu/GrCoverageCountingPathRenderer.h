@@ -0,0 +1,67 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrCoverageCountingPathRenderer_DEFINED
+#define GrCoverageCountingPathRenderer_DEFINED
+
+#include "GrPathRenderer.h"
+#include "GrRectanizer.h"
+
+class GrContext;
+class GrTexture;
+
+/**
+ * Draws antialiased fills of arbitrary complexity without touching the stencil buffer. Each path
+ * is first drawn into a slot of a 16-bit float atlas, where every edge adds (or, going up,
+ * subtracts) the fraction of each pixel to its right that it covers. Additive blending sums those
+ * into a fractional winding count per pixel, in a single pass and in any order. A second pass
+ * then draws the path's bounds on the target, turning the counts into coverage with the path's
+ * fill rule.
+ *
+ * The accumulation draws all render to the same atlas with the same pipeline, so the draws for
+ * many paths batch together. Atlas space is not reused until the atlas fills up, at which point
+ * we move on to a new one.
+ */
+class GrCoverageCountingPathRenderer : public GrPathRenderer {
+public:
+    GrCoverageCountingPathRenderer(GrContext* context);
+    virtual ~GrCoverageCountingPathRenderer();
+
+    virtual bool canDrawPath(const GrDrawTarget*,
+                             const GrPipelineBuilder*,
+                             const SkMatrix& viewMatrix,
+                             const SkPath&,
+                             const SkStrokeRec&,
+                             bool antiAlias) const override;
+
+protected:
+    virtual StencilSupport onGetStencilSupport(const GrDrawTarget*,
+                                               const GrPipelineBuilder*,
+                                               const SkPath&,
+                                               const SkStrokeRec&) const override;
+
+    virtual bool onDrawPath(GrDrawTarget*,
+                            GrPipelineBuilder*,
+                            GrColor,
+                            const SkMatrix& viewMatrix,
+                            const SkPath&,
+                            const SkStrokeRec&,
+                            bool antiAlias) override;
+
+private:
+    // Finds room for a width x height slot, moving to a new (cleared) atlas if the current one is
+    // full. Returns false if no atlas could be made.
+    bool allocSlot(GrDrawTarget*, int width, int height, SkIPoint16* loc);
+
+    GrContext*                  fContext;
+    SkAutoTUnref<GrTexture>     fAtlas;
+    SkAutoTDelete<GrRectanizer> fRectanizer;
+
+    typedef GrPathRenderer INHERITED;
+};
+
+#endif
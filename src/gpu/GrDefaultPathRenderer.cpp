@@ -192,24 +192,6 @@ static inline void append_countour_edge_indices(bool hairLine,
     *((*indices)++) = edgeV0Idx + 1;
 }
 
-static inline void add_quad(SkPoint** vert, const SkPoint* base, const SkPoint pts[],
-                            SkScalar srcSpaceTolSqd, SkScalar srcSpaceTol, bool indexed,
-                            bool isHairline, uint16_t subpathIdxStart, int offset, uint16_t** idx) {
-    // first pt of quad is the pt we ended on in previous step
-    uint16_t firstQPtIdx = (uint16_t)(*vert - base) - 1 + offset;
-    uint16_t numPts =  (uint16_t)
-        GrPathUtils::generateQuadraticPoints(
-            pts[0], pts[1], pts[2],
-            srcSpaceTolSqd, vert,
-            GrPathUtils::quadraticPointCount(pts, srcSpaceTol));
-    if (indexed) {
-        for (uint16_t i = 0; i < numPts; ++i) {
-            append_countour_edge_indices(isHairline, subpathIdxStart,
-                                         firstQPtIdx + i, idx);
-        }
-    }
-}
-
 class DefaultPathBatch : public GrBatch {
 public:
     struct Geometry {
@@ -275,19 +257,19 @@ public:
 
         int instanceCount = fGeoData.count();
 
-        // compute number of vertices
+        // flatten the paths, and count their vertices
         int maxVertices = 0;
+        SkSTArray<1, SkAutoTUnref<const GrPathUtils::FlattenedPath>, true> flattened(instanceCount);
 
         // We will use index buffers if we have multiple paths or one path with multiple contours
         bool isIndexed = instanceCount > 1;
         for (int i = 0; i < instanceCount; i++) {
             Geometry& args = fGeoData[i];
 
-            int contourCount;
-            maxVertices += GrPathUtils::worstCasePointCount(args.fPath, &contourCount,
-                                                            args.fTolerance);
+            flattened.push_back().reset(GrPathUtils::flattenPath(args.fPath, args.fTolerance));
+            maxVertices += flattened[i]->fPoints.count();
 
-            isIndexed = isIndexed || contourCount > 1;
+            isIndexed = isIndexed || flattened[i]->fContourStarts.count() > 1;
         }
 
         if (maxVertices == 0 || maxVertices > ((int)SK_MaxU16 + 1)) {
@@ -347,21 +329,16 @@ public:
         int vertexOffset = 0;
         int indexOffset = 0;
         for (int i = 0; i < instanceCount; i++) {
-            Geometry& args = fGeoData[i];
-
             int vertexCnt = 0;
             int indexCnt = 0;
-            if (!this->createGeom(vertices,
-                                  vertexOffset,
-                                  indices,
-                                  indexOffset,
-                                  &vertexCnt,
-                                  &indexCnt,
-                                  args.fPath,
-                                  args.fTolerance,
-                                  isIndexed)) {
-                return;
-            }
+            this->createGeom(vertices,
+                             vertexOffset,
+                             indices,
+                             indexOffset,
+                             &vertexCnt,
+                             &indexCnt,
+                             *flattened[i],
+                             isIndexed);
 
             vertexOffset += vertexCnt;
             indexOffset += indexCnt;
@@ -423,101 +400,39 @@ private:
         return true;
     }
 
-    bool createGeom(void* vertices,
+    void createGeom(void* vertices,
                     size_t vertexOffset,
                     void* indices,
                     size_t indexOffset,
                     int* vertexCnt,
                     int* indexCnt,
-                    const SkPath& path,
-                    SkScalar srcSpaceTol,
+                    const GrPathUtils::FlattenedPath& flattened,
                     bool isIndexed)  {
-        {
-            SkScalar srcSpaceTolSqd = SkScalarMul(srcSpaceTol, srcSpaceTol);
-
-            uint16_t indexOffsetU16 = (uint16_t)indexOffset;
-            uint16_t vertexOffsetU16 = (uint16_t)vertexOffset;
-
-            uint16_t* idxBase = reinterpret_cast<uint16_t*>(indices) + indexOffsetU16;
-            uint16_t* idx = idxBase;
-            uint16_t subpathIdxStart = vertexOffsetU16;
-
-            SkPoint* base = reinterpret_cast<SkPoint*>(vertices) + vertexOffset;
-            SkPoint* vert = base;
-
-            SkPoint pts[4];
+        uint16_t vertexOffsetU16 = (uint16_t)vertexOffset;
+        uint16_t* idxBase = reinterpret_cast<uint16_t*>(indices) + indexOffset;
+        uint16_t* idx = idxBase;
 
-            bool first = true;
-            int subpath = 0;
+        int pointCount = flattened.fPoints.count();
+        memcpy(reinterpret_cast<SkPoint*>(vertices) + vertexOffset, flattened.fPoints.begin(),
+               pointCount * sizeof(SkPoint));
 
-            SkPath::Iter iter(path, false);
-
-            bool done = false;
-            while (!done) {
-                SkPath::Verb verb = iter.next(pts);
-                switch (verb) {
-                    case SkPath::kMove_Verb:
-                        if (!first) {
-                            uint16_t currIdx = (uint16_t) (vert - base) + vertexOffsetU16;
-                            subpathIdxStart = currIdx;
-                            ++subpath;
-                        }
-                        *vert = pts[0];
-                        vert++;
-                        break;
-                    case SkPath::kLine_Verb:
-                        if (isIndexed) {
-                            uint16_t prevIdx = (uint16_t)(vert - base) - 1 + vertexOffsetU16;
-                            append_countour_edge_indices(this->isHairline(), subpathIdxStart,
-                                                         prevIdx, &idx);
-                        }
-                        *(vert++) = pts[1];
-                        break;
-                    case SkPath::kConic_Verb: {
-                        SkScalar weight = iter.conicWeight();
-                        SkAutoConicToQuads converter;
-                        // Converting in src-space, hance the finer tolerance (0.25)
-                        // TODO: find a way to do this in dev-space so the tolerance means something
-                        const SkPoint* quadPts = converter.computeQuads(pts, weight, 0.25f);
-                        for (int i = 0; i < converter.countQuads(); ++i) {
-                            add_quad(&vert, base, quadPts + i*2, srcSpaceTolSqd, srcSpaceTol,
-                                     isIndexed, this->isHairline(), subpathIdxStart,
-                                     (int)vertexOffset, &idx);
-                        }
-                        break;
-                    }
-                    case SkPath::kQuad_Verb:
-                        add_quad(&vert, base, pts, srcSpaceTolSqd, srcSpaceTol, isIndexed,
-                                 this->isHairline(), subpathIdxStart, (int)vertexOffset, &idx);
-                        break;
-                    case SkPath::kCubic_Verb: {
-                        // first pt of cubic is the pt we ended on in previous step
-                        uint16_t firstCPtIdx = (uint16_t)(vert - base) - 1 + vertexOffsetU16;
-                        uint16_t numPts = (uint16_t) GrPathUtils::generateCubicPoints(
-                                        pts[0], pts[1], pts[2], pts[3],
-                                        srcSpaceTolSqd, &vert,
-                                        GrPathUtils::cubicPointCount(pts, srcSpaceTol));
-                        if (isIndexed) {
-                            for (uint16_t i = 0; i < numPts; ++i) {
-                                append_countour_edge_indices(this->isHairline(), subpathIdxStart,
-                                                             firstCPtIdx + i, &idx);
-                            }
-                        }
-                        break;
-                    }
-                    case SkPath::kClose_Verb:
-                        break;
-                    case SkPath::kDone_Verb:
-                        done = true;
+        if (isIndexed) {
+            // Every point after the first of a contour ends an edge from the point before it.
+            int contourCount = flattened.fContourStarts.count();
+            for (int contour = 0; contour < contourCount; ++contour) {
+                int start = flattened.fContourStarts[contour];
+                int end = contour + 1 < contourCount ? flattened.fContourStarts[contour + 1]
+                                                     : pointCount;
+                uint16_t subpathIdxStart = (uint16_t)start + vertexOffsetU16;
+                for (int i = start + 1; i < end; ++i) {
+                    append_countour_edge_indices(this->isHairline(), subpathIdxStart,
+                                                 (uint16_t)(i - 1) + vertexOffsetU16, &idx);
                 }
-                first = false;
             }
-
-            *vertexCnt = static_cast<int>(vert - base);
-            *indexCnt = static_cast<int>(idx - idxBase);
-
         }
-        return true;
+
+        *vertexCnt = pointCount;
+        *indexCnt = static_cast<int>(idx - idxBase);
     }
 
     GrColor color() const { return fBatch.fColor; }
@@ -40,6 +40,10 @@ static const int kMediumDFFontSize = 72;
 static const int kMediumDFFontLimit = 72;
 static const int kLargeDFFontSize = 162;
 
+// How far, in distance field texels, a halo may reach past the glyph outlines. The fields are
+// padded by SK_DistanceFieldPad texels, and the edge of the halo needs one for antialiasing.
+static const int kMaxHaloDistance = SK_DistanceFieldPad - 1;
+
 static const int kVerticesPerGlyph = 4;
 static const int kIndicesPerGlyph = 6;
 
@@ -64,6 +68,8 @@ GrDistanceFieldTextContext::GrDistanceFieldTextContext(GrContext* context,
     fEffectTextureUniqueID = SK_InvalidUniqueID;
     fEffectColor = GrColor_ILLEGAL;
     fEffectFlags = kInvalid_DistanceFieldEffectFlag;
+    fEffectHaloDistance = 0;
+    fHaloDistance = 0;
 
     fVertices = NULL;
     fCurrVertex = 0;
@@ -178,6 +184,18 @@ GrDistanceFieldTextContext::~GrDistanceFieldTextContext() {
     fDistanceAdjustTable = NULL;
 }
 
+// LCD text keeps single channel fields, since it already samples three times per pixel
+static bool use_multi_channel(const GrContext* context, const SkPaint& skPaint) {
+    return context->getOptions().fMultiChannelDistanceFieldText && !skPaint.isLCDRenderText();
+}
+
+// Color glyphs have no outline, so they keep the single channel style, which sends them to
+// the fallback
+static GrGlyph::MaskStyle mask_style(const SkGlyph& glyph, bool useMultiChannel) {
+    return useMultiChannel && SkMask::kARGB32_Format != glyph.fMaskFormat ?
+           GrGlyph::kMultiChannelDistance_MaskStyle : GrGlyph::kDistance_MaskStyle;
+}
+
 bool GrDistanceFieldTextContext::canDraw(const GrRenderTarget* rt,
                                          const GrClip& clip,
                                          const GrPaint& paint,
@@ -191,8 +209,10 @@ bool GrDistanceFieldTextContext::canDraw(const GrRenderTarget* rt,
     SkScalar maxScale = viewMatrix.getMaxScale();
     SkScalar scaledTextSize = maxScale*skPaint.getTextSize();
     // Hinted text looks far better at small resolutions
-    // Scaling up beyond 2x yields undesireable artifacts
-    if (scaledTextSize < kMinDFFontSize || scaledTextSize > 2*kLargeDFFontSize) {
+    // Scaling up beyond 2x yields undesireable artifacts, except with multi-channel fields,
+    // which keep their corners
+    SkScalar maxScaleUp = use_multi_channel(fContext, skPaint) ? 4 : 2;
+    if (scaledTextSize < kMinDFFontSize || scaledTextSize > maxScaleUp*kLargeDFFontSize) {
         return false;
     }
 
@@ -216,6 +236,25 @@ bool GrDistanceFieldTextContext::canDraw(const GrRenderTarget* rt,
     return true;
 }
 
+// The size of the distance fields used for text of this paint's size, drawn with this matrix
+static int df_font_size(const SkPaint& skPaint, const SkMatrix& viewMatrix) {
+    SkScalar maxScale = viewMatrix.getMaxScale();
+    SkScalar scaledTextSize = skPaint.getTextSize();
+    // if we have non-unity scale, we need to choose our base text size
+    // based on the SkPaint's text size multiplied by the max scale factor
+    // TODO: do we need to do this if we're scaling down (i.e. maxScale < 1)?
+    if (maxScale > 0 && !SkScalarNearlyEqual(maxScale, SK_Scalar1)) {
+        scaledTextSize *= maxScale;
+    }
+
+    if (scaledTextSize <= kSmallDFFontLimit) {
+        return kSmallDFFontSize;
+    } else if (scaledTextSize <= kMediumDFFontLimit) {
+        return kMediumDFFontSize;
+    }
+    return kLargeDFFontSize;
+}
+
 inline void GrDistanceFieldTextContext::init(GrRenderTarget* rt, const GrClip& clip,
                                              const GrPaint& paint, const SkPaint& skPaint,
                                              const SkIRect& regionClipBounds) {
@@ -223,49 +262,38 @@ inline void GrDistanceFieldTextContext::init(GrRenderTarget* rt, const GrClip& c
 
     fStrike = NULL;
 
-    const SkMatrix& ctm = fViewMatrix;
-
     // getMaxScale doesn't support perspective, so neither do we at the moment
-    SkASSERT(!ctm.hasPerspective());
-    SkScalar maxScale = ctm.getMaxScale();
+    SkASSERT(!fViewMatrix.hasPerspective());
     SkScalar textSize = fSkPaint.getTextSize();
-    SkScalar scaledTextSize = textSize;
-    // if we have non-unity scale, we need to choose our base text size
-    // based on the SkPaint's text size multiplied by the max scale factor
-    // TODO: do we need to do this if we're scaling down (i.e. maxScale < 1)?
-    if (maxScale > 0 && !SkScalarNearlyEqual(maxScale, SK_Scalar1)) {
-        scaledTextSize *= maxScale;
-    }
+    int dfFontSize = df_font_size(fSkPaint, fViewMatrix);
 
     fVertices = NULL;
     fCurrVertex = 0;
     fAllocVertexCount = 0;
     fTotalVertexCount = 0;
 
-    if (scaledTextSize <= kSmallDFFontLimit) {
-        fTextRatio = textSize / kSmallDFFontSize;
-        fSkPaint.setTextSize(SkIntToScalar(kSmallDFFontSize));
+    fTextRatio = textSize / dfFontSize;
+    fSkPaint.setTextSize(SkIntToScalar(dfFontSize));
 #if DEBUG_TEXT_SIZE
+    if (kSmallDFFontSize == dfFontSize) {
         fSkPaint.setColor(SkColorSetARGB(0xFF, 0x00, 0x00, 0x7F));
         fPaint.setColor(GrColorPackRGBA(0x00, 0x00, 0x7F, 0xFF));
-#endif
-    } else if (scaledTextSize <= kMediumDFFontLimit) {
-        fTextRatio = textSize / kMediumDFFontSize;
-        fSkPaint.setTextSize(SkIntToScalar(kMediumDFFontSize));
-#if DEBUG_TEXT_SIZE
+    } else if (kMediumDFFontSize == dfFontSize) {
         fSkPaint.setColor(SkColorSetARGB(0xFF, 0x00, 0x3F, 0x00));
         fPaint.setColor(GrColorPackRGBA(0x00, 0x3F, 0x00, 0xFF));
-#endif
     } else {
-        fTextRatio = textSize / kLargeDFFontSize;
-        fSkPaint.setTextSize(SkIntToScalar(kLargeDFFontSize));
-#if DEBUG_TEXT_SIZE
         fSkPaint.setColor(SkColorSetARGB(0xFF, 0x7F, 0x00, 0x00));
         fPaint.setColor(GrColorPackRGBA(0x7F, 0x00, 0x00, 0xFF));
+    }
 #endif
+
+    // A halo is dilated from the text's own fields, so look them up as the text does.
+    if (fHaloDistance > 0) {
+        fSkPaint.setStyle(SkPaint::kFill_Style);
     }
 
     fUseLCDText = fSkPaint.isLCDRenderText();
+    fUseMultiChannel = use_multi_channel(fContext, fSkPaint);
 
     fSkPaint.setLCDRenderText(false);
     fSkPaint.setAutohinted(false);
@@ -385,7 +413,7 @@ void GrDistanceFieldTextContext::onDrawPosText(GrRenderTarget* rt, const GrClip&
                 if (!this->appendGlyph(GrGlyph::Pack(glyph.getGlyphID(),
                                                      glyph.getSubXFixed(),
                                                      glyph.getSubYFixed(),
-                                                     GrGlyph::kDistance_MaskStyle),
+                                                     mask_style(glyph, fUseMultiChannel)),
                                        x, y, fontScaler)) {
                     // couldn't append, send to fallback
                     fallbackTxt.push_back_n(SkToInt(text-lastText), lastText);
@@ -415,7 +443,7 @@ void GrDistanceFieldTextContext::onDrawPosText(GrRenderTarget* rt, const GrClip&
                 if (!this->appendGlyph(GrGlyph::Pack(glyph.getGlyphID(),
                                                      glyph.getSubXFixed(),
                                                      glyph.getSubYFixed(),
-                                                     GrGlyph::kDistance_MaskStyle),
+                                                     mask_style(glyph, fUseMultiChannel)),
                                        x - advanceX, y - advanceY, fontScaler)) {
                     // couldn't append, send to fallback
                     fallbackTxt.push_back_n(SkToInt(text-lastText), lastText);
@@ -439,6 +467,38 @@ void GrDistanceFieldTextContext::onDrawPosText(GrRenderTarget* rt, const GrClip&
     }
 }
 
+bool GrDistanceFieldTextContext::onDrawPosTextHalo(GrRenderTarget* rt, const GrClip& clip,
+                                                   const GrPaint& haloPaint,
+                                                   const SkPaint& skHaloPaint,
+                                                   const GrPaint& paint,
+                                                   const SkPaint& skPaint,
+                                                   const SkMatrix& viewMatrix,
+                                                   const char text[], size_t byteLength,
+                                                   const SkScalar pos[], int scalarsPerPosition,
+                                                   const SkPoint& offset,
+                                                   const SkIRect& regionClipBounds) {
+    // LCD text has a field per subpixel, which a halo of one color can't use
+    if (skPaint.isLCDRenderText()) {
+        return false;
+    }
+
+    // The halo is the text's own distance field with its edge moved out, as long as it stays
+    // within the field's padding.
+    SkScalar textRatio = skPaint.getTextSize() / df_font_size(skPaint, viewMatrix);
+    SkScalar haloDistance = SkScalarHalf(skHaloPaint.getStrokeWidth()) / textRatio;
+    if (!(haloDistance > 0) || haloDistance > kMaxHaloDistance) {
+        return false;
+    }
+
+    fHaloDistance = haloDistance;
+    this->onDrawPosText(rt, clip, haloPaint, skHaloPaint, viewMatrix, text, byteLength,
+                        pos, scalarsPerPosition, offset, regionClipBounds);
+    fHaloDistance = 0;
+    this->onDrawPosText(rt, clip, paint, skPaint, viewMatrix, text, byteLength,
+                        pos, scalarsPerPosition, offset, regionClipBounds);
+    return true;
+}
+
 static inline GrColor skcolor_to_grcolor_nopremultiply(SkColor c) {
     unsigned r = SkColorGetR(c);
     unsigned g = SkColorGetG(c);
@@ -483,11 +543,13 @@ void GrDistanceFieldTextContext::setupCoverageEffect(const SkColor& filteredColo
     kRectToRect_DistanceFieldEffectFlag : 0;
     bool useBGR = SkPixelGeometryIsBGR(fDeviceProperties.pixelGeometry());
     flags |= fUseLCDText && useBGR ? kBGR_DistanceFieldEffectFlag : 0;
+    flags |= fUseMultiChannel ? kMultiChannel_DistanceFieldEffectFlag : 0;
     
     // see if we need to create a new effect
     if (textureUniqueID != fEffectTextureUniqueID ||
         filteredColor != fEffectColor ||
         flags != fEffectFlags ||
+        fHaloDistance != fEffectHaloDistance ||
         !fCachedGeometryProcessor->viewMatrix().cheapEqualTo(fViewMatrix)) {
         GrColor color = fPaint.getColor();
         if (fUseLCDText) {
@@ -516,25 +578,23 @@ void GrDistanceFieldTextContext::setupCoverageEffect(const SkColor& filteredColo
             U8CPU lum = SkColorSpaceLuminance::computeLuminance(fDeviceProperties.gamma(),
                                                                 filteredColor);
             float correction = fDistanceAdjustTable[lum >> kDistanceAdjustLumShift];
-            fCachedGeometryProcessor.reset(GrDistanceFieldTextureEffect::Create(color,
-                                                                                fViewMatrix,
-                                                                                fCurrTexture,
-                                                                                params,
-                                                                                correction,
-                                                                                flags,
-                                                                                opaque));
 #else
+            float correction = 0;
+#endif
+            // a halo moves the edge out
+            correction -= fHaloDistance;
             fCachedGeometryProcessor.reset(GrDistanceFieldTextureEffect::Create(color,
                                                                                 fViewMatrix,
                                                                                 fCurrTexture,
                                                                                 params,
+                                                                                correction,
                                                                                 flags,
                                                                                 opaque));
-#endif
         }
         fEffectTextureUniqueID = textureUniqueID;
         fEffectColor = filteredColor;
         fEffectFlags = flags;
+        fEffectHaloDistance = fHaloDistance;
     }
     
 }
@@ -594,14 +654,19 @@ bool GrDistanceFieldTextContext::appendGlyph(GrGlyph::PackedID packed,
     }
 
     // fallback to color glyph support
-    if (kA8_GrMaskFormat != glyph->fMaskFormat) {
+    GrMaskFormat expectedFormat =
+            GrGlyph::kMultiChannelDistance_MaskStyle == GrGlyph::UnpackMaskStyle(packed) ?
+            kARGB_GrMaskFormat : kA8_GrMaskFormat;
+    if (expectedFormat != glyph->fMaskFormat) {
         return false;
     }
 
-    SkScalar dx = SkIntToScalar(glyph->fBounds.fLeft + SK_DistanceFieldInset);
-    SkScalar dy = SkIntToScalar(glyph->fBounds.fTop + SK_DistanceFieldInset);
-    SkScalar width = SkIntToScalar(glyph->fBounds.width() - 2*SK_DistanceFieldInset);
-    SkScalar height = SkIntToScalar(glyph->fBounds.height() - 2*SK_DistanceFieldInset);
+    // A halo reaches past the glyph, so it gives its quad more of the field's padding.
+    int inset = SkTMax(SK_DistanceFieldInset - SkScalarCeilToInt(fHaloDistance), 0);
+    SkScalar dx = SkIntToScalar(glyph->fBounds.fLeft + inset);
+    SkScalar dy = SkIntToScalar(glyph->fBounds.fTop + inset);
+    SkScalar width = SkIntToScalar(glyph->fBounds.width() - 2*inset);
+    SkScalar height = SkIntToScalar(glyph->fBounds.height() - 2*inset);
 
     SkScalar scale = fTextRatio;
     dx *= scale;
@@ -650,6 +715,13 @@ bool GrDistanceFieldTextContext::appendGlyph(GrGlyph::PackedID packed,
             tmpPath.transform(ctm);
 
             GrStrokeInfo strokeInfo(SkStrokeRec::kFill_InitStyle);
+            if (fHaloDistance > 0) {
+                // stroke the outline as the halo looper would have
+                SkStrokeRec* stroke = strokeInfo.getStrokeRecPtr();
+                stroke->setStrokeStyle(2 * fHaloDistance * fTextRatio, true);
+                stroke->setStrokeParams(SkPaint::kButt_Cap, SkPaint::kRound_Join,
+                                        fSkPaint.getStrokeMiter());
+            }
             fContext->drawPath(fRenderTarget, fClip, fPaint, fViewMatrix, tmpPath, strokeInfo);
 
             // remove this glyph from the vertices we need to allocate
@@ -683,10 +755,10 @@ bool GrDistanceFieldTextContext::appendGlyph(GrGlyph::PackedID packed,
 
     fVertexBounds.joinNonEmptyArg(glyphRect);
 
-    int u0 = glyph->fAtlasLocation.fX + SK_DistanceFieldInset;
-    int v0 = glyph->fAtlasLocation.fY + SK_DistanceFieldInset;
-    int u1 = u0 + glyph->fBounds.width() - 2*SK_DistanceFieldInset;
-    int v1 = v0 + glyph->fBounds.height() - 2*SK_DistanceFieldInset;
+    int u0 = glyph->fAtlasLocation.fX + inset;
+    int v0 = glyph->fAtlasLocation.fY + inset;
+    int u1 = u0 + glyph->fBounds.width() - 2*inset;
+    int v1 = v0 + glyph->fBounds.height() - 2*inset;
 
     size_t vertSize = get_vertex_stride(useColorVerts);
     intptr_t vertex = reinterpret_cast<intptr_t>(fVertices) + vertSize * fCurrVertex;
@@ -34,6 +34,7 @@ private:
     GrTextStrike*                      fStrike;
     SkScalar                           fTextRatio;
     bool                               fUseLCDText;
+    bool                               fUseMultiChannel;
     bool                               fEnableDFRendering;
     SkAutoTUnref<GrGeometryProcessor>  fCachedGeometryProcessor;
     SkScalar*                          fDistanceAdjustTable;
@@ -41,6 +42,9 @@ private:
     uint32_t                           fEffectTextureUniqueID;
     SkColor                            fEffectColor;
     uint32_t                           fEffectFlags;
+    SkScalar                           fEffectHaloDistance;
+    // While drawing a halo, how far (in distance field texels) it reaches past the glyphs
+    SkScalar                           fHaloDistance;
     void*                              fVertices;
     int                                fCurrVertex;
     int                                fAllocVertexCount;
@@ -64,6 +68,13 @@ private:
                        const char text[], size_t byteLength,
                        const SkScalar pos[], int scalarsPerPosition,
                        const SkPoint& offset, const SkIRect& regionClipBounds) override;
+    bool onDrawPosTextHalo(GrRenderTarget*, const GrClip&,
+                           const GrPaint& haloPaint, const SkPaint& skHaloPaint,
+                           const GrPaint&, const SkPaint&,
+                           const SkMatrix& viewMatrix,
+                           const char text[], size_t byteLength,
+                           const SkScalar pos[], int scalarsPerPosition,
+                           const SkPoint& offset, const SkIRect& regionClipBounds) override;
 
     void init(GrRenderTarget*, const GrClip&, const GrPaint&, const SkPaint&,
               const SkIRect& regionClipBounds);
@@ -35,6 +35,8 @@ GrDrawTarget::DrawInfo& GrDrawTarget::DrawInfo::operator =(const DrawInfo& di) {
     fVerticesPerInstance    = di.fVerticesPerInstance;
     fIndicesPerInstance     = di.fIndicesPerInstance;
 
+    fHWInstanceCount        = di.fHWInstanceCount;
+
     if (di.fDevBounds) {
         SkASSERT(di.fDevBounds == &di.fDevBoundsStorage);
         fDevBoundsStorage = di.fDevBoundsStorage;
@@ -1021,7 +1023,8 @@ GrDrawTarget::PipelineInfo::PipelineInfo(GrPipelineBuilder* pipelineBuilder,
                                          const SkRect* devBounds,
                                          GrDrawTarget* target)
     : fPipelineBuilder(pipelineBuilder)
-    , fScissor(scissor) {
+    , fScissor(scissor)
+    , fDevBounds(devBounds) {
     fColorPOI = fPipelineBuilder->colorProcInfo(primProc);
     fCoveragePOI = fPipelineBuilder->coverageProcInfo(primProc);
     if (!target->setupDstReadIfNecessary(*fPipelineBuilder, fColorPOI, fCoveragePOI,
@@ -1036,7 +1039,8 @@ GrDrawTarget::PipelineInfo::PipelineInfo(GrPipelineBuilder* pipelineBuilder,
                                          const SkRect* devBounds,
                                          GrDrawTarget* target)
     : fPipelineBuilder(pipelineBuilder)
-    , fScissor(scissor) {
+    , fScissor(scissor)
+    , fDevBounds(devBounds) {
     fColorPOI = fPipelineBuilder->colorProcInfo(batch);
     fCoveragePOI = fPipelineBuilder->coverageProcInfo(batch);
     if (!target->setupDstReadIfNecessary(*fPipelineBuilder, fColorPOI, fCoveragePOI,
@@ -1062,6 +1066,7 @@ void GrDrawTargetCaps::reset() {
     fGpuTracingSupport = false;
     fCompressedTexSubImageSupport = false;
     fOversizedStencilSupport = false;
+    fInstancedDrawingSupport = false;
 
     fUseDrawInsteadOfClear = false;
 
@@ -1092,6 +1097,7 @@ GrDrawTargetCaps& GrDrawTargetCaps::operator=(const GrDrawTargetCaps& other) {
     fGpuTracingSupport = other.fGpuTracingSupport;
     fCompressedTexSubImageSupport = other.fCompressedTexSubImageSupport;
     fOversizedStencilSupport = other.fOversizedStencilSupport;
+    fInstancedDrawingSupport = other.fInstancedDrawingSupport;
 
     fUseDrawInsteadOfClear = other.fUseDrawInsteadOfClear;
 
@@ -1128,6 +1134,11 @@ static SkString map_flags_to_string(uint32_t flags) {
             str.append(" full");
         }
         SkDEBUGCODE(flags &= ~GrDrawTargetCaps::kSubset_MapFlag);
+
+        if (GrDrawTargetCaps::kPersistent_MapFlag & flags) {
+            str.append(" persistent");
+        }
+        SkDEBUGCODE(flags &= ~GrDrawTargetCaps::kPersistent_MapFlag);
     }
     SkASSERT(0 == flags); // Make sure we handled all the flags.
     return str;
@@ -1174,6 +1185,7 @@ SkString GrDrawTargetCaps::dump() const {
     r.appendf("Gpu Tracing Support                : %s\n", gNY[fGpuTracingSupport]);
     r.appendf("Compressed Update Support          : %s\n", gNY[fCompressedTexSubImageSupport]);
     r.appendf("Oversized Stencil Support          : %s\n", gNY[fOversizedStencilSupport]);
+    r.appendf("Instanced Drawing Support          : %s\n", gNY[fInstancedDrawingSupport]);
     r.appendf("Draw Instead of Clear [workaround] : %s\n", gNY[fUseDrawInsteadOfClear]);
 
     r.appendf("Max Texture Size                   : %d\n", fMaxTextureSize);
@@ -419,12 +419,6 @@ public:
                         const SkIRect& srcRect,
                         const SkIPoint& dstPoint);
 
-    /**
-     * Release any resources that are cached but not currently in use. This
-     * is intended to give an application some recourse when resources are low.
-     */
-    virtual void purgeResources() {};
-
     ////////////////////////////////////////////////////////////////////////////
 
     class AutoReleaseGeometry : public ::SkNoncopyable {
@@ -496,7 +490,7 @@ public:
      */
     class DrawInfo {
     public:
-        DrawInfo() { fDevBounds = NULL; }
+        DrawInfo() : fHWInstanceCount(0) { fDevBounds = NULL; }
         DrawInfo(const DrawInfo& di) { (*this) = di; }
         DrawInfo& operator =(const DrawInfo& di);
 
@@ -518,6 +512,16 @@ public:
         void setIndicesPerInstance(int indicesPerI) { fIndicesPerInstance = indicesPerI; }
         void setInstanceCount(int instanceCount) { fInstanceCount = instanceCount; }
 
+        /**
+         * Unlike the instances above, which repeat an index pattern, these are instanced by the
+         * hardware.  When hwInstanceCount() > 0 the vertex buffer holds one record per instance,
+         * starting at startVertex(), and each instance draws vertexCount() vertices.  All of the
+         * primitive processor's attributes are per instance; its vertex shader tells the
+         * vertices apart by their vertex ID.  Requires instancedDrawingSupport() and no indices.
+         */
+        int hwInstanceCount() const { return fHWInstanceCount; }
+        void setHWInstanceCount(int instanceCount) { fHWInstanceCount = instanceCount; }
+
         bool isIndexed() const { return fIndexCount > 0; }
 #ifdef SK_DEBUG
         bool isInstanced() const; // this version is longer because of asserts
@@ -560,6 +564,8 @@ public:
         int                     fVerticesPerInstance;
         int                     fIndicesPerInstance;
 
+        int                     fHWInstanceCount;
+
         SkRect                  fDevBoundsStorage;
         SkRect*                 fDevBounds;
 
@@ -660,6 +666,10 @@ protected:
         bool willBlendWithDst(const GrPrimitiveProcessor* primProc) const {
             return fPipelineBuilder->willBlendWithDst(primProc);
         }
+
+        // Conservative device space bounds of the draw, or NULL if unknown.
+        const SkRect* devBounds() const { return fDevBounds; }
+
     private:
         friend class GrDrawTarget;
 
@@ -667,6 +677,7 @@ protected:
 
         GrPipelineBuilder*      fPipelineBuilder;
         GrScissorState*         fScissor;
+        const SkRect*           fDevBounds;
         GrProcOptInfo           fColorPOI; 
         GrProcOptInfo           fCoveragePOI; 
         GrDeviceCoordTexture    fDstCopy;
@@ -834,16 +845,6 @@ public:
      */
     virtual void clearStencilClip(const SkIRect& rect, bool insideClip, GrRenderTarget* = NULL) = 0;
 
-    /**
-     * Release any resources that are cached but not currently in use. This
-     * is intended to give an application some recourse when resources are low.
-     */
-    void purgeResources() override {
-        // The clip mask manager can rebuild all its clip masks so just
-        // get rid of them all.
-        fClipMaskManager.purgeResources();
-    };
-
 protected:
     GrClipMaskManager           fClipMaskManager;
 
@@ -86,6 +86,11 @@ public:
 #endif
     bool compressedTexSubImageSupport() const { return fCompressedTexSubImageSupport; }
     bool oversizedStencilSupport() const { return fOversizedStencilSupport; }
+    /**
+     * Can a draw be instanced in hardware, with per-instance vertex attributes and the vertex
+     * shader expanding each instance from its vertex ID?  See DrawInfo::setHWInstanceCount().
+     */
+    bool instancedDrawingSupport() const { return fInstancedDrawingSupport; }
 
     bool useDrawInsteadOfClear() const { return fUseDrawInsteadOfClear; }
 
@@ -99,6 +104,10 @@ public:
         kCanMap_MapFlag  = 0x1,       //<! The resource can be mapped. Must be set for any of
                                       //   the other flags to have meaning.k
         kSubset_MapFlag  = 0x2,       //<! The resource can be partially mapped.
+        kPersistent_MapFlag = 0x4,    //<! Dynamic buffers stay mapped for their lifetime, so
+                                      //   map() and unmap() are free, writes are coherent with
+                                      //   the GPU, and the caller must fence before rewriting
+                                      //   memory the GPU may still be reading.
     };
 
     uint32_t mapBufferFlags() const { return fMapBufferFlags; }
@@ -157,6 +166,7 @@ protected:
     bool fGpuTracingSupport             : 1;
     bool fCompressedTexSubImageSupport  : 1;
     bool fOversizedStencilSupport       : 1;
+    bool fInstancedDrawingSupport       : 1;
     // Driver workaround
     bool fUseDrawInsteadOfClear         : 1;
 
@@ -32,6 +32,8 @@
 // 1/(3*width)
 // only used for distance fields, which are A8
 #define GR_FONT_ATLAS_LCD_DELTA        "0.001302083"//"0.000162760417"
+
+#define GR_FONT_ATLAS_MAX_PAGES        1//4
 #else
 #define GR_FONT_ATLAS_TEXTURE_WIDTH    1024
 #define GR_FONT_ATLAS_A8_TEXTURE_WIDTH 2048
@@ -53,5 +55,9 @@
 // 1/(3*width)
 // only used for distance fields, which are A8
 #define GR_FONT_ATLAS_LCD_DELTA        "0.000162760417"
+
+// how many textures of the sizes above a batch font cache atlas may grow to, before it has to
+// evict glyphs that are still waiting to be drawn
+#define GR_FONT_ATLAS_MAX_PAGES        4
 #endif
 #endif
@@ -84,6 +84,10 @@ const GrFontDescKey* GrFontScaler::getKey() {
 }
 
 GrMaskFormat GrFontScaler::getPackedGlyphMaskFormat(GrGlyph::PackedID packed) const {
+    // Multi-channel distance fields keep their three distances in the 8888 atlas.
+    if (GrGlyph::kMultiChannelDistance_MaskStyle == GrGlyph::UnpackMaskStyle(packed)) {
+        return kARGB_GrMaskFormat;
+    }
     const SkGlyph& glyph = fStrike->getGlyphIDMetrics(GrGlyph::UnpackID(packed),
                                                       GrGlyph::UnpackFixedX(packed),
                                                       GrGlyph::UnpackFixedY(packed));
@@ -203,12 +207,28 @@ bool GrFontScaler::getPackedGlyphDFImage(GrGlyph::PackedID packed,
                                                       GrGlyph::UnpackFixedY(packed));
     SkASSERT(glyph.fWidth + 2*SK_DistanceFieldPad == width);
     SkASSERT(glyph.fHeight + 2*SK_DistanceFieldPad == height);
+    SkASSERT(dst);
+    if (GrGlyph::kMultiChannelDistance_MaskStyle == GrGlyph::UnpackMaskStyle(packed)) {
+        // color glyphs have no outline to measure
+        if (SkMask::kARGB32_Format == glyph.fMaskFormat) {
+            return false;
+        }
+        const SkPath* path = fStrike->findPath(glyph);
+        if (NULL == path) {
+            return false;
+        }
+        // make the distance field from the outline, placed over the image it would cover
+        SkPath imagePath;
+        path->offset(-SkIntToScalar(glyph.fLeft), -SkIntToScalar(glyph.fTop), &imagePath);
+        return SkGenerateMultiChannelDistanceFieldFromPath((SkPMColor*)dst, imagePath,
+                                                           glyph.fWidth, glyph.fHeight);
+    }
+
     const void* image = fStrike->findImage(glyph);
     if (NULL == image) {
         return false;
     }
     // now generate the distance field
-    SkASSERT(dst);
     SkMask::Format maskFormat = static_cast<SkMask::Format>(glyph.fMaskFormat);
     if (SkMask::kA8_Format == maskFormat) {
         // make the distance field from the image
@@ -26,7 +26,8 @@ class GrPlot;
 struct GrGlyph {
     enum MaskStyle {
         kCoverage_MaskStyle,
-        kDistance_MaskStyle
+        kDistance_MaskStyle,
+        kMultiChannelDistance_MaskStyle
     };
     
     typedef uint32_t PackedID;
@@ -72,8 +73,7 @@ struct GrGlyph {
     static inline PackedID Pack(uint16_t glyphID, SkFixed x, SkFixed y, MaskStyle ms) {
         x = ExtractSubPixelBitsFromFixed(x);
         y = ExtractSubPixelBitsFromFixed(y);
-        int dfFlag = (ms == kDistance_MaskStyle) ? 0x1 : 0x0;
-        return (dfFlag << 20) | (x << 18) | (y << 16) | glyphID;
+        return (ms << 20) | (x << 18) | (y << 16) | glyphID;
     }
 
     static inline SkFixed UnpackFixedX(PackedID packed) {
@@ -85,9 +85,13 @@ struct GrGlyph {
     }
 
     static inline MaskStyle UnpackMaskStyle(PackedID packed) {
-        return ((packed >> 20) & 1) ? kDistance_MaskStyle : kCoverage_MaskStyle;
+        return static_cast<MaskStyle>((packed >> 20) & 3);
     }
     
+    static inline bool IsDistanceField(PackedID packed) {
+        return kCoverage_MaskStyle != UnpackMaskStyle(packed);
+    }
+
     static inline uint16_t UnpackID(PackedID packed) {
         return (uint16_t)packed;
     }
@@ -210,10 +210,10 @@ bool GrGpu::readPixels(GrRenderTarget* target,
 bool GrGpu::writeTexturePixels(GrTexture* texture,
                                int left, int top, int width, int height,
                                GrPixelConfig config, const void* buffer,
-                               size_t rowBytes) {
+                               size_t rowBytes, bool async) {
     this->handleDirtyContext();
     if (this->onWriteTexturePixels(texture, left, top, width, height,
-                                   config, buffer, rowBytes)) {
+                                   config, buffer, rowBytes, async)) {
         fStats.incTextureUploads();
         return true;
     }
@@ -294,6 +294,7 @@ const GrIndexBuffer* GrGpu::getQuadIndexBuffer() const {
 
 void GrGpu::draw(const DrawArgs& args, const GrDrawTarget::DrawInfo& info) {
     this->handleDirtyContext();
+    fStats.incDraws();
     this->onDraw(args, info);
 }
 
@@ -235,11 +235,30 @@ public:
      * @param buffer        memory to read pixels from
      * @param rowBytes      number of bytes between consecutive rows. Zero
      *                      means rows are tightly packed.
+     * @param async         if true the backend may stage the pixels in a buffer of its own and
+     *                      return before the texture has been updated, rather than block until
+     *                      the 3D API is done with buffer.  Either way buffer may be reused as
+     *                      soon as this returns.
      */
     bool writeTexturePixels(GrTexture* texture,
                             int left, int top, int width, int height,
                             GrPixelConfig config, const void* buffer,
-                            size_t rowBytes);
+                            size_t rowBytes, bool async = false);
+
+    /**
+     * Inserts a fence into the 3D API's command stream, after everything issued so far.  Returns
+     * 0 if the backend can't fence, in which case waitFence() waits for all work to finish.
+     * Every fence returned must be passed to deleteFence().
+     */
+    virtual GrFence insertFence() = 0;
+
+    /**
+     * Waits up to timeoutNs nanoseconds for the commands before fence to complete.  Returns true
+     * if they did.
+     */
+    virtual bool waitFence(GrFence fence, uint64_t timeoutNs) = 0;
+
+    virtual void deleteFence(GrFence fence) = 0;
 
     /**
      * Clear the passed in render target. Ignores the draw state and clip. Clears the whole thing if
@@ -359,6 +378,7 @@ public:
             fTextureCreates = 0;
             fTextureUploads = 0;
             fStencilBufferCreates = 0;
+            fDraws = 0;
         }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
@@ -370,6 +390,8 @@ public:
         int textureUploads() const { return fTextureUploads; }
         void incTextureUploads() { fTextureUploads++; }
         void incStencilBufferCreates() { fStencilBufferCreates++; }
+        int draws() const { return fDraws; }
+        void incDraws() { fDraws++; }
         void dump(SkString*);
 
     private:
@@ -378,6 +400,7 @@ public:
         int fTextureCreates;
         int fTextureUploads;
         int fStencilBufferCreates;
+        int fDraws;
 #else
         void dump(SkString*) {};
         void incRenderTargetBinds() {}
@@ -385,6 +408,7 @@ public:
         void incTextureCreates() {}
         void incTextureUploads() {}
         void incStencilBufferCreates() {}
+        void incDraws() {}
 #endif
     };
 
@@ -480,7 +504,7 @@ private:
     virtual bool onWriteTexturePixels(GrTexture* texture,
                                       int left, int top, int width, int height,
                                       GrPixelConfig config, const void* buffer,
-                                      size_t rowBytes) = 0;
+                                      size_t rowBytes, bool async) = 0;
 
     // overridden by backend-specific derived class to perform the resolve
     virtual void onResolveRenderTarget(GrRenderTarget* target) = 0;
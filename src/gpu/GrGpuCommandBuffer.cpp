@@ -0,0 +1,408 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrGpuCommandBuffer.h"
+
+#include "GrTraceMarker.h"
+
+struct GrGpuCommandBuffer::Command : ::SkNoncopyable {
+    enum Type {
+        kBindProgram_Type,
+        kDraw_Type,
+        kStencilPath_Type,
+        kDrawPath_Type,
+        kDrawPaths_Type,
+        kClear_Type,
+        kClearStencilClip_Type,
+        kCopySurface_Type,
+        kUpload_Type,
+        kPushTraceMarker_Type,
+        kPopTraceMarker_Type,
+    };
+
+    Command(Type type) : fType(type) {}
+    virtual ~Command() {}
+
+    Type fType;
+};
+
+struct GrGpuCommandBuffer::BindProgram : public Command {
+    BindProgram() : Command(kBindProgram_Type) {}
+
+    const GrPrimitiveProcessor* fPrimitiveProcessor;
+    const GrPipeline*           fPipeline;
+    const GrProgramDesc*        fDesc;
+    const GrBatchTracker*       fBatchTracker;
+};
+
+struct GrGpuCommandBuffer::Draw : public Command {
+    Draw(const GrDrawTarget::DrawInfo& info) : Command(kDraw_Type), fInfo(info) {}
+
+    GrDrawTarget::DrawInfo fInfo;
+};
+
+struct GrGpuCommandBuffer::StencilPath : public Command {
+    StencilPath() : Command(kStencilPath_Type) {}
+
+    const GrPath*     fPath;
+    GrRenderTarget*   fRenderTarget;
+    bool              fUseHWAA;
+    SkMatrix          fViewMatrix;
+    GrStencilSettings fStencil;
+    GrScissorState    fScissor;
+};
+
+struct GrGpuCommandBuffer::DrawPath : public Command {
+    DrawPath() : Command(kDrawPath_Type) {}
+
+    const GrPath*     fPath;
+    GrStencilSettings fStencilSettings;
+};
+
+struct GrGpuCommandBuffer::DrawPaths : public Command {
+    DrawPaths() : Command(kDrawPaths_Type) {}
+
+    const GrPathRange*              fPathRange;
+    const void*                     fIndices;
+    GrDrawTarget::PathIndexType     fIndexType;
+    const float*                    fTransforms;
+    GrDrawTarget::PathTransformType fTransformType;
+    int                             fCount;
+    GrStencilSettings               fStencilSettings;
+};
+
+// This is also used to record a discard by setting the color to GrColor_ILLEGAL
+struct GrGpuCommandBuffer::Clear : public Command {
+    Clear() : Command(kClear_Type) {}
+
+    GrRenderTarget* fRenderTarget;
+    SkIRect         fRect;
+    bool            fHasRect;
+    GrColor         fColor;
+    bool            fCanIgnoreRect;
+};
+
+struct GrGpuCommandBuffer::ClearStencilClip : public Command {
+    ClearStencilClip() : Command(kClearStencilClip_Type) {}
+
+    GrRenderTarget* fRenderTarget;
+    SkIRect         fRect;
+    bool            fInsideClip;
+};
+
+struct GrGpuCommandBuffer::CopySurface : public Command {
+    CopySurface() : Command(kCopySurface_Type) {}
+
+    GrSurface* fDst;
+    GrSurface* fSrc;
+    SkIRect    fSrcRect;
+    SkIPoint   fDstPoint;
+};
+
+struct GrGpuCommandBuffer::Upload : public Command {
+    Upload(GrBatchTarget::Uploader* uploader)
+        : Command(kUpload_Type)
+        , fUploader(SkRef(uploader)) {}
+
+    SkAutoTUnref<GrBatchTarget::Uploader> fUploader;
+};
+
+struct GrGpuCommandBuffer::PushTraceMarker : public Command {
+    PushTraceMarker(const char* marker, int id)
+        : Command(kPushTraceMarker_Type)
+        , fMarker(marker)
+        , fID(id) {}
+
+    SkString fMarker;
+    int      fID;
+};
+
+struct GrGpuCommandBuffer::PopTraceMarker : public Command {
+    PopTraceMarker() : Command(kPopTraceMarker_Type) {}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+GrGpuCommandBuffer::GrGpuCommandBuffer(GrGpu* gpu)
+    : fGpu(gpu)
+    , fCommands(kCommandsInitialSizeInBytes) {
+    SkASSERT(gpu);
+    this->reset();
+}
+
+GrGpuCommandBuffer::~GrGpuCommandBuffer() {
+}
+
+void GrGpuCommandBuffer::bindProgram(const GrPrimitiveProcessor* primProc,
+                                     const GrPipeline* pipeline,
+                                     const GrProgramDesc* desc,
+                                     const GrBatchTracker* batchTracker) {
+    SkASSERT(primProc && pipeline && desc && batchTracker);
+    if (primProc == fBoundPrimitiveProcessor && pipeline == fBoundPipeline &&
+        desc == fBoundDesc && batchTracker == fBoundBatchTracker) {
+        return;
+    }
+    BindProgram* bp = GrNEW_APPEND_TO_RECORDER(fCommands, BindProgram, ());
+    bp->fPrimitiveProcessor = fBoundPrimitiveProcessor = primProc;
+    bp->fPipeline = fBoundPipeline = pipeline;
+    bp->fDesc = fBoundDesc = desc;
+    bp->fBatchTracker = fBoundBatchTracker = batchTracker;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::draw(const GrDrawTarget::DrawInfo& info) {
+    GrNEW_APPEND_TO_RECORDER(fCommands, Draw, (info));
+    fCount++;
+}
+
+void GrGpuCommandBuffer::stencilPath(const GrPath* path, const GrGpu::StencilPathState& state) {
+    StencilPath* sp = GrNEW_APPEND_TO_RECORDER(fCommands, StencilPath, ());
+    sp->fPath = path;
+    sp->fRenderTarget = state.fRenderTarget;
+    sp->fUseHWAA = state.fUseHWAA;
+    sp->fViewMatrix = *state.fViewMatrix;
+    sp->fStencil = *state.fStencil;
+    sp->fScissor = *state.fScissor;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::drawPath(const GrPath* path, const GrStencilSettings& stencilSettings) {
+    DrawPath* dp = GrNEW_APPEND_TO_RECORDER(fCommands, DrawPath, ());
+    dp->fPath = path;
+    dp->fStencilSettings = stencilSettings;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::drawPaths(const GrPathRange* pathRange,
+                                   const void* indices,
+                                   GrDrawTarget::PathIndexType indexType,
+                                   const float transformValues[],
+                                   GrDrawTarget::PathTransformType transformType,
+                                   int count,
+                                   const GrStencilSettings& stencilSettings) {
+    DrawPaths* dp = GrNEW_APPEND_TO_RECORDER(fCommands, DrawPaths, ());
+    dp->fPathRange = pathRange;
+    dp->fIndices = indices;
+    dp->fIndexType = indexType;
+    dp->fTransforms = transformValues;
+    dp->fTransformType = transformType;
+    dp->fCount = count;
+    dp->fStencilSettings = stencilSettings;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::clear(const SkIRect* rect, GrColor color, bool canIgnoreRect,
+                               GrRenderTarget* renderTarget) {
+    Clear* clr = GrNEW_APPEND_TO_RECORDER(fCommands, Clear, ());
+    clr->fRenderTarget = renderTarget;
+    clr->fHasRect = SkToBool(rect);
+    if (rect) {
+        clr->fRect = *rect;
+    }
+    clr->fColor = color;
+    clr->fCanIgnoreRect = canIgnoreRect;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::discard(GrRenderTarget* renderTarget) {
+    this->clear(NULL, GrColor_ILLEGAL, true, renderTarget);
+}
+
+void GrGpuCommandBuffer::clearStencilClip(const SkIRect& rect, bool insideClip,
+                                          GrRenderTarget* renderTarget) {
+    ClearStencilClip* clr = GrNEW_APPEND_TO_RECORDER(fCommands, ClearStencilClip, ());
+    clr->fRenderTarget = renderTarget;
+    clr->fRect = rect;
+    clr->fInsideClip = insideClip;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::copySurface(GrSurface* dst, GrSurface* src, const SkIRect& srcRect,
+                                     const SkIPoint& dstPoint) {
+    CopySurface* cs = GrNEW_APPEND_TO_RECORDER(fCommands, CopySurface, ());
+    cs->fDst = dst;
+    cs->fSrc = src;
+    cs->fSrcRect = srcRect;
+    cs->fDstPoint = dstPoint;
+    fCount++;
+}
+
+void GrGpuCommandBuffer::upload(GrBatchTarget::Uploader* uploader) {
+    GrNEW_APPEND_TO_RECORDER(fCommands, Upload, (uploader));
+    fCount++;
+}
+
+void GrGpuCommandBuffer::pushTraceMarker(const char* marker, int id) {
+    GrNEW_APPEND_TO_RECORDER(fCommands, PushTraceMarker, (marker, id));
+    fCount++;
+}
+
+void GrGpuCommandBuffer::popTraceMarker() {
+    GrNEW_APPEND_TO_RECORDER(fCommands, PopTraceMarker, ());
+    fCount++;
+}
+
+bool GrGpuCommandBuffer::validate() const {
+    // GrTRecorder's iterator isn't const
+    Commands::Iter iter(const_cast<Commands&>(fCommands));
+    bool programBound = false;
+    int markerDepth = 0;
+    while (iter.next()) {
+        switch (iter->fType) {
+            case Command::kBindProgram_Type:
+                programBound = true;
+                break;
+            case Command::kDraw_Type: {
+                const Draw* draw = reinterpret_cast<const Draw*>(iter.get());
+                if (!programBound || draw->fInfo.vertexCount() <= 0 ||
+                    NULL == draw->fInfo.vertexBuffer() ||
+                    (draw->fInfo.isIndexed() && NULL == draw->fInfo.indexBuffer())) {
+                    return false;
+                }
+                break;
+            }
+            case Command::kStencilPath_Type: {
+                const StencilPath* sp = reinterpret_cast<const StencilPath*>(iter.get());
+                if (NULL == sp->fPath || NULL == sp->fRenderTarget) {
+                    return false;
+                }
+                break;
+            }
+            case Command::kDrawPath_Type:
+                if (!programBound || NULL == reinterpret_cast<const DrawPath*>(iter.get())->fPath) {
+                    return false;
+                }
+                break;
+            case Command::kDrawPaths_Type: {
+                const DrawPaths* dp = reinterpret_cast<const DrawPaths*>(iter.get());
+                if (!programBound || NULL == dp->fPathRange || dp->fCount <= 0) {
+                    return false;
+                }
+                break;
+            }
+            case Command::kClear_Type:
+                if (NULL == reinterpret_cast<const Clear*>(iter.get())->fRenderTarget) {
+                    return false;
+                }
+                break;
+            case Command::kClearStencilClip_Type:
+                if (NULL == reinterpret_cast<const ClearStencilClip*>(iter.get())->fRenderTarget) {
+                    return false;
+                }
+                break;
+            case Command::kCopySurface_Type: {
+                const CopySurface* cs = reinterpret_cast<const CopySurface*>(iter.get());
+                if (NULL == cs->fDst || NULL == cs->fSrc) {
+                    return false;
+                }
+                break;
+            }
+            case Command::kUpload_Type:
+                break;
+            case Command::kPushTraceMarker_Type:
+                markerDepth++;
+                break;
+            case Command::kPopTraceMarker_Type:
+                if (--markerDepth < 0) {
+                    return false;
+                }
+                break;
+        }
+    }
+    return 0 == markerDepth;
+}
+
+void GrGpuCommandBuffer::submit() {
+    SkASSERT(this->validate());
+
+    SkTLazy<GrGpu::DrawArgs> args;
+    // Markers being pushed, so the ones popped can be removed from the GrGpu
+    SkSTArray<4, GrGpuTraceMarker, true> markers;
+
+    Commands::Iter iter(fCommands);
+    while (iter.next()) {
+        switch (iter->fType) {
+            case Command::kBindProgram_Type: {
+                const BindProgram* bp = reinterpret_cast<const BindProgram*>(iter.get());
+                args.set(GrGpu::DrawArgs(bp->fPrimitiveProcessor, bp->fPipeline, bp->fDesc,
+                                         bp->fBatchTracker));
+                break;
+            }
+            case Command::kDraw_Type:
+                fGpu->draw(*args.get(), reinterpret_cast<const Draw*>(iter.get())->fInfo);
+                break;
+            case Command::kStencilPath_Type: {
+                const StencilPath* sp = reinterpret_cast<const StencilPath*>(iter.get());
+                GrGpu::StencilPathState state;
+                state.fRenderTarget = sp->fRenderTarget;
+                state.fScissor = &sp->fScissor;
+                state.fStencil = &sp->fStencil;
+                state.fUseHWAA = sp->fUseHWAA;
+                state.fViewMatrix = &sp->fViewMatrix;
+                fGpu->stencilPath(sp->fPath, state);
+                break;
+            }
+            case Command::kDrawPath_Type: {
+                const DrawPath* dp = reinterpret_cast<const DrawPath*>(iter.get());
+                fGpu->drawPath(*args.get(), dp->fPath, dp->fStencilSettings);
+                break;
+            }
+            case Command::kDrawPaths_Type: {
+                const DrawPaths* dp = reinterpret_cast<const DrawPaths*>(iter.get());
+                fGpu->drawPaths(*args.get(), dp->fPathRange, dp->fIndices, dp->fIndexType,
+                                dp->fTransforms, dp->fTransformType, dp->fCount,
+                                dp->fStencilSettings);
+                break;
+            }
+            case Command::kClear_Type: {
+                const Clear* clr = reinterpret_cast<const Clear*>(iter.get());
+                if (GrColor_ILLEGAL == clr->fColor) {
+                    fGpu->discard(clr->fRenderTarget);
+                } else {
+                    fGpu->clear(clr->fHasRect ? &clr->fRect : NULL, clr->fColor,
+                                clr->fCanIgnoreRect, clr->fRenderTarget);
+                }
+                break;
+            }
+            case Command::kClearStencilClip_Type: {
+                const ClearStencilClip* clr = reinterpret_cast<const ClearStencilClip*>(iter.get());
+                fGpu->clearStencilClip(clr->fRect, clr->fInsideClip, clr->fRenderTarget);
+                break;
+            }
+            case Command::kCopySurface_Type: {
+                const CopySurface* cs = reinterpret_cast<const CopySurface*>(iter.get());
+                fGpu->copySurface(cs->fDst, cs->fSrc, cs->fSrcRect, cs->fDstPoint);
+                break;
+            }
+            case Command::kUpload_Type:
+                reinterpret_cast<Upload*>(iter.get())->fUploader->upload(
+                        GrBatchTarget::TextureUploader(fGpu));
+                break;
+            case Command::kPushTraceMarker_Type: {
+                const PushTraceMarker* ptm = reinterpret_cast<const PushTraceMarker*>(iter.get());
+                markers.push_back(GrGpuTraceMarker(ptm->fMarker.c_str(), ptm->fID));
+                fGpu->addGpuTraceMarker(&markers.back());
+                break;
+            }
+            case Command::kPopTraceMarker_Type:
+                fGpu->removeGpuTraceMarker(&markers.back());
+                markers.pop_back();
+                break;
+        }
+    }
+
+    this->reset();
+}
+
+void GrGpuCommandBuffer::reset() {
+    fCommands.reset();
+    fCount = 0;
+    fBoundPrimitiveProcessor = NULL;
+    fBoundPipeline = NULL;
+    fBoundDesc = NULL;
+    fBoundBatchTracker = NULL;
+}
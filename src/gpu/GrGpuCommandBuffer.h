@@ -0,0 +1,107 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrGpuCommandBuffer_DEFINED
+#define GrGpuCommandBuffer_DEFINED
+
+#include "GrBatchTarget.h"
+#include "GrDrawTarget.h"
+#include "GrGpu.h"
+#include "GrTRecorder.h"
+#include "SkString.h"
+
+class GrPath;
+class GrPathRange;
+
+/**
+ * GrGpuCommandBuffer sits between GrTargetCommands and GrGpu. At flush time the draws, path draws,
+ * program binds, clears, copies, texture uploads and trace markers that used to go straight to the
+ * GrGpu are recorded into one compact buffer instead, which is then validated and replayed by
+ * submit(). Recording makes no 3D API calls, so it is where command generation can move off the
+ * thread that owns the context, and where a backend with explicit command buffers can translate
+ * the stream rather than replay it call by call.
+ *
+ * Commands keep pointers to the pipelines, processors, program descs, paths, buffers and index
+ * data of the flush that recorded them, so the buffer must be submitted (or reset) before that
+ * flush releases them.
+ */
+class GrGpuCommandBuffer : SkNoncopyable {
+public:
+    GrGpuCommandBuffer(GrGpu*);
+    ~GrGpuCommandBuffer();
+
+    // The GrGpu the buffer is submitted to. Recorders may use it for queries that don't touch the
+    // 3D API, like building program descs.
+    GrGpu* gpu() const { return fGpu; }
+
+    // Makes later draws and path draws use this program. Binding the program that is already
+    // bound records nothing.
+    void bindProgram(const GrPrimitiveProcessor*, const GrPipeline*, const GrProgramDesc*,
+                     const GrBatchTracker*);
+
+    void draw(const GrDrawTarget::DrawInfo&);
+    void stencilPath(const GrPath*, const GrGpu::StencilPathState&);
+    void drawPath(const GrPath*, const GrStencilSettings&);
+    void drawPaths(const GrPathRange*,
+                   const void* indices,
+                   GrDrawTarget::PathIndexType,
+                   const float transformValues[],
+                   GrDrawTarget::PathTransformType,
+                   int count,
+                   const GrStencilSettings&);
+    void clear(const SkIRect* rect, GrColor, bool canIgnoreRect, GrRenderTarget*);
+    void discard(GrRenderTarget*);
+    void clearStencilClip(const SkIRect& rect, bool insideClip, GrRenderTarget*);
+    void copySurface(GrSurface* dst, GrSurface* src, const SkIRect& srcRect,
+                     const SkIPoint& dstPoint);
+    // The uploader is reffed until the buffer is reset
+    void upload(GrBatchTarget::Uploader*);
+    // The marker string is copied
+    void pushTraceMarker(const char* marker, int id);
+    void popTraceMarker();
+
+    bool empty() { return fCommands.empty(); }
+    int count() const { return fCount; }
+
+    // Returns true if every command has what it needs to be replayed: a bound program before
+    // each draw, non-empty draws, targets for clears and copies, and balanced trace markers.
+    bool validate() const;
+
+    // Replays the commands on the GrGpu, in the order they were recorded, and resets the buffer.
+    void submit();
+    void reset();
+
+private:
+    struct Command;
+    struct BindProgram;
+    struct Draw;
+    struct StencilPath;
+    struct DrawPath;
+    struct DrawPaths;
+    struct Clear;
+    struct ClearStencilClip;
+    struct CopySurface;
+    struct Upload;
+    struct PushTraceMarker;
+    struct PopTraceMarker;
+
+    static const int kCommandsInitialSizeInBytes = 8 * 1024;
+
+    typedef void* TCommandAlign;
+    typedef GrTRecorder<Command, TCommandAlign> Commands;
+
+    GrGpu*                      fGpu;
+    Commands                    fCommands;
+    int                         fCount;
+    // The program of the last BindProgram recorded
+    const GrPrimitiveProcessor* fBoundPrimitiveProcessor;
+    const GrPipeline*           fBoundPipeline;
+    const GrProgramDesc*        fBoundDesc;
+    const GrBatchTracker*       fBoundBatchTracker;
+};
+
+#endif
@@ -22,6 +22,7 @@ GrGpuResource::GrGpuResource(GrGpu* gpu, LifeCycle lifeCycle)
     : fGpu(gpu)
     , fGpuMemorySize(kInvalidGpuMemorySize)
     , fLifeCycle(lifeCycle)
+    , fPurgePriority(kDefault_PurgePriority)
     , fUniqueID(CreateUniqueID()) {
     SkDEBUGCODE(fCacheArrayIndex = -1);
 }
@@ -146,6 +147,15 @@ void GrGpuResource::makeUnbudgeted() {
     }
 }
 
+void GrGpuResource::setPurgePriority(PurgePriority priority) {
+    if (fPurgePriority != priority) {
+        fPurgePriority = priority;
+        if (!this->wasDestroyed()) {
+            get_resource_cache(fGpu)->resourceAccess().didChangePurgePriority(this);
+        }
+    }
+}
+
 uint32_t GrGpuResource::CreateUniqueID() {
     static int32_t gUniqueID = SK_InvalidUniqueID;
     uint32_t id;
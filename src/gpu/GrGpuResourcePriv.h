@@ -41,6 +41,16 @@ public:
      */
     void makeUnbudgeted() { fResource->makeUnbudgeted(); }
 
+    /**
+     * Sets how reluctant the cache should be to purge the resource when over budget. See
+     * GrGpuResource::PurgePriority.
+     */
+    void setPurgePriority(GrGpuResource::PurgePriority priority) {
+        fResource->setPurgePriority(priority);
+    }
+
+    GrGpuResource::PurgePriority purgePriority() const { return fResource->fPurgePriority; }
+
     /**
      * Does the resource count against the resource budget?
      */
@@ -49,6 +49,12 @@ public:
 
     void discard(GrRenderTarget*) override;
 
+    /**
+     * Allows batches that don't overlap to be drawn in a different order than they were recorded
+     * in, grouped to minimize state changes. Off by default.
+     */
+    void setSortBatches(bool sort) { fCommands.setSortBatches(sort); }
+
 protected:
     void willReserveVertexAndIndexSpace(int vertexCount,
                                         size_t vertexStride,
@@ -183,9 +183,11 @@ bool GrLayerCache::tryToAtlas(GrCachedLayer* layer,
 
     if (layer->isAtlased()) {
         SkASSERT(fAtlas);
-        // Hooray it is still in the atlas - make sure it stays there
+        // Hooray it is still in the atlas - make sure it stays there, and that its plot is the
+        // last to be purged.
         layer->setLocked(true);
         this->incPlotLock(layer->plot()->id());
+        fAtlas->makeMRU(layer->plot());
         *needsRendering = false;
         return true;
     } else {
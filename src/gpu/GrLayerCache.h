@@ -290,6 +290,8 @@ public:
     // elements by the GrContext
     void freeAll();
 
+    int numLayers() const { return fLayerHash.count(); }
+
     GrCachedLayer* findLayer(uint32_t pictureID, const SkMatrix& ctm,
                              const unsigned* key, int keySize);
     GrCachedLayer* findLayerOrCreate(uint32_t pictureID,
@@ -401,7 +403,6 @@ private:
 
     // for testing
     friend class TestingAccess;
-    int numLayers() const { return fLayerHash.count(); }
 };
 
 #endif
@@ -18,6 +18,7 @@
 #include "SkRecordDraw.h"
 #include "SkSurface.h"
 #include "SkSurface_Gpu.h"
+#include "SkTSort.h"
 
 // Create the layer information for the hoisted layer and secure the
 // required texture/render target resources.
@@ -113,6 +114,29 @@ static bool compute_source_rect(const SkLayerInfo::BlockInfo& info, const SkMatr
     return true;
 }
 
+namespace {
+
+// A layer that could go in the atlas, waiting its turn.
+struct AtlasCandidate {
+    const SkLayerInfo::BlockInfo* fInfo;
+    SkIRect fSrcIR;
+    SkIRect fDstIR;
+    int fIndex;
+
+    // Tallest first, then widest, then in picture order.
+    static bool Before(const AtlasCandidate& a, const AtlasCandidate& b) {
+        if (a.fSrcIR.height() != b.fSrcIR.height()) {
+            return a.fSrcIR.height() > b.fSrcIR.height();
+        }
+        if (a.fSrcIR.width() != b.fSrcIR.width()) {
+            return a.fSrcIR.width() > b.fSrcIR.width();
+        }
+        return a.fIndex < b.fIndex;
+    }
+};
+
+}  // namespace
+
 // Atlased layers must be small enough to fit in the atlas, not have a
 // paint with an image filter and be neither nested nor nesting.
 // TODO: allow leaf nested layers to appear in the atlas.
@@ -146,6 +170,7 @@ void GrLayerHoister::FindLayersToAtlas(GrContext* context,
 
     atlased->setReserve(atlased->count() + topLevelGPUData->numBlocks());
 
+    SkTDArray<AtlasCandidate> candidates;
     for (int i = 0; i < topLevelGPUData->numBlocks(); ++i) {
         const SkLayerInfo::BlockInfo& info = topLevelGPUData->block(i);
 
@@ -172,10 +197,23 @@ void GrLayerHoister::FindLayersToAtlas(GrContext* context,
             continue;
         }
 
-        prepare_for_hoisting(layerCache, topLevelPicture, initialMat,
-                             info, srcIR, dstIR, atlased, recycled, true, 0);
+        AtlasCandidate* candidate = candidates.append();
+        candidate->fInfo = &info;
+        candidate->fSrcIR = srcIR;
+        candidate->fDstIR = dstIR;
+        candidate->fIndex = i;
     }
 
+    // The plots pack rectangles along a skyline, which wastes the least space when taller layers
+    // go in first.
+    if (candidates.count() > 1) {
+        SkTQSort(candidates.begin(), candidates.end() - 1, AtlasCandidate::Before);
+    }
+    for (int i = 0; i < candidates.count(); ++i) {
+        const AtlasCandidate& candidate = candidates[i];
+        prepare_for_hoisting(layerCache, topLevelPicture, initialMat, *candidate.fInfo,
+                             candidate.fSrcIR, candidate.fDstIR, atlased, recycled, true, 0);
+    }
 }
 
 void GrLayerHoister::FindLayersToHoist(GrContext* context,
@@ -36,6 +36,13 @@ struct CircleVertex {
     SkScalar fInnerRadius;
 };
 
+// One record per circle, for CircleEdgeEffect's instanced draws.
+struct CircleInstance {
+    SkRect   fDevBounds;
+    SkScalar fOuterRadius;
+    SkScalar fInnerRadius;
+};
+
 struct EllipseVertex {
     SkPoint  fPos;
     SkPoint  fOffset;
@@ -66,21 +73,31 @@ inline bool circle_stays_circle(const SkMatrix& m) {
  *             p is the position in the normalized space.
  *             outerRad is the outerRadius in device space.
  *             innerRad is the innerRadius in normalized space (ignored if not stroking).
+ *
+ * An instanced effect instead reads one record per circle, and draws each as a four vertex
+ * strip whose corners come from gl_VertexID:
+ *    vec4f : (left, top, right, bottom) of the circle's device space bounds
+ *    vec2f : (outerRad, innerRad), as above
  */
 
 class CircleEdgeEffect : public GrGeometryProcessor {
 public:
-    static GrGeometryProcessor* Create(GrColor color, bool stroke, const SkMatrix& localMatrix) {
-        return SkNEW_ARGS(CircleEdgeEffect, (color, stroke, localMatrix));
+    static GrGeometryProcessor* Create(GrColor color, bool stroke, const SkMatrix& localMatrix,
+                                       bool instanced = false) {
+        return SkNEW_ARGS(CircleEdgeEffect, (color, stroke, localMatrix, instanced));
     }
 
+    // Only one pair of attributes is set, depending on isInstanced().
     const Attribute* inPosition() const { return fInPosition; }
     const Attribute* inCircleEdge() const { return fInCircleEdge; }
+    const Attribute* inBounds() const { return fInBounds; }
+    const Attribute* inRadii() const { return fInRadii; }
     virtual ~CircleEdgeEffect() {}
 
     const char* name() const override { return "CircleEdge"; }
 
     inline bool isStroked() const { return fStroke; }
+    inline bool isInstanced() const { return fInstanced; }
 
     class GLProcessor : public GrGLGeometryProcessor {
     public:
@@ -99,17 +116,31 @@ public:
 
             GrGLVertToFrag v(kVec4f_GrSLType);
             args.fPB->addVarying("CircleEdge", &v);
-            vsBuilder->codeAppendf("%s = %s;", v.vsOut(), ce.inCircleEdge()->fName);
+            const char* position;
+            if (ce.isInstanced()) {
+                // The strip's corners, in order, are TL, TR, BL, BR.
+                const char* bounds = ce.inBounds()->fName;
+                vsBuilder->codeAppend("vec2 corner = vec2(float(gl_VertexID & 1), "
+                                                         "float(gl_VertexID >> 1));");
+                vsBuilder->codeAppendf("vec2 circlePos = mix(%s.xy, %s.zw, corner);",
+                                       bounds, bounds);
+                vsBuilder->codeAppendf("%s = vec4(2.0 * corner - 1.0, %s);",
+                                       v.vsOut(), ce.inRadii()->fName);
+                position = "circlePos";
+            } else {
+                vsBuilder->codeAppendf("%s = %s;", v.vsOut(), ce.inCircleEdge()->fName);
+                position = ce.inPosition()->fName;
+            }
 
             // Setup pass through color
             this->setupColorPassThrough(pb, local.fInputColorType, args.fOutputColor, NULL,
                                         &fColorUniform);
 
             // Setup position
-            this->setupPosition(pb, gpArgs, ce.inPosition()->fName, ce.viewMatrix());
+            this->setupPosition(pb, gpArgs, position, ce.viewMatrix());
 
             // emit transforms
-            this->emitTransforms(args.fPB, gpArgs->fPositionVar, ce.inPosition()->fName,
+            this->emitTransforms(args.fPB, gpArgs->fPositionVar, position,
                                  ce.localMatrix(), args.fTransformsIn, args.fTransformsOut);;
 
             GrGLGPFragmentBuilder* fsBuilder = args.fPB->getFragmentShaderBuilder();
@@ -133,6 +164,7 @@ public:
             uint16_t key = circleEffect.isStroked() ? 0x1 : 0x0;
             key |= local.fUsesLocalCoords && gp.localMatrix().hasPerspective() ? 0x2 : 0x0;
             key |= ComputePosKey(gp.viewMatrix()) << 2;
+            key |= circleEffect.isInstanced() ? 0x10 : 0x0;
             b->add32(key << 16 | local.fInputColorType);
         }
 
@@ -185,18 +217,29 @@ public:
     }
 
 private:
-    CircleEdgeEffect(GrColor color, bool stroke, const SkMatrix& localMatrix)
-        : INHERITED(color, SkMatrix::I(), localMatrix) {
+    CircleEdgeEffect(GrColor color, bool stroke, const SkMatrix& localMatrix, bool instanced)
+        : INHERITED(color, SkMatrix::I(), localMatrix)
+        , fInPosition(NULL)
+        , fInCircleEdge(NULL)
+        , fInBounds(NULL)
+        , fInRadii(NULL) {
         this->initClassID<CircleEdgeEffect>();
-        fInPosition = &this->addVertexAttrib(Attribute("inPosition", kVec2f_GrVertexAttribType));
-        fInCircleEdge = &this->addVertexAttrib(Attribute("inCircleEdge",
-                                                           kVec4f_GrVertexAttribType));
+        if (instanced) {
+            fInBounds = &this->addVertexAttrib(Attribute("inBounds", kVec4f_GrVertexAttribType));
+            fInRadii = &this->addVertexAttrib(Attribute("inRadii", kVec2f_GrVertexAttribType));
+        } else {
+            fInPosition = &this->addVertexAttrib(Attribute("inPosition",
+                                                           kVec2f_GrVertexAttribType));
+            fInCircleEdge = &this->addVertexAttrib(Attribute("inCircleEdge",
+                                                               kVec4f_GrVertexAttribType));
+        }
         fStroke = stroke;
+        fInstanced = instanced;
     }
 
     bool onIsEqual(const GrGeometryProcessor& other) const override {
         const CircleEdgeEffect& cee = other.cast<CircleEdgeEffect>();
-        return cee.fStroke == fStroke;
+        return cee.fStroke == fStroke && cee.fInstanced == fInstanced;
     }
 
     void onGetInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
@@ -211,7 +254,10 @@ private:
 
     const Attribute* fInPosition;
     const Attribute* fInCircleEdge;
+    const Attribute* fInBounds;
+    const Attribute* fInRadii;
     bool fStroke;
+    bool fInstanced;
 
     GR_DECLARE_GEOMETRY_PROCESSOR_TEST;
 
@@ -222,11 +268,12 @@ GR_DEFINE_GEOMETRY_PROCESSOR_TEST(CircleEdgeEffect);
 
 GrGeometryProcessor* CircleEdgeEffect::TestCreate(SkRandom* random,
                                                   GrContext* context,
-                                                  const GrDrawTargetCaps&,
+                                                  const GrDrawTargetCaps& caps,
                                                   GrTexture* textures[]) {
     return CircleEdgeEffect::Create(GrRandomColor(random),
                                     random->nextBool(),
-                                    GrProcessorUnitTest::TestMatrix(random));
+                                    GrProcessorUnitTest::TestMatrix(random),
+                                    caps.instancedDrawingSupport() && random->nextBool());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -657,8 +704,7 @@ bool GrOvalRenderer::drawOval(GrDrawTarget* target,
                               const SkRect& oval,
                               const SkStrokeRec& stroke)
 {
-    bool useCoverageAA = useAA &&
-        !pipelineBuilder->getRenderTarget()->isMultisampled();
+    bool useCoverageAA = useAA && !pipelineBuilder->isHWAntialias();
 
     if (!useCoverageAA) {
         return false;
@@ -733,9 +779,11 @@ public:
         }
 
         // Setup geometry processor
+        bool instanced = batchTarget->caps().instancedDrawingSupport();
         SkAutoTUnref<GrGeometryProcessor> gp(CircleEdgeEffect::Create(this->color(),
                                                                       this->stroke(),
-                                                                      invert));
+                                                                      invert,
+                                                                      instanced));
 
         batchTarget->initDraw(gp, pipeline);
 
@@ -749,6 +797,11 @@ public:
         init.fUsesLocalCoords = this->usesLocalCoords();
         gp->initBatchTracker(batchTarget->currentBatchTracker(), init);
 
+        if (instanced) {
+            this->generateInstances(batchTarget, gp);
+            return;
+        }
+
         int instanceCount = fGeoData.count();
         int vertexCount = kVertsPerCircle * instanceCount;
         size_t vertexStride = gp->getVertexStride();
@@ -870,6 +923,52 @@ private:
         bool fCoverageIgnored;
     };
 
+    // Writes one CircleInstance per circle, and draws them all with a single instanced strip
+    // instead of four vertices and six indices apiece.
+    void generateInstances(GrBatchTarget* batchTarget, const GrGeometryProcessor* gp) {
+        int instanceCount = fGeoData.count();
+        size_t instanceStride = gp->getVertexStride();
+        SkASSERT(instanceStride == sizeof(CircleInstance));
+
+        const GrVertexBuffer* vertexBuffer;
+        int firstInstance;
+
+        void *instances = batchTarget->vertexPool()->makeSpace(instanceStride,
+                                                               instanceCount,
+                                                               &vertexBuffer,
+                                                               &firstInstance);
+
+        if (!instances) {
+            SkDebugf("Could not allocate buffers\n");
+            return;
+        }
+
+        CircleInstance* inst = reinterpret_cast<CircleInstance*>(instances);
+
+        for (int i = 0; i < instanceCount; i++) {
+            const Geometry& args = fGeoData[i];
+
+            inst[i].fDevBounds = args.fDevBounds;
+            inst[i].fOuterRadius = args.fOuterRadius;
+            // The inner radius must be specified in normalized space.
+            inst[i].fInnerRadius = args.fInnerRadius / args.fOuterRadius;
+        }
+
+        GrDrawTarget::DrawInfo drawInfo;
+        drawInfo.setPrimitiveType(kTriangleStrip_GrPrimitiveType);
+        drawInfo.setStartVertex(firstInstance);
+        drawInfo.setVertexCount(kVertsPerCircle);
+        drawInfo.setHWInstanceCount(instanceCount);
+        drawInfo.setStartIndex(0);
+        drawInfo.setIndexCount(0);
+        drawInfo.setInstanceCount(0);
+        drawInfo.setVerticesPerInstance(0);
+        drawInfo.setIndicesPerInstance(0);
+        drawInfo.setVertexBuffer(vertexBuffer);
+
+        batchTarget->draw(drawInfo);
+    }
+
     static const int kVertsPerCircle = 4;
     static const int kIndicesPerCircle = 6;
 
@@ -1568,8 +1667,7 @@ bool GrOvalRenderer::drawDRRect(GrDrawTarget* target,
                                 bool useAA,
                                 const SkRRect& origOuter,
                                 const SkRRect& origInner) {
-    bool applyAA = useAA &&
-                   !pipelineBuilder->getRenderTarget()->isMultisampled();
+    bool applyAA = useAA && !pipelineBuilder->isHWAntialias();
     GrPipelineBuilder::AutoRestoreFragmentProcessors arfp;
     if (!origInner.isEmpty()) {
         SkTCopyOnFirstWrite<SkRRect> inner(origInner);
@@ -2066,8 +2164,7 @@ bool GrOvalRenderer::drawRRect(GrDrawTarget* target,
                               stroke);
     }
 
-    bool useCoverageAA = useAA &&
-        !pipelineBuilder->getRenderTarget()->isMultisampled();
+    bool useCoverageAA = useAA && !pipelineBuilder->isHWAntialias();
 
     // only anti-aliased rrects for now
     if (!useCoverageAA) {
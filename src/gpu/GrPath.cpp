@@ -13,11 +13,55 @@ template<int NumBits> static uint64_t get_top_n_float_bits(float f) {
     return floatBits >> (32 - NumBits);
 }
 
-void GrPath::ComputeKey(const SkPath& path, const SkStrokeRec& stroke, GrUniqueKey* key) {
+// Paths with at most this many points are keyed by their contents.
+static const int kMaxContentKeyPoints = 16;
+
+static bool compute_key_for_simple_path(const SkPath& path, uint64_t strokeKey,
+                                        GrUniqueKey* key) {
+    const int verbCnt = path.countVerbs();
+    const int pointCnt = path.countPoints();
+    // Conic weights aren't in the points, so leave conics to the generation ID.
+    if (verbCnt > kMaxContentKeyPoints || pointCnt > kMaxContentKeyPoints ||
+        (path.getSegmentMasks() & SkPath::kConic_SegmentMask)) {
+        return false;
+    }
+
+    uint8_t verbs[kMaxContentKeyPoints];
+    SkPoint points[kMaxContentKeyPoints];
+    SkAssertResult(path.getVerbs(verbs, verbCnt) == verbCnt);
+    SkAssertResult(path.getPoints(points, pointCnt) == pointCnt);
+
+    const int verbWords = (verbCnt + 3) / 4;
+    const int pointWords = pointCnt * sizeof(SkPoint) / sizeof(uint32_t);
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey::Builder builder(key, kDomain, 3 + verbWords + pointWords);
+    int i = 0;
+    *reinterpret_cast<uint64_t*>(&builder[i]) = strokeKey;
+    i += 2;
+    builder[i++] = path.getFillType() | (verbCnt << 8) | (pointCnt << 20);
+    for (int v = 0; v < verbWords; ++v) {
+        builder[i + v] = 0;
+    }
+    memcpy(&builder[i], verbs, verbCnt);
+    i += verbWords;
+    memcpy(&builder[i], points, pointWords * sizeof(uint32_t));
+    return true;
+}
+
+void GrPath::ComputeKey(const SkPath& path, const SkStrokeRec& stroke, GrUniqueKey* key,
+                        bool* isVolatile) {
+    const uint64_t strokeKey = ComputeStrokeKey(stroke);
+    if (compute_key_for_simple_path(path, strokeKey, key)) {
+        *isVolatile = false;
+        return;
+    }
+
     static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
     GrUniqueKey::Builder builder(key, kDomain, 3);
-    *reinterpret_cast<uint64_t*>(&builder[0]) = ComputeStrokeKey(stroke);
+    *reinterpret_cast<uint64_t*>(&builder[0]) = strokeKey;
     builder[2] = path.getGenerationID();
+    // A volatile path won't be drawn again as is, so its GrPath would just crowd the cache.
+    *isVolatile = path.isVolatile();
 }
 
 uint64_t GrPath::ComputeStrokeKey(const SkStrokeRec& stroke) {
@@ -27,7 +27,14 @@ public:
           fBounds(skPath.getBounds()) {
     }
 
-    static void ComputeKey(const SkPath& path, const SkStrokeRec& stroke, GrUniqueKey* key);
+    /**
+     * Computes the cache key for path drawn with stroke. Small paths are keyed by their contents,
+     * so that one rebuilt every frame, e.g. an icon, still finds the GrPath made for it the frame
+     * before. Others are keyed by generation ID, and *isVolatile is set if they aren't worth
+     * caching at all.
+     */
+    static void ComputeKey(const SkPath& path, const SkStrokeRec& stroke, GrUniqueKey* key,
+                           bool* isVolatile);
     static uint64_t ComputeStrokeKey(const SkStrokeRec&);
 
     bool isEqualTo(const SkPath& path, const SkStrokeRec& stroke) {
@@ -9,6 +9,7 @@
 
 #include "GrTypes.h"
 #include "SkGeometry.h"
+#include "SkResourceCache.h"
 
 SkScalar GrPathUtils::scaleToleranceToSrc(SkScalar devTol,
                                           const SkMatrix& viewM,
@@ -204,6 +205,111 @@ int GrPathUtils::worstCasePointCount(const SkPath& path, int* subpaths,
     return pointCount;
 }
 
+static void flatten_path(const SkPath& path, SkScalar tol,
+                         GrPathUtils::FlattenedPath* flattened) {
+    int subpaths;
+    flattened->fPoints.setCount(GrPathUtils::worstCasePointCount(path, &subpaths, tol));
+    flattened->fContourStarts.setReserve(subpaths);
+    const SkScalar tolSqd = SkScalarMul(tol, tol);
+    SkPoint* base = flattened->fPoints.begin();
+    SkPoint* vert = base;
+
+    SkPath::Iter iter(path, false);
+    SkPath::Verb verb;
+    SkPoint pts[4];
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                *flattened->fContourStarts.append() = SkToInt(vert - base);
+                *(vert++) = pts[0];
+                break;
+            case SkPath::kLine_Verb:
+                *(vert++) = pts[1];
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads converter;
+                // Converting in src-space, hence the finer tolerance (0.25)
+                const SkPoint* quadPts = converter.computeQuads(pts, iter.conicWeight(), 0.25f);
+                for (int i = 0; i < converter.countQuads(); ++i) {
+                    const SkPoint* quad = quadPts + i * 2;
+                    GrPathUtils::generateQuadraticPoints(quad[0], quad[1], quad[2], tolSqd, &vert,
+                            GrPathUtils::quadraticPointCount(quad, tol));
+                }
+                break;
+            }
+            case SkPath::kQuad_Verb:
+                GrPathUtils::generateQuadraticPoints(pts[0], pts[1], pts[2], tolSqd, &vert,
+                        GrPathUtils::quadraticPointCount(pts, tol));
+                break;
+            case SkPath::kCubic_Verb:
+                GrPathUtils::generateCubicPoints(pts[0], pts[1], pts[2], pts[3], tolSqd, &vert,
+                        GrPathUtils::cubicPointCount(pts, tol));
+                break;
+            default:
+                break;
+        }
+    }
+    SkASSERT(vert - base <= flattened->fPoints.count());
+    flattened->fPoints.setCount(SkToInt(vert - base));
+}
+
+namespace {
+static unsigned gFlattenKeyNamespaceLabel;
+
+struct FlattenKey : public SkResourceCache::Key {
+public:
+    FlattenKey(const SkPath& path, SkScalar tol)
+        : fGenID(path.getGenerationID())
+        , fTolerance(tol) {
+        this->init(&gFlattenKeyNamespaceLabel, 0, sizeof(fGenID) + sizeof(fTolerance));
+    }
+
+    uint32_t fGenID;
+    SkScalar fTolerance;
+};
+
+struct FlattenRec : public SkResourceCache::Rec {
+    FlattenRec(const FlattenKey& key, const GrPathUtils::FlattenedPath* flattened)
+        : fKey(key)
+        , fFlattened(SkRef(flattened)) {
+    }
+
+    FlattenKey fKey;
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> fFlattened;
+
+    const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "flattened-path"; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fFlattened->fPoints.count() * sizeof(SkPoint) +
+               fFlattened->fContourStarts.count() * sizeof(int);
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const FlattenRec& rec = static_cast<const FlattenRec&>(baseRec);
+        *static_cast<const GrPathUtils::FlattenedPath**>(context) = SkRef(rec.fFlattened.get());
+        return true;
+    }
+};
+} // namespace
+
+const GrPathUtils::FlattenedPath* GrPathUtils::flattenPath(const SkPath& path, SkScalar tol) {
+    // Lines have nothing to subdivide, and volatile paths won't be drawn again.
+    const bool cacheable = !path.isVolatile() &&
+                           SkToBool(path.getSegmentMasks() & ~SkPath::kLine_SegmentMask);
+    if (cacheable) {
+        const FlattenedPath* cached;
+        if (SkResourceCache::Find(FlattenKey(path, tol), FlattenRec::Visitor, &cached)) {
+            return cached;
+        }
+    }
+    FlattenedPath* flattened = SkNEW(FlattenedPath);
+    flatten_path(path, tol, flattened);
+    if (cacheable) {
+        SkResourceCache::Add(SkNEW_ARGS(FlattenRec, (FlattenKey(path, tol), flattened)));
+    }
+    return flattened;
+}
+
 void GrPathUtils::QuadUVMatrix::set(const SkPoint qPts[3]) {
     SkMatrix m;
     // We want M such that M * xy_pt = uv_pt
@@ -11,6 +11,7 @@
 #include "SkRect.h"
 #include "SkPath.h"
 #include "SkTArray.h"
+#include "SkTDArray.h"
 
 class SkMatrix;
 
@@ -51,6 +52,21 @@ namespace GrPathUtils {
                                  SkPoint** points,
                                  uint32_t pointsLeft);
 
+    /// A path flattened into line segments: its curves are subdivided by
+    /// generateQuadraticPoints() and generateCubicPoints(), conics first becoming
+    /// quads. fContourStarts holds the index in fPoints of each contour's first point.
+    class FlattenedPath : public SkRefCnt {
+    public:
+        SkTDArray<SkPoint> fPoints;
+        SkTDArray<int>     fContourStarts;
+    };
+
+    /// Flattens path at tol, in the path's own space. Non-volatile paths with curves
+    /// are remembered in the SkResourceCache under their generation ID and tol, so
+    /// drawing one again at the same scale reuses its points. The caller must unref
+    /// the result.
+    const FlattenedPath* flattenPath(const SkPath& path, SkScalar tol);
+
     // A 2x3 matrix that goes from the 2d space coordinates to UV space where
     // u^2-v = 0 specifies the quad. The matrix is determined by the control
     // points of the quadratic.
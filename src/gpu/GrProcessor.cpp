@@ -49,8 +49,8 @@ GrProcessorTestFactory<GrGeometryProcessor>::GetFactories() {
  * we verify the count is as expected.  If a new factory is added, then these numbers must be
  * manually adjusted.
  */
-static const int kFPFactoryCount = 38;
-static const int kGPFactoryCount = 14;
+static const int kFPFactoryCount = 40;
+static const int kGPFactoryCount = 16;
 static const int kXPFactoryCount = 5;
 
 template<>
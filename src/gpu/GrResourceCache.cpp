@@ -41,7 +41,7 @@ GrUniqueKey::Domain GrUniqueKey::GenerateDomain() {
     return static_cast<Domain>(domain);
 }
 uint32_t GrResourceKeyHash(const uint32_t* data, size_t size) {
-    return SkChecksum::Compute(data, size);
+    return SkChecksum::Fast(data, size);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -72,6 +72,9 @@ GrResourceCache::GrResourceCache()
     , fBytes(0)
     , fBudgetedCount(0)
     , fBudgetedBytes(0)
+    , fHitCount(0)
+    , fMissCount(0)
+    , fPurgeCount(0)
     , fOverBudgetCB(NULL)
     , fOverBudgetData(NULL) {
     SkDEBUGCODE(fCount = 0;)
@@ -81,6 +84,14 @@ GrResourceCache::~GrResourceCache() {
     this->releaseAll();
 }
 
+size_t GrResourceCache::getPurgeableBytes() const {
+    size_t bytes = 0;
+    for (int i = 0; i < fPurgeableQueue.count(); ++i) {
+        bytes += fPurgeableQueue.at(i)->gpuMemorySize();
+    }
+    return bytes;
+}
+
 void GrResourceCache::setLimits(int count, size_t bytes) {
     fMaxCount = count;
     fMaxBytes = bytes;
@@ -224,10 +235,12 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
     if (flags & (kPreferNoPendingIO_ScratchFlag | kRequireNoPendingIO_ScratchFlag)) {
         resource = fScratchMap.find(scratchKey, AvailableForScratchUse(true));
         if (resource) {
+            ++fHitCount;
             this->refAndMakeResourceMRU(resource);
             this->validate();
             return resource;
         } else if (flags & kRequireNoPendingIO_ScratchFlag) {
+            ++fMissCount;
             return NULL;
         }
         // TODO: fail here when kPrefer is specified, we didn't find a resource without pending io,
@@ -235,8 +248,11 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
     }
     resource = fScratchMap.find(scratchKey, AvailableForScratchUse(false));
     if (resource) {
+        ++fHitCount;
         this->refAndMakeResourceMRU(resource);
         this->validate();
+    } else {
+        ++fMissCount;
     }
     return resource;
 }
@@ -334,6 +350,9 @@ void GrResourceCache::notifyPurgeable(GrGpuResource* resource) {
         if (!this->overBudget() && !noKey) {
             return;
         }
+        if (!noKey) {
+            ++fPurgeCount;
+        }
     }
 
     SkDEBUGCODE(int beforeCount = this->getResourceCount();)
@@ -391,6 +410,16 @@ void GrResourceCache::didChangeBudgetStatus(GrGpuResource* resource) {
     this->validate();
 }
 
+void GrResourceCache::didChangePurgePriority(GrGpuResource* resource) {
+    SkASSERT(resource);
+    SkASSERT(this->isInCache(resource));
+
+    if (resource->isPurgeable()) {
+        fPurgeableQueue.priorityDidChange(resource);
+    }
+    this->validate();
+}
+
 void GrResourceCache::internalPurgeAsNeeded() {
     SkASSERT(this->overBudget());
 
@@ -398,6 +427,7 @@ void GrResourceCache::internalPurgeAsNeeded() {
     while (fPurgeableQueue.count()) {
         GrGpuResource* resource = fPurgeableQueue.peek();
         SkASSERT(resource->isPurgeable());
+        ++fPurgeCount;
         resource->cacheAccess().release();
         if (!this->overBudget()) {
             stillOverbudget = false;
@@ -430,8 +460,10 @@ void GrResourceCache::purgeAllUnlocked() {
 void GrResourceCache::processInvalidUniqueKeys(
     const SkTArray<GrUniqueKeyInvalidatedMessage>& msgs) {
     for (int i = 0; i < msgs.count(); ++i) {
-        GrGpuResource* resource = this->findAndRefUniqueResource(msgs[i].key());
+        // Not a lookup, so this bypasses findAndRefUniqueResource() to leave the stats alone.
+        GrGpuResource* resource = fUniqueHash.find(msgs[i].key());
         if (resource) {
+            this->refAndMakeResourceMRU(resource);
             resource->resourcePriv().removeUniqueKey();
             resource->unref(); // will call notifyPurgeable, if it is indeed now purgeable.
         }
@@ -479,6 +511,11 @@ uint32_t GrResourceCache::getNextTimestamp() {
                 }
             };
             Less less;
+            // The queue popped them in priority order, not necessarily in timestamp order.
+            if (sortedPurgeableResources.count()) {
+                SkTQSort(sortedPurgeableResources.begin(), sortedPurgeableResources.end() - 1,
+                         less);
+            }
             SkTQSort(fNonpurgeableResources.begin(), fNonpurgeableResources.end() - 1, less);
 
             // Pick resources out of the purgeable and non-purgeable arrays based on lowest
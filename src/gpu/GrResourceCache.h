@@ -38,6 +38,9 @@ class SkString;
  * A unique key always takes precedence over a scratch key when a resource has both types of keys.
  * If a resource has neither key type then it will be deleted as soon as the last reference to it
  * is dropped.
+ *
+ * When over budget, purgeable resources are purged in order of GrGpuResource::PurgePriority, and
+ * within a priority in LRU order.
  */
 class GrResourceCache {
 public:
@@ -75,6 +78,12 @@ public:
      */
     size_t getBudgetedResourceBytes() const { return fBudgetedBytes; }
 
+    /**
+     * Returns the number of bytes consumed by resources that nothing refs, which a purge would
+     * free. This walks all of them.
+     */
+    size_t getPurgeableBytes() const;
+
     /**
      * Returns the cached resources count budget.
      */
@@ -122,7 +131,10 @@ public:
     GrGpuResource* findAndRefUniqueResource(const GrUniqueKey& key) {
         GrGpuResource* resource = fUniqueHash.find(key);
         if (resource) {
+            ++fHitCount;
             this->refAndMakeResourceMRU(resource);
+        } else {
+            ++fMissCount;
         }
         return resource;
     }
@@ -151,6 +163,20 @@ public:
     /** Purges all resources that don't have external owners. */
     void purgeAllUnlocked();
 
+    /**
+     * Counts of scratch and unique key lookups that found a resource and that didn't, and of
+     * resources purged to get back under budget, since the last call to resetStats(). Calling
+     * resetStats() once a frame makes these per-frame counts.
+     */
+    int getHitCount() const { return fHitCount; }
+    int getMissCount() const { return fMissCount; }
+    int getPurgeCount() const { return fPurgeCount; }
+    void resetStats() {
+        fHitCount = 0;
+        fMissCount = 0;
+        fPurgeCount = 0;
+    }
+
     /**
      * The callback function used by the cache when it is still over budget after a purge. The
      * passed in 'data' is the same 'data' handed to setOverbudgetCallback.
@@ -186,6 +212,7 @@ private:
     void removeUniqueKey(GrGpuResource*);
     void willRemoveScratchKey(const GrGpuResource*);
     void didChangeBudgetStatus(GrGpuResource*);
+    void didChangePurgePriority(GrGpuResource*);
     void refAndMakeResourceMRU(GrGpuResource*);
     /// @}
 
@@ -228,17 +255,24 @@ private:
         return a->cacheAccess().timestamp() < b->cacheAccess().timestamp();
     }
 
+    static bool ComparePurgeOrder(GrGpuResource* const& a, GrGpuResource* const& b) {
+        GrGpuResource::PurgePriority pa = a->resourcePriv().purgePriority();
+        GrGpuResource::PurgePriority pb = b->resourcePriv().purgePriority();
+        return pa != pb ? pa < pb : CompareTimestamp(a, b);
+    }
+
     static int* AccessResourceIndex(GrGpuResource* const& res) {
         return res->cacheAccess().accessCacheIndex();
     }
 
     typedef SkMessageBus<GrUniqueKeyInvalidatedMessage>::Inbox InvalidUniqueKeyInbox;
-    typedef SkTDPQueue<GrGpuResource*, CompareTimestamp, AccessResourceIndex> PurgeableQueue;
+    typedef SkTDPQueue<GrGpuResource*, ComparePurgeOrder, AccessResourceIndex> PurgeableQueue;
     typedef SkTDArray<GrGpuResource*> ResourceArray;
 
     // Whenever a resource is added to the cache or the result of a cache lookup, fTimestamp is
     // assigned as the resource's timestamp and then incremented. fPurgeableQueue orders the
-    // purgeable resources by this value, and thus is used to purge resources in LRU order.
+    // purgeable resources by priority and then by this value, and thus is used to purge resources
+    // in LRU order within each priority.
     uint32_t                            fTimestamp;
     PurgeableQueue                      fPurgeableQueue;
     ResourceArray                       fNonpurgeableResources;
@@ -267,6 +301,11 @@ private:
     int                                 fBudgetedCount;
     size_t                              fBudgetedBytes;
 
+    // lookups and purges since resetStats()
+    int                                 fHitCount;
+    int                                 fMissCount;
+    int                                 fPurgeCount;
+
     PFOverBudgetCB                      fOverBudgetCB;
     void*                               fOverBudgetData;
 
@@ -325,6 +364,13 @@ private:
      */
     void didChangeBudgetStatus(GrGpuResource* resource) { fCache->didChangeBudgetStatus(resource); }
 
+    /**
+     * Called by GrGpuResources when their purge priorities change.
+     */
+    void didChangePurgePriority(GrGpuResource* resource) {
+        fCache->didChangePurgePriority(resource);
+    }
+
     // No taking addresses of this type.
     const ResourceAccess* operator&() const;
     ResourceAccess* operator&();
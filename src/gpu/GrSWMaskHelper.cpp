@@ -229,7 +229,7 @@ bool GrSWMaskHelper::init(const SkIRect& resultBounds,
 /**
  * Get a texture (from the texture cache) of the correct size & format.
  */
-GrTexture* GrSWMaskHelper::createTexture() {
+GrTexture* GrSWMaskHelper::createTexture(bool flushing) {
     GrSurfaceDesc desc;
     desc.fWidth = fBM.width();
     desc.fHeight = fBM.height();
@@ -248,7 +248,7 @@ GrTexture* GrSWMaskHelper::createTexture() {
         SkASSERT(fContext->getGpu()->caps()->isConfigTexturable(desc.fConfig));
     }
 
-    return fContext->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch);
+    return fContext->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch, flushing);
 }
 
 void GrSWMaskHelper::sendTextureData(GrTexture *texture, const GrSurfaceDesc& desc,
@@ -66,6 +66,10 @@ public:
 
     // Convert mask generation results to a signed distance field
     void toSDF(unsigned char* sdf);
+
+    // Get a scratch texture suitable for capturing the result (i.e., right size & format).
+    // Pass flushing as true when called at flush time, as clip masks are.
+    GrTexture* createTexture(bool flushing = false);
     
     // Reset the internal bitmap
     void clear(uint8_t alpha) {
@@ -99,10 +103,6 @@ public:
                                          const SkIRect& rect);
 
 private:
-    // Helper function to get a scratch texture suitable for capturing the
-    // result (i.e., right size & format)
-    GrTexture* createTexture();
-
     GrContext*      fContext;
     SkMatrix        fMatrix;
     SkBitmap        fBM;
@@ -74,11 +74,15 @@ GrStencilAndCoverPathRenderer::onGetStencilSupport(const GrDrawTarget*,
 static GrPath* get_gr_path(GrGpu* gpu, const SkPath& skPath, const SkStrokeRec& stroke) {
     GrContext* ctx = gpu->getContext();
     GrUniqueKey key;
-    GrPath::ComputeKey(skPath, stroke, &key);
-    SkAutoTUnref<GrPath> path(static_cast<GrPath*>(ctx->findAndRefCachedResource(key)));
+    bool isVolatile;
+    GrPath::ComputeKey(skPath, stroke, &key, &isVolatile);
+    SkAutoTUnref<GrPath> path(
+        isVolatile ? NULL : static_cast<GrPath*>(ctx->findAndRefCachedResource(key)));
     if (NULL == path || !path->isEqualTo(skPath, stroke)) {
         path.reset(gpu->pathRendering()->createPath(skPath, stroke));
-        ctx->addResourceToCache(key, path);
+        if (!isVolatile) {
+            ctx->addResourceToCache(key, path);
+        }
     }
     return path.detach();
 }
@@ -12,14 +12,109 @@
 #include "GrInOrderDrawBuffer.h"
 #include "GrTemplates.h"
 #include "SkPoint.h"
+#include "SkTaskGroup.h"
+
+void GrTargetCommands::closeBatch(const OpenBatch& open) {
+    fBatchTarget.resetNumberOfDraws();
+    open.fCmd->execute(NULL, open.fState);
+    open.fCmd->fBatch->setNumberOfDraws(fBatchTarget.numberOfDraws());
+}
+
+void GrTargetCommands::PrepareBatch(OpenBatch* open) {
+    open->fCmd->fBatch->prepareGeometry();
+}
+
+static uint32_t first_texture_id(const GrPipeline* pipeline) {
+    if (pipeline->numFragmentStages() > 0) {
+        const GrFragmentProcessor* fp = pipeline->getFragmentStage(0).processor();
+        if (fp->numTextures() > 0) {
+            return fp->texture(0)->getUniqueID();
+        }
+    }
+    return SK_InvalidUniqueID;
+}
+
+// Batches of the same class most likely share a program, so that comes first, then the texture
+// and blend they draw with.
+static bool batch_sorts_before(const GrBatch* a, const GrPipeline* aPipeline,
+                               const GrBatch* b, const GrPipeline* bPipeline) {
+    if (a->classID() != b->classID()) {
+        return a->classID() < b->classID();
+    }
+    uint32_t aTexture = first_texture_id(aPipeline);
+    uint32_t bTexture = first_texture_id(bPipeline);
+    if (aTexture != bTexture) {
+        return aTexture < bTexture;
+    }
+    return aPipeline->getXferProcessor()->classID() < bPipeline->getXferProcessor()->classID();
+}
+
+void GrTargetCommands::sortOpenBatches() {
+    // An insertion sort that stops a batch at the first batch it overlaps.  Each swap checks the
+    // two batches involved, so overlapping batches never change their relative order.
+    SkSTArray<kMaxOpenBatches, OpenBatch, true> sorted;
+    sorted.push_back_n(fOpenBatches.count(), fOpenBatches.begin());
+    for (int i = 1; i < sorted.count(); i++) {
+        OpenBatch open = sorted[i];
+        int j = i;
+        while (j > 0 &&
+               !SkRect::Intersects(sorted[j - 1].fBounds, open.fBounds) &&
+               batch_sorts_before(open.fCmd->fBatch, open.fState->getPipeline(),
+                                  sorted[j - 1].fCmd->fBatch, sorted[j - 1].fState->getPipeline())) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = open;
+    }
+
+    // The DrawBatch commands stay where they are in fCmdBuffer, which the flush walks in order,
+    // so the batches are dealt out to them in the sorted order instead.
+    SkSTArray<kMaxOpenBatches, GrBatch*, true> batches;
+    for (int i = 0; i < sorted.count(); i++) {
+        batches.push_back(sorted[i].fCmd->fBatch.detach());
+    }
+    for (int i = 0; i < sorted.count(); i++) {
+        fOpenBatches[i].fCmd->fBatch.reset(batches[i]);
+        fOpenBatches[i].fState = sorted[i].fState;
+        fOpenBatches[i].fBounds = sorted[i].fBounds;
+    }
+}
 
 void GrTargetCommands::closeBatch() {
-    if (fDrawBatch) {
-        fBatchTarget.resetNumberOfDraws();
-        fDrawBatch->execute(NULL, fPrevState);
-        fDrawBatch->fBatch->setNumberOfDraws(fBatchTarget.numberOfDraws());
-        fDrawBatch = NULL;
+    if (fSortBatches && fOpenBatches.count() > 1) {
+        this->sortOpenBatches();
     }
+
+    // The batches can do the CPU heavy part of their work on other threads, all at once.  Only
+    // generating the geometry touches the GPU's buffers, and it must happen in the order
+    // flush() will find the batches, so that part stays on this thread.
+    if (fOpenBatches.count() > 1) {
+        SkTaskGroup tg;
+        tg.batch(PrepareBatch, fOpenBatches.begin(), fOpenBatches.count());
+    }
+    for (int i = 0; i < fOpenBatches.count(); i++) {
+        this->closeBatch(fOpenBatches[i]);
+    }
+    fOpenBatches.rewind();
+}
+
+GrTargetCommands::DrawBatch* GrTargetCommands::combineWithOpenBatch(GrBatch* batch,
+                                                                    const GrPipeline& pipeline,
+                                                                    const SkRect& bounds) {
+    // Combining batch into an earlier batch moves it back past every batch in between, which is
+    // only safe if it overlaps none of them.
+    for (int i = fOpenBatches.count() - 1; i >= 0; i--) {
+        OpenBatch& open = fOpenBatches[i];
+        if (open.fState->getPipeline()->isEqual(pipeline) &&
+            open.fCmd->fBatch->combineIfPossible(batch)) {
+            open.fBounds.join(bounds);
+            return open.fCmd;
+        }
+        if (SkRect::Intersects(open.fBounds, bounds)) {
+            return NULL;
+        }
+    }
+    return NULL;
 }
 
 static bool path_fill_type_is_winding(const GrStencilSettings& pathStencilSettings) {
@@ -109,23 +204,42 @@ GrTargetCommands::Cmd* GrTargetCommands::recordDrawBatch(
                                                   GrInOrderDrawBuffer* iodb,
                                                   GrBatch* batch,
                                                   const GrDrawTarget::PipelineInfo& pipelineInfo) {
-    if (!this->setupPipelineAndShouldDraw(iodb, batch, pipelineInfo)) {
+    SetState* ss = GrNEW_APPEND_TO_RECORDER(fCmdBuffer, SetState, ());
+    iodb->setupPipeline(pipelineInfo, ss->pipelineLocation());
+
+    if (ss->getPipeline()->mustSkip()) {
+        fCmdBuffer.pop_back();
         return NULL;
     }
 
-    // Check if there is a Batch Draw we can batch with
-    if (Cmd::kDrawBatch_CmdType != fCmdBuffer.back().type() || !fDrawBatch) {
-        fDrawBatch = GrNEW_APPEND_TO_RECORDER(fCmdBuffer, DrawBatch, (batch, &fBatchTarget));
-        return fDrawBatch;
+    batch->initBatchTracker(ss->getPipeline()->getInitBatchTracker());
+
+    // Draws without bounds could be anywhere, so nothing may move past them.
+    const SkRect bounds = pipelineInfo.devBounds() ? *pipelineInfo.devBounds()
+                                                   : SkRect::MakeLargest();
+    if (DrawBatch* combined = this->combineWithOpenBatch(batch, *ss->getPipeline(), bounds)) {
+        fCmdBuffer.pop_back();
+        return combined;
     }
 
-    SkASSERT(&fCmdBuffer.back() == fDrawBatch);
-    if (!fDrawBatch->fBatch->combineIfPossible(batch)) {
-        this->closeBatch();
-        fDrawBatch = GrNEW_APPEND_TO_RECORDER(fCmdBuffer, DrawBatch, (batch, &fBatchTarget));
+    if (fPrevState && !fPrevState->fPrimitiveProcessor.get() &&
+        fPrevState->getPipeline()->isEqual(*ss->getPipeline())) {
+        fCmdBuffer.pop_back();
+    } else {
+        fPrevState = ss;
+        iodb->recordTraceMarkersIfNecessary(ss);
+    }
+
+    if (kMaxOpenBatches == fOpenBatches.count()) {
+        this->closeBatch(fOpenBatches[0]);
+        fOpenBatches.remove(0);
     }
 
-    return fDrawBatch;
+    OpenBatch* open = fOpenBatches.append();
+    open->fCmd = GrNEW_APPEND_TO_RECORDER(fCmdBuffer, DrawBatch, (batch, &fBatchTarget));
+    open->fState = fPrevState;
+    open->fBounds = bounds;
+    return open->fCmd;
 }
 
 GrTargetCommands::Cmd* GrTargetCommands::recordStencilPath(
@@ -278,7 +392,7 @@ GrTargetCommands::Cmd* GrTargetCommands::recordDiscard(GrInOrderDrawBuffer* iodb
 void GrTargetCommands::reset() {
     fCmdBuffer.reset();
     fPrevState = NULL;
-    fDrawBatch = NULL;
+    fOpenBatches.rewind();
 }
 
 void GrTargetCommands::flush(GrInOrderDrawBuffer* iodb) {
@@ -290,7 +404,7 @@ void GrTargetCommands::flush(GrInOrderDrawBuffer* iodb) {
     this->closeBatch();
     iodb->getVertexAllocPool()->unmap();
     iodb->getIndexAllocPool()->unmap();
-    fBatchTarget.preFlush();
+    fBatchTarget.preFlush(&fGpuCommands);
 
     // Updated every time we find a set state cmd to reflect the current state in the playback
     // stream.
@@ -298,54 +412,45 @@ void GrTargetCommands::flush(GrInOrderDrawBuffer* iodb) {
 
     CmdBuffer::Iter iter(fCmdBuffer);
 
-    GrGpu* gpu = iodb->getGpu();
-
     while (iter.next()) {
-        GrGpuTraceMarker newMarker("", -1);
-        SkString traceString;
         if (iter->isTraced()) {
-            traceString = iodb->getCmdString(iter->markerID());
-            newMarker.fMarker = traceString.c_str();
-            gpu->addGpuTraceMarker(&newMarker);
+            fGpuCommands.pushTraceMarker(iodb->getCmdString(iter->markerID()).c_str(), -1);
         }
 
         // TODO temporary hack
         if (Cmd::kDrawBatch_CmdType == iter->type()) {
             DrawBatch* db = reinterpret_cast<DrawBatch*>(iter.get());
-            fBatchTarget.flushNext(db->fBatch->numberOfDraws());
-
-            if (iter->isTraced()) {
-                gpu->removeGpuTraceMarker(&newMarker);
-            }
-            continue;
-        }
-
-        if (Cmd::kSetState_CmdType == iter->type()) {
+            fBatchTarget.flushNext(db->fBatch->numberOfDraws(), &fGpuCommands);
+        } else if (Cmd::kSetState_CmdType == iter->type()) {
             SetState* ss = reinterpret_cast<SetState*>(iter.get());
 
-            ss->execute(gpu, currentState);
+            ss->execute(&fGpuCommands, currentState);
             currentState = ss;
         } else {
-            iter->execute(gpu, currentState);
+            iter->execute(&fGpuCommands, currentState);
         }
 
         if (iter->isTraced()) {
-            gpu->removeGpuTraceMarker(&newMarker);
+            fGpuCommands.popTraceMarker();
         }
     }
 
+    // The commands point into fCmdBuffer and the batch target's flush, so they have to be replayed
+    // before either is reset
+    fGpuCommands.submit();
+
     // TODO see copious notes about hack
     fBatchTarget.postFlush();
 }
 
-void GrTargetCommands::Draw::execute(GrGpu* gpu, const SetState* state) {
+void GrTargetCommands::Draw::execute(GrGpuCommandBuffer* commands, const SetState* state) {
     SkASSERT(state);
-    DrawArgs args(state->fPrimitiveProcessor.get(), state->getPipeline(), &state->fDesc,
-                  &state->fBatchTracker);
-    gpu->draw(args, fInfo);
+    commands->bindProgram(state->fPrimitiveProcessor.get(), state->getPipeline(), &state->fDesc,
+                          &state->fBatchTracker);
+    commands->draw(fInfo);
 }
 
-void GrTargetCommands::StencilPath::execute(GrGpu* gpu, const SetState*) {
+void GrTargetCommands::StencilPath::execute(GrGpuCommandBuffer* commands, const SetState*) {
     GrGpu::StencilPathState state;
     state.fRenderTarget = fRenderTarget.get();
     state.fScissor = &fScissor;
@@ -353,53 +458,54 @@ void GrTargetCommands::StencilPath::execute(GrGpu* gpu, const SetState*) {
     state.fUseHWAA = fUseHWAA;
     state.fViewMatrix = &fViewMatrix;
 
-    gpu->stencilPath(this->path(), state);
+    commands->stencilPath(this->path(), state);
 }
 
-void GrTargetCommands::DrawPath::execute(GrGpu* gpu, const SetState* state) {
+void GrTargetCommands::DrawPath::execute(GrGpuCommandBuffer* commands, const SetState* state) {
     SkASSERT(state);
-    DrawArgs args(state->fPrimitiveProcessor.get(), state->getPipeline(), &state->fDesc,
-                  &state->fBatchTracker);
-    gpu->drawPath(args, this->path(), fStencilSettings);
+    commands->bindProgram(state->fPrimitiveProcessor.get(), state->getPipeline(), &state->fDesc,
+                          &state->fBatchTracker);
+    commands->drawPath(this->path(), fStencilSettings);
 }
 
-void GrTargetCommands::DrawPaths::execute(GrGpu* gpu, const SetState* state) {
+void GrTargetCommands::DrawPaths::execute(GrGpuCommandBuffer* commands, const SetState* state) {
     SkASSERT(state);
-    DrawArgs args(state->fPrimitiveProcessor.get(), state->getPipeline(), &state->fDesc,
-                  &state->fBatchTracker);
-    gpu->drawPaths(args, this->pathRange(),
-                   fIndices, fIndexType,
-                   fTransforms, fTransformType,
-                   fCount, fStencilSettings);
+    commands->bindProgram(state->fPrimitiveProcessor.get(), state->getPipeline(), &state->fDesc,
+                          &state->fBatchTracker);
+    commands->drawPaths(this->pathRange(),
+                        fIndices, fIndexType,
+                        fTransforms, fTransformType,
+                        fCount, fStencilSettings);
 }
 
-void GrTargetCommands::DrawBatch::execute(GrGpu*, const SetState* state) {
+void GrTargetCommands::DrawBatch::execute(GrGpuCommandBuffer*, const SetState* state) {
     SkASSERT(state);
     fBatch->generateGeometry(fBatchTarget, state->getPipeline());
 }
 
-void GrTargetCommands::SetState::execute(GrGpu* gpu, const SetState*) {
+void GrTargetCommands::SetState::execute(GrGpuCommandBuffer* commands, const SetState*) {
     // TODO sometimes we have a prim proc, othertimes we have a GrBatch.  Eventually we
     // will only have GrBatch and we can delete this
     if (fPrimitiveProcessor) {
-        gpu->buildProgramDesc(&fDesc, *fPrimitiveProcessor, *getPipeline(), fBatchTracker);
+        commands->gpu()->buildProgramDesc(&fDesc, *fPrimitiveProcessor, *getPipeline(),
+                                          fBatchTracker);
     }
 }
 
-void GrTargetCommands::Clear::execute(GrGpu* gpu, const SetState*) {
+void GrTargetCommands::Clear::execute(GrGpuCommandBuffer* commands, const SetState*) {
     if (GrColor_ILLEGAL == fColor) {
-        gpu->discard(this->renderTarget());
+        commands->discard(this->renderTarget());
     } else {
-        gpu->clear(&fRect, fColor, fCanIgnoreRect, this->renderTarget());
+        commands->clear(&fRect, fColor, fCanIgnoreRect, this->renderTarget());
     }
 }
 
-void GrTargetCommands::ClearStencilClip::execute(GrGpu* gpu, const SetState*) {
-    gpu->clearStencilClip(fRect, fInsideClip, this->renderTarget());
+void GrTargetCommands::ClearStencilClip::execute(GrGpuCommandBuffer* commands, const SetState*) {
+    commands->clearStencilClip(fRect, fInsideClip, this->renderTarget());
 }
 
-void GrTargetCommands::CopySurface::execute(GrGpu* gpu, const SetState*) {
-    gpu->copySurface(this->dst(), this->src(), fSrcRect, fDstPoint);
+void GrTargetCommands::CopySurface::execute(GrGpuCommandBuffer* commands, const SetState*) {
+    commands->copySurface(this->dst(), this->src(), fSrcRect, fDstPoint);
 }
 
 GrTargetCommands::Cmd* GrTargetCommands::recordCopySurface(GrInOrderDrawBuffer* iodb,
@@ -444,27 +550,3 @@ bool GrTargetCommands::setupPipelineAndShouldDraw(GrInOrderDrawBuffer* iodb,
     return true;
 }
 
-bool GrTargetCommands::setupPipelineAndShouldDraw(GrInOrderDrawBuffer* iodb,
-                                                  GrBatch* batch,
-                                                  const GrDrawTarget::PipelineInfo& pipelineInfo) {
-    SetState* ss = GrNEW_APPEND_TO_RECORDER(fCmdBuffer, SetState, ());
-    iodb->setupPipeline(pipelineInfo, ss->pipelineLocation()); 
-
-    if (ss->getPipeline()->mustSkip()) {
-        fCmdBuffer.pop_back();
-        return false;
-    }
-
-    batch->initBatchTracker(ss->getPipeline()->getInitBatchTracker());
-
-    if (fPrevState && !fPrevState->fPrimitiveProcessor.get() &&
-        fPrevState->getPipeline()->isEqual(*ss->getPipeline())) {
-        fCmdBuffer.pop_back();
-    } else {
-        this->closeBatch();
-        fPrevState = ss;
-        iodb->recordTraceMarkersIfNecessary(ss);
-    }
-    return true;
-}
-
@@ -12,6 +12,7 @@
 #include "GrBatchTarget.h"
 #include "GrDrawTarget.h"
 #include "GrGpu.h"
+#include "GrGpuCommandBuffer.h"
 #include "GrPath.h"
 #include "GrPendingProgramElement.h"
 #include "GrRenderTarget.h"
@@ -33,7 +34,8 @@ public:
         : fCmdBuffer(kCmdBufferInitialSizeInBytes)
         , fPrevState(NULL)
         , fBatchTarget(gpu, vertexPool, indexPool)
-        , fDrawBatch(NULL) {
+        , fGpuCommands(gpu)
+        , fSortBatches(false) {
     }
 
     class Cmd : ::SkNoncopyable {
@@ -52,7 +54,7 @@ public:
         Cmd(CmdType type) : fMarkerID(-1), fType(type) {}
         virtual ~Cmd() {}
 
-        virtual void execute(GrGpu*, const SetState*) = 0;
+        virtual void execute(GrGpuCommandBuffer*, const SetState*) = 0;
 
         CmdType type() const { return fType; }
 
@@ -69,6 +71,8 @@ public:
     void reset();
     void flush(GrInOrderDrawBuffer*);
 
+    void setSortBatches(bool sort) { fSortBatches = sort; }
+
     Cmd* recordClearStencilClip(GrInOrderDrawBuffer*,
                                 const SkIRect& rect,
                                 bool insideClip,
@@ -139,14 +143,11 @@ private:
     bool SK_WARN_UNUSED_RESULT setupPipelineAndShouldDraw(GrInOrderDrawBuffer*,
                                                           const GrPrimitiveProcessor*,
                                                           const GrDrawTarget::PipelineInfo&);
-    bool SK_WARN_UNUSED_RESULT setupPipelineAndShouldDraw(GrInOrderDrawBuffer*,
-                                                          GrBatch*,
-                                                          const GrDrawTarget::PipelineInfo&);
 
     struct Draw : public Cmd {
         Draw(const GrDrawTarget::DrawInfo& info) : Cmd(kDraw_CmdType), fInfo(info) {}
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         GrDrawTarget::DrawInfo     fInfo;
     };
@@ -159,7 +160,7 @@ private:
 
         const GrPath* path() const { return fPath.get(); }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         SkMatrix                                                fViewMatrix;
         bool                                                    fUseHWAA;
@@ -175,7 +176,7 @@ private:
 
         const GrPath* path() const { return fPath.get(); }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         GrStencilSettings       fStencilSettings;
 
@@ -188,7 +189,7 @@ private:
 
         const GrPathRange* pathRange() const { return fPathRange.get();  }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         char*                           fIndices;
         GrDrawTarget::PathIndexType     fIndexType;
@@ -207,7 +208,7 @@ private:
 
         GrRenderTarget* renderTarget() const { return fRenderTarget.get(); }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         SkIRect fRect;
         GrColor fColor;
@@ -223,7 +224,7 @@ private:
 
         GrRenderTarget* renderTarget() const { return fRenderTarget.get(); }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         SkIRect fRect;
         bool    fInsideClip;
@@ -242,7 +243,7 @@ private:
         GrSurface* dst() const { return fDst.get(); }
         GrSurface* src() const { return fSrc.get(); }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         SkIPoint    fDstPoint;
         SkIRect     fSrcRect;
@@ -269,7 +270,7 @@ private:
             return reinterpret_cast<const GrPipeline*>(fPipeline.get());
         }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         typedef GrPendingProgramElement<const GrPrimitiveProcessor> ProgramPrimitiveProcessor;
         ProgramPrimitiveProcessor               fPrimitiveProcessor;
@@ -286,7 +287,7 @@ private:
             SkASSERT(!batch->isUsed());
         }
 
-        void execute(GrGpu*, const SetState*) override;
+        void execute(GrGpuCommandBuffer*, const SetState*) override;
 
         // TODO it wouldn't be too hard to let batches allocate in the cmd buffer
         SkAutoTUnref<GrBatch>  fBatch;
@@ -300,14 +301,39 @@ private:
      typedef void* TCmdAlign; // This wouldn't be enough align if a command used long double.
      typedef GrTRecorder<Cmd, TCmdAlign> CmdBuffer;
 
+     // A DrawBatch that hasn't generated its geometry yet, so later batches may still be
+     // combined into it.
+     struct OpenBatch {
+         DrawBatch*     fCmd;
+         SetState*      fState;
+         SkRect         fBounds;    // Device space bounds of everything fCmd draws.
+     };
+
+     // How many batches back a new batch may look for one to combine with.
+     static const int kMaxOpenBatches = 8;
+
      CmdBuffer                           fCmdBuffer;
      SetState*                           fPrevState;
      GrBatchTarget                       fBatchTarget;
+     // What a flush sends to the GrGpu is recorded here, then submitted
+     GrGpuCommandBuffer                  fGpuCommands;
      // TODO hack until batch is everywhere
-     GrTargetCommands::DrawBatch*        fDrawBatch;
+     SkTDArray<OpenBatch>                fOpenBatches;     // Oldest first, in fCmdBuffer order.
+     bool                                fSortBatches;
+
+     // Finds an open batch with this pipeline that batch can be combined into without being
+     // drawn under or over anything it overlaps that was recorded in between, and combines them.
+     DrawBatch* combineWithOpenBatch(GrBatch*, const GrPipeline&, const SkRect& bounds);
+
+     static void PrepareBatch(OpenBatch*);
+
+     // Reorders the open batches so that ones which can share GL state draw one after another,
+     // without moving any batch past another one it overlaps.
+     void sortOpenBatches();
+     void closeBatch(const OpenBatch&);
 
      // This will go away when everything uses batch.  However, in the short term anything which
-     // might be put into the GrInOrderDrawBuffer needs to make sure it closes the last batch
+     // might be put into the GrInOrderDrawBuffer needs to make sure it closes the open batches
      void closeBatch();
 };
 
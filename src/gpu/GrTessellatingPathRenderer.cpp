@@ -10,6 +10,7 @@
 #include "GrBatch.h"
 #include "GrBatchTarget.h"
 #include "GrDefaultGeoProcFactory.h"
+#include "GrGpuResourcePriv.h"
 #include "GrPathUtils.h"
 #include "SkChunkAlloc.h"
 #include "SkGeometry.h"
@@ -1330,14 +1331,31 @@ bool GrTessellatingPathRenderer::canDrawPath(const GrDrawTarget* target,
     return stroke.isFillStyle() && !antiAlias && !path.isConvex();
 }
 
+// Tessellations are cached by the path's contents, fill type, and tolerance.  The vertices are
+// in the path's own space and the view matrix is applied in the vertex shader, so the same
+// buffer serves any view matrix with the same scale.
+static void compute_key(const SkPath& path, SkScalar tolerance, GrUniqueKey* key) {
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey::Builder builder(key, kDomain, 3);
+    builder[0] = path.getGenerationID();
+    builder[1] = path.getFillType();
+    builder[2] = SkFloat2Bits(tolerance);
+}
+
 class TessellatingPathBatch : public GrBatch {
 public:
 
+    // If key is valid, the tessellation is cached under it.  vertexBuffer, if not NULL, is the
+    // tessellation an earlier batch cached.
     static GrBatch* Create(const GrColor& color,
                            const SkPath& path,
                            const SkMatrix& viewMatrix,
-                           SkRect clipBounds) {
-        return SkNEW_ARGS(TessellatingPathBatch, (color, path, viewMatrix, clipBounds));
+                           SkRect clipBounds,
+                           SkScalar tolerance,
+                           const GrUniqueKey& key,
+                           const GrVertexBuffer* vertexBuffer) {
+        return SkNEW_ARGS(TessellatingPathBatch, (color, path, viewMatrix, clipBounds, tolerance,
+                                                  key, vertexBuffer));
     }
 
     const char* name() const override { return "TessellatingPathBatch"; }
@@ -1360,8 +1378,14 @@ public:
         fPipelineInfo = init;
     }
 
-    void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
-        SkScalar tol = GrPathUtils::scaleToleranceToSrc(SK_Scalar1, fViewMatrix, fPath.getBounds());
+    // Tessellates the path into fTriangles.  This is all CPU work on data no other batch touches.
+    void prepareGeometry() override {
+        if (fPrepared || fVertexBuffer) {
+            return;
+        }
+        fPrepared = true;
+
+        SkScalar tol = fTolerance;
         int contourCnt;
         int maxPts = GrPathUtils::worstCasePointCount(fPath, &contourCnt, tol);
         if (maxPts <= 0) {
@@ -1377,12 +1401,6 @@ public:
         }
 
         LOG("got %d pts, %d contours\n", maxPts, contourCnt);
-        uint32_t flags = GrDefaultGeoProcFactory::kPosition_GPType;
-        SkAutoTUnref<const GrGeometryProcessor> gp(
-            GrDefaultGeoProcFactory::Create(flags, fColor, fViewMatrix, SkMatrix::I()));
-        batchTarget->initDraw(gp, pipeline);
-        gp->initBatchTracker(batchTarget->currentBatchTracker(), fPipelineInfo);
-
         SkAutoTDeleteArray<Vertex*> contours(SkNEW_ARRAY(Vertex *, contourCnt));
 
         // For the initial size of the chunk allocator, estimate based on the point count:
@@ -1403,39 +1421,69 @@ public:
             return;
         }
 
+        fTriangles.setCount(count);
+        void* end = polys_to_triangles(polys, fillType, fTriangles.begin());
+        int actualCount = SkToInt(static_cast<SkPoint*>(end) - fTriangles.begin());
+        LOG("actual count: %d\n", actualCount);
+        SkASSERT(actualCount <= count);
+        fTriangles.setCount(actualCount);
+    }
+
+    void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
+        this->prepareGeometry();
+        if (!fVertexBuffer && fTriangles.isEmpty()) {
+            return;
+        }
+
+        uint32_t flags = GrDefaultGeoProcFactory::kPosition_GPType;
+        SkAutoTUnref<const GrGeometryProcessor> gp(
+            GrDefaultGeoProcFactory::Create(flags, fColor, fViewMatrix, SkMatrix::I()));
+        batchTarget->initDraw(gp, pipeline);
+        gp->initBatchTracker(batchTarget->currentBatchTracker(), fPipelineInfo);
+
         size_t stride = gp->getVertexStride();
+        SkASSERT(sizeof(SkPoint) == stride);
+        if (!fVertexBuffer && fKey.isValid()) {
+            size_t size = fTriangles.count() * stride;
+            SkAutoTUnref<GrVertexBuffer> vb(batchTarget->createStaticVertexBuffer(size));
+            if (vb && vb->updateData(fTriangles.begin(), size)) {
+                vb->resourcePriv().setUniqueKey(fKey);
+                fVertexBuffer.reset(vb.detach());
+            }
+        }
+
         const GrVertexBuffer* vertexBuffer;
         int firstVertex;
-        void* vertices = batchTarget->vertexPool()->makeSpace(stride,
-                                                              count,
-                                                              &vertexBuffer,
-                                                              &firstVertex);
-
-        if (!vertices) {
-            SkDebugf("Could not allocate vertices\n");
-            return;
+        int count;
+        if (fVertexBuffer) {
+            vertexBuffer = fVertexBuffer;
+            firstVertex = 0;
+            count = SkToInt(fVertexBuffer->gpuMemorySize() / stride);
+        } else {
+            count = fTriangles.count();
+            void* vertices = batchTarget->vertexPool()->makeSpace(stride,
+                                                                  count,
+                                                                  &vertexBuffer,
+                                                                  &firstVertex);
+
+            if (!vertices) {
+                SkDebugf("Could not allocate vertices\n");
+                return;
+            }
+            memcpy(vertices, fTriangles.begin(), count * stride);
         }
 
         LOG("emitting %d verts\n", count);
-        void* end = polys_to_triangles(polys, fillType, vertices);
-        int actualCount = static_cast<int>(
-            (static_cast<char*>(end) - static_cast<char*>(vertices)) / stride);
-        LOG("actual count: %d\n", actualCount);
-        SkASSERT(actualCount <= count);
-
         GrPrimitiveType primitiveType = WIREFRAME ? kLines_GrPrimitiveType
                                                   : kTriangles_GrPrimitiveType;
         GrDrawTarget::DrawInfo drawInfo;
         drawInfo.setPrimitiveType(primitiveType);
         drawInfo.setVertexBuffer(vertexBuffer);
         drawInfo.setStartVertex(firstVertex);
-        drawInfo.setVertexCount(actualCount);
+        drawInfo.setVertexCount(count);
         drawInfo.setStartIndex(0);
         drawInfo.setIndexCount(0);
         batchTarget->draw(drawInfo);
-
-        batchTarget->putBackVertices((size_t)(count - actualCount), stride);
-        return;
     }
 
     bool onCombineIfPossible(GrBatch*) override {
@@ -1446,19 +1494,33 @@ private:
     TessellatingPathBatch(const GrColor& color,
                           const SkPath& path,
                           const SkMatrix& viewMatrix,
-                          const SkRect& clipBounds)
+                          const SkRect& clipBounds,
+                          SkScalar tolerance,
+                          const GrUniqueKey& key,
+                          const GrVertexBuffer* vertexBuffer)
       : fColor(color)
       , fPath(path)
       , fViewMatrix(viewMatrix)
-      , fClipBounds(clipBounds) {
+      , fClipBounds(clipBounds)
+      , fTolerance(tolerance)
+      , fKey(key)
+      , fVertexBuffer(SkSafeRef(vertexBuffer))
+      , fPrepared(false) {
         this->initClassID<TessellatingPathBatch>();
-    }
-
-    GrColor        fColor;
-    SkPath         fPath;
-    SkMatrix       fViewMatrix;
-    SkRect         fClipBounds; // in source space
-    GrPipelineInfo fPipelineInfo;
+        // Compute the path's bounds now, so prepareGeometry() only reads the shared SkPathRef.
+        (void)fPath.getBounds();
+    }
+
+    GrColor             fColor;
+    SkPath              fPath;
+    SkMatrix            fViewMatrix;
+    SkRect              fClipBounds; // in source space
+    SkScalar            fTolerance;  // in source space
+    GrUniqueKey         fKey;
+    GrPipelineInfo      fPipelineInfo;
+    bool                fPrepared;
+    SkTDArray<SkPoint>  fTriangles;  // Vertices of the tessellated path, ready to draw.
+    SkAutoTUnref<const GrVertexBuffer> fVertexBuffer;  // The same, cached under fKey.
 };
 
 bool GrTessellatingPathRenderer::onDrawPath(GrDrawTarget* target,
@@ -1469,7 +1531,7 @@ bool GrTessellatingPathRenderer::onDrawPath(GrDrawTarget* target,
                                             const SkStrokeRec& stroke,
                                             bool antiAlias) {
     SkASSERT(!antiAlias);
-    const GrRenderTarget* rt = pipelineBuilder->getRenderTarget();
+    GrRenderTarget* rt = pipelineBuilder->getRenderTarget();
     if (NULL == rt) {
         return false;
     }
@@ -1482,7 +1544,19 @@ bool GrTessellatingPathRenderer::onDrawPath(GrDrawTarget* target,
         return false;
     }
     vmi.mapRect(&clipBounds);
-    SkAutoTUnref<GrBatch> batch(TessellatingPathBatch::Create(color, path, viewM, clipBounds));
+
+    // Inverse fills are bounded by the clip in source space, which moves with the view, so only
+    // tessellations of regular fills are cached.
+    SkScalar tol = GrPathUtils::scaleToleranceToSrc(SK_Scalar1, viewM, path.getBounds());
+    GrUniqueKey key;
+    SkAutoTUnref<GrGpuResource> vertexBuffer;
+    if (!path.isInverseFillType() && !path.isVolatile()) {
+        compute_key(path, tol, &key);
+        vertexBuffer.reset(rt->getContext()->findAndRefCachedResource(key));
+    }
+    SkAutoTUnref<GrBatch> batch(TessellatingPathBatch::Create(
+        color, path, viewM, clipBounds, tol, key,
+        static_cast<const GrVertexBuffer*>(vertexBuffer.get())));
     target->drawBatch(pipelineBuilder, batch);
 
     return true;
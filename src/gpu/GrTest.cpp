@@ -72,6 +72,7 @@ void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Textures Created: %d\n", fTextureCreates);
     out->appendf("Texture Uploads: %d\n", fTextureUploads);
     out->appendf("Stencil Buffer Creates: %d\n", fStencilBufferCreates);
+    out->appendf("Draws: %d\n", fDraws);
 }
 #endif
 
@@ -121,6 +122,8 @@ void GrResourceCache::dumpStats(SkString* out) const {
     out->appendf("\t\tEntry Bytes: current %d (budgeted %d, %.2g%% full, %d unbudgeted) high %d\n",
                  SkToInt(fBytes), SkToInt(fBudgetedBytes), byteUtilization,
                  SkToInt(stats.fUnbudgetedSize), SkToInt(fHighWaterBytes));
+    out->appendf("\t\tLookups: %d hits, %d misses; %d purged to meet budget\n",
+                 fHitCount, fMissCount, fPurgeCount);
 }
 
 #endif
@@ -226,10 +229,16 @@ private:
     bool onWriteTexturePixels(GrTexture* texture,
                               int left, int top, int width, int height,
                               GrPixelConfig config, const void* buffer,
-                              size_t rowBytes) override {
+                              size_t rowBytes, bool async) override {
         return false;
     }
 
+    GrFence insertFence() override { return 0; }
+
+    bool waitFence(GrFence, uint64_t) override { return true; }
+
+    void deleteFence(GrFence) override {}
+
     void onResolveRenderTarget(GrRenderTarget* target) override { return; }
 
     bool createStencilBufferForRenderTarget(GrRenderTarget*, int width, int height) override {
@@ -93,6 +93,29 @@ void GrTextContext::drawPosText(GrRenderTarget* rt, const GrClip& clip, const Gr
                             clipBounds);
 }
 
+void GrTextContext::drawPosTextHalo(GrRenderTarget* rt, const GrClip& clip,
+                                    const GrPaint& haloPaint, const SkPaint& skHaloPaint,
+                                    const GrPaint& paint, const SkPaint& skPaint,
+                                    const SkMatrix& viewMatrix,
+                                    const char text[], size_t byteLength,
+                                    const SkScalar pos[], int scalarsPerPosition,
+                                    const SkPoint& offset, const SkIRect& clipBounds) {
+    if (!fContext->getTextTarget()) {
+        return;
+    }
+
+    if (this->canDraw(rt, clip, paint, skPaint, viewMatrix) &&
+        this->onDrawPosTextHalo(rt, clip, haloPaint, skHaloPaint, paint, skPaint, viewMatrix,
+                                text, byteLength, pos, scalarsPerPosition, offset, clipBounds)) {
+        return;
+    }
+
+    this->drawPosText(rt, clip, haloPaint, skHaloPaint, viewMatrix, text, byteLength, pos,
+                      scalarsPerPosition, offset, clipBounds);
+    this->drawPosText(rt, clip, paint, skPaint, viewMatrix, text, byteLength, pos,
+                      scalarsPerPosition, offset, clipBounds);
+}
+
 void GrTextContext::drawTextBlob(GrRenderTarget* rt, const GrClip& clip, const SkPaint& skPaint,
                                  const SkMatrix& viewMatrix, const SkTextBlob* blob,
                                  SkScalar x, SkScalar y,
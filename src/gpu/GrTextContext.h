@@ -41,6 +41,15 @@ public:
                      const char text[], size_t byteLength,
                      const SkScalar pos[], int scalarsPerPosition,
                      const SkPoint& offset, const SkIRect& clipBounds);
+    // Draws the text with haloPaint, which strokes and fills it with a round join, and then with
+    // paint, as a halo looper would (see SkDrawLooper::asAHalo).
+    void drawPosTextHalo(GrRenderTarget* rt, const GrClip&,
+                         const GrPaint& haloPaint, const SkPaint& skHaloPaint,
+                         const GrPaint&, const SkPaint&,
+                         const SkMatrix& viewMatrix,
+                         const char text[], size_t byteLength,
+                         const SkScalar pos[], int scalarsPerPosition,
+                         const SkPoint& offset, const SkIRect& clipBounds);
     virtual void drawTextBlob(GrRenderTarget*, const GrClip&, const SkPaint&,
                               const SkMatrix& viewMatrix, const SkTextBlob*, SkScalar x, SkScalar y,
                               SkDrawFilter*, const SkIRect& clipBounds);
@@ -76,6 +85,17 @@ protected:
                                const char text[], size_t byteLength,
                                const SkScalar pos[], int scalarsPerPosition,
                                const SkPoint& offset, const SkIRect& clipBounds) = 0;
+    // Called when canDraw() accepts the text's paint. Contexts that can draw the halo from the
+    // text's own glyphs do so and return true; returning false draws the two separately.
+    virtual bool onDrawPosTextHalo(GrRenderTarget*, const GrClip&,
+                                   const GrPaint& haloPaint, const SkPaint& skHaloPaint,
+                                   const GrPaint&, const SkPaint&,
+                                   const SkMatrix& viewMatrix,
+                                   const char text[], size_t byteLength,
+                                   const SkScalar pos[], int scalarsPerPosition,
+                                   const SkPoint& offset, const SkIRect& clipBounds) {
+        return false;
+    }
 
     void drawTextAsPath(const SkPaint& origPaint, const SkMatrix& viewMatrix,
                         const char text[], size_t byteLength, SkScalar x, SkScalar y,
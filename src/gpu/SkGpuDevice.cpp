@@ -7,6 +7,7 @@
 
 #include "SkGpuDevice.h"
 
+#include "GrBitmapAtlas.h"
 #include "GrBitmapTextContext.h"
 #include "GrContext.h"
 #include "GrDistanceFieldTextContext.h"
@@ -581,17 +582,21 @@ void SkGpuDevice::drawOval(const SkDraw& draw, const SkRect& oval,
     CHECK_FOR_ANNOTATION(paint);
     CHECK_SHOULD_DRAW(draw);
 
+    if (paint.getMaskFilter()) {
+        // drawRRect() can blur circles without a mask, and otherwise draws the path.
+        SkRRect rrect;
+        rrect.setOval(oval);
+        this->drawRRect(draw, rrect, paint);
+        return;
+    }
+
     GrStrokeInfo strokeInfo(paint);
 
     bool usePath = false;
     // some basic reasons we might need to call drawPath...
-    if (paint.getMaskFilter()) {
+    const SkPathEffect* pe = paint.getPathEffect();
+    if (pe && !strokeInfo.isDashed()) {
         usePath = true;
-    } else {
-        const SkPathEffect* pe = paint.getPathEffect();
-        if (pe && !strokeInfo.isDashed()) {
-            usePath = true;
-        }
     }
 
     if (usePath) {
@@ -1147,13 +1152,14 @@ void SkGpuDevice::drawBitmapCommon(const SkDraw& draw,
         }
     }
 
-    // If the render target is not msaa and draw is antialiased, we call
+    // If the render target is not msaa (or uses mixed sample AA) and draw is antialiased, we call
     // drawRect instead of drawing on the render target directly.
     // FIXME: the tiled bitmap code path doesn't currently support
     // anti-aliased edges, we work around that for now by drawing directly
     // if the image size exceeds maximum texture size.
     int maxTextureSize = fContext->getMaxTextureSize();
-    bool directDraw = fRenderTarget->isMultisampled() ||
+    bool directDraw = (fRenderTarget->isMultisampled() &&
+                       !fContext->getOptions().fMixedSampleAA) ||
                       !paint.isAntiAlias() ||
                       bitmap.width() > maxTextureSize ||
                       bitmap.height() > maxTextureSize;
@@ -1408,6 +1414,32 @@ void SkGpuDevice::internalDrawBitmap(const SkBitmap& bitmap,
     SkASSERT(bitmap.width() <= fContext->getMaxTextureSize() &&
              bitmap.height() <= fContext->getMaxTextureSize());
 
+    bool alphaOnly = !(kAlpha_8_SkColorType == bitmap.colorType());
+    GrColor paintColor = (alphaOnly) ? SkColor2GrColorJustAlpha(paint.getColor()) :
+                                       SkColor2GrColor(paint.getColor());
+
+    // Small bitmaps are drawn from a shared atlas so that draws of different bitmaps can be
+    // batched.  The atlas keeps a border of repeated edge pixels around each bitmap, which only
+    // stands in for clamping when the whole bitmap is drawn or bleeding is allowed.
+    if (!bicubic &&
+        GrTextureParams::kMipMap_FilterMode != params.filterMode() &&
+        (!needsTextureDomain || (flags & SkCanvas::kBleed_DrawBitmapRectFlag)) &&
+        !viewMatrix.hasPerspective() &&
+        GrBitmapAtlas::CanAtlas(bitmap)) {
+        GrTexture* atlasTexture = fContext->getBitmapAtlas()->getTexture();
+        if (atlasTexture) {
+            GrTextureParams atlasParams(SkShader::kClamp_TileMode, params.filterMode());
+            GrPaint grPaint;
+            grPaint.addColorTextureProcessor(atlasTexture, SkMatrix::I(), atlasParams);
+            SkPaint2GrPaintNoShader(this->context(), fRenderTarget, paint, paintColor, false,
+                                    &grPaint);
+
+            fContext->drawAtlasedBitmap(fRenderTarget, fClip, grPaint, viewMatrix, bitmap,
+                                        srcRect);
+            return;
+        }
+    }
+
     GrTexture* texture;
     AutoBitmapTexture abt(fContext, bitmap, &params, &texture);
     if (NULL == texture) {
@@ -1464,9 +1496,6 @@ void SkGpuDevice::internalDrawBitmap(const SkBitmap& bitmap,
     // the rest from the SkPaint.
     GrPaint grPaint;
     grPaint.addColorProcessor(fp);
-    bool alphaOnly = !(kAlpha_8_SkColorType == bitmap.colorType());
-    GrColor paintColor = (alphaOnly) ? SkColor2GrColorJustAlpha(paint.getColor()) :
-                                       SkColor2GrColor(paint.getColor());
     SkPaint2GrPaintNoShader(this->context(), fRenderTarget, paint, paintColor, false, &grPaint);
 
     fContext->drawNonAARectToRect(fRenderTarget, fClip, grPaint, viewMatrix, dstRect,
@@ -1845,6 +1874,26 @@ void SkGpuDevice::drawPosText(const SkDraw& draw, const void* text, size_t byteL
                               draw.fClip->getBounds());
 }
 
+void SkGpuDevice::drawPosTextHalo(const SkDraw& draw, const void* text, size_t byteLength,
+                                  const SkScalar pos[], int scalarsPerPos,
+                                  const SkPoint& offset, const SkPaint& haloPaint,
+                                  const SkPaint& paint) {
+    GR_CREATE_TRACE_MARKER_CONTEXT("SkGpuDevice::drawPosTextHalo", fContext);
+    CHECK_SHOULD_DRAW(draw);
+
+    GrPaint grHaloPaint;
+    SkPaint2GrPaintShader(this->context(), fRenderTarget, haloPaint, *draw.fMatrix, true,
+                          &grHaloPaint);
+    GrPaint grPaint;
+    SkPaint2GrPaintShader(this->context(), fRenderTarget, paint, *draw.fMatrix, true, &grPaint);
+
+    SkDEBUGCODE(this->validate();)
+
+    fTextContext->drawPosTextHalo(fRenderTarget, fClip, grHaloPaint, haloPaint, grPaint, paint,
+                                  *draw.fMatrix, (const char *)text, byteLength, pos,
+                                  scalarsPerPos, offset, draw.fClip->getBounds());
+}
+
 void SkGpuDevice::drawTextBlob(const SkDraw& draw, const SkTextBlob* blob, SkScalar x, SkScalar y,
                                const SkPaint& paint, SkDrawFilter* drawFilter) {
     GR_CREATE_TRACE_MARKER_CONTEXT("SkGpuDevice::drawTextBlob", fContext);
@@ -99,6 +99,10 @@ public:
     virtual void drawPosText(const SkDraw&, const void* text, size_t len,
                              const SkScalar pos[], int scalarsPerPos,
                              const SkPoint& offset, const SkPaint&) override;
+    void drawPosTextHalo(const SkDraw&, const void* text, size_t len,
+                         const SkScalar pos[], int scalarsPerPos,
+                         const SkPoint& offset, const SkPaint& haloPaint,
+                         const SkPaint&) override;
     virtual void drawTextBlob(const SkDraw&, const SkTextBlob*, SkScalar x, SkScalar y,
                               const SkPaint& paint, SkDrawFilter* drawFilter) override;
     virtual void drawVertices(const SkDraw&, SkCanvas::VertexMode, int vertexCount,
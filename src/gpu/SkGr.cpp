@@ -298,6 +298,32 @@ static GrTexture *load_etc1_texture(GrContext* ctx, const GrUniqueKey& optionalK
 
     return create_texture_for_bmp(ctx, optionalKey, desc, bm.pixelRef(), bytes, 0);
 }
+
+// Bitmaps smaller than this aren't worth the time to compress.
+static const int kMinCompressedBitmapArea = 256 * 256;
+
+static GrTexture* compress_static_bitmap(GrContext* ctx, const GrUniqueKey& optionalKey,
+                                         const SkBitmap& bm, GrSurfaceDesc desc) {
+    // Only compress bitmaps that won't change, since every change would encode again.
+    if (!bm.isImmutable() || !bm.isOpaque() ||
+        bm.width() * bm.height() < kMinCompressedBitmapArea ||
+        (kN32_SkColorType != bm.colorType() && kRGB_565_SkColorType != bm.colorType())) {
+        return NULL;
+    }
+
+    SkAutoLockPixels alp(bm);
+    if (!bm.readyToDraw()) {
+        return NULL;
+    }
+    SkAutoTUnref<SkData> data(SkTextureCompressor::CompressBitmapToFormat(
+            bm, SkTextureCompressor::kETC1_Format));
+    if (!data) {
+        // E.g. the dimensions aren't multiples of the block size.
+        return NULL;
+    }
+    desc.fConfig = kETC1_GrPixelConfig;
+    return create_texture_for_bmp(ctx, optionalKey, desc, bm.pixelRef(), data->data(), 0);
+}
 #endif   // SK_IGNORE_ETC1_SUPPORT
 
 static GrTexture* load_yuv_texture(GrContext* ctx, const GrUniqueKey& optionalKey,
@@ -446,6 +472,14 @@ static GrTexture* create_unstretched_bitmap_texture(GrContext* ctx,
             return texture;
         }
     }
+
+    if (ctx->getOptions().fCompressStaticBitmapTextures &&
+        ctx->isConfigTexturable(kETC1_GrPixelConfig)) {
+        GrTexture *texture = compress_static_bitmap(ctx, optionalKey, *bitmap, desc);
+        if (texture) {
+            return texture;
+        }
+    }
 #endif   // SK_IGNORE_ETC1_SUPPORT
 
     GrTexture *texture = load_yuv_texture(ctx, optionalKey, *bitmap, desc);
@@ -78,6 +78,12 @@ struct DashCircleVertex {
     SkScalar fRadius;
     SkScalar fCenterX;
 };
+struct DashPolylineVertex {
+    SkPoint fPos;
+    SkPoint fDashPos;
+    SkScalar fIntervalLength;
+    SkScalar fParams[4];
+};
 };
 
 static void calc_dash_scaling(SkScalar* parallelScale, SkScalar* perpScale,
@@ -748,6 +754,394 @@ bool GrDashingEffect::DrawDashLine(GrGpu* gpu, GrDrawTarget* target,
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Beyond this device space stroke width the unjoined segment quads drawn by DashPolylineBatch
+// would leave visible notches on the outside of corners, so wider strokes are dashed on the CPU.
+static const SkScalar kMaxPolylineDashStrokeWidth = 4;
+
+// Returns whether or not the gpu can dash the polyline in the fragment shader. On success
+// devScale is how much the view matrix scales src space lengths by.
+static bool can_fast_path_dash_polyline(const SkPath& path, const GrStrokeInfo& strokeInfo,
+                                        const GrPipelineBuilder& pipelineBuilder,
+                                        const SkMatrix& viewMatrix, SkScalar* devScale) {
+    if (pipelineBuilder.getRenderTarget()->isMultisampled()) {
+        return false;
+    }
+
+    if (path.isInverseFillType() || SkPath::kLine_SegmentMask != path.getSegmentMasks()) {
+        return false;
+    }
+
+    // Arc lengths are measured in device space, so the view matrix may only scale them uniformly
+    if (!viewMatrix.isSimilarity()) {
+        return false;
+    }
+
+    if (!strokeInfo.isDashed() || 2 != strokeInfo.dashCount()) {
+        return false;
+    }
+
+    const SkPathEffect::DashInfo& info = strokeInfo.getDashInfo();
+    if (0 == info.fIntervals[0] && 0 == info.fIntervals[1]) {
+        return false;
+    }
+
+    const SkStrokeRec& stroke = strokeInfo.getStrokeRec();
+    if (SkStrokeRec::kStroke_Style != stroke.getStyle() &&
+        SkStrokeRec::kHairline_Style != stroke.getStyle()) {
+        return false;
+    }
+
+    SkVector scale = SkVector::Make(SK_Scalar1, 0);
+    viewMatrix.mapVectors(&scale, 1);
+    *devScale = scale.length();
+    if (stroke.getWidth() * *devScale > kMaxPolylineDashStrokeWidth) {
+        return false;
+    }
+
+    return true;
+}
+
+static GrGeometryProcessor* create_dash_polyline_gp(GrColor,
+                                                    GrPrimitiveEdgeType edgeType,
+                                                    SkPaint::Cap cap,
+                                                    const SkMatrix& localMatrix);
+
+/**
+ * Draws dashed polylines without expanding the dashes. Every line segment is drawn as a quad
+ * carrying its dash position, the device space arc length from the start of its contour offset
+ * by the phase, and the fragment shader evaluates the dash pattern and caps from that. The quads
+ * aren't joined, which is only unnoticeable for thin strokes; see kMaxPolylineDashStrokeWidth.
+ */
+class DashPolylineBatch : public GrBatch {
+public:
+    struct Geometry {
+        GrColor fColor;
+        SkMatrix fViewMatrix;
+        SkPath fPath;
+        SkScalar fDevScale;
+        SkScalar fSrcStrokeWidth;
+        SkScalar fPhase;
+        SkScalar fIntervals[2];
+    };
+
+    static GrBatch* Create(const Geometry& geometry, SkPaint::Cap cap, bool useAA) {
+        return SkNEW_ARGS(DashPolylineBatch, (geometry, cap, useAA));
+    }
+
+    const char* name() const override { return "DashPolylineBatch"; }
+
+    void getInvariantOutputColor(GrInitInvariantOutput* out) const override {
+        // When this is called on a batch, there is only one geometry bundle
+        out->setKnownFourComponents(fGeoData[0].fColor);
+    }
+    void getInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        out->setUnknownSingleComponent();
+    }
+
+    void initBatchTracker(const GrPipelineInfo& init) override {
+        // Handle any color overrides
+        if (init.fColorIgnored) {
+            fGeoData[0].fColor = GrColor_ILLEGAL;
+        } else if (GrColor_ILLEGAL != init.fOverrideColor) {
+            fGeoData[0].fColor = init.fOverrideColor;
+        }
+
+        // setup batch properties
+        fBatch.fColorIgnored = init.fColorIgnored;
+        fBatch.fColor = fGeoData[0].fColor;
+        fBatch.fUsesLocalCoords = init.fUsesLocalCoords;
+        fBatch.fCoverageIgnored = init.fCoverageIgnored;
+    }
+
+    // A line segment in device space, and everything its quad's vertices need.
+    struct Segment {
+        SkPoint fPts[2];
+        SkScalar fDashStart;
+        SkScalar fLength;
+        // How far the quad reaches past each end of the segment
+        SkScalar fStartExt;
+        SkScalar fEndExt;
+        SkScalar fRadius;
+        SkScalar fIntervalLength;
+        // on interval, half stroke width, and the dash position range of the contour
+        SkScalar fParams[4];
+    };
+
+    void generateGeometry(GrBatchTarget* batchTarget, const GrPipeline* pipeline) override {
+        int instanceCount = fGeoData.count();
+
+        SkMatrix invert;
+        if (this->usesLocalCoords() && !this->viewMatrix().invert(&invert)) {
+            SkDebugf("Failed to invert\n");
+            return;
+        }
+
+        bool useAA = this->useAA();
+        GrPrimitiveEdgeType edgeType = useAA ? kFillAA_GrProcessorEdgeType :
+                                               kFillBW_GrProcessorEdgeType;
+        SkAutoTUnref<const GrGeometryProcessor> gp(create_dash_polyline_gp(this->color(),
+                                                                           edgeType,
+                                                                           this->cap(),
+                                                                           invert));
+
+        batchTarget->initDraw(gp, pipeline);
+
+        // TODO remove this when batch is everywhere
+        GrPipelineInfo init;
+        init.fColorIgnored = fBatch.fColorIgnored;
+        init.fOverrideColor = GrColor_ILLEGAL;
+        init.fCoverageIgnored = fBatch.fCoverageIgnored;
+        init.fUsesLocalCoords = this->usesLocalCoords();
+        gp->initBatchTracker(batchTarget->currentBatchTracker(), init);
+
+        // First we map every contour into device space and measure it, then we generate a quad
+        // per segment.
+        SkSTArray<128, Segment, true> segments;
+        for (int i = 0; i < instanceCount; i++) {
+            const Geometry& args = fGeoData[i];
+
+            SkScalar strokeWidth = args.fSrcStrokeWidth * args.fDevScale;
+            if ((strokeWidth < 1.f && !useAA) || 0.f == strokeWidth) {
+                strokeWidth = 1.f;
+            }
+            // We always want to at least stroke out half a pixel on each side in device space
+            SkScalar halfDevStroke = SkMaxScalar(strokeWidth * 0.5f, 0.5f);
+            SkScalar devBloat = useAA ? 0.5f : 0.f;
+            SkScalar capExt = SkPaint::kButt_Cap != this->cap() ? halfDevStroke : 0.f;
+
+            Segment proto;
+            proto.fStartExt = 0;
+            proto.fEndExt = 0;
+            proto.fRadius = halfDevStroke + devBloat;
+            proto.fIntervalLength = (args.fIntervals[0] + args.fIntervals[1]) * args.fDevScale;
+            proto.fParams[0] = args.fIntervals[0] * args.fDevScale;
+            proto.fParams[1] = halfDevStroke;
+            proto.fParams[2] = args.fPhase * args.fDevScale;
+            proto.fParams[3] = proto.fParams[2];
+
+            int contourStart = segments.count();
+            SkPath::Iter iter(args.fPath, false);
+            SkPoint pts[4];
+            SkPath::Verb verb;
+            do {
+                verb = iter.next(pts);
+                switch (verb) {
+                    case SkPath::kLine_Verb: {
+                        SkPoint devPts[2];
+                        args.fViewMatrix.mapPoints(devPts, pts, 2);
+                        SkScalar length = SkPoint::Distance(devPts[0], devPts[1]);
+                        if (length <= 0) {
+                            break;
+                        }
+                        Segment& segment = segments.push_back(proto);
+                        segment.fPts[0] = devPts[0];
+                        segment.fPts[1] = devPts[1];
+                        segment.fDashStart = proto.fParams[3];
+                        segment.fLength = length;
+                        proto.fParams[3] += length;
+                        break;
+                    }
+                    case SkPath::kMove_Verb:
+                    case SkPath::kClose_Verb:
+                    case SkPath::kDone_Verb:
+                        finish_contour(&segments, contourStart, proto.fParams[3],
+                                       capExt + devBloat);
+                        contourStart = segments.count();
+                        proto.fParams[3] = proto.fParams[2];
+                        break;
+                    default:
+                        SkFAIL("Unexpected verb in dashed polyline.");
+                        break;
+                }
+            } while (SkPath::kDone_Verb != verb);
+        }
+
+        int totalRectCount = segments.count();
+        if (0 == totalRectCount) {
+            return;
+        }
+
+        const GrVertexBuffer* vertexBuffer;
+        int firstVertex;
+
+        size_t vertexStride = gp->getVertexStride();
+        SkASSERT(vertexStride == sizeof(DashPolylineVertex));
+        void* vertices = batchTarget->vertexPool()->makeSpace(vertexStride,
+                                                              totalRectCount * kVertsPerDash,
+                                                              &vertexBuffer,
+                                                              &firstVertex);
+
+        if (!vertices || !batchTarget->quadIndexBuffer()) {
+            SkDebugf("Could not allocate buffers\n");
+            return;
+        }
+
+        DashPolylineVertex* verts = reinterpret_cast<DashPolylineVertex*>(vertices);
+        for (int i = 0; i < totalRectCount; i++) {
+            const Segment& segment = segments[i];
+            SkVector tangent = segment.fPts[1] - segment.fPts[0];
+            tangent.scale(SkScalarInvert(segment.fLength));
+            SkVector normal;
+            tangent.rotateCCW(&normal);
+
+            SkVector startExt, endExt, offset;
+            tangent.scale(segment.fStartExt, &startExt);
+            tangent.scale(segment.fEndExt, &endExt);
+            normal.scale(segment.fRadius, &offset);
+            SkPoint start = segment.fPts[0] - startExt;
+            SkPoint end = segment.fPts[1] + endExt;
+            SkScalar startDashX = segment.fDashStart - segment.fStartExt;
+            SkScalar endDashX = segment.fDashStart + segment.fLength + segment.fEndExt;
+
+            DashPolylineVertex* quad = verts + i * kVertsPerDash;
+            quad[0].fPos = start + offset;
+            quad[0].fDashPos.set(startDashX, segment.fRadius);
+            quad[1].fPos = start - offset;
+            quad[1].fDashPos.set(startDashX, -segment.fRadius);
+            quad[2].fPos = end - offset;
+            quad[2].fDashPos.set(endDashX, -segment.fRadius);
+            quad[3].fPos = end + offset;
+            quad[3].fDashPos.set(endDashX, segment.fRadius);
+            for (int j = 0; j < kVertsPerDash; j++) {
+                quad[j].fIntervalLength = segment.fIntervalLength;
+                memcpy(quad[j].fParams, segment.fParams, sizeof(segment.fParams));
+            }
+        }
+
+        const GrIndexBuffer* dashIndexBuffer = batchTarget->quadIndexBuffer();
+
+        GrDrawTarget::DrawInfo drawInfo;
+        drawInfo.setPrimitiveType(kTriangles_GrPrimitiveType);
+        drawInfo.setStartVertex(0);
+        drawInfo.setStartIndex(0);
+        drawInfo.setVerticesPerInstance(kVertsPerDash);
+        drawInfo.setIndicesPerInstance(kIndicesPerDash);
+        drawInfo.adjustStartVertex(firstVertex);
+        drawInfo.setVertexBuffer(vertexBuffer);
+        drawInfo.setIndexBuffer(dashIndexBuffer);
+
+        int maxInstancesPerDraw = dashIndexBuffer->maxQuads();
+        while (totalRectCount) {
+            drawInfo.setInstanceCount(SkTMin(totalRectCount, maxInstancesPerDraw));
+            drawInfo.setVertexCount(drawInfo.instanceCount() * drawInfo.verticesPerInstance());
+            drawInfo.setIndexCount(drawInfo.instanceCount() * drawInfo.indicesPerInstance());
+
+            batchTarget->draw(drawInfo);
+
+            drawInfo.setStartVertex(drawInfo.startVertex() + drawInfo.vertexCount());
+            totalRectCount -= drawInfo.instanceCount();
+        }
+    }
+
+    SkSTArray<1, Geometry, true>* geoData() { return &fGeoData; }
+
+private:
+    DashPolylineBatch(const Geometry& geometry, SkPaint::Cap cap, bool useAA) {
+        this->initClassID<DashPolylineBatch>();
+        fGeoData.push_back(geometry);
+
+        fBatch.fUseAA = useAA;
+        fBatch.fCap = cap;
+    }
+
+    // Records the dash position where the contour ends on each of its segments, and extends
+    // the first and last quads to cover the contour's caps.
+    static void finish_contour(SkTArray<Segment, true>* segments, int contourStart,
+                               SkScalar dashEnd, SkScalar ext) {
+        if (contourStart == segments->count()) {
+            return;
+        }
+        for (int i = contourStart; i < segments->count(); i++) {
+            (*segments)[i].fParams[3] = dashEnd;
+        }
+        (*segments)[contourStart].fStartExt = ext;
+        segments->back().fEndExt = ext;
+    }
+
+    bool onCombineIfPossible(GrBatch* t) override {
+        DashPolylineBatch* that = t->cast<DashPolylineBatch>();
+
+        if (this->useAA() != that->useAA()) {
+            return false;
+        }
+
+        if (this->cap() != that->cap()) {
+            return false;
+        }
+
+        // TODO vertex color
+        if (this->color() != that->color()) {
+            return false;
+        }
+
+        SkASSERT(this->usesLocalCoords() == that->usesLocalCoords());
+        if (this->usesLocalCoords() && !this->viewMatrix().cheapEqualTo(that->viewMatrix())) {
+            return false;
+        }
+
+        fGeoData.push_back_n(that->geoData()->count(), that->geoData()->begin());
+        return true;
+    }
+
+    GrColor color() const { return fBatch.fColor; }
+    bool usesLocalCoords() const { return fBatch.fUsesLocalCoords; }
+    const SkMatrix& viewMatrix() const { return fGeoData[0].fViewMatrix; }
+    bool useAA() const { return fBatch.fUseAA; }
+    SkPaint::Cap cap() const { return fBatch.fCap; }
+
+    struct BatchTracker {
+        GrColor fColor;
+        bool fUsesLocalCoords;
+        bool fColorIgnored;
+        bool fCoverageIgnored;
+        SkPaint::Cap fCap;
+        bool fUseAA;
+    };
+
+    static const int kVertsPerDash = 4;
+    static const int kIndicesPerDash = 6;
+
+    BatchTracker fBatch;
+    SkSTArray<1, Geometry, true> fGeoData;
+};
+
+bool GrDashingEffect::DrawDashPolyline(GrGpu*, GrDrawTarget* target,
+                                       GrPipelineBuilder* pipelineBuilder, GrColor color,
+                                       const SkMatrix& viewMatrix, const SkPath& path,
+                                       const GrPaint& paint, const GrStrokeInfo& strokeInfo) {
+    SkScalar devScale;
+    if (!can_fast_path_dash_polyline(path, strokeInfo, *pipelineBuilder, viewMatrix,
+                                     &devScale)) {
+        return false;
+    }
+
+    const SkPathEffect::DashInfo& info = strokeInfo.getDashInfo();
+
+    // the phase should be normalized to be [0, sum of all intervals)
+    SkASSERT(info.fPhase >= 0 && info.fPhase < info.fIntervals[0] + info.fIntervals[1]);
+
+    DashPolylineBatch::Geometry geometry;
+    geometry.fColor = color;
+    geometry.fViewMatrix = viewMatrix;
+    geometry.fPath = path;
+    geometry.fDevScale = devScale;
+    geometry.fSrcStrokeWidth = strokeInfo.getStrokeRec().getWidth();
+    geometry.fPhase = info.fPhase;
+    geometry.fIntervals[0] = info.fIntervals[0];
+    geometry.fIntervals[1] = info.fIntervals[1];
+
+    // Hairlines don't have caps
+    SkPaint::Cap cap = 0 == geometry.fSrcStrokeWidth ? SkPaint::kButt_Cap :
+                                                       strokeInfo.getStrokeRec().getCap();
+
+    SkAutoTUnref<GrBatch> batch(DashPolylineBatch::Create(geometry, cap, paint.isAntiAlias()));
+    target->drawBatch(pipelineBuilder, batch);
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 class GLDashingCircleEffect;
 
 struct DashingCircleBatchTracker {
@@ -1250,6 +1644,293 @@ GrGeometryProcessor* DashingLineEffect::TestCreate(SkRandom* random,
 
 //////////////////////////////////////////////////////////////////////////////
 
+class GLDashingPolylineEffect;
+
+struct DashingPolylineBatchTracker {
+    GrGPInput fInputColorType;
+    GrColor  fColor;
+    bool fUsesLocalCoords;
+};
+
+/*
+ * This effect will draw a dashed polyline with butt, square or round caps. Unlike
+ * DashingLineEffect the dash position isn't relative to a single line: its x is the arc length
+ * along the contour (in device space, offset by the phase) and its y is the signed distance from
+ * the segment. The effect also requires a vec4 vertex attribute holding the on interval, half the
+ * stroke width, and the range of dash positions the contour spans, which dashes are clipped to.
+ */
+class DashingPolylineEffect : public GrGeometryProcessor {
+public:
+    typedef SkPathEffect::DashInfo DashInfo;
+
+    static GrGeometryProcessor* Create(GrColor,
+                                       GrPrimitiveEdgeType edgeType,
+                                       SkPaint::Cap cap,
+                                       const SkMatrix& localMatrix);
+
+    virtual ~DashingPolylineEffect();
+
+    const char* name() const override { return "DashingPolylineEffect"; }
+
+    const Attribute* inPosition() const { return fInPosition; }
+
+    const Attribute* inDashParams() const { return fInDashParams; }
+
+    const Attribute* inPolylineParams() const { return fInPolylineParams; }
+
+    GrPrimitiveEdgeType getEdgeType() const { return fEdgeType; }
+
+    SkPaint::Cap getCap() const { return fCap; }
+
+    virtual void getGLProcessorKey(const GrBatchTracker& bt,
+                                   const GrGLCaps& caps,
+                                   GrProcessorKeyBuilder* b) const override;
+
+    virtual GrGLPrimitiveProcessor* createGLInstance(const GrBatchTracker& bt,
+                                                     const GrGLCaps&) const override;
+
+    void initBatchTracker(GrBatchTracker* bt, const GrPipelineInfo& init) const override;
+
+    bool onCanMakeEqual(const GrBatchTracker&,
+                        const GrGeometryProcessor&,
+                        const GrBatchTracker&) const override;
+
+private:
+    DashingPolylineEffect(GrColor, GrPrimitiveEdgeType edgeType, SkPaint::Cap cap,
+                          const SkMatrix& localMatrix);
+
+    bool onIsEqual(const GrGeometryProcessor& other) const override;
+
+    void onGetInvariantOutputCoverage(GrInitInvariantOutput*) const override;
+
+    GrPrimitiveEdgeType fEdgeType;
+    SkPaint::Cap        fCap;
+    const Attribute*    fInPosition;
+    const Attribute*    fInDashParams;
+    const Attribute*    fInPolylineParams;
+
+    GR_DECLARE_GEOMETRY_PROCESSOR_TEST;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+class GLDashingPolylineEffect : public GrGLGeometryProcessor {
+public:
+    GLDashingPolylineEffect(const GrGeometryProcessor&, const GrBatchTracker&);
+
+    void onEmitCode(EmitArgs&, GrGPArgs*) override;
+
+    static inline void GenKey(const GrGeometryProcessor&,
+                              const GrBatchTracker&,
+                              const GrGLCaps&,
+                              GrProcessorKeyBuilder*);
+
+    virtual void setData(const GrGLProgramDataManager&,
+                         const GrPrimitiveProcessor&,
+                         const GrBatchTracker&) override;
+
+private:
+    GrColor       fColor;
+    UniformHandle fColorUniform;
+    typedef GrGLGeometryProcessor INHERITED;
+};
+
+GLDashingPolylineEffect::GLDashingPolylineEffect(const GrGeometryProcessor&,
+                                                 const GrBatchTracker&) {
+    fColor = GrColor_ILLEGAL;
+}
+
+void GLDashingPolylineEffect::onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) {
+    const DashingPolylineEffect& de = args.fGP.cast<DashingPolylineEffect>();
+    const DashingPolylineBatchTracker& local = args.fBT.cast<DashingPolylineBatchTracker>();
+    GrGLGPBuilder* pb = args.fPB;
+
+    GrGLVertexBuilder* vsBuilder = args.fPB->getVertexShaderBuilder();
+
+    // emit attributes
+    vsBuilder->emitAttributes(de);
+
+    // XY refers to dashPos, Z is the dash interval length
+    GrGLVertToFrag inDashParams(kVec3f_GrSLType);
+    args.fPB->addVarying("DashParams", &inDashParams);
+    vsBuilder->codeAppendf("%s = %s;", inDashParams.vsOut(), de.inDashParams()->fName);
+
+    // XYZW refer to the on interval, half the stroke width, and the start and end of the contour
+    GrGLVertToFrag inPolylineParams(kVec4f_GrSLType);
+    args.fPB->addVarying("PolylineParams", &inPolylineParams);
+    vsBuilder->codeAppendf("%s = %s;", inPolylineParams.vsOut(), de.inPolylineParams()->fName);
+
+    // Setup pass through color
+    this->setupColorPassThrough(pb, local.fInputColorType, args.fOutputColor, NULL, &fColorUniform);
+
+    // Setup position
+    this->setupPosition(pb, gpArgs, de.inPosition()->fName, de.viewMatrix());
+
+    // emit transforms
+    this->emitTransforms(args.fPB, gpArgs->fPositionVar, de.inPosition()->fName, de.localMatrix(),
+                         args.fTransformsIn, args.fTransformsOut);
+
+    // Computes the coverage of the dash that starts at dash position start, clipped to the
+    // contour and then capped. Butt and square caps are box filtered along and across the
+    // segment; round caps are antialiased by the distance to the dash's spine.
+    static const GrGLShaderVar gDashArgs[] = {
+        GrGLShaderVar("start", kFloat_GrSLType),
+        GrGLShaderVar("pos", kVec3f_GrSLType),
+        GrGLShaderVar("params", kVec4f_GrSLType),
+    };
+    SkString body;
+    body.append("\tfloat a = max(start, params.z);\n"
+                "\tfloat b = min(start + params.x, params.w);\n"
+                "\tif (b < a) {\n"
+                "\t\treturn 0.0;\n"
+                "\t}\n");
+    if (SkPaint::kRound_Cap == de.getCap()) {
+        body.append("\tfloat d = length(vec2(max(max(a - pos.x, pos.x - b), 0.0), pos.y));\n"
+                    "\treturn clamp(params.y + 0.5 - d, 0.0, 1.0);\n");
+    } else {
+        if (SkPaint::kSquare_Cap == de.getCap()) {
+            body.append("\ta -= params.y;\n"
+                        "\tb += params.y;\n");
+        }
+        body.append("\tfloat along = clamp(min(pos.x + 0.5, b) - max(pos.x - 0.5, a), 0.0, 1.0);\n"
+                    "\tfloat across = clamp(min(pos.y + 0.5, params.y) - "
+                    "max(pos.y - 0.5, -params.y), 0.0, 1.0);\n"
+                    "\treturn along * across;\n");
+    }
+    GrGLGPFragmentBuilder* fsBuilder = args.fPB->getFragmentShaderBuilder();
+    SkString dashName;
+    fsBuilder->emitFunction(kFloat_GrSLType,
+                            "dash_coverage",
+                            SK_ARRAY_COUNT(gDashArgs),
+                            gDashArgs,
+                            body.c_str(),
+                            &dashName);
+
+    // Caps can reach into the off interval on either side of the dash the fragment is in, so
+    // the neighboring dashes are checked too.
+    const char* dashPos = inDashParams.fsIn();
+    const char* params = inPolylineParams.fsIn();
+    fsBuilder->codeAppendf("float dashStart = floor(%s.x / %s.z) * %s.z;",
+                           dashPos, dashPos, dashPos);
+    fsBuilder->codeAppendf("float alpha = %s(dashStart, %s, %s);", dashName.c_str(), dashPos,
+                           params);
+    fsBuilder->codeAppendf("alpha = max(alpha, %s(dashStart - %s.z, %s, %s));", dashName.c_str(),
+                           dashPos, dashPos, params);
+    fsBuilder->codeAppendf("alpha = max(alpha, %s(dashStart + %s.z, %s, %s));", dashName.c_str(),
+                           dashPos, dashPos, params);
+    if (!GrProcessorEdgeTypeIsAA(de.getEdgeType())) {
+        fsBuilder->codeAppend("alpha = alpha >= 0.5 ? 1.0 : 0.0;");
+    }
+    fsBuilder->codeAppendf("%s = vec4(alpha);", args.fOutputCoverage);
+}
+
+void GLDashingPolylineEffect::setData(const GrGLProgramDataManager& pdman,
+                                      const GrPrimitiveProcessor& processor,
+                                      const GrBatchTracker& bt) {
+    this->setUniformViewMatrix(pdman, processor.viewMatrix());
+
+    const DashingPolylineBatchTracker& local = bt.cast<DashingPolylineBatchTracker>();
+    if (kUniform_GrGPInput == local.fInputColorType && local.fColor != fColor) {
+        GrGLfloat c[4];
+        GrColorToRGBAFloat(local.fColor, c);
+        pdman.set4fv(fColorUniform, 1, c);
+        fColor = local.fColor;
+    }
+}
+
+void GLDashingPolylineEffect::GenKey(const GrGeometryProcessor& gp,
+                                     const GrBatchTracker& bt,
+                                     const GrGLCaps&,
+                                     GrProcessorKeyBuilder* b) {
+    const DashingPolylineBatchTracker& local = bt.cast<DashingPolylineBatchTracker>();
+    const DashingPolylineEffect& de = gp.cast<DashingPolylineEffect>();
+    uint32_t key = 0;
+    key |= local.fUsesLocalCoords && gp.localMatrix().hasPerspective() ? 0x1 : 0x0;
+    key |= ComputePosKey(gp.viewMatrix()) << 1;
+    key |= de.getEdgeType() << 8;
+    key |= de.getCap() << 11;
+    b->add32(key << 16 | local.fInputColorType);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+GrGeometryProcessor* DashingPolylineEffect::Create(GrColor color,
+                                                   GrPrimitiveEdgeType edgeType,
+                                                   SkPaint::Cap cap,
+                                                   const SkMatrix& localMatrix) {
+    return SkNEW_ARGS(DashingPolylineEffect, (color, edgeType, cap, localMatrix));
+}
+
+DashingPolylineEffect::~DashingPolylineEffect() {}
+
+void DashingPolylineEffect::onGetInvariantOutputCoverage(GrInitInvariantOutput* out) const {
+    out->setUnknownSingleComponent();
+}
+
+void DashingPolylineEffect::getGLProcessorKey(const GrBatchTracker& bt,
+                                              const GrGLCaps& caps,
+                                              GrProcessorKeyBuilder* b) const {
+    GLDashingPolylineEffect::GenKey(*this, bt, caps, b);
+}
+
+GrGLPrimitiveProcessor* DashingPolylineEffect::createGLInstance(const GrBatchTracker& bt,
+                                                                const GrGLCaps&) const {
+    return SkNEW_ARGS(GLDashingPolylineEffect, (*this, bt));
+}
+
+DashingPolylineEffect::DashingPolylineEffect(GrColor color,
+                                             GrPrimitiveEdgeType edgeType,
+                                             SkPaint::Cap cap,
+                                             const SkMatrix& localMatrix)
+    : INHERITED(color, SkMatrix::I(), localMatrix), fEdgeType(edgeType), fCap(cap) {
+    this->initClassID<DashingPolylineEffect>();
+    fInPosition = &this->addVertexAttrib(Attribute("inPosition", kVec2f_GrVertexAttribType));
+    fInDashParams = &this->addVertexAttrib(Attribute("inDashParams", kVec3f_GrVertexAttribType));
+    fInPolylineParams = &this->addVertexAttrib(Attribute("inPolylineParams",
+                                                         kVec4f_GrVertexAttribType));
+}
+
+bool DashingPolylineEffect::onIsEqual(const GrGeometryProcessor& other) const {
+    const DashingPolylineEffect& de = other.cast<DashingPolylineEffect>();
+    return fEdgeType == de.fEdgeType && fCap == de.fCap;
+}
+
+void DashingPolylineEffect::initBatchTracker(GrBatchTracker* bt,
+                                             const GrPipelineInfo& init) const {
+    DashingPolylineBatchTracker* local = bt->cast<DashingPolylineBatchTracker>();
+    local->fInputColorType = GetColorInputType(&local->fColor, this->color(), init, false);
+    local->fUsesLocalCoords = init.fUsesLocalCoords;
+}
+
+bool DashingPolylineEffect::onCanMakeEqual(const GrBatchTracker& m,
+                                           const GrGeometryProcessor& that,
+                                           const GrBatchTracker& t) const {
+    const DashingPolylineBatchTracker& mine = m.cast<DashingPolylineBatchTracker>();
+    const DashingPolylineBatchTracker& theirs = t.cast<DashingPolylineBatchTracker>();
+    return CanCombineLocalMatrices(*this, mine.fUsesLocalCoords,
+                                   that, theirs.fUsesLocalCoords) &&
+           CanCombineOutput(mine.fInputColorType, mine.fColor,
+                            theirs.fInputColorType, theirs.fColor);
+}
+
+GR_DEFINE_GEOMETRY_PROCESSOR_TEST(DashingPolylineEffect);
+
+GrGeometryProcessor* DashingPolylineEffect::TestCreate(SkRandom* random,
+                                                       GrContext*,
+                                                       const GrDrawTargetCaps& caps,
+                                                       GrTexture*[]) {
+    GrPrimitiveEdgeType edgeType = static_cast<GrPrimitiveEdgeType>(random->nextULessThan(
+            kGrProcessorEdgeTypeCnt));
+    SkPaint::Cap cap = static_cast<SkPaint::Cap>(random->nextULessThan(SkPaint::kCapCount));
+
+    return DashingPolylineEffect::Create(GrRandomColor(random), edgeType, cap,
+                                         GrProcessorUnitTest::TestMatrix(random));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 static GrGeometryProcessor* create_dash_gp(GrColor color,
                                            GrPrimitiveEdgeType edgeType,
                                            DashCap cap,
@@ -1264,3 +1945,10 @@ static GrGeometryProcessor* create_dash_gp(GrColor color,
     }
     return NULL;
 }
+
+static GrGeometryProcessor* create_dash_polyline_gp(GrColor color,
+                                                    GrPrimitiveEdgeType edgeType,
+                                                    SkPaint::Cap cap,
+                                                    const SkMatrix& localMatrix) {
+    return DashingPolylineEffect::Create(color, edgeType, cap, localMatrix);
+}
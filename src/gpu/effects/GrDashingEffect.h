@@ -19,11 +19,21 @@ class GrGpu;
 class GrPaint;
 class GrPipelineBuilder;
 class GrStrokeInfo;
+class SkPath;
 
 namespace GrDashingEffect {
     bool DrawDashLine(GrGpu*, GrDrawTarget*, GrPipelineBuilder*, GrColor,
                       const SkMatrix& viewMatrix, const SkPoint pts[2], const GrPaint& paint,
                       const GrStrokeInfo& strokeInfo);
+
+    /**
+     * Draws a dashed path made only of line segments by evaluating the dash pattern in the
+     * fragment shader, so the dashes never need to be expanded into geometry. Returns false if
+     * the path, stroke or view matrix can't be drawn this way.
+     */
+    bool DrawDashPolyline(GrGpu*, GrDrawTarget*, GrPipelineBuilder*, GrColor,
+                          const SkMatrix& viewMatrix, const SkPath& path, const GrPaint& paint,
+                          const GrStrokeInfo& strokeInfo);
 }
 
 #endif
@@ -32,10 +32,7 @@ public:
     GrGLDistanceFieldTextureEffect(const GrGeometryProcessor&,
                                    const GrBatchTracker&)
         : fColor(GrColor_ILLEGAL)
-#ifdef SK_GAMMA_APPLY_TO_A8
-        , fDistanceAdjust(-1.0f)
-#endif
-        {}
+        , fDistanceAdjust(-1.0f) {}
 
     void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override{
         const GrDistanceFieldTextureEffect& dfTexEffect =
@@ -58,17 +55,22 @@ public:
         GrGLVertToFrag uv(kVec2f_GrSLType);
         args.fPB->addVarying("TextureCoords", &uv, kHigh_GrSLPrecision);
         // this is only used with text, so our texture bounds always match the glyph atlas
-        vsBuilder->codeAppendf("%s = vec2(" GR_FONT_ATLAS_A8_RECIP_WIDTH ", "
-                               GR_FONT_ATLAS_RECIP_HEIGHT ")*%s;", uv.vsOut(),
-                               dfTexEffect.inTextureCoords()->fName);
-#ifdef SK_GAMMA_APPLY_TO_A8
-        // adjust based on gamma
+        bool isMultiChannel =
+                SkToBool(dfTexEffect.getFlags() & kMultiChannel_DistanceFieldEffectFlag);
+        if (isMultiChannel) {
+            vsBuilder->codeAppendf("%s = vec2(" GR_FONT_ATLAS_RECIP_WIDTH ", "
+                                   GR_FONT_ATLAS_RECIP_HEIGHT ")*%s;", uv.vsOut(),
+                                   dfTexEffect.inTextureCoords()->fName);
+        } else {
+            vsBuilder->codeAppendf("%s = vec2(" GR_FONT_ATLAS_A8_RECIP_WIDTH ", "
+                                   GR_FONT_ATLAS_RECIP_HEIGHT ")*%s;", uv.vsOut(),
+                                   dfTexEffect.inTextureCoords()->fName);
+        }
+        // adjust based on gamma, and for halos
         const char* distanceAdjustUniName = NULL;
-        // width, height, 1/(3*width)
         fDistanceAdjustUni = args.fPB->addUniform(GrGLProgramBuilder::kFragment_Visibility,
             kFloat_GrSLType, kDefault_GrSLPrecision,
             "DistanceAdjust", &distanceAdjustUniName);
-#endif
 
         // Setup pass through color
         this->setupColorPassThrough(pb, local.fInputColorType, args.fOutputColor,
@@ -86,17 +88,27 @@ public:
                                                              pb->ctxInfo().standard()));
         fsBuilder->codeAppendf("vec2 uv = %s;\n", uv.fsIn());
 
-        fsBuilder->codeAppend("\tfloat texColor = ");
-        fsBuilder->appendTextureLookup(args.fSamplers[0],
-                                       "uv",
-                                       kVec2f_GrSLType);
-        fsBuilder->codeAppend(".r;\n");
+        if (isMultiChannel) {
+            // the median of the three channels follows the nearest edge except at corners,
+            // where two channels agree on the sharp corner
+            fsBuilder->codeAppend("\tvec3 msdf = ");
+            fsBuilder->appendTextureLookup(args.fSamplers[0],
+                                           "uv",
+                                           kVec2f_GrSLType);
+            fsBuilder->codeAppend(".rgb;\n");
+            fsBuilder->codeAppend("\tfloat texColor = max(min(msdf.r, msdf.g), "
+                                  "min(max(msdf.r, msdf.g), msdf.b));\n");
+        } else {
+            fsBuilder->codeAppend("\tfloat texColor = ");
+            fsBuilder->appendTextureLookup(args.fSamplers[0],
+                                           "uv",
+                                           kVec2f_GrSLType);
+            fsBuilder->codeAppend(".r;\n");
+        }
         fsBuilder->codeAppend("\tfloat distance = "
                        SK_DistanceFieldMultiplier "*(texColor - " SK_DistanceFieldThreshold ");");
-#ifdef SK_GAMMA_APPLY_TO_A8
-        // adjust width based on gamma
+        // adjust width based on gamma, or widen it for a halo
         fsBuilder->codeAppendf("distance -= %s;", distanceAdjustUniName);
-#endif
 
         fsBuilder->codeAppend(GrGLShaderVar::PrecisionString(kHigh_GrSLPrecision,
                                                              pb->ctxInfo().standard()));
@@ -139,7 +151,6 @@ public:
     virtual void setData(const GrGLProgramDataManager& pdman,
                          const GrPrimitiveProcessor& proc,
                          const GrBatchTracker& bt) override {
-#ifdef SK_GAMMA_APPLY_TO_A8
         const GrDistanceFieldTextureEffect& dfTexEffect =
                 proc.cast<GrDistanceFieldTextureEffect>();
         float distanceAdjust = dfTexEffect.getDistanceAdjust();
@@ -147,7 +158,6 @@ public:
             pdman.set1f(fDistanceAdjustUni, distanceAdjust);
             fDistanceAdjust = distanceAdjust;
         }
-#endif
 
         this->setUniformViewMatrix(pdman, proc.viewMatrix());
 
@@ -176,10 +186,8 @@ public:
 private:
     GrColor       fColor;
     UniformHandle fColorUniform;
-#ifdef SK_GAMMA_APPLY_TO_A8
     float         fDistanceAdjust;
     UniformHandle fDistanceAdjustUni;
-#endif
 
     typedef GrGLGeometryProcessor INHERITED;
 };
@@ -190,15 +198,11 @@ GrDistanceFieldTextureEffect::GrDistanceFieldTextureEffect(GrColor color,
                                                            const SkMatrix& viewMatrix,
                                                            GrTexture* texture,
                                                            const GrTextureParams& params,
-#ifdef SK_GAMMA_APPLY_TO_A8
                                                            float distanceAdjust,
-#endif
                                                            uint32_t flags, bool opaqueVertexColors)
     : INHERITED(color, viewMatrix, SkMatrix::I(), opaqueVertexColors)
     , fTextureAccess(texture, params)
-#ifdef SK_GAMMA_APPLY_TO_A8
     , fDistanceAdjust(distanceAdjust)
-#endif
     , fFlags(flags & kNonLCD_DistanceFieldEffectMask)
     , fInColor(NULL) {
     SkASSERT(!(flags & ~kNonLCD_DistanceFieldEffectMask));
@@ -215,10 +219,7 @@ GrDistanceFieldTextureEffect::GrDistanceFieldTextureEffect(GrColor color,
 
 bool GrDistanceFieldTextureEffect::onIsEqual(const GrGeometryProcessor& other) const {
     const GrDistanceFieldTextureEffect& cte = other.cast<GrDistanceFieldTextureEffect>();
-    return
-#ifdef SK_GAMMA_APPLY_TO_A8
-           fDistanceAdjust == cte.fDistanceAdjust &&
-#endif
+    return fDistanceAdjust == cte.fDistanceAdjust &&
            fFlags == cte.fFlags;
 }
 
@@ -267,6 +268,8 @@ GrGeometryProcessor* GrDistanceFieldTextureEffect::TestCreate(SkRandom* random,
                                                               GrTexture* textures[]) {
     int texIdx = random->nextBool() ? GrProcessorUnitTest::kSkiaPMTextureIdx :
                                       GrProcessorUnitTest::kAlphaTextureIdx;
+    uint32_t flags = random->nextBool() ? kSimilarity_DistanceFieldEffectFlag : 0;
+    flags |= random->nextBool() ? kMultiChannel_DistanceFieldEffectFlag : 0;
     static const SkShader::TileMode kTileModes[] = {
         SkShader::kClamp_TileMode,
         SkShader::kRepeat_TileMode,
@@ -282,11 +285,8 @@ GrGeometryProcessor* GrDistanceFieldTextureEffect::TestCreate(SkRandom* random,
     return GrDistanceFieldTextureEffect::Create(GrRandomColor(random),
                                                 GrProcessorUnitTest::TestMatrix(random),
                                                 textures[texIdx], params,
-#ifdef SK_GAMMA_APPLY_TO_A8
                                                 random->nextF(),
-#endif
-                                                random->nextBool() ?
-                                                    kSimilarity_DistanceFieldEffectFlag : 0,
+                                                flags,
                                                 random->nextBool());
 }
 
@@ -23,6 +23,7 @@ enum GrDistanceFieldEffectFlags {
     kBGR_DistanceFieldEffectFlag        = 0x08,   // lcd display has bgr order
     kPortrait_DistanceFieldEffectFlag   = 0x10,   // lcd display is in portrait mode (not used yet)
     kColorAttr_DistanceFieldEffectFlag  = 0x20,   // color vertex attribute
+    kMultiChannel_DistanceFieldEffectFlag = 0x40, // median of three distances in the 8888 atlas
 
     kInvalid_DistanceFieldEffectFlag    = 0x80,   // invalid state (for initialization)
     
@@ -30,7 +31,8 @@ enum GrDistanceFieldEffectFlags {
                                             kRectToRect_DistanceFieldEffectFlag,
     // The subset of the flags relevant to GrDistanceFieldTextureEffect
     kNonLCD_DistanceFieldEffectMask       = kSimilarity_DistanceFieldEffectFlag |
-                                            kColorAttr_DistanceFieldEffectFlag,
+                                            kColorAttr_DistanceFieldEffectFlag |
+                                            kMultiChannel_DistanceFieldEffectFlag,
     // The subset of the flags relevant to GrDistanceFieldLCDTextureEffect
     kLCD_DistanceFieldEffectMask          = kSimilarity_DistanceFieldEffectFlag |
                                             kRectToRect_DistanceFieldEffectFlag |
@@ -43,24 +45,20 @@ enum GrDistanceFieldEffectFlags {
  * distance field texture (using a smoothed step function near 0.5).
  * It allows explicit specification of the filtering and wrap modes (GrTextureParams). The input
  * coords are a custom attribute. Gamma correction is handled via a texture LUT.
+ * With kMultiChannel_DistanceFieldEffectFlag the texture holds three distances per texel, and
+ * their median is the distance used.
  */
 class GrDistanceFieldTextureEffect : public GrGeometryProcessor {
 public:
-#ifdef SK_GAMMA_APPLY_TO_A8
+    // distanceAdjust is subtracted from the distance to the glyph edge, in texels: positive
+    // values thin the glyphs (as the gamma correction may), negative ones dilate them.
     static GrGeometryProcessor* Create(GrColor color, const SkMatrix& viewMatrix, GrTexture* tex,
-                                       const GrTextureParams& params,
-                                       float lum, uint32_t flags, bool opaqueVertexColors) {
-       return SkNEW_ARGS(GrDistanceFieldTextureEffect, (color, viewMatrix, tex, params, lum,
-                                                        flags, opaqueVertexColors));
-    }
-#else
-    static GrGeometryProcessor* Create(GrColor color, const SkMatrix& viewMatrix, GrTexture* tex,
-                                       const GrTextureParams& params,
+                                       const GrTextureParams& params, float distanceAdjust,
                                        uint32_t flags, bool opaqueVertexColors) {
-        return  SkNEW_ARGS(GrDistanceFieldTextureEffect, (color, viewMatrix, tex, params, flags,
-                                                          opaqueVertexColors));
+       return SkNEW_ARGS(GrDistanceFieldTextureEffect, (color, viewMatrix, tex, params,
+                                                        distanceAdjust, flags,
+                                                        opaqueVertexColors));
     }
-#endif
 
     virtual ~GrDistanceFieldTextureEffect() {}
 
@@ -69,9 +67,7 @@ public:
     const Attribute* inPosition() const { return fInPosition; }
     const Attribute* inColor() const { return fInColor; }
     const Attribute* inTextureCoords() const { return fInTextureCoords; }
-#ifdef SK_GAMMA_APPLY_TO_A8
     float getDistanceAdjust() const { return fDistanceAdjust; }
-#endif
     uint32_t getFlags() const { return fFlags; }
 
     virtual void getGLProcessorKey(const GrBatchTracker& bt,
@@ -89,10 +85,7 @@ public:
 
 private:
     GrDistanceFieldTextureEffect(GrColor, const SkMatrix& viewMatrix, GrTexture* texture,
-                                 const GrTextureParams& params,
-#ifdef SK_GAMMA_APPLY_TO_A8
-                                 float distanceAdjust,
-#endif
+                                 const GrTextureParams& params, float distanceAdjust,
                                  uint32_t flags, bool opaqueVertexColors);
 
     bool onIsEqual(const GrGeometryProcessor& other) const override;
@@ -100,9 +93,7 @@ private:
     void onGetInvariantOutputCoverage(GrInitInvariantOutput*) const override;
 
     GrTextureAccess  fTextureAccess;
-#ifdef SK_GAMMA_APPLY_TO_A8
     float            fDistanceAdjust;
-#endif
     uint32_t         fFlags;
     const Attribute* fInPosition;
     const Attribute* fInColor;
@@ -208,6 +208,18 @@ const GrGLInterface* GrGLAssembleGLInterface(void* ctx, GrGLGetProc get) {
         GET_PROC(FlushMappedBufferRange);
     }
 
+    if (glVer >= GR_GL_VER(4,4) || extensions.has("GL_ARB_buffer_storage")) {
+        // no ARB suffix for GL_ARB_buffer_storage
+        GET_PROC(BufferStorage);
+    }
+
+    if (glVer >= GR_GL_VER(3,1) || extensions.has("GL_ARB_uniform_buffer_object")) {
+        // no ARB suffix for GL_ARB_uniform_buffer_object
+        GET_PROC(BindBufferBase);
+        GET_PROC(GetUniformBlockIndex);
+        GET_PROC(UniformBlockBinding);
+    }
+
     // First look for GL3.0 FBO or GL_ARB_framebuffer_object (same since
     // GL_ARB_framebuffer_object doesn't use ARB suffix.)
     if (glVer >= GR_GL_VER(3,0) || extensions.has("GL_ARB_framebuffer_object")) {
@@ -301,6 +313,27 @@ const GrGLInterface* GrGLAssembleGLInterface(void* ctx, GrGLGetProc get) {
         GET_PROC(GetProgramResourceLocation);
     }
 
+    if (glVer >= GR_GL_VER(3,3)) {
+        GET_PROC(DrawArraysInstanced);
+        GET_PROC(VertexAttribDivisor);
+    } else if (extensions.has("GL_ARB_draw_instanced") &&
+               extensions.has("GL_ARB_instanced_arrays")) {
+        GET_PROC_SUFFIX(DrawArraysInstanced, ARB);
+        GET_PROC_SUFFIX(VertexAttribDivisor, ARB);
+    }
+
+    if (glVer >= GR_GL_VER(3,2) || extensions.has("GL_ARB_sync")) {
+        GET_PROC(FenceSync);
+        GET_PROC(ClientWaitSync);
+        GET_PROC(DeleteSync);
+    }
+
+    if (glVer >= GR_GL_VER(4,1) || extensions.has("GL_ARB_get_program_binary")) {
+        GET_PROC(GetProgramBinary);
+        GET_PROC(ProgramBinary);
+        GET_PROC(ProgramParameteri);
+    }
+
     interface->fStandard = kGL_GrGLStandard;
     interface->fExtensions.swap(&extensions);
 
@@ -464,6 +497,12 @@ const GrGLInterface* GrGLAssembleGLESInterface(void* ctx, GrGLGetProc get) {
     GET_PROC_SUFFIX(MapBuffer, OES);
     GET_PROC_SUFFIX(UnmapBuffer, OES);
 
+    if (version >= GR_GL_VER(3,0)) {
+        GET_PROC(BindBufferBase);
+        GET_PROC(GetUniformBlockIndex);
+        GET_PROC(UniformBlockBinding);
+    }
+
     if (version >= GR_GL_VER(3,0)) {
         GET_PROC(MapBufferRange);
         GET_PROC(FlushMappedBufferRange);
@@ -472,6 +511,10 @@ const GrGLInterface* GrGLAssembleGLESInterface(void* ctx, GrGLGetProc get) {
         GET_PROC_SUFFIX(FlushMappedBufferRange, EXT);
     }
 
+    if (extensions.has("GL_EXT_buffer_storage")) {
+        GET_PROC_SUFFIX(BufferStorage, EXT);
+    }
+
     if (extensions.has("GL_EXT_debug_marker")) {
         GET_PROC(InsertEventMarker);
         GET_PROC(PushGroupMarker);
@@ -496,6 +539,31 @@ const GrGLInterface* GrGLAssembleGLESInterface(void* ctx, GrGLGetProc get) {
         GET_PROC(GetProgramResourceLocation);
     }
 
+    // ES 2's GL_EXT_instanced_arrays has no gl_VertexID to go with it, so we don't use it.
+    if (version >= GR_GL_VER(3,0)) {
+        GET_PROC(DrawArraysInstanced);
+        GET_PROC(VertexAttribDivisor);
+    }
+
+    if (version >= GR_GL_VER(3,0)) {
+        GET_PROC(FenceSync);
+        GET_PROC(ClientWaitSync);
+        GET_PROC(DeleteSync);
+    } else if (extensions.has("GL_APPLE_sync")) {
+        GET_PROC_SUFFIX(FenceSync, APPLE);
+        GET_PROC_SUFFIX(ClientWaitSync, APPLE);
+        GET_PROC_SUFFIX(DeleteSync, APPLE);
+    }
+
+    if (version >= GR_GL_VER(3,0)) {
+        GET_PROC(GetProgramBinary);
+        GET_PROC(ProgramBinary);
+        GET_PROC(ProgramParameteri);
+    } else if (extensions.has("GL_OES_get_program_binary")) {
+        GET_PROC_SUFFIX(GetProgramBinary, OES);
+        GET_PROC_SUFFIX(ProgramBinary, OES);
+    }
+
     if (extensions.has("GL_NV_path_rendering")) {
         GET_PROC_SUFFIX(MatrixLoadf, EXT);
         GET_PROC_SUFFIX(MatrixLoadIdentity, EXT);
@@ -23,7 +23,8 @@
 GrGLBufferImpl::GrGLBufferImpl(GrGLGpu* gpu, const Desc& desc, GrGLenum bufferType)
     : fDesc(desc)
     , fBufferType(bufferType)
-    , fMapPtr(NULL) {
+    , fMapPtr(NULL)
+    , fPersistentPtr(NULL) {
     if (0 == desc.fID) {
         fCPUData = sk_malloc_flags(desc.fSizeInBytes, SK_MALLOC_THROW);
         fGLSizeInBytes = 0;
@@ -31,6 +32,11 @@ GrGLBufferImpl::GrGLBufferImpl(GrGLGpu* gpu, const Desc& desc, GrGLenum bufferTy
         fCPUData = NULL;
         // We assume that the GL buffer was created at the desc's size initially.
         fGLSizeInBytes = fDesc.fSizeInBytes;
+        if (fDesc.fPersistent) {
+            this->bind(gpu);
+            GR_GL_CALL_RET(gpu->glInterface(), fPersistentPtr,
+                           MapBufferRange(fBufferType, 0, fGLSizeInBytes, kPersistentFlags));
+        }
     }
     VALIDATE();
 }
@@ -42,6 +48,11 @@ void GrGLBufferImpl::release(GrGLGpu* gpu) {
         sk_free(fCPUData);
         fCPUData = NULL;
     } else if (fDesc.fID) {
+        if (fPersistentPtr) {
+            this->bind(gpu);
+            GL_CALL(gpu, UnmapBuffer(fBufferType));
+            fPersistentPtr = NULL;
+        }
         GL_CALL(gpu, DeleteBuffers(1, &fDesc.fID));
         if (GR_GL_ARRAY_BUFFER == fBufferType) {
             gpu->notifyVertexBufferDelete(fDesc.fID);
@@ -60,6 +71,7 @@ void GrGLBufferImpl::abandon() {
     fDesc.fID = 0;
     fGLSizeInBytes = 0;
     fMapPtr = NULL;
+    fPersistentPtr = NULL;
     sk_free(fCPUData);
     fCPUData = NULL;
     VALIDATE();
@@ -81,6 +93,10 @@ void* GrGLBufferImpl::map(GrGLGpu* gpu) {
     SkASSERT(!this->isMapped());
     if (0 == fDesc.fID) {
         fMapPtr = fCPUData;
+    } else if (fDesc.fPersistent) {
+        // Already mapped. The caller is responsible for not writing over anything the GPU may
+        // still read.
+        fMapPtr = fPersistentPtr;
     } else {
         switch (gpu->glCaps().mapBufferType()) {
             case GrGLCaps::kNone_MapBufferType:
@@ -136,7 +152,7 @@ void* GrGLBufferImpl::map(GrGLGpu* gpu) {
 void GrGLBufferImpl::unmap(GrGLGpu* gpu) {
     VALIDATE();
     SkASSERT(this->isMapped());
-    if (0 != fDesc.fID) {
+    if (0 != fDesc.fID && !fDesc.fPersistent) {
         switch (gpu->glCaps().mapBufferType()) {
             case GrGLCaps::kNone_MapBufferType:
                 SkDEBUGFAIL("Shouldn't get here.");
@@ -170,6 +186,16 @@ bool GrGLBufferImpl::updateData(GrGLGpu* gpu, const void* src, size_t srcSizeInB
         memcpy(fCPUData, src, srcSizeInBytes);
         return true;
     }
+    if (fDesc.fPersistent) {
+        // The store is immutable, so glBufferData isn't allowed.
+        if (fPersistentPtr) {
+            memcpy(fPersistentPtr, src, srcSizeInBytes);
+        } else {
+            this->bind(gpu);
+            GL_CALL(gpu, BufferSubData(fBufferType, 0, (GrGLsizeiptr) srcSizeInBytes, src));
+        }
+        return true;
+    }
     this->bind(gpu);
     GrGLenum usage = fDesc.fDynamic ? DYNAMIC_USAGE_PARAM : GR_GL_STATIC_DRAW;
 
@@ -222,4 +248,6 @@ void GrGLBufferImpl::validate() const {
     SkASSERT(NULL == fCPUData || 0 == fGLSizeInBytes);
     SkASSERT(NULL == fMapPtr || fCPUData || fGLSizeInBytes == fDesc.fSizeInBytes);
     SkASSERT(NULL == fCPUData || NULL == fMapPtr || fCPUData == fMapPtr);
+    SkASSERT(NULL == fPersistentPtr || fDesc.fPersistent);
+    SkASSERT(!fDesc.fPersistent || NULL == fMapPtr || fPersistentPtr == fMapPtr);
 }
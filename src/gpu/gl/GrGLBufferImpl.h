@@ -9,6 +9,7 @@
 #define GrGLBufferImpl_DEFINED
 
 #include "SkTypes.h"
+#include "GrGLDefines.h"
 #include "gl/GrGLFunctions.h"
 
 class GrGLGpu;
@@ -23,8 +24,15 @@ public:
         GrGLuint    fID;            // set to 0 to indicate buffer is CPU-backed and not a VBO.
         size_t      fSizeInBytes;
         bool        fDynamic;
+        bool        fPersistent;    // the GL buffer's store came from glBufferStorage with
+                                    // kPersistentFlags and it stays mapped while it exists.
     };
 
+    // Storage flags for, and access used to map, persistent buffers.
+    static const GrGLbitfield kPersistentFlags = GR_GL_MAP_WRITE_BIT |
+                                                 GR_GL_MAP_PERSISTENT_BIT |
+                                                 GR_GL_MAP_COHERENT_BIT;
+
     GrGLBufferImpl(GrGLGpu*, const Desc&, GrGLenum bufferType);
     ~GrGLBufferImpl() {
         // either release or abandon should have been called by the owner of this object.
@@ -51,6 +59,7 @@ private:
     GrGLenum     fBufferType; // GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
     void*        fCPUData;
     void*        fMapPtr;
+    void*        fPersistentPtr;     // The lifetime mapping of a persistent buffer.
     size_t       fGLSizeInBytes;     // In certain cases we make the size of the GL buffer object
                                      // smaller or larger than the size in fDesc.
 
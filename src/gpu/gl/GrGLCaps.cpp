@@ -46,6 +46,10 @@ void GrGLCaps::reset() {
     fFragCoordsConventionSupport = false;
     fVertexArrayObjectSupport = false;
     fES2CompatibilitySupport = false;
+    fProgramBinarySupport = false;
+    fPixelBufferSupport = false;
+    fFenceSyncSupport = false;
+    fUniformBufferSupport = false;
     fUseNonVBOVertexAndIndexDynamicData = false;
     fIsCoreProfile = false;
     fFullClearIsFree = false;
@@ -92,6 +96,10 @@ GrGLCaps& GrGLCaps::operator= (const GrGLCaps& caps) {
     fFragCoordsConventionSupport = caps.fFragCoordsConventionSupport;
     fVertexArrayObjectSupport = caps.fVertexArrayObjectSupport;
     fES2CompatibilitySupport = caps.fES2CompatibilitySupport;
+    fProgramBinarySupport = caps.fProgramBinarySupport;
+    fPixelBufferSupport = caps.fPixelBufferSupport;
+    fFenceSyncSupport = caps.fFenceSyncSupport;
+    fUniformBufferSupport = caps.fUniformBufferSupport;
     fUseNonVBOVertexAndIndexDynamicData = caps.fUseNonVBOVertexAndIndexDynamicData;
     fIsCoreProfile = caps.fIsCoreProfile;
     fFullClearIsFree = caps.fFullClearIsFree;
@@ -254,6 +262,33 @@ bool GrGLCaps::init(const GrGLContextInfo& ctxInfo, const GrGLInterface* gli) {
         fES2CompatibilitySupport = true;
     }
 
+    // A driver may expose the entry points but no binary formats, in which case it can't hand us
+    // anything back to reload.
+    if (gli->fFunctions.fGetProgramBinary && gli->fFunctions.fProgramBinary) {
+        GrGLint formats = 0;
+        GR_GL_GetIntegerv(gli, GR_GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        fProgramBinarySupport = formats > 0;
+    }
+
+    if (kGL_GrGLStandard == standard) {
+        fPixelBufferSupport = version >= GR_GL_VER(2, 1) ||
+                              ctxInfo.hasExtension("GL_ARB_pixel_buffer_object");
+    } else {
+        fPixelBufferSupport = version >= GR_GL_VER(3, 0) ||
+                              ctxInfo.hasExtension("GL_NV_pixel_buffer_object");
+    }
+
+    fFenceSyncSupport = gli->fFunctions.fFenceSync && gli->fFunctions.fClientWaitSync &&
+                        gli->fFunctions.fDeleteSync;
+
+    // std140 uniform blocks need GLSL 1.40 on desktop and GLSL ES 3.00.
+    GrGLSLGeneration uboGeneration = kGL_GrGLStandard == standard ? k140_GrGLSLGeneration
+                                                                  : k330_GrGLSLGeneration;
+    fUniformBufferSupport = gli->fFunctions.fBindBufferBase &&
+                            gli->fFunctions.fGetUniformBlockIndex &&
+                            gli->fFunctions.fUniformBlockBinding &&
+                            ctxInfo.glslGeneration() >= uboGeneration;
+
     if (kGLES_GrGLStandard == standard) {
         if (ctxInfo.hasExtension("GL_EXT_shader_framebuffer_fetch")) {
             fFBFetchNeedsCustomOutput = (version >= GR_GL_VER(3, 0));
@@ -322,6 +357,13 @@ bool GrGLCaps::init(const GrGLContextInfo& ctxInfo, const GrGLInterface* gli) {
         }
     }
 
+    // Dynamic buffers can be given immutable storage and mapped once, persistently and coherently.
+    // Reusing their memory safely takes a fence, and CPU-backed buffers don't need any of it.
+    if (kMapBufferRange_MapBufferType == fMapBufferType && gli->fFunctions.fBufferStorage &&
+        fFenceSyncSupport && !fUseNonVBOVertexAndIndexDynamicData) {
+        fMapBufferFlags |= kPersistent_MapFlag;
+    }
+
     if (kGL_GrGLStandard == standard) {
         SkASSERT(ctxInfo.version() >= GR_GL_VER(2,0) ||
                  ctxInfo.hasExtension("GL_ARB_texture_non_power_of_two"));
@@ -422,6 +464,11 @@ bool GrGLCaps::init(const GrGLContextInfo& ctxInfo, const GrGLInterface* gli) {
         fOversizedStencilSupport = ctxInfo.version() >= GR_GL_VER(3, 0);
     }
 
+    // Instances are expanded from gl_VertexID, which arrived with GLSL 1.30 and ES 3.0.
+    fInstancedDrawingSupport = gli->fFunctions.fDrawArraysInstanced &&
+                               gli->fFunctions.fVertexAttribDivisor &&
+                               ctxInfo.glslGeneration() >= k130_GrGLSLGeneration;
+
     this->initConfigTexturableTable(ctxInfo, gli);
     this->initConfigRenderableTable(ctxInfo);
 
@@ -1051,6 +1098,10 @@ SkString GrGLCaps::dump() const {
     r.appendf("Fragment coord conventions support: %s\n",
              (fFragCoordsConventionSupport ? "YES": "NO"));
     r.appendf("Vertex array object support: %s\n", (fVertexArrayObjectSupport ? "YES": "NO"));
+    r.appendf("Program binary support: %s\n", (fProgramBinarySupport ? "YES": "NO"));
+    r.appendf("Pixel buffer support: %s\n", (fPixelBufferSupport ? "YES": "NO"));
+    r.appendf("Fence sync support: %s\n", (fFenceSyncSupport ? "YES": "NO"));
+    r.appendf("Uniform buffer support: %s\n", (fUniformBufferSupport ? "YES": "NO"));
     r.appendf("Use non-VBO for dynamic data: %s\n",
              (fUseNonVBOVertexAndIndexDynamicData ? "YES" : "NO"));
     r.appendf("Full screen clear is free: %s\n", (fFullClearIsFree ? "YES" : "NO"));
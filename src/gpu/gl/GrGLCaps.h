@@ -252,6 +252,18 @@ public:
     /// Is there support for ES2 compatability?
     bool ES2CompatibilitySupport() const { return fES2CompatibilitySupport; }
 
+    /// Can linked programs be read back with glGetProgramBinary and reloaded with glProgramBinary?
+    bool programBinarySupport() const { return fProgramBinarySupport; }
+
+    /// Can texture uploads be sourced from a buffer bound to GL_PIXEL_UNPACK_BUFFER?
+    bool pixelBufferSupport() const { return fPixelBufferSupport; }
+
+    /// Is there support for glFenceSync and glClientWaitSync?
+    bool fenceSyncSupport() const { return fFenceSyncSupport; }
+
+    /// Can programs keep their uniforms in a std140 uniform block backed by a buffer?
+    bool uniformBufferSupport() const { return fUniformBufferSupport; }
+
     /// Use indices or vertices in CPU arrays rather than VBOs for dynamic content.
     bool useNonVBOVertexAndIndexDynamicData() const {
         return fUseNonVBOVertexAndIndexDynamicData;
@@ -385,6 +397,10 @@ private:
     bool fFragCoordsConventionSupport : 1;
     bool fVertexArrayObjectSupport : 1;
     bool fES2CompatibilitySupport : 1;
+    bool fProgramBinarySupport : 1;
+    bool fPixelBufferSupport : 1;
+    bool fFenceSyncSupport : 1;
+    bool fUniformBufferSupport : 1;
     bool fUseNonVBOVertexAndIndexDynamicData : 1;
     bool fIsCoreProfile : 1;
     bool fFullClearIsFree : 1;
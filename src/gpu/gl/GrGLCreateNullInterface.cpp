@@ -127,6 +127,7 @@ public:
     BufferManager   fBufferManager;
     GrGLuint        fCurrArrayBuffer;
     GrGLuint        fCurrElementArrayBuffer;
+    GrGLuint        fCurrPixelUnpackBuffer;
     GrGLuint        fCurrProgramID;
     GrGLuint        fCurrShaderID;
 
@@ -137,6 +138,7 @@ public:
     ThreadContext()
         : fCurrArrayBuffer(0)
         , fCurrElementArrayBuffer(0)
+        , fCurrPixelUnpackBuffer(0)
         , fCurrProgramID(0)
         , fCurrShaderID(0) {}
 
@@ -178,6 +180,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferData(GrGLenum target,
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         id = ctx->fCurrElementArrayBuffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        id = ctx->fCurrPixelUnpackBuffer;
+        break;
     default:
         SkFAIL("Unexpected target to nullGLBufferData");
         break;
@@ -189,6 +194,14 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferData(GrGLenum target,
     }
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferStorage(GrGLenum target,
+                                                 GrGLsizeiptr size,
+                                                 const GrGLvoid* data,
+                                                 GrGLbitfield flags) {
+    // Storage flags don't change anything here.
+    nullGLBufferData(target, size, data, GR_GL_DYNAMIC_DRAW);
+}
+
 GrGLvoid GR_GL_FUNCTION_TYPE nullGLPixelStorei(GrGLenum pname, GrGLint param) {}
 GrGLvoid GR_GL_FUNCTION_TYPE nullGLReadPixels(GrGLint x, GrGLint y, GrGLsizei width, GrGLsizei height, GrGLenum format, GrGLenum type, GrGLvoid* pixels) {}
 GrGLvoid GR_GL_FUNCTION_TYPE nullGLUseProgram(GrGLuint program) {}
@@ -221,6 +234,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBindBuffer(GrGLenum target, GrGLuint buffer)
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         ctx->fCurrElementArrayBuffer = buffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        ctx->fCurrPixelUnpackBuffer = buffer;
+        break;
     }
 }
 
@@ -234,6 +250,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLDeleteBuffers(GrGLsizei n, const GrGLuint* id
         if (ids[i] == ctx->fCurrElementArrayBuffer) {
             ctx->fCurrElementArrayBuffer = 0;
         }
+        if (ids[i] == ctx->fCurrPixelUnpackBuffer) {
+            ctx->fCurrPixelUnpackBuffer = 0;
+        }
 
         BufferObj* buffer = ctx->fBufferManager.lookUp(ids[i]);
         ctx->fBufferManager.free(buffer);
@@ -360,9 +379,11 @@ const GrGLInterface* GrGLCreateNullInterface() {
     functions->fBlendFunc = noOpGLBlendFunc;
     functions->fBufferData = nullGLBufferData;
     functions->fBufferSubData = noOpGLBufferSubData;
+    functions->fBufferStorage = nullGLBufferStorage;
     functions->fClear = noOpGLClear;
     functions->fClearColor = noOpGLClearColor;
     functions->fClearStencil = noOpGLClearStencil;
+    functions->fClientWaitSync = noOpGLClientWaitSync;
     functions->fColorMask = noOpGLColorMask;
     functions->fCompileShader = noOpGLCompileShader;
     functions->fCompressedTexImage2D = noOpGLCompressedTexImage2D;
@@ -375,18 +396,21 @@ const GrGLInterface* GrGLCreateNullInterface() {
     functions->fDeleteProgram = nullGLDelete;
     functions->fDeleteQueries = noOpGLDeleteIds;
     functions->fDeleteShader = nullGLDelete;
+    functions->fDeleteSync = noOpGLDeleteSync;
     functions->fDeleteTextures = noOpGLDeleteIds;
     functions->fDeleteVertexArrays = noOpGLDeleteIds;
     functions->fDepthMask = noOpGLDepthMask;
     functions->fDisable = noOpGLDisable;
     functions->fDisableVertexAttribArray = noOpGLDisableVertexAttribArray;
     functions->fDrawArrays = noOpGLDrawArrays;
+    functions->fDrawArraysInstanced = noOpGLDrawArraysInstanced;
     functions->fDrawBuffer = noOpGLDrawBuffer;
     functions->fDrawBuffers = noOpGLDrawBuffers;
     functions->fDrawElements = noOpGLDrawElements;
     functions->fEnable = noOpGLEnable;
     functions->fEnableVertexAttribArray = noOpGLEnableVertexAttribArray;
     functions->fEndQuery = noOpGLEndQuery;
+    functions->fFenceSync = noOpGLFenceSync;
     functions->fFinish = noOpGLFinish;
     functions->fFlush = noOpGLFlush;
     functions->fFlushMappedBufferRange = nullGLFlushMappedBufferRange;
@@ -404,6 +428,7 @@ const GrGLInterface* GrGLCreateNullInterface() {
     functions->fGetQueryObjectui64v = noOpGLGetQueryObjectui64v;
     functions->fGetQueryObjectuiv = noOpGLGetQueryObjectuiv;
     functions->fGetQueryiv = noOpGLGetQueryiv;
+    functions->fGetProgramBinary = noOpGLGetProgramBinary;
     functions->fGetProgramInfoLog = noOpGLGetInfoLog;
     functions->fGetProgramiv = noOpGLGetShaderOrProgramiv;
     functions->fGetShaderInfoLog = noOpGLGetInfoLog;
@@ -419,6 +444,7 @@ const GrGLInterface* GrGLCreateNullInterface() {
     functions->fMapBufferRange = nullGLMapBufferRange;
     functions->fPixelStorei = nullGLPixelStorei;
     functions->fPopGroupMarker = noOpGLPopGroupMarker;
+    functions->fProgramBinary = noOpGLProgramBinary;
     functions->fPushGroupMarker = noOpGLPushGroupMarker;
     functions->fQueryCounter = noOpGLQueryCounter;
     functions->fReadBuffer = noOpGLReadBuffer;
@@ -462,6 +488,7 @@ const GrGLInterface* GrGLCreateNullInterface() {
     functions->fVertexAttrib2fv = noOpGLVertexAttrib2fv;
     functions->fVertexAttrib3fv = noOpGLVertexAttrib3fv;
     functions->fVertexAttrib4fv = noOpGLVertexAttrib4fv;
+    functions->fVertexAttribDivisor = noOpGLVertexAttribDivisor;
     functions->fVertexAttribPointer = noOpGLVertexAttribPointer;
     functions->fViewport = nullGLViewport;
     functions->fBindFramebuffer = nullGLBindFramebuffer;
@@ -88,6 +88,9 @@
 #define GR_GL_ELEMENT_ARRAY_BUFFER           0x8893
 #define GR_GL_ARRAY_BUFFER_BINDING           0x8894
 #define GR_GL_ELEMENT_ARRAY_BUFFER_BINDING   0x8895
+#define GR_GL_PIXEL_UNPACK_BUFFER            0x88EC
+#define GR_GL_UNIFORM_BUFFER                 0x8A11
+#define GR_GL_INVALID_INDEX                  0xFFFFFFFF
 
 #define GR_GL_STREAM_DRAW                    0x88E0
 #define GR_GL_STATIC_DRAW                    0x88E4
@@ -415,6 +418,19 @@
 #define GR_GL_MAX_FRAGMENT_UNIFORM_COMPONENTS  0x8B49
 #define GR_GL_MAX_VERTEX_UNIFORM_COMPONENTS    0x8B4A
 
+/* Program binaries */
+#define GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT  0x8257
+#define GR_GL_PROGRAM_BINARY_LENGTH            0x8741
+#define GR_GL_NUM_PROGRAM_BINARY_FORMATS       0x87FE
+
+/* Sync objects */
+#define GR_GL_SYNC_GPU_COMMANDS_COMPLETE         0x9117
+#define GR_GL_SYNC_FLUSH_COMMANDS_BIT            0x00000001
+#define GR_GL_ALREADY_SIGNALED                   0x911A
+#define GR_GL_TIMEOUT_EXPIRED                    0x911B
+#define GR_GL_CONDITION_SATISFIED                0x911C
+#define GR_GL_WAIT_FAILED                        0x911D
+
 /* StencilFunction */
 #define GR_GL_NEVER                          0x0200
 #define GR_GL_LESS                           0x0201
@@ -688,6 +704,10 @@
 #define GR_GL_MAP_INVALIDATE_BUFFER_BIT          0x0008
 #define GR_GL_MAP_FLUSH_EXPLICIT_BIT             0x0010
 #define GR_GL_MAP_UNSYNCHRONIZED_BIT             0x0020
+#define GR_GL_MAP_PERSISTENT_BIT                 0x0040
+#define GR_GL_MAP_COHERENT_BIT                   0x0080
+#define GR_GL_DYNAMIC_STORAGE_BIT                0x0100
+#define GR_GL_CLIENT_STORAGE_BIT                 0x0200
 
 /* Read Format */
 #define GR_GL_IMPLEMENTATION_COLOR_READ_TYPE   0x8B9A
@@ -151,9 +151,11 @@ GrGLGpu::GrGLGpu(const GrGLContext& ctx, GrContext* context)
 
     fLastSuccessfulStencilFmtIdx = 0;
     fHWProgramID = 0;
+    fHWBoundUniformBufferID = 0;
     fTempSrcFBOID = 0;
     fTempDstFBOID = 0;
     fStencilClearFBOID = 0;
+    fTransferBufferID = 0;
 
     if (this->glCaps().pathRenderingSupport()) {
         fPathRendering.reset(new GrGLPathRendering(this));
@@ -177,6 +179,9 @@ GrGLGpu::~GrGLGpu() {
     if (0 != fStencilClearFBOID) {
         GL_CALL(DeleteFramebuffers(1, &fStencilClearFBOID));
     }
+    if (0 != fTransferBufferID) {
+        GL_CALL(DeleteBuffers(1, &fTransferBufferID));
+    }
 
     delete fProgramCache;
 }
@@ -185,9 +190,11 @@ void GrGLGpu::contextAbandoned() {
     INHERITED::contextAbandoned();
     fProgramCache->abandon();
     fHWProgramID = 0;
+    fHWBoundUniformBufferID = 0;
     fTempSrcFBOID = 0;
     fTempDstFBOID = 0;
     fStencilClearFBOID = 0;
+    fTransferBufferID = 0;
     if (this->glCaps().pathRenderingSupport()) {
         this->glPathRendering()->abandonGpuResources();
     }
@@ -358,6 +365,15 @@ void GrGLGpu::onResetContext(uint32_t resetBits) {
 
     if (resetBits & kProgram_GrGLBackendState) {
         fHWProgramID = 0;
+        fHWBoundUniformBufferID = 0;
+    }
+}
+
+void GrGLGpu::bindUniformBuffer(GrGLuint id) {
+    SkASSERT(this->glCaps().uniformBufferSupport());
+    if (fHWBoundUniformBufferID != id) {
+        GL_CALL(BindBufferBase(GR_GL_UNIFORM_BUFFER, 0, id));
+        fHWBoundUniformBufferID = id;
     }
 }
 
@@ -471,7 +487,7 @@ GrRenderTarget* GrGLGpu::onWrapBackendRenderTarget(const GrBackendRenderTargetDe
 bool GrGLGpu::onWriteTexturePixels(GrTexture* texture,
                                    int left, int top, int width, int height,
                                    GrPixelConfig config, const void* buffer,
-                                   size_t rowBytes) {
+                                   size_t rowBytes, bool async) {
     if (NULL == buffer) {
         return false;
     }
@@ -488,7 +504,8 @@ bool GrGLGpu::onWriteTexturePixels(GrTexture* texture,
                                                 height);
     } else {
         success = this->uploadTexData(glTex->desc(), false, left, top, width, height, config,
-                                      buffer, rowBytes);
+                                      buffer, rowBytes,
+                                      async && this->glCaps().pixelBufferSupport());
     }
 
     if (success) {
@@ -539,8 +556,11 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
                             int left, int top, int width, int height,
                             GrPixelConfig dataConfig,
                             const void* data,
-                            size_t rowBytes) {
+                            size_t rowBytes,
+                            bool viaTransferBuffer) {
     SkASSERT(data || isNewTexture);
+    // Only updates of existing textures go through the transfer buffer.
+    SkASSERT(!viaTransferBuffer || (data && !isNewTexture));
 
     // If we're uploading compressed data then we should be using uploadCompressedTexData
     SkASSERT(!GrPixelConfigIsCompressed(dataConfig));
@@ -551,6 +571,7 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
         return false;
     }
     size_t trimRowBytes = width * bpp;
+    size_t dataRowBytes = rowBytes;
 
     // in case we need a temporary, trimmed copy of the src pixels
     GrAutoMalloc<128 * 128> tempStorage;
@@ -634,6 +655,7 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
                 }
                 // now point data to our copied version
                 data = tempStorage.get();
+                dataRowBytes = trimRowBytes;
             }
         }
         if (glFlipY) {
@@ -683,11 +705,30 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
         if (swFlipY || glFlipY) {
             top = desc.fHeight - (top + height);
         }
-        GL_CALL(TexSubImage2D(GR_GL_TEXTURE_2D,
-                              0, // level
-                              left, top,
-                              width, height,
-                              externalFormat, externalType, data));
+        if (viaTransferBuffer) {
+            SkASSERT(this->glCaps().pixelBufferSupport());
+            if (0 == fTransferBufferID) {
+                GL_CALL(GenBuffers(1, &fTransferBufferID));
+            }
+            // The last row needn't be padded out to the row length.
+            size_t size = (height - 1) * dataRowBytes + trimRowBytes;
+            GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, fTransferBufferID));
+            GL_CALL(BufferData(GR_GL_PIXEL_UNPACK_BUFFER, (GrGLsizeiptr) size, data,
+                               GR_GL_STREAM_DRAW));
+            // With a buffer bound, the data pointer becomes an offset into it.
+            GL_CALL(TexSubImage2D(GR_GL_TEXTURE_2D,
+                                  0, // level
+                                  left, top,
+                                  width, height,
+                                  externalFormat, externalType, NULL));
+            GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, 0));
+        } else {
+            GL_CALL(TexSubImage2D(GR_GL_TEXTURE_2D,
+                                  0, // level
+                                  left, top,
+                                  width, height,
+                                  externalFormat, externalType, data));
+        }
     }
 
     if (restoreGLRowLength) {
@@ -1317,6 +1358,7 @@ GrVertexBuffer* GrGLGpu::onCreateVertexBuffer(size_t size, bool dynamic) {
     GrGLVertexBuffer::Desc desc;
     desc.fDynamic = dynamic;
     desc.fSizeInBytes = size;
+    desc.fPersistent = false;
 
     if (this->glCaps().useNonVBOVertexAndIndexDynamicData() && desc.fDynamic) {
         desc.fID = 0;
@@ -1328,11 +1370,22 @@ GrVertexBuffer* GrGLGpu::onCreateVertexBuffer(size_t size, bool dynamic) {
             fHWGeometryState.setVertexBufferID(this, desc.fID);
             CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
             // make sure driver can allocate memory for this buffer
-            GL_ALLOC_CALL(this->glInterface(),
-                          BufferData(GR_GL_ARRAY_BUFFER,
-                                     (GrGLsizeiptr) desc.fSizeInBytes,
-                                     NULL,   // data ptr
-                                     desc.fDynamic ? GR_GL_DYNAMIC_DRAW : GR_GL_STATIC_DRAW));
+            desc.fPersistent = desc.fDynamic &&
+                               SkToBool(GrDrawTargetCaps::kPersistent_MapFlag &
+                                        this->glCaps().mapBufferFlags());
+            if (desc.fPersistent) {
+                GL_ALLOC_CALL(this->glInterface(),
+                              BufferStorage(GR_GL_ARRAY_BUFFER,
+                                            (GrGLsizeiptr) desc.fSizeInBytes,
+                                            NULL,   // data ptr
+                                            GrGLBufferImpl::kPersistentFlags));
+            } else {
+                GL_ALLOC_CALL(this->glInterface(),
+                              BufferData(GR_GL_ARRAY_BUFFER,
+                                         (GrGLsizeiptr) desc.fSizeInBytes,
+                                         NULL,   // data ptr
+                                         desc.fDynamic ? GR_GL_DYNAMIC_DRAW : GR_GL_STATIC_DRAW));
+            }
             if (CHECK_ALLOC_ERROR(this->glInterface()) != GR_GL_NO_ERROR) {
                 GL_CALL(DeleteBuffers(1, &desc.fID));
                 this->notifyVertexBufferDelete(desc.fID);
@@ -1349,6 +1402,7 @@ GrIndexBuffer* GrGLGpu::onCreateIndexBuffer(size_t size, bool dynamic) {
     GrGLIndexBuffer::Desc desc;
     desc.fDynamic = dynamic;
     desc.fSizeInBytes = size;
+    desc.fPersistent = false;
 
     if (this->glCaps().useNonVBOVertexAndIndexDynamicData() && desc.fDynamic) {
         desc.fID = 0;
@@ -1360,11 +1414,22 @@ GrIndexBuffer* GrGLGpu::onCreateIndexBuffer(size_t size, bool dynamic) {
             fHWGeometryState.setIndexBufferIDOnDefaultVertexArray(this, desc.fID);
             CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
             // make sure driver can allocate memory for this buffer
-            GL_ALLOC_CALL(this->glInterface(),
-                          BufferData(GR_GL_ELEMENT_ARRAY_BUFFER,
-                                     (GrGLsizeiptr) desc.fSizeInBytes,
-                                     NULL,  // data ptr
-                                     desc.fDynamic ? GR_GL_DYNAMIC_DRAW : GR_GL_STATIC_DRAW));
+            desc.fPersistent = desc.fDynamic &&
+                               SkToBool(GrDrawTargetCaps::kPersistent_MapFlag &
+                                        this->glCaps().mapBufferFlags());
+            if (desc.fPersistent) {
+                GL_ALLOC_CALL(this->glInterface(),
+                              BufferStorage(GR_GL_ELEMENT_ARRAY_BUFFER,
+                                            (GrGLsizeiptr) desc.fSizeInBytes,
+                                            NULL,  // data ptr
+                                            GrGLBufferImpl::kPersistentFlags));
+            } else {
+                GL_ALLOC_CALL(this->glInterface(),
+                              BufferData(GR_GL_ELEMENT_ARRAY_BUFFER,
+                                         (GrGLsizeiptr) desc.fSizeInBytes,
+                                         NULL,  // data ptr
+                                         desc.fDynamic ? GR_GL_DYNAMIC_DRAW : GR_GL_STATIC_DRAW));
+            }
             if (CHECK_ALLOC_ERROR(this->glInterface()) != GR_GL_NO_ERROR) {
                 GL_CALL(DeleteBuffers(1, &desc.fID));
                 this->notifyIndexBufferDelete(desc.fID);
@@ -1476,10 +1541,19 @@ void GrGLGpu::setupGeometry(const GrPrimitiveProcessor& primProc,
 
         GrGLsizei stride = static_cast<GrGLsizei>(primProc.getVertexStride());
 
-        size_t vertexOffsetInBytes = stride * info.startVertex();
+        // Plain glDrawArrays takes startVertex as its first vertex, so the attrib pointers stay
+        // the same from one such draw to the next. The other draws can only start at the
+        // beginning of the arrays, so their pointers must account for it.
+        size_t vertexOffsetInBytes = 0;
+        if (info.isIndexed() || info.hwInstanceCount() > 0) {
+            vertexOffsetInBytes = stride * info.startVertex();
+        }
 
         vertexOffsetInBytes += vbuf->baseOffset();
 
+        // Instanced draws step every attribute once per instance.
+        GrGLuint divisor = info.hwInstanceCount() > 0 ? 1 : 0;
+
         uint32_t usedAttribArraysMask = 0;
         size_t offset = 0;
 
@@ -1494,7 +1568,8 @@ void GrGLGpu::setupGeometry(const GrPrimitiveProcessor& primProc,
                              GrGLAttribTypeToLayout(attribType).fType,
                              GrGLAttribTypeToLayout(attribType).fNormalized,
                              stride,
-                             reinterpret_cast<GrGLvoid*>(vertexOffsetInBytes + offset));
+                             reinterpret_cast<GrGLvoid*>(vertexOffsetInBytes + offset),
+                             divisor);
             offset += attrib.fOffset;
         }
         attribState->disableUnusedArrays(this, usedAttribArraysMask);
@@ -1561,6 +1636,34 @@ void GrGLGpu::onClear(GrRenderTarget* target, const SkIRect* rect, GrColor color
     GL_CALL(Clear(GR_GL_COLOR_BUFFER_BIT));
 }
 
+GrFence GrGLGpu::insertFence() {
+    if (!this->glCaps().fenceSyncSupport()) {
+        return 0;
+    }
+    GrGLsync sync;
+    GL_CALL_RET(sync, FenceSync(GR_GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    GR_STATIC_ASSERT(sizeof(GrFence) >= sizeof(GrGLsync));
+    return (GrFence)(intptr_t) sync;
+}
+
+bool GrGLGpu::waitFence(GrFence fence, uint64_t timeoutNs) {
+    if (0 == fence) {
+        // No sync objects, so the only way to know the work is done is to wait for all of it.
+        GL_CALL(Finish());
+        return true;
+    }
+    GrGLenum result;
+    GL_CALL_RET(result, ClientWaitSync((GrGLsync)(intptr_t) fence, GR_GL_SYNC_FLUSH_COMMANDS_BIT,
+                                       timeoutNs));
+    return GR_GL_ALREADY_SIGNALED == result || GR_GL_CONDITION_SATISFIED == result;
+}
+
+void GrGLGpu::deleteFence(GrFence fence) {
+    if (0 != fence) {
+        GL_CALL(DeleteSync((GrGLsync)(intptr_t) fence));
+    }
+}
+
 void GrGLGpu::discard(GrRenderTarget* renderTarget) {
     SkASSERT(renderTarget);
     if (!this->caps()->discardRenderTargetSupport()) {
@@ -1902,7 +2005,12 @@ void GrGLGpu::onDraw(const DrawArgs& args, const GrDrawTarget::DrawInfo& info) {
 
     SkASSERT((size_t)info.primitiveType() < SK_ARRAY_COUNT(gPrimitiveType2GLMode));
 
-    if (info.isIndexed()) {
+    if (info.hwInstanceCount() > 0) {
+        SkASSERT(this->glCaps().instancedDrawingSupport() && !info.isIndexed());
+        // As with DrawArrays, setupGeometry has accounted for startVertex, here the first instance.
+        GL_CALL(DrawArraysInstanced(gPrimitiveType2GLMode[info.primitiveType()], 0,
+                                    info.vertexCount(), info.hwInstanceCount()));
+    } else if (info.isIndexed()) {
         GrGLvoid* indices =
             reinterpret_cast<GrGLvoid*>(indexOffsetInBytes + sizeof(uint16_t) * info.startIndex());
         // info.startVertex() was accounted for by setupGeometry.
@@ -1911,10 +2019,9 @@ void GrGLGpu::onDraw(const DrawArgs& args, const GrDrawTarget::DrawInfo& info) {
                              GR_GL_UNSIGNED_SHORT,
                              indices));
     } else {
-        // Pass 0 for parameter first. We have to adjust glVertexAttribPointer() to account for
-        // startVertex in the DrawElements case. So we always rely on setupGeometry to have
-        // accounted for startVertex.
-        GL_CALL(DrawArrays(gPrimitiveType2GLMode[info.primitiveType()], 0, info.vertexCount()));
+        // setupGeometry left startVertex out of the attrib pointers for this case.
+        GL_CALL(DrawArrays(gPrimitiveType2GLMode[info.primitiveType()], info.startVertex(),
+                           info.vertexCount()));
     }
 #if SWAP_PER_DRAW
     glFlush();
@@ -2743,6 +2850,13 @@ bool GrGLGpu::copySurface(GrSurface* dst,
             copied = true;
         }
     }
+    if (copied) {
+        // The copy only wrote the base level
+        GrTexture* dstTexture = dst->asTexture();
+        if (dstTexture) {
+            dstTexture->texturePriv().dirtyMipMaps(true);
+        }
+    }
     return copied;
 }
 
@@ -52,6 +52,10 @@ public:
 
     void discard(GrRenderTarget*) override;
 
+    GrFence insertFence() override;
+    bool waitFence(GrFence, uint64_t timeoutNs) override;
+    void deleteFence(GrFence) override;
+
     // Used by GrGLProgram and GrGLPathTexGenProgramEffects to configure OpenGL
     // state.
     void bindTexture(int unitIdx, const GrTextureParams& params, GrGLTexture* texture);
@@ -82,6 +86,9 @@ public:
     void bindVertexBuffer(GrGLuint id) {
         fHWGeometryState.setVertexBufferID(this, id);
     }
+    // Binds to uniform block binding point 0, which every program's uniform block reads from,
+    // and to the generic GL_UNIFORM_BUFFER target.
+    void bindUniformBuffer(GrGLuint id);
 
     // These callbacks update state tracking when GL objects are deleted. They are called from
     // GrGLResource onRelease functions.
@@ -94,6 +101,11 @@ public:
     void notifyIndexBufferDelete(GrGLuint id) {
         fHWGeometryState.notifyIndexBufferDelete(id);
     }
+    void notifyUniformBufferDelete(GrGLuint id) {
+        if (id == fHWBoundUniformBufferID) {
+            fHWBoundUniformBufferID = 0;
+        }
+    }
 
     bool copySurface(GrSurface* dst,
                      GrSurface* src,
@@ -140,7 +152,7 @@ private:
     bool onWriteTexturePixels(GrTexture* texture,
                               int left, int top, int width, int height,
                               GrPixelConfig config, const void* buffer,
-                              size_t rowBytes) override;
+                              size_t rowBytes, bool async) override;
 
     void onResolveRenderTarget(GrRenderTarget* target) override;
 
@@ -256,13 +268,16 @@ private:
                            GrGLenum* internalFormat,
                            GrGLenum* externalFormat,
                            GrGLenum* externalType);
-    // helper for onCreateTexture and writeTexturePixels
+    // helper for onCreateTexture and writeTexturePixels. If viaTransferBuffer is set the data
+    // is copied into fTransferBufferID and sourced from there, so the driver need not finish
+    // with the client's memory before the call returns.
     bool uploadTexData(const GrSurfaceDesc& desc,
                        bool isNewTexture,
                        int left, int top, int width, int height,
                        GrPixelConfig dataConfig,
                        const void* data,
-                       size_t rowBytes);
+                       size_t rowBytes,
+                       bool viaTransferBuffer = false);
 
     // helper for onCreateCompressedTexture. If width and height are
     // set to -1, then this function will use desc.fWidth and desc.fHeight
@@ -300,6 +315,7 @@ private:
     ///@{
     int                         fHWActiveTextureUnitIdx;
     GrGLuint                    fHWProgramID;
+    GrGLuint                    fHWBoundUniformBufferID;
 
     enum TriState {
         kNo_TriState,
@@ -312,6 +328,10 @@ private:
 
     GrGLuint                    fStencilClearFBOID;
 
+    // Pixel unpack buffer for async texture uploads, created on first use.  Each upload
+    // orphans its storage, so the driver can keep reading the last upload's while we fill it.
+    GrGLuint                    fTransferBufferID;
+
     // last scissor / viewport scissor state seen by the GL.
     struct {
         TriState    fEnabled;
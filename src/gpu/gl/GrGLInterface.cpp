@@ -443,6 +443,14 @@ bool GrGLInterface::validate() const {
         }
     }
 
+    if ((kGL_GrGLStandard == fStandard &&
+         (glVer >= GR_GL_VER(4,4) || fExtensions.has("GL_ARB_buffer_storage"))) ||
+        (kGLES_GrGLStandard == fStandard && fExtensions.has("GL_EXT_buffer_storage"))) {
+        if (NULL == fFunctions.fBufferStorage) {
+            RETURN_FALSE_INTERFACE;
+        }
+    }
+
     if ((kGL_GrGLStandard == fStandard && fExtensions.has("GL_EXT_direct_state_access")) ||
         (kGLES_GrGLStandard == fStandard && fExtensions.has("GL_NV_path_rendering"))) {
         if (NULL == fFunctions.fMatrixLoadf ||
@@ -21,9 +21,13 @@ static const GrGLint kDefaultMaxVertexAttribs = 8;
 // the OpenGLES 2.0 spec says this must be >= 8
 static const GrGLint kDefaultMaxVaryingVectors = 8;
 
+// Size of the program binaries we hand back.
+static const GrGLint kProgramBinaryLength = 4;
+
 static const char* kExtensions[] = {
     "GL_ARB_framebuffer_object",
     "GL_ARB_blend_func_extended",
+    "GL_ARB_buffer_storage",
     "GL_ARB_timer_query",
     "GL_ARB_draw_buffers",
     "GL_ARB_occlusion_query",
@@ -81,6 +85,13 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLClearColor(GrGLclampf red,
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLClearStencil(GrGLint s) {
 }
 
+GrGLenum GR_GL_FUNCTION_TYPE noOpGLClientWaitSync(GrGLsync sync,
+                                                  GrGLbitfield flags,
+                                                  GrGLuint64 timeout) {
+    // Nothing is ever in flight.
+    return GR_GL_ALREADY_SIGNALED;
+}
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLColorMask(GrGLboolean red,
                                              GrGLboolean green,
                                              GrGLboolean blue,
@@ -138,6 +149,12 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawArrays(GrGLenum mode,
                                               GrGLsizei count) {
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawArraysInstanced(GrGLenum mode,
+                                                       GrGLint first,
+                                                       GrGLsizei count,
+                                                       GrGLsizei primcount) {
+}
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawBuffer(GrGLenum mode) {
 }
 
@@ -160,6 +177,15 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLEnableVertexAttribArray(GrGLuint index) {
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLEndQuery(GrGLenum target) {
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDeleteSync(GrGLsync sync) {
+}
+
+GrGLsync GR_GL_FUNCTION_TYPE noOpGLFenceSync(GrGLenum condition, GrGLbitfield flags) {
+    // Any non-NULL value will do, as no one looks inside.
+    static int gSync;
+    return reinterpret_cast<GrGLsync>(&gSync);
+}
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLFinish() {
 }
 
@@ -379,6 +405,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLUniformMatrix4fv(GrGLint location,
  GrGLvoid GR_GL_FUNCTION_TYPE noOpGLVertexAttrib4fv(GrGLuint indx, const GrGLfloat* values) {
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLVertexAttribDivisor(GrGLuint index, GrGLuint divisor) {
+}
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLVertexAttribPointer(GrGLuint indx,
                                                        GrGLint size,
                                                        GrGLenum type,
@@ -519,6 +548,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetIntegerv(GrGLenum pname, GrGLint* params)
         case GR_GL_NUM_EXTENSIONS:
             *params = SK_ARRAY_COUNT(kExtensions);
             break;
+        case GR_GL_NUM_PROGRAM_BINARY_FORMATS:
+            *params = 1;
+            break;
         default:
             SkFAIL("Unexpected pname to GetIntegerv");
    }
@@ -547,6 +579,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetShaderOrProgramiv(GrGLuint program,
         case GR_GL_INFO_LOG_LENGTH:
             *params = 0;
             break;
+        case GR_GL_PROGRAM_BINARY_LENGTH:
+            *params = kProgramBinaryLength;
+            break;
         // we don't expect any other pnames
         default:
             SkFAIL("Unexpected pname to GetProgramiv");
@@ -554,6 +589,25 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetShaderOrProgramiv(GrGLuint program,
    }
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetProgramBinary(GrGLuint program,
+                                                    GrGLsizei bufsize,
+                                                    GrGLsizei* length,
+                                                    GrGLenum* binaryFormat,
+                                                    GrGLvoid* binary) {
+    GrGLsizei written = SkTMin<GrGLsizei>(bufsize, kProgramBinaryLength);
+    memset(binary, 0, written);
+    if (length) {
+        *length = written;
+    }
+    *binaryFormat = 0;
+}
+
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLProgramBinary(GrGLuint program,
+                                                 GrGLenum binaryFormat,
+                                                 const GrGLvoid* binary,
+                                                 GrGLsizei length) {
+}
+
 namespace {
 template <typename T>
 void query_result(GrGLenum GLtarget, GrGLenum pname, T *params) {
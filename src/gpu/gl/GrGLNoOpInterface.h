@@ -39,6 +39,10 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLClearColor(GrGLclampf red,
 
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLClearStencil(GrGLint s);
 
+GrGLenum GR_GL_FUNCTION_TYPE noOpGLClientWaitSync(GrGLsync sync,
+                                                  GrGLbitfield flags,
+                                                  GrGLuint64 timeout);
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLColorMask(GrGLboolean red,
                                              GrGLboolean green,
                                              GrGLboolean blue,
@@ -84,6 +88,11 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDisableVertexAttribArray(GrGLuint index);
 
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawArrays(GrGLenum mode, GrGLint first, GrGLsizei count);
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawArraysInstanced(GrGLenum mode,
+                                                       GrGLint first,
+                                                       GrGLsizei count,
+                                                       GrGLsizei primcount);
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawBuffer(GrGLenum mode);
 
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDrawBuffers(GrGLsizei n,
@@ -100,6 +109,10 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLEnableVertexAttribArray(GrGLuint index);
 
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLEndQuery(GrGLenum target);
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLDeleteSync(GrGLsync sync);
+
+GrGLsync GR_GL_FUNCTION_TYPE noOpGLFenceSync(GrGLenum condition, GrGLbitfield flags);
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLFinish();
 
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLFlush();
@@ -274,6 +287,8 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLUniformMatrix4fv(GrGLint location,
 
  GrGLvoid GR_GL_FUNCTION_TYPE noOpGLVertexAttrib4fv(GrGLuint indx, const GrGLfloat* values);
 
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLVertexAttribDivisor(GrGLuint index, GrGLuint divisor);
+
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLVertexAttribPointer(GrGLuint indx,
                                                        GrGLint size,
                                                        GrGLenum type,
@@ -347,6 +362,18 @@ GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetShaderOrProgramiv(GrGLuint program,
                                                         GrGLenum pname,
                                                         GrGLint* params);
 
+// Hands back a program binary of zeros, and accepts any.
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetProgramBinary(GrGLuint program,
+                                                    GrGLsizei bufsize,
+                                                    GrGLsizei* length,
+                                                    GrGLenum* binaryFormat,
+                                                    GrGLvoid* binary);
+
+GrGLvoid GR_GL_FUNCTION_TYPE noOpGLProgramBinary(GrGLuint program,
+                                                 GrGLenum binaryFormat,
+                                                 const GrGLvoid* binary,
+                                                 GrGLsizei length);
+
 // Queries on bogus GLs just don't do anything at all. We could potentially make the timers work.
 GrGLvoid GR_GL_FUNCTION_TYPE noOpGLGetQueryiv(GrGLenum GLtarget,
                                               GrGLenum pname,
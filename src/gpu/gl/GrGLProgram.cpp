@@ -51,11 +51,13 @@ GrGLProgram::GrGLProgram(GrGLGpu* gpu,
 GrGLProgram::~GrGLProgram() {
     if (fProgramID) {
         GL_CALL(DeleteProgram(fProgramID));
+        fProgramDataManager.deleteUniformBuffer();
     }
 }
 
 void GrGLProgram::abandon() {
     fProgramID = 0;
+    fProgramDataManager.abandon();
 }
 
 void GrGLProgram::initSamplerUniforms() {
@@ -116,6 +118,8 @@ void GrGLProgram::setData(const GrPrimitiveProcessor& primProc, const GrPipeline
 
     // Some of GrGLProgram subclasses need to update state here
     this->didSetData();
+
+    fProgramDataManager.uploadUniformBlock();
 }
 
 void GrGLProgram::setFragmentData(const GrPrimitiveProcessor& primProc,
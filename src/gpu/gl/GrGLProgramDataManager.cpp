@@ -10,25 +10,127 @@
 #include "gl/GrGLGpu.h"
 #include "SkMatrix.h"
 
+// The number of 32 bit values a uniform of this type takes up in the shadow copy.
+static int slot_count(GrSLType type) {
+    switch (type) {
+        case kVoid_GrSLType:
+            return 0;
+        case kFloat_GrSLType:
+        case kSampler2D_GrSLType:
+            return 1;
+        case kVec2f_GrSLType:
+            return 2;
+        case kVec3f_GrSLType:
+            return 3;
+        case kVec4f_GrSLType:
+            return 4;
+        case kMat33f_GrSLType:
+            return 9;
+        case kMat44f_GrSLType:
+            return 16;
+    }
+    SkFAIL("Unexpected uniform type.");
+    return 0;
+}
+
+// The rows per column, and columns, a uniform of this type has in a std140 uniform block.
+static void std140_shape(GrSLType type, int* rows, int* columns) {
+    *columns = 1;
+    switch (type) {
+        case kFloat_GrSLType:
+            *rows = 1;
+            break;
+        case kVec2f_GrSLType:
+            *rows = 2;
+            break;
+        case kVec3f_GrSLType:
+            *rows = 3;
+            break;
+        case kVec4f_GrSLType:
+            *rows = 4;
+            break;
+        case kMat33f_GrSLType:
+            *rows = 3;
+            *columns = 3;
+            break;
+        case kMat44f_GrSLType:
+            *rows = 4;
+            *columns = 4;
+            break;
+        default:
+            SkFAIL("Unexpected uniform block member type.");
+            *rows = 0;
+            break;
+    }
+}
+
+// In std140 each matrix column, and each array element, starts on a vec4 boundary.
+static const int kStd140VecAlign = 4 * sizeof(GrGLfloat);
+
+static int align_to(int offset, int alignment) {
+    SkASSERT(SkIsPow2(alignment));
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
 #define ASSERT_ARRAY_UPLOAD_IN_BOUNDS(UNI, COUNT) \
          SkASSERT(arrayCount <= uni.fArrayCount || \
                   (1 == arrayCount && GrGLShaderVar::kNonArray == uni.fArrayCount))
 
+bool GrGLProgramDataManager::IsBlockUniform(const GrGLGpu* gpu, const UniformInfo& uniform) {
+    return gpu->glCaps().uniformBufferSupport() &&
+           kSampler2D_GrSLType != uniform.fVariable.getType();
+}
+
 GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, const UniformInfoArray& uniforms)
-    : fGpu(gpu) {
+    : fDirtyStart(0)
+    , fDirtyEnd(0)
+    , fBlockBufferID(0)
+    , fGpu(gpu) {
     int count = uniforms.count();
     fUniforms.push_back_n(count);
+    int shadowCount = 0;
+    int blockSize = 0;
     for (int i = 0; i < count; i++) {
         Uniform& uniform = fUniforms[i];
         const UniformInfo& builderUniform = uniforms[i];
         SkASSERT(GrGLShaderVar::kNonArray == builderUniform.fVariable.getArrayCount() ||
                  builderUniform.fVariable.getArrayCount() > 0);
+        int arrayCount = SkTMax(builderUniform.fVariable.getArrayCount(), 1);
+        uniform.fShadowOffset = shadowCount;
+        uniform.fShadowCount = arrayCount * slot_count(builderUniform.fVariable.getType());
+        uniform.fShadowValidCount = 0;
+        shadowCount += uniform.fShadowCount;
         SkDEBUGCODE(
             uniform.fArrayCount = builderUniform.fVariable.getArrayCount();
             uniform.fType = builderUniform.fVariable.getType();
         );
         // TODO: Move the Xoom uniform array in both FS and VS bug workaround here.
 
+        uniform.fBlockOffset = -1;
+        if (IsBlockUniform(gpu, builderUniform)) {
+            // std140 rules, applied in the order GrGLProgramBuilder declares the block.
+            std140_shape(builderUniform.fVariable.getType(),
+                         &uniform.fBlockRows, &uniform.fBlockColumns);
+            int size = 1 == uniform.fBlockColumns ?
+                       uniform.fBlockRows * sizeof(GrGLfloat) :
+                       uniform.fBlockColumns * kStd140VecAlign;
+            int align;
+            if (builderUniform.fVariable.isArray() || uniform.fBlockColumns > 1) {
+                align = kStd140VecAlign;
+                uniform.fBlockElementStride = align_to(size, kStd140VecAlign);
+            } else {
+                // A lone vec3 aligns like a vec4.
+                align = 3 == uniform.fBlockRows ? kStd140VecAlign : size;
+                uniform.fBlockElementStride = size;
+            }
+            blockSize = align_to(blockSize, align);
+            uniform.fBlockOffset = blockSize;
+            blockSize += arrayCount * uniform.fBlockElementStride;
+            uniform.fVSLocation = kBlockUniform;
+            uniform.fFSLocation = kBlockUniform;
+            continue;
+        }
+
         if (GrGLProgramBuilder::kVertex_Visibility & builderUniform.fVisibility) {
             uniform.fVSLocation = builderUniform.fLocation;
         } else {
@@ -40,6 +142,81 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, const UniformInfoAr
             uniform.fFSLocation = kUnusedUniform;
         }
     }
+    fShadow.setCount(shadowCount);
+    fBlockData.setCount(align_to(blockSize, kStd140VecAlign));
+    sk_bzero(fBlockData.begin(), fBlockData.count());
+}
+
+GrGLProgramDataManager::~GrGLProgramDataManager() {
+    SkASSERT(0 == fBlockBufferID);
+}
+
+void GrGLProgramDataManager::writeToBlock(const Uniform& uni, int count,
+                                          const GrGLfloat* values) const {
+    int perElement = uni.fBlockRows * uni.fBlockColumns;
+    int offset = uni.fBlockOffset;
+    for (int i = 0; i < count; ++i) {
+        int element = i / perElement;
+        int column = (i % perElement) / uni.fBlockRows;
+        int row = i % uni.fBlockRows;
+        offset = uni.fBlockOffset + element * uni.fBlockElementStride +
+                 column * kStd140VecAlign + row * sizeof(GrGLfloat);
+        memcpy(&fBlockData[offset], &values[i], sizeof(GrGLfloat));
+    }
+    int end = offset + sizeof(GrGLfloat);
+    if (fDirtyStart == fDirtyEnd) {
+        fDirtyStart = uni.fBlockOffset;
+        fDirtyEnd = end;
+    } else {
+        fDirtyStart = SkTMin(fDirtyStart, uni.fBlockOffset);
+        fDirtyEnd = SkTMax(fDirtyEnd, end);
+    }
+}
+
+void GrGLProgramDataManager::uploadUniformBlock() {
+    if (fBlockData.isEmpty()) {
+        return;
+    }
+    if (0 == fBlockBufferID) {
+        GR_GL_CALL(fGpu->glInterface(), GenBuffers(1, &fBlockBufferID));
+        fGpu->bindUniformBuffer(fBlockBufferID);
+        GR_GL_CALL(fGpu->glInterface(), BufferData(GR_GL_UNIFORM_BUFFER, fBlockData.count(),
+                                                   fBlockData.begin(), GR_GL_DYNAMIC_DRAW));
+        fDirtyStart = fDirtyEnd = 0;
+        return;
+    }
+    fGpu->bindUniformBuffer(fBlockBufferID);
+    if (fDirtyStart != fDirtyEnd) {
+        GR_GL_CALL(fGpu->glInterface(), BufferSubData(GR_GL_UNIFORM_BUFFER, fDirtyStart,
+                                                      fDirtyEnd - fDirtyStart,
+                                                      &fBlockData[fDirtyStart]));
+        fDirtyStart = fDirtyEnd = 0;
+    }
+}
+
+void GrGLProgramDataManager::deleteUniformBuffer() {
+    if (fBlockBufferID) {
+        GR_GL_CALL(fGpu->glInterface(), DeleteBuffers(1, &fBlockBufferID));
+        fGpu->notifyUniformBufferDelete(fBlockBufferID);
+        fBlockBufferID = 0;
+    }
+}
+
+bool GrGLProgramDataManager::updateShadow(UniformHandle u, int count, const void* values) const {
+    Uniform& uni = fUniforms[u.toProgramDataIndex()];
+    SkASSERT(count <= uni.fShadowCount);
+    void* shadow = &fShadow[uni.fShadowOffset];
+    size_t size = count * sizeof(GrGLfloat);
+    if (count <= uni.fShadowValidCount && 0 == memcmp(shadow, values, size)) {
+        return false;
+    }
+    memcpy(shadow, values, size);
+    uni.fShadowValidCount = SkTMax(uni.fShadowValidCount, count);
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, count, static_cast<const GrGLfloat*>(values));
+        return false;
+    }
+    return true;
 }
 
 void GrGLProgramDataManager::setSampler(UniformHandle u, GrGLint texUnit) const {
@@ -50,6 +227,9 @@ void GrGLProgramDataManager::setSampler(UniformHandle u, GrGLint texUnit) const
     // reference the sampler then the compiler may have optimized it out. Uncomment this assert
     // once stages insert their own samplers.
     // SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 1, &texUnit)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fFSLocation, texUnit));
     }
@@ -63,6 +243,9 @@ void GrGLProgramDataManager::set1f(UniformHandle u, GrGLfloat v0) const {
     SkASSERT(uni.fType == kFloat_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 1, &v0)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fFSLocation, v0));
     }
@@ -82,6 +265,9 @@ void GrGLProgramDataManager::set1fv(UniformHandle u,
     // Once the uniform manager is responsible for inserting the duplicate uniform
     // arrays in VS and FS driver bug workaround, this can be enabled.
     //SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, arrayCount, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fFSLocation, arrayCount, v));
     }
@@ -95,6 +281,10 @@ void GrGLProgramDataManager::set2f(UniformHandle u, GrGLfloat v0, GrGLfloat v1)
     SkASSERT(uni.fType == kVec2f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    const GrGLfloat v[] = { v0, v1 };
+    if (!this->updateShadow(u, 2, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fFSLocation, v0, v1));
     }
@@ -111,6 +301,9 @@ void GrGLProgramDataManager::set2fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 2 * arrayCount, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fFSLocation, arrayCount, v));
     }
@@ -124,6 +317,10 @@ void GrGLProgramDataManager::set3f(UniformHandle u, GrGLfloat v0, GrGLfloat v1,
     SkASSERT(uni.fType == kVec3f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    const GrGLfloat v[] = { v0, v1, v2 };
+    if (!this->updateShadow(u, 3, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fFSLocation, v0, v1, v2));
     }
@@ -140,6 +337,9 @@ void GrGLProgramDataManager::set3fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 3 * arrayCount, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fFSLocation, arrayCount, v));
     }
@@ -157,6 +357,10 @@ void GrGLProgramDataManager::set4f(UniformHandle u,
     SkASSERT(uni.fType == kVec4f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    const GrGLfloat v[] = { v0, v1, v2, v3 };
+    if (!this->updateShadow(u, 4, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fFSLocation, v0, v1, v2, v3));
     }
@@ -173,6 +377,9 @@ void GrGLProgramDataManager::set4fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 4 * arrayCount, v)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fFSLocation, arrayCount, v));
     }
@@ -186,6 +393,9 @@ void GrGLProgramDataManager::setMatrix3f(UniformHandle u, const GrGLfloat matrix
     SkASSERT(uni.fType == kMat33f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 9, matrix)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), UniformMatrix3fv(uni.fFSLocation, 1, false, matrix));
     }
@@ -199,6 +409,9 @@ void GrGLProgramDataManager::setMatrix4f(UniformHandle u, const GrGLfloat matrix
     SkASSERT(uni.fType == kMat44f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 16, matrix)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), UniformMatrix4fv(uni.fFSLocation, 1, false, matrix));
     }
@@ -215,6 +428,9 @@ void GrGLProgramDataManager::setMatrix3fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 9 * arrayCount, matrices)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(),
                    UniformMatrix3fv(uni.fFSLocation, arrayCount, false, matrices));
@@ -233,6 +449,9 @@ void GrGLProgramDataManager::setMatrix4fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
+    if (!this->updateShadow(u, 16 * arrayCount, matrices)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(),
                    UniformMatrix4fv(uni.fFSLocation, arrayCount, false, matrices));
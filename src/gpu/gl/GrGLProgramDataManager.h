@@ -13,6 +13,7 @@
 #include "GrAllocator.h"
 
 #include "SkTArray.h"
+#include "SkTDArray.h"
 
 class GrGLGpu;
 class SkMatrix;
@@ -69,6 +70,21 @@ public:
     typedef GrTAllocator<UniformInfo> UniformInfoArray;
 
     GrGLProgramDataManager(GrGLGpu*, const UniformInfoArray&);
+    ~GrGLProgramDataManager();
+
+    /** When the GL supports uniform buffers, every uniform but the samplers lives in one std140
+     *  uniform block. The setters then write into a CPU copy of the block, and only the range
+     *  they changed is uploaded by uploadUniformBlock(). */
+    static bool IsBlockUniform(const GrGLGpu*, const UniformInfo&);
+
+    /** Uploads whatever part of the uniform block changed since the last call and binds it for
+     *  drawing. Call after the program is in use and all of its uniforms are set. */
+    void uploadUniformBlock();
+
+    /** Deletes the buffer behind the uniform block. Must be called before destruction unless the
+     *  context was abandoned, in which case call abandon(). */
+    void deleteUniformBuffer();
+    void abandon() { fBlockBufferID = 0; }
 
     /** Functions for uploading uniform values. The varities ending in v can be used to upload to an
      *  array of uniforms. arrayCount must be <= the array count of the uniform.
@@ -95,18 +111,41 @@ public:
 private:
     enum {
         kUnusedUniform = -1,
+        kBlockUniform = -2,
     };
 
     struct Uniform {
         GrGLint     fVSLocation;
         GrGLint     fFSLocation;
+        // Where this uniform's last uploaded value starts in fShadow, how many 32 bit values it
+        // can hold, and how many of those are known to match what the program holds.
+        int         fShadowOffset;
+        int         fShadowCount;
+        int         fShadowValidCount;
+        // Where the uniform sits in the uniform block, or -1 if it has a location of its own.
+        int         fBlockOffset;
+        int         fBlockRows;
+        int         fBlockColumns;
+        int         fBlockElementStride;
         SkDEBUGCODE(
             GrSLType    fType;
             int         fArrayCount;
         );
     };
 
-    SkTArray<Uniform, true> fUniforms;
+    // Records count 32 bit values as the uniform's current value. Returns false, meaning there is
+    // no glUniform call to make, if the program already holds exactly those values or if the
+    // uniform lives in the block and the values went there.
+    bool updateShadow(UniformHandle, int count, const void* values) const;
+    void writeToBlock(const Uniform&, int count, const GrGLfloat* values) const;
+
+    // The setters are const, but remembering what they uploaded is not.
+    mutable SkTArray<Uniform, true> fUniforms;
+    mutable SkTDArray<GrGLfloat>    fShadow;
+    mutable SkTDArray<char>         fBlockData;
+    mutable int                     fDirtyStart;    // Byte range of fBlockData not yet uploaded.
+    mutable int                     fDirtyEnd;
+    GrGLuint                        fBlockBufferID;
     GrGLGpu* fGpu;
 
     typedef SkRefCnt INHERITED;
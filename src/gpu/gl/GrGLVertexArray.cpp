@@ -18,7 +18,8 @@ void GrGLAttribArrayState::set(const GrGLGpu* gpu,
                                GrGLenum type,
                                GrGLboolean normalized,
                                GrGLsizei stride,
-                               GrGLvoid* offset) {
+                               GrGLvoid* offset,
+                               GrGLuint divisor) {
     SkASSERT(index >= 0 && index < fAttribArrayStates.count());
     AttribArrayState* array = &fAttribArrayStates[index];
     if (!array->fEnableIsValid || !array->fEnabled) {
@@ -29,6 +30,7 @@ void GrGLAttribArrayState::set(const GrGLGpu* gpu,
     if (!array->fAttribPointerIsValid ||
         array->fVertexBufferID != buffer->bufferID() ||
         array->fSize != size ||
+        array->fType != type ||
         array->fNormalized != normalized ||
         array->fStride != stride ||
         array->fOffset != offset) {
@@ -43,10 +45,21 @@ void GrGLAttribArrayState::set(const GrGLGpu* gpu,
         array->fAttribPointerIsValid = true;
         array->fVertexBufferID = buffer->bufferID();
         array->fSize = size;
+        array->fType = type;
         array->fNormalized = normalized;
         array->fStride = stride;
         array->fOffset = offset;
     }
+    if (!array->fDivisorIsValid || array->fDivisor != divisor) {
+        // Without instancing every attribute keeps the default divisor of 0.
+        if (gpu->glCaps().instancedDrawingSupport()) {
+            GR_GL_CALL(gpu->glInterface(), VertexAttribDivisor(index, divisor));
+        } else {
+            SkASSERT(0 == divisor);
+        }
+        array->fDivisorIsValid = true;
+        array->fDivisor = divisor;
+    }
 }
 
 void GrGLAttribArrayState::disableUnusedArrays(const GrGLGpu* gpu, uint64_t usedMask) {
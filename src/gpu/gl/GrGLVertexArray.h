@@ -67,7 +67,8 @@ public:
     /**
      * This function enables and sets vertex attrib state for the specified attrib index. It is
      * assumed that the GrGLAttribArrayState is tracking the state of the currently bound vertex
-     * array object.
+     * array object.  A nonzero divisor advances the attribute once per that many instances
+     * rather than once per vertex, and requires instanced drawing support.
      */
     void set(const GrGLGpu*,
              int index,
@@ -76,7 +77,8 @@ public:
              GrGLenum type,
              GrGLboolean normalized,
              GrGLsizei stride,
-             GrGLvoid* offset);
+             GrGLvoid* offset,
+             GrGLuint divisor = 0);
 
     /**
      * This function disables vertex attribs not present in the mask. It is assumed that the
@@ -114,10 +116,12 @@ private:
             void invalidate() {
                 fEnableIsValid = false;
                 fAttribPointerIsValid = false;
+                fDivisorIsValid = false;
             }
 
             bool        fEnableIsValid;
             bool        fAttribPointerIsValid;
+            bool        fDivisorIsValid;
             bool        fEnabled;
             GrGLuint    fVertexBufferID;
             GrGLint     fSize;
@@ -125,6 +129,7 @@ private:
             GrGLboolean fNormalized;
             GrGLsizei   fStride;
             GrGLvoid*   fOffset;
+            GrGLuint    fDivisor;
     };
 
     SkSTArray<16, AttribArrayState, true> fAttribArrayStates;
@@ -122,6 +122,7 @@ public:
     BufferManager   fBufferManager;
     GrGLuint        fCurrArrayBuffer;
     GrGLuint        fCurrElementArrayBuffer;
+    GrGLuint        fCurrPixelUnpackBuffer;
     GrGLuint        fCurrProgramID;
     GrGLuint        fCurrShaderID;
 
@@ -129,6 +130,7 @@ public:
     ContextState()
         : fCurrArrayBuffer(0)
         , fCurrElementArrayBuffer(0)
+        , fCurrPixelUnpackBuffer(0)
         , fCurrProgramID(0)
         , fCurrShaderID(0) {}
 
@@ -172,6 +174,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferData(GrGLenum target,
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         id = state->fCurrElementArrayBuffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        id = state->fCurrPixelUnpackBuffer;
+        break;
     default:
         SkFAIL("Unexpected target to nullGLBufferData");
         break;
@@ -183,6 +188,14 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferData(GrGLenum target,
     }
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferStorage(GrGLenum target,
+                                                 GrGLsizeiptr size,
+                                                 const GrGLvoid* data,
+                                                 GrGLbitfield flags) {
+    // Storage flags don't change anything here.
+    nullGLBufferData(target, size, data, GR_GL_DYNAMIC_DRAW);
+}
+
 GrGLvoid GR_GL_FUNCTION_TYPE nullGLPixelStorei(GrGLenum pname, GrGLint param) {}
 GrGLvoid GR_GL_FUNCTION_TYPE nullGLReadPixels(GrGLint x, GrGLint y, GrGLsizei width, GrGLsizei height, GrGLenum format, GrGLenum type, GrGLvoid* pixels) {}
 GrGLvoid GR_GL_FUNCTION_TYPE nullGLUseProgram(GrGLuint program) {}
@@ -215,6 +228,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBindBuffer(GrGLenum target, GrGLuint buffer)
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         state->fCurrElementArrayBuffer = buffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        state->fCurrPixelUnpackBuffer = buffer;
+        break;
     }
 }
 
@@ -228,6 +244,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLDeleteBuffers(GrGLsizei n, const GrGLuint* id
         if (ids[i] == state->fCurrElementArrayBuffer) {
             state->fCurrElementArrayBuffer = 0;
         }
+        if (ids[i] == state->fCurrPixelUnpackBuffer) {
+            state->fCurrPixelUnpackBuffer = 0;
+        }
 
         BufferObj* buffer = state->fBufferManager.lookUp(ids[i]);
         state->fBufferManager.free(buffer);
@@ -363,9 +382,11 @@ static GrGLInterface* create_null_interface(State* state) {
     functions->fBlendFunc = noOpGLBlendFunc;
     functions->fBufferData = nullGLBufferData;
     functions->fBufferSubData = noOpGLBufferSubData;
+    functions->fBufferStorage = nullGLBufferStorage;
     functions->fClear = noOpGLClear;
     functions->fClearColor = noOpGLClearColor;
     functions->fClearStencil = noOpGLClearStencil;
+    functions->fClientWaitSync = noOpGLClientWaitSync;
     functions->fColorMask = noOpGLColorMask;
     functions->fCompileShader = noOpGLCompileShader;
     functions->fCompressedTexImage2D = noOpGLCompressedTexImage2D;
@@ -378,6 +399,7 @@ static GrGLInterface* create_null_interface(State* state) {
     functions->fDeleteProgram = nullGLDelete;
     functions->fDeleteQueries = noOpGLDeleteIds;
     functions->fDeleteShader = nullGLDelete;
+    functions->fDeleteSync = noOpGLDeleteSync;
     functions->fDeleteTextures = noOpGLDeleteIds;
     functions->fDeleteVertexArrays = noOpGLDeleteIds;
     functions->fDepthMask = noOpGLDepthMask;
@@ -390,6 +412,7 @@ static GrGLInterface* create_null_interface(State* state) {
     functions->fEnable = noOpGLEnable;
     functions->fEnableVertexAttribArray = noOpGLEnableVertexAttribArray;
     functions->fEndQuery = noOpGLEndQuery;
+    functions->fFenceSync = noOpGLFenceSync;
     functions->fFinish = noOpGLFinish;
     functions->fFlush = noOpGLFlush;
     functions->fFlushMappedBufferRange = nullGLFlushMappedBufferRange;
@@ -15,8 +15,10 @@
 #include "gl/GrGLUniformHandle.h"
 #include "gl/GrGLXferProcessor.h"
 #include "GrAutoLocaleSetter.h"
+#include "GrContext.h"
 #include "GrCoordTransform.h"
 #include "GrGLProgramBuilder.h"
+#include "GrPersistentCache.h"
 #include "GrTexture.h"
 #include "SkRTConf.h"
 #include "SkTraceEvent.h"
@@ -54,6 +56,7 @@ private:
 const int GrGLProgramBuilder::kVarsPerBlock = 8;
 
 GrGLProgram* GrGLProgramBuilder::CreateProgram(const DrawArgs& args, GrGLGpu* gpu) {
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia.gpu"), "GrGLProgramBuilder::CreateProgram");
     GrAutoLocaleSetter als("C");
 
     // create a builder.  This will be handed off to effects so they can use it to add
@@ -175,14 +178,40 @@ GrGLProgramDataManager::UniformHandle GrGLProgramBuilder::addUniformArray(
     return GrGLProgramDataManager::UniformHandle::CreateFromUniformIndex(fUniforms.count() - 1);
 }
 
+static const char kUniformBlockName[] = "UniformBlock";
+
 void GrGLProgramBuilder::appendUniformDecls(ShaderVisibility visibility,
                                             SkString* out) const {
+    bool hasBlockUniforms = false;
     for (int i = 0; i < fUniforms.count(); ++i) {
-        if (fUniforms[i].fVisibility & visibility) {
+        if (GrGLProgramDataManager::IsBlockUniform(fGpu, fUniforms[i])) {
+            hasBlockUniforms = true;
+        } else if (fUniforms[i].fVisibility & visibility) {
             fUniforms[i].fVariable.appendDecl(this->ctxInfo(), out);
             out->append(";\n");
         }
     }
+    if (!hasBlockUniforms) {
+        return;
+    }
+
+    // Every shader declares the whole block, in the order GrGLProgramDataManager lays it out.
+    // Members of a block shared between stages must match exactly, so their precision is made
+    // explicit rather than left to each stage's default.
+    out->appendf("layout(std140) uniform %s {\n", kUniformBlockName);
+    for (int i = 0; i < fUniforms.count(); ++i) {
+        if (GrGLProgramDataManager::IsBlockUniform(fGpu, fUniforms[i])) {
+            GrGLShaderVar member(fUniforms[i].fVariable);
+            member.setTypeModifier(GrGLShaderVar::kNone_TypeModifier);
+            if (kDefault_GrSLPrecision == member.getPrecision()) {
+                member.setPrecision(kHigh_GrSLPrecision);
+            }
+            out->append("\t");
+            member.appendDecl(this->ctxInfo(), out);
+            out->append(";\n");
+        }
+    }
+    out->append("};\n");
 }
 
 const GrGLContextInfo& GrGLProgramBuilder::ctxInfo() const {
@@ -392,6 +421,22 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
         return NULL;
     }
 
+    // A program linked by an earlier run needs no compiling at all.
+    GrPersistentCache* cache = this->persistentCache();
+    SkAutoTUnref<SkData> cacheKey;
+    if (cache) {
+        cacheKey.reset(this->createCacheKey());
+        if (this->loadProgramBinary(cache, *cacheKey, programID)) {
+            this->resolveUniformLocations(programID);
+            this->bindUniformBlock(programID);
+            return this->createProgram(programID);
+        }
+        if (fGpu->glInterface()->fFunctions.fProgramParameteri) {
+            GL_CALL(ProgramParameteri(programID, GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                                      GR_GL_TRUE));
+        }
+    }
+
     // compile shaders and bind attributes / uniforms
     SkTDArray<GrGLuint> shadersToDelete;
 
@@ -427,21 +472,32 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 #ifdef SK_DEBUG
     checkLinked = true;
 #endif
+    bool linked = true;
     if (checkLinked) {
-        checkLinkStatus(programID);
+        linked = checkLinkStatus(programID);
     }
     if (!usingBindUniform) {
         this->resolveUniformLocations(programID);
     }
+    if (linked) {
+        this->bindUniformBlock(programID);
+    }
 
     this->cleanupShaders(shadersToDelete);
 
+    if (cache && linked) {
+        this->storeProgramBinary(cache, *cacheKey, programID);
+    }
+
     return this->createProgram(programID);
 }
 
 void GrGLProgramBuilder::bindUniformLocations(GrGLuint programID) {
     int count = fUniforms.count();
     for (int i = 0; i < count; ++i) {
+        if (GrGLProgramDataManager::IsBlockUniform(fGpu, fUniforms[i])) {
+            continue;
+        }
         GL_CALL(BindUniformLocation(programID, i, fUniforms[i].fVariable.c_str()));
         fUniforms[i].fLocation = i;
     }
@@ -474,12 +530,94 @@ bool GrGLProgramBuilder::checkLinkStatus(GrGLuint programID) {
 void GrGLProgramBuilder::resolveUniformLocations(GrGLuint programID) {
     int count = fUniforms.count();
     for (int i = 0; i < count; ++i) {
+        if (GrGLProgramDataManager::IsBlockUniform(fGpu, fUniforms[i])) {
+            continue;
+        }
         GrGLint location;
         GL_CALL_RET(location, GetUniformLocation(programID, fUniforms[i].fVariable.c_str()));
         fUniforms[i].fLocation = location;
     }
 }
 
+void GrGLProgramBuilder::bindUniformBlock(GrGLuint programID) {
+    if (!fGpu->glCaps().uniformBufferSupport()) {
+        return;
+    }
+    // The block is missing if the program has no uniforms outside of samplers, or if the compiler
+    // found none of them used.
+    GrGLuint blockIndex;
+    GL_CALL_RET(blockIndex, GetUniformBlockIndex(programID, kUniformBlockName));
+    if (GR_GL_INVALID_INDEX != blockIndex) {
+        GL_CALL(UniformBlockBinding(programID, blockIndex, 0));
+    }
+}
+
+GrPersistentCache* GrGLProgramBuilder::persistentCache() const {
+    // NVPR programs have their varyings plugged in after linking, so we always build them.
+    if (!fGpu->glCaps().programBinarySupport() || this->primitiveProcessor().isPathRendering()) {
+        return NULL;
+    }
+    return fGpu->getContext()->getOptions().fPersistentCache;
+}
+
+SkData* GrGLProgramBuilder::createCacheKey() {
+    // Binaries are only good for the driver that made them.  Drivers reject ones they can't
+    // load anyway, but keying on the driver keeps an update from wasting a lookup per program.
+    static const GrGLenum kDriverStrings[] = { GR_GL_VENDOR, GR_GL_RENDERER, GR_GL_VERSION };
+    SkString key;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kDriverStrings); ++i) {
+        const GrGLubyte* str;
+        GL_CALL_RET(str, GetString(kDriverStrings[i]));
+        key.appendf("%s\n", str ? reinterpret_cast<const char*>(str) : "");
+    }
+
+    // The source is only complete once each builder has declared its uniforms and varyings.
+    fVS.completeSource();
+    fFS.completeSource();
+    fVS.appendSource(&key);
+    fFS.appendSource(&key);
+    return SkData::NewWithCopy(key.c_str(), key.size());
+}
+
+bool GrGLProgramBuilder::loadProgramBinary(GrPersistentCache* cache, const SkData& key,
+                                           GrGLuint programID) {
+    // Stored data is the binary's format followed by the binary itself.
+    SkAutoTUnref<SkData> data(cache->load(key));
+    if (!data || data->size() <= sizeof(GrGLenum)) {
+        return false;
+    }
+    GrGLenum format;
+    memcpy(&format, data->data(), sizeof(format));
+    GL_CALL(ProgramBinary(programID, format, data->bytes() + sizeof(format),
+                          (GrGLsizei)(data->size() - sizeof(format))));
+
+    // The driver refuses binaries it no longer understands, e.g. after an update.  The program
+    // is left unlinked, and we build it from source as usual.
+    GrGLint linked = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
+    return SkToBool(linked);
+}
+
+void GrGLProgramBuilder::storeProgramBinary(GrPersistentCache* cache, const SkData& key,
+                                            GrGLuint programID) {
+    GrGLint length = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(programID, GR_GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) {
+        return;
+    }
+
+    SkAutoTUnref<SkData> data(SkData::NewUninitialized(sizeof(GrGLenum) + length));
+    uint8_t* bytes = static_cast<uint8_t*>(data->writable_data());
+    GrGLenum format = GR_GL_INIT_ZERO;
+    GrGLsizei written = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramBinary(programID, length, &written, &format, bytes + sizeof(format)));
+    if (written != length) {
+        return;
+    }
+    memcpy(bytes, &format, sizeof(format));
+    cache->store(key, *data);
+}
+
 void GrGLProgramBuilder::cleanupProgram(GrGLuint programID, const SkTDArray<GrGLuint>& shaderIDs) {
     GL_CALL(DeleteProgram(programID));
     cleanupShaders(shaderIDs);
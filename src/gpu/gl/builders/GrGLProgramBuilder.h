@@ -18,6 +18,9 @@
 #include "../../GrPendingFragmentStage.h"
 #include "../../GrPipeline.h"
 
+class GrPersistentCache;
+class SkData;
+
 /*
  * This is the base class for a series of interfaces.  This base class *MUST* remain abstract with
  * NO data members because it is used in multiple interface inheritance.
@@ -326,9 +329,20 @@ protected:
     void bindUniformLocations(GrGLuint programID);
     bool checkLinkStatus(GrGLuint programID);
     void resolveUniformLocations(GrGLuint programID);
+    // Points the program's uniform block, if it has one, at the binding GrGLGpu::bindUniformBuffer
+    // uses.
+    void bindUniformBlock(GrGLuint programID);
     void cleanupProgram(GrGLuint programID, const SkTDArray<GrGLuint>& shaderIDs);
     void cleanupShaders(const SkTDArray<GrGLuint>& shaderIDs);
 
+    // Linked programs are saved to and reloaded from the client's GrPersistentCache, if it gave
+    // us one and the driver can hand programs back.  The key is the finalized shader source plus
+    // the driver's identity.
+    GrPersistentCache* persistentCache() const;
+    SkData* createCacheKey();
+    bool loadProgramBinary(GrPersistentCache*, const SkData& key, GrGLuint programID);
+    void storeProgramBinary(GrPersistentCache*, const SkData& key, GrGLuint programID);
+
     // Subclasses create different programs
     virtual GrGLProgram* createProgram(GrGLuint programID);
 
@@ -172,8 +172,7 @@ void GrGLShaderBuilder::appendTextureLookup(const char* samplerName,
                           kVec2f_GrSLType);
 }
 
-bool
-GrGLShaderBuilder::finalize(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuint>* shaderIds) {
+void GrGLShaderBuilder::finalizeSource() {
     SkASSERT(!fFinalized);
     // append the 'footer' to code
     this->code().append("}");
@@ -183,6 +182,20 @@ GrGLShaderBuilder::finalize(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuin
         fCompilerStringLengths[i] = (int)fShaderStrings[i].size();
     }
 
+    fFinalized = true;
+}
+
+void GrGLShaderBuilder::appendSource(SkString* out) const {
+    SkASSERT(fFinalized);
+    for (int i = 0; i < fCompilerStrings.count(); i++) {
+        out->append(fCompilerStrings[i], fCompilerStringLengths[i]);
+    }
+}
+
+bool
+GrGLShaderBuilder::compile(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuint>* shaderIds) {
+    SkASSERT(fFinalized);
+
     GrGLGpu* gpu = fProgramBuilder->gpu();
     GrGLuint shaderId = GrGLCompileAndAttachShader(gpu->glContext(),
                                                    programId,
@@ -192,8 +205,6 @@ GrGLShaderBuilder::finalize(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuin
                                                    fCompilerStrings.count(),
                                                    gpu->stats());
 
-    fFinalized = true;
-
     if (!shaderId) {
         return false;
     }
@@ -155,7 +155,18 @@ protected:
     SkString& functions() { return fShaderStrings[kFunctions]; }
     SkString& main() { return fShaderStrings[kMain]; }
     SkString& code() { return fShaderStrings[fCodeIndex]; }
-    bool finalize(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuint>* shaderIds);
+
+    /*
+     * Appends the 'footer' and gathers the source strings for the compiler.  After this the
+     * shader source is complete and can't change.
+     */
+    void finalizeSource();
+
+    // Appends the complete source of the shader to out.  Requires finalizeSource().
+    void appendSource(SkString* out) const;
+
+    // Compiles the finalized source and attaches the shader to programId.
+    bool compile(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuint>* shaderIds);
 
     enum {
         kVersionDecl,
@@ -72,13 +72,20 @@ void GrGLVertexBuilder::bindVertexAttributes(GrGLuint programID) {
     return;
 }
 
-bool
-GrGLVertexBuilder::compileAndAttachShaders(GrGLuint programId, SkTDArray<GrGLuint>* shaderIds) {
+void GrGLVertexBuilder::completeSource() {
     this->versionDecl() = GrGetGLSLVersionDecl(fProgramBuilder->ctxInfo());
     fProgramBuilder->appendUniformDecls(GrGLProgramBuilder::kVertex_Visibility, &this->uniforms());
     this->appendDecls(fInputs, &this->inputs());
     this->appendDecls(fOutputs, &this->outputs());
-    return this->finalize(programId, GR_GL_VERTEX_SHADER, shaderIds);
+    this->finalizeSource();
+}
+
+bool
+GrGLVertexBuilder::compileAndAttachShaders(GrGLuint programId, SkTDArray<GrGLuint>* shaderIds) {
+    if (!fFinalized) {
+        this->completeSource();
+    }
+    return this->compile(programId, GR_GL_VERTEX_SHADER, shaderIds);
 }
 
 bool GrGLVertexBuilder::addAttribute(const GrShaderVar& var) {
@@ -22,6 +22,7 @@ public:
         , fDataPtr(NULL)
         , fMapped(false)
         , fBound(false)
+        , fImmutable(false)
         , fSize(0)
         , fUsage(GR_GL_STATIC_DRAW) {
     }
@@ -48,6 +49,9 @@ public:
     void resetBound()            { fBound = false; }
     bool getBound() const        { return fBound; }
 
+    void setImmutable()          { fImmutable = true; }
+    bool getImmutable() const    { return fImmutable; }
+
     void allocate(GrGLsizeiptr size, const GrGLchar *dataPtr);
     GrGLsizeiptr getSize() const { return fSize; }
     GrGLchar *getDataPtr()       { return fDataPtr; }
@@ -65,6 +69,7 @@ private:
     GrGLintptr   fMappedOffset; // the offset of the buffer range that is mapped
     GrGLsizeiptr fMappedLength; // the size of the buffer range that is mapped
     bool         fBound;        // is the buffer object bound via "glBindBuffer"?
+    bool         fImmutable;    // was the buffer object's store created by "glBufferStorage"?
     GrGLsizeiptr fSize;         // size in bytes
     GrGLint      fUsage;        // one of: GL_STREAM_DRAW,
                                 //         GL_STATIC_DRAW,
@@ -36,6 +36,7 @@ GrDebugGL::GrDebugGL()
     , fCurTextureUnit(0)
     , fArrayBuffer(NULL)
     , fElementArrayBuffer(NULL)
+    , fPixelUnpackBuffer(NULL)
     , fFrameBuffer(NULL)
     , fRenderBuffer(NULL)
     , fProgram(NULL)
@@ -69,6 +70,7 @@ GrDebugGL::~GrDebugGL() {
 
     fArrayBuffer = NULL;
     fElementArrayBuffer = NULL;
+    fPixelUnpackBuffer = NULL;
     fFrameBuffer = NULL;
     fRenderBuffer = NULL;
     fProgram = NULL;
@@ -139,6 +141,27 @@ void GrDebugGL::setElementArrayBuffer(GrBufferObj *elementArrayBuffer) {
     }
 }
 
+void GrDebugGL::setPixelUnpackBuffer(GrBufferObj *pixelUnpackBuffer) {
+    if (fPixelUnpackBuffer) {
+        // automatically break the binding of the old buffer
+        GrAlwaysAssert(fPixelUnpackBuffer->getBound());
+        fPixelUnpackBuffer->resetBound();
+
+        GrAlwaysAssert(!fPixelUnpackBuffer->getDeleted());
+        fPixelUnpackBuffer->unref();
+    }
+
+    fPixelUnpackBuffer = pixelUnpackBuffer;
+
+    if (fPixelUnpackBuffer) {
+        GrAlwaysAssert(!fPixelUnpackBuffer->getDeleted());
+        fPixelUnpackBuffer->ref();
+
+        GrAlwaysAssert(!fPixelUnpackBuffer->getBound());
+        fPixelUnpackBuffer->setBound();
+    }
+}
+
 void GrDebugGL::setTexture(GrTextureObj *texture)  {
     fTextureUnits[fCurTextureUnit]->setTexture(texture);
 }
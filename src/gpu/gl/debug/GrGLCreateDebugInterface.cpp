@@ -78,7 +78,8 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBufferData(GrGLenum target,
                                                const GrGLvoid* data,
                                                GrGLenum usage) {
     GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
-                   GR_GL_ELEMENT_ARRAY_BUFFER == target);
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target ||
+                   GR_GL_PIXEL_UNPACK_BUFFER == target);
     GrAlwaysAssert(size >= 0);
     GrAlwaysAssert(GR_GL_STREAM_DRAW == usage ||
                    GR_GL_STATIC_DRAW == usage ||
@@ -92,6 +93,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBufferData(GrGLenum target,
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             buffer = GrDebugGL::getInstance()->getElementArrayBuffer();
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            buffer = GrDebugGL::getInstance()->getPixelUnpackBuffer();
+            break;
         default:
             SkFAIL("Unexpected target to glBufferData");
             break;
@@ -99,11 +103,47 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBufferData(GrGLenum target,
 
     GrAlwaysAssert(buffer);
     GrAlwaysAssert(buffer->getBound());
+    // glBufferData is an error once glBufferStorage has made the store immutable.
+    GrAlwaysAssert(!buffer->getImmutable());
 
     buffer->allocate(size, reinterpret_cast<const GrGLchar *>(data));
     buffer->setUsage(usage);
 }
 
+GrGLvoid GR_GL_FUNCTION_TYPE debugGLBufferStorage(GrGLenum target,
+                                                  GrGLsizeiptr size,
+                                                  const GrGLvoid* data,
+                                                  GrGLbitfield flags) {
+    GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target);
+    GrAlwaysAssert(size >= 0);
+    // Persistent mappings require map access.
+    GrAlwaysAssert(!SkToBool(GR_GL_MAP_PERSISTENT_BIT & flags) ||
+                   SkToBool((GR_GL_MAP_READ_BIT | GR_GL_MAP_WRITE_BIT) & flags));
+    GrAlwaysAssert(!SkToBool(GR_GL_MAP_COHERENT_BIT & flags) ||
+                   SkToBool(GR_GL_MAP_PERSISTENT_BIT & flags));
+
+    GrBufferObj *buffer = NULL;
+    switch (target) {
+        case GR_GL_ARRAY_BUFFER:
+            buffer = GrDebugGL::getInstance()->getArrayBuffer();
+            break;
+        case GR_GL_ELEMENT_ARRAY_BUFFER:
+            buffer = GrDebugGL::getInstance()->getElementArrayBuffer();
+            break;
+        default:
+            SkFAIL("Unexpected target to glBufferStorage");
+            break;
+    }
+
+    GrAlwaysAssert(buffer);
+    GrAlwaysAssert(buffer->getBound());
+    GrAlwaysAssert(!buffer->getImmutable());
+
+    buffer->allocate(size, reinterpret_cast<const GrGLchar *>(data));
+    buffer->setImmutable();
+}
+
 
 GrGLvoid GR_GL_FUNCTION_TYPE debugGLPixelStorei(GrGLenum pname,
                                                 GrGLint param) {
@@ -571,7 +611,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBindVertexArray(GrGLuint id) {
 }
 
 GrGLvoid GR_GL_FUNCTION_TYPE debugGLBindBuffer(GrGLenum target, GrGLuint bufferID) {
-    GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target || GR_GL_ELEMENT_ARRAY_BUFFER == target);
+    GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target ||
+                   GR_GL_PIXEL_UNPACK_BUFFER == target);
 
     GrBufferObj *buffer = GR_FIND(bufferID,
                                   GrBufferObj,
@@ -585,6 +627,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBindBuffer(GrGLenum target, GrGLuint bufferI
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             GrDebugGL::getInstance()->setElementArrayBuffer(buffer);
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            GrDebugGL::getInstance()->setPixelUnpackBuffer(buffer);
+            break;
         default:
             SkFAIL("Unexpected target to glBindBuffer");
             break;
@@ -607,6 +652,12 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLDeleteBuffers(GrGLsizei n, const GrGLuint* i
             // this ID is the current element array buffer
             GrDebugGL::getInstance()->setElementArrayBuffer(NULL);
         }
+        if (GrDebugGL::getInstance()->getPixelUnpackBuffer() &&
+            ids[i] ==
+                GrDebugGL::getInstance()->getPixelUnpackBuffer()->getID()) {
+            // this ID is the current pixel unpack buffer
+            GrDebugGL::getInstance()->setPixelUnpackBuffer(NULL);
+        }
     }
 
     // then actually "delete" the buffers
@@ -627,9 +678,11 @@ GrGLvoid* GR_GL_FUNCTION_TYPE debugGLMapBufferRange(GrGLenum target, GrGLintptr
     GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
                    GR_GL_ELEMENT_ARRAY_BUFFER == target);
 
-    // We only expect read access and we expect that the buffer or range is always invalidated.
+    // We only expect write access and we expect that the buffer or range is always invalidated,
+    // unless it is a persistent mapping of a store created by glBufferStorage.
     GrAlwaysAssert(!SkToBool(GR_GL_MAP_READ_BIT & access));
-    GrAlwaysAssert((GR_GL_MAP_INVALIDATE_BUFFER_BIT | GR_GL_MAP_INVALIDATE_RANGE_BIT) & access);
+    GrAlwaysAssert(((GR_GL_MAP_INVALIDATE_BUFFER_BIT | GR_GL_MAP_INVALIDATE_RANGE_BIT) & access) ||
+                   (GR_GL_MAP_PERSISTENT_BIT & access));
 
     GrBufferObj *buffer = NULL;
     switch (target) {
@@ -647,6 +700,7 @@ GrGLvoid* GR_GL_FUNCTION_TYPE debugGLMapBufferRange(GrGLenum target, GrGLintptr
     if (buffer) {
         GrAlwaysAssert(offset >= 0 && offset + length <= buffer->getSize());
         GrAlwaysAssert(!buffer->getMapped());
+        GrAlwaysAssert(!SkToBool(GR_GL_MAP_PERSISTENT_BIT & access) || buffer->getImmutable());
         buffer->setMapped(offset, length);
         return buffer->getDataPtr() + offset;
     }
@@ -853,9 +907,11 @@ const GrGLInterface* GrGLCreateDebugInterface() {
     functions->fBlendFunc = noOpGLBlendFunc;
     functions->fBufferData = debugGLBufferData;
     functions->fBufferSubData = noOpGLBufferSubData;
+    functions->fBufferStorage = debugGLBufferStorage;
     functions->fClear = noOpGLClear;
     functions->fClearColor = noOpGLClearColor;
     functions->fClearStencil = noOpGLClearStencil;
+    functions->fClientWaitSync = noOpGLClientWaitSync;
     functions->fColorMask = noOpGLColorMask;
     functions->fCompileShader = noOpGLCompileShader;
     functions->fCompressedTexImage2D = noOpGLCompressedTexImage2D;
@@ -868,6 +924,7 @@ const GrGLInterface* GrGLCreateDebugInterface() {
     functions->fDeleteProgram = debugGLDeleteProgram;
     functions->fDeleteQueries = noOpGLDeleteIds;
     functions->fDeleteShader = debugGLDeleteShader;
+    functions->fDeleteSync = noOpGLDeleteSync;
     functions->fDeleteTextures = debugGLDeleteTextures;
     functions->fDeleteVertexArrays = debugGLDeleteVertexArrays;
     functions->fDepthMask = noOpGLDepthMask;
@@ -880,6 +937,7 @@ const GrGLInterface* GrGLCreateDebugInterface() {
     functions->fEnable = noOpGLEnable;
     functions->fEnableVertexAttribArray = noOpGLEnableVertexAttribArray;
     functions->fEndQuery = noOpGLEndQuery;
+    functions->fFenceSync = noOpGLFenceSync;
     functions->fFinish = noOpGLFinish;
     functions->fFlush = noOpGLFlush;
     functions->fFlushMappedBufferRange = debugGLFlushMappedBufferRange;
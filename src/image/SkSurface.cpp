@@ -86,7 +86,7 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkPa
     }
 }
 
-void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
+void SkSurface_Base::aboutToDraw(ContentChangeMode mode, const SkIRect* bounds) {
     this->dirtyGenerationID();
 
     SkASSERT(!fCachedCanvas || fCachedCanvas->getSurfaceBase() == this);
@@ -106,6 +106,7 @@ void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
     } else if (kDiscard_ContentChangeMode == mode) {
         this->onDiscard();
     }
+    this->onContentWillChange(kDiscard_ContentChangeMode == mode ? NULL : bounds);
 }
 
 uint32_t SkSurface_Base::newGenerationID() {
@@ -60,6 +60,12 @@ public:
      */
     virtual void onCopyOnWrite(ContentChangeMode) = 0;
 
+    /**
+     *  Called after any copy-on-write, just before drawing changes the pixels in
+     *  bounds (in device space), or anywhere in the surface if bounds is NULL.
+     */
+    virtual void onContentWillChange(const SkIRect* bounds) {}
+
     inline SkCanvas* getCachedCanvas();
     inline SkImage* getCachedImage(Budgeted);
 
@@ -70,7 +76,7 @@ private:
     SkCanvas*   fCachedCanvas;
     SkImage*    fCachedImage;
 
-    void aboutToDraw(ContentChangeMode mode);
+    void aboutToDraw(ContentChangeMode mode, const SkIRect* bounds = NULL);
     friend class SkCanvas;
     friend class SkSurface;
 
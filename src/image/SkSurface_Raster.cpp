@@ -13,6 +13,12 @@
 
 static const size_t kIgnoreRowBytesValue = (size_t)~0;
 
+// When a snapshot shares our pixels and we're drawn to again, we fork onto other pixels. Instead
+// of filling a new allocation each time, we keep the pixels we forked away from as a spare. When
+// we next fork, if the snapshot holding the spare is gone we fork back onto it, and need only copy
+// the tiles drawn to since the last fork.
+static const int kTileSize = 256;
+
 class SkSurface_Raster : public SkSurface_Base {
 public:
     static bool Valid(const SkImageInfo&, size_t rb = kIgnoreRowBytesValue);
@@ -28,11 +34,20 @@ public:
     virtual void onDraw(SkCanvas*, SkScalar x, SkScalar y,
                         const SkPaint*) override;
     void onCopyOnWrite(ContentChangeMode) override;
+    void onContentWillChange(const SkIRect* bounds) override;
 
 private:
+    void setAllTilesDirty(bool dirty);
+    void copyDirtyTiles(const SkBitmap& src, const SkBitmap& dst) const;
+
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
 
+    SkAutoTUnref<SkPixelRef>    fSpare;         // The pixels we last forked away from, or NULL.
+    SkAutoTMalloc<bool>         fDirtyTiles;    // Which tiles of fBitmap may differ from fSpare.
+    int                         fTileCountX;
+    int                         fTileCountY;
+
     typedef SkSurface_Base INHERITED;
 };
 
@@ -89,6 +104,7 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, void* pixels, size_t
 {
     fBitmap.installPixels(info, pixels, rb, NULL, releaseProc, context);
     fWeOwnThePixels = false;    // We are "Direct"
+    fTileCountX = fTileCountY = 0;
 }
 
 SkSurface_Raster::SkSurface_Raster(SkPixelRef* pr, const SkSurfaceProps* props)
@@ -99,6 +115,8 @@ SkSurface_Raster::SkSurface_Raster(SkPixelRef* pr, const SkSurfaceProps* props)
     fBitmap.setInfo(info, info.minRowBytes());
     fBitmap.setPixelRef(pr);
     fWeOwnThePixels = true;
+    fTileCountX = (info.width()  + kTileSize - 1) / kTileSize;
+    fTileCountY = (info.height() + kTileSize - 1) / kTileSize;
 
     if (!info.isOpaque()) {
         fBitmap.eraseColor(SK_ColorTRANSPARENT);
@@ -127,14 +145,28 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     SkASSERT(this->getCachedImage(kNo_Budgeted));
     if (SkBitmapImageGetPixelRef(this->getCachedImage(kNo_Budgeted)) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
+        SkBitmap prev(fBitmap);
+        if (fSpare && fSpare->unique() && !fSpare->isImmutable()) {
+            // Nothing else can see the spare any more, so we can write to it again.
+            fBitmap.setPixelRef(fSpare);
+            fSpare->notifyPixelsChanged();
+            if (kRetain_ContentChangeMode == mode) {
+                this->copyDirtyTiles(prev, fBitmap);
+            }
+        } else if (kDiscard_ContentChangeMode == mode) {
             fBitmap.setPixelRef(NULL);
             fBitmap.allocPixels();
         } else {
-            SkBitmap prev(fBitmap);
             prev.deepCopyTo(&fBitmap);
         }
-        // Now fBitmap is a deep copy of itself (and therefore different from
+        fSpare.reset(SkRef(prev.pixelRef()));
+        if (NULL == fDirtyTiles.get()) {
+            fDirtyTiles.reset(fTileCountX * fTileCountY);
+        }
+        // Unless we discarded, fBitmap now matches what the image holds (our new spare).
+        this->setAllTilesDirty(kDiscard_ContentChangeMode == mode);
+
+        // Now fBitmap is a copy of itself (and therefore different from
         // what is being used by the image. Next we update the canvas to use
         // this as its backend, so we can't modify the image's pixels anymore.
         SkASSERT(this->getCachedCanvas());
@@ -142,6 +174,56 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     }
 }
 
+void SkSurface_Raster::onContentWillChange(const SkIRect* bounds) {
+    if (!fSpare) {
+        return;     // Nothing to compare against.
+    }
+    SkIRect r = SkIRect::MakeWH(fBitmap.width(), fBitmap.height());
+    if (bounds && !r.intersect(*bounds)) {
+        return;
+    }
+    for (int y = r.fTop / kTileSize; y <= (r.fBottom - 1) / kTileSize; y++) {
+        for (int x = r.fLeft / kTileSize; x <= (r.fRight - 1) / kTileSize; x++) {
+            fDirtyTiles[y * fTileCountX + x] = true;
+        }
+    }
+}
+
+void SkSurface_Raster::setAllTilesDirty(bool dirty) {
+    for (int i = 0; i < fTileCountX * fTileCountY; i++) {
+        fDirtyTiles[i] = dirty;
+    }
+}
+
+void SkSurface_Raster::copyDirtyTiles(const SkBitmap& src, const SkBitmap& dst) const {
+    SkASSERT(src.info() == dst.info());
+    SkAutoLockPixels srcLock(src), dstLock(dst);
+    if (NULL == src.getPixels() || NULL == dst.getPixels()) {
+        return;
+    }
+    const int bpp = src.bytesPerPixel();
+    for (int ty = 0; ty < fTileCountY; ty++) {
+        for (int tx = 0; tx < fTileCountX; tx++) {
+            if (!fDirtyTiles[ty * fTileCountX + tx]) {
+                continue;
+            }
+            // Copy runs of dirty tiles a row of tiles at a time.
+            int end = tx + 1;
+            while (end < fTileCountX && fDirtyTiles[ty * fTileCountX + end]) {
+                end++;
+            }
+            const int left   = tx * kTileSize;
+            const int width  = SkTMin(end * kTileSize, src.width()) - left;
+            const int top    = ty * kTileSize;
+            const int bottom = SkTMin(top + kTileSize, src.height());
+            for (int y = top; y < bottom; y++) {
+                memcpy(dst.getAddr(left, y), src.getAddr(left, y), width * bpp);
+            }
+            tx = end;
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkSurface* SkSurface::NewRasterDirectReleaseProc(const SkImageInfo& info, void* pixels, size_t rb,
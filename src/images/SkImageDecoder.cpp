@@ -12,6 +12,7 @@
 #include "SkPixelRef.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
+#include "SkTraceEvent.h"
 #include "SkCanvas.h"
 
 SkImageDecoder::SkImageDecoder()
@@ -127,6 +128,7 @@ SkColorType SkImageDecoder::getPrefColorType(SrcDepth srcDepth, bool srcHasAlpha
 
 SkImageDecoder::Result SkImageDecoder::decode(SkStream* stream, SkBitmap* bm, SkColorType pref,
                                               Mode mode) {
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia"), "SkImageDecoder::decode");
     // we reset this to false before calling onDecode
     fShouldCancelDecode = false;
     // assign this, for use by getPrefColorType(), in case fUsePrefTable is false
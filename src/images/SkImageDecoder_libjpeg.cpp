@@ -10,9 +10,11 @@
 #include "SkImageEncoder.h"
 #include "SkJpegUtility.h"
 #include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkDither.h"
 #include "SkScaledBitmapSampler.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTime.h"
 #include "SkUtils.h"
@@ -1358,76 +1360,205 @@ static WriteScanline ChooseWriter(const SkBitmap& bm) {
     }
 }
 
-class SkJPEGImageEncoder : public SkImageEncoder {
-protected:
-    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) {
-#ifdef TIME_ENCODE
-        SkAutoTime atm("JPEG Encode");
-#endif
-
-        SkAutoLockPixels alp(bm);
-        if (NULL == bm.getPixels()) {
-            return false;
-        }
-
-        jpeg_compress_struct    cinfo;
-        skjpeg_error_mgr        sk_err;
-        skjpeg_destination_mgr  sk_wstream(stream);
-
-        // allocate these before set call setjmp
-        SkAutoMalloc    oneRow;
-
-        cinfo.err = jpeg_std_error(&sk_err);
-        sk_err.error_exit = skjpeg_error_exit;
-        if (setjmp(sk_err.fJmpBuf)) {
-            return false;
-        }
+// The rows in each of the strips that parallel encodes compress on their own. A multiple of the
+// tallest MCU (16 rows, for 2x2 subsampled chroma).
+static const int kJpegStripRows = 256;
+
+/*  Encode rows [top, top + height) of bm to stream as a complete JPEG. If restartInterval is
+    not zero, every restartInterval MCUs are compressed independently of the others, and a DRI
+    marker says so.
+*/
+static bool encode_jpeg_rows(SkWStream* stream, const SkBitmap& bm, int quality,
+                             int top, int height, unsigned restartInterval) {
+    jpeg_compress_struct    cinfo;
+    skjpeg_error_mgr        sk_err;
+    skjpeg_destination_mgr  sk_wstream(stream);
+
+    // allocate these before set call setjmp
+    SkAutoMalloc    oneRow;
+
+    cinfo.err = jpeg_std_error(&sk_err);
+    sk_err.error_exit = skjpeg_error_exit;
+    if (setjmp(sk_err.fJmpBuf)) {
+        return false;
+    }
 
-        // Keep after setjmp or mark volatile.
-        const WriteScanline writer = ChooseWriter(bm);
-        if (NULL == writer) {
-            return false;
-        }
+    // Keep after setjmp or mark volatile.
+    const WriteScanline writer = ChooseWriter(bm);
+    if (NULL == writer) {
+        return false;
+    }
 
-        jpeg_create_compress(&cinfo);
-        cinfo.dest = &sk_wstream;
-        cinfo.image_width = bm.width();
-        cinfo.image_height = bm.height();
-        cinfo.input_components = 3;
+    jpeg_create_compress(&cinfo);
+    cinfo.dest = &sk_wstream;
+    cinfo.image_width = bm.width();
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
 #ifdef WE_CONVERT_TO_YUV
-        cinfo.in_color_space = JCS_YCbCr;
+    cinfo.in_color_space = JCS_YCbCr;
 #else
-        cinfo.in_color_space = JCS_RGB;
+    cinfo.in_color_space = JCS_RGB;
 #endif
-        cinfo.input_gamma = 1;
+    cinfo.input_gamma = 1;
 
-        jpeg_set_defaults(&cinfo);
-        jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, quality, TRUE /* limit to baseline-JPEG values */);
 #ifdef DCT_IFAST_SUPPORTED
-        cinfo.dct_method = JDCT_IFAST;
+    cinfo.dct_method = JDCT_IFAST;
 #endif
+    cinfo.restart_interval = restartInterval;
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    const int       width = bm.width();
+    uint8_t*        oneRowP = (uint8_t*)oneRow.reset(width * 3);
+
+    const SkPMColor* colors = bm.getColorTable() ? bm.getColorTable()->readColors() : NULL;
+    const void*      srcRow = bm.getAddr(0, top);
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
+
+        writer(oneRowP, srcRow, width, colors);
+        row_pointer[0] = oneRowP;
+        (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
+        srcRow = (const void*)((const char*)srcRow + bm.rowBytes());
+    }
+
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    return true;
+}
+
+namespace {
+struct JpegStrip {
+    const SkBitmap*         fBitmap;
+    int                     fQuality;
+    int                     fTop;
+    int                     fHeight;
+    unsigned                fRestartInterval;
+    SkAutoTUnref<SkData>    fData;
+};
+}  // namespace
+
+static void encode_jpeg_strip(JpegStrip* strip) {
+    SkDynamicMemoryWStream stream;
+    if (encode_jpeg_rows(&stream, *strip->fBitmap, strip->fQuality, strip->fTop, strip->fHeight,
+                         strip->fRestartInterval)) {
+        strip->fData.reset(stream.copyToData());
+    }
+}
 
-        jpeg_start_compress(&cinfo, TRUE);
+/*  Find the end of the SOS marker segment of a JPEG that libjpeg wrote, where the entropy-coded
+    data starts. If sofHeight is not NULL, it is set to the offset of the frame's height.
+*/
+static size_t find_jpeg_scan(const uint8_t* data, size_t size, size_t* sofHeight) {
+    size_t offset = 2;  // SOI
+    while (offset + 4 <= size && 0xFF == data[offset]) {
+        const uint8_t marker = data[offset + 1];
+        const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+        if (0xC0 == marker && sofHeight) {
+            *sofHeight = offset + 5;
+        }
+        offset += 2 + length;
+        if (0xDA == marker) {
+            return offset;
+        }
+    }
+    return 0;
+}
 
-        const int       width = bm.width();
-        uint8_t*        oneRowP = (uint8_t*)oneRow.reset(width * 3);
+/*  Encode bm as strips of kJpegStripRows rows at once, each one restart interval, and splice their
+    entropy-coded segments together with RST markers into one baseline JPEG. Nothing is written to
+    stream until every strip is encoded, so on failure before that, bm can be encoded serially.
+*/
+static bool encode_jpeg_strips(SkWStream* stream, const SkBitmap& bm, int quality) {
+    // jpeg_set_defaults() subsamples chroma 2x2, so MCUs are 16x16. The restart interval is
+    // written in 16 bits.
+    const unsigned mcusPerRow = (bm.width() + 15) / 16;
+    const unsigned restartInterval = mcusPerRow * (kJpegStripRows / 16);
+    if (restartInterval > 0xFFFF) {
+        return false;
+    }
 
-        const SkPMColor* colors = bm.getColorTable() ? bm.getColorTable()->readColors() : NULL;
-        const void*      srcRow = bm.getPixels();
+    const int stripCount = (bm.height() + kJpegStripRows - 1) / kJpegStripRows;
+    SkAutoTArray<JpegStrip> strips(stripCount);
+    for (int i = 0; i < stripCount; i++) {
+        strips[i].fBitmap = &bm;
+        strips[i].fQuality = quality;
+        strips[i].fTop = i * kJpegStripRows;
+        strips[i].fHeight = SkTMin(kJpegStripRows, bm.height() - strips[i].fTop);
+        strips[i].fRestartInterval = restartInterval;
+    }
+    {
+        SkTaskGroup tg;
+        tg.batch(encode_jpeg_strip, strips.get(), stripCount);
+    }
 
-        while (cinfo.next_scanline < cinfo.image_height) {
-            JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
+    for (int i = 0; i < stripCount; i++) {
+        if (!strips[i].fData) {
+            return false;
+        }
+    }
 
-            writer(oneRowP, srcRow, width, colors);
-            row_pointer[0] = oneRowP;
-            (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
-            srcRow = (const void*)((const char*)srcRow + bm.rowBytes());
+    // The first strip's headers, with the height of the whole image.
+    const SkData* first = strips[0].fData;
+    size_t sofHeight = 0;
+    const size_t headerSize = find_jpeg_scan(first->bytes(), first->size(), &sofHeight);
+    if (0 == headerSize || 0 == sofHeight) {
+        return false;
+    }
+    SkAutoMalloc header(headerSize);
+    uint8_t* headerBytes = (uint8_t*)header.get();
+    memcpy(headerBytes, first->bytes(), headerSize);
+    headerBytes[sofHeight] = SkToU8(bm.height() >> 8);
+    headerBytes[sofHeight + 1] = SkToU8(bm.height() & 0xFF);
+    if (!stream->write(headerBytes, headerSize)) {
+        return false;
+    }
+
+    // Then each strip's entropy-coded segment, without its EOI, after the RST marker that
+    // starts its interval.
+    for (int i = 0; i < stripCount; i++) {
+        const SkData* data = strips[i].fData;
+        const size_t scan = find_jpeg_scan(data->bytes(), data->size(), NULL);
+        if (0 == scan || data->size() < scan + 2) {
+            return false;
+        }
+        if (i > 0) {
+            const uint8_t rst[] = { 0xFF, SkToU8(0xD0 + (i - 1) % 8) };
+            if (!stream->write(rst, sizeof(rst))) {
+                return false;
+            }
+        }
+        if (!stream->write(data->bytes() + scan, data->size() - scan - 2)) {
+            return false;
         }
+    }
+    const uint8_t eoi[] = { 0xFF, 0xD9 };
+    return stream->write(eoi, sizeof(eoi));
+}
 
-        jpeg_finish_compress(&cinfo);
-        jpeg_destroy_compress(&cinfo);
+class SkJPEGImageEncoder : public SkImageEncoder {
+protected:
+    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) {
+#ifdef TIME_ENCODE
+        SkAutoTime atm("JPEG Encode");
+#endif
 
-        return true;
+        SkAutoLockPixels alp(bm);
+        if (NULL == bm.getPixels()) {
+            return false;
+        }
+
+        if (this->getParallel() && bm.height() > kJpegStripRows) {
+            // Strips are written to stream only once they have all been encoded.
+            if (encode_jpeg_strips(stream, bm, quality)) {
+                return true;
+            }
+        }
+        return encode_jpeg_rows(stream, bm, quality, 0, bm.height(), 0);
     }
 };
 
@@ -19,6 +19,12 @@
 #include "transform_scanline.h"
 extern "C" {
 #include "png.h"
+
+#ifdef ZLIB_INCLUDE
+    #include ZLIB_INCLUDE
+#else
+    #include "zlib.h"
+#endif
 }
 
 /* These were dropped in libpng >= 1.4 */
@@ -989,6 +995,10 @@ bool SkPNGImageDecoder::onDecodeSubset(SkBitmap* bm, const SkIRect& region) {
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkEndian.h"
+#include "SkTaskGroup.h"
+#include "SkTHash.h"
 #include "SkUnPreMultiply.h"
 
 static void sk_write_fn(png_structp png_ptr, png_bytep data, png_size_t len) {
@@ -1099,6 +1109,367 @@ static inline int pack_palette(SkColorTable* ctable,
     return num_trans;
 }
 
+/*  If bitmap, which must be kN32 and locked, has no more than 256 colors, make indexed the same
+    image as kIndex_8, with the translucent colors first in its colortable so that
+    pack_palette() can leave the opaque ones out of the tRNS chunk.
+*/
+static bool make_palette_bitmap(const SkBitmap& bitmap, SkBitmap* indexed) {
+    SkASSERT(kN32_SkColorType == bitmap.colorType());
+    SkTHashMap<SkPMColor, int> indices;
+    SkPMColor colors[256];
+    int count = 0;
+    for (int y = 0; y < bitmap.height(); y++) {
+        const SkPMColor* row = bitmap.getAddr32(0, y);
+        for (int x = 0; x < bitmap.width(); x++) {
+            // Tiles tend to have runs of a color, which don't need a lookup each.
+            if (x > 0 && row[x] == row[x - 1]) {
+                continue;
+            }
+            if (indices.find(row[x])) {
+                continue;
+            }
+            if (256 == count) {
+                return false;
+            }
+            indices.set(row[x], count);
+            colors[count++] = row[x];
+        }
+    }
+
+    int remap[256];
+    SkPMColor ordered[256];
+    int next = 0;
+    for (int i = 0; i < count; i++) {
+        if (SkGetPackedA32(colors[i]) != 0xFF) {
+            remap[i] = next;
+            ordered[next++] = colors[i];
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (SkGetPackedA32(colors[i]) == 0xFF) {
+            remap[i] = next;
+            ordered[next++] = colors[i];
+        }
+    }
+
+    SkAutoTUnref<SkColorTable> ctable(SkNEW_ARGS(SkColorTable, (ordered, count)));
+    if (!indexed->tryAllocPixels(bitmap.info().makeColorType(kIndex_8_SkColorType), NULL,
+                                 ctable)) {
+        return false;
+    }
+    for (int y = 0; y < bitmap.height(); y++) {
+        const SkPMColor* src = bitmap.getAddr32(0, y);
+        uint8_t* dst = indexed->getAddr8(0, y);
+        for (int x = 0; x < bitmap.width(); x++) {
+            dst[x] = (x > 0 && src[x] == src[x - 1]) ? dst[x - 1] : remap[*indices.find(src[x])];
+        }
+    }
+    return true;
+}
+
+static int png_filter_flags(SkImageEncoder::PNGFilter filter) {
+    switch (filter) {
+        case SkImageEncoder::kNone_PNGFilter:
+            return PNG_FILTER_NONE;
+        case SkImageEncoder::kSub_PNGFilter:
+            return PNG_FILTER_SUB;
+        case SkImageEncoder::kUp_PNGFilter:
+            return PNG_FILTER_UP;
+        case SkImageEncoder::kAdaptive_PNGFilter:
+            return PNG_ALL_FILTERS;
+        default:
+            SkASSERT(false);
+            return PNG_ALL_FILTERS;
+    }
+}
+
+// The rows in each of the strips that parallel encodes deflate on their own.
+static const int kPngStripRows = 256;
+
+enum {
+    kNone_PNGFilterType,
+    kSub_PNGFilterType,
+    kUp_PNGFilterType,
+    kAverage_PNGFilterType,
+    kPaeth_PNGFilterType,
+
+    kPNGFilterTypeCount
+};
+
+static int paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = SkAbs32(p - a);
+    const int pb = SkAbs32(p - b);
+    const int pc = SkAbs32(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+/*  Filter row, whose unfiltered predecessor is prev (all zeros for the first row), with the
+    filter type, writing the type byte and the filtered bytes to dst.
+*/
+static void filter_png_row(int type, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                           int bpp, uint8_t* dst) {
+    *dst++ = SkToU8(type);
+    for (size_t i = 0; i < rowBytes; i++) {
+        const int left = i >= (size_t)bpp ? row[i - bpp] : 0;
+        const int upLeft = i >= (size_t)bpp ? prev[i - bpp] : 0;
+        int predictor;
+        switch (type) {
+            case kSub_PNGFilterType:
+                predictor = left;
+                break;
+            case kUp_PNGFilterType:
+                predictor = prev[i];
+                break;
+            case kAverage_PNGFilterType:
+                predictor = (left + prev[i]) >> 1;
+                break;
+            case kPaeth_PNGFilterType:
+                predictor = paeth_predictor(left, prev[i], upLeft);
+                break;
+            default:
+                predictor = 0;
+                break;
+        }
+        dst[i] = SkToU8((row[i] - predictor) & 0xFF);
+    }
+}
+
+// libpng's heuristic: the filtered row whose bytes, as signed values, sum to the least.
+static uint32_t png_row_cost(const uint8_t* filtered, size_t rowBytes) {
+    uint32_t cost = 0;
+    for (size_t i = 0; i < rowBytes; i++) {
+        cost += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+    }
+    return cost;
+}
+
+// The filter types that filter tries on each row, as a mask of 1 << type.
+static int png_filter_types(SkImageEncoder::PNGFilter filter, bool palette) {
+    switch (filter) {
+        case SkImageEncoder::kNone_PNGFilter:
+            return 1 << kNone_PNGFilterType;
+        case SkImageEncoder::kSub_PNGFilter:
+            return 1 << kSub_PNGFilterType;
+        case SkImageEncoder::kUp_PNGFilter:
+            return 1 << kUp_PNGFilterType;
+        case SkImageEncoder::kAdaptive_PNGFilter:
+            return (1 << kPNGFilterTypeCount) - 1;
+        default:
+            // Like libpng, which doesn't filter palette images.
+            return palette ? 1 << kNone_PNGFilterType : (1 << kPNGFilterTypeCount) - 1;
+    }
+}
+
+namespace {
+struct PngStrip {
+    const SkBitmap*         fBitmap;
+    transform_scanline_proc fProc;
+    int                     fBpp;
+    int                     fTop;
+    int                     fHeight;
+    int                     fZLibLevel;
+    int                     fFilterTypes;
+    bool                    fLast;
+    // Results.
+    SkAutoTUnref<SkData>    fData;
+    uLong                   fAdler;
+    size_t                  fRawSize;
+};
+}  // namespace
+
+static bool deflate_to_stream(z_stream* zstream, const uint8_t* data, size_t size, int flush,
+                              SkWStream* stream) {
+    uint8_t buffer[4096];
+    zstream->next_in = const_cast<Bytef*>(data);
+    zstream->avail_in = SkToUInt(size);
+    do {
+        zstream->next_out = buffer;
+        zstream->avail_out = sizeof(buffer);
+        if (Z_STREAM_ERROR == deflate(zstream, flush)) {
+            return false;
+        }
+        if (!stream->write(buffer, sizeof(buffer) - zstream->avail_out)) {
+            return false;
+        }
+    } while (0 == zstream->avail_out);
+    return true;
+}
+
+/*  Filter and raw deflate the strip's rows, ending on a byte boundary with a sync flush so the
+    strips can be concatenated, or with the final block if it is the last strip.
+*/
+static void deflate_png_strip(PngStrip* strip) {
+    const SkBitmap& bitmap = *strip->fBitmap;
+    const size_t rowBytes = bitmap.width() * strip->fBpp;
+    SkAutoMalloc storage(2 * rowBytes + 2 * (1 + rowBytes));
+    uint8_t* prev = (uint8_t*)storage.get();
+    uint8_t* row = prev + rowBytes;
+    uint8_t* filtered = row + rowBytes;
+    uint8_t* best = filtered + 1 + rowBytes;
+
+    if (strip->fTop > 0) {
+        strip->fProc((const char*)bitmap.getAddr(0, strip->fTop - 1), bitmap.width(),
+                     (char*)prev);
+    } else {
+        memset(prev, 0, rowBytes);
+    }
+
+    z_stream zstream;
+    memset(&zstream, 0, sizeof(zstream));
+    if (Z_OK != deflateInit2(&zstream, strip->fZLibLevel, Z_DEFLATED, -MAX_WBITS, 8,
+                             Z_DEFAULT_STRATEGY)) {
+        return;
+    }
+    SkDynamicMemoryWStream stream;
+    uLong adler = adler32(0L, Z_NULL, 0);
+    bool success = true;
+    for (int y = strip->fTop; success && y < strip->fTop + strip->fHeight; y++) {
+        strip->fProc((const char*)bitmap.getAddr(0, y), bitmap.width(), (char*)row);
+        uint32_t bestCost = SK_MaxU32;
+        for (int type = 0; type < kPNGFilterTypeCount; type++) {
+            if (!(strip->fFilterTypes & (1 << type))) {
+                continue;
+            }
+            filter_png_row(type, row, prev, rowBytes, strip->fBpp, filtered);
+            const uint32_t cost = png_row_cost(filtered + 1, rowBytes);
+            if (cost < bestCost) {
+                bestCost = cost;
+                SkTSwap(filtered, best);
+            }
+        }
+        adler = adler32(adler, best, SkToUInt(1 + rowBytes));
+        success = deflate_to_stream(&zstream, best, 1 + rowBytes, Z_NO_FLUSH, &stream);
+        SkTSwap(prev, row);
+    }
+    if (success) {
+        success = deflate_to_stream(&zstream, NULL, 0, strip->fLast ? Z_FINISH : Z_SYNC_FLUSH,
+                                    &stream);
+    }
+    deflateEnd(&zstream);
+    if (success) {
+        strip->fData.reset(stream.copyToData());
+        strip->fAdler = adler;
+        strip->fRawSize = strip->fHeight * (1 + rowBytes);
+    }
+}
+
+static bool write_png_chunk(SkWStream* stream, const char type[4], const void* data,
+                            size_t size) {
+    uLong crc = crc32(0L, (const Bytef*)type, 4);
+    if (size > 0) {
+        crc = crc32(crc, (const Bytef*)data, SkToUInt(size));
+    }
+    return stream->write32(SkEndian_SwapBE32(SkToU32(size))) &&
+           stream->write(type, 4) &&
+           (0 == size || stream->write(data, size)) &&
+           stream->write32(SkEndian_SwapBE32(SkToU32(crc)));
+}
+
+static void put_png_u32(uint8_t* dst, uint32_t value) {
+    dst[0] = SkToU8(value >> 24);
+    dst[1] = SkToU8((value >> 16) & 0xFF);
+    dst[2] = SkToU8((value >> 8) & 0xFF);
+    dst[3] = SkToU8(value & 0xFF);
+}
+
+/*  Write the same image that doEncode() would, with the chunks written here rather than by
+    libpng, so that the rows can be filtered and deflated kPngStripRows at a time on SkTaskGroup
+    threads. Each strip is a run of deflate blocks ending in a sync flush, so they concatenate into
+    one zlib stream, whose adler32 is combined from the strips'.
+*/
+static bool encode_png_strips(SkWStream* stream, const SkBitmap& bitmap, bool hasAlpha,
+                              int colorType, int bitDepth, png_color_8& sig_bit, int zlibLevel,
+                              SkImageEncoder::PNGFilter filter) {
+    const bool palette = SkToBool(colorType & PNG_COLOR_MASK_PALETTE);
+    const int bpp = palette ? 1 : (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3;
+    const int stripCount = (bitmap.height() + kPngStripRows - 1) / kPngStripRows;
+    SkAutoTArray<PngStrip> strips(stripCount);
+    for (int i = 0; i < stripCount; i++) {
+        strips[i].fBitmap = &bitmap;
+        strips[i].fProc = choose_proc(bitmap.colorType(), hasAlpha);
+        strips[i].fBpp = bpp;
+        strips[i].fTop = i * kPngStripRows;
+        strips[i].fHeight = SkTMin(kPngStripRows, bitmap.height() - strips[i].fTop);
+        strips[i].fZLibLevel = SkImageEncoder::kDefault_ZLibLevel == zlibLevel ?
+                               Z_DEFAULT_COMPRESSION : zlibLevel;
+        strips[i].fFilterTypes = png_filter_types(filter, palette);
+        strips[i].fLast = (i == stripCount - 1);
+    }
+    {
+        SkTaskGroup tg;
+        tg.batch(deflate_png_strip, strips.get(), stripCount);
+    }
+    for (int i = 0; i < stripCount; i++) {
+        if (!strips[i].fData) {
+            return false;
+        }
+    }
+
+    static const uint8_t kSignature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    if (!stream->write(kSignature, sizeof(kSignature))) {
+        return false;
+    }
+
+    uint8_t ihdr[13];
+    put_png_u32(ihdr, bitmap.width());
+    put_png_u32(ihdr + 4, bitmap.height());
+    ihdr[8] = SkToU8(bitDepth);
+    ihdr[9] = SkToU8(colorType);
+    ihdr[10] = PNG_COMPRESSION_TYPE_BASE;
+    ihdr[11] = PNG_FILTER_TYPE_BASE;
+    ihdr[12] = PNG_INTERLACE_NONE;
+    if (!write_png_chunk(stream, "IHDR", ihdr, sizeof(ihdr))) {
+        return false;
+    }
+
+    // sBIT must come before PLTE.
+    const uint8_t sbit[] = { sig_bit.red, sig_bit.green, sig_bit.blue, sig_bit.alpha };
+    if (!write_png_chunk(stream, "sBIT", sbit, (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3)) {
+        return false;
+    }
+
+    if (palette) {
+        png_color paletteColors[256];
+        png_byte trans[256];
+        SkColorTable* ctable = bitmap.getColorTable();
+        const int numTrans = pack_palette(ctable, paletteColors, trans, hasAlpha);
+        uint8_t plte[3 * 256];
+        for (int i = 0; i < ctable->count(); i++) {
+            plte[3 * i + 0] = paletteColors[i].red;
+            plte[3 * i + 1] = paletteColors[i].green;
+            plte[3 * i + 2] = paletteColors[i].blue;
+        }
+        if (!write_png_chunk(stream, "PLTE", plte, 3 * ctable->count())) {
+            return false;
+        }
+        if (numTrans > 0 && !write_png_chunk(stream, "tRNS", trans, numTrans)) {
+            return false;
+        }
+    }
+
+    // The zlib header (deflate with a 32K window, no dictionary), then the strips, then the
+    // adler32 of all of the filtered rows, each in an IDAT of its own.
+    static const uint8_t kZLibHeader[] = { 0x78, 0x9C };
+    if (!write_png_chunk(stream, "IDAT", kZLibHeader, sizeof(kZLibHeader))) {
+        return false;
+    }
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (int i = 0; i < stripCount; i++) {
+        if (!write_png_chunk(stream, "IDAT", strips[i].fData->data(), strips[i].fData->size())) {
+            return false;
+        }
+        adler = adler32_combine(adler, strips[i].fAdler, (z_off_t)strips[i].fRawSize);
+    }
+    uint8_t adlerBytes[4];
+    put_png_u32(adlerBytes, SkToU32(adler));
+    return write_png_chunk(stream, "IDAT", adlerBytes, sizeof(adlerBytes)) &&
+           write_png_chunk(stream, "IEND", NULL, 0);
+}
+
 class SkPNGImageEncoder : public SkImageEncoder {
 protected:
     bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override;
@@ -1111,9 +1482,18 @@ private:
     typedef SkImageEncoder INHERITED;
 };
 
-bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int /*quality*/) {
+bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int quality) {
     SkColorType ct = bitmap.colorType();
 
+    if (this->getPalettize() && kN32_SkColorType == ct) {
+        SkAutoLockPixels alp(bitmap);
+        SkBitmap indexed;
+        if (bitmap.readyToDraw() && make_palette_bitmap(bitmap, &indexed)) {
+            SkAutoLockPixels alpIndexed(indexed);
+            return this->onEncode(stream, indexed, quality);
+        }
+    }
+
     const bool hasAlpha = !bitmap.isOpaque();
     int colorType = PNG_COLOR_MASK_COLOR;
     int bitDepth = 8;   // default for color
@@ -1178,6 +1558,11 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
                   int bitDepth, SkColorType ct,
                   png_color_8& sig_bit) {
 
+    if (this->getParallel() && bitmap.height() > kPngStripRows) {
+        return encode_png_strips(stream, bitmap, hasAlpha, colorType, bitDepth, sig_bit,
+                                 this->getZLibLevel(), this->getPNGFilter());
+    }
+
     png_structp png_ptr;
     png_infop info_ptr;
 
@@ -1203,6 +1588,13 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
 
     png_set_write_fn(png_ptr, (void*)stream, sk_write_fn, png_flush_ptr_NULL);
 
+    if (kDefault_ZLibLevel != this->getZLibLevel()) {
+        png_set_compression_level(png_ptr, this->getZLibLevel());
+    }
+    if (kDefault_PNGFilter != this->getPNGFilter()) {
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, png_filter_flags(this->getPNGFilter()));
+    }
+
     /* Set the image information here.  Width and height are up to 2^31,
     * bit_depth is one of 1, 2, 4, 8, or 16, but valid values also depend on
     * the color_type selected. color_type is one of PNG_COLOR_TYPE_GRAY,
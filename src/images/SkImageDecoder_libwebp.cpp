@@ -196,14 +196,25 @@ static WEBP_CSP_MODE webp_decode_mode(const SkBitmap* decodedBitmap, bool premul
 // Incremental WebP image decoding. Reads input buffer of 64K size iteratively
 // and decodes this block to appropriate color-space as per config object.
 static bool webp_idecode(SkStream* stream, WebPDecoderConfig* config) {
-    WebPIDecoder* idec = WebPIDecode(NULL, 0, config);
-    if (NULL == idec) {
-        WebPFreeDecBuffer(&config->output);
+    if (!stream->rewind()) {
+        SkDebugf("Failed to rewind webp stream!");
         return false;
     }
 
-    if (!stream->rewind()) {
-        SkDebugf("Failed to rewind webp stream!");
+    // If the whole image is in memory already, decode it in place rather than copying it in.
+    size_t memorySize = 0;
+    const void* memory = stream->peekMemory(&memorySize);
+    if (memory && stream->hasPosition() && stream->hasLength() &&
+        memorySize == stream->getLength() - stream->getPosition()) {
+        const bool success = VP8_STATUS_OK ==
+                WebPDecode(static_cast<const uint8_t*>(memory), memorySize, config);
+        WebPFreeDecBuffer(&config->output);
+        return success;
+    }
+
+    WebPIDecoder* idec = WebPIDecode(NULL, 0, config);
+    if (NULL == idec) {
+        WebPFreeDecBuffer(&config->output);
         return false;
     }
     const size_t readBufferSize = stream->hasLength() ?
@@ -10,6 +10,12 @@
 #include "SkStream.h"
 #include "SkTemplates.h"
 
+SkImageEncoder::SkImageEncoder()
+    : fZLibLevel(kDefault_ZLibLevel)
+    , fPNGFilter(kDefault_PNGFilter)
+    , fPalettize(false)
+    , fParallel(false) {}
+
 SkImageEncoder::~SkImageEncoder() {}
 
 bool SkImageEncoder::encodeStream(SkWStream* stream, const SkBitmap& bm,
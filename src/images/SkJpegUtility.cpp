@@ -50,7 +50,15 @@ static boolean sk_fill_input_buffer(j_decompress_ptr cinfo) {
     if (src->fDecoder != NULL && src->fDecoder->shouldCancelDecode()) {
         return FALSE;
     }
-    size_t bytes = src->fStream->read(src->fBuffer, skjpeg_source_mgr::kBufferSize);
+    // If the stream's next bytes are in memory, hand them to libjpeg as they are.
+    size_t bytes = 0;
+    const void* memory = src->fStream->peekMemory(&bytes);
+    if (memory && bytes > 0) {
+        (void)src->fStream->skip(bytes);
+    } else {
+        memory = src->fBuffer;
+        bytes = src->fStream->read(src->fBuffer, skjpeg_source_mgr::kBufferSize);
+    }
     // note that JPEG is happy with less than the full read,
     // as long as the result is non-zero
     if (bytes == 0) {
@@ -60,7 +68,7 @@ static boolean sk_fill_input_buffer(j_decompress_ptr cinfo) {
 #ifdef SK_BUILD_FOR_ANDROID
     src->current_offset += bytes;
 #endif
-    src->next_input_byte = (const JOCTET*)src->fBuffer;
+    src->next_input_byte = (const JOCTET*)memory;
     src->bytes_in_buffer = bytes;
     return TRUE;
 }
@@ -6,7 +6,7 @@
  */
 
 #include "SkCachingPixelRef.h"
-#include "SkBitmapCache.h"
+#include "SkDecodedImageCache.h"
 #include "SkRect.h"
 
 bool SkCachingPixelRef::Install(SkImageGenerator* generator,
@@ -46,8 +46,7 @@ bool SkCachingPixelRef::onNewLockPixels(LockRec* rec) {
     }
 
     const SkImageInfo& info = this->info();
-    if (!SkBitmapCache::Find(
-                this->getGenerationID(), info.bounds(), &fLockedBitmap)) {
+    if (!SkDecodedImageCache::Find(this->getGenerationID(), info.bounds(), &fLockedBitmap)) {
         // Cache has been purged, must re-decode.
         if (!fLockedBitmap.tryAllocPixels(info, fRowBytes)) {
             fErrorInDecoding = true;
@@ -64,7 +63,7 @@ bool SkCachingPixelRef::onNewLockPixels(LockRec* rec) {
                 return false;
         }
         fLockedBitmap.setImmutable();
-        SkBitmapCache::Add(this, info.bounds(), fLockedBitmap);
+        SkDecodedImageCache::Add(this, info.bounds(), fLockedBitmap);
     }
 
     // Now bitmap should contain a concrete PixelRef of the decoded image.
@@ -18,7 +18,7 @@ class SkColorTable;
 /**
  *  PixelRef which defers decoding until SkBitmap::lockPixels() is
  *  called.  Caches the decoded images in the global
- *  SkScaledImageCache.  When the pixels are unlocked, this cache may
+ *  SkDecodedImageCache.  When the pixels are unlocked, this cache may
  *  or be destroyed before the next lock.  If so, onLockPixels will
  *  attempt to re-decode.
  *
@@ -45,6 +45,7 @@ protected:
     bool onNewLockPixels(LockRec*) override;
     void onUnlockPixels() override;
     bool onLockPixelsAreWritable() const override { return false; }
+    bool onIsLazyGenerated() const override { return true; }
 
     SkData* onRefEncodedData() override {
         return fImageGenerator->refEncodedData();
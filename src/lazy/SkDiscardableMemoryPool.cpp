@@ -7,9 +7,12 @@
 
 #include "SkDiscardableMemory.h"
 #include "SkDiscardableMemoryPool.h"
+#include "SkGraphics.h"
 #include "SkImageGenerator.h"
 #include "SkLazyPtr.h"
+#include "SkTDArray.h"
 #include "SkTInternalLList.h"
+#include "SkTaskGroup.h"
 #include "SkThread.h"
 
 // Note:
@@ -29,7 +32,7 @@ public:
     /**
      *  Without mutex, will be not be thread safe.
      */
-    DiscardableMemoryPool(size_t budget, SkBaseMutex* mutex = NULL);
+    DiscardableMemoryPool(size_t budget, SkBaseMutex* mutex = NULL, bool asyncPurge = false);
     virtual ~DiscardableMemoryPool();
 
     SkDiscardableMemory* create(size_t bytes) override;
@@ -40,6 +43,7 @@ public:
 
     /** purges all unlocked DMs */
     void dumpPool() override;
+    void dumpYoungGeneration() override;
 
     #if SK_LAZY_CACHE_STATS  // Defined in SkDiscardableMemoryPool.h
     int getCacheHits() override { return fCacheHits; }
@@ -52,13 +56,29 @@ public:
     #endif  // SK_LAZY_CACHE_STATS
 
 private:
+    typedef SkTInternalLList<PoolDiscardableMemory> List;
+
     SkBaseMutex* fMutex;
     size_t       fBudget;
     size_t       fUsed;
-    SkTInternalLList<PoolDiscardableMemory> fList;
+    size_t       fOldUsed;
+    List         fYoung;
+    List         fOld;
+
+    const bool        fAsyncPurge;
+    bool              fPurgeScheduled;
+    SkTDArray<void*>  fGraveyard;    // Memory of purged DMs still to be freed.
+    SkTaskGroup       fPurgeTasks;
 
     /** Function called to free memory if needed */
     void dumpDownTo(size_t budget);
+    /** Purges unlocked DMs from the tail of list while fUsed > budget. */
+    void dumpListDownTo(List* list, size_t budget);
+    /** Frees or buries a purged DM's memory. */
+    void release(void* pointer);
+    /** Frees the graveyard on fPurgeTasks, if there is anything in it.  Call without fMutex. */
+    void schedulePurge();
+    static void EmptyGraveyard(DiscardableMemoryPool*);
     /** called by DiscardableMemoryPool upon destruction */
     void free(PoolDiscardableMemory* dm);
     /** called by DiscardableMemoryPool::lock() */
@@ -88,6 +108,7 @@ private:
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(PoolDiscardableMemory);
     DiscardableMemoryPool* const fPool;
     bool                         fLocked;
+    bool                         fOld;        // In fPool->fOld rather than fPool->fYoung.
     void*                        fPointer;
     const size_t                 fBytes;
 };
@@ -97,6 +118,7 @@ PoolDiscardableMemory::PoolDiscardableMemory(DiscardableMemoryPool* pool,
                                              size_t bytes)
     : fPool(pool)
     , fLocked(true)
+    , fOld(false)
     , fPointer(pointer)
     , fBytes(bytes) {
     SkASSERT(fPool != NULL);
@@ -129,10 +151,15 @@ void PoolDiscardableMemory::unlock() {
 ////////////////////////////////////////////////////////////////////////////////
 
 DiscardableMemoryPool::DiscardableMemoryPool(size_t budget,
-                                             SkBaseMutex* mutex)
+                                             SkBaseMutex* mutex,
+                                             bool asyncPurge)
     : fMutex(mutex)
     , fBudget(budget)
-    , fUsed(0) {
+    , fUsed(0)
+    , fOldUsed(0)
+    , fAsyncPurge(asyncPurge)
+    , fPurgeScheduled(false) {
+    SkASSERT(!asyncPurge || mutex != NULL);
     #if SK_LAZY_CACHE_STATS
     fCacheHits = 0;
     fCacheMisses = 0;
@@ -142,37 +169,87 @@ DiscardableMemoryPool::~DiscardableMemoryPool() {
     // PoolDiscardableMemory objects that belong to this pool are
     // always deleted before deleting this pool since each one has a
     // ref to the pool.
-    SkASSERT(fList.isEmpty());
+    SkASSERT(fYoung.isEmpty());
+    SkASSERT(fOld.isEmpty());
+    fPurgeTasks.wait();
+    fGraveyard.freeAll();
 }
 
-void DiscardableMemoryPool::dumpDownTo(size_t budget) {
-    if (fMutex != NULL) {
-        fMutex->assertHeld();
-    }
-    if (fUsed <= budget) {
-        return;
+void DiscardableMemoryPool::release(void* pointer) {
+    if (fAsyncPurge) {
+        *fGraveyard.append() = pointer;
+    } else {
+        sk_free(pointer);
     }
-    typedef SkTInternalLList<PoolDiscardableMemory>::Iter Iter;
+}
+
+void DiscardableMemoryPool::dumpListDownTo(List* list, size_t budget) {
+    typedef List::Iter Iter;
     Iter iter;
-    PoolDiscardableMemory* cur = iter.init(fList, Iter::kTail_IterStart);
+    PoolDiscardableMemory* cur = iter.init(*list, Iter::kTail_IterStart);
     while ((fUsed > budget) && (cur)) {
         if (!cur->fLocked) {
             PoolDiscardableMemory* dm = cur;
             SkASSERT(dm->fPointer != NULL);
-            sk_free(dm->fPointer);
+            this->release(dm->fPointer);
             dm->fPointer = NULL;
             SkASSERT(fUsed >= dm->fBytes);
             fUsed -= dm->fBytes;
+            if (dm->fOld) {
+                SkASSERT(fOldUsed >= dm->fBytes);
+                fOldUsed -= dm->fBytes;
+            }
             cur = iter.prev();
             // Purged DMs are taken out of the list.  This saves times
             // looking them up.  Purged DMs are NOT deleted.
-            fList.remove(dm);
+            list->remove(dm);
         } else {
             cur = iter.prev();
         }
     }
 }
 
+void DiscardableMemoryPool::dumpDownTo(size_t budget) {
+    if (fMutex != NULL) {
+        fMutex->assertHeld();
+    }
+    if (fUsed <= budget) {
+        return;
+    }
+    this->dumpListDownTo(&fYoung, budget);
+    this->dumpListDownTo(&fOld, budget);
+}
+
+void DiscardableMemoryPool::schedulePurge() {
+    if (!fAsyncPurge) {
+        return;
+    }
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        if (fPurgeScheduled || fGraveyard.isEmpty()) {
+            return;
+        }
+        fPurgeScheduled = true;
+    }
+    fPurgeTasks.add(EmptyGraveyard, this);
+}
+
+void DiscardableMemoryPool::EmptyGraveyard(DiscardableMemoryPool* pool) {
+    SkTDArray<void*> dead;
+    for (;;) {
+        {
+            SkAutoMutexAcquire autoMutexAcquire(pool->fMutex);
+            dead.swap(pool->fGraveyard);
+            if (dead.isEmpty()) {
+                pool->fPurgeScheduled = false;
+                return;
+            }
+        }
+        // The frees happen here, without the mutex held.
+        dead.freeAll();
+    }
+}
+
 SkDiscardableMemory* DiscardableMemoryPool::create(size_t bytes) {
     void* addr = sk_malloc_flags(bytes, 0);
     if (NULL == addr) {
@@ -180,10 +257,13 @@ SkDiscardableMemory* DiscardableMemoryPool::create(size_t bytes) {
     }
     PoolDiscardableMemory* dm = SkNEW_ARGS(PoolDiscardableMemory,
                                              (this, addr, bytes));
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    fList.addToHead(dm);
-    fUsed += bytes;
-    this->dumpDownTo(fBudget);
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        fYoung.addToHead(dm);
+        fUsed += bytes;
+        this->dumpDownTo(fBudget);
+    }
+    this->schedulePurge();
     return dm;
 }
 
@@ -195,9 +275,15 @@ void DiscardableMemoryPool::free(PoolDiscardableMemory* dm) {
         dm->fPointer = NULL;
         SkASSERT(fUsed >= dm->fBytes);
         fUsed -= dm->fBytes;
-        fList.remove(dm);
+        if (dm->fOld) {
+            SkASSERT(fOldUsed >= dm->fBytes);
+            fOldUsed -= dm->fBytes;
+            fOld.remove(dm);
+        } else {
+            fYoung.remove(dm);
+        }
     } else {
-        SkASSERT(!fList.isInList(dm));
+        SkASSERT(!fYoung.isInList(dm) && !fOld.isInList(dm));
     }
 }
 
@@ -219,8 +305,24 @@ bool DiscardableMemoryPool::lock(PoolDiscardableMemory* dm) {
         return false;
     }
     dm->fLocked = true;
-    fList.remove(dm);
-    fList.addToHead(dm);
+    if (dm->fOld) {
+        fOld.remove(dm);
+    } else {
+        // A second use: promote dm to the old generation.
+        fYoung.remove(dm);
+        dm->fOld = true;
+        fOldUsed += dm->fBytes;
+    }
+    fOld.addToHead(dm);
+    // Keep the old generation from crowding out new blocks entirely.
+    const size_t oldBudget = fBudget / 4 * 3;
+    while (fOldUsed > oldBudget) {
+        PoolDiscardableMemory* demoted = fOld.tail();
+        fOld.remove(demoted);
+        demoted->fOld = false;
+        fOldUsed -= demoted->fBytes;
+        fYoung.addToHead(demoted);
+    }
     #if SK_LAZY_CACHE_STATS
     ++fCacheHits;
     #endif  // SK_LAZY_CACHE_STATS
@@ -229,35 +331,53 @@ bool DiscardableMemoryPool::lock(PoolDiscardableMemory* dm) {
 
 void DiscardableMemoryPool::unlock(PoolDiscardableMemory* dm) {
     SkASSERT(dm != NULL);
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    dm->fLocked = false;
-    this->dumpDownTo(fBudget);
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        dm->fLocked = false;
+        this->dumpDownTo(fBudget);
+    }
+    this->schedulePurge();
 }
 
 size_t DiscardableMemoryPool::getRAMUsed() {
     return fUsed;
 }
 void DiscardableMemoryPool::setRAMBudget(size_t budget) {
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    fBudget = budget;
-    this->dumpDownTo(fBudget);
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        fBudget = budget;
+        this->dumpDownTo(fBudget);
+    }
+    this->schedulePurge();
 }
 void DiscardableMemoryPool::dumpPool() {
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    this->dumpDownTo(0);
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        this->dumpDownTo(0);
+    }
+    this->schedulePurge();
+}
+void DiscardableMemoryPool::dumpYoungGeneration() {
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        this->dumpListDownTo(&fYoung, 0);
+    }
+    this->schedulePurge();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 SK_DECLARE_STATIC_MUTEX(gMutex);
 SkDiscardableMemoryPool* create_global_pool() {
     return SkDiscardableMemoryPool::Create(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE,
-                                           &gMutex);
+                                           &gMutex,
+                                           SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_ASYNC_PURGE);
 }
 
 }  // namespace
 
-SkDiscardableMemoryPool* SkDiscardableMemoryPool::Create(size_t size, SkBaseMutex* mutex) {
-    return SkNEW_ARGS(DiscardableMemoryPool, (size, mutex));
+SkDiscardableMemoryPool* SkDiscardableMemoryPool::Create(size_t size, SkBaseMutex* mutex,
+                                                         bool asyncPurge) {
+    return SkNEW_ARGS(DiscardableMemoryPool, (size, mutex, asyncPurge));
 }
 
 SK_DECLARE_STATIC_LAZY_PTR(SkDiscardableMemoryPool, global, create_global_pool);
@@ -267,3 +387,16 @@ SkDiscardableMemoryPool* SkGetGlobalDiscardableMemoryPool() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+
+void SkGraphics::PurgeForMemoryPressure(MemoryPressure pressure) {
+    SkDiscardableMemoryPool* pool = SkGetGlobalDiscardableMemoryPool();
+    if (kLow_MemoryPressure == pressure) {
+        pool->dumpYoungGeneration();
+        return;
+    }
+    pool->dumpPool();
+    PurgeResourceCache();
+    if (kComplete_MemoryPressure == pressure) {
+        PurgeFontCache();
+    }
+}
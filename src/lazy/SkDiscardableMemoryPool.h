@@ -24,6 +24,17 @@
  *  budget of memory.  When the allocated memory exceeds this size,
  *  unlocked blocks of memory are purged.  If all memory is locked, it
  *  can exceed the memory-use budget.
+ *
+ *  Blocks start out in a young generation, and move to an old one the
+ *  first time they are locked again, so images that are drawn over and
+ *  over outlive ones that were decoded once.  Young blocks are purged
+ *  first, least recently used first.  The old generation is held to
+ *  3/4 of the budget; its least recently used blocks fall back into
+ *  the young one.
+ *
+ *  A pool created with asyncPurge frees the memory of purged blocks
+ *  on an SkTaskGroup instead of in the call that went over budget.
+ *  The purged blocks stop counting towards getRAMUsed() right away.
  */
 class SkDiscardableMemoryPool : public SkDiscardableMemory::Factory {
 public:
@@ -36,6 +47,9 @@ public:
     /** purges all unlocked DMs */
     virtual void dumpPool() = 0;
 
+    /** purges the unlocked DMs that have not been locked again since they were created */
+    virtual void dumpYoungGeneration() = 0;
+
     #if SK_LAZY_CACHE_STATS
     /**
      * These two values are a count of the number of successful and
@@ -51,9 +65,10 @@ public:
      *  This non-global pool can be used for unit tests to verify that
      *  the pool works.
      *  Without mutex, will be not be thread safe.
+     *  asyncPurge requires a mutex.
      */
     static SkDiscardableMemoryPool* Create(
-            size_t size, SkBaseMutex* mutex = NULL);
+            size_t size, SkBaseMutex* mutex = NULL, bool asyncPurge = false);
 };
 
 /**
@@ -66,4 +81,8 @@ SkDiscardableMemoryPool* SkGetGlobalDiscardableMemoryPool();
 #define SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE (128 * 1024 * 1024)
 #endif
 
+#if !defined(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_ASYNC_PURGE)
+#define SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_ASYNC_PURGE 1
+#endif
+
 #endif  // SkDiscardableMemoryPool_DEFINED
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapFilter_opts_AVX2.h"
+
+// Some compilers can't compile AVX2 intrinsics.  We give them stub methods.
+// The stubs should never be called, so we make them crash just to confirm that.
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+void convolveVertically_AVX2(const SkConvolutionFilter1D::ConvolutionFixed*, int,
+                             unsigned char* const*, int, unsigned char*, bool) {
+    sk_throw();
+}
+
+#else
+
+#include <immintrin.h>      // AVX2 intrinsics
+#include "SkBitmapFilter_opts_SSE2.h"
+#include "SkTemplates.h"
+
+// This is the 8-pixel version of convolveVertically_SSE2(), and computes exactly the same
+// results.  AVX2 unpacks and packs within each 128-bit lane, so pixels 0-3 and 4-7 stay in
+// their own lanes from the load through to the store.
+template<bool has_alpha>
+static void convolveVertically_AVX2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                                    int filter_length,
+                                    unsigned char* const* source_data_rows,
+                                    int pixel_width,
+                                    unsigned char* out_row) {
+    const int width = pixel_width & ~7;
+
+    const __m256i zero = _mm256_setzero_si256();
+    // Output eight pixels per iteration (32 bytes).
+    for (int out_x = 0; out_x < width; out_x += 8) {
+        // Accumulated result for each pixel. 32 bits per RGBA channel.
+        __m256i accum0 = _mm256_setzero_si256();
+        __m256i accum1 = _mm256_setzero_si256();
+        __m256i accum2 = _mm256_setzero_si256();
+        __m256i accum3 = _mm256_setzero_si256();
+
+        // Convolve with one filter coefficient per iteration.
+        for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+            const __m256i coeff16 = _mm256_set1_epi16(filter_values[filter_y]);
+
+            // [8] p7 p6 p5 p4 | p3 p2 p1 p0
+            const __m256i src8 = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(&source_data_rows[filter_y][out_x << 2]));
+
+            // [16] p5 p4 | p1 p0
+            __m256i src16 = _mm256_unpacklo_epi8(src8, zero);
+            __m256i mul_hi = _mm256_mulhi_epi16(src16, coeff16);
+            __m256i mul_lo = _mm256_mullo_epi16(src16, coeff16);
+            // [32] p4 | p0
+            accum0 = _mm256_add_epi32(accum0, _mm256_unpacklo_epi16(mul_lo, mul_hi));
+            // [32] p5 | p1
+            accum1 = _mm256_add_epi32(accum1, _mm256_unpackhi_epi16(mul_lo, mul_hi));
+
+            // [16] p7 p6 | p3 p2
+            src16 = _mm256_unpackhi_epi8(src8, zero);
+            mul_hi = _mm256_mulhi_epi16(src16, coeff16);
+            mul_lo = _mm256_mullo_epi16(src16, coeff16);
+            // [32] p6 | p2
+            accum2 = _mm256_add_epi32(accum2, _mm256_unpacklo_epi16(mul_lo, mul_hi));
+            // [32] p7 | p3
+            accum3 = _mm256_add_epi32(accum3, _mm256_unpackhi_epi16(mul_lo, mul_hi));
+        }
+
+        // Shift right for fixed point implementation.
+        accum0 = _mm256_srai_epi32(accum0, SkConvolutionFilter1D::kShiftBits);
+        accum1 = _mm256_srai_epi32(accum1, SkConvolutionFilter1D::kShiftBits);
+        accum2 = _mm256_srai_epi32(accum2, SkConvolutionFilter1D::kShiftBits);
+        accum3 = _mm256_srai_epi32(accum3, SkConvolutionFilter1D::kShiftBits);
+
+        // Pack 32 bits to 16 bits per channel (signed saturation), then to 8 bits per channel
+        // (unsigned saturation).
+        // [8] p7 p6 p5 p4 | p3 p2 p1 p0
+        accum0 = _mm256_packus_epi16(_mm256_packs_epi32(accum0, accum1),
+                                     _mm256_packs_epi32(accum2, accum3));
+
+        if (has_alpha) {
+            // Make sure the value of alpha channel is always larger than maximum
+            // value of color channels.
+            __m256i b = _mm256_max_epu8(_mm256_srli_epi32(accum0, 8), accum0);
+            b = _mm256_max_epu8(_mm256_srli_epi32(accum0, 16), b);
+            accum0 = _mm256_max_epu8(_mm256_slli_epi32(b, 24), accum0);
+        } else {
+            // Set value of alpha channels to 0xFF.
+            accum0 = _mm256_or_si256(accum0, _mm256_set1_epi32(0xff000000));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_row), accum0);
+        out_row += 32;
+    }
+
+    // The last few pixels are left to SSE2.
+    if (pixel_width & 7) {
+        SkAutoSTMalloc<64, unsigned char*> rows(filter_length);
+        for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+            rows[filter_y] = source_data_rows[filter_y] + (width << 2);
+        }
+        convolveVertically_SSE2(filter_values, filter_length, rows.get(), pixel_width - width,
+                                out_row, has_alpha);
+    }
+}
+
+void convolveVertically_AVX2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+    if (has_alpha) {
+        convolveVertically_AVX2<true>(filter_values, filter_length, source_data_rows,
+                                      pixel_width, out_row);
+    } else {
+        convolveVertically_AVX2<false>(filter_values, filter_length, source_data_rows,
+                                       pixel_width, out_row);
+    }
+}
+
+#endif
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapFilter_opts_AVX2_DEFINED
+#define SkBitmapFilter_opts_AVX2_DEFINED
+
+#include "SkConvolver.h"
+
+void convolveVertically_AVX2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha);
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitRow_opts_AVX2.h"
+
+// Some compilers can't compile AVX2 intrinsics.  We give them stub methods.
+// The stubs should never be called, so we make them crash just to confirm that.
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT, const SkPMColor* SK_RESTRICT, int, U8CPU) {
+    sk_throw();
+}
+
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT, const SkPMColor* SK_RESTRICT, int, U8CPU) {
+    sk_throw();
+}
+
+void Color32_AVX2(SkPMColor[], const SkPMColor[], int, SkPMColor) {
+    sk_throw();
+}
+
+void SkARGB32_A8_BlitMask_AVX2(void*, size_t, const void*, size_t, SkColor, int, int) {
+    sk_throw();
+}
+
+#else
+
+#include <immintrin.h>      // AVX2 intrinsics
+#include "SkColorPriv.h"
+#include "SkUtils.h"
+
+// These are the 8-pixel versions of the helpers in SkColor_opts_SSE2.h, and compute exactly the
+// same results, lane for lane.
+
+static inline __m256i SkAlphaMulQ_AVX2(const __m256i& c, const __m256i& scale) {
+    const __m256i mask = _mm256_set1_epi32(0xFF00FF);
+    __m256i s = _mm256_or_si256(_mm256_slli_epi32(scale, 16), scale);
+
+    // uint32_t rb = ((c & mask) * scale) >> 8
+    __m256i rb = _mm256_and_si256(mask, c);
+    rb = _mm256_mullo_epi16(rb, s);
+    rb = _mm256_srli_epi16(rb, 8);
+
+    // uint32_t ag = ((c >> 8) & mask) * scale
+    __m256i ag = _mm256_srli_epi16(c, 8);
+    ag = _mm256_mullo_epi16(ag, s);
+
+    // (rb & mask) | (ag & ~mask)
+    ag = _mm256_andnot_si256(mask, ag);
+    return _mm256_or_si256(rb, ag);
+}
+
+static inline __m256i SkGetPackedA32_AVX2(const __m256i& src) {
+#if SK_A32_SHIFT == 24
+    return _mm256_srli_epi32(src, 24);
+#else
+    __m256i a = _mm256_slli_epi32(src, (24 - SK_A32_SHIFT));
+    return _mm256_srli_epi32(a, 24);
+#endif
+}
+
+// Portable version is SkPMSrcOver in SkColorPriv.h.
+static inline __m256i SkPMSrcOver_AVX2(const __m256i& src, const __m256i& dst) {
+    return _mm256_add_epi32(src,
+                            SkAlphaMulQ_AVX2(dst, _mm256_sub_epi32(_mm256_set1_epi32(256),
+                                                                   SkGetPackedA32_AVX2(src))));
+}
+
+// Portable version is SkBlendARGB32 in SkColorPriv.h.
+static inline __m256i SkBlendARGB32_AVX2(const __m256i& src, const __m256i& dst,
+                                         const __m256i& aa) {
+    __m256i src_scale = _mm256_add_epi32(aa, _mm256_set1_epi32(1));
+    // SkAlpha255To256(255 - SkAlphaMul(SkGetPackedA32(src), src_scale))
+    __m256i dst_scale = SkGetPackedA32_AVX2(src);
+    dst_scale = _mm256_mullo_epi16(dst_scale, src_scale);
+    dst_scale = _mm256_srli_epi16(dst_scale, 8);
+    dst_scale = _mm256_sub_epi32(_mm256_set1_epi32(256), dst_scale);
+
+    __m256i result = SkAlphaMulQ_AVX2(src, src_scale);
+    return _mm256_add_epi8(result, SkAlphaMulQ_AVX2(dst, dst_scale));
+}
+
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count,
+                                U8CPU alpha) {
+    SkASSERT(alpha == 255);
+    // As long as we can, we'll work on 16 pixels at once.
+    int count16 = count / 16;
+    __m256i* dst8 = (__m256i*)dst;
+    const __m256i* src8 = (const __m256i*)src;
+    const __m256i alphaMask = _mm256_set1_epi32(0xFF << SK_A32_SHIFT);
+
+    for (int i = 0; i < count16 * 2; i += 2) {
+        __m256i s0 = _mm256_loadu_si256(src8+i+0),
+                s1 = _mm256_loadu_si256(src8+i+1);
+
+        if (_mm256_testz_si256(_mm256_or_si256(s0, s1), alphaMask)) {
+            // All 16 source pixels are fully transparent.  There's nothing to do!
+            continue;
+        }
+        if (_mm256_testc_si256(_mm256_and_si256(s0, s1), alphaMask)) {
+            // All 16 source pixels are fully opaque.  There's no need to read dst or blend it.
+            _mm256_storeu_si256(dst8+i+0, s0);
+            _mm256_storeu_si256(dst8+i+1, s1);
+            continue;
+        }
+        // The general slow case: do the blend for all 16 pixels.
+        _mm256_storeu_si256(dst8+i+0, SkPMSrcOver_AVX2(s0, _mm256_loadu_si256(dst8+i+0)));
+        _mm256_storeu_si256(dst8+i+1, SkPMSrcOver_AVX2(s1, _mm256_loadu_si256(dst8+i+1)));
+    }
+
+    int i = count16 * 16;
+    if (i + 8 <= count) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i* d = (__m256i*)(dst + i);
+        _mm256_storeu_si256(d, SkPMSrcOver_AVX2(s, _mm256_loadu_si256(d)));
+        i += 8;
+    }
+
+    // Wrap up the last <= 7 pixels.
+    for (; i < count; i++) {
+        // This check is not really necessarily, but it prevents pointless autovectorization.
+        if (src[i] & 0xFF000000) {
+            dst[i] = SkPMSrcOver(src[i], dst[i]);
+        }
+    }
+}
+
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                               const SkPMColor* SK_RESTRICT src,
+                               int count,
+                               U8CPU alpha) {
+    SkASSERT(alpha <= 255);
+    const __m256i aa = _mm256_set1_epi32(alpha);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i* d = (__m256i*)(dst + i);
+        _mm256_storeu_si256(d, SkBlendARGB32_AVX2(s, _mm256_loadu_si256(d), aa));
+    }
+    for (; i < count; i++) {
+        dst[i] = SkBlendARGB32(src[i], dst[i], alpha);
+    }
+}
+
+void Color32_AVX2(SkPMColor dst[], const SkPMColor src[], int count, SkPMColor color) {
+    if (count <= 0) {
+        return;
+    }
+
+    if (0 == color) {
+        if (src != dst) {
+            memcpy(dst, src, count * sizeof(SkPMColor));
+        }
+        return;
+    }
+
+    unsigned colorA = SkGetPackedA32(color);
+    if (255 == colorA) {
+        sk_memset32(dst, color, count);
+        return;
+    }
+
+    unsigned scale = 256 - SkAlpha255To256(colorA);
+    const __m256i color_wide = _mm256_set1_epi32(color);
+    const __m256i scale_wide = _mm256_set1_epi32(scale);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        s = SkAlphaMulQ_AVX2(s, scale_wide);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi8(color_wide, s));
+    }
+    for (; i < count; i++) {
+        dst[i] = color + SkAlphaMulQ(src[i], scale);
+    }
+}
+
+void SkARGB32_A8_BlitMask_AVX2(void* device, size_t dstRB, const void* maskPtr,
+                               size_t maskRB, SkColor origColor,
+                               int width, int height) {
+    SkPMColor color = SkPreMultiplyColor(origColor);
+    const bool opaque = 0xFF == SkGetPackedA32(color);
+    const __m256i src_pixel = _mm256_set1_epi32(color);
+    char* dstRow = (char*)device;
+    const uint8_t* mask = (const uint8_t*)maskPtr;
+    do {
+        SkPMColor* dst = (SkPMColor*)dstRow;
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            uint64_t aa8;
+            memcpy(&aa8, mask + x, sizeof(aa8));
+            if (0 == aa8) {
+                // Zero coverage leaves dst exactly as it was.
+                continue;
+            }
+            __m256i* d = (__m256i*)(dst + x);
+            if (opaque && ~(uint64_t)0 == aa8) {
+                // Full coverage of an opaque color blends to exactly the color.
+                _mm256_storeu_si256(d, src_pixel);
+                continue;
+            }
+            __m256i alpha_wide = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(mask + x)));
+            _mm256_storeu_si256(d, SkBlendARGB32_AVX2(src_pixel, _mm256_loadu_si256(d),
+                                                      alpha_wide));
+        }
+        for (; x < width; x++) {
+            dst[x] = SkBlendARGB32(color, dst[x], mask[x]);
+        }
+        dstRow += dstRB;
+        mask += maskRB;
+    } while (--height != 0);
+}
+
+#endif
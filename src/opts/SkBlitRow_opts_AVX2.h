@@ -0,0 +1,28 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlitRow_opts_AVX2_DEFINED
+#define SkBlitRow_opts_AVX2_DEFINED
+
+#include "SkBlitRow.h"
+
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT,
+                                const SkPMColor* SK_RESTRICT,
+                                int count,
+                                U8CPU alpha);
+
+void S32A_Blend_BlitRow32_AVX2(SkPMColor* SK_RESTRICT,
+                               const SkPMColor* SK_RESTRICT,
+                               int count,
+                               U8CPU alpha);
+
+void Color32_AVX2(SkPMColor dst[], const SkPMColor src[], int count, SkPMColor color);
+
+void SkARGB32_A8_BlitMask_AVX2(void* device, size_t dstRB, const void* mask,
+                               size_t maskRB, SkColor color,
+                               int width, int height);
+#endif
@@ -861,6 +861,104 @@ void S32_D565_Blend_Dither_neon(uint16_t *dst, const SkPMColor *src,
     }
 }
 
+void S32A_D565_Blend_Dither_neon(uint16_t* SK_RESTRICT dst,
+                                 const SkPMColor* SK_RESTRICT src,
+                                 int count, U8CPU alpha, int x, int y) {
+    SkASSERT(255 > alpha);
+
+    // rescale alpha to range 1 - 255 (alpha is < 255, so this fits in a byte)
+    int src_scale = SkAlpha255To256(alpha);
+
+    if (count >= 8) {
+        /* select row and offset for dither array */
+        const uint8_t *dstart = &gDitherMatrix_Neon[(y&3)*12 + (x&3)];
+
+        uint8x8_t vdither = vld1_u8(dstart);         // load dither values
+        uint8x8_t vdither_g = vshr_n_u8(vdither, 1); // calc. green dither values
+
+        uint8x8_t vsrc_scale8 = vdup_n_u8(src_scale);
+        uint16x8_t vsrc_scale = vdupq_n_u16(src_scale);
+        uint16x8_t v256 = vdupq_n_u16(256);
+        uint16x8_t vmask_b = vdupq_n_u16(SK_B16_MASK);
+
+        do {
+            uint8x8x4_t vsrc;
+            uint16x8_t vsrc_dit_r, vsrc_dit_g, vsrc_dit_b;
+            uint16x8_t vdst, vdst_r, vdst_g, vdst_b;
+            uint16x8_t vdst_scale;
+            uint16x8_t vres_r, vres_g, vres_b;
+
+            // Load source
+#ifdef SK_CPU_ARM64
+            vsrc = sk_vld4_u8_arm64_4(src);
+#else
+            vsrc = vld4_u8((uint8_t*)src);
+            src += 8;
+#endif
+
+            // dst_scale = SkAlpha255To256(255 - SkAlphaMul(sa, src_scale))
+            vdst_scale = vsubw_u8(v256, vshrn_n_u16(vmull_u8(vsrc.val[NEON_A], vsrc_scale8), 8));
+
+            // add dither to the source and shift it to 565
+            vsrc_dit_r = vaddl_u8(vsrc.val[NEON_R], vdither);
+            vsrc_dit_g = vaddl_u8(vsrc.val[NEON_G], vdither_g);
+            vsrc_dit_b = vaddl_u8(vsrc.val[NEON_B], vdither);
+            vsrc_dit_r = vshrq_n_u16(vsubw_u8(vsrc_dit_r, vshr_n_u8(vsrc.val[NEON_R], 5)), 3);
+            vsrc_dit_g = vshrq_n_u16(vsubw_u8(vsrc_dit_g, vshr_n_u8(vsrc.val[NEON_G], 6)), 2);
+            vsrc_dit_b = vshrq_n_u16(vsubw_u8(vsrc_dit_b, vshr_n_u8(vsrc.val[NEON_B], 5)), 3);
+
+            // Load dst and unpack
+            vdst = vld1q_u16(dst);
+            vdst_g = vshrq_n_u16(vshlq_n_u16(vdst, SK_R16_BITS), SK_R16_BITS + SK_B16_BITS);
+            vdst_r = vshrq_n_u16(vdst, SK_R16_SHIFT);
+            vdst_b = vandq_u16(vdst, vmask_b);
+
+            // (src * src_scale + dst * dst_scale) >> 8
+            vres_r = vshrq_n_u16(vmlaq_u16(vmulq_u16(vsrc_dit_r, vsrc_scale), vdst_r, vdst_scale), 8);
+            vres_g = vshrq_n_u16(vmlaq_u16(vmulq_u16(vsrc_dit_g, vsrc_scale), vdst_g, vdst_scale), 8);
+            vres_b = vshrq_n_u16(vmlaq_u16(vmulq_u16(vsrc_dit_b, vsrc_scale), vdst_b, vdst_scale), 8);
+
+            // pack result
+            vres_b = vsliq_n_u16(vres_b, vres_g, SK_G16_SHIFT); // insert green into blue
+            vres_b = vsliq_n_u16(vres_b, vres_r, SK_R16_SHIFT); // insert red into green/blue
+
+            // Store result
+            vst1q_u16(dst, vres_b);
+
+            // Next iteration
+            dst += 8;
+            count -= 8;
+        } while (count >= 8);
+    }
+
+    // Leftovers
+    if (count > 0) {
+        DITHER_565_SCAN(y);
+        do {
+            SkPMColor c = *src++;
+            SkPMColorAssert(c);
+            if (c) {
+                unsigned d = *dst;
+                int sa = SkGetPackedA32(c);
+                int dst_scale = SkAlpha255To256(255 - SkAlphaMul(sa, src_scale));
+                int dither = DITHER_VALUE(x);
+
+                int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+                int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+                int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+
+                int dr = (sr * src_scale + SkGetPackedR16(d) * dst_scale) >> 8;
+                int dg = (sg * src_scale + SkGetPackedG16(d) * dst_scale) >> 8;
+                int db = (sb * src_scale + SkGetPackedB16(d) * dst_scale) >> 8;
+
+                *dst = SkPackRGB16(dr, dg, db);
+            }
+            dst += 1;
+            DITHER_INC_X(x);
+        } while (--count != 0);
+    }
+}
+
 void S32A_Opaque_BlitRow32_neon(SkPMColor* SK_RESTRICT dst,
                                 const SkPMColor* SK_RESTRICT src,
                                 int count, U8CPU alpha) {
@@ -1785,7 +1883,7 @@ const SkBlitRow::Proc16 sk_blitrow_platform_565_procs_arm_neon[] = {
     S32_D565_Opaque_Dither_neon,
     S32_D565_Blend_Dither_neon,
     S32A_D565_Opaque_Dither_neon,
-    NULL,   // S32A_D565_Blend_Dither
+    S32A_D565_Blend_Dither_neon,
 };
 
 const SkBlitRow::ColorProc16 sk_blitrow_platform_565_colorprocs_arm_neon[] = {
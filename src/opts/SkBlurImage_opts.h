@@ -10,8 +10,13 @@
 
 #include "SkColorPriv.h"
 
-typedef void (*SkBoxBlurProc)(const SkPMColor* src, int srcStride, SkPMColor* dst, int kernelSize,
-                              int leftOffset, int rightOffset, int width, int height);
+/**
+ *  Box blurs height rows of width pixels each. srcStride and dstStride are the distances in
+ *  pixels between rows (or, for the procs that read or write transposed, columns) of src and dst.
+ */
+typedef void (*SkBoxBlurProc)(const SkPMColor* src, int srcStride, SkPMColor* dst, int dstStride,
+                              int kernelSize, int leftOffset, int rightOffset,
+                              int width, int height);
 
 bool SkBoxBlurGetPlatformProcs(SkBoxBlurProc* boxBlurX,
                                SkBoxBlurProc* boxBlurY,
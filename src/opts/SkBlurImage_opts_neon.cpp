@@ -55,14 +55,15 @@ inline void store_2_pixels(uint16x8_t result16x8, SkPMColor* dst, int dstStride)
  * fast path for kernel size less than 128
  */
 template<BlurDirection srcDirection, BlurDirection dstDirection>
-void SkDoubleRowBoxBlur_NEON(const SkPMColor** src, int srcStride, SkPMColor** dst, int kernelSize,
-                        int leftOffset, int rightOffset, int width, int* height)
+void SkDoubleRowBoxBlur_NEON(const SkPMColor** src, int srcStride, SkPMColor** dst, int dstStride,
+                             int kernelSize, int leftOffset, int rightOffset, int width,
+                             int* height)
 {
     const int rightBorder = SkMin32(rightOffset + 1, width);
     const int srcStrideX = srcDirection == kX ? 1 : srcStride;
-    const int dstStrideX = dstDirection == kX ? 1 : *height;
+    const int dstStrideX = dstDirection == kX ? 1 : dstStride;
     const int srcStrideY = srcDirection == kX ? srcStride : 1;
-    const int dstStrideY = dstDirection == kX ? width : 1;
+    const int dstStrideY = dstDirection == kX ? dstStride : 1;
     const uint16x8_t scale = vdupq_n_u16((1 << 15) / kernelSize);
 
     for (; *height >= 2; *height -= 2) {
@@ -80,7 +81,7 @@ void SkDoubleRowBoxBlur_NEON(const SkPMColor** src, int srcStride, SkPMColor** d
             // val = (sum * scale * 2 + 0x8000) >> 16
             uint16x8_t resultPixels = vreinterpretq_u16_s16(vqrdmulhq_s16(
                 vreinterpretq_s16_u16(sum), vreinterpretq_s16_u16(scale)));
-            store_2_pixels<dstDirection>(resultPixels, dptr, width);
+            store_2_pixels<dstDirection>(resultPixels, dptr, dstStride);
 
             if (x >= leftOffset) {
                 sum = vsubw_u8(sum,
@@ -112,21 +113,21 @@ static inline uint16x4_t expand(uint32_t a) {
 }
 
 template<BlurDirection srcDirection, BlurDirection dstDirection>
-void SkBoxBlur_NEON(const SkPMColor* src, int srcStride, SkPMColor* dst, int kernelSize,
-                    int leftOffset, int rightOffset, int width, int height)
+void SkBoxBlur_NEON(const SkPMColor* src, int srcStride, SkPMColor* dst, int dstStride,
+                    int kernelSize, int leftOffset, int rightOffset, int width, int height)
 {
     const int rightBorder = SkMin32(rightOffset + 1, width);
     const int srcStrideX = srcDirection == kX ? 1 : srcStride;
-    const int dstStrideX = dstDirection == kX ? 1 : height;
+    const int dstStrideX = dstDirection == kX ? 1 : dstStride;
     const int srcStrideY = srcDirection == kX ? srcStride : 1;
-    const int dstStrideY = dstDirection == kX ? width : 1;
+    const int dstStrideY = dstDirection == kX ? dstStride : 1;
     const uint32x4_t scale = vdupq_n_u32((1 << 24) / kernelSize);
     const uint32x4_t half = vdupq_n_u32(1 << 23);
 
     if (1 < kernelSize && kernelSize < 128)
     {
-        SkDoubleRowBoxBlur_NEON<srcDirection, dstDirection>(&src, srcStride, &dst, kernelSize,
-            leftOffset, rightOffset, width, &height);
+        SkDoubleRowBoxBlur_NEON<srcDirection, dstDirection>(&src, srcStride, &dst, dstStride,
+            kernelSize, leftOffset, rightOffset, width, &height);
     }
 
     for (; height > 0; height--) {
@@ -0,0 +1,21 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkChecksum_opts_DEFINED
+#define SkChecksum_opts_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  Hashes bytes of data, starting from seed, with a hardware CRC32C instruction.  The result is
+ *  only meaningful within one process: see SkChecksum::Fast.
+ */
+typedef uint32_t (*SkChecksumHashProc)(const void* data, size_t bytes, uint32_t seed);
+
+SkChecksumHashProc SkChecksumGetPlatformHashProc();
+
+#endif
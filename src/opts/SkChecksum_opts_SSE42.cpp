@@ -0,0 +1,50 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkChecksum.h"
+#include "SkChecksum_opts_SSE42.h"
+
+#include <nmmintrin.h>
+#include <string.h>
+
+uint32_t SkChecksumHash_SSE42(const void* data, size_t bytes, uint32_t seed) {
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    uint32_t hash = seed;
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t hash64 = hash;
+    // crc32 has a latency of 3 cycles but can start every cycle, so hash 24 byte chunks as three
+    // independent streams and fold them together at the end.
+    if (bytes >= 24) {
+        uint64_t a = hash64, b = ~hash64, c = hash64 ^ bytes;
+        for (; bytes >= 24; bytes -= 24, ptr += 24) {
+            uint64_t v[3];
+            memcpy(v, ptr, 24);
+            a = _mm_crc32_u64(a, v[0]);
+            b = _mm_crc32_u64(b, v[1]);
+            c = _mm_crc32_u64(c, v[2]);
+        }
+        hash64 = _mm_crc32_u64(_mm_crc32_u64(a, b), c);
+    }
+    for (; bytes >= 8; bytes -= 8, ptr += 8) {
+        uint64_t v;
+        memcpy(&v, ptr, 8);
+        hash64 = _mm_crc32_u64(hash64, v);
+    }
+    hash = (uint32_t)hash64;
+#endif
+    for (; bytes >= 4; bytes -= 4, ptr += 4) {
+        uint32_t v;
+        memcpy(&v, ptr, 4);
+        hash = _mm_crc32_u32(hash, v);
+    }
+    for (; bytes > 0; bytes--, ptr++) {
+        hash = _mm_crc32_u8(hash, *ptr);
+    }
+    // CRC32C spreads every input bit over the result, but only linearly; Mix breaks that up
+    // so hash tables can use any of the bits.
+    return SkChecksum::Mix(hash);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkChecksum.h"
+#include "SkChecksum_opts.h"
+
+// The CRC32 instructions are optional in ARMv8 and absent before it, and there is no run-time
+// check for them here, so they are only used when the compiler was told the CPU has them.
+#if defined(__ARM_FEATURE_CRC32)
+
+#include <arm_acle.h>
+#include <string.h>
+
+static uint32_t hash_crc32c_arm(const void* data, size_t bytes, uint32_t seed) {
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    uint32_t hash = seed;
+    for (; bytes >= 8; bytes -= 8, ptr += 8) {
+        uint64_t v;
+        memcpy(&v, ptr, 8);
+        hash = __crc32cd(hash, v);
+    }
+    for (; bytes >= 4; bytes -= 4, ptr += 4) {
+        uint32_t v;
+        memcpy(&v, ptr, 4);
+        hash = __crc32cw(hash, v);
+    }
+    for (; bytes > 0; bytes--, ptr++) {
+        hash = __crc32cb(hash, *ptr);
+    }
+    return SkChecksum::Mix(hash);
+}
+
+SkChecksumHashProc SkChecksumGetPlatformHashProc() {
+    return hash_crc32c_arm;
+}
+
+#else
+
+SkChecksumHashProc SkChecksumGetPlatformHashProc() {
+    return NULL;
+}
+
+#endif
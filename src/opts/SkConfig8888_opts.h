@@ -0,0 +1,30 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConfig8888_opts_DEFINED
+#define SkConfig8888_opts_DEFINED
+
+#include "SkTypes.h"
+
+enum SkConfig8888RowProcType {
+    kSwapRB_SkConfig8888RowProcType,
+    kPremul_SkConfig8888RowProcType,
+    kSwapRBPremul_SkConfig8888RowProcType,
+    kUnpremul_SkConfig8888RowProcType,
+    kSwapRBUnpremul_SkConfig8888RowProcType,
+};
+
+/**
+ *  Converts count RGBA or BGRA pixels, optionally swapping R and B and then premultiplying or
+ *  unpremultiplying them. The results match convert32_row() in src/core/SkConfig8888.cpp
+ *  exactly, and src may equal dst (but may not otherwise overlap it).
+ */
+typedef void (*SkConfig8888RowProc)(uint32_t* dst, const uint32_t* src, int count);
+
+SkConfig8888RowProc SkConfig8888GetPlatformRowProc(SkConfig8888RowProcType type);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkConfig8888_opts_SSSE3.h"
+#include "SkUnPreMultiply.h"
+
+/* With the exception of the compilers that don't support it, we always build the
+ * SSSE3 functions and enable the caller to determine SSSE3 support.  However for
+ * compilers that do not support SSSE3 we provide a stub implementation.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+#include <tmmintrin.h>  // SSSE3
+
+enum AlphaOp {
+    kNone_AlphaOp,
+    kPremul_AlphaOp,
+    kUnpremul_AlphaOp,
+};
+
+// RGBA and BGRA both keep alpha in the byte at SK_A32_SHIFT; SkSwizzle_RB() swaps the bytes at
+// SK_R32_SHIFT and SK_B32_SHIFT.
+static const int kR = SK_R32_SHIFT / 8;
+static const int kB = SK_B32_SHIFT / 8;
+static const int kA = SK_A32_SHIFT / 8;
+
+// Returns the _mm_shuffle_epi8() mask that swaps R and B in four pixels.
+static __m128i swap_rb_shuffle() {
+    uint8_t mask[16];
+    for (int i = 0; i < 16; ++i) {
+        mask[i] = i;
+    }
+    for (int p = 0; p < 4; ++p) {
+        mask[4*p + kR] = 4*p + kB;
+        mask[4*p + kB] = 4*p + kR;
+    }
+    return _mm_loadu_si128((const __m128i*)mask);
+}
+
+// Returns the mask that copies each pixel's alpha into its color bytes, and zeroes its alpha.
+static __m128i alpha_shuffle() {
+    uint8_t mask[16];
+    for (int p = 0; p < 4; ++p) {
+        for (int i = 0; i < 4; ++i) {
+            mask[4*p + i] = kA == i ? 0x80 : 4*p + kA;
+        }
+    }
+    return _mm_loadu_si128((const __m128i*)mask);
+}
+
+// Returns the mask that spreads the 16 bit half at byte offset half of the two 32 bit lanes
+// starting at lane firstPixel across the four 16 bit lanes of each of those pixels.
+static __m128i scale_shuffle(int firstPixel, int half) {
+    uint8_t mask[16];
+    for (int i = 0; i < 8; ++i) {
+        const int src = 4 * (firstPixel + i / 4) + half;
+        mask[2*i + 0] = src + 0;
+        mask[2*i + 1] = src + 1;
+    }
+    return _mm_loadu_si128((const __m128i*)mask);
+}
+
+// Matches SkMulDiv255Round() on each 16 bit lane.
+static inline __m128i mul_div_255_round(__m128i c, __m128i a) {
+    __m128i prod = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(prod, _mm_srli_epi16(prod, 8)), 8);
+}
+
+// Matches SkUnPreMultiply::ApplyScale() on each 16 bit lane, where scaleHi and scaleLo are the
+// halves of the 32 bit scale. ApplyScale() keeps bits 24-31 of (scale * c + (1 << 23)), which
+// are bits 8-15 of (scaleHi * c + ((scaleLo * c) >> 16) + 128), so 16 bit math is enough.
+static inline __m128i apply_scale(__m128i c, __m128i scaleHi, __m128i scaleLo) {
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(scaleHi, c), _mm_mulhi_epu16(scaleLo, c));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8);
+}
+
+template <bool kSwapRB, AlphaOp kAlphaOp>
+static inline uint32_t convert_pixel(uint32_t c) {
+    if (kSwapRB) {
+        c = SkSwizzle_RB(c);
+    }
+    if (kPremul_AlphaOp == kAlphaOp) {
+        c = SkPreMultiplyARGB(SkGetPackedA32(c), SkGetPackedR32(c),
+                              SkGetPackedG32(c), SkGetPackedB32(c));
+    } else if (kUnpremul_AlphaOp == kAlphaOp) {
+        c = SkUnPreMultiply::UnPreMultiplyPreservingByteOrder(c);
+    }
+    return c;
+}
+
+template <bool kSwapRB, AlphaOp kAlphaOp>
+static void convert_row(uint32_t* dst, const uint32_t* src, int count) {
+    const __m128i swapRB = swap_rb_shuffle();
+    const __m128i alphas = alpha_shuffle();
+    const __m128i alphaMask = _mm_set1_epi32(SK_A32_MASK << SK_A32_SHIFT);
+    const __m128i loPixelsHi = scale_shuffle(0, 2);
+    const __m128i loPixelsLo = scale_shuffle(0, 0);
+    const __m128i hiPixelsHi = scale_shuffle(2, 2);
+    const __m128i hiPixelsLo = scale_shuffle(2, 0);
+    const __m128i zero = _mm_setzero_si128();
+
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(src + x));
+        if (kSwapRB) {
+            pixels = _mm_shuffle_epi8(pixels, swapRB);
+        }
+        if (kPremul_AlphaOp == kAlphaOp) {
+            // Scale the colors by alpha, and the alpha by 255 (which leaves it alone).
+            __m128i scales = _mm_or_si128(_mm_shuffle_epi8(pixels, alphas), alphaMask);
+            __m128i lo = mul_div_255_round(_mm_unpacklo_epi8(pixels, zero),
+                                           _mm_unpacklo_epi8(scales, zero));
+            __m128i hi = mul_div_255_round(_mm_unpackhi_epi8(pixels, zero),
+                                           _mm_unpackhi_epi8(scales, zero));
+            pixels = _mm_packus_epi16(lo, hi);
+        } else if (kUnpremul_AlphaOp == kAlphaOp) {
+            // The table lookups stay scalar; the multiplies by the looked up scales don't.
+            const __m128i scales = _mm_setr_epi32(
+                    SkUnPreMultiply::GetScale(SkGetPackedA32(src[x + 0])),
+                    SkUnPreMultiply::GetScale(SkGetPackedA32(src[x + 1])),
+                    SkUnPreMultiply::GetScale(SkGetPackedA32(src[x + 2])),
+                    SkUnPreMultiply::GetScale(SkGetPackedA32(src[x + 3])));
+            __m128i lo = apply_scale(_mm_unpacklo_epi8(pixels, zero),
+                                     _mm_shuffle_epi8(scales, loPixelsHi),
+                                     _mm_shuffle_epi8(scales, loPixelsLo));
+            __m128i hi = apply_scale(_mm_unpackhi_epi8(pixels, zero),
+                                     _mm_shuffle_epi8(scales, hiPixelsHi),
+                                     _mm_shuffle_epi8(scales, hiPixelsLo));
+            pixels = _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi)),
+                                  _mm_and_si128(alphaMask, pixels));
+        }
+        _mm_storeu_si128((__m128i*)(dst + x), pixels);
+    }
+    for (; x < count; ++x) {
+        dst[x] = convert_pixel<kSwapRB, kAlphaOp>(src[x]);
+    }
+}
+
+void SkConfig8888SwapRB_SSSE3(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<true, kNone_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888Premul_SSSE3(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<false, kPremul_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888SwapRBPremul_SSSE3(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<true, kPremul_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888Unpremul_SSSE3(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<false, kUnpremul_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888SwapRBUnpremul_SSSE3(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<true, kUnpremul_AlphaOp>(dst, src, count);
+}
+
+#else // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+void SkConfig8888SwapRB_SSSE3(uint32_t*, const uint32_t*, int) {
+    sk_throw();
+}
+
+void SkConfig8888Premul_SSSE3(uint32_t*, const uint32_t*, int) {
+    sk_throw();
+}
+
+void SkConfig8888SwapRBPremul_SSSE3(uint32_t*, const uint32_t*, int) {
+    sk_throw();
+}
+
+void SkConfig8888Unpremul_SSSE3(uint32_t*, const uint32_t*, int) {
+    sk_throw();
+}
+
+void SkConfig8888SwapRBUnpremul_SSSE3(uint32_t*, const uint32_t*, int) {
+    sk_throw();
+}
+
+#endif // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
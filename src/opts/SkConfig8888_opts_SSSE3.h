@@ -0,0 +1,19 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConfig8888_opts_SSSE3_DEFINED
+#define SkConfig8888_opts_SSSE3_DEFINED
+
+#include "SkTypes.h"
+
+void SkConfig8888SwapRB_SSSE3(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888Premul_SSSE3(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888SwapRBPremul_SSSE3(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888Unpremul_SSSE3(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888SwapRBUnpremul_SSSE3(uint32_t* dst, const uint32_t* src, int count);
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkConfig8888_opts.h"
+#include "SkConfig8888_opts_neon.h"
+#include "SkUtilsArm.h"
+
+SkConfig8888RowProc SkConfig8888GetPlatformRowProc(SkConfig8888RowProcType type) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    switch (type) {
+        case kSwapRB_SkConfig8888RowProcType:
+            return SkConfig8888SwapRB_neon;
+        case kPremul_SkConfig8888RowProcType:
+            return SkConfig8888Premul_neon;
+        case kSwapRBPremul_SkConfig8888RowProcType:
+            return SkConfig8888SwapRBPremul_neon;
+        case kUnpremul_SkConfig8888RowProcType:
+            return SkConfig8888Unpremul_neon;
+        case kSwapRBUnpremul_SkConfig8888RowProcType:
+            return SkConfig8888SwapRBUnpremul_neon;
+        default:
+            return NULL;
+    }
+#endif
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkConfig8888_opts.h"
+#include "SkConfig8888_opts_neon.h"
+#include "SkUnPreMultiply.h"
+
+#include <arm_neon.h>
+
+/* neon versions of the RGBA and BGRA row conversions.
+ * portable versions are in src/core/SkConfig8888.cpp.
+ */
+
+enum AlphaOp {
+    kNone_AlphaOp,
+    kPremul_AlphaOp,
+    kUnpremul_AlphaOp,
+};
+
+// RGBA and BGRA both keep alpha in the byte at SK_A32_SHIFT; SkSwizzle_RB() swaps the bytes at
+// SK_R32_SHIFT and SK_B32_SHIFT.
+static const int kR = SK_R32_SHIFT / 8;
+static const int kB = SK_B32_SHIFT / 8;
+static const int kA = SK_A32_SHIFT / 8;
+
+// Matches SkMulDiv255Round() on each lane.
+static inline uint8x8_t mul_div_255_round(uint8x8_t c, uint8x8_t a) {
+    uint16x8_t prod = vaddq_u16(vmull_u8(c, a), vdupq_n_u16(128));
+    return vshrn_n_u16(vaddq_u16(prod, vshrq_n_u16(prod, 8)), 8);
+}
+
+// Matches SkUnPreMultiply::ApplyScale() on each lane, where scaleHi and scaleLo are the halves
+// of the 32 bit scale. ApplyScale() keeps bits 24-31 of (scale * c + (1 << 23)), which are
+// bits 8-15 of (scaleHi * c + ((scaleLo * c) >> 16) + 128), so 16 bit math is enough.
+static inline uint8x8_t apply_scale(uint8x8_t c8, uint16x8_t scaleHi, uint16x8_t scaleLo) {
+    uint16x8_t c = vmovl_u8(c8);
+    uint16x8_t mulhi = vcombine_u16(
+            vshrn_n_u32(vmull_u16(vget_low_u16(scaleLo), vget_low_u16(c)), 16),
+            vshrn_n_u32(vmull_u16(vget_high_u16(scaleLo), vget_high_u16(c)), 16));
+    uint16x8_t sum = vaddq_u16(vmulq_u16(scaleHi, c), mulhi);
+    return vshrn_n_u16(vaddq_u16(sum, vdupq_n_u16(128)), 8);
+}
+
+template <bool kSwapRB, AlphaOp kAlphaOp>
+static inline uint32_t convert_pixel(uint32_t c) {
+    if (kSwapRB) {
+        c = SkSwizzle_RB(c);
+    }
+    if (kPremul_AlphaOp == kAlphaOp) {
+        c = SkPreMultiplyARGB(SkGetPackedA32(c), SkGetPackedR32(c),
+                              SkGetPackedG32(c), SkGetPackedB32(c));
+    } else if (kUnpremul_AlphaOp == kAlphaOp) {
+        c = SkUnPreMultiply::UnPreMultiplyPreservingByteOrder(c);
+    }
+    return c;
+}
+
+template <bool kSwapRB, AlphaOp kAlphaOp>
+static void convert_row(uint32_t* dst, const uint32_t* src, int count) {
+    int x = 0;
+    for (; x + 8 <= count; x += 8) {
+        // Deinterleaves eight pixels into a vector per byte.
+        uint8x8x4_t bytes = vld4_u8((const uint8_t*)(src + x));
+        if (kSwapRB) {
+            uint8x8_t tmp = bytes.val[kR];
+            bytes.val[kR] = bytes.val[kB];
+            bytes.val[kB] = tmp;
+        }
+        if (kPremul_AlphaOp == kAlphaOp) {
+            const uint8x8_t a = bytes.val[kA];
+            for (int i = 0; i < 4; ++i) {
+                if (kA != i) {
+                    bytes.val[i] = mul_div_255_round(bytes.val[i], a);
+                }
+            }
+        } else if (kUnpremul_AlphaOp == kAlphaOp) {
+            // The table lookups stay scalar; the multiplies by the looked up scales don't.
+            uint32_t scales[8];
+            for (int i = 0; i < 8; ++i) {
+                scales[i] = SkUnPreMultiply::GetScale(SkGetPackedA32(src[x + i]));
+            }
+            const uint32x4_t lo = vld1q_u32(scales);
+            const uint32x4_t hi = vld1q_u32(scales + 4);
+            const uint16x8_t scaleHi = vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16));
+            const uint16x8_t scaleLo = vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+            for (int i = 0; i < 4; ++i) {
+                if (kA != i) {
+                    bytes.val[i] = apply_scale(bytes.val[i], scaleHi, scaleLo);
+                }
+            }
+        }
+        vst4_u8((uint8_t*)(dst + x), bytes);
+    }
+    for (; x < count; ++x) {
+        dst[x] = convert_pixel<kSwapRB, kAlphaOp>(src[x]);
+    }
+}
+
+void SkConfig8888SwapRB_neon(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<true, kNone_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888Premul_neon(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<false, kPremul_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888SwapRBPremul_neon(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<true, kPremul_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888Unpremul_neon(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<false, kUnpremul_AlphaOp>(dst, src, count);
+}
+
+void SkConfig8888SwapRBUnpremul_neon(uint32_t* dst, const uint32_t* src, int count) {
+    convert_row<true, kUnpremul_AlphaOp>(dst, src, count);
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkConfig8888_opts_neon_DEFINED
+#define SkConfig8888_opts_neon_DEFINED
+
+#include "SkTypes.h"
+
+void SkConfig8888SwapRB_neon(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888Premul_neon(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888SwapRBPremul_neon(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888Unpremul_neon(uint32_t* dst, const uint32_t* src, int count);
+void SkConfig8888SwapRBUnpremul_neon(uint32_t* dst, const uint32_t* src, int count);
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_DEFINED
+#define SkMipMap_opts_DEFINED
+
+#include "SkTypes.h"
+
+enum SkMipMapDownsampleProcType {
+    k8888_SkMipMapDownsampleProcType,
+    k565_SkMipMapDownsampleProcType,
+    kA8_SkMipMapDownsampleProcType,
+};
+
+/**
+ *  Averages each 2x2 block of the src row of 2 * count pixels and the row srcRowBytes after it
+ *  into the count dst pixels, truncating each channel exactly as the portable procs in
+ *  src/core/SkMipMap.cpp do.
+ */
+typedef void (*SkMipMapDownsampleRowProc)(void* dst, const void* src, size_t srcRowBytes,
+                                          int count);
+
+SkMipMapDownsampleRowProc SkMipMapGetPlatformDownsampleProc(SkMipMapDownsampleProcType type);
+
+#endif
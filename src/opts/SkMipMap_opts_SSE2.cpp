@@ -0,0 +1,141 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMipMap_opts_SSE2.h"
+
+#include <emmintrin.h>
+
+// The sums of each channel of two adjacent 8888 pixels in the low and high halves of sum, which
+// holds them as 16-bit lanes, packed into the low half.
+static inline __m128i add_pixel_pairs_8888(__m128i sum) {
+    return _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+}
+
+void SkMipMapDownsample8888_SSE2(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint8_t* row0 = static_cast<const uint8_t*>(src);
+    const uint8_t* row1 = row0 + srcRowBytes;
+    uint32_t* d = static_cast<uint32_t*>(dst);
+    const __m128i zero = _mm_setzero_si128();
+
+    // Four dst pixels from eight src pixels of each row at a time.
+    while (count >= 4) {
+        const __m128i a0 = _mm_loadu_si128((const __m128i*)row0);
+        const __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + 16));
+        const __m128i b0 = _mm_loadu_si128((const __m128i*)row1);
+        const __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + 16));
+
+        // Vertical sums, a pixel per 64 bits.
+        const __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        const __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        const __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        const __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        const __m128i d01 = _mm_srli_epi16(_mm_unpacklo_epi64(add_pixel_pairs_8888(s0),
+                                                              add_pixel_pairs_8888(s1)), 2);
+        const __m128i d23 = _mm_srli_epi16(_mm_unpacklo_epi64(add_pixel_pairs_8888(s2),
+                                                              add_pixel_pairs_8888(s3)), 2);
+        _mm_storeu_si128((__m128i*)d, _mm_packus_epi16(d01, d23));
+
+        row0 += 32;
+        row1 += 32;
+        d += 4;
+        count -= 4;
+    }
+    while (count-- > 0) {
+        const uint32_t* p0 = (const uint32_t*)row0;
+        const uint32_t* p1 = (const uint32_t*)row1;
+        uint32_t ag = ((p0[0] >> 8) & 0xFF00FF) + ((p0[1] >> 8) & 0xFF00FF) +
+                      ((p1[0] >> 8) & 0xFF00FF) + ((p1[1] >> 8) & 0xFF00FF);
+        uint32_t rb = (p0[0] & 0xFF00FF) + (p0[1] & 0xFF00FF) +
+                      (p1[0] & 0xFF00FF) + (p1[1] & 0xFF00FF);
+        *d++ = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        row0 += 8;
+        row1 += 8;
+    }
+}
+
+// The sums of adjacent pairs of the 16-bit lanes of v, in 32-bit lanes.
+static inline __m128i add_lane_pairs_16(__m128i v) {
+    return _mm_add_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFFFF)), _mm_srli_epi32(v, 16));
+}
+
+// Four 565 dst pixels, in 32-bit lanes, from four pixels of each of two rows.
+static inline __m128i downsample4_565(__m128i a, __m128i b) {
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i r = _mm_add_epi32(add_lane_pairs_16(_mm_srli_epi16(a, 11)),
+                                    add_lane_pairs_16(_mm_srli_epi16(b, 11)));
+    const __m128i g = _mm_add_epi32(add_lane_pairs_16(_mm_and_si128(_mm_srli_epi16(a, 5), mask6)),
+                                    add_lane_pairs_16(_mm_and_si128(_mm_srli_epi16(b, 5), mask6)));
+    const __m128i bl = _mm_add_epi32(add_lane_pairs_16(_mm_and_si128(a, mask5)),
+                                     add_lane_pairs_16(_mm_and_si128(b, mask5)));
+    const __m128i c = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(r, 2), 11),
+                                                _mm_slli_epi32(_mm_srli_epi32(g, 2), 5)),
+                                   _mm_srli_epi32(bl, 2));
+    // Sign extend, so that the signed saturating pack keeps all 16 bits.
+    return _mm_srai_epi32(_mm_slli_epi32(c, 16), 16);
+}
+
+void SkMipMapDownsample565_SSE2(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint16_t* row0 = static_cast<const uint16_t*>(src);
+    const uint16_t* row1 = (const uint16_t*)((const char*)src + srcRowBytes);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+
+    // Eight dst pixels from sixteen src pixels of each row at a time.
+    while (count >= 8) {
+        const __m128i lo = downsample4_565(_mm_loadu_si128((const __m128i*)row0),
+                                           _mm_loadu_si128((const __m128i*)row1));
+        const __m128i hi = downsample4_565(_mm_loadu_si128((const __m128i*)(row0 + 8)),
+                                           _mm_loadu_si128((const __m128i*)(row1 + 8)));
+        _mm_storeu_si128((__m128i*)d, _mm_packs_epi32(lo, hi));
+        row0 += 16;
+        row1 += 16;
+        d += 8;
+        count -= 8;
+    }
+    while (count-- > 0) {
+        const unsigned r = (row0[0] >> 11) + (row0[1] >> 11) + (row1[0] >> 11) + (row1[1] >> 11);
+        const unsigned g = ((row0[0] >> 5) & 0x3F) + ((row0[1] >> 5) & 0x3F) +
+                           ((row1[0] >> 5) & 0x3F) + ((row1[1] >> 5) & 0x3F);
+        const unsigned b = (row0[0] & 0x1F) + (row0[1] & 0x1F) +
+                           (row1[0] & 0x1F) + (row1[1] & 0x1F);
+        *d++ = SkToU16(((r >> 2) << 11) | ((g >> 2) << 5) | (b >> 2));
+        row0 += 2;
+        row1 += 2;
+    }
+}
+
+// The sums of each pair of bytes of v, in 16-bit lanes.
+static inline __m128i add_byte_pairs(__m128i v) {
+    return _mm_add_epi16(_mm_and_si128(v, _mm_set1_epi16(0xFF)), _mm_srli_epi16(v, 8));
+}
+
+void SkMipMapDownsampleA8_SSE2(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint8_t* row0 = static_cast<const uint8_t*>(src);
+    const uint8_t* row1 = row0 + srcRowBytes;
+    uint8_t* d = static_cast<uint8_t*>(dst);
+
+    // Sixteen dst pixels from thirty-two src pixels of each row at a time.
+    while (count >= 16) {
+        const __m128i lo = _mm_add_epi16(add_byte_pairs(_mm_loadu_si128((const __m128i*)row0)),
+                                         add_byte_pairs(_mm_loadu_si128((const __m128i*)row1)));
+        const __m128i hi = _mm_add_epi16(
+                add_byte_pairs(_mm_loadu_si128((const __m128i*)(row0 + 16))),
+                add_byte_pairs(_mm_loadu_si128((const __m128i*)(row1 + 16))));
+        _mm_storeu_si128((__m128i*)d, _mm_packus_epi16(_mm_srli_epi16(lo, 2),
+                                                       _mm_srli_epi16(hi, 2)));
+        row0 += 32;
+        row1 += 32;
+        d += 16;
+        count -= 16;
+    }
+    while (count-- > 0) {
+        *d++ = SkToU8((row0[0] + row0[1] + row1[0] + row1[1]) >> 2);
+        row0 += 2;
+        row1 += 2;
+    }
+}
@@ -0,0 +1,17 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_SSE2_DEFINED
+#define SkMipMap_opts_SSE2_DEFINED
+
+#include "SkTypes.h"
+
+void SkMipMapDownsample8888_SSE2(void* dst, const void* src, size_t srcRowBytes, int count);
+void SkMipMapDownsample565_SSE2(void* dst, const void* src, size_t srcRowBytes, int count);
+void SkMipMapDownsampleA8_SSE2(void* dst, const void* src, size_t srcRowBytes, int count);
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMipMap_opts.h"
+#include "SkMipMap_opts_neon.h"
+#include "SkUtilsArm.h"
+
+SkMipMapDownsampleRowProc SkMipMapGetPlatformDownsampleProc(SkMipMapDownsampleProcType type) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    switch (type) {
+        case k8888_SkMipMapDownsampleProcType:
+            return SkMipMapDownsample8888_neon;
+        case k565_SkMipMapDownsampleProcType:
+            return SkMipMapDownsample565_neon;
+        case kA8_SkMipMapDownsampleProcType:
+            return SkMipMapDownsampleA8_neon;
+        default:
+            return NULL;
+    }
+#endif
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMipMap_opts.h"
+#include "SkMipMap_opts_neon.h"
+
+#include <arm_neon.h>
+
+void SkMipMapDownsample8888_neon(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint32_t* row0 = static_cast<const uint32_t*>(src);
+    const uint32_t* row1 = (const uint32_t*)((const char*)src + srcRowBytes);
+    uint32_t* d = static_cast<uint32_t*>(dst);
+
+    // Four dst pixels from eight src pixels of each row at a time, deinterleaved into the even
+    // and odd pixels.
+    while (count >= 4) {
+        const uint32x4x2_t a = vld2q_u32(row0);
+        const uint32x4x2_t b = vld2q_u32(row1);
+        const uint8x16_t a0 = vreinterpretq_u8_u32(a.val[0]);
+        const uint8x16_t a1 = vreinterpretq_u8_u32(a.val[1]);
+        const uint8x16_t b0 = vreinterpretq_u8_u32(b.val[0]);
+        const uint8x16_t b1 = vreinterpretq_u8_u32(b.val[1]);
+
+        const uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(a0), vget_low_u8(a1)),
+                                        vaddl_u8(vget_low_u8(b0), vget_low_u8(b1)));
+        const uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(a0), vget_high_u8(a1)),
+                                        vaddl_u8(vget_high_u8(b0), vget_high_u8(b1)));
+        vst1q_u32(d, vreinterpretq_u32_u8(vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2))));
+
+        row0 += 8;
+        row1 += 8;
+        d += 4;
+        count -= 4;
+    }
+    while (count-- > 0) {
+        uint32_t ag = ((row0[0] >> 8) & 0xFF00FF) + ((row0[1] >> 8) & 0xFF00FF) +
+                      ((row1[0] >> 8) & 0xFF00FF) + ((row1[1] >> 8) & 0xFF00FF);
+        uint32_t rb = (row0[0] & 0xFF00FF) + (row0[1] & 0xFF00FF) +
+                      (row1[0] & 0xFF00FF) + (row1[1] & 0xFF00FF);
+        *d++ = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        row0 += 2;
+        row1 += 2;
+    }
+}
+
+void SkMipMapDownsample565_neon(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint16_t* row0 = static_cast<const uint16_t*>(src);
+    const uint16_t* row1 = (const uint16_t*)((const char*)src + srcRowBytes);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+
+    // Four dst pixels from eight src pixels of each row at a time.
+    while (count >= 4) {
+        const uint16x8_t a = vld1q_u16(row0);
+        const uint16x8_t b = vld1q_u16(row1);
+        // Pairwise adds of each field, in 32-bit lanes.
+        const uint32x4_t r = vaddq_u32(vpaddlq_u16(vshrq_n_u16(a, 11)),
+                                       vpaddlq_u16(vshrq_n_u16(b, 11)));
+        const uint32x4_t g = vaddq_u32(vpaddlq_u16(vandq_u16(vshrq_n_u16(a, 5), mask6)),
+                                       vpaddlq_u16(vandq_u16(vshrq_n_u16(b, 5), mask6)));
+        const uint32x4_t bl = vaddq_u32(vpaddlq_u16(vandq_u16(a, mask5)),
+                                        vpaddlq_u16(vandq_u16(b, mask5)));
+        const uint32x4_t c = vorrq_u32(vorrq_u32(vshlq_n_u32(vshrq_n_u32(r, 2), 11),
+                                                 vshlq_n_u32(vshrq_n_u32(g, 2), 5)),
+                                       vshrq_n_u32(bl, 2));
+        vst1_u16(d, vmovn_u32(c));
+
+        row0 += 8;
+        row1 += 8;
+        d += 4;
+        count -= 4;
+    }
+    while (count-- > 0) {
+        const unsigned r = (row0[0] >> 11) + (row0[1] >> 11) + (row1[0] >> 11) + (row1[1] >> 11);
+        const unsigned g = ((row0[0] >> 5) & 0x3F) + ((row0[1] >> 5) & 0x3F) +
+                           ((row1[0] >> 5) & 0x3F) + ((row1[1] >> 5) & 0x3F);
+        const unsigned b = (row0[0] & 0x1F) + (row0[1] & 0x1F) +
+                           (row1[0] & 0x1F) + (row1[1] & 0x1F);
+        *d++ = SkToU16(((r >> 2) << 11) | ((g >> 2) << 5) | (b >> 2));
+        row0 += 2;
+        row1 += 2;
+    }
+}
+
+void SkMipMapDownsampleA8_neon(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint8_t* row0 = static_cast<const uint8_t*>(src);
+    const uint8_t* row1 = row0 + srcRowBytes;
+    uint8_t* d = static_cast<uint8_t*>(dst);
+
+    // Eight dst pixels from sixteen src pixels of each row at a time.
+    while (count >= 8) {
+        const uint16x8_t sum = vaddq_u16(vpaddlq_u8(vld1q_u8(row0)), vpaddlq_u8(vld1q_u8(row1)));
+        vst1_u8(d, vshrn_n_u16(sum, 2));
+        row0 += 16;
+        row1 += 16;
+        d += 8;
+        count -= 8;
+    }
+    while (count-- > 0) {
+        *d++ = SkToU8((row0[0] + row0[1] + row1[0] + row1[1]) >> 2);
+        row0 += 2;
+        row1 += 2;
+    }
+}
@@ -14,7 +14,12 @@ enum SkMorphologyProcType {
     kDilateX_SkMorphologyProcType,
     kDilateY_SkMorphologyProcType,
     kErodeX_SkMorphologyProcType,
-    kErodeY_SkMorphologyProcType
+    kErodeY_SkMorphologyProcType,
+    // van Herk/Gil-Werman versions, for large radii.
+    kDilateXVanHerk_SkMorphologyProcType,
+    kDilateYVanHerk_SkMorphologyProcType,
+    kErodeXVanHerk_SkMorphologyProcType,
+    kErodeYVanHerk_SkMorphologyProcType
 };
 
 SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType type);
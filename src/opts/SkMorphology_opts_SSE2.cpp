@@ -8,6 +8,7 @@
 #include <emmintrin.h>
 #include "SkColorPriv.h"
 #include "SkMorphology_opts_SSE2.h"
+#include "SkTemplates.h"
 
 /* SSE2 version of dilateX, dilateY, erodeX, erodeY.
  * portable versions are in src/effects/SkMorphologyImageFilter.cpp.
@@ -56,6 +57,58 @@ static void SkMorph_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
     }
 }
 
+template<MorphType type>
+static inline SkPMColor SkMorphPixels_SSE2(SkPMColor a, SkPMColor b) {
+    const __m128i pa = _mm_cvtsi32_si128(a);
+    const __m128i pb = _mm_cvtsi32_si128(b);
+    return _mm_cvtsi128_si32(type == kDilate ? _mm_max_epu8(pa, pb) : _mm_min_epu8(pa, pb));
+}
+
+// van Herk/Gil-Werman version, whose cost per pixel doesn't depend on the radius.
+template<MorphType type, MorphDirection direction>
+static void SkMorphVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                                int width, int height, int srcStride, int dstStride)
+{
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    radius = SkMin32(radius, width - 1);
+    const int window = 2 * radius + 1;
+    const int lastBlock = (width - 1) / window * window;
+    SkAutoTMalloc<SkPMColor> storage(2 * width);
+    SkPMColor* prefix = storage.get();
+    SkPMColor* suffix = prefix + width;
+    for (int y = 0; y < height; ++y) {
+        const SkPMColor* sptr = src + y * srcStrideY;
+        SkPMColor* dptr = dst + y * dstStrideY;
+        for (int start = 0; start < width; start += window) {
+            const int end = SkMin32(start + window, width);
+            prefix[start] = sptr[start * srcStrideX];
+            for (int x = start + 1; x < end; ++x) {
+                prefix[x] = SkMorphPixels_SSE2<type>(prefix[x - 1], sptr[x * srcStrideX]);
+            }
+            suffix[end - 1] = sptr[(end - 1) * srcStrideX];
+            for (int x = end - 2; x >= start; --x) {
+                suffix[x] = SkMorphPixels_SSE2<type>(suffix[x + 1], sptr[x * srcStrideX]);
+            }
+        }
+        int x = 0;
+        for (; x <= radius; ++x) {
+            dptr[x * dstStrideX] = prefix[SkMin32(x + radius, width - 1)];
+        }
+        for (; x + radius < width; ++x) {
+            dptr[x * dstStrideX] = SkMorphPixels_SSE2<type>(suffix[x - radius],
+                                                            prefix[x + radius]);
+        }
+        for (; x < width; ++x) {
+            const int lo = x - radius;
+            dptr[x * dstStrideX] = lo >= lastBlock ? suffix[lo]
+                                 : SkMorphPixels_SSE2<type>(suffix[lo], prefix[width - 1]);
+        }
+    }
+}
+
 void SkDilateX_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
                     int width, int height, int srcStride, int dstStride)
 {
@@ -79,3 +132,27 @@ void SkErodeY_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
 {
     SkMorph_SSE2<kErode, kY>(src, dst, radius, width, height, srcStride, dstStride);
 }
+
+void SkDilateXVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_SSE2<kDilate, kX>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+void SkDilateYVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_SSE2<kDilate, kY>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+void SkErodeXVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_SSE2<kErode, kX>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+void SkErodeYVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_SSE2<kErode, kY>(src, dst, radius, width, height, srcStride, dstStride);
+}
@@ -19,4 +19,13 @@ void SkErodeX_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
 void SkErodeY_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
                    int width, int height, int srcStride, int dstStride);
 
+void SkDilateXVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride);
+void SkDilateYVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride);
+void SkErodeXVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride);
+void SkErodeYVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride);
+
 #endif
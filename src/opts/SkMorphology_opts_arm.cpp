@@ -27,6 +27,14 @@ SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType t
             return SkErodeX_neon;
         case kErodeY_SkMorphologyProcType:
             return SkErodeY_neon;
+        case kDilateXVanHerk_SkMorphologyProcType:
+            return SkDilateXVanHerk_neon;
+        case kDilateYVanHerk_SkMorphologyProcType:
+            return SkDilateYVanHerk_neon;
+        case kErodeXVanHerk_SkMorphologyProcType:
+            return SkErodeXVanHerk_neon;
+        case kErodeYVanHerk_SkMorphologyProcType:
+            return SkErodeYVanHerk_neon;
         default:
             return NULL;
     }
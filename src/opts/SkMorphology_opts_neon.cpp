@@ -9,6 +9,7 @@
 #include "SkColorPriv.h"
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_neon.h"
+#include "SkTemplates.h"
 
 #include <arm_neon.h>
 
@@ -55,6 +56,59 @@ static void SkMorph_neon(const SkPMColor* src, SkPMColor* dst, int radius,
     }
 }
 
+template<MorphType type>
+static inline SkPMColor SkMorphPixels_neon(SkPMColor a, SkPMColor b) {
+    const uint8x8_t pa = vreinterpret_u8_u32(vdup_n_u32(a));
+    const uint8x8_t pb = vreinterpret_u8_u32(vdup_n_u32(b));
+    return vget_lane_u32(vreinterpret_u32_u8(type == kDilate ? vmax_u8(pa, pb)
+                                                             : vmin_u8(pa, pb)), 0);
+}
+
+// van Herk/Gil-Werman version, whose cost per pixel doesn't depend on the radius.
+template<MorphType type, MorphDirection direction>
+static void SkMorphVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                                int width, int height, int srcStride, int dstStride)
+{
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    radius = SkMin32(radius, width - 1);
+    const int window = 2 * radius + 1;
+    const int lastBlock = (width - 1) / window * window;
+    SkAutoTMalloc<SkPMColor> storage(2 * width);
+    SkPMColor* prefix = storage.get();
+    SkPMColor* suffix = prefix + width;
+    for (int y = 0; y < height; ++y) {
+        const SkPMColor* sptr = src + y * srcStrideY;
+        SkPMColor* dptr = dst + y * dstStrideY;
+        for (int start = 0; start < width; start += window) {
+            const int end = SkMin32(start + window, width);
+            prefix[start] = sptr[start * srcStrideX];
+            for (int x = start + 1; x < end; ++x) {
+                prefix[x] = SkMorphPixels_neon<type>(prefix[x - 1], sptr[x * srcStrideX]);
+            }
+            suffix[end - 1] = sptr[(end - 1) * srcStrideX];
+            for (int x = end - 2; x >= start; --x) {
+                suffix[x] = SkMorphPixels_neon<type>(suffix[x + 1], sptr[x * srcStrideX]);
+            }
+        }
+        int x = 0;
+        for (; x <= radius; ++x) {
+            dptr[x * dstStrideX] = prefix[SkMin32(x + radius, width - 1)];
+        }
+        for (; x + radius < width; ++x) {
+            dptr[x * dstStrideX] = SkMorphPixels_neon<type>(suffix[x - radius],
+                                                            prefix[x + radius]);
+        }
+        for (; x < width; ++x) {
+            const int lo = x - radius;
+            dptr[x * dstStrideX] = lo >= lastBlock ? suffix[lo]
+                                 : SkMorphPixels_neon<type>(suffix[lo], prefix[width - 1]);
+        }
+    }
+}
+
 void SkDilateX_neon(const SkPMColor* src, SkPMColor* dst, int radius,
                     int width, int height, int srcStride, int dstStride)
 {
@@ -78,3 +132,27 @@ void SkErodeY_neon(const SkPMColor* src, SkPMColor* dst, int radius,
 {
     SkMorph_neon<kErode, kY>(src, dst, radius, width, height, srcStride, dstStride);
 }
+
+void SkDilateXVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_neon<kDilate, kX>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+void SkDilateYVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_neon<kDilate, kY>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+void SkErodeXVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_neon<kErode, kX>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+void SkErodeYVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride)
+{
+    SkMorphVanHerk_neon<kErode, kY>(src, dst, radius, width, height, srcStride, dstStride);
+}
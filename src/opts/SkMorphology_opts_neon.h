@@ -13,3 +13,12 @@ void SkErodeX_neon(const SkPMColor* src, SkPMColor* dst, int radius,
                    int width, int height, int srcStride, int dstStride);
 void SkErodeY_neon(const SkPMColor* src, SkPMColor* dst, int radius,
                    int width, int height, int srcStride, int dstStride);
+
+void SkDilateXVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride);
+void SkDilateYVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                           int width, int height, int srcStride, int dstStride);
+void SkErodeXVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride);
+void SkErodeYVanHerk_neon(const SkPMColor* src, SkPMColor* dst, int radius,
+                          int width, int height, int srcStride, int dstStride);
@@ -28,8 +28,28 @@ public:
     SkNi(int32x4_t vec) : fVec(vec) {}
 
     SkNi() {}
+    explicit SkNi(int32_t val) : fVec(vdupq_n_s32(val)) {}
+    static SkNi Load(const int32_t vals[4]) { return vld1q_s32(vals); }
+    SkNi(int32_t a, int32_t b, int32_t c, int32_t d) { fVec = (int32x4_t) { a, b, c, d }; }
+
+    void store(int32_t vals[4]) const { vst1q_s32(vals, fVec); }
+
+    SkNi operator + (const SkNi& o) const { return vaddq_s32(fVec, o.fVec); }
+    SkNi operator - (const SkNi& o) const { return vsubq_s32(fVec, o.fVec); }
+    SkNi operator & (const SkNi& o) const { return vandq_s32(fVec, o.fVec); }
+    SkNi operator | (const SkNi& o) const { return vorrq_s32(fVec, o.fVec); }
+    SkNi operator ^ (const SkNi& o) const { return veorq_s32(fVec, o.fVec); }
+
+    SkNi operator << (int bits) const { return vshlq_s32(fVec, vdupq_n_s32(bits)); }
+    SkNi operator >> (int bits) const { return vshlq_s32(fVec, vdupq_n_s32(-bits)); }
+
     bool allTrue() const { return fVec[0] && fVec[1] && fVec[2] && fVec[3]; }
     bool anyTrue() const { return fVec[0] || fVec[1] || fVec[2] || fVec[3]; }
+
+    int32_t operator[] (int k) const {
+        SkASSERT(0 <= k && k < 4);
+        return fVec[k];
+    }
 private:
     int32x4_t fVec;
 };
@@ -205,6 +225,8 @@ public:
         return est2;
     }
 
+    Ni castTrunc() const { return vcvtq_s32_f32(fVec); }
+
     SkNf operator + (const SkNf& o) const { return vaddq_f32(fVec, o.fVec); }
     SkNf operator - (const SkNf& o) const { return vsubq_f32(fVec, o.fVec); }
     SkNf operator * (const SkNf& o) const { return vmulq_f32(fVec, o.fVec); }
@@ -30,9 +30,30 @@ public:
     SkNi(const __m128i& vec) : fVec(vec) {}
 
     SkNi() {}
+    explicit SkNi(int32_t val) : fVec(_mm_set1_epi32(val)) {}
+    static SkNi Load(const int32_t vals[4]) { return _mm_loadu_si128((const __m128i*)vals); }
+    SkNi(int32_t a, int32_t b, int32_t c, int32_t d) : fVec(_mm_setr_epi32(a,b,c,d)) {}
+
+    void store(int32_t vals[4]) const { _mm_storeu_si128((__m128i*)vals, fVec); }
+
+    SkNi operator + (const SkNi& o) const { return _mm_add_epi32(fVec, o.fVec); }
+    SkNi operator - (const SkNi& o) const { return _mm_sub_epi32(fVec, o.fVec); }
+    SkNi operator & (const SkNi& o) const { return _mm_and_si128(fVec, o.fVec); }
+    SkNi operator | (const SkNi& o) const { return _mm_or_si128(fVec, o.fVec); }
+    SkNi operator ^ (const SkNi& o) const { return _mm_xor_si128(fVec, o.fVec); }
+
+    SkNi operator << (int bits) const { return _mm_slli_epi32(fVec, bits); }
+    SkNi operator >> (int bits) const { return _mm_srai_epi32(fVec, bits); }
+
     bool allTrue() const { return 0xffff == _mm_movemask_epi8(fVec); }
     bool anyTrue() const { return 0x0000 != _mm_movemask_epi8(fVec); }
 
+    int32_t operator[] (int k) const {
+        SkASSERT(0 <= k && k < 4);
+        union { __m128i v; int32_t is[4]; } pun = {fVec};
+        return pun.is[k];
+    }
+
 private:
     __m128i fVec;
 };
@@ -87,6 +108,8 @@ public:
     SkNf       invert() const { return SkNf(1) / *this; }
     SkNf approxInvert() const { return _mm_rcp_ps(fVec); }
 
+    Ni castTrunc() const { return _mm_cvttps_epi32(fVec); }
+
     float operator[] (int k) const {
         SkASSERT(0 <= k && k < 2);
         union { __m128 v; float fs[4]; } pun = {fVec};
@@ -176,6 +199,8 @@ public:
     SkNf       invert() const { return SkNf(1) / *this; }
     SkNf approxInvert() const { return _mm_rcp_ps(fVec); }
 
+    Ni castTrunc() const { return _mm_cvttps_epi32(fVec); }
+
     float operator[] (int k) const {
         SkASSERT(0 <= k && k < 4);
         union { __m128 v; float fs[4]; } pun = {fVec};
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSwizzler_opts_DEFINED
+#define SkSwizzler_opts_DEFINED
+
+#include "SkColor.h"
+
+enum SkSwizzleProcType {
+    kRGBA_To_N32_Premul_SkSwizzleProcType,
+    kRGBA_To_N32_Unpremul_SkSwizzleProcType,
+    kRGBX_To_N32_SkSwizzleProcType,
+    kRGB_To_N32_SkSwizzleProcType,
+    kIndex_To_N32_SkSwizzleProcType,
+    // src holds native endian uint16_t kRGB_565 pixels.
+    kRGB565_To_N32_SkSwizzleProcType,
+};
+
+/**
+ *  Converts one row of width src pixels to N32 dst pixels. ctable is only read by the index
+ *  proc. Returns the src alphas ANDed together in the high byte and ORed together in the low
+ *  byte, which is how SkSwizzler::ResultAlpha is packed.
+ *  Portable versions are in src/codec/SkSwizzler.cpp, except for the 565 one, which is
+ *  SkPixel16ToPixel32() in a loop.
+ */
+typedef uint16_t (*SkSwizzleRowProc)(SkPMColor* dst, const uint8_t* src, int width,
+                                     const SkPMColor ctable[]);
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc(SkSwizzleProcType type);
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkSwizzler_opts_SSSE3.h"
+
+/* With the exception of the compilers that don't support it, we always build the
+ * SSSE3 functions and enable the caller to determine SSSE3 support.  However for
+ * compilers that do not support SSSE3 we provide a stub implementation.
+ */
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+#include "SkColor_opts_SSE2.h"
+
+#include <tmmintrin.h>  // SSSE3
+
+static const int kR = SK_R32_SHIFT / 8;
+static const int kG = SK_G32_SHIFT / 8;
+static const int kB = SK_B32_SHIFT / 8;
+static const int kA = SK_A32_SHIFT / 8;
+
+// Returns the _mm_shuffle_epi8() mask that moves four src pixels of bytesPerPixel bytes each,
+// in R, G, B(, A) order, to the N32 byte order. Without a src alpha the alpha bytes are zeroed.
+static __m128i n32_shuffle(int bytesPerPixel, bool hasAlpha) {
+    uint8_t mask[16];
+    for (int p = 0; p < 4; ++p) {
+        const int src = p * bytesPerPixel;
+        mask[4*p + kR] = src + 0;
+        mask[4*p + kG] = src + 1;
+        mask[4*p + kB] = src + 2;
+        mask[4*p + kA] = hasAlpha ? src + 3 : 0x80;
+    }
+    return _mm_loadu_si128((const __m128i*)mask);
+}
+
+// Returns the mask that copies each N32 pixel's alpha into its color bytes, and zeroes its alpha.
+static __m128i alpha_shuffle() {
+    uint8_t mask[16];
+    for (int p = 0; p < 4; ++p) {
+        mask[4*p + kR] = mask[4*p + kG] = mask[4*p + kB] = 4*p + kA;
+        mask[4*p + kA] = 0x80;
+    }
+    return _mm_loadu_si128((const __m128i*)mask);
+}
+
+// Matches SkMulDiv255Round() on each 16 bit lane.
+static inline __m128i mul_div_255_round(__m128i c, __m128i a) {
+    __m128i prod = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(prod, _mm_srli_epi16(prod, 8)), 8);
+}
+
+// Folds the alpha bytes of the four N32 pixels in zeroAlpha and maxAlpha into the scalars.
+static inline void reduce_alpha(__m128i zeroAlpha, __m128i maxAlpha,
+                                uint8_t* zero, uint8_t* max) {
+    uint32_t ors[4], ands[4];
+    _mm_storeu_si128((__m128i*)ors, zeroAlpha);
+    _mm_storeu_si128((__m128i*)ands, maxAlpha);
+    *zero |= SkGetPackedA32(ors[0] | ors[1] | ors[2] | ors[3]);
+    *max &= SkGetPackedA32(ands[0] & ands[1] & ands[2] & ands[3]);
+}
+
+template <bool kPremul>
+static uint16_t swizzle_rgba_to_n32(SkPMColor* dst, const uint8_t* src, int width) {
+    const __m128i shuffle = n32_shuffle(4, true);
+    const __m128i alphas = alpha_shuffle();
+    const __m128i alphaMask = _mm_set1_epi32(SK_A32_MASK << SK_A32_SHIFT);
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i zeroAlpha = zero;
+    __m128i maxAlpha = _mm_set1_epi32(-1);
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + 4*x)), shuffle);
+        zeroAlpha = _mm_or_si128(zeroAlpha, pixels);
+        maxAlpha = _mm_and_si128(maxAlpha, pixels);
+        if (kPremul) {
+            // Scale the colors by alpha, and the alpha by 255 (which leaves it alone).
+            __m128i scales = _mm_or_si128(_mm_shuffle_epi8(pixels, alphas), alphaMask);
+            __m128i lo = mul_div_255_round(_mm_unpacklo_epi8(pixels, zero),
+                                           _mm_unpacklo_epi8(scales, zero));
+            __m128i hi = mul_div_255_round(_mm_unpackhi_epi8(pixels, zero),
+                                           _mm_unpackhi_epi8(scales, zero));
+            pixels = _mm_packus_epi16(lo, hi);
+        }
+        _mm_storeu_si128((__m128i*)(dst + x), pixels);
+    }
+
+    uint8_t zeroAlphaResult = 0;
+    uint8_t maxAlphaResult = 0xFF;
+    reduce_alpha(zeroAlpha, maxAlpha, &zeroAlphaResult, &maxAlphaResult);
+    for (; x < width; ++x) {
+        const uint8_t* p = src + 4*x;
+        zeroAlphaResult |= p[3];
+        maxAlphaResult &= p[3];
+        dst[x] = kPremul ? SkPreMultiplyARGB(p[3], p[0], p[1], p[2])
+                         : SkPackARGB32NoCheck(p[3], p[0], p[1], p[2]);
+    }
+    return (maxAlphaResult << 8) | zeroAlphaResult;
+}
+
+uint16_t SkSwizzleRGBAToN32Premul_SSSE3(SkPMColor* dst, const uint8_t* src, int width,
+                                        const SkPMColor[]) {
+    return swizzle_rgba_to_n32<true>(dst, src, width);
+}
+
+uint16_t SkSwizzleRGBAToN32Unpremul_SSSE3(SkPMColor* dst, const uint8_t* src, int width,
+                                          const SkPMColor[]) {
+    return swizzle_rgba_to_n32<false>(dst, src, width);
+}
+
+// Opaque sources, whose pixels are bytesPerPixel apart.
+template <int bytesPerPixel>
+static uint16_t swizzle_rgbx_to_n32(SkPMColor* dst, const uint8_t* src, int width) {
+    const __m128i shuffle = n32_shuffle(bytesPerPixel, false);
+    const __m128i alphaMask = _mm_set1_epi32(SK_A32_MASK << SK_A32_SHIFT);
+
+    // Each load reads 16 bytes, which for 3 byte pixels runs past the four being converted.
+    const int loadPixels = (16 + bytesPerPixel - 1) / bytesPerPixel;
+    int x = 0;
+    for (; x + loadPixels <= width; x += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(src + bytesPerPixel*x));
+        pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alphaMask);
+        _mm_storeu_si128((__m128i*)(dst + x), pixels);
+    }
+    for (; x < width; ++x) {
+        const uint8_t* p = src + bytesPerPixel*x;
+        dst[x] = SkPackARGB32NoCheck(0xFF, p[0], p[1], p[2]);
+    }
+    return 0xFFFF;
+}
+
+uint16_t SkSwizzleRGBXToN32_SSSE3(SkPMColor* dst, const uint8_t* src, int width,
+                                  const SkPMColor[]) {
+    return swizzle_rgbx_to_n32<4>(dst, src, width);
+}
+
+uint16_t SkSwizzleRGBToN32_SSSE3(SkPMColor* dst, const uint8_t* src, int width,
+                                 const SkPMColor[]) {
+    return swizzle_rgbx_to_n32<3>(dst, src, width);
+}
+
+// There is no gather before AVX2, so the lookups stay scalar, but the colors are written and
+// their alphas accumulated four at a time.
+uint16_t SkSwizzleIndexToN32_SSSE3(SkPMColor* dst, const uint8_t* src, int width,
+                                   const SkPMColor ctable[]) {
+    __m128i zeroAlpha = _mm_setzero_si128();
+    __m128i maxAlpha = _mm_set1_epi32(-1);
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i colors = _mm_setr_epi32(ctable[src[x + 0]], ctable[src[x + 1]],
+                                        ctable[src[x + 2]], ctable[src[x + 3]]);
+        zeroAlpha = _mm_or_si128(zeroAlpha, colors);
+        maxAlpha = _mm_and_si128(maxAlpha, colors);
+        _mm_storeu_si128((__m128i*)(dst + x), colors);
+    }
+
+    uint8_t zeroAlphaResult = 0;
+    uint8_t maxAlphaResult = 0xFF;
+    reduce_alpha(zeroAlpha, maxAlpha, &zeroAlphaResult, &maxAlphaResult);
+    for (; x < width; ++x) {
+        SkPMColor c = ctable[src[x]];
+        zeroAlphaResult |= SkGetPackedA32(c);
+        maxAlphaResult &= SkGetPackedA32(c);
+        dst[x] = c;
+    }
+    return (maxAlphaResult << 8) | zeroAlphaResult;
+}
+
+uint16_t SkSwizzleRGB565ToN32_SSSE3(SkPMColor* dst, const uint8_t* src, int width,
+                                    const SkPMColor[]) {
+    const uint16_t* src16 = (const uint16_t*)src;
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(src16 + x));
+        _mm_storeu_si128((__m128i*)(dst + x + 0),
+                         SkPixel16ToPixel32_SSE2(_mm_unpacklo_epi16(pixels, zero)));
+        _mm_storeu_si128((__m128i*)(dst + x + 4),
+                         SkPixel16ToPixel32_SSE2(_mm_unpackhi_epi16(pixels, zero)));
+    }
+    for (; x < width; ++x) {
+        dst[x] = SkPixel16ToPixel32(src16[x]);
+    }
+    return 0xFFFF;
+}
+
+#else // SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+uint16_t SkSwizzleRGBAToN32Premul_SSSE3(SkPMColor*, const uint8_t*, int, const SkPMColor[]) {
+    sk_throw();
+    return 0;
+}
+
+uint16_t SkSwizzleRGBAToN32Unpremul_SSSE3(SkPMColor*, const uint8_t*, int, const SkPMColor[]) {
+    sk_throw();
+    return 0;
+}
+
+uint16_t SkSwizzleRGBXToN32_SSSE3(SkPMColor*, const uint8_t*, int, const SkPMColor[]) {
+    sk_throw();
+    return 0;
+}
+
+uint16_t SkSwizzleRGBToN32_SSSE3(SkPMColor*, const uint8_t*, int, const SkPMColor[]) {
+    sk_throw();
+    return 0;
+}
+
+uint16_t SkSwizzleIndexToN32_SSSE3(SkPMColor*, const uint8_t*, int, const SkPMColor[]) {
+    sk_throw();
+    return 0;
+}
+
+uint16_t SkSwizzleRGB565ToN32_SSSE3(SkPMColor*, const uint8_t*, int, const SkPMColor[]) {
+    sk_throw();
+    return 0;
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSwizzler_opts.h"
+#include "SkSwizzler_opts_neon.h"
+#include "SkUtilsArm.h"
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc(SkSwizzleProcType type) {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    switch (type) {
+        case kRGBA_To_N32_Premul_SkSwizzleProcType:
+            return SkSwizzleRGBAToN32Premul_neon;
+        case kRGBA_To_N32_Unpremul_SkSwizzleProcType:
+            return SkSwizzleRGBAToN32Unpremul_neon;
+        case kRGBX_To_N32_SkSwizzleProcType:
+            return SkSwizzleRGBXToN32_neon;
+        case kRGB_To_N32_SkSwizzleProcType:
+            return SkSwizzleRGBToN32_neon;
+        case kIndex_To_N32_SkSwizzleProcType:
+            return SkSwizzleIndexToN32_neon;
+        case kRGB565_To_N32_SkSwizzleProcType:
+            return SkSwizzleRGB565ToN32_neon;
+        default:
+            return NULL;
+    }
+#endif
+}
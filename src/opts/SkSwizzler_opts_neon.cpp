@@ -0,0 +1,154 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkColor_opts_neon.h"
+#include "SkSwizzler_opts.h"
+#include "SkSwizzler_opts_neon.h"
+
+#include <arm_neon.h>
+
+/* neon versions of the N32 swizzles.
+ * portable versions are in src/codec/SkSwizzler.cpp.
+ */
+
+static const int kR = SK_R32_SHIFT / 8;
+static const int kG = SK_G32_SHIFT / 8;
+static const int kB = SK_B32_SHIFT / 8;
+static const int kA = SK_A32_SHIFT / 8;
+
+// Matches SkMulDiv255Round() on each lane.
+static inline uint8x8_t mul_div_255_round(uint8x8_t c, uint8x8_t a) {
+    uint16x8_t prod = vaddq_u16(vmull_u8(c, a), vdupq_n_u16(128));
+    return vshrn_n_u16(vaddq_u16(prod, vshrq_n_u16(prod, 8)), 8);
+}
+
+static inline void reduce_alpha(uint8x8_t zeroAlpha, uint8x8_t maxAlpha,
+                                uint8_t* zero, uint8_t* max) {
+    uint8_t ors[8], ands[8];
+    vst1_u8(ors, zeroAlpha);
+    vst1_u8(ands, maxAlpha);
+    for (int i = 0; i < 8; ++i) {
+        *zero |= ors[i];
+        *max &= ands[i];
+    }
+}
+
+template <bool kPremul>
+static uint16_t swizzle_rgba_to_n32(SkPMColor* dst, const uint8_t* src, int width) {
+    uint8x8_t zeroAlpha = vdup_n_u8(0);
+    uint8x8_t maxAlpha = vdup_n_u8(0xFF);
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        // Deinterleaves eight pixels into R, G, B and A vectors.
+        uint8x8x4_t rgba = vld4_u8(src + 4*x);
+        uint8x8_t a = rgba.val[3];
+        zeroAlpha = vorr_u8(zeroAlpha, a);
+        maxAlpha = vand_u8(maxAlpha, a);
+
+        uint8x8x4_t n32;
+        if (kPremul) {
+            n32.val[kR] = mul_div_255_round(rgba.val[0], a);
+            n32.val[kG] = mul_div_255_round(rgba.val[1], a);
+            n32.val[kB] = mul_div_255_round(rgba.val[2], a);
+        } else {
+            n32.val[kR] = rgba.val[0];
+            n32.val[kG] = rgba.val[1];
+            n32.val[kB] = rgba.val[2];
+        }
+        n32.val[kA] = a;
+        vst4_u8((uint8_t*)(dst + x), n32);
+    }
+
+    uint8_t zeroAlphaResult = 0;
+    uint8_t maxAlphaResult = 0xFF;
+    reduce_alpha(zeroAlpha, maxAlpha, &zeroAlphaResult, &maxAlphaResult);
+    for (; x < width; ++x) {
+        const uint8_t* p = src + 4*x;
+        zeroAlphaResult |= p[3];
+        maxAlphaResult &= p[3];
+        dst[x] = kPremul ? SkPreMultiplyARGB(p[3], p[0], p[1], p[2])
+                         : SkPackARGB32NoCheck(p[3], p[0], p[1], p[2]);
+    }
+    return (maxAlphaResult << 8) | zeroAlphaResult;
+}
+
+uint16_t SkSwizzleRGBAToN32Premul_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                       const SkPMColor[]) {
+    return swizzle_rgba_to_n32<true>(dst, src, width);
+}
+
+uint16_t SkSwizzleRGBAToN32Unpremul_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                         const SkPMColor[]) {
+    return swizzle_rgba_to_n32<false>(dst, src, width);
+}
+
+uint16_t SkSwizzleRGBXToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                 const SkPMColor[]) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x4_t rgbx = vld4_u8(src + 4*x);
+        uint8x8x4_t n32;
+        n32.val[kR] = rgbx.val[0];
+        n32.val[kG] = rgbx.val[1];
+        n32.val[kB] = rgbx.val[2];
+        n32.val[kA] = vdup_n_u8(0xFF);
+        vst4_u8((uint8_t*)(dst + x), n32);
+    }
+    for (; x < width; ++x) {
+        const uint8_t* p = src + 4*x;
+        dst[x] = SkPackARGB32NoCheck(0xFF, p[0], p[1], p[2]);
+    }
+    return 0xFFFF;
+}
+
+uint16_t SkSwizzleRGBToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                const SkPMColor[]) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        uint8x8x3_t rgb = vld3_u8(src + 3*x);
+        uint8x8x4_t n32;
+        n32.val[kR] = rgb.val[0];
+        n32.val[kG] = rgb.val[1];
+        n32.val[kB] = rgb.val[2];
+        n32.val[kA] = vdup_n_u8(0xFF);
+        vst4_u8((uint8_t*)(dst + x), n32);
+    }
+    for (; x < width; ++x) {
+        const uint8_t* p = src + 3*x;
+        dst[x] = SkPackARGB32NoCheck(0xFF, p[0], p[1], p[2]);
+    }
+    return 0xFFFF;
+}
+
+// NEON has no gather, so the lookups stay scalar. Accumulating whole colors and extracting
+// their alphas once at the end still saves the per pixel shifts of the portable version.
+uint16_t SkSwizzleIndexToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                  const SkPMColor ctable[]) {
+    SkPMColor zeroColors = 0;
+    SkPMColor maxColors = ~0U;
+    for (int x = 0; x < width; ++x) {
+        SkPMColor c = ctable[src[x]];
+        zeroColors |= c;
+        maxColors &= c;
+        dst[x] = c;
+    }
+    return (SkGetPackedA32(maxColors) << 8) | SkGetPackedA32(zeroColors);
+}
+
+uint16_t SkSwizzleRGB565ToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                   const SkPMColor[]) {
+    const uint16_t* src16 = (const uint16_t*)src;
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        vst4_u8((uint8_t*)(dst + x), SkPixel16ToPixel32_neon8(vld1q_u16(src16 + x)));
+    }
+    for (; x < width; ++x) {
+        dst[x] = SkPixel16ToPixel32(src16[x]);
+    }
+    return 0xFFFF;
+}
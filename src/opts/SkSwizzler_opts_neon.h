@@ -0,0 +1,26 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSwizzler_opts_neon_DEFINED
+#define SkSwizzler_opts_neon_DEFINED
+
+#include "SkColor.h"
+
+uint16_t SkSwizzleRGBAToN32Premul_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                       const SkPMColor ctable[]);
+uint16_t SkSwizzleRGBAToN32Unpremul_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                         const SkPMColor ctable[]);
+uint16_t SkSwizzleRGBXToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                 const SkPMColor ctable[]);
+uint16_t SkSwizzleRGBToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                const SkPMColor ctable[]);
+uint16_t SkSwizzleIndexToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                  const SkPMColor ctable[]);
+uint16_t SkSwizzleRGB565ToN32_neon(SkPMColor* dst, const uint8_t* src, int width,
+                                   const SkPMColor ctable[]);
+
+#endif
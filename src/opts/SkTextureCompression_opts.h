@@ -18,4 +18,10 @@ SkTextureCompressorGetPlatformProc(SkColorType colorType, SkTextureCompressor::F
 // compression format according to how the platform can consume them. Returns false otherwise.
 bool SkTextureCompressorGetPlatformDims(SkTextureCompressor::Format fmt, int* dimX, int* dimY);
 
+// Repacks count kN32 pixels as the R, G, B bytes the ETC1 encoder takes.
+typedef void (*SkTextureCompressorRGB888Proc)(uint8_t* dst, const SkPMColor* src, int count);
+
+// Returns NULL if the platform has no faster version than the portable one.
+SkTextureCompressorRGB888Proc SkTextureCompressorGetPlatformRGB888Proc();
+
 #endif  // SkTextureCompression_opts_DEFINED
@@ -57,3 +57,16 @@ bool SkTextureCompressorGetPlatformDims(SkTextureCompressor::Format fmt, int* di
     return false;
 #endif
 }
+
+SkTextureCompressorRGB888Proc SkTextureCompressorGetPlatformRGB888Proc() {
+#if SK_ARM_NEON_IS_NONE
+    return NULL;
+#else
+#if SK_ARM_NEON_IS_DYNAMIC
+    if (!sk_cpu_arm_has_neon()) {
+        return NULL;
+    }
+#endif
+    return N32ToRGB888_NEON;
+#endif
+}
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkColorPriv.h"
 #include "SkTextureCompressor.h"
 #include "SkTextureCompression_opts.h"
 
@@ -237,3 +238,25 @@ bool CompressA8toR11EAC_NEON(uint8_t* dst, const uint8_t* src,
     }
     return true;
 }
+
+void N32ToRGB888_NEON(uint8_t* dst, const SkPMColor* src, int count) {
+    // vld4 splits eight pixels into one register per byte, and vst3 interleaves the color
+    // bytes back without the alpha.
+    for (; count >= 8; count -= 8) {
+        const uint8x8x4_t argb = vld4_u8(reinterpret_cast<const uint8_t*>(src));
+        uint8x8x3_t rgb;
+        rgb.val[0] = argb.val[SK_R32_SHIFT / 8];
+        rgb.val[1] = argb.val[SK_G32_SHIFT / 8];
+        rgb.val[2] = argb.val[SK_B32_SHIFT / 8];
+        vst3_u8(dst, rgb);
+        src += 8;
+        dst += 24;
+    }
+    for (; count > 0; --count) {
+        dst[0] = SkGetPackedR32(*src);
+        dst[1] = SkGetPackedG32(*src);
+        dst[2] = SkGetPackedB32(*src);
+        src += 1;
+        dst += 3;
+    }
+}
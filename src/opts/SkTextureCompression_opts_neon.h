@@ -11,4 +11,6 @@
 bool CompressA8toR11EAC_NEON(uint8_t* dst, const uint8_t* src,
                              int width, int height, size_t rowBytes);
 
+void N32ToRGB888_NEON(uint8_t* dst, const SkPMColor* src, int count);
+
 #endif  // SkTextureCompression_opts_neon_h_
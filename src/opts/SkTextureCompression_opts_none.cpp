@@ -15,3 +15,7 @@ SkTextureCompressorGetPlatformProc(SkColorType colorType, SkTextureCompressor::F
 bool SkTextureCompressorGetPlatformDims(SkTextureCompressor::Format fmt, int* dimX, int* dimY) {
     return false;
 }
+
+SkTextureCompressorRGB888Proc SkTextureCompressorGetPlatformRGB888Proc() {
+    return NULL;
+}
@@ -641,6 +641,28 @@ typedef __m128i (*SkXfermodeProcSIMD)(const __m128i& src, const __m128i& dst);
 
 extern SkXfermodeProcSIMD gSSE2XfermodeProcs[];
 
+// SkFourByteInterp() for four pixels, each lane of coverage holding a pixel's weight in [0..255].
+// A weight of 0 returns dst, as skipping the pixel would.
+static inline __m128i SkFourByteInterp_SSE2(const __m128i& src, const __m128i& dst,
+                                            const __m128i& coverage) {
+    // SkAlpha255To256() for non-zero weights: weight + min(weight, 1)
+    __m128i scale = _mm_add_epi32(coverage, _mm_min_epi16(coverage, _mm_set1_epi32(1)));
+    // Repeat each pixel's scale in the four 16 bit lanes its channels unpack to
+    scale = _mm_or_si128(scale, _mm_slli_epi32(scale, 16));
+    __m128i scaleLo = _mm_unpacklo_epi32(scale, scale);
+    __m128i scaleHi = _mm_unpackhi_epi32(scale, scale);
+    __m128i invScaleLo = _mm_sub_epi16(_mm_set1_epi16(256), scaleLo);
+    __m128i invScaleHi = _mm_sub_epi16(_mm_set1_epi16(256), scaleHi);
+
+    // (src * scale + dst * (256 - scale)) >> 8, which is SkAlphaBlend() and fits in 16 bits
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), scaleLo),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), invScaleLo));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), scaleHi),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), invScaleHi));
+    return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
 void SkSSE2ProcCoeffXfermode::xfer32(SkPMColor dst[], const SkPMColor src[],
                                      int count, const SkAlpha aa[]) const {
     SkASSERT(dst && src && count >= 0);
@@ -680,6 +702,27 @@ void SkSSE2ProcCoeffXfermode::xfer32(SkPMColor dst[], const SkPMColor src[],
             src++;
         }
     } else {
+        while (count >= 4) {
+            uint32_t coverage4;
+            memcpy(&coverage4, aa, sizeof(coverage4));
+            if (0 != coverage4) {
+                __m128i src_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                __m128i dst_pixel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+                __m128i result = procSIMD(src_pixel, dst_pixel);
+                if (0xFFFFFFFF != coverage4) {
+                    __m128i coverage = _mm_cvtsi32_si128(coverage4);
+                    coverage = _mm_unpacklo_epi8(coverage, _mm_setzero_si128());
+                    coverage = _mm_unpacklo_epi16(coverage, _mm_setzero_si128());
+                    result = SkFourByteInterp_SSE2(result, dst_pixel, coverage);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+            }
+            dst += 4;
+            src += 4;
+            aa += 4;
+            count -= 4;
+        }
+
         for (int i = count - 1; i >= 0; --i) {
             unsigned a = aa[i];
             if (0 != a) {
@@ -743,6 +743,16 @@ typedef uint8x8x4_t (*SkXfermodeProcSIMD)(uint8x8x4_t src, uint8x8x4_t dst);
 
 extern SkXfermodeProcSIMD gNEONXfermodeProcs[];
 
+// SkFourByteInterp() for one channel of eight pixels, with each pixel's scale already converted
+// to [0..256]. The multiply may wrap, but the low 8 bits of the result are still right.
+static inline uint8x8_t SkFourByteInterp256_neon8(uint8x8_t src, uint8x8_t dst,
+                                                  int16x8_t scale) {
+    int16x8_t vsrc_wide = vreinterpretq_s16_u16(vmovl_u8(src));
+    int16x8_t vdst_wide = vreinterpretq_s16_u16(vmovl_u8(dst));
+    int16x8_t vdiff = vshrq_n_s16(vmulq_s16(vsubq_s16(vsrc_wide, vdst_wide), scale), 8);
+    return vmovn_u16(vreinterpretq_u16_s16(vaddq_s16(vdst_wide, vdiff)));
+}
+
 void SkNEONProcCoeffXfermode::xfer32(SkPMColor* SK_RESTRICT dst,
                                      const SkPMColor* SK_RESTRICT src, int count,
                                      const SkAlpha* SK_RESTRICT aa) const {
@@ -833,6 +843,31 @@ void SkNEONProcCoeffXfermode::xfer32(SkPMColor* SK_RESTRICT dst,
             dst[i] = proc(src[i], dst[i]);
         }
     } else {
+        while (count >= 8) {
+            uint64_t coverage8;
+            memcpy(&coverage8, aa, sizeof(coverage8));
+            if (0 != coverage8) {
+                uint8x8x4_t vsrc = vld4_u8((const uint8_t*)src);
+                uint8x8x4_t vdst = vld4_u8((const uint8_t*)dst);
+                uint8x8x4_t vres = procSIMD(vsrc, vdst);
+                if (~(uint64_t)0 != coverage8) {
+                    // SkAlpha255To256() for non-zero weights: weight + min(weight, 1). A weight
+                    // of 0 leaves dst as it was.
+                    uint8x8_t vcoverage = vld1_u8(aa);
+                    int16x8_t vscale = vreinterpretq_s16_u16(
+                            vaddl_u8(vcoverage, vmin_u8(vcoverage, vdup_n_u8(1))));
+                    for (int c = 0; c < 4; ++c) {
+                        vres.val[c] = SkFourByteInterp256_neon8(vres.val[c], vdst.val[c], vscale);
+                    }
+                }
+                vst4_u8((uint8_t*)dst, vres);
+            }
+            dst += 8;
+            src += 8;
+            aa += 8;
+            count -= 8;
+        }
+
         for (int i = count - 1; i >= 0; --i) {
             unsigned a = aa[i];
             if (0 != a) {
@@ -5,26 +5,36 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapFilter_opts_AVX2.h"
 #include "SkBitmapFilter_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSSE3.h"
 #include "SkBitmapScaler.h"
 #include "SkBlitMask.h"
 #include "SkBlitRow.h"
+#include "SkBlitRow_opts_AVX2.h"
 #include "SkBlitRow_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE4.h"
 #include "SkBlurImage_opts_SSE2.h"
 #include "SkBlurImage_opts_SSE4.h"
+#include "SkChecksum_opts.h"
+#include "SkChecksum_opts_SSE42.h"
+#include "SkConfig8888_opts.h"
+#include "SkConfig8888_opts_SSSE3.h"
 #include "SkLazyPtr.h"
+#include "SkMipMap_opts.h"
+#include "SkMipMap_opts_SSE2.h"
 #include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
 #include "SkRTConf.h"
+#include "SkSwizzler_opts.h"
+#include "SkSwizzler_opts_SSSE3.h"
 #include "SkUtils.h"
 #include "SkUtils_opts_SSE2.h"
 #include "SkXfermode.h"
 #include "SkXfermode_proccoeff.h"
 
-#if defined(_MSC_VER) && defined(_WIN64)
+#if defined(_MSC_VER)
 #include <intrin.h>
 #endif
 
@@ -35,14 +45,17 @@
    compiled with -msse2 or higher. */
 
 
-/* Function to get the CPU SSE-level in runtime, for different compilers. */
+/* Function to get the CPU SSE-level in runtime, for different compilers.
+ * The sub-leaf (ecx) is always 0, which leaf 7 (extended features) needs.
+ */
 #ifdef _MSC_VER
 static inline void getcpuid(int info_type, int info[4]) {
 #if defined(_WIN64)
-    __cpuid(info, info_type);
+    __cpuidex(info, info_type, 0);
 #else
     __asm {
         mov    eax, [info_type]
+        xor    ecx, ecx
         cpuid
         mov    edi, [info]
         mov    [edi], eax
@@ -57,7 +70,7 @@ static inline void getcpuid(int info_type, int info[4]) {
     asm volatile (
         "cpuid \n\t"
         : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #else
@@ -69,11 +82,47 @@ static inline void getcpuid(int info_type, int info[4]) {
         "movl %%ebx, %1   \n\t"
         "popl %%ebx       \n\t"
         : "=a"(info[0]), "=r"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #endif
 
+/* Reads the extended control register XCR0, to check which register state the OS saves. */
+static inline uint64_t getxcr0() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    asm volatile (
+        ".byte 0x0f, 0x01, 0xd0 \n\t"  // xgetbv, spelled out for older assemblers
+        : "=a"(eax), "=d"(edx)
+        : "c"(0)
+    );
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+/* AVX2 needs the CPU to support it, and the OS to save the YMM registers (OSXSAVE, then XMM and
+ * YMM state enabled in XCR0).
+ */
+static bool cpu_supports_avx2(const int cpu_info1[4]) {
+    const int kOSXSAVE = 1 << 27,
+              kAVX     = 1 << 28;
+    if ((cpu_info1[2] & (kOSXSAVE | kAVX)) != (kOSXSAVE | kAVX)) {
+        return false;
+    }
+    if ((getxcr0() & 0x6) != 0x6) {
+        return false;
+    }
+    int cpu_info7[4] = { 0, 0, 0, 0 };
+    getcpuid(0, cpu_info7);
+    if (cpu_info7[0] < 7) {
+        return false;
+    }
+    getcpuid(7, cpu_info7);
+    return (cpu_info7[1] & (1<<5)) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /* Fetch the SIMD level directly from the CPU, at run-time.
@@ -86,7 +135,9 @@ int* get_SIMD_level() {
 
     int* level = SkNEW(int);
 
-    if ((cpu_info[2] & (1<<20)) != 0) {
+    if ((cpu_info[2] & (1<<20)) != 0 && cpu_supports_avx2(cpu_info)) {
+        *level = SK_CPU_SSE_LEVEL_AVX2;
+    } else if ((cpu_info[2] & (1<<20)) != 0) {
         *level = SK_CPU_SSE_LEVEL_SSE42;
     } else if ((cpu_info[2] & (1<<19)) != 0) {
         *level = SK_CPU_SSE_LEVEL_SSE41;
@@ -137,6 +188,9 @@ void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs) {
         procs->fConvolveHorizontally = &convolveHorizontally_SSE2;
         procs->fApplySIMDPadding = &applySIMDPadding_SSE2;
     }
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        procs->fConvolveVertically = &convolveVertically_AVX2;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,7 +301,17 @@ static const SkBlitRow::Proc32 platform_32_procs_SSE4[] = {
     S32A_Blend_BlitRow32_SSE2,          // S32A_Blend,
 };
 
+static const SkBlitRow::Proc32 platform_32_procs_AVX2[] = {
+    NULL,                               // S32_Opaque,
+    S32_Blend_BlitRow32_SSE2,           // S32_Blend,
+    S32A_Opaque_BlitRow32_AVX2,         // S32A_Opaque
+    S32A_Blend_BlitRow32_AVX2,          // S32A_Blend,
+};
+
 SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return platform_32_procs_AVX2[flags];
+    } else
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE41)) {
         return platform_32_procs_SSE4[flags];
     } else
@@ -259,7 +323,9 @@ SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
 }
 
 SkBlitRow::ColorProc SkBlitRow::PlatformColorProc() {
-    if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return Color32_AVX2;
+    } else if (supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
         return Color32_SSE2;
     } else {
         return NULL;
@@ -282,7 +348,8 @@ SkBlitMask::ColorProc SkBlitMask::PlatformColorProcs(SkColorType dstCT,
                 // The SSE2 version is not (yet) faster for black, so we check
                 // for that.
                 if (SK_ColorBLACK != color) {
-                    proc = SkARGB32_A8_BlitMask_SSE2;
+                    proc = supports_simd(SK_CPU_SSE_LEVEL_AVX2) ? SkARGB32_A8_BlitMask_AVX2
+                                                                : SkARGB32_A8_BlitMask_SSE2;
                 }
                 break;
             default:
@@ -350,6 +417,87 @@ SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType t
             return SkErodeX_SSE2;
         case kErodeY_SkMorphologyProcType:
             return SkErodeY_SSE2;
+        case kDilateXVanHerk_SkMorphologyProcType:
+            return SkDilateXVanHerk_SSE2;
+        case kDilateYVanHerk_SkMorphologyProcType:
+            return SkDilateYVanHerk_SSE2;
+        case kErodeXVanHerk_SkMorphologyProcType:
+            return SkErodeXVanHerk_SSE2;
+        case kErodeYVanHerk_SkMorphologyProcType:
+            return SkErodeYVanHerk_SSE2;
+        default:
+            return NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkMipMapDownsampleRowProc SkMipMapGetPlatformDownsampleProc(SkMipMapDownsampleProcType type) {
+    if (!supports_simd(SK_CPU_SSE_LEVEL_SSE2)) {
+        return NULL;
+    }
+    switch (type) {
+        case k8888_SkMipMapDownsampleProcType:
+            return SkMipMapDownsample8888_SSE2;
+        case k565_SkMipMapDownsampleProcType:
+            return SkMipMapDownsample565_SSE2;
+        case kA8_SkMipMapDownsampleProcType:
+            return SkMipMapDownsampleA8_SSE2;
+        default:
+            return NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkChecksumHashProc SkChecksumGetPlatformHashProc() {
+    if (!supports_simd(SK_CPU_SSE_LEVEL_SSE42)) {
+        return NULL;
+    }
+    return SkChecksumHash_SSE42;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkConfig8888RowProc SkConfig8888GetPlatformRowProc(SkConfig8888RowProcType type) {
+    if (!supports_simd(SK_CPU_SSE_LEVEL_SSSE3)) {
+        return NULL;
+    }
+    switch (type) {
+        case kSwapRB_SkConfig8888RowProcType:
+            return SkConfig8888SwapRB_SSSE3;
+        case kPremul_SkConfig8888RowProcType:
+            return SkConfig8888Premul_SSSE3;
+        case kSwapRBPremul_SkConfig8888RowProcType:
+            return SkConfig8888SwapRBPremul_SSSE3;
+        case kUnpremul_SkConfig8888RowProcType:
+            return SkConfig8888Unpremul_SSSE3;
+        case kSwapRBUnpremul_SkConfig8888RowProcType:
+            return SkConfig8888SwapRBUnpremul_SSSE3;
+        default:
+            return NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkSwizzleRowProc SkSwizzleGetPlatformProc(SkSwizzleProcType type) {
+    if (!supports_simd(SK_CPU_SSE_LEVEL_SSSE3)) {
+        return NULL;
+    }
+    switch (type) {
+        case kRGBA_To_N32_Premul_SkSwizzleProcType:
+            return SkSwizzleRGBAToN32Premul_SSSE3;
+        case kRGBA_To_N32_Unpremul_SkSwizzleProcType:
+            return SkSwizzleRGBAToN32Unpremul_SSSE3;
+        case kRGBX_To_N32_SkSwizzleProcType:
+            return SkSwizzleRGBXToN32_SSSE3;
+        case kRGB_To_N32_SkSwizzleProcType:
+            return SkSwizzleRGBToN32_SSSE3;
+        case kIndex_To_N32_SkSwizzleProcType:
+            return SkSwizzleIndexToN32_SSSE3;
+        case kRGB565_To_N32_SkSwizzleProcType:
+            return SkSwizzleRGB565ToN32_SSSE3;
         default:
             return NULL;
     }
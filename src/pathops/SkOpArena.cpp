@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkOpArena.h"
+#include "SkTLS.h"
+
+// Uses that need more than this keep their memory only until they end.
+static const size_t kMaxCachedBytes = 1 << 20;
+
+static const size_t kMinSizes[] = {
+    4096,   // kOp_Use
+    1024,   // kTSect_Use
+};
+SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kMinSizes) == SkOpArena::kUseCount, missing_min_size);
+
+struct SkOpArena::Slot {
+    SkChunkAlloc*   fAlloc;     // NULL until the first use on this thread
+    size_t          fMinSize;   // fAlloc's minimum size, big enough for all of an earlier use
+    bool            fLent;
+};
+
+namespace {
+struct Slots {
+    SkOpArena::Slot fSlots[SkOpArena::kUseCount];
+};
+} // namespace
+
+static void* create_slots() {
+    Slots* slots = SkNEW(Slots);
+    for (int use = 0; use < SkOpArena::kUseCount; ++use) {
+        slots->fSlots[use].fAlloc = NULL;
+        slots->fSlots[use].fMinSize = kMinSizes[use];
+        slots->fSlots[use].fLent = false;
+    }
+    return slots;
+}
+
+static void delete_slots(void* ptr) {
+    Slots* slots = static_cast<Slots*>(ptr);
+    for (int use = 0; use < SkOpArena::kUseCount; ++use) {
+        SkDELETE(slots->fSlots[use].fAlloc);
+    }
+    SkDELETE(slots);
+}
+
+SkOpArena::SkOpArena(Use use) {
+    Slots* slots = static_cast<Slots*>(SkTLS::Get(create_slots, delete_slots));
+    fSlot = &slots->fSlots[use];
+    if (fSlot->fLent) {
+        fSlot = NULL;
+        fAlloc = SkNEW_ARGS(SkChunkAlloc, (kMinSizes[use]));
+        return;
+    }
+    fSlot->fLent = true;
+    if (NULL == fSlot->fAlloc) {
+        fSlot->fAlloc = SkNEW_ARGS(SkChunkAlloc, (fSlot->fMinSize));
+    }
+    fAlloc = fSlot->fAlloc;
+}
+
+SkOpArena::~SkOpArena() {
+    if (NULL == fSlot) {
+        SkDELETE(fAlloc);
+        return;
+    }
+    fSlot->fLent = false;
+    // A use that spilled past the kept block leaves more than one block behind. Next time,
+    // start with a single block that holds all of it.
+    size_t capacity = fAlloc->totalCapacity();
+    if (capacity <= fSlot->fMinSize) {
+        fAlloc->rewind();
+    } else if (capacity <= kMaxCachedBytes) {
+        fSlot->fMinSize = capacity;
+        SkDELETE(fAlloc);
+        fSlot->fAlloc = SkNEW_ARGS(SkChunkAlloc, (capacity));
+    } else {
+        fAlloc->reset();
+    }
+}
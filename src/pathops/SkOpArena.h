@@ -0,0 +1,39 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkOpArena_DEFINED
+#define SkOpArena_DEFINED
+
+#include "SkChunkAlloc.h"
+
+/** Lends out the calling thread's SkChunkAlloc for one use, for the temporaries of a path op
+    or of one curve intersection. The allocator is rewound when the arena goes out of scope,
+    keeping a block big enough for the most that any earlier use on this thread needed, so a
+    run of similar ops makes no calls to malloc. If the thread's allocator is already lent out,
+    the arena makes a private one instead.
+ */
+class SkOpArena : SkNoncopyable {
+public:
+    enum Use {
+        kOp_Use,      //!< everything built while computing Op() or Simplify()
+        kTSect_Use,   //!< the spans of one pair of SkTSects
+
+        kUseCount
+    };
+
+    explicit SkOpArena(Use use);
+    ~SkOpArena();
+
+    SkChunkAlloc& alloc() { return *fAlloc; }
+
+    struct Slot;
+
+private:
+    Slot* fSlot;
+    SkChunkAlloc* fAlloc;
+};
+
+#endif
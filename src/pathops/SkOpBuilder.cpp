@@ -8,6 +8,8 @@
 #include "SkMatrix.h"
 #include "SkPath.h"
 #include "SkPathOps.h"
+#include "SkRTree.h"
+#include "SkTaskGroup.h"
 
 void SkOpBuilder::add(const SkPath& path, SkPathOp op) {
     if (0 == fOps.count() && op != kUnion_SkPathOp) {
@@ -26,21 +28,18 @@ void SkOpBuilder::reset() {
 /* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
-bool SkOpBuilder::resolve(SkPath* result) {
-    int count = fOps.count();
-    bool allUnion = true;
+// Unions paths, none of which has an inverse fill. The paths may be reversed or simplified
+// in place.
+static bool union_paths(SkPath* const paths[], int count, SkPath* result) {
+    bool simplifySum = true;
     SkPath::Direction firstDir;
     for (int index = 0; index < count; ++index) {
-        SkPath* test = &fPathRefs[index];
-        if (kUnion_SkPathOp != fOps[index] || test->isInverseFillType()) {
-            allUnion = false;
-            break;
-        }
+        SkPath* test = paths[index];
         // If all paths are convex, track direction, reversing as needed.
         if (test->isConvex()) {
             SkPath::Direction dir;
             if (!test->cheapComputeDirection(&dir)) {
-                allUnion = false;
+                simplifySum = false;
                 break;
             }
             if (index == 0) {
@@ -56,12 +55,169 @@ bool SkOpBuilder::resolve(SkPath* result) {
         const SkRect& testBounds = test->getBounds();
         for (int inner = 0; inner < index; ++inner) {
             // OPTIMIZE: check to see if the contour bounds do not intersect other contour bounds?
-            if (SkRect::Intersects(fPathRefs[inner].getBounds(), testBounds)) {
-                allUnion = false;
+            if (SkRect::Intersects(paths[inner]->getBounds(), testBounds)) {
+                simplifySum = false;
                 break;
             }
         }
     }
+    if (!simplifySum) {
+        *result = *paths[0];
+        for (int index = 1; index < count; ++index) {
+            if (!Op(*result, *paths[index], kUnion_SkPathOp, result)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    SkPath sum;
+    for (int index = 0; index < count; ++index) {
+        if (!Simplify(*paths[index], paths[index])) {
+            return false;
+        }
+        sum.addPath(*paths[index]);
+    }
+    return Simplify(sum, result);
+}
+
+namespace {
+// Paths whose bounds overlap, directly or through other paths in the cluster. Each cluster is
+// unioned on its own SkTaskGroup task.
+struct UnionCluster {
+    SkPath**        fPaths;
+    int             fCount;
+    SkPath          fResult;
+    bool            fSucceeded;
+};
+} // namespace
+
+static void union_cluster(UnionCluster* cluster) {
+    cluster->fSucceeded = union_paths(cluster->fPaths, cluster->fCount, &cluster->fResult);
+}
+
+// Paths that only touch, or come within pathops' tolerance of each other, must still be
+// unioned together, so bounds are grown by a small fraction of their magnitude before testing.
+static SkRect pad_bounds(const SkRect& bounds) {
+    SkScalar magnitude = SkMaxScalar(SkMaxScalar(SkScalarAbs(bounds.fLeft),
+                                                 SkScalarAbs(bounds.fRight)),
+                                     SkMaxScalar(SkScalarAbs(bounds.fTop),
+                                                 SkScalarAbs(bounds.fBottom)));
+    SkScalar pad = SkMaxScalar(magnitude, SK_Scalar1) / 4096;
+    SkRect padded = bounds;
+    padded.outset(pad, pad);
+    return padded;
+}
+
+static int find_cluster(int parents[], int index) {
+    while (parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+/* Paths fall into clusters that share no area with each other: the connected components of the
+   graph where two paths are joined if their bounds overlap. Each cluster is unioned on its own,
+   in parallel, and since the results can't cross or touch, they are simply appended. Paths with
+   empty bounds have no area and are left out. */
+static bool union_clusters(SkPath* const paths[], int count, SkPath* result) {
+    SkAutoTMalloc<SkRect> bounds(count);
+    SkAutoTMalloc<int> parents(count);
+    for (int index = 0; index < count; ++index) {
+        const SkRect& pathBounds = paths[index]->getBounds();
+        if (!pathBounds.isFinite()) {
+            return union_paths(paths, count, result);
+        }
+        if (pathBounds.isEmpty()) {
+            bounds[index].setEmpty();
+            parents[index] = -1;
+        } else {
+            bounds[index] = pad_bounds(pathBounds);
+            parents[index] = index;
+        }
+    }
+    SkRTree rtree;
+    rtree.insert(bounds.get(), count);
+    SkTDArray<unsigned> hits;
+    for (int index = 0; index < count; ++index) {
+        if (parents[index] < 0) {
+            continue;
+        }
+        hits.rewind();
+        rtree.search(bounds[index], &hits);
+        for (int hit = 0; hit < hits.count(); ++hit) {
+            int a = find_cluster(parents.get(), index);
+            int b = find_cluster(parents.get(), hits[hit]);
+            // Keep the lowest index as the root, so clusters stay in the order they were added.
+            parents[SkMax32(a, b)] = SkMin32(a, b);
+        }
+    }
+
+    // Number the clusters, then gather the paths of each one together.
+    SkAutoTMalloc<int> clusterOf(count);
+    SkTDArray<int> clusterStarts;
+    for (int index = 0; index < count; ++index) {
+        if (parents[index] < 0) {
+            continue;
+        }
+        int root = find_cluster(parents.get(), index);
+        if (root == index) {
+            clusterOf[index] = clusterStarts.count();
+            *clusterStarts.append() = 0;
+        }
+        clusterStarts[clusterOf[root]]++;
+    }
+    int clusterCount = clusterStarts.count();
+    if (clusterCount <= 1) {
+        return union_paths(paths, count, result);
+    }
+    int start = 0;
+    for (int cluster = 0; cluster < clusterCount; ++cluster) {
+        int size = clusterStarts[cluster];
+        clusterStarts[cluster] = start;
+        start += size;
+    }
+    SkAutoTMalloc<SkPath*> sorted(start);
+    SkTArray<UnionCluster> clusters(clusterCount);
+    for (int cluster = 0; cluster < clusterCount; ++cluster) {
+        UnionCluster& entry = clusters.push_back();
+        entry.fPaths = &sorted[clusterStarts[cluster]];
+        entry.fCount = 0;
+        entry.fSucceeded = false;
+    }
+    for (int index = 0; index < count; ++index) {
+        if (parents[index] < 0) {
+            continue;
+        }
+        UnionCluster& entry = clusters[clusterOf[find_cluster(parents.get(), index)]];
+        entry.fPaths[entry.fCount++] = paths[index];
+    }
+
+    SkTaskGroup tg;
+    tg.batch(union_cluster, clusters.begin(), clusterCount);
+    tg.wait();
+
+    SkPath sum;
+    for (int cluster = 0; cluster < clusterCount; ++cluster) {
+        if (!clusters[cluster].fSucceeded) {
+            return false;
+        }
+        sum.addPath(clusters[cluster].fResult);
+    }
+    sum.setFillType(SkPath::kEvenOdd_FillType);
+    *result = sum;
+    return true;
+}
+
+bool SkOpBuilder::resolve(SkPath* result) {
+    int count = fOps.count();
+    bool allUnion = true;
+    for (int index = 0; index < count; ++index) {
+        if (kUnion_SkPathOp != fOps[index] || fPathRefs[index].isInverseFillType()) {
+            allUnion = false;
+            break;
+        }
+    }
     if (!allUnion) {
         *result = fPathRefs[0];
         for (int index = 1; index < count; ++index) {
@@ -73,14 +229,11 @@ bool SkOpBuilder::resolve(SkPath* result) {
         reset();
         return true;
     }
-    SkPath sum;
+    SkTDArray<SkPath*> paths;
     for (int index = 0; index < count; ++index) {
-        if (!Simplify(fPathRefs[index], &fPathRefs[index])) {
-            reset();
-            return false;
-        }
-        sum.addPath(fPathRefs[index]);
+        *paths.append() = &fPathRefs[index];
     }
+    bool succeeded = union_clusters(paths.begin(), count, result);
     reset();
-    return Simplify(sum, result);
+    return succeeded;
 }
@@ -73,6 +73,10 @@ int SkOpEdgeBuilder::preFetch() {
         fUnparseable = true;
         return 0;
     }
+    // Every point and verb is copied, plus the line and close that may end each contour.
+    // Only conics, split into quads, can need more.
+    fPathPts.setReserve(fPathPts.count() + fPath->countPoints() * 2);
+    fPathVerbs.setReserve(fPathVerbs.count() + fPath->countVerbs() * 2 + 1);
     SkAutoConicToQuads quadder;
     const SkScalar quadderTol = SK_Scalar1 / 16;
     SkPath::RawIter iter(*fPath);
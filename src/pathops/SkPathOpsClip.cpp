@@ -0,0 +1,328 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkEdgeClipper.h"
+#include "SkGeometry.h"
+#include "SkPathOps.h"
+
+namespace {
+
+/*  Clips a path to a rect one contour at a time. Each curve is chopped where it turns in x or y,
+    and again where it crosses the lines through the rect's edges, so every piece lies either
+    inside the rect or in one of the eight regions around it. Pieces inside are kept. A piece
+    outside is replaced by the line between its ends clamped to the rect, which runs along an
+    edge or collapses onto a corner. Sliding a piece onto the edge never crosses the rect's
+    interior, so every point inside keeps its winding number and the clipped contours fill
+    just like the originals, for either fill type.
+ */
+class RectClipper {
+public:
+    RectClipper(const SkRect& clip, SkPath* result)
+        : fClip(clip)
+        , fResult(result)
+        , fEdgeWinding(0)
+        , fKeptInside(false) {
+    }
+
+    void moveTo(const SkPoint& pt) {
+        this->closeContour();
+        fStart = fLast = this->clamp(pt);
+        fContour.moveTo(fStart);
+    }
+
+    // count is the number of points: 2 for a line, 3 for a quad, 4 for a cubic.
+    void addCurve(const SkPoint pts[], int count);
+
+    void closeContour();
+
+    // Adds the contours that ended up running only along the rect's edges.
+    void finish();
+
+private:
+    SkPoint clamp(const SkPoint& pt) const {
+        return SkPoint::Make(SkScalarPin(pt.fX, fClip.fLeft, fClip.fRight),
+                             SkScalarPin(pt.fY, fClip.fTop, fClip.fBottom));
+    }
+
+    bool contains(const SkPoint& pt) const {
+        return fClip.fLeft <= pt.fX && pt.fX <= fClip.fRight &&
+               fClip.fTop <= pt.fY && pt.fY <= fClip.fBottom;
+    }
+
+    void addMonoCurve(const SkPoint pts[], int count);
+    void addPiece(const SkPoint pts[], int count);
+
+    const SkRect    fClip;
+    SkPath*         fResult;
+    SkPath          fContour;
+    SkPoint         fStart;
+    SkPoint         fLast;
+    int             fEdgeWinding;
+    bool            fKeptInside;
+};
+
+} // namespace
+
+static SkScalar coord(const SkPoint& pt, bool isY) {
+    return isY ? pt.fY : pt.fX;
+}
+
+static void set_coord(SkPoint* pt, bool isY, SkScalar value) {
+    if (isY) {
+        pt->fY = value;
+    } else {
+        pt->fX = value;
+    }
+}
+
+// Finds where a curve that is monotonic in the coordinate reaches value, strictly between its
+// ends.
+static bool chop_mono_at(const SkPoint pts[], int count, bool isY, SkScalar value, SkScalar* t) {
+    SkScalar c[4];
+    SkScalar sign = coord(pts[0], isY) < coord(pts[count - 1], isY) ? SK_Scalar1 : -SK_Scalar1;
+    for (int index = 0; index < count; ++index) {
+        c[index] = sign * coord(pts[index], isY);
+    }
+    value *= sign;
+    if (!(c[0] < value && value < c[count - 1])) {
+        return false;
+    }
+    switch (count) {
+        case 2:
+            *t = (value - c[0]) / (c[1] - c[0]);
+            break;
+        case 3:
+            if (!SkChopMonoQuadAt(c[0], c[1], c[2], value, t)) {
+                return false;
+            }
+            break;
+        default:
+            SkChopMonoCubicAt(c[0], c[1], c[2], c[3], value, t);
+            break;
+    }
+    return 0 < *t && *t < 1;
+}
+
+static void chop_at(const SkPoint pts[], int count, SkScalar t, SkPoint dst[]) {
+    switch (count) {
+        case 2:
+            dst[0] = pts[0];
+            dst[1].set(SkScalarInterp(pts[0].fX, pts[1].fX, t),
+                       SkScalarInterp(pts[0].fY, pts[1].fY, t));
+            dst[2] = pts[1];
+            break;
+        case 3:
+            SkChopQuadAt(pts, dst, t);
+            break;
+        default:
+            SkChopCubicAt(pts, dst, t);
+            break;
+    }
+}
+
+static SkPoint eval_half(const SkPoint pts[], int count) {
+    SkPoint pt;
+    switch (count) {
+        case 2:
+            pt.set(SkScalarAve(pts[0].fX, pts[1].fX), SkScalarAve(pts[0].fY, pts[1].fY));
+            break;
+        case 3:
+            pt = SkEvalQuadAt(pts, SK_ScalarHalf);
+            break;
+        default:
+            SkEvalCubicAt(pts, SK_ScalarHalf, &pt, NULL, NULL);
+            break;
+    }
+    return pt;
+}
+
+void RectClipper::addCurve(const SkPoint pts[], int count) {
+    SkPoint monoY[10];
+    int monoYCount;
+    switch (count) {
+        case 2:
+            this->addMonoCurve(pts, 2);
+            return;
+        case 3:
+            monoYCount = SkChopQuadAtYExtrema(pts, monoY) + 1;
+            break;
+        default:
+            monoYCount = SkChopCubicAtYExtrema(pts, monoY) + 1;
+            break;
+    }
+    for (int y = 0; y < monoYCount; ++y) {
+        const SkPoint* curve = &monoY[y * (count - 1)];
+        SkPoint monoX[10];
+        int monoXCount = (3 == count ? SkChopQuadAtXExtrema(curve, monoX)
+                                     : SkChopCubicAtXExtrema(curve, monoX)) + 1;
+        for (int x = 0; x < monoXCount; ++x) {
+            this->addMonoCurve(&monoX[x * (count - 1)], count);
+        }
+    }
+}
+
+void RectClipper::addMonoCurve(const SkPoint pts[], int count) {
+    struct Crossing {
+        SkScalar    fT;
+        SkScalar    fValue;
+        bool        fIsY;
+    };
+    const Crossing edges[] = {
+        { 0, fClip.fLeft, false }, { 0, fClip.fRight, false },
+        { 0, fClip.fTop, true }, { 0, fClip.fBottom, true },
+    };
+    Crossing crossings[SK_ARRAY_COUNT(edges)];
+    int crossingCount = 0;
+    for (size_t index = 0; index < SK_ARRAY_COUNT(edges); ++index) {
+        Crossing crossing = edges[index];
+        if (chop_mono_at(pts, count, crossing.fIsY, crossing.fValue, &crossing.fT)) {
+            int insert = crossingCount++;
+            for (; insert > 0 && crossings[insert - 1].fT > crossing.fT; --insert) {
+                crossings[insert] = crossings[insert - 1];
+            }
+            crossings[insert] = crossing;
+        }
+    }
+
+    SkPoint rest[4];
+    memcpy(rest, pts, count * sizeof(SkPoint));
+    SkScalar restStart = 0;
+    for (int index = 0; index < crossingCount; ++index) {
+        const Crossing& crossing = crossings[index];
+        SkScalar t = (crossing.fT - restStart) / (1 - restStart);
+        if (!(0 < t && t < 1)) {
+            continue;
+        }
+        SkPoint chopped[7];
+        chop_at(rest, count, t, chopped);
+        // Put the chop exactly on the edge, so the pieces on either side meet there.
+        set_coord(&chopped[count - 1], crossing.fIsY, crossing.fValue);
+        this->addPiece(chopped, count);
+        memcpy(rest, &chopped[count - 1], count * sizeof(SkPoint));
+        restStart = crossing.fT;
+    }
+    this->addPiece(rest, count);
+}
+
+void RectClipper::addPiece(const SkPoint pts[], int count) {
+    if (!this->contains(eval_half(pts, count))) {
+        SkPoint end = this->clamp(pts[count - 1]);
+        if (end != fLast) {
+            fContour.lineTo(end);
+            fLast = end;
+        }
+        return;
+    }
+    if (pts[0] != fLast) {
+        fContour.lineTo(pts[0]);
+    }
+    switch (count) {
+        case 2:
+            fContour.lineTo(pts[1]);
+            break;
+        case 3:
+            fContour.quadTo(pts[1], pts[2]);
+            break;
+        default:
+            fContour.cubicTo(pts[1], pts[2], pts[3]);
+            break;
+    }
+    fLast = pts[count - 1];
+    fKeptInside = true;
+}
+
+void RectClipper::closeContour() {
+    if (fContour.isEmpty()) {
+        return;
+    }
+    if (fKeptInside) {
+        fContour.close();
+        fResult->addPath(fContour);
+    } else {
+        // Only lines along the rect's edges are left, so the contour winds a whole number of
+        // times around the rect, and its area tells how many. These are all gathered into
+        // copies of the rect at the end.
+        int count = fContour.countPoints();
+        SkScalar area = 0;
+        SkPoint prev = fContour.getPoint(count - 1);
+        for (int index = 0; index < count; ++index) {
+            SkPoint pt = fContour.getPoint(index);
+            area += prev.fX * pt.fY - pt.fX * prev.fY;
+            prev = pt;
+        }
+        fEdgeWinding += SkScalarRoundToInt(area / (2 * fClip.width() * fClip.height()));
+    }
+    fContour.rewind();
+    fKeptInside = false;
+}
+
+void RectClipper::finish() {
+    this->closeContour();
+    int copies = SkAbs32(fEdgeWinding);
+    if (SkPath::kEvenOdd_FillType == fResult->getFillType()) {
+        copies &= 1;
+    }
+    SkPath::Direction dir = fEdgeWinding > 0 ? SkPath::kCW_Direction : SkPath::kCCW_Direction;
+    for (int index = 0; index < copies; ++index) {
+        fResult->addRect(fClip, dir);
+    }
+}
+
+bool ClipToRect(const SkPath& path, const SkRect& rect, SkPath* result) {
+    if (!path.isFinite() || !rect.isFinite()) {
+        return false;
+    }
+    if (path.isInverseFillType()) {
+        SkPath rectPath;
+        rectPath.addRect(rect);
+        return Op(path, rectPath, kIntersect_SkPathOp, result);
+    }
+    const SkRect& bounds = path.getBounds();
+    if (rect.contains(bounds)) {
+        *result = path;
+        return true;
+    }
+    SkPath clipped;
+    clipped.setFillType(path.getFillType());
+    if (rect.isEmpty() || !SkRect::Intersects(rect, bounds)) {
+        result->swap(clipped);
+        return true;
+    }
+    RectClipper clipper(rect, &clipped);
+    SkPath::Iter iter(path, true);
+    SkAutoConicToQuads quadder;
+    const SkScalar quadderTol = SK_Scalar1 / 4;
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                clipper.moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                clipper.addCurve(pts, 2);
+                break;
+            case SkPath::kQuad_Verb:
+                clipper.addCurve(pts, 3);
+                break;
+            case SkPath::kConic_Verb: {
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                              quadderTol);
+                for (int index = 0; index < quadder.countQuads(); ++index) {
+                    clipper.addCurve(&quadPts[index * 2], 3);
+                }
+            } break;
+            case SkPath::kCubic_Verb:
+                clipper.addCurve(pts, 4);
+                break;
+            default:
+                break;
+        }
+    }
+    clipper.finish();
+    result->swap(clipped);
+    return true;
+}
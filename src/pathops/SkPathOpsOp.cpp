@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 #include "SkAddIntersections.h"
+#include "SkOpArena.h"
 #include "SkOpCoincidence.h"
 #include "SkOpEdgeBuilder.h"
 #include "SkPathOpsCommon.h"
@@ -261,7 +262,8 @@ static void dump_op(const SkPath& one, const SkPath& two, SkPathOp op) {
 #endif
 
 bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
-    SkChunkAlloc allocator(4096);  // FIXME: add a constant expression here, tune
+    SkOpArena arena(SkOpArena::kOp_Use);
+    SkChunkAlloc& allocator = arena.alloc();
     SkOpContour contour;
     SkOpCoincidence coincidence;
     SkOpGlobalState globalState(&coincidence  PATH_OPS_DEBUG_PARAMS(&contour));
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 #include "SkAddIntersections.h"
+#include "SkOpArena.h"
 #include "SkOpCoincidence.h"
 #include "SkOpEdgeBuilder.h"
 #include "SkPathOpsCommon.h"
@@ -177,7 +178,6 @@ static bool bridgeXor(SkTDArray<SkOpContour* >& contourList, SkPathWriter* simpl
 
 // FIXME : add this as a member of SkPath
 bool Simplify(const SkPath& path, SkPath* result) {
-    SkChunkAlloc allocator(4096);  // FIXME: constant-ize, tune
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
             : SkPath::kEvenOdd_FillType;
@@ -189,6 +189,8 @@ bool Simplify(const SkPath& path, SkPath* result) {
         return true;
     }
     // turn path into list of segments
+    SkOpArena arena(SkOpArena::kOp_Use);
+    SkChunkAlloc& allocator = arena.alloc();
     SkOpCoincidence coincidence;
     SkOpContour contour;
     SkOpGlobalState globalState(&coincidence  PATH_OPS_DEBUG_PARAMS(&contour));
@@ -5,11 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkOpArena.h"
 #include "SkPathOpsTSect.h"
 
 int SkIntersections::intersect(const SkDCubic& cubic1, const SkDCubic& cubic2) {
-    SkTSect<SkDCubic> sect1(cubic1 PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect<SkDCubic> sect2(cubic2 PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkOpArena arena(SkOpArena::kTSect_Use);
+    SkTSect<SkDCubic> sect1(cubic1, &arena.alloc() PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect<SkDCubic> sect2(cubic2, &arena.alloc() PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect<SkDCubic>::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -5,11 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkOpArena.h"
 #include "SkPathOpsTSect.h"
 
 int SkIntersections::intersect(const SkDQuad& quad1, const SkDQuad& quad2) {
-    SkTSect<SkDQuad> sect1(quad1 PATH_OPS_DEBUG_T_SECT_PARAMS(1));
-    SkTSect<SkDQuad> sect2(quad2 PATH_OPS_DEBUG_T_SECT_PARAMS(2));
+    SkOpArena arena(SkOpArena::kTSect_Use);
+    SkTSect<SkDQuad> sect1(quad1, &arena.alloc() PATH_OPS_DEBUG_T_SECT_PARAMS(1));
+    SkTSect<SkDQuad> sect2(quad2, &arena.alloc() PATH_OPS_DEBUG_T_SECT_PARAMS(2));
     SkTSect<SkDQuad>::BinarySearch(&sect1, &sect2, this);
     return used();
 }
@@ -189,7 +189,7 @@ private:
 template<typename TCurve>
 class SkTSect {
 public:
-    SkTSect(const TCurve& c  PATH_OPS_DEBUG_T_SECT_PARAMS(int id));
+    SkTSect(const TCurve& c, SkChunkAlloc* heap  PATH_OPS_DEBUG_T_SECT_PARAMS(int id));
     static void BinarySearch(SkTSect* sect1, SkTSect* sect2, SkIntersections* intersections);
 
     // for testing only
@@ -273,7 +273,7 @@ private:
     void validateBounded() const;
 
     const TCurve& fCurve;
-    SkChunkAlloc fHeap;
+    SkChunkAlloc& fHeap;
     SkTSpan<TCurve>* fHead;
     SkTSpan<TCurve>* fCoincident;
     SkTSpan<TCurve>* fDeleted;
@@ -782,9 +782,10 @@ void SkTSpan<TCurve>::validatePerpPt(double t, const SkDPoint& pt) const {
 
 
 template<typename TCurve>
-SkTSect<TCurve>::SkTSect(const TCurve& c PATH_OPS_DEBUG_T_SECT_PARAMS(int id))
+SkTSect<TCurve>::SkTSect(const TCurve& c, SkChunkAlloc* heap
+        PATH_OPS_DEBUG_T_SECT_PARAMS(int id))
     : fCurve(c)
-    , fHeap(sizeof(SkTSpan<TCurve>) * 4)
+    , fHeap(*heap)
     , fCoincident(NULL)
     , fDeleted(NULL)
     , fActiveCount(0)
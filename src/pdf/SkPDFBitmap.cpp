@@ -6,9 +6,11 @@
  */
 
 #include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkFlate.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
+#include "SkPixelRef.h"
 #include "SkStream.h"
 #include "SkUnPreMultiply.h"
 
@@ -235,6 +237,22 @@ static void bitmap_alpha_to_a8(const SkBitmap& bitmap, SkWStream* out) {
     }
 }
 
+// Deflates the pixels that toPixels() writes.  Written to a temporary buffer
+// to get the compressed length.
+static SkStreamAsset* deflate_pixels(const SkBitmap& bitmap,
+                                     void (*toPixels)(const SkBitmap&,
+                                                      SkWStream*)) {
+    SkAutoLockPixels autoLockPixels(bitmap);
+    SkASSERT(bitmap.colorType() != kIndex_8_SkColorType ||
+             bitmap.getColorTable());
+
+    SkDynamicMemoryWStream buffer;
+    SkDeflateWStream deflateWStream(&buffer);
+    toPixels(bitmap, &deflateWStream);
+    deflateWStream.finalize();  // call before detachAsStream().
+    return buffer.detachAsStream();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace {
@@ -246,24 +264,24 @@ public:
     void emitObject(SkWStream*,
                     const SkPDFObjNumMap&,
                     const SkPDFSubstituteMap&) override;
+    void compress() override;
 
 private:
     const SkBitmap fBitmap;
+    SkAutoTDelete<SkStreamAsset> fDeflated;
 };
 
+void PDFAlphaBitmap::compress() {
+    if (!fDeflated) {
+        fDeflated.reset(deflate_pixels(fBitmap, bitmap_alpha_to_a8));
+    }
+}
+
 void PDFAlphaBitmap::emitObject(SkWStream* stream,
                                 const SkPDFObjNumMap& objNumMap,
                                 const SkPDFSubstituteMap& substitutes) {
-    SkAutoLockPixels autoLockPixels(fBitmap);
-    SkASSERT(fBitmap.colorType() != kIndex_8_SkColorType ||
-             fBitmap.getColorTable());
-
-    // Write to a temporary buffer to get the compressed length.
-    SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    bitmap_alpha_to_a8(fBitmap, &deflateWStream);
-    deflateWStream.finalize();  // call before detachAsStream().
-    SkAutoTDelete<SkStreamAsset> asset(buffer.detachAsStream());
+    this->compress();
+    SkAutoTDelete<SkStreamAsset> asset(fDeflated.detach());
 
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
@@ -324,19 +342,17 @@ static SkPDFArray* make_indexed_color_space(const SkColorTable* table) {
     return result;
 }
 
+void SkPDFBitmap::compress() {
+    if (!fDeflated) {
+        fDeflated.reset(deflate_pixels(fBitmap, bitmap_to_pdf_pixels));
+    }
+}
+
 void SkPDFBitmap::emitObject(SkWStream* stream,
                              const SkPDFObjNumMap& objNumMap,
                              const SkPDFSubstituteMap& substitutes) {
-    SkAutoLockPixels autoLockPixels(fBitmap);
-    SkASSERT(fBitmap.colorType() != kIndex_8_SkColorType ||
-             fBitmap.getColorTable());
-
-    // Write to a temporary buffer to get the compressed length.
-    SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
-    bitmap_to_pdf_pixels(fBitmap, &deflateWStream);
-    deflateWStream.finalize();  // call before detachAsStream().
-    SkAutoTDelete<SkStreamAsset> asset(buffer.detachAsStream());
+    this->compress();
+    SkAutoTDelete<SkStreamAsset> asset(fDeflated.detach());
 
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
@@ -381,6 +397,89 @@ static const SkBitmap& immutable_bitmap(const SkBitmap& bm, SkBitmap* copy) {
     return *copy;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+// This SkPDFBitmap writes the JPEG its pixels were decoded from, as is.
+class PDFJpegBitmap : public SkPDFBitmap {
+public:
+    PDFJpegBitmap(const SkBitmap& bm, SkData* data, int components)
+        : SkPDFBitmap(bm, NULL), fData(SkRef(data)), fComponents(components) {}
+    void emitObject(SkWStream*,
+                    const SkPDFObjNumMap&,
+                    const SkPDFSubstituteMap&) override;
+    void compress() override {}
+
+private:
+    SkAutoTUnref<SkData> fData;
+    const int fComponents;
+};
+
+void PDFJpegBitmap::emitObject(SkWStream* stream,
+                               const SkPDFObjNumMap& objNumMap,
+                               const SkPDFSubstituteMap& substitutes) {
+    SkPDFDict pdfDict("XObject");
+    pdfDict.insertName("Subtype", "Image");
+    pdfDict.insertInt("Width", fBitmap.width());
+    pdfDict.insertInt("Height", fBitmap.height());
+    pdfDict.insertName("ColorSpace",
+                       1 == fComponents ? "DeviceGray" : "DeviceRGB");
+    pdfDict.insertInt("BitsPerComponent", 8);
+    pdfDict.insertName("Filter", "DCTDecode");
+    pdfDict.insertInt("Length", fData->size());
+    pdfDict.emitObject(stream, objNumMap, substitutes);
+
+    pdf_stream_begin(stream);
+    stream->write(fData->data(), fData->size());
+    pdf_stream_end(stream);
+}
+}  // namespace
+
+// Returns the number of color components (1 or 3) if data is a JFIF JPEG of
+// the given size with 8 bit samples, which a PDF DCTDecode filter reads as
+// DeviceGray or (from YCbCr) DeviceRGB.  Returns 0 otherwise.
+static int jfif_jpeg_components(const SkData* data, const SkISize& size) {
+    //  0   1   2   3   4   5   6   7   8   9   10
+    //  FF  D8  FF  E0  ??  ??  'J' 'F' 'I' 'F' 00 ...
+    static const uint8_t kStart[] = {0xFF, 0xD8, 0xFF, 0xE0};
+    static const uint8_t kJFIF[] = {'J', 'F', 'I', 'F', 0};
+    const uint8_t* bytes = data->bytes();
+    const size_t length = data->size();
+    if (length < 11 ||
+        0 != memcmp(bytes, kStart, sizeof(kStart)) ||
+        0 != memcmp(bytes + 6, kJFIF, sizeof(kJFIF))) {
+        return 0;
+    }
+    // Walk the marker segments to the start of frame.
+    size_t offset = 2;
+    while (offset + 4 <= length && 0xFF == bytes[offset]) {
+        const uint8_t marker = bytes[offset + 1];
+        const size_t segmentLength = (bytes[offset + 2] << 8) | bytes[offset + 3];
+        // SOF0 - SOF15, except DHT (C4), JPG (C8) and DAC (CC).
+        if (marker >= 0xC0 && marker <= 0xCF &&
+            marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            // P, Y (2 bytes), X (2 bytes), Nf
+            if (segmentLength < 8 || offset + 10 > length) {
+                return 0;
+            }
+            const uint8_t* frame = bytes + offset + 4;
+            const int height = (frame[1] << 8) | frame[2];
+            const int width = (frame[3] << 8) | frame[4];
+            const int components = frame[5];
+            if (8 != frame[0] || size != SkISize::Make(width, height) ||
+                (1 != components && 3 != components)) {
+                return 0;
+            }
+            return components;
+        }
+        if (0xDA == marker) {  // Start of scan, but no frame header yet.
+            return 0;
+        }
+        offset += 2 + segmentLength;
+    }
+    return 0;
+}
+
 SkPDFBitmap* SkPDFBitmap::Create(SkPDFCanon* canon, const SkBitmap& bitmap) {
     SkASSERT(canon);
     if (!SkColorTypeIsValid(bitmap.colorType()) ||
@@ -395,6 +494,19 @@ SkPDFBitmap* SkPDFBitmap::Create(SkPDFCanon* canon, const SkBitmap& bitmap) {
     if (SkPDFBitmap* canonBitmap = canon->findBitmap(bm)) {
         return SkRef(canonBitmap);
     }
+    // A bitmap of all the pixels decoded from a JPEG can use the JPEG itself.
+    SkPixelRef* pixelRef = bm.pixelRef();
+    if (pixelRef && bm.pixelRefOrigin().isZero() &&
+        bm.dimensions() == pixelRef->info().dimensions()) {
+        SkAutoTUnref<SkData> data(pixelRef->refEncodedData());
+        int components = data ? jfif_jpeg_components(data, bm.dimensions()) : 0;
+        if (components > 0) {
+            SkPDFBitmap* pdfBitmap =
+                    SkNEW_ARGS(PDFJpegBitmap, (bm, data.get(), components));
+            canon->addBitmap(pdfBitmap);
+            return pdfBitmap;
+        }
+    }
     SkPDFObject* smask = NULL;
     if (!bm.isOpaque() && !SkBitmap::ComputeIsOpaque(bm)) {
         smask = SkNEW_ARGS(PDFAlphaBitmap, (bm));
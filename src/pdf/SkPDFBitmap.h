@@ -11,11 +11,13 @@
 #include "SkBitmap.h"
 
 class SkPDFCanon;
+class SkStreamAsset;
 
 /**
  * SkPDFBitmap wraps a SkBitmap and serializes it as an image Xobject.
  * It is designed to use a minimal amout of memory, aside from refing
  * the bitmap's pixels, and its emitObject() does not cache any data.
+ * compress() holds on to the deflated pixels only until they are emitted.
  *
  * If !bitmap.isImmutable(), then a copy of the bitmap must be made;
  * there is no way around this.
@@ -32,16 +34,20 @@ public:
                     const SkPDFSubstituteMap& substitutes) override;
     void addResources(SkPDFObjNumMap*,
                       const SkPDFSubstituteMap&) const override;
+    void compress() override;
     bool equals(const SkBitmap& other) const {
         return fBitmap.getGenerationID() == other.getGenerationID() &&
                fBitmap.pixelRefOrigin() == other.pixelRefOrigin() &&
                fBitmap.dimensions() == other.dimensions();
     }
 
-private:
+protected:
     const SkBitmap fBitmap;
-    const SkAutoTUnref<SkPDFObject> fSMask;
     SkPDFBitmap(const SkBitmap&, SkPDFObject*);
+
+private:
+    const SkAutoTUnref<SkPDFObject> fSMask;
+    SkAutoTDelete<SkStreamAsset> fDeflated;
 };
 
 #endif  // SkPDFBitmap_DEFINED
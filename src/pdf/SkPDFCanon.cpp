@@ -8,7 +8,9 @@
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFFont.h"
+#include "SkPDFFormXObject.h"
 #include "SkPDFShader.h"
+#include "SkPDFStream.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -23,10 +25,20 @@ void SkPDFCanon::reset() {
     fAlphaShaderRecords.reset();
     fImageShaderRecords.unrefAll();
     fImageShaderRecords.reset();
+    fFunctionRecords.foreach ([](const SkString&, SkPDFStream** function) {
+        (*function)->unref();
+    });
+    fFunctionRecords.reset();
     fGraphicStateRecords.foreach ([](WrapGS w) { w.fPtr->unref(); });
     fGraphicStateRecords.reset();
     fBitmapRecords.unrefAll();
     fBitmapRecords.reset();
+    fScaledBitmapRecords.reset();
+    fPictureRecords.foreach ([](uint32_t, PictureRec* rec) {
+        SkSafeUnref(rec->fForm);
+        SkDELETE(rec->fGlyphUsage);
+    });
+    fPictureRecords.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,6 +61,7 @@ T* find_item(const SkTDArray<T*>& ptrArray, const U& object) {
 SkPDFFont* SkPDFCanon::findFont(uint32_t fontID,
                                 uint16_t glyphID,
                                 SkPDFFont** relatedFontPtr) const {
+    SkAutoMutexAcquire lock(fMutex);
     SkASSERT(relatedFontPtr);
 
     SkPDFFont* relatedFont = NULL;
@@ -67,6 +80,7 @@ SkPDFFont* SkPDFCanon::findFont(uint32_t fontID,
 }
 
 void SkPDFCanon::addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID) {
+    SkAutoMutexAcquire lock(fMutex);
     SkPDFCanon::FontRec* rec = fFontRecords.push();
     rec->fFont = SkRef(font);
     rec->fFontID = fontID;
@@ -77,9 +91,11 @@ void SkPDFCanon::addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID) {
 
 SkPDFFunctionShader* SkPDFCanon::findFunctionShader(
         const SkPDFShader::State& state) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fFunctionShaderRecords, state);
 }
 void SkPDFCanon::addFunctionShader(SkPDFFunctionShader* pdfShader) {
+    SkAutoMutexAcquire lock(fMutex);
     fFunctionShaderRecords.push(SkRef(pdfShader));
 }
 
@@ -87,9 +103,11 @@ void SkPDFCanon::addFunctionShader(SkPDFFunctionShader* pdfShader) {
 
 SkPDFAlphaFunctionShader* SkPDFCanon::findAlphaShader(
         const SkPDFShader::State& state) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fAlphaShaderRecords, state);
 }
 void SkPDFCanon::addAlphaShader(SkPDFAlphaFunctionShader* pdfShader) {
+    SkAutoMutexAcquire lock(fMutex);
     fAlphaShaderRecords.push(SkRef(pdfShader));
 }
 
@@ -97,34 +115,104 @@ void SkPDFCanon::addAlphaShader(SkPDFAlphaFunctionShader* pdfShader) {
 
 SkPDFImageShader* SkPDFCanon::findImageShader(
         const SkPDFShader::State& state) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fImageShaderRecords, state);
 }
 
 void SkPDFCanon::addImageShader(SkPDFImageShader* pdfShader) {
+    SkAutoMutexAcquire lock(fMutex);
     fImageShaderRecords.push(SkRef(pdfShader));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+SkPDFStream* SkPDFCanon::findFunction(const SkString& psCode) const {
+    SkAutoMutexAcquire lock(fMutex);
+    SkPDFStream* const* function = fFunctionRecords.find(psCode);
+    return function ? *function : NULL;
+}
+
+void SkPDFCanon::addFunction(const SkString& psCode, SkPDFStream* function) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (!fFunctionRecords.find(psCode)) {  // Another thread may have beaten us to it.
+        fFunctionRecords.set(psCode, SkRef(function));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 const SkPDFGraphicState* SkPDFCanon::findGraphicState(
         const SkPDFGraphicState& key) const {
+    SkAutoMutexAcquire lock(fMutex);
     const WrapGS* ptr = fGraphicStateRecords.find(WrapGS(&key));
     return ptr ? ptr->fPtr : NULL;
 }
 
 void SkPDFCanon::addGraphicState(const SkPDFGraphicState* state) {
     SkASSERT(state);
-    WrapGS w(SkRef(state));
-    SkASSERT(!fGraphicStateRecords.contains(w));
-    fGraphicStateRecords.add(w);
+    SkAutoMutexAcquire lock(fMutex);
+    WrapGS w(state);
+    if (!fGraphicStateRecords.contains(w)) {  // Another thread may have beaten us to it.
+        SkRef(state);
+        fGraphicStateRecords.add(w);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFBitmap* SkPDFCanon::findBitmap(const SkBitmap& bm) const {
+    SkAutoMutexAcquire lock(fMutex);
     return find_item(fBitmapRecords, bm);
 }
 
 void SkPDFCanon::addBitmap(SkPDFBitmap* pdfBitmap) {
+    SkAutoMutexAcquire lock(fMutex);
     fBitmapRecords.push(SkRef(pdfBitmap));
 }
+
+bool SkPDFCanon::findScaledBitmap(const SkBitmap& src, const SkISize& size,
+                                  SkBitmap* scaled) const {
+    SkAutoMutexAcquire lock(fMutex);
+    for (int i = 0; i < fScaledBitmapRecords.count(); ++i) {
+        const ScaledBitmapRec& rec = fScaledBitmapRecords[i];
+        if (rec.fGenID == src.getGenerationID() &&
+            rec.fOrigin == src.pixelRefOrigin() &&
+            rec.fSrcSize == src.dimensions() &&
+            rec.fScaled.dimensions() == size) {
+            *scaled = rec.fScaled;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SkPDFCanon::addScaledBitmap(const SkBitmap& src, const SkBitmap& scaled) {
+    SkAutoMutexAcquire lock(fMutex);
+    ScaledBitmapRec& rec = fScaledBitmapRecords.push_back();
+    rec.fGenID = src.getGenerationID();
+    rec.fOrigin = src.pixelRefOrigin();
+    rec.fSrcSize = src.dimensions();
+    rec.fScaled = scaled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool SkPDFCanon::findPicture(uint32_t pictureID, PictureRec* rec) const {
+    SkAutoMutexAcquire lock(fMutex);
+    if (const PictureRec* found = fPictureRecords.find(pictureID)) {
+        *rec = *found;
+        return true;
+    }
+    return false;
+}
+
+void SkPDFCanon::addPicture(uint32_t pictureID, SkPDFFormXObject* form,
+                            SkPDFGlyphSetMap* glyphUsage, bool blendsWithDst) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (fPictureRecords.find(pictureID)) {  // Another thread may have beaten us to it.
+        SkDELETE(glyphUsage);
+        return;
+    }
+    PictureRec rec = { SkSafeRef(form), glyphUsage, blendsWithDst };
+    fPictureRecords.set(pictureID, rec);
+}
@@ -7,26 +7,37 @@
 #ifndef SkPDFCanon_DEFINED
 #define SkPDFCanon_DEFINED
 
+#include "SkBitmap.h"
+#include "SkChecksum.h"
 #include "SkPDFGraphicState.h"
 #include "SkPDFShader.h"
+#include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTHash.h"
+#include "SkThread.h"
 
-class SkBitmap;
 class SkPDFFont;
 class SkPDFBitmap;
+class SkPDFFormXObject;
+class SkPDFGlyphSetMap;
+class SkPDFStream;
 class SkPaint;
 
 /**
  *  The SkPDFCanon canonicalizes objects across PDF pages(SkPDFDevices).
  *
  *  The PDF backend works correctly if:
- *  -  There is no more than one SkPDFCanon for each thread.
  *  -  Every SkPDFDevice is given a pointer to a SkPDFCanon on creation.
  *  -  All SkPDFDevices in a document share the same SkPDFCanon.
  *  The SkDocument_PDF class makes this happen by owning a single
  *  SkPDFCanon.
  *
+ *  Devices on different threads may share a canon.  Each find and add is
+ *  atomic, but two threads can both miss and then add equal objects; the
+ *  second addPicture() or addGraphicState() is ignored, and the other adds
+ *  just keep both, which only costs some sharing.  reset() must not race
+ *  with anything.
+ *
  *  The addFoo() methods will ref the Foo; the canon's destructor will
  *  call foo->unref() on all of these objects.
  *
@@ -35,8 +46,15 @@ class SkPaint;
  */
 class SkPDFCanon : SkNoncopyable {
 public:
+    SkPDFCanon() : fMaxImageDpi(0) {}
     ~SkPDFCanon() { this->reset(); }
 
+    // Bitmaps that would be embedded with more than this many pixels per
+    // inch on the page are resampled down to it first; zero (the default)
+    // embeds every pixel.  Set this before any device draws.
+    void setMaxImageDpi(SkScalar dpi) { fMaxImageDpi = dpi; }
+    SkScalar maxImageDpi() const { return fMaxImageDpi; }
+
     // reset to original setting, unrefs all objects.
     void reset();
 
@@ -48,6 +66,16 @@ public:
                         SkPDFFont** relatedFont) const;
     void addFont(SkPDFFont* font, uint32_t fontID, uint16_t fGlyphID);
 
+    // Every font added so far, in the order they were added.
+    int fontCount() const {
+        SkAutoMutexAcquire lock(fMutex);
+        return fFontRecords.count();
+    }
+    SkPDFFont* fontAt(int index) const {
+        SkAutoMutexAcquire lock(fMutex);
+        return fFontRecords[index].fFont;
+    }
+
     SkPDFFunctionShader* findFunctionShader(const SkPDFShader::State&) const;
     void addFunctionShader(SkPDFFunctionShader*);
 
@@ -57,13 +85,46 @@ public:
     SkPDFImageShader* findImageShader(const SkPDFShader::State&) const;
     void addImageShader(SkPDFImageShader*);
 
+    // PostScript functions of gradients, by their code.
+    SkPDFStream* findFunction(const SkString& psCode) const;
+    void addFunction(const SkString& psCode, SkPDFStream*);
+
     const SkPDFGraphicState* findGraphicState(const SkPDFGraphicState&) const;
     void addGraphicState(const SkPDFGraphicState*);
 
     SkPDFBitmap* findBitmap(const SkBitmap&) const;
     void addBitmap(SkPDFBitmap*);
 
+    // Keeping the resampled copies of bitmaps lets every draw of a bitmap
+    // at the same size share one SkPDFBitmap.
+    bool findScaledBitmap(const SkBitmap& src, const SkISize& size,
+                          SkBitmap* scaled) const;
+    void addScaledBitmap(const SkBitmap& src, const SkBitmap& scaled);
+
+    // A picture recorded once as a form XObject, to be drawn on every page
+    // that draws the picture.
+    struct PictureRec {
+        // NULL if the picture can't be drawn as a form (e.g. it has links).
+        SkPDFFormXObject* fForm;
+        // The glyphs the form uses, for the pages that draw it.
+        SkPDFGlyphSetMap* fGlyphUsage;
+        // The picture blends with what is under it (e.g. with kClear_Mode),
+        // so the isolated form only matches it when drawn in a layer.
+        bool fBlendsWithDst;
+    };
+    // Copies the picture's record into *rec, if there is one.  Its objects
+    // stay alive until reset().
+    bool findPicture(uint32_t pictureID, PictureRec* rec) const;
+    // Takes ownership of glyphUsage.
+    void addPicture(uint32_t pictureID, SkPDFFormXObject* form,
+                    SkPDFGlyphSetMap* glyphUsage, bool blendsWithDst);
+
 private:
+    SkScalar fMaxImageDpi;
+
+    // Guards everything below.
+    mutable SkMutex fMutex;
+
     struct FontRec {
         SkPDFFont* fFont;
         uint32_t fFontID;
@@ -77,6 +138,11 @@ private:
 
     SkTDArray<SkPDFImageShader*> fImageShaderRecords;
 
+    static uint32_t HashCode(const SkString& code) {
+        return SkChecksum::Murmur3(code.c_str(), code.size());
+    }
+    SkTHashMap<SkString, SkPDFStream*, HashCode> fFunctionRecords;
+
     struct WrapGS {
         explicit WrapGS(const SkPDFGraphicState* ptr = NULL) : fPtr(ptr) {}
         const SkPDFGraphicState* fPtr;
@@ -93,5 +159,15 @@ private:
     SkTHashSet<WrapGS, WrapGS::Hash> fGraphicStateRecords;
 
     SkTDArray<SkPDFBitmap*> fBitmapRecords;
+
+    struct ScaledBitmapRec {
+        uint32_t fGenID;
+        SkIPoint fOrigin;
+        SkISize fSrcSize;
+        SkBitmap fScaled;
+    };
+    SkTArray<ScaledBitmapRec> fScaledBitmapRecords;
+
+    SkTHashMap<uint32_t, PictureRec> fPictureRecords;
 };
 #endif  // SkPDFCanon_DEFINED
@@ -9,6 +9,7 @@
 
 #include "SkAnnotation.h"
 #include "SkBitmapDevice.h"
+#include "SkBitmapScaler.h"
 #include "SkColor.h"
 #include "SkClipStack.h"
 #include "SkData.h"
@@ -18,6 +19,7 @@
 #include "SkPath.h"
 #include "SkPathOps.h"
 #include "SkPDFBitmap.h"
+#include "SkPDFCanon.h"
 #include "SkPDFFont.h"
 #include "SkPDFFormXObject.h"
 #include "SkPDFGraphicState.h"
@@ -711,7 +713,8 @@ SkPDFDevice::SkPDFDevice(SkISize pageSize,
     , fClipStack(NULL)
     , fFontGlyphUsage(SkNEW(SkPDFGlyphSetMap))
     , fRasterDpi(rasterDpi)
-    , fCanon(canon) {
+    , fCanon(canon)
+    , fBlendsWithDst(false) {
     SkASSERT(pageSize.width() > 0);
     SkASSERT(pageSize.height() > 0);
     fLegacyBitmap.setInfo(
@@ -1195,6 +1198,80 @@ void SkPDFDevice::drawDevice(const SkDraw& d, SkBaseDevice* device,
     fFontGlyphUsage->merge(pdfDevice->getFontGlyphUsage());
 }
 
+bool SkPDFDevice::EXPERIMENTAL_drawPicture(SkCanvas* canvas,
+                                           const SkPicture* picture,
+                                           const SkMatrix* matrix,
+                                           const SkPaint* paint) {
+    // Layers not at the origin, draw filters, perspective and image filters
+    // are left to the canvas to play back.
+    if (!fCanon || !this->getOrigin().isZero() || canvas->getDrawFilter() ||
+        canvas->getTotalMatrix().hasPerspective() ||
+        (matrix && matrix->hasPerspective()) ||
+        (paint && not_supported_for_layers(*paint))) {
+        return false;
+    }
+    const SkIRect bounds = picture->cullRect().roundOut();
+    if (bounds.isEmpty()) {
+        return false;
+    }
+
+    SkPDFCanon::PictureRec rec;
+    if (!fCanon->findPicture(picture->uniqueID(), &rec)) {
+        SkAutoTUnref<SkPDFDevice> device(SkPDFDevice::Create(
+                bounds.size(), fRasterDpi, fCanon));
+        {
+            SkCanvas formCanvas(device.get());
+            formCanvas.translate(-SkIntToScalar(bounds.left()),
+                                 -SkIntToScalar(bounds.top()));
+            picture->playback(&formCanvas);
+        }
+        // Links and destinations belong to pages, so they can't go in a form.
+        SkPDFFormXObject* form = NULL;
+        if (!device->fAnnotations && device->fNamedDestinations.isEmpty()) {
+            form = SkNEW_ARGS(SkPDFFormXObject, (device.get()));
+        }
+        SkPDFGlyphSetMap* glyphUsage = SkNEW(SkPDFGlyphSetMap);
+        glyphUsage->merge(device->getFontGlyphUsage());
+        fCanon->addPicture(picture->uniqueID(), form, glyphUsage, device->fBlendsWithDst);
+        SkSafeUnref(form);
+        SkAssertResult(fCanon->findPicture(picture->uniqueID(), &rec));
+    }
+    // Without a paint the canvas would draw the picture straight onto the
+    // page, not into an isolated layer like the form.
+    if (!rec.fForm || (!paint && rec.fBlendsWithDst)) {
+        return false;
+    }
+
+    SkMatrix formMatrix = canvas->getTotalMatrix();
+    if (matrix) {
+        formMatrix.preConcat(*matrix);
+    }
+    formMatrix.preTranslate(SkIntToScalar(bounds.left()), SkIntToScalar(bounds.top()));
+
+    SkPaint defaultPaint;
+    ScopedContentEntry content(this, canvas->getClipStack(),
+                               canvas->internal_private_getTotalClip(),
+                               formMatrix, paint ? *paint : defaultPaint);
+    if (!content.entry()) {
+        return true;
+    }
+    if (content.needShape()) {
+        SkPath shape;
+        shape.addRect(SkRect::MakeWH(SkIntToScalar(bounds.width()),
+                                     SkIntToScalar(bounds.height())));
+        shape.transform(formMatrix);
+        content.setShape(shape);
+    }
+    if (!content.needSource()) {
+        return true;
+    }
+
+    SkPDFUtils::DrawFormXObject(this->addXObjectResource(rec.fForm),
+                                &content.entry()->fContent);
+    fFontGlyphUsage->merge(*rec.fGlyphUsage);
+    return true;
+}
+
 SkImageInfo SkPDFDevice::imageInfo() const {
     return fLegacyBitmap.info();
 }
@@ -1634,6 +1711,7 @@ ContentEntry* SkPDFDevice::setUpContentEntry(const SkClipStack* clipStack,
             xfermode == SkXfermode::kSrcATop_Mode ||
             xfermode == SkXfermode::kDstATop_Mode ||
             xfermode == SkXfermode::kModulate_Mode) {
+        fBlendsWithDst = true;
         if (!isContentEmpty()) {
             *dst = createFormXObjectFromDevice();
             SkASSERT(isContentEmpty());
@@ -1994,6 +2072,48 @@ int SkPDFDevice::getFontResourceIndex(SkTypeface* typeface, uint16_t glyphID) {
     return resourceIndex;
 }
 
+// Resamples bitmap, if drawing it with matrix would embed more than maxDpi
+// pixels per inch.  Copies of a bitmap resampled to the same size are shared
+// through the canon, so they are embedded once.
+static bool downsample_bitmap(SkPDFCanon* canon, const SkMatrix& matrix,
+                              const SkBitmap& bitmap, SkBitmap* result) {
+    const SkScalar maxDpi = canon ? canon->maxImageDpi() : 0;
+    if (maxDpi <= 0 || bitmap.drawsNothing()) {
+        return false;
+    }
+    // One point of the device is 1/DPI_FOR_RASTER_SCALE_ONE inches.
+    SkVector axes[2] = { SkVector::Make(SK_Scalar1, 0), SkVector::Make(0, SK_Scalar1) };
+    matrix.mapVectors(axes, 2);
+    const SkScalar pixelsPerPoint = maxDpi / DPI_FOR_RASTER_SCALE_ONE;
+    const SkISize size = SkISize::Make(
+            SkTMax(1, SkScalarCeilToInt(bitmap.width() * axes[0].length() * pixelsPerPoint)),
+            SkTMax(1, SkScalarCeilToInt(bitmap.height() * axes[1].length() * pixelsPerPoint)));
+    if (size.width() >= bitmap.width() && size.height() >= bitmap.height()) {
+        return false;
+    }
+    const SkISize scaledSize = SkISize::Make(SkTMin(size.width(), bitmap.width()),
+                                             SkTMin(size.height(), bitmap.height()));
+    if (canon->findScaledBitmap(bitmap, scaledSize, result)) {
+        return true;
+    }
+    SkBitmap n32;
+    const SkBitmap* source = &bitmap;
+    if (kN32_SkColorType != bitmap.colorType()) {
+        if (!bitmap.copyTo(&n32, kN32_SkColorType)) {
+            return false;
+        }
+        source = &n32;
+    }
+    if (!SkBitmapScaler::Resize(result, *source, SkBitmapScaler::RESIZE_BEST,
+                                SkIntToScalar(scaledSize.width()),
+                                SkIntToScalar(scaledSize.height()))) {
+        return false;
+    }
+    result->setImmutable();
+    canon->addScaledBitmap(bitmap, *result);
+    return true;
+}
+
 void SkPDFDevice::internalDrawBitmap(const SkMatrix& origMatrix,
                                      const SkClipStack* clipStack,
                                      const SkRegion& origClipRegion,
@@ -2102,6 +2222,14 @@ void SkPDFDevice::internalDrawBitmap(const SkMatrix& origMatrix,
         bitmap = &perspectiveBitmap;
     }
 
+    SkBitmap downsampledBitmap;
+    if (!srcRect && downsample_bitmap(fCanon, matrix, *bitmap, &downsampledBitmap)) {
+        // Draw the smaller bitmap over the same area of the page.
+        matrix.preScale(SkIntToScalar(bitmap->width()) / downsampledBitmap.width(),
+                        SkIntToScalar(bitmap->height()) / downsampledBitmap.height());
+        bitmap = &downsampledBitmap;
+    }
+
     SkMatrix scaled;
     // Adjust for origin flip.
     scaled.setScale(SK_Scalar1, -SK_Scalar1);
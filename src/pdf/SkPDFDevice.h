@@ -115,6 +115,13 @@ public:
     void drawDevice(const SkDraw&, SkBaseDevice*, int x, int y,
                     const SkPaint&) override;
 
+    /** Draws each picture as a form XObject, recorded the first time the
+     *  document draws it, so a picture repeated on many pages is written
+     *  only once.
+     */
+    bool EXPERIMENTAL_drawPicture(SkCanvas*, const SkPicture*, const SkMatrix*,
+                                  const SkPaint*) override;
+
     void onAttachToCanvas(SkCanvas* canvas) override;
     void onDetachFromCanvas() override;
     SkImageInfo imageInfo() const override;
@@ -227,6 +234,10 @@ private:
     SkBitmap fLegacyBitmap;
 
     SkPDFCanon* fCanon;  // Owned by SkDocument_PDF
+
+    // Set once anything on this device is drawn with an xfermode that needs
+    // what is already there (see setUpContentEntry()).
+    bool fBlendsWithDst;
     ////////////////////////////////////////////////////////////////////////////
 
     SkPDFDevice(SkISize pageSize,
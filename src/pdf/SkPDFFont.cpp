@@ -14,6 +14,7 @@
 #include "SkPDFDevice.h"
 #include "SkPDFFont.h"
 #include "SkPDFFontImpl.h"
+#include "SkPDFFontSubsetCache.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
@@ -590,6 +591,17 @@ static size_t get_subset_font_stream(const char* fontName,
                                      const SkTypeface* typeface,
                                      const SkTDArray<uint32_t>& subset,
                                      SkPDFStream** fontStream) {
+#if defined (SK_SFNTLY_SUBSETTER)
+    // Documents that use the same glyphs of a font share its subset.
+    if (SkData* cachedSubset =
+            SkPDFFontSubsetCache::FindAndRef(typeface->uniqueID(), subset)) {
+        *fontStream = new SkPDFStream(cachedSubset);
+        size_t cachedSize = cachedSubset->size();
+        cachedSubset->unref();
+        return cachedSize;
+    }
+#endif
+
     int ttcIndex;
     SkAutoTDelete<SkStream> fontData(typeface->openStream(&ttcIndex));
     SkASSERT(fontData.get());
@@ -618,6 +630,7 @@ static size_t get_subset_font_stream(const char* fontName,
                                                      subsetFontSize,
                                                      sk_delete_array,
                                                      NULL));
+            SkPDFFontSubsetCache::Add(typeface->uniqueID(), subset, data.get());
             subsetFontStream = new SkPDFStream(data.get());
             fontSize = subsetFontSize;
         }
@@ -641,17 +654,22 @@ static size_t get_subset_font_stream(const char* fontName,
 // class SkPDFGlyphSet
 ///////////////////////////////////////////////////////////////////////////////
 
-SkPDFGlyphSet::SkPDFGlyphSet() : fBitSet(SK_MaxU16 + 1) {
+SkPDFGlyphSet::SkPDFGlyphSet(int glyphCount)
+    : fBitSet(glyphCount)
+    , fGlyphCount(glyphCount) {
 }
 
 void SkPDFGlyphSet::set(const uint16_t* glyphIDs, int numGlyphs) {
     for (int i = 0; i < numGlyphs; ++i) {
-        fBitSet.setBit(glyphIDs[i], true);
+        // IDs the font doesn't have can't be subset, so they needn't be kept.
+        if (glyphIDs[i] < fGlyphCount) {
+            fBitSet.setBit(glyphIDs[i], true);
+        }
     }
 }
 
 bool SkPDFGlyphSet::has(uint16_t glyphID) const {
-    return fBitSet.isBitSet(glyphID);
+    return glyphID < fGlyphCount && fBitSet.isBitSet(glyphID);
 }
 
 void SkPDFGlyphSet::merge(const SkPDFGlyphSet& usage) {
@@ -726,7 +744,7 @@ SkPDFGlyphSet* SkPDFGlyphSetMap::getGlyphSetForFont(SkPDFFont* font) {
     fMap.append();
     index = fMap.count() - 1;
     fMap[index].fFont = font;
-    fMap[index].fGlyphSet = new SkPDFGlyphSet();
+    fMap[index].fGlyphSet = new SkPDFGlyphSet(font->glyphUsageCount());
     return fMap[index].fGlyphSet;
 }
 
@@ -774,6 +792,11 @@ bool SkPDFFont::canSubset() const {
             SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag) == 0;
 }
 
+int SkPDFFont::glyphUsageCount() const {
+    // Single byte encodings use codes below 256.
+    return SkTMax(fLastGlyphID + 1, 256);
+}
+
 bool SkPDFFont::hasGlyph(uint16_t id) {
     return (id >= fFirstGlyphID && id <= fLastGlyphID) || id == 0;
 }
@@ -23,7 +23,8 @@ class SkPDFFont;
 
 class SkPDFGlyphSet : SkNoncopyable {
 public:
-    SkPDFGlyphSet();
+    // Glyph IDs at or above glyphCount are ignored.
+    explicit SkPDFGlyphSet(int glyphCount = SK_MaxU16 + 1);
 
     void set(const uint16_t* glyphIDs, int numGlyphs);
     bool has(uint16_t glyphID) const;
@@ -32,6 +33,7 @@ public:
 
 private:
     SkBitSet fBitSet;
+    int fGlyphCount;
 };
 
 class SkPDFGlyphSetMap : SkNoncopyable {
@@ -108,6 +110,11 @@ public:
      */
     bool hasGlyph(uint16_t glyphID);
 
+    /** Returns the size of a SkPDFGlyphSet that can hold every value
+     *  glyphsToPDFFontEncoding() produces for this font.
+     */
+    int glyphUsageCount() const;
+
     /** Convert (in place) the input glyph IDs into the font encoding.  If the
      *  font has more glyphs than can be encoded (like a type 1 font with more
      *  than 255 glyphs) this method only converts up to the first out of range
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkPDFFontSubsetCache.h"
+#include "SkResourceCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gFontSubsetKeyNamespaceLabel;
+
+// Shared by every subset of one typeface, so all of them can be purged together.
+static uint64_t make_shared_id(uint32_t fontID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 's', 'u', 'b');
+    return (sharedID << 32) | fontID;
+}
+
+// The key holds every glyph ID, so its size depends on the glyph count: it is
+// the Key, then the font ID, the glyph count, and the glyph IDs as uint16_t,
+// padded to a multiple of 4 bytes.
+class FontSubsetKey : SkNoncopyable {
+public:
+    FontSubsetKey(uint32_t fontID, const SkTDArray<uint32_t>& glyphIDs) {
+        const size_t length = 2 * sizeof(uint32_t) +
+                              SkAlign4(glyphIDs.count() * sizeof(uint16_t));
+        fSize = sizeof(SkResourceCache::Key) + length;
+        SkResourceCache::Key* key =
+                static_cast<SkResourceCache::Key*>(fStorage.reset(fSize));
+        uint32_t* contents = static_cast<uint32_t*>(key->writableContents());
+        // Zero the padding, which is part of the key.
+        contents[(length >> 2) - 1] = 0;
+        contents[0] = fontID;
+        contents[1] = glyphIDs.count();
+        uint16_t* glyphs = reinterpret_cast<uint16_t*>(contents + 2);
+        for (int i = 0; i < glyphIDs.count(); ++i) {
+            SkASSERT(glyphIDs[i] <= SK_MaxU16);
+            glyphs[i] = SkToU16(glyphIDs[i]);
+        }
+        key->init(&gFontSubsetKeyNamespaceLabel, make_shared_id(fontID), length);
+    }
+
+    const SkResourceCache::Key& get() const {
+        return *static_cast<const SkResourceCache::Key*>(fStorage.get());
+    }
+    size_t size() const { return fSize; }
+
+private:
+    SkAutoSMalloc<256> fStorage;
+    size_t fSize;
+};
+
+struct FontSubsetRec : public SkResourceCache::Rec {
+    FontSubsetRec(const FontSubsetKey& key, SkData* subset)
+        : fKeyStorage(key.size())
+        , fKeySize(key.size())
+        , fSubset(SkRef(subset))
+    {
+        memcpy(fKeyStorage.get(), &key.get(), key.size());
+    }
+
+    SkAutoMalloc         fKeyStorage;
+    size_t               fKeySize;
+    SkAutoTUnref<SkData> fSubset;
+
+    const Key& getKey() const override {
+        return *static_cast<const Key*>(fKeyStorage.get());
+    }
+    const char* getCategory() const override { return "pdf-font-subset"; }
+    size_t bytesUsed() const override { return sizeof(*this) + fKeySize + fSubset->size(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const FontSubsetRec& rec = static_cast<const FontSubsetRec&>(baseRec);
+        SkData** result = static_cast<SkData**>(contextData);
+
+        *result = SkRef(rec.fSubset.get());
+        return true;
+    }
+};
+} // namespace
+
+SkData* SkPDFFontSubsetCache::FindAndRef(uint32_t fontID, const SkTDArray<uint32_t>& glyphIDs,
+                                         SkResourceCache* localCache) {
+    FontSubsetKey key(fontID, glyphIDs);
+    SkData* subset = NULL;
+    if (!CHECK_LOCAL(localCache, find, Find, key.get(), FontSubsetRec::Visitor, &subset)) {
+        return NULL;
+    }
+    return subset;
+}
+
+void SkPDFFontSubsetCache::Add(uint32_t fontID, const SkTDArray<uint32_t>& glyphIDs,
+                               SkData* subset, SkResourceCache* localCache) {
+    FontSubsetKey key(fontID, glyphIDs);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(FontSubsetRec, (key, subset)));
+}
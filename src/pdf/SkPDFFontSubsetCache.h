@@ -0,0 +1,39 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPDFFontSubsetCache_DEFINED
+#define SkPDFFontSubsetCache_DEFINED
+
+#include "SkTDArray.h"
+
+class SkData;
+class SkResourceCache;
+
+/**
+ *  Remembers the font files made by subsetting a typeface to a set of glyphs,
+ *  so documents that use the same fonts for the same glyphs don't subset them
+ *  again.  The key is the typeface's unique ID and the glyph IDs, in the
+ *  sorted order SkPDFGlyphSet::exportTo() gives them.  Entries live in the
+ *  SkResourceCache, so they share its budget and are purged with it.
+ */
+class SkPDFFontSubsetCache {
+public:
+    /**
+     *  If the subset is cached, return its font data, which the caller must
+     *  unref.  Otherwise return NULL.
+     */
+    static SkData* FindAndRef(uint32_t fontID, const SkTDArray<uint32_t>& glyphIDs,
+                              SkResourceCache* localCache = NULL);
+
+    /**
+     *  Add the font data for a subset to the cache.
+     */
+    static void Add(uint32_t fontID, const SkTDArray<uint32_t>& glyphIDs, SkData* subset,
+                    SkResourceCache* localCache = NULL);
+};
+
+#endif
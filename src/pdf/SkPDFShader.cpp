@@ -746,11 +746,27 @@ SkPDFObject* create_range_object() {
     return range;
 }
 
+// A function's domain only needs to cover its shading's.  Functions given this
+// one instead can be shared by every shading that uses the same code.
+static const int kSharedDomainLimit = 32767;
+
+SkPDFArray* create_shared_domain_object() {
+    SkPDFArray* domain = SkNEW(SkPDFArray);
+    domain->reserve(4);
+    domain->appendInt(-kSharedDomainLimit);
+    domain->appendInt(kSharedDomainLimit);
+    domain->appendInt(-kSharedDomainLimit);
+    domain->appendInt(kSharedDomainLimit);
+    return domain;
+}
+
 template <typename T> void unref(T* ptr) { ptr->unref();}
 }  // namespace
 
 SK_DECLARE_STATIC_LAZY_PTR(SkPDFObject, rangeObject,
                            create_range_object, unref<SkPDFObject>);
+SK_DECLARE_STATIC_LAZY_PTR(SkPDFArray, sharedDomainObject,
+                           create_shared_domain_object, unref<SkPDFArray>);
 
 static SkPDFStream* make_ps_function(const SkString& psCode,
                                      SkPDFArray* domain) {
@@ -876,9 +892,22 @@ SkPDFFunctionShader* SkPDFFunctionShader::Create(
     pdfShader->insertName("ColorSpace", "DeviceRGB");
     pdfShader->insert("Domain", domain.get());
 
+    // The code depends only on the gradient and how it maps to the unit
+    // gradient, not on where it is drawn, so repeated gradients share it.
+    const SkRect sharedDomain = SkRect::MakeLTRB(
+            -SkIntToScalar(kSharedDomainLimit), -SkIntToScalar(kSharedDomainLimit),
+            SkIntToScalar(kSharedDomainLimit), SkIntToScalar(kSharedDomainLimit));
+    const bool shareable = sharedDomain.contains(bbox);
     SkAutoTUnref<SkPDFStream> function(
-            make_ps_function(functionCode, domain.get()));
-    pdfShader->insert("Function", new SkPDFObjRef(function))->unref();
+            shareable ? SkSafeRef(canon->findFunction(functionCode)) : NULL);
+    if (!function.get()) {
+        function.reset(make_ps_function(
+                functionCode, shareable ? sharedDomainObject.get() : domain.get()));
+        if (shareable) {
+            canon->addFunction(functionCode, function.get());
+        }
+    }
+    pdfShader->insert("Function", new SkPDFObjRef(function.get()))->unref();
 
     SkAutoTUnref<SkPDFArray> matrixArray(
             SkPDFUtils::MatrixToArray(finalMatrix));
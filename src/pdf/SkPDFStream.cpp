@@ -26,22 +26,7 @@ SkPDFStream::~SkPDFStream() {}
 void SkPDFStream::emitObject(SkWStream* stream,
                              const SkPDFObjNumMap& objNumMap,
                              const SkPDFSubstituteMap& substitutes) {
-    if (fState == kUnused_State) {
-        fState = kNoCompression_State;
-        SkDynamicMemoryWStream compressedData;
-
-        SkAssertResult(
-                SkFlate::Deflate(fDataStream.get(), &compressedData));
-        SkAssertResult(fDataStream->rewind());
-        if (compressedData.getOffset() < this->dataSize()) {
-            SkAutoTDelete<SkStream> compressed(
-                    compressedData.detachAsStream());
-            this->setData(compressed.get());
-            this->insertName("Filter", "FlateDecode");
-        }
-        fState = kCompressed_State;
-        this->insertInt("Length", this->dataSize());
-    }
+    this->compress();
     this->INHERITED::emitObject(stream, objNumMap, substitutes);
     stream->writeText(" stream\n");
     stream->writeStream(fDataStream.get(), fDataStream->getLength());
@@ -49,8 +34,33 @@ void SkPDFStream::emitObject(SkWStream* stream,
     stream->writeText("\nendstream");
 }
 
+void SkPDFStream::compress() {
+    if (fState != kUnused_State) {
+        return;
+    }
+    fState = kNoCompression_State;
+    SkDynamicMemoryWStream compressedData;
+
+    SkAssertResult(
+            SkFlate::Deflate(fDataStream.get(), &compressedData));
+    SkAssertResult(fDataStream->rewind());
+    if (compressedData.getOffset() < this->dataSize()) {
+        SkAutoTDelete<SkStream> compressed(
+                compressedData.detachAsStream());
+        this->setData(compressed.get());
+        this->insertName("Filter", "FlateDecode");
+    }
+    fState = kCompressed_State;
+    this->insertInt("Length", this->dataSize());
+}
+
 SkPDFStream::SkPDFStream() : fState(kUnused_State) {}
 
+void SkPDFStream::drop() {
+    this->INHERITED::drop();
+    fDataStream.free();
+}
+
 void SkPDFStream::setData(SkData* data) {
     // FIXME: Don't swap if the data is the same.
     fDataStream.reset(SkNEW_ARGS(SkMemoryStream, (data)));
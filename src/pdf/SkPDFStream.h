@@ -43,6 +43,8 @@ public:
     virtual void emitObject(SkWStream* stream,
                             const SkPDFObjNumMap& objNumMap,
                             const SkPDFSubstituteMap& substitutes) override;
+    void drop() override;
+    void compress() override;
 
 protected:
     enum State {
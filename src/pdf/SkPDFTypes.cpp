@@ -253,6 +253,10 @@ SkPDFArray::~SkPDFArray() {
     fValue.unrefAll();
 }
 
+void SkPDFArray::drop() {
+    fValue.unrefAll();
+}
+
 void SkPDFArray::emitObject(SkWStream* stream,
                              const SkPDFObjNumMap& objNumMap,
                              const SkPDFSubstituteMap& substitutes) {
@@ -383,6 +387,10 @@ void SkPDFDict::insertName(const char key[], const char name[]) {
     (void)this->append(new SkPDFName(key), new SkPDFName(name));
 }
 
+void SkPDFDict::drop() {
+    this->clear();
+}
+
 void SkPDFDict::clear() {
     for (int i = 0; i < fValue.count(); i++) {
         SkASSERT(fValue[i].key);
@@ -51,6 +51,21 @@ public:
     virtual void addResources(SkPDFObjNumMap* catalog,
                               const SkPDFSubstituteMap& substitutes) const {}
 
+    /**
+     *  Frees what this object holds, once it has been emitted and nothing
+     *  else refers to it.  The object must not be emitted again; it stays
+     *  alive only so its address isn't reused while it is in a catalog.
+     */
+    virtual void drop() {}
+
+    /**
+     *  Does the slow part of emitObject() that doesn't depend on the catalog,
+     *  like deflating a stream, ahead of time.  The document calls this on
+     *  several objects at once from different threads, so it must only touch
+     *  this object.
+     */
+    virtual void compress() {}
+
 private:
     typedef SkRefCnt INHERITED;
 };
@@ -252,6 +267,7 @@ public:
                             const SkPDFSubstituteMap& substitutes) override;
     virtual void addResources(SkPDFObjNumMap*,
                               const SkPDFSubstituteMap&) const override;
+    void drop() override;
 
     /** The size of the array.
      */
@@ -327,6 +343,7 @@ public:
                             const SkPDFSubstituteMap& substitutes) override;
     virtual void addResources(SkPDFObjNumMap*,
                               const SkPDFSubstituteMap&) const override;
+    void drop() override;
 
     /** The size of the dictionary.
      */
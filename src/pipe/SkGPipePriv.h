@@ -74,6 +74,7 @@ enum DrawOps {
     kDef_Typeface_DrawOp,
     kDef_Flattenable_DrawOp,
     kDef_Bitmap_DrawOp,
+    kDef_SharedBitmap_DrawOp,
     kDef_Factory_DrawOp,
 
     // these are signals to playback, not drawing verbs
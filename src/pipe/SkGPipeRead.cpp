@@ -157,6 +157,32 @@ public:
         fReader->readBitmap(bm);
     }
 
+    /**
+     * Like addBitmap, but for a bitmap the writer passed by handle.
+     */
+    void addSharedBitmap(int index) {
+        SkASSERT(shouldFlattenBitmaps(fFlags));
+        const int width = fReader->readInt();
+        const int height = fReader->readInt();
+        const uint32_t handle = fReader->readUInt();
+        SkBitmap* bm;
+        if(fBitmaps.count() == index) {
+            bm = SkNEW(SkBitmap);
+            *fBitmaps.append() = bm;
+        } else {
+            bm = fBitmaps[index];
+        }
+        if (NULL == fImporter || !fImporter->importBitmap(handle, bm)) {
+            // Draw nothing, at the right size.
+            bm->reset();
+            bm->setInfo(SkImageInfo::MakeUnknown(width, height));
+        }
+    }
+
+    void setBitmapImporter(SkGPipeReader::BitmapImporter* importer) {
+        fImporter = importer;
+    }
+
     /**
      * Override of SkBitmapHeapReader, so that SkReadBuffer can use
      * these SkBitmaps for bitmap shaders. Used only in cross process mode
@@ -228,6 +254,8 @@ private:
     // Only used when sharing bitmaps with the writer.
     SkBitmapHeap*             fSharedHeap;
     unsigned                  fFlags;
+    // Not owned. Only used for bitmaps passed by handle.
+    SkGPipeReader::BitmapImporter* fImporter;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -755,6 +783,12 @@ static void def_Bitmap_rp(SkCanvas*, SkReader32*, uint32_t op32,
     state->addBitmap(index);
 }
 
+static void def_SharedBitmap_rp(SkCanvas*, SkReader32*, uint32_t op32,
+                                SkGPipeState* state) {
+    unsigned index = DrawOp_unpackData(op32);
+    state->addSharedBitmap(index);
+}
+
 static void def_Factory_rp(SkCanvas*, SkReader32* reader, uint32_t,
                            SkGPipeState* state) {
     state->defFactory(reader->readString());
@@ -824,6 +858,7 @@ static const ReadProc gReadTable[] = {
     def_Typeface_rp,
     def_PaintFlat_rp,
     def_Bitmap_rp,
+    def_SharedBitmap_rp,
     def_Factory_rp,
 
     reportFlags_rp,
@@ -837,7 +872,8 @@ SkGPipeState::SkGPipeState()
     : fReader(0)
     , fSilent(false)
     , fSharedHeap(NULL)
-    , fFlags(0) {
+    , fFlags(0)
+    , fImporter(NULL) {
 
 }
 
@@ -856,6 +892,7 @@ SkGPipeReader::SkGPipeReader() {
     fCanvas = NULL;
     fState = NULL;
     fProc = NULL;
+    fImporter = NULL;
 }
 
 SkGPipeReader::SkGPipeReader(SkCanvas* target) {
@@ -863,6 +900,7 @@ SkGPipeReader::SkGPipeReader(SkCanvas* target) {
     this->setCanvas(target);
     fState = NULL;
     fProc = NULL;
+    fImporter = NULL;
 }
 
 void SkGPipeReader::setCanvas(SkCanvas *target) {
@@ -885,6 +923,7 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
     }
 
     fState->setSilent(playbackFlags & kSilent_PlaybackFlag);
+    fState->setBitmapImporter(fImporter);
 
     SkASSERT(SK_ARRAY_COUNT(gReadTable) == (kDone_DrawOp + 1));
 
@@ -914,7 +953,8 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
             (table[op] != paintOp_rp &&
              table[op] != def_Typeface_rp &&
              table[op] != def_PaintFlat_rp &&
-             table[op] != def_Bitmap_rp
+             table[op] != def_Bitmap_rp &&
+             table[op] != def_SharedBitmap_rp
              )) {
                 status = kReadAtom_Status;
                 break;
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGPipeRingBuffer.h"
+#include "SkAtomics.h"
+
+// The writer asks for blocks of at least 16K; make room for two.
+static const size_t kMinCapacity = 2 * (16 * 1024 + 2 * sizeof(uint32_t));
+static const size_t kMaxCapacity = 1 << 29;
+
+// Lives at the start of the memory, followed by the ring itself.
+struct SkGPipeRingBuffer::Header {
+    uint32_t fCapacity;
+    // Bytes of the ring the reader is finished with, counted over the ring's
+    // lifetime. Only the reader writes it, and only in whole records, so the
+    // bytes it covers always end at the start of the reader's current record.
+    uint32_t fRead;
+};
+
+static uint8_t* ring_data(void* memory) {
+    return static_cast<uint8_t*>(memory) + sizeof(SkGPipeRingBuffer::Header);
+}
+
+size_t SkGPipeRingBuffer::ComputeMemorySize(size_t capacity) {
+    return sizeof(Header) + SkAlign4(capacity);
+}
+
+bool SkGPipeRingBuffer::Init(void* memory, size_t memorySize) {
+    SkASSERT(SkIsAlign4(reinterpret_cast<uintptr_t>(memory)));
+    if (memorySize < sizeof(Header) + kMinCapacity) {
+        return false;
+    }
+    Header* header = static_cast<Header*>(memory);
+    const size_t capacity = (memorySize - sizeof(Header)) & ~3;
+    header->fCapacity = SkToU32(SkTMin(capacity, kMaxCapacity));
+    header->fRead = 0;
+    // The writer's first record starts the ring, empty and open.
+    *RecordWord(ring_data(memory), 0) = 0;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkGPipeRingBufferController::SkGPipeRingBufferController(void* memory)
+    : fHeader(static_cast<SkGPipeRingBuffer::Header*>(memory))
+    , fData(ring_data(memory))
+    , fUsed(sizeof(uint32_t))
+    , fRecordOffset(0)
+    , fRecordBytes(0) {
+}
+
+void* SkGPipeRingBufferController::requestBlock(size_t minRequest, size_t* actual) {
+    const uint32_t capacity = fHeader->fCapacity;
+    // Keeping every block under half the ring means a record at the start
+    // never has to wrap onto its own record word.
+    const uint32_t maxBlock = capacity / 2 - 2 * sizeof(uint32_t);
+    if (minRequest > maxBlock) {
+        return NULL;
+    }
+
+    // The next record follows this one, unless its block would not fit
+    // before the end of the ring.
+    const uint32_t next = fRecordOffset + sizeof(uint32_t) + fRecordBytes;
+    const bool wraps = capacity - next < sizeof(uint32_t) + minRequest;
+    const uint32_t padding = wraps ? capacity - next : 0;
+    const uint32_t offset = wraps ? 0 : next;
+
+    // Start the next record before closing this one, so the reader always has
+    // a record word to look at. Closing this one lets the reader free it.
+    uint32_t free;
+    do {
+        free = capacity - (fUsed - sk_atomic_load(&fHeader->fRead, sk_memory_order_acquire));
+    } while (free < padding + sizeof(uint32_t));
+    sk_atomic_store(SkGPipeRingBuffer::RecordWord(fData, offset), 0u, sk_memory_order_relaxed);
+    uint32_t closed = fRecordBytes | SkGPipeRingBuffer::kClosed_RecordFlag;
+    if (wraps) {
+        closed |= SkGPipeRingBuffer::kWraps_RecordFlag;
+    }
+    sk_atomic_store(SkGPipeRingBuffer::RecordWord(fData, fRecordOffset), closed,
+                    sk_memory_order_release);
+    fUsed += padding + sizeof(uint32_t);
+    fRecordOffset = offset;
+    fRecordBytes = 0;
+
+    // Wait for the block itself, then hand out as much as is free.
+    do {
+        free = capacity - (fUsed - sk_atomic_load(&fHeader->fRead, sk_memory_order_acquire));
+    } while (free < minRequest);
+    uint32_t size = SkTMin(free, capacity - offset - (uint32_t)sizeof(uint32_t));
+    *actual = SkTMin(size, maxBlock) & ~3;
+    return fData + offset + sizeof(uint32_t);
+}
+
+void SkGPipeRingBufferController::notifyWritten(size_t bytes) {
+    if (0 == bytes) {
+        return;
+    }
+    SkASSERT(SkIsAlign4(bytes));
+    fRecordBytes += SkToU32(bytes);
+    fUsed += SkToU32(bytes);
+    sk_atomic_store(SkGPipeRingBuffer::RecordWord(fData, fRecordOffset), fRecordBytes,
+                    sk_memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkGPipeRingBufferReader::SkGPipeRingBufferReader(void* memory, SkCanvas* target)
+    : fReader(target)
+    , fHeader(static_cast<SkGPipeRingBuffer::Header*>(memory))
+    , fData(ring_data(memory))
+    , fRecordOffset(0)
+    , fRecordBytesRead(0)
+    , fStatus(SkGPipeReader::kEOF_Status) {
+}
+
+SkGPipeReader::Status SkGPipeRingBufferReader::playback() {
+    while (SkGPipeReader::kEOF_Status == fStatus) {
+        const uint32_t record = sk_atomic_load(SkGPipeRingBuffer::RecordWord(fData, fRecordOffset),
+                                               sk_memory_order_acquire);
+        const uint32_t bytes = record & SkGPipeRingBuffer::kBytes_RecordMask;
+        if (bytes > fRecordBytesRead) {
+            fStatus = fReader.playback(fData + fRecordOffset + sizeof(uint32_t) + fRecordBytesRead,
+                                       bytes - fRecordBytesRead);
+            fRecordBytesRead = bytes;
+        }
+        if (!(record & SkGPipeRingBuffer::kClosed_RecordFlag)) {
+            break;
+        }
+
+        // Free the whole record, and any padding after it, at once.
+        const uint32_t next = fRecordOffset + sizeof(uint32_t) + bytes;
+        uint32_t released = next - fRecordOffset;
+        if (record & SkGPipeRingBuffer::kWraps_RecordFlag) {
+            released += fHeader->fCapacity - next;
+            fRecordOffset = 0;
+        } else {
+            fRecordOffset = next;
+        }
+        fRecordBytesRead = 0;
+        const uint32_t read = sk_atomic_load(&fHeader->fRead, sk_memory_order_relaxed);
+        sk_atomic_store(&fHeader->fRead, read + released, sk_memory_order_release);
+    }
+    return fStatus;
+}
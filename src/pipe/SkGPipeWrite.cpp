@@ -266,6 +266,7 @@ protected:
     void onDrawPaint(const SkPaint&) override;
     void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
     void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRects(const SkRect[], int count, const SkPaint&) override;
     void onDrawOval(const SkRect&, const SkPaint&) override;
     void onDrawRRect(const SkRRect&, const SkPaint&) override;
     void onDrawPath(const SkPath&, const SkPaint&) override;
@@ -379,6 +380,17 @@ void SkGPipeCanvas::flattenFactoryNames() {
 
 bool SkGPipeCanvas::shuttleBitmap(const SkBitmap& bm, int32_t slot) {
     SkASSERT(shouldFlattenBitmaps(fFlags));
+    uint32_t handle;
+    if (fController->exportBitmap(bm, &handle)) {
+        if (this->needOpBytes(3 * sizeof(uint32_t))) {
+            this->writeOp(kDef_SharedBitmap_DrawOp, 0, slot);
+            fWriter.write32(bm.width());
+            fWriter.write32(bm.height());
+            fWriter.write32(handle);
+            return true;
+        }
+        return false;
+    }
     SkWriteBuffer buffer;
     buffer.setNamedFactoryRecorder(fFactorySet);
     buffer.writeBitmap(bm);
@@ -708,6 +720,12 @@ void SkGPipeCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     }
 }
 
+void SkGPipeCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkGPipeCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     NOTIFY_SETUP(this);
     this->writePaint(paint);
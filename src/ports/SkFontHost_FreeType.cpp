@@ -148,9 +148,17 @@ private:
 
 struct SkFaceRec;
 
+// How many FT_Faces may stay open once nothing is using them, so that typefaces which are
+// queried again and again (table data, metrics, new scaler contexts) don't reparse their fonts.
+#ifndef SK_DEFAULT_FREETYPE_FACE_COUNT_LIMIT
+    #define SK_DEFAULT_FREETYPE_FACE_COUNT_LIMIT    8
+#endif
+
 SK_DECLARE_STATIC_MUTEX(gFTMutex);
 static FreeTypeLibrary* gFTLibrary;
-static SkFaceRec* gFaceRecHead;
+static SkFaceRec* gFaceRecHead;     // most recently used first
+static int gFaceCount;              // faces in gFaceRecHead, in use or not
+static int gFaceCountLimit = SK_DEFAULT_FREETYPE_FACE_COUNT_LIMIT;
 
 // Private to RefFreeType and UnrefFreeType
 static int gFTCount;
@@ -273,6 +281,45 @@ SkFaceRec::SkFaceRec(SkStreamAsset* stream, uint32_t fontID)
     fFTStream.close = sk_ft_stream_close;
 }
 
+// Caller must lock gFTMutex before calling this function.
+static void close_ft_face(SkFaceRec* rec, SkFaceRec* prev) {
+    gFTMutex.assertHeld();
+    SkASSERT(0 == rec->fRefCnt);
+
+    if (prev) {
+        prev->fNext = rec->fNext;
+    } else {
+        gFaceRecHead = rec->fNext;
+    }
+    --gFaceCount;
+    FT_Done_Face(rec->fFace);
+    SkDELETE(rec);
+    // Every open face keeps the library alive.
+    unref_ft_library();
+}
+
+// Close the least recently used faces nobody is using until at most limit faces are open.
+// Caller must lock gFTMutex before calling this function.
+static void purge_ft_faces(int limit) {
+    gFTMutex.assertHeld();
+
+    while (gFaceCount > limit) {
+        SkFaceRec* victim = NULL;
+        SkFaceRec* victimPrev = NULL;
+        SkFaceRec* prev = NULL;
+        for (SkFaceRec* rec = gFaceRecHead; rec; prev = rec, rec = rec->fNext) {
+            if (0 == rec->fRefCnt) {
+                victim = rec;
+                victimPrev = prev;
+            }
+        }
+        if (NULL == victim) {
+            return;     // the rest are all in use
+        }
+        close_ft_face(victim, victimPrev);
+    }
+}
+
 // Will return 0 on failure
 // Caller must lock gFTMutex before calling this function.
 static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
@@ -280,12 +327,19 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
 
     const SkFontID fontID = typeface->uniqueID();
     SkFaceRec* rec = gFaceRecHead;
+    SkFaceRec* prev = NULL;
     while (rec) {
         if (rec->fFontID == fontID) {
             SkASSERT(rec->fFace);
             rec->fRefCnt += 1;
+            if (prev) {
+                prev->fNext = rec->fNext;
+                rec->fNext = gFaceRecHead;
+                gFaceRecHead = rec;
+            }
             return rec;
         }
+        prev = rec;
         rec = rec->fNext;
     }
 
@@ -298,6 +352,8 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
     // this passes ownership of stream to the rec
     rec = SkNEW_ARGS(SkFaceRec, (stream, fontID));
 
+    // Font files are normally memory mapped (see SkStream::NewFromFile()), so FreeType reads
+    // the mapping in place, and only pages it actually touches become resident.
     FT_Open_Args args;
     memset(&args, 0, sizeof(args));
     const void* memoryBase = stream->getMemoryBase();
@@ -319,6 +375,9 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
     SkASSERT(rec->fFace);
     rec->fNext = gFaceRecHead;
     gFaceRecHead = rec;
+    ref_ft_library();
+    ++gFaceCount;
+    purge_ft_faces(gFaceCountLimit);
     return rec;
 }
 
@@ -326,28 +385,34 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
 static void unref_ft_face(FT_Face face) {
     gFTMutex.assertHeld();
 
-    SkFaceRec*  rec = gFaceRecHead;
-    SkFaceRec*  prev = NULL;
-    while (rec) {
-        SkFaceRec* next = rec->fNext;
+    for (SkFaceRec* rec = gFaceRecHead; rec; rec = rec->fNext) {
         if (rec->fFace == face) {
+            SkASSERT(rec->fRefCnt > 0);
             if (--rec->fRefCnt == 0) {
-                if (prev) {
-                    prev->fNext = next;
-                } else {
-                    gFaceRecHead = next;
-                }
-                FT_Done_Face(face);
-                SkDELETE(rec);
+                // Keep it open for the next user, within the budget.
+                purge_ft_faces(gFaceCountLimit);
             }
             return;
         }
-        prev = rec;
-        rec = next;
     }
     SkDEBUGFAIL("shouldn't get here, face not in list");
 }
 
+// Caller must lock gFTMutex before calling this function.
+static void purge_ft_face(SkFontID fontID) {
+    gFTMutex.assertHeld();
+
+    SkFaceRec* prev = NULL;
+    for (SkFaceRec* rec = gFaceRecHead; rec; prev = rec, rec = rec->fNext) {
+        if (rec->fFontID == fontID) {
+            if (0 == rec->fRefCnt) {
+                close_ft_face(rec, prev);
+            }
+            return;
+        }
+    }
+}
+
 class AutoFTAccess {
 public:
     AutoFTAccess(const SkTypeface* tf) : fRec(NULL), fFace(NULL) {
@@ -721,6 +786,30 @@ void SkTypeface_FreeType::onFilterRec(SkScalerContextRec* rec) const {
 #endif
 }
 
+SkTypeface_FreeType::~SkTypeface_FreeType() {
+    // Nothing else can open this typeface's face again, so don't let it take up the budget.
+    SkAutoMutexAcquire ac(gFTMutex);
+    purge_ft_face(this->uniqueID());
+}
+
+int SkTypeface_FreeType::GetFaceCountLimit() {
+    SkAutoMutexAcquire ac(gFTMutex);
+    return gFaceCountLimit;
+}
+
+int SkTypeface_FreeType::SetFaceCountLimit(int count) {
+    SkAutoMutexAcquire ac(gFTMutex);
+    const int prev = gFaceCountLimit;
+    gFaceCountLimit = SkTMax(count, 0);
+    purge_ft_faces(gFaceCountLimit);
+    return prev;
+}
+
+int SkTypeface_FreeType::GetFaceCount() {
+    SkAutoMutexAcquire ac(gFTMutex);
+    return gFaceCount;
+}
+
 int SkTypeface_FreeType::onGetUPEM() const {
     AutoFTAccess fta(this);
     FT_Face face = fta.face();
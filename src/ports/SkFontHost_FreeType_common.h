@@ -52,11 +52,21 @@ public:
         mutable SkMutex fLibraryMutex;
     };
 
+    /** Each typeface opens one FT_Face, shared by everything that uses it. Once nothing does,
+     *  the face stays open for the next user until more than the limit are open, and then the
+     *  least recently used ones are closed. Faces in use are never closed, so the count can
+     *  exceed the limit. SetFaceCountLimit() returns the previous limit.
+     */
+    static int GetFaceCountLimit();
+    static int SetFaceCountLimit(int count);
+    static int GetFaceCount();
+
 protected:
     SkTypeface_FreeType(const SkFontStyle& style, SkFontID uniqueID, bool isFixedPitch)
         : INHERITED(style, uniqueID, isFixedPitch)
         , fGlyphCount(-1)
     {}
+    virtual ~SkTypeface_FreeType();
 
     virtual SkScalerContext* onCreateScalerContext(
                                         const SkDescriptor*) const override;
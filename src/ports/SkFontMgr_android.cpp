@@ -8,6 +8,7 @@
 #include "SkFontConfigParser_android.h"
 #include "SkFontDescriptor.h"
 #include "SkFontHost_FreeType_common.h"
+#include "SkFontMatchCache.h"
 #include "SkFontMgr.h"
 #include "SkFontMgr_android.h"
 #include "SkFontStyle.h"
@@ -309,8 +310,14 @@ protected:
 
     virtual SkTypeface* onMatchFamilyStyle(const char familyName[],
                                            const SkFontStyle& style) const override {
+        SkTypeface* face;
+        if (fMatchCache.findStyle(familyName, style, &face)) {
+            return face;
+        }
         SkAutoTUnref<SkFontStyleSet> sset(this->matchFamily(familyName));
-        return sset->matchStyle(style);
+        face = sset->matchStyle(style);
+        fMatchCache.addStyle(familyName, style, face);
+        return face;
     }
 
     virtual SkTypeface* onMatchFaceStyle(const SkTypeface* typeface,
@@ -360,6 +367,20 @@ protected:
                                                     const char* bcp47[],
                                                     int bcp47Count,
                                                     SkUnichar character) const override
+    {
+        SkTypeface* face;
+        if (fMatchCache.findCharacter(familyName, style, bcp47, bcp47Count, character, &face)) {
+            return face;
+        }
+        face = this->matchFamilyStyleCharacterUncached(style, bcp47, bcp47Count, character);
+        fMatchCache.addCharacter(familyName, style, bcp47, bcp47Count, character, face);
+        return face;
+    }
+
+    SkTypeface* matchFamilyStyleCharacterUncached(const SkFontStyle& style,
+                                                  const char* bcp47[],
+                                                  int bcp47Count,
+                                                  SkUnichar character) const
     {
         // The variant 'elegant' is 'not squashed', 'compact' is 'stays in ascent/descent'.
         // The variant 'default' means 'compact and elegant'.
@@ -441,6 +462,9 @@ private:
     SkTDArray<NameToFamily> fNameToFamilyMap;
     SkTDArray<NameToFamily> fFallbackNameToFamilyMap;
 
+    // Remembers matches, so fallback family lists are walked once per script and style.
+    mutable SkFontMatchCache fMatchCache;
+
     void buildNameToFamilyMap(SkTDArray<FontFamily*> families) {
         for (int i = 0; i < families.count(); i++) {
             FontFamily& family = *families[i];
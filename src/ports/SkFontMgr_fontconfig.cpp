@@ -8,6 +8,7 @@
 #include "SkDataTable.h"
 #include "SkFontDescriptor.h"
 #include "SkFontHost_FreeType_common.h"
+#include "SkFontMatchCache.h"
 #include "SkFontMgr.h"
 #include "SkFontStyle.h"
 #include "SkMath.h"
@@ -573,6 +574,8 @@ class SkFontMgr_fontconfig : public SkFontMgr {
 
     mutable SkMutex fTFCacheMutex;
     mutable SkTypefaceCache fTFCache;
+    // Remembers the typefaces from fTFCache that match requests, so fontconfig is asked once.
+    mutable SkFontMatchCache fMatchCache;
     /** Creates a typeface using a typeface cache.
      *  @param pattern a complete pattern from FcFontRenderPrepare.
      */
@@ -727,6 +730,35 @@ protected:
 
     virtual SkTypeface* onMatchFamilyStyle(const char familyName[],
                                            const SkFontStyle& style) const override
+    {
+        SkTypeface* face;
+        if (fMatchCache.findStyle(familyName, style, &face)) {
+            return face;
+        }
+        face = this->matchFamilyStyleUncached(familyName, style);
+        fMatchCache.addStyle(familyName, style, face);
+        return face;
+    }
+
+    virtual SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                                    const SkFontStyle& style,
+                                                    const char* bcp47[],
+                                                    int bcp47Count,
+                                                    SkUnichar character) const override
+    {
+        SkTypeface* face;
+        if (fMatchCache.findCharacter(familyName, style, bcp47, bcp47Count, character, &face)) {
+            return face;
+        }
+        face = this->matchFamilyStyleCharacterUncached(familyName, style, bcp47, bcp47Count,
+                                                       character);
+        fMatchCache.addCharacter(familyName, style, bcp47, bcp47Count, character, face);
+        return face;
+    }
+
+private:
+    SkTypeface* matchFamilyStyleUncached(const char familyName[],
+                                         const SkFontStyle& style) const
     {
         FCLocker lock;
 
@@ -763,11 +795,11 @@ protected:
         return createTypefaceFromFcPattern(font);
     }
 
-    virtual SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
-                                                    const SkFontStyle& style,
-                                                    const char* bcp47[],
-                                                    int bcp47Count,
-                                                    SkUnichar character) const override
+    SkTypeface* matchFamilyStyleCharacterUncached(const char familyName[],
+                                                  const SkFontStyle& style,
+                                                  const char* bcp47[],
+                                                  int bcp47Count,
+                                                  SkUnichar character) const
     {
         FCLocker lock;
 
@@ -800,6 +832,7 @@ protected:
         return createTypefaceFromFcPattern(font);
     }
 
+protected:
     virtual SkTypeface* onMatchFaceStyle(const SkTypeface* typeface,
                                          const SkFontStyle& style) const override
     {
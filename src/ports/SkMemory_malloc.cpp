@@ -5,10 +5,38 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  */
+#include "SkMallocStats.h"
 #include "SkTypes.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
+    #include <malloc/malloc.h>
+    static size_t allocated_size(void* p) { return malloc_size(p); }
+#elif defined(SK_BUILD_FOR_WIN32)
+    #include <malloc.h>
+    static size_t allocated_size(void* p) { return _msize(p); }
+#elif defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include <malloc.h>
+    static size_t allocated_size(void* p) { return malloc_usable_size(p); }
+#else
+    static size_t allocated_size(void*) { return 0; }
+#endif
+
+// SkMallocStats counts what the system allocator actually hands out, so frees balance allocs.
+static inline void* count_alloc(void* p) {
+    if (p && SkMallocStats::IsEnabled()) {
+        SkMallocStats::Alloc(allocated_size(p));
+    }
+    return p;
+}
+
+static inline void count_free(void* p) {
+    if (p && SkMallocStats::IsEnabled()) {
+        SkMallocStats::Free(allocated_size(p));
+    }
+}
+
 #define SK_DEBUGFAILF(fmt, ...) \
     SkASSERT((SkDebugf(fmt"\n", __VA_ARGS__), false))
 
@@ -41,17 +69,19 @@ void* sk_malloc_throw(size_t size) {
 }
 
 void* sk_realloc_throw(void* addr, size_t size) {
-    return throw_on_failure(size, realloc(addr, size));
+    count_free(addr);
+    return throw_on_failure(size, count_alloc(realloc(addr, size)));
 }
 
 void sk_free(void* p) {
     if (p) {
+        count_free(p);
         free(p);
     }
 }
 
 void* sk_malloc_flags(size_t size, unsigned flags) {
-    void* p = malloc(size);
+    void* p = count_alloc(malloc(size));
     if (flags & SK_MALLOC_THROW) {
         return throw_on_failure(size, p);
     } else {
@@ -60,7 +90,7 @@ void* sk_malloc_flags(size_t size, unsigned flags) {
 }
 
 void* sk_calloc(size_t size) {
-    return calloc(size, 1);
+    return count_alloc(calloc(size, 1));
 }
 
 void* sk_calloc_throw(size_t size) {
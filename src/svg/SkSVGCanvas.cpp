@@ -9,9 +9,15 @@
 #include "SkSVGDevice.h"
 
 SkCanvas* SkSVGCanvas::Create(const SkRect& bounds, SkXMLWriter* writer) {
+    return Create(bounds, writer, SkParsePath::kAbsolute_PathEncoding, -1);
+}
+
+SkCanvas* SkSVGCanvas::Create(const SkRect& bounds, SkXMLWriter* writer,
+                              SkParsePath::PathEncoding pathEncoding, int pathPrecision) {
     // TODO: pass full bounds to the device
     SkISize size = bounds.roundOut().size();
-    SkAutoTUnref<SkBaseDevice> device(SkSVGDevice::Create(size, writer));
+    SkAutoTUnref<SkBaseDevice> device(SkSVGDevice::Create(size, writer, pathEncoding,
+                                                          pathPrecision));
 
     return SkNEW_ARGS(SkCanvas, (device));
 }
@@ -244,10 +244,12 @@ private:
 }
 
 // For now all this does is serve unique serial IDs, but it will eventually evolve to track
-// and deduplicate resources.
+// and deduplicate resources. It also carries the document's path data format.
 class SkSVGDevice::ResourceBucket : ::SkNoncopyable {
 public:
-    ResourceBucket() : fGradientCount(0), fClipCount(0), fPathCount(0), fImageCount(0) {}
+    ResourceBucket(SkParsePath::PathEncoding pathEncoding, int pathPrecision)
+        : fGradientCount(0), fClipCount(0), fPathCount(0), fImageCount(0)
+        , fPathEncoding(pathEncoding), fPathPrecision(pathPrecision) {}
 
     SkString addLinearGradient() {
         return SkStringPrintf("gradient_%d", fGradientCount++);
@@ -265,11 +267,17 @@ public:
         return SkStringPrintf("img_%d", fImageCount++);
     }
 
+    SkParsePath::PathEncoding pathEncoding() const { return fPathEncoding; }
+    int pathPrecision() const { return fPathPrecision; }
+
 private:
     uint32_t fGradientCount;
     uint32_t fClipCount;
     uint32_t fPathCount;
     uint32_t fImageCount;
+
+    const SkParsePath::PathEncoding fPathEncoding;
+    const int                       fPathPrecision;
 };
 
 class SkSVGDevice::AutoElement : ::SkNoncopyable {
@@ -327,7 +335,7 @@ public:
     }
 
     void addRectAttributes(const SkRect&);
-    void addPathAttributes(const SkPath&);
+    void addPathAttributes(const SkPath&, const ResourceBucket&);
     void addTextAttributes(const SkPaint&);
 
 private:
@@ -458,7 +466,7 @@ void SkSVGDevice::AutoElement::addClipResources(const SkDraw& draw, Resources* r
             rectElement.addAttribute("clip-rule", clipRule);
         } else {
             AutoElement pathElement("path", fWriter);
-            pathElement.addPathAttributes(clipPath);
+            pathElement.addPathAttributes(clipPath, *fResourceBucket);
             pathElement.addAttribute("clip-rule", clipRule);
         }
     }
@@ -518,10 +526,11 @@ void SkSVGDevice::AutoElement::addRectAttributes(const SkRect& rect) {
     this->addAttribute("height", rect.height());
 }
 
-void SkSVGDevice::AutoElement::addPathAttributes(const SkPath& path) {
-    SkString pathData;
-    SkParsePath::ToSVGString(path, &pathData);
-    this->addAttribute("d", pathData);
+void SkSVGDevice::AutoElement::addPathAttributes(const SkPath& path,
+                                                 const ResourceBucket& bucket) {
+    SkWStream* pathData = fWriter->beginAttribute("d");
+    SkParsePath::ToSVGString(path, pathData, bucket.pathEncoding(), bucket.pathPrecision());
+    fWriter->endAttribute();
 }
 
 void SkSVGDevice::AutoElement::addTextAttributes(const SkPaint& paint) {
@@ -560,17 +569,19 @@ void SkSVGDevice::AutoElement::addTextAttributes(const SkPaint& paint) {
     }
 }
 
-SkBaseDevice* SkSVGDevice::Create(const SkISize& size, SkXMLWriter* writer) {
+SkBaseDevice* SkSVGDevice::Create(const SkISize& size, SkXMLWriter* writer,
+                                  SkParsePath::PathEncoding pathEncoding, int pathPrecision) {
     if (!writer) {
         return NULL;
     }
 
-    return SkNEW_ARGS(SkSVGDevice, (size, writer));
+    return SkNEW_ARGS(SkSVGDevice, (size, writer, pathEncoding, pathPrecision));
 }
 
-SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer)
+SkSVGDevice::SkSVGDevice(const SkISize& size, SkXMLWriter* writer,
+                         SkParsePath::PathEncoding pathEncoding, int pathPrecision)
     : fWriter(writer)
-    , fResourceBucket(SkNEW(ResourceBucket)) {
+    , fResourceBucket(SkNEW_ARGS(ResourceBucket, (pathEncoding, pathPrecision))) {
     SkASSERT(writer);
 
     fLegacyBitmap.setInfo(SkImageInfo::MakeUnknown(size.width(), size.height()));
@@ -630,7 +641,7 @@ void SkSVGDevice::drawRRect(const SkDraw&, const SkRRect& rr, const SkPaint& pai
 void SkSVGDevice::drawPath(const SkDraw& draw, const SkPath& path, const SkPaint& paint,
                            const SkMatrix* prePathMatrix, bool pathIsMutable) {
     AutoElement elem("path", fWriter, fResourceBucket, draw, paint);
-    elem.addPathAttributes(path);
+    elem.addPathAttributes(path, *fResourceBucket);
 }
 
 void SkSVGDevice::drawBitmapCommon(const SkDraw& draw, const SkBitmap& bm,
@@ -744,7 +755,7 @@ void SkSVGDevice::drawTextOnPath(const SkDraw&, const void* text, size_t len, co
         AutoElement defs("defs", fWriter);
         AutoElement pathElement("path", fWriter);
         pathElement.addAttribute("id", pathID);
-        pathElement.addPathAttributes(path);
+        pathElement.addPathAttributes(path, *fResourceBucket);
 
     }
 
@@ -9,12 +9,16 @@
 #define SkSVGDevice_DEFINED
 
 #include "SkDevice.h"
+#include "SkParsePath.h"
 
 class SkXMLWriter;
 
 class SkSVGDevice : public SkBaseDevice {
 public:
-    static SkBaseDevice* Create(const SkISize& size, SkXMLWriter* writer);
+    static SkBaseDevice* Create(const SkISize& size, SkXMLWriter* writer,
+                                SkParsePath::PathEncoding pathEncoding =
+                                        SkParsePath::kAbsolute_PathEncoding,
+                                int pathPrecision = -1);
 
     virtual SkImageInfo imageInfo() const override;
 
@@ -58,7 +62,8 @@ protected:
     virtual const SkBitmap& onAccessBitmap() override;
 
 private:
-    SkSVGDevice(const SkISize& size, SkXMLWriter* writer);
+    SkSVGDevice(const SkISize& size, SkXMLWriter* writer,
+                SkParsePath::PathEncoding pathEncoding, int pathPrecision);
     virtual ~SkSVGDevice();
 
     void drawBitmapCommon(const SkDraw& draw, const SkBitmap& bm, const SkPaint& paint);
@@ -10,6 +10,7 @@
 #ifndef SkBitSet_DEFINED
 #define SkBitSet_DEFINED
 
+#include "SkMath.h"
 #include "SkTypes.h"
 #include "SkTDArray.h"
 
@@ -60,13 +61,11 @@ public:
         uint32_t* data = reinterpret_cast<uint32_t*>(fBitData.get());
         for (unsigned int i = 0; i < fDwordCount; ++i) {
             uint32_t value = data[i];
-            if (value) {  // There are set bits
-                unsigned int index = i * 32;
-                for (unsigned int j = 0; j < 32; ++j) {
-                    if (0x1 & (value >> j)) {
-                        array->push(index + j);
-                    }
-                }
+            const unsigned int index = i * 32;
+            while (value) {  // Visit only the set bits, lowest first.
+                const uint32_t lowest = value & (0 - value);
+                array->push(index + 31 - SkCLZ(lowest));
+                value ^= lowest;
             }
         }
     }
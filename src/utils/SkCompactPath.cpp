@@ -0,0 +1,156 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCompactPath.h"
+
+static const int kMaxOffset = SK_MaxU16;
+
+SkCompactPath::SkCompactPath(const SkRect& bounds, SkPath::FillType fillType)
+    : fOrigin(SkPoint::Make(bounds.fLeft, bounds.fTop))
+    , fStep(SkVector::Make(bounds.width() / kMaxOffset, bounds.height() / kMaxOffset))
+    , fBounds(SkRect::MakeEmpty())
+    , fFillType(fillType) {
+}
+
+static uint16_t quantize(SkScalar value, SkScalar origin, SkScalar step) {
+    if (0 == step) {
+        return 0;
+    }
+    return SkToU16(SkPin32(SkScalarRoundToInt((value - origin) / step), 0, kMaxOffset));
+}
+
+SkCompactPath* SkCompactPath::Create(const SkPath& path, SkScalar tolerance) {
+    if (!path.isFinite() || (path.getSegmentMasks() & ~SkPath::kLine_SegmentMask)) {
+        return NULL;
+    }
+    const SkRect& bounds = path.getBounds();
+    SkAutoTUnref<SkCompactPath> compact(SkNEW_ARGS(SkCompactPath, (bounds, path.getFillType())));
+    // Rounding to the nearest step moves a coordinate by at most half a step.
+    if (SkScalarHalf(SkTMax(compact->fStep.fX, compact->fStep.fY)) > tolerance) {
+        return NULL;
+    }
+
+    SkTDArray<uint16_t>& coords = compact->fCoords;
+    SkTDArray<uint32_t>& contours = compact->fContours;
+    coords.setReserve(path.countPoints() * 2);
+    int contourStart = 0;
+    bool closed = false;
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    do {
+        verb = iter.next(pts);
+        if (SkPath::kLine_Verb == verb) {
+            uint16_t x = quantize(pts[1].fX, compact->fOrigin.fX, compact->fStep.fX);
+            uint16_t y = quantize(pts[1].fY, compact->fOrigin.fY, compact->fStep.fY);
+            if (coords.count() > contourStart * 2 &&
+                    coords.end()[-2] == x && coords.end()[-1] == y) {
+                continue;  // skip degenerate lines
+            }
+            *coords.append() = x;
+            *coords.append() = y;
+            continue;
+        }
+        if (SkPath::kClose_Verb == verb) {
+            closed = true;
+            continue;
+        }
+        // A move, or the end: finish the contour before it, dropping it if it has no lines.
+        int contourEnd = coords.count() >> 1;
+        if (contourEnd - contourStart > 1) {
+            *contours.append() = (contourEnd << 1) | closed;
+            contourStart = contourEnd;
+        } else {
+            coords.setCount(contourStart * 2);
+        }
+        closed = false;
+        if (SkPath::kMove_Verb == verb) {
+            *coords.append() = quantize(pts[0].fX, compact->fOrigin.fX, compact->fStep.fX);
+            *coords.append() = quantize(pts[0].fY, compact->fOrigin.fY, compact->fStep.fY);
+        }
+    } while (SkPath::kDone_Verb != verb);
+
+    // Drop the slack left by skipped points.
+    coords.shrinkToFit();
+    contours.shrinkToFit();
+
+    int count = compact->countPoints();
+    if (count > 0) {
+        SkAutoTMalloc<SkPoint> points(count);
+        for (int index = 0; index < count; ++index) {
+            points[index] = compact->point(index);
+        }
+        compact->fBounds.set(points.get(), count);
+    }
+    return compact.detach();
+}
+
+size_t SkCompactPath::approximateBytesUsed() const {
+    return sizeof(*this) + fCoords.reserved() * sizeof(uint16_t) +
+           fContours.reserved() * sizeof(uint32_t);
+}
+
+void SkCompactPath::toPath(SkPath* path) const {
+    path->reset();
+    path->setFillType(fFillType);
+    path->incReserve(this->countPoints());
+    int start = 0;
+    for (int contour = 0; contour < fContours.count(); ++contour) {
+        int end = fContours[contour] >> 1;
+        path->moveTo(this->point(start));
+        for (int index = start + 1; index < end; ++index) {
+            path->lineTo(this->point(index));
+        }
+        if (fContours[contour] & 1) {
+            path->close();
+        }
+        start = end;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkCompactPath::Iter::Iter(const SkCompactPath& path, bool forceClose)
+    : fPath(path)
+    , fMoveTo(SkPoint::Make(0, 0))
+    , fLastPt(SkPoint::Make(0, 0))
+    , fContour(0)
+    , fIndex(0)
+    , fForceClose(forceClose)
+    , fNeedClose(false) {
+}
+
+SkPath::Verb SkCompactPath::Iter::next(SkPoint pts[4]) {
+    if (fNeedClose) {
+        if (fLastPt != fMoveTo) {
+            pts[0] = fLastPt;
+            pts[1] = fMoveTo;
+            fLastPt = fMoveTo;
+            return SkPath::kLine_Verb;
+        }
+        fNeedClose = false;
+        pts[0] = fMoveTo;
+        return SkPath::kClose_Verb;
+    }
+    if (fContour >= fPath.fContours.count()) {
+        return SkPath::kDone_Verb;
+    }
+    uint32_t contour = fPath.fContours[fContour];
+    int start = fContour > 0 ? fPath.fContours[fContour - 1] >> 1 : 0;
+    if (fIndex == start) {
+        fMoveTo = fLastPt = fPath.point(fIndex++);
+        pts[0] = fMoveTo;
+        return SkPath::kMove_Verb;
+    }
+    pts[0] = fLastPt;
+    pts[1] = fLastPt = fPath.point(fIndex++);
+    if (fIndex == (int) (contour >> 1)) {
+        fNeedClose = fForceClose || (contour & 1);
+        ++fContour;
+    }
+    return SkPath::kLine_Verb;
+}
@@ -83,6 +83,8 @@ static void outset_for_stroke(SkRect* rect, const SkStrokeRec& rec) {
     }
     if (SkPaint::kMiter_Join == rec.getJoin()) {
         radius = SkScalarMul(radius, rec.getMiter());
+    } else if (SkPaint::kSquare_Cap == rec.getCap()) {
+        radius = SkScalarMul(radius, SK_ScalarSqrt2);   // the corners of the caps
     }
     rect->outset(radius, radius);
 }
@@ -218,10 +220,21 @@ private:
 };
 
 
-bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
-                                const SkRect* cullRect, const SkScalar aIntervals[],
-                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
-                                SkScalar intervalLength) {
+// Returns how far pt is outside of rect in x or y, or 0 if it's inside. Since no part of a path
+// is further from a point on it than the arc length between them, the path is outside of rect
+// for at least this far in both directions.
+static SkScalar distance_outside(const SkRect& rect, const SkPoint& pt) {
+    SkScalar dx = SkMaxScalar(rect.fLeft - pt.fX, pt.fX - rect.fRight);
+    SkScalar dy = SkMaxScalar(rect.fTop - pt.fY, pt.fY - rect.fBottom);
+    return SkMaxScalar(SkMaxScalar(dx, dy), 0);
+}
+
+// Builds the dashes of src in dst. If proc is not NULL, dst is instead handed to proc and rewound
+// whenever it holds maxDashes dashes, and once more at the end.
+static bool dash_path(SkPath* dst, const SkPath& src, SkStrokeRec* rec, const SkRect* cullRect,
+                      const SkScalar aIntervals[], int32_t count, SkScalar initialDashLength,
+                      int32_t initialDashIndex, SkScalar intervalLength, int maxDashes,
+                      SkDashPath::DashStreamProc proc, void* ctx) {
 
     // we do nothing if the src wants to be filled, or if our dashlength is 0
     if (rec->isFillStyle() || initialDashLength < 0) {
@@ -238,8 +251,26 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         srcPtr = &cullPathStorage;
     }
 
+    // Dashes that can't reach the cull rect are skipped, which is only worth checking when some
+    // of the path is outside of it.
+    SkRect cullBounds;
+    bool cullDashes = false;
+    if (cullRect) {
+        cullBounds = *cullRect;
+        outset_for_stroke(&cullBounds, *rec);
+        cullDashes = !cullBounds.contains(srcPtr->getBounds());
+    }
+    int dashesChecked = 0;
+    int chunkCount = 0;
+
     SpecialLineRec lineRec;
-    bool specialLine = lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
+    bool specialLine;
+    {
+        // Streamed dashes are never all held at once, so don't reserve room for all of them.
+        SkPath reserveStorage;
+        specialLine = lineRec.init(*srcPtr, proc ? &reserveStorage : dst, rec, count >> 1,
+                                   intervalLength);
+    }
 
     SkPathMeasure   meas(*srcPtr, false);
 
@@ -257,9 +288,12 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // 90 million dash segments and crashing the memory allocator. A limit of 1 million
         // segments seems reasonable: at 2 verbs per segment * 9 bytes per verb, this caps the
         // maximum dash memory overhead at roughly 17MB per path.
-        static const SkScalar kMaxDashCount = 1000000;
+        //
+        // When culling, only the dashes that are checked against the cull rect count, since
+        // runs of dashes far from it are skipped without being looked at.
+        static const int kMaxDashCount = 1000000;
         dashCount += length * (count >> 1) / intervalLength;
-        if (dashCount > kMaxDashCount) {
+        if (!cullDashes && dashCount > kMaxDashCount) {
             dst->reset();
             return false;
         }
@@ -272,10 +306,36 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         while (distance < length) {
             SkASSERT(dlen >= 0);
             addedSegment = false;
-            if (is_even(index) && dlen > 0 && !skipFirstSegment) {
+            bool visible = true;
+            if (cullDashes && is_even(index) && dlen > 0 && !skipFirstSegment) {
+                if (++dashesChecked > kMaxDashCount) {
+                    dst->reset();
+                    return false;
+                }
+                SkPoint pos;
+                if (meas.getPosTan(SkDoubleToScalar(distance), &pos, NULL)) {
+                    double gap = distance_outside(cullBounds, pos);
+                    if (gap > dlen) {
+                        visible = false;
+                        // The dashes of whole intervals that start within gap - dlen of this one
+                        // are just as far away, so skip them too, keeping the phase.
+                        if (dlen == intervals[index]) {
+                            distance += floor((gap - dlen) / intervalLength) * intervalLength;
+                        }
+                    }
+                }
+            }
+            if (is_even(index) && dlen > 0 && !skipFirstSegment && visible) {
                 addedSegment = true;
                 ++segCount;
 
+                if (proc && chunkCount >= maxDashes) {
+                    proc(*dst, *rec, ctx);
+                    dst->rewind();
+                    chunkCount = 0;
+                }
+                ++chunkCount;
+
                 if (specialLine) {
                     lineRec.addSegment(SkDoubleToScalar(distance),
                                        SkDoubleToScalar(distance + dlen),
@@ -303,10 +363,22 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         }
 
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
-        if (meas.isClosed() && is_even(initialDashIndex) &&
-            initialDashLength > 0) {
+        // (unless it stands alone and can't reach the cull rect)
+        bool extend = meas.isClosed() && is_even(initialDashIndex) && initialDashLength > 0;
+        if (extend && cullDashes && !addedSegment) {
+            SkPoint pos;
+            extend = !meas.getPosTan(0, &pos, NULL) ||
+                     distance_outside(cullBounds, pos) <= initialDashLength;
+        }
+        if (extend) {
+            if (proc && !addedSegment && chunkCount >= maxDashes) {
+                proc(*dst, *rec, ctx);
+                dst->rewind();
+                chunkCount = 0;
+            }
             meas.getSegment(0, initialDashLength, dst, !addedSegment);
             ++segCount;
+            chunkCount += !addedSegment;
         }
     } while (meas.nextContour());
 
@@ -314,9 +386,22 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         dst->setConvexity(SkPath::kConcave_Convexity);
     }
 
+    if (proc && !dst->isEmpty()) {
+        proc(*dst, *rec, ctx);
+        dst->rewind();
+    }
+
     return true;
 }
 
+bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
+                                const SkRect* cullRect, const SkScalar aIntervals[],
+                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
+                                SkScalar intervalLength) {
+    return dash_path(dst, src, rec, cullRect, aIntervals, count, initialDashLength,
+                     initialDashIndex, intervalLength, 0, NULL, NULL);
+}
+
 bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
                                 const SkRect* cullRect, const SkPathEffect::DashInfo& info) {
     SkScalar initialDashLength = 0;
@@ -327,3 +412,17 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     return FilterDashPath(dst, src, rec, cullRect, info.fIntervals, info.fCount, initialDashLength,
                           initialDashIndex, intervalLength);
 }
+
+bool SkDashPath::StreamDashPath(const SkPath& src, SkStrokeRec* rec, const SkRect* cullRect,
+                                const SkPathEffect::DashInfo& info, int maxDashes,
+                                DashStreamProc proc, void* ctx) {
+    SkASSERT(maxDashes > 0 && proc);
+    SkScalar initialDashLength = 0;
+    int32_t initialDashIndex = 0;
+    SkScalar intervalLength = 0;
+    CalcDashParameters(info.fPhase, info.fIntervals, info.fCount,
+                       &initialDashLength, &initialDashIndex, &intervalLength);
+    SkPath dashes;
+    return dash_path(&dashes, src, rec, cullRect, info.fIntervals, info.fCount, initialDashLength,
+                     initialDashIndex, intervalLength, maxDashes, proc, ctx);
+}
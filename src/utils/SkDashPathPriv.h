@@ -27,6 +27,22 @@ namespace SkDashPath {
     
     bool FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec*, const SkRect*,
                         const SkPathEffect::DashInfo& info);
+
+    /*
+     * Receives the dashes from StreamDashPath() a batch at a time. rec says how to stroke them,
+     * which may have changed to fill if the dashes were already stroked.
+     */
+    typedef void (*DashStreamProc)(const SkPath& dashes, const SkStrokeRec& rec, void* ctx);
+
+    /*
+     * Like FilterDashPath(), but rather than building one path of every dash, hands the dashes
+     * to proc in batches of at most maxDashes, so long dashed paths never hold all of their
+     * dashes at once. Dashes that can't touch the cull rect are dropped. Returns false if the
+     * path isn't dashed; proc may have already been called by then, if the path is too long.
+     */
+    bool StreamDashPath(const SkPath& src, SkStrokeRec*, const SkRect* cullRect,
+                        const SkPathEffect::DashInfo& info, int maxDashes, DashStreamProc proc,
+                        void* ctx);
 }
 
 #endif
@@ -18,6 +18,8 @@
 #include "SkRRect.h"
 #include "SkShader.h"
 #include "SkSurface.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 
 enum {
     // Deferred canvas will auto-flush when recording reaches this limit
@@ -30,6 +32,8 @@ enum {
 enum PlaybackMode {
     kNormal_PlaybackMode,
     kSilent_PlaybackMode,
+    // Normal, but on the background thread when the canvas has one.
+    kBackground_PlaybackMode,
 };
 
 static bool should_draw_immediately(const SkBitmap* bitmap, const SkPaint* paint,
@@ -60,16 +64,24 @@ static bool should_draw_immediately(const SkBitmap* bitmap, const SkPaint* paint
 // DeferredPipeController
 //-----------------------------------------------------------------------------
 
-class DeferredPipeController : public SkGPipeController {
+class DeferredPipeController : public SkGPipeController,
+                               public SkGPipeReader::BitmapImporter {
 public:
     DeferredPipeController();
     void setPlaybackCanvas(SkCanvas*);
     virtual ~DeferredPipeController();
     void* requestBlock(size_t minRequest, size_t* actual) override;
     void notifyWritten(size_t bytes) override;
+    bool exportBitmap(const SkBitmap&, uint32_t* handle) override;
+    bool importBitmap(uint32_t handle, SkBitmap* dst) override;
     void playback(bool silent);
-    bool hasPendingCommands() const { return fAllocator.totalUsed() != 0; }
-    size_t storageAllocatedForRecording() const { return fAllocator.totalCapacity(); }
+    // Plays back the pending commands on another thread, after any it is already playing.
+    void playbackInBackground();
+    void waitForPlayback() { fPlaybackTasks.wait(); }
+    bool hasPendingCommands() const { return fRecordingBatch->fAllocator.totalUsed() != 0; }
+    size_t storageAllocatedForRecording() const {
+        return fRecordingBatch->fAllocator.totalCapacity() + fRecordingBatch->fBitmapBytes;
+    }
 private:
     enum {
         kMinBlockSize = 4096
@@ -79,35 +91,53 @@ private:
         void* fBlock;
         size_t fSize;
     };
+    // The commands recorded between two playbacks, and the bitmaps they pass by handle.
+    struct Batch {
+        Batch() : fAllocator(kMinBlockSize), fBitmapBytes(0) {}
+        SkChunkAlloc fAllocator;
+        SkTDArray<PipeBlock> fBlockList;
+        SkTArray<SkBitmap> fBitmaps;
+        size_t fBitmapBytes;  // Pixels copied for fBitmaps.
+    };
+    void endBlock();
+    void playBatch(Batch*, bool silent);
+    static void PlayBackgroundBatch(DeferredPipeController*);
+
     void* fBlock;
     size_t fBytesWritten;
-    SkChunkAlloc fAllocator;
-    SkTDArray<PipeBlock> fBlockList;
+    Batch fBatches[2];
+    Batch* fRecordingBatch;
+    Batch* fBackgroundBatch;
+    // The batch being played back, whose bitmaps importBitmap() resolves.
+    Batch* fPlayingBatch;
     SkGPipeReader fReader;
+    SkTaskGroup fPlaybackTasks;
 };
 
-DeferredPipeController::DeferredPipeController() :
-    fAllocator(kMinBlockSize) {
+DeferredPipeController::DeferredPipeController() {
     fBlock = NULL;
     fBytesWritten = 0;
+    fRecordingBatch = &fBatches[0];
+    fBackgroundBatch = NULL;
+    fPlayingBatch = NULL;
+    fReader.setBitmapImporter(this);
 }
 
 DeferredPipeController::~DeferredPipeController() {
-    fAllocator.reset();
+    this->waitForPlayback();
+    fBatches[0].fAllocator.reset();
+    fBatches[1].fAllocator.reset();
 }
 
 void DeferredPipeController::setPlaybackCanvas(SkCanvas* canvas) {
+    this->waitForPlayback();
     fReader.setCanvas(canvas);
 }
 
 void* DeferredPipeController::requestBlock(size_t minRequest, size_t *actual) {
-    if (fBlock) {
-        // Save the previous block for later
-        PipeBlock previousBloc(fBlock, fBytesWritten);
-        fBlockList.push(previousBloc);
-    }
+    this->endBlock();
     size_t blockSize = SkTMax<size_t>(minRequest, kMinBlockSize);
-    fBlock = fAllocator.allocThrow(blockSize);
+    fBlock = fRecordingBatch->fAllocator.allocThrow(blockSize);
     fBytesWritten = 0;
     *actual = blockSize;
     return fBlock;
@@ -117,21 +147,74 @@ void DeferredPipeController::notifyWritten(size_t bytes) {
     fBytesWritten += bytes;
 }
 
-void DeferredPipeController::playback(bool silent) {
-    uint32_t flags = silent ? SkGPipeReader::kSilent_PlaybackFlag : 0;
-    for (int currentBlock = 0; currentBlock < fBlockList.count(); currentBlock++ ) {
-        fReader.playback(fBlockList[currentBlock].fBlock, fBlockList[currentBlock].fSize,
-                         flags);
+bool DeferredPipeController::exportBitmap(const SkBitmap& bitmap, uint32_t* handle) {
+    // Only reached when recording for background playback. Like the bitmap heap used
+    // for playback on this thread, share immutable pixels and snapshot the rest.
+    SkBitmap snapshot;
+    if (bitmap.isImmutable() || bitmap.empty()) {
+        snapshot = bitmap;
+    } else if (bitmap.deepCopyTo(&snapshot)) {
+        snapshot.setImmutable();
+        fRecordingBatch->fBitmapBytes += snapshot.getSize();
+    } else {
+        return false;
     }
-    fBlockList.reset();
+    *handle = fRecordingBatch->fBitmaps.count();
+    fRecordingBatch->fBitmaps.push_back(snapshot);
+    return true;
+}
+
+bool DeferredPipeController::importBitmap(uint32_t handle, SkBitmap* dst) {
+    if (NULL == fPlayingBatch || handle >= (uint32_t)fPlayingBatch->fBitmaps.count()) {
+        return false;
+    }
+    *dst = fPlayingBatch->fBitmaps[handle];
+    return true;
+}
 
+void DeferredPipeController::endBlock() {
     if (fBlock) {
-        fReader.playback(fBlock, fBytesWritten, flags);
+        // Save the previous block for later
+        PipeBlock previousBloc(fBlock, fBytesWritten);
+        fRecordingBatch->fBlockList.push(previousBloc);
         fBlock = NULL;
     }
+}
+
+void DeferredPipeController::playBatch(Batch* batch, bool silent) {
+    fPlayingBatch = batch;
+    uint32_t flags = silent ? SkGPipeReader::kSilent_PlaybackFlag : 0;
+    for (int currentBlock = 0; currentBlock < batch->fBlockList.count(); currentBlock++ ) {
+        fReader.playback(batch->fBlockList[currentBlock].fBlock,
+                         batch->fBlockList[currentBlock].fSize, flags);
+    }
+    fPlayingBatch = NULL;
+    batch->fBlockList.reset();
+    batch->fBitmaps.reset();
+    batch->fBitmapBytes = 0;
 
     // Release all allocated blocks
-    fAllocator.reset();
+    batch->fAllocator.reset();
+}
+
+void DeferredPipeController::PlayBackgroundBatch(DeferredPipeController* controller) {
+    controller->playBatch(controller->fBackgroundBatch, false);
+}
+
+void DeferredPipeController::playback(bool silent) {
+    // Commands already handed to the background thread go first.
+    this->waitForPlayback();
+    this->endBlock();
+    this->playBatch(fRecordingBatch, silent);
+}
+
+void DeferredPipeController::playbackInBackground() {
+    // Only one batch is in flight at a time, and the reader is not thread safe.
+    this->waitForPlayback();
+    this->endBlock();
+    fBackgroundBatch = fRecordingBatch;
+    fRecordingBatch = (fRecordingBatch == &fBatches[0]) ? &fBatches[1] : &fBatches[0];
+    fPlaybackTasks.add(PlayBackgroundBatch, this);
 }
 
 //-----------------------------------------------------------------------------
@@ -139,7 +222,7 @@ void DeferredPipeController::playback(bool silent) {
 //-----------------------------------------------------------------------------
 class SkDeferredDevice : public SkBaseDevice {
 public:
-    explicit SkDeferredDevice(SkSurface* surface);
+    SkDeferredDevice(SkSurface* surface, bool backgroundPlayback);
     ~SkDeferredDevice();
 
     void setNotificationClient(SkDeferredCanvas::NotificationClient* notificationClient);
@@ -257,11 +340,13 @@ private:
     bool fFreshFrame;
     bool fCanDiscardCanvasContents;
     bool fIsDrawingToLayer;
+    bool fBackgroundPlayback;
     size_t fMaxRecordingStorageBytes;
     size_t fPreviousStorageAllocated;
 };
 
-SkDeferredDevice::SkDeferredDevice(SkSurface* surface) {
+SkDeferredDevice::SkDeferredDevice(SkSurface* surface, bool backgroundPlayback) {
+    fBackgroundPlayback = backgroundPlayback;
     fMaxRecordingStorageBytes = kDefaultMaxRecordingStorageBytes;
     fNotificationClient = NULL;
     fImmediateCanvas = NULL;
@@ -300,7 +385,10 @@ void SkDeferredDevice::setMaxRecordingStorage(size_t maxStorage) {
 
 void SkDeferredDevice::beginRecording() {
     SkASSERT(NULL == fRecordingCanvas);
-    fRecordingCanvas = fPipeWriter.startRecording(&fPipeController, 0,
+    // The playback thread cannot share the writer's bitmap heap, so bitmaps
+    // are passed through the controller instead, as if to another process.
+    uint32_t flags = fBackgroundPlayback ? SkGPipeWriter::kCrossProcess_Flag : 0;
+    fRecordingCanvas = fPipeWriter.startRecording(&fPipeController, flags,
         immediateDevice()->width(), immediateDevice()->height());
 }
 
@@ -344,13 +432,26 @@ void SkDeferredDevice::aboutToDraw()
 
 void SkDeferredDevice::flushPendingCommands(PlaybackMode playbackMode) {
     if (!fPipeController.hasPendingCommands()) {
+        if (kBackground_PlaybackMode != playbackMode) {
+            fPipeController.waitForPlayback();
+        }
         return;
     }
-    if (playbackMode == kNormal_PlaybackMode) {
+    if (kBackground_PlaybackMode == playbackMode && !fBackgroundPlayback) {
+        playbackMode = kNormal_PlaybackMode;
+    }
+    if (playbackMode != kSilent_PlaybackMode) {
+        // Whatever the background thread is drawing must land before the surface is told
+        // about the next batch.
+        fPipeController.waitForPlayback();
         aboutToDraw();
     }
     fPipeWriter.flushRecording(true);
-    fPipeController.playback(kSilent_PlaybackMode == playbackMode);
+    if (kBackground_PlaybackMode == playbackMode) {
+        fPipeController.playbackInBackground();
+    } else {
+        fPipeController.playback(kSilent_PlaybackMode == playbackMode);
+    }
     if (fNotificationClient) {
         if (playbackMode == kSilent_PlaybackMode) {
             fNotificationClient->skippedPendingDrawCommands();
@@ -386,7 +487,7 @@ void SkDeferredDevice::recordedDrawCommand() {
         size_t tryFree = storageAllocated - fMaxRecordingStorageBytes;
         if (this->freeMemoryIfPossible(tryFree) < tryFree) {
             // Flush is necessary to free more space.
-            this->flushPendingCommands(kNormal_PlaybackMode);
+            this->flushPendingCommands(kBackground_PlaybackMode);
             // Free as much as possible to avoid oscillating around fMaxRecordingStorageBytes
             // which could cause a high flushing frequency.
             this->freeMemoryIfPossible(~0U);
@@ -426,6 +527,7 @@ void SkDeferredDevice::prepareForImmediatePixelWrite() {
     if (fPipeController.hasPendingCommands()) {
         this->flushPendingCommands(kNormal_PlaybackMode);
     } else {
+        fPipeController.waitForPlayback();
         bool mustNotifyDirectly = !fCanDiscardCanvasContents;
         this->aboutToDraw();
         if (mustNotifyDirectly) {
@@ -507,8 +609,9 @@ private:
     SkDeferredCanvas* fCanvas;
 };
 
-SkDeferredCanvas* SkDeferredCanvas::Create(SkSurface* surface) {
-    SkAutoTUnref<SkDeferredDevice> deferredDevice(SkNEW_ARGS(SkDeferredDevice, (surface)));
+SkDeferredCanvas* SkDeferredCanvas::Create(SkSurface* surface, PlaybackThread playbackThread) {
+    SkAutoTUnref<SkDeferredDevice> deferredDevice(SkNEW_ARGS(SkDeferredDevice,
+            (surface, kBackground_PlaybackThread == playbackThread)));
     return SkNEW_ARGS(SkDeferredCanvas, (deferredDevice));
 }
 
@@ -598,6 +701,12 @@ bool SkDeferredCanvas::hasPendingCommands() const {
     return this->getDeferredDevice()->hasPendingCommands();
 }
 
+void SkDeferredCanvas::flushInBackground() {
+    if (fDeferredDrawing) {
+        this->getDeferredDevice()->flushPendingCommands(kBackground_PlaybackMode);
+    }
+}
+
 void SkDeferredCanvas::silentFlush() {
     if (fDeferredDrawing) {
         this->getDeferredDevice()->flushPendingCommands(kSilent_PlaybackMode);
@@ -782,6 +891,12 @@ void SkDeferredCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     this->recordedDrawCommand();
 }
 
+void SkDeferredCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    AutoImmediateDrawIfNeeded autoDraw(*this, &paint);
+    this->drawingCanvas()->drawRects(rects, count, paint);
+    this->recordedDrawCommand();
+}
+
 void SkDeferredCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     if (rrect.isRect()) {
         this->SkDeferredCanvas::drawRect(rrect.getBounds(), paint);
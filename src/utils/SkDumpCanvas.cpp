@@ -316,6 +316,12 @@ void SkDumpCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     this->dump(kDrawRect_Verb, &paint, "drawRect(%s)", str.c_str());
 }
 
+void SkDumpCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkDumpCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     SkString str;
     toString(rrect, &str);
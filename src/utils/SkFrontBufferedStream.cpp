@@ -30,6 +30,8 @@ public:
 
     SkStreamRewindable* duplicate() const override { return NULL; }
 
+    const void* peekMemory(size_t* size) override;
+
 private:
     SkAutoTDelete<SkStream> fStream;
     const bool              fHasLength;
@@ -63,10 +65,76 @@ private:
     typedef SkStream INHERITED;
 };
 
+// What Create returns when the rest of the stream is in memory already. Rewinding just goes back
+// to the first of those bytes, so nothing is copied into a buffer, and peekMemory always has them
+// all. Rewinding is still limited to the buffer size, as for FrontBufferedStream.
+class MemoryViewStream : public SkStreamRewindable {
+public:
+    // Called by Create.
+    MemoryViewStream(SkStream* stream, const void* data, size_t length, size_t bufferSize)
+        : fStream(stream)
+        , fData(static_cast<const char*>(data))
+        , fLength(length)
+        , fOffset(0)
+        , fBufferSize(bufferSize) {}
+
+    size_t read(void* buffer, size_t size) override {
+        size = SkTMin(size, fLength - fOffset);
+        if (buffer) {
+            memcpy(buffer, fData + fOffset, size);
+        }
+        fOffset += size;
+        return size;
+    }
+
+    bool isAtEnd() const override { return fOffset == fLength; }
+
+    bool rewind() override {
+        if (fOffset <= fBufferSize) {
+            fOffset = 0;
+            return true;
+        }
+        return false;
+    }
+
+    bool hasPosition() const override { return true; }
+
+    size_t getPosition() const override { return fOffset; }
+
+    bool hasLength() const override { return true; }
+
+    size_t getLength() const override { return fLength; }
+
+    SkStreamRewindable* duplicate() const override { return NULL; }
+
+    const void* getMemoryBase() override { return fData; }
+
+    const void* peekMemory(size_t* size) override {
+        *size = fLength - fOffset;
+        return fData + fOffset;
+    }
+
+private:
+    // Owns the memory in [fData, fData + fLength), and is never moved, so it stays valid.
+    SkAutoTDelete<SkStream> fStream;
+    const char*             fData;
+    const size_t            fLength;
+    size_t                  fOffset;
+    const size_t            fBufferSize;
+
+    typedef SkStreamRewindable INHERITED;
+};
+
 SkStreamRewindable* SkFrontBufferedStream::Create(SkStream* stream, size_t bufferSize) {
     if (NULL == stream) {
         return NULL;
     }
+    size_t size;
+    const void* memory = stream->peekMemory(&size);
+    if (memory && stream->hasPosition() && stream->hasLength() &&
+        size == stream->getLength() - stream->getPosition()) {
+        return SkNEW_ARGS(MemoryViewStream, (stream, memory, size, bufferSize));
+    }
     return SkNEW_ARGS(FrontBufferedStream, (stream, bufferSize));
 }
 
@@ -98,6 +166,18 @@ bool FrontBufferedStream::rewind() {
     return false;
 }
 
+const void* FrontBufferedStream::peekMemory(size_t* size) {
+    if (fOffset < fBufferedSoFar) {
+        *size = fBufferedSoFar - fOffset;
+        return fBuffer + fOffset;
+    }
+    // Once nothing more will be buffered, reads go straight to the stream, and so can peeks.
+    if (fOffset >= fBufferSize) {
+        return fStream->peekMemory(size);
+    }
+    return NULL;
+}
+
 size_t FrontBufferedStream::readFromBuffer(char* dst, size_t size) {
     SkASSERT(fOffset < fBufferedSoFar);
     // Some data has already been copied to fBuffer. Read up to the
@@ -57,33 +57,94 @@ DEF_MTNAME(SkSurface)
 DEF_MTNAME(SkTextBlob)
 DEF_MTNAME(SkTypeface)
 
+// The addresses of these are light userdata keys into the registry, so the per-class lookups
+// below don't have to hash a metatable name.
+template <typename T> struct RegistryKeys {
+    static const char kMetaTable;   // T's metatable
+    static const char kWrappers;    // weak-valued table of the userdata wrapping each T*
+    static const char kLastPushed;  // the userdata last pushed by push_obj_reusing_last<T>()
+};
+template <typename T> const char RegistryKeys<T>::kMetaTable = 0;
+template <typename T> const char RegistryKeys<T>::kWrappers = 0;
+template <typename T> const char RegistryKeys<T>::kLastPushed = 0;
+
+template <typename T> void push_metatable(lua_State* L) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &RegistryKeys<T>::kMetaTable);
+}
+
 template <typename T> T* push_new(lua_State* L) {
     T* addr = (T*)lua_newuserdata(L, sizeof(T));
     new (addr) T;
-    luaL_getmetatable(L, get_mtname<T>());
+    push_metatable<T>(L);
     lua_setmetatable(L, -2);
     return addr;
 }
 
 template <typename T> void push_obj(lua_State* L, const T& obj) {
     new (lua_newuserdata(L, sizeof(T))) T(obj);
-    luaL_getmetatable(L, get_mtname<T>());
+    push_metatable<T>(L);
     lua_setmetatable(L, -2);
 }
 
+// Like push_obj(), but if the userdata pushed last time still holds an equal T (the script may
+// have changed it since), push that one again instead of a new copy. Callbacks that hand the
+// same paint to Lua for every draw then don't leave a copy of it behind each time for the GC.
+template <typename T> void push_obj_reusing_last(lua_State* L, const T& obj) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &RegistryKeys<T>::kLastPushed);
+    const T* last = (const T*)lua_touserdata(L, -1);
+    if (last && *last == obj) {
+        return;
+    }
+    lua_pop(L, 1);
+    push_obj(L, obj);
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &RegistryKeys<T>::kLastPushed);
+}
+
+// Each T* gets one wrapper, for as long as Lua holds on to it, so pushing the same object again
+// (e.g. the canvas on every callback) reuses that wrapper rather than allocating another.
 template <typename T> T* push_ref(lua_State* L, T* ref) {
+    if (ref) {
+        lua_rawgetp(L, LUA_REGISTRYINDEX, &RegistryKeys<T>::kWrappers);
+        lua_rawgetp(L, -1, ref);
+        if (!lua_isnil(L, -1)) {
+            lua_remove(L, -2);  // the wrappers table
+            return ref;
+        }
+        lua_pop(L, 1);
+    }
     *(T**)lua_newuserdata(L, sizeof(T*)) = SkSafeRef(ref);
-    luaL_getmetatable(L, get_mtname<T>());
+    push_metatable<T>(L);
     lua_setmetatable(L, -2);
+    if (ref) {
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, -3, ref);
+        lua_remove(L, -2);  // the wrappers table
+    }
     return ref;
 }
 
+// Returns the userdata at index if its metatable is T's, comparing the metatables directly.
+// Anything else goes to luaL_checkudata() to raise the usual error.
+template <typename T> void* check_udata(lua_State* L, int index) {
+    void* p = lua_touserdata(L, index);
+    if (p && lua_getmetatable(L, index)) {
+        push_metatable<T>(L);
+        bool matches = SkToBool(lua_rawequal(L, -1, -2));
+        lua_pop(L, 2);
+        if (matches) {
+            return p;
+        }
+    }
+    return luaL_checkudata(L, index, get_mtname<T>());
+}
+
 template <typename T> T* get_ref(lua_State* L, int index) {
-    return *(T**)luaL_checkudata(L, index, get_mtname<T>());
+    return *(T**)check_udata<T>(L, index);
 }
 
 template <typename T> T* get_obj(lua_State* L, int index) {
-    return (T*)luaL_checkudata(L, index, get_mtname<T>());
+    return (T*)check_udata<T>(L, index);
 }
 
 static bool lua2bool(lua_State* L, int index) {
@@ -305,12 +366,12 @@ void SkLua::pushDash(const SkPathEffect::DashInfo& info, const char key[]) {
 
 
 void SkLua::pushMatrix(const SkMatrix& matrix, const char key[]) {
-    push_obj(fL, matrix);
+    push_obj_reusing_last(fL, matrix);
     CHECK_SETFIELD(key);
 }
 
 void SkLua::pushPaint(const SkPaint& paint, const char key[]) {
-    push_obj(fL, paint);
+    push_obj_reusing_last(fL, paint);
     CHECK_SETFIELD(key);
 }
 
@@ -445,7 +506,16 @@ static SkColor lua2color(lua_State* L, int index) {
                           unit2byte(getfield_scalar_default(L, index, "b", 0)));
 }
 
+// Rects are { left=l, top=t, right=r, bottom=b } or, quicker to read, { l, t, r, b }.
 static SkRect* lua2rect(lua_State* L, int index, SkRect* rect) {
+    index = lua_absindex(L, index);
+    lua_rawgeti(L, index, 1);
+    bool isArray = !lua_isnil(L, -1);
+    lua_pop(L, 1);
+    if (isArray) {
+        getarray_scalars(L, index, &rect->fLeft, 4);
+        return rect;
+    }
     rect->set(getfield_scalar_default(L, index, "left", 0),
               getfield_scalar_default(L, index, "top", 0),
               getfield_scalar(L, index, "right"),
@@ -491,6 +561,51 @@ static int lcanvas_drawCircle(lua_State* L) {
     return 0;
 }
 
+// The batched draws below take one flat array of numbers, so a script can emit thousands of
+// primitives per call without building a table for each.
+
+static int lcanvas_drawRects(lua_State* L) {
+    SkCanvas* canvas = get_ref<SkCanvas>(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    const SkPaint& paint = *get_obj<SkPaint>(L, 3);
+    const int count = SkToInt(lua_rawlen(L, 2) / 4);
+    for (int i = 0; i < count; ++i) {
+        SkRect rect;
+        rect.set(getarray_scalar(L, 2, 4*i + 1), getarray_scalar(L, 2, 4*i + 2),
+                 getarray_scalar(L, 2, 4*i + 3), getarray_scalar(L, 2, 4*i + 4));
+        canvas->drawRect(rect, paint);
+    }
+    return 0;
+}
+
+static int lcanvas_drawCircles(lua_State* L) {
+    SkCanvas* canvas = get_ref<SkCanvas>(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    const SkPaint& paint = *get_obj<SkPaint>(L, 3);
+    const int count = SkToInt(lua_rawlen(L, 2) / 3);
+    for (int i = 0; i < count; ++i) {
+        canvas->drawCircle(getarray_scalar(L, 2, 3*i + 1), getarray_scalar(L, 2, 3*i + 2),
+                           getarray_scalar(L, 2, 3*i + 3), paint);
+    }
+    return 0;
+}
+
+static int lcanvas_drawPoints(lua_State* L) {
+    static const char* const gModes[] = { "points", "lines", "polygon", NULL };
+    static const SkCanvas::PointMode gPointModes[] = {
+        SkCanvas::kPoints_PointMode, SkCanvas::kLines_PointMode, SkCanvas::kPolygon_PointMode,
+    };
+    SkCanvas* canvas = get_ref<SkCanvas>(L, 1);
+    SkCanvas::PointMode mode = gPointModes[luaL_checkoption(L, 2, NULL, gModes)];
+    luaL_checktype(L, 3, LUA_TTABLE);
+    const SkPaint& paint = *get_obj<SkPaint>(L, 4);
+    const int count = SkToInt(lua_rawlen(L, 3) / 2);
+    SkAutoSTMalloc<64, SkPoint> pts(count);
+    getarray_points(L, 3, pts.get(), count);
+    canvas->drawPoints(mode, count, pts.get(), paint);
+    return 0;
+}
+
 static SkPaint* lua2OptionalPaint(lua_State* L, int index, SkPaint* paint) {
     if (lua_isnumber(L, index)) {
         paint->setAlpha(SkScalarRoundToInt(lua2scalar(L, index) * 255));
@@ -728,8 +843,11 @@ const struct luaL_Reg gSkCanvas_Methods[] = {
     { "drawColor", lcanvas_drawColor },
     { "drawPaint", lcanvas_drawPaint },
     { "drawRect", lcanvas_drawRect },
+    { "drawRects", lcanvas_drawRects },
     { "drawOval", lcanvas_drawOval },
     { "drawCircle", lcanvas_drawCircle },
+    { "drawCircles", lcanvas_drawCircles },
+    { "drawPoints", lcanvas_drawPoints },
     { "drawImage", lcanvas_drawImage },
     { "drawImageRect", lcanvas_drawImageRect },
     { "drawPatch", lcanvas_drawPatch },
@@ -1340,6 +1458,21 @@ static int lmatrix_getTranslateY(lua_State* L) {
     return 1;
 }
 
+// get() and set() index the matrix like SkMatrix does, from 0 (kMScaleX) to 8 (kMPersp2).
+static int lmatrix_get(lua_State* L) {
+    int index = luaL_checkint(L, 2);
+    luaL_argcheck(L, index >= 0 && index < 9, 2, "matrix index out of range");
+    lua_pushnumber(L, SkScalarToLua(get_obj<SkMatrix>(L, 1)->get(index)));
+    return 1;
+}
+
+static int lmatrix_set(lua_State* L) {
+    int index = luaL_checkint(L, 2);
+    luaL_argcheck(L, index >= 0 && index < 9, 2, "matrix index out of range");
+    get_obj<SkMatrix>(L, 1)->set(index, lua2scalar(L, 3));
+    return 0;
+}
+
 static int lmatrix_invert(lua_State* L) {
     lua_pushboolean(L, get_obj<SkMatrix>(L, 1)->invert(get_obj<SkMatrix>(L, 2)));
     return 1;
@@ -1390,6 +1523,8 @@ static const struct luaL_Reg gSkMatrix_Methods[] = {
     { "getScaleY", lmatrix_getScaleY },
     { "getTranslateX", lmatrix_getTranslateX },
     { "getTranslateY", lmatrix_getTranslateY },
+    { "get", lmatrix_get },
+    { "set", lmatrix_set },
     { "setRectToRect", lmatrix_setRectToRect },
     { "invert", lmatrix_invert },
     { "mapXY", lmatrix_mapXY },
@@ -1517,6 +1652,16 @@ static int lpath_countPoints(lua_State* L) {
     return 1;
 }
 
+static int lpath_getPoint(lua_State* L) {
+    const SkPath* path = get_obj<SkPath>(L, 1);
+    int index = luaL_checkint(L, 2);
+    luaL_argcheck(L, index >= 0 && index < path->countPoints(), 2, "point index out of range");
+    SkPoint pt = path->getPoint(index);
+    lua_pushnumber(L, SkScalarToLua(pt.x()));
+    lua_pushnumber(L, SkScalarToLua(pt.y()));
+    return 2;
+}
+
 static int lpath_reset(lua_State* L) {
     get_obj<SkPath>(L, 1)->reset();
     return 0;
@@ -1564,6 +1709,7 @@ static const struct luaL_Reg gSkPath_Methods[] = {
     { "isRect", lpath_isRect },
     { "isNestedRects", lpath_isNestedRects },
     { "countPoints", lpath_countPoints },
+    { "getPoint", lpath_getPoint },
     { "reset", lpath_reset },
     { "moveTo", lpath_moveTo },
     { "lineTo", lpath_lineTo },
@@ -2038,13 +2184,25 @@ static void register_Sk(lua_State* L) {
     lua_pop(L, 1);  // pop off the Sk table
 }
 
-#define REG_CLASS(L, C)                             \
-    do {                                            \
-        luaL_newmetatable(L, get_mtname<C>());      \
-        lua_pushvalue(L, -1);                       \
-        lua_setfield(L, -2, "__index");             \
-        luaL_setfuncs(L, g##C##_Methods, 0);        \
-        lua_pop(L, 1); /* pop off the meta-table */ \
+// The table push_ref() keeps a class's wrappers in. Its values are weak, so a wrapper that Lua no
+// longer holds is still collected (and unrefs its object).
+static void register_wrappers(lua_State* L, const void* key) {
+    lua_newtable(L);
+    lua_newtable(L);
+    lua_pushstring(L, "v");
+    lua_setfield(L, -2, "__mode");
+    lua_setmetatable(L, -2);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, key);
+}
+
+#define REG_CLASS(L, C)                                                   \
+    do {                                                                  \
+        luaL_newmetatable(L, get_mtname<C>());                            \
+        lua_pushvalue(L, -1);                                             \
+        lua_setfield(L, -2, "__index");                                   \
+        luaL_setfuncs(L, g##C##_Methods, 0);                              \
+        lua_rawsetp(L, LUA_REGISTRYINDEX, &RegistryKeys<C>::kMetaTable);  \
+        register_wrappers(L, &RegistryKeys<C>::kWrappers);                \
     } while (0)
 
 void SkLua::Load(lua_State* L) {
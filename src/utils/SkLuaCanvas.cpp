@@ -186,6 +186,12 @@ void SkLuaCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     lua.pushPaint(paint, "paint");
 }
 
+void SkLuaCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkLuaCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     AUTO_LUA("drawRRect");
     lua.pushRRect(rrect, "rrect");
@@ -251,23 +251,30 @@ void SkNinePatch::DrawMesh(SkCanvas* canvas, const SkRect& bounds,
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static void drawNineViaRects(SkCanvas* canvas, const SkRect& dst,
-                             const SkBitmap& bitmap, const SkIRect& margins,
-                             const SkPaint* paint) {
-    const int32_t srcX[4] = {
-        0, margins.fLeft, bitmap.width() - margins.fRight, bitmap.width()
-    };
-    const int32_t srcY[4] = {
-        0, margins.fTop, bitmap.height() - margins.fBottom, bitmap.height()
-    };
-    SkScalar dstX[4] = {
-        dst.fLeft, dst.fLeft + SkIntToScalar(margins.fLeft),
-        dst.fRight - SkIntToScalar(margins.fRight), dst.fRight
-    };
-    SkScalar dstY[4] = {
-        dst.fTop, dst.fTop + SkIntToScalar(margins.fTop),
-        dst.fBottom - SkIntToScalar(margins.fBottom), dst.fBottom
-    };
+// Computes the edges of the nine cells in the bitmap and in dst. When the margins don't fit in
+// dst the middle row or column collapses, and the margins share dst in proportion to their size.
+static void computeNineEdges(const SkRect& dst, const SkBitmap& bitmap, const SkIRect& margins,
+                             int32_t srcX[4], int32_t srcY[4],
+                             SkScalar dstX[4], SkScalar dstY[4]) {
+    srcX[0] = 0;
+    srcX[1] = margins.fLeft;
+    srcX[2] = bitmap.width() - margins.fRight;
+    srcX[3] = bitmap.width();
+
+    srcY[0] = 0;
+    srcY[1] = margins.fTop;
+    srcY[2] = bitmap.height() - margins.fBottom;
+    srcY[3] = bitmap.height();
+
+    dstX[0] = dst.fLeft;
+    dstX[1] = dst.fLeft + SkIntToScalar(margins.fLeft);
+    dstX[2] = dst.fRight - SkIntToScalar(margins.fRight);
+    dstX[3] = dst.fRight;
+
+    dstY[0] = dst.fTop;
+    dstY[1] = dst.fTop + SkIntToScalar(margins.fTop);
+    dstY[2] = dst.fBottom - SkIntToScalar(margins.fBottom);
+    dstY[3] = dst.fBottom;
 
     if (dstX[1] > dstX[2]) {
         dstX[1] = dstX[0] + (dstX[3] - dstX[0]) * SkIntToScalar(margins.fLeft) /
@@ -280,6 +287,14 @@ static void drawNineViaRects(SkCanvas* canvas, const SkRect& dst,
             (SkIntToScalar(margins.fTop) + SkIntToScalar(margins.fBottom));
         dstY[2] = dstY[1];
     }
+}
+
+static void drawNineViaRects(SkCanvas* canvas, const SkRect& dst,
+                             const SkBitmap& bitmap, const SkIRect& margins,
+                             const SkPaint* paint) {
+    int32_t  srcX[4], srcY[4];
+    SkScalar dstX[4], dstY[4];
+    computeNineEdges(dst, bitmap, margins, srcX, srcY, dstX, dstY);
 
     SkIRect s;
     SkRect  d;
@@ -333,3 +348,69 @@ void SkNinePatch::DrawNine(SkCanvas* canvas, const SkRect& bounds,
         drawNineViaRects(canvas, bounds, bitmap, margins, paint);
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkNinePatch::DrawNineBatch(SkCanvas* canvas, const SkRect dsts[], int count,
+                                const SkBitmap& bitmap, const SkIRect& margins,
+                                const SkPaint* paint) {
+    if (count <= 0 || bitmap.width() == 0 || bitmap.height() == 0) {
+        return;
+    }
+
+    // Each nine-patch is a 4x4 grid of vertices, so 16 bit indices reach 4096 of them per draw.
+    static const int kVertsPerNine = 16;
+    static const int kIndicesPerNine = SK_ARRAY_COUNT(g3x3Indices);
+    static const int kMaxNinesPerDraw = (SK_MaxU16 + 1) / kVertsPerNine;
+
+    const int maxNines = SkTMin(count, kMaxNinesPerDraw);
+    const int maxVerts = maxNines * kVertsPerNine;
+    SkAutoMalloc storage(maxVerts * sizeof(SkPoint) * 2 +
+                         maxNines * kIndicesPerNine * sizeof(uint16_t));
+    SkPoint* verts = (SkPoint*)storage.get();
+    SkPoint* texs = verts + maxVerts;
+    uint16_t* indices = (uint16_t*)(texs + maxVerts);
+
+    SkShader* shader = SkShader::CreateBitmapShader(bitmap,
+                                                    SkShader::kClamp_TileMode,
+                                                    SkShader::kClamp_TileMode);
+    SkPaint p;
+    if (paint) {
+        p = *paint;
+    }
+    p.setShader(shader)->unref();
+
+    int nines = 0;
+    for (int i = 0; i < count; i++) {
+        if (dsts[i].isEmpty()) {
+            continue;
+        }
+        int32_t  srcX[4], srcY[4];
+        SkScalar dstX[4], dstY[4];
+        computeNineEdges(dsts[i], bitmap, margins, srcX, srcY, dstX, dstY);
+
+        SkPoint* v = verts + nines * kVertsPerNine;
+        SkPoint* t = texs + nines * kVertsPerNine;
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                v->set(dstX[x], dstY[y]); v++;
+                t->set(SkIntToScalar(srcX[x]), SkIntToScalar(srcY[y])); t++;
+            }
+        }
+        uint16_t* idx = indices + nines * kIndicesPerNine;
+        const int base = nines * kVertsPerNine;
+        for (int j = 0; j < kIndicesPerNine; j++) {
+            idx[j] = SkToU16(base + g3x3Indices[j]);
+        }
+
+        if (++nines == maxNines) {
+            canvas->drawVertices(SkCanvas::kTriangles_VertexMode, nines * kVertsPerNine,
+                                 verts, texs, NULL, NULL, indices, nines * kIndicesPerNine, p);
+            nines = 0;
+        }
+    }
+    if (nines > 0) {
+        canvas->drawVertices(SkCanvas::kTriangles_VertexMode, nines * kVertsPerNine,
+                             verts, texs, NULL, NULL, indices, nines * kIndicesPerNine, p);
+    }
+}
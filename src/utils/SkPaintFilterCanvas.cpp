@@ -46,6 +46,11 @@ void SkPaintFilterCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     this->INHERITED::onDrawRect(rect, *apf.paint());
 }
 
+void SkPaintFilterCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    AutoPaintFilter apf(this, kRect_Type, paint);
+    this->INHERITED::onDrawRects(rects, count, *apf.paint());
+}
+
 void SkPaintFilterCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     AutoPaintFilter apf(this, kRRect_Type, paint);
     this->INHERITED::onDrawRRect(rrect, *apf.paint());
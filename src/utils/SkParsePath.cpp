@@ -104,6 +104,7 @@ bool SkParsePath::FromSVGString(const char data[], SkPath* result) {
                 path.moveTo(points[0]);
                 op = 'L';
                 c = points[0];
+                f = c;
                 break;
             case 'L':
                 data = find_points(data, points, 1, relative, &c);
@@ -190,6 +191,114 @@ bool SkParsePath::FromSVGString(const char data[], SkPath* result) {
 #include "SkString.h"
 #include "SkStream.h"
 
+namespace {
+
+// Writes path data, dropping the repeated commands and the separators SVG lets us leave out.
+class PathWriter {
+public:
+    PathWriter(SkWStream* stream, SkParsePath::PathEncoding encoding, int precision)
+        : fStream(stream)
+        , fRelative(SkParsePath::kRelative_PathEncoding == encoding)
+        , fPrecision(SkTMin(precision, 8))
+        , fScale(1)
+        , fPrevVerb('\0')
+        , fNeedSeparator(false) {
+        for (int i = 0; i < fPrecision; i++) {
+            fScale *= 10;
+        }
+        fCurrent.set(0, 0);
+        fContourStart.set(0, 0);
+    }
+
+    void moveTo(const SkPoint& pt) {
+        this->writePoints('M', &pt, 1);
+        fContourStart = fCurrent;
+        // Points after a moveto are implicit linetos, so 'L' can't be dropped after it.
+        fPrevVerb = '\0';
+    }
+
+    void writePoints(char verb, const SkPoint pts[], int count) {
+        if (fRelative) {
+            verb = verb - 'A' + 'a';
+        }
+        if (verb != fPrevVerb) {
+            fStream->write(&verb, 1);
+            fNeedSeparator = false;
+        }
+        fPrevVerb = verb;
+        // Relative control points are all measured from the start of the segment.
+        const SkPoint origin = fCurrent;
+        for (int i = 0; i < count; i++) {
+            SkPoint written;
+            written.fX = this->writeCoordinate(pts[i].fX, fRelative ? origin.fX : 0);
+            written.fY = this->writeCoordinate(pts[i].fY, fRelative ? origin.fY : 0);
+            fCurrent = written;
+        }
+    }
+
+    void close() {
+        const char verb = fRelative ? 'z' : 'Z';
+        fStream->write(&verb, 1);
+        fPrevVerb = verb;
+        fCurrent = fContourStart;
+    }
+
+private:
+    // Writes value - base, and returns the value a reader will get back.
+    SkScalar writeCoordinate(SkScalar value, SkScalar base) {
+        char buffer[64];
+        int len;
+        SkScalar delta = value - base;
+        if (fPrecision < 0) {
+#ifdef SK_BUILD_FOR_WIN32
+            len = _snprintf(buffer, sizeof(buffer), "%g", delta);
+#else
+            len = snprintf(buffer, sizeof(buffer), "%g", delta);
+#endif
+        } else {
+            delta = SkDoubleToScalar(floor(delta * fScale + 0.5) / fScale);
+#ifdef SK_BUILD_FOR_WIN32
+            len = _snprintf(buffer, sizeof(buffer), "%.*f", fPrecision, delta);
+#else
+            len = snprintf(buffer, sizeof(buffer), "%.*f", fPrecision, delta);
+#endif
+            if (memchr(buffer, '.', len)) {
+                while ('0' == buffer[len - 1]) {
+                    len--;
+                }
+                if ('.' == buffer[len - 1]) {
+                    len--;
+                }
+            }
+            if (2 == len && '-' == buffer[0] && '0' == buffer[1]) {
+                buffer[0] = '0';
+                len = 1;
+            }
+        }
+        if (len < 0 || len >= (int)sizeof(buffer)) {
+            len = 0;
+        }
+        // A minus sign separates numbers by itself.
+        if (fNeedSeparator && '-' != buffer[0]) {
+            fStream->write(" ", 1);
+        }
+        fStream->write(buffer, len);
+        fNeedSeparator = true;
+        return fPrecision < 0 ? value : base + delta;
+    }
+
+    SkWStream*  fStream;
+    const bool  fRelative;
+    const int   fPrecision;
+    double      fScale;
+    SkPoint     fCurrent;
+    SkPoint     fContourStart;
+    char        fPrevVerb;
+    bool        fNeedSeparator;
+};
+
+}  // namespace
+
 static void write_scalar(SkWStream* stream, SkScalar value) {
     char buffer[64];
 #ifdef SK_BUILD_FOR_WIN32
@@ -249,3 +358,41 @@ void SkParsePath::ToSVGString(const SkPath& path, SkString* str) {
         }
     }
 }
+
+void SkParsePath::ToSVGString(const SkPath& path, SkWStream* stream,
+                              PathEncoding encoding, int precision) {
+    PathWriter      writer(stream, encoding, precision);
+    // Unlike SkPath::Iter, RawIter doesn't add the closing line that 'Z' draws anyway.
+    SkPath::RawIter iter(path);
+    SkPoint         pts[4];
+
+    for (;;) {
+        switch (iter.next(pts)) {
+            case SkPath::kConic_Verb: {
+                const SkScalar tol = SK_Scalar1 / 1024; // how close to a quad
+                SkAutoConicToQuads quadder;
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(), tol);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    writer.writePoints('Q', &quadPts[i*2 + 1], 2);
+                }
+            } break;
+            case SkPath::kMove_Verb:
+                writer.moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                writer.writePoints('L', &pts[1], 1);
+                break;
+            case SkPath::kQuad_Verb:
+                writer.writePoints('Q', &pts[1], 2);
+                break;
+            case SkPath::kCubic_Verb:
+                writer.writePoints('C', &pts[1], 3);
+                break;
+            case SkPath::kClose_Verb:
+                writer.close();
+                break;
+            case SkPath::kDone_Verb:
+                return;
+        }
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "SkPatchGrid.h"
 #include "SkPatchUtils.h"
+#include "SkTDArray.h"
 
 SkPatchGrid::SkPatchGrid(int rows, int cols, VertexType flags, SkXfermode* xfer)
     : fRows(0)
@@ -147,6 +148,11 @@ void SkPatchGrid::reset(int rows, int cols, VertexType flags, SkXfermode* xMode)
         fTexCoords = SkNEW_ARRAY(SkPoint, (fRows + 1) * (fCols + 1));
         memset(fTexCoords, 0, (fRows + 1) * (fCols + 1) * sizeof(SkPoint));
     }
+
+    // Keep every patch's mesh around between draws of an unchanged grid.
+    fMeshCache.reset();
+    fMeshCache.setMaxEntries(SkTMax<int>(fRows * fCols,
+                                         SkPatchUtils::MeshCache::kDefaultMaxEntries));
 }
 
 void SkPatchGrid::draw(SkCanvas* canvas, SkPaint& paint) {
@@ -166,24 +172,61 @@ void SkPatchGrid::draw(SkCanvas* canvas, SkPaint& paint) {
             maxRows[y] = SkMax32(maxRows[y], lod.height());
         }
     }
-    // Draw the patches by generating their geometry with the maximum level of detail per axis.
+    // Draw the patches with the maximum level of detail per axis. Their meshes come from the cache
+    // and are appended into as few drawVertices calls as 16 bit indices allow.
+    SkTDArray<SkPoint> points, texs;
+    SkTDArray<uint32_t> vertexColors;
+    SkTDArray<uint16_t> indices;
     for (int x = 0; x < fCols; x++) {
         for (int y = 0; y < fRows; y++) {
             SkPoint cubics[12];
             SkPoint texCoords[4];
             SkColor colors[4];
             this->getPatch(x, y, cubics, colors, texCoords);
-            SkPatchUtils::VertexData data;
-            if (SkPatchUtils::getVertexData(&data, cubics,
-                                            fModeFlags & kColors_VertexType ? colors : NULL,
-                                            fModeFlags & kTexs_VertexType ? texCoords : NULL,
-                                            maxCols[x], maxRows[y])) {
-                canvas->drawVertices(SkCanvas::kTriangles_VertexMode, data.fVertexCount,
-                                     data.fPoints, data.fTexCoords, data.fColors, fXferMode,
-                                     data.fIndices, data.fIndexCount, paint);
+            const SkPatchUtils::VertexData* data =
+                    fMeshCache.find(cubics,
+                                    fModeFlags & kColors_VertexType ? colors : NULL,
+                                    fModeFlags & kTexs_VertexType ? texCoords : NULL,
+                                    maxCols[x], maxRows[y]);
+            if (NULL == data) {
+                continue;
+            }
+            if (points.count() + data->fVertexCount > SK_MaxU16 + 1) {
+                this->drawBatch(canvas, paint, points, texs, vertexColors, indices);
+            }
+            const int base = points.count();
+            memcpy(points.append(data->fVertexCount), data->fPoints,
+                   data->fVertexCount * sizeof(SkPoint));
+            if (data->fTexCoords) {
+                memcpy(texs.append(data->fVertexCount), data->fTexCoords,
+                       data->fVertexCount * sizeof(SkPoint));
+            }
+            if (data->fColors) {
+                memcpy(vertexColors.append(data->fVertexCount), data->fColors,
+                       data->fVertexCount * sizeof(uint32_t));
+            }
+            uint16_t* dst = indices.append(data->fIndexCount);
+            for (int i = 0; i < data->fIndexCount; i++) {
+                dst[i] = SkToU16(base + data->fIndices[i]);
             }
         }
     }
+    this->drawBatch(canvas, paint, points, texs, vertexColors, indices);
     SkDELETE_ARRAY(maxCols);
     SkDELETE_ARRAY(maxRows);
 }
+
+void SkPatchGrid::drawBatch(SkCanvas* canvas, SkPaint& paint, SkTDArray<SkPoint>& points,
+                            SkTDArray<SkPoint>& texs, SkTDArray<uint32_t>& colors,
+                            SkTDArray<uint16_t>& indices) {
+    if (points.count() > 0) {
+        canvas->drawVertices(SkCanvas::kTriangles_VertexMode, points.count(), points.begin(),
+                             texs.count() ? texs.begin() : NULL,
+                             colors.count() ? colors.begin() : NULL, fXferMode,
+                             indices.begin(), indices.count(), paint);
+    }
+    points.rewind();
+    texs.rewind();
+    colors.rewind();
+    indices.rewind();
+}
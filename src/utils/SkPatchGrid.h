@@ -12,6 +12,8 @@
 #include "SkPatchUtils.h"
 #include "SkXfermode.h"
 
+template <typename T> class SkTDArray;
+
 /**
  * Class that represents a grid of patches. Adjacent patches share their corners and a color is 
  * specified at each one of them. The colors are bilinearly interpolated across the patch.
@@ -119,6 +121,8 @@ public:
      * Draws the grid of patches. The patches are drawn starting at patch (0,0) drawing columns, so 
      * for a 2x2 grid the order would be (0,0)->(0,1)->(1,0)->(1,1). The order follows the order 
      * of the parametric coordinates of the coons patch.
+     * Patch meshes are cached between draws, and as many patches as 16 bit indices allow are drawn
+     * with each drawVertices call.
      */
     void draw(SkCanvas* canvas, SkPaint& paint);
     
@@ -138,6 +142,11 @@ private:
     SkPoint* fHrzCtrlPts;
     SkPoint* fVrtCtrlPts;
     SkXfermode* fXferMode;
+    SkPatchUtils::MeshCache fMeshCache;
+
+    // Draws the accumulated patch meshes with one drawVertices call, and empties the arrays.
+    void drawBatch(SkCanvas*, SkPaint&, SkTDArray<SkPoint>& points, SkTDArray<SkPoint>& texs,
+                   SkTDArray<uint32_t>& colors, SkTDArray<uint16_t>& indices);
 };
 
 
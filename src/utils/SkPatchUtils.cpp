@@ -7,8 +7,10 @@
 
 #include "SkPatchUtils.h"
 
+#include "SkChecksum.h"
 #include "SkColorPriv.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 
 /**
  * Evaluator to sample the values of a cubic bezier using forward differences.
@@ -137,13 +139,6 @@ static SkScalar approx_arc_length(SkPoint* points, int count) {
     return arcLength;
 }
 
-static SkScalar bilerp(SkScalar tx, SkScalar ty, SkScalar c00, SkScalar c10, SkScalar c01,
-                      SkScalar c11) {
-    SkScalar a = c00 * (1.f - tx) + c10 * tx;
-    SkScalar b = c01 * (1.f - tx) + c11 * tx;
-    return a * (1.f - ty) + b * ty;
-}
-
 SkISize SkPatchUtils::GetLevelOfDetail(const SkPoint cubics[12], const SkMatrix* matrix) {
     
     // Approximate length of each cubic.
@@ -256,6 +251,36 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
     SkPatchUtils::getRightCubic(cubics, pts);
     FwDCubicEvaluator fRight(pts);
     
+    // The corner term of the Coons patch and the texture coordinates are both bilinear in
+    // (u, v), so they are interpolated together, four floats at a time: (x, y, s, t). Colors
+    // get the same treatment a channel per lane. The u half of each bilerp is done once a column.
+    const SkPoint* topPts = fTop.getCtrlPoints();
+    const SkPoint* bottomPts = fBottom.getCtrlPoints();
+    SkPoint texs[kNumCorners];
+    if (texCoords) {
+        memcpy(texs, texCoords, sizeof(texs));
+    } else {
+        memset(texs, 0, sizeof(texs));
+    }
+    const Sk4f topLeft(topPts[0].x(), topPts[0].y(),
+                       texs[kTopLeft_Corner].x(), texs[kTopLeft_Corner].y()),
+               topRight(topPts[3].x(), topPts[3].y(),
+                        texs[kTopRight_Corner].x(), texs[kTopRight_Corner].y()),
+               bottomLeft(bottomPts[0].x(), bottomPts[0].y(),
+                          texs[kBottomLeft_Corner].x(), texs[kBottomLeft_Corner].y()),
+               bottomRight(bottomPts[3].x(), bottomPts[3].y(),
+                           texs[kBottomRight_Corner].x(), texs[kBottomRight_Corner].y());
+
+    Sk4f colorCorners[kNumCorners];
+    if (colors) {
+        for (int i = 0; i < kNumCorners; i++) {
+            colorCorners[i] = Sk4f(SkScalar(SkGetPackedA32(colorsPM[i])),
+                                   SkScalar(SkGetPackedR32(colorsPM[i])),
+                                   SkScalar(SkGetPackedG32(colorsPM[i])),
+                                   SkScalar(SkGetPackedB32(colorsPM[i])));
+        }
+    }
+
     fBottom.restart(lodX);
     fTop.restart(lodX);
     
@@ -265,6 +290,17 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
         SkPoint bottom = fBottom.next(), top = fTop.next();
         fLeft.restart(lodY);
         fRight.restart(lodY);
+
+        const Sk4f u4(u), u1(1.0f - u);
+        const Sk4f cornersTop = topLeft * u1 + topRight * u4,
+                   cornersBottom = bottomLeft * u1 + bottomRight * u4;
+        Sk4f colorTop(0), colorBottom(0);
+        if (colors) {
+            colorTop = colorCorners[kTopLeft_Corner] * u1 + colorCorners[kTopRight_Corner] * u4;
+            colorBottom = colorCorners[kBottomLeft_Corner] * u1 +
+                          colorCorners[kBottomRight_Corner] * u4;
+        }
+
         SkScalar v = 0.f;
         for (int y = 0; y <= lodY; y++) {
             int dataIndex = x * (lodY + 1) + y;
@@ -275,52 +311,21 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
                                        (1.0f - v) * top.y() + v * bottom.y());
             SkPoint s1 = SkPoint::Make((1.0f - u) * left.x() + u * right.x(),
                                        (1.0f - u) * left.y() + u * right.y());
-            SkPoint s2 = SkPoint::Make(
-                                       (1.0f - v) * ((1.0f - u) * fTop.getCtrlPoints()[0].x()
-                                                     + u * fTop.getCtrlPoints()[3].x())
-                                       + v * ((1.0f - u) * fBottom.getCtrlPoints()[0].x()
-                                              + u * fBottom.getCtrlPoints()[3].x()),
-                                       (1.0f - v) * ((1.0f - u) * fTop.getCtrlPoints()[0].y()
-                                                     + u * fTop.getCtrlPoints()[3].y())
-                                       + v * ((1.0f - u) * fBottom.getCtrlPoints()[0].y()
-                                              + u * fBottom.getCtrlPoints()[3].y()));
-            data->fPoints[dataIndex] = s0 + s1 - s2;
+
+            const Sk4f v4(v), v1(1.0f - v);
+            SkScalar corners[4];
+            (cornersTop * v1 + cornersBottom * v4).store(corners);
+            data->fPoints[dataIndex] = s0 + s1 - SkPoint::Make(corners[0], corners[1]);
             
             if (colors) {
-                uint8_t a = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetA(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetA(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetA(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetA(colorsPM[kBottomRight_Corner]))));
-                uint8_t r = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetR(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetR(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetR(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetR(colorsPM[kBottomRight_Corner]))));
-                uint8_t g = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetG(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetG(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetG(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetG(colorsPM[kBottomRight_Corner]))));
-                uint8_t b = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetB(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetB(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetB(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetB(colorsPM[kBottomRight_Corner]))));
-                data->fColors[dataIndex] = SkPackARGB32(a,r,g,b);
+                SkScalar argb[4];
+                (colorTop * v1 + colorBottom * v4).store(argb);
+                data->fColors[dataIndex] = SkPackARGB32(uint8_t(argb[0]), uint8_t(argb[1]),
+                                                        uint8_t(argb[2]), uint8_t(argb[3]));
             }
             
             if (texCoords) {
-                data->fTexCoords[dataIndex] = SkPoint::Make(
-                                            bilerp(u, v, texCoords[kTopLeft_Corner].x(),
-                                                   texCoords[kTopRight_Corner].x(),
-                                                   texCoords[kBottomLeft_Corner].x(),
-                                                   texCoords[kBottomRight_Corner].x()),
-                                            bilerp(u, v, texCoords[kTopLeft_Corner].y(),
-                                                   texCoords[kTopRight_Corner].y(),
-                                                   texCoords[kBottomLeft_Corner].y(),
-                                                   texCoords[kBottomRight_Corner].y()));
-                
+                data->fTexCoords[dataIndex] = SkPoint::Make(corners[2], corners[3]);
             }
             
             if(x < lodX && y < lodY) {
@@ -339,3 +344,83 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
     return true;
 
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SkPatchUtils::MeshCache::Entry {
+    Key        fKey;
+    VertexData fData;
+    bool       fValid;
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+};
+
+SkPatchUtils::MeshCache::MeshCache(int maxEntries) : fMaxEntries(SkTMax(maxEntries, 1)) {}
+
+SkPatchUtils::MeshCache::~MeshCache() {
+    this->reset();
+}
+
+uint32_t SkPatchUtils::MeshCache::Hash(const Key& key) {
+    return SkChecksum::Fast(&key, sizeof(Key));
+}
+
+const SkPatchUtils::VertexData* SkPatchUtils::MeshCache::find(const SkPoint cubics[12],
+                                                              const SkColor colors[4],
+                                                              const SkPoint texCoords[4],
+                                                              int lodX, int lodY) {
+    if (NULL == cubics) {
+        return NULL;
+    }
+
+    Key key;
+    memset(&key, 0, sizeof(Key));
+    memcpy(key.fCubics, cubics, sizeof(key.fCubics));
+    if (colors) {
+        memcpy(key.fColors, colors, sizeof(key.fColors));
+        key.fFlags |= 1;
+    }
+    if (texCoords) {
+        memcpy(key.fTexCoords, texCoords, sizeof(key.fTexCoords));
+        key.fFlags |= 2;
+    }
+    key.fLodX = lodX;
+    key.fLodY = lodY;
+
+    Entry* entry;
+    if (Entry** found = fMap.find(key)) {
+        entry = *found;
+        fLRU.remove(entry);
+    } else {
+        entry = SkNEW(Entry);
+        entry->fKey = key;
+        // Failures are cached too, so a patch that can't be tessellated isn't retried every draw.
+        entry->fValid = getVertexData(&entry->fData, cubics, colors, texCoords, lodX, lodY);
+        fMap.set(key, entry);
+    }
+    fLRU.addToHead(entry);
+    this->purge();
+    return entry->fValid ? &entry->fData : NULL;
+}
+
+void SkPatchUtils::MeshCache::setMaxEntries(int maxEntries) {
+    fMaxEntries = SkTMax(maxEntries, 1);
+    this->purge();
+}
+
+void SkPatchUtils::MeshCache::purge() {
+    while (fMap.count() > fMaxEntries) {
+        Entry* entry = fLRU.tail();
+        fLRU.remove(entry);
+        fMap.remove(entry->fKey);
+        SkDELETE(entry);
+    }
+}
+
+void SkPatchUtils::MeshCache::reset() {
+    while (Entry* entry = fLRU.head()) {
+        fLRU.remove(entry);
+        SkDELETE(entry);
+    }
+    fMap.reset();
+}
@@ -10,6 +10,8 @@
 
 #include "SkColorPriv.h"
 #include "SkMatrix.h"
+#include "SkTGroupHash.h"
+#include "SkTInternalLList.h"
 
 class SK_API SkPatchUtils {
     
@@ -116,6 +118,57 @@ public:
     static bool getVertexData(SkPatchUtils::VertexData* data, const SkPoint cubics[12],
                               const SkColor colors[4], const SkPoint texCoords[4],
                               int lodX, int lodY);
+
+    /**
+     * Cache of patch tessellations for callers that draw the same patches frame after frame.
+     * Meshes are keyed on the patch's control points, corner colors, texture coordinates and
+     * level of detail, so a patch that moves or changes simply misses. Once the cache holds more
+     * than its limit of meshes, the least recently used ones are dropped.
+     */
+    class MeshCache : SkNoncopyable {
+    public:
+        enum { kDefaultMaxEntries = 256 };
+
+        explicit MeshCache(int maxEntries = kDefaultMaxEntries);
+        ~MeshCache();
+
+        /**
+         * Returns the tessellation of the patch, computing it with getVertexData if the cache
+         * doesn't hold it yet, or NULL if getVertexData fails. The returned data is only valid
+         * until the next call to find(), setMaxEntries() or reset().
+         */
+        const VertexData* find(const SkPoint cubics[12], const SkColor colors[4],
+                               const SkPoint texCoords[4], int lodX, int lodY);
+
+        int count() const { return fMap.count(); }
+        int maxEntries() const { return fMaxEntries; }
+        void setMaxEntries(int maxEntries);
+
+        // Drops every mesh in the cache.
+        void reset();
+
+    private:
+        // Plain data without padding, so it can be hashed and compared bytewise.
+        struct Key {
+            SkPoint  fCubics[kNumCtrlPts];
+            SkPoint  fTexCoords[kNumCorners];
+            SkColor  fColors[kNumCorners];
+            int32_t  fLodX, fLodY;
+            uint32_t fFlags;
+
+            bool operator==(const Key& that) const {
+                return 0 == memcmp(this, &that, sizeof(Key));
+            }
+        };
+        struct Entry;
+
+        static uint32_t Hash(const Key&);
+        void purge();
+
+        SkTGroupHashMap<Key, Entry*, Hash> fMap;
+        SkTInternalLList<Entry>            fLRU;   // most recently used at the head
+        int                                fMaxEntries;
+    };
 };
 
 #endif
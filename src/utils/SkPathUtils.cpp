@@ -11,6 +11,7 @@
 #include "SkPath.h"
 #include "SkPathOps.h" // this can't be found, how do I link it?
 #include "SkRegion.h"
+#include "SkTDArray.h"
 
 typedef void (*line2path)(SkPath*, const char*, int, int);
 #define SQRT_2 1.41421356237f
@@ -104,7 +105,7 @@ void SkPathUtils::BitsToPath_Path(SkPath* path,
         //l2p_fn(path, &bitmap[i*stride], i, w);
         Line2path_span(path, &bitmap[i*stride], i, w);
     }
-    Simplify(*path, path); // simplify resulting path.
+    ::Simplify(*path, path); // simplify resulting path.
 }
 
 void SkPathUtils::BitsToPath_Region(SkPath* path,
@@ -150,3 +151,98 @@ void SkPathUtils::BitsToPath_Region(SkPath* path,
     // convert region to path
     region.getBoundaryPath(path);
 }
+
+// Appends lineTos for the points of run[] that Douglas-Peucker keeps. run[0] is the current
+// point, and the last point of run[] is always kept.
+static void add_simplified_run(SkPath* dst, const SkTDArray<SkPoint>& run, SkScalar tolSqd,
+                               SkTDArray<bool>* keep, SkTDArray<int>* stack) {
+    int count = run.count();
+    if (count <= 2) {
+        if (count == 2) {
+            dst->lineTo(run[1]);
+        }
+        return;
+    }
+    keep->setCount(count);
+    memset(keep->begin(), 0, count * sizeof(bool));
+    (*keep)[count - 1] = true;
+    stack->rewind();
+    *stack->append() = 0;
+    *stack->append() = count - 1;
+    while (stack->count()) {
+        int last = stack->top();
+        stack->pop();
+        int first = stack->top();
+        stack->pop();
+        SkScalar farthestSqd = tolSqd;
+        int farthest = -1;
+        for (int index = first + 1; index < last; ++index) {
+            SkScalar distSqd = run[index].distanceToLineSegmentBetweenSqd(run[first], run[last]);
+            if (distSqd > farthestSqd) {
+                farthestSqd = distSqd;
+                farthest = index;
+            }
+        }
+        if (farthest >= 0) {
+            (*keep)[farthest] = true;
+            *stack->append() = first;
+            *stack->append() = farthest;
+            *stack->append() = farthest;
+            *stack->append() = last;
+        }
+    }
+    for (int index = 1; index < count; ++index) {
+        if ((*keep)[index]) {
+            dst->lineTo(run[index]);
+        }
+    }
+}
+
+void SkPathUtils::Simplify(const SkPath& src, SkScalar tolerance, SkPath* dst) {
+    if (!(tolerance > 0)) {
+        *dst = src;
+        return;
+    }
+    const SkScalar tolSqd = SkScalarSquare(tolerance);
+    SkPath result;
+    result.setFillType(src.getFillType());
+    result.incReserve(src.countPoints());
+    SkTDArray<SkPoint> run;
+    SkTDArray<bool> keep;
+    SkTDArray<int> stack;
+    SkPath::RawIter iter(src);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    do {
+        verb = iter.next(pts);
+        if (SkPath::kLine_Verb == verb) {
+            if (run.isEmpty()) {
+                *run.append() = pts[0];
+            }
+            *run.append() = pts[1];
+            continue;
+        }
+        add_simplified_run(&result, run, tolSqd, &keep, &stack);
+        run.rewind();
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                result.moveTo(pts[0]);
+                break;
+            case SkPath::kQuad_Verb:
+                result.quadTo(pts[1], pts[2]);
+                break;
+            case SkPath::kConic_Verb:
+                result.conicTo(pts[1], pts[2], iter.conicWeight());
+                break;
+            case SkPath::kCubic_Verb:
+                result.cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPath::kClose_Verb:
+                result.close();
+                break;
+            default:
+                break;
+        }
+    } while (SkPath::kDone_Verb != verb);
+    dst->swap(result);
+}
@@ -10,7 +10,10 @@
 #include "SkData.h"
 #include "SkPictureUtils.h"
 #include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRegion.h"
 #include "SkShader.h"
+#include "SkTextBlob.h"
 
 struct MeasureRecords {
     template <typename T> size_t operator()(const T& op) { return 0; }
@@ -26,6 +29,11 @@ size_t SkPictureUtils::ApproximateBytesUsed(const SkPicture* pict) {
     if (pict->fBBH.get()) {
         byteCount += pict->fBBH->bytesUsed();
     }
+    const SkRecordOcclusion* occlusion = static_cast<const SkRecordOcclusion*>(
+            pict->EXPERIMENTAL_getAccelData(SkRecordOcclusion::ComputeKey()));
+    if (occlusion) {
+        byteCount += occlusion->bytesUsed();
+    }
     MeasureRecords visitor;
     for (unsigned curOp = 0; curOp < pict->fRecord->count(); curOp++) {
         byteCount += pict->fRecord->visit<size_t>(curOp, visitor);
@@ -33,3 +41,280 @@ size_t SkPictureUtils::ApproximateBytesUsed(const SkPicture* pict) {
 
     return byteCount;
 }
+
+namespace {
+
+// Equal() is true if two ops of the same type are sure to draw the same, given the same state.
+// Anything we don't know how to compare is assumed to differ.
+template <typename T> bool Equal(const T&, const T&) { return false; }
+
+bool Equal(const SkPaint* a, const SkPaint* b) { return a == b || (a && b && *a == *b); }
+bool Equal(const SkRect* a, const SkRect* b)   { return a == b || (a && b && *a == *b); }
+
+bool Equal(const SkRecords::ImmutableBitmap& a, const SkRecords::ImmutableBitmap& b) {
+    // Mutable bitmaps were copied when recorded, so only shared immutable pixels match.
+    const SkBitmap bitmapA = a.shallowCopy(), bitmapB = b.shallowCopy();
+    return bitmapA.getGenerationID() == bitmapB.getGenerationID() &&
+           bitmapA.width() == bitmapB.width() && bitmapA.height() == bitmapB.height();
+}
+
+template <typename T> bool EqualArrays(const T* a, const T* b, size_t count) {
+    return a == b || (a && b && 0 == memcmp(a, b, count * sizeof(T)));
+}
+
+bool EqualText(const char* a, size_t byteLengthA, const char* b, size_t byteLengthB) {
+    return byteLengthA == byteLengthB && EqualArrays(a, b, byteLengthA);
+}
+
+using namespace SkRecords;
+
+bool Equal(const NoOp&, const NoOp&)                       { return true; }
+bool Equal(const Save&, const Save&)                       { return true; }
+bool Equal(const EndCommentGroup&, const EndCommentGroup&) { return true; }
+
+bool Equal(const Restore& a, const Restore& b) {
+    return a.devBounds == b.devBounds && a.matrix == b.matrix;
+}
+bool Equal(const SaveLayer& a, const SaveLayer& b) {
+    return Equal(a.bounds, b.bounds) && Equal(a.paint, b.paint) && a.flags == b.flags;
+}
+bool Equal(const SetMatrix& a, const SetMatrix& b) { return a.matrix == b.matrix; }
+
+bool Equal(const RegionOpAndAA& a, const RegionOpAndAA& b) {
+    return a.op == b.op && a.aa == b.aa;
+}
+bool Equal(const ClipPath& a, const ClipPath& b) {
+    return a.devBounds == b.devBounds && Equal(a.opAA, b.opAA) && a.path == b.path;
+}
+bool Equal(const ClipRRect& a, const ClipRRect& b) {
+    return a.devBounds == b.devBounds && Equal(a.opAA, b.opAA) && a.rrect == b.rrect;
+}
+bool Equal(const ClipRect& a, const ClipRect& b) {
+    return a.devBounds == b.devBounds && Equal(a.opAA, b.opAA) && a.rect == b.rect;
+}
+bool Equal(const ClipRegion& a, const ClipRegion& b) {
+    return a.devBounds == b.devBounds && a.op == b.op && a.region == b.region;
+}
+
+bool Equal(const DrawBitmap& a, const DrawBitmap& b) {
+    return a.left == b.left && a.top == b.top && Equal(a.paint, b.paint) &&
+           Equal(a.bitmap, b.bitmap);
+}
+bool Equal(const DrawBitmapNine& a, const DrawBitmapNine& b) {
+    return a.center == b.center && a.dst == b.dst && Equal(a.paint, b.paint) &&
+           Equal(a.bitmap, b.bitmap);
+}
+bool Equal(const DrawBitmapRectToRect& a, const DrawBitmapRectToRect& b) {
+    return a.dst == b.dst && Equal(a.src, b.src) && Equal(a.paint, b.paint) &&
+           Equal(a.bitmap, b.bitmap);
+}
+bool Equal(const DrawBitmapRectToRectBleed& a, const DrawBitmapRectToRectBleed& b) {
+    return a.dst == b.dst && Equal(a.src, b.src) && Equal(a.paint, b.paint) &&
+           Equal(a.bitmap, b.bitmap);
+}
+bool Equal(const DrawImage& a, const DrawImage& b) {
+    return a.left == b.left && a.top == b.top && Equal(a.paint, b.paint) &&
+           a.image->uniqueID() == b.image->uniqueID();
+}
+bool Equal(const DrawImageRect& a, const DrawImageRect& b) {
+    return a.dst == b.dst && Equal(a.src, b.src) && Equal(a.paint, b.paint) &&
+           a.image->uniqueID() == b.image->uniqueID();
+}
+bool Equal(const DrawSprite& a, const DrawSprite& b) {
+    return a.left == b.left && a.top == b.top && Equal(a.paint, b.paint) &&
+           Equal(a.bitmap, b.bitmap);
+}
+bool Equal(const DrawPicture& a, const DrawPicture& b) {
+    return a.matrix == b.matrix && Equal(a.paint, b.paint) &&
+           a.picture->uniqueID() == b.picture->uniqueID();
+}
+
+bool Equal(const DrawDRRect& a, const DrawDRRect& b) {
+    return a.outer == b.outer && a.inner == b.inner && Equal(a.paint.get(), b.paint.get());
+}
+bool Equal(const DrawOval& a, const DrawOval& b) {
+    return a.oval == b.oval && Equal(a.paint.get(), b.paint.get());
+}
+bool Equal(const DrawPaint& a, const DrawPaint& b) { return Equal(a.paint.get(), b.paint.get()); }
+bool Equal(const DrawPath& a, const DrawPath& b) {
+    return a.path == b.path && Equal(a.paint.get(), b.paint.get());
+}
+bool Equal(const DrawPoints& a, const DrawPoints& b) {
+    return a.mode == b.mode && a.count == b.count && EqualArrays(a.pts, b.pts, a.count) &&
+           Equal(a.paint.get(), b.paint.get());
+}
+bool Equal(const DrawRRect& a, const DrawRRect& b) {
+    return a.rrect == b.rrect && Equal(a.paint.get(), b.paint.get());
+}
+bool Equal(const DrawRect& a, const DrawRect& b) {
+    return a.rect == b.rect && Equal(a.paint.get(), b.paint.get());
+}
+bool Equal(const DrawRects& a, const DrawRects& b) {
+    return a.count == b.count && EqualArrays<SkRect>(a.rects, b.rects, a.count) &&
+           Equal(a.paint.get(), b.paint.get());
+}
+
+bool Equal(const DrawText& a, const DrawText& b) {
+    return a.x == b.x && a.y == b.y && Equal(a.paint.get(), b.paint.get()) &&
+           EqualText(a.text, a.byteLength, b.text, b.byteLength);
+}
+bool Equal(const DrawPosText& a, const DrawPosText& b) {
+    return Equal(a.paint.get(), b.paint.get()) &&
+           EqualText(a.text, a.byteLength, b.text, b.byteLength) &&
+           EqualArrays<SkPoint>(a.pos, b.pos, a.paint->countText(a.text, a.byteLength));
+}
+bool Equal(const DrawPosTextH& a, const DrawPosTextH& b) {
+    return a.y == b.y && Equal(a.paint.get(), b.paint.get()) &&
+           EqualText(a.text, a.byteLength, b.text, b.byteLength) &&
+           EqualArrays<SkScalar>(a.xpos, b.xpos, a.paint->countText(a.text, a.byteLength));
+}
+bool Equal(const DrawTextBlob& a, const DrawTextBlob& b) {
+    return a.x == b.x && a.y == b.y && Equal(a.paint.get(), b.paint.get()) &&
+           a.blob->uniqueID() == b.blob->uniqueID();
+}
+bool Equal(const DrawTextOnPath& a, const DrawTextOnPath& b) {
+    return a.matrix == b.matrix && a.path == b.path && Equal(a.paint.get(), b.paint.get()) &&
+           EqualText(a.text, a.byteLength, b.text, b.byteLength);
+}
+
+// Visit one op with GetOp, then another with SameOp to compare them.
+struct GetOp {
+    template <typename T> void operator()(const T& op) {
+        fType = T::kType;
+        fOp = &op;
+    }
+
+    Type fType;
+    const void* fOp;
+};
+
+struct SameOp {
+    explicit SameOp(const GetOp& a) : fA(a) {}
+
+    template <typename T> bool operator()(const T& b) {
+        return T::kType == fA.fType && Equal(*static_cast<const T*>(fA.fOp), b);
+    }
+
+    const GetOp& fA;
+};
+
+// Walks two pictures' ops in step, resyncing after inserted, deleted, or changed ops.
+class Damage {
+public:
+    Damage(const SkRecord& before, const SkRect& beforeCull,
+           const SkRecord& after,  const SkRect& afterCull,
+           const SkMatrix& matrix, SkRegion* damage)
+        : fBefore(before)
+        , fAfter(after)
+        , fBeforeBounds(before.count())
+        , fAfterBounds(after.count())
+        , fMatrix(matrix)
+        , fDamage(damage) {
+        // Both pictures' bounds are in identity space, but are clamped to their own cull rects.
+        SkRecordFillBounds(beforeCull, fBefore, fBeforeBounds.get());
+        SkRecordFillBounds(afterCull,  fAfter,  fAfterBounds.get());
+        fDamage->setEmpty();
+        if (beforeCull != afterCull) {
+            this->damage(beforeCull);
+            this->damage(afterCull);
+        }
+    }
+
+    void compute() {
+        unsigned i = 0, j = 0;
+        while (i < fBefore.count() && j < fAfter.count()) {
+            if (this->match(i, j)) {
+                i++;
+                j++;
+                continue;
+            }
+            // Look a little way ahead for the nearest op of one picture matching the next op of
+            // the other.  The ops skipped on the way were deleted or inserted.
+            unsigned skip = 1;
+            for (; skip <= kLookAhead; skip++) {
+                if (i + skip < fBefore.count() && this->same(i + skip, j)) {
+                    this->damageBefore(i, i + skip);
+                    i += skip;
+                    break;
+                }
+                if (j + skip < fAfter.count() && this->same(i, j + skip)) {
+                    this->damageAfter(j, j + skip);
+                    j += skip;
+                    break;
+                }
+            }
+            if (skip > kLookAhead) {
+                // No luck.  Call it a changed op.
+                this->damageBefore(i, i + 1);
+                this->damageAfter(j, j + 1);
+                i++;
+                j++;
+            }
+        }
+        this->damageBefore(i, fBefore.count());
+        this->damageAfter(j, fAfter.count());
+    }
+
+private:
+    static const unsigned kLookAhead = 32;
+
+    bool same(unsigned i, unsigned j) const {
+        GetOp a;
+        fBefore.visit<void>(i, a);
+        SameOp same(a);
+        return fAfter.visit<bool>(j, same);
+    }
+
+    // Equal ops draw the same given the same state.  If their bounds differ, their state does
+    // too, so they are both damage.  If not, any op changing their state damages them already.
+    bool match(unsigned i, unsigned j) {
+        if (!this->same(i, j)) {
+            return false;
+        }
+        if (fBeforeBounds[i] != fAfterBounds[j]) {
+            this->damage(fBeforeBounds[i]);
+            this->damage(fAfterBounds[j]);
+        }
+        return true;
+    }
+
+    void damageBefore(unsigned start, unsigned stop) {
+        for (unsigned i = start; i < stop; i++) {
+            this->damage(fBeforeBounds[i]);
+        }
+    }
+    void damageAfter(unsigned start, unsigned stop) {
+        for (unsigned j = start; j < stop; j++) {
+            this->damage(fAfterBounds[j]);
+        }
+    }
+
+    void damage(const SkRect& bounds) {
+        if (bounds.isEmpty()) {
+            return;
+        }
+        SkRect devBounds;
+        fMatrix.mapRect(&devBounds, bounds);
+        SkIRect pixels;
+        devBounds.roundOut(&pixels);
+        // Antialiased edges can touch the pixels just outside.
+        pixels.outset(1, 1);
+        fDamage->op(pixels, SkRegion::kUnion_Op);
+    }
+
+    const SkRecord& fBefore;
+    const SkRecord& fAfter;
+    SkAutoTMalloc<SkRect> fBeforeBounds;
+    SkAutoTMalloc<SkRect> fAfterBounds;
+    const SkMatrix& fMatrix;
+    SkRegion* fDamage;
+};
+
+}  // namespace
+
+void SkPictureUtils::ComputeDamage(const SkPicture* before, const SkPicture* after,
+                                   const SkMatrix& matrix, SkRegion* damage) {
+    SkASSERT(before && after && damage);
+    Damage(*before->fRecord, before->cullRect(), *after->fRecord, after->cullRect(),
+           matrix, damage).compute();
+}
@@ -13,11 +13,29 @@ static inline int is_ws(int c)
     return !((c - 1) >> 5);
 }
 
+// Like SkPaint::breakText(), but from advances already measured for each character.
+static size_t measure_break(const char text[], const char stop[], const SkScalar advances[],
+                           SkScalar margin)
+{
+    const char* start = text;
+    SkScalar width = 0;
+    while (text < stop) {
+        width += *advances++;
+        if (width > margin) {
+            break;
+        }
+        text += SkUTF8_LeadByteToCount(*(const uint8_t*)text);
+    }
+    return SkTMin<size_t>(text - start, stop - start);
+}
+
 static size_t linebreak(const char text[], const char stop[],
                         const SkPaint& paint, SkScalar margin,
+                        const SkScalar advances[] = NULL,
                         size_t* trailing = NULL)
 {
-    size_t lengthBreak = paint.breakText(text, stop - text, margin);
+    size_t lengthBreak = advances ? measure_break(text, stop, advances, margin)
+                                  : paint.breakText(text, stop - text, margin);
 
     //Check for white space or line breakers before the lengthBreak
     const char* start = text;
@@ -97,16 +115,50 @@ static size_t linebreak(const char text[], const char stop[],
 
 int SkTextLineBreaker::CountLines(const char text[], size_t len, const SkPaint& paint, SkScalar width)
 {
+    return BreakLines(text, len, paint, width, NULL);
+}
+
+int SkTextLineBreaker::BreakLines(const char text[], size_t len, const SkPaint& paint,
+                                  SkScalar width, SkTDArray<Line>* lines)
+{
+    if (width <= 0) {
+        return 0;
+    }
+
+    // Measure all the characters in one pass through the glyph cache, rather than looking the
+    // cache up again for every line with SkPaint::breakText(). Dev-kerned text is still measured
+    // a line at a time, since its kerning depends on where the measuring starts.
+    SkAutoSTMalloc<128, SkScalar> storage;
+    const SkScalar* advances = NULL;
+    if (len > 0 && SkPaint::kUTF8_TextEncoding == paint.getTextEncoding() &&
+            !paint.isDevKernText()) {
+        int charCount = SkUTF8_CountUnichars(text, len);
+        if (charCount > 0) {
+            storage.reset(charCount);
+            if (paint.getTextWidths(text, len, storage.get()) == charCount) {
+                advances = storage.get();
+            }
+        }
+    }
+
+    const char* start = text;
     const char* stop = text + len;
     int         count = 0;
 
-    if (width > 0)
-    {
-        do {
-            count += 1;
-            text += linebreak(text, stop, paint, width);
-        } while (text < stop);
-    }
+    do {
+        size_t trailing;
+        size_t lineLen = linebreak(text, stop, paint, width, advances, &trailing);
+        if (lines) {
+            Line* line = lines->append();
+            line->fOffset = text - start;
+            line->fLength = lineLen - trailing;
+        }
+        if (advances) {
+            advances += SkUTF8_CountUnichars(text, lineLen);
+        }
+        count += 1;
+        text += lineLen;
+    } while (text < stop);
     return count;
 }
 
@@ -119,6 +171,7 @@ SkTextBox::SkTextBox()
     fSpacingAdd = 0;
     fMode = kLineBreak_Mode;
     fSpacingAlign = kStart_SpacingAlign;
+    fLinesWidth = -1;   // nothing broken into lines yet
 }
 
 void SkTextBox::setMode(Mode mode)
@@ -165,6 +218,23 @@ void SkTextBox::setSpacing(SkScalar mul, SkScalar add)
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 
+const SkTDArray<SkTextLineBreaker::Line>& SkTextBox::breakLines(const char text[], size_t len,
+                                                                const SkPaint& paint) const {
+    SkScalar width = fBox.width();
+    // The lines don't depend on the paint's color, so don't let it spoil the comparison.
+    fLinesPaint.setColor(paint.getColor());
+    if (width != fLinesWidth || !(fLinesPaint == paint) || len != fLinesText.size() ||
+            (len > 0 && memcmp(text, fLinesText.c_str(), len))) {
+        fLines.rewind();
+        SkTextLineBreaker::BreakLines(text, len, paint, width, &fLines);
+        fLinesText.set(text, len);
+        fLinesWidth = width;
+        fLinesPaint = paint;
+        fLinesFontHeight = paint.getFontMetrics(&fLinesMetrics);
+    }
+    return fLines;
+}
+
 SkScalar SkTextBox::visit(Visitor& visitor, const char text[], size_t len,
                           const SkPaint& paint) const {
     SkScalar marginWidth = fBox.width();
@@ -173,10 +243,11 @@ SkScalar SkTextBox::visit(Visitor& visitor, const char text[], size_t len,
         return fBox.top();
     }
 
-    const char* textStop = text + len;
+    const SkTDArray<SkTextLineBreaker::Line>& lines = this->breakLines(text, len, paint);
+    SkASSERT(lines.count() > 0);
 
     SkScalar                x, y, scaledSpacing, height, fontHeight;
-    SkPaint::FontMetrics    metrics;
+    const SkPaint::FontMetrics& metrics = fLinesMetrics;
 
     switch (paint.getTextAlign()) {
     case SkPaint::kLeft_Align:
@@ -191,7 +262,7 @@ SkScalar SkTextBox::visit(Visitor& visitor, const char text[], size_t len,
     }
     x += fBox.fLeft;
 
-    fontHeight = paint.getFontMetrics(&metrics);
+    fontHeight = fLinesFontHeight;
     scaledSpacing = SkScalarMul(fontHeight, fSpacingMul) + fSpacingAdd;
     height = fBox.height();
 
@@ -200,9 +271,7 @@ SkScalar SkTextBox::visit(Visitor& visitor, const char text[], size_t len,
         SkScalar textHeight = fontHeight;
 
         if (fMode == kLineBreak_Mode && fSpacingAlign != kStart_SpacingAlign) {
-            int count = SkTextLineBreaker::CountLines(text, textStop - text, paint, marginWidth);
-            SkASSERT(count > 0);
-            textHeight += scaledSpacing * (count - 1);
+            textHeight += scaledSpacing * (lines.count() - 1);
         }
 
         switch (fSpacingAlign) {
@@ -220,14 +289,12 @@ SkScalar SkTextBox::visit(Visitor& visitor, const char text[], size_t len,
         y += fBox.fTop - metrics.fAscent;
     }
 
-    for (;;) {
-        size_t trailing;
-        len = linebreak(text, textStop, paint, marginWidth, &trailing);
+    for (int i = 0;; ++i) {
+        const SkTextLineBreaker::Line& line = lines[i];
         if (y + metrics.fDescent + metrics.fLeading > 0) {
-            visitor(text, len - trailing, x, y, paint);
+            visitor(text + line.fOffset, line.fLength, x, y, paint);
         }
-        text += len;
-        if (text >= textStop) {
+        if (i + 1 == lines.count()) {
             break;
         }
         y += scaledSpacing;
@@ -267,7 +334,7 @@ void SkTextBox::draw(SkCanvas* canvas) {
 }
 
 int SkTextBox::countLines() const {
-    return SkTextLineBreaker::CountLines(fText, fLen, *fPaint, fBox.width());
+    return this->breakLines(fText, fLen, *fPaint).count();
 }
 
 SkScalar SkTextBox::getTextHeight() const {
@@ -12,6 +12,7 @@
 
 #include "SkBitmap.h"
 #include "SkBitmapProcShader.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkEndian.h"
 
@@ -31,6 +32,48 @@ static bool compress_etc1_565(uint8_t* dst, const uint8_t* src,
 #endif
 }
 
+static void n32_to_rgb888(uint8_t* dst, const SkPMColor* src, int count) {
+    for (int i = 0; i < count; ++i) {
+        dst[0] = SkGetPackedR32(src[i]);
+        dst[1] = SkGetPackedG32(src[i]);
+        dst[2] = SkGetPackedB32(src[i]);
+        dst += 3;
+    }
+}
+
+// libetc1 only takes 565 or RGB pixels, so repack each row of blocks as RGB and encode that.
+// Alpha is dropped.
+static bool compress_etc1_8888(uint8_t* dst, const uint8_t* src,
+                               int width, int height, size_t rowBytes) {
+#ifndef SK_IGNORE_ETC1_SUPPORT
+    if ((width & 3) || (height & 3)) {
+        return false;
+    }
+    SkTextureCompressorRGB888Proc proc = SkTextureCompressorGetPlatformRGB888Proc();
+    if (NULL == proc) {
+        proc = n32_to_rgb888;
+    }
+
+    const int rgbRowBytes = 3 * width;
+    SkAutoTMalloc<uint8_t> rgb(4 * rgbRowBytes);
+    const size_t encodedRowBytes = SkTextureCompressor::GetCompressedDataSize(
+            SkTextureCompressor::kETC1_Format, width, 4);
+    for (int y = 0; y < height; y += 4) {
+        for (int row = 0; row < 4; ++row) {
+            proc(rgb.get() + row * rgbRowBytes,
+                 reinterpret_cast<const SkPMColor*>(src + (y + row) * rowBytes), width);
+        }
+        if (0 != etc1_encode_image(rgb.get(), width, 4, 3, rgbRowBytes, dst)) {
+            return false;
+        }
+        dst += encodedRowBytes;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace SkTextureCompressor {
@@ -160,6 +203,19 @@ bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcCol
             }
             break;
 
+            case kN32_SkColorType:
+            {
+                switch (format) {
+                    case kETC1_Format:
+                        proc = compress_etc1_8888;
+                        break;
+                    default:
+                        // Do nothing...
+                        break;
+                }
+            }
+            break;
+
             default:
                 // Do nothing...
                 break;
@@ -176,6 +232,11 @@ bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcCol
 SkData* CompressBitmapToFormat(const SkBitmap &bitmap, Format format) {
     SkAutoLockPixels alp(bitmap);
 
+    // ETC1 has nowhere to keep alpha.
+    if (kETC1_Format == format && !bitmap.isOpaque()) {
+        return NULL;
+    }
+
     int compressedDataSize = GetCompressedDataSize(format, bitmap.width(), bitmap.height());
     if (compressedDataSize < 0) {
         return NULL;
@@ -23,11 +23,8 @@ namespace SkTextureCompressor {
         kR11_EAC_Format,    // 4x4 blocks, (de)compresses A8
 
         // RGB only formats
-        kETC1_Format,       // 4x4 blocks, compresses RGB 565, decompresses 8-bit RGB
-                            //    NOTE: ETC1 supports 8-bit RGB compression, but we
-                            //    currently don't have any RGB8 SkColorTypes. We could
-                            //    support 8-bit RGBA but we would have to preprocess the
-                            //    bitmap to insert alphas.
+        kETC1_Format,       // 4x4 blocks, compresses RGB 565 and opaque N32 (dropping
+                            //    alpha), decompresses 8-bit RGB
 
         // Multi-purpose formats
         kASTC_4x4_Format,   // 4x4 blocks, no compression, decompresses RGBA
@@ -124,6 +124,10 @@ void SkAndroidSDKCanvas::onDrawRect(const SkRect& r, const SkPaint& paint) {
     FILTER(paint);
     fProxyTarget->drawRect(r, filteredPaint);
 }
+void SkAndroidSDKCanvas::onDrawRects(const SkRect r[], int count, const SkPaint& paint) {
+    FILTER(paint);
+    fProxyTarget->drawRects(r, count, filteredPaint);
+}
 void SkAndroidSDKCanvas::onDrawRRect(const SkRRect& r, const SkPaint& paint) {
     FILTER(paint);
     fProxyTarget->drawRRect(r, filteredPaint);
@@ -38,6 +38,7 @@ protected:
                       const SkPaint& paint) override;
     void onDrawOval(const SkRect& r, const SkPaint& paint) override;
     void onDrawRect(const SkRect& r, const SkPaint& paint) override;
+    void onDrawRects(const SkRect r[], int count, const SkPaint& paint) override;
     void onDrawRRect(const SkRRect& r, const SkPaint& paint) override;
     void onDrawPath(const SkPath& path, const SkPaint& paint) override;
     void onDrawBitmap(const SkBitmap& bitmap, SkScalar left, SkScalar top,
@@ -485,6 +485,12 @@ void SkDebugCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     addDrawCommand(new SkDrawRectCommand(rect, paint));
 }
 
+void SkDebugCanvas::onDrawRects(const SkRect rects[], int count, const SkPaint& paint) {
+    for (int i = 0; i < count; ++i) {
+        this->onDrawRect(rects[i], paint);
+    }
+}
+
 void SkDebugCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     this->addDrawCommand(new SkDrawRRectCommand(rrect, paint));
 }
@@ -7,6 +7,7 @@
  */
 #include "SkView.h"
 #include "SkCanvas.h"
+#include "SkPictureRecorder.h"
 
 ////////////////////////////////////////////////////////////////////////
 
@@ -17,11 +18,13 @@ SkView::SkView(uint32_t flags) : fFlags(SkToU8(flags))
     fParent = fFirstChild = fNextSibling = fPrevSibling = NULL;
     fMatrix.setIdentity();
     fContainsFocus = 0;
+    fPicture = NULL;
 }
 
 SkView::~SkView()
 {
     this->detachAllChildren();
+    SkSafeUnref(fPicture);
 }
 
 void SkView::setFlags(uint32_t flags)
@@ -35,6 +38,9 @@ void SkView::setFlags(uint32_t flags)
 
     fFlags = SkToU8(flags);
 
+    if (diff & kCachePicture_Mask)
+        SkSafeSetNull(fPicture);
+
     if (diff & kVisible_Mask)
     {
         this->inval(NULL);
@@ -60,6 +66,10 @@ void SkView::setClipToBounds(bool pred) {
     this->setFlags(SkSetClearShift(fFlags, !pred, kNoClip_Shift));
 }
 
+void SkView::setCachePicture(bool pred) {
+    this->setFlags(SkSetClearShift(fFlags, pred, kCachePicture_Shift));
+}
+
 void SkView::setSize(SkScalar width, SkScalar height)
 {
     width = SkMaxScalar(0, width);
@@ -124,7 +134,7 @@ void SkView::draw(SkCanvas* canvas)
         }
 
         int sc = canvas->save();
-        this->onDraw(canvas);
+        this->drawContent(canvas);
         canvas->restoreToCount(sc);
 
         if (fParent) {
@@ -143,10 +153,33 @@ void SkView::draw(SkCanvas* canvas)
     }
 }
 
+void SkView::drawContent(SkCanvas* canvas) {
+    if (!this->isCachePicture()) {
+        this->onDraw(canvas);
+        return;
+    }
+    if (NULL == fPicture) {
+        SkRect bounds;
+        if (this->isClipToBounds()) {
+            this->getLocalBounds(&bounds);
+        } else {
+            // the view may draw anywhere, so don't let the picture's bounds cull any of it
+            bounds = SkRect::MakeLargest();
+        }
+        SkPictureRecorder recorder;
+        this->onDraw(recorder.beginRecording(bounds));
+        fPicture = recorder.endRecording();
+    }
+    canvas->drawPicture(fPicture);
+}
+
 void SkView::inval(SkRect* rect) {
     SkView*    view = this;
     SkRect storage;
 
+    // only this view's own drawing is recorded, so its parents' pictures are still good
+    SkSafeSetNull(fPicture);
+
     for (;;) {
         if (!view->isVisible()) {
             return;
@@ -674,7 +707,7 @@ void SkView::onInflate(const SkDOM& dom, const SkDOM::Node* node) {
     // inflate the flags
 
     static const char* gFlagNames[] = {
-        "visible", "enabled", "focusable", "flexH", "flexV"
+        "visible", "enabled", "focusable", "flexH", "flexV", "noClip", "cachePicture"
     };
     SkASSERT(SK_ARRAY_COUNT(gFlagNames) == kFlagShiftCount);
 
@@ -190,15 +190,21 @@ const char* SkDOM::AttrIter::next(const char** value)
 #include "SkXMLParser.h"
 #include "SkTDArray.h"
 
-static char* dupstr(SkChunkAlloc* chunk, const char src[])
+static char* dupstr(SkChunkAlloc* chunk, const char src[], size_t len)
 {
     SkASSERT(chunk && src);
-    size_t  len = strlen(src);
     char*   dst = (char*)chunk->alloc(len + 1, SkChunkAlloc::kThrow_AllocFailType);
-    memcpy(dst, src, len + 1);
+    memcpy(dst, src, len);
+    dst[len] = 0;
     return dst;
 }
 
+static char* dupstr(SkChunkAlloc* chunk, const char src[])
+{
+    SkASSERT(chunk && src);
+    return dupstr(chunk, src, strlen(src));
+}
+
 class SkDOMParser : public SkXMLParser {
 public:
     SkDOMParser(SkChunkAlloc* chunk) : SkXMLParser(&fParserError), fAlloc(chunk)
@@ -246,7 +252,7 @@ protected:
     }
 
     bool onStartElement(const char elem[]) override {
-        this->startCommon(elem, SkDOM::kElement_Type);
+        this->startCommon(elem, strlen(elem), SkDOM::kElement_Type);
         return false;
     }
 
@@ -257,6 +263,13 @@ protected:
         return false;
     }
 
+    bool onAddAttributeLen(const char name[], const char value[], size_t len) override {
+        SkDOM::Attr* attr = fAttrs.append();
+        attr->fName = dupstr(fAlloc, name);
+        attr->fValue = dupstr(fAlloc, value, len);
+        return false;
+    }
+
     bool onEndElement(const char elem[]) override {
         --fLevel;
         if (fNeedToFlush)
@@ -281,20 +294,20 @@ protected:
     }
 
     bool onText(const char text[], int len) override {
-        SkString str(text, len);
-        this->startCommon(str.c_str(), SkDOM::kText_Type);
-        this->SkDOMParser::onEndElement(str.c_str());
+        // text isn't nul terminated, so it's copied by length
+        this->startCommon(text, len, SkDOM::kText_Type);
+        this->SkDOMParser::onEndElement(fElemName);
 
         return false;
     }
 
 private:
-    void startCommon(const char elem[], SkDOM::Type type) {
+    void startCommon(const char elem[], size_t len, SkDOM::Type type) {
         if (fLevel > 0 && fNeedToFlush)
             this->flushAttributes();
 
         fNeedToFlush = true;
-        fElemName = dupstr(fAlloc, elem);
+        fElemName = dupstr(fAlloc, elem, len);
         fElemType = type;
         ++fLevel;
     }
@@ -312,9 +325,15 @@ private:
 };
 
 const SkDOM::Node* SkDOM::build(const char doc[], size_t len)
+{
+    SkMemoryStream docStream(doc, len, false);
+    return this->build(docStream);
+}
+
+const SkDOM::Node* SkDOM::build(SkStream& docStream)
 {
     SkDOMParser parser(&fAlloc);
-    if (!parser.parse(doc, len))
+    if (!parser.parse(docStream))
     {
         SkDEBUGCODE(SkDebugf("xml parse error, line %d\n", parser.fParserError.getLineNumber());)
         fRoot = NULL;
@@ -8,6 +8,7 @@
 
 
 #include "SkXMLParser.h"
+#include "SkStream.h"
 
 static char const* const gErrorStrings[] = {
     "empty or missing file ",
@@ -61,17 +62,85 @@ SkXMLParser::~SkXMLParser()
 
 bool SkXMLParser::parse(SkStream& docStream)
 {
-    return false;
+    SkXMLPullParser pull(&docStream);
+    fParser = &pull;
+
+    bool success = false;
+    for (;;)
+    {
+        SkXMLPullParser::EventType type = pull.nextToken();
+        bool stop = false;
+        switch (type) {
+        case SkXMLPullParser::START_TAG:
+        {
+            stop = this->startElement(pull.getName());
+            const int count = pull.getAttributeCount();
+            for (int i = 0; i < count && !stop; i++)
+            {
+                SkXMLPullParser::AttrInfo info;
+                pull.getAttributeInfo(i, &info);
+                stop = this->addAttributeLen(info.fName, info.fValue, info.fValueLength);
+            }
+            break;
+        }
+        case SkXMLPullParser::END_TAG:
+            stop = this->endElement(pull.getName());
+            break;
+        case SkXMLPullParser::TEXT:
+            if (pull.isWhitespace())
+                break;
+            // fall through
+        case SkXMLPullParser::CDSECT:
+            stop = this->text(pull.getText(), SkToInt(pull.getTextLength()));
+            break;
+        case SkXMLPullParser::END_DOCUMENT:
+            success = true;
+            stop = true;
+            break;
+        case SkXMLPullParser::ERROR:
+            this->reportError(&pull);
+            stop = true;
+            break;
+        default:
+            break;
+        }
+        if (stop)
+            break;
+    }
+
+    fParser = NULL;
+    return success;
 }
 
 bool SkXMLParser::parse(const char doc[], size_t len)
 {
-    return false;
+    SkMemoryStream docStream(doc, len, false);
+    return this->parse(docStream);
 }
 
-void SkXMLParser::GetNativeErrorString(int error, SkString* str)
+void SkXMLParser::reportError(void* parser)
 {
+    if (NULL == fError)
+        return;
+
+    SkXMLPullParser* pull = static_cast<SkXMLPullParser*>(parser);
+    fError->fNativeCode = pull->getError();
+    fError->fLineNumber = pull->getLineNumber();
+}
 
+void SkXMLParser::GetNativeErrorString(int error, SkString* str)
+{
+    static char const* const gNativeErrorStrings[] = {
+        "no error",
+        "no document",
+        "unexpected end of document",
+        "malformed tag",
+        "mismatched tag",
+        "junk outside the root element"
+    };
+
+    if ((unsigned)error < SK_ARRAY_COUNT(gNativeErrorStrings))
+        str->set(gNativeErrorStrings[error]);
 }
 
 bool SkXMLParser::startElement(const char elem[])
@@ -84,6 +153,11 @@ bool SkXMLParser::addAttribute(const char name[], const char value[])
     return this->onAddAttribute(name, value);
 }
 
+bool SkXMLParser::addAttributeLen(const char name[], const char value[], size_t len)
+{
+    return this->onAddAttributeLen(name, value, len);
+}
+
 bool SkXMLParser::endElement(const char elem[])
 {
     return this->onEndElement(elem);
@@ -98,5 +172,8 @@ bool SkXMLParser::text(const char text[], int len)
 
 bool SkXMLParser::onStartElement(const char elem[]) {return false; }
 bool SkXMLParser::onAddAttribute(const char name[], const char value[]) {return false; }
+bool SkXMLParser::onAddAttributeLen(const char name[], const char value[], size_t len) {
+    return this->onAddAttribute(name, value);
+}
 bool SkXMLParser::onEndElement(const char elem[]) { return false; }
 bool SkXMLParser::onText(const char text[], int len) {return false; }
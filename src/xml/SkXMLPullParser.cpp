@@ -1,4 +1,3 @@
-
 /*
  * Copyright 2011 Google Inc.
  *
@@ -7,26 +6,43 @@
  */
 #include "SkXMLParser.h"
 #include "SkStream.h"
+#include "SkUtils.h"
+
+// The window starts this big, and doubles whenever a single token doesn't fit.
+static const size_t kInitialCapacity = 16 * 1024;
 
 static void reset(SkXMLPullParser::Curr* curr)
 {
     curr->fEventType = SkXMLPullParser::ERROR;
     curr->fName = "";
+    curr->fNameLength = 0;
+    curr->fAttrInfos = NULL;
     curr->fAttrInfoCount = 0;
     curr->fIsWhitespace = false;
 }
 
-SkXMLPullParser::SkXMLPullParser() : fStream(NULL)
+static bool is_space(char c)
 {
-    fCurr.fEventType = ERROR;
-    fDepth = -1;
+    return ' ' == c || '\t' == c || '\n' == c || '\r' == c;
 }
 
-SkXMLPullParser::SkXMLPullParser(SkStream* stream) : fStream(NULL)
+static bool is_all_space(const char text[], size_t length)
 {
-    fCurr.fEventType = ERROR;
-    fDepth = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (!is_space(text[i])) {
+            return false;
+        }
+    }
+    return true;
+}
 
+SkXMLPullParser::SkXMLPullParser() : fStream(NULL), fCapacity(0)
+{
+    this->setStream(NULL);
+}
+
+SkXMLPullParser::SkXMLPullParser(SkStream* stream) : fStream(NULL), fCapacity(0)
+{
     this->setStream(stream);
 }
 
@@ -37,21 +53,23 @@ SkXMLPullParser::~SkXMLPullParser()
 
 SkStream* SkXMLPullParser::setStream(SkStream* stream)
 {
-    if (fStream && !stream)
+    if (fStream)
         this->onExit();
 
-    SkRefCnt_SafeAssign(fStream, stream);
+    fStream = stream;
+    reset(&fCurr);
+    fDepth = 0;
 
-    if (fStream)
+    if (fStream && this->onInit())
     {
         fCurr.fEventType = START_DOCUMENT;
-        this->onInit();
     }
     else
     {
         fCurr.fEventType = ERROR;
+        fError = kNoStream_Error;
+        fLine = fTokenLine = 0;
     }
-    fDepth = 0;
 
     return fStream;
 }
@@ -98,12 +116,21 @@ const char* SkXMLPullParser::getText()
     switch (fCurr.fEventType) {
     case TEXT:
     case IGNORABLE_WHITESPACE:
+    case CDSECT:
+    case COMMENT:
+    case PROCESSING_INSTRUCTION:
+    case DOCDECL:
         return fCurr.fName;
     default:
         return NULL;
     }
 }
 
+size_t SkXMLPullParser::getTextLength()
+{
+    return this->getText() ? fCurr.fNameLength : 0;
+}
+
 bool SkXMLPullParser::isWhitespace()
 {
     switch (fCurr.fEventType) {
@@ -133,6 +160,464 @@ void SkXMLPullParser::getAttributeInfo(int index, AttrInfo* info)
 bool SkXMLPullParser::onEntityReplacement(const char name[],
                                           SkString* replacement)
 {
-    // TODO: std 5 entities here
+    // the five predefined entities and character references are decoded before we're called
     return false;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// The tokenizer. Each token is found in full first, reading more of the stream as needed,
+// then taken out of the window and parsed in place.
+
+bool SkXMLPullParser::onInit()
+{
+    if (0 == fCapacity)
+    {
+        fCapacity = kInitialCapacity;
+        // one spare byte, so that text at the very end can be nul terminated
+        fBuffer.reset(fCapacity + 1);
+    }
+    fPos = fEnd = 0;
+    fStreamEnded = false;
+    fAttrs.rewind();
+    fOpenNames.rewind();
+    fOpenNameStarts.rewind();
+    fPendingEndTag = false;
+    fSeenRoot = false;
+    fError = kNone_Error;
+    fLine = fTokenLine = 1;
+    return true;
+}
+
+void SkXMLPullParser::onExit()
+{
+    fBuffer.reset(0);
+    fCapacity = 0;
+    fAttrs.reset();
+    fOpenNames.reset();
+    fOpenNameStarts.reset();
+}
+
+bool SkXMLPullParser::fill()
+{
+    if (fStreamEnded)
+        return false;
+
+    if (fPos > 0)
+    {
+        memmove(fBuffer.get(), fBuffer.get() + fPos, fEnd - fPos);
+        fEnd -= fPos;
+        fPos = 0;
+    }
+    if (fEnd == fCapacity)
+    {
+        fCapacity *= 2;
+        fBuffer.realloc(fCapacity + 1);
+    }
+
+    size_t bytes = fStream->read(fBuffer.get() + fEnd, fCapacity - fEnd);
+    if (0 == bytes)
+    {
+        fStreamEnded = true;
+        return false;
+    }
+    fEnd += bytes;
+    return true;
+}
+
+bool SkXMLPullParser::ensure(size_t length)
+{
+    while (fEnd - fPos < length)
+        if (!this->fill())
+            return false;
+    return true;
+}
+
+// Returns the offset from fPos of the first match of pattern at or after from, or 0 if the stream
+// ends first.
+size_t SkXMLPullParser::find(size_t from, const char pattern[], size_t patternLength)
+{
+    SkASSERT(from > 0 && patternLength > 0);
+    for (;;)
+    {
+        const char* buffer = fBuffer.get() + fPos;
+        const size_t available = fEnd - fPos;
+        while (from + patternLength <= available)
+        {
+            const char* hit = (const char*)memchr(buffer + from, pattern[0],
+                                                  available - patternLength + 1 - from);
+            if (NULL == hit)
+            {
+                from = available - patternLength + 1;
+                break;
+            }
+            from = hit - buffer;
+            if (!memcmp(hit, pattern, patternLength))
+                return from;
+            from += 1;
+        }
+        if (!this->fill())
+            return 0;
+    }
+}
+
+// Returns the length of the tag at fPos through its closing '>', or 0 if the stream ends first.
+// A '>' in a quoted attribute value doesn't close the tag.
+size_t SkXMLPullParser::tagLength()
+{
+    char quote = 0;
+    for (size_t i = 1;; i++)
+    {
+        while (fPos + i >= fEnd)
+            if (!this->fill())
+                return 0;
+
+        const char c = fBuffer[fPos + i];
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if ('"' == c || '\'' == c)
+            quote = c;
+        else if ('>' == c)
+            return i + 1;
+    }
+}
+
+// Like tagLength(), but skips over the internal subset in [brackets] too.
+size_t SkXMLPullParser::docDeclLength()
+{
+    char quote = 0;
+    int depth = 0;
+    for (size_t i = 1;; i++)
+    {
+        while (fPos + i >= fEnd)
+            if (!this->fill())
+                return 0;
+
+        const char c = fBuffer[fPos + i];
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if ('"' == c || '\'' == c)
+            quote = c;
+        else if ('[' == c)
+            depth += 1;
+        else if (']' == c)
+            depth -= 1;
+        else if ('>' == c && depth <= 0)
+            return i + 1;
+    }
+}
+
+// Takes the next length bytes out of the window, counting their lines, and returns them. They
+// stay put until the next fill(), which only happens in the next call to onNextToken().
+char* SkXMLPullParser::take(size_t length)
+{
+    SkASSERT(fPos + length <= fEnd);
+    char* token = fBuffer.get() + fPos;
+    const char* stop = token + length;
+    for (const char* p = token; (p = (const char*)memchr(p, '\n', stop - p)) != NULL; p++)
+        fLine += 1;
+    fPos += length;
+    return token;
+}
+
+// Decodes the entity and character references in text in place, returning its new length.
+// Every reference is at least as long as what it stands for, so the text only shrinks.
+size_t SkXMLPullParser::decode(char text[], size_t length)
+{
+    char* dst = (char*)memchr(text, '&', length);
+    if (NULL == dst)
+        return length;
+
+    const char* src = dst;
+    const char* stop = text + length;
+    while (src < stop)
+    {
+        if ('&' != *src)
+        {
+            *dst++ = *src++;
+            continue;
+        }
+
+        const char* semi = (const char*)memchr(src, ';', stop - src);
+        if (NULL == semi)
+        {
+            *dst++ = *src++;
+            continue;
+        }
+        const char* ref = src + 1;
+        const size_t refLength = semi - ref;
+
+        char        utf8[kMaxBytesInUTF8Sequence];
+        const char* replacement = NULL;
+        size_t      replacementLength = 1;
+        SkString    custom;
+
+        if (2 == refLength && !memcmp(ref, "lt", 2))
+            replacement = "<";
+        else if (2 == refLength && !memcmp(ref, "gt", 2))
+            replacement = ">";
+        else if (3 == refLength && !memcmp(ref, "amp", 3))
+            replacement = "&";
+        else if (4 == refLength && !memcmp(ref, "apos", 4))
+            replacement = "'";
+        else if (4 == refLength && !memcmp(ref, "quot", 4))
+            replacement = "\"";
+        else if (refLength > 1 && '#' == ref[0])
+        {
+            const bool hex = 'x' == ref[1] || 'X' == ref[1];
+            const char* digit = ref + (hex ? 2 : 1);
+            SkUnichar uni = 0;
+            bool valid = digit < semi;
+            for (; valid && digit < semi; digit++)
+            {
+                int value;
+                if (*digit >= '0' && *digit <= '9')
+                    value = *digit - '0';
+                else if (hex && (*digit | 0x20) >= 'a' && (*digit | 0x20) <= 'f')
+                    value = (*digit | 0x20) - 'a' + 10;
+                else
+                    break;
+                uni = uni * (hex ? 16 : 10) + value;
+                valid = uni <= 0x10FFFF;
+            }
+            if (valid && digit == semi && uni > 0)
+            {
+                replacementLength = SkUTF8_FromUnichar(uni, utf8);
+                replacement = utf8;
+            }
+        }
+        else if (refLength > 0)
+        {
+            SkString name(ref, refLength);
+            if (this->onEntityReplacement(name.c_str(), &custom) &&
+                custom.size() <= refLength + 2)
+            {
+                replacement = custom.c_str();
+                replacementLength = custom.size();
+            }
+        }
+
+        if (replacement)
+        {
+            memcpy(dst, replacement, replacementLength);
+            dst += replacementLength;
+            src = semi + 1;
+        }
+        else
+            *dst++ = *src++;
+    }
+    return dst - text;
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::error(Error error)
+{
+    fError = error;
+    return ERROR;
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::onNextToken()
+{
+    if (fPendingEndTag)
+    {
+        // the end of an empty element tag, whose name is still on the open stack
+        fPendingEndTag = false;
+        const int start = fOpenNameStarts.top();
+        fCurr.fName = fOpenNames.begin() + start;
+        fCurr.fNameLength = fOpenNames.count() - start - 1;
+        fOpenNames.setCount(start);
+        fOpenNameStarts.pop();
+        return END_TAG;
+    }
+
+    fTokenLine = fLine;
+    if (!this->ensure(1))
+    {
+        if (fOpenNameStarts.count() > 0 || !fSeenRoot)
+            return this->error(kUnexpectedEnd_Error);
+        return END_DOCUMENT;
+    }
+
+    if ('<' != fBuffer[fPos])
+        return this->parseText();
+
+    if (!this->ensure(2))
+        return this->error(kUnexpectedEnd_Error);
+
+    size_t length;
+    switch (fBuffer[fPos + 1]) {
+    case '?':
+        if (0 == (length = this->find(2, "?>", 2)))
+            return this->error(kUnexpectedEnd_Error);
+        return this->consume(PROCESSING_INSTRUCTION, 2, length + 2, 2);
+    case '/':
+        if (0 == (length = this->tagLength()))
+            return this->error(kUnexpectedEnd_Error);
+        return this->parseEndTag(this->take(length), length);
+    case '!':
+        if (this->ensure(4) && !memcmp(fBuffer.get() + fPos, "<!--", 4))
+        {
+            if (0 == (length = this->find(4, "-->", 3)))
+                return this->error(kUnexpectedEnd_Error);
+            return this->consume(COMMENT, 4, length + 3, 3);
+        }
+        if (this->ensure(9) && !memcmp(fBuffer.get() + fPos, "<![CDATA[", 9))
+        {
+            if (0 == fOpenNameStarts.count())
+                return this->error(kOutsideRoot_Error);
+            if (0 == (length = this->find(9, "]]>", 3)))
+                return this->error(kUnexpectedEnd_Error);
+            return this->consume(CDSECT, 9, length + 3, 3);
+        }
+        if (0 == (length = this->docDeclLength()))
+            return this->error(kUnexpectedEnd_Error);
+        return this->consume(DOCDECL, 2, length, 1);
+    default:
+        if (0 == (length = this->tagLength()))
+            return this->error(kUnexpectedEnd_Error);
+        return this->parseStartTag(this->take(length), length);
+    }
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::consume(EventType type, size_t prefix, size_t length,
+                                                    size_t suffix)
+{
+    char* token = this->take(length);
+    fCurr.fName = token + prefix;
+    fCurr.fNameLength = length - prefix - suffix;
+    if (CDSECT == type)
+        fCurr.fIsWhitespace = is_all_space(fCurr.fName, fCurr.fNameLength);
+    return type;
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::parseText()
+{
+    // text runs up to the next tag, or the end of the stream
+    size_t length = this->find(1, "<", 1);
+    if (0 == length)
+        length = fEnd - fPos;
+
+    char* text = this->take(length);
+    length = this->decode(text, length);
+    fCurr.fName = text;
+    fCurr.fNameLength = length;
+    fCurr.fIsWhitespace = is_all_space(text, length);
+
+    if (0 == fOpenNameStarts.count())
+    {
+        if (!fCurr.fIsWhitespace)
+            return this->error(kOutsideRoot_Error);
+        return IGNORABLE_WHITESPACE;
+    }
+    return TEXT;
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::parseStartTag(char tag[], size_t length)
+{
+    if (fSeenRoot && 0 == fOpenNameStarts.count())
+        return this->error(kOutsideRoot_Error);
+
+    char* end = tag + length - 1;   // the '>'
+    bool isEmpty = false;
+    if (end > tag + 1 && '/' == end[-1])
+    {
+        isEmpty = true;
+        end -= 1;
+    }
+
+    char* p = tag + 1;
+    char* name = p;
+    while (p < end && !is_space(*p))
+        p++;
+    char* nameEnd = p;
+    if (nameEnd == name)
+        return this->error(kMalformedTag_Error);
+
+    fAttrs.rewind();
+    for (;;)
+    {
+        while (p < end && is_space(*p))
+            p++;
+        if (p == end)
+            break;
+
+        char* attrName = p;
+        while (p < end && !is_space(*p) && '=' != *p)
+            p++;
+        char* attrNameEnd = p;
+        while (p < end && is_space(*p))
+            p++;
+        if (attrNameEnd == attrName || p == end || '=' != *p)
+            return this->error(kMalformedTag_Error);
+        p++;
+        while (p < end && is_space(*p))
+            p++;
+        if (p == end || ('"' != *p && '\'' != *p))
+            return this->error(kMalformedTag_Error);
+
+        const char quote = *p++;
+        char* value = p;
+        while (p < end && quote != *p)
+            p++;
+        if (p == end)
+            return this->error(kMalformedTag_Error);
+        char* valueEnd = p++;
+
+        // Everything up to here is parsed, so the name's and value's terminators can be
+        // overwritten.
+        *attrNameEnd = 0;
+        const size_t valueLength = this->decode(value, valueEnd - value);
+        value[valueLength] = 0;
+
+        AttrInfo* info = fAttrs.append();
+        info->fName = attrName;
+        info->fValue = value;
+        info->fValueLength = valueLength;
+    }
+    *nameEnd = 0;
+
+    const size_t nameLength = nameEnd - name;
+    *fOpenNameStarts.append() = fOpenNames.count();
+    memcpy(fOpenNames.append(SkToInt(nameLength + 1)), name, nameLength + 1);
+    fSeenRoot = true;
+    fPendingEndTag = isEmpty;
+
+    fCurr.fName = name;
+    fCurr.fNameLength = nameLength;
+    fCurr.fAttrInfos = fAttrs.begin();
+    fCurr.fAttrInfoCount = fAttrs.count();
+    return START_TAG;
+}
+
+SkXMLPullParser::EventType SkXMLPullParser::parseEndTag(char tag[], size_t length)
+{
+    char* end = tag + length - 1;   // the '>'
+    char* name = tag + 2;
+    char* p = name;
+    while (p < end && !is_space(*p))
+        p++;
+    char* nameEnd = p;
+    while (p < end && is_space(*p))
+        p++;
+    if (nameEnd == name || p != end)
+        return this->error(kMalformedTag_Error);
+    *nameEnd = 0;
+
+    const size_t nameLength = nameEnd - name;
+    if (0 == fOpenNameStarts.count())
+        return this->error(kMismatchedTag_Error);
+    const int start = fOpenNameStarts.top();
+    if ((size_t)(fOpenNames.count() - start - 1) != nameLength ||
+        memcmp(fOpenNames.begin() + start, name, nameLength))
+        return this->error(kMismatchedTag_Error);
+    fOpenNames.setCount(start);
+    fOpenNameStarts.pop();
+
+    fCurr.fName = name;
+    fCurr.fNameLength = nameLength;
+    return END_TAG;
+}
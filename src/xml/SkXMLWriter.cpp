@@ -17,6 +17,37 @@ SkXMLWriter::~SkXMLWriter()
     SkASSERT(fElems.count() == 0);
 }
 
+SkWStream* SkXMLWriter::beginAttribute(const char name[])
+{
+    return this->onBeginAttribute(name);
+}
+
+void SkXMLWriter::endAttribute()
+{
+    this->onEndAttribute();
+}
+
+SkWStream* SkXMLWriter::onBeginAttribute(const char name[])
+{
+    SkASSERT(fAttributeName.isEmpty());
+    fAttributeName.set(name);
+    if (!fAttributeValue.get()) {
+        fAttributeValue.reset(SkNEW(SkDynamicMemoryWStream));
+    }
+    return fAttributeValue.get();
+}
+
+void SkXMLWriter::onEndAttribute()
+{
+    SkASSERT(fAttributeValue.get());
+    SkString value;
+    value.resize(fAttributeValue->bytesWritten());
+    fAttributeValue->copyTo(value.writable_str());
+    fAttributeValue->reset();
+    this->onAddAttributeLen(fAttributeName.c_str(), value.c_str(), value.size());
+    fAttributeName.reset();
+}
+
 void SkXMLWriter::flush()
 {
     while (fElems.count())
@@ -30,9 +61,9 @@ void SkXMLWriter::addAttribute(const char name[], const char value[])
 
 void SkXMLWriter::addS32Attribute(const char name[], int32_t value)
 {
-    SkString    tmp;
-    tmp.appendS32(value);
-    this->addAttribute(name, tmp.c_str());
+    char buffer[SkStrAppendS32_MaxSize];
+    char* stop = SkStrAppendS32(buffer, value);
+    this->onAddAttributeLen(name, buffer, stop - buffer);
 }
 
 void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigits)
@@ -44,9 +75,9 @@ void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigi
 
 void SkXMLWriter::addScalarAttribute(const char name[], SkScalar value)
 {
-    SkString    tmp;
-    tmp.appendScalar(value);
-    this->addAttribute(name, tmp.c_str());
+    char buffer[SkStrAppendScalar_MaxSize];
+    char* stop = SkStrAppendScalar(buffer, value);
+    this->onAddAttributeLen(name, buffer, stop - buffer);
 }
 
 void SkXMLWriter::addText(const char text[], size_t length) {
@@ -233,6 +264,20 @@ void SkXMLStreamWriter::onAddAttributeLen(const char name[], const char value[],
     fStream.writeText("\"");
 }
 
+SkWStream* SkXMLStreamWriter::onBeginAttribute(const char name[])
+{
+    SkASSERT(!fElems.top()->fHasChildren && !fElems.top()->fHasText);
+    fStream.writeText(" ");
+    fStream.writeText(name);
+    fStream.writeText("=\"");
+    return &fStream;
+}
+
+void SkXMLStreamWriter::onEndAttribute()
+{
+    fStream.writeText("\"");
+}
+
 void SkXMLStreamWriter::onAddText(const char text[], size_t length) {
     Elem* elem = fElems.top();
 
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkColorTable.h"
+#include "SkRandom.h"
+#include "SkShader.h"
+#include "Test.h"
+
+static int tile(int x, int n, SkShader::TileMode mode) {
+    switch (mode) {
+        case SkShader::kRepeat_TileMode:
+            return ((x % n) + n) % n;
+        case SkShader::kMirror_TileMode: {
+            const int m = ((x % (2 * n)) + 2 * n) % (2 * n);
+            return m < n ? m : 2 * n - 1 - m;
+        }
+        default:
+            return SkTMax(0, SkTMin(x, n - 1));
+    }
+}
+
+static SkPMColor get_pmcolor(const SkBitmap& bm, int x, int y) {
+    switch (bm.colorType()) {
+        case kRGB_565_SkColorType:
+            return SkPixel16ToPixel32(*bm.getAddr16(x, y));
+        case kIndex_8_SkColorType:
+            return bm.getIndex8Color(x, y);
+        default:
+            return *bm.getAddr32(x, y);
+    }
+}
+
+static void make_src(SkBitmap* bm, SkColorType colorType, SkRandom& rand) {
+    const int w = 13, h = 7;
+    switch (colorType) {
+        case kRGB_565_SkColorType:
+            bm->allocPixels(SkImageInfo::Make(w, h, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+            break;
+        case kIndex_8_SkColorType: {
+            SkPMColor colors[256];
+            for (int i = 0; i < 256; ++i) {
+                colors[i] = SkPreMultiplyColor(rand.nextU());
+            }
+            SkAutoTUnref<SkColorTable> ctable(SkNEW_ARGS(SkColorTable, (colors, 256)));
+            bm->allocPixels(SkImageInfo::Make(w, h, kIndex_8_SkColorType, kPremul_SkAlphaType),
+                            NULL, ctable);
+            break;
+        }
+        default:
+            bm->allocN32Pixels(w, h);
+            break;
+    }
+    for (int y = 0; y < h; ++y) {
+        uint8_t* row = (uint8_t*)bm->getAddr(0, y);
+        for (size_t i = 0; i < bm->info().minRowBytes(); ++i) {
+            row[i] = rand.nextU() & 0xFF;
+        }
+        if (kN32_SkColorType == colorType) {
+            for (int x = 0; x < w; ++x) {
+                *bm->getAddr32(x, y) = SkPreMultiplyColor(*bm->getAddr32(x, y));
+            }
+        }
+    }
+}
+
+// Unfiltered bitmap shaders moved by whole pixels copy runs of src rows for repeat and mirror
+// tiling. Every pixel must still come from where the tile modes say.
+DEF_TEST(BitmapShader_TranslateTiling, reporter) {
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGB_565_SkColorType, kIndex_8_SkColorType
+    };
+    const SkShader::TileMode modes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode
+    };
+    const SkIPoint translates[] = {
+        SkIPoint::Make(0, 0), SkIPoint::Make(5, -3), SkIPoint::Make(-40, 17),
+        SkIPoint::Make(20011, -19997),
+    };
+
+    SkRandom rand;
+    SkBitmap dst;
+    dst.allocN32Pixels(61, 33);
+    for (size_t c = 0; c < SK_ARRAY_COUNT(colorTypes); ++c) {
+        SkBitmap src;
+        make_src(&src, colorTypes[c], rand);
+        for (size_t tx = 0; tx < SK_ARRAY_COUNT(modes); ++tx) {
+            for (size_t ty = 0; ty < SK_ARRAY_COUNT(modes); ++ty) {
+                for (size_t t = 0; t < SK_ARRAY_COUNT(translates); ++t) {
+                    const SkIPoint& offset = translates[t];
+                    SkMatrix matrix;
+                    matrix.setTranslate(SkIntToScalar(offset.fX), SkIntToScalar(offset.fY));
+                    SkPaint paint;
+                    paint.setShader(SkShader::CreateBitmapShader(src, modes[tx], modes[ty],
+                                                                 &matrix))->unref();
+                    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+                    dst.eraseColor(SK_ColorTRANSPARENT);
+                    SkCanvas canvas(dst);
+                    canvas.drawPaint(paint);
+
+                    int mismatches = 0;
+                    for (int y = 0; y < dst.height(); ++y) {
+                        const int sy = tile(y - offset.fY, src.height(), modes[ty]);
+                        for (int x = 0; x < dst.width(); ++x) {
+                            const int sx = tile(x - offset.fX, src.width(), modes[tx]);
+                            mismatches += get_pmcolor(src, sx, sy) != *dst.getAddr32(x, y);
+                        }
+                    }
+                    REPORTER_ASSERT(reporter, 0 == mismatches);
+                }
+            }
+        }
+    }
+}
@@ -6,9 +6,13 @@
  */
 
 #include "SkBitmap.h"
+#include "SkBlitMask.h"
+#include "SkBlitRow.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkDither.h"
 #include "SkGradientShader.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -262,3 +266,198 @@ DEF_TEST(BlitRow, reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
 }
+
+static SkPMColor random_pmcolor(SkRandom* rand) {
+    // Favor the transparent and opaque alphas the procs special-case.
+    U8CPU a;
+    switch (rand->nextU() % 4) {
+        case 0:  a = 0;   break;
+        case 1:  a = 255; break;
+        default: a = rand->nextU() & 0xFF; break;
+    }
+    return SkPremultiplyARGBInline(a, rand->nextU() & 0xFF, rand->nextU() & 0xFF,
+                                   rand->nextU() & 0xFF);
+}
+
+// Whatever platform procs we pick (SSE2, SSE4, AVX2, NEON...) must match the portable math.
+DEF_TEST(BlitRow_PlatformProcsMatchPortable, reporter) {
+    static const int kMax = 67;
+    SkRandom rand;
+    SkPMColor src[kMax], dst[kMax], expected[kMax];
+    uint8_t mask[kMax];
+
+    SkBlitRow::Proc32 srcOver = SkBlitRow::Factory32(SkBlitRow::kSrcPixelAlpha_Flag32);
+    SkBlitRow::Proc32 blend = SkBlitRow::Factory32(SkBlitRow::kSrcPixelAlpha_Flag32 |
+                                                   SkBlitRow::kGlobalAlpha_Flag32);
+    SkBlitRow::ColorProc color32 = SkBlitRow::ColorProcFactory();
+
+    for (int count = 0; count <= kMax; ++count) {
+        // Start at an odd offset some of the time, so the procs see unaligned pointers.
+        const int offset = count & 1;
+        const int n = count - offset;
+        for (int i = 0; i < kMax; ++i) {
+            src[i] = random_pmcolor(&rand);
+            dst[i] = random_pmcolor(&rand);
+            mask[i] = (i % 3) ? (rand.nextU() & 0xFF) : 0xFF * (rand.nextU() & 1);
+        }
+        // Runs of the same alpha exercise the all-transparent / all-opaque shortcuts.
+        if (count & 2) {
+            for (int i = 0; i < kMax / 2; ++i) {
+                src[i] = SkPackARGB32(0xFF, 0x10, 0x20, 0x30);
+                mask[i] = 0xFF;
+            }
+        }
+
+        SkPMColor work[kMax];
+        memcpy(work, dst, sizeof(dst));
+        srcOver(work + offset, src + offset, n, 0xFF);
+        for (int i = 0; i < kMax; ++i) {
+            bool touched = i >= offset && i < offset + n;
+            expected[i] = touched ? SkPMSrcOver(src[i], dst[i]) : dst[i];
+        }
+        REPORTER_ASSERT(reporter, 0 == memcmp(work, expected, sizeof(work)));
+
+        const U8CPU alpha = rand.nextU() % 255;
+        memcpy(work, dst, sizeof(dst));
+        blend(work + offset, src + offset, n, alpha);
+        for (int i = 0; i < kMax; ++i) {
+            bool touched = i >= offset && i < offset + n;
+            expected[i] = touched ? SkBlendARGB32(src[i], dst[i], alpha) : dst[i];
+        }
+        REPORTER_ASSERT(reporter, 0 == memcmp(work, expected, sizeof(work)));
+
+        const SkPMColor color = SkPremultiplyARGBInline(0x80, 0x40, 0xC0, 0x20);
+        memcpy(work, dst, sizeof(dst));
+        color32(work + offset, src + offset, n, color);
+        const unsigned scale = 256 - SkAlpha255To256(SkGetPackedA32(color));
+        for (int i = 0; i < kMax; ++i) {
+            bool touched = i >= offset && i < offset + n;
+            expected[i] = touched ? color + SkAlphaMulQ(src[i], scale) : dst[i];
+        }
+        REPORTER_ASSERT(reporter, 0 == memcmp(work, expected, sizeof(work)));
+
+        if (n <= 0) {
+            continue;
+        }
+        const SkColor maskColors[] = { SK_ColorRED, 0x80336699 };
+        for (size_t c = 0; c < SK_ARRAY_COUNT(maskColors); ++c) {
+            SkBlitMask::ColorProc maskProc = SkBlitMask::ColorFactory(kN32_SkColorType,
+                                                                      SkMask::kA8_Format,
+                                                                      maskColors[c]);
+            REPORTER_ASSERT(reporter, maskProc);
+            // Two rows of n pixels, with a larger stride in dst than in the mask.
+            SkPMColor dst2[2 * kMax];
+            memcpy(dst2, dst, sizeof(dst));
+            memcpy(dst2 + kMax, dst, sizeof(dst));
+            maskProc(dst2 + offset, kMax * sizeof(SkPMColor), mask + offset, 0, maskColors[c],
+                     n, 2);
+            const SkPMColor pm = SkPreMultiplyColor(maskColors[c]);
+            for (int row = 0; row < 2; ++row) {
+                for (int i = 0; i < kMax; ++i) {
+                    bool touched = i >= offset && i < offset + n;
+                    expected[i] = touched ? SkBlendARGB32(pm, dst[i], mask[i]) : dst[i];
+                }
+                REPORTER_ASSERT(reporter,
+                                0 == memcmp(dst2 + row * kMax, expected, sizeof(expected)));
+            }
+        }
+    }
+}
+
+// SkBlitMask::BlitColor skips and fills solid runs of A8 coverage; the result must not change.
+DEF_TEST(BlitMask_A8Spans, reporter) {
+    static const int kW = 101, kH = 4;
+    SkRandom rand;
+    uint8_t maskStorage[kW * kH];
+    for (int y = 0; y < kH; ++y) {
+        uint8_t* row = maskStorage + y * kW;
+        int x = 0;
+        while (x < kW) {
+            // Runs of 0, 0xFF or random coverage, of random (often shorter than 8) length.
+            int n = SkTMin<int>(kW - x, 1 + rand.nextU() % 20);
+            int kind = rand.nextU() % 3;
+            for (int i = 0; i < n; ++i) {
+                row[x + i] = 0 == kind ? 0 : 1 == kind ? 0xFF : rand.nextU() & 0xFF;
+            }
+            x += n;
+        }
+    }
+    SkMask mask;
+    mask.fImage = maskStorage;
+    mask.fBounds.set(0, 0, kW, kH);
+    mask.fRowBytes = kW;
+    mask.fFormat = SkMask::kA8_Format;
+
+    const SkColor colors[] = { SK_ColorBLACK, SK_ColorRED, 0x80336699, 0x00FFFFFF };
+    for (size_t c = 0; c < SK_ARRAY_COUNT(colors); ++c) {
+        SkBitmap bm;
+        bm.allocN32Pixels(kW + 3, kH);
+        for (int y = 0; y < kH; ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                *bm.getAddr32(x, y) = random_pmcolor(&rand);
+            }
+        }
+        SkBitmap orig;
+        bm.copyTo(&orig);
+
+        // Blit into a clip inset from the mask, so rows start off the mask's first byte.
+        const SkIRect clip = SkIRect::MakeLTRB(1, 1, kW - 2, kH);
+        REPORTER_ASSERT(reporter, SkBlitMask::BlitColor(bm, mask, clip, colors[c]));
+
+        const SkPMColor pmc = SkPreMultiplyColor(colors[c]);
+        bool same = true;
+        for (int y = 0; y < kH; ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                SkPMColor expected = *orig.getAddr32(x, y);
+                if (clip.contains(x, y)) {
+                    expected = SkBlendARGB32(pmc, expected, *mask.getAddr8(x, y));
+                }
+                same &= expected == *bm.getAddr32(x, y);
+            }
+        }
+        REPORTER_ASSERT(reporter, same);
+    }
+}
+
+// The platform 565 proc for shader spans with global alpha and dither must match the portable math.
+DEF_TEST(BlitRow_565BlendDitherMatchesPortable, reporter) {
+    static const int kMax = 37;
+    SkRandom rand;
+    SkPMColor src[kMax];
+    uint16_t dst[kMax], work[kMax], expected[kMax];
+
+    SkBlitRow::Proc16 proc = SkBlitRow::Factory16(SkBlitRow::kSrcPixelAlpha_Flag |
+                                                  SkBlitRow::kGlobalAlpha_Flag |
+                                                  SkBlitRow::kDither_Flag);
+    for (int count = 1; count <= kMax; ++count) {
+        for (int i = 0; i < kMax; ++i) {
+            src[i] = (i % 5) ? random_pmcolor(&rand) : 0;
+            dst[i] = SkToU16(rand.nextU());
+        }
+        const U8CPU alpha = rand.nextU() % 255;
+        const int x = rand.nextU() & 7, y = rand.nextU() & 7;
+
+        memcpy(work, dst, sizeof(dst));
+        proc(work, src, count, alpha, x, y);
+
+        memcpy(expected, dst, sizeof(dst));
+        const int src_scale = SkAlpha255To256(alpha);
+        DITHER_565_SCAN(y);
+        for (int i = 0; i < count; ++i) {
+            const SkPMColor c = src[i];
+            if (!c) {
+                continue;
+            }
+            const unsigned d = dst[i];
+            const int dst_scale = SkAlpha255To256(255 - SkAlphaMul(SkGetPackedA32(c), src_scale));
+            const int dither = DITHER_VALUE(x + i);
+            const int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+            const int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+            const int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+            expected[i] = SkPackRGB16((sr * src_scale + SkGetPackedR16(d) * dst_scale) >> 8,
+                                      (sg * src_scale + SkGetPackedG16(d) * dst_scale) >> 8,
+                                      (sb * src_scale + SkGetPackedB16(d) * dst_scale) >> 8);
+        }
+        REPORTER_ASSERT(reporter, 0 == memcmp(work, expected, sizeof(work)));
+    }
+}
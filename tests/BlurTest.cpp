@@ -564,6 +564,117 @@ static void test_asABlur(skiatest::Reporter* reporter) {
     }
 }
 
+// Big masks are blurred a band of rows at a time. Blurring a spot in the middle of one, across
+// band boundaries, gives what blurring it in a small mask does.
+static void test_banded_box_blur(skiatest::Reporter* reporter, SkScalar sigma,
+                                 SkBlurQuality quality) {
+    const int kSmall = 40, kBig = 700, kOrigin = 330;
+    SkMask small, big;
+    small.fBounds.set(0, 0, kSmall, kSmall);
+    small.fFormat = SkMask::kA8_Format;
+    small.fRowBytes = kSmall;
+    small.fImage = SkMask::AllocImage(small.computeTotalImageSize());
+    big.fBounds.set(0, 0, kBig, kBig);
+    big.fFormat = SkMask::kA8_Format;
+    big.fRowBytes = kBig;
+    big.fImage = SkMask::AllocImage(big.computeTotalImageSize());
+    memset(big.fImage, 0, big.computeTotalImageSize());
+    for (int y = 0; y < kSmall; ++y) {
+        for (int x = 0; x < kSmall; ++x) {
+            *small.getAddr8(x, y) = (x * 37 + y * 11) & 0xFF;
+            *big.getAddr8(kOrigin + x, kOrigin + y) = *small.getAddr8(x, y);
+        }
+    }
+
+    SkMask smallDst, bigDst;
+    SkIPoint smallMargin, bigMargin;
+    REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&smallDst, small, sigma, kNormal_SkBlurStyle,
+                                                  quality, &smallMargin));
+    REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&bigDst, big, sigma, kNormal_SkBlurStyle,
+                                                  quality, &bigMargin));
+    REPORTER_ASSERT(reporter, smallMargin == bigMargin);
+    if (smallMargin == bigMargin) {
+        for (int y = 0; y < smallDst.fBounds.height(); ++y) {
+            REPORTER_ASSERT(reporter, !memcmp(smallDst.getAddr8(smallDst.fBounds.fLeft,
+                                                                smallDst.fBounds.fTop + y),
+                                              bigDst.getAddr8(smallDst.fBounds.fLeft + kOrigin,
+                                                              smallDst.fBounds.fTop + kOrigin + y),
+                                              smallDst.fBounds.width()));
+        }
+    }
+
+    SkMask::FreeImage(small.fImage);
+    SkMask::FreeImage(big.fImage);
+    SkMask::FreeImage(smallDst.fImage);
+    SkMask::FreeImage(bigDst.fImage);
+}
+
+DEF_TEST(BlurMaskBoxBlurBands, reporter) {
+    test_banded_box_blur(reporter, 3, kHigh_SkBlurQuality);
+    test_banded_box_blur(reporter, 3, kLow_SkBlurQuality);
+    // A non-integer radius takes the interpolating blur.
+    test_banded_box_blur(reporter, 2.6f, kHigh_SkBlurQuality);
+    test_banded_box_blur(reporter, 2.6f, kLow_SkBlurQuality);
+}
+
+// Draws rrect with a blur of the given sigma into an A8 bitmap, which takes the analytic spans,
+// and returns the largest difference from blurring the sharp rrect with BlurGroundTruth.
+static int analytic_blur_error(const SkRRect& rrect, SkScalar sigma) {
+    const int kSize = 128;
+    SkBitmap sharp, blurred;
+    sharp.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    blurred.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    sharp.eraseColor(SK_ColorTRANSPARENT);
+    blurred.eraseColor(SK_ColorTRANSPARENT);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    {
+        SkCanvas canvas(sharp);
+        canvas.drawRRect(rrect, paint);
+    }
+    {
+        SkCanvas canvas(blurred);
+        paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, sigma))->unref();
+        canvas.drawRRect(rrect, paint);
+    }
+
+    SkMask src, dst;
+    src.fBounds.set(0, 0, kSize, kSize);
+    src.fFormat = SkMask::kA8_Format;
+    src.fRowBytes = sharp.rowBytes();
+    src.fImage = (uint8_t*)sharp.getPixels();
+    dst.fImage = NULL;
+    SkBlurMask::BlurGroundTruth(sigma, &dst, src, kNormal_SkBlurStyle);
+
+    int maxError = 0;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            const int truth = *dst.getAddr8(x, y);
+            maxError = SkTMax(maxError, SkAbs32(truth - *blurred.getAddr8(x, y)));
+        }
+    }
+    SkMask::FreeImage(dst.fImage);
+    return maxError;
+}
+
+DEF_TEST(BlurAnalyticSpans, reporter) {
+    const SkRect r = SkRect::MakeLTRB(30.5f, 34, 97, 90.25f);
+    SkRRect rects[4];
+    rects[0].setRect(r);
+    rects[1].setRectXY(r, 12, 12);
+    rects[2].setRectXY(r, 20, 8);
+    rects[3].setOval(SkRect::MakeXYWH(34, 34, 60, 60));
+    const SkScalar sigmas[] = { 2, 2.5f, 6, 12 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(rects); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(sigmas); ++j) {
+            // The ground truth blurs antialiased pixel coverage, the spans sample the blurred
+            // shape at pixel centers; they part most where tight curves meet small sigmas.
+            REPORTER_ASSERT(reporter, analytic_blur_error(rects[i], sigmas[j]) <= 6);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 DEF_GPUTEST(Blur, reporter, factory) {
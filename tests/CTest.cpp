@@ -7,6 +7,7 @@
 
 #include "sk_canvas.h"
 #include "sk_paint.h"
+#include "sk_path.h"
 #include "sk_surface.h"
 
 #include "Test.h"
@@ -34,6 +35,65 @@ static void test_c(skiatest::Reporter* reporter) {
     sk_surface_unref(surface);
 }
 
+static void test_c_batch(skiatest::Reporter* reporter) {
+    sk_imageinfo_t info = {
+        4, 4, sk_colortype_get_default_8888(), PREMUL_SK_ALPHATYPE
+    };
+    uint32_t pixels[16];
+
+    sk_surface_t* surface = sk_surface_new_raster_direct(&info, pixels, 4 * sizeof(uint32_t));
+    sk_canvas_t* canvas = sk_surface_get_canvas(surface);
+    sk_paint_t* black = sk_paint_new();
+    sk_paint_t* white = sk_paint_new();
+    sk_paint_set_color(white, sk_color_set_argb(0xFF, 0xFF, 0xFF, 0xFF));
+
+    // two rects in one call cover the top-left and bottom-right pixels
+    const sk_rect_t rects[] = { { 0, 0, 1, 1 }, { 3, 3, 4, 4 } };
+    sk_canvas_draw_paint(canvas, black);
+    sk_canvas_draw_rects(canvas, rects, 2, white);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[0]);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[5]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[15]);
+
+    const sk_point_t points[] = { { 1.5f, 0.5f }, { 2.5f, 2.5f } };
+    sk_canvas_draw_paint(canvas, black);
+    sk_canvas_draw_points(canvas, POINTS_SK_POINT_MODE, 2, points, white);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[1]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[10]);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[0]);
+
+    // the right half of the surface as one closed contour
+    const sk_path_verb_t verbs[] = {
+        MOVE_SK_PATH_VERB, LINE_SK_PATH_VERB, LINE_SK_PATH_VERB, LINE_SK_PATH_VERB,
+        CLOSE_SK_PATH_VERB
+    };
+    const sk_point_t pathPoints[] = { { 2, 0 }, { 4, 0 }, { 4, 4 }, { 2, 4 } };
+    sk_canvas_draw_paint(canvas, black);
+    sk_canvas_draw_path_verbs(canvas, verbs, 5, pathPoints, 4, NULL, 0, white);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[1]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[2]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[15]);
+
+    // mismatched counts draw nothing and leave a path untouched
+    sk_canvas_draw_paint(canvas, black);
+    sk_canvas_draw_path_verbs(canvas, verbs, 5, pathPoints, 3, NULL, 0, white);
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[15]);
+
+    sk_path_t* path = sk_path_new();
+    sk_rect_t bounds;
+    REPORTER_ASSERT(reporter, !sk_path_add_verbs(path, verbs, 5, pathPoints, 4, NULL, 1));
+    REPORTER_ASSERT(reporter, !sk_path_get_bounds(path, &bounds));
+    REPORTER_ASSERT(reporter, sk_path_add_verbs(path, verbs, 5, pathPoints, 4, NULL, 0));
+    REPORTER_ASSERT(reporter, sk_path_get_bounds(path, &bounds));
+    REPORTER_ASSERT(reporter, 2 == bounds.left && 4 == bounds.right && 4 == bounds.bottom);
+    sk_path_delete(path);
+
+    sk_paint_delete(white);
+    sk_paint_delete(black);
+    sk_surface_unref(surface);
+}
+
 DEF_TEST(C_API, reporter) {
     test_c(reporter);
+    test_c_batch(reporter);
 }
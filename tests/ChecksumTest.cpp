@@ -12,13 +12,14 @@
 
 // Murmur3 has an optional third seed argument, so we wrap it to fit a uniform type.
 static uint32_t murmur_noseed(const uint32_t* d, size_t l) { return SkChecksum::Murmur3(d, l); }
+static uint32_t fast_noseed(const uint32_t* d, size_t l) { return SkChecksum::Fast(d, l); }
 
 #define ASSERT(x) REPORTER_ASSERT(r, x)
 
 DEF_TEST(Checksum, r) {
     // Algorithms to test.  They're currently all uint32_t(const uint32_t*, size_t).
     typedef uint32_t(*algorithmProc)(const uint32_t*, size_t);
-    const algorithmProc kAlgorithms[] = { &SkChecksum::Compute, &murmur_noseed };
+    const algorithmProc kAlgorithms[] = { &SkChecksum::Compute, &murmur_noseed, &fast_noseed };
 
     // Put 128 random bytes into two identical buffers.  Any multiple of 4 will do.
     const size_t kBytes = SkAlign4(128);
@@ -51,6 +52,26 @@ DEF_TEST(Checksum, r) {
     }
 }
 
+// Fast takes any length at any alignment, so also tweak single bytes of odd-sized, unaligned data.
+DEF_TEST(Checksum_Fast, r) {
+    SkRandom rand;
+    uint8_t data[67];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = SkToU8(rand.nextU());
+    }
+    for (size_t bytes = 1; bytes < sizeof(data) - 1; bytes += 5) {
+        uint8_t* unaligned = data + 1;
+        const uint32_t hash = SkChecksum::Fast(unaligned, bytes);
+        ASSERT(hash == SkChecksum::Fast(unaligned, bytes));
+        ASSERT(hash != SkChecksum::Fast(unaligned, bytes, 1));
+        for (size_t j = 0; j < bytes; ++j) {
+            unaligned[j] ^= 0x10;
+            ASSERT(hash != SkChecksum::Fast(unaligned, bytes));
+            unaligned[j] ^= 0x10;
+        }
+    }
+}
+
 DEF_TEST(GoodHash, r) {
     ASSERT(SkGoodHash(( int32_t)4) ==  614249093);  // 4 bytes.  Hits SkChecksum::Mix fast path.
     ASSERT(SkGoodHash((uint32_t)4) ==  614249093);  // (Ditto)
@@ -10,35 +10,14 @@
 #if SK_SUPPORT_GPU
 #include "GrClipMaskManager.h"
 #include "GrContextFactory.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
 #include "SkGpuDevice.h"
+#include "SkSurface.h"
 
 static const int X_SIZE = 12;
 static const int Y_SIZE = 12;
 
-////////////////////////////////////////////////////////////////////////////////
-// note: this is unused
-static GrTexture* createTexture(GrContext* context) {
-    unsigned char textureData[X_SIZE][Y_SIZE][4];
-
-    memset(textureData, 0, 4* X_SIZE * Y_SIZE);
-
-    GrSurfaceDesc desc;
-
-    // let Skia know we will be using this texture as a render target
-    desc.fFlags     = kRenderTarget_GrSurfaceFlag;
-    desc.fConfig    = kSkia8888_GrPixelConfig;
-    desc.fWidth     = X_SIZE;
-    desc.fHeight    = Y_SIZE;
-
-    // We are initializing the texture with zeros here
-    GrTexture* texture = context->createTexture(desc, false, textureData, 0);
-    if (!texture) {
-        return NULL;
-    }
-
-    return texture;
-}
-
 // Ensure that the 'getConservativeBounds' calls are returning bounds clamped
 // to the render target
 static void test_clip_bounds(skiatest::Reporter* reporter, GrContext* context) {
@@ -98,121 +77,54 @@ static void test_clip_bounds(skiatest::Reporter* reporter, GrContext* context) {
     REPORTER_ASSERT(reporter, isIntersectionOfRects);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-// verify that the top state of the stack matches the passed in state
-static void check_state(skiatest::Reporter* reporter,
-                        const GrClipMaskCache& cache,
-                        const SkClipStack& clip,
-                        GrTexture* mask,
-                        const SkIRect& bound) {
-    REPORTER_ASSERT(reporter, clip.getTopmostGenID() == cache.getLastClipGenID());
-
-    REPORTER_ASSERT(reporter, mask == cache.getLastMask());
-
-    SkIRect cacheBound;
-    cache.getLastBound(&cacheBound);
-    REPORTER_ASSERT(reporter, bound == cacheBound);
+#if GR_GPU_STATS
+// Draws a rect through the canvas' clip, and returns how many draws and uploads that took,
+// including any it took to make a clip mask.
+static int count_clipped_draw_work(GrContext* context, SkCanvas* canvas) {
+    context->flush();
+    const GrGpu::Stats* stats = context->getGpu()->stats();
+    const int before = stats->draws() + stats->textureUploads();
+    canvas->drawRect(SkRect::MakeWH(SkIntToScalar(X_SIZE), SkIntToScalar(Y_SIZE)), SkPaint());
+    context->flush();
+    return stats->draws() + stats->textureUploads() - before;
 }
 
-static void check_empty_state(skiatest::Reporter* reporter,
-                              const GrClipMaskCache& cache) {
-    REPORTER_ASSERT(reporter, SkClipStack::kInvalidGenID == cache.getLastClipGenID());
-    REPORTER_ASSERT(reporter, NULL == cache.getLastMask());
-
-    SkIRect emptyBound;
-    emptyBound.setEmpty();
-
-    SkIRect cacheBound;
-    cache.getLastBound(&cacheBound);
-    REPORTER_ASSERT(reporter, emptyBound == cacheBound);
+static void make_star(SkPath* path, SkScalar offset) {
+    path->moveTo(offset + 6, 0);
+    path->lineTo(offset + 10, 12);
+    path->lineTo(offset, 4);
+    path->lineTo(offset + 12, 4);
+    path->lineTo(offset + 2, 12);
+    path->close();
 }
 
-////////////////////////////////////////////////////////////////////////////////
-// basic test of the cache's base functionality:
-//  push, pop, set, canReuse & getters
-static void test_cache(skiatest::Reporter* reporter, GrContext* context) {
-
-    if (false) { // avoid bit rot, suppress warning
-        createTexture(context);
-    }
-    GrClipMaskCache cache;
-
-    cache.setContext(context);
-
-    // check initial state
-    check_empty_state(reporter, cache);
-
-    // set the current state
-    SkIRect bound1;
-    bound1.set(0, 0, 100, 100);
-
-    SkClipStack clip1(bound1);
-
-    GrSurfaceDesc desc;
-    desc.fFlags = kRenderTarget_GrSurfaceFlag;
-    desc.fWidth = X_SIZE;
-    desc.fHeight = Y_SIZE;
-    desc.fConfig = kSkia8888_GrPixelConfig;
-
-    cache.acquireMask(clip1.getTopmostGenID(), desc, bound1);
-
-    GrTexture* texture1 = cache.getLastMask();
-    REPORTER_ASSERT(reporter, texture1);
-    if (NULL == texture1) {
-        return;
-    }
-
-    // check that the set took
-    check_state(reporter, cache, clip1, texture1, bound1);
-
-    // push the state
-    cache.push();
-
-    // verify that the pushed state is initially empty
-    check_empty_state(reporter, cache);
-
-    // modify the new state
-    SkIRect bound2;
-    bound2.set(-10, -10, 10, 10);
-
-    SkClipStack clip2(bound2);
-
-    cache.acquireMask(clip2.getTopmostGenID(), desc, bound2);
-
-    GrTexture* texture2 = cache.getLastMask();
-    REPORTER_ASSERT(reporter, texture2);
-    if (NULL == texture2) {
+// Going back to a clip after drawing through a nested one reuses the first clip's mask.
+static void test_mask_reuse(skiatest::Reporter* reporter, GrContext* context) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(2 * X_SIZE, 2 * Y_SIZE);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (NULL == surface) {
+        ERRORF(reporter, "Could not create a render target.");
         return;
     }
-
-    // check that the changes took
-    check_state(reporter, cache, clip2, texture2, bound2);
-
-    // check to make sure canReuse works
-    REPORTER_ASSERT(reporter, cache.canReuse(clip2.getTopmostGenID(), bound2));
-    REPORTER_ASSERT(reporter, !cache.canReuse(clip1.getTopmostGenID(), bound1));
-
-    // pop the state
-    cache.pop();
-
-    // verify that the old state is restored
-    check_state(reporter, cache, clip1, texture1, bound1);
-
-    // manually clear the state
-    cache.reset();
-
-    // verify it is now empty
-    check_empty_state(reporter, cache);
-
-    // pop again - so there is no state
-    cache.pop();
-
-#if !defined(SK_DEBUG)
-    // verify that the getters don't crash
-    // only do in release since it generates asserts in debug
-    check_empty_state(reporter, cache);
-#endif
+    SkCanvas* canvas = surface->getCanvas();
+
+    // Concave anti-aliased clips can only be drawn through a mask.
+    SkPath outer, inner;
+    make_star(&outer, 0);
+    make_star(&inner, SK_ScalarHalf);
+    canvas->clipPath(outer, SkRegion::kIntersect_Op, true);
+    REPORTER_ASSERT(reporter, count_clipped_draw_work(context, canvas) > 1);
+    REPORTER_ASSERT(reporter, 1 == count_clipped_draw_work(context, canvas));
+
+    canvas->save();
+    canvas->clipPath(inner, SkRegion::kIntersect_Op, true);
+    REPORTER_ASSERT(reporter, count_clipped_draw_work(context, canvas) > 1);
+    canvas->restore();
+
+    REPORTER_ASSERT(reporter, 1 == count_clipped_draw_work(context, canvas));
 }
+#endif
 
 DEF_GPUTEST(ClipCache, reporter, factory) {
     for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
@@ -225,9 +137,17 @@ DEF_GPUTEST(ClipCache, reporter, factory) {
             continue;
         }
 
-        test_cache(reporter, context);
         test_clip_bounds(reporter, context);
     }
 }
 
+#if GR_GPU_STATS
+DEF_GPUTEST(ClipCache_MaskReuse, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (context) {
+        test_mask_reuse(reporter, context);
+    }
+}
+#endif
+
 #endif
@@ -8,7 +8,10 @@
 #include "Resources.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkMD5.h"
+#include "SkRect.h"
 #include "Test.h"
 
 static SkStreamAsset* resource(const char path[]) {
@@ -94,6 +97,13 @@ DEF_TEST(Codec, r) {
     // Decodes an embedded PNG image
     check(r, "google_chrome.ico", SkISize::Make(256, 256), false);
 
+    // JPEG
+    check(r, "CMYK.jpg", SkISize::Make(642, 516), true);
+    check(r, "color_wheel.jpg", SkISize::Make(128, 128), true);
+    check(r, "grayscale.jpg", SkISize::Make(128, 128), true);
+    check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true);
+    check(r, "randPixels.jpg", SkISize::Make(8, 8), true);
+
     // PNG
     check(r, "arrow.png", SkISize::Make(187, 312), true);
     check(r, "baby_tux.png", SkISize::Make(240, 246), true);
@@ -108,4 +118,477 @@ DEF_TEST(Codec, r) {
     check(r, "plane.png", SkISize::Make(250, 126), true);
     check(r, "randPixels.png", SkISize::Make(8, 8), true);
     check(r, "yellow_rose.png", SkISize::Make(400, 301), true);
+
+    // WEBP
+    check(r, "baby_tux.webp", SkISize::Make(386, 395), true);
+    check(r, "color_wheel.webp", SkISize::Make(128, 128), true);
+    check(r, "half-transparent-white-pixel.webp", SkISize::Make(1, 1), true);
+    check(r, "randPixels.webp", SkISize::Make(8, 8), true);
+    check(r, "yellow_rose.webp", SkISize::Make(400, 301), true);
+}
+
+// Average of the differences between each channel of each pixel of scaled and the average of the
+// block of full it was scaled from.
+static int average_block_difference(const SkBitmap& full, const SkBitmap& scaled, int denom) {
+    int64_t total = 0;
+    for (int y = 0; y < scaled.height(); ++y) {
+        for (int x = 0; x < scaled.width(); ++x) {
+            int sums[3] = { 0, 0, 0 };
+            int count = 0;
+            for (int fy = y * denom; fy < SkTMin(full.height(), (y + 1) * denom); ++fy) {
+                for (int fx = x * denom; fx < SkTMin(full.width(), (x + 1) * denom); ++fx) {
+                    const SkPMColor c = *full.getAddr32(fx, fy);
+                    sums[0] += SkGetPackedR32(c);
+                    sums[1] += SkGetPackedG32(c);
+                    sums[2] += SkGetPackedB32(c);
+                    count++;
+                }
+            }
+            const SkPMColor c = *scaled.getAddr32(x, y);
+            total += SkTAbs<int>(sums[0] / count - SkGetPackedR32(c)) +
+                     SkTAbs<int>(sums[1] / count - SkGetPackedG32(c)) +
+                     SkTAbs<int>(sums[2] / count - SkGetPackedB32(c));
+        }
+    }
+    return SkToInt(total / (3 * scaled.width() * scaled.height()));
+}
+
+DEF_TEST(Codec_JpegScaled, r) {
+    SkAutoTDelete<SkStream> stream(resource("mandrill_512_q075.jpg"));
+    if (!stream) {
+        SkDebugf("Missing resource 'mandrill_512_q075.jpg'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    REPORTER_ASSERT(r, kJPEG_SkEncodedFormat == codec->getEncodedFormat());
+
+    const SkImageInfo info = codec->getInfo();
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                       codec->getPixels(info, full.getPixels(), full.rowBytes(), NULL, NULL, NULL));
+
+    // Asking for a scale gets the nearest one the IDCT can do that is at least as large.
+    REPORTER_ASSERT(r, codec->getScaledDimensions(1.0f) == SkISize::Make(512, 512));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.6f) == SkISize::Make(512, 512));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.5f) == SkISize::Make(256, 256));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.3f) == SkISize::Make(256, 256));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.25f) == SkISize::Make(128, 128));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.1f) == SkISize::Make(64, 64));
+
+    static const float kScales[] = { 0.5f, 0.25f, 0.125f };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kScales); ++i) {
+        const SkISize size = codec->getScaledDimensions(kScales[i]);
+        const SkImageInfo scaledInfo = info.makeWH(size.width(), size.height());
+        SkBitmap scaled;
+        scaled.allocPixels(scaledInfo);
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                           codec->getPixels(scaledInfo, scaled.getPixels(), scaled.rowBytes(),
+                                            NULL, NULL, NULL));
+        // Each pixel looks like the block it stands for.
+        const int denom = info.width() / size.width();
+        REPORTER_ASSERT(r, average_block_difference(full, scaled, denom) <= 4);
+
+        // Scanline decoding scales the same way.
+        SkBitmap scanlines;
+        scanlines.allocPixels(scaledInfo);
+        SkScanlineDecoder* scanlineDecoder = codec->getScanlineDecoder(scaledInfo);
+        REPORTER_ASSERT(r, scanlineDecoder);
+        if (scanlineDecoder) {
+            REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                               scanlineDecoder->getScanlines(scanlines.getPixels(),
+                                                             scaledInfo.height(),
+                                                             scanlines.rowBytes()));
+            REPORTER_ASSERT(r, 0 == memcmp(scaled.getPixels(), scanlines.getPixels(),
+                                           scaled.getSize()));
+        }
+    }
+
+    // Sizes the IDCT can't make are refused.
+    const SkImageInfo oddInfo = info.makeWH(300, 300);
+    SkBitmap odd;
+    odd.allocPixels(oddInfo);
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidScale ==
+                       codec->getPixels(oddInfo, odd.getPixels(), odd.rowBytes(), NULL, NULL, NULL));
+    REPORTER_ASSERT(r, NULL == codec->getScanlineDecoder(oddInfo));
+
+    // A truncated file still decodes, with the missing rows made up.
+    const SkString path = GetResourcePath("mandrill_512_q075.jpg");
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(path.c_str()));
+    SkAutoTUnref<SkData> truncated(SkData::NewSubset(data, 0, data->size() / 2));
+    codec.reset(SkCodec::NewFromData(truncated));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        REPORTER_ASSERT(r, SkImageGenerator::kIncompleteInput ==
+                           codec->getPixels(info, full.getPixels(), full.rowBytes(),
+                                            NULL, NULL, NULL));
+    }
+}
+
+DEF_TEST(Codec_WebpScaled, r) {
+    SkAutoTDelete<SkStream> stream(resource("yellow_rose.webp"));
+    if (!stream) {
+        SkDebugf("Missing resource 'yellow_rose.webp'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    REPORTER_ASSERT(r, kWEBP_SkEncodedFormat == codec->getEncodedFormat());
+
+    // libwebp scales to any size, but only down.
+    const SkImageInfo info = codec->getInfo().makeAlphaType(kPremul_SkAlphaType);
+    REPORTER_ASSERT(r, codec->getScaledDimensions(1.5f) == SkISize::Make(400, 301));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.5f) == SkISize::Make(200, 151));
+    REPORTER_ASSERT(r, codec->getScaledDimensions(0.0f) == SkISize::Make(1, 1));
+
+    const SkISize sizes[] = {
+        SkISize::Make(200, 151),
+        SkISize::Make(123, 45),
+        SkISize::Make(1, 1),
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sizes); ++i) {
+        const SkImageInfo scaledInfo = info.makeWH(sizes[i].width(), sizes[i].height());
+        SkBitmap scaled;
+        scaled.allocPixels(scaledInfo);
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                           codec->getPixels(scaledInfo, scaled.getPixels(), scaled.rowBytes(),
+                                            NULL, NULL, NULL));
+
+        // The scanline decoder scales the same way.
+        SkScanlineDecoder* scanlineDecoder = codec->getScanlineDecoder(scaledInfo);
+        REPORTER_ASSERT(r, scanlineDecoder);
+        if (scanlineDecoder) {
+            SkBitmap scanlines;
+            scanlines.allocPixels(scaledInfo);
+            REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                               scanlineDecoder->getScanlines(scanlines.getPixels(),
+                                                             scaledInfo.height(),
+                                                             scanlines.rowBytes()));
+            REPORTER_ASSERT(r, 0 == memcmp(scaled.getPixels(), scanlines.getPixels(),
+                                           scaled.getSize()));
+        }
+    }
+
+    // Larger than the image is refused.
+    const SkImageInfo largeInfo = info.makeWH(800, 602);
+    SkBitmap large;
+    large.allocPixels(largeInfo);
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidScale ==
+                       codec->getPixels(largeInfo, large.getPixels(), large.rowBytes(),
+                                        NULL, NULL, NULL));
+    REPORTER_ASSERT(r, NULL == codec->getScanlineDecoder(largeInfo));
+
+    // A truncated file still decodes, with the missing rows made up.
+    const SkString path = GetResourcePath("yellow_rose.webp");
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(path.c_str()));
+    SkAutoTUnref<SkData> truncated(SkData::NewSubset(data, 0, data->size() / 2));
+    codec.reset(SkCodec::NewFromData(truncated));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkImageGenerator::kIncompleteInput ==
+                           codec->getPixels(info, bm.getPixels(), bm.rowBytes(),
+                                            NULL, NULL, NULL));
+    }
+}
+
+static void check_subsets(skiatest::Reporter* r, const char path[]) {
+    SkAutoTDelete<SkStream> stream(resource(path));
+    if (!stream) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    const SkImageInfo info = codec->getInfo();
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                       codec->getPixels(info, full.getPixels(), full.rowBytes(), NULL, NULL, NULL));
+
+    // Corners, edges and the middle, each decoded into the top left of the destination.
+    const int w = info.width();
+    const int h = info.height();
+    const SkIRect subsets[] = {
+        SkIRect::MakeWH(w, h),
+        SkIRect::MakeWH(w / 3, h / 3),
+        SkIRect::MakeLTRB(w / 4, h / 4, 3 * w / 4, 3 * h / 4),
+        SkIRect::MakeLTRB(w - 7, h - 5, w, h),
+        SkIRect::MakeLTRB(1, h / 2, w, h / 2 + 1),
+        SkIRect::MakeLTRB(w / 2, 0, w / 2 + 1, h),
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(subsets); ++i) {
+        const SkIRect& subset = subsets[i];
+        const SkImageInfo subsetInfo = info.makeWH(subset.width(), subset.height());
+        SkBitmap bm;
+        bm.allocPixels(subsetInfo);
+        SkImageGenerator::Options options;
+        options.fSubset = &subset;
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                           codec->getPixels(subsetInfo, bm.getPixels(), bm.rowBytes(), &options,
+                                            NULL, NULL));
+        for (int y = 0; y < subset.height(); ++y) {
+            REPORTER_ASSERT(r, 0 == memcmp(full.getAddr32(subset.fLeft, subset.fTop + y),
+                                           bm.getAddr32(0, y), bm.info().minRowBytes()));
+        }
+    }
+
+    // The subset must be inside the image, and the same size as the destination.
+    SkBitmap bm;
+    bm.allocPixels(info.makeWH(8, 8));
+    SkImageGenerator::Options options;
+    const SkIRect outside = SkIRect::MakeXYWH(w - 4, 0, 8, 8);
+    options.fSubset = &outside;
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidParameters ==
+                       codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), &options,
+                                        NULL, NULL));
+    const SkIRect mismatched = SkIRect::MakeWH(4, 4);
+    options.fSubset = &mismatched;
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidParameters ==
+                       codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), &options,
+                                        NULL, NULL));
+}
+
+DEF_TEST(Codec_Subset, r) {
+    check_subsets(r, "arrow.png");
+    check_subsets(r, "mandrill_256.png");
+    check_subsets(r, "yellow_rose.png");
+    check_subsets(r, "CMYK.jpg");
+    check_subsets(r, "grayscale.jpg");
+    check_subsets(r, "mandrill_512_q075.jpg");
+    check_subsets(r, "color_wheel.webp");
+    check_subsets(r, "randPixels.webp");
+
+    // Codecs that can't decode subsets say so.
+    SkAutoTDelete<SkStream> stream(resource("randPixels.bmp"));
+    if (!stream) {
+        SkDebugf("Missing resource 'randPixels.bmp'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo().makeWH(4, 4));
+        const SkIRect subset = SkIRect::MakeWH(4, 4);
+        SkImageGenerator::Options options;
+        options.fSubset = &subset;
+        REPORTER_ASSERT(r, SkImageGenerator::kUnimplemented ==
+                           codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), &options,
+                                            NULL, NULL));
+    }
+}
+
+// Hands out no more than the first fAvailable bytes of its data, like a download in progress.
+class GrowingStream : public SkStream {
+public:
+    GrowingStream(SkData* data)
+        : fData(SkRef(data)), fAvailable(data->size()), fPosition(0), fBytesRead(0) {}
+
+    void setAvailable(size_t available) { fAvailable = SkTMin(available, fData->size()); }
+    size_t bytesRead() const { return fBytesRead; }
+    void resetBytesRead() { fBytesRead = 0; }
+
+    size_t read(void* buffer, size_t size) override {
+        size = SkTMin(size, fAvailable - fPosition);
+        if (buffer) {
+            memcpy(buffer, fData->bytes() + fPosition, size);
+        }
+        fPosition += size;
+        fBytesRead += size;
+        return size;
+    }
+    bool isAtEnd() const override { return fPosition == fData->size(); }
+    bool rewind() override {
+        fPosition = 0;
+        return true;
+    }
+
+private:
+    SkAutoTUnref<SkData> fData;
+    size_t               fAvailable;
+    size_t               fPosition;
+    size_t               fBytesRead;
+};
+
+static void check_incremental(skiatest::Reporter* r, const char path[]) {
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(GetResourcePath(path).c_str()));
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    // The codec reads the header as it's created, so let it see all of the data until then.
+    GrowingStream* stream = SkNEW_ARGS(GrowingStream, (data));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    const SkImageInfo info = codec->getInfo();
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                       codec->getPixels(info, full.getPixels(), full.rowBytes(), NULL, NULL, NULL));
+
+    // Without a start, or after another decode, there is nothing to continue.
+    REPORTER_ASSERT(r, SkImageGenerator::kInvalidParameters == codec->incrementalDecode());
+
+    SkBitmap bm;
+    bm.allocPixels(info);
+    // Starting reads the header again, after that the data is only handed out bit by bit.
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                       codec->startIncrementalDecode(info, bm.getPixels(), bm.rowBytes()));
+    stream->resetBytesRead();
+
+    // Grow the data in uneven steps, checking the rows decoded so far after each one.
+    const size_t step = data->size() / 7 + 1;
+    int rowsDecoded = 0;
+    SkImageGenerator::Result result = SkImageGenerator::kIncompleteInput;
+    for (size_t available = 0; SkImageGenerator::kIncompleteInput == result; available += step) {
+        REPORTER_ASSERT(r, available < data->size() + step);
+        stream->setAvailable(available);
+        const int previousRows = rowsDecoded;
+        result = codec->incrementalDecode(&rowsDecoded);
+        REPORTER_ASSERT(r, SkImageGenerator::kSuccess == result ||
+                           SkImageGenerator::kIncompleteInput == result);
+        REPORTER_ASSERT(r, rowsDecoded >= previousRows && rowsDecoded <= info.height());
+        if (available >= data->size()) {
+            break;
+        }
+    }
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess == result);
+    REPORTER_ASSERT(r, info.height() == rowsDecoded);
+    // Each byte was read once.
+    REPORTER_ASSERT(r, stream->bytesRead() <= data->size());
+
+    for (int y = 0; y < info.height(); ++y) {
+        REPORTER_ASSERT(r, 0 == memcmp(full.getAddr(0, y), bm.getAddr(0, y),
+                                       info.minRowBytes()));
+    }
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess == codec->incrementalDecode(&rowsDecoded));
+}
+
+DEF_TEST(Codec_Incremental, r) {
+    check_incremental(r, "arrow.png");
+    check_incremental(r, "mandrill_256.png");
+    check_incremental(r, "yellow_rose.png");
+
+    // Codecs that can't decode incrementally say so.
+    SkAutoTDelete<SkStream> stream(resource("randPixels.bmp"));
+    if (!stream) {
+        SkDebugf("Missing resource 'randPixels.bmp'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo());
+        REPORTER_ASSERT(r, SkImageGenerator::kUnimplemented ==
+                           codec->startIncrementalDecode(bm.info(), bm.getPixels(),
+                                                         bm.rowBytes()));
+    }
+}
+
+// Converts the planes to RGB as GrYUVtoRGBEffect does for kJPEG_SkYUVColorSpace, with the
+// nearest chroma sample, and returns the average difference from the RGB decode.
+static int average_yuv_difference(const SkBitmap& rgb, const SkISize sizes[3],
+                                  const uint8_t* const planes[3], const size_t rowBytes[3]) {
+    int64_t total = 0;
+    for (int y = 0; y < rgb.height(); ++y) {
+        const int uvY = y * sizes[1].height() / sizes[0].height();
+        for (int x = 0; x < rgb.width(); ++x) {
+            const int uvX = x * sizes[1].width() / sizes[0].width();
+            const float Y = planes[0][y * rowBytes[0] + x];
+            const float U = planes[1][uvY * rowBytes[1] + uvX] - 128.0f;
+            const float V = planes[2][uvY * rowBytes[2] + uvX] - 128.0f;
+            const int R = SkPin32(SkScalarRoundToInt(Y + 1.402f * V), 0, 255);
+            const int G = SkPin32(SkScalarRoundToInt(Y - 0.344136f * U - 0.714136f * V), 0, 255);
+            const int B = SkPin32(SkScalarRoundToInt(Y + 1.772f * U), 0, 255);
+            const SkPMColor c = *rgb.getAddr32(x, y);
+            total += SkTAbs<int>(R - SkGetPackedR32(c)) +
+                     SkTAbs<int>(G - SkGetPackedG32(c)) +
+                     SkTAbs<int>(B - SkGetPackedB32(c));
+        }
+    }
+    return SkToInt(total / (3 * rgb.width() * rgb.height()));
+}
+
+static void check_yuv(skiatest::Reporter* r, const char path[], bool supportsYUV) {
+    SkAutoTDelete<SkStream> stream(resource(path));
+    if (!stream) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    SkISize sizes[3];
+    if (!codec->getYUV8Planes(sizes, NULL, NULL, NULL)) {
+        REPORTER_ASSERT(r, !supportsYUV);
+        return;
+    }
+    REPORTER_ASSERT(r, supportsYUV);
+    const SkImageInfo& info = codec->getInfo();
+    REPORTER_ASSERT(r, sizes[0].width() >= info.width() && sizes[0].height() >= info.height());
+
+    size_t rowBytes[3];
+    SkAutoMalloc storage[3];
+    void* planes[3];
+    for (int i = 0; i < 3; ++i) {
+        rowBytes[i] = sizes[i].width();
+        planes[i] = storage[i].reset(rowBytes[i] * sizes[i].height());
+    }
+    SkYUVColorSpace colorSpace;
+    REPORTER_ASSERT(r, codec->getYUV8Planes(sizes, planes, rowBytes, &colorSpace));
+    REPORTER_ASSERT(r, kJPEG_SkYUVColorSpace == colorSpace);
+    // The sizes are now those of the image, not of its blocks.
+    REPORTER_ASSERT(r, sizes[0] == info.dimensions());
+    REPORTER_ASSERT(r, sizes[1] == sizes[2]);
+
+    // The codec rewinds to decode to RGB, which the planes should match, apart from the
+    // upsampling of the chroma.
+    SkBitmap bm;
+    bm.allocPixels(info);
+    REPORTER_ASSERT(r, SkImageGenerator::kSuccess ==
+                       codec->getPixels(info, bm.getPixels(), bm.rowBytes(), NULL, NULL, NULL));
+    const uint8_t* const constPlanes[3] = {
+        static_cast<uint8_t*>(planes[0]),
+        static_cast<uint8_t*>(planes[1]),
+        static_cast<uint8_t*>(planes[2]),
+    };
+    REPORTER_ASSERT(r, average_yuv_difference(bm, sizes, constPlanes, rowBytes) <= 4);
+
+    // Planes that are too small are refused.
+    sizes[0].set(sizes[0].width() / 2, sizes[0].height());
+    REPORTER_ASSERT(r, !codec->getYUV8Planes(sizes, planes, rowBytes, NULL));
+}
+
+DEF_TEST(Codec_JpegYUV, r) {
+    check_yuv(r, "color_wheel.jpg", true);
+    check_yuv(r, "mandrill_512_q075.jpg", true);
+    check_yuv(r, "randPixels.jpg", true);
+
+    // Neither gray nor CMYK images have chroma planes.
+    check_yuv(r, "CMYK.jpg", false);
+    check_yuv(r, "grayscale.jpg", false);
+
+    // Nor does anything but a JPEG.
+    check_yuv(r, "mandrill_256.png", false);
 }
@@ -5,10 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkColorFilter.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkColorMatrixFilter.h"
 #include "SkColorPriv.h"
 #include "SkLumaColorFilter.h"
+#include "SkTableColorFilter.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkRandom.h"
@@ -147,3 +152,121 @@ DEF_TEST(LumaColorFilter, reporter) {
         REPORTER_ASSERT(reporter, SkGetPackedB32(out) == 0);
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+static SkColorFilter* make_scale_translate(SkScalar scale, SkScalar trans) {
+    SkScalar matrix[20] = { scale, 0, 0, 0, trans,
+                            0, scale, 0, 0, trans,
+                            0, 0, scale, 0, trans,
+                            0, 0, 0, 1, 0 };
+    return SkColorMatrixFilter::Create(matrix);
+}
+
+static bool nearly_equal(SkPMColor a, SkPMColor b, int tolerance) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        if (SkAbs32((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks that outer(inner(c)) is a single table filter that matches running the two in turn.
+static void test_fused_tables(skiatest::Reporter* reporter, SkColorFilter* outer,
+                              SkColorFilter* inner) {
+    SkAutoTUnref<SkColorFilter> fused(SkColorFilter::CreateComposeFilter(outer, inner));
+    REPORTER_ASSERT(reporter, fused && fused->asComponentTable(NULL));
+    if (!fused) {
+        return;
+    }
+    SkRandom rand;
+    for (int i = 0; i < 1000; ++i) {
+        const SkPMColor c = SkPreMultiplyColor(rand.nextU() | 0xFF000000);
+        SkPMColor expected, actual;
+        inner->filterSpan(&c, 1, &expected);
+        outer->filterSpan(&expected, 1, &expected);
+        fused->filterSpan(&c, 1, &actual);
+        REPORTER_ASSERT(reporter, nearly_equal(expected, actual, 1));
+    }
+}
+
+DEF_TEST(ColorFilterFusing, reporter) {
+    uint8_t square[256];
+    for (int i = 0; i < 256; ++i) {
+        square[i] = i * i / 255;
+    }
+    SkAutoTUnref<SkColorFilter> table(SkTableColorFilter::Create(square));
+    // Brightening and darkening clamp, so they can't be concatenated as matrices.
+    SkAutoTUnref<SkColorFilter> brighten(make_scale_translate(1, 40));
+    SkAutoTUnref<SkColorFilter> darken(make_scale_translate(SK_Scalar1 / 2, -20));
+    REPORTER_ASSERT(reporter, brighten->asComponentTable(NULL));
+
+    test_fused_tables(reporter, table, brighten);
+    test_fused_tables(reporter, brighten, table);
+    test_fused_tables(reporter, darken, brighten);
+
+    // A matrix that mixes components is not a table.
+    SkScalar gray[20] = { 0.25f, 0.5f, 0.25f, 0, 0,
+                          0.25f, 0.5f, 0.25f, 0, 0,
+                          0.25f, 0.5f, 0.25f, 0, 0,
+                          0, 0, 0, 1, 0 };
+    SkAutoTUnref<SkColorFilter> grayscale(SkColorMatrixFilter::Create(gray));
+    REPORTER_ASSERT(reporter, !grayscale->asComponentTable(NULL));
+
+    // Filters that can't be fused still filter long spans as if run one after the other.
+    SkAutoTUnref<SkColorFilter> mode(make_filter());
+    SkAutoTUnref<SkColorFilter> composed(SkColorFilter::CreateComposeFilter(mode, grayscale));
+    REPORTER_ASSERT(reporter, composed);
+    if (composed) {
+        SkPMColor src[1000], expected[1000], actual[1000];
+        SkRandom rand;
+        for (int i = 0; i < 1000; ++i) {
+            src[i] = SkPreMultiplyColor(rand.nextU());
+        }
+        grayscale->filterSpan(src, 1000, expected);
+        mode->filterSpan(expected, 1000, expected);
+        composed->filterSpan(src, 1000, actual);
+        REPORTER_ASSERT(reporter, !memcmp(expected, actual, sizeof(actual)));
+    }
+}
+
+DEF_TEST(ColorFilterImageFilterOnPaint, reporter) {
+    // A color filter node on the paint draws like it does on a layer underneath the image filter.
+    SkAutoTUnref<SkColorFilter> brighten(make_scale_translate(1, 40));
+    SkAutoTUnref<SkColorFilter> darken(make_scale_translate(SK_Scalar1 / 2, 0));
+    SkAutoTUnref<SkImageFilter> imageFilter(SkColorFilterImageFilter::Create(darken));
+
+    SkPaint paint;
+    paint.setColor(0xFF4080C0);
+    paint.setColorFilter(brighten);
+    paint.setImageFilter(imageFilter);
+    const SkRect rect = SkRect::MakeXYWH(4, 6, 20, 10);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(32, 32);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.allocN32Pixels(32, 32);
+    actual.eraseColor(SK_ColorWHITE);
+    {
+        SkCanvas canvas(expected);
+        SkPaint layerPaint;
+        layerPaint.setImageFilter(imageFilter);
+        canvas.saveLayer(NULL, &layerPaint);
+        SkPaint drawPaint(paint);
+        drawPaint.setImageFilter(NULL);
+        canvas.drawRect(rect, drawPaint);
+        canvas.restore();
+    }
+    {
+        SkCanvas canvas(actual);
+        canvas.drawRect(rect, paint);
+    }
+    SkAutoLockPixels expectedLock(expected), actualLock(actual);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            REPORTER_ASSERT(reporter, nearly_equal(*expected.getAddr32(x, y),
+                                                   *actual.getAddr32(x, y), 1));
+        }
+    }
+}
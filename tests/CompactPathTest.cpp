@@ -0,0 +1,94 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCompactPath.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// Checks that compact's Iter matches SkPath::Iter over the path it rebuilds.
+static void check_iter(skiatest::Reporter* reporter, const SkCompactPath& compact,
+                       bool forceClose) {
+    SkPath path;
+    compact.toPath(&path);
+    SkPath::Iter pathIter(path, forceClose);
+    SkCompactPath::Iter compactIter(compact, forceClose);
+    SkPoint pathPts[4], compactPts[4];
+    SkPath::Verb verb;
+    do {
+        verb = pathIter.next(pathPts);
+        REPORTER_ASSERT(reporter, verb == compactIter.next(compactPts));
+        int count = SkPath::kLine_Verb == verb ? 2 : SkPath::kDone_Verb == verb ? 0 : 1;
+        for (int index = 0; index < count; ++index) {
+            REPORTER_ASSERT(reporter, pathPts[index] == compactPts[index]);
+        }
+    } while (SkPath::kDone_Verb != verb);
+}
+
+DEF_TEST(CompactPath, reporter) {
+    const SkScalar tolerance = SK_Scalar1 / 64;
+    SkRandom rand;
+    SkPath path;
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    for (int contour = 0; contour < 10; ++contour) {
+        path.moveTo(rand.nextRangeF(0, 1000), rand.nextRangeF(-500, 500));
+        for (int index = 0; index < 100; ++index) {
+            path.lineTo(rand.nextRangeF(0, 1000), rand.nextRangeF(-500, 500));
+        }
+        if (contour & 1) {
+            path.close();
+        }
+    }
+
+    SkAutoTUnref<SkCompactPath> compact(SkCompactPath::Create(path, tolerance));
+    REPORTER_ASSERT(reporter, compact);
+    REPORTER_ASSERT(reporter, compact->countPoints() == path.countPoints());
+    REPORTER_ASSERT(reporter, compact->countContours() == 10);
+    size_t pathBytes = path.countPoints() * sizeof(SkPoint) + path.countVerbs();
+    REPORTER_ASSERT(reporter, compact->approximateBytesUsed() < pathBytes / 2);
+
+    SkPath rebuilt;
+    compact->toPath(&rebuilt);
+    REPORTER_ASSERT(reporter, rebuilt.getFillType() == path.getFillType());
+    REPORTER_ASSERT(reporter, rebuilt.countVerbs() == path.countVerbs());
+    REPORTER_ASSERT(reporter, rebuilt.getBounds() == compact->getBounds());
+    for (int index = 0; index < path.countPoints(); ++index) {
+        SkPoint delta = rebuilt.getPoint(index) - path.getPoint(index);
+        REPORTER_ASSERT(reporter, SkScalarAbs(delta.fX) <= tolerance);
+        REPORTER_ASSERT(reporter, SkScalarAbs(delta.fY) <= tolerance);
+    }
+    check_iter(reporter, *compact, false);
+    check_iter(reporter, *compact, true);
+
+    // 16 bits can't reach this tolerance across this path.
+    REPORTER_ASSERT(reporter, NULL == SkCompactPath::Create(path, SK_Scalar1 / 1024));
+
+    // Curves aren't kept.
+    SkPath curved(path);
+    curved.quadTo(0, 0, 10, 10);
+    REPORTER_ASSERT(reporter, NULL == SkCompactPath::Create(curved, tolerance));
+
+    // Lone moves and repeated points are dropped.
+    SkPath sparse;
+    sparse.moveTo(5, 5);
+    sparse.moveTo(0, 0);
+    sparse.lineTo(10, 0);
+    sparse.lineTo(10, 0);
+    sparse.lineTo(10, 10);
+    sparse.close();
+    sparse.moveTo(20, 20);
+    compact.reset(SkCompactPath::Create(sparse, tolerance));
+    REPORTER_ASSERT(reporter, compact);
+    REPORTER_ASSERT(reporter, 3 == compact->countPoints());
+    REPORTER_ASSERT(reporter, 1 == compact->countContours());
+    check_iter(reporter, *compact, false);
+
+    SkPath empty;
+    compact.reset(SkCompactPath::Create(empty, tolerance));
+    REPORTER_ASSERT(reporter, compact);
+    REPORTER_ASSERT(reporter, 0 == compact->countPoints());
+    check_iter(reporter, *compact, true);
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkCompiledPicture.h"
+#include "SkDashPathEffect.h"
+#include "SkGradientShader.h"
+#include "SkPictureRecorder.h"
+#include "Test.h"
+
+static const int kW = 128;
+static const int kH = 96;
+
+static SkPicture* make_picture() {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kW), SkIntToScalar(kH));
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(0xC0306090);
+    canvas->drawCircle(30.5f, 20.25f, 17.3f, paint);
+
+    SkPath path;
+    path.moveTo(5, 90);
+    path.lineTo(60, 40);
+    path.quadTo(90, 90, 120, 10);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    paint.setColor(0xFF20F040);
+    paint.setXfermodeMode(SkXfermode::kMultiply_Mode);
+    canvas->drawPath(path, paint);
+
+    canvas->save();
+        canvas->translate(60, 50);
+        canvas->rotate(30);
+        SkScalar intervals[] = { 4, 2 };
+        SkAutoTUnref<SkPathEffect> dash(SkDashPathEffect::Create(intervals, 2, 0));
+        paint.setPathEffect(dash);
+        paint.setXfermode(NULL);
+        paint.setColor(0x80F04010);
+        SkRRect rrect;
+        rrect.setRectXY(SkRect::MakeWH(40, 25), 5, 5);
+        canvas->drawRRect(rrect, paint);
+    canvas->restore();
+
+    SkAutoTUnref<SkMaskFilter> blur(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 2));
+    paint.reset();
+    paint.setAntiAlias(true);
+    paint.setMaskFilter(blur);
+    canvas->drawOval(SkRect::MakeXYWH(70, 60, 40, 20), paint);
+
+    // Ops with shaders aren't compiled.
+    const SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kW), SkIntToScalar(kH) } };
+    const SkColor colors[] = { 0x40000000, 0x4000FF00 };
+    SkAutoTUnref<SkShader> gradient(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                                   SkShader::kClamp_TileMode));
+    paint.reset();
+    paint.setShader(gradient);
+    canvas->drawOval(SkRect::MakeWH(SkIntToScalar(kW), SkIntToScalar(kH)), paint);
+
+    return recorder.endRecording();
+}
+
+static void draw(SkBitmap* bm, const SkMatrix& matrix, const SkPicture* picture,
+                 const SkCompiledPicture* compiled) {
+    bm->allocN32Pixels(kW, kH);
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.concat(matrix);
+    if (compiled) {
+        compiled->playback(&canvas);
+    } else {
+        picture->playback(&canvas);
+    }
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int maxDiff = 0;
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            SkPMColor ca = *a.getAddr32(x, y),
+                      cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                int diff = (int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF);
+                maxDiff = SkTMax(maxDiff, SkAbs32(diff));
+            }
+        }
+    }
+    return maxDiff;
+}
+
+// Blitting the compiled masks should draw what scan converting the ops draws, give or take
+// rounding.  (Anti-aliased edges the canvas clips can come out a little differently, as the mask
+// was scan converted unclipped.)
+DEF_TEST(CompiledPicture_MatchesPlayback, r) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+
+    SkMatrix matrices[3];
+    matrices[0].reset();
+    matrices[1].setScale(0.75f, 0.8f);
+    matrices[1].postTranslate(10.5f, 3);
+    matrices[2].setRotate(10, 64, 48);
+    matrices[2].postScale(0.8f, 0.8f, 64, 48);   // Keeps everything off the canvas' edges.
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); i++) {
+        SkAutoTDelete<SkCompiledPicture> compiled(SkCompiledPicture::Create(picture, matrices[i]));
+        REPORTER_ASSERT(r, 4 == compiled->maskCount());
+
+        SkBitmap expected, actual;
+        draw(&expected, matrices[i], picture, NULL);
+        draw(&actual, matrices[i], picture, compiled);
+        REPORTER_ASSERT(r, max_diff(expected, actual) <= 2);
+    }
+}
+
+// At any other matrix we just play the picture back.
+DEF_TEST(CompiledPicture_OtherMatrix, r) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+    SkAutoTDelete<SkCompiledPicture> compiled(SkCompiledPicture::Create(picture, SkMatrix::I()));
+
+    SkMatrix matrix;
+    matrix.setScale(1.5f, 1.5f);
+    SkBitmap expected, actual;
+    draw(&expected, matrix, picture, NULL);
+    draw(&actual, matrix, picture, compiled);
+    REPORTER_ASSERT(r, 0 == max_diff(expected, actual));
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkConvolver.h"
+#include "SkRandom.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// A six tap filter with some negative lobes for each of dstSize values, scaling from srcSize.
+static void make_filter(SkConvolutionFilter1D* filter, int srcSize, int dstSize) {
+    static const float gTaps[] = { -0.05f, 0.15f, 0.4f, 0.4f, 0.15f, -0.05f };
+    for (int i = 0; i < dstSize; ++i) {
+        int offset = i * srcSize / dstSize - 2;
+        int begin = SkTMax(offset, 0);
+        int end = SkTMin(offset + (int)SK_ARRAY_COUNT(gTaps), srcSize);
+        filter->AddFilter(begin, &gTaps[begin - offset], end - begin);
+    }
+}
+
+static void convolve(const SkAutoTMalloc<uint32_t>& src, int srcWidth, bool hasAlpha,
+                     const SkConvolutionFilter1D& filterX, const SkConvolutionFilter1D& filterY,
+                     const SkConvolutionProcs& procs, uint32_t* dst) {
+    BGRAConvolve2D((const unsigned char*)src.get(), srcWidth * 4, hasAlpha, filterX, filterY,
+                   filterX.numValues() * 4, (unsigned char*)dst, procs, true);
+}
+
+// Big outputs are convolved in bands, perhaps on other threads, and with whichever SIMD procs
+// the CPU has. None of that may change a single pixel.
+DEF_TEST(Convolver_BandsAndProcs, reporter) {
+    const int srcWidth = 701, srcHeight = 1203;
+    const int dstWidth = 467, dstHeight = 802;
+
+    SkRandom rand;
+    SkAutoTMalloc<uint32_t> src(srcWidth * srcHeight);
+    for (int i = 0; i < srcWidth * srcHeight; ++i) {
+        src[i] = rand.nextU();
+    }
+
+    SkConvolutionProcs platformProcs = { 0, NULL, NULL, NULL, NULL };
+    SkBitmapScaler::PlatformConvolutionProcs(&platformProcs);
+    const SkConvolutionProcs portableProcs = { 0, NULL, NULL, NULL, NULL };
+
+    SkConvolutionFilter1D filterX, paddedFilterX, filterY;
+    make_filter(&filterX, srcWidth, dstWidth);
+    make_filter(&paddedFilterX, srcWidth, dstWidth);
+    if (platformProcs.fApplySIMDPadding) {
+        platformProcs.fApplySIMDPadding(&paddedFilterX);
+    }
+    make_filter(&filterY, srcHeight, dstHeight);
+
+    for (int hasAlpha = 0; hasAlpha < 2; ++hasAlpha) {
+        SkAutoTMalloc<uint32_t> portable(dstWidth * dstHeight);
+        convolve(src, srcWidth, SkToBool(hasAlpha), filterX, filterY, portableProcs,
+                 portable.get());
+
+        SkAutoTMalloc<uint32_t> platform(dstWidth * dstHeight);
+        convolve(src, srcWidth, SkToBool(hasAlpha), paddedFilterX, filterY, platformProcs,
+                 platform.get());
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(portable.get(), platform.get(), dstWidth * dstHeight * 4));
+
+        // One row at a time is too small to be split up.
+        int mismatches = 0;
+        SkAutoTMalloc<uint32_t> row(dstWidth);
+        for (int y = 0; y < dstHeight; y += 7) {
+            int offset, length;
+            const SkConvolutionFilter1D::ConvolutionFixed* values =
+                    filterY.FilterForValue(y, &offset, &length);
+            SkConvolutionFilter1D oneRow;
+            oneRow.AddFilter(offset, values, length);
+            convolve(src, srcWidth, SkToBool(hasAlpha), filterX, oneRow, portableProcs,
+                     row.get());
+            mismatches += 0 != memcmp(row.get(), &portable[y * dstWidth], dstWidth * 4);
+        }
+        REPORTER_ASSERT(reporter, 0 == mismatches);
+    }
+}
+
+// Resizes with the same sizes and method share their filters through the SkResourceCache,
+// which must not change the pixels they make.
+DEF_TEST(BitmapScaler_CachedFilters, reporter) {
+    SkRandom rand;
+    SkBitmap src;
+    src.allocN32Pixels(123, 77);
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    const SkBitmapScaler::ResizeMethod methods[] = {
+        SkBitmapScaler::RESIZE_BOX,
+        SkBitmapScaler::RESIZE_TRIANGLE,
+        SkBitmapScaler::RESIZE_LANCZOS3,
+        SkBitmapScaler::RESIZE_HAMMING,
+        SkBitmapScaler::RESIZE_MITCHELL,
+    };
+    const SkISize sizes[] = { SkISize::Make(31, 19), SkISize::Make(31, 31), SkISize::Make(200, 9) };
+    for (size_t m = 0; m < SK_ARRAY_COUNT(methods); ++m) {
+        for (size_t s = 0; s < SK_ARRAY_COUNT(sizes); ++s) {
+            const float width = (float)sizes[s].width();
+            const float height = (float)sizes[s].height();
+            SkBitmap first, second;
+            REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&first, src, methods[m],
+                                                             width, height));
+            REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&second, src, methods[m],
+                                                             width, height));
+            REPORTER_ASSERT(reporter, first.dimensions() == sizes[s]);
+            REPORTER_ASSERT(reporter, second.dimensions() == sizes[s]);
+            if (first.dimensions() != sizes[s] || second.dimensions() != sizes[s]) {
+                continue;
+            }
+            bool same = true;
+            for (int y = 0; y < sizes[s].height(); ++y) {
+                same &= 0 == memcmp(first.getAddr32(0, y), second.getAddr32(0, y),
+                                    sizes[s].width() * sizeof(SkPMColor));
+            }
+            REPORTER_ASSERT(reporter, same);
+        }
+    }
+}
@@ -7,7 +7,12 @@
 
 #include "Test.h"
 
+#include "Sk1DPathEffect.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkDashPathEffect.h"
+#include "SkDashPathPriv.h"
+#include "SkStrokeRec.h"
 #include "SkWriteBuffer.h"
 
 // crbug.com/348821 was rooted in SkDashPathEffect refusing to flatten and unflatten itself when
@@ -86,3 +91,239 @@ DEF_TEST(DashPathEffectTest_asPoints, r) {
         }
     }
 }
+
+namespace {
+struct StreamedDashes {
+    StreamedDashes() : fBatchCount(0), fMaxBatchDashes(0) {}
+
+    SkPath   fDashes;
+    SkRect   fBatchBounds;
+    int      fBatchCount;
+    int      fMaxBatchDashes;
+};
+}
+
+static void collect_dashes(const SkPath& dashes, const SkStrokeRec&, void* ctx) {
+    StreamedDashes* streamed = static_cast<StreamedDashes*>(ctx);
+    if (0 == streamed->fBatchCount++) {
+        streamed->fBatchBounds = dashes.getBounds();
+    } else {
+        streamed->fBatchBounds.join(dashes.getBounds());
+    }
+    int dashCount = 0;
+    SkPath::RawIter iter(dashes);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        dashCount += SkPath::kMove_Verb == verb;
+    }
+    streamed->fMaxBatchDashes = SkTMax(streamed->fMaxBatchDashes, dashCount);
+    streamed->fDashes.addPath(dashes);
+}
+
+static bool all_dashes_touch(const SkPath& dashes, const SkRect& rect) {
+    SkPath::RawIter iter(dashes);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    SkRect bounds = SkRect::MakeEmpty();
+    bool touches = true;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        if (SkPath::kMove_Verb == verb) {
+            touches &= bounds.isEmpty() || SkRect::Intersects(bounds, rect);
+            bounds.setBounds(pts, 1);
+        } else if (SkPath::kClose_Verb != verb) {
+            bounds.growToInclude(pts[1].fX, pts[1].fY);
+        }
+    }
+    return touches && SkRect::Intersects(bounds, rect);
+}
+
+// Streaming the dashes hands over the same dashes FilterDashPath() builds, a batch at a time.
+DEF_TEST(DashPathEffectTest_stream, r) {
+    SkPath src;
+    src.addCircle(100, 100, 80);
+    src.moveTo(10, 10);
+    for (int i = 1; i < 20; ++i) {
+        src.lineTo(SkIntToScalar(10 + 10 * i), SkIntToScalar(10 + 15 * (i & 1)));
+    }
+
+    SkPathEffect::DashInfo info;
+    const SkScalar intervals[] = { 3, 2, 1, 2 };
+    info.fIntervals = const_cast<SkScalar*>(intervals);
+    info.fCount = SK_ARRAY_COUNT(intervals);
+    info.fPhase = 1;
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+
+    SkStrokeRec filterRec(paint);
+    SkPath filtered;
+    REPORTER_ASSERT(r, SkDashPath::FilterDashPath(&filtered, src, &filterRec, NULL, info));
+
+    StreamedDashes streamed;
+    SkStrokeRec streamRec(paint);
+    REPORTER_ASSERT(r, SkDashPath::StreamDashPath(src, &streamRec, NULL, info, 16,
+                                                  collect_dashes, &streamed));
+    REPORTER_ASSERT(r, streamed.fBatchCount > 1);
+    REPORTER_ASSERT(r, streamed.fMaxBatchDashes <= 16);
+    REPORTER_ASSERT(r, streamed.fDashes.countPoints() == filtered.countPoints());
+    REPORTER_ASSERT(r, streamed.fDashes.countVerbs() == filtered.countVerbs());
+    REPORTER_ASSERT(r, streamed.fDashes.getBounds() == filtered.getBounds());
+
+    // Dashes that can't touch the cull rect are dropped.
+    SkRect cull = SkRect::MakeLTRB(150, 80, 250, 120);
+    StreamedDashes culled;
+    SkStrokeRec cullRec(paint);
+    REPORTER_ASSERT(r, SkDashPath::StreamDashPath(src, &cullRec, &cull, info, 16,
+                                                  collect_dashes, &culled));
+    REPORTER_ASSERT(r, culled.fBatchCount > 0);
+    REPORTER_ASSERT(r, culled.fDashes.countVerbs() < streamed.fDashes.countVerbs() / 4);
+    // The cull rect is outset by the stroke's miter radius.
+    cull.outset(4, 4);
+    REPORTER_ASSERT(r, all_dashes_touch(culled.fDashes, cull));
+}
+
+// A path with too many dashes to hold at once draws the same as its dashes drawn as a path.
+DEF_TEST(DashPathEffectTest_drawStreamed, r) {
+    // Rows far enough apart that no two dashes touch the same pixel.
+    SkPath src;
+    for (int y = 0; y < 200; ++y) {
+        src.moveTo(2, SkIntToScalar(2 + 3 * y));
+        src.lineTo(252, SkIntToScalar(2 + 3 * y));
+    }
+
+    const SkScalar intervals[] = { 2, 3 };
+    SkAutoTUnref<SkPathEffect> dash(SkDashPathEffect::Create(intervals, 2, 0));
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(1.5f);
+    paint.setStrokeCap(SkPaint::kRound_Cap);
+    paint.setColor(0x80336699);
+
+    for (int aa = 0; aa < 2; ++aa) {
+        paint.setAntiAlias(SkToBool(aa));
+
+        SkBitmap streamed, expected;
+        streamed.allocN32Pixels(256, 604);
+        expected.allocN32Pixels(256, 604);
+        streamed.eraseColor(SK_ColorWHITE);
+        expected.eraseColor(SK_ColorWHITE);
+
+        SkPaint dashPaint(paint);
+        dashPaint.setPathEffect(dash);
+        SkCanvas(streamed).drawPath(src, dashPaint);
+
+        SkPath dashes;
+        SkStrokeRec rec(paint);
+        REPORTER_ASSERT(r, dash->filterPath(&dashes, src, &rec, NULL));
+        REPORTER_ASSERT(r, dashes.countVerbs() > 2 * 4096);
+        SkCanvas(expected).drawPath(dashes, paint);
+
+        SkAutoLockPixels lockStreamed(streamed), lockExpected(expected);
+        int maxDiff = 0;
+        for (int y = 0; y < expected.height(); ++y) {
+            for (int x = 0; x < expected.width(); ++x) {
+                SkPMColor s = *streamed.getAddr32(x, y);
+                SkPMColor e = *expected.getAddr32(x, y);
+                maxDiff = SkTMax(maxDiff, SkAbs32(SkGetPackedG32(s) - SkGetPackedG32(e)));
+                maxDiff = SkTMax(maxDiff, SkAbs32(SkGetPackedB32(s) - SkGetPackedB32(e)));
+            }
+        }
+        REPORTER_ASSERT(r, maxDiff <= 1);
+    }
+}
+
+// A long wavy path that mostly runs outside of a 100x100 device.
+static void make_offscreen_path(SkPath* path) {
+    path->moveTo(-2000, 50);
+    for (int i = 0; i < 400; ++i) {
+        SkScalar x = SkIntToScalar(-2000 + 20 * i);
+        path->quadTo(x + 5, SkIntToScalar(i & 1 ? 80 : 20), x + 10, 50);
+        path->quadTo(x + 15, SkIntToScalar(i & 1 ? 30 : 70), x + 20, 50);
+    }
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkPMColor pa = *a.getAddr32(x, y);
+            SkPMColor pb = *b.getAddr32(x, y);
+            maxDiff = SkTMax(maxDiff, SkAbs32(SkGetPackedA32(pa) - SkGetPackedA32(pb)));
+            maxDiff = SkTMax(maxDiff, SkAbs32(SkGetPackedG32(pa) - SkGetPackedG32(pb)));
+        }
+    }
+    return maxDiff;
+}
+
+static void draw_filtered(SkBitmap* bm, const SkPath& path, const SkPaint& paint) {
+    bm->allocN32Pixels(100, 100);
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(*bm).drawPath(path, paint);
+}
+
+// Dashes that can't reach the cull rect are skipped without changing the ones that can.
+DEF_TEST(DashPathEffectTest_cull, r) {
+    SkPath src;
+    make_offscreen_path(&src);
+    const SkRect cull = SkRect::MakeLTRB(-1, -1, 101, 101);
+
+    const SkScalar intervals[] = { 4, 2, 1, 3 };
+    SkAutoTUnref<SkPathEffect> dash(SkDashPathEffect::Create(intervals, 4, 1.5f));
+
+    const SkPaint::Cap caps[] = { SkPaint::kButt_Cap, SkPaint::kSquare_Cap };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(caps); ++i) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(3);
+        paint.setStrokeCap(caps[i]);
+
+        SkPath all, culled;
+        SkStrokeRec allRec(paint), culledRec(paint);
+        REPORTER_ASSERT(r, dash->filterPath(&all, src, &allRec, NULL));
+        REPORTER_ASSERT(r, dash->filterPath(&culled, src, &culledRec, &cull));
+        REPORTER_ASSERT(r, culled.countVerbs() > 0);
+        REPORTER_ASSERT(r, culled.countVerbs() < all.countVerbs() / 10);
+
+        SkBitmap allBM, culledBM;
+        draw_filtered(&allBM, all, paint);
+        draw_filtered(&culledBM, culled, paint);
+        REPORTER_ASSERT(r, max_diff(allBM, culledBM) <= 1);
+    }
+}
+
+// So are the stamps of an SkPath1DPathEffect, for every style.
+DEF_TEST(Path1DPathEffect_cull, r) {
+    SkPath src;
+    make_offscreen_path(&src);
+    const SkRect cull = SkRect::MakeLTRB(-1, -1, 101, 101);
+
+    SkPath stamp;
+    stamp.addRect(SkRect::MakeLTRB(-2, -3, 4, 3));
+    const SkPath1DPathEffect::Style styles[] = {
+        SkPath1DPathEffect::kTranslate_Style,
+        SkPath1DPathEffect::kRotate_Style,
+        SkPath1DPathEffect::kMorph_Style,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(styles); ++i) {
+        SkAutoTUnref<SkPathEffect> effect(SkPath1DPathEffect::Create(stamp, 9, 2, styles[i]));
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        SkPath all, culled;
+        SkStrokeRec allRec(paint), culledRec(paint);
+        REPORTER_ASSERT(r, effect->filterPath(&all, src, &allRec, NULL));
+        REPORTER_ASSERT(r, effect->filterPath(&culled, src, &culledRec, &cull));
+        REPORTER_ASSERT(r, culled.countVerbs() > 0);
+        REPORTER_ASSERT(r, culled.countVerbs() < all.countVerbs() / 10);
+
+        SkBitmap allBM, culledBM;
+        draw_filtered(&allBM, all, paint);
+        draw_filtered(&culledBM, culled, paint);
+        REPORTER_ASSERT(r, max_diff(allBM, culledBM) <= 1);
+    }
+}
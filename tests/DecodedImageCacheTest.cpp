@@ -0,0 +1,117 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkBitmap.h"
+#include "SkCachingPixelRef.h"
+#include "SkColorPriv.h"
+#include "SkDecodedImageCache.h"
+#include "SkGraphics.h"
+#include "SkTaskGroup.h"
+#include "SkUtils.h"
+#include "Test.h"
+
+namespace {
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(int32_t* decodes)
+        : INHERITED(SkImageInfo::MakeN32Premul(32, 32)), fDecodes(decodes) {}
+
+protected:
+    Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, const Options&,
+                       SkPMColor*, int*) override {
+        sk_atomic_inc(fDecodes);
+        for (int y = 0; y < info.height(); y++) {
+            sk_memset32((uint32_t*)((char*)pixels + y * rowBytes),
+                        SkPreMultiplyColor(SK_ColorGREEN), info.width());
+        }
+        return kSuccess;
+    }
+
+private:
+    int32_t* fDecodes;
+
+    typedef SkImageGenerator INHERITED;
+};
+}  // namespace
+
+static void lock_and_check(skiatest::Reporter* r, const SkBitmap& bitmap) {
+    SkAutoLockPixels alp(bitmap);
+    REPORTER_ASSERT(r, bitmap.getPixels());
+    if (bitmap.getPixels()) {
+        REPORTER_ASSERT(r, SkPreMultiplyColor(SK_ColorGREEN) == *bitmap.getAddr32(5, 5));
+    }
+}
+
+// Other tests share the global cache, and may purge it, so this only checks what pinning
+// guarantees, and what a prefetch must have done.
+DEF_TEST(DecodedImageCache, r) {
+    int32_t decodes[3] = { 0, 0, 0 };
+    SkBitmap bitmaps[3];
+    for (int i = 0; i < 3; i++) {
+        REPORTER_ASSERT(r, SkCachingPixelRef::Install(SkNEW_ARGS(CountingGenerator,
+                                                                 (&decodes[i])),
+                                                      &bitmaps[i]));
+    }
+
+    // Prefetching decodes each bitmap once, and the decodes are kept in the cache.
+    SkTaskGroup taskGroup;
+    REPORTER_ASSERT(r, 3 == SkDecodedImageCache::Prefetch(bitmaps, 3, &taskGroup));
+    taskGroup.wait();
+    for (int i = 0; i < 3; i++) {
+        REPORTER_ASSERT(r, 1 == sk_atomic_load(&decodes[i]));
+        SkBitmap cached;
+        const SkIRect bounds = bitmaps[i].info().bounds();
+        if (SkDecodedImageCache::Find(bitmaps[i].getGenerationID(), bounds, &cached)) {
+            REPORTER_ASSERT(r, cached.getPixels());
+            // Already cached, so there is nothing to prefetch.
+            REPORTER_ASSERT(r, 0 == SkDecodedImageCache::Prefetch(&bitmaps[i], 1, &taskGroup));
+        }
+    }
+
+    // Pinned pixels survive purges, and aren't decoded again.
+    REPORTER_ASSERT(r, SkDecodedImageCache::Pin(bitmaps[0]));
+    const int32_t pinnedDecodes = sk_atomic_load(&decodes[0]);
+    SkResourceCache::Stats stats;
+    SkDecodedImageCache::GetStats(&stats);
+    REPORTER_ASSERT(r, stats.fPinnedCount >= 1);
+    REPORTER_ASSERT(r, stats.fPinnedBytes >= bitmaps[0].getSize());
+    SkGraphics::PurgeResourceCache();
+    lock_and_check(r, bitmaps[0]);
+    REPORTER_ASSERT(r, pinnedDecodes == sk_atomic_load(&decodes[0]));
+
+    // Once unpinned, they can be purged again.
+    REPORTER_ASSERT(r, SkDecodedImageCache::Unpin(bitmaps[0]));
+    REPORTER_ASSERT(r, !SkDecodedImageCache::Unpin(bitmaps[0]));
+    SkDecodedImageCache::PurgeAll();
+    lock_and_check(r, bitmaps[0]);
+    REPORTER_ASSERT(r, pinnedDecodes + 1 == sk_atomic_load(&decodes[0]));
+
+    // Pinning a bitmap that isn't cached decodes it.
+    SkDecodedImageCache::PurgeAll();
+    const int32_t decodesBeforePin = sk_atomic_load(&decodes[1]);
+    REPORTER_ASSERT(r, SkDecodedImageCache::Pin(bitmaps[1]));
+    REPORTER_ASSERT(r, decodesBeforePin + 1 == sk_atomic_load(&decodes[1]));
+    lock_and_check(r, bitmaps[1]);
+    REPORTER_ASSERT(r, decodesBeforePin + 1 == sk_atomic_load(&decodes[1]));
+    REPORTER_ASSERT(r, SkDecodedImageCache::Unpin(bitmaps[1]));
+
+    // Bitmaps that aren't lazily decoded are neither prefetched nor pinned.
+    SkBitmap raster;
+    raster.allocN32Pixels(8, 8);
+    REPORTER_ASSERT(r, 0 == SkDecodedImageCache::Prefetch(&raster, 1, &taskGroup));
+    REPORTER_ASSERT(r, !SkDecodedImageCache::Pin(raster));
+}
+
+DEF_TEST(DecodedImageCache_Budget, r) {
+    // The decoded images have a budget of their own.
+    const size_t resourceLimit = SkGraphics::GetResourceCacheTotalByteLimit();
+    const size_t prevLimit = SkGraphics::SetDecodedImageCacheTotalByteLimit(resourceLimit + 1);
+    REPORTER_ASSERT(r, resourceLimit + 1 == SkGraphics::GetDecodedImageCacheTotalByteLimit());
+    REPORTER_ASSERT(r, resourceLimit == SkGraphics::GetResourceCacheTotalByteLimit());
+    SkGraphics::SetDecodedImageCacheTotalByteLimit(prevLimit);
+}
@@ -506,6 +506,48 @@ static void TestDeferredCanvasMemoryLimit(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, 1 == notificationCounter.fFlushedDrawCommandsCount);
 }
 
+static void TestDeferredCanvasBackgroundPlayback(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(100, 100));
+    SkAutoTUnref<SkDeferredCanvas> canvas(SkDeferredCanvas::Create(
+            surface.get(), SkDeferredCanvas::kBackground_PlaybackThread));
+
+    NotificationCounter notificationCounter;
+    canvas->setNotificationClient(&notificationCounter);
+
+    canvas->setMaxRecordingStorage(160000);
+
+    // Each 20 by 100 strip takes 8,000 bytes, so recording them reaches the limit.
+    static const SkColor kColors[] = {
+        SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorYELLOW, SK_ColorCYAN,
+    };
+    SkBitmap sourceImage;
+    sourceImage.allocN32Pixels(20, 100);
+    for (int pass = 0; pass < 10; pass++) {
+        for (int i = 0; i < (int)SK_ARRAY_COUNT(kColors); i++) {
+            // Changing the pixels must not change what was already recorded.
+            sourceImage.eraseColor(kColors[(i + pass) % SK_ARRAY_COUNT(kColors)]);
+            canvas->drawBitmap(sourceImage, SkIntToScalar(20 * i), 0, NULL);
+        }
+    }
+    REPORTER_ASSERT(reporter, notificationCounter.fFlushedDrawCommandsCount > 0);
+
+    canvas->flushInBackground();
+    SkPaint paint;
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawRect(SkRect::MakeXYWH(90, 90, 10, 10), paint);
+
+    // Reading waits for everything to be played back, in order.
+    SkBitmap result;
+    result.allocN32Pixels(100, 100);
+    REPORTER_ASSERT(reporter, canvas->readPixels(&result, 0, 0));
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(kColors); i++) {
+        SkColor expected = kColors[(i + 9) % SK_ARRAY_COUNT(kColors)];
+        REPORTER_ASSERT(reporter, expected == result.getColor(20 * i + 5, 5));
+    }
+    REPORTER_ASSERT(reporter, SK_ColorBLACK == result.getColor(95, 95));
+    REPORTER_ASSERT(reporter, !canvas->hasPendingCommands());
+}
+
 static void TestDeferredCanvasSilentFlush(skiatest::Reporter* reporter) {
     SkAutoTUnref<SkSurface> surface(createSurface(0));
     SkAutoTUnref<SkDeferredCanvas> canvas(SkDeferredCanvas::Create(surface.get()));
@@ -926,6 +968,7 @@ DEF_TEST(DeferredCanvas_CPU, reporter) {
     TestDeferredCanvasSilentFlush(reporter);
     TestDeferredCanvasFreshFrame(reporter);
     TestDeferredCanvasMemoryLimit(reporter);
+    TestDeferredCanvasBackgroundPlayback(reporter);
     TestDeferredCanvasBitmapCaching(reporter);
     TestDeferredCanvasSkip(reporter);
     TestDeferredCanvasBitmapShaderNoLeak(reporter);
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkData.h"
 #include "SkFlate.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -70,3 +71,47 @@ DEF_TEST(SkDeflateWStream, r) {
         }
     }
 }
+
+// Every level and strategy must round trip, including writes big enough to be
+// compressed straight from the caller's memory, and mixes of small and big.
+DEF_TEST(SkDeflateWStream_LevelsAndStrategies, r) {
+    static const size_t kSize = 50000;
+    SkAutoTMalloc<uint8_t> buffer(kSize);
+    SkRandom random(654321);
+    for (size_t i = 0; i < kSize; ++i) {
+        // Runs and repeats, so that every strategy has something to find.
+        buffer[i] = (i / 7) % 3 ? buffer[i / 2] : random.nextU() & 0xff;
+    }
+
+    const SkDeflateWStream::Strategy kStrategies[] = {
+        SkDeflateWStream::kDefault_Strategy,
+        SkDeflateWStream::kFiltered_Strategy,
+        SkDeflateWStream::kHuffmanOnly_Strategy,
+        SkDeflateWStream::kRLE_Strategy,
+    };
+    for (int level = SkDeflateWStream::kDefaultCompressionLevel; level <= 9; ++level) {
+        for (size_t s = 0; s < SK_ARRAY_COUNT(kStrategies); ++s) {
+            SkDynamicMemoryWStream compressedWStream;
+            SkDeflateWStream deflateWStream(&compressedWStream, level, kStrategies[s]);
+            size_t j = 0;
+            while (j < kSize) {
+                size_t writeSize = SkTMin(kSize - j, (size_t)(random.nextBool()
+                        ? random.nextRangeU(1, 100) : random.nextRangeU(4096, 20000)));
+                REPORTER_ASSERT(r, deflateWStream.write(&buffer[j], writeSize));
+                j += writeSize;
+            }
+            REPORTER_ASSERT(r, deflateWStream.bytesWritten() == kSize);
+            REPORTER_ASSERT(r, deflateWStream.finalize());
+            REPORTER_ASSERT(r, !deflateWStream.write(&buffer[0], 1));
+
+            SkAutoTDelete<SkStreamAsset> compressed(compressedWStream.detachAsStream());
+            SkDynamicMemoryWStream decompressedWStream;
+            REPORTER_ASSERT(r, SkFlate::Inflate(compressed, &decompressedWStream));
+            SkAutoTUnref<SkData> decompressed(decompressedWStream.copyToData());
+            if (decompressed->size() != kSize ||
+                memcmp(decompressed->data(), buffer.get(), kSize)) {
+                ERRORF(r, "Level %d, strategy %d did not round trip.", level, (int)s);
+            }
+        }
+    }
+}
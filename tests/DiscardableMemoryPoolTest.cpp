@@ -33,3 +33,46 @@ DEF_TEST(DiscardableMemoryPool, reporter) {
     REPORTER_ASSERT(reporter, !dm2->lock());
     REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
 }
+
+DEF_TEST(DiscardableMemoryPool_Generations, reporter) {
+    SkAutoTUnref<SkDiscardableMemoryPool> pool(
+        SkDiscardableMemoryPool::Create(300, NULL));
+
+    // Locked again once, so old enough to outlive a younger block.
+    SkAutoTDelete<SkDiscardableMemory> reused(pool->create(100));
+    reused->unlock();
+    REPORTER_ASSERT(reporter, reused->lock());
+    reused->unlock();
+
+    SkAutoTDelete<SkDiscardableMemory> once(pool->create(100));
+    once->unlock();
+
+    // Going over budget purges the younger block, though it was used more recently.
+    SkAutoTDelete<SkDiscardableMemory> fresh(pool->create(150));
+    REPORTER_ASSERT(reporter, 250 == pool->getRAMUsed());
+    REPORTER_ASSERT(reporter, !once->lock());
+    REPORTER_ASSERT(reporter, reused->lock());
+    reused->unlock();
+
+    fresh->unlock();
+    pool->dumpYoungGeneration();
+    REPORTER_ASSERT(reporter, 100 == pool->getRAMUsed());
+    REPORTER_ASSERT(reporter, !fresh->lock());
+    REPORTER_ASSERT(reporter, reused->lock());
+    reused->unlock();
+}
+
+DEF_TEST(DiscardableMemoryPool_AsyncPurge, reporter) {
+    SkMutex mutex;
+    SkAutoTUnref<SkDiscardableMemoryPool> pool(
+        SkDiscardableMemoryPool::Create(150, &mutex, true));
+    for (int i = 0; i < 10; ++i) {
+        SkAutoTDelete<SkDiscardableMemory> dm(pool->create(100));
+        REPORTER_ASSERT(reporter, dm->data() != NULL);
+        dm->unlock();
+        // Purged blocks stop counting right away, whenever their memory is freed.
+        REPORTER_ASSERT(reporter, pool->getRAMUsed() <= 100);
+    }
+    pool->dumpPool();
+    REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkDistanceFieldGen.h"
+#include "SkPath.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// What the shader reads back: the median of the three channels.
+static int median(SkPMColor c) {
+    const int r = SkGetPackedR32(c);
+    const int g = SkGetPackedG32(c);
+    const int b = SkGetPackedB32(c);
+    return SkTMax(SkTMin(r, g), SkTMin(SkTMax(r, g), b));
+}
+
+DEF_TEST(DistanceField_MultiChannel, reporter) {
+    static const int kSize = 16;
+    const int dfSize = kSize + 2 * SK_DistanceFieldPad;
+
+    SkPath path;
+    path.addRect(SkRect::MakeWH(SkIntToScalar(kSize), SkIntToScalar(kSize)));
+    SkAutoTMalloc<SkPMColor> field(dfSize * dfSize);
+    REPORTER_ASSERT(reporter, SkGenerateMultiChannelDistanceFieldFromPath(field.get(), path,
+                                                                          kSize, kSize));
+
+    // Texels inside the outline are above the threshold, texels outside are below it.
+    for (int y = 0; y < dfSize; ++y) {
+        for (int x = 0; x < dfSize; ++x) {
+            const SkScalar px = SkIntToScalar(x - SK_DistanceFieldPad) + SK_ScalarHalf;
+            const SkScalar py = SkIntToScalar(y - SK_DistanceFieldPad) + SK_ScalarHalf;
+            const int value = median(field[y * dfSize + x]);
+            REPORTER_ASSERT(reporter, (value > 128) == path.contains(px, py));
+        }
+    }
+
+    // Just past a corner, diagonally, the median is the distance to the nearer side (0.5) rather
+    // than to the corner point (0.707), so the corner stays square when scaled up.
+    const int corner = SK_DistanceFieldPad + kSize;
+    const int value = median(field[corner * dfSize + corner]);
+    // A distance of half a texel outside, in the 128-at-the-edge encoding.
+    const int expected = 128 - 64 / SK_DistanceFieldMagnitude;
+    REPORTER_ASSERT(reporter, SkTAbs(value - expected) <= 1);
+}
+
+// A disc of the given radius and center in a size x size A8 image.
+static void draw_disc(uint8_t* image, int size, float centerX, float radius) {
+    const float centerY = 0.5f * size;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const float dx = x + 0.5f - centerX;
+            const float dy = y + 0.5f - centerY;
+            const float coverage = SkScalarPin(radius + 0.5f - sqrtf(dx * dx + dy * dy), 0, 1);
+            image[y * size + x] = SkToU8((int)(coverage * 255));
+        }
+    }
+}
+
+DEF_TEST(DistanceField_A8, reporter) {
+    static const int kMaxSize = 20;
+    const int kMaxDFSize = kMaxSize + 2 * SK_DistanceFieldPad;
+
+    // Odd sizes too, so the rows don't divide into whole vectors.
+    for (int size = kMaxSize - 3; size <= kMaxSize; ++size) {
+        const int dfSize = size + 2 * SK_DistanceFieldPad;
+        const float radius = 0.3f * size;
+
+        // The same disc, once off to the left and once off to the right.
+        uint8_t left[kMaxSize * kMaxSize], right[kMaxSize * kMaxSize];
+        draw_disc(left, size, 0.5f * size - 2.5f, radius);
+        draw_disc(right, size, 0.5f * size + 2.5f, radius);
+        uint8_t leftField[kMaxDFSize * kMaxDFSize], rightField[kMaxDFSize * kMaxDFSize];
+        REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8Image(leftField, left,
+                                                                     size, size, size));
+        REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8Image(rightField, right,
+                                                                     size, size, size));
+
+        // Covered texels are above the threshold, and uncovered ones below it.
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const int value = leftField[(y + SK_DistanceFieldPad) * dfSize +
+                                            x + SK_DistanceFieldPad];
+                const int alpha = left[y * size + x];
+                REPORTER_ASSERT(reporter, alpha <= 192 || value > 128);
+                REPORTER_ASSERT(reporter, alpha >= 64 || value < 128);
+            }
+        }
+
+        // The fields mirror each other, padding included.
+        for (int y = 0; y < dfSize; ++y) {
+            for (int x = 0; x < dfSize; ++x) {
+                const int mirrorX = dfSize - 1 - x;
+                REPORTER_ASSERT(reporter, SkTAbs(leftField[y * dfSize + x] -
+                                                 rightField[y * dfSize + mirrorX]) <= 4);
+            }
+        }
+    }
+}
+
+DEF_TEST(DistanceField_Batch, reporter) {
+    static const int kCount = 8;
+    static const int kSize = 24;
+    const int dfSize = kSize + 2 * SK_DistanceFieldPad;
+
+    uint8_t images[kCount][kSize * kSize];
+    SkAutoTMalloc<uint8_t> fields(kCount * dfSize * dfSize);
+    SkDistanceFieldRequest requests[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        draw_disc(images[i], kSize, 0.5f * kSize, 2.0f + i);
+        requests[i].fDistanceField = fields.get() + i * dfSize * dfSize;
+        requests[i].fImage = images[i];
+        requests[i].fWidth = kSize;
+        requests[i].fHeight = kSize;
+        requests[i].fRowBytes = kSize;
+        requests[i].fIsBW = false;
+    }
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFields(requests, kCount));
+
+    // The same as generating them one at a time.
+    for (int i = 0; i < kCount; ++i) {
+        uint8_t field[dfSize * dfSize];
+        SkGenerateDistanceFieldFromA8Image(field, images[i], kSize, kSize, kSize);
+        REPORTER_ASSERT(reporter, 0 == memcmp(field, requests[i].fDistanceField, sizeof(field)));
+    }
+}
@@ -1,6 +1,7 @@
 #include "Test.h"
 
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDocument.h"
 #include "SkOSFile.h"
 #include "SkStream.h"
@@ -19,9 +20,9 @@ static void test_abort(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
     SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
 
+    // Pages are written as they end, so abort before the first one does.
     SkCanvas* canvas = doc->beginPage(100, 100);
     canvas->drawColor(SK_ColorRED);
-    doc->endPage();
 
     doc->abort();
 
@@ -45,7 +46,6 @@ static void test_abortWithFile(skiatest::Reporter* reporter) {
 
         SkCanvas* canvas = doc->beginPage(100, 100);
         canvas->drawColor(SK_ColorRED);
-        doc->endPage();
 
         doc->abort();
     }
@@ -83,6 +83,27 @@ static void test_file(skiatest::Reporter* reporter) {
     fclose(file);
 }
 
+static void test_streaming(skiatest::Reporter* reporter) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
+
+    SkPaint paint;
+    size_t written = 0;
+    // Enough pages for more than one level of page tree.
+    for (int i = 0; i < 20; i++) {
+        SkCanvas* canvas = doc->beginPage(100, 100);
+        canvas->drawColor(SK_ColorRED);
+        canvas->drawText("page", 4, 10, 50, paint);
+        doc->endPage();
+
+        // Each page is written out when it ends.
+        REPORTER_ASSERT(reporter, stream.bytesWritten() > written);
+        written = stream.bytesWritten();
+    }
+    REPORTER_ASSERT(reporter, doc->close());
+    REPORTER_ASSERT(reporter, stream.bytesWritten() > written);
+}
+
 static void test_close(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
     SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
@@ -96,10 +117,64 @@ static void test_close(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, stream.bytesWritten() != 0);
 }
 
+static int count_pages(const SkDynamicMemoryWStream& stream) {
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    static const char kPage[] = "/Type /Page\n";
+    const size_t length = strlen(kPage);
+    int count = 0;
+    for (size_t i = 0; i + length <= pdf->size(); i++) {
+        if (0 == memcmp(pdf->bytes() + i, kPage, length)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void draw_page(SkCanvas* canvas, int i) {
+    SkPaint paint;
+    canvas->drawColor(SK_ColorRED);
+    SkString text;
+    text.printf("page %d", i);
+    canvas->drawText(text.c_str(), text.size(), 10, 50, paint);
+    paint.setColor(SK_ColorBLUE);
+    paint.setAlpha(0x80);
+    canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(i), 0, 20, 20), paint);
+}
+
+static void test_concurrent(skiatest::Reporter* reporter) {
+    static const int kPages = 40;  // More than one batch.
+    SkDynamicMemoryWStream serialStream, concurrentStream;
+    SkAutoTUnref<SkDocument> serial(SkDocument::CreatePDF(&serialStream));
+    SkAutoTUnref<SkDocument> concurrent(SkDocument::CreateConcurrentPDF(&concurrentStream));
+    for (int i = 0; i < kPages; i++) {
+        draw_page(serial->beginPage(100, 100), i);
+        serial->endPage();
+        draw_page(concurrent->beginPage(100, 100), i);
+        concurrent->endPage();
+    }
+    REPORTER_ASSERT(reporter, serial->close());
+    REPORTER_ASSERT(reporter, concurrent->close());
+
+    REPORTER_ASSERT(reporter, kPages == count_pages(concurrentStream));
+    // The canon still shares the font and graphic states between the pages.
+    REPORTER_ASSERT(reporter, concurrentStream.bytesWritten() <=
+                              serialStream.bytesWritten() + serialStream.bytesWritten() / 10);
+
+    // Aborting with recorded pages not yet drawn.
+    SkDynamicMemoryWStream abortStream;
+    SkAutoTUnref<SkDocument> aborted(SkDocument::CreateConcurrentPDF(&abortStream));
+    draw_page(aborted->beginPage(100, 100), 0);
+    aborted->endPage();
+    draw_page(aborted->beginPage(100, 100), 1);
+    aborted->abort();
+}
+
 DEF_TEST(document_tests, reporter) {
     test_empty(reporter);
     test_abort(reporter);
     test_abortWithFile(reporter);
     test_file(reporter);
     test_close(reporter);
+    test_streaming(reporter);
+    test_concurrent(reporter);
 }
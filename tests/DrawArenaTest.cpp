@@ -0,0 +1,85 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkDrawArena.h"
+#include "SkGradientShader.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+DEF_TEST(DrawArena_Scopes, reporter) {
+    REPORTER_ASSERT(reporter, NULL == SkDrawArena::Current());
+
+    SkAutoMalloc storage;
+    int before = SkDrawArena::HeapAllocCount();
+    void* outside = SkDrawArena::Alloc(100, &storage);
+    REPORTER_ASSERT(reporter, outside == storage.get());
+    REPORTER_ASSERT(reporter, SkDrawArena::HeapAllocCount() == before + 1);
+
+    void* first;
+    {
+        SkDrawArena::AutoScope scope;
+        SkDrawArena* arena = SkDrawArena::Current();
+        REPORTER_ASSERT(reporter, arena);
+
+        first = SkDrawArena::Alloc(100, &storage);
+        REPORTER_ASSERT(reporter, first != storage.get());
+        REPORTER_ASSERT(reporter, 0 == ((uintptr_t)first & 7));
+
+        void* inner;
+        {
+            SkDrawArena::AutoScope nested;
+            REPORTER_ASSERT(reporter, arena == SkDrawArena::Current());
+            inner = arena->alloc(3);
+            REPORTER_ASSERT(reporter, inner != first);
+        }
+        // The nested scope's memory has been released, and is handed out again.
+        REPORTER_ASSERT(reporter, inner == arena->alloc(3));
+
+        // Spill well past the first block.
+        for (int i = 0; i < 100; ++i) {
+            memset(arena->alloc(1000), 0, 1000);
+        }
+    }
+    REPORTER_ASSERT(reporter, NULL == SkDrawArena::Current());
+
+    // The blocks were merged, so the same allocations are served without touching the heap.
+    before = SkDrawArena::HeapAllocCount();
+    {
+        SkDrawArena::AutoScope scope;
+        SkDrawArena::Alloc(100, &storage);
+        SkDrawArena::Alloc(3, &storage);
+        SkDrawArena::Alloc(3, &storage);
+        for (int i = 0; i < 100; ++i) {
+            SkDrawArena::Current()->alloc(1000);
+        }
+    }
+    REPORTER_ASSERT(reporter, SkDrawArena::HeapAllocCount() == before);
+}
+
+DEF_TEST(DrawArena_RepeatedDraw, reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(200, 200));
+    SkCanvas* canvas = surface->getCanvas();
+
+    const SkPoint pts[] = { { 0, 0 }, { 200, 200 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                   SkShader::kClamp_TileMode))->unref();
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(190, 10, 10, 190, 190, 190);
+    path.lineTo(100, 20);
+    path.close();
+
+    canvas->drawPath(path, paint);
+    const int before = SkDrawArena::HeapAllocCount();
+    canvas->drawPath(path, paint);
+    REPORTER_ASSERT(reporter, SkDrawArena::HeapAllocCount() == before);
+}
@@ -7,6 +7,8 @@
 
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkDiscardableMemoryPool.h"
 #include "SkImageGeneratorPriv.h"
@@ -14,6 +16,7 @@
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
+#include "SkXfermode.h"
 #include "SkSurface.h"
 #include "Test.h"
 
@@ -316,3 +319,77 @@ DEF_TEST(DrawBitmapRect, reporter) {
     test_treatAsSprite(reporter);
     test_faulty_pixelref(reporter);
 }
+
+static void draw_sprite(const SkBitmap& src, const SkPaint& paint, SkBitmap* dst) {
+    dst->allocN32Pixels(src.width() + 7, src.height() + 3);
+    dst->eraseColor(0x80402010);
+    SkCanvas canvas(*dst);
+    canvas.drawSprite(src, 5, 1, &paint);
+}
+
+static bool nearly_equal(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const SkPMColor ca = *a.getAddr32(x, y), cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkAbs32(((ca >> shift) & 0xFF) - ((cb >> shift) & 0xFF)) > tolerance) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// kIndex_8 and kRGB_565 sprites draw to N32 like their N32 copies do.
+DEF_TEST(DrawSprite_Index8And565, reporter) {
+    SkPMColor colors[256];
+    for (int i = 0; i < 256; ++i) {
+        colors[i] = SkPreMultiplyARGB(i, 255 - i, (i * 3) & 0xFF, (i * 7) & 0xFF);
+    }
+    SkAutoTUnref<SkColorTable> ctable(SkNEW_ARGS(SkColorTable, (colors, 256)));
+    SkBitmap index8;
+    index8.allocPixels(SkImageInfo::Make(37, 19, kIndex_8_SkColorType, kPremul_SkAlphaType),
+                       NULL, ctable);
+    SkBitmap rgb565;
+    rgb565.allocPixels(SkImageInfo::Make(37, 19, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    for (int y = 0; y < index8.height(); ++y) {
+        for (int x = 0; x < index8.width(); ++x) {
+            *index8.getAddr8(x, y) = x * 7 + y * 13;
+            *rgb565.getAddr16(x, y) = (x * 2731 + y * 397) & 0xFFFF;
+        }
+    }
+
+    SkAutoTUnref<SkColorFilter> filter(SkColorFilter::CreateModeFilter(0x80FF0000,
+                                                                       SkXfermode::kSrcOver_Mode));
+    const SkBitmap* sources[] = { &index8, &rgb565 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sources); ++i) {
+        SkBitmap n32;
+        REPORTER_ASSERT(reporter, sources[i]->copyTo(&n32, kN32_SkColorType));
+
+        for (int alpha = 0x80; alpha <= 0xFF; alpha += 0x7F) {
+            for (int filtered = 0; filtered < 2; ++filtered) {
+                SkPaint paint;
+                paint.setAlpha(alpha);
+                if (filtered) {
+                    paint.setColorFilter(filter);
+                }
+                SkBitmap expected, actual;
+                draw_sprite(n32, paint, &expected);
+                draw_sprite(*sources[i], paint, &actual);
+                // N32 sprites with both alpha and a color filter take the shader path, which
+                // rounds a little differently.
+                REPORTER_ASSERT(reporter, nearly_equal(expected, actual,
+                                                       filtered && alpha < 0xFF ? 1 : 0));
+            }
+        }
+
+        SkPaint xferPaint;
+        xferPaint.setXfermodeMode(SkXfermode::kMultiply_Mode);
+        SkBitmap expected, actual;
+        draw_sprite(n32, xferPaint, &expected);
+        draw_sprite(*sources[i], xferPaint, &actual);
+        REPORTER_ASSERT(reporter, nearly_equal(expected, actual, 0));
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGradientShader.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static const int kW = 200;
+static const int kH = 150;
+
+static void make_rects(SkTDArray<SkRect>* rects) {
+    SkRandom rand;
+    for (int i = 0; i < 300; ++i) {
+        SkScalar x = rand.nextRangeF(-20, kW + 20),
+                 y = rand.nextRangeF(-20, kH + 20);
+        *rects->append() = SkRect::MakeXYWH(x, y, rand.nextRangeF(0, 12), rand.nextRangeF(0, 9));
+    }
+    // Unsorted and empty rects must draw just as drawRect() would draw them.
+    *rects->append() = SkRect::MakeLTRB(50, 40, 30, 20);
+    *rects->append() = SkRect::MakeLTRB(60, 60, 60, 90);
+}
+
+static void setup_canvas(SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+    canvas->clipRect(SkRect::MakeLTRB(5, 7, kW - 11, kH - 3));
+    canvas->translate(3.5f, -2.25f);
+    canvas->scale(1.25f, 0.75f);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+DEF_TEST(DrawRects, reporter) {
+    SkTDArray<SkRect> rects;
+    make_rects(&rects);
+
+    SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kW), SkIntToScalar(kH) } };
+    SkColor colors[] = { SK_ColorBLUE, SK_ColorGREEN };
+    SkAutoTUnref<SkShader> shader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                                 SkShader::kClamp_TileMode));
+
+    for (int i = 0; i < 12; ++i) {
+        SkPaint paint;
+        paint.setColor(0x80FF0000);
+        paint.setAntiAlias(SkToBool(i & 1));
+        switch (i >> 1) {
+            case 0: break;
+            case 1: paint.setStyle(SkPaint::kStroke_Style); break;                  // hairline
+            case 2: paint.setStyle(SkPaint::kStroke_Style); paint.setStrokeWidth(3); break;
+            case 3: paint.setStyle(SkPaint::kStroke_Style); paint.setStrokeWidth(2);
+                    paint.setStrokeJoin(SkPaint::kRound_Join); break;               // as paths
+            case 4: paint.setShader(shader); break;
+            case 5: paint.setStyle(SkPaint::kStrokeAndFill_Style); paint.setStrokeWidth(1); break;
+        }
+
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(kW, kH);
+        actual.allocN32Pixels(kW, kH);
+
+        SkCanvas expectedCanvas(expected);
+        setup_canvas(&expectedCanvas);
+        for (int j = 0; j < rects.count(); ++j) {
+            expectedCanvas.drawRect(rects[j], paint);
+        }
+
+        SkCanvas actualCanvas(actual);
+        setup_canvas(&actualCanvas);
+        actualCanvas.drawRects(rects.begin(), rects.count(), paint);
+        REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+
+        // Recorded batches play back the same way.
+        SkPictureRecorder recorder;
+        recorder.beginRecording(SkIntToScalar(kW), SkIntToScalar(kH))
+                ->drawRects(rects.begin(), rects.count(), paint);
+        SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+        actual.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas playbackCanvas(actual);
+        setup_canvas(&playbackCanvas);
+        picture->playback(&playbackCanvas);
+        REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+    }
+}
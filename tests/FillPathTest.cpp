@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "Test.h"
@@ -43,3 +46,205 @@ DEF_TEST(FillPathInverse, reporter) {
 
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+static void fill_a8(const SkPath& path, bool analytic, SkBitmap* bm) {
+    bm->allocPixels(SkImageInfo::MakeA8(64, 64));
+    bm->eraseColor(SK_ColorTRANSPARENT);
+
+    const bool oldAnalytic = gSkUseAnalyticAA;
+    gSkUseAnalyticAA = analytic;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkCanvas(*bm).drawPath(path, paint);
+    gSkUseAnalyticAA = oldAnalytic;
+}
+
+DEF_TEST(FillPathAnalyticAA, reporter) {
+    SkBitmap bm, ref;
+
+    // Axis-aligned edges get exactly their covered area.
+    SkPath rect;
+    rect.addRect(SkRect::MakeLTRB(10.25f, 10.5f, 20.75f, 20));
+    fill_a8(rect, true, &bm);
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(15, 15));
+    REPORTER_ASSERT(reporter, 191 == *bm.getAddr8(10, 15));     // 3/4 of a column
+    REPORTER_ASSERT(reporter, 191 == *bm.getAddr8(20, 15));
+    REPORTER_ASSERT(reporter, 128 == *bm.getAddr8(15, 10));     // 1/2 of a row
+    REPORTER_ASSERT(reporter,  96 == *bm.getAddr8(10, 10));     // 3/8 of a pixel
+    REPORTER_ASSERT(reporter,   0 == *bm.getAddr8(15, 20));
+    REPORTER_ASSERT(reporter,   0 == *bm.getAddr8( 9, 15));
+
+    // Curves agree closely with the supersampler, and the area covered matches.
+    SkPath circle;
+    circle.addCircle(31.3f, 30.6f, 25.5f);
+    circle.addCircle(31.3f, 30.6f, 12.2f);
+    for (int evenOdd = 0; evenOdd < 2; ++evenOdd) {
+        circle.setFillType(evenOdd ? SkPath::kEvenOdd_FillType : SkPath::kWinding_FillType);
+        fill_a8(circle, true, &bm);
+        fill_a8(circle, false, &ref);
+
+        int maxDiff = 0;
+        int64_t sum = 0, refSum = 0;
+        for (int y = 0; y < bm.height(); ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                int a = *bm.getAddr8(x, y), b = *ref.getAddr8(x, y);
+                maxDiff = SkTMax(maxDiff, SkAbs32(a - b));
+                sum += a;
+                refSum += b;
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 64);
+        REPORTER_ASSERT(reporter, SkTAbs(sum - refSum) <= refSum / 200);
+        REPORTER_ASSERT(reporter, (evenOdd ? 0 : 255) == *bm.getAddr8(31, 30));
+    }
+}
+
+// Paths made of many lines are walked with a table of line edges, while any curve sends
+// the path through the general edge walker. Both should produce the same pixels.
+DEF_TEST(FillPathManyLines, reporter) {
+    SkRandom rand;
+    SkPath lines;
+    lines.moveTo(rand.nextRangeF(8, 64), rand.nextRangeF(8, 64));
+    for (int i = 0; i < 40; ++i) {
+        lines.lineTo(rand.nextRangeF(8, 64), rand.nextRangeF(8, 64));
+    }
+    lines.close();
+
+    // A tiny curved contour tucked away in the corner, where the polygon never reaches.
+    SkPath curved(lines);
+    curved.moveTo(1, 1);
+    curved.quadTo(4, 1, 4, 4);
+    curved.close();
+
+    const SkPath::FillType fillTypes[] = {
+        SkPath::kWinding_FillType,
+        SkPath::kEvenOdd_FillType,
+        SkPath::kInverseWinding_FillType,
+        SkPath::kInverseEvenOdd_FillType,
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(fillTypes); ++i) {
+        for (int aa = 0; aa < 2; ++aa) {
+            lines.setFillType(fillTypes[i]);
+            curved.setFillType(fillTypes[i]);
+
+            SkBitmap bm, ref;
+            bm.allocPixels(SkImageInfo::MakeA8(72, 72));
+            ref.allocPixels(SkImageInfo::MakeA8(72, 72));
+            bm.eraseColor(SK_ColorTRANSPARENT);
+            ref.eraseColor(SK_ColorTRANSPARENT);
+
+            SkPaint paint;
+            paint.setAntiAlias(SkToBool(aa));
+            SkCanvas(bm).drawPath(lines, paint);
+            SkCanvas(ref).drawPath(curved, paint);
+
+            int diffs = 0;
+            for (int y = 0; y < bm.height(); ++y) {
+                for (int x = 0; x < bm.width(); ++x) {
+                    if (x < 6 && y < 6) {
+                        continue;
+                    }
+                    diffs += *bm.getAddr8(x, y) != *ref.getAddr8(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == diffs);
+        }
+    }
+}
+
+// The analytic filler only visits the parts of each row that edges cross; wide rows with
+// far-apart or long flat geometry must still resolve to the right coverage everywhere.
+DEF_TEST(FillPathAnalyticAASparse, reporter) {
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(3.5f, 4, 1000.25f, 12));
+    path.moveTo(2000, 20);                                  // a long, thin sliver
+    path.lineTo(4000, 28);
+    path.lineTo(4000, 29);
+    path.close();
+    path.addCircle(100, 24, 5);                             // shares rows with the sliver
+
+    SkBitmap bm, ref;
+    for (int analytic = 0; analytic < 2; ++analytic) {
+        SkBitmap* dst = analytic ? &bm : &ref;
+        dst->allocPixels(SkImageInfo::MakeA8(4096, 32));
+        dst->eraseColor(SK_ColorTRANSPARENT);
+
+        const bool oldAnalytic = gSkUseAnalyticAA;
+        gSkUseAnalyticAA = SkToBool(analytic);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkCanvas(*dst).drawPath(path, paint);
+        gSkUseAnalyticAA = oldAnalytic;
+    }
+
+    REPORTER_ASSERT(reporter, 128 == *bm.getAddr8(3, 8));
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(4, 8));
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(500, 8));
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(999, 8));
+    REPORTER_ASSERT(reporter,  64 == *bm.getAddr8(1000, 8));
+    REPORTER_ASSERT(reporter,   0 == *bm.getAddr8(1001, 8));
+    REPORTER_ASSERT(reporter, 255 == *bm.getAddr8(100, 24));
+    REPORTER_ASSERT(reporter,   0 == *bm.getAddr8(1000, 24));
+
+    int maxDiff = 0;
+    int64_t sum = 0, refSum = 0;
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            int a = *bm.getAddr8(x, y), b = *ref.getAddr8(x, y);
+            maxDiff = SkTMax(maxDiff, SkAbs32(a - b));
+            sum += a;
+            refSum += b;
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 64);
+    REPORTER_ASSERT(reporter, SkTAbs(sum - refSum) <= refSum / 200);
+}
+
+// Convex paths are filled by a walker that only tracks a left and a right edge. It should
+// produce the same pixels as the general edge walker, which a concave path goes through.
+DEF_TEST(FillPathConvex, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 20; ++i) {
+        // A convex polygon around a random center, often running off the bitmap to be clipped.
+        SkPoint center = SkPoint::Make(rand.nextRangeF(0, 72), rand.nextRangeF(0, 72));
+        SkScalar radius = rand.nextRangeF(4, 40);
+        int sides = 3 + rand.nextULessThan(12);
+        SkPath convex;
+        SkScalar start = rand.nextRangeF(0, SK_ScalarPI);
+        for (int side = 0; side < sides; ++side) {
+            SkScalar angle = start + side * 2 * SK_ScalarPI / sides;
+            SkPoint pt = SkPoint::Make(center.fX + radius * SkScalarCos(angle),
+                                       center.fY + radius * SkScalarSin(angle));
+            side ? convex.lineTo(pt) : convex.moveTo(pt);
+        }
+        convex.close();
+        if (i & 1) {
+            // Curves are chopped into many edges, which must still pair up.
+            convex.rewind();
+            convex.addOval(SkRect::MakeXYWH(center.fX, center.fY, radius, radius * 0.7f));
+        }
+        REPORTER_ASSERT(reporter, convex.isConvex());
+
+        SkPath concave(convex);
+        concave.setConvexity(SkPath::kConcave_Convexity);
+
+        for (int aa = 0; aa < 2; ++aa) {
+            SkBitmap bm, ref;
+            bm.allocPixels(SkImageInfo::MakeA8(72, 72));
+            ref.allocPixels(SkImageInfo::MakeA8(72, 72));
+            bm.eraseColor(SK_ColorTRANSPARENT);
+            ref.eraseColor(SK_ColorTRANSPARENT);
+
+            SkPaint paint;
+            paint.setAntiAlias(SkToBool(aa));
+            SkCanvas(bm).drawPath(convex, paint);
+            SkCanvas(ref).drawPath(concave, paint);
+
+            int diffs = 0;
+            for (int y = 0; y < bm.height(); ++y) {
+                diffs += memcmp(bm.getAddr8(0, y), ref.getAddr8(0, y), bm.width()) != 0;
+            }
+            REPORTER_ASSERT(reporter, 0 == diffs);
+        }
+    }
+}
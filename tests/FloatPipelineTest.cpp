@@ -0,0 +1,96 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkCoreBlitters.h"
+#include "SkGradientShader.h"
+#include "SkXfermode.h"
+#include "Test.h"
+
+static const int kW = 64;
+static const int kH = 48;
+
+// A translucent, premultiplied background so that every mode has some dst to work with.
+static void make_background(SkBitmap* bm) {
+    bm->allocN32Pixels(kW, kH);
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            *bm->getAddr32(x, y) = SkPreMultiplyARGB(0x40 + 3 * y, 4 * x, 0x80, 5 * y);
+        }
+    }
+}
+
+static void draw(SkBitmap* bm, const SkPaint& paint) {
+    make_background(bm);
+    SkCanvas canvas(*bm);
+    canvas.drawCircle(30.5f, 20.25f, 17.3f, paint);
+    canvas.drawRect(SkRect::MakeXYWH(40, 2, 20, 40), paint);
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int maxDiff = 0;
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            SkPMColor ca = *a.getAddr32(x, y),
+                      cb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                int diff = (int)((ca >> shift) & 0xFF) - (int)((cb >> shift) & 0xFF);
+                maxDiff = SkTMax(maxDiff, SkAbs32(diff));
+            }
+        }
+    }
+    return maxDiff;
+}
+
+static void test_paint(skiatest::Reporter* reporter, const SkPaint& paint, int tolerance) {
+    SkPaint floatPaint(paint);
+    floatPaint.setFloatPipeline(true);
+
+    SkBitmap expected, actual;
+    draw(&expected, paint);
+    draw(&actual, floatPaint);
+    REPORTER_ASSERT(reporter, max_diff(expected, actual) <= tolerance);
+}
+
+// The float pipeline should draw what the 8888 blitters draw, give or take rounding.
+DEF_TEST(FloatPipeline_MatchesLegacy, reporter) {
+    const SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kW), SkIntToScalar(kH) } };
+    const SkColor colors[] = { 0xFF2080F0, 0x80F04010 };
+    SkAutoTUnref<SkShader> gradient(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                                   SkShader::kClamp_TileMode));
+    SkAutoTUnref<SkColorFilter> filter(SkColorFilter::CreateModeFilter(0x80808080,
+                                                                       SkXfermode::kPlus_Mode));
+
+    for (int m = 0; m <= SkXfermode::kLastSeparableMode; ++m) {
+        SkXfermode::Mode mode = (SkXfermode::Mode)m;
+        for (int aa = 0; aa < 2; ++aa) {
+            SkPaint paint;
+            paint.setAntiAlias(SkToBool(aa));
+            paint.setXfermodeMode(mode);
+
+            paint.setColor(0xC0306090);
+            test_paint(reporter, paint, 3);
+
+            paint.setShader(gradient);
+            test_paint(reporter, paint, 3);
+
+            paint.setColorFilter(filter);
+            test_paint(reporter, paint, 3);
+        }
+    }
+}
+
+// Modes without a float stage fall back to the 8888 blitters, so they should match exactly.
+DEF_TEST(FloatPipeline_Unsupported, reporter) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(0xC0306090);
+    paint.setXfermodeMode(SkXfermode::kOverlay_Mode);
+    REPORTER_ASSERT(reporter, !SkARGB32_Float_Blitter::Supports(paint));
+    test_paint(reporter, paint, 0);
+}
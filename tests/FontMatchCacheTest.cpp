@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFontMatchCache.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+DEF_TEST(FontMatchCache_Style, reporter) {
+    SkFontMatchCache cache;
+    SkAutoTUnref<SkTypeface> face(SkTypeface::RefDefault());
+    const SkFontStyle bold(SkFontStyle::kBold_Weight, SkFontStyle::kNormal_Width,
+                           SkFontStyle::kUpright_Slant);
+
+    SkTypeface* found = NULL;
+    REPORTER_ASSERT(reporter, !cache.findStyle("serif", SkFontStyle(), &found));
+    cache.addStyle("serif", SkFontStyle(), face);
+    REPORTER_ASSERT(reporter, cache.findStyle("serif", SkFontStyle(), &found));
+    REPORTER_ASSERT(reporter, found == face.get());
+    SkSafeUnref(found);
+
+    // Other families and styles are other entries, and a failed match is remembered.
+    REPORTER_ASSERT(reporter, !cache.findStyle("serif", bold, &found));
+    REPORTER_ASSERT(reporter, !cache.findStyle("sans-serif", SkFontStyle(), &found));
+    REPORTER_ASSERT(reporter, !cache.findStyle(NULL, SkFontStyle(), &found));
+    cache.addStyle(NULL, SkFontStyle(), NULL);
+    found = face.get();
+    REPORTER_ASSERT(reporter, cache.findStyle(NULL, SkFontStyle(), &found));
+    REPORTER_ASSERT(reporter, NULL == found);
+    REPORTER_ASSERT(reporter, !cache.findStyle("", SkFontStyle(), &found));
+
+    SkFontMatchCache::Stats stats;
+    cache.getStats(&stats);
+    REPORTER_ASSERT(reporter, 2 == stats.fHits);
+    REPORTER_ASSERT(reporter, 5 == stats.fMisses);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, !cache.findStyle("serif", SkFontStyle(), &found));
+}
+
+DEF_TEST(FontMatchCache_Character, reporter) {
+    SkFontMatchCache cache;
+    SkAutoTUnref<SkTypeface> face(SkTypeface::RefDefault());
+    uint16_t glyphs[2];
+    const SkUnichar latin[] = { 'A', 'B' };
+    if (2 != face->charsToGlyphs(latin, SkTypeface::kUTF32_Encoding, glyphs, 2) ||
+        0 == glyphs[0] || 0 == glyphs[1]) {
+        return;
+    }
+
+    const char* en[] = { "en" };
+    const char* ja[] = { "ja" };
+    SkTypeface* found = NULL;
+    REPORTER_ASSERT(reporter, !cache.findCharacter("serif", SkFontStyle(), en, 1, 'A', &found));
+    cache.addCharacter("serif", SkFontStyle(), en, 1, 'A', face);
+
+    // The typeface found for 'A' also serves 'B', which is in the same range.
+    REPORTER_ASSERT(reporter, cache.findCharacter("serif", SkFontStyle(), en, 1, 'B', &found));
+    REPORTER_ASSERT(reporter, found == face.get());
+    SkSafeUnref(found);
+
+    // Other languages and ranges are other entries.
+    REPORTER_ASSERT(reporter, !cache.findCharacter("serif", SkFontStyle(), ja, 1, 'B', &found));
+    REPORTER_ASSERT(reporter, !cache.findCharacter("serif", SkFontStyle(), NULL, 0, 'B', &found));
+    const SkUnichar far = 'A' + SkFontMatchCache::kRangeSize;
+    REPORTER_ASSERT(reporter, !cache.findCharacter("serif", SkFontStyle(), en, 1, far, &found));
+
+    // A character nothing has a glyph for is remembered on its own, not for its whole range.
+    const SkUnichar kPrivateUse = 0xF8FF;
+    cache.addCharacter("serif", SkFontStyle(), en, 1, kPrivateUse, NULL);
+    found = face.get();
+    REPORTER_ASSERT(reporter,
+                    cache.findCharacter("serif", SkFontStyle(), en, 1, kPrivateUse, &found));
+    REPORTER_ASSERT(reporter, NULL == found);
+    REPORTER_ASSERT(reporter,
+                    !cache.findCharacter("serif", SkFontStyle(), en, 1, kPrivateUse - 1, &found));
+}
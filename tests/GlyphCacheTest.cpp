@@ -0,0 +1,233 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkThreadUtils.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+static const int kGlyphCount = 128;
+
+// Looks up every glyph in a strike shared with other threads, counting the ones whose advance
+// doesn't match what a single thread found.
+struct Worker {
+    const SkPaint* fPaint;
+    const SkFixed* fAdvances;
+    int fMismatches;
+
+    static void Run(void* arg) {
+        Worker* worker = (Worker*)arg;
+        SkAutoGlyphCache autoCache(*worker->fPaint, NULL, NULL);
+        SkGlyphCache* cache = autoCache.getCache();
+        for (int i = 0; i < kGlyphCount; i++) {
+            // Half the lookups only want the advance, and half want everything, so some glyphs
+            // are filled in while other threads are reading them.
+            const SkGlyph& glyph = (i & 1) ? cache->getGlyphIDAdvance(i)
+                                           : cache->getGlyphIDMetrics(i);
+            if (glyph.fAdvanceX != worker->fAdvances[i]) {
+                worker->fMismatches++;
+            }
+            const SkGlyph& full = cache->getGlyphIDMetrics(i);
+            if (full.fAdvanceX != worker->fAdvances[i] || full.isJustAdvance()) {
+                worker->fMismatches++;
+            }
+            cache->findImage(full);
+        }
+    }
+};
+
+DEF_TEST(GlyphCache_SharedStrike, reporter) {
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(29));
+
+    // Asking again for a strike already in use gets the same one, rather than a copy.
+    SkAutoGlyphCache cache0(paint, NULL, NULL);
+    SkAutoGlyphCache cache1(paint, NULL, NULL);
+    REPORTER_ASSERT(reporter, cache0.getCache() == cache1.getCache());
+}
+
+DEF_TEST(GlyphCache_Threads, reporter) {
+    SkPaint paint;
+    paint.setTextSize(SkFloatToScalar(31.25f));
+    paint.setAntiAlias(true);
+
+    SkFixed advances[kGlyphCount];
+    {
+        SkAutoGlyphCache autoCache(paint, NULL, NULL);
+        for (int i = 0; i < kGlyphCount; i++) {
+            advances[i] = autoCache.getCache()->getGlyphIDAdvance(i).fAdvanceX;
+        }
+    }
+    // Start the threads on a new strike, so they miss at the same time.
+    SkGraphics::PurgeFontCache();
+
+    static const int kThreads = 8;
+    Worker workers[kThreads];
+    SkThread* threads[kThreads];
+    for (int i = 0; i < kThreads; i++) {
+        workers[i].fPaint = &paint;
+        workers[i].fAdvances = advances;
+        workers[i].fMismatches = 0;
+        threads[i] = SkNEW_ARGS(SkThread, (Worker::Run, &workers[i]));
+    }
+    for (int i = 0; i < kThreads; i++) {
+        threads[i]->start();
+    }
+    for (int i = 0; i < kThreads; i++) {
+        threads[i]->join();
+        SkDELETE(threads[i]);
+    }
+
+    for (int i = 0; i < kThreads; i++) {
+        REPORTER_ASSERT(reporter, 0 == workers[i].fMismatches);
+    }
+}
+
+// Copies out the images of glyphs 0..kGlyphCount-1, generating any that are missing.
+static void copy_images(SkGlyphCache* cache, SkTDArray<uint8_t>* images) {
+    images->rewind();
+    for (int i = 0; i < kGlyphCount; i++) {
+        const SkGlyph& glyph = cache->getGlyphIDMetrics(i);
+        if (const void* image = cache->findImage(glyph)) {
+            images->append(SkToInt(glyph.computeImageSize()), (const uint8_t*)image);
+        }
+    }
+}
+
+DEF_TEST(GlyphCache_Prefetch, reporter) {
+    SkPaint paint;
+    paint.setTextSize(SkFloatToScalar(27.5f));
+    paint.setAntiAlias(true);
+
+    uint16_t ids[2 * kGlyphCount];
+    for (int i = 0; i < kGlyphCount; i++) {
+        ids[2 * i] = ids[2 * i + 1] = i;    // each one twice
+    }
+
+    SkTDArray<uint8_t> prefetched, expected;
+    SkGraphics::PurgeFontCache();
+    {
+        SkAutoGlyphCache autoCache(paint, NULL, NULL);
+        SkGlyphCache* cache = autoCache.getCache();
+        cache->prefetchGlyphs(ids, SK_ARRAY_COUNT(ids));
+        for (int i = 0; i < kGlyphCount; i++) {
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(i);
+            REPORTER_ASSERT(reporter, 0 == glyph.fWidth || glyph.fImage);
+        }
+        copy_images(cache, &prefetched);
+    }
+
+    // The images match the ones the strike makes for itself, one at a time.
+    SkGraphics::PurgeFontCache();
+    {
+        SkAutoGlyphCache autoCache(paint, NULL, NULL);
+        copy_images(autoCache.getCache(), &expected);
+    }
+    REPORTER_ASSERT(reporter, prefetched.count() > 0);
+    REPORTER_ASSERT(reporter, prefetched.count() == expected.count());
+    REPORTER_ASSERT(reporter, 0 == memcmp(prefetched.begin(), expected.begin(),
+                                          SkTMin(prefetched.count(), expected.count())));
+}
+
+DEF_TEST(GlyphCache_GlyphPaths, reporter) {
+    static const char kText[] = "Outline me";
+    const size_t length = strlen(kText);
+
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(40));
+    const int count = paint.countText(kText, length);
+    SkAutoTArray<uint16_t> glyphs(count);
+    paint.textToGlyphs(kText, length, glyphs.get());
+
+    SkPath outlines;
+    SkAutoTArray<int> pointOffsets(count + 1), verbOffsets(count + 1);
+    paint.getGlyphPaths(glyphs.get(), count, &outlines, pointOffsets.get(), verbOffsets.get());
+    REPORTER_ASSERT(reporter, pointOffsets[count] == outlines.countPoints());
+    REPORTER_ASSERT(reporter, verbOffsets[count] == outlines.countVerbs());
+
+    // The outlines are the ones getPosTextPath() finds, all drawn at the origin.
+    SkAutoTArray<SkPoint> origins(count);
+    for (int i = 0; i < count; ++i) {
+        origins[i].set(0, 0);
+    }
+    SkPath expected;
+    paint.getPosTextPath(kText, length, origins.get(), &expected);
+    REPORTER_ASSERT(reporter, outlines == expected);
+
+    // Each glyph's range holds its own outline, and the space has none.
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    for (int i = 0; i < count; ++i) {
+        SkPath glyphPath;
+        paint.getTextPath(&glyphs[i], sizeof(uint16_t), 0, 0, &glyphPath);
+        REPORTER_ASSERT(reporter,
+                        pointOffsets[i + 1] - pointOffsets[i] == glyphPath.countPoints());
+        REPORTER_ASSERT(reporter,
+                        verbOffsets[i + 1] - verbOffsets[i] == glyphPath.countVerbs());
+        if (' ' == kText[i]) {
+            REPORTER_ASSERT(reporter, pointOffsets[i + 1] == pointOffsets[i]);
+        }
+    }
+}
+
+// Counts the subpixel variants of each glyph that have the same mask as the variant at x = 0,
+// and how many of those share its image.
+static void count_same_variants(SkGlyphCache* cache, int* same, int* shared) {
+    *same = *shared = 0;
+    for (int i = 0; i < kGlyphCount; i++) {
+        const SkGlyph& base = cache->getGlyphIDMetrics(i, 0, 0);
+        const void* baseImage = cache->findImage(base);
+        for (int sub = 1; sub < 4; sub++) {
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(i, sub * (SK_Fixed1 / 4), 0);
+            const void* image = cache->findImage(glyph);
+            if (baseImage && image && base.fWidth == glyph.fWidth &&
+                base.fHeight == glyph.fHeight && base.fLeft == glyph.fLeft &&
+                base.fTop == glyph.fTop && base.fMaskFormat == glyph.fMaskFormat &&
+                0 == memcmp(baseImage, image, glyph.computeImageSize())) {
+                *same += 1;
+                *shared += (baseImage == image);
+            }
+        }
+    }
+}
+
+DEF_TEST(GlyphCache_SharedSubpixelImages, reporter) {
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(12));
+    paint.setSubpixelText(true);
+    paint.setHinting(SkPaint::kFull_Hinting);
+    paint.setTypeface(SkTypeface::RefDefault())->unref();
+
+    // How many variants come out the same depends on the font, so just check that every one of
+    // them shares once sharing is on, and none do while it is off.
+    int same, shared;
+    // PurgeFontCache() leaves a thread's own cache alone, so make sure the strikes are shared.
+    const size_t tlsLimit = SkGraphics::GetTLSFontCacheLimit();
+    SkGraphics::SetTLSFontCacheLimit(0);
+    const bool wasSharing = SkGraphics::SetFontCacheSharesSubpixelImages(false);
+    SkGraphics::PurgeFontCache();
+    {
+        SkAutoGlyphCache autoCache(paint, NULL, NULL);
+        REPORTER_ASSERT(reporter, autoCache.getCache()->isSubpixel());
+        count_same_variants(autoCache.getCache(), &same, &shared);
+        REPORTER_ASSERT(reporter, 0 == shared);
+    }
+
+    SkGraphics::SetFontCacheSharesSubpixelImages(true);
+    SkGraphics::PurgeFontCache();
+    {
+        SkAutoGlyphCache autoCache(paint, NULL, NULL);
+        int sameShared;
+        count_same_variants(autoCache.getCache(), &sameShared, &shared);
+        REPORTER_ASSERT(reporter, same == sameShared);
+        REPORTER_ASSERT(reporter, same == shared);
+    }
+    SkGraphics::SetFontCacheSharesSubpixelImages(wasSharing);
+    SkGraphics::SetTLSFontCacheLimit(tlsLimit);
+}
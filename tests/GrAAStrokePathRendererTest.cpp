@@ -0,0 +1,68 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+// A winding road, concave and self intersecting once stroked.
+static void make_road(SkPath* path, SkScalar x, SkScalar y) {
+    path->moveTo(x, y);
+    path->lineTo(x + 80, y + 20);
+    path->quadTo(x + 140, y + 40, x + 100, y + 90);
+    path->lineTo(x + 20, y + 60);
+    path->lineTo(x + 60, y + 10);
+}
+
+DEF_GPUTEST(GrAAStrokePathRenderer, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+    SkImageInfo info = SkImageInfo::MakeN32Premul(512, 512);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (NULL == surface) {
+        ERRORF(reporter, "Could not create a render target.");
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    context->flush();
+
+    const GrGpu::Stats* stats = context->getGpu()->stats();
+    const int creates = stats->textureCreates();
+    const int uploads = stats->textureUploads();
+    const int draws = stats->draws();
+
+    // Opaque strokes are tessellated directly, so no masks are made and the roads share one draw
+    // even though their colors, widths, joins and caps differ.
+    for (int i = 0; i < 8; ++i) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(SkIntToScalar(2 + 3 * i));
+        paint.setStrokeJoin(static_cast<SkPaint::Join>(i % SkPaint::kJoinCount));
+        paint.setStrokeCap(static_cast<SkPaint::Cap>(i % SkPaint::kCapCount));
+        paint.setColor(i & 1 ? SK_ColorBLUE : SK_ColorRED);
+        SkPath road;
+        make_road(&road, SkIntToScalar(40 * i), SkIntToScalar(30 * i));
+        canvas->drawPath(road, paint);
+    }
+    context->flush();
+
+    REPORTER_ASSERT(reporter, creates == stats->textureCreates());
+    REPORTER_ASSERT(reporter, uploads == stats->textureUploads());
+    REPORTER_ASSERT(reporter, 1 == stats->draws() - draws);
+}
+
+#endif
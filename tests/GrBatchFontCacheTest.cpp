@@ -0,0 +1,69 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrBatchFontCache.h"
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrFontAtlasSizes.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+// More large glyphs than fit in one page of the A8 atlas, all drawn by one batch, so every plot
+// is still waiting to be drawn when the page fills up.
+static const int kGlyphCount = 160;
+static const SkScalar kTextSize = 160;
+
+DEF_GPUTEST(GrBatchFontCache_Pages, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNative_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(kTextSize);
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    SkAutoTUnref<SkTypeface> typeface(SkTypeface::RefDefault());
+    if (typeface->countGlyphs() <= kGlyphCount) {
+        return;
+    }
+
+    uint16_t glyphs[kGlyphCount];
+    SkPoint pos[kGlyphCount];
+    for (int i = 0; i < kGlyphCount; ++i) {
+        glyphs[i] = SkToU16(i + 1);
+        pos[i].set(SkIntToScalar(i % 16) * 60, SkIntToScalar(i / 16) * 60 + kTextSize);
+    }
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(1024, 768);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (!surface) {
+        return;
+    }
+
+    GrBatchFontCache* fontCache = context->getBatchFontCache();
+    const GrBatchAtlas::Stats before = fontCache->atlasStats(kA8_GrMaskFormat);
+
+    surface->getCanvas()->drawPosText(glyphs, sizeof(glyphs), pos, paint);
+    context->flush();
+
+    const GrBatchAtlas::Stats& after = fontCache->atlasStats(kA8_GrMaskFormat);
+    const int pages = fontCache->numPages(kA8_GrMaskFormat);
+    REPORTER_ASSERT(reporter, pages <= GR_FONT_ATLAS_MAX_PAGES);
+    REPORTER_ASSERT(reporter, after.fPagesAdded - before.fPagesAdded <= pages - 1);
+    // Until the atlas reaches its last page, it grows rather than making the batch flush.
+    if (pages < GR_FONT_ATLAS_MAX_PAGES) {
+        REPORTER_ASSERT(reporter, after.fFlushes == before.fFlushes);
+    }
+}
+
+#endif
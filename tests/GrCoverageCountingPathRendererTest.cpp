@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+// Too big for the distance field renderer, and concave, so without coverage counting it would
+// take a software mask.
+static void make_star(SkPath* path, SkScalar x, SkScalar y) {
+    path->moveTo(x + 60, y);
+    path->lineTo(x + 100, y + 120);
+    path->lineTo(x, y + 40);
+    path->lineTo(x + 120, y + 40);
+    path->lineTo(x + 20, y + 120);
+    path->close();
+}
+
+DEF_GPUTEST(GrCoverageCountingPathRenderer, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+    SkImageInfo info = SkImageInfo::MakeN32Premul(512, 512);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (NULL == surface) {
+        ERRORF(reporter, "Could not create a render target.");
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    // The first path may need an atlas.
+    SkPath path;
+    make_star(&path, 0, 0);
+    canvas->drawPath(path, paint);
+    context->flush();
+
+    const GrGpu::Stats* stats = context->getGpu()->stats();
+    const int creates = stats->textureCreates();
+    const int uploads = stats->textureUploads();
+    const int draws = stats->draws();
+
+    // Later ones share it. Nothing is drawn in software, so nothing is uploaded.
+    for (int i = 0; i < 8; ++i) {
+        SkPath star;
+        make_star(&star, SkIntToScalar(40 * i), SkIntToScalar(30 * i));
+        star.setFillType(i & 1 ? SkPath::kEvenOdd_FillType : SkPath::kWinding_FillType);
+        if (i & 2) {
+            star.addCircle(SkIntToScalar(40 * i + 60), SkIntToScalar(30 * i + 60), 20);
+        }
+        canvas->drawPath(star, paint);
+    }
+    context->flush();
+
+    REPORTER_ASSERT(reporter, creates == stats->textureCreates());
+    REPORTER_ASSERT(reporter, uploads == stats->textureUploads());
+    REPORTER_ASSERT(reporter, stats->draws() - draws >= 8);
+}
+
+#endif
@@ -12,6 +12,8 @@
 #include "GrContextFactory.h"
 #include "GrDrawTargetCaps.h"
 #include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
 #include "Test.h"
 
 static void test_print(skiatest::Reporter*, const GrDrawTargetCaps* caps) {
@@ -33,4 +35,77 @@ DEF_GPUTEST(GrDrawTarget, reporter, factory) {
     }
 }
 
+#if GR_GPU_STATS
+// Draws count pairs of anti-aliased rects and circles, alternating, and returns how many draw calls
+// that took.  Each rect crosses its circle.  The pairs are laid out in a row, or all stacked in
+// the same spot if overlap is true.
+static int count_draws(GrContext* context, SkCanvas* canvas, int count, bool overlap) {
+    context->flush();
+    const int before = context->getGpu()->stats()->draws();
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < count; i++) {
+        SkScalar x = overlap ? 0 : SkIntToScalar(20 * i);
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(x + 2, 17, 15, 6), paint);
+        paint.setColor(SK_ColorRED);
+        canvas->drawCircle(x + 10, 20, 7, paint);
+    }
+
+    context->flush();
+    return context->getGpu()->stats()->draws() - before;
+}
+
+// Batches may be combined with earlier ones they don't overlap, even across other batches.
+DEF_GPUTEST(GrDrawTarget_ReordersBatches, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+    SkImageInfo info = SkImageInfo::MakeN32Premul(256, 64);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (NULL == surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+
+    // One draw for all the rects, one for all the circles.
+    REPORTER_ASSERT(reporter, 2 == count_draws(context, canvas, 10, false));
+
+    // Each batch now covers the one before, so none can move.
+    REPORTER_ASSERT(reporter, 20 == count_draws(context, canvas, 10, true));
+}
+
+// With instanced drawing, one batch of circles is one draw however many circles it holds, even
+// more than the quad index buffer would cover.
+DEF_GPUTEST(GrDrawTarget_InstancedCircles, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context || !context->getGpu()->caps()->instancedDrawingSupport()) {
+        return;
+    }
+    SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (NULL == surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+
+    context->flush();
+    const int before = context->getGpu()->stats()->draws();
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 3000; i++) {
+        canvas->drawCircle(SkIntToScalar(4 + 8 * (i % 32)), SkIntToScalar(4 + 8 * (i / 32 % 32)),
+                           3, paint);
+    }
+
+    context->flush();
+    REPORTER_ASSERT(reporter, 1 == context->getGpu()->stats()->draws() - before);
+}
+#endif
+
 #endif
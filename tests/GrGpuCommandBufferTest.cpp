@@ -0,0 +1,63 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrGpuCommandBuffer.h"
+#include "Test.h"
+
+DEF_GPUTEST(GrGpuCommandBuffer, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+
+    GrSurfaceDesc desc;
+    desc.fFlags     = kRenderTarget_GrSurfaceFlag;
+    desc.fConfig    = kRGBA_8888_GrPixelConfig;
+    desc.fWidth     = 16;
+    desc.fHeight    = 16;
+    SkAutoTUnref<GrTexture> texture(context->createTexture(desc, false, NULL, 0));
+    if (!texture) {
+        return;
+    }
+    GrRenderTarget* rt = texture->asRenderTarget();
+
+    GrGpuCommandBuffer commands(context->getGpu());
+    REPORTER_ASSERT(reporter, commands.empty());
+    REPORTER_ASSERT(reporter, commands.validate());
+
+    SkIRect rect = SkIRect::MakeWH(8, 8);
+    commands.pushTraceMarker("clears", 0);
+    commands.clear(&rect, GrColor_WHITE, false, rt);
+    commands.discard(rt);
+    commands.popTraceMarker();
+    REPORTER_ASSERT(reporter, 4 == commands.count());
+    REPORTER_ASSERT(reporter, commands.validate());
+
+    // Submitting replays and empties the buffer
+    commands.submit();
+    REPORTER_ASSERT(reporter, commands.empty());
+    REPORTER_ASSERT(reporter, 0 == commands.count());
+
+    // Markers have to balance
+    commands.popTraceMarker();
+    REPORTER_ASSERT(reporter, !commands.validate());
+    commands.reset();
+    commands.pushTraceMarker("unbalanced", 0);
+    REPORTER_ASSERT(reporter, !commands.validate());
+    commands.reset();
+
+    // A clear needs a target
+    commands.clear(&rect, GrColor_WHITE, false, NULL);
+    REPORTER_ASSERT(reporter, !commands.validate());
+    commands.reset();
+}
+
+#endif
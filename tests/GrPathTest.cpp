@@ -0,0 +1,69 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrPath.h"
+#include "Test.h"
+
+static void make_icon(SkPath* path, SkScalar offset) {
+    path->moveTo(0, 0);
+    path->lineTo(10 + offset, 0);
+    path->quadTo(15, 5, 10, 10);
+    path->close();
+}
+
+static GrUniqueKey key_for(const SkPath& path, const SkStrokeRec& stroke, bool* isVolatile) {
+    GrUniqueKey key;
+    GrPath::ComputeKey(path, stroke, &key, isVolatile);
+    return key;
+}
+
+DEF_TEST(GrPathKeys, reporter) {
+    SkStrokeRec fill(SkStrokeRec::kFill_InitStyle);
+    SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
+    stroke.setStrokeStyle(2);
+    bool isVolatile;
+
+    // Small paths built separately, with different generation IDs, share a key...
+    SkPath a, b;
+    make_icon(&a, 0);
+    make_icon(&b, 0);
+    REPORTER_ASSERT(reporter, a.getGenerationID() != b.getGenerationID());
+    GrUniqueKey keyA = key_for(a, fill, &isVolatile);
+    REPORTER_ASSERT(reporter, !isVolatile);
+    REPORTER_ASSERT(reporter, keyA == key_for(b, fill, &isVolatile));
+
+    // ... unless their points, fill type or stroke differ.
+    SkPath c;
+    make_icon(&c, 1);
+    REPORTER_ASSERT(reporter, keyA != key_for(c, fill, &isVolatile));
+    b.setFillType(SkPath::kEvenOdd_FillType);
+    REPORTER_ASSERT(reporter, keyA != key_for(b, fill, &isVolatile));
+    REPORTER_ASSERT(reporter, keyA != key_for(a, stroke, &isVolatile));
+
+    // Volatile small paths may still share a key, as they're keyed by their contents.
+    a.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, keyA == key_for(a, fill, &isVolatile));
+    REPORTER_ASSERT(reporter, !isVolatile);
+
+    // Big paths are keyed by generation ID, and aren't cached if volatile.
+    SkPath big1, big2;
+    for (int i = 0; i < 50; ++i) {
+        big1.lineTo(SkIntToScalar(i), SkIntToScalar(i * i % 7));
+        big2.lineTo(SkIntToScalar(i), SkIntToScalar(i * i % 7));
+    }
+    GrUniqueKey keyBig = key_for(big1, fill, &isVolatile);
+    REPORTER_ASSERT(reporter, !isVolatile);
+    REPORTER_ASSERT(reporter, keyBig == key_for(big1, fill, &isVolatile));
+    REPORTER_ASSERT(reporter, keyBig != key_for(big2, fill, &isVolatile));
+    big1.setIsVolatile(true);
+    key_for(big1, fill, &isVolatile);
+    REPORTER_ASSERT(reporter, isVolatile);
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+// This is a GPU-backend specific test
+#if SK_SUPPORT_GPU
+#include "GrPathUtils.h"
+
+static void check_flattened(skiatest::Reporter* reporter, const SkPath& path, SkScalar tol,
+                            const GrPathUtils::FlattenedPath* flattened) {
+    int contourCount;
+    int worstCase = GrPathUtils::worstCasePointCount(path, &contourCount, tol);
+    REPORTER_ASSERT(reporter, flattened->fPoints.count() <= worstCase);
+    REPORTER_ASSERT(reporter, flattened->fContourStarts.count() == contourCount);
+    if (contourCount > 0) {
+        REPORTER_ASSERT(reporter, 0 == flattened->fContourStarts[0]);
+    }
+    // Every flattened point lies on the path, so inside its bounds.
+    SkRect bounds = path.getBounds();
+    bounds.outset(tol, tol);
+    for (int i = 0; i < flattened->fPoints.count(); ++i) {
+        const SkPoint& pt = flattened->fPoints[i];
+        REPORTER_ASSERT(reporter, bounds.fLeft <= pt.fX && pt.fX <= bounds.fRight &&
+                                  bounds.fTop <= pt.fY && pt.fY <= bounds.fBottom);
+    }
+}
+
+DEF_TEST(GrPathUtils_FlattenPath, reporter) {
+    const SkScalar tol = SK_Scalar1 / 4;
+
+    SkPath path;
+    path.addCircle(50, 50, 40);
+    path.addOval(SkRect::MakeLTRB(10, 10, 30, 60));
+
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> first(GrPathUtils::flattenPath(path, tol));
+    check_flattened(reporter, path, tol, first);
+    REPORTER_ASSERT(reporter, 2 == first->fContourStarts.count());
+
+    // Drawing the same path at the same tolerance reuses the points.
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> second(GrPathUtils::flattenPath(path, tol));
+    REPORTER_ASSERT(reporter, first.get() == second.get());
+
+    // A different tolerance, or an edited path, is flattened again.
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> coarse(GrPathUtils::flattenPath(path, 2 * tol));
+    REPORTER_ASSERT(reporter, coarse.get() != first.get());
+    REPORTER_ASSERT(reporter, coarse->fPoints.count() <= first->fPoints.count());
+    check_flattened(reporter, path, 2 * tol, coarse);
+
+    path.quadTo(0, 0, 100, 0);
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> edited(GrPathUtils::flattenPath(path, tol));
+    REPORTER_ASSERT(reporter, edited.get() != first.get());
+    REPORTER_ASSERT(reporter, edited->fPoints.count() > first->fPoints.count());
+    check_flattened(reporter, path, tol, edited);
+
+    // Volatile paths and paths of only lines aren't kept.
+    SkPath volatilePath;
+    volatilePath.addCircle(20, 20, 10);
+    volatilePath.setIsVolatile(true);
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> v0(GrPathUtils::flattenPath(volatilePath, tol));
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> v1(GrPathUtils::flattenPath(volatilePath, tol));
+    REPORTER_ASSERT(reporter, v0.get() != v1.get());
+    REPORTER_ASSERT(reporter, v0->fPoints == v1->fPoints);
+
+    SkPath linePath;
+    linePath.addRect(SkRect::MakeWH(10, 20));
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> l0(GrPathUtils::flattenPath(linePath, tol));
+    SkAutoTUnref<const GrPathUtils::FlattenedPath> l1(GrPathUtils::flattenPath(linePath, tol));
+    REPORTER_ASSERT(reporter, l0.get() != l1.get());
+    // The close adds a line back to the first corner.
+    REPORTER_ASSERT(reporter, 5 == l0->fPoints.count());
+    check_flattened(reporter, linePath, tol, l0);
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+
+#include "GrContext.h"
+#include "GrGpu.h"
+#include "GrPersistentCache.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "SkTDArray.h"
+#include "Test.h"
+#include "gl/GrGLInterface.h"
+
+namespace {
+
+// Keeps everything in memory, standing in for a cache on disk that outlives each context.
+class MemoryCache : public GrPersistentCache {
+public:
+    MemoryCache() : fHits(0) {}
+    ~MemoryCache() {
+        fKeys.unrefAll();
+        fData.unrefAll();
+    }
+
+    SkData* load(const SkData& key) override {
+        for (int i = 0; i < fKeys.count(); i++) {
+            if (fKeys[i]->equals(&key)) {
+                fHits++;
+                return SkRef(fData[i]);
+            }
+        }
+        return NULL;
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        *fKeys.append() = SkData::NewWithCopy(key.data(), key.size());
+        *fData.append() = SkData::NewWithCopy(data.data(), data.size());
+    }
+
+    int count() const { return fKeys.count(); }
+    int hits() const { return fHits; }
+
+private:
+    SkTDArray<SkData*> fKeys;
+    SkTDArray<SkData*> fData;
+    int fHits;
+};
+
+}  // namespace
+
+// Draws a few shapes that need different programs into a new context, returning how many
+// shaders it had to compile.
+static int draw_and_count_compiles(skiatest::Reporter* reporter, GrPersistentCache* cache) {
+    SkAutoTUnref<const GrGLInterface> gl(GrGLCreateNullInterface());
+    GrContext::Options opts;
+    opts.fPersistentCache = cache;
+    SkAutoTUnref<GrContext> context(GrContext::Create(kOpenGL_GrBackend,
+                                                      reinterpret_cast<GrBackendContext>(gl.get()),
+                                                      &opts));
+    if (NULL == context) {
+        ERRORF(reporter, "Could not create a null GL context.");
+        return -1;
+    }
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (NULL == surface) {
+        ERRORF(reporter, "Could not create a render target.");
+        return -1;
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->drawRect(SkRect::MakeXYWH(2, 2, 20, 10), paint);
+    canvas->drawCircle(40, 40, 10, paint);
+    context->flush();
+    return context->getGpu()->stats()->shaderCompilations();
+}
+
+DEF_GPUTEST(GrPersistentCache, reporter, factory) {
+    MemoryCache cache;
+
+    // A cold cache compiles everything, and keeps each program it links.
+    int compiles = draw_and_count_compiles(reporter, &cache);
+    REPORTER_ASSERT(reporter, compiles > 0);
+    REPORTER_ASSERT(reporter, cache.count() > 0);
+    REPORTER_ASSERT(reporter, 0 == cache.hits());
+
+    // A warm one compiles nothing.
+    const int stored = cache.count();
+    REPORTER_ASSERT(reporter, 0 == draw_and_count_compiles(reporter, &cache));
+    REPORTER_ASSERT(reporter, stored == cache.hits());
+    REPORTER_ASSERT(reporter, stored == cache.count());
+}
+
+#endif
@@ -181,6 +181,71 @@ static void TestConstantGradient(skiatest::Reporter*) {
 
 typedef void (*GradProc)(skiatest::Reporter* reporter, const GradRec&);
 
+static bool colors_are_close(SkPMColor a, SkPMColor b, int tolerance) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        if (SkAbs32((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Linear and radial gradients shade whole spans four pixels at a time. Check them against
+// shading each pixel on its own, which only differs by the rounding of where the pixel lands.
+static void test_span_kernels(skiatest::Reporter* reporter) {
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    const SkPoint pts[] = { { 3, 0 }, { 20, 5 } };
+    const SkShader::TileMode modes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode,
+    };
+    SkMatrix matrices[3];
+    matrices[0].reset();
+    matrices[1].setRotate(30);
+    matrices[1].postTranslate(7.25f, -3.5f);
+    matrices[2].setScale(-0.75f, 1.5f);
+    matrices[2].postSkew(0.25f, 0);
+
+    for (int radial = 0; radial < 2; radial++) {
+        for (size_t m = 0; m < SK_ARRAY_COUNT(modes); m++) {
+            for (size_t i = 0; i < SK_ARRAY_COUNT(matrices); i++) {
+                SkAutoTUnref<SkShader> shader(radial ?
+                    SkGradientShader::CreateRadial(pts[0], 13, colors, NULL, 2, modes[m], 0,
+                                                   &matrices[i]) :
+                    SkGradientShader::CreateLinear(pts, colors, NULL, 2, modes[m], 0,
+                                                   &matrices[i]));
+                SkPaint paint;
+                paint.setShader(shader);
+
+                SkBitmap spans, pixels;
+                spans.allocN32Pixels(67, 5);
+                pixels.allocN32Pixels(67, 5);
+                SkCanvas spanCanvas(spans);
+                spanCanvas.drawPaint(paint);
+                SkCanvas pixelCanvas(pixels);
+                for (int y = 0; y < pixels.height(); y++) {
+                    for (int x = 0; x < pixels.width(); x++) {
+                        pixelCanvas.drawRect(SkRect::MakeXYWH(SkIntToScalar(x),
+                                                              SkIntToScalar(y), 1, 1), paint);
+                    }
+                }
+
+                int mismatches = 0;
+                for (int y = 0; y < spans.height(); y++) {
+                    for (int x = 0; x < spans.width(); x++) {
+                        if (!colors_are_close(*spans.getAddr32(x, y), *pixels.getAddr32(x, y),
+                                              4)) {
+                            mismatches++;
+                        }
+                    }
+                }
+                // A pixel can land on a repeat or mirror seam, where the two roundings pick
+                // opposite ends of the cache. That happens once at most in these rows.
+                REPORTER_ASSERT(reporter, mismatches <= 1);
+            }
+        }
+    }
+}
+
 static void TestGradientShaders(skiatest::Reporter* reporter) {
     static const SkColor gColors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
     static const SkScalar gPos[] = { 0, SK_ScalarHalf, SK_Scalar1 };
@@ -217,4 +282,5 @@ DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
     test_big_grad(reporter);
+    test_span_kernels(reporter);
 }
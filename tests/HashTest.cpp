@@ -6,7 +6,9 @@
  */
 
 #include "SkChecksum.h"
+#include "SkRandom.h"
 #include "SkString.h"
+#include "SkTGroupHash.h"
 #include "SkTHash.h"
 #include "Test.h"
 
@@ -137,3 +139,88 @@ DEF_TEST(HashSetCopyCounter, r) {
     // We allow copies for same-value adds for now.
     REPORTER_ASSERT(r, globalCounter == 5);
 }
+
+DEF_TEST(GroupHashMap, r) {
+    SkTGroupHashMap<int, double> map;
+    REPORTER_ASSERT(r, !map.find(3));
+
+    map.set(3, 4.0);
+    REPORTER_ASSERT(r, map.count() == 1);
+    REPORTER_ASSERT(r, map.find(3) && *map.find(3) == 4.0);
+
+    map.set(3, 5.0);
+    REPORTER_ASSERT(r, map.count() == 1);
+    REPORTER_ASSERT(r, *map.find(3) == 5.0);
+
+    map.remove(3);
+    REPORTER_ASSERT(r, map.count() == 0);
+    REPORTER_ASSERT(r, !map.find(3));
+
+    // Mirror random sets and removes in an SkTHashMap, across several resizes and rehashes.
+    SkTHashMap<int, int> expected;
+    SkRandom random;
+    for (int i = 0; i < 20000; i++) {
+        int key = random.nextULessThan(1000);
+        if (random.nextBool()) {
+            map.set(key, i);
+            expected.set(key, i);
+        } else {
+            map.remove(key);
+            expected.set(key, -1);
+        }
+    }
+    int count = 0;
+    expected.foreach([&](int key, int* val) {
+        double* found = map.find(key);
+        if (*val < 0) {
+            REPORTER_ASSERT(r, !found);
+        } else {
+            REPORTER_ASSERT(r, found && *found == *val);
+            count++;
+        }
+    });
+    REPORTER_ASSERT(r, map.count() == count);
+
+    int visited = 0;
+    map.foreach([&visited](int, double*) { visited++; });
+    REPORTER_ASSERT(r, visited == count);
+
+    map.reset();
+    REPORTER_ASSERT(r, map.count() == 0);
+    REPORTER_ASSERT(r, !map.find(0));
+}
+
+DEF_TEST(GroupHashSet, r) {
+    SkTGroupHashSet<SkString> set;
+
+    set.add(SkString("Hello"));
+    set.add(SkString("World"));
+
+    REPORTER_ASSERT(r, set.count() == 2);
+    REPORTER_ASSERT(r, set.contains(SkString("Hello")));
+    REPORTER_ASSERT(r, set.contains(SkString("World")));
+    REPORTER_ASSERT(r, !set.contains(SkString("Goodbye")));
+    REPORTER_ASSERT(r, *set.find(SkString("Hello")) == SkString("Hello"));
+
+    set.remove(SkString("Hello"));
+    REPORTER_ASSERT(r, set.count() == 1);
+    REPORTER_ASSERT(r, !set.contains(SkString("Hello")));
+    REPORTER_ASSERT(r, set.contains(SkString("World")));
+
+    // Colliding hashes fill whole groups and probe on to the next ones.
+    SkTGroupHashSet<CopyCounter, hash_copy_counter> colliding;
+    uint32_t counter = 0;
+    for (uint32_t i = 1; i <= 100; i++) {
+        colliding.add(CopyCounter(i, &counter));
+    }
+    for (uint32_t i = 1; i <= 100; i += 2) {
+        colliding.remove(CopyCounter(i, &counter));
+    }
+    REPORTER_ASSERT(r, colliding.count() == 50);
+    for (uint32_t i = 1; i <= 100; i++) {
+        REPORTER_ASSERT(r, colliding.contains(CopyCounter(i, &counter)) == (i % 2 == 0));
+    }
+
+    set.reset();
+    REPORTER_ASSERT(r, set.count() == 0);
+}
@@ -25,6 +25,7 @@ struct TestingRec : public SkResourceCache::Rec {
     intptr_t    fValue;
 
     const Key& getKey() const override { return fKey; }
+    const char* getCategory() const override { return "test"; }
     size_t bytesUsed() const override { return sizeof(fKey) + sizeof(fValue); }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
@@ -149,3 +150,53 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+DEF_TEST(ImageCache_pin, r) {
+    const size_t recBytes = TestingRec(TestingKey(0), 0).bytesUsed();
+    SkResourceCache cache(4 * recBytes);
+
+    TestingKey pinnedKey(0, 1);
+    REPORTER_ASSERT(r, !cache.pin(pinnedKey));
+    cache.add(SkNEW_ARGS(TestingRec, (pinnedKey, 0)));
+    REPORTER_ASSERT(r, cache.pin(pinnedKey));
+    REPORTER_ASSERT(r, cache.pin(pinnedKey));
+
+    SkResourceCache::Stats stats;
+    cache.getStats(&stats);
+    REPORTER_ASSERT(r, 1 == stats.fPinnedCount);
+    REPORTER_ASSERT(r, recBytes == stats.fPinnedBytes);
+
+    // Going over budget purges everything else first, then leaves the pinned rec alone.
+    for (int i = 1; i <= COUNT; ++i) {
+        cache.add(SkNEW_ARGS(TestingRec, (TestingKey(i), i)));
+    }
+    intptr_t value = -1;
+    REPORTER_ASSERT(r, cache.find(pinnedKey, TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, 0 == value);
+    cache.setTotalByteLimit(0);
+    cache.purgeAll();
+    cache.getStats(&stats);
+    REPORTER_ASSERT(r, 1 == stats.fCount);
+    REPORTER_ASSERT(r, stats.fPurges >= COUNT);
+    REPORTER_ASSERT(r, cache.find(pinnedKey, TestingRec::Visitor, &value));
+
+    // Pins nest, and the last unpin lets the budget purge it.
+    REPORTER_ASSERT(r, cache.unpin(pinnedKey));
+    REPORTER_ASSERT(r, cache.find(pinnedKey, TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, cache.unpin(pinnedKey));
+    REPORTER_ASSERT(r, !cache.find(pinnedKey, TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, !cache.unpin(pinnedKey));
+    cache.getStats(&stats);
+    REPORTER_ASSERT(r, 0 == stats.fCount);
+    REPORTER_ASSERT(r, 0 == stats.fPinnedCount);
+    REPORTER_ASSERT(r, 0 == stats.fPinnedBytes);
+
+    // Stale recs are purged whether or not they are pinned.
+    cache.setTotalByteLimit(4 * recBytes);
+    cache.add(SkNEW_ARGS(TestingRec, (pinnedKey, 0)));
+    REPORTER_ASSERT(r, cache.pin(pinnedKey));
+    cache.purgeSharedID(1);
+    REPORTER_ASSERT(r, !cache.find(pinnedKey, TestingRec::Visitor, &value));
+    cache.getStats(&stats);
+    REPORTER_ASSERT(r, 0 == stats.fPinnedCount);
+}
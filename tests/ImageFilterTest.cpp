@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkAtomics.h"
 #include "SkBitmap.h"
 #include "SkBitmapDevice.h"
 #include "SkBitmapSource.h"
@@ -28,6 +29,7 @@
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
 #include "SkReadBuffer.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "SkRectShaderImageFilter.h"
 #include "SkTileImageFilter.h"
@@ -72,8 +74,51 @@ private:
     typedef SkImageFilter INHERITED;
 };
 
+// Passes its source through, offset by (dx, 0), and counts how many times it is filtered.
+class CountingImageFilter : public SkImageFilter {
+public:
+    explicit CountingImageFilter(int dx) : SkImageFilter(0, NULL), fDx(dx), fCount(0) {}
+
+    int count() const { return sk_atomic_load(&fCount); }
+
+    virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
+                               SkBitmap* result, SkIPoint* offset) const override {
+        sk_atomic_inc(&fCount);
+        *result = src;
+        *offset = SkIPoint::Make(fDx, 0);
+        return true;
+    }
+
+    SK_TO_STRING_OVERRIDE()
+    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(CountingImageFilter)
+
+protected:
+    void flatten(SkWriteBuffer& buffer) const override {
+        this->INHERITED::flatten(buffer);
+        buffer.writeInt(fDx);
+    }
+
+private:
+    int fDx;
+    mutable int32_t fCount;
+
+    typedef SkImageFilter INHERITED;
+};
+
 }
 
+SkFlattenable* CountingImageFilter::CreateProc(SkReadBuffer& buffer) {
+    SK_IMAGEFILTER_UNFLATTEN_COMMON(common, 0);
+    return SkNEW_ARGS(CountingImageFilter, (buffer.readInt()));
+}
+
+#ifndef SK_IGNORE_TO_STRING
+void CountingImageFilter::toString(SkString* str) const {
+    str->appendf("CountingImageFilter: (");
+    str->append(")");
+}
+#endif
+
 SkFlattenable* MatrixTestImageFilter::CreateProc(SkReadBuffer& buffer) {
     SK_IMAGEFILTER_UNFLATTEN_COMMON(common, 1);
     skiatest::Reporter* reporter = (skiatest::Reporter*)buffer.readFunctionPtr();
@@ -405,6 +450,248 @@ DEF_TEST(TestNegativeBlurSigma, reporter) {
     test_negative_blur_sigma(&device, reporter);
 }
 
+DEF_TEST(ImageFilterBlurStripes, reporter) {
+    // Big images are blurred a stripe of rows at a time. Blurring a spot in the middle of one,
+    // across stripe boundaries, gives what blurring it in a small image with room around the
+    // spot does.
+    const int kSmall = 64, kBig = 640, kOrigin = 340;
+    SkBitmap small;
+    small.allocN32Pixels(kSmall, kSmall);
+    small.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(small);
+        canvas.drawBitmap(make_gradient_circle(16, 16), 24, 24);
+    }
+    SkBitmap big;
+    big.allocN32Pixels(kBig, kBig);
+    big.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(big);
+        canvas.drawBitmap(small, SkIntToScalar(kOrigin), SkIntToScalar(kOrigin));
+    }
+
+    SkBitmap temp;
+    temp.allocN32Pixels(100, 100);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    const SkScalar sigmas[][2] = { { 3, 3 }, { 3, 0 }, { 0, 3 }, { 0.5f, 5 } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sigmas); ++i) {
+        SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(sigmas[i][0], sigmas[i][1]));
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+        SkBitmap smallResult, bigResult;
+        SkIPoint smallOffset, bigOffset;
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, small, ctx, &smallResult,
+                                                    &smallOffset));
+        REPORTER_ASSERT(reporter, blur->filterImage(&proxy, big, ctx, &bigResult, &bigOffset));
+        REPORTER_ASSERT(reporter, smallResult.dimensions() == small.dimensions());
+        REPORTER_ASSERT(reporter, bigResult.dimensions() == big.dimensions());
+        if (smallResult.dimensions() != small.dimensions() ||
+            bigResult.dimensions() != big.dimensions()) {
+            continue;
+        }
+        SkAutoLockPixels smallLock(smallResult), bigLock(bigResult);
+        for (int y = 0; y < kSmall; ++y) {
+            REPORTER_ASSERT(reporter, !memcmp(smallResult.getAddr32(0, y),
+                                              bigResult.getAddr32(kOrigin, kOrigin + y),
+                                              kSmall * sizeof(SkPMColor)));
+        }
+    }
+}
+
+// The min or max of each channel over the clamped (2 * rx + 1) x (2 * ry + 1) window.
+static SkPMColor morph_reference(const SkBitmap& src, int x, int y, int rx, int ry,
+                                 bool dilate) {
+    int c[4];
+    for (int i = 0; i < 4; ++i) {
+        c[i] = dilate ? 0 : 255;
+    }
+    for (int j = SkTMax(y - ry, 0); j <= SkTMin(y + ry, src.height() - 1); ++j) {
+        for (int i = SkTMax(x - rx, 0); i <= SkTMin(x + rx, src.width() - 1); ++i) {
+            const SkPMColor p = *src.getAddr32(i, j);
+            const int v[4] = { (int)SkGetPackedA32(p), (int)SkGetPackedR32(p),
+                               (int)SkGetPackedG32(p), (int)SkGetPackedB32(p) };
+            for (int k = 0; k < 4; ++k) {
+                c[k] = dilate ? SkTMax(c[k], v[k]) : SkTMin(c[k], v[k]);
+            }
+        }
+    }
+    return SkPackARGB32(c[0], c[1], c[2], c[3]);
+}
+
+DEF_TEST(ImageFilterMorphologyLargeRadius, reporter) {
+    // Large radii take the van Herk/Gil-Werman path, which has to match the plain window, edges
+    // and radii bigger than the image included.
+    SkBitmap src;
+    src.allocN32Pixels(37, 29);
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyARGB(rand.nextU() & 0xFF, rand.nextU() & 0xFF,
+                                                     rand.nextU() & 0xFF, rand.nextU() & 0xFF);
+        }
+    }
+
+    SkBitmap temp;
+    temp.allocN32Pixels(100, 100);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+    const int radii[][2] = { { 6, 6 }, { 9, 3 }, { 3, 12 }, { 17, 0 }, { 0, 14 }, { 64, 64 } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(radii); ++i) {
+        for (int dilate = 0; dilate < 2; ++dilate) {
+            const int rx = radii[i][0], ry = radii[i][1];
+            SkAutoTUnref<SkImageFilter> filter(dilate
+                    ? static_cast<SkImageFilter*>(SkDilateImageFilter::Create(rx, ry))
+                    : static_cast<SkImageFilter*>(SkErodeImageFilter::Create(rx, ry)));
+            SkBitmap result;
+            SkIPoint offset;
+            REPORTER_ASSERT(reporter, filter->filterImage(&proxy, src, ctx, &result, &offset));
+            REPORTER_ASSERT(reporter, result.dimensions() == src.dimensions());
+            if (result.dimensions() != src.dimensions()) {
+                continue;
+            }
+            SkAutoLockPixels lock(result);
+            bool matches = true;
+            for (int y = 0; y < src.height(); ++y) {
+                for (int x = 0; x < src.width(); ++x) {
+                    matches &= *result.getAddr32(x, y) ==
+                               morph_reference(src, x, y, rx, ry, SkToBool(dilate));
+                }
+            }
+            REPORTER_ASSERT(reporter, matches);
+        }
+    }
+}
+
+// What a distant light's diffuse lighting gives an interior pixel, from its Sobel normal.
+static SkPMColor distant_diffuse_reference(const SkBitmap& src, int x, int y,
+                                           const SkPoint3& direction, SkColor color,
+                                           SkScalar surfaceScale, SkScalar kd) {
+    int a[3][3];
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) {
+            a[j][i] = SkGetPackedA32(*src.getAddr32(x + i - 1, y + j - 1));
+        }
+    }
+    int sobelX = a[0][2] - a[0][0] + 2 * (a[1][2] - a[1][0]) + a[2][2] - a[2][0];
+    int sobelY = a[2][0] - a[0][0] + 2 * (a[2][1] - a[0][1]) + a[2][2] - a[0][2];
+    SkScalar scale = surfaceScale / 255;
+    SkPoint3 normal(-SkIntToScalar(sobelX) * 0.25f * scale,
+                    -SkIntToScalar(sobelY) * 0.25f * scale, SK_Scalar1);
+    normal.normalize();
+    SkScalar colorScale = SkScalarClampMax(kd * normal.dot(direction), SK_Scalar1);
+    return SkPackARGB32(255,
+                        SkClampMax(SkScalarRoundToInt(SkColorGetR(color) * colorScale), 255),
+                        SkClampMax(SkScalarRoundToInt(SkColorGetG(color) * colorScale), 255),
+                        SkClampMax(SkScalarRoundToInt(SkColorGetB(color) * colorScale), 255));
+}
+
+DEF_TEST(ImageFilterLightingInterior, reporter) {
+    // The interior is lit several pixels at a time, so try widths that leave every remainder.
+    SkBitmap temp;
+    temp.allocN32Pixels(100, 100);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+
+    const SkPoint3 direction(0.6f, -0.48f, 0.64f);
+    const SkColor color = SkColorSetRGB(0xF0, 0xC0, 0x80);
+    const SkScalar surfaceScale = 3, kd = 1.5f;
+    SkAutoTUnref<SkImageFilter> filter(SkLightingImageFilter::CreateDistantLitDiffuse(
+            direction, color, surfaceScale, kd));
+
+    SkRandom rand;
+    const int widths[] = { 3, 4, 5, 6, 7, 10, 66, 71 };
+    for (size_t w = 0; w < SK_ARRAY_COUNT(widths); ++w) {
+        SkBitmap src;
+        src.allocN32Pixels(widths[w], 5);
+        for (int y = 0; y < src.height(); ++y) {
+            for (int x = 0; x < src.width(); ++x) {
+                *src.getAddr32(x, y) = SkPackARGB32(rand.nextU() & 0xFF, 0, 0, 0);
+            }
+        }
+
+        SkBitmap result;
+        SkIPoint offset;
+        REPORTER_ASSERT(reporter, filter->filterImage(&proxy, src, ctx, &result, &offset));
+        REPORTER_ASSERT(reporter, result.dimensions() == src.dimensions());
+        if (result.dimensions() != src.dimensions()) {
+            continue;
+        }
+        SkAutoLockPixels lock(result);
+        bool matches = true;
+        for (int y = 1; y < src.height() - 1; ++y) {
+            for (int x = 1; x < src.width() - 1; ++x) {
+                matches &= *result.getAddr32(x, y) ==
+                           distant_diffuse_reference(src, x, y, direction, color, surfaceScale,
+                                                     kd);
+            }
+        }
+        REPORTER_ASSERT(reporter, matches);
+    }
+}
+
+DEF_TEST(ImageFilterDAG, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(40, 40);
+    src.eraseColor(SK_ColorTRANSPARENT);
+    src.eraseArea(SkIRect::MakeXYWH(4, 4, 8, 8), 0x80FF0000);
+    src.eraseArea(SkIRect::MakeXYWH(20, 10, 6, 12), 0xFF00FF00);
+
+    SkBitmap temp;
+    temp.allocN32Pixels(100, 100);
+    SkBitmapDevice device(temp);
+    // Attaching the device locks its pixels, as happens whenever it's drawn to.
+    SkCanvas canvas(&device);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    REPORTER_ASSERT(reporter, proxy.isThreadSafe());
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(40, 40), NULL);
+
+    // An input connected several times is only filtered once, even without a cache.
+    SkAutoTUnref<CountingImageFilter> shared(SkNEW_ARGS(CountingImageFilter, (3)));
+    SkAutoTUnref<CountingImageFilter> other(SkNEW_ARGS(CountingImageFilter, (7)));
+    SkImageFilter* inputs[] = { shared, NULL, other, shared, shared };
+    SkAutoTUnref<SkImageFilter> merge(SkMergeImageFilter::Create(inputs,
+                                                                 SK_ARRAY_COUNT(inputs)));
+    SkBitmap result;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, merge->filterImage(&proxy, src, ctx, &result, &offset));
+    REPORTER_ASSERT(reporter, 1 == shared->count());
+    REPORTER_ASSERT(reporter, 1 == other->count());
+
+    // Independent inputs filtered in parallel give what filtering them one by one does.
+    SkAutoTUnref<SkImageFilter> blurs[4];
+    SkImageFilter* blurInputs[SK_ARRAY_COUNT(blurs)];
+    SkBitmap expected;
+    expected.allocN32Pixels(40, 40);
+    expected.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(expected);
+        for (size_t i = 0; i < SK_ARRAY_COUNT(blurs); ++i) {
+            const SkScalar sigma = SkIntToScalar(i + 1);
+            blurs[i].reset(SkBlurImageFilter::Create(sigma, sigma));
+            blurInputs[i] = blurs[i];
+            SkBitmap blurred;
+            SkIPoint blurOffset;
+            REPORTER_ASSERT(reporter, blurs[i]->filterImage(&proxy, src, ctx, &blurred,
+                                                            &blurOffset));
+            canvas.drawSprite(blurred, blurOffset.x(), blurOffset.y());
+        }
+    }
+    SkAutoTUnref<SkImageFilter> blurMerge(SkMergeImageFilter::Create(blurInputs,
+                                                                     SK_ARRAY_COUNT(blurs)));
+    REPORTER_ASSERT(reporter, blurMerge->filterImage(&proxy, src, ctx, &result, &offset));
+    REPORTER_ASSERT(reporter, 0 == offset.x() && 0 == offset.y());
+    REPORTER_ASSERT(reporter, result.dimensions() == expected.dimensions());
+    if (result.dimensions() == expected.dimensions()) {
+        SkAutoLockPixels resultLock(result), expectedLock(expected);
+        for (int y = 0; y < expected.height(); ++y) {
+            REPORTER_ASSERT(reporter, !memcmp(result.getAddr32(0, y), expected.getAddr32(0, y),
+                                              expected.width() * sizeof(SkPMColor)));
+        }
+    }
+}
+
 DEF_TEST(ImageFilterDrawTiled, reporter) {
     // Check that all filters when drawn tiled (with subsequent clip rects) exactly
     // match the same filters drawn with a single full-canvas bitmap draw.
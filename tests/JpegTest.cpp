@@ -6,9 +6,12 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkDecodingImageGenerator.h"
 #include "SkForceLinking.h"
 #include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
 #include "SkPixelRef.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
@@ -497,3 +500,48 @@ DEF_TEST(Jpeg_YUV, reporter) {
     // Get the YUV planes
     REPORTER_ASSERT(reporter, pixelRef->getYUV8Planes(yuvSizes, planes, rowBytes, NULL));
 }
+
+static SkData* encode_jpeg(const SkBitmap& bitmap, bool parallel) {
+    SkAutoTDelete<SkImageEncoder> encoder(SkImageEncoder::Create(SkImageEncoder::kJPEG_Type));
+    if (!encoder) {
+        return NULL;
+    }
+    encoder->setParallel(parallel);
+    return encoder->encodeData(bitmap, 90);
+}
+
+DEF_TEST(Jpeg_ParallelEncode, reporter) {
+    // Tall enough for several strips, the last one short, and not a whole number of MCUs wide.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(301, 700, true);
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x & 0xFF, y & 0xFF, (x * y) & 0xFF);
+        }
+    }
+
+    SkAutoTUnref<SkData> serial(encode_jpeg(bitmap, false));
+    SkAutoTUnref<SkData> parallel(encode_jpeg(bitmap, true));
+    REPORTER_ASSERT(reporter, serial && parallel);
+    if (!serial || !parallel) {
+        return;
+    }
+
+    // The strips are whole rows of MCUs, compressed just as the serial encode does, so only the
+    // restart markers differ, and the pixels decode the same.
+    REPORTER_ASSERT(reporter, !serial->equals(parallel));
+    SkBitmap serialBitmap, parallelBitmap;
+    REPORTER_ASSERT(reporter, SkImageDecoder::DecodeMemory(serial->data(), serial->size(),
+                                                           &serialBitmap));
+    REPORTER_ASSERT(reporter, SkImageDecoder::DecodeMemory(parallel->data(), parallel->size(),
+                                                           &parallelBitmap));
+    REPORTER_ASSERT(reporter, serialBitmap.dimensions() == bitmap.dimensions());
+    REPORTER_ASSERT(reporter, parallelBitmap.dimensions() == bitmap.dimensions());
+    if (serialBitmap.dimensions() != parallelBitmap.dimensions() ||
+            serialBitmap.colorType() != parallelBitmap.colorType()) {
+        return;
+    }
+    SkAutoLockPixels serialLock(serialBitmap), parallelLock(parallelBitmap);
+    REPORTER_ASSERT(reporter, 0 == memcmp(serialBitmap.getPixels(), parallelBitmap.getPixels(),
+                                          serialBitmap.getSize()));
+}
@@ -161,8 +161,97 @@ static void test_mixed(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, !context->next(&canvas, &paint));
 }
 
+class HaloDevice : public SkBitmapDevice {
+public:
+    HaloDevice(const SkBitmap& bm) : SkBitmapDevice(bm), fHaloCount(0) { }
+
+    void drawPosTextHalo(const SkDraw& draw, const void* text, size_t len,
+                         const SkScalar pos[], int scalarsPerPos, const SkPoint& offset,
+                         const SkPaint& haloPaint, const SkPaint& paint) override {
+        fHaloCount++;
+        fHaloPaint = haloPaint;
+        this->INHERITED::drawPosTextHalo(draw, text, len, pos, scalarsPerPos, offset,
+                                         haloPaint, paint);
+    }
+
+    int     fHaloCount;
+    SkPaint fHaloPaint;
+
+private:
+    typedef SkBitmapDevice INHERITED;
+};
+
+static SkDrawLooper* make_halo_looper(SkScalar radius, SkColor color, const SkVector& offset) {
+    SkLayerDrawLooper::Builder looperBuilder;
+    SkLayerDrawLooper::LayerInfo layerInfo;
+
+    // The halo, at the bottom.
+    layerInfo.fPaintBits = SkLayerDrawLooper::kStyle_Bit;
+    layerInfo.fColorMode = SkXfermode::kSrc_Mode;
+    layerInfo.fOffset = offset;
+    SkPaint* haloPaint = looperBuilder.addLayer(layerInfo);
+    haloPaint->setStyle(SkPaint::kStrokeAndFill_Style);
+    haloPaint->setStrokeWidth(2 * radius);
+    haloPaint->setStrokeJoin(SkPaint::kRound_Join);
+    haloPaint->setColor(color);
+
+    // The text itself, on top.
+    looperBuilder.addLayerOnTop(SkLayerDrawLooper::LayerInfo());
+    return looperBuilder.detachLooper();
+}
+
+static void test_halo(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkDrawLooper> looper(make_halo_looper(2, SK_ColorRED, SkVector::Make(0, 0)));
+    SkDrawLooper::HaloRec rec;
+    REPORTER_ASSERT(reporter, looper->asAHalo(&rec));
+    REPORTER_ASSERT(reporter, 2 == rec.fRadius);
+    REPORTER_ASSERT(reporter, SK_ColorRED == rec.fColor);
+
+    // A shifted layer is a drop shadow, not a halo.
+    SkAutoTUnref<SkDrawLooper> shadow(make_halo_looper(2, SK_ColorRED, SkVector::Make(1, 1)));
+    REPORTER_ASSERT(reporter, !shadow->asAHalo(NULL));
+
+    SkBitmap bm = make_bm(100, 40);
+    bm.eraseColor(SK_ColorWHITE);
+    HaloDevice device(bm);
+    SkCanvas canvas(&device);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(24);
+    paint.setColor(SK_ColorBLACK);
+    paint.setLooper(looper);
+    canvas.drawText("Halo", 4, 10, 30, paint);
+
+    // The device gets the halo and the text together, with the halo paint the looper would
+    // have drawn with.
+    REPORTER_ASSERT(reporter, 1 == device.fHaloCount);
+    REPORTER_ASSERT(reporter, SK_ColorRED == device.fHaloPaint.getColor());
+    REPORTER_ASSERT(reporter, SkPaint::kStrokeAndFill_Style == device.fHaloPaint.getStyle());
+    REPORTER_ASSERT(reporter, 4 == device.fHaloPaint.getStrokeWidth());
+
+    bool sawHalo = false;
+    for (int y = 0; y < bm.height() && !sawHalo; ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            SkColor c = bm.getColor(x, y);
+            if (SkColorGetR(c) > SkColorGetG(c) + 64) {
+                sawHalo = true;
+                break;
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, sawHalo);
+
+    // Other loopers still draw pass by pass.
+    const SkScalar xpos[] = { 10, 25, 40, 55 };
+    paint.setLooper(shadow);
+    canvas.drawPosTextH("Halo", 4, xpos, 30, paint);
+    REPORTER_ASSERT(reporter, 1 == device.fHaloCount);
+}
+
 DEF_TEST(LayerDrawLooper, reporter) {
     test_frontToBack(reporter);
     test_backToFront(reporter);
     test_mixed(reporter);
+    test_halo(reporter);
 }
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMallocStats.h"
+#include "Test.h"
+
+// Other tests may allocate on other threads while this runs, so counts are only bounded below.
+DEF_TEST(MallocStats, reporter) {
+    REPORTER_ASSERT(reporter, !SkMallocStats::IsEnabled());
+
+    // Nothing is counted while disabled.
+    SkMallocStats::Reset();
+    sk_free(sk_malloc_throw(1000));
+    REPORTER_ASSERT(reporter, 0 == SkMallocStats::Count());
+    REPORTER_ASSERT(reporter, 0 == SkMallocStats::Bytes());
+
+    SkMallocStats::SetEnabled(true);
+    SkMallocStats::Reset();
+    void* p = sk_malloc_throw(1000);
+    void* q = sk_calloc_throw(2000);
+    REPORTER_ASSERT(reporter, SkMallocStats::Count() >= 2);
+    REPORTER_ASSERT(reporter, SkMallocStats::Bytes() >= 3000);
+    p = sk_realloc_throw(p, 4000);
+    REPORTER_ASSERT(reporter, SkMallocStats::Count() >= 3);
+    REPORTER_ASSERT(reporter, SkMallocStats::Bytes() >= 7000);
+    sk_free(p);
+    sk_free(q);
+    REPORTER_ASSERT(reporter, SkMallocStats::PeakDelta() >= 6000);
+    SkMallocStats::SetEnabled(false);
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMaskGamma.h"
+#include "SkScalerContext.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+static bool lut_matches(SkScalar contrast, SkScalar paintGamma, SkScalar deviceGamma) {
+    int width, height;
+    size_t size = SkScalerContext::GetGammaLUTSize(contrast, paintGamma, deviceGamma,
+                                                   &width, &height);
+    SkAutoTMalloc<uint8_t> data(size);
+    SkScalerContext::GetGammaLUTData(contrast, paintGamma, deviceGamma, data.get());
+
+    SkAutoTUnref<SkMaskGamma> expected(SkNEW_ARGS(SkMaskGamma,
+                                                  (contrast, paintGamma, deviceGamma)));
+    return 0 == memcmp(data.get(), expected->getGammaTables(), size);
+}
+
+struct LutCheck {
+    SkScalar fContrast;
+    bool     fMatches;
+};
+
+static void check_lut(LutCheck* check) {
+    check->fMatches = lut_matches(check->fContrast, SK_GAMMA_EXPONENT, SK_GAMMA_EXPONENT);
+}
+
+// Common gamma parameters come from shared, lock-free tables and the rest from a locked cache;
+// either way the tables must be the ones SkMaskGamma builds.
+DEF_TEST(MaskGamma_SharedTables, reporter) {
+    // How the default parameters arrive from a glyph cache's rec.
+    SkScalerContext::Rec rec;
+    rec.setContrast(0.5f);
+    rec.setPaintGamma(SK_GAMMA_EXPONENT);
+    rec.setDeviceGamma(SK_GAMMA_EXPONENT);
+    REPORTER_ASSERT(reporter,
+                    lut_matches(rec.getContrast(), rec.getPaintGamma(), rec.getDeviceGamma()));
+
+    // Exactly as given, and something uncommon.
+    REPORTER_ASSERT(reporter, lut_matches(0.5f, SK_GAMMA_EXPONENT, SK_GAMMA_EXPONENT));
+    REPORTER_ASSERT(reporter, lut_matches(0.25f, 1.8f, 2.0f));
+
+    // Linear parameters mean no pre-blend at all.
+    rec.setContrast(0);
+    rec.setPaintGamma(SK_Scalar1);
+    rec.setDeviceGamma(SK_Scalar1);
+    rec.setLuminanceColor(SK_ColorWHITE);
+    REPORTER_ASSERT(reporter, !SkScalerContext::GetMaskPreBlend(rec).isApplicable());
+
+    // Threads asking for common and uncommon parameters at once all get the right tables.
+    LutCheck checks[16];
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(checks); ++i) {
+        checks[i].fContrast = (i & 1) ? 0.5f : 0.125f * (i >> 1);
+        checks[i].fMatches = false;
+    }
+    SkTaskGroup tg;
+    tg.batch(check_lut, checks, SK_ARRAY_COUNT(checks));
+    tg.wait();
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(checks); ++i) {
+        REPORTER_ASSERT(reporter, checks[i].fMatches);
+    }
+}
@@ -933,3 +933,55 @@ DEF_TEST(Matrix_Concat, r) {
 
     REPORTER_ASSERT(r, expected == SkMatrix::Concat(a, b));
 }
+
+// The affine procs sum their terms in a different order than mapXY(), so allow for rounding.
+// Points sent to (or near) infinity only need to agree that they're not finite.
+static bool nearly_equal(const SkPoint& a, const SkPoint& b) {
+    if (!a.isFinite() || !b.isFinite()) {
+        return a.isFinite() == b.isFinite();
+    }
+    return SkScalarNearlyEqual(a.fX, b.fX, SkScalarAbs(a.fX) * 1e-6f + 1e-6f) &&
+           SkScalarNearlyEqual(a.fY, b.fY, SkScalarAbs(a.fY) * 1e-6f + 1e-6f);
+}
+
+// mapPoints() maps runs of points together, and should agree with mapXY() on each one.
+DEF_TEST(Matrix_MapPoints, r) {
+    SkMatrix matrices[4];
+    matrices[0].setScale(2, -3, 4, 5);
+    matrices[1].setRotate(30, 7, 8);
+    matrices[2].setPerspX(SK_Scalar1 / 100);
+    matrices[2].postRotate(20);
+    matrices[3].setPerspY(-SK_Scalar1 / 50);
+    matrices[3].postTranslate(10, 20);
+
+    SkRandom rand;
+    const int N = 37;
+    SkPoint src[N], dst[N];
+    for (int i = 0; i < N; ++i) {
+        src[i].set(rand.nextRangeF(-100, 100), rand.nextRangeF(-100, 100));
+    }
+    // This point sends z to 0 under matrices[2], which leaves it at the origin.
+    src[5].set(-100, 0);
+    SkRect srcRects[N / 2], dstRects[N / 2];
+    for (int i = 0; i < N / 2; ++i) {
+        srcRects[i].set(src[2 * i], src[2 * i + 1]);
+    }
+
+    for (size_t m = 0; m < SK_ARRAY_COUNT(matrices); ++m) {
+        const SkMatrix& matrix = matrices[m];
+        matrix.mapPoints(dst, src, N);
+        for (int i = 0; i < N; ++i) {
+            SkPoint expected;
+            matrix.mapXY(src[i].fX, src[i].fY, &expected);
+            REPORTER_ASSERT(r, nearly_equal(expected, dst[i]));
+        }
+
+        bool stays = matrix.mapRects(dstRects, srcRects, N / 2);
+        REPORTER_ASSERT(r, stays == matrix.rectStaysRect());
+        for (int i = 0; i < N / 2; ++i) {
+            SkRect expected;
+            matrix.mapRect(&expected, srcRects[i]);
+            REPORTER_ASSERT(r, expected == dstRects[i]);
+        }
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkMessageBus.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 
 struct TestMessage {
@@ -14,6 +15,55 @@ struct TestMessage {
 };
 DECLARE_SKMESSAGEBUS_MESSAGE(TestMessage)
 
+namespace {
+
+struct PostArgs {
+    int fThread;
+};
+
+void post_from_thread(PostArgs* args) {
+    for (int i = 0; i < 1000; i++) {
+        const TestMessage m = { args->fThread, SkIntToScalar(i) };
+        SkMessageBus<TestMessage>::Post(m);
+    }
+}
+
+}  // namespace
+
+// Tests can run concurrently, and every TestMessage inbox sees every TestMessage, so this runs
+// as part of the MessageBus test below rather than as a test of its own.
+static void test_threaded(skiatest::Reporter* r) {
+    SkMessageBus<TestMessage>::Inbox inbox;
+
+    PostArgs args[8];
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(args); i++) {
+        args[i].fThread = i;
+    }
+    SkTArray<TestMessage> messages;
+    int received = 0;
+    {
+        SkTaskGroup tg;
+        tg.batch(post_from_thread, args, SK_ARRAY_COUNT(args));
+        // Poll while the posts are still coming in.
+        inbox.poll(&messages);
+        received += messages.count();
+        tg.wait();
+    }
+    inbox.poll(&messages);
+    received += messages.count();
+    REPORTER_ASSERT(r, 8000 == received);
+
+    // Each thread's messages arrive in the order it posted them.
+    float last[8];
+    for (int i = 0; i < 8; i++) {
+        last[i] = -1;
+    }
+    for (int i = 0; i < messages.count(); i++) {
+        REPORTER_ASSERT(r, messages[i].y > last[messages[i].x]);
+        last[messages[i].x] = messages[i].y;
+    }
+}
+
 DEF_TEST(MessageBus, r) {
     // Register two inboxes to receive all TestMessages.
     SkMessageBus<TestMessage>::Inbox inbox1, inbox2;
@@ -48,6 +98,18 @@ DEF_TEST(MessageBus, r) {
     REPORTER_ASSERT(r, 5 == messages[0].x);
     REPORTER_ASSERT(r, 6 == messages[1].x);
     REPORTER_ASSERT(r, 1 == messages[2].x);
-}
 
-// Multithreaded tests tbd.
+    // A batch arrives in order, after anything posted before it.
+    const TestMessage batch[] = { { 7, 0.1f }, { 8, 0.2f }, { 9, 0.3f } };
+    SkMessageBus<TestMessage>::Post(m3);
+    SkMessageBus<TestMessage>::PostMany(batch, SK_ARRAY_COUNT(batch));
+    SkMessageBus<TestMessage>::PostMany(batch, 0);
+    inbox1.poll(&messages);
+    REPORTER_ASSERT(r, 4 == messages.count());
+    REPORTER_ASSERT(r, 1 == messages[0].x);
+    REPORTER_ASSERT(r, 7 == messages[1].x);
+    REPORTER_ASSERT(r, 8 == messages[2].x);
+    REPORTER_ASSERT(r, 9 == messages[3].x);
+
+    test_threaded(r);
+}
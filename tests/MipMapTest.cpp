@@ -6,6 +6,7 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
 #include "SkMipMap.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -53,3 +54,172 @@ DEF_TEST(MipMap, reporter) {
         }
     }
 }
+
+static void make_noise(SkBitmap* bm, SkColorType ct, int w, int h, SkRandom& rand) {
+    const SkAlphaType at = kRGB_565_SkColorType == ct ? kOpaque_SkAlphaType
+                                                      : kPremul_SkAlphaType;
+    bm->allocPixels(SkImageInfo::Make(w, h, ct, at));
+    for (int y = 0; y < h; ++y) {
+        uint8_t* row = (uint8_t*)bm->getAddr(0, y);
+        for (size_t i = 0; i < bm->info().minRowBytes(); ++i) {
+            row[i] = rand.nextU() & 0xFF;
+        }
+    }
+}
+
+// The average of the 2x2 block of src at (2x, 2y), truncating each channel.
+static uint32_t reference_average(const SkBitmap& src, int x, int y) {
+    x *= 2;
+    y *= 2;
+    switch (src.colorType()) {
+        case kN32_SkColorType: {
+            uint32_t result = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                const unsigned sum = ((*src.getAddr32(x, y) >> shift) & 0xFF) +
+                                     ((*src.getAddr32(x + 1, y) >> shift) & 0xFF) +
+                                     ((*src.getAddr32(x, y + 1) >> shift) & 0xFF) +
+                                     ((*src.getAddr32(x + 1, y + 1) >> shift) & 0xFF);
+                result |= (sum >> 2) << shift;
+            }
+            return result;
+        }
+        case kRGB_565_SkColorType: {
+            const uint16_t p[] = { *src.getAddr16(x, y), *src.getAddr16(x + 1, y),
+                                   *src.getAddr16(x, y + 1), *src.getAddr16(x + 1, y + 1) };
+            unsigned r = 0, g = 0, b = 0;
+            for (int i = 0; i < 4; ++i) {
+                r += SkGetPackedR16(p[i]);
+                g += SkGetPackedG16(p[i]);
+                b += SkGetPackedB16(p[i]);
+            }
+            return SkPackRGB16(r >> 2, g >> 2, b >> 2);
+        }
+        case kAlpha_8_SkColorType:
+            return (*src.getAddr8(x, y) + *src.getAddr8(x + 1, y) +
+                    *src.getAddr8(x, y + 1) + *src.getAddr8(x + 1, y + 1)) >> 2;
+        default:
+            SkASSERT(false);
+            return 0;
+    }
+}
+
+static uint32_t get_pixel(const SkMipMap::Level& level, SkColorType ct, int x, int y) {
+    const char* row = (const char*)level.fPixels + level.fRowBytes * y;
+    switch (ct) {
+        case kN32_SkColorType:
+            return ((const uint32_t*)row)[x];
+        case kRGB_565_SkColorType:
+            return ((const uint16_t*)row)[x];
+        default:
+            return ((const uint8_t*)row)[x];
+    }
+}
+
+// Whatever procs (and however many threads) built each level, it matches the portable math.
+DEF_TEST(MipMap_Downsample, reporter) {
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGB_565_SkColorType, kAlpha_8_SkColorType
+    };
+    // Odd and even sizes, narrower and wider than the SIMD procs' chunks, and one big enough to
+    // be built in bands.
+    const SkISize sizes[] = {
+        SkISize::Make(2, 2), SkISize::Make(7, 3), SkISize::Make(37, 61),
+        SkISize::Make(64, 64), SkISize::Make(1031, 1029),
+    };
+    SkRandom rand;
+    for (size_t c = 0; c < SK_ARRAY_COUNT(colorTypes); ++c) {
+        for (size_t s = 0; s < SK_ARRAY_COUNT(sizes); ++s) {
+            SkBitmap bm;
+            make_noise(&bm, colorTypes[c], sizes[s].width(), sizes[s].height(), rand);
+            SkAutoTUnref<SkMipMap> mm(SkMipMap::Build(bm, NULL));
+            REPORTER_ASSERT(reporter, mm);
+            if (!mm) {
+                continue;
+            }
+
+            SkBitmap src(bm);
+            src.lockPixels();
+            for (SkScalar scale = SK_ScalarHalf; ; scale /= 2) {
+                SkMipMap::Level level;
+                if (!mm->extractLevel(scale, &level) ||
+                    (int)level.fWidth != src.width() / 2 || (int)level.fHeight != src.height() / 2) {
+                    break;
+                }
+                bool matches = true;
+                for (int y = 0; y < (int)level.fHeight && matches; ++y) {
+                    for (int x = 0; x < (int)level.fWidth && matches; ++x) {
+                        matches = reference_average(src, x, y) ==
+                                  get_pixel(level, colorTypes[c], x, y);
+                    }
+                }
+                REPORTER_ASSERT(reporter, matches);
+
+                src.installPixels(SkImageInfo::Make(level.fWidth, level.fHeight, colorTypes[c],
+                                                    bm.alphaType()),
+                                  level.fPixels, level.fRowBytes);
+            }
+        }
+    }
+}
+
+DEF_TEST(MipMap_GammaCorrect, reporter) {
+    // Black and white average to middle gray in linear space, which is 188 or so in sRGB.
+    SkBitmap checker;
+    checker.allocN32Pixels(16, 16, true);
+    for (int y = 0; y < checker.height(); ++y) {
+        for (int x = 0; x < checker.width(); ++x) {
+            *checker.getAddr32(x, y) = (x + y) & 1 ? SK_ColorWHITE : SK_ColorBLACK;
+        }
+    }
+
+    SkMipMap::Level level;
+    SkAutoTUnref<SkMipMap> plain(SkMipMap::Build(checker, NULL));
+    REPORTER_ASSERT(reporter, plain && plain->extractLevel(SK_ScalarHalf, &level));
+    if (plain) {
+        REPORTER_ASSERT(reporter, 127 == SkGetPackedR32(*(const SkPMColor*)level.fPixels));
+    }
+
+    SkAutoTUnref<SkMipMap> gamma(SkMipMap::Build(checker, NULL, true));
+    REPORTER_ASSERT(reporter, gamma && gamma->extractLevel(SK_ScalarHalf, &level));
+    if (gamma) {
+        for (uint32_t y = 0; y < level.fHeight; ++y) {
+            const SkPMColor* row = (const SkPMColor*)((const char*)level.fPixels +
+                                                      level.fRowBytes * y);
+            for (uint32_t x = 0; x < level.fWidth; ++x) {
+                REPORTER_ASSERT(reporter, 0xFF == SkGetPackedA32(row[x]));
+                REPORTER_ASSERT(reporter, SkTAbs((int)SkGetPackedR32(row[x]) - 188) <= 1);
+                REPORTER_ASSERT(reporter, SkGetPackedR32(row[x]) == SkGetPackedG32(row[x]));
+                REPORTER_ASSERT(reporter, SkGetPackedR32(row[x]) == SkGetPackedB32(row[x]));
+            }
+        }
+    }
+
+    // Translucent pixels stay premultiplied, and transparent ones stay transparent.
+    SkRandom rand;
+    SkBitmap noise;
+    noise.allocN32Pixels(33, 17);
+    for (int y = 0; y < noise.height(); ++y) {
+        for (int x = 0; x < noise.width(); ++x) {
+            const U8CPU a = x < 4 ? 0 : rand.nextU() & 0xFF;
+            *noise.getAddr32(x, y) = SkPreMultiplyARGB(a, rand.nextU() & 0xFF,
+                                                       rand.nextU() & 0xFF, rand.nextU() & 0xFF);
+        }
+    }
+    SkAutoTUnref<SkMipMap> translucent(SkMipMap::Build(noise, NULL, true));
+    REPORTER_ASSERT(reporter, translucent && translucent->extractLevel(SK_ScalarHalf, &level));
+    if (translucent) {
+        for (uint32_t y = 0; y < level.fHeight; ++y) {
+            const SkPMColor* row = (const SkPMColor*)((const char*)level.fPixels +
+                                                      level.fRowBytes * y);
+            for (uint32_t x = 0; x < level.fWidth; ++x) {
+                const unsigned a = SkGetPackedA32(row[x]);
+                REPORTER_ASSERT(reporter, SkGetPackedR32(row[x]) <= a);
+                REPORTER_ASSERT(reporter, SkGetPackedG32(row[x]) <= a);
+                REPORTER_ASSERT(reporter, SkGetPackedB32(row[x]) <= a);
+                if (x < 2) {
+                    REPORTER_ASSERT(reporter, 0 == row[x]);
+                }
+            }
+        }
+    }
+}
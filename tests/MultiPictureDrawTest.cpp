@@ -0,0 +1,58 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkMultiPictureDraw.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "Test.h"
+
+static SkPicture* make_fill(SkColor color) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(10, 10);
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    return recorder.endRecording();
+}
+
+// Raster draws into different targets run concurrently, but draws into the same pixels must
+// still happen in the order they were added.
+DEF_TEST(MultiPictureDraw_Raster, r) {
+    static const SkColor kColors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    SkAutoTUnref<SkPicture> pictures[SK_ARRAY_COUNT(kColors)];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kColors); ++i) {
+        pictures[i].reset(make_fill(kColors[i]));
+    }
+
+    static const int kTargets = 8;
+    SkBitmap bitmaps[kTargets];
+    SkAutoTUnref<SkCanvas> canvases[kTargets];
+    for (int i = 0; i < kTargets; ++i) {
+        bitmaps[i].allocN32Pixels(10, 10);
+        bitmaps[i].eraseColor(SK_ColorWHITE);
+        canvases[i].reset(SkNEW_ARGS(SkCanvas, (bitmaps[i])));
+    }
+    // A second canvas on the first bitmap.
+    SkAutoTUnref<SkCanvas> alias(SkNEW_ARGS(SkCanvas, (bitmaps[0])));
+
+    SkMultiPictureDraw mpd;
+    for (int i = 0; i < kTargets; ++i) {
+        // Each target ends with a different color.
+        for (int j = 0; j <= i % 3; ++j) {
+            mpd.add(canvases[i], pictures[j]);
+        }
+    }
+    mpd.add(alias, pictures[2]);
+    mpd.add(canvases[0], pictures[1]);
+    mpd.draw();
+
+    REPORTER_ASSERT(r, SK_ColorGREEN == bitmaps[0].getColor(5, 5));
+    for (int i = 1; i < kTargets; ++i) {
+        REPORTER_ASSERT(r, kColors[i % 3] == bitmaps[i].getColor(5, 5));
+    }
+}
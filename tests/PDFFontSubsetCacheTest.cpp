@@ -0,0 +1,44 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkPDFFontSubsetCache.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+DEF_TEST(PDFFontSubsetCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    const uint32_t fontID = 42;
+    SkTDArray<uint32_t> glyphs;
+    glyphs.push(3);
+    glyphs.push(36);
+    glyphs.push(1000);
+
+    SkAutoDataUnref subset(SkData::NewWithCString("subset font"));
+    REPORTER_ASSERT(reporter, NULL == SkPDFFontSubsetCache::FindAndRef(fontID, glyphs, &cache));
+    SkPDFFontSubsetCache::Add(fontID, glyphs, subset.get(), &cache);
+
+    SkAutoDataUnref found(SkPDFFontSubsetCache::FindAndRef(fontID, glyphs, &cache));
+    REPORTER_ASSERT(reporter, found.get() == subset.get());
+
+    // Another font, or any other glyphs, is another subset.
+    REPORTER_ASSERT(reporter, NULL == SkPDFFontSubsetCache::FindAndRef(fontID + 1, glyphs,
+                                                                       &cache));
+    SkTDArray<uint32_t> fewer;
+    fewer.append(2, glyphs.begin());
+    REPORTER_ASSERT(reporter, NULL == SkPDFFontSubsetCache::FindAndRef(fontID, fewer, &cache));
+    SkTDArray<uint32_t> other;
+    other.append(glyphs.count(), glyphs.begin());
+    other[2] = 1001;
+    REPORTER_ASSERT(reporter, NULL == SkPDFFontSubsetCache::FindAndRef(fontID, other, &cache));
+    SkTDArray<uint32_t> none;
+    REPORTER_ASSERT(reporter, NULL == SkPDFFontSubsetCache::FindAndRef(fontID, none, &cache));
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, NULL == SkPDFFontSubsetCache::FindAndRef(fontID, glyphs, &cache));
+}
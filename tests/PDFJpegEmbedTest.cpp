@@ -81,8 +81,7 @@ DEF_TEST(PDFJpegEmbedTest, r) {
     SkASSERT(pdfData);
     pdf.reset();
 
-    // Test disabled, waiting on resolution to http://skbug.com/3180
-    // REPORTER_ASSERT(r, is_subset_of(mandrillData, pdfData));
+    REPORTER_ASSERT(r, is_subset_of(mandrillData, pdfData));
 
     // This JPEG uses a nonstandard colorspace - it can not be
     // embedded into the PDF directly.
@@ -97,3 +96,40 @@ DEF_TEST(PDFJpegEmbedTest, r) {
         }
     }
 }
+
+static SkData* draw_to_pdf(const SkBitmap& bitmap, const SkIRect* src) {
+    SkDynamicMemoryWStream pdf;
+    SkAutoTUnref<SkDocument> document(SkDocument::CreatePDF(&pdf));
+    SkCanvas* canvas = document->beginPage(512, 512);
+    if (src) {
+        SkBitmap subset;
+        SkAssertResult(bitmap.extractSubset(&subset, *src));
+        canvas->drawBitmap(subset, 0, 0, NULL);
+    } else {
+        canvas->drawBitmap(bitmap, 0, 0, NULL);
+    }
+    document->endPage();
+    document->close();
+    return pdf.copyToData();
+}
+
+/**
+ *  Test that grayscale JFIF files are embedded as is, and that a subset
+ *  of a JPEG is not.
+ */
+DEF_TEST(PDFJpegEmbedGrayAndSubset, r) {
+    const char test[] = "PDFJpegEmbedGrayAndSubset";
+    SkAutoTUnref<SkData> grayData(load_resource(r, test, "grayscale.jpg"));
+    SkAutoTUnref<SkData> mandrillData(
+            load_resource(r, test, "mandrill_512_q075.jpg"));
+    if (!grayData || !mandrillData) {
+        return;
+    }
+
+    SkAutoTUnref<SkData> pdfData(draw_to_pdf(bitmap_from_data(grayData), NULL));
+    REPORTER_ASSERT(r, is_subset_of(grayData, pdfData));
+
+    SkIRect src = SkIRect::MakeXYWH(10, 10, 100, 100);
+    pdfData.reset(draw_to_pdf(bitmap_from_data(mandrillData), &src));
+    REPORTER_ASSERT(r, !is_subset_of(mandrillData, pdfData));
+}
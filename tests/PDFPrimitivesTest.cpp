@@ -10,12 +10,14 @@
 #include "SkData.h"
 #include "SkDocument.h"
 #include "SkFlate.h"
+#include "SkGradientShader.h"
 #include "SkImageEncoder.h"
 #include "SkMatrix.h"
 #include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
+#include "SkPictureRecorder.h"
 #include "SkReadBuffer.h"
 #include "SkScalar.h"
 #include "SkStream.h"
@@ -138,6 +140,14 @@ static void TestPDFStream(skiatest::Reporter* reporter) {
         CheckObjectOutput(reporter, stream.get(),
                           (const char*) expectedResultData2->data(),
                           expectedResultData2->size(), true);
+
+        // Compressing ahead of time gives the same output.
+        SkAutoTUnref<SkPDFStream> precompressed(
+                new SkPDFStream(streamData2.get()));
+        precompressed->compress();
+        CheckObjectOutput(reporter, precompressed.get(),
+                          (const char*) expectedResultData2->data(),
+                          expectedResultData2->size(), true);
     }
 }
 
@@ -351,3 +361,124 @@ DEF_TEST(PDFImageFilter, reporter) {
     // Filter was used in rendering; should be visited.
     REPORTER_ASSERT(reporter, filter->visited());
 }
+
+static int count_forms(SkPicture* picture, int pages, const SkPaint* paint) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
+    for (int i = 0; i < pages; i++) {
+        SkCanvas* canvas = doc->beginPage(100.0f, 100.0f);
+        canvas->translate(SkIntToScalar(i), 0);
+        canvas->drawPicture(picture, NULL, paint);
+        doc->endPage();
+    }
+    doc->close();
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    static const char kForm[] = "/Subtype /Form";
+    const size_t length = strlen(kForm);
+    int count = 0;
+    for (size_t i = 0; i + length <= pdf->size(); i++) {
+        if (0 == memcmp(pdf->bytes() + i, kForm, length)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Check that a picture drawn on many pages is written once, as a form XObject.
+DEF_TEST(PDFPictureForm, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* recording = recorder.beginRecording(50, 50);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    recording->drawRect(SkRect::MakeXYWH(10, 10, 30, 30), paint);
+    recording->drawText("legend", 6, 5, 45, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    REPORTER_ASSERT(reporter, 1 == count_forms(picture, 5, NULL));
+
+    // A picture that clears what is under it is only a form in a layer.
+    recording = recorder.beginRecording(50, 50);
+    paint.setXfermodeMode(SkXfermode::kClear_Mode);
+    recording->drawRect(SkRect::MakeXYWH(10, 10, 30, 30), paint);
+    SkAutoTUnref<SkPicture> clearing(recorder.endRecording());
+
+    REPORTER_ASSERT(reporter, 0 == count_forms(clearing, 2, NULL));
+    SkPaint alpha;
+    alpha.setAlpha(0x80);
+    REPORTER_ASSERT(reporter, 1 == count_forms(clearing, 2, &alpha));
+}
+
+static int count_occurrences(const SkData* data, const char* str) {
+    const size_t length = strlen(str);
+    int count = 0;
+    for (size_t i = 0; i + length <= data->size(); i++) {
+        if (0 == memcmp(data->bytes() + i, str, length)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static SkData* draw_thumbnails(const SkBitmap& bitmap, SkScalar maxImageDpi) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream, SK_ScalarDefaultRasterDPI,
+                                                       maxImageDpi));
+    for (int i = 0; i < 2; i++) {
+        SkCanvas* canvas = doc->beginPage(200, 200);
+        // One inch square.
+        SkRect dst = SkRect::MakeXYWH(10, 10, 72, 72);
+        canvas->drawBitmapRect(bitmap, dst);
+        doc->endPage();
+    }
+    doc->close();
+    return stream.copyToData();
+}
+
+// Check that bitmaps drawn small are embedded at no more than the maximum DPI.
+DEF_TEST(PDFDownsampleBitmaps, reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(600, 600);
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, (x * y) & 0xFF, x & 0xFF, y & 0xFF);
+        }
+    }
+    bitmap.setImmutable();
+
+    SkAutoTUnref<SkData> full(draw_thumbnails(bitmap, 0));
+    REPORTER_ASSERT(reporter, 1 == count_occurrences(full, "/Width 600"));
+
+    SkAutoTUnref<SkData> downsampled(draw_thumbnails(bitmap, 144));
+    REPORTER_ASSERT(reporter, 0 == count_occurrences(downsampled, "/Width 600"));
+    // Both pages share one resampled image.
+    REPORTER_ASSERT(reporter, 1 == count_occurrences(downsampled, "/Width 144"));
+    REPORTER_ASSERT(reporter, downsampled->size() < full->size() / 4);
+
+    // Bitmaps already under the limit are left alone.
+    SkAutoTUnref<SkData> unchanged(draw_thumbnails(bitmap, 1200));
+    REPORTER_ASSERT(reporter, 1 == count_occurrences(unchanged, "/Width 600"));
+}
+
+// Check that one gradient drawn in several places shares its PostScript function.
+DEF_TEST(PDFSharedGradientFunction, reporter) {
+    const SkPoint points[2] = { SkPoint::Make(0, 0), SkPoint::Make(40, 0) };
+    const SkColor colors[2] = { SK_ColorRED, SK_ColorBLUE };
+    SkAutoTUnref<SkShader> shader(SkGradientShader::CreateLinear(
+            points, colors, NULL, 2, SkShader::kClamp_TileMode));
+    SkPaint paint;
+    paint.setShader(shader);
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
+    for (int i = 0; i < 3; i++) {
+        SkCanvas* canvas = doc->beginPage(200, 200);
+        canvas->translate(SkIntToScalar(10 * i), SkIntToScalar(20 * i));
+        canvas->drawRect(SkRect::MakeWH(40, 40), paint);
+        canvas->drawRect(SkRect::MakeXYWH(50, 50, 40, 40), paint);
+        doc->endPage();
+    }
+    doc->close();
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    REPORTER_ASSERT(reporter, count_occurrences(pdf, "/ShadingType 1") > 1);
+    REPORTER_ASSERT(reporter, 1 == count_occurrences(pdf, "/FunctionType 4"));
+}
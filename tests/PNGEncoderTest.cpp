@@ -0,0 +1,169 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkImageDecoder.h"
+#include "SkImageEncoder.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// A few colors, opaque and fully transparent, so they survive the round trip through the
+// unpremultiplied PNG exactly.
+static void make_tile(SkBitmap* bm) {
+    static const SkPMColor gColors[] = {
+        SkPackARGB32(0xFF, 0xF2, 0xEF, 0xE9),
+        SkPackARGB32(0xFF, 0xAA, 0xD3, 0xDF),
+        SkPackARGB32(0xFF, 0x00, 0x00, 0x00),
+        0,
+    };
+    bm->allocN32Pixels(64, 48);
+    for (int y = 0; y < bm->height(); y++) {
+        for (int x = 0; x < bm->width(); x++) {
+            *bm->getAddr32(x, y) = gColors[(x / 5 + y / 7) % SK_ARRAY_COUNT(gColors)];
+        }
+    }
+}
+
+static void make_noise(SkBitmap* bm, int width = 64, int height = 48) {
+    bm->allocN32Pixels(width, height, true);
+    SkRandom rand;
+    for (int y = 0; y < bm->height(); y++) {
+        for (int x = 0; x < bm->width(); x++) {
+            *bm->getAddr32(x, y) = rand.nextU() | SkPackARGB32(0xFF, 0, 0, 0);
+        }
+    }
+}
+
+static SkData* encode(const SkBitmap& bm, int zlibLevel, SkImageEncoder::PNGFilter filter,
+                      bool palettize, bool parallel = false) {
+    SkAutoTDelete<SkImageEncoder> encoder(SkImageEncoder::Create(SkImageEncoder::kPNG_Type));
+    if (!encoder) {
+        return NULL;
+    }
+    encoder->setZLibLevel(zlibLevel);
+    encoder->setPNGFilter(filter);
+    encoder->setPalettize(palettize);
+    encoder->setParallel(parallel);
+    return encoder->encodeData(bm, SkImageEncoder::kDefaultQuality);
+}
+
+static void check_round_trip(skiatest::Reporter* r, const SkBitmap& bm, SkData* encoded) {
+    REPORTER_ASSERT(r, encoded);
+    if (!encoded) {
+        return;
+    }
+    SkBitmap decoded;
+    REPORTER_ASSERT(r, SkImageDecoder::DecodeMemory(encoded->data(), encoded->size(), &decoded,
+                                                    kN32_SkColorType,
+                                                    SkImageDecoder::kDecodePixels_Mode));
+    // Palette PNGs may decode to kIndex_8.
+    if (kN32_SkColorType != decoded.colorType()) {
+        SkBitmap copy;
+        REPORTER_ASSERT(r, decoded.copyTo(&copy, kN32_SkColorType));
+        decoded.swap(copy);
+    }
+    REPORTER_ASSERT(r, kN32_SkColorType == decoded.colorType());
+    REPORTER_ASSERT(r, decoded.dimensions() == bm.dimensions());
+    if (kN32_SkColorType != decoded.colorType() || decoded.dimensions() != bm.dimensions()) {
+        return;
+    }
+    SkAutoLockPixels alp(decoded);
+    for (int y = 0; y < bm.height(); y++) {
+        REPORTER_ASSERT(r, 0 == memcmp(bm.getAddr32(0, y), decoded.getAddr32(0, y),
+                                       bm.width() * sizeof(SkPMColor)));
+    }
+}
+
+DEF_TEST(PNGEncoder_Options, r) {
+    SkBitmap tile, noise;
+    make_tile(&tile);
+    make_noise(&noise);
+
+    // Every setting is lossless.
+    const SkImageEncoder::PNGFilter filters[] = {
+        SkImageEncoder::kDefault_PNGFilter,
+        SkImageEncoder::kNone_PNGFilter,
+        SkImageEncoder::kSub_PNGFilter,
+        SkImageEncoder::kUp_PNGFilter,
+        SkImageEncoder::kAdaptive_PNGFilter,
+    };
+    const int levels[] = { SkImageEncoder::kDefault_ZLibLevel, 0, 1, 9 };
+    for (size_t f = 0; f < SK_ARRAY_COUNT(filters); f++) {
+        for (size_t l = 0; l < SK_ARRAY_COUNT(levels); l++) {
+            for (int palettize = 0; palettize < 2; palettize++) {
+                SkAutoTUnref<SkData> encodedTile(encode(tile, levels[l], filters[f],
+                                                        SkToBool(palettize)));
+                check_round_trip(r, tile, encodedTile);
+                SkAutoTUnref<SkData> encodedNoise(encode(noise, levels[l], filters[f],
+                                                         SkToBool(palettize)));
+                check_round_trip(r, noise, encodedNoise);
+            }
+        }
+    }
+
+    // Storing without compression is bigger than the best compression.
+    SkAutoTUnref<SkData> stored(encode(tile, 0, SkImageEncoder::kNone_PNGFilter, false));
+    SkAutoTUnref<SkData> smallest(encode(tile, 9, SkImageEncoder::kAdaptive_PNGFilter, false));
+    REPORTER_ASSERT(r, stored && smallest && stored->size() > smallest->size());
+
+    // A palette shrinks a low-color tile's pixels to a byte each.
+    SkAutoTUnref<SkData> argb(encode(tile, 0, SkImageEncoder::kNone_PNGFilter, false));
+    SkAutoTUnref<SkData> palette(encode(tile, 0, SkImageEncoder::kNone_PNGFilter, true));
+    REPORTER_ASSERT(r, argb && palette && palette->size() < argb->size() / 2);
+
+    // The noise has too many colors for a palette, so it is encoded as it was.
+    SkAutoTUnref<SkData> noisy(encode(noise, 0, SkImageEncoder::kNone_PNGFilter, false));
+    SkAutoTUnref<SkData> noisyPalette(encode(noise, 0, SkImageEncoder::kNone_PNGFilter, true));
+    REPORTER_ASSERT(r, noisy && noisyPalette && noisy->equals(noisyPalette));
+
+    // The zlib level is clamped.
+    SkAutoTDelete<SkImageEncoder> encoder(SkImageEncoder::Create(SkImageEncoder::kPNG_Type));
+    if (encoder) {
+        encoder->setZLibLevel(42);
+        REPORTER_ASSERT(r, 9 == encoder->getZLibLevel());
+        encoder->setZLibLevel(-5);
+        REPORTER_ASSERT(r, SkImageEncoder::kDefault_ZLibLevel == encoder->getZLibLevel());
+    }
+}
+
+DEF_TEST(PNGEncoder_Parallel, r) {
+    // Tall enough for several strips, the last one short.
+    SkBitmap noise;
+    make_noise(&noise, 67, 600);
+    SkBitmap tile;
+    tile.allocN32Pixels(67, 600);
+    tile.eraseColor(SK_ColorTRANSPARENT);
+    for (int y = 0; y < tile.height(); y += 9) {
+        tile.eraseArea(SkIRect::MakeXYWH(y % 60, y, 7, 5), SK_ColorBLUE);
+    }
+
+    const SkImageEncoder::PNGFilter filters[] = {
+        SkImageEncoder::kDefault_PNGFilter,
+        SkImageEncoder::kNone_PNGFilter,
+        SkImageEncoder::kSub_PNGFilter,
+        SkImageEncoder::kUp_PNGFilter,
+        SkImageEncoder::kAdaptive_PNGFilter,
+    };
+    for (size_t f = 0; f < SK_ARRAY_COUNT(filters); f++) {
+        SkAutoTUnref<SkData> encodedNoise(encode(noise, 1, filters[f], false, true));
+        check_round_trip(r, noise, encodedNoise);
+        SkAutoTUnref<SkData> encodedTile(encode(tile, SkImageEncoder::kDefault_ZLibLevel,
+                                                filters[f], false, true));
+        check_round_trip(r, tile, encodedTile);
+        SkAutoTUnref<SkData> encodedPalette(encode(tile, 9, filters[f], true, true));
+        check_round_trip(r, tile, encodedPalette);
+    }
+
+    // Small images aren't worth splitting, so are encoded as before.
+    SkBitmap small;
+    make_noise(&small);
+    SkAutoTUnref<SkData> serial(encode(small, 6, SkImageEncoder::kUp_PNGFilter, false, false));
+    SkAutoTUnref<SkData> parallel(encode(small, 6, SkImageEncoder::kUp_PNGFilter, false, true));
+    REPORTER_ASSERT(r, serial && parallel && serial->equals(parallel));
+}
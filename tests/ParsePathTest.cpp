@@ -6,6 +6,7 @@
  */
 
 #include "SkParsePath.h"
+#include "SkStream.h"
 #include "Test.h"
 
 static void test_to_from(skiatest::Reporter* reporter, const SkPath& path) {
@@ -63,3 +64,56 @@ DEF_TEST(ParsePath, reporter) {
     p.addRoundRect(r, 4, 4.5f);
     test_to_from(reporter, p);
 }
+
+static SkString to_svg(const SkPath& path, SkParsePath::PathEncoding encoding, int precision) {
+    SkDynamicMemoryWStream stream;
+    SkParsePath::ToSVGString(path, &stream, encoding, precision);
+    SkString str;
+    str.resize(stream.bytesWritten());
+    stream.copyTo(str.writable_str());
+    return str;
+}
+
+DEF_TEST(ParsePath_encodings, reporter) {
+    SkPath path;
+    path.moveTo(100, 100);
+    path.lineTo(110, 100.5f);
+    path.lineTo(110, 90.25f);
+    path.close();
+    path.moveTo(200, 50);
+    path.cubicTo(201, 51, 202.125f, 52, 203, 50);
+
+    // The stream leaves out repeated commands and the line back to the start of a contour.
+    REPORTER_ASSERT(reporter, to_svg(path, SkParsePath::kAbsolute_PathEncoding, -1).equals(
+            "M100 100L110 100.5 110 90.25ZM200 50C201 51 202.125 52 203 50"));
+
+    REPORTER_ASSERT(reporter, to_svg(path, SkParsePath::kAbsolute_PathEncoding, 1).equals(
+            "M100 100L110 100.5 110 90.3ZM200 50C201 51 202.1 52 203 50"));
+    REPORTER_ASSERT(reporter, to_svg(path, SkParsePath::kRelative_PathEncoding, 2).equals(
+            "m100 100l10 0.5 0-10.25zm100-50c1 1 2.13 2 3 0"));
+
+    // Rounded relative coordinates stay close to the original, however long the path.
+    SkPath wiggle;
+    wiggle.moveTo(0, 0);
+    for (int i = 1; i <= 1000; i++) {
+        wiggle.lineTo(SkIntToScalar(i) / 3, SkIntToScalar(i % 7) / 3);
+    }
+    SkPath parsed;
+    REPORTER_ASSERT(reporter, SkParsePath::FromSVGString(
+            to_svg(wiggle, SkParsePath::kRelative_PathEncoding, 2).c_str(), &parsed));
+    REPORTER_ASSERT(reporter, parsed.countPoints() == wiggle.countPoints());
+    for (int i = 0; i < wiggle.countPoints(); i++) {
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(parsed.getPoint(i).fX,
+                                                      wiggle.getPoint(i).fX, 0.006f));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(parsed.getPoint(i).fY,
+                                                      wiggle.getPoint(i).fY, 0.006f));
+    }
+
+    // Both encodings read back as the same path.
+    SkPath absolute, relative;
+    REPORTER_ASSERT(reporter, SkParsePath::FromSVGString(
+            to_svg(path, SkParsePath::kAbsolute_PathEncoding, -1).c_str(), &absolute));
+    REPORTER_ASSERT(reporter, SkParsePath::FromSVGString(
+            to_svg(path, SkParsePath::kRelative_PathEncoding, -1).c_str(), &relative));
+    REPORTER_ASSERT(reporter, absolute == relative);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPatchCache.h"
+#include "SkPatchUtils.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+static const SkPoint gCubics[SkPatchUtils::kNumCtrlPts] = {
+    // top
+    { 10, 10 }, { 40, 0 }, { 70, 20 }, { 100, 10 },
+    // right
+    { 110, 40 }, { 90, 70 },
+    // bottom
+    { 100, 100 }, { 70, 110 }, { 40, 90 }, { 10, 100 },
+    // left
+    { 0, 70 }, { 20, 40 },
+};
+static const SkColor gColors[SkPatchUtils::kNumCorners] = {
+    SK_ColorRED, SK_ColorCYAN, SK_ColorGREEN, 0x80000080,
+};
+static const SkPoint gTexCoords[SkPatchUtils::kNumCorners] = {
+    { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 },
+};
+
+// The Coons patch at (u, v) evaluated directly, one coordinate at a time.
+static SkPoint eval_coons(const SkPoint cubics[12], SkScalar u, SkScalar v) {
+    SkPoint top[4], bottom[4], left[4], right[4];
+    SkPatchUtils::getTopCubic(cubics, top);
+    SkPatchUtils::getBottomCubic(cubics, bottom);
+    SkPatchUtils::getLeftCubic(cubics, left);
+    SkPatchUtils::getRightCubic(cubics, right);
+
+    SkScalar wu[4] = { (1-u)*(1-u)*(1-u), 3*u*(1-u)*(1-u), 3*u*u*(1-u), u*u*u };
+    SkScalar wv[4] = { (1-v)*(1-v)*(1-v), 3*v*(1-v)*(1-v), 3*v*v*(1-v), v*v*v };
+    SkPoint t = SkPoint::Make(0, 0), b = t, l = t, r = t, result;
+    for (int i = 0; i < 4; i++) {
+        t += SkPoint::Make(top[i].fX * wu[i], top[i].fY * wu[i]);
+        b += SkPoint::Make(bottom[i].fX * wu[i], bottom[i].fY * wu[i]);
+        l += SkPoint::Make(left[i].fX * wv[i], left[i].fY * wv[i]);
+        r += SkPoint::Make(right[i].fX * wv[i], right[i].fY * wv[i]);
+    }
+    for (int i = 0; i < 2; i++) {
+        const SkScalar tc = i ? t.fY : t.fX, bc = i ? b.fY : b.fX,
+                       lc = i ? l.fY : l.fX, rc = i ? r.fY : r.fX;
+        const SkScalar c00 = i ? top[0].fY : top[0].fX, c10 = i ? top[3].fY : top[3].fX,
+                       c01 = i ? bottom[0].fY : bottom[0].fX,
+                       c11 = i ? bottom[3].fY : bottom[3].fX;
+        const SkScalar coord = (1-v)*tc + v*bc + (1-u)*lc + u*rc -
+                               ((1-v)*((1-u)*c00 + u*c10) + v*((1-u)*c01 + u*c11));
+        if (i) {
+            result.fY = coord;
+        } else {
+            result.fX = coord;
+        }
+    }
+    return result;
+}
+
+DEF_TEST(PatchUtils_VertexData, reporter) {
+    const int lodX = 7, lodY = 5;
+    SkPatchUtils::VertexData data;
+    REPORTER_ASSERT(reporter, SkPatchUtils::getVertexData(&data, gCubics, gColors, gTexCoords,
+                                                          lodX, lodY));
+    REPORTER_ASSERT(reporter, (lodX + 1) * (lodY + 1) == data.fVertexCount);
+    REPORTER_ASSERT(reporter, lodX * lodY * 6 == data.fIndexCount);
+
+    for (int x = 0; x <= lodX; x++) {
+        for (int y = 0; y <= lodY; y++) {
+            const SkScalar u = SkIntToScalar(x) / lodX, v = SkIntToScalar(y) / lodY;
+            const int i = x * (lodY + 1) + y;
+
+            const SkPoint expected = eval_coons(gCubics, u, v);
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(expected.fX, data.fPoints[i].fX, 0.01f));
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(expected.fY, data.fPoints[i].fY, 0.01f));
+
+            // The texture coordinates span a square, so they're just (u, v) scaled.
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(100 * u, data.fTexCoords[i].fX, 0.01f));
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(100 * v, data.fTexCoords[i].fY, 0.01f));
+        }
+    }
+
+    // The first corner gets exactly its premultiplied color.
+    REPORTER_ASSERT(reporter, SkPreMultiplyColor(gColors[SkPatchUtils::kTopLeft_Corner]) ==
+                              data.fColors[0]);
+}
+
+DEF_TEST(PatchCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    REPORTER_ASSERT(reporter, NULL == SkPatchCache::Find(gCubics, gColors, NULL, 4, 4, &cache));
+
+    SkAutoTUnref<const SkPatchCache::Mesh> mesh(SkPatchCache::Create(gCubics, gColors, NULL,
+                                                                     4, 4));
+    REPORTER_ASSERT(reporter, mesh);
+    SkPatchCache::Add(gCubics, gColors, NULL, 4, 4, mesh, &cache);
+
+    SkAutoTUnref<const SkPatchCache::Mesh> found(SkPatchCache::Find(gCubics, gColors, NULL, 4, 4,
+                                                                    &cache));
+    REPORTER_ASSERT(reporter, found.get() == mesh.get());
+
+    // Any change to the patch or the level of detail is a different entry.
+    SkAutoTUnref<const SkPatchCache::Mesh> missed;
+    missed.reset(SkPatchCache::Find(gCubics, gColors, NULL, 4, 5, &cache));
+    REPORTER_ASSERT(reporter, NULL == missed.get());
+    missed.reset(SkPatchCache::Find(gCubics, NULL, NULL, 4, 4, &cache));
+    REPORTER_ASSERT(reporter, NULL == missed.get());
+    missed.reset(SkPatchCache::Find(gCubics, gColors, gTexCoords, 4, 4, &cache));
+    REPORTER_ASSERT(reporter, NULL == missed.get());
+    SkPoint moved[SkPatchUtils::kNumCtrlPts];
+    memcpy(moved, gCubics, sizeof(moved));
+    moved[5].fX += 1;
+    missed.reset(SkPatchCache::Find(moved, gColors, NULL, 4, 4, &cache));
+    REPORTER_ASSERT(reporter, NULL == missed.get());
+
+    // Purging the cache drops the entry, but not the mesh we still hold.
+    cache.purgeAll();
+    missed.reset(SkPatchCache::Find(gCubics, gColors, NULL, 4, 4, &cache));
+    REPORTER_ASSERT(reporter, NULL == missed.get());
+    REPORTER_ASSERT(reporter, 25 == mesh->data().fVertexCount);
+}
+
+DEF_TEST(PatchCache_Draw, reporter) {
+    const bool wasEnabled = SkGraphics::SetPatchCacheEnabled(true);
+
+    SkPaint paint;
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(120, 120);
+    actual.allocN32Pixels(120, 120);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+
+    SkGraphics::SetPatchCacheEnabled(false);
+    SkCanvas(expected).drawPatch(gCubics, gColors, NULL, NULL, paint);
+    SkGraphics::SetPatchCacheEnabled(true);
+
+    SkPatchCache::ResetStats();
+    SkCanvas canvas(actual);
+    for (int i = 0; i < 3; ++i) {
+        actual.eraseColor(SK_ColorWHITE);
+        canvas.drawPatch(gCubics, gColors, NULL, NULL, paint);
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(expected.getPixels(), actual.getPixels(), actual.getSize()));
+    }
+
+    // The global cache is shared with other tests running in parallel (which may purge it), so
+    // only check that the draws went through it and that it was useful at least once.
+    SkPatchCache::Stats stats;
+    SkPatchCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fHits >= 1);
+    REPORTER_ASSERT(reporter, stats.fHits + stats.fMisses >= 3);
+
+    SkGraphics::SetPatchCacheEnabled(wasEnabled);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkOpArena.h"
+#include "Test.h"
+
+DEF_TEST(PathOpsArena, reporter) {
+    SkChunkAlloc* first;
+    size_t capacity;
+    {
+        SkOpArena arena(SkOpArena::kOp_Use);
+        first = &arena.alloc();
+        REPORTER_ASSERT(reporter, 0 == first->totalUsed());
+        for (int index = 0; index < 100; ++index) {
+            first->allocThrow(1000);
+        }
+        {
+            // A nested use gets an allocator of its own.
+            SkOpArena nested(SkOpArena::kOp_Use);
+            REPORTER_ASSERT(reporter, &nested.alloc() != first);
+            REPORTER_ASSERT(reporter, 0 == nested.alloc().totalUsed());
+        }
+    }
+    {
+        // The next use on this thread starts empty, with room for all of the last one.
+        SkOpArena arena(SkOpArena::kOp_Use);
+        SkChunkAlloc& alloc = arena.alloc();
+        REPORTER_ASSERT(reporter, 0 == alloc.totalUsed());
+        for (int index = 0; index < 100; ++index) {
+            alloc.allocThrow(1000);
+        }
+        capacity = alloc.totalCapacity();
+        REPORTER_ASSERT(reporter, capacity >= 100 * 1000);
+        SkDEBUGCODE(REPORTER_ASSERT(reporter, 1 == alloc.blockCount()));
+    }
+    {
+        // Once sized, uses that fit keep the same block.
+        SkOpArena arena(SkOpArena::kOp_Use);
+        SkChunkAlloc& alloc = arena.alloc();
+        REPORTER_ASSERT(reporter, capacity == alloc.totalCapacity());
+        for (int index = 0; index < 50; ++index) {
+            alloc.allocThrow(1000);
+        }
+        REPORTER_ASSERT(reporter, capacity == alloc.totalCapacity());
+    }
+    {
+        // Each use has its own allocator.
+        SkOpArena opArena(SkOpArena::kOp_Use);
+        SkOpArena sectArena(SkOpArena::kTSect_Use);
+        REPORTER_ASSERT(reporter, &opArena.alloc() != &sectArena.alloc());
+    }
+}
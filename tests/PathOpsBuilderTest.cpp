@@ -78,3 +78,45 @@ DEF_TEST(PathOpsBuilder, reporter) {
     int pixelDiff = comparePaths(reporter, __FUNCTION__, opCompare, result, bitmap);
     REPORTER_ASSERT(reporter, pixelDiff == 0);
 }
+
+DEF_TEST(PathOpsBuilderClusters, reporter) {
+    SkOpBuilder builder;
+    SkPath opCompare;
+    // Groups of overlapping circles that don't touch each other, added out of order.
+    for (int index = 0; index < 16; ++index) {
+        int cell = (index * 7) % 16;
+        SkScalar x = SkIntToScalar(cell % 4 * 20 + 10);
+        SkScalar y = SkIntToScalar(cell / 4 * 20 + 10);
+        for (int circle = 0; circle < 3; ++circle) {
+            SkPath path;
+            path.addCircle(x + circle * 2 - 2, y + (circle & 1) * 3, SkIntToScalar(5 + circle),
+                           circle & 1 ? SkPath::kCCW_Direction : SkPath::kCW_Direction);
+            builder.add(path, kUnion_SkPathOp);
+            Op(opCompare, path, kUnion_SkPathOp, &opCompare);
+        }
+    }
+    // A frame of four rects, none of whose bounds overlap the rect it surrounds.
+    const SkRect rects[] = {
+        { 100, 0, 140, 10 }, { 100, 30, 140, 40 }, { 100, 10, 110, 30 }, { 130, 10, 140, 30 },
+        { 115, 15, 125, 25 },
+    };
+    for (size_t index = 0; index < SK_ARRAY_COUNT(rects); ++index) {
+        SkPath path;
+        path.addRect(rects[index]);
+        builder.add(path, kUnion_SkPathOp);
+        Op(opCompare, path, kUnion_SkPathOp, &opCompare);
+    }
+    // Empty paths add no area.
+    SkPath line;
+    line.moveTo(0, 90);
+    line.lineTo(50, 90);
+    builder.add(line, kUnion_SkPathOp);
+    builder.add(SkPath(), kUnion_SkPathOp);
+
+    SkPath result;
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    REPORTER_ASSERT(reporter, result.getBounds() == opCompare.getBounds());
+    SkBitmap bitmap;
+    int pixelDiff = comparePaths(reporter, __FUNCTION__, opCompare, result, bitmap);
+    REPORTER_ASSERT(reporter, pixelDiff == 0);
+}
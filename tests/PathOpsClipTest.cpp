@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "PathOpsExtendedTest.h"
+#include "SkBitmap.h"
+#include "Test.h"
+
+static void test_clip(skiatest::Reporter* reporter, const SkPath& path, const SkRect& rect) {
+    SkPath rectPath, expected, result;
+    rectPath.addRect(rect);
+    REPORTER_ASSERT(reporter, Op(path, rectPath, kIntersect_SkPathOp, &expected));
+    REPORTER_ASSERT(reporter, ClipToRect(path, rect, &result));
+    if (!path.isInverseFillType()) {
+        REPORTER_ASSERT(reporter, result.getFillType() == path.getFillType());
+    }
+    if (expected.isEmpty()) {
+        REPORTER_ASSERT(reporter, result.isEmpty());
+        return;
+    }
+    SkBitmap bitmap;
+    int pixelDiff = comparePaths(reporter, __FUNCTION__, expected, result, bitmap);
+    REPORTER_ASSERT(reporter, pixelDiff == 0);
+}
+
+DEF_TEST(PathOpsClipToRect, reporter) {
+    SkPath star;
+    star.moveTo(50, 0);
+    for (int index = 1; index < 5; ++index) {
+        SkScalar angle = index * 4 * SK_ScalarPI / 5;
+        star.lineTo(50 + 50 * SkScalarSin(angle), 50 - 50 * SkScalarCos(angle));
+    }
+    star.close();
+    SkPath evenOddStar(star);
+    evenOddStar.setFillType(SkPath::kEvenOdd_FillType);
+
+    SkPath ring;
+    ring.setFillType(SkPath::kEvenOdd_FillType);
+    ring.addCircle(50, 50, 45);
+    ring.addCircle(50, 50, 25);
+
+    SkPath blob;
+    blob.moveTo(10, 50);
+    blob.cubicTo(-20, -10, 120, -10, 90, 50);
+    blob.quadTo(110, 110, 50, 90);
+    blob.cubicTo(0, 120, 90, 20, 10, 50);
+
+    SkPath oval;
+    oval.addOval(SkRect::MakeLTRB(-50, 20, 150, 80));
+
+    SkPath inverse(star);
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+
+    const SkPath* paths[] = { &star, &evenOddStar, &ring, &blob, &oval, &inverse };
+    const SkRect rects[] = {
+        SkRect::MakeLTRB(20, 20, 80, 80),
+        SkRect::MakeLTRB(-10, 30, 60, 70),
+        SkRect::MakeLTRB(40, 40, 60, 60),
+        SkRect::MakeLTRB(45, -5, 95, 45),
+        SkRect::MakeLTRB(0, 0, 25, 25),
+        SkRect::MakeLTRB(-20, -20, 120, 120),
+    };
+    for (size_t p = 0; p < SK_ARRAY_COUNT(paths); ++p) {
+        for (size_t r = 0; r < SK_ARRAY_COUNT(rects); ++r) {
+            test_clip(reporter, *paths[p], rects[r]);
+        }
+    }
+
+    // A rect well inside the ring's hole, and one inside the oval that no edge crosses.
+    SkPath result;
+    REPORTER_ASSERT(reporter, ClipToRect(ring, SkRect::MakeLTRB(45, 45, 55, 55), &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+    const SkRect inside = SkRect::MakeLTRB(40, 40, 60, 60);
+    REPORTER_ASSERT(reporter, ClipToRect(oval, inside, &result));
+    REPORTER_ASSERT(reporter, result.getBounds() == inside);
+
+    // Lines stay inside the rect.
+    REPORTER_ASSERT(reporter, ClipToRect(star, rects[1], &result));
+    REPORTER_ASSERT(reporter, rects[1].contains(result.getBounds()));
+
+    // The result may be the input.
+    SkPath expected;
+    REPORTER_ASSERT(reporter, ClipToRect(blob, rects[0], &expected));
+    result = blob;
+    REPORTER_ASSERT(reporter, ClipToRect(result, rects[0], &result));
+    REPORTER_ASSERT(reporter, result == expected);
+}
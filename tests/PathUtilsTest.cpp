@@ -150,3 +150,75 @@ DEF_TEST(PathUtils, reporter) {
         }
     }
 }
+
+// Returns the largest distance from a point of src to the lines of dst's contour.
+static SkScalar max_distance_to_lines(const SkPath& src, const SkPath& dst) {
+    SkScalar maxDist = 0;
+    for (int i = 0; i < src.countPoints(); ++i) {
+        SkScalar dist = SK_ScalarMax;
+        for (int j = 1; j < dst.countPoints(); ++j) {
+            dist = SkMinScalar(dist, src.getPoint(i).distanceToLineSegmentBetween(
+                    dst.getPoint(j - 1), dst.getPoint(j)));
+        }
+        maxDist = SkMaxScalar(maxDist, dist);
+    }
+    return maxDist;
+}
+
+DEF_TEST(PathUtils_Simplify, reporter) {
+    const SkScalar tolerance = SK_Scalar1 / 2;
+    SkRandom rand;
+    SkPath wiggle;
+    wiggle.moveTo(0, 0);
+    for (int i = 1; i <= 100; ++i) {
+        wiggle.lineTo(SkIntToScalar(i), rand.nextRangeScalar(-0.2f, 0.2f));
+    }
+    for (int i = 1; i <= 100; ++i) {
+        wiggle.lineTo(100 + rand.nextRangeScalar(-0.2f, 0.2f), SkIntToScalar(i));
+    }
+    SkPath dst;
+    SkPathUtils::Simplify(wiggle, tolerance, &dst);
+    REPORTER_ASSERT(reporter, dst.countPoints() < 10);
+    REPORTER_ASSERT(reporter, dst.getPoint(0) == wiggle.getPoint(0));
+    SkPoint dstLast, wiggleLast;
+    dst.getLastPt(&dstLast);
+    wiggle.getLastPt(&wiggleLast);
+    REPORTER_ASSERT(reporter, dstLast == wiggleLast);
+    REPORTER_ASSERT(reporter, max_distance_to_lines(wiggle, dst) <= tolerance);
+
+    // Curves, moves and closes survive, and the lines between them are still simplified.
+    SkPath mixed;
+    mixed.setFillType(SkPath::kEvenOdd_FillType);
+    mixed.moveTo(0, 0);
+    mixed.lineTo(10, 0.1f);
+    mixed.lineTo(20, 0);
+    mixed.quadTo(30, 10, 40, 0);
+    mixed.lineTo(50, 0.1f);
+    mixed.lineTo(60, 0);
+    mixed.conicTo(70, 10, 80, 0, 0.5f);
+    mixed.cubicTo(90, 10, 100, -10, 110, 0);
+    mixed.close();
+    mixed.moveTo(0, 50);
+    mixed.lineTo(50, 50);
+    mixed.lineTo(50, 51);
+    SkPathUtils::Simplify(mixed, tolerance, &dst);
+    REPORTER_ASSERT(reporter, dst.getFillType() == SkPath::kEvenOdd_FillType);
+    const uint8_t expectedVerbs[] = {
+        SkPath::kMove_Verb, SkPath::kLine_Verb, SkPath::kQuad_Verb, SkPath::kLine_Verb,
+        SkPath::kConic_Verb, SkPath::kCubic_Verb, SkPath::kClose_Verb,
+        SkPath::kMove_Verb, SkPath::kLine_Verb, SkPath::kLine_Verb,
+    };
+    uint8_t verbs[SK_ARRAY_COUNT(expectedVerbs) + 1];
+    int verbCount = dst.getVerbs(verbs, SK_ARRAY_COUNT(verbs));
+    REPORTER_ASSERT(reporter, SK_ARRAY_COUNT(expectedVerbs) == verbCount);
+    REPORTER_ASSERT(reporter, !memcmp(verbs, expectedVerbs, sizeof(expectedVerbs)));
+    REPORTER_ASSERT(reporter, dst.getBounds() == mixed.getBounds());
+
+    // dst may be src, and a zero tolerance leaves the path alone.
+    SkPath copy(wiggle);
+    SkPathUtils::Simplify(copy, 0, &copy);
+    REPORTER_ASSERT(reporter, copy == wiggle);
+    SkPathUtils::Simplify(copy, tolerance, &copy);
+    SkPathUtils::Simplify(wiggle, tolerance, &dst);
+    REPORTER_ASSERT(reporter, copy == dst);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPerlinNoiseShader.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+static void draw_noise(SkBitmap* bm, SkShader* shader, SkScalar dx, SkScalar dy) {
+    bm->allocN32Pixels(150, 110);
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bm);
+    canvas.translate(dx, dy);
+    SkPaint paint;
+    paint.setShader(shader);
+    canvas.drawPaint(paint);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    return a.getSize() == b.getSize() && 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+// The noise of a stitched tile is made once, and drawing from the cache gives the same colors.
+DEF_TEST(PerlinNoiseShader_TileCache, reporter) {
+    const SkISize tileSize = SkISize::Make(64, 48);
+    SkAutoTUnref<SkShader> turbulence(SkPerlinNoiseShader::CreateTurbulence(
+            0.05f, 0.08f, 3, 7, &tileSize));
+    SkAutoTUnref<SkShader> fractal(SkPerlinNoiseShader::CreateFractalNoise(
+            0.05f, 0.08f, 3, 7, &tileSize));
+
+    SkResourceCache::PurgeAll();
+    size_t initialBytes = SkResourceCache::GetTotalBytesUsed();
+    SkBitmap first, second, other;
+    draw_noise(&first, turbulence, 3, 5);
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() >=
+                              initialBytes + 65 * 49 * sizeof(SkPMColor));
+
+    size_t cachedBytes = SkResourceCache::GetTotalBytesUsed();
+    draw_noise(&second, turbulence, 3, 5);
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() == cachedBytes);
+    REPORTER_ASSERT(reporter, equal_pixels(first, second));
+
+    // Only the same noise shares a tile.
+    draw_noise(&other, fractal, 3, 5);
+    REPORTER_ASSERT(reporter, SkResourceCache::GetTotalBytesUsed() > cachedBytes);
+    REPORTER_ASSERT(reporter, !equal_pixels(first, other));
+
+    // Translating by whole pixels moves the noise with it, whether it comes from the tile or not.
+    SkBitmap moved;
+    draw_noise(&moved, turbulence, 3 + 40, 5 + 20);
+    SkAutoLockPixels lockFirst(first), lockMoved(moved);
+    bool matches = true;
+    for (int y = 0; y < first.height() - 20; ++y) {
+        for (int x = 0; x < first.width() - 40; ++x) {
+            matches &= *first.getAddr32(x, y) == *moved.getAddr32(x + 40, y + 20);
+        }
+    }
+    REPORTER_ASSERT(reporter, matches);
+}
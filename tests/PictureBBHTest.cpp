@@ -34,6 +34,14 @@ public:
         // With an R-Tree
         SkRTreeFactory RTreeFactory;
         this->run(&RTreeFactory, reporter);
+
+        // With a tile grid
+        SkTileGridFactory::TileGridInfo tileGridInfo;
+        tileGridInfo.fTileInterval.set(16, 16);
+        tileGridInfo.fMargin.setEmpty();
+        tileGridInfo.fOffset.setZero();
+        SkTileGridFactory tileGridFactory(tileGridInfo);
+        this->run(&tileGridFactory, reporter);
     }
 
 private:
@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
+#include "SkPictureShader.h"
 #include "SkShader.h"
 #include "Test.h"
 
@@ -24,3 +27,84 @@ DEF_TEST(PictureShader_empty, reporter) {
             SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, NULL, NULL);
     REPORTER_ASSERT(reporter, NULL == shader);
 }
+
+static SkShader* make_checker_shader() {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(10, 10, NULL, 0);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeWH(5, 5), paint);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 5, 5), paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+    return SkShader::CreatePictureShader(picture, SkShader::kRepeat_TileMode,
+                                         SkShader::kRepeat_TileMode, NULL, NULL);
+}
+
+static void draw_scaled(SkCanvas* canvas, SkShader* shader, SkScalar scale) {
+    SkPaint paint;
+    paint.setShader(shader);
+    canvas->save();
+    canvas->scale(scale, scale);
+    canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+    canvas->restore();
+}
+
+// Zooming between two powers of two reuses one tile.
+DEF_TEST(PictureShader_ScaleBuckets, reporter) {
+    SkAutoTUnref<SkShader> shader(make_checker_shader());
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    SkCanvas canvas(bm);
+
+    SkPictureShader::TileCacheStats before, after;
+    SkPictureShader::GetTileCacheStats(&before);
+    draw_scaled(&canvas, shader, 1.1f);
+    draw_scaled(&canvas, shader, 1.3f);
+    draw_scaled(&canvas, shader, 1.7f);
+    draw_scaled(&canvas, shader, 2);
+    SkPictureShader::GetTileCacheStats(&after);
+    REPORTER_ASSERT(reporter, after.fRasterMisses > before.fRasterMisses);
+    REPORTER_ASSERT(reporter, after.fRasterHits - before.fRasterHits >= 3);
+
+    // The tile is drawn at 2x and filtered down, so the checker still lands where it should.
+    canvas.clear(SK_ColorWHITE);
+    draw_scaled(&canvas, shader, 1.5f);
+    REPORTER_ASSERT(reporter, SK_ColorRED == bm.getColor(3, 3));
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bm.getColor(11, 3));
+    REPORTER_ASSERT(reporter, SK_ColorRED == bm.getColor(11, 11));
+}
+
+#if SK_SUPPORT_GPU
+#include "GrContextFactory.h"
+#include "SkSurface.h"
+
+DEF_GPUTEST(PictureShader_GpuTiles, reporter, factory) {
+    for (int type = 0; type < GrContextFactory::kGLContextTypeCnt; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        if (GrContextFactory::kNull_GLContextType == glType) {
+            continue;
+        }
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context,
+                SkSurface::kNo_Budgeted, SkImageInfo::MakeN32Premul(64, 64)));
+        if (!surface) {
+            continue;
+        }
+        SkAutoTUnref<SkShader> shader(make_checker_shader());
+
+        SkPictureShader::TileCacheStats before, after;
+        SkPictureShader::GetTileCacheStats(&before);
+        draw_scaled(surface->getCanvas(), shader, 1.1f);
+        draw_scaled(surface->getCanvas(), shader, 1.6f);
+        surface->getCanvas()->flush();
+        SkPictureShader::GetTileCacheStats(&after);
+        REPORTER_ASSERT(reporter, 1 == after.fGpuMisses - before.fGpuMisses);
+        REPORTER_ASSERT(reporter, 1 == after.fGpuHits - before.fGpuHits);
+        // The GPU draws its own tiles.
+        REPORTER_ASSERT(reporter, after.fRasterMisses == before.fRasterMisses);
+    }
+}
+#endif
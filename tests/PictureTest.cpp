@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkAtomics.h"
 #include "SkBBoxHierarchy.h"
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
@@ -14,6 +15,7 @@
 #include "SkData.h"
 #include "SkImageGenerator.h"
 #include "SkError.h"
+#include "SkImage.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
 #include "SkLayerInfo.h"
@@ -28,6 +30,7 @@
 #include "SkRecord.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkUtils.h"
 #include "sk_tool_utils.h"
 
 #if SK_SUPPORT_GPU
@@ -1311,3 +1314,487 @@ DEF_TEST(Picture_BitmapLeak, r) {
     REPORTER_ASSERT(r, mut.pixelRef()->unique());
     REPORTER_ASSERT(r, immut.pixelRef()->unique());
 }
+
+static size_t serialized_size_with_bitmaps(const SkBitmap& a, const SkBitmap& b) {
+    SkPictureRecorder rec;
+    SkCanvas* canvas = rec.beginRecording(100, 100);
+        canvas->drawBitmap(a, 0, 0);
+        canvas->drawBitmap(b, 50, 50);
+    SkAutoTUnref<const SkPicture> pic(rec.endRecording());
+    SkDynamicMemoryWStream stream;
+    pic->serialize(&stream);
+    return stream.getOffset();
+}
+
+// Separately allocated bitmaps with the same pixels are stored once when serialized.
+DEF_TEST(Picture_SerializeDedupesBitmapContent, r) {
+    SkBitmap a, b, c;
+    a.allocN32Pixels(32, 32);
+    b.allocN32Pixels(32, 32);
+    c.allocN32Pixels(32, 32);
+    a.eraseColor(SK_ColorRED);
+    b.eraseColor(SK_ColorRED);
+    c.eraseColor(SK_ColorRED);
+    *c.getAddr32(5, 5) = SK_ColorBLUE;
+    a.setImmutable();
+    b.setImmutable();
+    c.setImmutable();
+    REPORTER_ASSERT(r, a.pixelRef() != b.pixelRef());
+
+    const size_t same = serialized_size_with_bitmaps(a, a);
+    REPORTER_ASSERT(r, same == serialized_size_with_bitmaps(a, b));
+    REPORTER_ASSERT(r, same < serialized_size_with_bitmaps(a, c));
+}
+
+// Banded parallel playback must produce the same pixels as serial playback.
+DEF_TEST(Picture_PlaybackParallel, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* recordingCanvas = recorder.beginRecording(400, 300, &factory);
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 200; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        SkRect rect = SkRect::MakeXYWH(rand.nextRangeScalar(-20, 380),
+                                       rand.nextRangeScalar(-20, 280),
+                                       rand.nextRangeScalar(1, 60),
+                                       rand.nextRangeScalar(1, 60));
+        if (i & 1) {
+            recordingCanvas->drawOval(rect, paint);
+        } else {
+            recordingCanvas->save();
+            recordingCanvas->rotate(rand.nextRangeScalar(0, 90));
+            recordingCanvas->drawRect(rect, paint);
+            recordingCanvas->restore();
+        }
+    }
+    SkAutoTUnref<const SkPicture> picture(recorder.endRecording());
+
+    SkBitmap serial, parallel;
+    serial.allocN32Pixels(320, 240);
+    parallel.allocN32Pixels(320, 240);
+
+    for (int bands = 0; bands <= 7; bands++) {
+        serial.eraseColor(SK_ColorWHITE);
+        parallel.eraseColor(SK_ColorWHITE);
+
+        SkCanvas serialCanvas(serial), parallelCanvas(parallel);
+        SkCanvas* canvases[] = { &serialCanvas, &parallelCanvas };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(canvases); i++) {
+            canvases[i]->clipRect(SkRect::MakeLTRB(10, 5, 300, 230));
+            canvases[i]->translate(-15, 7);
+            canvases[i]->scale(0.9f, 0.8f);
+        }
+
+        picture->playback(&serialCanvas);
+        picture->playbackParallel(&parallelCanvas, NULL, bands);
+
+        // Geometry crossing a band seam is clipped there, which can nudge anti-aliased edge
+        // pixels along the seam; everything else must match exactly.
+        int diffs = 0;
+        for (int y = 0; y < serial.height(); y++) {
+            for (int x = 0; x < serial.width(); x++) {
+                diffs += *serial.getAddr32(x, y) != *parallel.getAddr32(x, y);
+            }
+        }
+        REPORTER_ASSERT(r, diffs <= serial.width() * serial.height() / 100);
+        if (bands == 1) {
+            REPORTER_ASSERT(r, 0 == diffs);
+        }
+        // The canvas state is left untouched.
+        REPORTER_ASSERT(r, serialCanvas.getTotalMatrix() == parallelCanvas.getTotalMatrix());
+    }
+}
+
+// Fills its pixels with one color, counting how many times it's asked to.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(int32_t* decodes)
+        : INHERITED(SkImageInfo::MakeN32Premul(16, 16)), fDecodes(decodes) {}
+
+protected:
+    Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, const Options&,
+                       SkPMColor*, int*) override {
+        sk_atomic_inc(fDecodes);
+        for (int y = 0; y < info.height(); y++) {
+            sk_memset32((uint32_t*)((char*)pixels + y * rowBytes),
+                        SkPreMultiplyColor(SK_ColorBLUE), info.width());
+        }
+        return kSuccess;
+    }
+
+private:
+    int32_t* fDecodes;
+
+    typedef SkImageGenerator INHERITED;
+};
+
+DEF_TEST(Picture_PreDecodeBitmaps, r) {
+    int32_t decodes[5] = { 0, 0, 0, 0, 0 };
+    SkBitmap bitmaps[5];
+    for (int i = 0; i < 5; i++) {
+        REPORTER_ASSERT(r, SkInstallDiscardablePixelRef(SkNEW_ARGS(CountingGenerator,
+                                                                   (&decodes[i])),
+                                                        &bitmaps[i]));
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* nestedCanvas = recorder.beginRecording(100, 100);
+    nestedCanvas->drawBitmap(bitmaps[3], 0, 0);
+    SkAutoTUnref<const SkPicture> nested(recorder.endRecording());
+
+    SkRTreeFactory factory;
+    SkCanvas* canvas = recorder.beginRecording(400, 400, &factory);
+    canvas->drawBitmap(bitmaps[0], 10, 10);
+    canvas->drawBitmap(bitmaps[0], 20, 20);
+    canvas->drawBitmap(bitmaps[1], 300, 300);
+    SkPaint shaderPaint;
+    shaderPaint.setShader(SkShader::CreateBitmapShader(bitmaps[2], SkShader::kRepeat_TileMode,
+                                                       SkShader::kRepeat_TileMode))->unref();
+    canvas->drawRect(SkRect::MakeXYWH(300, 10, 50, 50), shaderPaint);
+    SkMatrix matrix = SkMatrix::MakeTrans(10, 300);
+    canvas->drawPicture(nested, &matrix, NULL);
+    SkAutoTUnref<SkImage> image(SkImage::NewFromGenerator(SkNEW_ARGS(CountingGenerator,
+                                                                     (&decodes[4]))));
+    canvas->drawImage(image, 200, 200);
+    SkAutoTUnref<const SkPicture> picture(recorder.endRecording());
+
+    // Only the first bitmap is drawn in the top left corner.
+    const SkRect corner = SkRect::MakeWH(100, 100);
+    REPORTER_ASSERT(r, 1 == picture->preDecodeBitmaps(&corner));
+    REPORTER_ASSERT(r, 1 == decodes[0]);
+    REPORTER_ASSERT(r, 0 == decodes[1] && 0 == decodes[2] && 0 == decodes[3]);
+
+    // Each of the others is decoded once, and playback doesn't decode any of them again.
+    REPORTER_ASSERT(r, 5 == picture->preDecodeBitmaps());
+    SkBitmap dst;
+    dst.allocN32Pixels(400, 400);
+    SkCanvas dstCanvas(dst);
+    picture->playback(&dstCanvas);
+    for (int i = 0; i < 5; i++) {
+        REPORTER_ASSERT(r, 1 == decodes[i]);
+    }
+    REPORTER_ASSERT(r, SkPreMultiplyColor(SK_ColorBLUE) == *dst.getAddr32(305, 305));
+
+    // Pixels that are already there aren't worth scheduling.
+    SkBitmap plain;
+    plain.allocN32Pixels(16, 16);
+    canvas = recorder.beginRecording(100, 100);
+    canvas->drawBitmap(plain, 0, 0);
+    SkAutoTUnref<const SkPicture> plainPicture(recorder.endRecording());
+    REPORTER_ASSERT(r, 0 == plainPicture->preDecodeBitmaps());
+}
+
+// Hides the memory behind an SkMemoryStream, so SKP parsing has to read and copy it.
+class ReadOnlyStream : public SkStream {
+public:
+    explicit ReadOnlyStream(SkStream* stream) : fStream(stream) {}
+    size_t read(void* buffer, size_t size) override { return fStream->read(buffer, size); }
+    bool isAtEnd() const override { return fStream->isAtEnd(); }
+private:
+    SkStream* fStream;
+};
+
+static void draw_picture_to_bitmap(const SkPicture* picture, SkBitmap* bm) {
+    bm->allocN32Pixels(100, 100);
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.drawPicture(picture);
+}
+
+// SKPs read from memory (e.g. mmap'd files) are parsed in place, and the resulting picture must
+// not depend on that memory once it's gone.
+DEF_TEST(Picture_CreateFromMemoryStream, r) {
+    SkAutoTUnref<SkPicture> nested;
+    {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(100, 100);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawCircle(70, 70, 20, paint);
+        nested.reset(recorder.endRecording());
+    }
+
+    SkBitmap bitmap;
+    make_bm(&bitmap, 10, 10, SK_ColorRED, true);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkPath path;
+        path.moveTo(5, 5);
+        path.lineTo(60, 20);
+        path.lineTo(20, 60);
+        canvas->drawPath(path, paint);
+        canvas->drawBitmap(bitmap, 40, 40);
+        canvas->drawText("Hello", 5, 10, 90, paint);
+        canvas->drawPicture(nested);
+    }
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream wStream;
+    picture->serialize(&wStream);
+    SkAutoTUnref<SkData> data(wStream.copyToData());
+    // Every chunk is padded to 4 bytes, so the SKP can be parsed where it sits.
+    REPORTER_ASSERT(r, SkIsAlign4(data->size()));
+
+    SkAutoTUnref<SkPicture> fromMemory, fromReads;
+    {
+        SkMemoryStream memStream(data);
+        REPORTER_ASSERT(r, memStream.getMemoryBase());
+        fromMemory.reset(SkPicture::CreateFromStream(&memStream));
+
+        SkMemoryStream hiddenStream(data);
+        ReadOnlyStream readStream(&hiddenStream);
+        fromReads.reset(SkPicture::CreateFromStream(&readStream));
+    }
+    REPORTER_ASSERT(r, fromMemory && fromReads);
+    if (!fromMemory || !fromReads) {
+        return;
+    }
+
+    // Scribble over the serialized bytes before drawing.
+    memset(const_cast<void*>(data->data()), 0xAB, data->size());
+    data.reset(NULL);
+
+    SkBitmap expected, fromMemoryBm, fromReadsBm;
+    draw_picture_to_bitmap(picture, &expected);
+    draw_picture_to_bitmap(fromMemory, &fromMemoryBm);
+    draw_picture_to_bitmap(fromReads, &fromReadsBm);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), fromMemoryBm.getPixels(),
+                                   expected.getSize()));
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), fromReadsBm.getPixels(),
+                                   expected.getSize()));
+}
+
+// serializeCompact() must read back as the same picture, in fewer bytes.
+DEF_TEST(Picture_SerializeCompact, r) {
+    SkAutoTUnref<SkPicture> nested;
+    {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(100, 100);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawCircle(70, 70, 20, paint);
+        nested.reset(recorder.endRecording());
+    }
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 20; ++i) {
+            canvas->save();
+            canvas->clipRect(SkRect::MakeXYWH(SkIntToScalar(i), 0, 60, 100));
+            paint.setColor(0 == i % 2 ? SK_ColorRED : SK_ColorGREEN);
+            SkPath path;
+            path.moveTo(SkIntToScalar(i), 5);
+            path.lineTo(60, 20.5f);
+            path.conicTo(70, 80, 20, 60, 0.7f);
+            path.close();
+            canvas->drawPath(path, paint);
+            canvas->drawRect(SkRect::MakeXYWH(3, 3, 10, 10), paint);
+            canvas->restore();
+        }
+        SkPath curve;
+        curve.moveTo(1.0f / 3, 2.0f / 7);
+        curve.cubicTo(90.1f, 10.2f, 10.3f, 90.4f, 95.7f, 95.9f);
+        canvas->drawPath(curve, paint);
+        canvas->drawPicture(nested);
+    }
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkDynamicMemoryWStream plain, compact, rounded;
+    picture->serialize(&plain);
+    picture->serializeCompact(&compact);
+    picture->serializeCompact(&rounded, 0.125f);
+    REPORTER_ASSERT(r, compact.bytesWritten() < plain.bytesWritten() / 2);
+    REPORTER_ASSERT(r, rounded.bytesWritten() < compact.bytesWritten());
+    REPORTER_ASSERT(r, SkIsAlign4(compact.bytesWritten()));
+
+    SkAutoTUnref<SkData> data(compact.copyToData());
+    SkMemoryStream stream(data);
+    SkAutoTUnref<SkPicture> fromCompact(SkPicture::CreateFromStream(&stream));
+    SkAutoTUnref<SkData> roundedData(rounded.copyToData());
+    SkMemoryStream roundedStream(roundedData);
+    SkAutoTUnref<SkPicture> fromRounded(SkPicture::CreateFromStream(&roundedStream));
+    REPORTER_ASSERT(r, fromCompact && fromRounded);
+    if (!fromCompact || !fromRounded) {
+        return;
+    }
+
+    // Without a path precision, nothing is lost.
+    SkBitmap expected, actual;
+    draw_picture_to_bitmap(picture, &expected);
+    draw_picture_to_bitmap(fromCompact, &actual);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+
+    // Truncated data is rejected rather than misread.
+    SkMemoryStream truncated(data->data(), data->size() / 2);
+    SkAutoTUnref<SkPicture> fromTruncated(SkPicture::CreateFromStream(&truncated));
+    REPORTER_ASSERT(r, NULL == fromTruncated.get());
+}
+
+static void draw_overlapping_rects(SkCanvas* canvas) {
+    // Curves and antialiased edges can come out slightly differently once clipped to a tile.
+    SkPaint paint;
+    for (int i = 0; i < 5; ++i) {
+        paint.setColor(SkColorSetARGB(0xC0, 0x30 * i, 0xFF - 0x30 * i, 0x80));
+        canvas->drawRect(SkRect::MakeXYWH(20.5f * i, 15.25f * i + 3, 30, 25), paint);
+    }
+}
+
+// A picture split into tiles must draw like the original, across the seams too.
+DEF_TEST(Picture_EndRecordingAsTiles, r) {
+    SkPictureRecorder recorder;
+    draw_overlapping_rects(recorder.beginRecording(100, 100));
+    SkAutoTUnref<SkPicture> whole(recorder.endRecording());
+
+    SkRTreeFactory factory;
+    draw_overlapping_rects(recorder.beginRecording(100, 100));
+    SkAutoTUnref<SkPicture> tiles(recorder.endRecordingAsTiles(32, 32, &factory));
+    // 16 tiles cover the picture, but nothing touches those in the corners.
+    REPORTER_ASSERT(r, tiles->approximateOpCount() < 16);
+
+    SkBitmap expected, actual;
+    draw_picture_to_bitmap(whole, &expected);
+    draw_picture_to_bitmap(tiles, &actual);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSize()));
+}
+
+static void record_tile(SkCanvas* canvas, SkColor color) {
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeXYWH(0, 0, 30, 30), paint);
+}
+
+static void record_map(SkCanvas* canvas, SkColor tileColor, bool groupTile) {
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 50, 50), paint);
+    canvas->save();
+    canvas->translate(20, 30);
+    if (groupTile) {
+        canvas->beginCommentGroup("tile");
+    }
+    canvas->save();
+    canvas->scale(2, 1);
+    record_tile(canvas, tileColor);
+    canvas->restore();
+    if (groupTile) {
+        canvas->endCommentGroup();
+    }
+    canvas->restore();
+    paint.setColor(0x800000FF);
+    canvas->drawOval(SkRect::MakeXYWH(40, 40, 50, 50), paint);
+}
+
+// Replacing a comment group must draw like recording the whole picture again.
+DEF_TEST(Picture_ReplaceCommentGroup, r) {
+    SkPictureRecorder recorder;
+    record_map(recorder.beginRecording(100, 100), SK_ColorRED, true);
+    SkAutoTUnref<SkPicture> original(recorder.endRecording());
+
+    {
+        // The replacement is recorded on its own, as if at the origin.
+        SkCanvas* canvas = recorder.beginRecording(100, 100);
+        canvas->scale(2, 1);
+        record_tile(canvas, SK_ColorBLUE);
+    }
+    SkAutoTUnref<SkPicture> blueTile(recorder.endRecording());
+    record_map(recorder.beginRecording(100, 100), SK_ColorBLUE, false);
+    SkAutoTUnref<SkPicture> blueMap(recorder.endRecording());
+
+    REPORTER_ASSERT(r, NULL == original->newWithCommentGroupReplaced("nope", blueTile));
+
+    SkRTreeFactory factory;
+    SkAutoTUnref<SkPicture> replaced(original->newWithCommentGroupReplaced("tile", blueTile,
+                                                                           &factory));
+    REPORTER_ASSERT(r, replaced);
+    if (!replaced) {
+        return;
+    }
+    // The shared commands must outlive the picture they came from.
+    original.reset(NULL);
+
+    SkBitmap expected, actual;
+    draw_picture_to_bitmap(blueMap, &expected);
+    draw_picture_to_bitmap(replaced, &actual);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()));
+
+    // The group survives, so it can be replaced again.
+    SkAutoTUnref<SkPicture> again(replaced->newWithCommentGroupReplaced("tile", blueTile));
+    REPORTER_ASSERT(r, again);
+    if (again) {
+        draw_picture_to_bitmap(again, &actual);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSize()));
+    }
+}
+
+static void record_poi_map(SkCanvas* canvas, SkColor poiColor, bool groupPOI) {
+    // Ovals and antialiased edges can come out slightly differently once clipped.
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 90, 90), paint);
+    canvas->save();
+    canvas->translate(20, 30);
+    if (groupPOI) {
+        canvas->beginCommentGroup("poi");
+    }
+    canvas->scale(2, 1);
+    paint.setColor(poiColor);
+    canvas->drawRect(SkRect::MakeXYWH(0, 0, 30, 30), paint);
+    if (groupPOI) {
+        canvas->endCommentGroup();
+    }
+    canvas->restore();
+    paint.setColor(0x800000FF);
+    canvas->drawRect(SkRect::MakeXYWH(40.5f, 40.5f, 50, 50), paint);
+}
+
+// Repainting just the damage must draw like drawing the new picture from scratch.
+DEF_TEST(Picture_ComputeDamage, r) {
+    SkPictureRecorder recorder;
+    record_poi_map(recorder.beginRecording(100, 100), SK_ColorRED, false);
+    SkAutoTUnref<SkPicture> redMap(recorder.endRecording());
+    record_poi_map(recorder.beginRecording(100, 100), SK_ColorRED, false);
+    SkAutoTUnref<SkPicture> sameMap(recorder.endRecording());
+    record_poi_map(recorder.beginRecording(100, 100), SK_ColorBLUE, false);
+    SkAutoTUnref<SkPicture> blueMap(recorder.endRecording());
+    record_poi_map(recorder.beginRecording(100, 100), SK_ColorBLUE, true);
+    SkAutoTUnref<SkPicture> groupedMap(recorder.endRecording());
+
+    SkRegion damage;
+    SkPictureUtils::ComputeDamage(redMap, sameMap, SkMatrix::I(), &damage);
+    REPORTER_ASSERT(r, damage.isEmpty());
+
+    // Only the point of interest changed, and it covers (20,30) to (80,60).
+    SkPictureUtils::ComputeDamage(redMap, blueMap, SkMatrix::I(), &damage);
+    REPORTER_ASSERT(r, damage.contains(SkIRect::MakeLTRB(20, 30, 80, 60)));
+    REPORTER_ASSERT(r, !damage.contains(10, 10));
+    REPORTER_ASSERT(r, !damage.contains(85, 85));
+
+    SkBitmap expected, actual;
+    draw_picture_to_bitmap(blueMap, &expected);
+    draw_picture_to_bitmap(redMap, &actual);
+    {
+        SkCanvas canvas(actual);
+        canvas.clipRegion(damage);
+        canvas.clear(SK_ColorWHITE);
+        canvas.drawPicture(blueMap);
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize()));
+
+    // Inserted ops are damage too, here a comment group around the point of interest.  Damage
+    // is in device space, so follows the matrix.
+    SkPictureUtils::ComputeDamage(blueMap, groupedMap, SkMatrix::MakeScale(2, 2), &damage);
+    REPORTER_ASSERT(r, !damage.isEmpty());
+    REPORTER_ASSERT(r, damage.getBounds().fLeft >= 38 && damage.getBounds().fBottom <= 122);
+}
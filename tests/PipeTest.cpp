@@ -9,8 +9,13 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkGPipe.h"
+#include "SkGPipeRingBuffer.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkShader.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+#include "SkThreadUtils.h"
 #include "Test.h"
 
 // Ensures that the pipe gracefully handles drawing an invalid bitmap.
@@ -54,3 +59,111 @@ DEF_TEST(Pipe, reporter) {
 
     testDrawingAfterEndRecording(&canvas);
 }
+
+static void draw_stripes(SkCanvas* canvas) {
+    SkPaint paint;
+    for (int i = 0; i < 4000; i++) {
+        paint.setColor(SkColorSetARGB(0xFF, i & 0xFF, (i >> 4) & 0xFF, 0x80));
+        SkPath path;
+        path.moveTo(SkIntToScalar(i % 64), 0);
+        path.lineTo(SkIntToScalar(i % 64 + 1), 0);
+        path.lineTo(SkIntToScalar(i % 64 + 1), SkIntToScalar(64));
+        path.lineTo(SkIntToScalar(i % 64), SkIntToScalar(64));
+        canvas->drawPath(path, paint);
+    }
+}
+
+static void play_ring(void* reader) {
+    SkGPipeRingBufferReader* ringReader = static_cast<SkGPipeRingBufferReader*>(reader);
+    while (SkGPipeReader::kEOF_Status == ringReader->playback()) {
+        // Spin until the writer is done.
+    }
+}
+
+// Check that a stream many times the size of the ring arrives intact on another thread.
+DEF_TEST(Pipe_RingBuffer, reporter) {
+    SkAutoTMalloc<uint32_t> memory(SkGPipeRingBuffer::ComputeMemorySize(40 * 1024) / 4);
+    REPORTER_ASSERT(reporter, !SkGPipeRingBuffer::Init(memory.get(), 1024));
+    REPORTER_ASSERT(reporter, SkGPipeRingBuffer::Init(memory.get(),
+                                                      SkGPipeRingBuffer::ComputeMemorySize(40 * 1024)));
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(64, 64);
+    actual.allocN32Pixels(64, 64);
+    actual.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas expectedCanvas(expected);
+    expectedCanvas.clear(SK_ColorTRANSPARENT);
+    draw_stripes(&expectedCanvas);
+
+    SkCanvas actualCanvas(actual);
+    SkGPipeRingBufferReader reader(memory.get(), &actualCanvas);
+    SkThread thread(play_ring, &reader);
+    REPORTER_ASSERT(reporter, thread.start());
+
+    SkGPipeRingBufferController controller(memory.get());
+    SkGPipeWriter writer;
+    draw_stripes(writer.startRecording(&controller, SkGPipeWriter::kCrossProcess_Flag));
+    writer.endRecording();
+    thread.join();
+
+    SkAutoLockPixels expectedLock(expected), actualLock(actual);
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+}
+
+// Passes bitmaps by their index in a table, like a controller handing out shared memory handles.
+class ExportingPipeController : public PipeController, public SkGPipeReader::BitmapImporter {
+public:
+    ExportingPipeController(SkCanvas* target) : INHERITED(target), fImports(0) {
+        fReader.setBitmapImporter(this);
+    }
+
+    bool exportBitmap(const SkBitmap& bitmap, uint32_t* handle) override {
+        *handle = fBitmaps.count();
+        fBitmaps.push_back(bitmap);
+        return true;
+    }
+
+    bool importBitmap(uint32_t handle, SkBitmap* dst) override {
+        if (handle >= (uint32_t)fBitmaps.count()) {
+            return false;
+        }
+        *dst = fBitmaps[handle];
+        fImports++;
+        return true;
+    }
+
+    SkTArray<SkBitmap> fBitmaps;
+    int fImports;
+
+private:
+    typedef PipeController INHERITED;
+};
+
+DEF_TEST(Pipe_ExportBitmap, reporter) {
+    SkBitmap target;
+    target.allocN32Pixels(16, 16);
+    target.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(target);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorRED);
+    // Otherwise the writer passes a copy, in case the pixels change.
+    bitmap.setImmutable();
+
+    ExportingPipeController controller(&canvas);
+    SkGPipeWriter writer;
+    SkCanvas* pipeCanvas = writer.startRecording(&controller, SkGPipeWriter::kCrossProcess_Flag);
+    pipeCanvas->drawBitmap(bitmap, 0, 0);
+    pipeCanvas->drawBitmap(bitmap, 8, 8);
+    writer.endRecording();
+
+    // The pixels were passed by handle, once, and never copied into the stream.
+    REPORTER_ASSERT(reporter, 1 == controller.fBitmaps.count());
+    REPORTER_ASSERT(reporter, 1 == controller.fImports);
+    REPORTER_ASSERT(reporter, controller.fBitmaps[0].pixelRef() == bitmap.pixelRef());
+    REPORTER_ASSERT(reporter, SK_ColorRED == target.getColor(0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorRED == target.getColor(12, 12));
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == target.getColor(12, 0));
+}
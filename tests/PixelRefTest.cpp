@@ -2,6 +2,7 @@
 
 #include "SkMallocPixelRef.h"
 #include "SkPixelRef.h"
+#include "SkTaskGroup.h"
 
 class TestListener : public SkPixelRef::GenIDChangeListener {
 public:
@@ -44,3 +45,85 @@ DEF_TEST(PixelRef_GenIDChange, r) {
     pixelRef->addGenIDChangeListener(NULL);
     pixelRef->notifyPixelsChanged();
 }
+
+namespace {
+
+// A pixel ref that counts how often its pixels are really locked and unlocked.
+class CountingPixelRef : public SkPixelRef {
+public:
+    CountingPixelRef() : INHERITED(SkImageInfo::MakeN32Premul(4, 4)), fLocks(0), fUnlocks(0) {}
+
+    int32_t fLocks, fUnlocks;
+
+protected:
+    bool onNewLockPixels(LockRec* rec) override {
+        sk_atomic_inc(&fLocks);
+        rec->fPixels = fStorage;
+        rec->fColorTable = NULL;
+        rec->fRowBytes = 4 * sizeof(SkPMColor);
+        return true;
+    }
+
+    void onUnlockPixels() override { sk_atomic_inc(&fUnlocks); }
+
+private:
+    SkPMColor fStorage[16];
+
+    typedef SkPixelRef INHERITED;
+};
+
+struct Locker {
+    CountingPixelRef* fPixelRef;
+    bool fAlwaysGotPixels;
+
+    static void LockLots(Locker* locker) {
+        locker->fAlwaysGotPixels = true;
+        for (int i = 0; i < 1000; i++) {
+            SkPixelRef::LockRec rec;
+            locker->fAlwaysGotPixels &= locker->fPixelRef->lockPixels(&rec) &&
+                                        rec.fPixels != NULL;
+            locker->fPixelRef->unlockPixels();
+        }
+    }
+};
+
+}  // namespace
+
+DEF_TEST(PixelRef_NestedLocks, r) {
+    CountingPixelRef pixelRef;
+
+    REPORTER_ASSERT(r, pixelRef.lockPixels());
+    REPORTER_ASSERT(r, pixelRef.lockPixels());
+    REPORTER_ASSERT(r, 1 == pixelRef.fLocks);
+    REPORTER_ASSERT(r, pixelRef.pixels());
+
+    pixelRef.unlockPixels();
+    REPORTER_ASSERT(r, 0 == pixelRef.fUnlocks);
+    REPORTER_ASSERT(r, pixelRef.pixels());
+
+    pixelRef.unlockPixels();
+    REPORTER_ASSERT(r, 1 == pixelRef.fUnlocks);
+    REPORTER_ASSERT(r, NULL == pixelRef.pixels());
+}
+
+// Nested locks skip the mutex, so make sure racing lockers still see pixels and stay balanced.
+DEF_TEST(PixelRef_ThreadedLocks, r) {
+    static const int kLockers = 64;
+
+    CountingPixelRef pixelRef;
+    Locker lockers[kLockers];
+    for (int i = 0; i < kLockers; i++) {
+        lockers[i].fPixelRef = &pixelRef;
+    }
+
+    SkTaskGroup tg;
+    tg.batch(Locker::LockLots, lockers, kLockers);
+    tg.wait();
+
+    for (int i = 0; i < kLockers; i++) {
+        REPORTER_ASSERT(r, lockers[i].fAlwaysGotPixels);
+    }
+    REPORTER_ASSERT(r, pixelRef.fLocks > 0);
+    REPORTER_ASSERT(r, pixelRef.fLocks == pixelRef.fUnlocks);
+    REPORTER_ASSERT(r, NULL == pixelRef.pixels());
+}
@@ -8,6 +8,7 @@
 #include "SkBitmapDevice.h"
 #include "SkCanvas.h"
 #include "SkConfig8888.h"
+#include "SkUnPreMultiply.h"
 #include "Test.h"
 #include "sk_tool_utils.h"
 
@@ -131,3 +132,76 @@ DEF_GPUTEST(PremulAlphaRoundTrip, reporter, factory) {
         }
     }
 }
+
+// Converts the premul or unpremul bytes of one RGBA or BGRA pixel the slow way.
+static uint32_t convert_bytes(uint32_t src, bool swapRB, SkAlphaType srcAT, SkAlphaType dstAT) {
+    uint8_t* byte = reinterpret_cast<uint8_t*>(&src);
+    if (swapRB) {
+        SkTSwap(byte[0], byte[2]);
+    }
+    const unsigned a = byte[3];
+    for (int i = 0; i < 3; ++i) {
+        if (kUnpremul_SkAlphaType == srcAT && kPremul_SkAlphaType == dstAT) {
+            byte[i] = SkMulDiv255Round(byte[i], a);
+        } else if (kPremul_SkAlphaType == srcAT && kUnpremul_SkAlphaType == dstAT) {
+            byte[i] = SkUnPreMultiply::ApplyScale(SkUnPreMultiply::GetScale(a), byte[i]);
+        }
+    }
+    return src;
+}
+
+// The platform row procs must match the portable ones for every alpha and color, even colors
+// larger than their alpha, at any width, and in place.
+DEF_TEST(PremulAlphaConvertPixels, reporter) {
+    const int kW = 256 + 7, kH = 256;
+    SkAutoTMalloc<uint32_t> src(kW * kH), dst(kW * kH);
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            uint8_t* byte = reinterpret_cast<uint8_t*>(&src[y * kW + x]);
+            byte[0] = x;
+            byte[1] = x * 7 + y;
+            byte[2] = 255 - x;
+            byte[3] = y;
+        }
+    }
+
+    const SkColorType colorTypes[] = { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType };
+    const SkAlphaType alphaTypes[] = { kPremul_SkAlphaType, kUnpremul_SkAlphaType };
+    for (size_t sc = 0; sc < SK_ARRAY_COUNT(colorTypes); ++sc) {
+    for (size_t dc = 0; dc < SK_ARRAY_COUNT(colorTypes); ++dc) {
+    for (size_t sa = 0; sa < SK_ARRAY_COUNT(alphaTypes); ++sa) {
+    for (size_t da = 0; da < SK_ARRAY_COUNT(alphaTypes); ++da) {
+        for (int inPlace = 0; inPlace < 2; ++inPlace) {
+            SkSrcPixelInfo srcPI;
+            srcPI.fColorType = colorTypes[sc];
+            srcPI.fAlphaType = alphaTypes[sa];
+            srcPI.fRowBytes = kW * sizeof(uint32_t);
+            SkDstPixelInfo dstPI;
+            dstPI.fColorType = colorTypes[dc];
+            dstPI.fAlphaType = alphaTypes[da];
+            dstPI.fRowBytes = kW * sizeof(uint32_t);
+            if (inPlace) {
+                memcpy(dst.get(), src.get(), kW * kH * sizeof(uint32_t));
+                srcPI.fPixels = dst.get();
+            } else {
+                srcPI.fPixels = src.get();
+            }
+            dstPI.fPixels = dst.get();
+            // Odd widths leave a few pixels for the scalar tails in each row.
+            REPORTER_ASSERT(reporter, srcPI.convertPixelsTo(&dstPI, kW - inPlace, kH));
+
+            int mismatches = 0;
+            for (int y = 0; y < kH; ++y) {
+                for (int x = 0; x < kW - inPlace; ++x) {
+                    const uint32_t expected = convert_bytes(src[y * kW + x], sc != dc,
+                                                            alphaTypes[sa], alphaTypes[da]);
+                    mismatches += expected != dst[y * kW + x];
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+        }
+    }
+    }
+    }
+    }
+}
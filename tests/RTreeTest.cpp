@@ -89,3 +89,36 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+// Rects sharing an edge with the query don't intersect it, and every op count from a single
+// rect to several levels of nodes should find exactly what a linear scan finds.
+DEF_TEST(RTree_Grid, reporter) {
+    const int kCounts[] = { 1, 2, SkRTree::kMaxChildren, SkRTree::kMaxChildren + 1, 1000 };
+    for (size_t c = 0; c < SK_ARRAY_COUNT(kCounts); ++c) {
+        const int count = kCounts[c];
+        SkAutoTMalloc<SkRect> rects(count);
+        for (int i = 0; i < count; ++i) {
+            rects[i] = SkRect::MakeXYWH(SkIntToScalar(i % 40), SkIntToScalar(i / 40), 1, 1);
+        }
+        SkRTree rtree;
+        rtree.insert(rects.get(), count);
+        REPORTER_ASSERT(reporter, count == rtree.getCount());
+
+        for (int i = 0; i < count; ++i) {
+            SkTDArray<unsigned> hits;
+            rtree.search(rects[i], &hits);
+            REPORTER_ASSERT(reporter, 1 == hits.count() && (unsigned)i == hits[0]);
+        }
+
+        SkTDArray<unsigned> hits;
+        rtree.search(SkRect::MakeLTRB(-1, -1, 100, 100), &hits);
+        REPORTER_ASSERT(reporter, count == hits.count());
+        for (int i = 0; i < hits.count(); ++i) {
+            REPORTER_ASSERT(reporter, (unsigned)i == hits[i]);
+        }
+
+        hits.rewind();
+        rtree.search(SkRect::MakeLTRB(5, 0, 5, 10), &hits);
+        REPORTER_ASSERT(reporter, 0 == hits.count());
+    }
+}
@@ -8,9 +8,11 @@
 #include "Test.h"
 #include "RecordTestUtils.h"
 
+#include "SkBBHFactory.h"
 #include "SkDebugCanvas.h"
 #include "SkDropShadowImageFilter.h"
 #include "SkImagePriv.h"
+#include "SkPictureRecorder.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
@@ -331,3 +333,172 @@ DEF_TEST(RecordDraw_drawImage, r){
     REPORTER_ASSERT(r, canvas.fDrawImageRectCalled);
 
 }
+
+namespace {
+
+class RecordingProfiler : public SkRecordDrawProfiler {
+public:
+    RecordingProfiler() : fInOrder(true), fNext(0) {}
+
+    void willDraw(unsigned i, SkRecords::Type) override { fInOrder = fInOrder && i == fNext; }
+
+    void didDraw(unsigned i, SkRecords::Type type, int64_t pixels) override {
+        fInOrder = fInOrder && i == fNext++;
+        *fTypes.append() = type;
+        *fPixels.append() = pixels;
+    }
+
+    bool fInOrder;
+    unsigned fNext;
+    SkTDArray<SkRecords::Type> fTypes;
+    SkTDArray<int64_t> fPixels;
+};
+
+}  // namespace
+
+DEF_TEST(RecordDraw_Profile, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 100, 100);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), paint);
+    recorder.save();
+        recorder.clipRect(SkRect::MakeLTRB(0, 0, 15, 15));
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), paint);
+    recorder.restore();
+    recorder.saveLayer(NULL, NULL);
+        recorder.drawRect(SkRect::MakeLTRB(60, 60, 80, 80), paint);
+    recorder.restore();
+    REPORTER_ASSERT(r, 8 == record.count());
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(150, 150);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.scale(2, 2);
+
+    RecordingProfiler profiler;
+    SkRecordProfileDraw(record, SkRect::MakeWH(100, 100), &canvas, NULL, 0, &profiler);
+    REPORTER_ASSERT(r, profiler.fInOrder);
+    REPORTER_ASSERT(r, 8 == profiler.fTypes.count());
+
+    const SkRecords::Type types[] = {
+        SkRecords::DrawRect_Type, SkRecords::Save_Type, SkRecords::ClipRect_Type,
+        SkRecords::DrawRect_Type, SkRecords::Restore_Type, SkRecords::SaveLayer_Type,
+        SkRecords::DrawRect_Type, SkRecords::Restore_Type,
+    };
+    // Pixels are counted in device space, clipped both by the record and by the canvas.
+    const int64_t pixels[] = { 20*20, 0, 0, 10*10, 0, 0, 30*30, 30*30 };
+    for (int i = 0; i < 8; i++) {
+        REPORTER_ASSERT(r, types[i] == profiler.fTypes[i]);
+        REPORTER_ASSERT(r, pixels[i] == profiler.fPixels[i]);
+    }
+
+    // It should still draw.
+    REPORTER_ASSERT(r, SK_ColorBLUE == bitmap.getColor(30, 30));
+    REPORTER_ASSERT(r, SK_ColorBLUE == bitmap.getColor(140, 140));
+    REPORTER_ASSERT(r, SK_ColorWHITE == bitmap.getColor(5, 5));
+}
+
+DEF_TEST(RecordDraw_Occlusion, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 200, 200);
+    SkPaint opaque, translucent, aa;
+    opaque.setColor(SK_ColorBLUE);
+    translucent.setColor(0x80FF0000);
+    aa.setColor(SK_ColorGREEN);
+    aa.setAntiAlias(true);
+
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), opaque);          // 0: hidden
+    recorder.drawOval(SkRect::MakeLTRB(20.5f, 20.5f, 98.5f, 98.5f), aa);  // 1: hidden
+    recorder.drawRect(SkRect::MakeLTRB(90, 90, 150, 150), opaque);        // 2: pokes out
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 100, 100), opaque);          // 3: occluder
+    recorder.drawRect(SkRect::MakeLTRB(20, 20, 40, 40), translucent);     // 4: on top
+    recorder.drawRect(SkRect::MakeLTRB(150, 150, 160, 160), opaque);      // 5: hidden by...
+    SkRRect rrect;
+    rrect.setRectXY(SkRect::MakeLTRB(100, 100, 200, 200), 10, 10);
+    recorder.drawRRect(rrect, opaque);                                    // 6: ...this rrect
+    REPORTER_ASSERT(r, 7 == record.count());
+
+    SkRecordOcclusion occlusion(SkRect::MakeWH(200, 200), record);
+
+    SkRecord rerecord;
+    SkRecorder canvas(&rerecord, 200, 200);
+    SkRecordDraw(record, &canvas, NULL, NULL, 0, NULL/*bbh*/, NULL/*callback*/, &occlusion);
+    REPORTER_ASSERT(r, 4 == rerecord.count());
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::DrawOval>(rerecord));
+    const SkRecords::DrawRect* rect = assert_type<SkRecords::DrawRect>(r, rerecord, 0);
+    REPORTER_ASSERT(r, rect->rect == SkRect::MakeLTRB(90, 90, 150, 150));
+
+    // A canvas that doesn't keep rects rects skips nothing.
+    SkRecord rotated;
+    SkRecorder rotatedCanvas(&rotated, 200, 200);
+    rotatedCanvas.rotate(30);
+    SkRecordDraw(record, &rotatedCanvas, NULL, NULL, 0, NULL/*bbh*/, NULL/*callback*/,
+                 &occlusion);
+    REPORTER_ASSERT(r, 7 == count_instances_of_type<SkRecords::DrawRect>(rotated) +
+                             count_instances_of_type<SkRecords::DrawOval>(rotated) +
+                             count_instances_of_type<SkRecords::DrawRRect>(rotated));
+}
+
+DEF_TEST(RecordDraw_OcclusionRespectsClipsAndLayers, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 200, 200);
+    SkPaint opaque;
+    opaque.setColor(SK_ColorBLUE);
+    SkPath circle;
+    circle.addCircle(50, 50, 30);
+
+    // The corner of the circle's bounds is not covered by the clipped rect.
+    recorder.drawRect(SkRect::MakeLTRB(21, 21, 24, 24), opaque);
+    recorder.save();
+        recorder.clipPath(circle);
+        recorder.drawRect(SkRect::MakeWH(200, 200), opaque);
+    recorder.restore();
+
+    // Nor is anything covered by a rect drawn into a layer.
+    recorder.drawRect(SkRect::MakeLTRB(120, 120, 140, 140), opaque);
+    recorder.saveLayer(NULL, NULL);
+        recorder.drawRect(SkRect::MakeLTRB(100, 100, 200, 200), opaque);
+    recorder.restore();
+
+    SkRecordOcclusion occlusion(SkRect::MakeWH(200, 200), record);
+
+    SkRecord rerecord;
+    SkRecorder canvas(&rerecord, 200, 200);
+    SkRecordDraw(record, &canvas, NULL, NULL, 0, NULL/*bbh*/, NULL/*callback*/, &occlusion);
+    REPORTER_ASSERT(r, 4 == count_instances_of_type<SkRecords::DrawRect>(rerecord));
+}
+
+DEF_TEST(RecordDraw_OcclusionPicture, r) {
+    SkRTreeFactory factory;
+    SkAutoTUnref<SkPicture> pictures[2];
+    for (int i = 0; i < 2; i++) {
+        // The second picture skips occluded ops, but should draw just the same.
+        const uint32_t flags = i ? SkPictureRecorder::kComputeOcclusion_RecordFlag : 0;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100), &factory, flags);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int j = 0; j < 10; j++) {
+            paint.setColor(SkColorSetARGB(0xFF, 0x10 * j, 0x80, 0xFF - 0x10 * j));
+            SkScalar inset = 3.25f * j;
+            canvas->drawRect(SkRect::MakeLTRB(inset, inset, 100 - inset, 100 - inset), paint);
+            canvas->drawCircle(50, 50, 60 - 3.25f * j, paint);
+        }
+        pictures[i].reset(recorder.endRecordingAsPicture());
+    }
+
+    SkBitmap bitmaps[2];
+    for (int i = 0; i < 2; i++) {
+        bitmaps[i].allocN32Pixels(100, 100);
+        bitmaps[i].eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.clipRect(SkRect::MakeLTRB(10, 20, 90, 70));
+        canvas.scale(1.5f, 1.5f);
+        canvas.drawPicture(pictures[i]);
+    }
+    REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                   bitmaps[0].getSize()));
+}
@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "RecordTestUtils.h"
 
+#include "SkBlurDrawLooper.h"
 #include "SkColorFilter.h"
 #include "SkRecord.h"
 #include "SkRecordOpts.h"
@@ -170,7 +171,12 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != NULL);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
+
+    // The first draw shared that paint, and must not have seen the alpha folded in.
+    drawRect = assert_type<SkRecords::DrawRect>(r, record, 1);
+    REPORTER_ASSERT(r, drawRect != NULL);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0xFF020202);
 }
 
 static void assert_merge_svg_opacity_and_filter_layers(skiatest::Reporter* r,
@@ -308,3 +314,115 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     assert_type<SkRecords::Restore>(r, record, index + 3);
     index += 4;
 }
+
+DEF_TEST(RecordOpts_MergeDrawRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+    SkAutoTUnref<SkDrawLooper> looper(SkBlurDrawLooper::Create(SK_ColorBLACK, 1, 2, 2));
+    SkPaint shadowed(red);
+    shadowed.setLooper(looper);
+
+    recorder.drawRect(SkRect::MakeWH(10, 10), red);          // 0: merged into a DrawRects
+    recorder.drawRect(SkRect::MakeWH(20, 20), red);          // 1: NoOp
+    recorder.drawRect(SkRect::MakeWH(30, 30), red);          // 2: NoOp
+    recorder.drawRect(SkRect::MakeWH(40, 40), blue);         // 3: different paint, left alone
+    recorder.drawOval(SkRect::MakeWH(40, 40), blue);         // 4: not a DrawRect
+    recorder.drawRect(SkRect::MakeWH(50, 50), blue);         // 5: merged into a DrawRects
+    recorder.drawRect(SkRect::MakeWH(60, 60), blue);         // 6: NoOp
+    recorder.drawRect(SkRect::MakeWH(70, 70), shadowed);     // 7: loopers aren't merged
+    recorder.drawRect(SkRect::MakeWH(80, 80), shadowed);     // 8: loopers aren't merged
+
+    record.replace<SkRecords::NoOp>(1);  // NoOps should be allowed.
+
+    SkRecordMergeDrawRects(&record);
+
+    const SkRecords::DrawRects* reds = assert_type<SkRecords::DrawRects>(r, record, 0);
+    REPORTER_ASSERT(r, 2 == reds->count);
+    REPORTER_ASSERT(r, SkRect::MakeWH(10, 10) == reds->rects[0]);
+    REPORTER_ASSERT(r, SkRect::MakeWH(30, 30) == reds->rects[1]);
+    REPORTER_ASSERT(r, red == reds->paint);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::DrawOval>(r, record, 4);
+
+    const SkRecords::DrawRects* blues = assert_type<SkRecords::DrawRects>(r, record, 5);
+    REPORTER_ASSERT(r, 2 == blues->count);
+    REPORTER_ASSERT(r, SkRect::MakeWH(60, 60) == blues->rects[1]);
+    assert_type<SkRecords::NoOp>(r, record, 6);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+    assert_type<SkRecords::DrawRect>(r, record, 8);
+}
+
+// Records big enough for SkRecordOptimize to split should still come out exactly as if each pass
+// ran over the whole record.
+static void record_many_layers(SkRecorder* recorder) {
+    SkPaint alphaOnlyLayerPaint;
+    alphaOnlyLayerPaint.setColor(0x03000000);
+    SkPaint drawPaint;
+    drawPaint.setColor(0xFF020202);
+    const SkRect rect = SkRect::MakeWH(100, 100);
+
+    for (int i = 0; i < 6000; i++) {
+        if (i % 1000 == 500) {
+            // Keep a save open for a while, so some cuts have to wait for it to close.
+            recorder->save();
+        }
+        if (i % 1000 == 700) {
+            recorder->restore();
+        }
+        if (i % 3) {
+            recorder->saveLayer(NULL, &alphaOnlyLayerPaint);
+            recorder->drawRect(rect, drawPaint);
+            recorder->restore();
+        } else {
+            recorder->saveLayer(NULL, &alphaOnlyLayerPaint);
+            recorder->save();
+            recorder->clipRect(rect);
+            recorder->saveLayer(NULL, &drawPaint);
+            recorder->restore();
+            recorder->restore();
+            recorder->restore();
+        }
+    }
+}
+
+// Identifies an op by its type and, for the ops recorded above, its paint's alpha.
+struct TypeAndAlpha {
+    int operator()(const SkRecords::DrawRect& draw) {
+        return 256 * SkRecords::DrawRect::kType + draw.paint->getAlpha();
+    }
+    int operator()(const SkRecords::DrawRects& draw) {
+        return 256 * SkRecords::DrawRects::kType + draw.paint->getAlpha();
+    }
+    int operator()(const SkRecords::SaveLayer& saveLayer) {
+        return 256 * SkRecords::SaveLayer::kType + (saveLayer.paint ? saveLayer.paint->getAlpha()
+                                                                     : 255);
+    }
+    template <typename T>
+    int operator()(const T&) { return 256 * T::kType; }
+};
+
+DEF_TEST(RecordOpts_OptimizeLargeRecord, r) {
+    SkRecord parallel, serial;
+    SkRecorder parallelRecorder(&parallel, W, H);
+    SkRecorder serialRecorder(&serial, W, H);
+    record_many_layers(&parallelRecorder);
+    record_many_layers(&serialRecorder);
+
+    SkRecordOptimize(&parallel);
+    SkRecordNoopSaveLayerDrawRestores(&serial);
+    SkRecordMergeSvgOpacityAndFilterLayers(&serial);
+    SkRecordMergeDrawRects(&serial);
+
+    REPORTER_ASSERT(r, parallel.count() == serial.count());
+    REPORTER_ASSERT(r, count_instances_of_type<SkRecords::NoOp>(serial) > 0);
+    TypeAndAlpha id;
+    for (unsigned i = 0; i < parallel.count(); i++) {
+        REPORTER_ASSERT(r, parallel.visit<int>(i, id) == serial.visit<int>(i, id));
+    }
+}
@@ -90,6 +90,19 @@ DEF_TEST(RecordPattern_Star, r) {
     REPORTER_ASSERT(r, pattern.match(&record, index));
 }
 
+DEF_TEST(RecordPattern_TrailingStar, r) {
+    Pattern2<Is<Save>, Star<Is<ClipRect> > > pattern;
+
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1200);
+
+    // A Star can match all the way to the end of the record.
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(300, 200));
+        recorder.clipRect(SkRect::MakeWH(100, 100));
+    REPORTER_ASSERT(r, 3 == pattern.match(&record, 0));
+}
+
 DEF_TEST(RecordPattern_Complex, r) {
     Pattern3<Is<Save>,
              Star<Not<Or3<Is<Save>,
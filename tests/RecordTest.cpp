@@ -76,6 +76,47 @@ DEF_TEST(Record, r) {
     REPORTER_ASSERT(r, summer.area() == 500);
 }
 
+// Shared commands stay alive with the SkRecord sharing them, and are destroyed exactly once.
+DEF_TEST(Record_Shared, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(1, 1);
+    SkAutoTUnref<SkShader> shader(SkShader::CreateBitmapShader(bm, SkShader::kClamp_TileMode,
+                                                               SkShader::kClamp_TileMode));
+    SkPaint paint;
+    paint.setShader(shader);
+    paint.setShader(NULL);
+    const int32_t baseRefCnt = shader->getRefCnt();
+    paint.setShader(shader);
+
+    SkRecord* src = SkNEW(SkRecord);
+    APPEND((*src), SkRecords::DrawRect, paint, SkRect::MakeWH(10, 10));
+    src->append<SkRecords::NoOp>();
+    APPEND((*src), SkRecords::DrawRect, paint, SkRect::MakeWH(20, 20));
+
+    {
+        SkRecord shared;
+        for (unsigned i = 0; i < src->count(); i++) {
+            shared.appendShared(*src, i);
+        }
+        REPORTER_ASSERT(r, shared.isShared(0));
+        REPORTER_ASSERT(r, !shared.isShared(1));  // Empty commands are never marked.
+
+        // Replacing a shared command just forgets it.
+        SkNEW_PLACEMENT_ARGS(shared.replace<SkRecords::DrawRect>(2), SkRecords::DrawRect,
+                             (paint, SkRect::MakeWH(5, 5)));
+        REPORTER_ASSERT(r, !shared.isShared(2));
+
+        // The shared DrawRect outlives src being unref'd here.
+        src->unref();
+        AreaSummer summer;
+        summer.apply(shared);
+        REPORTER_ASSERT(r, summer.area() == 125);
+        // Our paint, src's two DrawRects, and the new one.
+        REPORTER_ASSERT(r, shader->getRefCnt() == baseRefCnt + 4);
+    }
+    REPORTER_ASSERT(r, shader->getRefCnt() == baseRefCnt + 1);
+}
+
 #undef APPEND
 
 template <typename T>
@@ -6,6 +6,7 @@
  */
 
 #include "Test.h"
+#include "RecordTestUtils.h"
 
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
@@ -89,6 +90,43 @@ DEF_TEST(Recorder_RefLeaking, r) {
     REPORTER_ASSERT(r, paint.getShader()->unique());
 }
 
+// Ops recorded with equal paints should share one copy of the paint.
+DEF_TEST(Recorder_InternsPaints, r) {
+    SkPaint paint;
+    paint.setShader(SkShader::CreateEmptyShader())->unref();
+    SkPaint other;
+    other.setColor(SK_ColorBLUE);
+
+    SkRecord record;
+    {
+        SkRecorder recorder(&record, 1920, 1080);
+        for (int i = 0; i < 100; i++) {
+            recorder.drawRect(SkRect::MakeXYWH(SkIntToScalar(i), 0, 10, 10), paint);
+            recorder.drawOval(SkRect::MakeXYWH(SkIntToScalar(i), 0, 10, 10), other);
+        }
+        recorder.drawPaint(paint);
+    }
+    REPORTER_ASSERT(r, 201 == record.count());
+
+    // The recorder is gone, so only the one shared copy of paint refs the shader.
+    REPORTER_ASSERT(r, 2 == paint.getShader()->getRefCnt());
+
+    const SkRecords::PaintBox* rectPaint = assert_type<SkRecords::DrawRect>(r, record, 0)
+            ->paint.box();
+    const SkRecords::PaintBox* ovalPaint = assert_type<SkRecords::DrawOval>(r, record, 1)
+            ->paint.box();
+    REPORTER_ASSERT(r, rectPaint != ovalPaint);
+    for (unsigned i = 0; i < 200; i += 2) {
+        REPORTER_ASSERT(r, rectPaint == assert_type<SkRecords::DrawRect>(r, record, i)
+                ->paint.box());
+        REPORTER_ASSERT(r, ovalPaint == assert_type<SkRecords::DrawOval>(r, record, i + 1)
+                ->paint.box());
+    }
+    REPORTER_ASSERT(r, rectPaint == assert_type<SkRecords::DrawPaint>(r, record, 200)
+            ->paint.box());
+    REPORTER_ASSERT(r, SK_ColorBLUE == ovalPaint->fPaint.getColor());
+}
+
 DEF_TEST(Recorder_RefPictures, r) {
     SkAutoTUnref<SkPicture> pic;
 
@@ -256,6 +256,14 @@ DEF_TEST(Region, reporter) {
         }
         REPORTER_ASSERT(reporter, test_rects(rect, N));
     }
+    for (int i = 0; i < 100; i++) {
+        const int N = 64;
+        SkIRect rect[N];
+        for (int j = 0; j < N; j++) {
+            rand_rect(&rect[j], rand);
+        }
+        REPORTER_ASSERT(reporter, test_rects(rect, N));
+    }
 
     test_proc(reporter, contains_proc);
     test_proc(reporter, intersects_proc);
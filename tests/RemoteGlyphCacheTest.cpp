@@ -0,0 +1,176 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkFontMgr_indirect.h"
+#include "SkRemoteGlyphCache.h"
+#include "SkStream.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+namespace {
+
+// Knows one font, the default typeface, as data id 0.
+class DefaultFontMgr : public SkRemotableFontMgr {
+public:
+    SkDataTable* getFamilyNames() const override { return SkDataTable::NewEmpty(); }
+    SkRemotableFontIdentitySet* getIndex(int) const override {
+        return SkRemotableFontIdentitySet::NewEmpty();
+    }
+    SkFontIdentity matchIndexStyle(int, const SkFontStyle& style) const override {
+        return this->identity(style);
+    }
+    SkRemotableFontIdentitySet* matchName(const char[]) const override {
+        return SkRemotableFontIdentitySet::NewEmpty();
+    }
+    SkFontIdentity matchNameStyle(const char[], const SkFontStyle& style) const override {
+        return this->identity(style);
+    }
+    SkFontIdentity matchNameStyleCharacter(const char[], const SkFontStyle& style,
+                                           const char*[], int, SkUnichar) const override {
+        return this->identity(style);
+    }
+    SkStreamAsset* getData(int dataId) const override {
+        if (0 != dataId) {
+            return NULL;
+        }
+        SkAutoTUnref<SkTypeface> typeface(SkTypeface::RefDefault());
+        return typeface->openStream(NULL);
+    }
+
+private:
+    SkFontIdentity identity(const SkFontStyle& style) const {
+        SkFontIdentity id;
+        id.fDataId = 0;
+        id.fTtcIndex = 0;
+        id.fFontStyle = style;
+        return id;
+    }
+};
+
+// Hands requests straight to a broker in this process.
+class DirectTransport : public SkRemoteGlyphCacheClient::Transport {
+public:
+    explicit DirectTransport(SkRemoteGlyphCacheBroker* broker) : fBroker(broker), fCount(0) {}
+
+    void sendRequest(const void* request, size_t length) override {
+        fCount++;
+        fBroker->handleRequest(request, length);
+    }
+
+    int count() const { return fCount; }
+
+private:
+    SkRemoteGlyphCacheBroker* fBroker;
+    int fCount;
+};
+
+}  // namespace
+
+static void draw_text(SkBitmap* bitmap, SkTypeface* typeface, const SkPaint& base) {
+    bitmap->allocN32Pixels(256, 64);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    SkPaint paint(base);
+    paint.setTypeface(typeface);
+    canvas.drawText("Hamburgefons", 12, 5.3f, 20, paint);
+    canvas.rotate(5);
+    canvas.drawText("Hamburgefons", 12, 10, 50, paint);
+}
+
+static bool draws_like(SkTypeface* typeface, SkTypeface* local, const SkPaint& paint) {
+    SkBitmap expected, actual;
+    draw_text(&expected, local, paint);
+    draw_text(&actual, typeface, paint);
+    SkAutoLockPixels lockExpected(expected), lockActual(actual);
+    return 0 == memcmp(expected.getPixels(), actual.getPixels(), expected.getSize());
+}
+
+static SkFontIdentity default_identity() {
+    SkFontIdentity id;
+    id.fDataId = 0;
+    id.fTtcIndex = 0;
+    id.fFontStyle = SkFontStyle();
+    return id;
+}
+
+DEF_TEST(RemoteGlyphCache, reporter) {
+    // Text must draw the same whether its glyphs come from the broker or the local font.
+    const size_t memorySize = 1 << 20;
+    SkAutoTMalloc<uint32_t> memory(memorySize / sizeof(uint32_t));
+    REPORTER_ASSERT(reporter, !SkRemoteGlyphCache::Init(memory.get(), 64));
+    REPORTER_ASSERT(reporter, SkRemoteGlyphCache::Init(memory.get(), memorySize));
+
+    SkAutoTUnref<DefaultFontMgr> fonts(SkNEW(DefaultFontMgr));
+    SkRemoteGlyphCacheBroker broker(memory.get(), fonts);
+    DirectTransport transport(&broker);
+    SkAutoTUnref<SkRemoteGlyphCacheClient> client(
+            SkNEW_ARGS(SkRemoteGlyphCacheClient, (memory.get(), &transport)));
+
+    SkAutoTUnref<SkTypeface> local(SkTypeface::RefDefault());
+    SkAutoTUnref<SkTypeface> typeface(client->createTypeface(local, default_identity()));
+    REPORTER_ASSERT(reporter, typeface->uniqueID() != local->uniqueID());
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(17);
+    REPORTER_ASSERT(reporter, draws_like(typeface, local, paint));
+    const int requests = transport.count();
+    REPORTER_ASSERT(reporter, requests > 0);
+
+    paint.setSubpixelText(true);
+    REPORTER_ASSERT(reporter, draws_like(typeface, local, paint));
+    REPORTER_ASSERT(reporter, transport.count() > requests);
+
+    // Stroked glyphs are made from the local font's outlines.
+    const int subpixelRequests = transport.count();
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(1);
+    REPORTER_ASSERT(reporter, draws_like(typeface, local, paint));
+    REPORTER_ASSERT(reporter, transport.count() == subpixelRequests);
+
+    // Another renderer finds every glyph already published.
+    SkAutoTUnref<SkRemoteGlyphCacheClient> otherClient(
+            SkNEW_ARGS(SkRemoteGlyphCacheClient, (memory.get(), &transport)));
+    SkAutoTUnref<SkTypeface> otherTypeface(otherClient->createTypeface(local,
+                                                                       default_identity()));
+    paint.setStyle(SkPaint::kFill_Style);
+    REPORTER_ASSERT(reporter, draws_like(otherTypeface, local, paint));
+    paint.setSubpixelText(false);
+    REPORTER_ASSERT(reporter, draws_like(otherTypeface, local, paint));
+    REPORTER_ASSERT(reporter, transport.count() == subpixelRequests);
+
+    // Requests are not trusted.
+    REPORTER_ASSERT(reporter, !broker.handleRequest(memory.get(), 3));
+}
+
+DEF_TEST(RemoteGlyphCache_FontMgrIndirect, reporter) {
+    const size_t memorySize = 1 << 20;
+    SkAutoTMalloc<uint32_t> memory(memorySize / sizeof(uint32_t));
+    REPORTER_ASSERT(reporter, SkRemoteGlyphCache::Init(memory.get(), memorySize));
+
+    SkAutoTUnref<DefaultFontMgr> fonts(SkNEW(DefaultFontMgr));
+    SkRemoteGlyphCacheBroker broker(memory.get(), fonts);
+    DirectTransport transport(&broker);
+    SkAutoTUnref<SkRemoteGlyphCacheClient> client(
+            SkNEW_ARGS(SkRemoteGlyphCacheClient, (memory.get(), &transport)));
+
+    SkAutoTUnref<SkFontMgr> impl(SkFontMgr::RefDefault());
+    SkAutoTUnref<SkFontMgr> fontMgr(SkNEW_ARGS(SkFontMgr_Indirect, (impl, fonts, client)));
+    SkAutoTUnref<SkTypeface> typeface(fontMgr->matchFamilyStyle("any", SkFontStyle()));
+    REPORTER_ASSERT(reporter, typeface.get());
+    if (NULL == typeface.get()) {
+        return;
+    }
+
+    SkAutoTUnref<SkTypeface> local(SkTypeface::RefDefault());
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(17);
+    REPORTER_ASSERT(reporter, draws_like(typeface, local, paint));
+    REPORTER_ASSERT(reporter, transport.count() > 0);
+}
@@ -893,6 +893,77 @@ static void test_cache_chained_purge(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, 0 == TestResource::NumAlive());
 }
 
+static void test_purge_priority(skiatest::Reporter* reporter) {
+    Mock mock(3, 30000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    GrUniqueKey key1, key2, key3, key4, key5, key6;
+    make_unique_key<0>(&key1, 1);
+    make_unique_key<0>(&key2, 2);
+    make_unique_key<0>(&key3, 3);
+    make_unique_key<0>(&key4, 4);
+    make_unique_key<0>(&key5, 5);
+    make_unique_key<0>(&key6, 6);
+
+    // Oldest to newest: high, default, low.
+    TestResource* high = SkNEW_ARGS(TestResource, (context->getGpu()));
+    high->resourcePriv().setUniqueKey(key1);
+    high->resourcePriv().setPurgePriority(GrGpuResource::kHigh_PurgePriority);
+    high->unref();
+    TestResource* a = SkNEW_ARGS(TestResource, (context->getGpu()));
+    a->resourcePriv().setUniqueKey(key2);
+    a->unref();
+    TestResource* low = SkNEW_ARGS(TestResource, (context->getGpu()));
+    low->resourcePriv().setUniqueKey(key3);
+    low->resourcePriv().setPurgePriority(GrGpuResource::kLow_PurgePriority);
+    low->unref();
+
+    // Going over budget purges the low priority resource first, even though it's the newest.
+    TestResource* b = SkNEW_ARGS(TestResource, (context->getGpu()));
+    b->resourcePriv().setUniqueKey(key4);
+    b->unref();
+    REPORTER_ASSERT(reporter, 3 == TestResource::NumAlive());
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key1));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key2));
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key3));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key4));
+
+    cache->resetStats();
+    SkSafeUnref(cache->findAndRefUniqueResource(key2));
+    REPORTER_ASSERT(reporter, NULL == cache->findAndRefUniqueResource(key3));
+
+    // Among the rest, LRU order decides: b is now older than a.
+    TestResource* c = SkNEW_ARGS(TestResource, (context->getGpu()));
+    c->resourcePriv().setUniqueKey(key5);
+    c->unref();
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key1));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key2));
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key4));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key5));
+
+    int hits, misses, purges;
+    context->getResourceCacheStats(&hits, &misses, &purges);
+    REPORTER_ASSERT(reporter, 1 == hits);
+    REPORTER_ASSERT(reporter, 1 == misses);
+    REPORTER_ASSERT(reporter, 1 == purges);
+
+    // Raising the priority of a purgeable resource takes effect right away.
+    a->resourcePriv().setPurgePriority(GrGpuResource::kHigh_PurgePriority);
+    TestResource* d = SkNEW_ARGS(TestResource, (context->getGpu()));
+    d->resourcePriv().setUniqueKey(key6);
+    d->unref();
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key2));
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(key5));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(key6));
+    REPORTER_ASSERT(reporter, 2 == cache->getPurgeCount());
+
+    context->resetResourceCacheStats();
+    REPORTER_ASSERT(reporter, 0 == cache->getHitCount());
+    REPORTER_ASSERT(reporter, 0 == cache->getMissCount());
+    REPORTER_ASSERT(reporter, 0 == cache->getPurgeCount());
+}
+
 static void test_resource_size_changed(skiatest::Reporter* reporter) {
     GrUniqueKey key1, key2;
     make_unique_key<0>(&key1, 1);
@@ -1116,6 +1187,7 @@ DEF_GPUTEST(ResourceCache, reporter, factory) {
     test_scratch_key_consistency(reporter);
     test_purge_invalidated(reporter);
     test_cache_chained_purge(reporter);
+    test_purge_priority(reporter);
     test_resource_size_changed(reporter);
     test_timestamp_wrap(reporter);
     test_large_resource_count(reporter);
@@ -147,3 +147,41 @@ DEF_TEST(SVGDevice_whitespace_pos, reporter) {
         test_whitespace_pos(reporter, tests[i].tst_in, tests[i].tst_out);
     }
 }
+
+DEF_TEST(SVGDevice_path_data, reporter) {
+    SkPath path;
+    path.moveTo(10.125f, 20);
+    path.lineTo(30, 20.5f);
+    path.lineTo(30, 40);
+    SkPaint paint;
+
+    // Streamed straight to the output...
+    SkDynamicMemoryWStream stream;
+    {
+        SkXMLStreamWriter writer(&stream);
+        SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(SkRect::MakeWH(100, 100), &writer,
+                                                             SkParsePath::kRelative_PathEncoding,
+                                                             1));
+        svgCanvas->drawPath(path, paint);
+    }
+    SkAutoTUnref<SkData> svg(stream.copyToData());
+    SkString svgString(static_cast<const char*>(svg->data()), svg->size());
+    REPORTER_ASSERT(reporter, svgString.contains(" d=\"m10.1 20l19.9 0.5 0 19.5\""));
+
+    // ... or buffered by a writer that can't stream.
+    SkDOM dom;
+    {
+        SkXMLParserWriter writer(dom.beginParsing());
+        SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(SkRect::MakeWH(100, 100), &writer,
+                                                             SkParsePath::kAbsolute_PathEncoding,
+                                                             0));
+        svgCanvas->drawPath(path, paint);
+    }
+    const SkDOM::Node* root = dom.finishParsing();
+    const SkDOM::Node* pathElem = root ? dom.getFirstChild(root, "path") : NULL;
+    REPORTER_ASSERT(reporter, pathElem);
+    if (pathElem) {
+        const char* d = dom.findAttr(pathElem, "d");
+        REPORTER_ASSERT(reporter, d && 0 == strcmp(d, "M10 20L30 21 30 40"));
+    }
+}
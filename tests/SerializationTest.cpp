@@ -484,6 +484,23 @@ DEF_TEST(Serialization, reporter) {
         TestArraySerialization(data, reporter);
     }
 
+    // Test reads past the end
+    {
+        const SkScalar data[3] = { 1, 2, 3 };
+        SkValidatingReadBuffer reader(data, sizeof(data));
+        SkPoint point;
+        reader.readPoint(&point);
+        REPORTER_ASSERT(reporter, reader.isValid() && point == SkPoint::Make(1, 2));
+        reader.readPoint(&point);
+        REPORTER_ASSERT(reporter, !reader.isValid() && point.isZero());
+        REPORTER_ASSERT(reporter, 0 == reader.readInt());
+
+        // A size that would wrap around when aligned is still out of bounds.
+        SkValidatingReadBuffer skipper(data, sizeof(data));
+        skipper.skip(SIZE_MAX);
+        REPORTER_ASSERT(reporter, !skipper.isValid());
+    }
+
     // Test invalid deserializations
     {
         SkImageInfo info = SkImageInfo::MakeN32Premul(kBitmapSize, kBitmapSize);
@@ -75,4 +75,51 @@ DEF_TEST(SkNf, r) {
 
     test_Nf<4, float>(r);
     test_Nf<4, double>(r);
+
+    int32_t is[4];
+    Sk4f(1.9f, -1.9f, 65535.5f, -0.5f).castTrunc().store(is);
+    REPORTER_ASSERT(r, is[0] == 1 && is[1] == -1 && is[2] == 65535 && is[3] == 0);
+}
+
+template <int N, typename T>
+static void test_Ni(skiatest::Reporter* r) {
+    auto assert_eq = [&](const SkNi<N,T>& v, T a, T b, T c, T d) {
+        T vals[4];
+        v.store(vals);
+        REPORTER_ASSERT(r, vals[0] == a && vals[1] == b && vals[2] == c && vals[3] == d);
+        REPORTER_ASSERT(r,    v[0] == a &&    v[1] == b &&    v[2] == c &&    v[3] == d);
+    };
+
+    T vals[] = {3, 4, 5, 6};
+    SkNi<N,T> a = SkNi<N,T>::Load(vals),
+              b(a),
+              c = a;
+    SkNi<N,T> d;
+    d = a;
+
+    assert_eq(a, 3, 4, 5, 6);
+    assert_eq(b, 3, 4, 5, 6);
+    assert_eq(c, 3, 4, 5, 6);
+    assert_eq(d, 3, 4, 5, 6);
+
+    assert_eq(a+b, 6, 8, 10, 12);
+    assert_eq(a-b-b, -3, -4, -5, -6);
+    assert_eq(-a, -3, -4, -5, -6);
+    assert_eq(SkNi<N,T>(7), 7, 7, 7, 7);
+    assert_eq(SkNi<N,T>(1, 2, 3, 4) + a, 4, 6, 8, 10);
+
+    a += SkNi<N,T>(1);
+    assert_eq(a, 4, 5, 6, 7);
+
+    assert_eq(a & SkNi<N,T>(5), 4, 5, 4, 5);
+    assert_eq(a | SkNi<N,T>(1), 5, 5, 7, 7);
+    assert_eq(a ^ SkNi<N,T>(6), 2, 3, 0, 1);
+    assert_eq(a << 2, 16, 20, 24, 28);
+    assert_eq(a >> 1, 2, 2, 3, 3);
+    assert_eq(-a >> 1, -2, -3, -3, -4);
+}
+
+DEF_TEST(SkNi, r) {
+    test_Ni<4, int32_t>(r);
+    test_Ni<4, int16_t>(r);
 }
@@ -7,7 +7,9 @@
 
 #include "Test.h"
 #include "SkBitmapCache.h"
+#include "SkBitmapProcState.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkDiscardableMemoryPool.h"
 #include "SkGraphics.h"
 #include "SkResourceCache.h"
@@ -79,6 +81,63 @@ DEF_TEST(ResourceCache_SingleAllocationByteLimit, reporter) {
     SkGraphics::SetResourceCacheTotalByteLimit(originalByteLimit);
 }
 
+static void draw_high_quality(const SkBitmap& bitmap, SkBitmap* result) {
+    const SkScalar w = SkIntToScalar(kBitmapSize * kScale);
+    const SkScalar h = SkIntToScalar(kBitmapSize * kScale / 2);
+    result->allocN32Pixels(SkScalarRoundToInt(w), SkScalarRoundToInt(h));
+    result->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*result);
+    SkPaint paint;
+    paint.setFilterQuality(kHigh_SkFilterQuality);
+    canvas.drawBitmapRect(bitmap, SkRect::MakeWH(w, h), &paint);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    return a.dimensions() == b.dimensions() &&
+           0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+DEF_TEST(ResourceCache_AsyncHighQualityScaling, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(kBitmapSize, kBitmapSize);
+    for (int y = 0; y < kBitmapSize; ++y) {
+        for (int x = 0; x < kBitmapSize; ++x) {
+            *src.getAddr32(x, y) = SkPackARGB32(0xFF, x * 16, y * 16, (x ^ y) * 16);
+        }
+    }
+    const SkScalar xScale = SkIntToScalar(kScale);
+    const SkScalar yScale = xScale / 2;
+
+    // The same pixels scaled the usual synchronous way.
+    SkBitmap expected;
+    {
+        SkBitmap copy;
+        REPORTER_ASSERT(reporter, src.copyTo(&copy));
+        draw_high_quality(copy, &expected);
+        REPORTER_ASSERT(reporter, is_in_scaled_image_cache(copy, xScale, yScale));
+    }
+
+    const bool wasEnabled = SkGraphics::SetAsyncHighQualityScalingEnabled(true);
+
+    // Mutable bitmaps are still scaled before the draw returns.
+    SkBitmap mutableCopy, drawn;
+    REPORTER_ASSERT(reporter, src.copyTo(&mutableCopy));
+    draw_high_quality(mutableCopy, &drawn);
+    REPORTER_ASSERT(reporter, is_in_scaled_image_cache(mutableCopy, xScale, yScale));
+    REPORTER_ASSERT(reporter, equal_pixels(expected, drawn));
+
+    // Immutable ones may draw at low quality until their scale is cached, then draw at high.
+    src.setImmutable();
+    draw_high_quality(src, &drawn);
+    SkBitmapProcState::WaitForAsyncHQScales();
+    REPORTER_ASSERT(reporter, is_in_scaled_image_cache(src, xScale, yScale));
+    draw_high_quality(src, &drawn);
+    REPORTER_ASSERT(reporter, equal_pixels(expected, drawn));
+
+    SkGraphics::SetAsyncHighQualityScalingEnabled(wasEnabled);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 
 static void make_bitmap(SkBitmap* bitmap, const SkImageInfo& info, SkBitmap::Allocator* allocator) {
@@ -286,3 +345,84 @@ DEF_TEST(BitmapCache_discarded_bitmap, reporter) {
     test_bitmap_notify(reporter, cache);
     test_mipmap_notify(reporter, cache);
 }
+
+#include "SkTArray.h"
+#include "SkTraceMemoryDump.h"
+
+namespace {
+
+class TestMemoryDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char* units,
+                          uint64_t value) override {
+        Entry* entry = &fEntries.push_back();
+        entry->fDumpName.set(dumpName);
+        entry->fValueName.set(valueName);
+        entry->fValue = value;
+    }
+
+    // Returns true and sets value if dumpName reported valueName.
+    bool find(const char* dumpName, const char* valueName, uint64_t* value) const {
+        for (int i = 0; i < fEntries.count(); ++i) {
+            if (fEntries[i].fDumpName.equals(dumpName) &&
+                fEntries[i].fValueName.equals(valueName)) {
+                *value = fEntries[i].fValue;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Entry {
+        SkString fDumpName;
+        SkString fValueName;
+        uint64_t fValue;
+    };
+    SkTArray<Entry> fEntries;
+};
+
+}  // namespace
+
+DEF_TEST(ResourceCache_CategoryStats, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkBitmap bitmaps[2];
+    for (int i = 0; i < 2; ++i) {
+        make_bitmap(&bitmaps[i], SkImageInfo::MakeN32Premul(5, 5), NULL);
+        bitmaps[i].setImmutable();
+        REPORTER_ASSERT(reporter, SkBitmapCache::Add(bitmaps[i].pixelRef(),
+                                                     SkIRect::MakeWH(5, 5), bitmaps[i], &cache));
+    }
+    SkSafeUnref(SkMipMapCache::AddAndRef(bitmaps[0], &cache));
+
+    SkTDArray<SkResourceCache::CategoryStats> stats;
+    cache.addCategoryStats(&stats);
+    REPORTER_ASSERT(reporter, 2 == stats.count());
+    size_t total = 0;
+    for (int i = 0; i < stats.count(); ++i) {
+        const bool isBitmap = 0 == strcmp("bitmap", stats[i].fCategory);
+        REPORTER_ASSERT(reporter, isBitmap || 0 == strcmp("mipmap", stats[i].fCategory));
+        REPORTER_ASSERT(reporter, (isBitmap ? 2 : 1) == stats[i].fCount);
+        REPORTER_ASSERT(reporter, stats[i].fPurgeableBytes == stats[i].fBytes);
+        total += stats[i].fBytes;
+    }
+    REPORTER_ASSERT(reporter, total == cache.getTotalBytesUsed());
+
+    TestMemoryDump dump;
+    SkResourceCache::DumpCategoryStats("test", stats, &dump);
+    uint64_t count;
+    REPORTER_ASSERT(reporter, dump.find("test/bitmap", "count", &count) && 2 == count);
+}
+
+DEF_TEST(Graphics_DumpMemoryStatistics, reporter) {
+    TestMemoryDump dump;
+    SkGraphics::DumpMemoryStatistics(&dump);
+
+    uint64_t value;
+    REPORTER_ASSERT(reporter, dump.find("skia/sk_glyph_cache", "size", &value));
+    REPORTER_ASSERT(reporter, dump.find("skia/sk_typeface_cache", "count", &value));
+    REPORTER_ASSERT(reporter, dump.find("skia/sk_decoded_image_cache", "limit", &value));
+    REPORTER_ASSERT(reporter, dump.find("skia/sk_discardable_memory_pool", "size", &value));
+    REPORTER_ASSERT(reporter, dump.find("skia/sk_resource_cache", "limit", &value));
+    REPORTER_ASSERT(reporter, SkGraphics::GetResourceCacheTotalByteLimit() == value);
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkData.h"
+#include "SkFrontBufferedStream.h"
 #include "SkOSFile.h"
 #include "SkRandom.h"
 #include "SkStream.h"
@@ -185,8 +186,57 @@ static void TestNullData() {
 
 }
 
+// Reads all of stream through peekMemory and skip, checking it against expected.
+static void test_peek_memory(skiatest::Reporter* reporter, SkStream* stream,
+                             const char* expected, size_t length) {
+    size_t offset = 0;
+    size_t size;
+    while (const void* memory = stream->peekMemory(&size)) {
+        if (0 == size) {
+            break;
+        }
+        REPORTER_ASSERT(reporter, offset + size <= length);
+        REPORTER_ASSERT(reporter, !memcmp(memory, expected + offset, size));
+        REPORTER_ASSERT(reporter, stream->skip(size) == size);
+        offset += size;
+    }
+    REPORTER_ASSERT(reporter, offset == length);
+    REPORTER_ASSERT(reporter, stream->isAtEnd());
+}
+
+static void TestPeekMemory(skiatest::Reporter* reporter) {
+    char data[1000];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (char)i;
+    }
+
+    SkMemoryStream memStream(data, sizeof(data));
+    memStream.skip(10);
+    size_t size;
+    REPORTER_ASSERT(reporter, memStream.peekMemory(&size) == data + 10);
+    REPORTER_ASSERT(reporter, size == sizeof(data) - 10);
+    memStream.rewind();
+    test_peek_memory(reporter, &memStream, data, sizeof(data));
+
+    // Many small writes spread the data over several blocks, each a window of its own.
+    SkDynamicMemoryWStream wStream;
+    for (size_t i = 0; i < sizeof(data); i += 10) {
+        wStream.write(data + i, 10);
+    }
+    SkAutoTDelete<SkStreamAsset> blockStream(wStream.detachAsStream());
+    test_peek_memory(reporter, blockStream, data, sizeof(data));
+
+    // Buffering a memory stream copies nothing: the buffered stream peeks at the original data.
+    SkAutoTDelete<SkStreamRewindable> buffered(SkFrontBufferedStream::Create(
+            SkNEW_ARGS(SkMemoryStream, (data, sizeof(data))), 64));
+    REPORTER_ASSERT(reporter, buffered->peekMemory(&size) == data);
+    REPORTER_ASSERT(reporter, size == sizeof(data));
+    test_peek_memory(reporter, buffered, data, sizeof(data));
+}
+
 DEF_TEST(Stream, reporter) {
     TestWStream(reporter);
     TestPackedUInt(reporter);
     TestNullData();
+    TestPeekMemory(reporter);
 }
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkResourceCache.h"
+#include "SkStrokeCache.h"
+#include "Test.h"
+
+static SkPath make_polyline() {
+    SkPath path;
+    path.moveTo(10, 10);
+    for (int i = 1; i < 20; ++i) {
+        path.lineTo(SkIntToScalar(10 + 9 * i), SkIntToScalar(i & 1 ? 40 : 15));
+    }
+    return path;
+}
+
+DEF_TEST(StrokeCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path = make_polyline();
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(4);
+    SkStrokeRec rec(paint);
+
+    SkPath result;
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &result, &cache));
+
+    SkPath stroked;
+    rec.applyToPath(&stroked, path);
+    SkStrokeCache::Add(path, rec, stroked, &cache);
+
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, &result, &cache));
+    REPORTER_ASSERT(reporter, result == stroked);
+
+    // Any change to the stroke or the path is a different entry.
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, SkStrokeRec(paint), &result, &cache));
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, SkStrokeRec(paint, 2), &result, &cache));
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &result, &cache));
+
+    // Purging the path's entries (or the whole cache) drops them.
+    path = make_polyline();
+    SkStrokeCache::Add(path, rec, stroked, &cache);
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, &result, &cache));
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &result, &cache));
+}
+
+DEF_TEST(StrokeCache_Draw, reporter) {
+    const bool wasEnabled = SkGraphics::SetStrokeCacheEnabled(true);
+
+    SkPath path = make_polyline();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(5);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(200, 50);
+    actual.allocN32Pixels(200, 50);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+
+    SkGraphics::SetStrokeCacheEnabled(false);
+    SkCanvas(expected).drawPath(path, paint);
+    SkGraphics::SetStrokeCacheEnabled(true);
+
+    SkStrokeCache::ResetStats();
+    SkCanvas canvas(actual);
+    for (int i = 0; i < 3; ++i) {
+        actual.eraseColor(SK_ColorWHITE);
+        canvas.drawPath(path, paint);
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(expected.getPixels(), actual.getPixels(), actual.getSize()));
+    }
+
+    // The global cache is shared with other tests running in parallel (which may purge it), so
+    // only check that the draws went through it and that it was useful at least once.
+    SkStrokeCache::Stats stats;
+    SkStrokeCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fHits >= 1);
+    REPORTER_ASSERT(reporter, stats.fHits + stats.fMisses >= 3);
+
+    SkGraphics::SetStrokeCacheEnabled(wasEnabled);
+}
@@ -531,11 +531,79 @@ static void TestSurfaceNoCanvas(skiatest::Reporter* reporter,
 
 }
 
+static SkPMColor image_pixel(SkImage* image, int x, int y) {
+    SkPMColor pixel = 0;
+    image->readPixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, sizeof(pixel), x, y);
+    return pixel;
+}
+
+static const void* surface_addr(SkSurface* surface) {
+    SkImageInfo info;
+    size_t rowBytes;
+    return surface->peekPixels(&info, &rowBytes);
+}
+
+static SkPMColor surface_pixel(SkSurface* surface, int x, int y) {
+    SkImageInfo info;
+    size_t rowBytes;
+    const void* addr = surface->peekPixels(&info, &rowBytes);
+    return ((const SkPMColor*)((const char*)addr + y * rowBytes))[x];
+}
+
+// Snapshot every frame, then draw a small update, while the previous frame's snapshot is still
+// alive. The surface should alternate between two sets of pixels, only fixing up what changed.
+static void test_raster_snapshot_per_frame(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(600, 600));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorRED);
+    const SkPMColor red   = SkPreMultiplyColor(SK_ColorRED),
+                    green = SkPreMultiplyColor(SK_ColorGREEN),
+                    blue  = SkPreMultiplyColor(SK_ColorBLUE);
+    SkPaint paint;
+
+    SkAutoTUnref<SkImage> frame0(surface->newImageSnapshot());
+    const void* pixels0 = surface_addr(surface);
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);   // Copy-on-write.
+    const void* pixels1 = surface_addr(surface);
+    REPORTER_ASSERT(reporter, pixels0 != pixels1);
+    REPORTER_ASSERT(reporter, red == image_pixel(frame0, 15, 15));
+
+    SkAutoTUnref<SkImage> frame1(surface->newImageSnapshot());
+    frame0.reset(NULL);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(550, 550, 20, 20), paint); // Reuses frame0's old pixels.
+    REPORTER_ASSERT(reporter, pixels0 == surface_addr(surface));
+    REPORTER_ASSERT(reporter, green == surface_pixel(surface, 15, 15));
+    REPORTER_ASSERT(reporter, blue  == surface_pixel(surface, 555, 555));
+    REPORTER_ASSERT(reporter, red   == surface_pixel(surface, 300, 300));
+    REPORTER_ASSERT(reporter, green == image_pixel(frame1, 15, 15));
+    REPORTER_ASSERT(reporter, red   == image_pixel(frame1, 555, 555));
+
+    SkAutoTUnref<SkImage> frame2(surface->newImageSnapshot());
+    frame1.reset(NULL);
+    canvas->clear(SK_ColorRED);                                  // Back to pixels1.
+    REPORTER_ASSERT(reporter, pixels1 == surface_addr(surface));
+    REPORTER_ASSERT(reporter, red   == surface_pixel(surface, 15, 15));
+    REPORTER_ASSERT(reporter, red   == surface_pixel(surface, 555, 555));
+    REPORTER_ASSERT(reporter, green == image_pixel(frame2, 15, 15));
+    REPORTER_ASSERT(reporter, blue  == image_pixel(frame2, 555, 555));
+
+    SkAutoTUnref<SkImage> frame3(surface->newImageSnapshot());
+    frame2.reset(NULL);
+    canvas->drawPoint(0, 0, SK_ColorGREEN);                      // pixels0 must catch up fully.
+    REPORTER_ASSERT(reporter, green == surface_pixel(surface, 0, 0));
+    REPORTER_ASSERT(reporter, red   == surface_pixel(surface, 15, 15));
+    REPORTER_ASSERT(reporter, red   == surface_pixel(surface, 555, 555));
+    REPORTER_ASSERT(reporter, red   == image_pixel(frame3, 0, 0));
+}
+
 DEF_GPUTEST(Surface, reporter, factory) {
     test_image(reporter);
 
     TestSurfaceCopyOnWrite(reporter, kRaster_SurfaceType, NULL);
     TestSurfaceWritableAfterSnapshotRelease(reporter, kRaster_SurfaceType, NULL);
+    test_raster_snapshot_per_frame(reporter);
     TestSurfaceNoCanvas(reporter, kRaster_SurfaceType, NULL, SkSurface::kDiscard_ContentChangeMode);
     TestSurfaceNoCanvas(reporter, kRaster_SurfaceType, NULL, SkSurface::kRetain_ContentChangeMode);
 
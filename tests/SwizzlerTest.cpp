@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "SkSwizzler.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// Odd widths leave pixels for the scalar tails of the platform procs.
+static const int kWidths[] = { 1, 3, 4, 7, 8, 16, 37 };
+
+// The expected conversion of one src pixel, matching the portable procs.
+static SkPMColor expected_color(SkSwizzler::SrcConfig config, SkAlphaType alphaType,
+                                const uint8_t* src, const SkPMColor ctable[]) {
+    switch (config) {
+        case SkSwizzler::kIndex:
+            return ctable[src[0]];
+        case SkSwizzler::kRGB:
+        case SkSwizzler::kRGBX:
+            return SkPackARGB32NoCheck(0xFF, src[0], src[1], src[2]);
+        case SkSwizzler::kRGBA:
+            return kPremul_SkAlphaType == alphaType
+                    ? SkPreMultiplyARGB(src[3], src[0], src[1], src[2])
+                    : SkPackARGB32NoCheck(src[3], src[0], src[1], src[2]);
+        default:
+            SkASSERT(false);
+            return 0;
+    }
+}
+
+static void check_swizzle(skiatest::Reporter* r, SkSwizzler::SrcConfig config,
+                          SkAlphaType alphaType, const uint8_t* src, int width,
+                          const SkPMColor ctable[]) {
+    const SkImageInfo info = SkImageInfo::MakeN32(width, 1, alphaType);
+    SkAutoTMalloc<SkPMColor> dst(width);
+    SkAutoTDelete<SkSwizzler> swizzler(SkSwizzler::CreateSwizzler(config, ctable, info,
+            dst.get(), info.minRowBytes(), SkImageGenerator::kNo_ZeroInitialized));
+    REPORTER_ASSERT(r, swizzler);
+    if (!swizzler) {
+        return;
+    }
+    const SkSwizzler::ResultAlpha result = swizzler->next(src);
+
+    const int bytesPerPixel = SkSwizzler::BytesPerPixel(config);
+    uint8_t zeroAlpha = 0;
+    uint8_t maxAlpha = 0xFF;
+    for (int x = 0; x < width; ++x) {
+        const SkPMColor expected = expected_color(config, alphaType, src + x * bytesPerPixel,
+                                                  ctable);
+        REPORTER_ASSERT(r, expected == dst[x]);
+        zeroAlpha |= SkGetPackedA32(expected);
+        maxAlpha &= SkGetPackedA32(expected);
+    }
+    REPORTER_ASSERT(r, SkSwizzler::GetResult(zeroAlpha, maxAlpha) == result);
+}
+
+// Whether or not the platform has SIMD versions, every width should match the portable procs.
+DEF_TEST(Swizzler_N32, r) {
+    static const int kMaxWidth = 37;
+    SkRandom rand;
+    uint8_t src[kMaxWidth * 4];
+    SkPMColor ctable[256];
+    for (int i = 0; i < 256; ++i) {
+        const U8CPU a = rand.nextU() & 0xFF;
+        ctable[i] = SkPreMultiplyARGB(a, rand.nextU() & 0xFF, rand.nextU() & 0xFF,
+                                      rand.nextU() & 0xFF);
+    }
+
+    for (int fill = 0; fill < 3; ++fill) {
+        for (size_t i = 0; i < sizeof(src); ++i) {
+            src[i] = rand.nextU() & 0xFF;
+        }
+        // Also convert fully opaque and fully transparent rows.
+        if (fill > 0) {
+            for (int x = 0; x < kMaxWidth; ++x) {
+                src[4*x + 3] = 1 == fill ? 0xFF : 0;
+            }
+        }
+        for (size_t i = 0; i < SK_ARRAY_COUNT(kWidths); ++i) {
+            const int width = kWidths[i];
+            check_swizzle(r, SkSwizzler::kRGBA, kPremul_SkAlphaType, src, width, NULL);
+            check_swizzle(r, SkSwizzler::kRGBA, kUnpremul_SkAlphaType, src, width, NULL);
+            check_swizzle(r, SkSwizzler::kRGBX, kOpaque_SkAlphaType, src, width, NULL);
+            check_swizzle(r, SkSwizzler::kRGB, kOpaque_SkAlphaType, src, width, NULL);
+            check_swizzle(r, SkSwizzler::kIndex, kPremul_SkAlphaType, src, width, ctable);
+        }
+    }
+}
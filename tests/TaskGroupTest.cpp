@@ -0,0 +1,165 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+static void add_one(int32_t* counter) {
+    sk_atomic_inc(counter);
+}
+
+DEF_TEST(SkTaskGroup_Batch, r) {
+    int32_t counter = 0;
+    const int kTasks = 1000;
+    int32_t* counters[kTasks];
+    for (int i = 0; i < kTasks; i++) {
+        counters[i] = &counter;
+    }
+
+    SkTaskGroup tg;
+    for (int i = 0; i < kTasks; i++) {
+        tg.add(add_one, &counter);
+    }
+    tg.wait();
+    REPORTER_ASSERT(r, kTasks == sk_atomic_load(&counter));
+
+    // batch() hands each task one element of the array.
+    int32_t values[kTasks];
+    sk_bzero(values, sizeof(values));
+    tg.batch(add_one, values, kTasks);
+    tg.wait();
+    for (int i = 0; i < kTasks; i++) {
+        REPORTER_ASSERT(r, 1 == values[i]);
+    }
+}
+
+namespace {
+
+// Each node spawns its children into a group of its own and waits for them, so the pool threads
+// end up waiting on work that was added from inside other tasks.
+struct Node {
+    int      fDepth;
+    int32_t* fCount;
+};
+
+static void visit(Node* node) {
+    sk_atomic_inc(node->fCount);
+    if (0 == node->fDepth) {
+        return;
+    }
+    Node children[4];
+    for (int i = 0; i < 4; i++) {
+        children[i].fDepth = node->fDepth - 1;
+        children[i].fCount = node->fCount;
+    }
+    SkTaskGroup tg;
+    tg.add(visit, &children[0]);
+    tg.batch(visit, &children[1], 3);
+    tg.wait();
+}
+
+}  // namespace
+
+DEF_TEST(SkTaskGroup_Nested, r) {
+    int32_t count = 0;
+    Node root = { 5, &count };
+    SkTaskGroup tg;
+    tg.add(visit, &root);
+    tg.wait();
+    // 1 + 4 + 16 + ... + 4^5
+    REPORTER_ASSERT(r, 1365 == sk_atomic_load(&count));
+}
+
+static void bump(int i, int32_t* values) {
+    sk_atomic_inc(&values[i]);
+}
+
+DEF_TEST(SkTaskGroup_ParallelFor, r) {
+    const int kCount = 1000;
+    int32_t values[kCount];
+    const int grains[] = { 0, 1, 7, kCount, 2 * kCount };
+    for (size_t g = 0; g < SK_ARRAY_COUNT(grains); g++) {
+        sk_bzero(values, sizeof(values));
+        sk_parallel_for(10, kCount - 10, grains[g], bump, values);
+        for (int i = 0; i < kCount; i++) {
+            REPORTER_ASSERT(r, (i >= 10 && i < kCount - 10) == (1 == values[i]));
+        }
+    }
+    // An empty range calls nothing.
+    sk_parallel_for(5, 5, 0, bump, values);
+    sk_parallel_for(5, 0, 0, bump, values);
+    REPORTER_ASSERT(r, 0 == values[5]);
+}
+
+namespace {
+
+// Each step records when it ran, as a count of the steps that ran before it.
+struct Step {
+    int32_t* fClock;
+    int32_t  fRanAt;
+};
+
+static void tick(Step* step) {
+    step->fRanAt = sk_atomic_inc(step->fClock);
+}
+
+}  // namespace
+
+DEF_TEST(SkTask_Chain, r) {
+    int32_t clock = 0;
+    const int kSteps = 50;
+    Step steps[kSteps];
+    SkTaskGroup tg;
+    SkAutoTDelete<SkTask> tasks[kSteps];
+    for (int i = 0; i < kSteps; i++) {
+        steps[i].fClock = &clock;
+        steps[i].fRanAt = -1;
+        tasks[i].reset(SkNEW_ARGS(SkTask, (&tg, tick, &steps[i])));
+        if (i > 0) {
+            tasks[i]->runAfter(tasks[i - 1]);
+        }
+    }
+    // Start them back to front, so none can run just because it was started first.
+    for (int i = kSteps - 1; i >= 0; i--) {
+        tasks[i]->start();
+    }
+    tg.wait();
+    for (int i = 0; i < kSteps; i++) {
+        REPORTER_ASSERT(r, i == steps[i].fRanAt);
+    }
+}
+
+DEF_TEST(SkTask_Diamond, r) {
+    // top fans out to kMiddle tasks, which all feed bottom.
+    int32_t clock = 0;
+    const int kMiddle = 16;
+    Step top = { &clock, -1 }, bottom = { &clock, -1 };
+    Step middle[kMiddle];
+    SkTaskGroup tg;
+    SkTask topTask(&tg, tick, &top), bottomTask(&tg, tick, &bottom);
+    SkAutoTDelete<SkTask> middleTasks[kMiddle];
+    for (int i = 0; i < kMiddle; i++) {
+        middle[i].fClock = &clock;
+        middle[i].fRanAt = -1;
+        middleTasks[i].reset(SkNEW_ARGS(SkTask, (&tg, tick, &middle[i])));
+        middleTasks[i]->runAfter(&topTask);
+        bottomTask.runAfter(middleTasks[i]);
+    }
+    bottomTask.start();
+    for (int i = 0; i < kMiddle; i++) {
+        middleTasks[i]->start();
+    }
+    topTask.start();
+    tg.wait();
+    REPORTER_ASSERT(r, 0 == top.fRanAt);
+    for (int i = 0; i < kMiddle; i++) {
+        REPORTER_ASSERT(r, middle[i].fRanAt > 0 && middle[i].fRanAt <= kMiddle);
+    }
+    REPORTER_ASSERT(r, kMiddle + 1 == bottom.fRanAt);
+}
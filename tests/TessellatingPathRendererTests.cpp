@@ -230,16 +230,17 @@ static SkPath create_path_15() {
     return path;
 }
 
-static void test_path(GrDrawTarget* dt, GrRenderTarget* rt, const SkPath& path) {
+static void test_path(GrDrawTarget* dt, GrRenderTarget* rt, const SkPath& path,
+                      const SkMatrix& matrix = SkMatrix::I()) {
     GrTessellatingPathRenderer tess;
     GrPipelineBuilder pipelineBuilder;
     pipelineBuilder.setRenderTarget(rt);
     SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
-    tess.drawPath(dt, &pipelineBuilder, SK_ColorWHITE, SkMatrix::I(), path, stroke, false);
+    tess.drawPath(dt, &pipelineBuilder, SK_ColorWHITE, matrix, path, stroke, false);
 }
 
 DEF_GPUTEST(TessellatingPathRendererTests, reporter, factory) {
-    GrContext* context = factory->get(static_cast<GrContextFactory::GLContextType>(0));
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
     GrSurfaceDesc desc;
     desc.fFlags = kRenderTarget_GrSurfaceFlag;
     desc.fWidth = 800;
@@ -249,26 +250,85 @@ DEF_GPUTEST(TessellatingPathRendererTests, reporter, factory) {
     SkAutoTUnref<GrTexture> texture(
         context->refScratchTexture(desc, GrContext::kExact_ScratchTexMatch)
     );
-    GrTestTarget tt;
-    context->getTestTarget(&tt);
+    {
+        GrTestTarget tt;
+        context->getTestTarget(&tt);
+        GrRenderTarget* rt = texture->asRenderTarget();
+        GrDrawTarget* dt = tt.target();
+
+        test_path(dt, rt, create_path_0());
+        test_path(dt, rt, create_path_1());
+        test_path(dt, rt, create_path_2());
+        test_path(dt, rt, create_path_3());
+        test_path(dt, rt, create_path_4());
+        test_path(dt, rt, create_path_5());
+        test_path(dt, rt, create_path_6());
+        test_path(dt, rt, create_path_7());
+        test_path(dt, rt, create_path_8());
+        test_path(dt, rt, create_path_9());
+        test_path(dt, rt, create_path_10());
+        test_path(dt, rt, create_path_11());
+        test_path(dt, rt, create_path_12());
+        test_path(dt, rt, create_path_13());
+        test_path(dt, rt, create_path_14());
+        test_path(dt, rt, create_path_15());
+    }
+
+    // The paths aren't tessellated until their batches close.
+    context->flush();
+}
+
+// Draws path and returns how many resources the context's cache gained.
+static int count_new_resources(GrContext* context, GrRenderTarget* rt, const SkPath& path,
+                               const SkMatrix& matrix) {
+    int before;
+    context->getResourceCacheUsage(&before, NULL);
+    {
+        GrTestTarget tt;
+        context->getTestTarget(&tt);
+        test_path(tt.target(), rt, path, matrix);
+    }
+    context->flush();
+    int after;
+    context->getResourceCacheUsage(&after, NULL);
+    return after - before;
+}
+
+// Redrawing a path at the same scale reuses its cached tessellation.
+DEF_GPUTEST(TessellatingPathRendererCache, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+    GrSurfaceDesc desc;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = 800;
+    desc.fHeight = 800;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+    SkAutoTUnref<GrTexture> texture(
+        context->refScratchTexture(desc, GrContext::kExact_ScratchTexMatch)
+    );
     GrRenderTarget* rt = texture->asRenderTarget();
-    GrDrawTarget* dt = tt.target();
 
-    test_path(dt, rt, create_path_0());
-    test_path(dt, rt, create_path_1());
-    test_path(dt, rt, create_path_2());
-    test_path(dt, rt, create_path_3());
-    test_path(dt, rt, create_path_4());
-    test_path(dt, rt, create_path_5());
-    test_path(dt, rt, create_path_6());
-    test_path(dt, rt, create_path_7());
-    test_path(dt, rt, create_path_8());
-    test_path(dt, rt, create_path_9());
-    test_path(dt, rt, create_path_10());
-    test_path(dt, rt, create_path_11());
-    test_path(dt, rt, create_path_12());
-    test_path(dt, rt, create_path_13());
-    test_path(dt, rt, create_path_14());
-    test_path(dt, rt, create_path_15());
+    SkPath path;
+    path.moveTo(10, 10);
+    path.lineTo(50, 30);
+    path.lineTo(90, 10);
+    path.quadTo(50, 90, 10, 10);
+    REPORTER_ASSERT(reporter, 1 == count_new_resources(context, rt, path, SkMatrix::I()));
+
+    SkMatrix matrix;
+    matrix.setTranslate(30, 40);
+    REPORTER_ASSERT(reporter, 0 == count_new_resources(context, rt, path, matrix));
+    matrix.setRotate(90);
+    REPORTER_ASSERT(reporter, 0 == count_new_resources(context, rt, path, matrix));
+
+    // A new scale changes the tolerance, and needs a new tessellation.
+    matrix.setScale(4, 4);
+    REPORTER_ASSERT(reporter, 1 == count_new_resources(context, rt, path, matrix));
+
+    // So does changing the path.
+    path.lineTo(200, 200);
+    REPORTER_ASSERT(reporter, 1 == count_new_resources(context, rt, path, SkMatrix::I()));
 }
 #endif
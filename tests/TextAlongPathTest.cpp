@@ -0,0 +1,184 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkResourceCache.h"
+#include "SkTextAlongPath.h"
+#include "Test.h"
+
+static const char kText[] = "Mountain View";
+
+DEF_TEST(TextAlongPath_MeasureCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.quadTo(100, 0, 190, 40);
+
+    SkTextAlongPath::ResetStats();
+    SkAutoTUnref<SkSharedPathMeasure> first(SkTextAlongPath::RefMeasure(path, &cache));
+    SkAutoTUnref<SkSharedPathMeasure> second(SkTextAlongPath::RefMeasure(path, &cache));
+    REPORTER_ASSERT(reporter, first.get() == second.get());
+    REPORTER_ASSERT(reporter, first->length() > SkIntToScalar(180));
+
+    // A copy of the path measures the same, so it shares the entry.
+    SkPath copy(path);
+    SkAutoTUnref<SkSharedPathMeasure> third(SkTextAlongPath::RefMeasure(copy, &cache));
+    REPORTER_ASSERT(reporter, first.get() == third.get());
+
+    SkTextAlongPath::Stats stats;
+    SkTextAlongPath::GetStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fHits >= 2);
+    REPORTER_ASSERT(reporter, stats.fMisses >= 1);
+
+    // Editing the path is a different entry.
+    copy.lineTo(190, 100);
+    third.reset(SkTextAlongPath::RefMeasure(copy, &cache));
+    REPORTER_ASSERT(reporter, first.get() != third.get());
+    REPORTER_ASSERT(reporter, third->length() > first->length());
+
+    // Volatile paths aren't cached.
+    path.setIsVolatile(true);
+    third.reset(SkTextAlongPath::RefMeasure(path, &cache));
+    REPORTER_ASSERT(reporter, first.get() != third.get());
+    path.setIsVolatile(false);
+
+    // Purging the cache drops the entries.
+    cache.purgeAll();
+    third.reset(SkTextAlongPath::RefMeasure(path, &cache));
+    REPORTER_ASSERT(reporter, first.get() != third.get());
+}
+
+DEF_TEST(TextAlongPath_Xforms, reporter) {
+    const size_t length = strlen(kText);
+
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(16));
+    SkAutoTMalloc<SkScalar> widths(length);
+    const int count = paint.getTextWidths(kText, length, widths.get());
+    const SkScalar textWidth = paint.measureText(kText, length);
+
+    SkPath line;
+    line.moveTo(10, 50);
+    line.lineTo(310, 50);
+    SkAutoTUnref<SkSharedPathMeasure> measure(SkTextAlongPath::RefMeasure(line));
+
+    SkTDArray<uint16_t> glyphs;
+    SkTDArray<SkRSXform> xforms;
+
+    // Along a horizontal line each glyph just sits where drawText() would put it, with the
+    // matrix's y translate moving every glyph off the line.
+    const SkScalar kTolerance = SK_Scalar1 / 256;
+    static const SkPaint::Align kAligns[] = {
+        SkPaint::kLeft_Align, SkPaint::kCenter_Align, SkPaint::kRight_Align,
+    };
+    const SkScalar starts[] = {
+        10, 10 + SkScalarHalf(300 - textWidth), 10 + 300 - textWidth,
+    };
+    SkMatrix matrix;
+    matrix.setTranslate(0, -5);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kAligns); ++i) {
+        paint.setTextAlign(kAligns[i]);
+        REPORTER_ASSERT(reporter, SkTextAlongPath::ComputeXforms(kText, length, paint, *measure,
+                                                              &matrix, &glyphs, &xforms));
+        REPORTER_ASSERT(reporter, count == xforms.count());
+        REPORTER_ASSERT(reporter, glyphs.count() == xforms.count());
+
+        SkScalar x = starts[i];
+        for (int j = 0; j < xforms.count(); ++j) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fSCos, 1, kTolerance));
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fSSin, 0, kTolerance));
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fTx, x, kTolerance));
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fTy, 45, kTolerance));
+            x += widths[j];
+        }
+    }
+
+    // Going down, the glyphs turn a quarter and step along y, and "up" points to +x.
+    SkPath down;
+    down.moveTo(50, 10);
+    down.lineTo(50, 310);
+    measure.reset(SkTextAlongPath::RefMeasure(down));
+    paint.setTextAlign(SkPaint::kLeft_Align);
+    REPORTER_ASSERT(reporter, SkTextAlongPath::ComputeXforms(kText, length, paint, *measure,
+                                                          &matrix, &glyphs, &xforms));
+    REPORTER_ASSERT(reporter, count == xforms.count());
+    SkScalar y = 10;
+    for (int j = 0; j < xforms.count(); ++j) {
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fSCos, 0, kTolerance));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fSSin, 1, kTolerance));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fTx, 55, kTolerance));
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(xforms[j].fTy, y, kTolerance));
+        y += widths[j];
+    }
+
+    // Glyphs whose middles run off the end of the path are dropped.
+    SkPath shortLine;
+    shortLine.moveTo(0, 0);
+    shortLine.lineTo(SkScalarHalf(textWidth), 0);
+    measure.reset(SkTextAlongPath::RefMeasure(shortLine));
+    REPORTER_ASSERT(reporter, SkTextAlongPath::ComputeXforms(kText, length, paint, *measure,
+                                                          NULL, &glyphs, &xforms));
+    REPORTER_ASSERT(reporter, xforms.count() > 0 && xforms.count() < count);
+
+    // Vertical text and matrices that do more than translate need the outlines.
+    matrix.setRotate(10);
+    REPORTER_ASSERT(reporter, !SkTextAlongPath::ComputeXforms(kText, length, paint, *measure,
+                                                           &matrix, &glyphs, &xforms));
+    paint.setVerticalText(true);
+    REPORTER_ASSERT(reporter, !SkTextAlongPath::ComputeXforms(kText, length, paint, *measure,
+                                                           NULL, &glyphs, &xforms));
+}
+
+static SkIRect ink_bounds(const SkBitmap& bitmap) {
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x) {
+            if (*bitmap.getAddr32(x, y) != SK_ColorWHITE) {
+                bounds.join(x, y, x + 1, y + 1);
+            }
+        }
+    }
+    return bounds;
+}
+
+DEF_TEST(TextAlongPath_Draw, reporter) {
+    const size_t length = strlen(kText);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(SkIntToScalar(24));
+
+    SkPath arc;
+    arc.moveTo(20, 150);
+    arc.quadTo(150, 20, 280, 150);
+
+    SkBitmap bent, fast;
+    bent.allocN32Pixels(300, 200);
+    fast.allocN32Pixels(300, 200);
+
+    const bool wasEnabled = SkGraphics::SetFastTextOnPathEnabled(false);
+    bent.eraseColor(SK_ColorWHITE);
+    SkCanvas(bent).drawTextOnPath(kText, length, arc, NULL, paint);
+
+    SkGraphics::SetFastTextOnPathEnabled(true);
+    fast.eraseColor(SK_ColorWHITE);
+    SkCanvas(fast).drawTextOnPath(kText, length, arc, NULL, paint);
+    SkGraphics::SetFastTextOnPathEnabled(wasEnabled);
+
+    // Rotating whole glyphs doesn't bend them, so only expect them to cover about the same area.
+    const SkIRect bentBounds = ink_bounds(bent);
+    const SkIRect fastBounds = ink_bounds(fast);
+    REPORTER_ASSERT(reporter, !bentBounds.isEmpty());
+    REPORTER_ASSERT(reporter, !fastBounds.isEmpty());
+    const int kSlop = 3;
+    REPORTER_ASSERT(reporter, SkTAbs(bentBounds.fLeft - fastBounds.fLeft) <= kSlop);
+    REPORTER_ASSERT(reporter, SkTAbs(bentBounds.fTop - fastBounds.fTop) <= kSlop);
+    REPORTER_ASSERT(reporter, SkTAbs(bentBounds.fRight - fastBounds.fRight) <= kSlop);
+    REPORTER_ASSERT(reporter, SkTAbs(bentBounds.fBottom - fastBounds.fBottom) <= kSlop);
+}
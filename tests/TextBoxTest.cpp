@@ -0,0 +1,71 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPaint.h"
+#include "SkTextBox.h"
+#include "Test.h"
+
+static const char kText[] = "The quick brown fox jumps over the lazy dog.\n"
+                            "Pack my box with five dozen liquor jugs.";
+
+DEF_TEST(TextBox_BreakLines, reporter) {
+    const size_t len = strlen(kText);
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(12));
+    const SkScalar width = SkIntToScalar(80);
+
+    SkTDArray<SkTextLineBreaker::Line> lines;
+    int count = SkTextLineBreaker::BreakLines(kText, len, paint, width, &lines);
+    REPORTER_ASSERT(reporter, count == lines.count());
+    REPORTER_ASSERT(reporter, count == SkTextLineBreaker::CountLines(kText, len, paint, width));
+    REPORTER_ASSERT(reporter, count > 2);
+
+    // The lines cover the text in order, and each fits in the width.
+    size_t end = 0;
+    for (int i = 0; i < lines.count(); ++i) {
+        REPORTER_ASSERT(reporter, lines[i].fOffset >= end);
+        end = lines[i].fOffset + lines[i].fLength;
+        REPORTER_ASSERT(reporter, end <= len);
+        REPORTER_ASSERT(reporter,
+                        paint.measureText(kText + lines[i].fOffset, lines[i].fLength) <= width);
+    }
+    REPORTER_ASSERT(reporter, len == end);
+
+    // Dev-kerned text is measured a line at a time instead, and still breaks into lines.
+    paint.setDevKernText(true);
+    REPORTER_ASSERT(reporter, SkTextLineBreaker::CountLines(kText, len, paint, width) > 2);
+}
+
+// SkTextBox keeps the lines it broke the text into; changing what they depend on must not leave
+// it with stale ones.
+DEF_TEST(TextBox_LinesCache, reporter) {
+    const size_t len = strlen(kText);
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(12));
+
+    SkTextBox box;
+    box.setBox(0, 0, SkIntToScalar(80), SkIntToScalar(400));
+    box.setText(kText, len, paint);
+    const int count = box.countLines();
+    REPORTER_ASSERT(reporter, count == SkTextLineBreaker::CountLines(kText, len, paint, 80));
+    REPORTER_ASSERT(reporter, count == box.countLines());
+
+    paint.setColor(SK_ColorRED);
+    REPORTER_ASSERT(reporter, count == box.countLines());
+
+    box.setBox(0, 0, SkIntToScalar(200), SkIntToScalar(400));
+    REPORTER_ASSERT(reporter, SkTextLineBreaker::CountLines(kText, len, paint, 200) ==
+                              box.countLines());
+    REPORTER_ASSERT(reporter, box.countLines() < count);
+
+    paint.setTextSize(SkIntToScalar(24));
+    REPORTER_ASSERT(reporter, SkTextLineBreaker::CountLines(kText, len, paint, 200) ==
+                              box.countLines());
+
+    box.setText(kText, 10, paint);
+    REPORTER_ASSERT(reporter, 1 == box.countLines());
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkResourceCache.h"
+#include "SkTextBlob.h"
+#include "SkTextRunCache.h"
+#include "Test.h"
+
+static const char kText[] = "Mountain View Ave.";
+
+DEF_TEST(TextRunCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    const size_t length = strlen(kText);
+
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(18));
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length, paint, &cache));
+
+    SkAutoTUnref<const SkTextBlob> blob(SkTextRunCache::Create(kText, length, paint));
+    REPORTER_ASSERT(reporter, blob);
+    SkTextRunCache::Add(kText, length, paint, blob, &cache);
+
+    SkAutoTUnref<const SkTextBlob> found(SkTextRunCache::Find(kText, length, paint, &cache));
+    REPORTER_ASSERT(reporter, found.get() == blob.get());
+
+    // The blob is just another way to draw the text, at any alignment.
+    static const SkPaint::Align kAligns[] = {
+        SkPaint::kLeft_Align, SkPaint::kCenter_Align, SkPaint::kRight_Align,
+    };
+    static const SkScalar kXs[] = { 10, 100, 190 };
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(200, 50);
+    actual.allocN32Pixels(200, 50);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kAligns); ++i) {
+        paint.setTextAlign(kAligns[i]);
+        expected.eraseColor(SK_ColorWHITE);
+        SkCanvas(expected).drawText(kText, length, kXs[i], 30, paint);
+
+        SkAutoTUnref<const SkTextBlob> aligned(SkTextRunCache::Create(kText, length, paint));
+        SkPaint leftPaint(paint);
+        leftPaint.setTextAlign(SkPaint::kLeft_Align);
+        actual.eraseColor(SK_ColorWHITE);
+        SkCanvas(actual).drawTextBlob(aligned, kXs[i], 30, leftPaint);
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(expected.getPixels(), actual.getPixels(), actual.getSize()));
+    }
+
+    // Any change to the text or the font is a different entry.
+    paint.setTextAlign(SkPaint::kCenter_Align);
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length, paint, &cache));
+    paint.setTextAlign(SkPaint::kLeft_Align);
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length - 1, paint, &cache));
+    paint.setTextSize(SkIntToScalar(19));
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length, paint, &cache));
+    paint.setTextSize(SkIntToScalar(18));
+    paint.setTextSkewX(-SK_Scalar1 / 4);
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length, paint, &cache));
+    paint.setTextSkewX(0);
+    paint.setLinearText(true);
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length, paint, &cache));
+
+    // Vertical text isn't cached.
+    paint.setLinearText(false);
+    paint.setVerticalText(true);
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Create(kText, length, paint));
+
+    // Purging the cache drops the entries.
+    paint.setVerticalText(false);
+    found.reset(SkTextRunCache::Find(kText, length, paint, &cache));
+    REPORTER_ASSERT(reporter, found);
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, NULL == SkTextRunCache::Find(kText, length, paint, &cache));
+}
+
+DEF_TEST(TextRunCache_Draw, reporter) {
+    const bool wasEnabled = SkGraphics::SetTextRunCacheEnabled(true);
+    const size_t length = strlen(kText);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(SkIntToScalar(16));
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(200, 50);
+    actual.allocN32Pixels(200, 50);
+
+    static const SkPaint::Align kAligns[] = {
+        SkPaint::kLeft_Align, SkPaint::kCenter_Align, SkPaint::kRight_Align,
+    };
+    static const SkScalar kXs[] = { 10, 100, 190 };
+
+    SkTextRunCache::ResetStats();
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kAligns); ++i) {
+        paint.setTextAlign(kAligns[i]);
+
+        expected.eraseColor(SK_ColorWHITE);
+        SkGraphics::SetTextRunCacheEnabled(false);
+        SkCanvas(expected).drawText(kText, length, kXs[i], 30, paint);
+        SkGraphics::SetTextRunCacheEnabled(true);
+
+        SkCanvas canvas(actual);
+        for (int j = 0; j < 2; ++j) {
+            actual.eraseColor(SK_ColorWHITE);
+            canvas.drawText(kText, length, kXs[i], 30, paint);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                        actual.getSize()));
+        }
+    }
+
+    // The global cache is shared with other tests running in parallel (which may purge it), so
+    // only check that the draws went through it and that it was useful at least once.
+    SkTextRunCache::Stats stats;
+    SkTextRunCache::GetStats(&stats);
+    REPORTER_ASSERT(reporter, stats.fHits >= 1);
+    REPORTER_ASSERT(reporter, stats.fHits + stats.fMisses >= 6);
+
+    SkGraphics::SetTextRunCacheEnabled(wasEnabled);
+}
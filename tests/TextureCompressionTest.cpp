@@ -6,6 +6,7 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkEndian.h"
 #include "SkImageInfo.h"
@@ -302,3 +303,59 @@ DEF_TEST(CompressLATC, reporter) {
         }
     }
 }
+
+/**
+ * Opaque N32 bitmaps compress to ETC1, dropping only the alpha, and decompress to roughly the
+ * colors they started with.
+ */
+DEF_TEST(CompressETC1FromN32, reporter) {
+    static const int kWidth = 32;
+    static const int kHeight = 24;
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(kWidth, kHeight, kOpaque_SkAlphaType));
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, 4 * x + 60, 8 * y, 100 + 2 * (x + y));
+        }
+    }
+
+    SkAutoDataUnref data(SkTextureCompressor::CompressBitmapToFormat(
+            bitmap, SkTextureCompressor::kETC1_Format));
+    REPORTER_ASSERT(reporter, data);
+    if (NULL == data) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, SkTextureCompressor::GetCompressedDataSize(
+            SkTextureCompressor::kETC1_Format, kWidth, kHeight) == (int)data->size());
+
+    uint8_t decompressed[kWidth * kHeight * 3];
+    REPORTER_ASSERT(reporter, SkTextureCompressor::DecompressBufferFromFormat(
+            decompressed, kWidth * 3, data->bytes(), kWidth, kHeight,
+            SkTextureCompressor::kETC1_Format));
+    int maxError = 0;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            const SkPMColor c = *bitmap.getAddr32(x, y);
+            const uint8_t* rgb = decompressed + 3 * (y * kWidth + x);
+            maxError = SkTMax(maxError, SkAbs32(rgb[0] - (int)SkGetPackedR32(c)));
+            maxError = SkTMax(maxError, SkAbs32(rgb[1] - (int)SkGetPackedG32(c)));
+            maxError = SkTMax(maxError, SkAbs32(rgb[2] - (int)SkGetPackedB32(c)));
+        }
+    }
+    REPORTER_ASSERT(reporter, maxError <= 16);
+
+    // ETC1 can't hold alpha, nor partial blocks.
+    SkBitmap translucent;
+    translucent.allocN32Pixels(kWidth, kHeight);
+    translucent.eraseColor(0x80808080);
+    SkAutoDataUnref translucentData(SkTextureCompressor::CompressBitmapToFormat(
+            translucent, SkTextureCompressor::kETC1_Format));
+    REPORTER_ASSERT(reporter, NULL == translucentData);
+
+    SkBitmap odd;
+    odd.allocPixels(SkImageInfo::MakeN32(kWidth + 2, kHeight, kOpaque_SkAlphaType));
+    odd.eraseColor(SK_ColorBLUE);
+    SkAutoDataUnref oddData(SkTextureCompressor::CompressBitmapToFormat(
+            odd, SkTextureCompressor::kETC1_Format));
+    REPORTER_ASSERT(reporter, NULL == oddData);
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "Test.h"
+
+static const int kW = 120;
+static const int kH = 80;
+
+static void make_canvas(SkBitmap* bm) {
+    bm->allocN32Pixels(kW, kH);
+    bm->eraseColor(SK_ColorWHITE);
+}
+
+static SkPath make_zigzag() {
+    SkPath path;
+    path.moveTo(5.25f, 10.5f);
+    for (int i = 1; i < 40; ++i) {
+        path.lineTo(5.25f + 2.7f * i, (i & 1) ? 60.75f : 12.1f + i);
+    }
+    return path;
+}
+
+// Compares the red channel; returns the largest difference, and the difference of the totals.
+static int compare(const SkBitmap& a, const SkBitmap& b, int* sumDiff, int* sumA) {
+    int maxDiff = 0;
+    int totalA = 0, totalB = 0;
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            int ra = 255 - SkColorGetR(a.getColor(x, y));
+            int rb = 255 - SkColorGetR(b.getColor(x, y));
+            maxDiff = SkTMax(maxDiff, SkAbs32(ra - rb));
+            totalA += ra;
+            totalB += rb;
+        }
+    }
+    *sumDiff = SkAbs32(totalA - totalB);
+    *sumA = totalA;
+    return maxDiff;
+}
+
+// The thin stroke fast path should look like stroking the outline and filling it.
+DEF_TEST(ThinStroke_MatchesStroker, reporter) {
+    const SkScalar widths[] = { 1.5f, 2, 3 };
+    const SkPaint::Cap caps[] = { SkPaint::kButt_Cap, SkPaint::kRound_Cap };
+    SkPath path = make_zigzag();
+
+    for (size_t w = 0; w < SK_ARRAY_COUNT(widths); ++w) {
+        for (size_t c = 0; c < SK_ARRAY_COUNT(caps); ++c) {
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(SK_ColorBLACK);
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(widths[w]);
+            paint.setStrokeJoin(SkPaint::kRound_Join);
+            paint.setStrokeCap(caps[c]);
+
+            SkBitmap fast, slow;
+            make_canvas(&fast);
+            make_canvas(&slow);
+            SkCanvas(fast).drawPath(path, paint);
+
+            SkPath outline;
+            paint.getFillPath(path, &outline);
+            SkPaint fill(paint);
+            fill.setStyle(SkPaint::kFill_Style);
+            SkCanvas(slow).drawPath(outline, fill);
+
+            int sumDiff, sum;
+            int maxDiff = compare(fast, slow, &sumDiff, &sum);
+            REPORTER_ASSERT(reporter, sum > 0);
+            REPORTER_ASSERT(reporter, maxDiff <= 64);
+            REPORTER_ASSERT(reporter, sumDiff * 100 <= sum);
+        }
+    }
+}
+
+DEF_TEST(ThinStroke_Points, reporter) {
+    SkPoint pts[60];
+    for (int i = 0; i < 60; ++i) {
+        pts[i].set(3.5f + 1.9f * i, (i & 1) ? 70.0f : 9.0f);
+    }
+    const SkCanvas::PointMode modes[] = { SkCanvas::kLines_PointMode,
+                                          SkCanvas::kPolygon_PointMode };
+    for (size_t m = 0; m < SK_ARRAY_COUNT(modes); ++m) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(SK_ColorBLACK);
+        paint.setStrokeWidth(2);
+        paint.setStrokeCap(SkPaint::kRound_Cap);
+
+        // Each segment should match stroking the segment on its own.
+        SkBitmap fast, slow;
+        make_canvas(&fast);
+        make_canvas(&slow);
+        SkCanvas(fast).drawPoints(modes[m], SK_ARRAY_COUNT(pts), pts, paint);
+
+        SkPath outlines;
+        SkPaint stroke(paint);
+        stroke.setStyle(SkPaint::kStroke_Style);
+        size_t inc = (SkCanvas::kLines_PointMode == modes[m]) ? 2 : 1;
+        for (size_t i = 0; i + 1 < SK_ARRAY_COUNT(pts); i += inc) {
+            SkPath seg, outline;
+            seg.moveTo(pts[i]);
+            seg.lineTo(pts[i + 1]);
+            stroke.getFillPath(seg, &outline);
+            outlines.addPath(outline);
+        }
+        outlines.setFillType(SkPath::kWinding_FillType);
+        SkPaint fill(paint);
+        fill.setStyle(SkPaint::kFill_Style);
+        SkCanvas(slow).drawPath(outlines, fill);
+
+        int sumDiff, sum;
+        int maxDiff = compare(fast, slow, &sumDiff, &sum);
+        REPORTER_ASSERT(reporter, sum > 0);
+        REPORTER_ASSERT(reporter, maxDiff <= 64);
+        REPORTER_ASSERT(reporter, sumDiff * 100 <= sum);
+    }
+}
+
+DEF_TEST(ThinStroke_Clip, reporter) {
+    SkPath path = make_zigzag();
+    path.close();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLACK);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2.5f);
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+
+    SkBitmap bm;
+    make_canvas(&bm);
+    SkCanvas canvas(bm);
+    const SkIRect clip = SkIRect::MakeLTRB(20, 15, 70, 50);
+    canvas.clipRect(SkRect::Make(clip));
+    canvas.drawPath(path, paint);
+
+    bool inside = false, outside = false;
+    for (int y = 0; y < kH; ++y) {
+        for (int x = 0; x < kW; ++x) {
+            if (bm.getColor(x, y) != SK_ColorWHITE) {
+                (clip.contains(x, y) ? inside : outside) = true;
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, inside);
+    REPORTER_ASSERT(reporter, !outside);
+
+    // Anti-aliased clips go through SkAAClipBlitter.
+    SkPath clipPath;
+    clipPath.addCircle(60, 40, 30);
+    canvas.clipPath(clipPath, SkRegion::kReplace_Op, true);
+    canvas.drawPath(path, paint);
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bm.getColor(1, 1));
+}
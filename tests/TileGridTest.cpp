@@ -0,0 +1,109 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkTileGrid.h"
+#include "Test.h"
+
+static SkTileGridFactory::TileGridInfo make_info(int tileSize, int margin) {
+    SkTileGridFactory::TileGridInfo info;
+    info.fTileInterval.set(tileSize, tileSize);
+    info.fMargin.set(margin, margin);
+    info.fOffset.setZero();
+    return info;
+}
+
+DEF_TEST(TileGrid_Tiles, reporter) {
+    SkTileGrid grid(4, 4, make_info(10, 1));
+    const SkRect rects[] = {
+        SkRect::MakeLTRB(2, 2, 8, 8),     // Inside tile (0, 0), even with the margin.
+        SkRect::MakeLTRB(2, 2, 9.5f, 8),  // Reaches tile (1, 0) through the margin.
+        SkRect::MakeLTRB(12, 22, 38, 28), // Spans row 2.
+        SkRect::MakeLTRB(5, 5, 5, 5),     // Empty; never stored.
+        SkRect::MakeLTRB(-50, 35, -40, 100), // Off the grid; clamped to tile (0, 3).
+    };
+    grid.insert(rects, SK_ARRAY_COUNT(rects));
+
+    REPORTER_ASSERT(reporter, 2 == grid.tileCount(0, 0));
+    REPORTER_ASSERT(reporter, 1 == grid.tileCount(1, 0));
+    REPORTER_ASSERT(reporter, 0 == grid.tileCount(2, 0));
+    REPORTER_ASSERT(reporter, 0 == grid.tileCount(0, 2));
+    REPORTER_ASSERT(reporter, 1 == grid.tileCount(1, 2));
+    REPORTER_ASSERT(reporter, 1 == grid.tileCount(3, 2));
+    REPORTER_ASSERT(reporter, 0 == grid.tileCount(1, 1));
+    REPORTER_ASSERT(reporter, 1 == grid.tileCount(0, 3));
+
+    // A grid-aligned query of one tile plus its margins visits only that tile.
+    SkTDArray<unsigned> hits;
+    grid.search(SkRect::MakeLTRB(-1, -1, 11, 11), &hits);
+    REPORTER_ASSERT(reporter, 2 == hits.count() && 0 == hits[0] && 1 == hits[1]);
+
+    hits.rewind();
+    grid.search(SkRect::MakeLTRB(0, 20, 40, 30), &hits);
+    REPORTER_ASSERT(reporter, 1 == hits.count() && 2 == hits[0]);
+
+    REPORTER_ASSERT(reporter, SkRect::MakeLTRB(-50, 2, 38, 100) == grid.getRootBound());
+}
+
+// Every op intersecting a query must be found, in order, without duplicates.
+DEF_TEST(TileGrid_Search, reporter) {
+    static const int kNumRects = 500;
+    const int margins[] = { 0, 1, 7 };
+
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(kNumRects);
+    for (int i = 0; i < kNumRects; ++i) {
+        SkScalar x = rand.nextRangeF(-20, 300),
+                 y = rand.nextRangeF(-20, 300);
+        rects[i] = SkRect::MakeXYWH(x, y, rand.nextRangeF(0.5f, 60), rand.nextRangeF(0.5f, 60));
+    }
+
+    for (size_t m = 0; m < SK_ARRAY_COUNT(margins); ++m) {
+        SkTileGrid grid(10, 10, make_info(32, margins[m]));
+        grid.insert(rects.get(), kNumRects);
+
+        for (int q = 0; q < 200; ++q) {
+            SkScalar x = rand.nextRangeF(-10, 320),
+                     y = rand.nextRangeF(-10, 320);
+            SkRect query = SkRect::MakeXYWH(x, y, rand.nextRangeF(0.25f, 80),
+                                            rand.nextRangeF(0.25f, 80));
+            SkTDArray<unsigned> hits;
+            grid.search(query, &hits);
+
+            for (int i = 1; i < hits.count(); ++i) {
+                REPORTER_ASSERT(reporter, hits[i - 1] < hits[i]);
+            }
+            int found = 0;
+            for (int i = 0; i < kNumRects; ++i) {
+                if (SkRect::Intersects(rects[i], query)) {
+                    while (found < hits.count() && hits[found] < (unsigned)i) {
+                        found++;
+                    }
+                    REPORTER_ASSERT(reporter, found < hits.count() &&
+                                              hits[found] == (unsigned)i);
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(TileGrid_Picture, reporter) {
+    SkTileGridFactory factory(make_info(64, 1));
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(256, 256, &factory);
+    SkPaint paint;
+    for (int i = 0; i < 16; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(16 * i), SkIntToScalar(16 * i), 8, 8),
+                         paint);
+    }
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+    REPORTER_ASSERT(reporter, picture->approximateOpCount() == 16);
+    REPORTER_ASSERT(reporter, picture->cullRect() == SkRect::MakeLTRB(0, 0, 248, 248));
+}
@@ -477,3 +477,60 @@ DEF_GPUTEST(WritePixels, reporter, factory) {
         }
     }
 }
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "GrTexture.h"
+
+// Async writes may be staged, but once a fence inserted after them signals the texture must hold
+// the pixels.  The src rows are padded, and the src is scribbled on straight after the write.
+DEF_GPUTEST(WritePixels_Async, reporter, factory) {
+    static const int kW = 20, kH = 12, kRowPixels = 32;
+    for (int type = 0; type < GrContextFactory::kGLContextTypeCnt; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+
+        GrSurfaceDesc desc;
+        desc.fFlags = kRenderTarget_GrSurfaceFlag;
+        desc.fWidth = kW;
+        desc.fHeight = kH;
+        desc.fConfig = kSkia8888_GrPixelConfig;
+        SkAutoTUnref<GrTexture> texture(context->createTexture(desc, false));
+        if (NULL == texture) {
+            continue;
+        }
+
+        SkAutoTMalloc<uint32_t> src(kRowPixels * kH);
+        for (int i = 0; i < kRowPixels * kH; ++i) {
+            src[i] = 0xFF000000 | (i * 0x010203);
+        }
+        SkAutoTMalloc<uint32_t> expected(kW * kH);
+        for (int y = 0; y < kH; ++y) {
+            memcpy(&expected[y * kW], &src[y * kRowPixels], kW * sizeof(uint32_t));
+        }
+
+        REPORTER_ASSERT(reporter, context->writeSurfacePixels(texture, 0, 0, kW, kH,
+                                                              desc.fConfig, src.get(),
+                                                              kRowPixels * sizeof(uint32_t),
+                                                              GrContext::kAsync_PixelOpsFlag));
+        memset(src.get(), 0, kRowPixels * kH * sizeof(uint32_t));
+
+        GrFence fence = context->insertFence();
+        REPORTER_ASSERT(reporter, context->waitFence(fence, 1000 * 1000 * 1000));
+        context->deleteFence(fence);
+
+        if (!GrContextFactory::IsRenderingGLContext(glType)) {
+            continue;
+        }
+        SkAutoTMalloc<uint32_t> readback(kW * kH);
+        REPORTER_ASSERT(reporter, context->readRenderTargetPixels(texture->asRenderTarget(),
+                                                                  0, 0, kW, kH, desc.fConfig,
+                                                                  readback.get()));
+        REPORTER_ASSERT(reporter, 0 == memcmp(readback.get(), expected.get(),
+                                              kW * kH * sizeof(uint32_t)));
+    }
+}
+#endif
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDOM.h"
+#include "SkStream.h"
+#include "SkXMLParser.h"
+#include "Test.h"
+
+// Hands out its data a few bytes at a time, so tokens straddle reads.
+class TrickleStream : public SkMemoryStream {
+public:
+    TrickleStream(const char doc[]) : INHERITED(doc, strlen(doc), false) {}
+    size_t read(void* buffer, size_t size) override {
+        return this->INHERITED::read(buffer, SkTMin<size_t>(size, 3));
+    }
+private:
+    typedef SkMemoryStream INHERITED;
+};
+
+static bool text_equals(SkXMLPullParser& parser, const char expected[]) {
+    return parser.getTextLength() == strlen(expected) &&
+           !memcmp(parser.getText(), expected, strlen(expected));
+}
+
+DEF_TEST(XMLPullParser_Tokens, reporter) {
+    static const char gDoc[] =
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE svg [ <!ENTITY e \"x\"> ]>\n"
+        "<svg width='10' title=\"a &lt;b&gt; &amp; &#65;&#x42;\">\n"
+        "  <!-- note -->\n"
+        "  <g/>text &quot;here&quot;<![CDATA[<raw>]]>\n"
+        "</svg>\n";
+
+    TrickleStream stream(gDoc);
+    SkXMLPullParser parser(&stream);
+    REPORTER_ASSERT(reporter, SkXMLPullParser::START_DOCUMENT == parser.getEventType());
+
+    REPORTER_ASSERT(reporter, SkXMLPullParser::PROCESSING_INSTRUCTION == parser.nextToken());
+    REPORTER_ASSERT(reporter, text_equals(parser, "xml version=\"1.0\""));
+    REPORTER_ASSERT(reporter, SkXMLPullParser::IGNORABLE_WHITESPACE == parser.nextToken());
+    REPORTER_ASSERT(reporter, SkXMLPullParser::DOCDECL == parser.nextToken());
+    REPORTER_ASSERT(reporter, text_equals(parser, "DOCTYPE svg [ <!ENTITY e \"x\"> ]"));
+    REPORTER_ASSERT(reporter, SkXMLPullParser::IGNORABLE_WHITESPACE == parser.nextToken());
+
+    REPORTER_ASSERT(reporter, SkXMLPullParser::START_TAG == parser.nextToken());
+    REPORTER_ASSERT(reporter, !strcmp(parser.getName(), "svg"));
+    REPORTER_ASSERT(reporter, 1 == parser.getDepth());
+    REPORTER_ASSERT(reporter, 3 == parser.getLineNumber());
+    REPORTER_ASSERT(reporter, 2 == parser.getAttributeCount());
+    SkXMLPullParser::AttrInfo info;
+    parser.getAttributeInfo(0, &info);
+    REPORTER_ASSERT(reporter, !strcmp(info.fName, "width") && !strcmp(info.fValue, "10"));
+    REPORTER_ASSERT(reporter, 2 == info.fValueLength);
+    parser.getAttributeInfo(1, &info);
+    REPORTER_ASSERT(reporter, !strcmp(info.fName, "title"));
+    REPORTER_ASSERT(reporter, !strcmp(info.fValue, "a <b> & AB"));
+    REPORTER_ASSERT(reporter, strlen("a <b> & AB") == info.fValueLength);
+
+    REPORTER_ASSERT(reporter, SkXMLPullParser::TEXT == parser.nextToken());
+    REPORTER_ASSERT(reporter, parser.isWhitespace());
+    REPORTER_ASSERT(reporter, SkXMLPullParser::COMMENT == parser.nextToken());
+    REPORTER_ASSERT(reporter, text_equals(parser, " note "));
+    REPORTER_ASSERT(reporter, SkXMLPullParser::TEXT == parser.nextToken());
+
+    REPORTER_ASSERT(reporter, SkXMLPullParser::START_TAG == parser.nextToken());
+    REPORTER_ASSERT(reporter, !strcmp(parser.getName(), "g"));
+    REPORTER_ASSERT(reporter, 2 == parser.getDepth());
+    REPORTER_ASSERT(reporter, 5 == parser.getLineNumber());
+    REPORTER_ASSERT(reporter, SkXMLPullParser::END_TAG == parser.nextToken());
+    REPORTER_ASSERT(reporter, !strcmp(parser.getName(), "g"));
+
+    REPORTER_ASSERT(reporter, SkXMLPullParser::TEXT == parser.nextToken());
+    REPORTER_ASSERT(reporter, !parser.isWhitespace());
+    REPORTER_ASSERT(reporter, text_equals(parser, "text \"here\""));
+    REPORTER_ASSERT(reporter, SkXMLPullParser::CDSECT == parser.nextToken());
+    REPORTER_ASSERT(reporter, text_equals(parser, "<raw>"));
+    REPORTER_ASSERT(reporter, SkXMLPullParser::TEXT == parser.nextToken());
+
+    REPORTER_ASSERT(reporter, SkXMLPullParser::END_TAG == parser.nextToken());
+    REPORTER_ASSERT(reporter, !strcmp(parser.getName(), "svg"));
+    REPORTER_ASSERT(reporter, 6 == parser.getLineNumber());
+    REPORTER_ASSERT(reporter, SkXMLPullParser::IGNORABLE_WHITESPACE == parser.nextToken());
+    REPORTER_ASSERT(reporter, SkXMLPullParser::END_DOCUMENT == parser.nextToken());
+    REPORTER_ASSERT(reporter, 0 == parser.getDepth());
+    REPORTER_ASSERT(reporter, SkXMLPullParser::kNone_Error == parser.getError());
+}
+
+DEF_TEST(XMLPullParser_Errors, reporter) {
+    static const struct {
+        const char*             fDoc;
+        SkXMLPullParser::Error  fError;
+        int                     fLine;
+    } gTests[] = {
+        { "",                           SkXMLPullParser::kUnexpectedEnd_Error,  1 },
+        { "<a>\n<b>\n</a>",             SkXMLPullParser::kMismatchedTag_Error,  3 },
+        { "<a>\n<b x=1/>\n</a>",        SkXMLPullParser::kMalformedTag_Error,   2 },
+        { "<a><b>",                     SkXMLPullParser::kUnexpectedEnd_Error,  1 },
+        { "<a x='>",                    SkXMLPullParser::kUnexpectedEnd_Error,  1 },
+        { "<a/>\n<b/>",                 SkXMLPullParser::kOutsideRoot_Error,    2 },
+        { "junk<a/>",                   SkXMLPullParser::kOutsideRoot_Error,    1 },
+    };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gTests); i++) {
+        SkMemoryStream stream(gTests[i].fDoc, strlen(gTests[i].fDoc), false);
+        SkXMLPullParser parser(&stream);
+        while (parser.nextToken() != SkXMLPullParser::ERROR) {
+            if (SkXMLPullParser::END_DOCUMENT == parser.getEventType()) {
+                ERRORF(reporter, "no error in \"%s\"", gTests[i].fDoc);
+                break;
+            }
+        }
+        REPORTER_ASSERT(reporter, gTests[i].fError == parser.getError());
+        REPORTER_ASSERT(reporter, gTests[i].fLine == parser.getLineNumber());
+    }
+}
+
+// A document many times the size of the initial window, with a token bigger than it too, parses
+// with the same results as a small one.
+DEF_TEST(XMLPullParser_Large, reporter) {
+    SkString doc("<root>");
+    for (int i = 0; i < 5000; i++) {
+        doc.appendf("<item index=\"%d\">value &amp; %d</item>\n", i, i);
+    }
+    SkString big;
+    for (int i = 0; i < 40000; i++) {
+        big.append("0123456789");
+    }
+    doc.append("<big data=\"");
+    doc.append(big);
+    doc.append("\"/></root>");
+
+    SkMemoryStream stream(doc.c_str(), doc.size(), false);
+    SkXMLPullParser parser(&stream);
+    int items = 0;
+    bool sawBig = false;
+    SkXMLPullParser::EventType type;
+    while ((type = parser.nextToken()) != SkXMLPullParser::END_DOCUMENT &&
+           type != SkXMLPullParser::ERROR) {
+        if (SkXMLPullParser::START_TAG == type && !strcmp(parser.getName(), "item")) {
+            SkXMLPullParser::AttrInfo info;
+            parser.getAttributeInfo(0, &info);
+            SkString index;
+            index.appendS32(items);
+            REPORTER_ASSERT(reporter, !strcmp(info.fValue, index.c_str()));
+            REPORTER_ASSERT(reporter, SkXMLPullParser::TEXT == parser.nextToken());
+            SkString text;
+            text.printf("value & %d", items);
+            REPORTER_ASSERT(reporter, text_equals(parser, text.c_str()));
+            items++;
+        } else if (SkXMLPullParser::START_TAG == type && !strcmp(parser.getName(), "big")) {
+            SkXMLPullParser::AttrInfo info;
+            parser.getAttributeInfo(0, &info);
+            sawBig = info.fValueLength == big.size() && !strcmp(info.fValue, big.c_str());
+        }
+    }
+    REPORTER_ASSERT(reporter, SkXMLPullParser::END_DOCUMENT == type);
+    REPORTER_ASSERT(reporter, 5000 == items);
+    REPORTER_ASSERT(reporter, sawBig);
+    REPORTER_ASSERT(reporter, 5001 == parser.getLineNumber());
+}
+
+DEF_TEST(XMLParser_DOM, reporter) {
+    static const char gDoc[] =
+        "<svg width=\"100\" name=\"a &amp; b\">"
+            "<rect x=\"1\"/>"
+            "<text>Hello &lt;world&gt;</text>"
+        "</svg>";
+
+    SkDOM dom;
+    TrickleStream stream(gDoc);
+    const SkDOM::Node* root = dom.build(stream);
+    REPORTER_ASSERT(reporter, root);
+    if (!root) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, !strcmp(dom.getName(root), "svg"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(root, "width"), "100"));
+    REPORTER_ASSERT(reporter, !strcmp(dom.findAttr(root, "name"), "a & b"));
+
+    const SkDOM::Node* rect = dom.getFirstChild(root);
+    REPORTER_ASSERT(reporter, rect && !strcmp(dom.getName(rect), "rect"));
+    REPORTER_ASSERT(reporter, rect && !strcmp(dom.findAttr(rect, "x"), "1"));
+
+    const SkDOM::Node* text = dom.getFirstChild(root, "text");
+    const SkDOM::Node* content = text ? dom.getFirstChild(text) : NULL;
+    REPORTER_ASSERT(reporter, content && SkDOM::kText_Type == dom.getType(content));
+    REPORTER_ASSERT(reporter, content && !strcmp(dom.getName(content), "Hello <world>"));
+
+    // Callers see the same nodes when building from memory, and errors stop the build.
+    SkDOM dom2;
+    REPORTER_ASSERT(reporter, dom2.build(gDoc, strlen(gDoc)));
+    REPORTER_ASSERT(reporter, !dom2.build("<svg><g></svg>", 14));
+}
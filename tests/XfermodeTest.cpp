@@ -6,6 +6,8 @@
  */
 
 #include "SkColor.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
 #include "SkXfermode.h"
 #include "Test.h"
 
@@ -51,7 +53,49 @@ static void test_IsMode(skiatest::Reporter* reporter) {
     }
 }
 
+// xfer32 with coverage must match blending its uncovered result with dst by the coverage, for
+// every mode, both in the SIMD spans and in the leftover pixels after them.
+static void test_xfer32_coverage(skiatest::Reporter* reporter) {
+    static const int kCount = 37;
+    SkRandom random;
+    SkPMColor src[kCount], dst[kCount], full[kCount], covered[kCount];
+    SkAlpha aa[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        src[i] = SkPreMultiplyColor(random.nextU());
+        dst[i] = SkPreMultiplyColor(random.nextU());
+        aa[i] = i % 3 ? SkToU8(random.nextULessThan(256)) : (i % 2 ? 0 : 0xFF);
+    }
+    // A span of four and a span of eight with no coverage at all
+    memset(aa + 8, 0, 8);
+
+    for (int i = 0; i <= SkXfermode::kLastMode; ++i) {
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create((SkXfermode::Mode)i));
+        if (!xfer) {
+            continue;
+        }
+        memcpy(full, dst, sizeof(full));
+        xfer->xfer32(full, src, kCount, NULL);
+        memcpy(covered, dst, sizeof(covered));
+        xfer->xfer32(covered, src, kCount, aa);
+
+        for (int j = 0; j < kCount; ++j) {
+            SkPMColor expected = dst[j];
+            if (0xFF == aa[j]) {
+                expected = full[j];
+            } else if (0 != aa[j]) {
+                expected = SkFourByteInterp(full[j], dst[j], aa[j]);
+            }
+            if (expected != covered[j]) {
+                ERRORF(reporter, "%s: pixel %d with coverage %d is %08x, expected %08x",
+                       SkXfermode::ModeName((SkXfermode::Mode)i), j, aa[j], covered[j], expected);
+                break;
+            }
+        }
+    }
+}
+
 DEF_TEST(Xfermode, reporter) {
     test_asMode(reporter);
     test_IsMode(reporter);
+    test_xfer32_coverage(reporter);
 }
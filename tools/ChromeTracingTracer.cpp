@@ -0,0 +1,162 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "ChromeTracingTracer.h"
+#include "SkStream.h"
+#include "SkTLS.h"
+#include "SkTraceEvent.h"
+
+namespace {
+
+// What each thread keeps in SkTLS.  The buffer itself belongs to the tracer, so its events
+// outlive the thread.
+struct ThreadState {
+    const void* fTracer;
+    void* fBuffer;
+};
+
+void* create_thread_state() {
+    ThreadState* state = SkNEW(ThreadState);
+    state->fTracer = NULL;
+    state->fBuffer = NULL;
+    return state;
+}
+
+void delete_thread_state(void* state) {
+    SkDELETE(static_cast<ThreadState*>(state));
+}
+
+void append_escaped(SkString* out, const char* str) {
+    for (; *str; ++str) {
+        if ('"' == *str || '\\' == *str) {
+            out->append("\\");
+        }
+        out->append(str, 1);
+    }
+}
+
+}  // namespace
+
+ChromeTracingTracer::ChromeTracingTracer(const char* path)
+    : fPath(path)
+    , fCategoryCount(0) {
+    fClock.startWall();
+    sk_bzero(fCategoryNames, sizeof(fCategoryNames));
+    sk_bzero(fCategoryFlags, sizeof(fCategoryFlags));
+}
+
+ChromeTracingTracer::~ChromeTracingTracer() {
+    this->write();
+    fBuffers.deleteAll();
+}
+
+const uint8_t* ChromeTracingTracer::getCategoryGroupEnabled(const char* name) {
+    SkAutoMutexAcquire lock(fMutex);
+    for (int i = 0; i < fCategoryCount; ++i) {
+        if (0 == strcmp(name, fCategoryNames[i])) {
+            return &fCategoryFlags[i];
+        }
+    }
+    if (fCategoryCount == kMaxCategories) {
+        static const uint8_t kDisabled = 0;
+        return &kDisabled;
+    }
+    // Everything is recorded, including the disabled-by-default categories.
+    fCategoryNames[fCategoryCount] = name;
+    fCategoryFlags[fCategoryCount] = kEnabledForRecording_CategoryGroupEnabledFlags;
+    return &fCategoryFlags[fCategoryCount++];
+}
+
+const char* ChromeTracingTracer::getCategoryGroupName(const uint8_t* categoryEnabledFlag) {
+    if (categoryEnabledFlag < fCategoryFlags ||
+        categoryEnabledFlag >= fCategoryFlags + kMaxCategories) {
+        return "unknown";
+    }
+    int index = SkToInt(categoryEnabledFlag - fCategoryFlags);
+    SkAutoMutexAcquire lock(fMutex);
+    return index < fCategoryCount ? fCategoryNames[index] : "unknown";
+}
+
+ChromeTracingTracer::ThreadBuffer* ChromeTracingTracer::threadBuffer() {
+    ThreadState* state = static_cast<ThreadState*>(SkTLS::Get(create_thread_state,
+                                                              delete_thread_state));
+    if (state->fTracer != this) {
+        ThreadBuffer* buffer = SkNEW(ThreadBuffer);
+        buffer->fCount = 0;
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            buffer->fTid = fBuffers.count();
+            *fBuffers.append() = buffer;
+        }
+        state->fTracer = this;
+        state->fBuffer = buffer;
+    }
+    return static_cast<ThreadBuffer*>(state->fBuffer);
+}
+
+SkEventTracer::Handle ChromeTracingTracer::addTraceEvent(char phase,
+                                                         const uint8_t* categoryEnabledFlag,
+                                                         const char* name,
+                                                         uint64_t id,
+                                                         int32_t numArgs,
+                                                         const char** argNames,
+                                                         const uint8_t* argTypes,
+                                                         const uint64_t* argValues,
+                                                         uint8_t flags) {
+    ThreadBuffer* buffer = this->threadBuffer();
+    Event& event = buffer->fEvents[buffer->fCount % kEventsPerThread];
+    event.fName = name;
+    event.fCategory = categoryEnabledFlag;
+    event.fBeginMs = this->nowMs();
+    event.fDurationMs = 0;
+    event.fPhase = phase;
+    // Handles are 1-based so that 0 never names an event.
+    return ++buffer->fCount;
+}
+
+void ChromeTracingTracer::updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                                   const char* name,
+                                                   SkEventTracer::Handle handle) {
+    // Scoped events end on the thread that began them.
+    ThreadBuffer* buffer = this->threadBuffer();
+    if (0 == handle || handle > buffer->fCount || buffer->fCount - handle >= kEventsPerThread) {
+        return;  // The event has already been overwritten.
+    }
+    Event& event = buffer->fEvents[(handle - 1) % kEventsPerThread];
+    event.fDurationMs = this->nowMs() - event.fBeginMs;
+}
+
+void ChromeTracingTracer::write() {
+    SkFILEWStream stream(fPath.c_str());
+    if (!stream.isValid()) {
+        SkDebugf("Could not write trace to %s.\n", fPath.c_str());
+        return;
+    }
+    stream.writeText("{\"traceEvents\":[");
+    bool first = true;
+    for (int i = 0; i < fBuffers.count(); ++i) {
+        const ThreadBuffer* buffer = fBuffers[i];
+        uint64_t begin = buffer->fCount > kEventsPerThread ? buffer->fCount - kEventsPerThread : 0;
+        for (uint64_t index = begin; index < buffer->fCount; ++index) {
+            const Event& event = buffer->fEvents[index % kEventsPerThread];
+            SkString json;
+            json.append(first ? "\n" : ",\n");
+            json.append("{\"name\":\"");
+            append_escaped(&json, event.fName);
+            json.append("\",\"cat\":\"");
+            append_escaped(&json, this->getCategoryGroupName(event.fCategory));
+            json.appendf("\",\"ph\":\"%c\",\"ts\":%.3f", event.fPhase, event.fBeginMs * 1000);
+            if (TRACE_EVENT_PHASE_COMPLETE == event.fPhase) {
+                json.appendf(",\"dur\":%.3f", event.fDurationMs * 1000);
+            }
+            json.appendf(",\"pid\":0,\"tid\":%d}", buffer->fTid);
+            stream.writeText(json.c_str());
+            first = false;
+        }
+    }
+    stream.writeText("\n]}\n");
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef ChromeTracingTracer_DEFINED
+#define ChromeTracingTracer_DEFINED
+
+#include "SkEventTracer.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+#include "Timer.h"
+
+/**
+ *  An SkEventTracer that records every trace event, in every category, and writes them out as
+ *  Chrome trace JSON (load it in chrome://tracing) when it is destroyed.
+ *
+ *  Each thread records into its own fixed size ring buffer, so recording an event takes no lock;
+ *  a busy thread keeps only its most recent events. Event arguments are not recorded.
+ *
+ *  Install it with SkEventTracer::SetInstance() before anything is traced: each trace point
+ *  caches its category's enabled flag the first time it runs.
+ */
+class ChromeTracingTracer : public SkEventTracer {
+public:
+    explicit ChromeTracingTracer(const char* path);
+    ~ChromeTracingTracer() override;
+
+    const uint8_t* getCategoryGroupEnabled(const char* name) override;
+    const char* getCategoryGroupName(const uint8_t* categoryEnabledFlag) override;
+
+    SkEventTracer::Handle addTraceEvent(char phase,
+                                        const uint8_t* categoryEnabledFlag,
+                                        const char* name,
+                                        uint64_t id,
+                                        int32_t numArgs,
+                                        const char** argNames,
+                                        const uint8_t* argTypes,
+                                        const uint64_t* argValues,
+                                        uint8_t flags) override;
+
+    void updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                  const char* name,
+                                  SkEventTracer::Handle handle) override;
+
+private:
+    static const int kMaxCategories = 256;
+    static const int kEventsPerThread = 1 << 15;
+
+    struct Event {
+        const char* fName;
+        const uint8_t* fCategory;
+        double fBeginMs;
+        double fDurationMs;
+        char fPhase;
+    };
+
+    struct ThreadBuffer {
+        int fTid;
+        uint64_t fCount;  // Events ever added; the newest is at (fCount - 1) % kEventsPerThread.
+        Event fEvents[kEventsPerThread];
+    };
+
+    ThreadBuffer* threadBuffer();
+    double nowMs() { return fClock.endWall(); }
+    void write();
+
+    SkString fPath;
+    SysTimer fClock;
+
+    SkMutex fMutex;
+    // Guarded by fMutex.
+    const char* fCategoryNames[kMaxCategories];
+    int fCategoryCount;
+    SkTDArray<ThreadBuffer*> fBuffers;
+
+    // Read without the lock by trace points; only ever set once.
+    uint8_t fCategoryFlags[kMaxCategories];
+
+    typedef SkEventTracer INHERITED;
+};
+
+#endif
@@ -9,19 +9,26 @@
 
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
+#include "SkTSort.h"
 
 #include "DumpRecord.h"
 #include "Timer.h"
 
 namespace {
 
-class Dumper {
+const char* name_of(SkRecords::Type type) {
+#define CASE(U) case SkRecords::U##_Type: return #U;
+    switch(type) { SK_RECORD_TYPES(CASE); }
+#undef CASE
+    SkDEBUGFAIL("Unknown T");
+    return "Unknown T";
+}
+
+class Dumper : public SkRecordDrawProfiler {
 public:
-    explicit Dumper(SkCanvas* canvas, int count, bool timeWithCommand)
+    explicit Dumper(int count, bool timeWithCommand)
         : fDigits(0)
         , fIndent(0)
-        , fIndex(0)
-        , fDraw(canvas, NULL, NULL, 0, NULL)
         , fTimeWithCommand(timeWithCommand) {
         while (count > 0) {
             count /= 10;
@@ -29,83 +36,178 @@ public:
         }
     }
 
-    template <typename T>
-    void operator()(const T& command) {
-        Timer timer;
-        timer.start();
-            fDraw(command);
-        timer.end();
+    void willDraw(unsigned, SkRecords::Type) override {
+        fTimer.start();
+    }
 
-        this->print(command, timer.fCpu);
+    void didDraw(unsigned i, SkRecords::Type type, int64_t pixels) override {
+        fTimer.end();
+
+        switch (type) {
+            case SkRecords::NoOp_Type:
+                // Move on without printing anything.
+                break;
+            case SkRecords::Restore_Type:
+                --fIndent;
+                this->printNameAndTime(i, type, pixels);
+                break;
+            case SkRecords::Save_Type:
+            case SkRecords::SaveLayer_Type:
+                this->printNameAndTime(i, type, pixels);
+                ++fIndent;
+                break;
+            default:
+                this->printNameAndTime(i, type, pixels);
+                break;
+        }
     }
 
-    void operator()(const SkRecords::NoOp&) {
-        // Move on without printing anything.
+private:
+    void printNameAndTime(unsigned i, SkRecords::Type type, int64_t pixels) {
+        const double time = fTimer.fCpu;
+        if (!fTimeWithCommand) {
+            printf("%6.1f %9lld ", time * 1000, (long long)pixels);
+        }
+        printf("%*u ", fDigits, i);
+        for (int j = 0; j < fIndent; j++) {
+            putchar('\t');
+        }
+        if (fTimeWithCommand) {
+            printf("%6.1f %9lld ", time * 1000, (long long)pixels);
+        }
+        if (SkRecords::SaveLayer_Type == type) {
+            puts("\x1b[31;1mSaveLayer\x1b[0m");  // Bold red.
+        } else {
+            puts(name_of(type));
+        }
     }
 
+    int fDigits;
+    int fIndent;
+    Timer fTimer;
+    const bool fTimeWithCommand;
+};
+
+struct OpCost {
+    unsigned fIndex;
+    SkRecords::Type fType;
+    double fMs;
+    int64_t fPixels;
+};
+
+struct TypeCost {
+    SkRecords::Type fType;
+    int fCount;
+    double fMs;
+    int64_t fPixels;
+};
+
+struct MoreMs {
     template <typename T>
-    void print(const T& command, double time) {
-        this->printNameAndTime(command, time);
-    }
+    bool operator()(const T& a, const T& b) const { return a.fMs > b.fMs; }
+};
 
-    void print(const SkRecords::Restore& command, double time) {
-        --fIndent;
-        this->printNameAndTime(command, time);
+#define COUNT(T) + 1
+static const int kTypeCount = SK_RECORD_TYPES(COUNT);
+#undef COUNT
+
+class Profiler : public SkRecordDrawProfiler {
+public:
+    Profiler() {
+        sk_bzero(fTypes, sizeof(fTypes));
+        for (int i = 0; i < kTypeCount; i++) {
+            fTypes[i].fType = (SkRecords::Type)i;
+        }
     }
 
-    void print(const SkRecords::Save& command, double time) {
-        this->printNameAndTime(command, time);
-        ++fIndent;
+    void willDraw(unsigned, SkRecords::Type) override {
+        fTimer.start();
     }
 
-    void print(const SkRecords::SaveLayer& command, double time) {
-        this->printNameAndTime(command, time);
-        ++fIndent;
+    void didDraw(unsigned i, SkRecords::Type type, int64_t pixels) override {
+        fTimer.end();
+
+        OpCost* op = fOps.append();
+        op->fIndex  = i;
+        op->fType   = type;
+        op->fMs     = fTimer.fWall;
+        op->fPixels = pixels;
+
+        fTypes[type].fCount++;
+        fTypes[type].fMs     += fTimer.fWall;
+        fTypes[type].fPixels += pixels;
     }
 
-private:
-    template <typename T>
-    void printNameAndTime(const T& command, double time) {
-        if (!fTimeWithCommand) {
-            printf("%6.1f ", time * 1000);
+    void print(int slowest) {
+        double totalMs = 0;
+        for (int i = 0; i < kTypeCount; i++) {
+            totalMs += fTypes[i].fMs;
         }
-        printf("%*d ", fDigits, fIndex++);
-        for (int i = 0; i < fIndent; i++) {
-            putchar('\t');
+
+        // Summarize by type, slowest types first.
+        SkTDArray<TypeCost> types;
+        for (int i = 0; i < kTypeCount; i++) {
+            if (fTypes[i].fCount > 0) {
+                *types.append() = fTypes[i];
+            }
         }
-        if (fTimeWithCommand) {
-            printf("%6.1f ", time * 1000);
+        if (types.count() > 1) {
+            SkTQSort(types.begin(), types.end() - 1, MoreMs());
         }
-        puts(NameOf(command));
-    }
+        printf("%-26s %8s %10s %6s %12s %10s\n", "op", "count", "ms", "%", "pixels", "ns/pixel");
+        for (int i = 0; i < types.count(); i++) {
+            const TypeCost& type = types[i];
+            printf("%-26s %8d %10.3f %5.1f%% %12lld %10s\n",
+                   name_of(type.fType), type.fCount, type.fMs,
+                   totalMs > 0 ? 100 * type.fMs / totalMs : 0.0,
+                   (long long)type.fPixels, NsPerPixel(type.fMs, type.fPixels).c_str());
+        }
+        printf("%-26s %8d %10.3f\n\n", "total", fOps.count(), totalMs);
 
-    template <typename T>
-    static const char* NameOf(const T&) {
-    #define CASE(U) case SkRecords::U##_Type: return #U;
-        switch(T::kType) { SK_RECORD_TYPES(CASE); }
-    #undef CASE
-        SkDEBUGFAIL("Unknown T");
-        return "Unknown T";
+        // Then the slowest individual ops.
+        if (fOps.count() > 1) {
+            SkTQSort(fOps.begin(), fOps.end() - 1, MoreMs());
+        }
+        slowest = SkTMin(slowest, fOps.count());
+        printf("%d slowest ops:\n", slowest);
+        printf("%8s %-26s %10s %12s %10s\n", "index", "op", "ms", "pixels", "ns/pixel");
+        for (int i = 0; i < slowest; i++) {
+            const OpCost& op = fOps[i];
+            printf("%8u %-26s %10.3f %12lld %10s\n",
+                   op.fIndex, name_of(op.fType), op.fMs,
+                   (long long)op.fPixels, NsPerPixel(op.fMs, op.fPixels).c_str());
+        }
     }
 
-    static const char* NameOf(const SkRecords::SaveLayer&) {
-        return "\x1b[31;1mSaveLayer\x1b[0m";  // Bold red.
+private:
+    static SkString NsPerPixel(double ms, int64_t pixels) {
+        SkString str("-");
+        if (pixels > 0) {
+            str.printf("%.2f", ms * 1e6 / pixels);
+        }
+        return str;
     }
 
-    int fDigits;
-    int fIndent;
-    int fIndex;
-    SkRecords::Draw fDraw;
-    const bool fTimeWithCommand;
+    WallTimer fTimer;
+    SkTDArray<OpCost> fOps;
+    TypeCost fTypes[kTypeCount];
 };
 
 }  // namespace
 
 void DumpRecord(const SkRecord& record,
-                  SkCanvas* canvas,
-                  bool timeWithCommand) {
-    Dumper dumper(canvas, record.count(), timeWithCommand);
-    for (unsigned i = 0; i < record.count(); i++) {
-        record.visit<void>(i, dumper);
-    }
+                const SkRect& cullRect,
+                SkCanvas* canvas,
+                bool timeWithCommand) {
+    Dumper dumper(record.count(), timeWithCommand);
+    SkRecordProfileDraw(record, cullRect, canvas, NULL, 0, &dumper);
+}
+
+void DumpRecordProfile(const SkRecord& record,
+                       const SkRect& cullRect,
+                       SkCanvas* canvas,
+                       int slowest) {
+    Profiler profiler;
+    SkRecordProfileDraw(record, cullRect, canvas, NULL, 0, &profiler);
+    profiler.print(slowest);
 }
@@ -9,16 +9,32 @@
 
 class SkRecord;
 class SkCanvas;
+struct SkRect;
 
 /**
- * Draw the record to the supplied canvas via SkRecords::Draw, while
- * printing each draw command and run time in microseconds to stdout.
+ * Draw the record to the supplied canvas via SkRecordProfileDraw, while
+ * printing each draw command, its run time in microseconds and the number
+ * of device pixels it touched to stdout.
  *
+ * @param cullRect The record's cull rect, used to bound unbounded commands.
  * @param timeWithCommand If true, print time next to command, else in
  *        first column.
  */
 void DumpRecord(const SkRecord& record,
+                const SkRect& cullRect,
                 SkCanvas* canvas,
                 bool timeWithCommand);
 
+/**
+ * Draw the record to the supplied canvas via SkRecordProfileDraw, then print
+ * the count, total wall time and pixels touched of each type of command,
+ * slowest type first, followed by the slowest commands themselves.
+ *
+ * @param slowest How many of the slowest commands to list.
+ */
+void DumpRecordProfile(const SkRecord& record,
+                       const SkRect& cullRect,
+                       SkCanvas* canvas,
+                       int slowest);
+
 #endif  // DumpRecord_DEFINED
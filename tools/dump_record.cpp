@@ -23,7 +23,9 @@ DEFINE_bool2(optimize, O, false, "Run SkRecordOptimize before dumping.");
 DEFINE_int32(tile, 1000000000, "Simulated tile size.");
 DEFINE_bool(timeWithCommand, false, "If true, print time next to command, else in first column.");
 
-static void dump(const char* name, int w, int h, const SkRecord& record) {
+static void dump(const char* name, const SkRect& cullRect, const SkRecord& record) {
+    const int w = SkScalarCeilToInt(cullRect.width());
+    const int h = SkScalarCeilToInt(cullRect.height());
     SkBitmap bitmap;
     bitmap.allocN32Pixels(w, h);
     SkCanvas canvas(bitmap);
@@ -32,7 +34,7 @@ static void dump(const char* name, int w, int h, const SkRecord& record) {
 
     printf("%s %s\n", FLAGS_optimize ? "optimized" : "not-optimized", name);
 
-    DumpRecord(record, &canvas, FLAGS_timeWithCommand);
+    DumpRecord(record, cullRect, &canvas, FLAGS_timeWithCommand);
 }
 
 
@@ -68,7 +70,7 @@ int tool_main(int argc, char** argv) {
             SkRecordOptimize(&record);
         }
 
-        dump(FLAGS_skps[i], w, h, record);
+        dump(FLAGS_skps[i], src->cullRect(), record);
     }
 
     return 0;
@@ -7,6 +7,9 @@
 
 #include "SkCommonFlags.h"
 
+DEFINE_bool(analyticAA, false, "Fill anti-aliased paths with exact-coverage analytic AA "
+                                "instead of supersampling.");
+
 DEFINE_string(config, "565 8888 gpu nonrendering angle nvprmsaa4 hwui ",
               "Options: 565 8888 pdf gpu nonrendering msaa4 msaa16 nvprmsaa4 nvprmsaa16 "
               "gpudft gpunull gpudebug angle mesa (and many more)");
@@ -45,8 +48,26 @@ DEFINE_bool(abandonGpuContext, false, "Abandon the GrContext after running each
 
 DEFINE_string(skps, "skps", "Directory to read skps from.");
 
+DEFINE_bool(strokeCache, false, "Cache stroked paths across draws (SkGraphics::SetStrokeCacheEnabled).");
+
+DEFINE_bool(textRunCache, false, "Cache laid out text across draws "
+                                 "(SkGraphics::SetTextRunCacheEnabled).");
+
+DEFINE_bool(patchCache, false, "Cache tessellated patches across draws "
+                               "(SkGraphics::SetPatchCacheEnabled).");
+
+DEFINE_bool(fastTextOnPath, false, "Draw raster text on paths by rotating glyph masks "
+                                   "(SkGraphics::SetFastTextOnPathEnabled).");
+
+DEFINE_bool(shareSubpixelGlyphs, false, "Share identical subpixel glyph masks in the font cache "
+                                       "(SkGraphics::SetFontCacheSharesSubpixelImages).");
+
 DEFINE_int32(threads, -1, "Run threadsafe tests on a threadpool with this many extra threads, "
-                          "defaulting to one extra thread per core.");
+                          "defaulting to one extra thread per core. nanobench: if greater than "
+                          "1, also time each CPU bench on this many threads at once.");
+
+DEFINE_string(trace, "", "If set, record trace events and write them to this file as Chrome trace "
+                          "JSON, for chrome://tracing.");
 
 DEFINE_bool2(verbose, v, false, "enable verbose output from the test driver.");
 
@@ -10,6 +10,7 @@
 
 #include "SkCommandLineFlags.h"
 
+DECLARE_bool(analyticAA);
 DECLARE_string(config);
 DECLARE_bool(cpu);
 DECLARE_bool(dryRun);
@@ -23,8 +24,14 @@ DECLARE_bool(resetGpuContext);
 DECLARE_bool(preAbandonGpuContext);
 DECLARE_bool(abandonGpuContext);
 DECLARE_string(skps);
+DECLARE_bool(strokeCache);
+DECLARE_bool(textRunCache);
+DECLARE_bool(patchCache);
+DECLARE_bool(fastTextOnPath);
+DECLARE_bool(shareSubpixelGlyphs);
 DECLARE_int32(threads);
 DECLARE_string(resourcePath);
+DECLARE_string(trace);
 DECLARE_bool(verbose);
 DECLARE_bool(veryVerbose);
 DECLARE_string(writePath);
@@ -16,6 +16,7 @@
 #include "SkStream.h"
 #include "SkTArray.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "ProcStats.h"
 
 __SK_FORCE_IMAGE_DECODER_LINKING;
@@ -56,6 +57,10 @@ DEFINE_string2(match, m, "",
                "If a file does not match any list entry,\n"
                "it is skipped unless some list entry starts with ~");
 
+DEFINE_int32(threads, 0,
+             "Convert the files on a thread pool of this many threads (-1 for one per "
+             "core). By default they are converted one at a time.");
+
 /** Replaces the extension of a file.
  * @param path File name whose extension will be changed.
  * @param old_extension The old extension.
@@ -182,6 +187,63 @@ static void process_input_files(
     }
 }
 
+namespace {
+struct Conversion {
+    const SkString* fInput;
+    const SkString* fOutputDir;
+    size_t fNameWidth;
+    SkString fLog;      // What to print for this file, once all are done.
+    bool fFailed;
+};
+}  // namespace
+
+/** Reads one skp file, renders it to pdf and writes the output to a pdf file.
+ */
+static void convert(int i, Conversion* conversions) {
+    Conversion& conversion = conversions[i];
+    const SkString& input = *conversion.fInput;
+    SkString basename = SkOSPath::Basename(input.c_str());
+
+    SkFILEStream inputStream;
+    inputStream.setPath(input.c_str());
+    if (!inputStream.isValid()) {
+        conversion.fLog.printf("Could not open file %s\n", input.c_str());
+        conversion.fFailed = true;
+        return;
+    }
+
+    SkAutoTUnref<SkPicture> picture(
+            SkPicture::CreateFromStream(&inputStream));
+    if (NULL == picture.get()) {
+        conversion.fLog.printf("Could not read an SkPicture from %s\n",
+                               input.c_str());
+        conversion.fFailed = true;
+        return;
+    }
+    conversion.fLog.printf("[%6g %6g %6g %6g] %-*s",
+        picture->cullRect().fLeft, picture->cullRect().fTop,
+        picture->cullRect().fRight, picture->cullRect().fBottom,
+        (int)conversion.fNameWidth, basename.c_str());
+
+    SkAutoTDelete<SkWStream> stream(open_stream(*conversion.fOutputDir, input));
+    if (!stream.get()) {
+        conversion.fLog.append("\n");
+        conversion.fFailed = true;
+        return;
+    }
+    if (!pdf_to_stream(picture, stream.get())) {
+        conversion.fLog.append("Error in PDF Serialization.");
+        conversion.fFailed = true;
+    }
+
+    int max_rss_mb = sk_tools::getMaxResidentSetSizeMB();
+    if (max_rss_mb >= 0) {
+        conversion.fLog.appendf(" %4dM peak rss", max_rss_mb);
+    }
+
+    conversion.fLog.append("\n");
+}
+
 /** For each input skp file, read it, render it to pdf and write. the
  *  output to a pdf file
  */
@@ -209,47 +271,29 @@ int tool_main_core(int argc, char** argv) {
         maximumPathLength = SkTMax(maximumPathLength, basename.size());
     }
 
-    int failures = 0;
-    for (int i = 0; i < files.count(); i ++) {
-        SkString basename = SkOSPath::Basename(files[i].c_str());
-
-        SkFILEStream inputStream;
-        inputStream.setPath(files[i].c_str());
-        if (!inputStream.isValid()) {
-            SkDebugf("Could not open file %s\n", files[i].c_str());
-            ++failures;
-            continue;
-        }
+    SkAutoTDelete<SkTaskGroup::Enabler> threadPool;
+    if (FLAGS_threads != 0) {
+        threadPool.reset(SkNEW_ARGS(SkTaskGroup::Enabler, (FLAGS_threads)));
+    }
 
-        SkAutoTUnref<SkPicture> picture(
-                SkPicture::CreateFromStream(&inputStream));
-        if (NULL == picture.get()) {
-            SkDebugf("Could not read an SkPicture from %s\n",
-                     files[i].c_str());
-            ++failures;
-            continue;
-        }
-        SkDebugf("[%6g %6g %6g %6g] %-*s",
-            picture->cullRect().fLeft, picture->cullRect().fTop,
-            picture->cullRect().fRight, picture->cullRect().fBottom,
-            maximumPathLength, basename.c_str());
+    SkTArray<Conversion> conversions(files.count());
+    for (int i = 0; i < files.count(); i ++) {
+        Conversion* conversion = &conversions.push_back();
+        conversion->fInput = &files[i];
+        conversion->fOutputDir = &outputDir;
+        conversion->fNameWidth = maximumPathLength;
+        conversion->fFailed = false;
+    }
+    // Each file is its own document, so they convert independently.  Without a
+    // thread pool, this converts them in order on this thread.
+    sk_parallel_for(0, conversions.count(), 1, convert, conversions.begin());
 
-        SkAutoTDelete<SkWStream> stream(open_stream(outputDir, files[i]));
-        if (!stream.get()) {
-            ++failures;
-            continue;
-        }
-        if (!pdf_to_stream(picture, stream.get())) {
-            SkDebugf("Error in PDF Serialization.");
+    int failures = 0;
+    for (int i = 0; i < conversions.count(); i ++) {
+        SkDebugf("%s", conversions[i].fLog.c_str());
+        if (conversions[i].fFailed) {
             ++failures;
         }
-
-        int max_rss_mb = sk_tools::getMaxResidentSetSizeMB();
-        if (max_rss_mb >= 0) {
-            SkDebugf(" %4dM peak rss", max_rss_mb);
-        }
-
-        SkDebugf("\n");
     }
     if (failures != 0) {
         SkDebugf("Failed to render %i of %i PDFs.\n", failures, files.count());
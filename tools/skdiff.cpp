@@ -10,6 +10,7 @@
 #include "SkColor.h"
 #include "SkColorPriv.h"
 #include "SkTypes.h"
+#include "SkUtils.h"
 
 /*static*/ char const * const DiffRecord::ResultNames[DiffRecord::kResultCount] = {
     "EqualBits",
@@ -174,10 +175,29 @@ void compute_diff(DiffRecord* dr, DiffMetricProc diffFunction, const int colorTh
     // Accumulate fractionally different pixels, then divide out
     // # of pixels at the end.
     dr->fWeightedFraction = 0;
+    const size_t rowBytes = w * sizeof(SkPMColor);
     for (int y = 0; y < h; y++) {
+        const SkPMColor* base = dr->fBase.fBitmap.getAddr32(0, y);
+        const SkPMColor* comparison = dr->fComparison.fBitmap.getAddr32(0, y);
+        SkPMColor* difference = dr->fDifference.fBitmap.getAddr32(0, y);
+        SkPMColor* white = dr->fWhite.fBitmap.getAddr32(0, y);
+
+        // Most rows of a typical diff are untouched; skip them wholesale.
+        if (0 == memcmp(base, comparison, rowBytes)) {
+            sk_bzero(difference, rowBytes);
+            sk_memset32(white, PMCOLOR_BLACK, w);
+            continue;
+        }
+
+        int rowValue = 0;
         for (int x = 0; x < w; x++) {
-            SkPMColor c0 = *dr->fBase.fBitmap.getAddr32(x, y);
-            SkPMColor c1 = *dr->fComparison.fBitmap.getAddr32(x, y);
+            SkPMColor c0 = base[x];
+            SkPMColor c1 = comparison[x];
+            if (c0 == c1) {
+                difference[x] = 0;
+                white[x] = PMCOLOR_BLACK;
+                continue;
+            }
             SkPMColor outputDifference = diffFunction(c0, c1);
             uint32_t thisA = SkAbs32(SkGetPackedA32(c0) - SkGetPackedA32(c1));
             uint32_t thisR = SkAbs32(SkGetPackedR32(c0) - SkGetPackedR32(c1));
@@ -188,8 +208,7 @@ void compute_diff(DiffRecord* dr, DiffMetricProc diffFunction, const int colorTh
             totalMismatchG += thisG;
             totalMismatchB += thisB;
             // In HSV, value is defined as max RGB component.
-            int value = MAX3(thisR, thisG, thisB);
-            dr->fWeightedFraction += ((float) value) / 255;
+            rowValue += MAX3(thisR, thisG, thisB);
             if (thisA > dr->fMaxMismatchA) {
                 dr->fMaxMismatchA = thisA;
             }
@@ -204,13 +223,14 @@ void compute_diff(DiffRecord* dr, DiffMetricProc diffFunction, const int colorTh
             }
             if (!colors_match_thresholded(c0, c1, colorThreshold)) {
                 mismatchedPixels++;
-                *dr->fDifference.fBitmap.getAddr32(x, y) = outputDifference;
-                *dr->fWhite.fBitmap.getAddr32(x, y) = PMCOLOR_WHITE;
+                difference[x] = outputDifference;
+                white[x] = PMCOLOR_WHITE;
             } else {
-                *dr->fDifference.fBitmap.getAddr32(x, y) = 0;
-                *dr->fWhite.fBitmap.getAddr32(x, y) = PMCOLOR_BLACK;
+                difference[x] = 0;
+                white[x] = PMCOLOR_BLACK;
             }
         }
+        dr->fWeightedFraction += ((float) rowValue) / 255;
     }
     if (0 == mismatchedPixels) {
         dr->fResult = DiffRecord::kEqualPixels_Result;
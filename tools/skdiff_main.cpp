@@ -17,6 +17,7 @@
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTSearch.h"
+#include "SkTaskGroup.h"
 
 __SK_FORCE_IMAGE_DECODER_LINKING;
 
@@ -372,6 +373,72 @@ static void get_bounds(DiffRecord& drp) {
 
 #define VERBOSE_STATUS(status,color,filename) if (verbose) printf( "[ " color " %10s " ANSI_COLOR_RESET " ] %s\n", status, filename->c_str())
 
+struct DiffTask {
+    DiffRecord* fRecord;
+    DiffMetricProc fDiffProc;
+    int fColorThreshold;
+    const SkString* fOutputDir;
+    bool fGetBounds;
+    bool fVerbose;
+};
+
+/// Does the slow part of comparing one pair of images: reading, decoding, and
+/// diffing them, and writing out the difference images.  Files in only one
+/// directory just get their bounds read, if asked for.
+static void diff_task(DiffTask* task) {
+    DiffRecord* drp = task->fRecord;
+    const bool verbose = task->fVerbose;
+    if (DiffRecord::kUnknown_Result == drp->fResult) {
+        const DiffMetricProc dmp = task->fDiffProc;
+        const int colorThreshold = task->fColorThreshold;
+        const SkString& outputDir = *task->fOutputDir;
+        const SkString* baseName = &drp->fBase.fFilename;
+        const SkString* comparisonName = &drp->fComparison.fFilename;
+
+        SkAutoDataUnref baseFileBits(read_file(drp->fBase.fFullPath.c_str()));
+        if (baseFileBits) {
+            drp->fBase.fStatus = DiffResource::kRead_Status;
+        }
+        SkAutoDataUnref comparisonFileBits(read_file(drp->fComparison.fFullPath.c_str()));
+        if (comparisonFileBits) {
+            drp->fComparison.fStatus = DiffResource::kRead_Status;
+        }
+        if (NULL == baseFileBits || NULL == comparisonFileBits) {
+            if (NULL == baseFileBits) {
+                drp->fBase.fStatus = DiffResource::kCouldNotRead_Status;
+                VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, baseName);
+            }
+            if (NULL == comparisonFileBits) {
+                drp->fComparison.fStatus = DiffResource::kCouldNotRead_Status;
+                VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, comparisonName);
+            }
+            drp->fResult = DiffRecord::kCouldNotCompare_Result;
+
+        } else if (are_buffers_equal(baseFileBits, comparisonFileBits)) {
+            drp->fResult = DiffRecord::kEqualBits_Result;
+            VERBOSE_STATUS("MATCH", ANSI_COLOR_GREEN, baseName);
+        } else {
+            AutoReleasePixels arp(drp);
+            get_bitmap(baseFileBits, drp->fBase, SkImageDecoder::kDecodePixels_Mode);
+            get_bitmap(comparisonFileBits, drp->fComparison,
+                       SkImageDecoder::kDecodePixels_Mode);
+            VERBOSE_STATUS("DIFFERENT", ANSI_COLOR_RED, baseName);
+            if (DiffResource::kDecoded_Status == drp->fBase.fStatus &&
+                DiffResource::kDecoded_Status == drp->fComparison.fStatus) {
+                create_and_write_diff_image(drp, dmp, colorThreshold,
+                                            outputDir, drp->fBase.fFilename);
+            } else {
+                drp->fResult = DiffRecord::kCouldNotCompare_Result;
+            }
+        }
+    }
+
+    if (task->fGetBounds) {
+        get_bounds(*drp);
+    }
+    SkASSERT(DiffRecord::kUnknown_Result != drp->fResult);
+}
+
 /// Creates difference images, returns the number that have a 0 metric.
 /// If outputDir.isEmpty(), don't write out diff files.
 static void create_diff_images (DiffMetricProc dmp,
@@ -405,6 +472,7 @@ static void create_diff_images (DiffMetricProc dmp,
               sizeof(SkString*), SkCastForQSort(compare_file_name_metrics));
     }
 
+    const int firstRecord = differences->count();
     int i = 0;
     int j = 0;
 
@@ -468,53 +536,12 @@ static void create_diff_images (DiffMetricProc dmp,
             drp->fComparison.fFullPath = comparisonPath;
             drp->fComparison.fStatus = DiffResource::kExists_Status;
 
-            SkAutoDataUnref baseFileBits(read_file(drp->fBase.fFullPath.c_str()));
-            if (baseFileBits) {
-                drp->fBase.fStatus = DiffResource::kRead_Status;
-            }
-            SkAutoDataUnref comparisonFileBits(read_file(drp->fComparison.fFullPath.c_str()));
-            if (comparisonFileBits) {
-                drp->fComparison.fStatus = DiffResource::kRead_Status;
-            }
-            if (NULL == baseFileBits || NULL == comparisonFileBits) {
-                if (NULL == baseFileBits) {
-                    drp->fBase.fStatus = DiffResource::kCouldNotRead_Status;
-                    VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, baseFiles[i]);
-                }
-                if (NULL == comparisonFileBits) {
-                    drp->fComparison.fStatus = DiffResource::kCouldNotRead_Status;
-                    VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, comparisonFiles[j]);
-                }
-                drp->fResult = DiffRecord::kCouldNotCompare_Result;
-
-            } else if (are_buffers_equal(baseFileBits, comparisonFileBits)) {
-                drp->fResult = DiffRecord::kEqualBits_Result;
-                VERBOSE_STATUS("MATCH", ANSI_COLOR_GREEN, baseFiles[i]);
-            } else {
-                AutoReleasePixels arp(drp);
-                get_bitmap(baseFileBits, drp->fBase, SkImageDecoder::kDecodePixels_Mode);
-                get_bitmap(comparisonFileBits, drp->fComparison,
-                           SkImageDecoder::kDecodePixels_Mode);
-                VERBOSE_STATUS("DIFFERENT", ANSI_COLOR_RED, baseFiles[i]);
-                if (DiffResource::kDecoded_Status == drp->fBase.fStatus &&
-                    DiffResource::kDecoded_Status == drp->fComparison.fStatus) {
-                    create_and_write_diff_image(drp, dmp, colorThreshold,
-                                                outputDir, drp->fBase.fFilename);
-                } else {
-                    drp->fResult = DiffRecord::kCouldNotCompare_Result;
-                }
-            }
-
+            // Reading, decoding, and diffing the pair is left for diff_task(), below.
             ++i;
             ++j;
         }
 
-        if (getBounds) {
-            get_bounds(*drp);
-        }
-        SkASSERT(DiffRecord::kUnknown_Result != drp->fResult);
         differences->push(drp);
-        summary->add(drp);
     }
 
     for (; i < baseFiles.count(); ++i) {
@@ -531,11 +558,7 @@ static void create_diff_images (DiffMetricProc dmp,
         drp->fComparison.fStatus = DiffResource::kDoesNotExist_Status;
 
         drp->fResult = DiffRecord::kCouldNotCompare_Result;
-        if (getBounds) {
-            get_bounds(*drp);
-        }
         differences->push(drp);
-        summary->add(drp);
     }
 
     for (; j < comparisonFiles.count(); ++j) {
@@ -552,11 +575,26 @@ static void create_diff_images (DiffMetricProc dmp,
         drp->fComparison.fStatus = DiffResource::kExists_Status;
 
         drp->fResult = DiffRecord::kCouldNotCompare_Result;
-        if (getBounds) {
-            get_bounds(*drp);
-        }
         differences->push(drp);
-        summary->add(drp);
+    }
+
+    // Each pair is independent, so compare them in parallel, then summarize in order.
+    const int count = differences->count() - firstRecord;
+    SkAutoTArray<DiffTask> tasks(count);
+    for (int k = 0; k < count; ++k) {
+        DiffTask& task = tasks[k];
+        task.fRecord = (*differences)[firstRecord + k];
+        task.fDiffProc = dmp;
+        task.fColorThreshold = colorThreshold;
+        task.fOutputDir = &outputDir;
+        task.fGetBounds = getBounds;
+        task.fVerbose = verbose;
+    }
+    SkTaskGroup tg;
+    tg.batch(diff_task, tasks.get(), count);
+    tg.wait();
+    for (int k = 0; k < count; ++k) {
+        summary->add(tasks[k].fRecord);
     }
 
     release_file_list(&baseFiles);
@@ -593,6 +631,8 @@ static void usage (char * argv0) {
 "\n    --sortbymaxmismatch: sort by worst color channel mismatch;"
 "\n                         break ties with -sortbymismatch"
 "\n    --sortbymismatch: sort by average color channel mismatch"
+"\n    --threads <n>: compare this many pairs of images at once;"
+"\n                   0 compares them one at a time [default: # of cores]"
 "\n    --threshold <n>: only report differences > n (per color channel) [default 0]"
 "\n    --weighted: sort by # pixels different weighted by color difference"
 "\n"
@@ -616,6 +656,7 @@ int tool_main(int argc, char** argv) {
     // Maximum error tolerated in any one color channel in any one pixel before
     // a difference is reported.
     int colorThreshold = 0;
+    int threads = -1;
     SkString baseDir;
     SkString comparisonDir;
     SkString outputDir;
@@ -728,6 +769,10 @@ int tool_main(int argc, char** argv) {
             sortProc = compare<CompareDiffMeanMismatches>;
             continue;
         }
+        if (!strcmp(argv[i], "--threads")) {
+            threads = atoi(argv[++i]);
+            continue;
+        }
         if (!strcmp(argv[i], "--threshold")) {
             colorThreshold = atoi(argv[++i]);
             continue;
@@ -804,6 +849,7 @@ int tool_main(int argc, char** argv) {
         matchSubstrings.push(new SkString(""));
     }
 
+    SkTaskGroup::Enabler enabled(threads);
     create_diff_images(diffProc, colorThreshold, &differences,
                        baseDir, comparisonDir, outputDir,
                        matchSubstrings, nomatchSubstrings, recurseIntoSubdirs, generateDiffs,
@@ -8,14 +8,23 @@
 #include "SkCommandLineFlags.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
+#include "SkReadBuffer.h"
+#include "SkRecord.h"
+#include "SkRecorder.h"
 #include "SkStream.h"
 
+#include "DumpRecord.h"
+
 DEFINE_string2(input, i, "", "skp on which to report");
 DEFINE_bool2(version, v, true, "version");
 DEFINE_bool2(cullRect, c, true, "cullRect");
 DEFINE_bool2(flags, f, true, "flags");
 DEFINE_bool2(tags, t, true, "tags");
 DEFINE_bool2(quiet, q, false, "quiet");
+DEFINE_bool2(profile, p, false, "draw the skp and report which ops take the longest");
+DEFINE_int32(slowest, 20, "how many of the slowest ops --profile lists");
+DEFINE_bool(compact, false, "report how much smaller SkPicture::serializeCompact() makes the skp");
+DEFINE_double(pathPrecision, 0, "path precision to pass serializeCompact() for --compact");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -28,6 +37,51 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+// Re-record the picture and draw it into a raster canvas, timing each op.
+static void profile(const char* path) {
+    SkFILEStream stream(path);
+    SkAutoTUnref<SkPicture> picture(SkPicture::CreateFromStream(&stream));
+    if (!picture) {
+        SkDebugf("Couldn't parse the picture to profile it\n");
+        return;
+    }
+
+    const SkRect cullRect = picture->cullRect();
+    const int w = SkScalarCeilToInt(cullRect.width());
+    const int h = SkScalarCeilToInt(cullRect.height());
+
+    SkRecord record;
+    SkRecorder recorder(&record, w, h);
+    picture->playback(&recorder);
+
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocN32Pixels(w, h)) {
+        SkDebugf("Couldn't allocate a %dx%d bitmap to profile into\n", w, h);
+        return;
+    }
+    SkCanvas canvas(bitmap);
+    DumpRecordProfile(record, cullRect, &canvas, FLAGS_slowest);
+}
+
+// Re-serialize the picture both ways, and compare the sizes.
+static void report_compact(const char* path) {
+    SkFILEStream stream(path);
+    SkAutoTUnref<SkPicture> picture(SkPicture::CreateFromStream(&stream));
+    if (!picture) {
+        SkDebugf("Couldn't parse the picture to compact it\n");
+        return;
+    }
+
+    SkDynamicMemoryWStream plain, compact;
+    picture->serialize(&plain);
+    picture->serializeCompact(&compact, SkDoubleToScalar(FLAGS_pathPrecision));
+    const size_t plainSize = plain.bytesWritten();
+    const size_t compactSize = compact.bytesWritten();
+    SkDebugf("Serialized: %d bytes, compact: %d bytes (%.1f%%)\n",
+             SkToInt(plainSize), SkToInt(compactSize),
+             plainSize ? 100.0 * compactSize / plainSize : 100.0);
+}
+
 int tool_main(int argc, char** argv);
 int tool_main(int argc, char** argv) {
     SkCommandLineFlags::SetUsage("Prints information about an skp file");
@@ -66,6 +120,12 @@ int tool_main(int argc, char** argv) {
     if (FLAGS_flags && !FLAGS_quiet) {
         SkDebugf("Flags: 0x%x\n", info.fFlags);
     }
+    if (FLAGS_profile && !FLAGS_quiet) {
+        profile(FLAGS_input[0]);
+    }
+    if (FLAGS_compact && !FLAGS_quiet) {
+        report_compact(FLAGS_input[0]);
+    }
 
     if (!stream.readBool()) {
         // If we read true there's a picture playback object flattened
@@ -73,6 +133,9 @@ int tool_main(int argc, char** argv) {
         // reading the file.
         return kSuccess;
     }
+    if (info.fVersion >= SkReadBuffer::kAlignedStream_Version) {
+        stream.skip(3);  // Padding after the bool.
+    }
 
     for (;;) {
         uint32_t tag = stream.readU32();
@@ -102,17 +165,33 @@ int tool_main(int argc, char** argv) {
                 SkDebugf("SK_PICT_READER_TAG %d\n", chunkSize);
             }
             break;
+        case SK_PICT_COMPACT_READER_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_COMPACT_READER_TAG %d\n", chunkSize);
+            }
+            chunkSize = SkAlign4(chunkSize);
+            break;
         case SK_PICT_FACTORY_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_FACTORY_TAG %d\n", chunkSize);
             }
+            if (info.fVersion >= SkReadBuffer::kAlignedStream_Version) {
+                chunkSize = SkAlign4(chunkSize);
+            }
             break;
         case SK_PICT_TYPEFACE_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_TYPEFACE_TAG %d\n", chunkSize);
+            }
+            if (info.fVersion >= SkReadBuffer::kAlignedStream_Version) {
+                // The typefaces are followed by their size in bytes.
+                chunkSize = SkAlign4(stream.readU32());
+                break;
+            }
+            if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("Exiting early due to format limitations\n");
             }
-            return kSuccess;       // TODO: need to store size in bytes
+            return kSuccess;       // Older SKPs don't store the size in bytes.
             break;
         case SK_PICT_PICTURE_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
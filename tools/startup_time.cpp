@@ -0,0 +1,176 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlurMaskFilter.h"
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkGradientShader.h"
+#include "SkGraphics.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTypeface.h"
+#include "Timer.h"
+
+/**
+ * startup_time
+ *
+ * Times how long a fresh process takes from SkGraphics::Init() to its first rendered frame,
+ * one kind of drawing at a time, so that each lazily initialized global (blitter procs,
+ * shaders, the font manager and glyph cache, flattenable registration) is charged to the
+ * first draw that needs it.  Then draws the same frame again to show what is left once
+ * everything is warm.
+ *
+ * Everything here happens once per process, so run it several times to see the spread.
+ * Static initializers run before main() and are not counted.
+ */
+
+DEFINE_int32(width,  1080, "Width of the frame.");
+DEFINE_int32(height, 1920, "Height of the frame.");
+
+enum Stage {
+    kFill_Stage,
+    kGradient_Stage,
+    kBitmap_Stage,
+    kTypeface_Stage,
+    kText_Stage,
+    kPicture_Stage,
+
+    kLast_Stage = kPicture_Stage
+};
+static const int kStageCount = kLast_Stage + 1;
+
+static const char* kStageNames[] = {
+    "fill",
+    "gradient",
+    "bitmap",
+    "typeface",
+    "text",
+    "picture",
+};
+SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kStageNames) == kStageCount, missing_stage_name);
+
+static void draw_stage(Stage stage, SkCanvas* canvas, const SkBitmap& bitmap) {
+    const SkRect r = SkRect::MakeWH(SkIntToScalar(FLAGS_width), SkIntToScalar(FLAGS_height) / 4);
+    SkPaint paint;
+    switch (stage) {
+        case kFill_Stage:
+            canvas->clear(SK_ColorWHITE);
+            paint.setColor(0xFF4285F4);
+            canvas->drawRect(r, paint);
+            break;
+        case kGradient_Stage: {
+            const SkPoint pts[] = { { r.fLeft, r.fTop }, { r.fRight, r.fBottom } };
+            const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+            paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                           SkShader::kClamp_TileMode))->unref();
+            canvas->drawRect(r.makeOffset(0, r.height()), paint);
+            break;
+        }
+        case kBitmap_Stage:
+            paint.setFilterQuality(kLow_SkFilterQuality);
+            canvas->drawBitmapRect(bitmap, r.makeOffset(0, 2 * r.height()), &paint);
+            break;
+        case kTypeface_Stage: {
+            // The first typeface creates the font manager.
+            SkAutoTUnref<SkTypeface> typeface(SkTypeface::RefDefault());
+            break;
+        }
+        case kText_Stage: {
+            static const char kText[] = "The quick brown fox jumps over the lazy dog.";
+            paint.setAntiAlias(true);
+            paint.setTextSize(SkIntToScalar(32));
+            canvas->drawText(kText, sizeof(kText) - 1, 20, 3 * r.height() + 40, paint);
+            break;
+        }
+        case kPicture_Stage: {
+            // A round trip through serialization, as for a picture sent from another process,
+            // which is the first thing that needs the flattenable factories registered.
+            SkPictureRecorder recorder;
+            SkCanvas* recording = recorder.beginRecording(r.width(), r.height());
+            // Keep the blur small, so that drawing it costs little next to the round trip.
+            paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 1))->unref();
+            recording->drawCircle(r.centerX(), r.centerY(), 8, paint);
+            SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+            SkDynamicMemoryWStream stream;
+            picture->serialize(&stream);
+            SkAutoTDelete<SkStreamAsset> asset(stream.detachAsStream());
+            SkAutoTUnref<SkPicture> copy(SkPicture::CreateFromStream(asset));
+            if (copy) {
+                canvas->save();
+                canvas->translate(0, 3 * r.height());
+                canvas->drawPicture(copy);
+                canvas->restore();
+            }
+            break;
+        }
+    }
+}
+
+static double draw_frame(SkSurface* surface, const SkBitmap& bitmap, double ms[kStageCount]) {
+    SkCanvas* canvas = surface->getCanvas();
+    double total = 0;
+    for (int i = 0; i < kStageCount; i++) {
+        WallTimer timer;
+        timer.start();
+        draw_stage((Stage)i, canvas, bitmap);
+        canvas->flush();
+        timer.end();
+        ms[i] = timer.fWall;
+        total += timer.fWall;
+    }
+    return total;
+}
+
+int tool_main(int argc, char** argv);
+int tool_main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Times SkGraphics::Init() to first frame in a fresh process.");
+    SkCommandLineFlags::Parse(argc, argv);
+
+    WallTimer timer;
+    timer.start();
+    SkAutoGraphics ag;
+    timer.end();
+    const double initMs = timer.fWall;
+
+    timer.start();
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(FLAGS_width, FLAGS_height));
+    timer.end();
+    const double surfaceMs = timer.fWall;
+    if (!surface) {
+        SkDebugf("Could not make a %dx%d surface.\n", FLAGS_width, FLAGS_height);
+        return 1;
+    }
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(256, 256);
+    bitmap.eraseColor(SK_ColorGREEN);
+
+    double first[kStageCount], second[kStageCount];
+    const double firstFrameMs  = draw_frame(surface, bitmap, first);
+    const double secondFrameMs = draw_frame(surface, bitmap, second);
+
+    SkDebugf("first\tsecond\tstage\n");
+    SkDebugf("%s\t\tSkGraphics::Init\n", HumanizeMs(initMs).c_str());
+    SkDebugf("%s\t\tsurface\n", HumanizeMs(surfaceMs).c_str());
+    for (int i = 0; i < kStageCount; i++) {
+        SkDebugf("%s\t%s\t%s\n",
+                 HumanizeMs(first[i]).c_str(), HumanizeMs(second[i]).c_str(), kStageNames[i]);
+    }
+    SkDebugf("%s\t%s\tframe\n", HumanizeMs(firstFrameMs).c_str(), HumanizeMs(secondFrameMs).c_str());
+    SkDebugf("%s\t\tSkGraphics::Init to end of first frame\n",
+             HumanizeMs(initMs + surfaceMs + firstFrameMs).c_str());
+    return 0;
+}
+
+#if !defined SK_BUILD_FOR_IOS
+int main(int argc, char * const argv[]) {
+    return tool_main(argc, (char**) argv);
+}
+#endif
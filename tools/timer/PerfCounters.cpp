@@ -0,0 +1,126 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <string.h>
+#endif
+
+const char* PerfCounters::Name(Counter counter) {
+    static const char* kNames[] = {
+        "instructions",
+        "cycles",
+        "cache_misses",
+        "branch_misses",
+    };
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kNames) == kCounterCount, missing_counter_name);
+    return kNames[counter];
+}
+
+#if defined(__linux__)
+
+static int open_counter(uint64_t config, int groupFD) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    // Only the leader starts disabled; the rest follow it.
+    attr.disabled = groupFD < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open, &attr, 0/*this thread*/, -1/*any cpu*/, groupFD, 0);
+}
+
+PerfCounters::PerfCounters() : fLeader(-1) {
+    static const uint64_t kConfigs[] = {
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kConfigs) == kCounterCount, missing_counter_config);
+
+    // Opening the counters as one group means they are always scheduled together.
+    for (int i = 0; i < kCounterCount; i++) {
+        fFDs[i] = open_counter(kConfigs[i], fLeader);
+        if (fLeader < 0) {
+            fLeader = fFDs[i];
+        }
+    }
+    this->reset();
+}
+
+PerfCounters::~PerfCounters() {
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFDs[i] >= 0) {
+            close(fFDs[i]);
+        }
+    }
+}
+
+void PerfCounters::start() {
+    if (fLeader >= 0) {
+        ioctl(fLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounters::end() {
+    if (fLeader < 0) {
+        return;
+    }
+    ioctl(fLeader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // { nr, time_enabled, time_running, value[nr] }, values in the order the counters opened.
+    uint64_t data[3 + kCounterCount];
+    const ssize_t bytes = read(fLeader, data, sizeof(data));
+    if (bytes < (ssize_t)(3 * sizeof(uint64_t)) ||
+        data[0] > (uint64_t)kCounterCount ||
+        bytes < (ssize_t)((3 + data[0]) * sizeof(uint64_t))) {
+        return;
+    }
+    // If the group was multiplexed with other users of the PMU, extrapolate.
+    double scale = 1;
+    if (data[2] > 0 && data[2] < data[1]) {
+        scale = (double)data[1] / data[2];
+    }
+    const uint64_t* value = data + 3;
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFDs[i] >= 0) {
+            fTotals[i] += scale * (double)*value++;
+        }
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters() : fLeader(-1) {
+    for (int i = 0; i < kCounterCount; i++) {
+        fFDs[i] = -1;
+    }
+    this->reset();
+}
+
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+void PerfCounters::end() {}
+
+#endif
+
+void PerfCounters::reset() {
+    for (int i = 0; i < kCounterCount; i++) {
+        fTotals[i] = 0;
+    }
+}
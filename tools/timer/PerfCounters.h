@@ -0,0 +1,55 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef PerfCounters_DEFINED
+#define PerfCounters_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ * Hardware performance counters for the calling thread, in user space only.
+ * Counts accumulate over every start()/end() pair until reset().
+ *
+ * Only implemented on Linux and Android, through perf_event_open(). Elsewhere,
+ * or if the kernel refuses (e.g. /proc/sys/kernel/perf_event_paranoid is too
+ * high, or the hardware is virtualized without a PMU), no counter is available
+ * and start() and end() do nothing.
+ */
+class PerfCounters : SkNoncopyable {
+public:
+    enum Counter {
+        kInstructions_Counter,
+        kCycles_Counter,
+        kCacheMisses_Counter,
+        kBranchMisses_Counter,
+
+        kLast_Counter = kBranchMisses_Counter
+    };
+    static const int kCounterCount = kLast_Counter + 1;
+
+    // The name of a counter, suitable as a key in JSON results.
+    static const char* Name(Counter);
+
+    PerfCounters();
+    ~PerfCounters();
+
+    bool has(Counter counter) const { return fFDs[counter] >= 0; }
+    bool hasAny() const { return fLeader >= 0; }
+
+    void start();
+    void end();
+    void reset();
+
+    // Total count since reset(), or 0 if !has(counter).
+    double get(Counter counter) const { return fTotals[counter]; }
+
+private:
+    int fFDs[kCounterCount];
+    int fLeader;
+    double fTotals[kCounterCount];
+};
+
+#endif